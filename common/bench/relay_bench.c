@@ -0,0 +1,927 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host benchmarks for the relay code both firmwares share: CRC, the CDC0
+ * deframer in both framings, the pass-through codec against nanopb, and
+ * relay_dispatch.
+ * The pass-through codec is first checked against nanopb and the run fails
+ * if they disagree. Each case then runs for at least RUN_NS and reports time
+ * per frame, payload throughput and heap calls per run.
+ *
+ * With a file argument, a raw CDC0 capture is also deframed and dispatched
+ * in USB-sized chunks. A session capture (mouthpad_capture.h) is replayed
+ * instead, once, through the paths the relay would run for each record:
+ * host writes are framed, deframed and dispatched, MouthPad notifications
+ * are encoded for CDC0, and HID reports go through the HID mirror with a
+ * flush every HID_MIRROR_FLUSH_MS of capture time. Each kind of record is
+ * reported with its latency spread and drops, and the MouthPad's sensor
+ * frames are also put through the sensor codec to report what it saves.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hid_mirror.h"
+#include "mouthpad_capture.h"
+#include "mouthpad_crc16.h"
+#include "mouthpad_frame.h"
+#include "mouthpad_hid_reports.h"
+#include "mouthpad_pass_through.h"
+#include "relay_dispatch.h"
+#include "sensor_codec.h"
+#include "pb_decode.h"
+#include "pb_encode.h"
+
+/* Minimum time each case runs for */
+#define RUN_NS 200000000ull
+
+/* Frames per synthetic stream */
+#define STREAM_FRAMES 256
+
+/* Full-speed bulk packet, what the CDC RX callbacks are handed */
+#define USB_CHUNK 64
+
+/* Typical MouthPad NUS packet, and the largest the relay forwards */
+#define NUS_SMALL 20
+#define NUS_MAX_TO_MOUTHPAD \
+	sizeof(((mouthware_message_PassThroughToMouthpad *)0)->data.bytes)
+#define NUS_MAX_TO_APP sizeof(((mouthware_message_PassThroughToApp *)0)->data.bytes)
+
+#define STREAM_MAX (STREAM_FRAMES * (MOUTHPAD_FRAME_COBS_SIZE(MOUTHPAD_FRAME_MAX_PAYLOAD) + 8))
+
+#if RELAY_BENCH_COUNT_ALLOCS
+static unsigned long heap_calls;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+	heap_calls++;
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+	heap_calls++;
+	return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	heap_calls++;
+	return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+	if (ptr) {
+		heap_calls++;
+	}
+	__real_free(ptr);
+}
+#endif
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Keeps results alive so the compiler cannot drop the work */
+static volatile uint32_t sink;
+
+/* One run over a case's workload */
+typedef void (*bench_fn_t)(void *ctx);
+
+static void bench(const char *name, bench_fn_t fn, void *ctx, size_t frames, size_t bytes)
+{
+	unsigned long calls = 0;
+
+	fn(ctx);
+
+#if RELAY_BENCH_COUNT_ALLOCS
+	unsigned long heap_start = heap_calls;
+#endif
+	uint64_t start = now_ns();
+	uint64_t elapsed;
+
+	do {
+		fn(ctx);
+		calls++;
+		elapsed = now_ns() - start;
+	} while (elapsed < RUN_NS);
+
+	double ns_per_frame = (double)elapsed / ((double)calls * frames);
+	double mb_per_s = (double)bytes * calls * 1000.0 / (double)elapsed;
+
+#if RELAY_BENCH_COUNT_ALLOCS
+	printf("%-44s %10.1f ns/frame %9.1f MB/s %8.2f heap/run\n", name, ns_per_frame, mb_per_s,
+	       (double)(heap_calls - heap_start) / calls);
+#else
+	printf("%-44s %10.1f ns/frame %9.1f MB/s\n", name, ns_per_frame, mb_per_s);
+#endif
+}
+
+/* [0xAA 0x55][len][payload][crc], as the firmwares send it */
+static size_t frame_build(uint8_t *out, const uint8_t *payload, size_t len)
+{
+	uint16_t crc = mouthpad_crc16(payload, len);
+
+	out[0] = MOUTHPAD_FRAME_MAGIC1;
+	out[1] = MOUTHPAD_FRAME_MAGIC2;
+	out[2] = (uint8_t)(len >> 8);
+	out[3] = (uint8_t)len;
+	/* The pass-through codec case encodes in place */
+	if (payload != out + MOUTHPAD_FRAME_HEADER_SIZE) {
+		memcpy(out + MOUTHPAD_FRAME_HEADER_SIZE, payload, len);
+	}
+	out[MOUTHPAD_FRAME_HEADER_SIZE + len] = (uint8_t)(crc >> 8);
+	out[MOUTHPAD_FRAME_HEADER_SIZE + len + 1] = (uint8_t)crc;
+	return len + MOUTHPAD_FRAME_OVERHEAD;
+}
+
+static void fill_pattern(uint8_t *data, size_t len, uint32_t seed)
+{
+	for (size_t i = 0; i < len; i++) {
+		seed = seed * 1103515245u + 12345u;
+		data[i] = (uint8_t)(seed >> 16);
+	}
+}
+
+/* AppToRelayMessage carrying a host->MouthPad write, encoded by nanopb */
+static size_t encode_to_mouthpad(uint8_t *out, size_t size, const uint8_t *data, size_t len)
+{
+	mouthware_message_AppToRelayMessage msg = mouthware_message_AppToRelayMessage_init_zero;
+	pb_ostream_t stream = pb_ostream_from_buffer(out, size);
+
+	msg.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD;
+	msg.which_message_body = mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag;
+	msg.message_body.pass_through_to_mouthpad.data.size = (pb_size_t)len;
+	memcpy(msg.message_body.pass_through_to_mouthpad.data.bytes, data, len);
+
+	if (!pb_encode(&stream, mouthware_message_AppToRelayMessage_fields, &msg)) {
+		fprintf(stderr, "encode failed: %s\n", PB_GET_ERROR(&stream));
+		exit(1);
+	}
+	return stream.bytes_written;
+}
+
+static size_t encode_control(uint8_t *out, size_t size)
+{
+	mouthware_message_AppToRelayMessage msg = mouthware_message_AppToRelayMessage_init_zero;
+	pb_ostream_t stream = pb_ostream_from_buffer(out, size);
+
+	msg.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	msg.which_message_body = mouthware_message_AppToRelayMessage_device_info_read_tag;
+
+	if (!pb_encode(&stream, mouthware_message_AppToRelayMessage_fields, &msg)) {
+		fprintf(stderr, "encode failed: %s\n", PB_GET_ERROR(&stream));
+		exit(1);
+	}
+	return stream.bytes_written;
+}
+
+/* CRC over one buffer */
+
+struct crc_ctx {
+	const uint8_t *data;
+	size_t len;
+};
+
+static void run_crc(void *arg)
+{
+	struct crc_ctx *ctx = arg;
+
+	sink += mouthpad_crc16(ctx->data, ctx->len);
+}
+
+/* Deframing a stream fed in fixed-size chunks */
+
+struct deframe_ctx {
+	struct mouthpad_deframer deframer;
+	const uint8_t *stream;
+	size_t len;
+	size_t chunk;
+	bool dispatch;
+	enum relay_dispatch_result result; /* Of the last frame dispatched */
+};
+
+static void on_frame(const uint8_t *payload, uint16_t len, void *user_data)
+{
+	struct deframe_ctx *ctx = user_data;
+
+	if (ctx->dispatch) {
+		ctx->result = relay_dispatch_submit(payload, len);
+		sink += ctx->result;
+	} else {
+		sink += payload[0] + len;
+	}
+}
+
+static void run_deframe(void *arg)
+{
+	struct deframe_ctx *ctx = arg;
+
+	for (size_t pos = 0; pos < ctx->len; pos += ctx->chunk) {
+		size_t n = ctx->len - pos < ctx->chunk ? ctx->len - pos : ctx->chunk;
+
+		mouthpad_deframer_feed(&ctx->deframer, ctx->stream + pos, n);
+	}
+}
+
+static void deframe_ctx_init(struct deframe_ctx *ctx, const uint8_t *stream, size_t len,
+			     size_t chunk, bool dispatch)
+{
+	mouthpad_deframer_init(&ctx->deframer, on_frame, NULL, ctx);
+	ctx->stream = stream;
+	ctx->len = len;
+	ctx->chunk = chunk;
+	ctx->dispatch = dispatch;
+}
+
+/* Relay->host pass-through encoding: hand-written codec against nanopb */
+
+struct to_app_ctx {
+	const uint8_t *data;
+	size_t len;
+	uint8_t out[MOUTHPAD_FRAME_MAX_PAYLOAD + MOUTHPAD_FRAME_OVERHEAD];
+	uint8_t cobs[MOUTHPAD_FRAME_COBS_SIZE(MOUTHPAD_FRAME_MAX_PAYLOAD)];
+	mouthware_message_RelayToAppMessage msg;
+};
+
+static void run_to_app_codec(void *arg)
+{
+	struct to_app_ctx *ctx = arg;
+	uint8_t *payload = ctx->out + MOUTHPAD_FRAME_HEADER_SIZE;
+	size_t n = mouthpad_pass_through_to_app_encode(payload, ctx->data, ctx->len, false, 0, 0);
+
+	sink += frame_build(ctx->out, payload, n);
+}
+
+/* The same, COBS-framed from the encoded payload as the ESP relay does */
+static void run_to_app_cobs(void *arg)
+{
+	struct to_app_ctx *ctx = arg;
+	uint8_t *payload = ctx->out + MOUTHPAD_FRAME_HEADER_SIZE;
+	size_t n = mouthpad_pass_through_to_app_encode(payload, ctx->data, ctx->len, false, 0, 0);
+
+	sink += mouthpad_frame_cobs(ctx->cobs, payload, n);
+}
+
+static void run_to_app_nanopb(void *arg)
+{
+	struct to_app_ctx *ctx = arg;
+	uint8_t payload[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	pb_ostream_t stream = pb_ostream_from_buffer(payload, sizeof(payload));
+
+	memset(&ctx->msg, 0, sizeof(ctx->msg));
+	ctx->msg.which_message_body = mouthware_message_RelayToAppMessage_pass_through_to_app_tag;
+	ctx->msg.message_body.pass_through_to_app.data.size = (pb_size_t)ctx->len;
+	memcpy(ctx->msg.message_body.pass_through_to_app.data.bytes, ctx->data, ctx->len);
+
+	pb_encode(&stream, mouthware_message_RelayToAppMessage_fields, &ctx->msg);
+	sink += frame_build(ctx->out, payload, stream.bytes_written);
+}
+
+/* Host->relay pass-through decoding: peek against nanopb */
+
+struct to_mouthpad_ctx {
+	uint8_t frame[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	size_t len;
+	mouthware_message_AppToRelayMessage msg;
+};
+
+static void run_peek(void *arg)
+{
+	struct to_mouthpad_ctx *ctx = arg;
+	struct mouthpad_pass_through_to_mouthpad pt;
+
+	sink += mouthpad_pass_through_to_mouthpad_peek(ctx->frame, ctx->len, &pt) ? pt.len : 0;
+}
+
+static void run_pb_decode(void *arg)
+{
+	struct to_mouthpad_ctx *ctx = arg;
+	pb_istream_t stream = pb_istream_from_buffer(ctx->frame, ctx->len);
+
+	sink += pb_decode(&stream, mouthware_message_AppToRelayMessage_fields, &ctx->msg);
+}
+
+/*
+ * The pass-through codec must match nanopb byte for byte on encode and
+ * field for field on peek. Checked before anything is timed, over every
+ * data length and the varint edges of the numeric fields.
+ */
+
+static const uint32_t check_values[] = {0, 1, 127, 128, 16383, 16384, UINT32_MAX};
+
+#define CHECK_VALUES (sizeof(check_values) / sizeof(check_values[0]))
+
+static bool check_to_app(const uint8_t *data, size_t len, bool more_fragments, uint32_t fragment,
+			 uint32_t device_index)
+{
+	static mouthware_message_RelayToAppMessage msg;
+	uint8_t expected[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	uint8_t out[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	pb_ostream_t stream = pb_ostream_from_buffer(expected, sizeof(expected));
+	size_t n, header;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.which_message_body = mouthware_message_RelayToAppMessage_pass_through_to_app_tag;
+	msg.message_body.pass_through_to_app.data.size = (pb_size_t)len;
+	memcpy(msg.message_body.pass_through_to_app.data.bytes, data, len);
+	msg.message_body.pass_through_to_app.more_fragments = more_fragments;
+	msg.message_body.pass_through_to_app.fragment = fragment;
+	msg.message_body.pass_through_to_app.device_index = device_index;
+
+	if (!pb_encode(&stream, mouthware_message_RelayToAppMessage_fields, &msg)) {
+		fprintf(stderr, "encode failed: %s\n", PB_GET_ERROR(&stream));
+		exit(1);
+	}
+
+	n = mouthpad_pass_through_to_app_encode(out, data, len, more_fragments, fragment,
+						device_index);
+	header = mouthpad_pass_through_to_app_header(out, len, more_fragments, fragment,
+						     device_index);
+	memcpy(out + header, data, len);
+	header += len + mouthpad_pass_through_to_app_trailer(out + header + len, more_fragments,
+							       fragment, device_index);
+
+	if (n == stream.bytes_written && header == n &&
+	    n == mouthpad_pass_through_to_app_size(len, more_fragments, fragment, device_index) &&
+	    memcmp(out, expected, n) == 0) {
+		return true;
+	}
+	fprintf(stderr,
+		"to_app %zu B, more_fragments %d, fragment %u, device_index %u: "
+		"codec %zu B, nanopb %zu B\n",
+		len, more_fragments, fragment, device_index, n, stream.bytes_written);
+	return false;
+}
+
+static bool check_to_mouthpad(const uint8_t *data, size_t len, unsigned int flags, uint32_t ack,
+			      uint32_t v)
+{
+	static mouthware_message_AppToRelayMessage msg, decoded;
+	mouthware_message_PassThroughToMouthpad *body = &msg.message_body.pass_through_to_mouthpad;
+	const mouthware_message_PassThroughToMouthpad *want =
+		&decoded.message_body.pass_through_to_mouthpad;
+	struct mouthpad_pass_through_to_mouthpad pt;
+	uint8_t frame[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	pb_ostream_t stream = pb_ostream_from_buffer(frame, sizeof(frame));
+	pb_istream_t in;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD;
+	msg.which_message_body = mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag;
+	body->data.size = (pb_size_t)len;
+	memcpy(body->data.bytes, data, len);
+	body->reliable = flags & 1;
+	body->more_fragments = (flags >> 1) & 1;
+	body->fragment = check_values[v];
+	body->device_index = check_values[(v + 1) % CHECK_VALUES];
+	body->ack = (mouthware_message_PassThroughAckMode)ack;
+	body->sequence = check_values[(v + 2) % CHECK_VALUES];
+
+	if (!pb_encode(&stream, mouthware_message_AppToRelayMessage_fields, &msg)) {
+		fprintf(stderr, "encode failed: %s\n", PB_GET_ERROR(&stream));
+		exit(1);
+	}
+	memset(&decoded, 0, sizeof(decoded));
+	in = pb_istream_from_buffer(frame, stream.bytes_written);
+	if (!pb_decode(&in, mouthware_message_AppToRelayMessage_fields, &decoded)) {
+		fprintf(stderr, "decode failed: %s\n", PB_GET_ERROR(&in));
+		exit(1);
+	}
+
+	if (mouthpad_pass_through_to_mouthpad_peek(frame, stream.bytes_written, &pt) &&
+	    decoded.which_message_body ==
+		    mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag &&
+	    pt.len == want->data.size && memcmp(pt.data, want->data.bytes, pt.len) == 0 &&
+	    pt.reliable == want->reliable && pt.more_fragments == want->more_fragments &&
+	    pt.fragment == want->fragment && pt.device_index == want->device_index &&
+	    pt.ack == (uint32_t)want->ack && pt.sequence == want->sequence) {
+		return true;
+	}
+	fprintf(stderr,
+		"to_mouthpad %zu B, reliable %d, more_fragments %d, fragment %u, device_index %u, "
+		"ack %u, sequence %u: peek disagrees with nanopb\n",
+		len, body->reliable, body->more_fragments, body->fragment, body->device_index, ack,
+		body->sequence);
+	return false;
+}
+
+static bool check_pass_through(const uint8_t *data)
+{
+	unsigned long cases = 0, failed = 0;
+
+	for (size_t len = 0; len <= NUS_MAX_TO_APP; len++) {
+		for (int more = 0; more < 2; more++) {
+			for (size_t f = 0; f < CHECK_VALUES; f++) {
+				for (size_t d = 0; d < CHECK_VALUES; d++) {
+					failed += !check_to_app(data, len, more, check_values[f],
+								check_values[d]);
+					cases++;
+				}
+			}
+		}
+	}
+
+	for (size_t len = 0; len <= NUS_MAX_TO_MOUTHPAD; len++) {
+		for (unsigned int flags = 0; flags < 4; flags++) {
+			for (uint32_t ack = 0; ack < _mouthware_message_PassThroughAckMode_ARRAYSIZE;
+			     ack++) {
+				for (uint32_t v = 0; v < CHECK_VALUES; v++) {
+					failed += !check_to_mouthpad(data, len, flags, ack, v);
+					cases++;
+				}
+			}
+		}
+	}
+
+	printf("pass-through codec against nanopb: %lu cases, %lu failed\n", cases, failed);
+	return failed == 0;
+}
+
+/* relay_dispatch platform hooks: everything runs at once on this thread */
+
+static int dispatch_pass_through(const struct mouthpad_pass_through_to_mouthpad *pt)
+{
+	sink += pt->len;
+	return 0;
+}
+
+static int dispatch_handler(const mouthware_message_AppToRelayMessage *message)
+{
+	sink += message->which_message_body;
+	return 0;
+}
+
+static void dispatch_kick(void)
+{
+	relay_dispatch_run();
+}
+
+static uint32_t dispatch_now_us(void)
+{
+	return (uint32_t)(now_ns() / 1000);
+}
+
+static const struct relay_dispatch_entry dispatch_table[RELAY_DISPATCH_TAG_COUNT] = {
+	[mouthware_message_AppToRelayMessage_device_info_read_tag] = {"device_info_read",
+								      dispatch_handler, false},
+};
+
+/* Builds a stream of frames, COBS or not; every corrupt_every-th one gets
+ * a bad CRC and is followed by noise. Returns the stream length.
+ */
+static size_t stream_build(uint8_t *stream, const uint8_t *payload, size_t len,
+			   unsigned int corrupt_every, bool cobs)
+{
+	size_t pos = 0;
+
+	for (unsigned int i = 0; i < STREAM_FRAMES; i++) {
+		size_t n = cobs ? mouthpad_frame_cobs(stream + pos, payload, len)
+				: frame_build(stream + pos, payload, len);
+
+		if (corrupt_every && i % corrupt_every == corrupt_every - 1) {
+			/* The last CRC byte, ahead of the COBS delimiter */
+			stream[pos + n - 1 - cobs] ^= 0x5A;
+			pos += n;
+			fill_pattern(stream + pos, 7, i);
+			pos += 7;
+		} else {
+			pos += n;
+		}
+	}
+	return pos;
+}
+
+/* Session capture replay */
+
+enum replay_kind {
+	REPLAY_CONTROL_IN,  /* Host->relay message: deframe and dispatch */
+	REPLAY_NUS_IN,      /* Host->MouthPad write: deframe and peek */
+	REPLAY_NUS_OUT,     /* MouthPad notification: encode for CDC0 */
+	REPLAY_HID,         /* HID report into the mirror ring */
+	REPLAY_HID_FLUSH,   /* One HidMirrorBatch encoded for CDC0 */
+	REPLAY_CONTROL_OUT, /* Relay->host message; counted only */
+	REPLAY_KINDS,
+};
+
+static const char *const replay_names[REPLAY_KINDS] = {
+	"replay control host->relay",
+	"replay NUS host->MouthPad",
+	"replay NUS MouthPad->host",
+	"replay HID into mirror",
+	"replay HID mirror batch",
+	"replay control relay->host",
+};
+
+struct replay_stats {
+	uint32_t count;
+	uint32_t drops;
+	uint32_t *ns; /* One per record, sorted for the report */
+};
+
+/* Every tag queued, so replayed control messages go through the queue */
+static struct relay_dispatch_entry replay_table[RELAY_DISPATCH_TAG_COUNT];
+
+static enum replay_kind replay_kind_of(const struct mouthpad_capture_record *record)
+{
+	bool in = record->direction == MOUTHPAD_CAPTURE_TO_DEVICE;
+
+	switch (record->channel) {
+	case MOUTHPAD_CAPTURE_NUS:
+		return in ? REPLAY_NUS_IN : REPLAY_NUS_OUT;
+	case MOUTHPAD_CAPTURE_HID:
+		return REPLAY_HID;
+	default:
+		return in ? REPLAY_CONTROL_IN : REPLAY_CONTROL_OUT;
+	}
+}
+
+static void replay_sample(struct replay_stats *stats, uint64_t ns)
+{
+	stats->ns[stats->count++] = ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+static bool dispatch_dropped(enum relay_dispatch_result result)
+{
+	return result == RELAY_DISPATCH_DECODE_ERROR || result == RELAY_DISPATCH_FULL ||
+	       result == RELAY_DISPATCH_FAILED;
+}
+
+/* Host->relay frame through the deframer and relay_dispatch; false if it
+ * was dropped on the way
+ */
+static bool replay_to_relay(struct deframe_ctx *ctx, uint8_t *stream, const uint8_t *payload,
+			    size_t len)
+{
+	uint32_t frames = ctx->deframer.frames;
+
+	ctx->stream = stream;
+	ctx->len = frame_build(stream, payload, len);
+	run_deframe(ctx);
+	return ctx->deframer.frames != frames && !dispatch_dropped(ctx->result);
+}
+
+/* Drain the mirror as the flush context does, one sample per batch */
+static void replay_hid_flush(struct replay_stats *stats)
+{
+	static mouthware_message_RelayToAppMessage msg;
+	uint8_t out[MOUTHPAD_FRAME_MAX_PAYLOAD + MOUTHPAD_FRAME_OVERHEAD];
+
+	for (;;) {
+		uint64_t start = now_ns();
+
+		memset(&msg, 0, sizeof(msg));
+		if (!hid_mirror_fill(&msg.message_body.hid_mirror_batch)) {
+			break;
+		}
+		msg.which_message_body = mouthware_message_RelayToAppMessage_hid_mirror_batch_tag;
+
+		pb_ostream_t stream = pb_ostream_from_buffer(out + MOUTHPAD_FRAME_HEADER_SIZE,
+							     MOUTHPAD_FRAME_MAX_PAYLOAD);
+
+		if (!pb_encode(&stream, mouthware_message_RelayToAppMessage_fields, &msg)) {
+			stats->drops++;
+			continue;
+		}
+		sink += frame_build(out, out + MOUTHPAD_FRAME_HEADER_SIZE, stream.bytes_written);
+		replay_sample(stats, now_ns() - start);
+	}
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static uint8_t *read_capture(const char *path, size_t *len)
+{
+	FILE *f = fopen(path, "rb");
+	uint8_t *data = NULL;
+	long size;
+
+	if (!f) {
+		perror(path);
+		return NULL;
+	}
+
+	if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0) {
+		data = malloc((size_t)size);
+		if (data && fread(data, 1, (size_t)size, f) != (size_t)size) {
+			free(data);
+			data = NULL;
+		}
+		*len = (size_t)size;
+	}
+
+	fclose(f);
+	return data;
+}
+
+/* Replay a session capture once; false if it could not be */
+static bool replay(const char *path, const uint8_t *capture, size_t len)
+{
+	static uint8_t stream[MOUTHPAD_FRAME_MAX_PAYLOAD + MOUTHPAD_FRAME_OVERHEAD];
+	static struct deframe_ctx deframe;
+	static mouthware_message_SensorFrameDelta delta;
+	struct replay_stats stats[REPLAY_KINDS] = {0};
+	uint32_t counts[REPLAY_KINDS] = {0};
+	struct mouthpad_capture_reader reader;
+	struct mouthpad_capture_record record;
+	uint8_t payload[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	uint64_t next_flush = HID_MIRROR_FLUSH_MS * 1000ull;
+	uint64_t end_us = 0;
+	uint32_t pending = 0;
+	bool ok = true;
+
+	/* Counts first, to size the sample arrays */
+	mouthpad_capture_open(&reader, capture, len);
+	while (mouthpad_capture_next(&reader, &record)) {
+		counts[replay_kind_of(&record)]++;
+		end_us = record.time_us;
+	}
+	counts[REPLAY_HID_FLUSH] = counts[REPLAY_HID];
+	for (int k = 0; k < REPLAY_KINDS; k++) {
+		stats[k].ns = malloc((counts[k] ? counts[k] : 1) * sizeof(uint32_t));
+		if (!stats[k].ns) {
+			ok = false;
+		}
+	}
+
+	for (int tag = 0; tag < RELAY_DISPATCH_TAG_COUNT; tag++) {
+		replay_table[tag] = (struct relay_dispatch_entry){"replay", dispatch_handler, false};
+	}
+	relay_dispatch_init(&(struct relay_dispatch_config){
+		.table = replay_table,
+		.pass_through = dispatch_pass_through,
+		.kick = dispatch_kick,
+		.now_us = dispatch_now_us,
+	});
+	deframe_ctx_init(&deframe, stream, 0, USB_CHUNK, true);
+	hid_mirror_set_enabled(true);
+	sensor_codec_configure(true, 0);
+
+	mouthpad_capture_open(&reader, capture, len);
+	while (ok && mouthpad_capture_next(&reader, &record)) {
+		enum replay_kind kind = replay_kind_of(&record);
+		struct replay_stats *s = &stats[kind];
+		uint64_t start;
+		bool done = true;
+
+		/* The flush context's period, in capture time */
+		while (record.time_us >= next_flush) {
+			if (pending > HID_MIRROR_RING_LEN) {
+				stats[REPLAY_HID].drops += pending - HID_MIRROR_RING_LEN;
+			}
+			pending = 0;
+			replay_hid_flush(&stats[REPLAY_HID_FLUSH]);
+			next_flush += HID_MIRROR_FLUSH_MS * 1000ull;
+		}
+
+		start = now_ns();
+		switch (kind) {
+		case REPLAY_CONTROL_IN:
+			done = record.len <= MOUTHPAD_FRAME_MAX_PAYLOAD &&
+			       replay_to_relay(&deframe, stream, record.data, record.len);
+			break;
+		case REPLAY_NUS_IN:
+			done = record.len <= NUS_MAX_TO_MOUTHPAD &&
+			       replay_to_relay(&deframe, stream, payload,
+					       encode_to_mouthpad(payload, sizeof(payload),
+								  record.data, record.len));
+			break;
+		case REPLAY_NUS_OUT:
+			done = record.len <= NUS_MAX_TO_APP;
+			if (done) {
+				size_t n = mouthpad_pass_through_to_app_encode(
+					stream + MOUTHPAD_FRAME_HEADER_SIZE, record.data, record.len,
+					false, 0, 0);
+
+				sink += frame_build(stream, stream + MOUTHPAD_FRAME_HEADER_SIZE, n);
+			}
+			break;
+		case REPLAY_HID:
+			/* [report ID][report], as mouthpad::relay records them */
+			done = record.len >= 1 &&
+			       mouthpad_hid_report_fits(record.data[0], record.len - 1u);
+			if (done) {
+				hid_mirror_record(record.data[0], record.data + 1, record.len - 1u,
+						  record.time_us, record.time_us, true);
+				pending++;
+			}
+			break;
+		default:
+			sink += record.len;
+			break;
+		}
+		replay_sample(s, now_ns() - start);
+		if (!done) {
+			s->drops++;
+		}
+
+		/* Outside the timing; the codec's savings are what is reported */
+		if (kind == REPLAY_NUS_OUT) {
+			sensor_codec_encode(record.data, record.len, &delta);
+		}
+	}
+
+	if (pending > HID_MIRROR_RING_LEN) {
+		stats[REPLAY_HID].drops += pending - HID_MIRROR_RING_LEN;
+	}
+	replay_hid_flush(&stats[REPLAY_HID_FLUSH]);
+	hid_mirror_set_enabled(false);
+	sensor_codec_configure(false, 0);
+
+	if (ok) {
+		printf("%s: %zu bytes over %.3f s\n", path, len, (double)end_us / 1e6);
+		printf("%-44s %8s %9s %9s %9s %9s %6s\n", "", "records", "avg ns", "p50", "p99",
+		       "max", "drops");
+	}
+	for (int k = 0; ok && k < REPLAY_KINDS; k++) {
+		const struct replay_stats *st = &stats[k];
+		uint64_t total = 0;
+
+		if (st->count == 0) {
+			continue;
+		}
+		qsort(st->ns, st->count, sizeof(uint32_t), compare_u32);
+		for (uint32_t i = 0; i < st->count; i++) {
+			total += st->ns[i];
+		}
+		printf("%-44s %8u %9.1f %9u %9u %9u %6u\n", replay_names[k], st->count,
+		       (double)total / st->count, st->ns[st->count / 2],
+		       st->ns[(uint64_t)st->count * 99 / 100], st->ns[st->count - 1], st->drops);
+	}
+	if (ok) {
+		char line[128];
+
+		sensor_codec_format(line, sizeof(line));
+		printf("%s\n", line);
+	}
+
+	for (int k = 0; k < REPLAY_KINDS; k++) {
+		free(stats[k].ns);
+	}
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t stream[STREAM_MAX];
+	static struct deframe_ctx deframe;
+	static struct to_app_ctx to_app;
+	static struct to_mouthpad_ctx to_mouthpad;
+	uint8_t data[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	uint8_t payload[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	char name[64];
+	size_t len;
+
+	fill_pattern(data, sizeof(data), 1);
+
+	if (!check_pass_through(data)) {
+		return 1;
+	}
+
+	relay_dispatch_init(&(struct relay_dispatch_config){
+		.table = dispatch_table,
+		.pass_through = dispatch_pass_through,
+		.kick = dispatch_kick,
+		.now_us = dispatch_now_us,
+	});
+
+	static const size_t crc_sizes[] = {NUS_SMALL, 64, MOUTHPAD_FRAME_MAX_PAYLOAD};
+
+	for (size_t i = 0; i < sizeof(crc_sizes) / sizeof(crc_sizes[0]); i++) {
+		struct crc_ctx crc = {data, crc_sizes[i]};
+
+		snprintf(name, sizeof(name), "crc16 %zu B", crc_sizes[i]);
+		bench(name, run_crc, &crc, 1, crc_sizes[i]);
+	}
+
+	static const size_t nus_sizes[] = {NUS_SMALL, NUS_MAX_TO_MOUTHPAD};
+	static const size_t chunks[] = {STREAM_MAX, USB_CHUNK, 1};
+
+	for (size_t i = 0; i < sizeof(nus_sizes) / sizeof(nus_sizes[0]); i++) {
+		size_t plen = encode_to_mouthpad(payload, sizeof(payload), data, nus_sizes[i]);
+		size_t slen = stream_build(stream, payload, plen, 0, false);
+
+		for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+			deframe_ctx_init(&deframe, stream, slen, chunks[c], false);
+			if (chunks[c] == STREAM_MAX) {
+				snprintf(name, sizeof(name), "deframe %zu B write, one chunk", nus_sizes[i]);
+			} else {
+				snprintf(name, sizeof(name), "deframe %zu B write, %zu B chunks",
+					 nus_sizes[i], chunks[c]);
+			}
+			bench(name, run_deframe, &deframe, STREAM_FRAMES, slen);
+		}
+
+		slen = stream_build(stream, payload, plen, 4, false);
+		deframe_ctx_init(&deframe, stream, slen, USB_CHUNK, false);
+		snprintf(name, sizeof(name), "deframe %zu B write, 1/4 corrupt", nus_sizes[i]);
+		bench(name, run_deframe, &deframe, STREAM_FRAMES, slen);
+
+		slen = stream_build(stream, payload, plen, 0, true);
+		deframe_ctx_init(&deframe, stream, slen, USB_CHUNK, false);
+		snprintf(name, sizeof(name), "deframe %zu B write, COBS", nus_sizes[i]);
+		bench(name, run_deframe, &deframe, STREAM_FRAMES, slen);
+
+		slen = stream_build(stream, payload, plen, 4, true);
+		deframe_ctx_init(&deframe, stream, slen, USB_CHUNK, false);
+		snprintf(name, sizeof(name), "deframe %zu B write, COBS, 1/4 corrupt", nus_sizes[i]);
+		bench(name, run_deframe, &deframe, STREAM_FRAMES, slen);
+
+		slen = stream_build(stream, payload, plen, 0, false);
+		deframe_ctx_init(&deframe, stream, slen, USB_CHUNK, true);
+		snprintf(name, sizeof(name), "deframe+dispatch %zu B write", nus_sizes[i]);
+		bench(name, run_deframe, &deframe, STREAM_FRAMES, slen);
+	}
+
+	len = encode_control(payload, sizeof(payload));
+	len = stream_build(stream, payload, len, 0, false);
+	deframe_ctx_init(&deframe, stream, len, USB_CHUNK, true);
+	bench("deframe+dispatch device_info_read", run_deframe, &deframe, STREAM_FRAMES, len);
+
+	static const size_t to_app_sizes[] = {NUS_SMALL, NUS_MAX_TO_APP};
+
+	for (size_t i = 0; i < sizeof(to_app_sizes) / sizeof(to_app_sizes[0]); i++) {
+		to_app.data = data;
+		to_app.len = to_app_sizes[i];
+
+		snprintf(name, sizeof(name), "to_app %zu B, pass-through codec", to_app_sizes[i]);
+		bench(name, run_to_app_codec, &to_app, 1, to_app_sizes[i]);
+		snprintf(name, sizeof(name), "to_app %zu B, pass-through codec, COBS",
+			 to_app_sizes[i]);
+		bench(name, run_to_app_cobs, &to_app, 1, to_app_sizes[i]);
+		snprintf(name, sizeof(name), "to_app %zu B, nanopb", to_app_sizes[i]);
+		bench(name, run_to_app_nanopb, &to_app, 1, to_app_sizes[i]);
+	}
+
+	for (size_t i = 0; i < sizeof(nus_sizes) / sizeof(nus_sizes[0]); i++) {
+		to_mouthpad.len = encode_to_mouthpad(to_mouthpad.frame, sizeof(to_mouthpad.frame), data,
+						     nus_sizes[i]);
+
+		snprintf(name, sizeof(name), "to_mouthpad %zu B, peek", nus_sizes[i]);
+		bench(name, run_peek, &to_mouthpad, 1, nus_sizes[i]);
+		snprintf(name, sizeof(name), "to_mouthpad %zu B, nanopb", nus_sizes[i]);
+		bench(name, run_pb_decode, &to_mouthpad, 1, nus_sizes[i]);
+	}
+
+	if (argc > 1) {
+		uint8_t *capture = read_capture(argv[1], &len);
+
+		if (!capture) {
+			return 1;
+		}
+
+		struct mouthpad_capture_reader reader;
+
+		if (mouthpad_capture_open(&reader, capture, len)) {
+			bool ok = replay(argv[1], capture, len);
+
+			free(capture);
+			return ok ? 0 : 1;
+		}
+
+		/* Frames per run are only known after one pass */
+		deframe_ctx_init(&deframe, capture, len, USB_CHUNK, true);
+		run_deframe(&deframe);
+		if (deframe.deframer.frames == 0) {
+			fprintf(stderr, "%s: no frames found\n", argv[1]);
+			free(capture);
+			return 1;
+		}
+
+		printf("capture: %zu bytes, %u frames, %u length and %u CRC errors per pass\n", len,
+		       deframe.deframer.frames, deframe.deframer.length_errors,
+		       deframe.deframer.crc_errors);
+		bench("capture, deframe+dispatch", run_deframe, &deframe, deframe.deframer.frames,
+		      len);
+		free(capture);
+	}
+
+	return 0;
+}
@@ -0,0 +1,748 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Fuzzer for the CDC0 receive path both firmwares share: deframer, then
+ * relay_dispatch_submit() with its peek, pb_decode and table dispatch.
+ * Inputs are AppToRelayMessages, one seed per message body, plus a NUS
+ * and a control channel payload, mutated in place and framed, half of them with COBS; some frames also get noise, a
+ * bad CRC or a bad length before they are fed to the deframer in
+ * random-sized chunks. Every frame delivered must be reported in the
+ * framing it was sent in, which a run of framing switches checks first.
+ *
+ * For every message type that comes out of the deframer it records the
+ * worst pb_decode and relay_dispatch_submit times and the deepest stack
+ * either used. Stacks are measured by running each call on a painted
+ * stack of its own. A worst time is only taken after the input has been
+ * re-run, so one preemption does not count. With budgets given, the run
+ * fails when any type goes over them, so a schema change that makes the
+ * RX path slower or deeper shows up before it reaches a firmware.
+ *
+ * Built with RELAY_FUZZ_LIBFUZZER, the same path is a libFuzzer target
+ * taking one payload per input; the table is printed at exit.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if RELAY_FUZZ_STACK
+#include <ucontext.h>
+#endif
+
+#include "mouthpad_crc16.h"
+#include "mouthpad_frame.h"
+#include "relay_dispatch.h"
+#include "pb_decode.h"
+#include "pb_encode.h"
+
+/* Stack each measured call runs on; far more than either firmware gives
+ * the RX path, so an overflow shows as a number rather than a crash
+ */
+#define PROBE_STACK_SIZE (16 * 1024)
+#define PROBE_PAINT      0xA5
+
+/* Mutated inputs that decoded are kept to be mutated further */
+#define CORPUS_SIZE 256
+
+/* Runs of an input that sets a new worst time; the fastest one counts */
+#define WORST_RERUNS 3
+
+#define DEFAULT_ITERATIONS 200000
+
+/* Largest chunk handed to the deframer at once, one full-speed packet */
+#define USB_CHUNK_MAX 64
+
+/* Row 0 collects payloads that did not decode */
+#define CLASS_COUNT RELAY_DISPATCH_TAG_COUNT
+
+struct class_stats {
+	uint32_t inputs;
+	uint32_t decode_ns;
+	uint32_t decode_stack;
+	uint32_t submit_ns;
+	uint32_t submit_stack;
+};
+
+static struct class_stats stats[CLASS_COUNT];
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Keeps results alive so the compiler cannot drop the work */
+static volatile uint32_t sink;
+
+/* xorshift32; the same seed gives the same run */
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+	uint32_t x = rng_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	rng_state = x;
+	return x;
+}
+
+static uint32_t rng_below(uint32_t n)
+{
+	return n ? rng() % n : 0;
+}
+
+/* relay_dispatch platform hooks: everything runs at once on this thread */
+
+static int dispatch_pass_through(const struct mouthpad_pass_through_to_mouthpad *pt)
+{
+	sink += pt->len;
+	return 0;
+}
+
+static int dispatch_handler(const mouthware_message_AppToRelayMessage *message)
+{
+	sink += message->which_message_body;
+	return 0;
+}
+
+static void dispatch_kick(void)
+{
+	relay_dispatch_run();
+}
+
+static uint32_t dispatch_now_us(void)
+{
+	return (uint32_t)(now_ns() / 1000);
+}
+
+/* Every body, split between inline and queued as the firmwares do */
+#define ENTRY(name, run_inline) \
+	[mouthware_message_AppToRelayMessage_##name##_tag] = {#name, dispatch_handler, run_inline}
+
+static const struct relay_dispatch_entry dispatch_table[RELAY_DISPATCH_TAG_COUNT] = {
+	ENTRY(ble_connection_status_read, true),
+	ENTRY(pass_through_to_mouthpad, true),
+	ENTRY(device_info_read, false),
+	ENTRY(clear_bonds_write, false),
+	ENTRY(dfu_write, false),
+	ENTRY(clear_firmware_cache_write, false),
+	ENTRY(hid_latency_read, true),
+	ENTRY(hid_config_read, true),
+	ENTRY(hid_config_write, false),
+	ENTRY(pass_through_batch_config_write, true),
+	ENTRY(relay_stats_read, true),
+	ENTRY(connection_timing_read, true),
+	ENTRY(link_telemetry_subscribe, true),
+	ENTRY(relay_capabilities_read, true),
+	ENTRY(echo_request, true),
+	ENTRY(hid_mirror_config_write, false),
+	ENTRY(thread_stats_read, false),
+	ENTRY(trace_read, false),
+	ENTRY(mem_stats_read, false),
+	ENTRY(fw_update_start, true),
+	ENTRY(fw_update_chunk, true),
+	ENTRY(fw_update_end, true),
+	ENTRY(nus_stream_control, true),
+	ENTRY(nus_stream_write, true),
+	ENTRY(sensor_stream_filter_write, true),
+	ENTRY(sensor_codec_config_write, true),
+	ENTRY(sensor_stream_rate_write, true),
+	ENTRY(relay_profile_write, false),
+	ENTRY(usb_composition_write, false),
+	ENTRY(link_history_read, false),
+};
+
+static void dispatch_init(void)
+{
+	relay_dispatch_init(&(struct relay_dispatch_config){
+		.table = dispatch_table,
+		.pass_through = dispatch_pass_through,
+		.kick = dispatch_kick,
+		.now_us = dispatch_now_us,
+	});
+}
+
+static const char *class_name(size_t tag)
+{
+	if (tag == 0) {
+		return "(decode error)";
+	}
+	return dispatch_table[tag].name ? dispatch_table[tag].name : "(no handler)";
+}
+
+/* One measured call: the payload, and what the call reports back */
+
+struct probe {
+	const uint8_t *payload;
+	size_t len;
+	uint32_t ns;
+	pb_size_t tag;
+};
+
+typedef void (*probe_fn_t)(struct probe *probe);
+
+static void probe_decode(struct probe *probe)
+{
+	mouthware_message_AppToRelayMessage msg;
+	pb_istream_t stream = pb_istream_from_buffer(probe->payload, probe->len);
+	uint64_t start = now_ns();
+	bool ok = pb_decode(&stream, mouthware_message_AppToRelayMessage_fields, &msg);
+
+	probe->ns = (uint32_t)(now_ns() - start);
+	probe->tag = ok && msg.which_message_body < CLASS_COUNT ? msg.which_message_body : 0;
+}
+
+static void probe_submit(struct probe *probe)
+{
+	uint64_t start = now_ns();
+
+	sink += relay_dispatch_submit(probe->payload, probe->len);
+	probe->ns = (uint32_t)(now_ns() - start);
+}
+
+#if RELAY_FUZZ_STACK
+
+static uint64_t probe_stack[PROBE_STACK_SIZE / sizeof(uint64_t)];
+static ucontext_t caller_ctx;
+static ucontext_t probe_ctx;
+static probe_fn_t probe_call;
+static struct probe *probe_arg;
+
+/* Lowest word written since the last repaint */
+static size_t probe_dirty;
+
+/* Bytes the context switch itself leaves on the probe stack */
+static size_t probe_baseline;
+
+static void probe_entry(void)
+{
+	probe_call(probe_arg);
+}
+
+/* Stack grows down: every word below the first overwritten one is unused */
+static size_t probe_run(probe_fn_t fn, struct probe *probe)
+{
+	static const uint64_t paint = 0x0101010101010101ull * PROBE_PAINT;
+	size_t words = sizeof(probe_stack) / sizeof(probe_stack[0]);
+
+	for (size_t i = probe_dirty; i < words; i++) {
+		probe_stack[i] = paint;
+	}
+
+	probe_call = fn;
+	probe_arg = probe;
+	getcontext(&probe_ctx);
+	probe_ctx.uc_stack.ss_sp = probe_stack;
+	probe_ctx.uc_stack.ss_size = sizeof(probe_stack);
+	probe_ctx.uc_link = &caller_ctx;
+	makecontext(&probe_ctx, probe_entry, 0);
+	swapcontext(&caller_ctx, &probe_ctx);
+
+	size_t low = 0;
+
+	while (low < words && probe_stack[low] == paint) {
+		low++;
+	}
+	if (low == 0) {
+		fprintf(stderr, "probe stack of %d bytes exhausted\n", PROBE_STACK_SIZE);
+		abort();
+	}
+	probe_dirty = low;
+
+	size_t used = (words - low) * sizeof(probe_stack[0]);
+
+	return used > probe_baseline ? used - probe_baseline : 0;
+}
+
+static void probe_nothing(struct probe *probe)
+{
+	probe->ns = 0;
+}
+
+static void probe_calibrate(void)
+{
+	struct probe probe = {0};
+
+	probe_baseline = probe_run(probe_nothing, &probe);
+}
+
+#else
+
+/* Sanitizers and libFuzzer keep their own stacks; times only */
+static size_t probe_run(probe_fn_t fn, struct probe *probe)
+{
+	fn(probe);
+	return 0;
+}
+
+static void probe_calibrate(void)
+{
+}
+
+#endif
+
+static void record_max(uint32_t *max, uint32_t value)
+{
+	if (value > *max) {
+		*max = value;
+	}
+}
+
+/* Fastest of WORST_RERUNS; a one-off stall is not the input's cost */
+static uint32_t rerun_min(probe_fn_t fn, struct probe *probe, uint32_t first)
+{
+	uint32_t best = first;
+
+	for (int i = 1; i < WORST_RERUNS && best > 0; i++) {
+		probe_run(fn, probe);
+		if (probe->ns < best) {
+			best = probe->ns;
+		}
+	}
+	return best;
+}
+
+/* Class of the last frame delivered, -1 if the deframer dropped it */
+static int last_tag;
+
+static struct mouthpad_deframer deframer;
+
+/* Framing of the frame being fed, which the deframer must report back */
+static int expect_cobs = -1;
+static uint32_t framing_errors;
+
+/* Deframer callback: one payload through pb_decode, then the real path */
+static void on_frame(const uint8_t *payload, uint16_t len, void *user_data)
+{
+	struct probe probe = {.payload = payload, .len = len};
+	uint32_t stack;
+
+	(void)user_data;
+
+	stack = probe_run(probe_decode, &probe);
+
+	struct class_stats *cls = &stats[probe.tag];
+
+	last_tag = probe.tag;
+	if (expect_cobs >= 0 && deframer.cobs != expect_cobs) {
+		framing_errors++;
+	}
+	cls->inputs++;
+	record_max(&cls->decode_stack, stack);
+	if (probe.ns > cls->decode_ns) {
+		record_max(&cls->decode_ns, rerun_min(probe_decode, &probe, probe.ns));
+	}
+
+	/* Queued handlers run inside the submit through the kick hook */
+	stack = probe_run(probe_submit, &probe);
+	record_max(&cls->submit_stack, stack);
+	if (probe.ns > cls->submit_ns) {
+		record_max(&cls->submit_ns, rerun_min(probe_submit, &probe, probe.ns));
+	}
+}
+
+/* [0xAA 0x55][len][payload][crc], as the firmwares send it */
+static size_t frame_build(uint8_t *out, const uint8_t *payload, size_t len)
+{
+	uint16_t crc = mouthpad_crc16(payload, len);
+
+	out[0] = MOUTHPAD_FRAME_MAGIC1;
+	out[1] = MOUTHPAD_FRAME_MAGIC2;
+	out[2] = (uint8_t)(len >> 8);
+	out[3] = (uint8_t)len;
+	memcpy(out + MOUTHPAD_FRAME_HEADER_SIZE, payload, len);
+	out[MOUTHPAD_FRAME_HEADER_SIZE + len] = (uint8_t)(crc >> 8);
+	out[MOUTHPAD_FRAME_HEADER_SIZE + len + 1] = (uint8_t)crc;
+	return len + MOUTHPAD_FRAME_OVERHEAD;
+}
+
+/* Frames the payload and feeds it in chunks of 1 to chunk_max bytes; with
+ * damage, one frame in eight is preceded by noise and one in sixteen has a
+ * bad CRC or length, or a COBS byte changed, to exercise the deframer's
+ * resync paths as well
+ */
+static void feed_framed(const uint8_t *payload, size_t len, bool damage, bool cobs,
+			size_t chunk_max)
+{
+	uint8_t stream[16 + MOUTHPAD_FRAME_COBS_SIZE(MOUTHPAD_FRAME_MAX_PAYLOAD)];
+	size_t pos = 0;
+
+	if (damage && rng_below(8) == 0) {
+		size_t noise = 1 + rng_below(16);
+
+		for (size_t i = 0; i < noise; i++) {
+			stream[pos++] = (uint8_t)rng();
+		}
+	}
+
+	size_t start = pos;
+
+	pos += cobs ? mouthpad_frame_cobs(stream + pos, payload, len)
+		    : frame_build(stream + pos, payload, len);
+
+	if (damage && rng_below(16) == 0) {
+		if (cobs) {
+			/* Anything between the delimiters, a zero included */
+			stream[start + 1 + rng_below(pos - start - 2)] ^= (uint8_t)(1 + rng_below(255));
+		} else if (rng() & 1) {
+			stream[pos - 1 - rng_below(MOUTHPAD_FRAME_CRC_SIZE)] ^= (uint8_t)(1 + rng_below(255));
+		} else {
+			stream[start + 2 + rng_below(2)] ^= (uint8_t)(1 + rng_below(255));
+		}
+	}
+
+	/* Damage lets the odd run of leftover bytes pass its CRC */
+	expect_cobs = damage ? -1 : cobs;
+	for (size_t off = 0; off < pos;) {
+		size_t n = 1 + rng_below((uint32_t)chunk_max);
+
+		if (n > pos - off) {
+			n = pos - off;
+		}
+		mouthpad_deframer_feed(&deframer, stream + off, n);
+		off += n;
+	}
+	expect_cobs = -1;
+}
+
+/* Either framing, in chunks up to one full-speed packet */
+static void feed_payload(const uint8_t *payload, size_t len, bool damage)
+{
+	feed_framed(payload, len, damage, rng() & 1, USB_CHUNK_MAX);
+}
+
+static void print_table(void)
+{
+	printf("%-32s %8s %10s %8s %10s %8s\n", "message", "inputs", "decode ns", "stack",
+	       "submit ns", "stack");
+	for (size_t tag = 0; tag < CLASS_COUNT; tag++) {
+		const struct class_stats *cls = &stats[tag];
+
+		if (cls->inputs == 0) {
+			continue;
+		}
+		printf("%-32s %8" PRIu32 " %10" PRIu32 " %8" PRIu32 " %10" PRIu32 " %8" PRIu32 "\n",
+		       class_name(tag), cls->inputs, cls->decode_ns, cls->decode_stack, cls->submit_ns,
+		       cls->submit_stack);
+	}
+}
+
+#ifdef RELAY_FUZZ_LIBFUZZER
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+	(void)argc;
+	(void)argv;
+
+	dispatch_init();
+	mouthpad_deframer_init(&deframer, on_frame, NULL, NULL);
+	probe_calibrate();
+	atexit(print_table);
+	return 0;
+}
+
+/* One payload per input; the chunking follows from its contents so a
+ * crash reproduces from the input alone
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	if (size > MOUTHPAD_FRAME_MAX_PAYLOAD) {
+		return 0;
+	}
+
+	rng_state = mouthpad_crc16(data, size) | 1u;
+	mouthpad_deframer_reset(&deframer);
+	feed_payload(data, size, false);
+	return 0;
+}
+
+#else
+
+struct input {
+	uint16_t len;
+	uint8_t data[MOUTHPAD_FRAME_MAX_PAYLOAD];
+};
+
+/* Seeds first, never replaced; inputs that decoded rotate through the rest */
+static struct input corpus[CORPUS_SIZE];
+static size_t corpus_seeds;
+static size_t corpus_len;
+static size_t corpus_next;
+
+static void corpus_add(const uint8_t *data, size_t len)
+{
+	size_t idx;
+
+	if (corpus_len < CORPUS_SIZE) {
+		idx = corpus_len++;
+	} else {
+		idx = corpus_seeds + corpus_next++ % (CORPUS_SIZE - corpus_seeds);
+	}
+	corpus[idx].len = (uint16_t)len;
+	memcpy(corpus[idx].data, data, len);
+}
+
+static void seed_add(pb_size_t tag, size_t data_len)
+{
+	mouthware_message_AppToRelayMessage msg = mouthware_message_AppToRelayMessage_init_zero;
+	uint8_t out[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	pb_ostream_t stream = pb_ostream_from_buffer(out, sizeof(out));
+
+	msg.which_message_body = tag;
+	if (tag == mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag) {
+		msg.destination =
+			mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD;
+		msg.message_body.pass_through_to_mouthpad.data.size = (pb_size_t)data_len;
+		for (size_t i = 0; i < data_len; i++) {
+			msg.message_body.pass_through_to_mouthpad.data.bytes[i] = (uint8_t)rng();
+		}
+		/* The full-size seed also carries the acknowledgement fields */
+		if (data_len == sizeof(msg.message_body.pass_through_to_mouthpad.data.bytes)) {
+			msg.message_body.pass_through_to_mouthpad.ack =
+				mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_CUMULATIVE;
+			msg.message_body.pass_through_to_mouthpad.sequence = rng();
+		}
+	} else {
+		msg.destination =
+			mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	}
+
+	if (!pb_encode(&stream, mouthware_message_AppToRelayMessage_fields, &msg)) {
+		fprintf(stderr, "seed %u: encode failed: %s\n", (unsigned)tag, PB_GET_ERROR(&stream));
+		exit(1);
+	}
+	corpus_add(out, stream.bytes_written);
+}
+
+/* A channel header in front of len bytes of data */
+static void seed_channel(enum mouthpad_channel channel, const uint8_t *data, size_t len)
+{
+	uint8_t out[MOUTHPAD_FRAME_MAX_PAYLOAD];
+	size_t header = mouthpad_channel_header(out, channel, 0);
+
+	memcpy(&out[header], data, len);
+	corpus_add(out, header + len);
+}
+
+static void seed_corpus(void)
+{
+	static const size_t pass_through_max =
+		sizeof(((mouthware_message_PassThroughToMouthpad *)0)->data.bytes);
+
+	for (pb_size_t tag = 1; tag < RELAY_DISPATCH_TAG_COUNT; tag++) {
+		if (dispatch_table[tag].name) {
+			seed_add(tag, 20);
+		}
+	}
+	seed_add(mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag, pass_through_max);
+
+	uint8_t nus[sizeof(((mouthware_message_PassThroughToMouthpad *)0)->data.bytes)];
+
+	for (size_t i = 0; i < sizeof(nus); i++) {
+		nus[i] = (uint8_t)rng();
+	}
+	seed_channel(MOUTHPAD_CHANNEL_NUS, nus, sizeof(nus));
+	seed_channel(MOUTHPAD_CHANNEL_CONTROL, corpus[0].data, corpus[0].len);
+	corpus_seeds = corpus_len;
+}
+
+static void insert_bytes(uint8_t *buf, size_t *len, size_t pos, const uint8_t *bytes, size_t n)
+{
+	if (*len + n > MOUTHPAD_FRAME_MAX_PAYLOAD) {
+		n = MOUTHPAD_FRAME_MAX_PAYLOAD - *len;
+	}
+	memmove(buf + pos + n, buf + pos, *len - pos);
+	memcpy(buf + pos, bytes, n);
+	*len += n;
+}
+
+/* One to four edits: bit flips, byte values protobuf treats specially,
+ * inserted, erased and spliced runs, overlong varints and truncation
+ */
+static void mutate(uint8_t *buf, size_t *len)
+{
+	static const uint8_t interesting[] = {0x00, 0x01, 0x7F, 0x80, 0xFF};
+	static const uint8_t long_varint[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					      0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+	unsigned int edits = 1 + rng_below(4);
+
+	for (unsigned int e = 0; e < edits; e++) {
+		size_t pos = rng_below((uint32_t)*len + 1);
+		uint8_t run[16];
+		size_t n = 1 + rng_below(sizeof(run));
+
+		switch (rng_below(8)) {
+		case 0:
+			if (pos < *len) {
+				buf[pos] ^= (uint8_t)(1u << rng_below(8));
+			}
+			break;
+		case 1:
+			if (pos < *len) {
+				buf[pos] = (uint8_t)rng();
+			}
+			break;
+		case 2:
+			for (size_t i = 0; i < n; i++) {
+				run[i] = (uint8_t)rng();
+			}
+			insert_bytes(buf, len, pos, run, n);
+			break;
+		case 3:
+			if (n > *len - pos) {
+				n = *len - pos;
+			}
+			memmove(buf + pos, buf + pos + n, *len - pos - n);
+			*len -= n;
+			break;
+		case 4: {
+			const struct input *other = &corpus[rng_below((uint32_t)corpus_len)];
+			size_t from = rng_below(other->len);
+
+			if (n > other->len - from) {
+				n = other->len - from;
+			}
+			insert_bytes(buf, len, pos, other->data + from, n);
+			break;
+		}
+		case 5:
+			if (pos < *len) {
+				buf[pos] = interesting[rng_below(sizeof(interesting))];
+			}
+			break;
+		case 6:
+			insert_bytes(buf, len, pos, long_varint, sizeof(long_varint));
+			break;
+		default:
+			*len = pos;
+			break;
+		}
+	}
+}
+
+static bool over_budget(uint32_t max_stack, uint32_t max_ns)
+{
+	bool over = false;
+
+	for (size_t tag = 0; tag < CLASS_COUNT; tag++) {
+		const struct class_stats *cls = &stats[tag];
+
+		if (max_stack && cls->submit_stack > max_stack) {
+			fprintf(stderr, "%s: %" PRIu32 " bytes of stack, budget %" PRIu32 "\n",
+				class_name(tag), cls->submit_stack, max_stack);
+			over = true;
+		}
+		if (max_ns && cls->submit_ns > max_ns) {
+			fprintf(stderr, "%s: %" PRIu32 " ns, budget %" PRIu32 "\n", class_name(tag),
+				cls->submit_ns, max_ns);
+			over = true;
+		}
+	}
+	return over;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [-n iterations] [-s seed] [-S max_stack_bytes] [-T max_submit_ns]\n",
+		prog);
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long iterations = DEFAULT_ITERATIONS;
+	unsigned long seed = 1;
+	uint32_t max_stack = 0;
+	uint32_t max_ns = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 == argc || argv[i][0] != '-' || argv[i][2] != '\0') {
+			usage(argv[0]);
+		}
+
+		unsigned long value = strtoul(argv[++i], NULL, 0);
+
+		switch (argv[i - 1][1]) {
+		case 'n':
+			iterations = value;
+			break;
+		case 's':
+			seed = value;
+			break;
+		case 'S':
+			max_stack = (uint32_t)value;
+			break;
+		case 'T':
+			max_ns = (uint32_t)value;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	rng_state = (uint32_t)seed ? (uint32_t)seed : 1u;
+	dispatch_init();
+	mouthpad_deframer_init(&deframer, on_frame, NULL, NULL);
+	probe_calibrate();
+	seed_corpus();
+
+	/* Every seed once as is, so each message type has a row */
+	for (size_t i = 0; i < corpus_seeds; i++) {
+		feed_payload(corpus[i].data, corpus[i].len, false);
+	}
+
+	/* Framing switches: each frame must be reported in its own framing,
+	 * whole in one chunk (the zero-copy path) or a byte at a time
+	 */
+	for (size_t i = 0; i < corpus_seeds; i++) {
+		feed_framed(corpus[i].data, corpus[i].len, false, true, SIZE_MAX);
+		feed_framed(corpus[i].data, corpus[i].len, false, false, SIZE_MAX);
+		feed_framed(corpus[i].data, corpus[i].len, false, false, 1);
+		feed_framed(corpus[i].data, corpus[i].len, false, true, 1);
+		feed_framed(corpus[i].data, corpus[i].len, false, false, SIZE_MAX);
+	}
+
+	for (unsigned long it = 0; it < iterations; it++) {
+		const struct input *base = &corpus[rng_below((uint32_t)corpus_len)];
+		uint8_t buf[MOUTHPAD_FRAME_MAX_PAYLOAD];
+		size_t len = base->len;
+
+		memcpy(buf, base->data, len);
+		mutate(buf, &len);
+
+		last_tag = -1;
+		feed_payload(buf, len, true);
+		if (last_tag > 0 && rng_below(4) == 0) {
+			corpus_add(buf, len);
+		}
+	}
+
+	printf("%lu inputs, seed %lu: %" PRIu32 " frames, %" PRIu32 " length errors, %" PRIu32
+	       " CRC errors\n",
+	       iterations, seed, deframer.frames, deframer.length_errors, deframer.crc_errors);
+#if RELAY_FUZZ_STACK
+	printf("stack in bytes above the %zu the probe itself uses\n", probe_baseline);
+#endif
+	print_table();
+
+	if (framing_errors) {
+		fprintf(stderr, "%" PRIu32 " frames reported in the wrong framing\n", framing_errors);
+		return 1;
+	}
+	return over_budget(max_stack, max_ns) ? 1 : 0;
+}
+
+#endif /* RELAY_FUZZ_LIBFUZZER */
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "bond_table.h"
+
+_Static_assert((BOND_TABLE_SLOTS & (BOND_TABLE_SLOTS - 1)) == 0, "Slots a power of two");
+_Static_assert(BOND_TABLE_SLOTS >= 2 * BOND_TABLE_MAX, "Index at most half full");
+
+/* FNV-1a; the low address bytes are the random ones, all six go in */
+static uint32_t addr_hash(const uint8_t addr[BOND_TABLE_ADDR_LEN])
+{
+	uint32_t hash = 2166136261u;
+
+	for (size_t i = 0; i < BOND_TABLE_ADDR_LEN; i++) {
+		hash = (hash ^ addr[i]) * 16777619u;
+	}
+	return hash;
+}
+
+/* Positions move on every use; the index is rebuilt, at most
+ * BOND_TABLE_MAX inserts
+ */
+static void reindex(struct bond_table *table)
+{
+	memset(table->index, 0, sizeof(table->index));
+	for (size_t pos = 0; pos < table->count; pos++) {
+		uint32_t slot = addr_hash(table->addr[pos]) & (BOND_TABLE_SLOTS - 1);
+
+		while (table->index[slot] != 0) {
+			slot = (slot + 1) & (BOND_TABLE_SLOTS - 1);
+		}
+		table->index[slot] = (uint8_t)(pos + 1);
+	}
+}
+
+void bond_table_init(struct bond_table *table, size_t capacity)
+{
+	memset(table, 0, sizeof(*table));
+	if (capacity < 1) {
+		capacity = 1;
+	} else if (capacity > BOND_TABLE_MAX) {
+		capacity = BOND_TABLE_MAX;
+	}
+	table->capacity = (uint8_t)capacity;
+}
+
+int bond_table_find(const struct bond_table *table, const uint8_t addr[BOND_TABLE_ADDR_LEN])
+{
+	uint32_t slot = addr_hash(addr) & (BOND_TABLE_SLOTS - 1);
+
+	while (table->index[slot] != 0) {
+		int pos = table->index[slot] - 1;
+
+		if (memcmp(table->addr[pos], addr, BOND_TABLE_ADDR_LEN) == 0) {
+			return pos;
+		}
+		slot = (slot + 1) & (BOND_TABLE_SLOTS - 1);
+	}
+	return -1;
+}
+
+enum bond_table_result bond_table_use(struct bond_table *table,
+				      const uint8_t addr[BOND_TABLE_ADDR_LEN],
+				      uint8_t evicted[BOND_TABLE_ADDR_LEN])
+{
+	enum bond_table_result result = BOND_TABLE_CHANGED;
+	int pos = bond_table_find(table, addr);
+
+	if (pos == 0) {
+		return BOND_TABLE_UNCHANGED;
+	}
+	if (pos < 0) {
+		if (table->count == table->capacity) {
+			if (evicted) {
+				memcpy(evicted, table->addr[table->count - 1], BOND_TABLE_ADDR_LEN);
+			}
+			result = BOND_TABLE_EVICTED;
+		} else {
+			table->count++;
+		}
+		pos = table->count - 1;
+	}
+
+	memmove(table->addr[1], table->addr[0], (size_t)pos * BOND_TABLE_ADDR_LEN);
+	memcpy(table->addr[0], addr, BOND_TABLE_ADDR_LEN);
+	reindex(table);
+	return result;
+}
+
+bool bond_table_remove(struct bond_table *table, const uint8_t addr[BOND_TABLE_ADDR_LEN])
+{
+	int pos = bond_table_find(table, addr);
+
+	if (pos < 0) {
+		return false;
+	}
+	memmove(table->addr[pos], table->addr[pos + 1],
+		(size_t)(table->count - pos - 1) * BOND_TABLE_ADDR_LEN);
+	table->count--;
+	memset(table->addr[table->count], 0, BOND_TABLE_ADDR_LEN);
+	reindex(table);
+	return true;
+}
+
+void bond_table_clear(struct bond_table *table)
+{
+	bond_table_init(table, table->capacity);
+}
+
+const uint8_t *bond_table_get(const struct bond_table *table, size_t pos)
+{
+	return pos < table->count ? table->addr[pos] : NULL;
+}
+
+size_t bond_table_save(const struct bond_table *table, uint8_t *buf, size_t len)
+{
+	size_t size = 2 + (size_t)table->count * BOND_TABLE_ADDR_LEN;
+
+	if (len < size) {
+		return 0;
+	}
+	buf[0] = BOND_TABLE_BLOB_VERSION;
+	buf[1] = table->count;
+	memcpy(&buf[2], table->addr, (size_t)table->count * BOND_TABLE_ADDR_LEN);
+	return size;
+}
+
+bool bond_table_load(struct bond_table *table, const uint8_t *buf, size_t len)
+{
+	size_t count;
+
+	bond_table_clear(table);
+	if (len < 2 || buf[0] != BOND_TABLE_BLOB_VERSION) {
+		return false;
+	}
+	count = buf[1];
+	if (len != 2 + count * BOND_TABLE_ADDR_LEN) {
+		return false;
+	}
+	if (count > table->capacity) {
+		count = table->capacity;
+	}
+	memcpy(table->addr, &buf[2], count * BOND_TABLE_ADDR_LEN);
+	table->count = (uint8_t)count;
+	reindex(table);
+	return true;
+}
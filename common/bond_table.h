@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Bonded MouthPad addresses, most recently used first, shared by
+ *         both relays
+ *
+ * The table holds up to capacity addresses in use order. Lookups go
+ * through a small open-addressed hash index, so checking a scan result
+ * against the bonds costs a hash and, nearly always, one compare however
+ * full the table is. Adding an address that is already there moves it to
+ * the front; adding one to a full table drops the least recently used.
+ *
+ * The whole table saves to one blob, most recent first, so a platform
+ * stores it with a single write and loads it with a single read:
+ *
+ *   version  1 byte, BOND_TABLE_BLOB_VERSION
+ *   count    1 byte
+ *   address  BOND_TABLE_ADDR_LEN bytes each, count of them
+ *
+ * Callers lock.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef BOND_TABLE_H_
+#define BOND_TABLE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOND_TABLE_ADDR_LEN 6
+#define BOND_TABLE_MAX      8
+
+/* Index slots; a power of two at least twice BOND_TABLE_MAX */
+#define BOND_TABLE_SLOTS 16
+
+#define BOND_TABLE_BLOB_VERSION 1
+#define BOND_TABLE_BLOB_MAX     (2 + BOND_TABLE_MAX * BOND_TABLE_ADDR_LEN)
+
+struct bond_table {
+	uint8_t addr[BOND_TABLE_MAX][BOND_TABLE_ADDR_LEN]; /* Most recent first */
+	uint8_t count;
+	uint8_t capacity;
+	uint8_t index[BOND_TABLE_SLOTS]; /* Position + 1; 0 is empty */
+};
+
+enum bond_table_result {
+	BOND_TABLE_UNCHANGED, /* Already the most recent */
+	BOND_TABLE_CHANGED,   /* Added, or moved to the front */
+	BOND_TABLE_EVICTED,   /* Added, and the least recent dropped */
+};
+
+/**
+ * @brief Empty table
+ *
+ * @param capacity Addresses kept, 1 .. BOND_TABLE_MAX
+ */
+void bond_table_init(struct bond_table *table, size_t capacity);
+
+/**
+ * @brief Position of an address, 0 the most recent
+ *
+ * @return -1 when not bonded
+ */
+int bond_table_find(const struct bond_table *table, const uint8_t addr[BOND_TABLE_ADDR_LEN]);
+
+static inline bool bond_table_contains(const struct bond_table *table,
+				       const uint8_t addr[BOND_TABLE_ADDR_LEN])
+{
+	return bond_table_find(table, addr) >= 0;
+}
+
+/**
+ * @brief Make an address the most recently used, adding it if needed
+ *
+ * @param evicted Set to the dropped address on BOND_TABLE_EVICTED; may be
+ *                NULL
+ */
+enum bond_table_result bond_table_use(struct bond_table *table,
+				      const uint8_t addr[BOND_TABLE_ADDR_LEN],
+				      uint8_t evicted[BOND_TABLE_ADDR_LEN]);
+
+/**
+ * @return false when the address was not bonded
+ */
+bool bond_table_remove(struct bond_table *table, const uint8_t addr[BOND_TABLE_ADDR_LEN]);
+
+void bond_table_clear(struct bond_table *table);
+
+static inline size_t bond_table_count(const struct bond_table *table)
+{
+	return table->count;
+}
+
+/**
+ * @brief Address at a position, 0 the most recent
+ *
+ * @return NULL past the end
+ */
+const uint8_t *bond_table_get(const struct bond_table *table, size_t pos);
+
+/**
+ * @brief Table as a blob
+ *
+ * @return Bytes written, 0 when len is too small
+ */
+size_t bond_table_save(const struct bond_table *table, uint8_t *buf, size_t len);
+
+/**
+ * @brief Replace the table with a saved blob
+ *
+ * Addresses past the capacity, the least recent, are dropped.
+ *
+ * @return false, leaving the table empty, on a malformed blob
+ */
+bool bond_table_load(struct bond_table *table, const uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOND_TABLE_H_ */
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+
+#include "connection_timing.h"
+#include "fault_inject.h"
+#include "link_history.h"
+#include "trace_ring.h"
+
+_Static_assert(CONNECTION_TIMING_RECORDS ==
+		       pb_arraysize(mouthware_message_ConnectionTimingResponse, records),
+	       "ConnectionTimingResponse no longer holds every kept record");
+
+static uint32_t (*clock_ms)(void);
+
+static struct connection_timing_record records[CONNECTION_TIMING_RECORDS];
+static uint32_t scan_start_ms;
+static uint32_t next_sequence = 1;
+static size_t newest;  /* Index of the newest record */
+static size_t count;   /* Records kept, including an open one */
+static uint32_t boot_phase_ms[CONNECTION_TIMING_BOOT_PHASE_COUNT];
+
+static struct connection_timing_record *open_record(void)
+{
+	if (count == 0 || !records[newest].in_progress) {
+		return NULL;
+	}
+
+	return &records[newest];
+}
+
+void connection_timing_init(uint32_t (*now_ms)(void))
+{
+	clock_ms = now_ms;
+}
+
+void connection_timing_boot_mark(enum connection_timing_boot_phase phase)
+{
+	if (!clock_ms || phase >= CONNECTION_TIMING_BOOT_PHASE_COUNT || boot_phase_ms[phase] != 0) {
+		return;
+	}
+
+	uint32_t now = clock_ms();
+
+	boot_phase_ms[phase] = now > 0 ? now : 1;
+}
+
+uint32_t connection_timing_boot_ms(enum connection_timing_boot_phase phase)
+{
+	return phase < CONNECTION_TIMING_BOOT_PHASE_COUNT ? boot_phase_ms[phase] : 0;
+}
+
+void connection_timing_scan_started(void)
+{
+	connection_timing_boot_mark(CONNECTION_TIMING_BOOT_SCAN_STARTED);
+	if (!clock_ms || open_record()) {
+		return;
+	}
+
+	if (count > 0) {
+		newest = (newest + 1) % CONNECTION_TIMING_RECORDS;
+	}
+	if (count < CONNECTION_TIMING_RECORDS) {
+		count++;
+	}
+
+	records[newest] = (struct connection_timing_record){
+		.sequence = next_sequence++,
+		.in_progress = true,
+	};
+	scan_start_ms = clock_ms();
+}
+
+void connection_timing_mark(enum connection_timing_phase phase)
+{
+	struct connection_timing_record *record = open_record();
+
+	if (phase == CONNECTION_TIMING_HID_READY) {
+		connection_timing_boot_mark(CONNECTION_TIMING_BOOT_HID_READY);
+	}
+
+	if (!record || phase >= CONNECTION_TIMING_PHASE_COUNT || record->phase_ms[phase] != 0) {
+		return;
+	}
+
+	/* 0 means not reached, so a phase in the scan's first millisecond counts as 1 */
+	uint32_t elapsed = clock_ms() - scan_start_ms;
+
+	record->phase_ms[phase] = elapsed > 0 ? elapsed : 1;
+	trace_ring_record(TRACE_EVENT_PHASE, phase, elapsed);
+	if (phase == CONNECTION_TIMING_CONNECTED) {
+		link_history_connected();
+	}
+	fault_inject_phase(phase);
+}
+
+void connection_timing_set_bonded(bool bonded)
+{
+	struct connection_timing_record *record = open_record();
+
+	if (record) {
+		record->bonded = bonded;
+	}
+}
+
+void connection_timing_set_att_bearers(uint32_t bearers)
+{
+	struct connection_timing_record *record = open_record();
+
+	if (record) {
+		record->att_bearers = bearers;
+	}
+}
+
+void connection_timing_disconnected(void)
+{
+	struct connection_timing_record *record = open_record();
+
+	if (record) {
+		record->in_progress = false;
+	}
+}
+
+void connection_timing_clear(void)
+{
+	count = open_record() ? 1 : 0;
+}
+
+size_t connection_timing_get(struct connection_timing_record *out)
+{
+	size_t n = count;
+
+	for (size_t i = 0; i < n; i++) {
+		size_t index = (newest + CONNECTION_TIMING_RECORDS - i) % CONNECTION_TIMING_RECORDS;
+
+		out[i] = records[index];
+	}
+
+	return n;
+}
+
+const char *connection_timing_phase_name(enum connection_timing_phase phase)
+{
+	static const char *const names[CONNECTION_TIMING_PHASE_COUNT] = {
+		[CONNECTION_TIMING_FIRST_ADV] = "adv",
+		[CONNECTION_TIMING_CONNECT_REQUEST] = "req",
+		[CONNECTION_TIMING_CONNECTED] = "conn",
+		[CONNECTION_TIMING_SECURITY] = "sec",
+		[CONNECTION_TIMING_HID_READY] = "hid",
+		[CONNECTION_TIMING_NUS_READY] = "nus",
+		[CONNECTION_TIMING_DIS_READY] = "dis",
+		[CONNECTION_TIMING_BAS_READY] = "bas",
+	};
+
+	return phase < CONNECTION_TIMING_PHASE_COUNT ? names[phase] : "?";
+}
+
+size_t connection_timing_format(const struct connection_timing_record *record, char *buf,
+				size_t size)
+{
+	size_t len = 0;
+	int n;
+
+	if (size == 0) {
+		return 0;
+	}
+
+	n = snprintf(buf, size, "#%u %s%s:", (unsigned int)record->sequence,
+		     record->bonded ? "bonded" : "new",
+		     record->in_progress ? ", in progress" : "");
+	if (n > 0) {
+		len = (size_t)n;
+	}
+
+	for (int phase = 0; phase < CONNECTION_TIMING_PHASE_COUNT && len < size; phase++) {
+		const char *name = connection_timing_phase_name(phase);
+
+		if (record->phase_ms[phase] != 0) {
+			n = snprintf(&buf[len], size - len, " %s %u", name,
+				     (unsigned int)record->phase_ms[phase]);
+		} else {
+			n = snprintf(&buf[len], size - len, " %s -", name);
+		}
+		if (n > 0) {
+			len += (size_t)n;
+		}
+	}
+
+	if (record->att_bearers != 0 && len < size) {
+		n = snprintf(&buf[len], size - len, " att %u", (unsigned int)record->att_bearers);
+		if (n > 0) {
+			len += (size_t)n;
+		}
+	}
+
+	return len < size ? len : size - 1;
+}
+
+size_t connection_timing_format_boot(char *buf, size_t size)
+{
+	static const char *const names[CONNECTION_TIMING_BOOT_PHASE_COUNT] = {
+		[CONNECTION_TIMING_BOOT_USB_STARTED] = "usbup",
+		[CONNECTION_TIMING_BOOT_BLE_READY] = "ble",
+		[CONNECTION_TIMING_BOOT_SCAN_STARTED] = "scan",
+		[CONNECTION_TIMING_BOOT_USB_ENUMERATED] = "usb",
+		[CONNECTION_TIMING_BOOT_HID_READY] = "hid",
+	};
+	size_t len = 0;
+	int n;
+
+	if (size == 0) {
+		return 0;
+	}
+
+	n = snprintf(buf, size, "boot:");
+	if (n > 0) {
+		len = (size_t)n;
+	}
+
+	for (int phase = 0; phase < CONNECTION_TIMING_BOOT_PHASE_COUNT && len < size; phase++) {
+		if (boot_phase_ms[phase] != 0) {
+			n = snprintf(&buf[len], size - len, " %s %u", names[phase],
+				     (unsigned int)boot_phase_ms[phase]);
+		} else {
+			n = snprintf(&buf[len], size - len, " %s -", names[phase]);
+		}
+		if (n > 0) {
+			len += (size_t)n;
+		}
+	}
+
+	return len < size ? len : size - 1;
+}
+
+void connection_timing_fill_response(mouthware_message_ConnectionTimingResponse *response)
+{
+	struct connection_timing_record kept[CONNECTION_TIMING_RECORDS];
+	size_t n = connection_timing_get(kept);
+
+	response->records_count = (pb_size_t)n;
+	response->boot_usb_enumerated_ms = boot_phase_ms[CONNECTION_TIMING_BOOT_USB_ENUMERATED];
+	response->boot_hid_ready_ms = boot_phase_ms[CONNECTION_TIMING_BOOT_HID_READY];
+	response->boot_usb_started_ms = boot_phase_ms[CONNECTION_TIMING_BOOT_USB_STARTED];
+	response->boot_ble_ready_ms = boot_phase_ms[CONNECTION_TIMING_BOOT_BLE_READY];
+	response->boot_scan_started_ms = boot_phase_ms[CONNECTION_TIMING_BOOT_SCAN_STARTED];
+
+	for (size_t i = 0; i < n; i++) {
+		const uint32_t *ms = kept[i].phase_ms;
+
+		response->records[i] = (mouthware_message_ConnectionTimingRecord){
+			.sequence = kept[i].sequence,
+			.bonded = kept[i].bonded,
+			.in_progress = kept[i].in_progress,
+			.first_adv_ms = ms[CONNECTION_TIMING_FIRST_ADV],
+			.connect_request_ms = ms[CONNECTION_TIMING_CONNECT_REQUEST],
+			.connected_ms = ms[CONNECTION_TIMING_CONNECTED],
+			.security_ms = ms[CONNECTION_TIMING_SECURITY],
+			.hid_ready_ms = ms[CONNECTION_TIMING_HID_READY],
+			.nus_ready_ms = ms[CONNECTION_TIMING_NUS_READY],
+			.dis_ready_ms = ms[CONNECTION_TIMING_DIS_READY],
+			.bas_ready_ms = ms[CONNECTION_TIMING_BAS_READY],
+			.att_bearers = kept[i].att_bearers,
+		};
+	}
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Per-phase timing of the relay's connections to the MouthPad
+ *
+ * Each connection attempt gets a record that opens when scanning starts and
+ * closes when the link drops. The BLE code marks the phases it passes on the
+ * way (first advertisement, connection request, link up, encryption, each
+ * service ready) and the record keeps the first time each was reached, as
+ * milliseconds after scanning started. The most recent records are kept for
+ * the shell and for ConnectionTimingRead.
+ *
+ * Marks outside an open record are ignored, so a phase the stack passes
+ * again later in the connection (a second encryption, a battery
+ * notification) does not move its time. Separately, the boot timeline (USB
+ * and Bluetooth stacks up, first scan, USB enumerated, first HID reports)
+ * is kept as milliseconds on the clock itself, which must therefore count
+ * from boot.
+ * Records are written from the
+ * Bluetooth stack's context and may be read while one changes; the values
+ * are diagnostics only.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef CONNECTION_TIMING_H_
+#define CONNECTION_TIMING_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum connection_timing_phase {
+	CONNECTION_TIMING_FIRST_ADV,       /* First matching MouthPad advertisement */
+	CONNECTION_TIMING_CONNECT_REQUEST, /* Connection requested */
+	CONNECTION_TIMING_CONNECTED,       /* Link layer connection established */
+	CONNECTION_TIMING_SECURITY,        /* Link encrypted */
+	CONNECTION_TIMING_HID_READY,       /* HID reports flowing */
+	CONNECTION_TIMING_NUS_READY,       /* NUS notifications enabled */
+	CONNECTION_TIMING_DIS_READY,       /* Device information read */
+	CONNECTION_TIMING_BAS_READY,       /* First battery level received */
+	CONNECTION_TIMING_PHASE_COUNT
+};
+
+enum connection_timing_boot_phase {
+	CONNECTION_TIMING_BOOT_USB_STARTED,    /* USB device stack up, attached to the bus */
+	CONNECTION_TIMING_BOOT_BLE_READY,      /* Bluetooth controller and host up */
+	CONNECTION_TIMING_BOOT_SCAN_STARTED,   /* First scan for the MouthPad */
+	CONNECTION_TIMING_BOOT_USB_ENUMERATED, /* USB configured by the host */
+	CONNECTION_TIMING_BOOT_HID_READY,      /* First HID reports flowing */
+	CONNECTION_TIMING_BOOT_PHASE_COUNT
+};
+
+/* Records kept, newest overwriting oldest */
+#define CONNECTION_TIMING_RECORDS 4
+
+struct connection_timing_record {
+	uint32_t sequence;                               /* Attempt number since boot, from 1 */
+	uint32_t phase_ms[CONNECTION_TIMING_PHASE_COUNT]; /* After scan start, 0 if not reached */
+	uint32_t att_bearers;                            /* Open once secured, 0 if not known */
+	bool bonded;
+	bool in_progress;
+};
+
+/**
+ * @brief Set the millisecond clock phases are timed with
+ *
+ * Must be called before any other function, as early in boot as possible.
+ * The clock counts from boot and may wrap.
+ */
+void connection_timing_init(uint32_t (*now_ms)(void));
+
+/**
+ * @brief Record reaching a boot phase, if not reached since boot
+ *
+ * CONNECTION_TIMING_BOOT_SCAN_STARTED is also recorded by the first
+ * connection_timing_scan_started(), and CONNECTION_TIMING_BOOT_HID_READY
+ * by the first CONNECTION_TIMING_HID_READY mark.
+ */
+void connection_timing_boot_mark(enum connection_timing_boot_phase phase);
+
+/**
+ * @brief Milliseconds after boot a boot phase was reached, 0 if not yet
+ */
+uint32_t connection_timing_boot_ms(enum connection_timing_boot_phase phase);
+
+/**
+ * @brief Scanning started; opens a record unless one is already open
+ *
+ * A scan restarted after a failed connection attempt stays in the same
+ * record.
+ */
+void connection_timing_scan_started(void);
+
+/**
+ * @brief Record reaching a phase in the open record, if not reached yet
+ */
+void connection_timing_mark(enum connection_timing_phase phase);
+
+/**
+ * @brief Note whether the open record is a reconnect to a bonded MouthPad
+ */
+void connection_timing_set_bonded(bool bonded);
+
+/**
+ * @brief Note how many ATT bearers the open record's link has
+ *
+ * One unenhanced bearer plus any Enhanced ATT ones; shown as "att" by
+ * connection_timing_format().
+ */
+void connection_timing_set_att_bearers(uint32_t bearers);
+
+/**
+ * @brief The link dropped; closes the open record
+ */
+void connection_timing_disconnected(void);
+
+/**
+ * @brief Forget every record except the open one; boot phases are kept
+ */
+void connection_timing_clear(void);
+
+/**
+ * @brief Copy the kept records, newest first
+ *
+ * @param out At least CONNECTION_TIMING_RECORDS entries
+ * @return Records copied
+ */
+size_t connection_timing_get(struct connection_timing_record *out);
+
+/**
+ * @brief Short name of a phase for logs and the shell
+ */
+const char *connection_timing_phase_name(enum connection_timing_phase phase);
+
+/**
+ * @brief Format a record as one line, e.g. "#3 bonded: adv 41 req 42 ..."
+ *
+ * Phases not reached are shown as "-".
+ *
+ * @return Length of the line, truncated to fit size
+ */
+size_t connection_timing_format(const struct connection_timing_record *record, char *buf,
+				size_t size);
+
+/**
+ * @brief Format the boot phases as one line, e.g. "boot: usb 412 hid 1630"
+ *
+ * @return Length of the line, truncated to fit size
+ */
+size_t connection_timing_format_boot(char *buf, size_t size);
+
+/**
+ * @brief Fill a ConnectionTimingResponse with the kept records and boot phases
+ */
+void connection_timing_fill_response(mouthware_message_ConnectionTimingResponse *response);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONNECTION_TIMING_H_ */
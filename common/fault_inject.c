@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fault_inject.h"
+
+#define FAULT_INJECT_SEED_DEFAULT 0x2545F491u
+
+static struct fault_inject_platform platform;
+
+static atomic_uint drop_permille[FAULT_INJECT_PATH_COUNT];
+static atomic_uint delay_permille[FAULT_INJECT_PATH_COUNT];
+static atomic_uint delay_us[FAULT_INJECT_PATH_COUNT];
+static atomic_uint usb_busy_permille;
+
+/* CDC0 refuses frames while stalled and now is before stall_until_ms */
+static atomic_bool stalled;
+static atomic_uint stall_until_ms;
+
+/* Phase + 1 to drop the link at, 0 for none, and drops left */
+static atomic_uint disconnect_phase;
+static atomic_uint disconnects_left;
+
+static atomic_uint rng_state = FAULT_INJECT_SEED_DEFAULT;
+
+static atomic_uint dropped[FAULT_INJECT_PATH_COUNT];
+static atomic_uint delayed[FAULT_INJECT_PATH_COUNT];
+static atomic_uint usb_busy;
+static atomic_uint cdc_refused;
+static atomic_uint disconnects;
+
+static const char *const path_names[FAULT_INJECT_PATH_COUNT] = {
+	[FAULT_INJECT_HID] = "hid",
+	[FAULT_INJECT_NUS] = "nus",
+};
+
+static uint32_t clamp_permille(uint32_t permille)
+{
+	return permille > 1000 ? 1000 : permille;
+}
+
+/* xorshift32; two contexts racing may draw the same number, which only
+ * makes the run less repeatable, never wrong
+ */
+static uint32_t rng_next(void)
+{
+	uint32_t x = atomic_load_explicit(&rng_state, memory_order_relaxed);
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	atomic_store_explicit(&rng_state, x, memory_order_relaxed);
+	return x;
+}
+
+static bool roll(atomic_uint *permille)
+{
+	uint32_t chance = atomic_load_explicit(permille, memory_order_relaxed);
+
+	return chance > 0 && rng_next() % 1000 < chance;
+}
+
+void fault_inject_init(const struct fault_inject_platform *p)
+{
+	platform = *p;
+	fault_inject_clear();
+}
+
+void fault_inject_set_drop(enum fault_inject_path path, uint32_t permille)
+{
+	if (path < FAULT_INJECT_PATH_COUNT) {
+		atomic_store_explicit(&drop_permille[path], clamp_permille(permille),
+				      memory_order_relaxed);
+	}
+}
+
+void fault_inject_set_delay(enum fault_inject_path path, uint32_t permille, uint32_t us)
+{
+	if (path >= FAULT_INJECT_PATH_COUNT) {
+		return;
+	}
+	if (us > FAULT_INJECT_DELAY_MAX_US) {
+		us = FAULT_INJECT_DELAY_MAX_US;
+	}
+	atomic_store_explicit(&delay_us[path], us, memory_order_relaxed);
+	atomic_store_explicit(&delay_permille[path], us > 0 ? clamp_permille(permille) : 0,
+			      memory_order_relaxed);
+}
+
+void fault_inject_set_usb_busy(uint32_t permille)
+{
+	atomic_store_explicit(&usb_busy_permille, clamp_permille(permille), memory_order_relaxed);
+}
+
+void fault_inject_stall_cdc(uint32_t ms)
+{
+	if (ms == 0 || !platform.now_ms) {
+		atomic_store_explicit(&stalled, false, memory_order_relaxed);
+		return;
+	}
+	if (ms > FAULT_INJECT_STALL_MAX_MS) {
+		ms = FAULT_INJECT_STALL_MAX_MS;
+	}
+	atomic_store_explicit(&stall_until_ms, platform.now_ms() + ms, memory_order_relaxed);
+	atomic_store_explicit(&stalled, true, memory_order_relaxed);
+}
+
+void fault_inject_set_disconnect(enum connection_timing_phase phase, uint32_t count)
+{
+	if (phase >= CONNECTION_TIMING_PHASE_COUNT || count == 0) {
+		atomic_store_explicit(&disconnect_phase, 0, memory_order_relaxed);
+		atomic_store_explicit(&disconnects_left, 0, memory_order_relaxed);
+		return;
+	}
+	atomic_store_explicit(&disconnects_left, count, memory_order_relaxed);
+	atomic_store_explicit(&disconnect_phase, phase + 1U, memory_order_relaxed);
+}
+
+void fault_inject_seed(uint32_t seed)
+{
+	/* xorshift never leaves 0 */
+	atomic_store_explicit(&rng_state, seed ? seed : FAULT_INJECT_SEED_DEFAULT,
+			      memory_order_relaxed);
+}
+
+void fault_inject_clear(void)
+{
+	for (size_t i = 0; i < FAULT_INJECT_PATH_COUNT; i++) {
+		atomic_store_explicit(&drop_permille[i], 0, memory_order_relaxed);
+		atomic_store_explicit(&delay_permille[i], 0, memory_order_relaxed);
+		atomic_store_explicit(&delay_us[i], 0, memory_order_relaxed);
+		atomic_store_explicit(&dropped[i], 0, memory_order_relaxed);
+		atomic_store_explicit(&delayed[i], 0, memory_order_relaxed);
+	}
+	atomic_store_explicit(&usb_busy_permille, 0, memory_order_relaxed);
+	atomic_store_explicit(&stalled, false, memory_order_relaxed);
+	fault_inject_set_disconnect(CONNECTION_TIMING_PHASE_COUNT, 0);
+	atomic_store_explicit(&usb_busy, 0, memory_order_relaxed);
+	atomic_store_explicit(&cdc_refused, 0, memory_order_relaxed);
+	atomic_store_explicit(&disconnects, 0, memory_order_relaxed);
+}
+
+bool fault_inject_notification(enum fault_inject_path path)
+{
+	if (path >= FAULT_INJECT_PATH_COUNT) {
+		return false;
+	}
+
+	if (roll(&delay_permille[path]) && platform.delay_us) {
+		atomic_fetch_add_explicit(&delayed[path], 1, memory_order_relaxed);
+		platform.delay_us(atomic_load_explicit(&delay_us[path], memory_order_relaxed));
+	}
+
+	if (roll(&drop_permille[path])) {
+		atomic_fetch_add_explicit(&dropped[path], 1, memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+bool fault_inject_usb_busy(void)
+{
+	if (roll(&usb_busy_permille)) {
+		atomic_fetch_add_explicit(&usb_busy, 1, memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+bool fault_inject_cdc_stalled(void)
+{
+	if (!atomic_load_explicit(&stalled, memory_order_relaxed)) {
+		return false;
+	}
+
+	uint32_t until = atomic_load_explicit(&stall_until_ms, memory_order_relaxed);
+
+	/* Wrap-safe: still stalled while until is ahead of now */
+	if ((int32_t)(until - platform.now_ms()) <= 0) {
+		atomic_store_explicit(&stalled, false, memory_order_relaxed);
+		return false;
+	}
+
+	atomic_fetch_add_explicit(&cdc_refused, 1, memory_order_relaxed);
+	return true;
+}
+
+void fault_inject_phase(enum connection_timing_phase phase)
+{
+	if (atomic_load_explicit(&disconnect_phase, memory_order_relaxed) != phase + 1U) {
+		return;
+	}
+
+	unsigned int left = atomic_load_explicit(&disconnects_left, memory_order_relaxed);
+
+	do {
+		if (left == 0) {
+			return;
+		}
+	} while (!atomic_compare_exchange_weak(&disconnects_left, &left, left - 1));
+
+	if (left == 1) {
+		atomic_store_explicit(&disconnect_phase, 0, memory_order_relaxed);
+	}
+	atomic_fetch_add_explicit(&disconnects, 1, memory_order_relaxed);
+	if (platform.disconnect) {
+		platform.disconnect();
+	}
+}
+
+void fault_inject_get_stats(struct fault_inject_stats *stats)
+{
+	for (size_t i = 0; i < FAULT_INJECT_PATH_COUNT; i++) {
+		stats->dropped[i] = atomic_load_explicit(&dropped[i], memory_order_relaxed);
+		stats->delayed[i] = atomic_load_explicit(&delayed[i], memory_order_relaxed);
+	}
+	stats->usb_busy = atomic_load_explicit(&usb_busy, memory_order_relaxed);
+	stats->cdc_refused = atomic_load_explicit(&cdc_refused, memory_order_relaxed);
+	stats->disconnects = atomic_load_explicit(&disconnects, memory_order_relaxed);
+}
+
+static bool parse_u32(const char *s, uint32_t *value)
+{
+	char *end;
+	unsigned long v = strtoul(s, &end, 0);
+
+	if (end == s || *end != '\0' || v > UINT32_MAX) {
+		return false;
+	}
+	*value = (uint32_t)v;
+	return true;
+}
+
+static bool parse_path(const char *s, enum fault_inject_path *path)
+{
+	for (size_t i = 0; i < FAULT_INJECT_PATH_COUNT; i++) {
+		if (strcmp(s, path_names[i]) == 0) {
+			*path = (enum fault_inject_path)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_phase(const char *s, enum connection_timing_phase *phase)
+{
+	for (size_t i = 0; i < CONNECTION_TIMING_PHASE_COUNT; i++) {
+		if (strcmp(s, connection_timing_phase_name((enum connection_timing_phase)i)) == 0) {
+			*phase = (enum connection_timing_phase)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+int fault_inject_command(size_t argc, char **argv)
+{
+	enum fault_inject_path path;
+	enum connection_timing_phase phase;
+	uint32_t a;
+	uint32_t b = 1;
+
+	if (argc == 1 && strcmp(argv[0], "off") == 0) {
+		fault_inject_clear();
+		return 0;
+	}
+	if (argc == 3 && strcmp(argv[0], "drop") == 0 && parse_path(argv[1], &path) &&
+	    parse_u32(argv[2], &a)) {
+		fault_inject_set_drop(path, a);
+		return 0;
+	}
+	if (argc == 4 && strcmp(argv[0], "delay") == 0 && parse_path(argv[1], &path) &&
+	    parse_u32(argv[2], &a) && parse_u32(argv[3], &b)) {
+		fault_inject_set_delay(path, a, b);
+		return 0;
+	}
+	if (argc == 2 && strcmp(argv[0], "usbbusy") == 0 && parse_u32(argv[1], &a)) {
+		fault_inject_set_usb_busy(a);
+		return 0;
+	}
+	if (argc == 2 && strcmp(argv[0], "cdcstall") == 0 && parse_u32(argv[1], &a)) {
+		fault_inject_stall_cdc(a);
+		return 0;
+	}
+	if ((argc == 2 || argc == 3) && strcmp(argv[0], "disconnect") == 0 &&
+	    parse_phase(argv[1], &phase) && (argc == 2 || parse_u32(argv[2], &b))) {
+		fault_inject_set_disconnect(phase, b);
+		return 0;
+	}
+	if (argc == 2 && strcmp(argv[0], "seed") == 0 && parse_u32(argv[1], &a)) {
+		fault_inject_seed(a);
+		return 0;
+	}
+	return -1;
+}
+
+int fault_inject_format(size_t index, char *buf, size_t len)
+{
+	struct fault_inject_stats stats;
+
+	fault_inject_get_stats(&stats);
+
+	if (index < FAULT_INJECT_PATH_COUNT) {
+		return snprintf(buf, len,
+				"%s: drop %u/1000 (%u dropped), delay %u us %u/1000 (%u delayed)",
+				path_names[index],
+				atomic_load_explicit(&drop_permille[index], memory_order_relaxed),
+				(unsigned int)stats.dropped[index],
+				atomic_load_explicit(&delay_us[index], memory_order_relaxed),
+				atomic_load_explicit(&delay_permille[index], memory_order_relaxed),
+				(unsigned int)stats.delayed[index]);
+	}
+	index -= FAULT_INJECT_PATH_COUNT;
+
+	if (index == 0) {
+		return snprintf(buf, len, "usb busy: %u/1000 (%u refused)",
+				atomic_load_explicit(&usb_busy_permille, memory_order_relaxed),
+				(unsigned int)stats.usb_busy);
+	}
+	if (index == 1) {
+		uint32_t left_ms = 0;
+
+		if (atomic_load_explicit(&stalled, memory_order_relaxed) && platform.now_ms) {
+			int32_t left = (int32_t)(atomic_load_explicit(&stall_until_ms,
+								      memory_order_relaxed) -
+						 platform.now_ms());
+
+			left_ms = left > 0 ? (uint32_t)left : 0;
+		}
+		return snprintf(buf, len, "cdc stall: %u ms left (%u refused)", (unsigned int)left_ms,
+				(unsigned int)stats.cdc_refused);
+	}
+	if (index == 2) {
+		unsigned int phase = atomic_load_explicit(&disconnect_phase, memory_order_relaxed);
+
+		if (phase == 0) {
+			return snprintf(buf, len, "disconnect: off (%u done)",
+					(unsigned int)stats.disconnects);
+		}
+		return snprintf(buf, len, "disconnect: at %s, %u left (%u done)",
+				connection_timing_phase_name((enum connection_timing_phase)(phase - 1)),
+				atomic_load_explicit(&disconnects_left, memory_order_relaxed),
+				(unsigned int)stats.disconnects);
+	}
+	return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Fault injection for bench builds, shared by both relays
+ *
+ * Makes the conditions the coalescing, credit, sensor codec and reconnect
+ * code exists for happen on demand, so how the relay holds up under them
+ * can be measured on the bench:
+ *
+ * - HID and NUS notifications from the MouthPad dropped, or held up by a
+ *   busy-wait before they are handled, each with its own chance per
+ *   notification
+ * - USB HID IN reported busy to the forwarding path
+ * - CDC0 TX refusing frames, as with a host that stopped reading, for a
+ *   given time
+ * - The MouthPad link dropped on reaching a connection phase (see
+ *   connection_timing.h), a given number of times
+ *
+ * Chances are per mille and drawn from one xorshift generator, so a run
+ * with the same seed and traffic repeats. The platform calls the hooks at
+ * its boundaries only when built with fault injection (CONFIG_RELAY_FAULT_INJECT,
+ * CONFIG_MOUTHPAD_FAULT_INJECT); everything starts off and is set from the
+ * console with fault_inject_command(). Hooks may be called from any
+ * context; a setting changed meanwhile may apply one notification late.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef FAULT_INJECT_H_
+#define FAULT_INJECT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "connection_timing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Longest hold-up of one notification */
+#define FAULT_INJECT_DELAY_MAX_US 100000
+
+/* Longest CDC0 stall asked for at once */
+#define FAULT_INJECT_STALL_MAX_MS 60000
+
+enum fault_inject_path {
+	FAULT_INJECT_HID, /* HOGP input report notifications */
+	FAULT_INJECT_NUS, /* NUS notifications */
+	FAULT_INJECT_PATH_COUNT
+};
+
+struct fault_inject_platform {
+	/* Milliseconds since boot; may wrap */
+	uint32_t (*now_ms)(void);
+
+	/* Busy-wait, in the caller's context */
+	void (*delay_us)(uint32_t us);
+
+	/* Drop the primary MouthPad link; called from wherever the phase
+	 * was marked
+	 */
+	void (*disconnect)(void);
+};
+
+struct fault_inject_stats {
+	uint32_t dropped[FAULT_INJECT_PATH_COUNT];
+	uint32_t delayed[FAULT_INJECT_PATH_COUNT];
+	uint32_t usb_busy;    /* HID reports refused */
+	uint32_t cdc_refused; /* CDC0 frames refused during a stall */
+	uint32_t disconnects;
+};
+
+/**
+ * @brief Install the platform hooks; everything stays off
+ */
+void fault_inject_init(const struct fault_inject_platform *platform);
+
+/* Settings; a chance of 0 turns the fault off */
+void fault_inject_set_drop(enum fault_inject_path path, uint32_t permille);
+void fault_inject_set_delay(enum fault_inject_path path, uint32_t permille, uint32_t delay_us);
+void fault_inject_set_usb_busy(uint32_t permille);
+void fault_inject_stall_cdc(uint32_t ms);
+void fault_inject_set_disconnect(enum connection_timing_phase phase, uint32_t count);
+void fault_inject_seed(uint32_t seed);
+
+/**
+ * @brief Turn every fault off and clear the counts
+ */
+void fault_inject_clear(void);
+
+/**
+ * @brief Hook for a notification arriving on path
+ *
+ * Holds the caller up first if the notification was picked for a delay.
+ *
+ * @return true if the notification should be dropped
+ */
+bool fault_inject_notification(enum fault_inject_path path);
+
+/**
+ * @brief Hook before a HID report is submitted to USB
+ *
+ * @return true if the submit should fail as if the IN endpoint were busy
+ */
+bool fault_inject_usb_busy(void);
+
+/**
+ * @brief Hook before a frame is queued for CDC0
+ *
+ * @return true if the frame should be refused as if the TX buffer were full
+ */
+bool fault_inject_cdc_stalled(void);
+
+/**
+ * @brief Hook for a connection phase reached; called by connection_timing
+ */
+void fault_inject_phase(enum connection_timing_phase phase);
+
+void fault_inject_get_stats(struct fault_inject_stats *stats);
+
+/**
+ * @brief Apply a console command
+ *
+ * argv holds the words after "fault":
+ *
+ *   off                            everything off, counts cleared
+ *   drop hid|nus <permille>
+ *   delay hid|nus <permille> <us>
+ *   usbbusy <permille>
+ *   cdcstall <ms>
+ *   disconnect <phase> [count]     phase as connection_timing_phase_name()
+ *   seed <n>
+ *
+ * @return 0, or -1 for a command that is not understood
+ */
+int fault_inject_command(size_t argc, char **argv);
+
+/**
+ * @brief Format line index of the settings and counts
+ *
+ * @return Characters written, 0 past the last line
+ */
+int fault_inject_format(size_t index, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAULT_INJECT_H_ */
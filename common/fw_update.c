@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fw_update.h"
+#include "mouthpad_frame.h"
+
+_Static_assert((FW_UPDATE_SLOTS & (FW_UPDATE_SLOTS - 1)) == 0,
+	       "FW_UPDATE_SLOTS must be a power of two");
+
+/* 3 bytes go to the RelayToAppMessage tag and length */
+_Static_assert(mouthware_message_FwUpdateStatus_size <= MOUTHPAD_FRAME_MAX_PAYLOAD - 3,
+	       "FwUpdateStatus does not fit a frame");
+
+/* phase packs a generation, bumped by every FwUpdateStart, above the
+ * state. The RX path starts a generation, the writer moves its state on,
+ * and each side changes it by compare-and-swap so a writer still busy with
+ * the last generation cannot overwrite the next one.
+ */
+#define PHASE(generation, state) (((generation) << 8) | (state))
+#define PHASE_GENERATION(phase) ((phase) >> 8)
+#define PHASE_STATE(phase) ((phase) & 0xff)
+
+/* end_request packs the generation with one of these */
+enum end_kind {
+	END_NONE,
+	END_FINISH,
+	END_REBOOT,
+	END_ABORT,
+};
+
+struct slot {
+	uint32_t offset;
+	uint16_t len;
+	uint8_t data[FW_UPDATE_CHUNK_MAX];
+};
+
+static const struct fw_update_ops *ops;
+static atomic_uint phase;
+static atomic_uint end_request;
+static atomic_bool status_due;
+
+/* Chunk ring: the RX path fills at head, the writer empties at tail */
+static struct slot slots[FW_UPDATE_SLOTS];
+static atomic_uint head;
+static atomic_uint tail;
+
+/* Owned by the RX path; start_* are read by the writer under phase */
+static uint32_t start_size;
+static uint8_t start_sha256[FW_UPDATE_SHA256_LEN];
+static atomic_uint rx_offset;
+static atomic_uint dropped;
+
+/* Owned by the writer */
+static unsigned int open_generation;
+static bool opened;
+static uint8_t sha256[FW_UPDATE_SHA256_LEN];
+static atomic_uint size;
+static atomic_uint written;
+static atomic_uint error;
+static atomic_int detail;
+
+void fw_update_init(const struct fw_update_ops *platform_ops)
+{
+	ops = platform_ops;
+}
+
+static void request_status(void)
+{
+	atomic_store_explicit(&status_due, true, memory_order_relaxed);
+	ops->kick();
+}
+
+static void handle_start(const mouthware_message_FwUpdateStart *start)
+{
+	unsigned int old = atomic_load_explicit(&phase, memory_order_relaxed);
+
+	start_size = start->size;
+	memset(start_sha256, 0, sizeof(start_sha256));
+	memcpy(start_sha256, start->sha256.bytes,
+	       start->sha256.size < sizeof(start_sha256) ? start->sha256.size
+							 : sizeof(start_sha256));
+	atomic_store_explicit(&rx_offset, 0, memory_order_relaxed);
+
+	/* Release: the parameters above are visible with the new generation */
+	while (!atomic_compare_exchange_weak_explicit(
+		&phase, &old, PHASE(PHASE_GENERATION(old) + 1, FW_UPDATE_PREPARING),
+		memory_order_release, memory_order_relaxed)) {
+	}
+
+	ops->kick();
+}
+
+static int handle_chunk(const mouthware_message_FwUpdateChunk *chunk)
+{
+	unsigned int state = PHASE_STATE(atomic_load_explicit(&phase, memory_order_acquire));
+	uint32_t expected = atomic_load_explicit(&rx_offset, memory_order_relaxed);
+	unsigned int h = atomic_load_explicit(&head, memory_order_relaxed);
+	size_t len = chunk->data.size;
+
+	if (state != FW_UPDATE_RECEIVING || chunk->offset != expected || len == 0 ||
+	    len > FW_UPDATE_CHUNK_MAX || len > start_size - expected ||
+	    h - atomic_load_explicit(&tail, memory_order_acquire) >= FW_UPDATE_SLOTS) {
+		atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+		request_status();
+		return -1;
+	}
+
+	struct slot *slot = &slots[h & (FW_UPDATE_SLOTS - 1)];
+
+	slot->offset = chunk->offset;
+	slot->len = (uint16_t)len;
+	memcpy(slot->data, chunk->data.bytes, len);
+
+	atomic_store_explicit(&rx_offset, expected + len, memory_order_relaxed);
+	atomic_store_explicit(&head, h + 1, memory_order_release);
+	ops->kick();
+	return 0;
+}
+
+static void handle_end(const mouthware_message_FwUpdateEnd *end)
+{
+	unsigned int now = atomic_load_explicit(&phase, memory_order_relaxed);
+	enum end_kind kind = end->abort ? END_ABORT : end->reboot ? END_REBOOT : END_FINISH;
+
+	if (PHASE_STATE(now) == FW_UPDATE_IDLE) {
+		request_status();
+		return;
+	}
+
+	atomic_store_explicit(&end_request, PHASE(PHASE_GENERATION(now), kind),
+			      memory_order_relaxed);
+	ops->kick();
+}
+
+int fw_update_handle(const mouthware_message_AppToRelayMessage *message)
+{
+	if (!ops) {
+		return -1;
+	}
+
+	switch (message->which_message_body) {
+	case mouthware_message_AppToRelayMessage_fw_update_start_tag:
+		handle_start(&message->message_body.fw_update_start);
+		return 0;
+	case mouthware_message_AppToRelayMessage_fw_update_chunk_tag:
+		return handle_chunk(&message->message_body.fw_update_chunk);
+	case mouthware_message_AppToRelayMessage_fw_update_end_tag:
+		handle_end(&message->message_body.fw_update_end);
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+void fw_update_get_status(mouthware_message_FwUpdateStatus *status)
+{
+	*status = (mouthware_message_FwUpdateStatus)mouthware_message_FwUpdateStatus_init_zero;
+	status->state = PHASE_STATE(atomic_load_explicit(&phase, memory_order_relaxed));
+	status->size = atomic_load_explicit(&size, memory_order_relaxed);
+	status->offset = atomic_load_explicit(&rx_offset, memory_order_relaxed);
+	status->written = atomic_load_explicit(&written, memory_order_relaxed);
+	status->window = FW_UPDATE_SLOTS;
+	status->chunk_max = FW_UPDATE_CHUNK_MAX;
+	status->error = atomic_load_explicit(&error, memory_order_relaxed);
+	status->detail = atomic_load_explicit(&detail, memory_order_relaxed);
+}
+
+static void send_status(void)
+{
+	mouthware_message_FwUpdateStatus status;
+
+	atomic_store_explicit(&status_due, false, memory_order_relaxed);
+	fw_update_get_status(&status);
+	ops->send_status(&status);
+}
+
+/* Move the open generation from one state to another; false if a newer
+ * FwUpdateStart got there first
+ */
+static bool set_state(enum fw_update_state from, enum fw_update_state to)
+{
+	unsigned int expected = PHASE(open_generation, from);
+
+	return atomic_compare_exchange_strong_explicit(&phase, &expected,
+						       PHASE(open_generation, to),
+						       memory_order_relaxed, memory_order_relaxed);
+}
+
+static bool in_state(enum fw_update_state state)
+{
+	return atomic_load_explicit(&phase, memory_order_acquire) ==
+	       PHASE(open_generation, state);
+}
+
+static void fail(enum fw_update_state from, int err)
+{
+	/* Negative codes are the platform's own */
+	atomic_store_explicit(&error, err < 0 ? FW_UPDATE_ERR_PLATFORM : (unsigned int)err,
+			      memory_order_relaxed);
+	atomic_store_explicit(&detail, err < 0 ? err : 0, memory_order_relaxed);
+
+	if (opened) {
+		ops->abort();
+		opened = false;
+	}
+	if (set_state(from, FW_UPDATE_ERROR)) {
+		send_status();
+	}
+}
+
+static void begin(void)
+{
+	unsigned int now;
+
+	if (opened) {
+		ops->abort();
+		opened = false;
+	}
+
+	/* Copy the parameters, again if another FwUpdateStart lands meanwhile */
+	do {
+		now = atomic_load_explicit(&phase, memory_order_acquire);
+		atomic_store_explicit(&size, start_size, memory_order_relaxed);
+		memcpy(sha256, start_sha256, sizeof(sha256));
+	} while (atomic_load_explicit(&phase, memory_order_acquire) != now);
+
+	open_generation = PHASE_GENERATION(now);
+
+	/* The RX path queues nothing while preparing; whatever is left belongs
+	 * to the update just abandoned
+	 */
+	atomic_store_explicit(&tail, atomic_load_explicit(&head, memory_order_acquire),
+			      memory_order_release);
+	atomic_store_explicit(&written, 0, memory_order_relaxed);
+	atomic_store_explicit(&error, FW_UPDATE_ERR_NONE, memory_order_relaxed);
+	atomic_store_explicit(&detail, 0, memory_order_relaxed);
+
+	if (!in_state(FW_UPDATE_PREPARING)) {
+		return;
+	}
+	send_status();
+
+	int err = ops->begin(start_size);
+
+	if (err) {
+		fail(FW_UPDATE_PREPARING, err);
+		return;
+	}
+
+	opened = true;
+	if (set_state(FW_UPDATE_PREPARING, FW_UPDATE_RECEIVING)) {
+		send_status();
+	}
+}
+
+static void write_chunks(void)
+{
+	unsigned int t = atomic_load_explicit(&tail, memory_order_relaxed);
+
+	while (in_state(FW_UPDATE_RECEIVING) &&
+	       t != atomic_load_explicit(&head, memory_order_acquire)) {
+		const struct slot *slot = &slots[t & (FW_UPDATE_SLOTS - 1)];
+		uint32_t at = atomic_load_explicit(&written, memory_order_relaxed);
+
+		if (slot->offset != at) {
+			fail(FW_UPDATE_RECEIVING, FW_UPDATE_ERR_SEQUENCE);
+			return;
+		}
+
+		int err = ops->write(slot->offset, slot->data, slot->len);
+
+		if (err) {
+			fail(FW_UPDATE_RECEIVING, err);
+			return;
+		}
+
+		atomic_store_explicit(&written, at + slot->len, memory_order_relaxed);
+		atomic_store_explicit(&tail, ++t, memory_order_release);
+		send_status();
+	}
+}
+
+static void end(void)
+{
+	unsigned int request = atomic_load_explicit(&end_request, memory_order_relaxed);
+
+	if (PHASE_GENERATION(request) != open_generation || PHASE_STATE(request) == END_NONE) {
+		return;
+	}
+
+	/* Wait for the chunks sent before the end to be written */
+	if (in_state(FW_UPDATE_RECEIVING) &&
+	    atomic_load_explicit(&tail, memory_order_relaxed) !=
+		    atomic_load_explicit(&head, memory_order_acquire)) {
+		return;
+	}
+
+	if (!atomic_compare_exchange_strong_explicit(&end_request, &request, 0,
+						     memory_order_relaxed, memory_order_relaxed)) {
+		return;
+	}
+
+	if (PHASE_STATE(request) == END_ABORT) {
+		enum fw_update_state from = PHASE_STATE(atomic_load_explicit(&phase,
+									    memory_order_relaxed));
+
+		if (opened) {
+			ops->abort();
+			opened = false;
+		}
+		if (set_state(from, FW_UPDATE_IDLE)) {
+			send_status();
+		}
+		return;
+	}
+
+	if (!in_state(FW_UPDATE_RECEIVING)) {
+		send_status();
+		return;
+	}
+	if (atomic_load_explicit(&written, memory_order_relaxed) != start_size) {
+		fail(FW_UPDATE_RECEIVING, FW_UPDATE_ERR_SHORT);
+		return;
+	}
+	if (!set_state(FW_UPDATE_RECEIVING, FW_UPDATE_VERIFYING)) {
+		return;
+	}
+	send_status();
+
+	int err = ops->finish(atomic_load_explicit(&size, memory_order_relaxed), sha256);
+
+	opened = false;
+	if (err) {
+		fail(FW_UPDATE_VERIFYING, err);
+		return;
+	}
+	if (!set_state(FW_UPDATE_VERIFYING, FW_UPDATE_DONE)) {
+		return;
+	}
+	send_status();
+
+	if (PHASE_STATE(request) == END_REBOOT) {
+		ops->reboot();
+	}
+}
+
+void fw_update_process(void)
+{
+	if (!ops) {
+		return;
+	}
+
+	unsigned int now = atomic_load_explicit(&phase, memory_order_acquire);
+
+	if (PHASE_GENERATION(now) != open_generation) {
+		begin();
+	}
+
+	write_chunks();
+	end();
+
+	if (atomic_load_explicit(&status_due, memory_order_relaxed)) {
+		send_status();
+	}
+}
+
+static const char *state_name(unsigned int state)
+{
+	static const char *const names[] = {
+		[FW_UPDATE_IDLE] = "idle",
+		[FW_UPDATE_PREPARING] = "preparing",
+		[FW_UPDATE_RECEIVING] = "receiving",
+		[FW_UPDATE_VERIFYING] = "verifying",
+		[FW_UPDATE_DONE] = "done, boots next reset",
+		[FW_UPDATE_ERROR] = "error",
+	};
+
+	return state < sizeof(names) / sizeof(names[0]) ? names[state] : "?";
+}
+
+static const char *error_name(unsigned int err)
+{
+	static const char *const names[] = {
+		[FW_UPDATE_ERR_NONE] = "none",
+		[FW_UPDATE_ERR_PLATFORM] = "platform",
+		[FW_UPDATE_ERR_TOO_LARGE] = "too large",
+		[FW_UPDATE_ERR_SEQUENCE] = "out of sequence",
+		[FW_UPDATE_ERR_SHORT] = "short",
+		[FW_UPDATE_ERR_VERIFY] = "verify failed",
+	};
+
+	return err < sizeof(names) / sizeof(names[0]) ? names[err] : "?";
+}
+
+int fw_update_format(char *buf, size_t len)
+{
+	mouthware_message_FwUpdateStatus status;
+	unsigned int drops = atomic_load_explicit(&dropped, memory_order_relaxed);
+
+	fw_update_get_status(&status);
+
+	if (status.state == FW_UPDATE_ERROR) {
+		return snprintf(buf, len, "fw update: error, %s (%d), %u/%u B written",
+				error_name(status.error), (int)status.detail,
+				(unsigned int)status.written, (unsigned int)status.size);
+	}
+
+	return snprintf(buf, len, "fw update: %s, %u/%u B written, %u received, %u dropped",
+			state_name(status.state), (unsigned int)status.written,
+			(unsigned int)status.size, (unsigned int)status.offset, drops);
+}
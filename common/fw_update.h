@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Firmware update streamed over CDC0, shared by both relays
+ *
+ * The host sends FwUpdateStart with the image size and SHA-256, waits for a
+ * FwUpdateStatus in the receiving state, then streams FwUpdateChunks in
+ * order and ends with FwUpdateEnd. The relay keeps running the bridge
+ * throughout: chunks are copied into one of FW_UPDATE_SLOTS buffers on the
+ * CDC0 RX path, and the platform's writer context empties them into the
+ * update slot (MCUboot secondary slot on nRF, the next OTA partition on
+ * ESP). Each written chunk is acknowledged with a FwUpdateStatus.
+ *
+ * Flow control is by credit: the host may have at most window chunks sent
+ * that end beyond FwUpdateStatus.written. A chunk that arrives out of
+ * sequence or without a free buffer is dropped, and the next status tells
+ * the host where to resume.
+ *
+ * FwUpdateEnd verifies the image against the SHA-256, marks it for the
+ * next boot and, if asked, reboots into it. The platform confirms the new
+ * image once it has come up, and the bootloader falls back to the old one
+ * if it does not.
+ *
+ * fw_update_handle() runs on the RX path, fw_update_process() in the writer
+ * context; nothing else is locked.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef FW_UPDATE_H_
+#define FW_UPDATE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Chunk buffers, and so the credit window; a power of two */
+#define FW_UPDATE_SLOTS 4
+
+/* Largest chunk, as in FwUpdateChunk.data */
+#define FW_UPDATE_CHUNK_MAX sizeof(((mouthware_message_FwUpdateChunk *)0)->data.bytes)
+
+#define FW_UPDATE_SHA256_LEN 32
+
+/* FwUpdateStatus.state */
+enum fw_update_state {
+	FW_UPDATE_IDLE,
+	FW_UPDATE_PREPARING,   /* Opening and erasing the update slot */
+	FW_UPDATE_RECEIVING,
+	FW_UPDATE_VERIFYING,
+	FW_UPDATE_DONE,        /* Marked for the next boot */
+	FW_UPDATE_ERROR,
+};
+
+/* FwUpdateStatus.error */
+enum fw_update_error {
+	FW_UPDATE_ERR_NONE,
+	FW_UPDATE_ERR_PLATFORM,  /* detail holds the platform's code */
+	FW_UPDATE_ERR_TOO_LARGE, /* Bigger than the update slot */
+	FW_UPDATE_ERR_SEQUENCE,  /* Chunks reached the writer out of order */
+	FW_UPDATE_ERR_SHORT,     /* Ended before size bytes were written */
+	FW_UPDATE_ERR_VERIFY,    /* SHA-256 mismatch or image rejected */
+};
+
+/* Platform side; every call but kick() comes from fw_update_process() */
+struct fw_update_ops {
+	/* Open the update slot for size bytes, erasing as needed. Return 0,
+	 * FW_UPDATE_ERR_TOO_LARGE as a positive value, or a negative platform
+	 * error.
+	 */
+	int (*begin)(uint32_t size);
+
+	/* Write the next bytes of the image; offsets only ever increase */
+	int (*write)(uint32_t offset, const uint8_t *data, size_t len);
+
+	/* Flush, check size bytes against sha256 and mark them for the next
+	 * boot. Return 0, FW_UPDATE_ERR_VERIFY as a positive value, or a
+	 * negative platform error.
+	 */
+	int (*finish)(uint32_t size, const uint8_t *sha256);
+
+	/* Drop an update in progress; the running image stays */
+	void (*abort)(void);
+
+	/* Reboot into the marked image, once the last status has gone out */
+	void (*reboot)(void);
+
+	/* Send a FwUpdateStatus to the host */
+	void (*send_status)(const mouthware_message_FwUpdateStatus *status);
+
+	/* Arrange for fw_update_process() to run in the writer context; any
+	 * context
+	 */
+	void (*kick)(void);
+};
+
+/**
+ * @brief Install the platform hooks; call once before the first message
+ */
+void fw_update_init(const struct fw_update_ops *ops);
+
+/**
+ * @brief Handle FwUpdateStart, FwUpdateChunk or FwUpdateEnd
+ *
+ * Only copies and flags; cheap enough for the RX path. Register it inline
+ * for all three tags.
+ *
+ * @return 0, or -1 for a chunk that was dropped
+ */
+int fw_update_handle(const mouthware_message_AppToRelayMessage *message);
+
+/**
+ * @brief Do pending work: open the slot, write chunks, finish; writer
+ *        context only
+ */
+void fw_update_process(void);
+
+/**
+ * @brief Current state as sent in FwUpdateStatus
+ */
+void fw_update_get_status(mouthware_message_FwUpdateStatus *status);
+
+/**
+ * @brief Current state as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int fw_update_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FW_UPDATE_H_ */
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hid_idle.h"
+#include "mouthpad_hid_reports.h"
+
+/* Index 0 holds the rate last set for every report */
+static atomic_uint idle_ms[MOUTHPAD_HID_REPORT_ID_MAX + 1];
+
+/* What the host was last sent, relative bytes zeroed */
+static struct {
+	bool known;
+	uint8_t state[MOUTHPAD_HID_REPORT_SIZE_MAX];
+	uint32_t sent_ms;
+} last[MOUTHPAD_HID_REPORT_ID_MAX + 1];
+
+static atomic_uint suppressed;
+static atomic_uint repeats;
+
+static bool valid_id(uint8_t report_id)
+{
+	return report_id >= 1 && report_id <= MOUTHPAD_HID_REPORT_ID_MAX;
+}
+
+void hid_idle_set(uint8_t report_id, uint32_t duration_ms)
+{
+	if (report_id == 0) {
+		for (int id = 0; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+			atomic_store_explicit(&idle_ms[id], duration_ms, memory_order_relaxed);
+		}
+	} else if (valid_id(report_id)) {
+		atomic_store_explicit(&idle_ms[report_id], duration_ms, memory_order_relaxed);
+	}
+}
+
+uint32_t hid_idle_get(uint8_t report_id)
+{
+	if (report_id != 0 && !valid_id(report_id)) {
+		return 0;
+	}
+	return atomic_load_explicit(&idle_ms[report_id], memory_order_relaxed);
+}
+
+static bool idle_ran_out(uint8_t report_id, uint32_t now_ms)
+{
+	uint32_t idle = atomic_load_explicit(&idle_ms[report_id], memory_order_relaxed);
+
+	return idle != 0 && now_ms - last[report_id].sent_ms >= idle;
+}
+
+bool hid_idle_filter(uint8_t report_id, const uint8_t *data, size_t size, uint32_t now_ms)
+{
+	uint8_t mask = mouthpad_hid_report_state_mask(report_id);
+	uint8_t state[MOUTHPAD_HID_REPORT_SIZE_MAX] = {0};
+	bool news = false;
+
+	if (!valid_id(report_id)) {
+		return true;
+	}
+
+	for (size_t i = 0; i < sizeof(state); i++) {
+		uint8_t byte = i < size ? data[i] : 0;
+
+		if (i < 8 && (mask & (1u << i))) {
+			state[i] = byte;
+		} else if (byte != 0) {
+			news = true;
+		}
+	}
+	/* All-relative reports (motion) are news only when they move */
+	if (mask != 0 &&
+	    (!last[report_id].known || memcmp(state, last[report_id].state, sizeof(state)) != 0)) {
+		news = true;
+	}
+
+	if (!news) {
+		if (!idle_ran_out(report_id, now_ms)) {
+			atomic_fetch_add_explicit(&suppressed, 1, memory_order_relaxed);
+			return false;
+		}
+		atomic_fetch_add_explicit(&repeats, 1, memory_order_relaxed);
+	}
+
+	memcpy(last[report_id].state, state, sizeof(state));
+	last[report_id].known = true;
+	last[report_id].sent_ms = now_ms;
+	return true;
+}
+
+void hid_idle_forget(uint8_t report_id)
+{
+	if (report_id == 0) {
+		for (int id = 1; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+			last[id].known = false;
+		}
+	} else if (valid_id(report_id)) {
+		last[report_id].known = false;
+	}
+}
+
+uint8_t hid_idle_repeat(uint32_t id_mask, uint32_t now_ms, uint8_t *data)
+{
+	for (uint8_t id = 1; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+		if (!(id_mask & (1u << id)) || !last[id].known || !idle_ran_out(id, now_ms)) {
+			continue;
+		}
+
+		memcpy(data, last[id].state, sizeof(last[id].state));
+		last[id].sent_ms = now_ms;
+		atomic_fetch_add_explicit(&repeats, 1, memory_order_relaxed);
+		return id;
+	}
+	return 0;
+}
+
+uint32_t hid_idle_next(uint32_t now_ms)
+{
+	uint32_t next = HID_IDLE_NEVER;
+
+	for (int id = 1; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+		uint32_t idle = atomic_load_explicit(&idle_ms[id], memory_order_relaxed);
+		uint32_t elapsed = now_ms - last[id].sent_ms;
+
+		if (idle == 0 || !last[id].known) {
+			continue;
+		}
+		if (elapsed >= idle) {
+			return 0;
+		}
+		if (idle - elapsed < next) {
+			next = idle - elapsed;
+		}
+	}
+	return next;
+}
+
+void hid_idle_reset(void)
+{
+	hid_idle_set(0, 0);
+	hid_idle_forget(0);
+}
+
+void hid_idle_get_stats(struct hid_idle_stats *stats)
+{
+	stats->suppressed = atomic_load_explicit(&suppressed, memory_order_relaxed);
+	stats->repeats = atomic_load_explicit(&repeats, memory_order_relaxed);
+}
+
+int hid_idle_format(char *buf, size_t len)
+{
+	struct hid_idle_stats stats;
+	int n;
+
+	hid_idle_get_stats(&stats);
+	n = snprintf(buf, len, "HID idle (ms):");
+	for (int id = 1; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+		if (n < 0 || (size_t)n >= len) {
+			return n;
+		}
+		n += snprintf(buf + n, len - n, " %d:%u", id, (unsigned int)hid_idle_get(id));
+	}
+	if (n < 0 || (size_t)n >= len) {
+		return n;
+	}
+	return n + snprintf(buf + n, len - n, ", %u redundant suppressed, %u repeats",
+			    (unsigned int)stats.suppressed, (unsigned int)stats.repeats);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief HID idle rates and redundant report suppression, shared by both relays
+ *
+ * The MouthPad notifies at its own pace whether or not anything changed,
+ * so the bridge would forward all-zero motion and button, consumer and
+ * keyboard reports equal to the last one. With SET_IDLE the host says how
+ * often, per report ID, it wants an unchanged report repeated; 0, the
+ * default after a bus reset, means only on change. A report is forwarded
+ * when:
+ *
+ *   - a state byte (buttons, usage, keys) differs from the last one sent
+ *   - a relative byte (motion, wheel, pan) is not zero
+ *   - its ID has an idle rate, and that long has passed since the last
+ *
+ * and hid_idle_repeat() hands back the last state, relative bytes zeroed,
+ * for an ID whose idle rate ran out with nothing sent. Which bytes are
+ * state is mouthpad_hid_report_state_mask().
+ *
+ * hid_idle_set(), hid_idle_get() and the status functions may be called
+ * from any context. The platform serializes the others.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef HID_IDLE_H_
+#define HID_IDLE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* SET_IDLE duration unit */
+#define HID_IDLE_UNIT_MS 4
+
+/* hid_idle_next() with no repeat to come */
+#define HID_IDLE_NEVER UINT32_MAX
+
+struct hid_idle_stats {
+	uint32_t suppressed; /* Redundant reports not forwarded */
+	uint32_t repeats; /* Unchanged reports sent for an idle rate */
+};
+
+/**
+ * @brief Set an idle rate, from SET_IDLE
+ *
+ * @param report_id Report ID, or 0 for every report
+ * @param duration_ms 0 for only on change
+ */
+void hid_idle_set(uint8_t report_id, uint32_t duration_ms);
+
+/**
+ * @brief Idle rate of a report ID, for GET_IDLE
+ *
+ * @return Duration in ms; for ID 0, the last one set for every report
+ */
+uint32_t hid_idle_get(uint8_t report_id);
+
+/**
+ * @brief Check whether an input report is worth sending
+ *
+ * A report that passes is taken as sent; call hid_idle_forget() if it
+ * then could not be.
+ *
+ * @param data Payload as it goes to USB, without the ID byte; shorter
+ *             payloads are taken as zero-filled
+ * @param now_ms Millisecond clock shared with the other calls; may wrap
+ *
+ * @return false if the host would learn nothing from it
+ */
+bool hid_idle_filter(uint8_t report_id, const uint8_t *data, size_t size, uint32_t now_ms);
+
+/**
+ * @brief Let the next report of an ID through whatever it holds
+ *
+ * For a report that passed hid_idle_filter() but was not sent, and after
+ * reports sent around it, such as release-all.
+ *
+ * @param report_id Report ID, or 0 for every report
+ */
+void hid_idle_forget(uint8_t report_id);
+
+/**
+ * @brief Take a repeat whose idle rate ran out
+ *
+ * The lowest report ID due of those in id_mask is taken as sent.
+ *
+ * @param id_mask Bit n for report ID n: the IDs the caller's interface has
+ * @param data MOUTHPAD_HID_REPORT_SIZE_MAX bytes, zero-filled past the state
+ *
+ * @return Report ID, or 0 if none is due
+ */
+uint8_t hid_idle_repeat(uint32_t id_mask, uint32_t now_ms, uint8_t *data);
+
+/**
+ * @brief Time until the next repeat is due
+ *
+ * @return ms, 0 if one is due now, or HID_IDLE_NEVER
+ */
+uint32_t hid_idle_next(uint32_t now_ms);
+
+/**
+ * @brief Back to the power-on state, on a bus reset
+ *
+ * Idle rates go to 0 and every report is forgotten.
+ */
+void hid_idle_reset(void);
+
+void hid_idle_get_stats(struct hid_idle_stats *stats);
+
+/**
+ * @brief Idle rates and counts as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int hid_idle_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HID_IDLE_H_ */
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "hid_mirror.h"
+#include "mouthpad_frame.h"
+#include "pb_encode.h"
+
+_Static_assert((HID_MIRROR_RING_LEN & (HID_MIRROR_RING_LEN - 1)) == 0,
+	       "HID_MIRROR_RING_LEN must be a power of two");
+_Static_assert(HID_MIRROR_BATCH_MAX <= HID_MIRROR_RING_LEN,
+	       "A batch cannot hold more records than the ring");
+
+/* Batch fields, then a tag and length byte per record; 3 bytes go to the
+ * RelayToAppMessage tag and length
+ */
+_Static_assert(1 + 5 + 1 + 10 +
+		       HID_MIRROR_BATCH_MAX * (2 + mouthware_message_HidMirrorRecord_size) <=
+	       MOUTHPAD_FRAME_MAX_PAYLOAD - 3,
+	       "A full HidMirrorBatch does not fit a frame");
+
+#define RECORD_DATA_MAX sizeof(((mouthware_message_HidMirrorRecord_data_t *)0)->bytes)
+
+struct mirror_slot {
+	uint64_t ble_rx_us;
+	uint32_t usb_submit_delay_us;
+	uint32_t sequence;
+	uint8_t report_id;
+	uint8_t len;
+	bool submitted;
+	uint8_t data[RECORD_DATA_MAX];
+};
+
+static atomic_bool enabled;
+
+static struct mirror_slot ring[HID_MIRROR_RING_LEN];
+static atomic_uint ring_head; /* Written by hid_mirror_record() only */
+static atomic_uint ring_tail; /* Written by hid_mirror_fill() only */
+static uint32_t next_sequence; /* Producer only */
+
+/* Records of the batch last filled in, until it is encoded; consumer only */
+static struct mirror_slot batch_slots[HID_MIRROR_BATCH_MAX];
+static size_t batch_count;
+
+void hid_mirror_set_enabled(bool enable)
+{
+	atomic_store(&enabled, enable);
+}
+
+bool hid_mirror_enabled(void)
+{
+	return atomic_load_explicit(&enabled, memory_order_relaxed);
+}
+
+void hid_mirror_record(uint8_t report_id, const uint8_t *data, size_t len,
+		       uint64_t ble_rx_us, uint64_t usb_submit_us, bool submitted)
+{
+	if (!hid_mirror_enabled()) {
+		return;
+	}
+
+	uint32_t sequence = next_sequence++;
+	unsigned int head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+
+	if (head - tail >= HID_MIRROR_RING_LEN) {
+		return;
+	}
+
+	struct mirror_slot *slot = &ring[head & (HID_MIRROR_RING_LEN - 1)];
+	uint64_t delay = usb_submit_us > ble_rx_us ? usb_submit_us - ble_rx_us : 0;
+
+	slot->ble_rx_us = ble_rx_us;
+	slot->usb_submit_delay_us = delay > UINT32_MAX ? UINT32_MAX : (uint32_t)delay;
+	slot->sequence = sequence;
+	slot->report_id = report_id;
+	slot->len = len > RECORD_DATA_MAX ? RECORD_DATA_MAX : (uint8_t)len;
+	slot->submitted = submitted;
+	memcpy(slot->data, data, slot->len);
+
+	atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+}
+
+/* nanopb callback for HidMirrorBatch.records, from batch_slots */
+static bool encode_records(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+	const uint64_t base_us = batch_slots[0].ble_rx_us;
+
+	(void)arg;
+
+	for (size_t i = 0; i < batch_count; i++) {
+		const struct mirror_slot *slot = &batch_slots[i];
+		uint64_t offset = slot->ble_rx_us - base_us;
+		mouthware_message_HidMirrorRecord record = {
+			.report_id = slot->report_id,
+			.data.size = slot->len,
+			.ble_rx_offset_us = offset > UINT32_MAX ? UINT32_MAX : (uint32_t)offset,
+			.usb_submit_delay_us = slot->usb_submit_delay_us,
+			.not_submitted = !slot->submitted,
+		};
+
+		memcpy(record.data.bytes, slot->data, slot->len);
+		if (!pb_encode_tag_for_field(stream, field) ||
+		    !pb_encode_submessage(stream, mouthware_message_HidMirrorRecord_fields,
+					  &record)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool hid_mirror_fill(mouthware_message_HidMirrorBatch *batch)
+{
+	unsigned int tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&ring_head, memory_order_acquire);
+
+	if (!hid_mirror_enabled()) {
+		/* Turned off: what is left belongs to the previous session */
+		atomic_store_explicit(&ring_tail, head, memory_order_release);
+		return false;
+	}
+
+	/* A batch is a run of consecutive sequence numbers; a gap ends it */
+	batch_count = 0;
+	while (tail != head && batch_count < HID_MIRROR_BATCH_MAX) {
+		const struct mirror_slot *slot = &ring[tail & (HID_MIRROR_RING_LEN - 1)];
+
+		if (batch_count && slot->sequence != batch_slots[0].sequence + batch_count) {
+			break;
+		}
+		batch_slots[batch_count++] = *slot;
+		tail++;
+	}
+	atomic_store_explicit(&ring_tail, tail, memory_order_release);
+
+	if (!batch_count) {
+		return false;
+	}
+
+	*batch = (mouthware_message_HidMirrorBatch)mouthware_message_HidMirrorBatch_init_zero;
+	batch->sequence = batch_slots[0].sequence;
+	batch->base_us = batch_slots[0].ble_rx_us;
+	batch->records.funcs.encode = encode_records;
+
+	return true;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief HID mirror stream shared by both relays
+ *
+ * While a host has turned it on with HidMirrorConfigWrite, every HID input
+ * report from the MouthPad is copied here along with the time it arrived
+ * over BLE and the time the relay was done handing it to USB HID. Records
+ * wait in a ring until the platform's flush context, which runs every
+ * HID_MIRROR_FLUSH_MS at low priority, turns them into HidMirrorBatch
+ * messages for CDC0. The HID path never waits on CDC0.
+ *
+ * The ring has one producer, the HID input path, and one consumer, the
+ * flush context. A record that finds the ring full is dropped but still
+ * uses up its sequence number, so the host sees the gap.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef HID_MIRROR_H_
+#define HID_MIRROR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Records waiting for the flush context; must be a power of two */
+#define HID_MIRROR_RING_LEN 32
+
+/* Records per HidMirrorBatch; a full batch of the largest records still
+ * fits one frame
+ */
+#define HID_MIRROR_BATCH_MAX 12
+
+/* How often the platform drains the ring while the mirror is on */
+#define HID_MIRROR_FLUSH_MS 20
+
+/**
+ * @brief Turn the mirror on or off
+ *
+ * Call from anywhere. Records still in the ring when it is turned off are
+ * discarded by the next hid_mirror_fill(), so the platform should run its
+ * flush context once more after turning it off.
+ */
+void hid_mirror_set_enabled(bool enable);
+
+bool hid_mirror_enabled(void);
+
+/**
+ * @brief Mirror one HID input report; call from the HID input path only
+ *
+ * Does nothing while the mirror is off. Payloads longer than a
+ * HidMirrorRecord holds are truncated.
+ *
+ * @param ble_rx_us When the report arrived over BLE
+ * @param usb_submit_us When the relay was done handing it to USB HID
+ * @param submitted false if the report was dropped or folded into a later one
+ */
+void hid_mirror_record(uint8_t report_id, const uint8_t *data, size_t len,
+		       uint64_t ble_rx_us, uint64_t usb_submit_us, bool submitted);
+
+/**
+ * @brief Take the oldest records as a HidMirrorBatch; flush context only
+ *
+ * Call repeatedly until it returns false. The batch refers to records held
+ * here and must be encoded before the next call.
+ *
+ * @return true if batch was filled in and should be sent
+ */
+bool hid_mirror_fill(mouthware_message_HidMirrorBatch *batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HID_MIRROR_H_ */
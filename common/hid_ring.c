@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "hid_ring.h"
+
+_Static_assert((HID_RING_LEN & (HID_RING_LEN - 1)) == 0, "Length a power of two");
+
+void hid_ring_init(struct hid_ring *ring)
+{
+	memset(ring->entry, 0, sizeof(ring->entry));
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+}
+
+struct hid_ring_entry *hid_ring_claim(struct hid_ring *ring)
+{
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	if (head - tail >= HID_RING_LEN) {
+		return NULL;
+	}
+
+	return &ring->entry[head & (HID_RING_LEN - 1)];
+}
+
+void hid_ring_publish(struct hid_ring *ring)
+{
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+const struct hid_ring_entry *hid_ring_peek(struct hid_ring *ring)
+{
+	unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+	if (head == tail) {
+		return NULL;
+	}
+
+	return &ring->entry[tail & (HID_RING_LEN - 1)];
+}
+
+void hid_ring_release(struct hid_ring *ring)
+{
+	unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+	atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
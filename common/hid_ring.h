@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Hand-off of MouthPad HID reports from the Bluetooth receive
+ *         context to the thread that forwards them to USB
+ *
+ * A fixed ring of report copies with one producer and one consumer. The
+ * producer claims the next free entry, fills it in place and publishes it;
+ * the consumer peeks at the oldest entry, forwards it and releases it. No
+ * step blocks or takes a lock, so the receive side spends a copy of a few
+ * bytes and two atomic accesses per report.
+ *
+ * An entry carries the stamps the platform took on arrival, in its own
+ * clocks, so latency is still measured from the notification rather than
+ * from when the forwarding thread got to it. A full ring refuses the
+ * report; the producer counts the drop.
+ *
+ * One thread may produce and one consume; head and tail are atomics with
+ * acquire and release ordering, nothing else is shared.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef HID_RING_H_
+#define HID_RING_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Entries; a power of two so the index survives head and tail wrapping */
+#define HID_RING_LEN 16
+
+/* Largest report kept: a notification at the default ATT MTU, more than
+ * any report the USB descriptor carries
+ */
+#define HID_RING_DATA_MAX 20
+
+struct hid_ring_entry {
+	uint64_t mirror_us;     /* Arrival for the HID mirror, 0 while it is off */
+	uint32_t latency_stamp; /* Arrival for the latency histograms */
+	uint32_t stall_stamp;   /* Arrival for the stall watch */
+	uint8_t report_id;
+	uint8_t size;
+	uint8_t data[HID_RING_DATA_MAX];
+};
+
+struct hid_ring {
+	struct hid_ring_entry entry[HID_RING_LEN];
+	atomic_uint head; /* Next entry to publish; producer writes */
+	atomic_uint tail; /* Next entry to forward; consumer writes */
+};
+
+void hid_ring_init(struct hid_ring *ring);
+
+/**
+ * @brief Producer: the entry to fill next
+ *
+ * @return NULL when every entry is waiting
+ */
+struct hid_ring_entry *hid_ring_claim(struct hid_ring *ring);
+
+/**
+ * @brief Producer: hand the claimed entry to the consumer
+ */
+void hid_ring_publish(struct hid_ring *ring);
+
+/**
+ * @brief Consumer: the oldest waiting entry, left in place
+ *
+ * @return NULL when the ring is empty
+ */
+const struct hid_ring_entry *hid_ring_peek(struct hid_ring *ring);
+
+/**
+ * @brief Consumer: done with the entry hid_ring_peek() returned
+ */
+void hid_ring_release(struct hid_ring *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HID_RING_H_ */
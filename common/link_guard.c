@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "link_guard.h"
+#include "trace_ring.h"
+
+static struct link_guard_config config = {
+	.floor_dbm = -90,
+	.hysteresis_db = 6,
+	.horizon_ms = 4000,
+	.hold_ms = 5000,
+};
+
+/* Readings, owned by the one caller of link_guard_sample() */
+static int8_t rssi_ring[LINK_GUARD_SAMPLES];
+static uint32_t time_ring[LINK_GUARD_SAMPLES];
+static unsigned int count;
+static uint32_t risk_since_ms;
+
+static atomic_bool at_risk;
+static atomic_int last_rssi;
+static atomic_int projected;
+static atomic_uint alerts;
+static atomic_uint drops;
+static atomic_uint drops_warned;
+
+void link_guard_init(const struct link_guard_config *new_config)
+{
+	config = *new_config;
+}
+
+void link_guard_connected(void)
+{
+	count = 0;
+	atomic_store_explicit(&at_risk, false, memory_order_relaxed);
+}
+
+void link_guard_dropped(void)
+{
+	atomic_fetch_add_explicit(&drops, 1, memory_order_relaxed);
+	if (atomic_exchange_explicit(&at_risk, false, memory_order_relaxed)) {
+		atomic_fetch_add_explicit(&drops_warned, 1, memory_order_relaxed);
+	}
+}
+
+/* RSSI horizon_ms ahead, if it keeps falling as it has */
+static int projection(int8_t rssi, uint32_t now_ms)
+{
+	unsigned int oldest = count < LINK_GUARD_SAMPLES ? 0 : count % LINK_GUARD_SAMPLES;
+	uint32_t span_ms = now_ms - time_ring[oldest];
+	int fall = rssi_ring[oldest] - rssi;
+
+	if (count < 2 || fall <= 0 || span_ms == 0) {
+		return rssi;
+	}
+	return rssi - (int)((int64_t)fall * config.horizon_ms / span_ms);
+}
+
+bool link_guard_sample(int8_t rssi, uint32_t now_ms)
+{
+	unsigned int slot = count % LINK_GUARD_SAMPLES;
+	bool risk = atomic_load_explicit(&at_risk, memory_order_relaxed);
+	int ahead;
+
+	rssi_ring[slot] = rssi;
+	time_ring[slot] = now_ms;
+	count++;
+
+	ahead = projection(rssi, now_ms);
+	atomic_store_explicit(&last_rssi, rssi, memory_order_relaxed);
+	atomic_store_explicit(&projected, ahead, memory_order_relaxed);
+
+	if (!risk && ahead < config.floor_dbm) {
+		risk = true;
+		risk_since_ms = now_ms;
+		atomic_fetch_add_explicit(&alerts, 1, memory_order_relaxed);
+	} else if (risk && ahead >= config.floor_dbm + config.hysteresis_db &&
+		   now_ms - risk_since_ms >= config.hold_ms) {
+		risk = false;
+	}
+
+	if (atomic_exchange_explicit(&at_risk, risk, memory_order_relaxed) != risk) {
+		trace_ring_record(TRACE_EVENT_LINK_RISK, risk, (uint16_t)(ahead < 0 ? -ahead : 0));
+	}
+	return risk;
+}
+
+bool link_guard_at_risk(void)
+{
+	return atomic_load_explicit(&at_risk, memory_order_relaxed);
+}
+
+void link_guard_get_status(struct link_guard_status *status)
+{
+	status->at_risk = link_guard_at_risk();
+	status->rssi_dbm = (int8_t)atomic_load_explicit(&last_rssi, memory_order_relaxed);
+	status->projected_dbm = (int8_t)atomic_load_explicit(&projected, memory_order_relaxed);
+	status->alerts = atomic_load_explicit(&alerts, memory_order_relaxed);
+	status->drops = atomic_load_explicit(&drops, memory_order_relaxed);
+	status->drops_warned = atomic_load_explicit(&drops_warned, memory_order_relaxed);
+}
+
+int link_guard_format(char *buf, size_t len)
+{
+	struct link_guard_status status;
+
+	link_guard_get_status(&status);
+
+	return snprintf(buf, len,
+			"guard: %s, RSSI %d dBm -> %d dBm in %u ms (floor %d), %u alerts, "
+			"%u drops (%u warned)",
+			status.at_risk ? "AT RISK" : "ok", status.rssi_dbm, status.projected_dbm,
+			(unsigned int)config.horizon_ms, config.floor_dbm, (unsigned int)status.alerts,
+			(unsigned int)status.drops, (unsigned int)status.drops_warned);
+}
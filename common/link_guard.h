@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Early warning of a failing MouthPad link, shared by both relays
+ *
+ * A link that drops does so after the supervision timeout, seconds after
+ * the last packet got through. The guard extrapolates the RSSI readings of
+ * the primary link to see the drop coming:
+ *
+ *   slope      over the last LINK_GUARD_SAMPLES readings, falling only
+ *   projected  RSSI + slope * horizon_ms
+ *
+ * and declares the link at risk while the projection lies below floor_dbm.
+ * The relay then acts before the link drops: it moves to a longer-range
+ * PHY, raises the TX power, and shortens the supervision timeout, so that a
+ * link that drops anyway is given up, and reconnected, in a fraction of
+ * the time. The link is safe again once the projection is hysteresis_db
+ * above the floor and it has been at risk for hold_ms.
+ *
+ * link_guard_connected() and link_guard_sample() must not run at once;
+ * link_guard_dropped() and the status functions may be called from any
+ * context.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef LINK_GUARD_H_
+#define LINK_GUARD_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Readings the slope is taken over */
+#define LINK_GUARD_SAMPLES 4
+
+struct link_guard_config {
+	int8_t floor_dbm; /* Least projected RSSI the link is safe at */
+	uint8_t hysteresis_db;
+	uint32_t horizon_ms; /* How far ahead the RSSI is projected */
+	uint32_t hold_ms; /* Least time at risk */
+};
+
+struct link_guard_status {
+	bool at_risk;
+	int8_t rssi_dbm; /* Last reading */
+	int8_t projected_dbm;
+	uint32_t alerts; /* Times the link was found at risk */
+	uint32_t drops; /* Links lost */
+	uint32_t drops_warned; /* Of those, lost while at risk */
+};
+
+void link_guard_init(const struct link_guard_config *config);
+
+/**
+ * @brief Forget the readings of the last link; call on connect
+ */
+void link_guard_connected(void);
+
+/**
+ * @brief Count a lost link; call on an unrequested disconnect
+ */
+void link_guard_dropped(void);
+
+/**
+ * @brief Fold in one RSSI reading of the primary link
+ *
+ * @param now_ms Clock since boot; may wrap
+ *
+ * @return Whether the link is at risk now
+ */
+bool link_guard_sample(int8_t rssi, uint32_t now_ms);
+
+bool link_guard_at_risk(void);
+
+void link_guard_get_status(struct link_guard_status *status);
+
+/**
+ * @brief State, projection and counts as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int link_guard_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINK_GUARD_H_ */
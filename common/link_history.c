@@ -0,0 +1,655 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "link_history.h"
+#include "mouthpad_crc16.h"
+#include "mouthpad_frame.h"
+#include "trace_ring.h"
+#include "tuning_profile.h"
+#include "pb_encode.h"
+
+/* Six varint fields, the address, the buckets field and 3 bytes for the
+ * RelayToAppMessage tag and length
+ */
+_Static_assert(6 * 6 + 8 + 3 + LINK_HISTORY_RESPONSE_MAX * LINK_HISTORY_BUCKET_SIZE + 3 <=
+		       MOUTHPAD_FRAME_MAX_PAYLOAD - 3,
+	       "A full LinkHistoryResponse does not fit a frame");
+_Static_assert(LINK_HISTORY_HOURS <= UINT8_MAX, "Bucket counts are saved in a byte");
+
+/* Latency histogram as hid_latency.c bins it: 4 sub-buckets per power of
+ * two, so percentiles come out within a quarter. The last bin holds
+ * everything from 65536 us up.
+ */
+#define LATENCY_SUB_BITS  2
+#define LATENCY_SUB_COUNT (1u << LATENCY_SUB_BITS)
+#define LATENCY_BINS      61
+
+/* RSSI histogram, 1 dB per bin; weaker and stronger samples are clamped */
+#define RSSI_MIN  -110
+#define RSSI_MAX  -20
+#define RSSI_BINS (RSSI_MAX - RSSI_MIN + 1)
+
+/* A sample more than this after the last is taken to have been held up,
+ * and only credited this much connected time
+ */
+#define SAMPLE_GAP_MAX_MS (2 * LINK_HISTORY_SAMPLE_MS)
+
+/* Times a reader retries before giving up on a page */
+#define READ_TRIES 4
+
+struct bond_history {
+	uint8_t addr[6];
+	uint8_t count;  /* Buckets held */
+	uint8_t newest; /* Slot of the newest bucket */
+	uint8_t buckets[LINK_HISTORY_HOURS][LINK_HISTORY_BUCKET_SIZE];
+};
+
+/* Totals of the bucket being filled, packed into its slot every sample */
+struct open_bucket {
+	bool open;
+	bool was_connected;
+	uint16_t boot;
+	uint32_t hour;
+	uint32_t connected_ms;
+	uint32_t connects;
+	int32_t rssi_sum;
+	uint32_t rssi_samples;
+	uint16_t rssi_bins[RSSI_BINS];
+	uint32_t latency_bins[LATENCY_BINS];
+	uint32_t latency_count;
+	uint32_t hid_reports;
+	uint32_t hid_dropped;
+	uint32_t nus_lost;
+	uint32_t nus_received;
+	uint32_t phy_ms[3];
+	uint32_t profile_ms[3];
+};
+
+/* Writer side: link_history_sample(), _save() and _load() */
+static void (*changed_cb)(void);
+static struct bond_history bonds[LINK_HISTORY_BONDS]; /* Most recent first */
+static size_t bond_count;
+static struct open_bucket current;
+static struct link_telemetry_sample previous;
+static bool have_previous;
+static uint64_t uptime_ms;
+
+/* Hours since boot, for readers */
+static atomic_uint hour_now;
+
+/* Odd while bonds is being written */
+static atomic_uint bonds_seq;
+
+/* Filled from any context, drained by the sampler */
+static atomic_uint latency_pending[LATENCY_BINS];
+static atomic_uint connects_pending;
+static atomic_bool clear_pending;
+
+static void write_begin(void)
+{
+	atomic_fetch_add_explicit(&bonds_seq, 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+}
+
+static void write_end(void)
+{
+	atomic_fetch_add_explicit(&bonds_seq, 1, memory_order_release);
+}
+
+static unsigned int read_begin(void)
+{
+	return atomic_load_explicit(&bonds_seq, memory_order_acquire);
+}
+
+static bool read_retry(unsigned int seq)
+{
+	atomic_thread_fence(memory_order_acquire);
+	return (seq & 1) || seq != atomic_load_explicit(&bonds_seq, memory_order_relaxed);
+}
+
+static void put16(uint8_t *p, uint16_t value)
+{
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t value)
+{
+	put16(p, (uint16_t)value);
+	put16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+	return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static uint16_t saturate16(uint32_t value)
+{
+	return value > UINT16_MAX ? UINT16_MAX : (uint16_t)value;
+}
+
+static uint32_t latency_bin(uint32_t us)
+{
+	if (us < LATENCY_SUB_COUNT) {
+		return us;
+	}
+
+	uint32_t msb = 31u - (uint32_t)__builtin_clz(us);
+	uint32_t sub = (us >> (msb - LATENCY_SUB_BITS)) & (LATENCY_SUB_COUNT - 1u);
+	uint32_t bin = ((msb - LATENCY_SUB_BITS + 1u) << LATENCY_SUB_BITS) + sub;
+
+	return bin < LATENCY_BINS - 1 ? bin : LATENCY_BINS - 1;
+}
+
+/* Largest latency that still falls in bin; the last bin reads as 65535 */
+static uint16_t latency_bin_upper(uint32_t bin)
+{
+	if (bin < LATENCY_SUB_COUNT) {
+		return (uint16_t)bin;
+	}
+	if (bin >= LATENCY_BINS - 1) {
+		return UINT16_MAX;
+	}
+
+	uint32_t shift = (bin >> LATENCY_SUB_BITS) - 1u;
+	uint32_t sub = bin & (LATENCY_SUB_COUNT - 1u);
+
+	return saturate16(((LATENCY_SUB_COUNT + sub) << shift) + (1u << shift) - 1u);
+}
+
+static uint16_t latency_percentile(const struct open_bucket *b, uint32_t pct)
+{
+	uint32_t target = (uint32_t)(((uint64_t)b->latency_count * pct + 99) / 100);
+	uint32_t seen = 0;
+
+	if (b->latency_count == 0) {
+		return 0;
+	}
+	for (uint32_t i = 0; i < LATENCY_BINS; i++) {
+		seen += b->latency_bins[i];
+		if (seen >= target) {
+			return latency_bin_upper(i);
+		}
+	}
+	return UINT16_MAX;
+}
+
+/* Strongest level that 95% of samples were at or above */
+static int8_t rssi_p95(const struct open_bucket *b)
+{
+	uint32_t target = (uint32_t)(((uint64_t)b->rssi_samples * 95 + 99) / 100);
+	uint32_t seen = 0;
+
+	if (b->rssi_samples == 0) {
+		return 0;
+	}
+	for (int i = RSSI_BINS - 1; i >= 0; i--) {
+		seen += b->rssi_bins[i];
+		if (seen >= target) {
+			return (int8_t)(RSSI_MIN + i);
+		}
+	}
+	return RSSI_MIN;
+}
+
+static uint8_t minutes(uint32_t ms)
+{
+	uint32_t min = (ms + 30000) / 60000;
+
+	return min > UINT8_MAX ? UINT8_MAX : (uint8_t)min;
+}
+
+static void pack(const struct open_bucket *b, uint8_t *out)
+{
+	int32_t rssi_mean = b->rssi_samples ? b->rssi_sum / (int32_t)b->rssi_samples : 0;
+
+	put16(out + 0, b->boot);
+	put16(out + 2, saturate16(b->hour));
+	put16(out + 4, saturate16(b->connected_ms / 1000));
+	put16(out + 6, saturate16(b->connects));
+	out[8] = (uint8_t)(int8_t)rssi_mean;
+	out[9] = (uint8_t)rssi_p95(b);
+	put16(out + 10, latency_percentile(b, 50));
+	put16(out + 12, latency_percentile(b, 95));
+	put16(out + 14, latency_percentile(b, 99));
+	put32(out + 16, b->hid_reports);
+	put16(out + 20, saturate16(b->hid_dropped));
+	put16(out + 22, saturate16(b->nus_lost));
+	put32(out + 24, b->nus_received);
+	for (size_t i = 0; i < 3; i++) {
+		out[28 + i] = minutes(b->phy_ms[i]);
+		out[31 + i] = minutes(b->profile_ms[i]);
+	}
+}
+
+void link_history_bucket_unpack(const uint8_t *data, struct link_history_bucket *bucket)
+{
+	bucket->boot = get16(data + 0);
+	bucket->hour = get16(data + 2);
+	bucket->connected_s = get16(data + 4);
+	bucket->connects = get16(data + 6);
+	bucket->rssi_mean = (int8_t)data[8];
+	bucket->rssi_p95 = (int8_t)data[9];
+	bucket->latency_p50_us = get16(data + 10);
+	bucket->latency_p95_us = get16(data + 12);
+	bucket->latency_p99_us = get16(data + 14);
+	bucket->hid_reports = get32(data + 16);
+	bucket->hid_dropped = get16(data + 20);
+	bucket->nus_lost = get16(data + 22);
+	bucket->nus_received = get32(data + 24);
+	memcpy(bucket->phy_min, data + 28, 3);
+	memcpy(bucket->profile_min, data + 31, 3);
+}
+
+/* Slot of the bucket index counted from the oldest held */
+static size_t slot(const struct bond_history *bond, size_t index)
+{
+	return (bond->newest + LINK_HISTORY_HOURS + 1 - bond->count + index) % LINK_HISTORY_HOURS;
+}
+
+/* Move the MouthPad at addr to the front, making room for it if it is new */
+static void bond_use(const uint8_t addr[6])
+{
+	struct bond_history found;
+	size_t i;
+
+	for (i = 0; i < bond_count; i++) {
+		if (memcmp(bonds[i].addr, addr, 6) == 0) {
+			break;
+		}
+	}
+	if (i == 0 && bond_count > 0) {
+		return;
+	}
+
+	if (i < bond_count) {
+		found = bonds[i];
+	} else {
+		memset(&found, 0, sizeof(found));
+		memcpy(found.addr, addr, 6);
+		found.newest = LINK_HISTORY_HOURS - 1;
+		if (bond_count < LINK_HISTORY_BONDS) {
+			bond_count++;
+		}
+		i = bond_count - 1;
+	}
+
+	write_begin();
+	memmove(&bonds[1], &bonds[0], i * sizeof(bonds[0]));
+	bonds[0] = found;
+	write_end();
+}
+
+static void bucket_store(void)
+{
+	write_begin();
+	pack(&current, bonds[0].buckets[bonds[0].newest]);
+	write_end();
+}
+
+static void bucket_open(uint32_t hour)
+{
+	struct bond_history *bond = &bonds[0];
+
+	memset(&current, 0, sizeof(current));
+	current.open = true;
+	current.boot = (uint16_t)trace_ring_boot_count();
+	current.hour = hour;
+
+	write_begin();
+	bond->newest = (uint8_t)((bond->newest + 1) % LINK_HISTORY_HOURS);
+	if (bond->count < LINK_HISTORY_HOURS) {
+		bond->count++;
+	}
+	pack(&current, bond->buckets[bond->newest]);
+	write_end();
+}
+
+static void bucket_close(void)
+{
+	if (current.open) {
+		bucket_store();
+		current.open = false;
+		if (changed_cb) {
+			changed_cb();
+		}
+	}
+}
+
+void link_history_init(void (*changed)(void))
+{
+	changed_cb = changed;
+	write_begin();
+	memset(bonds, 0, sizeof(bonds));
+	bond_count = 0;
+	write_end();
+	memset(&current, 0, sizeof(current));
+	have_previous = false;
+	uptime_ms = 0;
+	atomic_store_explicit(&hour_now, 0, memory_order_relaxed);
+	atomic_store_explicit(&connects_pending, 0, memory_order_relaxed);
+	atomic_store_explicit(&clear_pending, false, memory_order_relaxed);
+}
+
+void link_history_connected(void)
+{
+	atomic_fetch_add_explicit(&connects_pending, 1, memory_order_relaxed);
+}
+
+void link_history_latency(uint32_t us)
+{
+	atomic_fetch_add_explicit(&latency_pending[latency_bin(us)], 1, memory_order_relaxed);
+}
+
+void link_history_clear(void)
+{
+	atomic_store_explicit(&clear_pending, true, memory_order_relaxed);
+}
+
+static void accumulate(const struct link_telemetry_sample *sample, uint32_t elapsed)
+{
+	if (have_previous) {
+		current.hid_reports += sample->hid_reports - previous.hid_reports;
+		current.hid_dropped += sample->hid_dropped - previous.hid_dropped;
+		current.nus_lost += (sample->nus_seq.lost - previous.nus_seq.lost) +
+				    (sample->nus_rx_dropped - previous.nus_rx_dropped);
+		current.nus_received += sample->nus_seq.received - previous.nus_seq.received;
+	}
+
+	if (!sample->connected) {
+		return;
+	}
+
+	current.connected_ms += elapsed;
+
+	if (sample->rssi < 0 && sample->rssi >= -127) {
+		int32_t rssi = sample->rssi;
+
+		if (rssi < RSSI_MIN) {
+			rssi = RSSI_MIN;
+		} else if (rssi > RSSI_MAX) {
+			rssi = RSSI_MAX;
+		}
+		current.rssi_sum += sample->rssi;
+		current.rssi_samples++;
+		if (current.rssi_bins[rssi - RSSI_MIN] < UINT16_MAX) {
+			current.rssi_bins[rssi - RSSI_MIN]++;
+		}
+	}
+
+	if (sample->rx_phy >= 1 && sample->rx_phy <= 3) {
+		current.phy_ms[sample->rx_phy - 1] += elapsed;
+	}
+
+	mouthware_message_RelayProfile profile = tuning_profile_preset();
+
+	if (profile >= mouthware_message_RelayProfile_RELAY_PROFILE_LOW_LATENCY &&
+	    profile <= mouthware_message_RelayProfile_RELAY_PROFILE_BATTERY) {
+		current.profile_ms[profile - mouthware_message_RelayProfile_RELAY_PROFILE_LOW_LATENCY] +=
+			elapsed;
+	}
+}
+
+void link_history_sample(const struct link_telemetry_sample *sample, const uint8_t addr[6])
+{
+	uint32_t elapsed = have_previous ? sample->now_ms - previous.now_ms : 0;
+	bool connected = sample->connected && addr;
+	uint32_t connects;
+	uint32_t hour;
+
+	uptime_ms += elapsed;
+	hour = (uint32_t)(uptime_ms / LINK_HISTORY_BUCKET_MS);
+	atomic_store_explicit(&hour_now, hour, memory_order_relaxed);
+	if (elapsed > SAMPLE_GAP_MAX_MS) {
+		elapsed = SAMPLE_GAP_MAX_MS;
+	}
+
+	if (atomic_exchange_explicit(&clear_pending, false, memory_order_relaxed)) {
+		current.open = false;
+		write_begin();
+		memset(bonds, 0, sizeof(bonds));
+		bond_count = 0;
+		write_end();
+		if (changed_cb) {
+			changed_cb();
+		}
+	}
+
+	/* An hour over, or another MouthPad: the bucket is done */
+	if (current.open &&
+	    (hour != current.hour || (connected && memcmp(bonds[0].addr, addr, 6) != 0))) {
+		bucket_close();
+	}
+	if (connected && !current.open) {
+		bond_use(addr);
+		bucket_open(hour);
+	}
+
+	connects = atomic_exchange_explicit(&connects_pending, 0, memory_order_relaxed);
+	for (size_t i = 0; i < LATENCY_BINS; i++) {
+		uint32_t n = atomic_exchange_explicit(&latency_pending[i], 0, memory_order_relaxed);
+
+		if (current.open && n > 0) {
+			current.latency_bins[i] += n;
+			current.latency_count += n;
+		}
+	}
+
+	if (current.open) {
+		current.connects += connects;
+		accumulate(sample, elapsed);
+		bucket_store();
+
+		/* Saved on every drop, so a reset loses at most the time since */
+		if (current.was_connected && !connected && changed_cb) {
+			changed_cb();
+		}
+		current.was_connected = connected;
+	}
+
+	previous = *sample;
+	have_previous = true;
+}
+
+size_t link_history_save(uint8_t *buf, size_t size)
+{
+	size_t len = 4;
+
+	if (size < LINK_HISTORY_BLOB_MAX) {
+		return 0;
+	}
+
+	buf[0] = LINK_HISTORY_BLOB_VERSION;
+	buf[1] = (uint8_t)bond_count;
+	for (size_t b = 0; b < bond_count; b++) {
+		const struct bond_history *bond = &bonds[b];
+
+		memcpy(buf + len, bond->addr, 6);
+		buf[len + 6] = bond->count;
+		len += 7;
+		for (size_t i = 0; i < bond->count; i++) {
+			memcpy(buf + len, bond->buckets[slot(bond, i)], LINK_HISTORY_BUCKET_SIZE);
+			len += LINK_HISTORY_BUCKET_SIZE;
+		}
+	}
+	put16(buf + 2, mouthpad_crc16(buf + 4, len - 4));
+
+	return len;
+}
+
+bool link_history_load(const uint8_t *buf, size_t len)
+{
+	size_t pos = 4;
+
+	if (!buf || len < 4 || buf[0] != LINK_HISTORY_BLOB_VERSION ||
+	    buf[1] > LINK_HISTORY_BONDS || get16(buf + 2) != mouthpad_crc16(buf + 4, len - 4)) {
+		return false;
+	}
+
+	/* Walk it once before taking anything */
+	for (size_t b = 0; b < buf[1]; b++) {
+		if (len - pos < 7 || buf[pos + 6] > LINK_HISTORY_HOURS ||
+		    len - pos - 7 < (size_t)buf[pos + 6] * LINK_HISTORY_BUCKET_SIZE) {
+			return false;
+		}
+		pos += 7 + (size_t)buf[pos + 6] * LINK_HISTORY_BUCKET_SIZE;
+	}
+	if (pos != len) {
+		return false;
+	}
+
+	write_begin();
+	memset(bonds, 0, sizeof(bonds));
+	bond_count = buf[1];
+	pos = 4;
+	for (size_t b = 0; b < bond_count; b++) {
+		struct bond_history *bond = &bonds[b];
+
+		memcpy(bond->addr, buf + pos, 6);
+		bond->count = buf[pos + 6];
+		bond->newest = bond->count > 0 ? bond->count - 1 : LINK_HISTORY_HOURS - 1;
+		pos += 7;
+		memcpy(bond->buckets, buf + pos, (size_t)bond->count * LINK_HISTORY_BUCKET_SIZE);
+		pos += (size_t)bond->count * LINK_HISTORY_BUCKET_SIZE;
+	}
+	write_end();
+
+	return true;
+}
+
+struct response_page {
+	uint32_t count;
+	uint8_t buckets[LINK_HISTORY_RESPONSE_MAX][LINK_HISTORY_BUCKET_SIZE];
+};
+
+/* nanopb callback for LinkHistoryResponse.buckets */
+static bool encode_buckets(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+	const struct response_page *page = *arg;
+
+	return pb_encode_tag_for_field(stream, field) &&
+	       pb_encode_string(stream, &page->buckets[0][0],
+				page->count * LINK_HISTORY_BUCKET_SIZE);
+}
+
+void link_history_fill_response(uint32_t bond, uint32_t offset,
+				mouthware_message_LinkHistoryResponse *response)
+{
+	/* Only one response is encoded at a time */
+	static struct response_page page;
+	bool cleared = atomic_load_explicit(&clear_pending, memory_order_relaxed);
+
+	*response = (mouthware_message_LinkHistoryResponse)mouthware_message_LinkHistoryResponse_init_zero;
+	response->bond = bond;
+	response->boot_count = trace_ring_boot_count();
+	response->hour = atomic_load_explicit(&hour_now, memory_order_relaxed);
+
+	for (int tries = 0; tries < READ_TRIES && !cleared; tries++) {
+		unsigned int seq = read_begin();
+		uint32_t held;
+
+		response->bond_count = (uint32_t)bond_count;
+		response->address.size = 0;
+		response->total = 0;
+		response->offset = 0;
+		page.count = 0;
+
+		if (bond < response->bond_count) {
+			const struct bond_history *b = &bonds[bond];
+
+			held = b->count <= LINK_HISTORY_HOURS ? b->count : 0;
+			memcpy(response->address.bytes, b->addr, 6);
+			response->address.size = 6;
+			response->total = held;
+			response->offset = offset < held ? offset : held;
+			page.count = held - response->offset;
+			if (page.count > LINK_HISTORY_RESPONSE_MAX) {
+				page.count = LINK_HISTORY_RESPONSE_MAX;
+			}
+			for (uint32_t i = 0; i < page.count; i++) {
+				memcpy(page.buckets[i], b->buckets[slot(b, response->offset + i)],
+				       LINK_HISTORY_BUCKET_SIZE);
+			}
+		}
+
+		if (!read_retry(seq)) {
+			if (page.count > 0) {
+				response->buckets.funcs.encode = encode_buckets;
+				response->buckets.arg = &page;
+			}
+			return;
+		}
+	}
+
+	/* Cleared, or kept changing under the copy: the host asks again */
+	response->bond_count = 0;
+	response->address.size = 0;
+	response->total = 0;
+	response->offset = 0;
+}
+
+int link_history_format(size_t index, char *buf, size_t len)
+{
+	size_t line = 0;
+
+	for (size_t b = 0; b < LINK_HISTORY_BONDS; b++) {
+		const struct bond_history *bond = &bonds[b];
+		uint8_t addr[6];
+		uint8_t data[LINK_HISTORY_BUCKET_SIZE];
+		size_t held = 0;
+		bool present = false;
+		int tries = 0;
+		unsigned int seq;
+
+		do {
+			seq = read_begin();
+			present = b < bond_count;
+			held = bond->count <= LINK_HISTORY_HOURS ? bond->count : 0;
+			memcpy(addr, bond->addr, sizeof(addr));
+			if (index > line && index <= line + held) {
+				memcpy(data, bond->buckets[slot(bond, index - line - 1)], sizeof(data));
+			}
+		} while (read_retry(seq) && ++tries < READ_TRIES);
+
+		if (!present) {
+			return 0;
+		}
+		if (index == line) {
+			return snprintf(buf, len, "%u %02x:%02x:%02x:%02x:%02x:%02x: %u h",
+					(unsigned int)b, addr[0], addr[1], addr[2], addr[3], addr[4],
+					addr[5], (unsigned int)held);
+		}
+		if (index <= line + held) {
+			struct link_history_bucket k;
+
+			link_history_bucket_unpack(data, &k);
+			return snprintf(buf, len,
+					"  boot %u +%uh: %us up, %u links, rssi %d/%d, "
+					"lat %u/%u/%u us, hid %u (-%u), nus %u (-%u), "
+					"phy %u/%u/%u min, prof %u/%u/%u min",
+					k.boot, k.hour, k.connected_s, k.connects, k.rssi_mean,
+					k.rssi_p95, k.latency_p50_us, k.latency_p95_us,
+					k.latency_p99_us, (unsigned int)k.hid_reports, k.hid_dropped,
+					(unsigned int)k.nus_received, k.nus_lost, k.phy_min[0],
+					k.phy_min[1], k.phy_min[2], k.profile_min[0], k.profile_min[1],
+					k.profile_min[2]);
+		}
+		line += 1 + held;
+	}
+
+	return 0;
+}
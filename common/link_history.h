@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Hourly link history per bonded MouthPad, kept in flash, shared by
+ *         both relays
+ *
+ * So "it has been laggy this week" can be looked into without a capture
+ * having run at the time. For each of the LINK_HISTORY_BONDS MouthPads
+ * connected most recently, the last LINK_HISTORY_HOURS hours of connected
+ * time are kept as buckets: links made, time connected, RSSI mean and the
+ * level 95% of samples reached, BLE->USB HID latency percentiles, HID
+ * reports and drops, NUS notifications and losses, and minutes on each
+ * PHY and tuning preset.
+ *
+ * The platform hands in a link_telemetry_sample every LINK_HISTORY_SAMPLE_MS,
+ * with the MouthPad's address while it is connected, and each HID latency
+ * as it is measured. A bucket covers one hour of relay uptime and is
+ * stamped with the boot count (trace_ring.h) and the hour after that boot;
+ * an hour spent disconnected opens none. The relay has no wall clock, so
+ * the host dates the buckets of the current boot from LinkHistoryResponse's
+ * hour, and orders older ones by boot.
+ *
+ * The buckets are saved as one blob through the platform's write-behind
+ * layer: the changed callback asks for a save when a bucket is closed and
+ * when the link drops, so flash sees a write per hour of use at most, plus
+ * one per disconnect.
+ *
+ * link_history_sample(), link_history_save() and link_history_load() run in
+ * one context. link_history_latency(), link_history_connected() and
+ * link_history_clear() may be called from any. link_history_fill_response()
+ * and link_history_format() may too: they read under a sequence count, and
+ * a page a sample kept changing is sent empty rather than half updated.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef LINK_HISTORY_H_
+#define LINK_HISTORY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+#include "link_telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* MouthPads kept; the one connected longest ago makes room for a new one */
+#define LINK_HISTORY_BONDS 4
+
+/* Buckets kept per MouthPad */
+#define LINK_HISTORY_HOURS 24
+
+#define LINK_HISTORY_BUCKET_MS 3600000u
+
+/* Sampling period the platform runs at */
+#define LINK_HISTORY_SAMPLE_MS 5000
+
+/* Buckets per LinkHistoryResponse */
+#define LINK_HISTORY_RESPONSE_MAX 8
+
+/* Bucket as it is saved and sent, little-endian:
+ *
+ *    0  boot u16            Boot count, low 16 bits
+ *    2  hour u16            Hours after that boot the bucket covers
+ *    4  connected_s u16
+ *    6  connects u16        Links made
+ *    8  rssi_mean i8        dBm, 0 without samples
+ *    9  rssi_p95 i8         dBm that 95% of samples were at or above
+ *   10  latency_p50_us u16  BLE->USB HID, 65535 for longer
+ *   12  latency_p95_us u16
+ *   14  latency_p99_us u16
+ *   16  hid_reports u32     Received from the MouthPad
+ *   20  hid_dropped u16     Not forwarded to USB
+ *   22  nus_lost u16        Sequence numbers missed, plus NUS RX drops
+ *   24  nus_received u32    Notifications with a sequence number
+ *   28  phy_min u8[3]       Minutes on 1M, 2M, Coded
+ *   31  profile_min u8[3]   Minutes in LOW_LATENCY, BALANCED, BATTERY
+ */
+#define LINK_HISTORY_BUCKET_SIZE 34
+
+#define LINK_HISTORY_BLOB_VERSION 1
+
+/* Version, bond count, CRC, then per MouthPad its address, a bucket count
+ * and that many buckets, oldest first; MouthPads most recent first
+ */
+#define LINK_HISTORY_BLOB_MAX \
+	(4 + LINK_HISTORY_BONDS * (7 + LINK_HISTORY_HOURS * LINK_HISTORY_BUCKET_SIZE))
+
+struct link_history_bucket {
+	uint16_t boot;
+	uint16_t hour;
+	uint16_t connected_s;
+	uint16_t connects;
+	int8_t rssi_mean;
+	int8_t rssi_p95;
+	uint16_t latency_p50_us;
+	uint16_t latency_p95_us;
+	uint16_t latency_p99_us;
+	uint32_t hid_reports;
+	uint16_t hid_dropped;
+	uint16_t nus_lost;
+	uint32_t nus_received;
+	uint8_t phy_min[3];
+	uint8_t profile_min[3];
+};
+
+/**
+ * @brief Start with no history
+ *
+ * @param changed Asks the platform's write-behind layer for a
+ *                link_history_save(); called from link_history_sample()
+ */
+void link_history_init(void (*changed)(void));
+
+/**
+ * @brief Take one sample of the link
+ *
+ * @param addr The MouthPad's address, most significant byte first, while
+ *             sample->connected; else NULL
+ */
+void link_history_sample(const struct link_telemetry_sample *sample, const uint8_t addr[6]);
+
+/**
+ * @brief A link to the MouthPad came up; counted at the next sample
+ */
+void link_history_connected(void);
+
+/**
+ * @brief One BLE->USB HID latency, from wherever it is measured
+ */
+void link_history_latency(uint32_t us);
+
+/**
+ * @brief Forget every MouthPad's history at the next sample
+ */
+void link_history_clear(void);
+
+/**
+ * @brief Pack the history for flash
+ *
+ * @return Bytes written, at most LINK_HISTORY_BLOB_MAX
+ */
+size_t link_history_save(uint8_t *buf, size_t size);
+
+/**
+ * @brief Take back what link_history_save() wrote; call before sampling
+ *
+ * @return false if the blob is not one this firmware wrote; nothing is kept
+ */
+bool link_history_load(const uint8_t *buf, size_t len);
+
+void link_history_bucket_unpack(const uint8_t *data, struct link_history_bucket *bucket);
+
+/**
+ * @brief Fill in a LinkHistoryResponse: one page of one MouthPad's buckets
+ *
+ * The buckets are copied here; the response must be encoded before the
+ * next call.
+ *
+ * @param bond 0 for the MouthPad connected most recently
+ * @param offset First bucket to send, counted from the oldest held
+ */
+void link_history_fill_response(uint32_t bond, uint32_t offset,
+				mouthware_message_LinkHistoryResponse *response);
+
+/**
+ * @brief Format line index of the history, for the console
+ *
+ * @return Characters written, 0 past the last line
+ */
+int link_history_format(size_t index, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINK_HISTORY_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+
+#include "link_state.h"
+
+/* Packed layout of the state word */
+#define PHASE_SHIFT   0
+#define PHASE_MASK    (0x3u << PHASE_SHIFT)
+#define READY_SHIFT   2
+#define READY_MASK    (0x7u << READY_SHIFT)
+#define RSSI_SHIFT    5
+#define RSSI_MASK     (0xFFu << RSSI_SHIFT)
+#define BATTERY_SHIFT 13
+#define BATTERY_MASK  (0xFFu << BATTERY_SHIFT)
+#define VERSION_SHIFT 21
+#define VERSION_MASK  (0x7FFu << VERSION_SHIFT)
+
+_Static_assert(LINK_STATE_CONNECTED <= (PHASE_MASK >> PHASE_SHIFT), "Phase field");
+_Static_assert((LINK_STATE_HID | LINK_STATE_NUS | LINK_STATE_READY) <= (READY_MASK >> READY_SHIFT),
+	       "Ready field");
+
+static atomic_uint state = (uint32_t)LINK_STATE_BATTERY_UNKNOWN << BATTERY_SHIFT;
+
+/* Replace the bits in mask with those of bits; the version moves only if
+ * something else did
+ */
+static void update(uint32_t mask, uint32_t bits)
+{
+	unsigned int old = atomic_load_explicit(&state, memory_order_relaxed);
+	unsigned int next;
+
+	do {
+		next = (old & ~mask) | (bits & mask);
+		if (next == old) {
+			return;
+		}
+		next = (next & ~VERSION_MASK) | ((old + (1u << VERSION_SHIFT)) & VERSION_MASK);
+	} while (!atomic_compare_exchange_weak_explicit(&state, &old, next, memory_order_release,
+							memory_order_relaxed));
+}
+
+void link_state_set_phase(enum link_state_phase phase)
+{
+	update(PHASE_MASK, (uint32_t)phase << PHASE_SHIFT);
+}
+
+void link_state_set_ready(uint32_t mask, uint32_t ready)
+{
+	update((mask << READY_SHIFT) & READY_MASK, ready << READY_SHIFT);
+}
+
+void link_state_set_rssi(int8_t rssi)
+{
+	update(RSSI_MASK, (uint32_t)(uint8_t)rssi << RSSI_SHIFT);
+}
+
+void link_state_set_battery(uint8_t battery_level)
+{
+	update(BATTERY_MASK, (uint32_t)battery_level << BATTERY_SHIFT);
+}
+
+void link_state_lost(void)
+{
+	update(READY_MASK | RSSI_MASK | BATTERY_MASK,
+	       ((uint32_t)(uint8_t)LINK_STATE_RSSI_UNKNOWN << RSSI_SHIFT) |
+		       ((uint32_t)LINK_STATE_BATTERY_UNKNOWN << BATTERY_SHIFT));
+}
+
+void link_state_get(struct link_state *snapshot)
+{
+	uint32_t word = atomic_load_explicit(&state, memory_order_acquire);
+
+	snapshot->version = (uint16_t)((word & VERSION_MASK) >> VERSION_SHIFT);
+	snapshot->phase = (uint8_t)((word & PHASE_MASK) >> PHASE_SHIFT);
+	snapshot->ready = (uint8_t)((word & READY_MASK) >> READY_SHIFT);
+	snapshot->rssi = (int8_t)(uint8_t)((word & RSSI_MASK) >> RSSI_SHIFT);
+	snapshot->battery_level = (uint8_t)((word & BATTERY_MASK) >> BATTERY_SHIFT);
+}
+
+uint16_t link_state_version(void)
+{
+	return (uint16_t)((atomic_load_explicit(&state, memory_order_relaxed) & VERSION_MASK) >>
+			  VERSION_SHIFT);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Where the MouthPad link stands, as one snapshot, shared by both relays
+ *
+ * The Bluetooth side writes the phase, the services that are ready, the
+ * smoothed RSSI and the battery level as they change; status responses,
+ * the LEDs, the display and telemetry read them back all at once. The
+ * whole state is packed into one 32-bit word, so a writer swaps it with a
+ * compare-and-exchange and a reader takes it with a single load: a
+ * snapshot never mixes two updates, and nobody takes a lock or waits.
+ *
+ * Each change that moves a field bumps the version, so a poller can tell
+ * cheaply whether anything moved. It wraps.
+ *
+ * Every function may be called from any context.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef LINK_STATE_H_
+#define LINK_STATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum link_state_phase {
+	LINK_STATE_IDLE,       /* Neither scanning nor connected */
+	LINK_STATE_SCANNING,
+	LINK_STATE_CONNECTING, /* Link up, services not ready */
+	LINK_STATE_CONNECTED,
+};
+
+/* Services, for link_state_set_ready() */
+#define LINK_STATE_HID   (1u << 0) /* HID input flows */
+#define LINK_STATE_NUS   (1u << 1) /* NUS discovered */
+#define LINK_STATE_READY (1u << 2) /* CONNECTED reported to the host */
+
+/* RSSI and battery level before they are known */
+#define LINK_STATE_RSSI_UNKNOWN    0
+#define LINK_STATE_BATTERY_UNKNOWN 0xFF
+
+struct link_state {
+	uint16_t version; /* Changes since boot; wraps */
+	uint8_t phase; /* enum link_state_phase */
+	uint8_t ready; /* LINK_STATE_HID | LINK_STATE_NUS | LINK_STATE_READY */
+	int8_t rssi; /* Smoothed, dBm; LINK_STATE_RSSI_UNKNOWN */
+	uint8_t battery_level; /* %; LINK_STATE_BATTERY_UNKNOWN */
+};
+
+void link_state_set_phase(enum link_state_phase phase);
+
+/**
+ * @brief Mark services ready or not
+ *
+ * @param mask LINK_STATE_* bits to change
+ * @param ready Their new values
+ */
+void link_state_set_ready(uint32_t mask, uint32_t ready);
+
+void link_state_set_rssi(int8_t rssi);
+
+void link_state_set_battery(uint8_t battery_level);
+
+/**
+ * @brief Nothing ready and RSSI and battery level unknown, on a disconnect
+ *
+ * The phase is left to its writer, which may already be scanning again.
+ */
+void link_state_lost(void);
+
+/**
+ * @brief Take a consistent snapshot
+ */
+void link_state_get(struct link_state *state);
+
+/**
+ * @brief Version alone, to check whether anything moved
+ */
+uint16_t link_state_version(void);
+
+/**
+ * @brief Whether HID or NUS is up on the link
+ */
+static inline bool link_state_is_up(const struct link_state *state)
+{
+	return (state->ready & (LINK_STATE_HID | LINK_STATE_NUS)) != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINK_STATE_H_ */
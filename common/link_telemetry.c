@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "link_telemetry.h"
+
+static uint32_t interval_ms;
+static bool on_change;
+static bool send_next; /* First sample after a subscribe */
+static uint32_t sequence;
+
+/* Previous sample, for the report rate and USB means; valid once has_previous */
+static bool has_previous;
+static struct link_telemetry_sample previous;
+
+/* Last sample sent, for on_change */
+static struct link_telemetry_sample sent;
+
+uint32_t link_telemetry_subscribe(const mouthware_message_LinkTelemetrySubscribe *request)
+{
+	uint32_t interval = request->interval_ms;
+
+	if (interval == 0 && request->on_change) {
+		interval = LINK_TELEMETRY_CHANGE_INTERVAL_MS;
+	}
+	if (interval != 0 && interval < LINK_TELEMETRY_MIN_INTERVAL_MS) {
+		interval = LINK_TELEMETRY_MIN_INTERVAL_MS;
+	}
+	if (interval > LINK_TELEMETRY_MAX_INTERVAL_MS) {
+		interval = LINK_TELEMETRY_MAX_INTERVAL_MS;
+	}
+
+	interval_ms = interval;
+	on_change = request->on_change;
+	send_next = interval != 0;
+	has_previous = false;
+
+	return interval_ms;
+}
+
+uint32_t link_telemetry_interval_ms(void)
+{
+	return interval_ms;
+}
+
+static bool link_changed(const struct link_telemetry_sample *sample)
+{
+	return sample->connected != sent.connected || sample->rssi != sent.rssi ||
+	       sample->battery_level != sent.battery_level ||
+	       sample->conn_interval_us != sent.conn_interval_us ||
+	       sample->tx_phy != sent.tx_phy || sample->rx_phy != sent.rx_phy ||
+	       sample->hid_dropped != sent.hid_dropped ||
+	       sample->nus_rx_dropped != sent.nus_rx_dropped ||
+	       sample->nus_tx_dropped != sent.nus_tx_dropped ||
+	       sample->nus_seq.lost != sent.nus_seq.lost ||
+	       sample->nus_seq.reordered != sent.nus_seq.reordered ||
+	       sample->stalls != sent.stalls;
+}
+
+bool link_telemetry_fill(const struct link_telemetry_sample *sample,
+			 mouthware_message_LinkTelemetry *out)
+{
+	uint32_t reports_per_s = 0;
+	uint32_t usb_wait_us = 0;
+	uint32_t usb_phase_us = 0;
+	uint32_t loss_permille = 0;
+
+	if (interval_ms == 0) {
+		return false;
+	}
+
+	if (has_previous && sample->now_ms != previous.now_ms) {
+		uint64_t reports = sample->hid_reports - previous.hid_reports;
+
+		reports_per_s = (uint32_t)(reports * 1000U / (sample->now_ms - previous.now_ms));
+	}
+	if (has_previous) {
+		uint32_t waits = sample->usb_waits - previous.usb_waits;
+		uint32_t submits = sample->usb_reports - previous.usb_reports;
+
+		if (waits) {
+			usb_wait_us = (sample->usb_wait_sum_us - previous.usb_wait_sum_us) / waits;
+		}
+		if (submits) {
+			usb_phase_us = (sample->usb_phase_sum_us - previous.usb_phase_sum_us) / submits;
+		}
+
+		/* A late notification can take back a loss counted last period */
+		int32_t lost = (int32_t)(sample->nus_seq.lost - previous.nus_seq.lost);
+		uint32_t received = sample->nus_seq.received - previous.nus_seq.received;
+
+		if (lost > 0) {
+			loss_permille = (uint32_t)((uint64_t)lost * 1000U / ((uint64_t)received + lost));
+		}
+	}
+	has_previous = true;
+	previous = *sample;
+
+	if (!send_next && on_change && !link_changed(sample)) {
+		return false;
+	}
+	send_next = false;
+	sent = *sample;
+
+	*out = (mouthware_message_LinkTelemetry){
+		.sequence = sequence++,
+		.connected = sample->connected,
+		.rssi = sample->rssi,
+		.battery_level = sample->battery_level,
+		.conn_interval_us = sample->conn_interval_us,
+		.tx_phy = sample->tx_phy,
+		.rx_phy = sample->rx_phy,
+		.hid_reports_per_s = reports_per_s,
+		.hid_dropped = sample->hid_dropped,
+		.nus_rx_dropped = sample->nus_rx_dropped,
+		.nus_tx_dropped = sample->nus_tx_dropped,
+		.nus_tx_queued = sample->nus_tx_queued,
+		.cdc_tx_queued = sample->cdc_tx_queued,
+		.interval_ms = interval_ms,
+		.stalls = sample->stalls,
+		.worst_stall_us = sample->worst_stall_us,
+		.usb_wait_us = usb_wait_us,
+		.usb_phase_us = usb_phase_us,
+		.nus_seq_lost = sample->nus_seq.lost,
+		.nus_seq_reordered = sample->nus_seq.reordered,
+		.nus_loss_permille = loss_permille,
+		.nus_gap_lengths_count = SENSOR_STREAM_GAP_BINS,
+	};
+	for (unsigned int i = 0; i < SENSOR_STREAM_GAP_BINS; i++) {
+		out->nus_gap_lengths[i] = sample->nus_seq.gaps[i];
+	}
+
+	return true;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief LinkTelemetry stream shared by both relays
+ *
+ * A LinkTelemetrySubscribe from the host sets a sampling period and whether
+ * only changes are wanted. The platform then takes a sample every period
+ * and hands it here, which turns the HID report count into a rate, the
+ * USB phase sums into means (usb_phase.h) and the MouthPad's sequence
+ * counts into a loss share over the period (sensor_stream.h), decides
+ * whether the sample is worth sending and fills in the LinkTelemetry.
+ *
+ * With on_change set, a sample is only sent when the link state (connected,
+ * RSSI, battery, interval, PHY), a drop or sequence counter or the stall
+ * count differs from the last one sent; rates and queue depths ride along
+ * but do not trigger a send. The first sample after a subscribe is always sent and
+ * serves as its reply.
+ *
+ * Not thread safe: subscribe and sample from the same context.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef LINK_TELEMETRY_H_
+#define LINK_TELEMETRY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+#include "sensor_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shortest sampling period; faster requests are slowed to this */
+#define LINK_TELEMETRY_MIN_INTERVAL_MS 100
+
+/* Longest sampling period; slower requests are sped up to this */
+#define LINK_TELEMETRY_MAX_INTERVAL_MS 60000
+
+/* Sampling period for an on_change subscription without an interval */
+#define LINK_TELEMETRY_CHANGE_INTERVAL_MS 250
+
+struct link_telemetry_sample {
+	uint32_t now_ms; /* Any millisecond clock; may wrap */
+	bool connected;
+	int32_t rssi;
+	uint32_t battery_level;
+	uint32_t conn_interval_us;
+	uint8_t tx_phy;
+	uint8_t rx_phy;
+	uint32_t hid_reports; /* Received since boot; sent as a rate */
+	uint32_t hid_dropped;
+	uint32_t nus_rx_dropped;
+	uint32_t nus_tx_dropped;
+	uint32_t nus_tx_queued;
+	uint32_t cdc_tx_queued;
+	uint32_t stalls;      /* Since boot; see stall_watch.h */
+	uint32_t worst_stall_us;
+	uint32_t usb_reports; /* Since boot; see usb_phase.h */
+	uint32_t usb_phase_sum_us;
+	uint32_t usb_waits;
+	uint32_t usb_wait_sum_us;
+	struct sensor_stream_sequence nus_seq; /* sensor_stream_sequence_total() */
+};
+
+/**
+ * @brief Apply a LinkTelemetrySubscribe
+ *
+ * @return Sampling period to run at in ms, 0 if the stream is now stopped
+ */
+uint32_t link_telemetry_subscribe(const mouthware_message_LinkTelemetrySubscribe *request);
+
+/**
+ * @brief Sampling period in effect, 0 while nobody is subscribed
+ */
+uint32_t link_telemetry_interval_ms(void);
+
+/**
+ * @brief Turn a sample into a LinkTelemetry if it should be sent
+ *
+ * Call once per sampling period while subscribed, whether or not the
+ * previous sample was sent.
+ *
+ * @return true if out was filled in and should be sent
+ */
+bool link_telemetry_fill(const struct link_telemetry_sample *sample,
+			 mouthware_message_LinkTelemetry *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINK_TELEMETRY_H_ */
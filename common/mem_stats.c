@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mem_stats.h"
+#include "mouthpad_frame.h"
+#include "pb_encode.h"
+
+/* Five heap and three stack varints, then a tag and length byte per pool
+ * and site; 3 bytes go to the RelayToAppMessage tag and length
+ */
+_Static_assert(8 * 6 + MEM_STATS_POOLS_MAX * (2 + mouthware_message_MemPool_size) +
+			       MEM_SITE_COUNT * (2 + mouthware_message_MemSite_size) <=
+		       MOUTHPAD_FRAME_MAX_PAYLOAD - 3,
+	       "A full MemStatsResponse does not fit a frame");
+
+static atomic_uint site_calls[MEM_SITE_COUNT];
+static atomic_uint site_failures[MEM_SITE_COUNT];
+static atomic_uint site_peak[MEM_SITE_COUNT];
+
+void mem_stats_take(enum mem_site site, bool ok, uint32_t in_use)
+{
+	if (site >= MEM_SITE_COUNT) {
+		return;
+	}
+
+	atomic_fetch_add_explicit(&site_calls[site], 1, memory_order_relaxed);
+	if (!ok) {
+		atomic_fetch_add_explicit(&site_failures[site], 1, memory_order_relaxed);
+		return;
+	}
+
+	unsigned int peak = atomic_load_explicit(&site_peak[site], memory_order_relaxed);
+
+	while (in_use > peak &&
+	       !atomic_compare_exchange_weak(&site_peak[site], &peak, in_use)) {
+	}
+}
+
+void mem_stats_site_get(enum mem_site site, struct mem_stats_site *stats)
+{
+	if (site >= MEM_SITE_COUNT) {
+		*stats = (struct mem_stats_site){0};
+		return;
+	}
+
+	stats->calls = atomic_load_explicit(&site_calls[site], memory_order_relaxed);
+	stats->failures = atomic_load_explicit(&site_failures[site], memory_order_relaxed);
+	stats->peak = atomic_load_explicit(&site_peak[site], memory_order_relaxed);
+}
+
+void mem_stats_reset(void)
+{
+	for (size_t i = 0; i < MEM_SITE_COUNT; i++) {
+		atomic_store_explicit(&site_calls[i], 0, memory_order_relaxed);
+		atomic_store_explicit(&site_failures[i], 0, memory_order_relaxed);
+		atomic_store_explicit(&site_peak[i], 0, memory_order_relaxed);
+	}
+}
+
+const char *mem_stats_site_name(uint8_t site)
+{
+	static const char *const names[] = {
+		[MEM_SITE_CDC_MESSAGE] = "cdc message",
+		[MEM_SITE_CDC_PASS_THROUGH] = "cdc pass-thru",
+		[MEM_SITE_NUS_TX] = "nus write",
+	};
+
+	return site < MEM_SITE_COUNT ? names[site] : "?";
+}
+
+void mem_stats_add_pool(struct mem_stats_report *report, const struct mem_stats_pool *pool)
+{
+	if (report->pool_count < MEM_STATS_POOLS_MAX) {
+		report->pools[report->pool_count++] = *pool;
+	}
+}
+
+static void copy_name(char *dst, size_t size, const char *src)
+{
+	strncpy(dst, src ? src : "", size - 1);
+	dst[size - 1] = '\0';
+}
+
+void mem_stats_add_stack(struct mem_stats_report *report, const char *name, uint32_t size,
+			 uint32_t unused)
+{
+	struct mem_stats_stack *stack;
+
+	if (report->stack_count >= MEM_STATS_STACKS_MAX) {
+		return;
+	}
+
+	stack = &report->stacks[report->stack_count++];
+	copy_name(stack->name, sizeof(stack->name), name);
+	stack->size = size;
+	stack->peak = unused < size ? size - unused : 0;
+}
+
+uint32_t mem_stats_stack_budget(const struct mem_stats_stack *stack)
+{
+	return (stack->peak + MEM_STATS_STACK_MARGIN + 63) & ~63u;
+}
+
+enum mem_stack_check mem_stats_stack_check(const struct mem_stats_stack *stack)
+{
+	uint32_t budget = mem_stats_stack_budget(stack);
+
+	if (stack->size < stack->peak + MEM_STATS_STACK_MARGIN) {
+		return MEM_STACK_TIGHT;
+	}
+	if (stack->size >= budget + MEM_STATS_STACK_SLACK) {
+		return MEM_STACK_SLACK;
+	}
+	return MEM_STACK_OK;
+}
+
+/* nanopb callback for MemStatsResponse.pools */
+static bool encode_pools(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+	const struct mem_stats_report *report = *arg;
+
+	for (size_t i = 0; i < report->pool_count; i++) {
+		const struct mem_stats_pool *pool = &report->pools[i];
+		mouthware_message_MemPool message = {
+			.unit = pool->unit,
+			.size = pool->size,
+			.used = pool->used,
+			.max_used = pool->max_used,
+			.failures = pool->failures,
+		};
+
+		copy_name(message.name, sizeof(message.name), pool->name);
+		if (!pb_encode_tag_for_field(stream, field) ||
+		    !pb_encode_submessage(stream, mouthware_message_MemPool_fields, &message)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* nanopb callback for MemStatsResponse.sites */
+static bool encode_sites(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+	(void)arg;
+
+	for (uint8_t i = 0; i < MEM_SITE_COUNT; i++) {
+		struct mem_stats_site site;
+
+		mem_stats_site_get(i, &site);
+
+		mouthware_message_MemSite message = {
+			.calls = site.calls,
+			.failures = site.failures,
+			.peak = site.peak,
+		};
+
+		copy_name(message.name, sizeof(message.name), mem_stats_site_name(i));
+		if (!pb_encode_tag_for_field(stream, field) ||
+		    !pb_encode_submessage(stream, mouthware_message_MemSite_fields, &message)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void mem_stats_fill_response(const struct mem_stats_report *report,
+			     mouthware_message_MemStatsResponse *response)
+{
+	*response = (mouthware_message_MemStatsResponse)mouthware_message_MemStatsResponse_init_zero;
+	response->heap_size = report->heap.size;
+	response->heap_used = report->heap.used;
+	response->heap_max_used = report->heap.max_used;
+	response->heap_largest_free = report->heap.largest_free;
+	response->heap_failures = report->heap.failures;
+	response->pools.funcs.encode = encode_pools;
+	response->pools.arg = (void *)report;
+	response->sites.funcs.encode = encode_sites;
+
+	response->stacks_checked = report->stack_count;
+	for (size_t i = 0; i < report->stack_count; i++) {
+		const struct mem_stats_stack *stack = &report->stacks[i];
+
+		switch (mem_stats_stack_check(stack)) {
+		case MEM_STACK_TIGHT:
+			response->stacks_tight++;
+			break;
+		case MEM_STACK_SLACK:
+			response->stack_spare += stack->size - mem_stats_stack_budget(stack);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+int mem_stats_format(const struct mem_stats_report *report, size_t index, char *buf,
+		     size_t len)
+{
+	const struct mem_stats_heap *heap = &report->heap;
+
+	if (index == 0) {
+		if (heap->size == 0) {
+			return snprintf(buf, len, "Heap: none");
+		}
+		return snprintf(buf, len, "Heap: %u/%u bytes used, peak %u, largest free %u, %u failed",
+				(unsigned int)heap->used, (unsigned int)heap->size,
+				(unsigned int)heap->max_used, (unsigned int)heap->largest_free,
+				(unsigned int)heap->failures);
+	}
+	index--;
+
+	if (index == 0) {
+		return snprintf(buf, len, "Pool            unit   used   peak   size  failed");
+	}
+	index--;
+
+	if (index < report->pool_count) {
+		const struct mem_stats_pool *pool = &report->pools[index];
+
+		return snprintf(buf, len, "%-14s %5u %6u %6u %6u %7u", pool->name,
+				(unsigned int)pool->unit, (unsigned int)pool->used,
+				(unsigned int)pool->max_used, (unsigned int)pool->size,
+				(unsigned int)pool->failures);
+	}
+	index -= report->pool_count;
+
+	if (index == 0) {
+		return snprintf(buf, len, "Site             calls  failed   peak");
+	}
+	index--;
+
+	if (index < MEM_SITE_COUNT) {
+		struct mem_stats_site site;
+
+		mem_stats_site_get(index, &site);
+		return snprintf(buf, len, "%-14s %7u %7u %6u", mem_stats_site_name(index),
+				(unsigned int)site.calls, (unsigned int)site.failures,
+				(unsigned int)site.peak);
+	}
+	index -= MEM_SITE_COUNT;
+
+	if (report->stack_count == 0) {
+		return 0;
+	}
+
+	if (index == 0) {
+		return snprintf(buf, len, "Stack            size   peak budget  check");
+	}
+	index--;
+
+	if (index < report->stack_count) {
+		static const char *const checks[] = {
+			[MEM_STACK_OK] = "ok",
+			[MEM_STACK_TIGHT] = "TIGHT",
+			[MEM_STACK_SLACK] = "cut",
+		};
+		const struct mem_stats_stack *stack = &report->stacks[index];
+
+		return snprintf(buf, len, "%-14s %6u %6u %6u  %s", stack->name,
+				(unsigned int)stack->size, (unsigned int)stack->peak,
+				(unsigned int)mem_stats_stack_budget(stack),
+				checks[mem_stats_stack_check(stack)]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Heap and buffer pool accounting shared by both relays
+ *
+ * The relay paths take their buffers from fixed pools (slabs, rings and
+ * queues) rather than the heap, so running out shows up as a refused take
+ * long before anything leaks. Each place that takes from a pool is a site:
+ * it notes every take here with whether it succeeded and how full the pool
+ * was afterwards, which gives per-site call and failure counts and a peak
+ * for pools that keep none of their own.
+ *
+ * On a read the platform fills in a report: heap totals from its allocator
+ * (the Zephyr system heap, or the ESP-IDF internal heap), one row per pool
+ * and one per thread stack with its size and measured peak. This module
+ * formats the report for the console and encodes it as a MemStatsResponse.
+ *
+ * Each stack is checked against a budget of its measured peak plus
+ * MEM_STATS_STACK_MARGIN: below that it is tight, and a stack holding at
+ * least MEM_STATS_STACK_SLACK bytes over it can be cut to the budget. The
+ * response carries only the totals; the console lists every thread.
+ *
+ * Takes may be noted from any context. No Zephyr or ESP-IDF headers may be
+ * pulled in.
+ */
+
+#ifndef MEM_STATS_H_
+#define MEM_STATS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pools in one report; all of them fit one MemStatsResponse */
+#define MEM_STATS_POOLS_MAX 6
+
+/* Thread stacks in one report; further ones are left out */
+#define MEM_STATS_STACKS_MAX 24
+
+/* Bytes a stack keeps free above its measured peak */
+#define MEM_STATS_STACK_MARGIN 256
+
+/* Bytes over budget before a stack is worth cutting */
+#define MEM_STATS_STACK_SLACK 512
+
+/* Name length including the terminator, as in MemPool.name */
+#define MEM_STATS_NAME_LEN sizeof(((mouthware_message_MemPool *)0)->name)
+
+enum mem_site {
+	MEM_SITE_CDC_MESSAGE,      /* RelayToAppMessage queued for CDC0 */
+	MEM_SITE_CDC_PASS_THROUGH, /* MouthPad NUS data queued for CDC0 */
+	MEM_SITE_NUS_TX,           /* Host write queued for the MouthPad */
+	MEM_SITE_COUNT,
+};
+
+struct mem_stats_site {
+	uint32_t calls;
+	uint32_t failures;
+	uint32_t peak;              /* Most of its pool in use after a take */
+};
+
+struct mem_stats_heap {
+	uint32_t size;              /* Bytes; 0 without a heap */
+	uint32_t used;
+	uint32_t max_used;          /* Since boot */
+	uint32_t largest_free;      /* 0 if the allocator cannot tell */
+	uint32_t failures;          /* Allocations refused; 0 if not counted */
+};
+
+struct mem_stats_pool {
+	const char *name;
+	uint32_t unit;              /* Bytes per block; 1 for byte rings */
+	uint32_t size;              /* Blocks */
+	uint32_t used;
+	uint32_t max_used;          /* Since the last reset */
+	uint32_t failures;          /* Takes refused since the last reset */
+};
+
+struct mem_stats_stack {
+	char name[MEM_STATS_NAME_LEN];
+	uint32_t size;              /* Bytes */
+	uint32_t peak;              /* Most bytes ever used */
+};
+
+enum mem_stack_check {
+	MEM_STACK_OK,
+	MEM_STACK_TIGHT,            /* Less than the margin free at the peak */
+	MEM_STACK_SLACK,            /* Can be cut to its budget */
+};
+
+struct mem_stats_report {
+	struct mem_stats_heap heap;
+	size_t pool_count;
+	struct mem_stats_pool pools[MEM_STATS_POOLS_MAX];
+	size_t stack_count;         /* 0 if the platform does not measure stacks */
+	struct mem_stats_stack stacks[MEM_STATS_STACKS_MAX];
+};
+
+/**
+ * @brief Note one take from a pool; safe from any context
+ *
+ * @param in_use Blocks of the pool in use afterwards; ignored on failure
+ */
+void mem_stats_take(enum mem_site site, bool ok, uint32_t in_use);
+
+void mem_stats_site_get(enum mem_site site, struct mem_stats_site *stats);
+
+/**
+ * @brief Zero the site counters and peaks
+ */
+void mem_stats_reset(void);
+
+const char *mem_stats_site_name(uint8_t site);
+
+/**
+ * @brief Append a pool row; rows past MEM_STATS_POOLS_MAX are left out
+ */
+void mem_stats_add_pool(struct mem_stats_report *report, const struct mem_stats_pool *pool);
+
+/**
+ * @brief Append a thread stack; rows past MEM_STATS_STACKS_MAX are left out
+ *
+ * @param unused Bytes never touched, as the platform's high-water scan finds
+ */
+void mem_stats_add_stack(struct mem_stats_report *report, const char *name, uint32_t size,
+			 uint32_t unused);
+
+/**
+ * @brief Size a stack should have: its peak plus MEM_STATS_STACK_MARGIN,
+ *        rounded up to 64 bytes
+ */
+uint32_t mem_stats_stack_budget(const struct mem_stats_stack *stack);
+
+enum mem_stack_check mem_stats_stack_check(const struct mem_stats_stack *stack);
+
+/**
+ * @brief Fill in a MemStatsResponse from a report and the site counters
+ *
+ * The response refers to report, which must outlive the encode.
+ */
+void mem_stats_fill_response(const struct mem_stats_report *report,
+			     mouthware_message_MemStatsResponse *response);
+
+/**
+ * @brief One console line of the report or the site counters, for index
+ *        0, 1, ...
+ *
+ * @return Characters written, as snprintf; 0 past the last line
+ */
+int mem_stats_format(const struct mem_stats_report *report, size_t index, char *buf,
+		     size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEM_STATS_H_ */
@@ -742,7 +742,12 @@ bool checkreturn pb_encode_submessage(pb_ostream_t *stream, const pb_msgdesc_t *
         return false;
     
     if (stream->callback == NULL)
-        return pb_write(stream, NULL, substream.bytes_written); /* Just sizing */
+    {
+        /* Just sizing. Counted here rather than through pb_write(stream, NULL, ...),
+         * which GCC flags as a NULL memcpy source once PB_BUFFER_ONLY inlines it. */
+        stream->bytes_written += substream.bytes_written;
+        return true;
+    }
     
     if (stream->bytes_written + substream.bytes_written > stream->max_size)
         PB_RETURN_ERROR(stream, "stream full");
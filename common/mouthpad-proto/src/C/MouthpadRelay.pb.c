@@ -0,0 +1,235 @@
+/* Automatically generated nanopb constant definitions */
+/* Generated by nanopb-1.0.0-dev */
+
+#include "MouthpadRelay.pb.h"
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+PB_BIND(mouthware_message_BleConnectionStatusRead, mouthware_message_BleConnectionStatusRead, AUTO)
+
+
+PB_BIND(mouthware_message_DeviceInfoRead, mouthware_message_DeviceInfoRead, AUTO)
+
+
+PB_BIND(mouthware_message_ClearBondsWrite, mouthware_message_ClearBondsWrite, AUTO)
+
+
+PB_BIND(mouthware_message_DfuWrite, mouthware_message_DfuWrite, AUTO)
+
+
+PB_BIND(mouthware_message_ClearFirmwareCacheWrite, mouthware_message_ClearFirmwareCacheWrite, AUTO)
+
+
+PB_BIND(mouthware_message_HidLatencyRead, mouthware_message_HidLatencyRead, AUTO)
+
+
+PB_BIND(mouthware_message_HidConfigRead, mouthware_message_HidConfigRead, AUTO)
+
+
+PB_BIND(mouthware_message_HidConfigWrite, mouthware_message_HidConfigWrite, AUTO)
+
+
+PB_BIND(mouthware_message_PassThroughBatchConfigWrite, mouthware_message_PassThroughBatchConfigWrite, AUTO)
+
+
+PB_BIND(mouthware_message_RelayStatsRead, mouthware_message_RelayStatsRead, AUTO)
+
+
+PB_BIND(mouthware_message_ConnectionTimingRead, mouthware_message_ConnectionTimingRead, AUTO)
+
+
+PB_BIND(mouthware_message_LinkTelemetrySubscribe, mouthware_message_LinkTelemetrySubscribe, AUTO)
+
+
+PB_BIND(mouthware_message_RelayCapabilitiesRead, mouthware_message_RelayCapabilitiesRead, AUTO)
+
+
+PB_BIND(mouthware_message_EchoRequest, mouthware_message_EchoRequest, AUTO)
+
+
+PB_BIND(mouthware_message_HidMirrorConfigWrite, mouthware_message_HidMirrorConfigWrite, AUTO)
+
+
+PB_BIND(mouthware_message_ThreadStatsRead, mouthware_message_ThreadStatsRead, AUTO)
+
+
+PB_BIND(mouthware_message_TraceRead, mouthware_message_TraceRead, AUTO)
+
+
+PB_BIND(mouthware_message_MemStatsRead, mouthware_message_MemStatsRead, AUTO)
+
+
+PB_BIND(mouthware_message_FwUpdateStart, mouthware_message_FwUpdateStart, AUTO)
+
+
+PB_BIND(mouthware_message_FwUpdateChunk, mouthware_message_FwUpdateChunk, AUTO)
+
+
+PB_BIND(mouthware_message_FwUpdateEnd, mouthware_message_FwUpdateEnd, AUTO)
+
+
+PB_BIND(mouthware_message_NusStreamControl, mouthware_message_NusStreamControl, AUTO)
+
+
+PB_BIND(mouthware_message_NusStreamWrite, mouthware_message_NusStreamWrite, AUTO)
+
+
+PB_BIND(mouthware_message_SensorStreamFilterWrite, mouthware_message_SensorStreamFilterWrite, AUTO)
+
+
+PB_BIND(mouthware_message_SensorCodecConfigWrite, mouthware_message_SensorCodecConfigWrite, AUTO)
+
+
+PB_BIND(mouthware_message_SensorStreamRateWrite, mouthware_message_SensorStreamRateWrite, AUTO)
+
+
+PB_BIND(mouthware_message_RelayProfileKnobValue, mouthware_message_RelayProfileKnobValue, AUTO)
+
+
+PB_BIND(mouthware_message_RelayProfileWrite, mouthware_message_RelayProfileWrite, AUTO)
+
+
+PB_BIND(mouthware_message_UsbCompositionWrite, mouthware_message_UsbCompositionWrite, AUTO)
+
+
+PB_BIND(mouthware_message_LinkHistoryRead, mouthware_message_LinkHistoryRead, AUTO)
+
+
+PB_BIND(mouthware_message_PassThroughToMouthpad, mouthware_message_PassThroughToMouthpad, 2)
+
+
+PB_BIND(mouthware_message_AppToRelayMessage, mouthware_message_AppToRelayMessage, 2)
+
+
+PB_BIND(mouthware_message_BleConnectionStatusResponse, mouthware_message_BleConnectionStatusResponse, AUTO)
+
+
+PB_BIND(mouthware_message_DeviceInfoResponse, mouthware_message_DeviceInfoResponse, AUTO)
+
+
+PB_BIND(mouthware_message_ClearBondsResponse, mouthware_message_ClearBondsResponse, AUTO)
+
+
+PB_BIND(mouthware_message_DfuResponse, mouthware_message_DfuResponse, AUTO)
+
+
+PB_BIND(mouthware_message_ClearFirmwareCacheResponse, mouthware_message_ClearFirmwareCacheResponse, AUTO)
+
+
+PB_BIND(mouthware_message_HidLatencyReportStats, mouthware_message_HidLatencyReportStats, AUTO)
+
+
+PB_BIND(mouthware_message_HidLatencyResponse, mouthware_message_HidLatencyResponse, AUTO)
+
+
+PB_BIND(mouthware_message_HidConfigResponse, mouthware_message_HidConfigResponse, AUTO)
+
+
+PB_BIND(mouthware_message_PassThroughBatchConfigResponse, mouthware_message_PassThroughBatchConfigResponse, AUTO)
+
+
+PB_BIND(mouthware_message_RelayStatsPathCounters, mouthware_message_RelayStatsPathCounters, AUTO)
+
+
+PB_BIND(mouthware_message_RelayStatsResponse, mouthware_message_RelayStatsResponse, AUTO)
+
+
+PB_BIND(mouthware_message_ConnectionTimingRecord, mouthware_message_ConnectionTimingRecord, AUTO)
+
+
+PB_BIND(mouthware_message_ConnectionTimingResponse, mouthware_message_ConnectionTimingResponse, AUTO)
+
+
+PB_BIND(mouthware_message_LinkTelemetry, mouthware_message_LinkTelemetry, AUTO)
+
+
+PB_BIND(mouthware_message_RelayCapabilitiesResponse, mouthware_message_RelayCapabilitiesResponse, AUTO)
+
+
+PB_BIND(mouthware_message_EchoResponse, mouthware_message_EchoResponse, AUTO)
+
+
+PB_BIND(mouthware_message_HidMirrorConfigResponse, mouthware_message_HidMirrorConfigResponse, AUTO)
+
+
+PB_BIND(mouthware_message_HidMirrorRecord, mouthware_message_HidMirrorRecord, AUTO)
+
+
+PB_BIND(mouthware_message_HidMirrorBatch, mouthware_message_HidMirrorBatch, AUTO)
+
+
+PB_BIND(mouthware_message_ThreadStat, mouthware_message_ThreadStat, AUTO)
+
+
+PB_BIND(mouthware_message_ThreadStatsResponse, mouthware_message_ThreadStatsResponse, AUTO)
+
+
+PB_BIND(mouthware_message_TraceResponse, mouthware_message_TraceResponse, AUTO)
+
+
+PB_BIND(mouthware_message_MemPool, mouthware_message_MemPool, AUTO)
+
+
+PB_BIND(mouthware_message_MemSite, mouthware_message_MemSite, AUTO)
+
+
+PB_BIND(mouthware_message_MemStatsResponse, mouthware_message_MemStatsResponse, AUTO)
+
+
+PB_BIND(mouthware_message_FwUpdateStatus, mouthware_message_FwUpdateStatus, AUTO)
+
+
+PB_BIND(mouthware_message_NusStreamStatus, mouthware_message_NusStreamStatus, AUTO)
+
+
+PB_BIND(mouthware_message_SensorStreamFilterResponse, mouthware_message_SensorStreamFilterResponse, AUTO)
+
+
+PB_BIND(mouthware_message_SensorCodecConfigResponse, mouthware_message_SensorCodecConfigResponse, AUTO)
+
+
+PB_BIND(mouthware_message_SensorFrameDelta, mouthware_message_SensorFrameDelta, AUTO)
+
+
+PB_BIND(mouthware_message_SensorStreamRateResponse, mouthware_message_SensorStreamRateResponse, AUTO)
+
+
+PB_BIND(mouthware_message_RelayProfileResponse, mouthware_message_RelayProfileResponse, AUTO)
+
+
+PB_BIND(mouthware_message_UsbCompositionResponse, mouthware_message_UsbCompositionResponse, AUTO)
+
+
+PB_BIND(mouthware_message_LinkHistoryResponse, mouthware_message_LinkHistoryResponse, AUTO)
+
+
+PB_BIND(mouthware_message_RequestError, mouthware_message_RequestError, AUTO)
+
+
+PB_BIND(mouthware_message_PassThroughToMouthpadResponse, mouthware_message_PassThroughToMouthpadResponse, AUTO)
+
+
+PB_BIND(mouthware_message_PassThroughToApp, mouthware_message_PassThroughToApp, 2)
+
+
+PB_BIND(mouthware_message_PassThroughChunk, mouthware_message_PassThroughChunk, 2)
+
+
+PB_BIND(mouthware_message_PassThroughToAppBatch, mouthware_message_PassThroughToAppBatch, AUTO)
+
+
+PB_BIND(mouthware_message_RelayToAppMessage, mouthware_message_RelayToAppMessage, 2)
+
+
+
+
+
+
+
+
+
+
+
+
+
@@ -0,0 +1,2213 @@
+/* Automatically generated nanopb header */
+/* Generated by nanopb-1.0.0-dev */
+
+#ifndef PB_MOUTHWARE_MESSAGE_MOUTHPADRELAY_PB_H_INCLUDED
+#define PB_MOUTHWARE_MESSAGE_MOUTHPADRELAY_PB_H_INCLUDED
+#include <pb.h>
+
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+/* Enum definitions */
+typedef enum _mouthware_message_AppToRelayMessageDestination {
+    mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_UNSPECIFIED = 0,
+    mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY = 1,
+    mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD = 2
+} mouthware_message_AppToRelayMessageDestination;
+
+typedef enum _mouthware_message_RelayBleConnectionStatus {
+    mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_UNSPECIFIED = 0,
+    mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_DISCONNECTED = 1,
+    mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTED = 2,
+    mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_SEARCHING = 3,
+    mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTING = 4
+} mouthware_message_RelayBleConnectionStatus;
+
+typedef enum _mouthware_message_DeviceFamily {
+    mouthware_message_DeviceFamily_DEVICE_FAMILY_UNSPECIFIED = 0,
+    mouthware_message_DeviceFamily_DEVICE_FAMILY_NRF = 1,
+    mouthware_message_DeviceFamily_DEVICE_FAMILY_ESP = 2
+} mouthware_message_DeviceFamily;
+
+typedef enum _mouthware_message_DeviceBoard {
+    mouthware_message_DeviceBoard_DEVICE_BOARD_UNSPECIFIED = 0,
+    /* nRF52840 boards */
+    mouthware_message_DeviceBoard_DEVICE_BOARD_SEEED_XIAO_NRF52840 = 1,
+    mouthware_message_DeviceBoard_DEVICE_BOARD_NORDIC_NRF52840DONGLE = 2,
+    mouthware_message_DeviceBoard_DEVICE_BOARD_APRBROTHER_NRF52840 = 3,
+    mouthware_message_DeviceBoard_DEVICE_BOARD_RAYTAC_MDBT50Q_RX = 4,
+    mouthware_message_DeviceBoard_DEVICE_BOARD_RAYTAC_MDBT50Q_CX_40 = 5,
+    mouthware_message_DeviceBoard_DEVICE_BOARD_MAKERDIARY_NRF52840_MDK = 6,
+    mouthware_message_DeviceBoard_DEVICE_BOARD_ADAFRUIT_FEATHER_NRF52840 = 7,
+    /* ESP32-S3 boards */
+    mouthware_message_DeviceBoard_DEVICE_BOARD_SEEED_XIAO_ESP32S3 = 100,
+    mouthware_message_DeviceBoard_DEVICE_BOARD_LILYGO_TDISPLAY_S3 = 101
+} mouthware_message_DeviceBoard;
+
+typedef enum _mouthware_message_PassThroughToMouthpadErrorCode {
+    mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED = 0,
+    mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_TIMEOUT = 1,
+    mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_TOO_LARGE = 2,
+    mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED = 3,
+    mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNKNOWN_ERROR = 4,
+    mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_INVALID_MESSAGE = 5,
+    mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_FRAGMENT_OUT_OF_ORDER = 6
+} mouthware_message_PassThroughToMouthpadErrorCode;
+
+/* Bits of RelayCapabilitiesResponse.features */
+typedef enum _mouthware_message_RelayFeature {
+    mouthware_message_RelayFeature_RELAY_FEATURE_NONE = 0,
+    mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_BATCH = 1, /* PassThroughBatchConfigWrite can enable PassThroughToAppBatch */
+    mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_CREDITS = 2, /* PassThroughToMouthpadResponse.credits is meaningful */
+    mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_FRAGMENTS = 4, /* PassThroughToMouthpad fragments are reassembled */
+    mouthware_message_RelayFeature_RELAY_FEATURE_LINK_TELEMETRY = 8, /* LinkTelemetrySubscribe is answered */
+    mouthware_message_RelayFeature_RELAY_FEATURE_STATUS_PUSH = 16, /* BleConnectionStatusResponse is pushed on state changes */
+    mouthware_message_RelayFeature_RELAY_FEATURE_SECONDARY_MOUTHPADS = 32, /* device_index > 0 may appear */
+    mouthware_message_RelayFeature_RELAY_FEATURE_RELAY_STATS = 64, /* RelayStatsRead is answered */
+    mouthware_message_RelayFeature_RELAY_FEATURE_CONNECTION_TIMING = 128, /* ConnectionTimingRead is answered */
+    mouthware_message_RelayFeature_RELAY_FEATURE_HID_LATENCY = 256, /* HidLatencyRead is answered */
+    mouthware_message_RelayFeature_RELAY_FEATURE_ECHO = 512, /* EchoRequest is answered, via_mouthpad included */
+    mouthware_message_RelayFeature_RELAY_FEATURE_HID_MIRROR = 1024, /* HidMirrorConfigWrite can enable HidMirrorBatch */
+    mouthware_message_RelayFeature_RELAY_FEATURE_THREAD_STATS = 2048, /* ThreadStatsRead is answered */
+    mouthware_message_RelayFeature_RELAY_FEATURE_TRACE = 4096, /* TraceRead is answered */
+    mouthware_message_RelayFeature_RELAY_FEATURE_MEM_STATS = 8192, /* MemStatsRead is answered */
+    mouthware_message_RelayFeature_RELAY_FEATURE_FW_UPDATE = 16384, /* FwUpdateStart can stream a new firmware image over CDC0 */
+    mouthware_message_RelayFeature_RELAY_FEATURE_NUS_STREAM = 32768, /* NusStreamControl opens a bulk stream to the MouthPad over NUS */
+    mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_STREAM_FILTER = 65536, /* SensorStreamFilterWrite can stop MouthPad streams at the relay */
+    mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_CODEC = 131072, /* SensorCodecConfigWrite can switch sensor frames to SensorFrameDelta */
+    mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_STREAM_RATE = 262144, /* SensorStreamRateWrite can thin MouthPad streams at the relay */
+    mouthware_message_RelayFeature_RELAY_FEATURE_REQUEST_ID = 524288, /* AppToRelayMessage.request_id is echoed in the reply, and requests the relay cannot run get a RequestError */
+    mouthware_message_RelayFeature_RELAY_FEATURE_COBS_FRAMING = 1048576, /* COBS frames are accepted, and answered in COBS */
+    mouthware_message_RelayFeature_RELAY_FEATURE_TUNING_PROFILE = 2097152, /* RelayProfileWrite selects a persisted tuning profile */
+    mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_ACK_MODES = 4194304, /* PassThroughToMouthpad.ack is honoured */
+    mouthware_message_RelayFeature_RELAY_FEATURE_SCAN_BOOST = 8388608, /* BleConnectionStatusRead.scan_boost brings scanning back to full rate */
+    mouthware_message_RelayFeature_RELAY_FEATURE_USB_COMPOSITION = 16777216, /* UsbCompositionWrite picks the USB functions the relay enumerates with */
+    mouthware_message_RelayFeature_RELAY_FEATURE_RAW_CHANNELS = 33554432, /* Channel payloads (mouthpad_frame.h) are accepted, and MouthPad notifications answered on the NUS channel */
+    mouthware_message_RelayFeature_RELAY_FEATURE_LINK_HISTORY = 67108864 /* LinkHistoryRead is answered */
+} mouthware_message_RelayFeature;
+
+/* MouthPad NUS streams as the relay tells them apart; bit (1 << value) in SensorStreamFilterWrite.blocked */
+typedef enum _mouthware_message_SensorStream {
+    mouthware_message_SensorStream_SENSOR_STREAM_OTHER = 0, /* Anything not recognized below */
+    mouthware_message_SensorStream_SENSOR_STREAM_SENSOR = 1, /* Sensor frames of 138 bytes or more: JCP, IMU, click and cap-touch */
+    mouthware_message_SensorStream_SENSOR_STREAM_POWER = 2 /* Power frames: 9 to 137 bytes with byte 3 below 0x10 */
+} mouthware_message_SensorStream;
+
+/* Why the relay did not answer a request that carried a request_id */
+typedef enum _mouthware_message_RequestErrorCode {
+    mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_UNSPECIFIED = 0,
+    mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_BUSY = 1, /* Too many requests waiting at the relay; send it again later */
+    mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_UNSUPPORTED = 2, /* This firmware has no handler for the request */
+    mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_FAILED = 3 /* The handler ran and failed; any reply it sent before failing carries the same request_id */
+} mouthware_message_RequestErrorCode;
+
+/* Runtime tuning presets of RelayProfileWrite */
+typedef enum _mouthware_message_RelayProfile {
+    mouthware_message_RelayProfile_RELAY_PROFILE_UNCHANGED = 0, /* In a write: keep the current preset */
+    mouthware_message_RelayProfile_RELAY_PROFILE_LOW_LATENCY = 1, /* Shortest intervals, never relaxed, stronger link */
+    mouthware_message_RelayProfile_RELAY_PROFILE_BALANCED = 2, /* The firmware's build-time settings */
+    mouthware_message_RelayProfile_RELAY_PROFILE_BATTERY = 3 /* Longer intervals, weaker link, status lights off */
+} mouthware_message_RelayProfile;
+
+/* Tunables of a profile; index of RelayProfileResponse.values */
+typedef enum _mouthware_message_RelayProfileKnob {
+    mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_ACTIVE_INTERVAL = 0, /* Connection interval while active, 1.25 ms units */
+    mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_IDLE_INTERVAL = 1, /* Connection interval once idle, 1.25 ms units */
+    mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_IDLE_LATENCY = 2, /* Peripheral latency once idle, in connection events */
+    mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_TX_POWER_TARGET = 3, /* Signal the MouthPad should receive from the relay, dBm */
+    mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_STATUS_LIGHTS = 4, /* 1 to drive the status LEDs and display, 0 to keep them dark */
+    mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_CDC_COALESCE_US = 5 /* How long CDC0 frames wait to share a USB packet */
+} mouthware_message_RelayProfileKnob;
+
+/* USB functions of UsbCompositionWrite; HID interfaces are always enumerated */
+typedef enum _mouthware_message_UsbComposition {
+    mouthware_message_UsbComposition_USB_COMPOSITION_UNCHANGED = 0, /* In a write: keep the saved composition */
+    mouthware_message_UsbComposition_USB_COMPOSITION_FULL = 1, /* Every function the firmware was built with */
+    mouthware_message_UsbComposition_USB_COMPOSITION_HID_BRIDGE = 2, /* HID and CDC0, the relay protocol and NUS bridge port */
+    mouthware_message_UsbComposition_USB_COMPOSITION_HID_ONLY = 3 /* HID alone, no class driver beyond the host's HID driver */
+} mouthware_message_UsbComposition;
+
+/* Which PassThroughToMouthpadResponse a write gets */
+typedef enum _mouthware_message_PassThroughAckMode {
+    mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_EACH = 0, /* One response per write */
+    mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_ERRORS = 1, /* A response only if the write fails */
+    mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_NONE = 2, /* No response at all */
+    mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_CUMULATIVE = 3 /* One response per pass_through_ack_writes writes or pass_through_ack_interval_us, and at once on a failure */
+} mouthware_message_PassThroughAckMode;
+
+/* Struct definitions */
+typedef struct _mouthware_message_BleConnectionStatusRead {
+    bool scan_boost; /* The user is waiting for the MouthPad: scan at full rate again while disconnected */
+} mouthware_message_BleConnectionStatusRead;
+
+typedef struct _mouthware_message_DeviceInfoRead {
+    char dummy_field;
+} mouthware_message_DeviceInfoRead;
+
+typedef struct _mouthware_message_ClearBondsWrite {
+    char dummy_field;
+} mouthware_message_ClearBondsWrite;
+
+typedef struct _mouthware_message_DfuWrite { /* Triggers device to enter bootloader/DFU mode */
+    char dummy_field;
+} mouthware_message_DfuWrite;
+
+typedef struct _mouthware_message_ClearFirmwareCacheWrite { /* Clears cached firmware versions for all bonded devices
+ Used when initiating firmware update to prevent false "update needed" warnings */
+    char dummy_field;
+} mouthware_message_ClearFirmwareCacheWrite;
+
+typedef struct _mouthware_message_HidLatencyRead { /* Request BLE->USB HID latency histograms from the relay */
+    char dummy_field;
+} mouthware_message_HidLatencyRead;
+
+typedef struct _mouthware_message_HidConfigRead { /* Request the relay's current USB HID forwarding options */
+    char dummy_field;
+} mouthware_message_HidConfigRead;
+
+typedef struct _mouthware_message_HidConfigWrite { /* Change USB HID forwarding options (not persisted) */
+    bool motion_interpolation; /* Spread each motion report across 1 ms USB frames */
+    bool motion_prediction; /* With interpolation, extrapolate motion while a BLE report is late */
+} mouthware_message_HidConfigWrite;
+
+typedef struct _mouthware_message_PassThroughBatchConfigWrite { /* Negotiate batched pass-through delivery (not persisted) */
+    bool enabled; /* Batch MouthPad pass-through data into PassThroughToAppBatch */
+} mouthware_message_PassThroughBatchConfigWrite;
+
+typedef struct _mouthware_message_RelayStatsRead { /* Request NUS/HID data path counters from the relay */
+    bool reset; /* Clear the counters once they have been read */
+} mouthware_message_RelayStatsRead;
+
+typedef struct _mouthware_message_ConnectionTimingRead { /* Request per-phase timings of recent connections from the relay */
+    bool clear; /* Forget the recorded connections once they have been read */
+} mouthware_message_ConnectionTimingRead;
+
+typedef struct _mouthware_message_LinkTelemetrySubscribe { /* Ask the relay to push LinkTelemetry instead of being polled */
+    uint32_t interval_ms; /* Sampling period; 0 with on_change false stops the stream */
+    bool on_change; /* Only send samples whose link state or drop counts changed */
+} mouthware_message_LinkTelemetrySubscribe;
+
+typedef struct _mouthware_message_RelayCapabilitiesRead { /* Ask the relay which optional protocol features it supports */
+    char dummy_field;
+} mouthware_message_RelayCapabilitiesRead;
+
+typedef PB_BYTES_ARRAY_T(20) mouthware_message_EchoRequest_payload_t;
+typedef struct _mouthware_message_EchoRequest { /* Round-trip probe; the relay stamps it with its own clock and sends it back */
+    uint64_t host_timestamp_us; /* Host clock when sent, returned untouched */
+    uint32_t sequence; /* Returned untouched */
+    bool via_mouthpad; /* Also time an acknowledged NUS write of payload to the MouthPad */
+    mouthware_message_EchoRequest_payload_t payload; /* Written to the MouthPad when via_mouthpad; must be something it ignores */
+} mouthware_message_EchoRequest;
+
+typedef struct _mouthware_message_HidMirrorConfigWrite { /* Mirror forwarded HID reports onto CDC0 as HidMirrorBatch (not persisted) */
+    bool enabled;
+} mouthware_message_HidMirrorConfigWrite;
+
+typedef struct _mouthware_message_ThreadStatsRead { /* Ask for per-thread CPU, stack and context switch figures */
+    char dummy_field;
+} mouthware_message_ThreadStatsRead;
+
+typedef struct _mouthware_message_TraceRead { /* Read the event trace kept across resets, a page at a time */
+    uint32_t offset; /* First record to send, counted from the oldest held */
+    bool clear; /* Discard every record once this page has been sent */
+} mouthware_message_TraceRead;
+
+typedef struct _mouthware_message_MemStatsRead { /* Ask for heap and buffer pool usage */
+    bool reset; /* Restart the pool peaks and site counters once the reply has been sent */
+} mouthware_message_MemStatsRead;
+
+typedef PB_BYTES_ARRAY_T(32) mouthware_message_FwUpdateStart_sha256_t;
+typedef struct _mouthware_message_FwUpdateStart { /* Open the update slot for a new image; any update in progress is abandoned */
+    uint32_t size; /* Image size in bytes */
+    mouthware_message_FwUpdateStart_sha256_t sha256; /* SHA-256 of the whole image, checked before it is marked for boot */
+} mouthware_message_FwUpdateStart;
+
+typedef PB_BYTES_ARRAY_T(240) mouthware_message_FwUpdateChunk_data_t;
+typedef struct _mouthware_message_FwUpdateChunk { /* Image bytes; send in order, at most FwUpdateStatus.window beyond FwUpdateStatus.written */
+    uint32_t offset; /* Position of data in the image */
+    mouthware_message_FwUpdateChunk_data_t data;
+} mouthware_message_FwUpdateChunk;
+
+typedef struct _mouthware_message_FwUpdateEnd { /* Finish or abandon the update */
+    bool abort; /* Abandon the update; the running image stays */
+    bool reboot; /* Reboot into the new image once it is verified */
+} mouthware_message_FwUpdateEnd;
+
+typedef struct _mouthware_message_NusStreamControl { /* Open or close the bulk stream to the MouthPad */
+    bool enabled; /* Open a new stream from offset 0, or close it once what was received has been written */
+} mouthware_message_NusStreamControl;
+
+typedef PB_BYTES_ARRAY_T(240) mouthware_message_NusStreamWrite_data_t;
+typedef struct _mouthware_message_NusStreamWrite { /* Stream bytes; send in order, ending at most NusStreamStatus.window beyond NusStreamStatus.forwarded */
+    uint32_t offset; /* Position of data in the stream */
+    mouthware_message_NusStreamWrite_data_t data;
+} mouthware_message_NusStreamWrite;
+
+typedef struct _mouthware_message_SensorStreamFilterWrite { /* Choose which MouthPad streams the relay forwards (not persisted) */
+    uint32_t blocked; /* Bits (1 << SensorStream) of streams to drop at the relay; 0 forwards everything */
+} mouthware_message_SensorStreamFilterWrite;
+
+typedef struct _mouthware_message_SensorCodecConfigWrite { /* Send the primary MouthPad's sensor frames as SensorFrameDelta instead of PassThroughToApp (not persisted) */
+    bool enabled;
+    uint32_t keyframe_interval; /* Frames per keyframe; 0 keeps the relay's default */
+} mouthware_message_SensorCodecConfigWrite;
+
+typedef struct _mouthware_message_SensorStreamRateWrite { /* Thin one MouthPad stream at the relay (not persisted); 0 in both limits forwards every notification */
+    mouthware_message_SensorStream stream;
+    uint32_t keep_one_in; /* Forward one notification in this many, per MouthPad; 0 or 1 forwards all */
+    uint32_t min_interval_us; /* Forward at most one notification per this many microseconds on average, per MouthPad; 0 for no limit */
+} mouthware_message_SensorStreamRateWrite;
+
+typedef struct _mouthware_message_RelayProfileKnobValue {
+    mouthware_message_RelayProfileKnob knob;
+    int32_t value;
+} mouthware_message_RelayProfileKnobValue;
+
+typedef struct _mouthware_message_RelayProfileWrite { /* Choose a tuning preset and override single knobs (persisted); an empty write only reads */
+    mouthware_message_RelayProfile profile;
+    bool clear_overrides; /* Drop the overrides in force before applying these */
+    pb_size_t overrides_count;
+    mouthware_message_RelayProfileKnobValue overrides[6]; /* Kept across preset changes until cleared */
+} mouthware_message_RelayProfileWrite;
+
+typedef struct _mouthware_message_UsbCompositionWrite { /* Choose the USB functions enumerated from the next enumeration on (persisted); an empty write only reads */
+    mouthware_message_UsbComposition composition;
+    bool reenumerate; /* Re-enumerate right after the response so the saved composition takes effect */
+} mouthware_message_UsbCompositionWrite;
+
+typedef struct _mouthware_message_LinkHistoryRead { /* Read one MouthPad's hourly link history, a page at a time */
+    uint32_t bond; /* 0 for the MouthPad connected most recently */
+    uint32_t offset; /* First bucket to send, counted from the oldest held */
+    bool clear; /* Forget every MouthPad's history instead */
+} mouthware_message_LinkHistoryRead;
+
+typedef PB_BYTES_ARRAY_T(240) mouthware_message_PassThroughToMouthpad_data_t;
+typedef struct _mouthware_message_PassThroughToMouthpad {
+    mouthware_message_PassThroughToMouthpad_data_t data;
+    bool reliable; /* Send as an acknowledged write request instead of write-without-response */
+    bool more_fragments; /* Further fragments of this payload follow; the relay reassembles them */
+    uint32_t fragment; /* Index of this fragment within the payload, 0 for the first */
+    uint32_t device_index; /* MouthPad to write to: 0 for the primary, 1 and up for secondary links */
+    mouthware_message_PassThroughAckMode ack; /* Response wanted for this write; EACH unless RELAY_FEATURE_PASS_THROUGH_ACK_MODES is listed */
+    uint32_t sequence; /* Host's number for this write, echoed in the response that covers it */
+} mouthware_message_PassThroughToMouthpad;
+
+/* / Message from App to the MouthPad Relay. */
+typedef struct _mouthware_message_AppToRelayMessage {
+    /* / The intended destination for the wrapped message. */
+    mouthware_message_AppToRelayMessageDestination destination;
+    pb_size_t which_message_body;
+    union _mouthware_message_AppToRelayMessage_message_body {
+        /* / Request information from the relay regarding current BLE connection status */
+        mouthware_message_BleConnectionStatusRead ble_connection_status_read;
+        /* / Message to forward to the MouthPad through the Relay. */
+        mouthware_message_PassThroughToMouthpad pass_through_to_mouthpad;
+        /* / Request device information from the connected MouthPad */
+        mouthware_message_DeviceInfoRead device_info_read;
+        /* / Request to clear all bonded devices on the relay */
+        mouthware_message_ClearBondsWrite clear_bonds_write;
+        /* / Request to enter DFU/bootloader mode */
+        mouthware_message_DfuWrite dfu_write;
+        /* / Request to clear cached firmware versions from relay */
+        mouthware_message_ClearFirmwareCacheWrite clear_firmware_cache_write;
+        /* / Request BLE->USB HID latency statistics from the relay */
+        mouthware_message_HidLatencyRead hid_latency_read;
+        /* / Request current USB HID forwarding options */
+        mouthware_message_HidConfigRead hid_config_read;
+        /* / Change USB HID forwarding options */
+        mouthware_message_HidConfigWrite hid_config_write;
+        /* / Enable or disable batched pass-through delivery */
+        mouthware_message_PassThroughBatchConfigWrite pass_through_batch_config_write;
+        /* / Request data path counters from the relay */
+        mouthware_message_RelayStatsRead relay_stats_read;
+        /* / Request connection phase timings from the relay */
+        mouthware_message_ConnectionTimingRead connection_timing_read;
+        /* / Start, change or stop the LinkTelemetry stream */
+        mouthware_message_LinkTelemetrySubscribe link_telemetry_subscribe;
+        /* / Ask which optional features the relay supports */
+        mouthware_message_RelayCapabilitiesRead relay_capabilities_read;
+        /* / Measure host<->relay, and optionally relay<->MouthPad, round trips */
+        mouthware_message_EchoRequest echo_request;
+        /* / Start or stop the HID mirror stream */
+        mouthware_message_HidMirrorConfigWrite hid_mirror_config_write;
+        /* / Per-thread CPU and stack usage since the previous read */
+        mouthware_message_ThreadStatsRead thread_stats_read;
+        /* / Events recorded before and since the last reset */
+        mouthware_message_TraceRead trace_read;
+        /* / Heap and buffer pool usage */
+        mouthware_message_MemStatsRead mem_stats_read;
+        /* / Start streaming a firmware image into the update slot */
+        mouthware_message_FwUpdateStart fw_update_start;
+        /* / Part of the firmware image */
+        mouthware_message_FwUpdateChunk fw_update_chunk;
+        /* / Verify the image and mark it for the next boot, or abandon it */
+        mouthware_message_FwUpdateEnd fw_update_end;
+        /* / Open or close the bulk NUS stream */
+        mouthware_message_NusStreamControl nus_stream_control;
+        /* / Bulk data for the MouthPad, split into NUS writes by the relay */
+        mouthware_message_NusStreamWrite nus_stream_write;
+        /* / Stop or restart MouthPad streams at the relay */
+        mouthware_message_SensorStreamFilterWrite sensor_stream_filter_write;
+        /* / Turn the sensor frame codec on or off */
+        mouthware_message_SensorCodecConfigWrite sensor_codec_config_write;
+        /* / Thin a MouthPad stream to the rate the host consumes */
+        mouthware_message_SensorStreamRateWrite sensor_stream_rate_write;
+        /* / Read or change the tuning profile */
+        mouthware_message_RelayProfileWrite relay_profile_write;
+        /* / Read or change the USB composition */
+        mouthware_message_UsbCompositionWrite usb_composition_write;
+        /* / Read the per-MouthPad link history */
+        mouthware_message_LinkHistoryRead link_history_read;
+    } message_body;
+    /* / Echoed in the RelayToAppMessage answering this request; 0 for none */
+    uint32_t request_id;
+} mouthware_message_AppToRelayMessage;
+
+typedef struct _mouthware_message_BleConnectionStatusResponse {
+    mouthware_message_RelayBleConnectionStatus connection_status;
+    int32_t rssi;
+    uint32_t battery_level; /* Battery level percentage (0-100) from BLE Battery Service */
+    uint32_t tx_phy; /* LE PHY used to transmit to the MouthPad: 1 = 1M, 2 = 2M, 3 = Coded, 0 = unknown */
+    uint32_t rx_phy; /* LE PHY used to receive from the MouthPad, same encoding as tx_phy */
+    uint32_t max_tx_octets; /* Negotiated LL data length towards the MouthPad (27-251), 0 = unknown */
+    uint32_t max_rx_octets; /* Negotiated LL data length from the MouthPad (27-251), 0 = unknown */
+    uint32_t connected_devices; /* MouthPads connected, primary and secondary links together */
+} mouthware_message_BleConnectionStatusResponse;
+
+typedef struct _mouthware_message_DeviceInfoResponse {
+    pb_callback_t name; /* Advertised device name */
+    pb_callback_t firmware; /* Firmware version */
+    pb_callback_t address; /* BLE MAC address */
+    uint32_t vid; /* USB Vendor ID from PnP ID characteristic */
+    uint32_t pid; /* USB Product ID from PnP ID characteristic */
+    mouthware_message_DeviceFamily family; /* Device family */
+    mouthware_message_DeviceBoard board; /* Target board */
+} mouthware_message_DeviceInfoResponse;
+
+typedef struct _mouthware_message_ClearBondsResponse {
+    bool success;
+} mouthware_message_ClearBondsResponse;
+
+typedef struct _mouthware_message_DfuResponse {
+    bool success;
+} mouthware_message_DfuResponse;
+
+typedef struct _mouthware_message_ClearFirmwareCacheResponse {
+    bool success;
+} mouthware_message_ClearFirmwareCacheResponse;
+
+typedef struct _mouthware_message_HidLatencyReportStats {
+    uint32_t report_id; /* HID report ID */
+    uint32_t count; /* Reports measured since boot or last reset */
+    uint32_t p50_us; /* Median latency in microseconds */
+    uint32_t p99_us; /* 99th percentile latency in microseconds */
+    uint32_t max_us; /* Worst observed latency in microseconds */
+} mouthware_message_HidLatencyReportStats;
+
+typedef struct _mouthware_message_HidLatencyResponse {
+    pb_size_t reports_count;
+    mouthware_message_HidLatencyReportStats reports[4];
+} mouthware_message_HidLatencyResponse;
+
+typedef struct _mouthware_message_HidConfigResponse { /* Current USB HID forwarding options, sent in reply to HidConfigRead/Write */
+    bool motion_interpolation; /* Motion interpolation active */
+    bool motion_prediction; /* Motion prediction active */
+} mouthware_message_HidConfigResponse;
+
+typedef struct _mouthware_message_PassThroughBatchConfigResponse { /* Sent in reply to PassThroughBatchConfigWrite */
+    bool enabled; /* Batching active; false if the relay does not support it */
+} mouthware_message_PassThroughBatchConfigResponse;
+
+typedef struct _mouthware_message_RelayStatsPathCounters {
+    uint32_t packets; /* Packets entering the path */
+    uint32_t bytes; /* Payload bytes entering the path */
+    uint32_t echo_filtered; /* Packets discarded as echoes */
+    uint32_t dropped; /* Packets lost to errors or an unready link */
+    uint32_t bridged; /* Packets delivered to the other side */
+} mouthware_message_RelayStatsPathCounters;
+
+typedef struct _mouthware_message_RelayStatsResponse { /* Counters since boot or the last reset */
+    bool has_nus_rx;
+    mouthware_message_RelayStatsPathCounters nus_rx; /* MouthPad NUS notifications to the host */
+    bool has_nus_tx;
+    mouthware_message_RelayStatsPathCounters nus_tx; /* Host pass-through writes to the MouthPad */
+    bool has_hid;
+    mouthware_message_RelayStatsPathCounters hid; /* MouthPad HID reports to USB HID */
+} mouthware_message_RelayStatsResponse;
+
+typedef struct _mouthware_message_ConnectionTimingRecord {
+    uint32_t sequence; /* Connection attempt number since boot */
+    bool bonded; /* Reconnect to a bonded MouthPad */
+    bool in_progress; /* Still connecting or connected */
+    uint32_t first_adv_ms; /* First matching MouthPad advertisement, ms after scanning started; 0 if not reached */
+    uint32_t connect_request_ms; /* Connection requested, ms after scanning started; 0 if not reached */
+    uint32_t connected_ms; /* Link layer connection established, ms after scanning started; 0 if not reached */
+    uint32_t security_ms; /* Link encrypted, ms after scanning started; 0 if not reached */
+    uint32_t hid_ready_ms; /* HID reports flowing, ms after scanning started; 0 if not reached */
+    uint32_t nus_ready_ms; /* NUS notifications enabled, ms after scanning started; 0 if not reached */
+    uint32_t dis_ready_ms; /* Device information read, ms after scanning started; 0 if not reached */
+    uint32_t bas_ready_ms; /* First battery level received, ms after scanning started; 0 if not reached */
+    uint32_t att_bearers; /* ATT bearers open once the link was secured: 1 unenhanced plus any EATT ones; 0 if not known */
+} mouthware_message_ConnectionTimingRecord;
+
+typedef struct _mouthware_message_ConnectionTimingResponse { /* Phase timings of the most recent connection attempts */
+    pb_size_t records_count;
+    mouthware_message_ConnectionTimingRecord records[4]; /* Newest first */
+    uint32_t boot_usb_enumerated_ms; /* USB configured by the host, ms after boot; 0 if not yet */
+    uint32_t boot_hid_ready_ms; /* First HID reports flowing, ms after boot; 0 if not yet */
+    uint32_t boot_usb_started_ms; /* USB device stack up, ms after boot; 0 if not yet */
+    uint32_t boot_ble_ready_ms; /* Bluetooth controller and host up, ms after boot; 0 if not yet */
+    uint32_t boot_scan_started_ms; /* First scan for the MouthPad, ms after boot; 0 if not yet */
+} mouthware_message_ConnectionTimingResponse;
+
+typedef struct _mouthware_message_LinkTelemetry { /* Pushed at the subscribed rate; the first one answers the LinkTelemetrySubscribe */
+    uint32_t sequence; /* Increments by one per sample sent */
+    bool connected; /* Primary MouthPad link up */
+    int32_t rssi; /* dBm, 0 if unknown */
+    uint32_t battery_level; /* Percent, 0 if unknown */
+    uint32_t conn_interval_us; /* Current connection interval */
+    uint32_t tx_phy; /* HCI PHY code, 0 if unknown */
+    uint32_t rx_phy; /* HCI PHY code, 0 if unknown */
+    uint32_t hid_reports_per_s; /* HID reports received per second over the last sampling period */
+    uint32_t hid_dropped; /* HID reports dropped since boot */
+    uint32_t nus_rx_dropped; /* MouthPad notifications dropped since boot */
+    uint32_t nus_tx_dropped; /* Host pass-through writes dropped since boot */
+    uint32_t nus_tx_queued; /* Pass-through writes waiting for the MouthPad */
+    uint32_t cdc_tx_queued; /* Bytes waiting for the host on CDC0 */
+    uint32_t interval_ms; /* Sampling period in effect */
+    uint32_t stalls; /* Pipeline delays and worker gaps over the stall threshold since boot */
+    uint32_t worst_stall_us; /* Longest pipeline delay or worker gap since boot */
+    uint32_t usb_wait_us; /* Mean time a HID report waited for the host to read it over the last sampling period, 0 if not measured */
+    uint32_t usb_phase_us; /* Mean time from Start of Frame to HID report submit over the last sampling period, 0 if not measured */
+    uint32_t nus_seq_lost; /* MouthPad sensor and power notifications missing from their sequence since boot */
+    uint32_t nus_seq_reordered; /* MouthPad notifications that arrived behind a later one since boot */
+    uint32_t nus_loss_permille; /* Share of MouthPad sensor and power notifications lost over the last sampling period, in 1/1000 */
+    pb_size_t nus_gap_lengths_count;
+    uint32_t nus_gap_lengths[6]; /* Sequence gaps since boot by length: 1, 2, 3-4, 5-8, 9-16, 17 or more */
+} mouthware_message_LinkTelemetry;
+
+typedef struct _mouthware_message_RelayCapabilitiesResponse { /* Optional protocol features; hosts enable fast paths only when listed */
+    char firmware_version[24]; /* Relay firmware version, e.g. "0.1.4" */
+    uint32_t features; /* RelayFeature bits */
+    uint32_t max_frame_size; /* Largest CDC0 frame payload the relay accepts, in bytes */
+    uint32_t max_in_flight_writes; /* PassThroughToMouthpad writes the host may have unacknowledged */
+    uint32_t batch_window_us; /* How long the relay holds host-bound data to share a USB packet; 0 = sent at once */
+    uint32_t max_pass_through_size; /* Largest PassThroughToMouthpad payload, after reassembly */
+    uint32_t pass_through_ack_writes; /* CUMULATIVE writes covered by one response at most */
+    uint32_t pass_through_ack_interval_us; /* How long a CUMULATIVE completion waits for its response at most */
+} mouthware_message_RelayCapabilitiesResponse;
+
+typedef struct _mouthware_message_EchoResponse { /* Relay timestamps are microseconds since relay boot */
+    uint64_t host_timestamp_us; /* From the EchoRequest */
+    uint32_t sequence; /* From the EchoRequest */
+    uint64_t relay_rx_us; /* Request handled, straight off the CDC0 RX path */
+    uint64_t relay_tx_us; /* This response queued for CDC0 */
+    bool via_mouthpad; /* The MouthPad leg was attempted */
+    uint64_t mouthpad_write_us; /* NUS write request handed to the BLE stack; 0 if not sent */
+    uint64_t mouthpad_ack_us; /* MouthPad's write response received; 0 if none */
+    mouthware_message_PassThroughToMouthpadErrorCode error_code; /* Why the MouthPad leg failed */
+} mouthware_message_EchoResponse;
+
+typedef struct _mouthware_message_HidMirrorConfigResponse { /* Sent in reply to HidMirrorConfigWrite */
+    bool enabled; /* HidMirrorBatch messages follow while set */
+} mouthware_message_HidMirrorConfigResponse;
+
+typedef PB_BYTES_ARRAY_T(8) mouthware_message_HidMirrorRecord_data_t;
+typedef struct _mouthware_message_HidMirrorRecord { /* One HID input report as the relay saw it */
+    uint32_t report_id; /* HID report ID */
+    mouthware_message_HidMirrorRecord_data_t data; /* Report payload from BLE, without the report ID */
+    uint32_t ble_rx_offset_us; /* BLE receive time after HidMirrorBatch.base_us */
+    uint32_t usb_submit_delay_us; /* From BLE receive until the report was handed to USB HID */
+    bool not_submitted; /* Dropped, or motion folded into a later USB report */
+} mouthware_message_HidMirrorRecord;
+
+typedef struct _mouthware_message_HidMirrorBatch { /* Consecutive mirrored reports, oldest first */
+    uint32_t sequence; /* Sequence number of the first record; one per record, gaps are records lost to overflow */
+    uint64_t base_us; /* BLE receive time of the first record, microseconds since relay boot */
+    pb_callback_t records;
+} mouthware_message_HidMirrorBatch;
+
+typedef struct _mouthware_message_ThreadStat { /* One thread (nRF) or task (ESP) */
+    char name[16];
+    uint32_t cpu_permille; /* Share of one core over the window, in tenths of a percent */
+    uint32_t stack_size; /* Bytes; 0 if the relay does not know it */
+    uint32_t stack_unused; /* Bytes of stack never touched since the thread started */
+    uint32_t context_switches; /* Times switched in over the window; 0 if the relay does not count them */
+} mouthware_message_ThreadStat;
+
+typedef struct _mouthware_message_ThreadStatsResponse { /* Sent in reply to ThreadStatsRead */
+    uint32_t window_ms; /* Time since the previous read, or since boot for the first */
+    uint32_t thread_count; /* Threads alive; only the busiest are listed when they do not all fit */
+    pb_callback_t threads; /* Busiest first */
+} mouthware_message_ThreadStatsResponse;
+
+typedef struct _mouthware_message_TraceResponse { /* Sent in reply to TraceRead */
+    uint32_t boot_count; /* Boots since the trace was last lost to power-off */
+    uint32_t total; /* Records written since the last clear; only the newest 128 are held */
+    uint32_t offset; /* Index of the first record in this page */
+    pb_callback_t records; /* 8 bytes each, little endian: time_ms u32, value u16, type u8, arg u8 */
+} mouthware_message_TraceResponse;
+
+typedef struct _mouthware_message_MemPool { /* One fixed pool: a slab, ring or queue */
+    char name[16];
+    uint32_t unit; /* Bytes per block; 1 for byte rings */
+    uint32_t size; /* Blocks */
+    uint32_t used; /* Blocks in use now */
+    uint32_t max_used; /* Most blocks in use since the last reset */
+    uint32_t failures; /* Takes refused because the pool was full, since the last reset */
+} mouthware_message_MemPool;
+
+typedef struct _mouthware_message_MemSite { /* One place that takes from a pool */
+    char name[16];
+    uint32_t calls; /* Takes since the last reset */
+    uint32_t failures; /* Takes refused */
+    uint32_t peak; /* Most of its pool in use after one of its takes */
+} mouthware_message_MemSite;
+
+typedef struct _mouthware_message_MemStatsResponse { /* Sent in reply to MemStatsRead */
+    uint32_t heap_size; /* Bytes; 0 if the relay has no heap */
+    uint32_t heap_used;
+    uint32_t heap_max_used; /* Since boot */
+    uint32_t heap_largest_free; /* 0 if the allocator cannot tell */
+    uint32_t heap_failures; /* Allocations refused since boot; 0 if not counted */
+    pb_callback_t pools;
+    pb_callback_t sites;
+    uint32_t stacks_checked; /* Threads in the stack budget check; 0 if stacks are not measured */
+    uint32_t stacks_tight; /* Threads whose measured peak leaves less than the margin free */
+    uint32_t stack_spare; /* Bytes all threads could give back and still keep the margin */
+} mouthware_message_MemStatsResponse;
+
+typedef struct _mouthware_message_FwUpdateStatus { /* Sent on every FwUpdate state change and as each chunk is written */
+    uint32_t state; /* 0 idle, 1 preparing (erasing), 2 receiving, 3 verifying, 4 done, 5 error */
+    uint32_t size; /* From the FwUpdateStart */
+    uint32_t offset; /* Next image byte the relay expects; resend from here after a gap */
+    uint32_t written; /* Image bytes in flash */
+    uint32_t window; /* Chunks the host may send that end beyond written */
+    uint32_t chunk_max; /* Largest FwUpdateChunk.data the relay accepts */
+    uint32_t error; /* With state 5: 1 platform, 2 too large, 3 out of sequence, 4 short, 5 verify failed */
+    int32_t detail; /* Platform error code behind error, 0 if none */
+} mouthware_message_FwUpdateStatus;
+
+typedef struct _mouthware_message_NusStreamStatus { /* Sent when the stream opens or closes, as forwarding frees window space, and after a refused write */
+    uint32_t state; /* 0 closed, 1 opening, 2 open, 3 closing (draining) */
+    uint32_t received; /* Next stream byte the relay expects; resend from here after a gap */
+    uint32_t forwarded; /* Bytes handed to the NUS TX queue */
+    uint32_t sent; /* Bytes whose NUS writes have gone out */
+    uint32_t failed; /* Bytes lost to failed NUS writes or a dropped link */
+    uint32_t window; /* Bytes the host may send beyond forwarded */
+    uint32_t packet_size; /* Bytes per NUS write on the current link */
+    uint32_t refused; /* NusStreamWrites dropped as out of order, too large for the window or with the stream closed */
+} mouthware_message_NusStreamStatus;
+
+typedef struct _mouthware_message_SensorStreamFilterResponse { /* Sent in reply to SensorStreamFilterWrite; counts are since boot */
+    uint32_t blocked; /* Filter now in force */
+    uint32_t sensor_forwarded; /* SENSOR_STREAM_SENSOR notifications passed to the host */
+    uint32_t sensor_dropped; /* SENSOR_STREAM_SENSOR notifications stopped by the filter */
+    uint32_t power_forwarded;
+    uint32_t power_dropped;
+    uint32_t other_forwarded;
+    uint32_t other_dropped;
+} mouthware_message_SensorStreamFilterResponse;
+
+typedef struct _mouthware_message_SensorCodecConfigResponse { /* Sent in reply to SensorCodecConfigWrite; counts are since boot */
+    bool enabled;
+    uint32_t keyframe_interval; /* Interval now in force */
+    uint32_t frames; /* Sensor frames sent as SensorFrameDelta */
+    uint32_t keyframes; /* Of those, sent whole */
+    uint32_t raw_bytes; /* Bytes of the frames as the MouthPad sent them */
+    uint32_t coded_bytes; /* Bytes of SensorFrameDelta.data that replaced them */
+} mouthware_message_SensorCodecConfigResponse;
+
+typedef PB_BYTES_ARRAY_T(244) mouthware_message_SensorFrameDelta_data_t;
+typedef struct _mouthware_message_SensorFrameDelta { /* One primary MouthPad sensor frame, coded against the one before it */
+    uint32_t sequence; /* Increments by one per SensorFrameDelta; a gap means the host must wait for a keyframe */
+    bool keyframe; /* data is the whole frame; otherwise the delta tokens of common/sensor_codec.h */
+    mouthware_message_SensorFrameDelta_data_t data;
+} mouthware_message_SensorFrameDelta;
+
+typedef struct _mouthware_message_SensorStreamRateResponse { /* Sent in reply to SensorStreamRateWrite */
+    mouthware_message_SensorStream stream;
+    uint32_t keep_one_in; /* Limits now in force for the stream */
+    uint32_t min_interval_us;
+    uint32_t thinned; /* Notifications of the stream dropped by these limits since boot */
+} mouthware_message_SensorStreamRateResponse;
+
+typedef struct _mouthware_message_RelayProfileResponse { /* Sent in reply to RelayProfileWrite, and when the button cycles the preset */
+    mouthware_message_RelayProfile profile;
+    uint32_t overridden; /* Bits (1 << RelayProfileKnob) of knobs that differ from the preset */
+    uint32_t applied; /* Bits (1 << RelayProfileKnob) of knobs this relay acts on */
+    pb_size_t values_count;
+    int32_t values[6]; /* Indexed by RelayProfileKnob, overrides included */
+} mouthware_message_RelayProfileResponse;
+
+typedef struct _mouthware_message_UsbCompositionResponse { /* Sent in reply to UsbCompositionWrite, and when the button cycles the composition */
+    mouthware_message_UsbComposition composition; /* Saved, enumerated from the next enumeration on */
+    mouthware_message_UsbComposition active; /* Enumerated now */
+    bool reenumerating; /* The relay detaches from USB shortly after this response */
+} mouthware_message_UsbCompositionResponse;
+
+typedef PB_BYTES_ARRAY_T(6) mouthware_message_LinkHistoryResponse_address_t;
+typedef struct _mouthware_message_LinkHistoryResponse { /* Sent in reply to LinkHistoryRead */
+    mouthware_message_LinkHistoryResponse_address_t address; /* MouthPad's BLE address, little endian; empty if no MouthPad is held at bond */
+    uint32_t bond;
+    uint32_t bond_count; /* MouthPads with history held */
+    uint32_t boot_count; /* Boot the relay is in now, to date buckets against */
+    uint32_t hour; /* Hours since this boot */
+    uint32_t total; /* Buckets held for this MouthPad, one per hour connected */
+    uint32_t offset; /* Index of the first bucket in this page */
+    pb_callback_t buckets; /* 34 bytes each, little endian, as link_history.h */
+} mouthware_message_LinkHistoryResponse;
+
+typedef struct _mouthware_message_RequestError { /* Sent instead of a reply to a request with a request_id the relay did not run, or that failed */
+    mouthware_message_RequestErrorCode code;
+    uint32_t request_tag; /* AppToRelayMessage body tag of the request */
+} mouthware_message_RequestError;
+
+typedef struct _mouthware_message_PassThroughToMouthpadResponse { /* Sent as each PassThroughToMouthpad write completes or fails, or for several at once as their ack mode asks; until the first one arrives the host sends one write at a time */
+    mouthware_message_PassThroughToMouthpadErrorCode error_code;
+    uint32_t credits; /* Writes the host may keep unacknowledged */
+    uint32_t device_index; /* MouthPad the write went to; credits are counted per device */
+    uint32_t sequence; /* sequence of the latest write covered */
+    uint32_t acked; /* Writes covered, this one included; 0 from older relays means 1 */
+} mouthware_message_PassThroughToMouthpadResponse;
+
+typedef PB_BYTES_ARRAY_T(255) mouthware_message_PassThroughToApp_data_t;
+typedef struct _mouthware_message_PassThroughToApp {
+    mouthware_message_PassThroughToApp_data_t data;
+    bool more_fragments; /* Further fragments of this notification follow */
+    uint32_t fragment; /* Index of this fragment within the notification, 0 for the first */
+    uint32_t device_index; /* MouthPad the notification came from: 0 for the primary, 1 and up for secondary links */
+} mouthware_message_PassThroughToApp;
+
+typedef PB_BYTES_ARRAY_T(255) mouthware_message_PassThroughChunk_data_t;
+typedef struct _mouthware_message_PassThroughChunk {
+    uint32_t sequence; /* Increments by one per MouthPad notification */
+    mouthware_message_PassThroughChunk_data_t data;
+} mouthware_message_PassThroughChunk;
+
+typedef struct _mouthware_message_PassThroughToAppBatch { /* Several MouthPad notifications in one frame, oldest first */
+    pb_callback_t chunks;
+} mouthware_message_PassThroughToAppBatch;
+
+/* / Message from the MouthPad Relay to the App. */
+typedef struct _mouthware_message_RelayToAppMessage {
+    pb_size_t which_message_body;
+    union _mouthware_message_RelayToAppMessage_message_body {
+        /* / Response to a BleConnectionStatusRead */
+        mouthware_message_BleConnectionStatusResponse ble_connection_status_response;
+        /* / Response to a PassThroughToMouthPadRequest (originating at the MouthPad). */
+        mouthware_message_PassThroughToMouthpadResponse pass_through_to_mouthpad_response;
+        /* / Message from the MouthPad for the app. */
+        mouthware_message_PassThroughToApp pass_through_to_app;
+        /* / Response to a DeviceInfoRead */
+        mouthware_message_DeviceInfoResponse device_info_response;
+        /* / Response to a ClearBondsWrite */
+        mouthware_message_ClearBondsResponse clear_bonds_response;
+        /* / Response to a DfuWrite */
+        mouthware_message_DfuResponse dfu_response;
+        /* / Response to a ClearFirmwareCacheWrite */
+        mouthware_message_ClearFirmwareCacheResponse clear_firmware_cache_response;
+        /* / Response to a HidLatencyRead */
+        mouthware_message_HidLatencyResponse hid_latency_response;
+        /* / Response to a HidConfigRead or HidConfigWrite */
+        mouthware_message_HidConfigResponse hid_config_response;
+        /* / Batched messages from the MouthPad for the app */
+        mouthware_message_PassThroughToAppBatch pass_through_to_app_batch;
+        /* / Response to a PassThroughBatchConfigWrite */
+        mouthware_message_PassThroughBatchConfigResponse pass_through_batch_config_response;
+        /* / Response to a RelayStatsRead */
+        mouthware_message_RelayStatsResponse relay_stats_response;
+        /* / Response to a ConnectionTimingRead */
+        mouthware_message_ConnectionTimingResponse connection_timing_response;
+        /* / Link telemetry sample, pushed after a LinkTelemetrySubscribe */
+        mouthware_message_LinkTelemetry link_telemetry;
+        /* / Response to a RelayCapabilitiesRead */
+        mouthware_message_RelayCapabilitiesResponse relay_capabilities_response;
+        /* / Response to an EchoRequest */
+        mouthware_message_EchoResponse echo_response;
+        /* / Response to a HidMirrorConfigWrite */
+        mouthware_message_HidMirrorConfigResponse hid_mirror_config_response;
+        /* / Mirrored HID reports, pushed while the mirror is enabled */
+        mouthware_message_HidMirrorBatch hid_mirror_batch;
+        /* / Response to a ThreadStatsRead */
+        mouthware_message_ThreadStatsResponse thread_stats_response;
+        /* / Response to a TraceRead */
+        mouthware_message_TraceResponse trace_response;
+        /* / Response to a MemStatsRead */
+        mouthware_message_MemStatsResponse mem_stats_response;
+        /* / Progress of a firmware update */
+        mouthware_message_FwUpdateStatus fw_update_status;
+        /* / Progress of the bulk NUS stream */
+        mouthware_message_NusStreamStatus nus_stream_status;
+        /* / Response to a SensorStreamFilterWrite */
+        mouthware_message_SensorStreamFilterResponse sensor_stream_filter_response;
+        /* / Response to a SensorCodecConfigWrite */
+        mouthware_message_SensorCodecConfigResponse sensor_codec_config_response;
+        /* / A sensor frame from the codec, in place of its PassThroughToApp */
+        mouthware_message_SensorFrameDelta sensor_frame_delta;
+        /* / Response to a SensorStreamRateWrite */
+        mouthware_message_SensorStreamRateResponse sensor_stream_rate_response;
+        /* / A request with a request_id was refused or failed */
+        mouthware_message_RequestError request_error;
+        /* / Response to a RelayProfileWrite */
+        mouthware_message_RelayProfileResponse relay_profile_response;
+        /* / Response to a UsbCompositionWrite */
+        mouthware_message_UsbCompositionResponse usb_composition_response;
+        /* / Response to a LinkHistoryRead */
+        mouthware_message_LinkHistoryResponse link_history_response;
+    } message_body;
+    /* / request_id of the AppToRelayMessage this answers; 0 for messages the relay sends on its own */
+    uint32_t request_id;
+} mouthware_message_RelayToAppMessage;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Helper constants for enums */
+#define _mouthware_message_AppToRelayMessageDestination_MIN mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_UNSPECIFIED
+#define _mouthware_message_AppToRelayMessageDestination_MAX mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD
+#define _mouthware_message_AppToRelayMessageDestination_ARRAYSIZE ((mouthware_message_AppToRelayMessageDestination)(mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD+1))
+
+#define _mouthware_message_RelayBleConnectionStatus_MIN mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_UNSPECIFIED
+#define _mouthware_message_RelayBleConnectionStatus_MAX mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTING
+#define _mouthware_message_RelayBleConnectionStatus_ARRAYSIZE ((mouthware_message_RelayBleConnectionStatus)(mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTING+1))
+
+#define _mouthware_message_DeviceFamily_MIN mouthware_message_DeviceFamily_DEVICE_FAMILY_UNSPECIFIED
+#define _mouthware_message_DeviceFamily_MAX mouthware_message_DeviceFamily_DEVICE_FAMILY_ESP
+#define _mouthware_message_DeviceFamily_ARRAYSIZE ((mouthware_message_DeviceFamily)(mouthware_message_DeviceFamily_DEVICE_FAMILY_ESP+1))
+
+#define _mouthware_message_DeviceBoard_MIN mouthware_message_DeviceBoard_DEVICE_BOARD_UNSPECIFIED
+#define _mouthware_message_DeviceBoard_MAX mouthware_message_DeviceBoard_DEVICE_BOARD_LILYGO_TDISPLAY_S3
+#define _mouthware_message_DeviceBoard_ARRAYSIZE ((mouthware_message_DeviceBoard)(mouthware_message_DeviceBoard_DEVICE_BOARD_LILYGO_TDISPLAY_S3+1))
+
+#define _mouthware_message_PassThroughToMouthpadErrorCode_MIN mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED
+#define _mouthware_message_PassThroughToMouthpadErrorCode_MAX mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_FRAGMENT_OUT_OF_ORDER
+#define _mouthware_message_PassThroughToMouthpadErrorCode_ARRAYSIZE ((mouthware_message_PassThroughToMouthpadErrorCode)(mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_FRAGMENT_OUT_OF_ORDER+1))
+
+#define _mouthware_message_RelayFeature_MIN mouthware_message_RelayFeature_RELAY_FEATURE_NONE
+#define _mouthware_message_RelayFeature_MAX mouthware_message_RelayFeature_RELAY_FEATURE_LINK_HISTORY
+#define _mouthware_message_RelayFeature_ARRAYSIZE ((mouthware_message_RelayFeature)(mouthware_message_RelayFeature_RELAY_FEATURE_LINK_HISTORY+1))
+
+#define _mouthware_message_SensorStream_MIN mouthware_message_SensorStream_SENSOR_STREAM_OTHER
+#define _mouthware_message_SensorStream_MAX mouthware_message_SensorStream_SENSOR_STREAM_POWER
+#define _mouthware_message_SensorStream_ARRAYSIZE ((mouthware_message_SensorStream)(mouthware_message_SensorStream_SENSOR_STREAM_POWER+1))
+
+#define _mouthware_message_RequestErrorCode_MIN mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_UNSPECIFIED
+#define _mouthware_message_RequestErrorCode_MAX mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_FAILED
+#define _mouthware_message_RequestErrorCode_ARRAYSIZE ((mouthware_message_RequestErrorCode)(mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_FAILED+1))
+
+#define _mouthware_message_RelayProfile_MIN mouthware_message_RelayProfile_RELAY_PROFILE_UNCHANGED
+#define _mouthware_message_RelayProfile_MAX mouthware_message_RelayProfile_RELAY_PROFILE_BATTERY
+#define _mouthware_message_RelayProfile_ARRAYSIZE ((mouthware_message_RelayProfile)(mouthware_message_RelayProfile_RELAY_PROFILE_BATTERY+1))
+
+#define _mouthware_message_RelayProfileKnob_MIN mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_ACTIVE_INTERVAL
+#define _mouthware_message_RelayProfileKnob_MAX mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_CDC_COALESCE_US
+#define _mouthware_message_RelayProfileKnob_ARRAYSIZE ((mouthware_message_RelayProfileKnob)(mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_CDC_COALESCE_US+1))
+
+#define _mouthware_message_UsbComposition_MIN mouthware_message_UsbComposition_USB_COMPOSITION_UNCHANGED
+#define _mouthware_message_UsbComposition_MAX mouthware_message_UsbComposition_USB_COMPOSITION_HID_ONLY
+#define _mouthware_message_UsbComposition_ARRAYSIZE ((mouthware_message_UsbComposition)(mouthware_message_UsbComposition_USB_COMPOSITION_HID_ONLY+1))
+
+#define _mouthware_message_PassThroughAckMode_MIN mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_EACH
+#define _mouthware_message_PassThroughAckMode_MAX mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_CUMULATIVE
+#define _mouthware_message_PassThroughAckMode_ARRAYSIZE ((mouthware_message_PassThroughAckMode)(mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_CUMULATIVE+1))
+
+
+
+
+
+
+
+#define mouthware_message_AppToRelayMessage_destination_ENUMTYPE mouthware_message_AppToRelayMessageDestination
+
+#define mouthware_message_BleConnectionStatusResponse_connection_status_ENUMTYPE mouthware_message_RelayBleConnectionStatus
+
+#define mouthware_message_DeviceInfoResponse_family_ENUMTYPE mouthware_message_DeviceFamily
+#define mouthware_message_DeviceInfoResponse_board_ENUMTYPE mouthware_message_DeviceBoard
+
+#define mouthware_message_PassThroughToMouthpad_ack_ENUMTYPE mouthware_message_PassThroughAckMode
+
+
+
+
+#define mouthware_message_EchoResponse_error_code_ENUMTYPE mouthware_message_PassThroughToMouthpadErrorCode
+
+#define mouthware_message_SensorStreamRateWrite_stream_ENUMTYPE mouthware_message_SensorStream
+#define mouthware_message_RelayProfileKnobValue_knob_ENUMTYPE mouthware_message_RelayProfileKnob
+#define mouthware_message_RelayProfileWrite_profile_ENUMTYPE mouthware_message_RelayProfile
+#define mouthware_message_UsbCompositionWrite_composition_ENUMTYPE mouthware_message_UsbComposition
+#define mouthware_message_SensorStreamRateResponse_stream_ENUMTYPE mouthware_message_SensorStream
+#define mouthware_message_RelayProfileResponse_profile_ENUMTYPE mouthware_message_RelayProfile
+#define mouthware_message_UsbCompositionResponse_composition_ENUMTYPE mouthware_message_UsbComposition
+#define mouthware_message_UsbCompositionResponse_active_ENUMTYPE mouthware_message_UsbComposition
+
+#define mouthware_message_RequestError_code_ENUMTYPE mouthware_message_RequestErrorCode
+
+#define mouthware_message_PassThroughToMouthpadResponse_error_code_ENUMTYPE mouthware_message_PassThroughToMouthpadErrorCode
+
+
+
+
+/* Initializer values for message structs */
+#define mouthware_message_BleConnectionStatusRead_init_default {0}
+#define mouthware_message_DeviceInfoRead_init_default {0}
+#define mouthware_message_ClearBondsWrite_init_default {0}
+#define mouthware_message_DfuWrite_init_default  {0}
+#define mouthware_message_ClearFirmwareCacheWrite_init_default {0}
+#define mouthware_message_HidLatencyRead_init_default {0}
+#define mouthware_message_HidConfigRead_init_default {0}
+#define mouthware_message_HidConfigWrite_init_default {0, 0}
+#define mouthware_message_PassThroughBatchConfigWrite_init_default {0}
+#define mouthware_message_RelayStatsRead_init_default {0}
+#define mouthware_message_ConnectionTimingRead_init_default {0}
+#define mouthware_message_LinkTelemetrySubscribe_init_default {0, 0}
+#define mouthware_message_RelayCapabilitiesRead_init_default {0}
+#define mouthware_message_EchoRequest_init_default {0, 0, 0, {0, {0}}}
+#define mouthware_message_HidMirrorConfigWrite_init_default {0}
+#define mouthware_message_ThreadStatsRead_init_default {0}
+#define mouthware_message_TraceRead_init_default {0, 0}
+#define mouthware_message_MemStatsRead_init_default {0}
+#define mouthware_message_FwUpdateStart_init_default {0, {0, {0}}}
+#define mouthware_message_FwUpdateChunk_init_default {0, {0, {0}}}
+#define mouthware_message_FwUpdateEnd_init_default {0, 0}
+#define mouthware_message_NusStreamControl_init_default {0}
+#define mouthware_message_NusStreamWrite_init_default {0, {0, {0}}}
+#define mouthware_message_SensorStreamFilterWrite_init_default {0}
+#define mouthware_message_SensorCodecConfigWrite_init_default {0, 0}
+#define mouthware_message_SensorStreamRateWrite_init_default {_mouthware_message_SensorStream_MIN, 0, 0}
+#define mouthware_message_RelayProfileKnobValue_init_default {_mouthware_message_RelayProfileKnob_MIN, 0}
+#define mouthware_message_RelayProfileWrite_init_default {_mouthware_message_RelayProfile_MIN, 0, 0, {mouthware_message_RelayProfileKnobValue_init_default, mouthware_message_RelayProfileKnobValue_init_default, mouthware_message_RelayProfileKnobValue_init_default, mouthware_message_RelayProfileKnobValue_init_default, mouthware_message_RelayProfileKnobValue_init_default, mouthware_message_RelayProfileKnobValue_init_default}}
+#define mouthware_message_UsbCompositionWrite_init_default {_mouthware_message_UsbComposition_MIN, 0}
+#define mouthware_message_LinkHistoryRead_init_default {0, 0, 0}
+#define mouthware_message_PassThroughToMouthpad_init_default {{0, {0}}, 0, 0, 0, 0, _mouthware_message_PassThroughAckMode_MIN, 0}
+#define mouthware_message_AppToRelayMessage_init_default {_mouthware_message_AppToRelayMessageDestination_MIN, 0, {mouthware_message_BleConnectionStatusRead_init_default}, 0}
+#define mouthware_message_BleConnectionStatusResponse_init_default {_mouthware_message_RelayBleConnectionStatus_MIN, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_DeviceInfoResponse_init_default {{{NULL}, NULL}, {{NULL}, NULL}, {{NULL}, NULL}, 0, 0, _mouthware_message_DeviceFamily_MIN, _mouthware_message_DeviceBoard_MIN}
+#define mouthware_message_ClearBondsResponse_init_default {0}
+#define mouthware_message_DfuResponse_init_default {0}
+#define mouthware_message_ClearFirmwareCacheResponse_init_default {0}
+#define mouthware_message_HidLatencyReportStats_init_default {0, 0, 0, 0, 0}
+#define mouthware_message_HidLatencyResponse_init_default {0, {mouthware_message_HidLatencyReportStats_init_default, mouthware_message_HidLatencyReportStats_init_default, mouthware_message_HidLatencyReportStats_init_default, mouthware_message_HidLatencyReportStats_init_default}}
+#define mouthware_message_HidConfigResponse_init_default {0, 0}
+#define mouthware_message_PassThroughBatchConfigResponse_init_default {0}
+#define mouthware_message_RelayStatsPathCounters_init_default {0, 0, 0, 0, 0}
+#define mouthware_message_RelayStatsResponse_init_default {false, mouthware_message_RelayStatsPathCounters_init_default, false, mouthware_message_RelayStatsPathCounters_init_default, false, mouthware_message_RelayStatsPathCounters_init_default}
+#define mouthware_message_ConnectionTimingRecord_init_default {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_ConnectionTimingResponse_init_default {0, {mouthware_message_ConnectionTimingRecord_init_default, mouthware_message_ConnectionTimingRecord_init_default, mouthware_message_ConnectionTimingRecord_init_default, mouthware_message_ConnectionTimingRecord_init_default}, 0, 0, 0, 0, 0}
+#define mouthware_message_LinkTelemetry_init_default {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0}}
+#define mouthware_message_RelayCapabilitiesResponse_init_default {"", 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_EchoResponse_init_default {0, 0, 0, 0, 0, 0, 0, _mouthware_message_PassThroughToMouthpadErrorCode_MIN}
+#define mouthware_message_HidMirrorConfigResponse_init_default {0}
+#define mouthware_message_HidMirrorRecord_init_default {0, {0, {0}}, 0, 0, 0}
+#define mouthware_message_HidMirrorBatch_init_default {0, 0, {{NULL}, NULL}}
+#define mouthware_message_ThreadStat_init_default {"", 0, 0, 0, 0}
+#define mouthware_message_ThreadStatsResponse_init_default {0, 0, {{NULL}, NULL}}
+#define mouthware_message_TraceResponse_init_default {0, 0, 0, {{NULL}, NULL}}
+#define mouthware_message_MemPool_init_default {"", 0, 0, 0, 0, 0}
+#define mouthware_message_MemSite_init_default {"", 0, 0, 0}
+#define mouthware_message_MemStatsResponse_init_default {0, 0, 0, 0, 0, {{NULL}, NULL}, {{NULL}, NULL}, 0, 0, 0}
+#define mouthware_message_FwUpdateStatus_init_default {0, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_NusStreamStatus_init_default {0, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_SensorStreamFilterResponse_init_default {0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_SensorCodecConfigResponse_init_default {0, 0, 0, 0, 0, 0}
+#define mouthware_message_SensorFrameDelta_init_default {0, 0, {0, {0}}}
+#define mouthware_message_SensorStreamRateResponse_init_default {_mouthware_message_SensorStream_MIN, 0, 0, 0}
+#define mouthware_message_RelayProfileResponse_init_default {_mouthware_message_RelayProfile_MIN, 0, 0, 0, {0, 0, 0, 0, 0, 0}}
+#define mouthware_message_UsbCompositionResponse_init_default {_mouthware_message_UsbComposition_MIN, _mouthware_message_UsbComposition_MIN, 0}
+#define mouthware_message_LinkHistoryResponse_init_default {{0, {0}}, 0, 0, 0, 0, 0, 0, {{NULL}, NULL}}
+#define mouthware_message_RequestError_init_default {_mouthware_message_RequestErrorCode_MIN, 0}
+#define mouthware_message_PassThroughToMouthpadResponse_init_default {_mouthware_message_PassThroughToMouthpadErrorCode_MIN, 0, 0, 0, 0}
+#define mouthware_message_PassThroughToApp_init_default {{0, {0}}, 0, 0, 0}
+#define mouthware_message_PassThroughChunk_init_default {0, {0, {0}}}
+#define mouthware_message_PassThroughToAppBatch_init_default {{{NULL}, NULL}}
+#define mouthware_message_RelayToAppMessage_init_default {0, {mouthware_message_BleConnectionStatusResponse_init_default}, 0}
+#define mouthware_message_BleConnectionStatusRead_init_zero {0}
+#define mouthware_message_DeviceInfoRead_init_zero {0}
+#define mouthware_message_ClearBondsWrite_init_zero {0}
+#define mouthware_message_DfuWrite_init_zero     {0}
+#define mouthware_message_ClearFirmwareCacheWrite_init_zero {0}
+#define mouthware_message_HidLatencyRead_init_zero {0}
+#define mouthware_message_HidConfigRead_init_zero {0}
+#define mouthware_message_HidConfigWrite_init_zero {0, 0}
+#define mouthware_message_PassThroughBatchConfigWrite_init_zero {0}
+#define mouthware_message_RelayStatsRead_init_zero {0}
+#define mouthware_message_ConnectionTimingRead_init_zero {0}
+#define mouthware_message_LinkTelemetrySubscribe_init_zero {0, 0}
+#define mouthware_message_RelayCapabilitiesRead_init_zero {0}
+#define mouthware_message_EchoRequest_init_zero {0, 0, 0, {0, {0}}}
+#define mouthware_message_HidMirrorConfigWrite_init_zero {0}
+#define mouthware_message_ThreadStatsRead_init_zero {0}
+#define mouthware_message_TraceRead_init_zero {0, 0}
+#define mouthware_message_MemStatsRead_init_zero {0}
+#define mouthware_message_FwUpdateStart_init_zero {0, {0, {0}}}
+#define mouthware_message_FwUpdateChunk_init_zero {0, {0, {0}}}
+#define mouthware_message_FwUpdateEnd_init_zero {0, 0}
+#define mouthware_message_NusStreamControl_init_zero {0}
+#define mouthware_message_NusStreamWrite_init_zero {0, {0, {0}}}
+#define mouthware_message_SensorStreamFilterWrite_init_zero {0}
+#define mouthware_message_SensorCodecConfigWrite_init_zero {0, 0}
+#define mouthware_message_SensorStreamRateWrite_init_zero {_mouthware_message_SensorStream_MIN, 0, 0}
+#define mouthware_message_RelayProfileKnobValue_init_zero {_mouthware_message_RelayProfileKnob_MIN, 0}
+#define mouthware_message_RelayProfileWrite_init_zero {_mouthware_message_RelayProfile_MIN, 0, 0, {mouthware_message_RelayProfileKnobValue_init_zero, mouthware_message_RelayProfileKnobValue_init_zero, mouthware_message_RelayProfileKnobValue_init_zero, mouthware_message_RelayProfileKnobValue_init_zero, mouthware_message_RelayProfileKnobValue_init_zero, mouthware_message_RelayProfileKnobValue_init_zero}}
+#define mouthware_message_UsbCompositionWrite_init_zero {_mouthware_message_UsbComposition_MIN, 0}
+#define mouthware_message_LinkHistoryRead_init_zero {0, 0, 0}
+#define mouthware_message_PassThroughToMouthpad_init_zero {{0, {0}}, 0, 0, 0, 0, _mouthware_message_PassThroughAckMode_MIN, 0}
+#define mouthware_message_AppToRelayMessage_init_zero {_mouthware_message_AppToRelayMessageDestination_MIN, 0, {mouthware_message_BleConnectionStatusRead_init_zero}, 0}
+#define mouthware_message_BleConnectionStatusResponse_init_zero {_mouthware_message_RelayBleConnectionStatus_MIN, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_DeviceInfoResponse_init_zero {{{NULL}, NULL}, {{NULL}, NULL}, {{NULL}, NULL}, 0, 0, _mouthware_message_DeviceFamily_MIN, _mouthware_message_DeviceBoard_MIN}
+#define mouthware_message_ClearBondsResponse_init_zero {0}
+#define mouthware_message_DfuResponse_init_zero  {0}
+#define mouthware_message_ClearFirmwareCacheResponse_init_zero {0}
+#define mouthware_message_HidLatencyReportStats_init_zero {0, 0, 0, 0, 0}
+#define mouthware_message_HidLatencyResponse_init_zero {0, {mouthware_message_HidLatencyReportStats_init_zero, mouthware_message_HidLatencyReportStats_init_zero, mouthware_message_HidLatencyReportStats_init_zero, mouthware_message_HidLatencyReportStats_init_zero}}
+#define mouthware_message_HidConfigResponse_init_zero {0, 0}
+#define mouthware_message_PassThroughBatchConfigResponse_init_zero {0}
+#define mouthware_message_RelayStatsPathCounters_init_zero {0, 0, 0, 0, 0}
+#define mouthware_message_RelayStatsResponse_init_zero {false, mouthware_message_RelayStatsPathCounters_init_zero, false, mouthware_message_RelayStatsPathCounters_init_zero, false, mouthware_message_RelayStatsPathCounters_init_zero}
+#define mouthware_message_ConnectionTimingRecord_init_zero {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_ConnectionTimingResponse_init_zero {0, {mouthware_message_ConnectionTimingRecord_init_zero, mouthware_message_ConnectionTimingRecord_init_zero, mouthware_message_ConnectionTimingRecord_init_zero, mouthware_message_ConnectionTimingRecord_init_zero}, 0, 0, 0, 0, 0}
+#define mouthware_message_LinkTelemetry_init_zero {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0}}
+#define mouthware_message_RelayCapabilitiesResponse_init_zero {"", 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_EchoResponse_init_zero {0, 0, 0, 0, 0, 0, 0, _mouthware_message_PassThroughToMouthpadErrorCode_MIN}
+#define mouthware_message_HidMirrorConfigResponse_init_zero {0}
+#define mouthware_message_HidMirrorRecord_init_zero {0, {0, {0}}, 0, 0, 0}
+#define mouthware_message_HidMirrorBatch_init_zero {0, 0, {{NULL}, NULL}}
+#define mouthware_message_ThreadStat_init_zero {"", 0, 0, 0, 0}
+#define mouthware_message_ThreadStatsResponse_init_zero {0, 0, {{NULL}, NULL}}
+#define mouthware_message_TraceResponse_init_zero {0, 0, 0, {{NULL}, NULL}}
+#define mouthware_message_MemPool_init_zero {"", 0, 0, 0, 0, 0}
+#define mouthware_message_MemSite_init_zero {"", 0, 0, 0}
+#define mouthware_message_MemStatsResponse_init_zero {0, 0, 0, 0, 0, {{NULL}, NULL}, {{NULL}, NULL}, 0, 0, 0}
+#define mouthware_message_FwUpdateStatus_init_zero {0, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_NusStreamStatus_init_zero {0, 0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_SensorStreamFilterResponse_init_zero {0, 0, 0, 0, 0, 0, 0}
+#define mouthware_message_SensorCodecConfigResponse_init_zero {0, 0, 0, 0, 0, 0}
+#define mouthware_message_SensorFrameDelta_init_zero {0, 0, {0, {0}}}
+#define mouthware_message_SensorStreamRateResponse_init_zero {_mouthware_message_SensorStream_MIN, 0, 0, 0}
+#define mouthware_message_RelayProfileResponse_init_zero {_mouthware_message_RelayProfile_MIN, 0, 0, 0, {0, 0, 0, 0, 0, 0}}
+#define mouthware_message_UsbCompositionResponse_init_zero {_mouthware_message_UsbComposition_MIN, _mouthware_message_UsbComposition_MIN, 0}
+#define mouthware_message_LinkHistoryResponse_init_zero {{0, {0}}, 0, 0, 0, 0, 0, 0, {{NULL}, NULL}}
+#define mouthware_message_RequestError_init_zero {_mouthware_message_RequestErrorCode_MIN, 0}
+#define mouthware_message_PassThroughToMouthpadResponse_init_zero {_mouthware_message_PassThroughToMouthpadErrorCode_MIN, 0, 0, 0, 0}
+#define mouthware_message_PassThroughToApp_init_zero {{0, {0}}, 0, 0, 0}
+#define mouthware_message_PassThroughChunk_init_zero {0, {0, {0}}}
+#define mouthware_message_PassThroughToAppBatch_init_zero {{{NULL}, NULL}}
+#define mouthware_message_RelayToAppMessage_init_zero {0, {mouthware_message_BleConnectionStatusResponse_init_zero}, 0}
+
+/* Field tags (for use in manual encoding/decoding) */
+#define mouthware_message_BleConnectionStatusRead_scan_boost_tag 1
+#define mouthware_message_HidConfigWrite_motion_interpolation_tag 1
+#define mouthware_message_HidConfigWrite_motion_prediction_tag 2
+#define mouthware_message_PassThroughBatchConfigWrite_enabled_tag 1
+#define mouthware_message_RelayStatsRead_reset_tag 1
+#define mouthware_message_ConnectionTimingRead_clear_tag 1
+#define mouthware_message_LinkTelemetrySubscribe_interval_ms_tag 1
+#define mouthware_message_LinkTelemetrySubscribe_on_change_tag 2
+#define mouthware_message_EchoRequest_host_timestamp_us_tag 1
+#define mouthware_message_EchoRequest_sequence_tag 2
+#define mouthware_message_EchoRequest_via_mouthpad_tag 3
+#define mouthware_message_EchoRequest_payload_tag 4
+#define mouthware_message_HidMirrorConfigWrite_enabled_tag 1
+#define mouthware_message_SensorStreamFilterWrite_blocked_tag 1
+#define mouthware_message_SensorCodecConfigWrite_enabled_tag 1
+#define mouthware_message_SensorCodecConfigWrite_keyframe_interval_tag 2
+#define mouthware_message_SensorStreamRateWrite_stream_tag 1
+#define mouthware_message_SensorStreamRateWrite_keep_one_in_tag 2
+#define mouthware_message_SensorStreamRateWrite_min_interval_us_tag 3
+#define mouthware_message_RelayProfileKnobValue_knob_tag 1
+#define mouthware_message_RelayProfileKnobValue_value_tag 2
+#define mouthware_message_RelayProfileWrite_profile_tag 1
+#define mouthware_message_RelayProfileWrite_clear_overrides_tag 2
+#define mouthware_message_RelayProfileWrite_overrides_tag 3
+#define mouthware_message_UsbCompositionWrite_composition_tag 1
+#define mouthware_message_UsbCompositionWrite_reenumerate_tag 2
+#define mouthware_message_LinkHistoryRead_bond_tag 1
+#define mouthware_message_LinkHistoryRead_offset_tag 2
+#define mouthware_message_LinkHistoryRead_clear_tag 3
+#define mouthware_message_PassThroughToMouthpad_data_tag 1
+#define mouthware_message_PassThroughToMouthpad_reliable_tag 2
+#define mouthware_message_PassThroughToMouthpad_more_fragments_tag 3
+#define mouthware_message_PassThroughToMouthpad_fragment_tag 4
+#define mouthware_message_PassThroughToMouthpad_device_index_tag 5
+#define mouthware_message_PassThroughToMouthpad_ack_tag 6
+#define mouthware_message_PassThroughToMouthpad_sequence_tag 7
+#define mouthware_message_AppToRelayMessage_destination_tag 1
+#define mouthware_message_AppToRelayMessage_ble_connection_status_read_tag 2
+#define mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag 3
+#define mouthware_message_AppToRelayMessage_device_info_read_tag 4
+#define mouthware_message_AppToRelayMessage_clear_bonds_write_tag 5
+#define mouthware_message_AppToRelayMessage_dfu_write_tag 6
+#define mouthware_message_AppToRelayMessage_clear_firmware_cache_write_tag 7
+#define mouthware_message_AppToRelayMessage_hid_latency_read_tag 8
+#define mouthware_message_AppToRelayMessage_hid_config_read_tag 9
+#define mouthware_message_AppToRelayMessage_hid_config_write_tag 10
+#define mouthware_message_AppToRelayMessage_pass_through_batch_config_write_tag 11
+#define mouthware_message_AppToRelayMessage_relay_stats_read_tag 12
+#define mouthware_message_AppToRelayMessage_connection_timing_read_tag 13
+#define mouthware_message_AppToRelayMessage_link_telemetry_subscribe_tag 14
+#define mouthware_message_AppToRelayMessage_relay_capabilities_read_tag 15
+#define mouthware_message_AppToRelayMessage_echo_request_tag 16
+#define mouthware_message_AppToRelayMessage_hid_mirror_config_write_tag 17
+#define mouthware_message_AppToRelayMessage_thread_stats_read_tag 18
+#define mouthware_message_AppToRelayMessage_trace_read_tag 19
+#define mouthware_message_AppToRelayMessage_mem_stats_read_tag 20
+#define mouthware_message_AppToRelayMessage_fw_update_start_tag 21
+#define mouthware_message_AppToRelayMessage_fw_update_chunk_tag 22
+#define mouthware_message_AppToRelayMessage_fw_update_end_tag 23
+#define mouthware_message_AppToRelayMessage_nus_stream_control_tag 24
+#define mouthware_message_AppToRelayMessage_nus_stream_write_tag 25
+#define mouthware_message_AppToRelayMessage_sensor_stream_filter_write_tag 26
+#define mouthware_message_AppToRelayMessage_sensor_codec_config_write_tag 27
+#define mouthware_message_AppToRelayMessage_sensor_stream_rate_write_tag 28
+#define mouthware_message_AppToRelayMessage_relay_profile_write_tag 29
+#define mouthware_message_AppToRelayMessage_usb_composition_write_tag 30
+#define mouthware_message_AppToRelayMessage_link_history_read_tag 31
+#define mouthware_message_AppToRelayMessage_request_id_tag 100
+#define mouthware_message_BleConnectionStatusResponse_connection_status_tag 1
+#define mouthware_message_BleConnectionStatusResponse_rssi_tag 2
+#define mouthware_message_BleConnectionStatusResponse_battery_level_tag 3
+#define mouthware_message_BleConnectionStatusResponse_tx_phy_tag 4
+#define mouthware_message_BleConnectionStatusResponse_rx_phy_tag 5
+#define mouthware_message_BleConnectionStatusResponse_max_tx_octets_tag 6
+#define mouthware_message_BleConnectionStatusResponse_max_rx_octets_tag 7
+#define mouthware_message_BleConnectionStatusResponse_connected_devices_tag 8
+#define mouthware_message_DeviceInfoResponse_name_tag 1
+#define mouthware_message_DeviceInfoResponse_firmware_tag 2
+#define mouthware_message_DeviceInfoResponse_address_tag 3
+#define mouthware_message_DeviceInfoResponse_vid_tag 4
+#define mouthware_message_DeviceInfoResponse_pid_tag 5
+#define mouthware_message_DeviceInfoResponse_family_tag 6
+#define mouthware_message_DeviceInfoResponse_board_tag 7
+#define mouthware_message_ClearBondsResponse_success_tag 1
+#define mouthware_message_DfuResponse_success_tag 1
+#define mouthware_message_ClearFirmwareCacheResponse_success_tag 1
+#define mouthware_message_HidLatencyReportStats_report_id_tag 1
+#define mouthware_message_HidLatencyReportStats_count_tag 2
+#define mouthware_message_HidLatencyReportStats_p50_us_tag 3
+#define mouthware_message_HidLatencyReportStats_p99_us_tag 4
+#define mouthware_message_HidLatencyReportStats_max_us_tag 5
+#define mouthware_message_HidLatencyResponse_reports_tag 1
+#define mouthware_message_HidConfigResponse_motion_interpolation_tag 1
+#define mouthware_message_HidConfigResponse_motion_prediction_tag 2
+#define mouthware_message_PassThroughBatchConfigResponse_enabled_tag 1
+#define mouthware_message_RelayStatsPathCounters_packets_tag 1
+#define mouthware_message_RelayStatsPathCounters_bytes_tag 2
+#define mouthware_message_RelayStatsPathCounters_echo_filtered_tag 3
+#define mouthware_message_RelayStatsPathCounters_dropped_tag 4
+#define mouthware_message_RelayStatsPathCounters_bridged_tag 5
+#define mouthware_message_RelayStatsResponse_nus_rx_tag 1
+#define mouthware_message_RelayStatsResponse_nus_tx_tag 2
+#define mouthware_message_RelayStatsResponse_hid_tag 3
+#define mouthware_message_ConnectionTimingRecord_sequence_tag 1
+#define mouthware_message_ConnectionTimingRecord_bonded_tag 2
+#define mouthware_message_ConnectionTimingRecord_in_progress_tag 3
+#define mouthware_message_ConnectionTimingRecord_first_adv_ms_tag 4
+#define mouthware_message_ConnectionTimingRecord_connect_request_ms_tag 5
+#define mouthware_message_ConnectionTimingRecord_connected_ms_tag 6
+#define mouthware_message_ConnectionTimingRecord_security_ms_tag 7
+#define mouthware_message_ConnectionTimingRecord_hid_ready_ms_tag 8
+#define mouthware_message_ConnectionTimingRecord_nus_ready_ms_tag 9
+#define mouthware_message_ConnectionTimingRecord_dis_ready_ms_tag 10
+#define mouthware_message_ConnectionTimingRecord_bas_ready_ms_tag 11
+#define mouthware_message_ConnectionTimingRecord_att_bearers_tag 12
+#define mouthware_message_ConnectionTimingResponse_records_tag 1
+#define mouthware_message_ConnectionTimingResponse_boot_usb_enumerated_ms_tag 2
+#define mouthware_message_ConnectionTimingResponse_boot_hid_ready_ms_tag 3
+#define mouthware_message_ConnectionTimingResponse_boot_usb_started_ms_tag 4
+#define mouthware_message_ConnectionTimingResponse_boot_ble_ready_ms_tag 5
+#define mouthware_message_ConnectionTimingResponse_boot_scan_started_ms_tag 6
+#define mouthware_message_LinkTelemetry_sequence_tag 1
+#define mouthware_message_LinkTelemetry_connected_tag 2
+#define mouthware_message_LinkTelemetry_rssi_tag 3
+#define mouthware_message_LinkTelemetry_battery_level_tag 4
+#define mouthware_message_LinkTelemetry_conn_interval_us_tag 5
+#define mouthware_message_LinkTelemetry_tx_phy_tag 6
+#define mouthware_message_LinkTelemetry_rx_phy_tag 7
+#define mouthware_message_LinkTelemetry_hid_reports_per_s_tag 8
+#define mouthware_message_LinkTelemetry_hid_dropped_tag 9
+#define mouthware_message_LinkTelemetry_nus_rx_dropped_tag 10
+#define mouthware_message_LinkTelemetry_nus_tx_dropped_tag 11
+#define mouthware_message_LinkTelemetry_nus_tx_queued_tag 12
+#define mouthware_message_LinkTelemetry_cdc_tx_queued_tag 13
+#define mouthware_message_LinkTelemetry_interval_ms_tag 14
+#define mouthware_message_LinkTelemetry_stalls_tag 15
+#define mouthware_message_LinkTelemetry_worst_stall_us_tag 16
+#define mouthware_message_LinkTelemetry_usb_wait_us_tag 17
+#define mouthware_message_LinkTelemetry_usb_phase_us_tag 18
+#define mouthware_message_LinkTelemetry_nus_seq_lost_tag 19
+#define mouthware_message_LinkTelemetry_nus_seq_reordered_tag 20
+#define mouthware_message_LinkTelemetry_nus_loss_permille_tag 21
+#define mouthware_message_LinkTelemetry_nus_gap_lengths_tag 22
+#define mouthware_message_RelayCapabilitiesResponse_firmware_version_tag 1
+#define mouthware_message_RelayCapabilitiesResponse_features_tag 2
+#define mouthware_message_RelayCapabilitiesResponse_max_frame_size_tag 3
+#define mouthware_message_RelayCapabilitiesResponse_max_in_flight_writes_tag 4
+#define mouthware_message_RelayCapabilitiesResponse_batch_window_us_tag 5
+#define mouthware_message_RelayCapabilitiesResponse_max_pass_through_size_tag 6
+#define mouthware_message_RelayCapabilitiesResponse_pass_through_ack_writes_tag 7
+#define mouthware_message_RelayCapabilitiesResponse_pass_through_ack_interval_us_tag 8
+#define mouthware_message_EchoResponse_host_timestamp_us_tag 1
+#define mouthware_message_EchoResponse_sequence_tag 2
+#define mouthware_message_EchoResponse_relay_rx_us_tag 3
+#define mouthware_message_EchoResponse_relay_tx_us_tag 4
+#define mouthware_message_EchoResponse_via_mouthpad_tag 5
+#define mouthware_message_EchoResponse_mouthpad_write_us_tag 6
+#define mouthware_message_EchoResponse_mouthpad_ack_us_tag 7
+#define mouthware_message_EchoResponse_error_code_tag 8
+#define mouthware_message_HidMirrorConfigResponse_enabled_tag 1
+#define mouthware_message_HidMirrorRecord_report_id_tag 1
+#define mouthware_message_HidMirrorRecord_data_tag 2
+#define mouthware_message_HidMirrorRecord_ble_rx_offset_us_tag 3
+#define mouthware_message_HidMirrorRecord_usb_submit_delay_us_tag 4
+#define mouthware_message_HidMirrorRecord_not_submitted_tag 5
+#define mouthware_message_HidMirrorBatch_sequence_tag 1
+#define mouthware_message_HidMirrorBatch_base_us_tag 2
+#define mouthware_message_HidMirrorBatch_records_tag 3
+#define mouthware_message_ThreadStat_name_tag        1
+#define mouthware_message_ThreadStat_cpu_permille_tag 2
+#define mouthware_message_ThreadStat_stack_size_tag  3
+#define mouthware_message_ThreadStat_stack_unused_tag 4
+#define mouthware_message_ThreadStat_context_switches_tag 5
+#define mouthware_message_ThreadStatsResponse_window_ms_tag 1
+#define mouthware_message_ThreadStatsResponse_thread_count_tag 2
+#define mouthware_message_ThreadStatsResponse_threads_tag 3
+#define mouthware_message_TraceResponse_boot_count_tag 1
+#define mouthware_message_TraceResponse_total_tag 2
+#define mouthware_message_TraceResponse_offset_tag 3
+#define mouthware_message_TraceResponse_records_tag 4
+#define mouthware_message_MemStatsRead_reset_tag 1
+#define mouthware_message_FwUpdateStart_size_tag 1
+#define mouthware_message_FwUpdateStart_sha256_tag 2
+#define mouthware_message_FwUpdateChunk_offset_tag 1
+#define mouthware_message_FwUpdateChunk_data_tag 2
+#define mouthware_message_FwUpdateEnd_abort_tag 1
+#define mouthware_message_FwUpdateEnd_reboot_tag 2
+#define mouthware_message_NusStreamControl_enabled_tag 1
+#define mouthware_message_NusStreamWrite_offset_tag 1
+#define mouthware_message_NusStreamWrite_data_tag 2
+#define mouthware_message_MemPool_name_tag       1
+#define mouthware_message_MemPool_unit_tag       2
+#define mouthware_message_MemPool_size_tag       3
+#define mouthware_message_MemPool_used_tag       4
+#define mouthware_message_MemPool_max_used_tag   5
+#define mouthware_message_MemPool_failures_tag   6
+#define mouthware_message_MemSite_name_tag       1
+#define mouthware_message_MemSite_calls_tag      2
+#define mouthware_message_MemSite_failures_tag   3
+#define mouthware_message_MemSite_peak_tag       4
+#define mouthware_message_MemStatsResponse_heap_size_tag 1
+#define mouthware_message_MemStatsResponse_heap_used_tag 2
+#define mouthware_message_MemStatsResponse_heap_max_used_tag 3
+#define mouthware_message_MemStatsResponse_heap_largest_free_tag 4
+#define mouthware_message_MemStatsResponse_heap_failures_tag 5
+#define mouthware_message_MemStatsResponse_pools_tag 6
+#define mouthware_message_MemStatsResponse_sites_tag 7
+#define mouthware_message_MemStatsResponse_stacks_checked_tag 8
+#define mouthware_message_MemStatsResponse_stacks_tight_tag 9
+#define mouthware_message_MemStatsResponse_stack_spare_tag 10
+#define mouthware_message_FwUpdateStatus_state_tag 1
+#define mouthware_message_FwUpdateStatus_size_tag 2
+#define mouthware_message_FwUpdateStatus_offset_tag 3
+#define mouthware_message_FwUpdateStatus_written_tag 4
+#define mouthware_message_FwUpdateStatus_window_tag 5
+#define mouthware_message_FwUpdateStatus_chunk_max_tag 6
+#define mouthware_message_FwUpdateStatus_error_tag 7
+#define mouthware_message_FwUpdateStatus_detail_tag 8
+#define mouthware_message_NusStreamStatus_state_tag 1
+#define mouthware_message_NusStreamStatus_received_tag 2
+#define mouthware_message_NusStreamStatus_forwarded_tag 3
+#define mouthware_message_NusStreamStatus_sent_tag 4
+#define mouthware_message_NusStreamStatus_failed_tag 5
+#define mouthware_message_NusStreamStatus_window_tag 6
+#define mouthware_message_NusStreamStatus_packet_size_tag 7
+#define mouthware_message_NusStreamStatus_refused_tag 8
+#define mouthware_message_SensorStreamFilterResponse_blocked_tag 1
+#define mouthware_message_SensorStreamFilterResponse_sensor_forwarded_tag 2
+#define mouthware_message_SensorStreamFilterResponse_sensor_dropped_tag 3
+#define mouthware_message_SensorStreamFilterResponse_power_forwarded_tag 4
+#define mouthware_message_SensorStreamFilterResponse_power_dropped_tag 5
+#define mouthware_message_SensorStreamFilterResponse_other_forwarded_tag 6
+#define mouthware_message_SensorStreamFilterResponse_other_dropped_tag 7
+#define mouthware_message_SensorCodecConfigResponse_enabled_tag 1
+#define mouthware_message_SensorCodecConfigResponse_keyframe_interval_tag 2
+#define mouthware_message_SensorCodecConfigResponse_frames_tag 3
+#define mouthware_message_SensorCodecConfigResponse_keyframes_tag 4
+#define mouthware_message_SensorCodecConfigResponse_raw_bytes_tag 5
+#define mouthware_message_SensorCodecConfigResponse_coded_bytes_tag 6
+#define mouthware_message_SensorFrameDelta_sequence_tag 1
+#define mouthware_message_SensorFrameDelta_keyframe_tag 2
+#define mouthware_message_SensorFrameDelta_data_tag 3
+#define mouthware_message_SensorStreamRateResponse_stream_tag 1
+#define mouthware_message_SensorStreamRateResponse_keep_one_in_tag 2
+#define mouthware_message_SensorStreamRateResponse_min_interval_us_tag 3
+#define mouthware_message_SensorStreamRateResponse_thinned_tag 4
+#define mouthware_message_RelayProfileResponse_profile_tag 1
+#define mouthware_message_RelayProfileResponse_overridden_tag 2
+#define mouthware_message_RelayProfileResponse_applied_tag 3
+#define mouthware_message_RelayProfileResponse_values_tag 4
+#define mouthware_message_UsbCompositionResponse_composition_tag 1
+#define mouthware_message_UsbCompositionResponse_active_tag 2
+#define mouthware_message_UsbCompositionResponse_reenumerating_tag 3
+#define mouthware_message_LinkHistoryResponse_address_tag 1
+#define mouthware_message_LinkHistoryResponse_bond_tag 2
+#define mouthware_message_LinkHistoryResponse_bond_count_tag 3
+#define mouthware_message_LinkHistoryResponse_boot_count_tag 4
+#define mouthware_message_LinkHistoryResponse_hour_tag 5
+#define mouthware_message_LinkHistoryResponse_total_tag 6
+#define mouthware_message_LinkHistoryResponse_offset_tag 7
+#define mouthware_message_LinkHistoryResponse_buckets_tag 8
+#define mouthware_message_RequestError_code_tag 1
+#define mouthware_message_RequestError_request_tag_tag 2
+#define mouthware_message_PassThroughToMouthpadResponse_error_code_tag 1
+#define mouthware_message_PassThroughToMouthpadResponse_credits_tag 2
+#define mouthware_message_PassThroughToMouthpadResponse_device_index_tag 3
+#define mouthware_message_PassThroughToMouthpadResponse_sequence_tag 4
+#define mouthware_message_PassThroughToMouthpadResponse_acked_tag 5
+#define mouthware_message_PassThroughToApp_data_tag 1
+#define mouthware_message_PassThroughToApp_more_fragments_tag 2
+#define mouthware_message_PassThroughToApp_fragment_tag 3
+#define mouthware_message_PassThroughToApp_device_index_tag 4
+#define mouthware_message_PassThroughChunk_sequence_tag 1
+#define mouthware_message_PassThroughChunk_data_tag 2
+#define mouthware_message_PassThroughToAppBatch_chunks_tag 1
+#define mouthware_message_RelayToAppMessage_ble_connection_status_response_tag 1
+#define mouthware_message_RelayToAppMessage_pass_through_to_mouthpad_response_tag 2
+#define mouthware_message_RelayToAppMessage_pass_through_to_app_tag 3
+#define mouthware_message_RelayToAppMessage_device_info_response_tag 4
+#define mouthware_message_RelayToAppMessage_clear_bonds_response_tag 5
+#define mouthware_message_RelayToAppMessage_dfu_response_tag 6
+#define mouthware_message_RelayToAppMessage_clear_firmware_cache_response_tag 7
+#define mouthware_message_RelayToAppMessage_hid_latency_response_tag 8
+#define mouthware_message_RelayToAppMessage_hid_config_response_tag 9
+#define mouthware_message_RelayToAppMessage_pass_through_to_app_batch_tag 10
+#define mouthware_message_RelayToAppMessage_pass_through_batch_config_response_tag 11
+#define mouthware_message_RelayToAppMessage_relay_stats_response_tag 12
+#define mouthware_message_RelayToAppMessage_connection_timing_response_tag 13
+#define mouthware_message_RelayToAppMessage_link_telemetry_tag 14
+#define mouthware_message_RelayToAppMessage_relay_capabilities_response_tag 15
+#define mouthware_message_RelayToAppMessage_echo_response_tag 16
+#define mouthware_message_RelayToAppMessage_hid_mirror_config_response_tag 17
+#define mouthware_message_RelayToAppMessage_hid_mirror_batch_tag 18
+#define mouthware_message_RelayToAppMessage_thread_stats_response_tag 19
+#define mouthware_message_RelayToAppMessage_trace_response_tag 20
+#define mouthware_message_RelayToAppMessage_mem_stats_response_tag 21
+#define mouthware_message_RelayToAppMessage_fw_update_status_tag 22
+#define mouthware_message_RelayToAppMessage_nus_stream_status_tag 23
+#define mouthware_message_RelayToAppMessage_sensor_stream_filter_response_tag 24
+#define mouthware_message_RelayToAppMessage_sensor_codec_config_response_tag 25
+#define mouthware_message_RelayToAppMessage_sensor_frame_delta_tag 26
+#define mouthware_message_RelayToAppMessage_sensor_stream_rate_response_tag 27
+#define mouthware_message_RelayToAppMessage_request_error_tag 28
+#define mouthware_message_RelayToAppMessage_relay_profile_response_tag 29
+#define mouthware_message_RelayToAppMessage_usb_composition_response_tag 30
+#define mouthware_message_RelayToAppMessage_link_history_response_tag 31
+#define mouthware_message_RelayToAppMessage_request_id_tag 100
+
+/* Struct field encoding specification for nanopb */
+#define mouthware_message_BleConnectionStatusRead_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     scan_boost,        1)
+#define mouthware_message_BleConnectionStatusRead_CALLBACK NULL
+#define mouthware_message_BleConnectionStatusRead_DEFAULT NULL
+
+#define mouthware_message_DeviceInfoRead_FIELDLIST(X, a) \
+
+#define mouthware_message_DeviceInfoRead_CALLBACK NULL
+#define mouthware_message_DeviceInfoRead_DEFAULT NULL
+
+#define mouthware_message_ClearBondsWrite_FIELDLIST(X, a) \
+
+#define mouthware_message_ClearBondsWrite_CALLBACK NULL
+#define mouthware_message_ClearBondsWrite_DEFAULT NULL
+
+#define mouthware_message_DfuWrite_FIELDLIST(X, a) \
+
+#define mouthware_message_DfuWrite_CALLBACK NULL
+#define mouthware_message_DfuWrite_DEFAULT NULL
+
+#define mouthware_message_ClearFirmwareCacheWrite_FIELDLIST(X, a) \
+
+#define mouthware_message_ClearFirmwareCacheWrite_CALLBACK NULL
+#define mouthware_message_ClearFirmwareCacheWrite_DEFAULT NULL
+
+#define mouthware_message_HidLatencyRead_FIELDLIST(X, a) \
+
+#define mouthware_message_HidLatencyRead_CALLBACK NULL
+#define mouthware_message_HidLatencyRead_DEFAULT NULL
+
+#define mouthware_message_HidConfigRead_FIELDLIST(X, a) \
+
+#define mouthware_message_HidConfigRead_CALLBACK NULL
+#define mouthware_message_HidConfigRead_DEFAULT NULL
+
+#define mouthware_message_HidConfigWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     motion_interpolation,   1) \
+X(a, STATIC,   SINGULAR, BOOL,     motion_prediction,   2)
+#define mouthware_message_HidConfigWrite_CALLBACK NULL
+#define mouthware_message_HidConfigWrite_DEFAULT NULL
+
+#define mouthware_message_PassThroughBatchConfigWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     enabled,           1)
+#define mouthware_message_PassThroughBatchConfigWrite_CALLBACK NULL
+#define mouthware_message_PassThroughBatchConfigWrite_DEFAULT NULL
+
+#define mouthware_message_RelayStatsRead_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     reset,             1)
+#define mouthware_message_RelayStatsRead_CALLBACK NULL
+#define mouthware_message_RelayStatsRead_DEFAULT NULL
+
+#define mouthware_message_ConnectionTimingRead_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     clear,             1)
+#define mouthware_message_ConnectionTimingRead_CALLBACK NULL
+#define mouthware_message_ConnectionTimingRead_DEFAULT NULL
+
+#define mouthware_message_LinkTelemetrySubscribe_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   interval_ms,       1) \
+X(a, STATIC,   SINGULAR, BOOL,     on_change,         2)
+#define mouthware_message_LinkTelemetrySubscribe_CALLBACK NULL
+#define mouthware_message_LinkTelemetrySubscribe_DEFAULT NULL
+
+#define mouthware_message_RelayCapabilitiesRead_FIELDLIST(X, a) \
+
+#define mouthware_message_RelayCapabilitiesRead_CALLBACK NULL
+#define mouthware_message_RelayCapabilitiesRead_DEFAULT NULL
+
+#define mouthware_message_EchoRequest_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT64,   host_timestamp_us,   1) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          2) \
+X(a, STATIC,   SINGULAR, BOOL,     via_mouthpad,      3) \
+X(a, STATIC,   SINGULAR, BYTES,    payload,           4)
+#define mouthware_message_EchoRequest_CALLBACK NULL
+#define mouthware_message_EchoRequest_DEFAULT NULL
+
+#define mouthware_message_HidMirrorConfigWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     enabled,           1)
+#define mouthware_message_HidMirrorConfigWrite_CALLBACK NULL
+#define mouthware_message_HidMirrorConfigWrite_DEFAULT NULL
+
+#define mouthware_message_ThreadStatsRead_FIELDLIST(X, a) \
+
+#define mouthware_message_ThreadStatsRead_CALLBACK NULL
+#define mouthware_message_ThreadStatsRead_DEFAULT NULL
+
+#define mouthware_message_TraceRead_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   SINGULAR, BOOL,     clear,             2)
+#define mouthware_message_TraceRead_CALLBACK NULL
+#define mouthware_message_TraceRead_DEFAULT NULL
+
+#define mouthware_message_MemStatsRead_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     reset,             1)
+#define mouthware_message_MemStatsRead_CALLBACK NULL
+#define mouthware_message_MemStatsRead_DEFAULT NULL
+
+#define mouthware_message_FwUpdateStart_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   size,              1) \
+X(a, STATIC,   SINGULAR, BYTES,    sha256,            2)
+#define mouthware_message_FwUpdateStart_CALLBACK NULL
+#define mouthware_message_FwUpdateStart_DEFAULT NULL
+
+#define mouthware_message_FwUpdateChunk_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              2)
+#define mouthware_message_FwUpdateChunk_CALLBACK NULL
+#define mouthware_message_FwUpdateChunk_DEFAULT NULL
+
+#define mouthware_message_FwUpdateEnd_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     abort,             1) \
+X(a, STATIC,   SINGULAR, BOOL,     reboot,            2)
+#define mouthware_message_FwUpdateEnd_CALLBACK NULL
+#define mouthware_message_FwUpdateEnd_DEFAULT NULL
+
+#define mouthware_message_NusStreamControl_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     enabled,           1)
+#define mouthware_message_NusStreamControl_CALLBACK NULL
+#define mouthware_message_NusStreamControl_DEFAULT NULL
+
+#define mouthware_message_NusStreamWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              2)
+#define mouthware_message_NusStreamWrite_CALLBACK NULL
+#define mouthware_message_NusStreamWrite_DEFAULT NULL
+
+#define mouthware_message_SensorStreamFilterWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   blocked,           1)
+#define mouthware_message_SensorStreamFilterWrite_CALLBACK NULL
+#define mouthware_message_SensorStreamFilterWrite_DEFAULT NULL
+
+#define mouthware_message_SensorCodecConfigWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     enabled,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   keyframe_interval,   2)
+#define mouthware_message_SensorCodecConfigWrite_CALLBACK NULL
+#define mouthware_message_SensorCodecConfigWrite_DEFAULT NULL
+
+#define mouthware_message_SensorStreamRateWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    stream,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   keep_one_in,       2) \
+X(a, STATIC,   SINGULAR, UINT32,   min_interval_us,   3)
+#define mouthware_message_SensorStreamRateWrite_CALLBACK NULL
+#define mouthware_message_SensorStreamRateWrite_DEFAULT NULL
+
+#define mouthware_message_RelayProfileKnobValue_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    knob,              1) \
+X(a, STATIC,   SINGULAR, SINT32,   value,             2)
+#define mouthware_message_RelayProfileKnobValue_CALLBACK NULL
+#define mouthware_message_RelayProfileKnobValue_DEFAULT NULL
+
+#define mouthware_message_RelayProfileWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    profile,           1) \
+X(a, STATIC,   SINGULAR, BOOL,     clear_overrides,   2) \
+X(a, STATIC,   REPEATED, MESSAGE,  overrides,         3)
+#define mouthware_message_RelayProfileWrite_CALLBACK NULL
+#define mouthware_message_RelayProfileWrite_DEFAULT NULL
+#define mouthware_message_RelayProfileWrite_overrides_MSGTYPE mouthware_message_RelayProfileKnobValue
+
+#define mouthware_message_UsbCompositionWrite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    composition,       1) \
+X(a, STATIC,   SINGULAR, BOOL,     reenumerate,       2)
+#define mouthware_message_UsbCompositionWrite_CALLBACK NULL
+#define mouthware_message_UsbCompositionWrite_DEFAULT NULL
+
+#define mouthware_message_LinkHistoryRead_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   bond,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            2) \
+X(a, STATIC,   SINGULAR, BOOL,     clear,             3)
+#define mouthware_message_LinkHistoryRead_CALLBACK NULL
+#define mouthware_message_LinkHistoryRead_DEFAULT NULL
+
+#define mouthware_message_PassThroughToMouthpad_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              1) \
+X(a, STATIC,   SINGULAR, BOOL,     reliable,          2) \
+X(a, STATIC,   SINGULAR, BOOL,     more_fragments,    3) \
+X(a, STATIC,   SINGULAR, UINT32,   fragment,          4) \
+X(a, STATIC,   SINGULAR, UINT32,   device_index,      5) \
+X(a, STATIC,   SINGULAR, UENUM,    ack,               6) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          7)
+#define mouthware_message_PassThroughToMouthpad_CALLBACK NULL
+#define mouthware_message_PassThroughToMouthpad_DEFAULT NULL
+
+#define mouthware_message_AppToRelayMessage_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    destination,       1) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,ble_connection_status_read,message_body.ble_connection_status_read),   2) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,pass_through_to_mouthpad,message_body.pass_through_to_mouthpad),   3) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,device_info_read,message_body.device_info_read),   4) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,clear_bonds_write,message_body.clear_bonds_write),   5) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,dfu_write,message_body.dfu_write),   6) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,clear_firmware_cache_write,message_body.clear_firmware_cache_write),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_latency_read,message_body.hid_latency_read),   8) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_config_read,message_body.hid_config_read),   9) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_config_write,message_body.hid_config_write),  10) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,pass_through_batch_config_write,message_body.pass_through_batch_config_write),  11) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,relay_stats_read,message_body.relay_stats_read),  12) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,connection_timing_read,message_body.connection_timing_read),  13) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,link_telemetry_subscribe,message_body.link_telemetry_subscribe),  14) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,relay_capabilities_read,message_body.relay_capabilities_read),  15) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,echo_request,message_body.echo_request),  16) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_mirror_config_write,message_body.hid_mirror_config_write),  17) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,thread_stats_read,message_body.thread_stats_read),  18) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,trace_read,message_body.trace_read),  19) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,mem_stats_read,message_body.mem_stats_read),  20) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,fw_update_start,message_body.fw_update_start),  21) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,fw_update_chunk,message_body.fw_update_chunk),  22) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,fw_update_end,message_body.fw_update_end),  23) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,nus_stream_control,message_body.nus_stream_control),  24) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,nus_stream_write,message_body.nus_stream_write),  25) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,sensor_stream_filter_write,message_body.sensor_stream_filter_write),  26) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,sensor_codec_config_write,message_body.sensor_codec_config_write),  27) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,sensor_stream_rate_write,message_body.sensor_stream_rate_write),  28) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,relay_profile_write,message_body.relay_profile_write),  29) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,usb_composition_write,message_body.usb_composition_write),  30) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,link_history_read,message_body.link_history_read),  31) \
+X(a, STATIC,   SINGULAR, UINT32,   request_id,      100)
+#define mouthware_message_AppToRelayMessage_CALLBACK NULL
+#define mouthware_message_AppToRelayMessage_DEFAULT NULL
+#define mouthware_message_AppToRelayMessage_message_body_ble_connection_status_read_MSGTYPE mouthware_message_BleConnectionStatusRead
+#define mouthware_message_AppToRelayMessage_message_body_pass_through_to_mouthpad_MSGTYPE mouthware_message_PassThroughToMouthpad
+#define mouthware_message_AppToRelayMessage_message_body_device_info_read_MSGTYPE mouthware_message_DeviceInfoRead
+#define mouthware_message_AppToRelayMessage_message_body_clear_bonds_write_MSGTYPE mouthware_message_ClearBondsWrite
+#define mouthware_message_AppToRelayMessage_message_body_dfu_write_MSGTYPE mouthware_message_DfuWrite
+#define mouthware_message_AppToRelayMessage_message_body_clear_firmware_cache_write_MSGTYPE mouthware_message_ClearFirmwareCacheWrite
+#define mouthware_message_AppToRelayMessage_message_body_hid_latency_read_MSGTYPE mouthware_message_HidLatencyRead
+#define mouthware_message_AppToRelayMessage_message_body_hid_config_read_MSGTYPE mouthware_message_HidConfigRead
+#define mouthware_message_AppToRelayMessage_message_body_hid_config_write_MSGTYPE mouthware_message_HidConfigWrite
+#define mouthware_message_AppToRelayMessage_message_body_pass_through_batch_config_write_MSGTYPE mouthware_message_PassThroughBatchConfigWrite
+#define mouthware_message_AppToRelayMessage_message_body_relay_stats_read_MSGTYPE mouthware_message_RelayStatsRead
+#define mouthware_message_AppToRelayMessage_message_body_connection_timing_read_MSGTYPE mouthware_message_ConnectionTimingRead
+#define mouthware_message_AppToRelayMessage_message_body_link_telemetry_subscribe_MSGTYPE mouthware_message_LinkTelemetrySubscribe
+#define mouthware_message_AppToRelayMessage_message_body_relay_capabilities_read_MSGTYPE mouthware_message_RelayCapabilitiesRead
+#define mouthware_message_AppToRelayMessage_message_body_echo_request_MSGTYPE mouthware_message_EchoRequest
+#define mouthware_message_AppToRelayMessage_message_body_hid_mirror_config_write_MSGTYPE mouthware_message_HidMirrorConfigWrite
+#define mouthware_message_AppToRelayMessage_message_body_thread_stats_read_MSGTYPE mouthware_message_ThreadStatsRead
+#define mouthware_message_AppToRelayMessage_message_body_trace_read_MSGTYPE mouthware_message_TraceRead
+#define mouthware_message_AppToRelayMessage_message_body_mem_stats_read_MSGTYPE mouthware_message_MemStatsRead
+#define mouthware_message_AppToRelayMessage_message_body_fw_update_start_MSGTYPE mouthware_message_FwUpdateStart
+#define mouthware_message_AppToRelayMessage_message_body_fw_update_chunk_MSGTYPE mouthware_message_FwUpdateChunk
+#define mouthware_message_AppToRelayMessage_message_body_fw_update_end_MSGTYPE mouthware_message_FwUpdateEnd
+#define mouthware_message_AppToRelayMessage_message_body_nus_stream_control_MSGTYPE mouthware_message_NusStreamControl
+#define mouthware_message_AppToRelayMessage_message_body_nus_stream_write_MSGTYPE mouthware_message_NusStreamWrite
+#define mouthware_message_AppToRelayMessage_message_body_sensor_stream_filter_write_MSGTYPE mouthware_message_SensorStreamFilterWrite
+#define mouthware_message_AppToRelayMessage_message_body_sensor_codec_config_write_MSGTYPE mouthware_message_SensorCodecConfigWrite
+#define mouthware_message_AppToRelayMessage_message_body_sensor_stream_rate_write_MSGTYPE mouthware_message_SensorStreamRateWrite
+#define mouthware_message_AppToRelayMessage_message_body_relay_profile_write_MSGTYPE mouthware_message_RelayProfileWrite
+#define mouthware_message_AppToRelayMessage_message_body_usb_composition_write_MSGTYPE mouthware_message_UsbCompositionWrite
+#define mouthware_message_AppToRelayMessage_message_body_link_history_read_MSGTYPE mouthware_message_LinkHistoryRead
+
+#define mouthware_message_BleConnectionStatusResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    connection_status,   1) \
+X(a, STATIC,   SINGULAR, INT32,    rssi,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   battery_level,     3) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_phy,            4) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_phy,            5) \
+X(a, STATIC,   SINGULAR, UINT32,   max_tx_octets,     6) \
+X(a, STATIC,   SINGULAR, UINT32,   max_rx_octets,     7) \
+X(a, STATIC,   SINGULAR, UINT32,   connected_devices,   8)
+#define mouthware_message_BleConnectionStatusResponse_CALLBACK NULL
+#define mouthware_message_BleConnectionStatusResponse_DEFAULT NULL
+
+#define mouthware_message_DeviceInfoResponse_FIELDLIST(X, a) \
+X(a, CALLBACK, SINGULAR, STRING,   name,              1) \
+X(a, CALLBACK, SINGULAR, STRING,   firmware,          2) \
+X(a, CALLBACK, SINGULAR, STRING,   address,           3) \
+X(a, STATIC,   SINGULAR, UINT32,   vid,               4) \
+X(a, STATIC,   SINGULAR, UINT32,   pid,               5) \
+X(a, STATIC,   SINGULAR, UENUM,    family,            6) \
+X(a, STATIC,   SINGULAR, UENUM,    board,             7)
+#define mouthware_message_DeviceInfoResponse_CALLBACK pb_default_field_callback
+#define mouthware_message_DeviceInfoResponse_DEFAULT NULL
+
+#define mouthware_message_ClearBondsResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     success,           1)
+#define mouthware_message_ClearBondsResponse_CALLBACK NULL
+#define mouthware_message_ClearBondsResponse_DEFAULT NULL
+
+#define mouthware_message_DfuResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     success,           1)
+#define mouthware_message_DfuResponse_CALLBACK NULL
+#define mouthware_message_DfuResponse_DEFAULT NULL
+
+#define mouthware_message_ClearFirmwareCacheResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     success,           1)
+#define mouthware_message_ClearFirmwareCacheResponse_CALLBACK NULL
+#define mouthware_message_ClearFirmwareCacheResponse_DEFAULT NULL
+
+#define mouthware_message_HidLatencyReportStats_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   report_id,         1) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   p50_us,            3) \
+X(a, STATIC,   SINGULAR, UINT32,   p99_us,            4) \
+X(a, STATIC,   SINGULAR, UINT32,   max_us,            5)
+#define mouthware_message_HidLatencyReportStats_CALLBACK NULL
+#define mouthware_message_HidLatencyReportStats_DEFAULT NULL
+
+#define mouthware_message_HidLatencyResponse_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  reports,           1)
+#define mouthware_message_HidLatencyResponse_CALLBACK NULL
+#define mouthware_message_HidLatencyResponse_DEFAULT NULL
+#define mouthware_message_HidLatencyResponse_reports_MSGTYPE mouthware_message_HidLatencyReportStats
+
+#define mouthware_message_HidConfigResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     motion_interpolation,   1) \
+X(a, STATIC,   SINGULAR, BOOL,     motion_prediction,   2)
+#define mouthware_message_HidConfigResponse_CALLBACK NULL
+#define mouthware_message_HidConfigResponse_DEFAULT NULL
+
+#define mouthware_message_PassThroughBatchConfigResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     enabled,           1)
+#define mouthware_message_PassThroughBatchConfigResponse_CALLBACK NULL
+#define mouthware_message_PassThroughBatchConfigResponse_DEFAULT NULL
+
+#define mouthware_message_RelayStatsPathCounters_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   packets,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   bytes,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   echo_filtered,     3) \
+X(a, STATIC,   SINGULAR, UINT32,   dropped,           4) \
+X(a, STATIC,   SINGULAR, UINT32,   bridged,           5)
+#define mouthware_message_RelayStatsPathCounters_CALLBACK NULL
+#define mouthware_message_RelayStatsPathCounters_DEFAULT NULL
+
+#define mouthware_message_RelayStatsResponse_FIELDLIST(X, a) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  nus_rx,            1) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  nus_tx,            2) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  hid,               3)
+#define mouthware_message_RelayStatsResponse_CALLBACK NULL
+#define mouthware_message_RelayStatsResponse_DEFAULT NULL
+#define mouthware_message_RelayStatsResponse_nus_rx_MSGTYPE mouthware_message_RelayStatsPathCounters
+#define mouthware_message_RelayStatsResponse_nus_tx_MSGTYPE mouthware_message_RelayStatsPathCounters
+#define mouthware_message_RelayStatsResponse_hid_MSGTYPE mouthware_message_RelayStatsPathCounters
+
+#define mouthware_message_ConnectionTimingRecord_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          1) \
+X(a, STATIC,   SINGULAR, BOOL,     bonded,            2) \
+X(a, STATIC,   SINGULAR, BOOL,     in_progress,       3) \
+X(a, STATIC,   SINGULAR, UINT32,   first_adv_ms,      4) \
+X(a, STATIC,   SINGULAR, UINT32,   connect_request_ms,   5) \
+X(a, STATIC,   SINGULAR, UINT32,   connected_ms,      6) \
+X(a, STATIC,   SINGULAR, UINT32,   security_ms,       7) \
+X(a, STATIC,   SINGULAR, UINT32,   hid_ready_ms,      8) \
+X(a, STATIC,   SINGULAR, UINT32,   nus_ready_ms,      9) \
+X(a, STATIC,   SINGULAR, UINT32,   dis_ready_ms,     10) \
+X(a, STATIC,   SINGULAR, UINT32,   bas_ready_ms,     11) \
+X(a, STATIC,   SINGULAR, UINT32,   att_bearers,      12)
+#define mouthware_message_ConnectionTimingRecord_CALLBACK NULL
+#define mouthware_message_ConnectionTimingRecord_DEFAULT NULL
+
+#define mouthware_message_ConnectionTimingResponse_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  records,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   boot_usb_enumerated_ms,   2) \
+X(a, STATIC,   SINGULAR, UINT32,   boot_hid_ready_ms,   3) \
+X(a, STATIC,   SINGULAR, UINT32,   boot_usb_started_ms,   4) \
+X(a, STATIC,   SINGULAR, UINT32,   boot_ble_ready_ms,   5) \
+X(a, STATIC,   SINGULAR, UINT32,   boot_scan_started_ms,   6)
+#define mouthware_message_ConnectionTimingResponse_CALLBACK NULL
+#define mouthware_message_ConnectionTimingResponse_DEFAULT NULL
+#define mouthware_message_ConnectionTimingResponse_records_MSGTYPE mouthware_message_ConnectionTimingRecord
+
+#define mouthware_message_LinkTelemetry_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          1) \
+X(a, STATIC,   SINGULAR, BOOL,     connected,         2) \
+X(a, STATIC,   SINGULAR, INT32,    rssi,              3) \
+X(a, STATIC,   SINGULAR, UINT32,   battery_level,     4) \
+X(a, STATIC,   SINGULAR, UINT32,   conn_interval_us,   5) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_phy,            6) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_phy,            7) \
+X(a, STATIC,   SINGULAR, UINT32,   hid_reports_per_s,   8) \
+X(a, STATIC,   SINGULAR, UINT32,   hid_dropped,       9) \
+X(a, STATIC,   SINGULAR, UINT32,   nus_rx_dropped,   10) \
+X(a, STATIC,   SINGULAR, UINT32,   nus_tx_dropped,   11) \
+X(a, STATIC,   SINGULAR, UINT32,   nus_tx_queued,    12) \
+X(a, STATIC,   SINGULAR, UINT32,   cdc_tx_queued,    13) \
+X(a, STATIC,   SINGULAR, UINT32,   interval_ms,      14) \
+X(a, STATIC,   SINGULAR, UINT32,   stalls,           15) \
+X(a, STATIC,   SINGULAR, UINT32,   worst_stall_us,   16) \
+X(a, STATIC,   SINGULAR, UINT32,   usb_wait_us,      17) \
+X(a, STATIC,   SINGULAR, UINT32,   usb_phase_us,     18) \
+X(a, STATIC,   SINGULAR, UINT32,   nus_seq_lost,     19) \
+X(a, STATIC,   SINGULAR, UINT32,   nus_seq_reordered,  20) \
+X(a, STATIC,   SINGULAR, UINT32,   nus_loss_permille,  21) \
+X(a, STATIC,   REPEATED, UINT32,   nus_gap_lengths,  22)
+#define mouthware_message_LinkTelemetry_CALLBACK NULL
+#define mouthware_message_LinkTelemetry_DEFAULT NULL
+
+#define mouthware_message_RelayCapabilitiesResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   firmware_version,   1) \
+X(a, STATIC,   SINGULAR, UINT32,   features,          2) \
+X(a, STATIC,   SINGULAR, UINT32,   max_frame_size,    3) \
+X(a, STATIC,   SINGULAR, UINT32,   max_in_flight_writes,   4) \
+X(a, STATIC,   SINGULAR, UINT32,   batch_window_us,   5) \
+X(a, STATIC,   SINGULAR, UINT32,   max_pass_through_size,   6) \
+X(a, STATIC,   SINGULAR, UINT32,   pass_through_ack_writes,   7) \
+X(a, STATIC,   SINGULAR, UINT32,   pass_through_ack_interval_us,   8)
+#define mouthware_message_RelayCapabilitiesResponse_CALLBACK NULL
+#define mouthware_message_RelayCapabilitiesResponse_DEFAULT NULL
+
+#define mouthware_message_EchoResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT64,   host_timestamp_us,   1) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          2) \
+X(a, STATIC,   SINGULAR, UINT64,   relay_rx_us,       3) \
+X(a, STATIC,   SINGULAR, UINT64,   relay_tx_us,       4) \
+X(a, STATIC,   SINGULAR, BOOL,     via_mouthpad,      5) \
+X(a, STATIC,   SINGULAR, UINT64,   mouthpad_write_us,   6) \
+X(a, STATIC,   SINGULAR, UINT64,   mouthpad_ack_us,   7) \
+X(a, STATIC,   SINGULAR, UENUM,    error_code,        8)
+#define mouthware_message_EchoResponse_CALLBACK NULL
+#define mouthware_message_EchoResponse_DEFAULT NULL
+
+#define mouthware_message_HidMirrorConfigResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     enabled,           1)
+#define mouthware_message_HidMirrorConfigResponse_CALLBACK NULL
+#define mouthware_message_HidMirrorConfigResponse_DEFAULT NULL
+
+#define mouthware_message_HidMirrorRecord_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   report_id,         1) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   ble_rx_offset_us,   3) \
+X(a, STATIC,   SINGULAR, UINT32,   usb_submit_delay_us,   4) \
+X(a, STATIC,   SINGULAR, BOOL,     not_submitted,     5)
+#define mouthware_message_HidMirrorRecord_CALLBACK NULL
+#define mouthware_message_HidMirrorRecord_DEFAULT NULL
+
+#define mouthware_message_HidMirrorBatch_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          1) \
+X(a, STATIC,   SINGULAR, UINT64,   base_us,           2) \
+X(a, CALLBACK, REPEATED, MESSAGE,  records,           3)
+#define mouthware_message_HidMirrorBatch_CALLBACK pb_default_field_callback
+#define mouthware_message_HidMirrorBatch_DEFAULT NULL
+#define mouthware_message_HidMirrorBatch_records_MSGTYPE mouthware_message_HidMirrorRecord
+
+#define mouthware_message_ThreadStat_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   cpu_permille,      2) \
+X(a, STATIC,   SINGULAR, UINT32,   stack_size,        3) \
+X(a, STATIC,   SINGULAR, UINT32,   stack_unused,      4) \
+X(a, STATIC,   SINGULAR, UINT32,   context_switches,   5)
+#define mouthware_message_ThreadStat_CALLBACK NULL
+#define mouthware_message_ThreadStat_DEFAULT NULL
+
+#define mouthware_message_ThreadStatsResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   window_ms,         1) \
+X(a, STATIC,   SINGULAR, UINT32,   thread_count,      2) \
+X(a, CALLBACK, REPEATED, MESSAGE,  threads,           3)
+#define mouthware_message_ThreadStatsResponse_CALLBACK pb_default_field_callback
+#define mouthware_message_ThreadStatsResponse_DEFAULT NULL
+#define mouthware_message_ThreadStatsResponse_threads_MSGTYPE mouthware_message_ThreadStat
+
+#define mouthware_message_TraceResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   boot_count,        1) \
+X(a, STATIC,   SINGULAR, UINT32,   total,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            3) \
+X(a, CALLBACK, SINGULAR, BYTES,    records,           4)
+#define mouthware_message_TraceResponse_CALLBACK pb_default_field_callback
+#define mouthware_message_TraceResponse_DEFAULT NULL
+
+#define mouthware_message_MemPool_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   unit,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   size,              3) \
+X(a, STATIC,   SINGULAR, UINT32,   used,              4) \
+X(a, STATIC,   SINGULAR, UINT32,   max_used,          5) \
+X(a, STATIC,   SINGULAR, UINT32,   failures,          6)
+#define mouthware_message_MemPool_CALLBACK NULL
+#define mouthware_message_MemPool_DEFAULT NULL
+
+#define mouthware_message_MemSite_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   calls,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   failures,          3) \
+X(a, STATIC,   SINGULAR, UINT32,   peak,              4)
+#define mouthware_message_MemSite_CALLBACK NULL
+#define mouthware_message_MemSite_DEFAULT NULL
+
+#define mouthware_message_MemStatsResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   heap_size,         1) \
+X(a, STATIC,   SINGULAR, UINT32,   heap_used,         2) \
+X(a, STATIC,   SINGULAR, UINT32,   heap_max_used,     3) \
+X(a, STATIC,   SINGULAR, UINT32,   heap_largest_free,  4) \
+X(a, STATIC,   SINGULAR, UINT32,   heap_failures,     5) \
+X(a, CALLBACK, REPEATED, MESSAGE,  pools,             6) \
+X(a, CALLBACK, REPEATED, MESSAGE,  sites,             7) \
+X(a, STATIC,   SINGULAR, UINT32,   stacks_checked,    8) \
+X(a, STATIC,   SINGULAR, UINT32,   stacks_tight,      9) \
+X(a, STATIC,   SINGULAR, UINT32,   stack_spare,      10)
+#define mouthware_message_MemStatsResponse_CALLBACK pb_default_field_callback
+#define mouthware_message_MemStatsResponse_DEFAULT NULL
+#define mouthware_message_MemStatsResponse_pools_MSGTYPE mouthware_message_MemPool
+#define mouthware_message_MemStatsResponse_sites_MSGTYPE mouthware_message_MemSite
+
+#define mouthware_message_FwUpdateStatus_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   state,             1) \
+X(a, STATIC,   SINGULAR, UINT32,   size,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            3) \
+X(a, STATIC,   SINGULAR, UINT32,   written,           4) \
+X(a, STATIC,   SINGULAR, UINT32,   window,            5) \
+X(a, STATIC,   SINGULAR, UINT32,   chunk_max,         6) \
+X(a, STATIC,   SINGULAR, UINT32,   error,             7) \
+X(a, STATIC,   SINGULAR, SINT32,   detail,            8)
+#define mouthware_message_FwUpdateStatus_CALLBACK NULL
+#define mouthware_message_FwUpdateStatus_DEFAULT NULL
+
+#define mouthware_message_NusStreamStatus_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   state,             1) \
+X(a, STATIC,   SINGULAR, UINT32,   received,          2) \
+X(a, STATIC,   SINGULAR, UINT32,   forwarded,         3) \
+X(a, STATIC,   SINGULAR, UINT32,   sent,              4) \
+X(a, STATIC,   SINGULAR, UINT32,   failed,            5) \
+X(a, STATIC,   SINGULAR, UINT32,   window,            6) \
+X(a, STATIC,   SINGULAR, UINT32,   packet_size,       7) \
+X(a, STATIC,   SINGULAR, UINT32,   refused,           8)
+#define mouthware_message_NusStreamStatus_CALLBACK NULL
+#define mouthware_message_NusStreamStatus_DEFAULT NULL
+
+#define mouthware_message_SensorStreamFilterResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   blocked,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   sensor_forwarded,   2) \
+X(a, STATIC,   SINGULAR, UINT32,   sensor_dropped,    3) \
+X(a, STATIC,   SINGULAR, UINT32,   power_forwarded,   4) \
+X(a, STATIC,   SINGULAR, UINT32,   power_dropped,     5) \
+X(a, STATIC,   SINGULAR, UINT32,   other_forwarded,   6) \
+X(a, STATIC,   SINGULAR, UINT32,   other_dropped,     7)
+#define mouthware_message_SensorStreamFilterResponse_CALLBACK NULL
+#define mouthware_message_SensorStreamFilterResponse_DEFAULT NULL
+
+#define mouthware_message_SensorCodecConfigResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BOOL,     enabled,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   keyframe_interval,   2) \
+X(a, STATIC,   SINGULAR, UINT32,   frames,            3) \
+X(a, STATIC,   SINGULAR, UINT32,   keyframes,         4) \
+X(a, STATIC,   SINGULAR, UINT32,   raw_bytes,         5) \
+X(a, STATIC,   SINGULAR, UINT32,   coded_bytes,       6)
+#define mouthware_message_SensorCodecConfigResponse_CALLBACK NULL
+#define mouthware_message_SensorCodecConfigResponse_DEFAULT NULL
+
+#define mouthware_message_SensorFrameDelta_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          1) \
+X(a, STATIC,   SINGULAR, BOOL,     keyframe,          2) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              3)
+#define mouthware_message_SensorFrameDelta_CALLBACK NULL
+#define mouthware_message_SensorFrameDelta_DEFAULT NULL
+
+#define mouthware_message_SensorStreamRateResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    stream,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   keep_one_in,       2) \
+X(a, STATIC,   SINGULAR, UINT32,   min_interval_us,   3) \
+X(a, STATIC,   SINGULAR, UINT32,   thinned,           4)
+#define mouthware_message_SensorStreamRateResponse_CALLBACK NULL
+#define mouthware_message_SensorStreamRateResponse_DEFAULT NULL
+
+#define mouthware_message_RelayProfileResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    profile,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   overridden,        2) \
+X(a, STATIC,   SINGULAR, UINT32,   applied,           3) \
+X(a, STATIC,   REPEATED, SINT32,   values,            4)
+#define mouthware_message_RelayProfileResponse_CALLBACK NULL
+#define mouthware_message_RelayProfileResponse_DEFAULT NULL
+
+#define mouthware_message_UsbCompositionResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    composition,       1) \
+X(a, STATIC,   SINGULAR, UENUM,    active,            2) \
+X(a, STATIC,   SINGULAR, BOOL,     reenumerating,     3)
+#define mouthware_message_UsbCompositionResponse_CALLBACK NULL
+#define mouthware_message_UsbCompositionResponse_DEFAULT NULL
+
+#define mouthware_message_LinkHistoryResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BYTES,    address,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   bond,              2) \
+X(a, STATIC,   SINGULAR, UINT32,   bond_count,        3) \
+X(a, STATIC,   SINGULAR, UINT32,   boot_count,        4) \
+X(a, STATIC,   SINGULAR, UINT32,   hour,              5) \
+X(a, STATIC,   SINGULAR, UINT32,   total,             6) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            7) \
+X(a, CALLBACK, SINGULAR, BYTES,    buckets,           8)
+#define mouthware_message_LinkHistoryResponse_CALLBACK pb_default_field_callback
+#define mouthware_message_LinkHistoryResponse_DEFAULT NULL
+
+#define mouthware_message_RequestError_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    code,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   request_tag,       2)
+#define mouthware_message_RequestError_CALLBACK NULL
+#define mouthware_message_RequestError_DEFAULT NULL
+
+#define mouthware_message_PassThroughToMouthpadResponse_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UENUM,    error_code,        1) \
+X(a, STATIC,   SINGULAR, UINT32,   credits,           2) \
+X(a, STATIC,   SINGULAR, UINT32,   device_index,      3) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          4) \
+X(a, STATIC,   SINGULAR, UINT32,   acked,             5)
+#define mouthware_message_PassThroughToMouthpadResponse_CALLBACK NULL
+#define mouthware_message_PassThroughToMouthpadResponse_DEFAULT NULL
+
+#define mouthware_message_PassThroughToApp_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              1) \
+X(a, STATIC,   SINGULAR, BOOL,     more_fragments,    2) \
+X(a, STATIC,   SINGULAR, UINT32,   fragment,          3) \
+X(a, STATIC,   SINGULAR, UINT32,   device_index,      4)
+#define mouthware_message_PassThroughToApp_CALLBACK NULL
+#define mouthware_message_PassThroughToApp_DEFAULT NULL
+
+#define mouthware_message_PassThroughChunk_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   sequence,          1) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              2)
+#define mouthware_message_PassThroughChunk_CALLBACK NULL
+#define mouthware_message_PassThroughChunk_DEFAULT NULL
+
+#define mouthware_message_PassThroughToAppBatch_FIELDLIST(X, a) \
+X(a, CALLBACK, REPEATED, MESSAGE,  chunks,            1)
+#define mouthware_message_PassThroughToAppBatch_CALLBACK pb_default_field_callback
+#define mouthware_message_PassThroughToAppBatch_DEFAULT NULL
+#define mouthware_message_PassThroughToAppBatch_chunks_MSGTYPE mouthware_message_PassThroughChunk
+
+#define mouthware_message_RelayToAppMessage_FIELDLIST(X, a) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,ble_connection_status_response,message_body.ble_connection_status_response),   1) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,pass_through_to_mouthpad_response,message_body.pass_through_to_mouthpad_response),   2) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,pass_through_to_app,message_body.pass_through_to_app),   3) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,device_info_response,message_body.device_info_response),   4) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,clear_bonds_response,message_body.clear_bonds_response),   5) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,dfu_response,message_body.dfu_response),   6) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,clear_firmware_cache_response,message_body.clear_firmware_cache_response),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_latency_response,message_body.hid_latency_response),   8) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_config_response,message_body.hid_config_response),   9) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,pass_through_to_app_batch,message_body.pass_through_to_app_batch),  10) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,pass_through_batch_config_response,message_body.pass_through_batch_config_response),  11) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,relay_stats_response,message_body.relay_stats_response),  12) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,connection_timing_response,message_body.connection_timing_response),  13) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,link_telemetry,message_body.link_telemetry),  14) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,relay_capabilities_response,message_body.relay_capabilities_response),  15) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,echo_response,message_body.echo_response),  16) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_mirror_config_response,message_body.hid_mirror_config_response),  17) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,hid_mirror_batch,message_body.hid_mirror_batch),  18) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,thread_stats_response,message_body.thread_stats_response),  19) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,trace_response,message_body.trace_response),  20) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,mem_stats_response,message_body.mem_stats_response),  21) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,fw_update_status,message_body.fw_update_status),  22) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,nus_stream_status,message_body.nus_stream_status),  23) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,sensor_stream_filter_response,message_body.sensor_stream_filter_response),  24) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,sensor_codec_config_response,message_body.sensor_codec_config_response),  25) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,sensor_frame_delta,message_body.sensor_frame_delta),  26) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,sensor_stream_rate_response,message_body.sensor_stream_rate_response),  27) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,request_error,message_body.request_error),  28) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,relay_profile_response,message_body.relay_profile_response),  29) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,usb_composition_response,message_body.usb_composition_response),  30) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message_body,link_history_response,message_body.link_history_response),  31) \
+X(a, STATIC,   SINGULAR, UINT32,   request_id,      100)
+#define mouthware_message_RelayToAppMessage_CALLBACK NULL
+#define mouthware_message_RelayToAppMessage_DEFAULT NULL
+#define mouthware_message_RelayToAppMessage_message_body_ble_connection_status_response_MSGTYPE mouthware_message_BleConnectionStatusResponse
+#define mouthware_message_RelayToAppMessage_message_body_pass_through_to_mouthpad_response_MSGTYPE mouthware_message_PassThroughToMouthpadResponse
+#define mouthware_message_RelayToAppMessage_message_body_pass_through_to_app_MSGTYPE mouthware_message_PassThroughToApp
+#define mouthware_message_RelayToAppMessage_message_body_device_info_response_MSGTYPE mouthware_message_DeviceInfoResponse
+#define mouthware_message_RelayToAppMessage_message_body_clear_bonds_response_MSGTYPE mouthware_message_ClearBondsResponse
+#define mouthware_message_RelayToAppMessage_message_body_dfu_response_MSGTYPE mouthware_message_DfuResponse
+#define mouthware_message_RelayToAppMessage_message_body_clear_firmware_cache_response_MSGTYPE mouthware_message_ClearFirmwareCacheResponse
+#define mouthware_message_RelayToAppMessage_message_body_hid_latency_response_MSGTYPE mouthware_message_HidLatencyResponse
+#define mouthware_message_RelayToAppMessage_message_body_hid_config_response_MSGTYPE mouthware_message_HidConfigResponse
+#define mouthware_message_RelayToAppMessage_message_body_pass_through_to_app_batch_MSGTYPE mouthware_message_PassThroughToAppBatch
+#define mouthware_message_RelayToAppMessage_message_body_pass_through_batch_config_response_MSGTYPE mouthware_message_PassThroughBatchConfigResponse
+#define mouthware_message_RelayToAppMessage_message_body_relay_stats_response_MSGTYPE mouthware_message_RelayStatsResponse
+#define mouthware_message_RelayToAppMessage_message_body_connection_timing_response_MSGTYPE mouthware_message_ConnectionTimingResponse
+#define mouthware_message_RelayToAppMessage_message_body_link_telemetry_MSGTYPE mouthware_message_LinkTelemetry
+#define mouthware_message_RelayToAppMessage_message_body_relay_capabilities_response_MSGTYPE mouthware_message_RelayCapabilitiesResponse
+#define mouthware_message_RelayToAppMessage_message_body_echo_response_MSGTYPE mouthware_message_EchoResponse
+#define mouthware_message_RelayToAppMessage_message_body_hid_mirror_config_response_MSGTYPE mouthware_message_HidMirrorConfigResponse
+#define mouthware_message_RelayToAppMessage_message_body_hid_mirror_batch_MSGTYPE mouthware_message_HidMirrorBatch
+#define mouthware_message_RelayToAppMessage_message_body_thread_stats_response_MSGTYPE mouthware_message_ThreadStatsResponse
+#define mouthware_message_RelayToAppMessage_message_body_trace_response_MSGTYPE mouthware_message_TraceResponse
+#define mouthware_message_RelayToAppMessage_message_body_mem_stats_response_MSGTYPE mouthware_message_MemStatsResponse
+#define mouthware_message_RelayToAppMessage_message_body_fw_update_status_MSGTYPE mouthware_message_FwUpdateStatus
+#define mouthware_message_RelayToAppMessage_message_body_nus_stream_status_MSGTYPE mouthware_message_NusStreamStatus
+#define mouthware_message_RelayToAppMessage_message_body_sensor_stream_filter_response_MSGTYPE mouthware_message_SensorStreamFilterResponse
+#define mouthware_message_RelayToAppMessage_message_body_sensor_codec_config_response_MSGTYPE mouthware_message_SensorCodecConfigResponse
+#define mouthware_message_RelayToAppMessage_message_body_sensor_frame_delta_MSGTYPE mouthware_message_SensorFrameDelta
+#define mouthware_message_RelayToAppMessage_message_body_sensor_stream_rate_response_MSGTYPE mouthware_message_SensorStreamRateResponse
+#define mouthware_message_RelayToAppMessage_message_body_request_error_MSGTYPE mouthware_message_RequestError
+#define mouthware_message_RelayToAppMessage_message_body_relay_profile_response_MSGTYPE mouthware_message_RelayProfileResponse
+#define mouthware_message_RelayToAppMessage_message_body_usb_composition_response_MSGTYPE mouthware_message_UsbCompositionResponse
+#define mouthware_message_RelayToAppMessage_message_body_link_history_response_MSGTYPE mouthware_message_LinkHistoryResponse
+
+extern const pb_msgdesc_t mouthware_message_BleConnectionStatusRead_msg;
+extern const pb_msgdesc_t mouthware_message_DeviceInfoRead_msg;
+extern const pb_msgdesc_t mouthware_message_ClearBondsWrite_msg;
+extern const pb_msgdesc_t mouthware_message_DfuWrite_msg;
+extern const pb_msgdesc_t mouthware_message_ClearFirmwareCacheWrite_msg;
+extern const pb_msgdesc_t mouthware_message_HidLatencyRead_msg;
+extern const pb_msgdesc_t mouthware_message_HidConfigRead_msg;
+extern const pb_msgdesc_t mouthware_message_HidConfigWrite_msg;
+extern const pb_msgdesc_t mouthware_message_PassThroughBatchConfigWrite_msg;
+extern const pb_msgdesc_t mouthware_message_RelayStatsRead_msg;
+extern const pb_msgdesc_t mouthware_message_ConnectionTimingRead_msg;
+extern const pb_msgdesc_t mouthware_message_LinkTelemetrySubscribe_msg;
+extern const pb_msgdesc_t mouthware_message_RelayCapabilitiesRead_msg;
+extern const pb_msgdesc_t mouthware_message_EchoRequest_msg;
+extern const pb_msgdesc_t mouthware_message_HidMirrorConfigWrite_msg;
+extern const pb_msgdesc_t mouthware_message_ThreadStatsRead_msg;
+extern const pb_msgdesc_t mouthware_message_TraceRead_msg;
+extern const pb_msgdesc_t mouthware_message_MemStatsRead_msg;
+extern const pb_msgdesc_t mouthware_message_FwUpdateStart_msg;
+extern const pb_msgdesc_t mouthware_message_FwUpdateChunk_msg;
+extern const pb_msgdesc_t mouthware_message_FwUpdateEnd_msg;
+extern const pb_msgdesc_t mouthware_message_NusStreamControl_msg;
+extern const pb_msgdesc_t mouthware_message_NusStreamWrite_msg;
+extern const pb_msgdesc_t mouthware_message_SensorStreamFilterWrite_msg;
+extern const pb_msgdesc_t mouthware_message_SensorCodecConfigWrite_msg;
+extern const pb_msgdesc_t mouthware_message_SensorStreamRateWrite_msg;
+extern const pb_msgdesc_t mouthware_message_RelayProfileKnobValue_msg;
+extern const pb_msgdesc_t mouthware_message_RelayProfileWrite_msg;
+extern const pb_msgdesc_t mouthware_message_UsbCompositionWrite_msg;
+extern const pb_msgdesc_t mouthware_message_LinkHistoryRead_msg;
+extern const pb_msgdesc_t mouthware_message_PassThroughToMouthpad_msg;
+extern const pb_msgdesc_t mouthware_message_AppToRelayMessage_msg;
+extern const pb_msgdesc_t mouthware_message_BleConnectionStatusResponse_msg;
+extern const pb_msgdesc_t mouthware_message_DeviceInfoResponse_msg;
+extern const pb_msgdesc_t mouthware_message_ClearBondsResponse_msg;
+extern const pb_msgdesc_t mouthware_message_DfuResponse_msg;
+extern const pb_msgdesc_t mouthware_message_ClearFirmwareCacheResponse_msg;
+extern const pb_msgdesc_t mouthware_message_HidLatencyReportStats_msg;
+extern const pb_msgdesc_t mouthware_message_HidLatencyResponse_msg;
+extern const pb_msgdesc_t mouthware_message_HidConfigResponse_msg;
+extern const pb_msgdesc_t mouthware_message_PassThroughBatchConfigResponse_msg;
+extern const pb_msgdesc_t mouthware_message_RelayStatsPathCounters_msg;
+extern const pb_msgdesc_t mouthware_message_RelayStatsResponse_msg;
+extern const pb_msgdesc_t mouthware_message_ConnectionTimingRecord_msg;
+extern const pb_msgdesc_t mouthware_message_ConnectionTimingResponse_msg;
+extern const pb_msgdesc_t mouthware_message_LinkTelemetry_msg;
+extern const pb_msgdesc_t mouthware_message_RelayCapabilitiesResponse_msg;
+extern const pb_msgdesc_t mouthware_message_EchoResponse_msg;
+extern const pb_msgdesc_t mouthware_message_HidMirrorConfigResponse_msg;
+extern const pb_msgdesc_t mouthware_message_HidMirrorRecord_msg;
+extern const pb_msgdesc_t mouthware_message_HidMirrorBatch_msg;
+extern const pb_msgdesc_t mouthware_message_ThreadStat_msg;
+extern const pb_msgdesc_t mouthware_message_ThreadStatsResponse_msg;
+extern const pb_msgdesc_t mouthware_message_TraceResponse_msg;
+extern const pb_msgdesc_t mouthware_message_MemPool_msg;
+extern const pb_msgdesc_t mouthware_message_MemSite_msg;
+extern const pb_msgdesc_t mouthware_message_MemStatsResponse_msg;
+extern const pb_msgdesc_t mouthware_message_FwUpdateStatus_msg;
+extern const pb_msgdesc_t mouthware_message_NusStreamStatus_msg;
+extern const pb_msgdesc_t mouthware_message_SensorStreamFilterResponse_msg;
+extern const pb_msgdesc_t mouthware_message_SensorCodecConfigResponse_msg;
+extern const pb_msgdesc_t mouthware_message_SensorFrameDelta_msg;
+extern const pb_msgdesc_t mouthware_message_SensorStreamRateResponse_msg;
+extern const pb_msgdesc_t mouthware_message_RelayProfileResponse_msg;
+extern const pb_msgdesc_t mouthware_message_UsbCompositionResponse_msg;
+extern const pb_msgdesc_t mouthware_message_LinkHistoryResponse_msg;
+extern const pb_msgdesc_t mouthware_message_RequestError_msg;
+extern const pb_msgdesc_t mouthware_message_PassThroughToMouthpadResponse_msg;
+extern const pb_msgdesc_t mouthware_message_PassThroughToApp_msg;
+extern const pb_msgdesc_t mouthware_message_PassThroughChunk_msg;
+extern const pb_msgdesc_t mouthware_message_PassThroughToAppBatch_msg;
+extern const pb_msgdesc_t mouthware_message_RelayToAppMessage_msg;
+
+/* Defines for backwards compatibility with code written before nanopb-0.4.0 */
+#define mouthware_message_BleConnectionStatusRead_fields &mouthware_message_BleConnectionStatusRead_msg
+#define mouthware_message_DeviceInfoRead_fields &mouthware_message_DeviceInfoRead_msg
+#define mouthware_message_ClearBondsWrite_fields &mouthware_message_ClearBondsWrite_msg
+#define mouthware_message_DfuWrite_fields &mouthware_message_DfuWrite_msg
+#define mouthware_message_ClearFirmwareCacheWrite_fields &mouthware_message_ClearFirmwareCacheWrite_msg
+#define mouthware_message_HidLatencyRead_fields &mouthware_message_HidLatencyRead_msg
+#define mouthware_message_HidConfigRead_fields &mouthware_message_HidConfigRead_msg
+#define mouthware_message_HidConfigWrite_fields &mouthware_message_HidConfigWrite_msg
+#define mouthware_message_PassThroughBatchConfigWrite_fields &mouthware_message_PassThroughBatchConfigWrite_msg
+#define mouthware_message_RelayStatsRead_fields &mouthware_message_RelayStatsRead_msg
+#define mouthware_message_ConnectionTimingRead_fields &mouthware_message_ConnectionTimingRead_msg
+#define mouthware_message_LinkTelemetrySubscribe_fields &mouthware_message_LinkTelemetrySubscribe_msg
+#define mouthware_message_RelayCapabilitiesRead_fields &mouthware_message_RelayCapabilitiesRead_msg
+#define mouthware_message_EchoRequest_fields &mouthware_message_EchoRequest_msg
+#define mouthware_message_HidMirrorConfigWrite_fields &mouthware_message_HidMirrorConfigWrite_msg
+#define mouthware_message_ThreadStatsRead_fields &mouthware_message_ThreadStatsRead_msg
+#define mouthware_message_TraceRead_fields &mouthware_message_TraceRead_msg
+#define mouthware_message_MemStatsRead_fields &mouthware_message_MemStatsRead_msg
+#define mouthware_message_FwUpdateStart_fields &mouthware_message_FwUpdateStart_msg
+#define mouthware_message_FwUpdateChunk_fields &mouthware_message_FwUpdateChunk_msg
+#define mouthware_message_FwUpdateEnd_fields &mouthware_message_FwUpdateEnd_msg
+#define mouthware_message_NusStreamControl_fields &mouthware_message_NusStreamControl_msg
+#define mouthware_message_NusStreamWrite_fields &mouthware_message_NusStreamWrite_msg
+#define mouthware_message_SensorStreamFilterWrite_fields &mouthware_message_SensorStreamFilterWrite_msg
+#define mouthware_message_SensorCodecConfigWrite_fields &mouthware_message_SensorCodecConfigWrite_msg
+#define mouthware_message_SensorStreamRateWrite_fields &mouthware_message_SensorStreamRateWrite_msg
+#define mouthware_message_RelayProfileKnobValue_fields &mouthware_message_RelayProfileKnobValue_msg
+#define mouthware_message_RelayProfileWrite_fields &mouthware_message_RelayProfileWrite_msg
+#define mouthware_message_UsbCompositionWrite_fields &mouthware_message_UsbCompositionWrite_msg
+#define mouthware_message_LinkHistoryRead_fields &mouthware_message_LinkHistoryRead_msg
+#define mouthware_message_PassThroughToMouthpad_fields &mouthware_message_PassThroughToMouthpad_msg
+#define mouthware_message_AppToRelayMessage_fields &mouthware_message_AppToRelayMessage_msg
+#define mouthware_message_BleConnectionStatusResponse_fields &mouthware_message_BleConnectionStatusResponse_msg
+#define mouthware_message_DeviceInfoResponse_fields &mouthware_message_DeviceInfoResponse_msg
+#define mouthware_message_ClearBondsResponse_fields &mouthware_message_ClearBondsResponse_msg
+#define mouthware_message_DfuResponse_fields &mouthware_message_DfuResponse_msg
+#define mouthware_message_ClearFirmwareCacheResponse_fields &mouthware_message_ClearFirmwareCacheResponse_msg
+#define mouthware_message_HidLatencyReportStats_fields &mouthware_message_HidLatencyReportStats_msg
+#define mouthware_message_HidLatencyResponse_fields &mouthware_message_HidLatencyResponse_msg
+#define mouthware_message_HidConfigResponse_fields &mouthware_message_HidConfigResponse_msg
+#define mouthware_message_PassThroughBatchConfigResponse_fields &mouthware_message_PassThroughBatchConfigResponse_msg
+#define mouthware_message_RelayStatsPathCounters_fields &mouthware_message_RelayStatsPathCounters_msg
+#define mouthware_message_RelayStatsResponse_fields &mouthware_message_RelayStatsResponse_msg
+#define mouthware_message_ConnectionTimingRecord_fields &mouthware_message_ConnectionTimingRecord_msg
+#define mouthware_message_ConnectionTimingResponse_fields &mouthware_message_ConnectionTimingResponse_msg
+#define mouthware_message_LinkTelemetry_fields &mouthware_message_LinkTelemetry_msg
+#define mouthware_message_RelayCapabilitiesResponse_fields &mouthware_message_RelayCapabilitiesResponse_msg
+#define mouthware_message_EchoResponse_fields &mouthware_message_EchoResponse_msg
+#define mouthware_message_HidMirrorConfigResponse_fields &mouthware_message_HidMirrorConfigResponse_msg
+#define mouthware_message_HidMirrorRecord_fields &mouthware_message_HidMirrorRecord_msg
+#define mouthware_message_HidMirrorBatch_fields &mouthware_message_HidMirrorBatch_msg
+#define mouthware_message_ThreadStat_fields &mouthware_message_ThreadStat_msg
+#define mouthware_message_ThreadStatsResponse_fields &mouthware_message_ThreadStatsResponse_msg
+#define mouthware_message_TraceResponse_fields &mouthware_message_TraceResponse_msg
+#define mouthware_message_MemPool_fields &mouthware_message_MemPool_msg
+#define mouthware_message_MemSite_fields &mouthware_message_MemSite_msg
+#define mouthware_message_MemStatsResponse_fields &mouthware_message_MemStatsResponse_msg
+#define mouthware_message_FwUpdateStatus_fields &mouthware_message_FwUpdateStatus_msg
+#define mouthware_message_NusStreamStatus_fields &mouthware_message_NusStreamStatus_msg
+#define mouthware_message_SensorStreamFilterResponse_fields &mouthware_message_SensorStreamFilterResponse_msg
+#define mouthware_message_SensorCodecConfigResponse_fields &mouthware_message_SensorCodecConfigResponse_msg
+#define mouthware_message_SensorFrameDelta_fields &mouthware_message_SensorFrameDelta_msg
+#define mouthware_message_SensorStreamRateResponse_fields &mouthware_message_SensorStreamRateResponse_msg
+#define mouthware_message_RelayProfileResponse_fields &mouthware_message_RelayProfileResponse_msg
+#define mouthware_message_UsbCompositionResponse_fields &mouthware_message_UsbCompositionResponse_msg
+#define mouthware_message_LinkHistoryResponse_fields &mouthware_message_LinkHistoryResponse_msg
+#define mouthware_message_RequestError_fields &mouthware_message_RequestError_msg
+#define mouthware_message_PassThroughToMouthpadResponse_fields &mouthware_message_PassThroughToMouthpadResponse_msg
+#define mouthware_message_PassThroughToApp_fields &mouthware_message_PassThroughToApp_msg
+#define mouthware_message_PassThroughChunk_fields &mouthware_message_PassThroughChunk_msg
+#define mouthware_message_PassThroughToAppBatch_fields &mouthware_message_PassThroughToAppBatch_msg
+#define mouthware_message_RelayToAppMessage_fields &mouthware_message_RelayToAppMessage_msg
+
+/* Maximum encoded size of messages (where known) */
+/* mouthware_message_PassThroughToAppBatch_size depends on runtime parameters */
+/* mouthware_message_HidMirrorBatch_size depends on runtime parameters */
+/* mouthware_message_ThreadStatsResponse_size depends on runtime parameters */
+/* mouthware_message_TraceResponse_size depends on runtime parameters */
+/* mouthware_message_LinkHistoryResponse_size depends on runtime parameters */
+/* mouthware_message_MemStatsResponse_size depends on runtime parameters */
+/* mouthware_message_DeviceInfoResponse_size depends on runtime parameters */
+/* mouthware_message_RelayToAppMessage_size depends on runtime parameters */
+#define MOUTHWARE_MESSAGE_MOUTHPADRELAY_PB_H_MAX_SIZE mouthware_message_ConnectionTimingResponse_size
+#define mouthware_message_AppToRelayMessage_size 279
+#define mouthware_message_BleConnectionStatusRead_size 2
+#define mouthware_message_BleConnectionStatusResponse_size 49
+#define mouthware_message_ClearBondsResponse_size 2
+#define mouthware_message_ClearBondsWrite_size   0
+#define mouthware_message_ClearFirmwareCacheResponse_size 2
+#define mouthware_message_ClearFirmwareCacheWrite_size 0
+#define mouthware_message_ConnectionTimingRead_size 2
+#define mouthware_message_ConnectionTimingRecord_size 64
+#define mouthware_message_ConnectionTimingResponse_size 294
+#define mouthware_message_DeviceInfoRead_size    0
+#define mouthware_message_DfuResponse_size       2
+#define mouthware_message_DfuWrite_size          0
+#define mouthware_message_EchoRequest_size       41
+#define mouthware_message_EchoResponse_size      65
+#define mouthware_message_FwUpdateChunk_size    249
+#define mouthware_message_FwUpdateEnd_size      4
+#define mouthware_message_FwUpdateStart_size    40
+#define mouthware_message_FwUpdateStatus_size   48
+#define mouthware_message_HidConfigRead_size     0
+#define mouthware_message_HidConfigResponse_size 4
+#define mouthware_message_HidConfigWrite_size    4
+#define mouthware_message_HidLatencyRead_size    0
+#define mouthware_message_HidLatencyReportStats_size 30
+#define mouthware_message_HidMirrorConfigResponse_size 2
+#define mouthware_message_HidMirrorConfigWrite_size 2
+#define mouthware_message_HidMirrorRecord_size   30
+#define mouthware_message_HidLatencyResponse_size 128
+#define mouthware_message_LinkHistoryRead_size   14
+#define mouthware_message_LinkTelemetrySubscribe_size 8
+#define mouthware_message_LinkTelemetry_size     166
+#define mouthware_message_MemPool_size          47
+#define mouthware_message_MemSite_size          35
+#define mouthware_message_MemStatsRead_size      2
+#define mouthware_message_NusStreamControl_size  2
+#define mouthware_message_NusStreamStatus_size   48
+#define mouthware_message_NusStreamWrite_size    249
+#define mouthware_message_PassThroughBatchConfigResponse_size 2
+#define mouthware_message_PassThroughBatchConfigWrite_size 2
+#define mouthware_message_PassThroughChunk_size  264
+#define mouthware_message_PassThroughToApp_size  272
+#define mouthware_message_PassThroughToMouthpadResponse_size 26
+#define mouthware_message_PassThroughToMouthpad_size 267
+#define mouthware_message_RelayCapabilitiesRead_size 0
+#define mouthware_message_RelayCapabilitiesResponse_size 67
+#define mouthware_message_RelayProfileKnobValue_size 8
+#define mouthware_message_RelayProfileResponse_size 46
+#define mouthware_message_RelayProfileWrite_size 64
+#define mouthware_message_RelayStatsPathCounters_size 30
+#define mouthware_message_RelayStatsRead_size    2
+#define mouthware_message_RelayStatsResponse_size 96
+#define mouthware_message_RequestError_size      8
+#define mouthware_message_SensorCodecConfigResponse_size 32
+#define mouthware_message_SensorCodecConfigWrite_size 8
+#define mouthware_message_SensorFrameDelta_size  255
+#define mouthware_message_SensorStreamFilterResponse_size 42
+#define mouthware_message_SensorStreamFilterWrite_size 6
+#define mouthware_message_SensorStreamRateResponse_size 20
+#define mouthware_message_SensorStreamRateWrite_size 14
+#define mouthware_message_ThreadStat_size       41
+#define mouthware_message_ThreadStatsRead_size   0
+#define mouthware_message_TraceRead_size         8
+#define mouthware_message_UsbCompositionResponse_size 6
+#define mouthware_message_UsbCompositionWrite_size 4
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "mouthpad_capture.h"
+
+static const uint8_t magic[6] = {'M', 'P', 'C', 'A', 'P', 0};
+
+#define TYPE_TO_DEVICE 0x80
+#define TYPE_CHANNEL   0x7F
+
+static void put_le(uint8_t *out, uint64_t value, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		out[i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+static uint64_t get_le(const uint8_t *in, size_t n)
+{
+	uint64_t value = 0;
+
+	for (size_t i = 0; i < n; i++) {
+		value |= (uint64_t)in[i] << (8 * i);
+	}
+
+	return value;
+}
+
+static void put_record_header(uint8_t *out, uint32_t delta_us, uint8_t type, uint16_t len)
+{
+	put_le(out, delta_us, 4);
+	out[4] = type;
+	out[5] = 0;
+	put_le(&out[6], len, 2);
+}
+
+void mouthpad_capture_start(struct mouthpad_capture_writer *w, uint8_t *out, uint64_t start_us)
+{
+	memcpy(out, magic, sizeof(magic));
+	out[6] = MOUTHPAD_CAPTURE_VERSION;
+	out[7] = 0;
+	put_le(&out[8], start_us, 8);
+	w->time_us = 0;
+}
+
+/* Whole CLOCK records needed before a record at time_us */
+static uint64_t clock_records(const struct mouthpad_capture_writer *w, uint64_t time_us)
+{
+	uint64_t delta = time_us > w->time_us ? time_us - w->time_us : 0;
+
+	return delta / UINT32_MAX;
+}
+
+size_t mouthpad_capture_record_size(const struct mouthpad_capture_writer *w, uint64_t time_us,
+				    size_t len)
+{
+	return (size_t)(clock_records(w, time_us) + 1) * MOUTHPAD_CAPTURE_RECORD_SIZE + len;
+}
+
+size_t mouthpad_capture_put(struct mouthpad_capture_writer *w, uint8_t *out, size_t size,
+			    uint64_t time_us, enum mouthpad_capture_channel channel,
+			    enum mouthpad_capture_direction direction, const uint8_t *data,
+			    size_t len)
+{
+	size_t need = mouthpad_capture_record_size(w, time_us, len);
+	uint8_t type = (uint8_t)channel |
+		       (direction == MOUTHPAD_CAPTURE_TO_DEVICE ? TYPE_TO_DEVICE : 0);
+	size_t n = 0;
+
+	if (len > MOUTHPAD_CAPTURE_MAX_PAYLOAD || need > size) {
+		return 0;
+	}
+
+	if (time_us < w->time_us) {
+		time_us = w->time_us;
+	}
+	while (time_us - w->time_us >= UINT32_MAX) {
+		put_record_header(&out[n], UINT32_MAX, MOUTHPAD_CAPTURE_CLOCK, 0);
+		n += MOUTHPAD_CAPTURE_RECORD_SIZE;
+		w->time_us += UINT32_MAX;
+	}
+
+	put_record_header(&out[n], (uint32_t)(time_us - w->time_us), type, (uint16_t)len);
+	n += MOUTHPAD_CAPTURE_RECORD_SIZE;
+	if (len) {
+		memcpy(&out[n], data, len);
+	}
+	w->time_us = time_us;
+
+	return n + len;
+}
+
+bool mouthpad_capture_open(struct mouthpad_capture_reader *r, const uint8_t *data, size_t len)
+{
+	if (len < MOUTHPAD_CAPTURE_HEADER_SIZE || memcmp(data, magic, sizeof(magic)) != 0 ||
+	    data[6] != MOUTHPAD_CAPTURE_VERSION) {
+		return false;
+	}
+
+	r->pos = data + MOUTHPAD_CAPTURE_HEADER_SIZE;
+	r->end = data + len;
+	r->start_us = get_le(&data[8], 8);
+	r->time_us = 0;
+
+	return true;
+}
+
+bool mouthpad_capture_next(struct mouthpad_capture_reader *r,
+			   struct mouthpad_capture_record *record)
+{
+	while ((size_t)(r->end - r->pos) >= MOUTHPAD_CAPTURE_RECORD_SIZE) {
+		uint16_t len = (uint16_t)get_le(&r->pos[6], 2);
+		uint8_t type = r->pos[4];
+
+		if ((size_t)(r->end - r->pos) < MOUTHPAD_CAPTURE_RECORD_SIZE + (size_t)len) {
+			break;
+		}
+
+		r->time_us += get_le(r->pos, 4);
+		r->pos += MOUTHPAD_CAPTURE_RECORD_SIZE + len;
+
+		if ((type & TYPE_CHANNEL) == MOUTHPAD_CAPTURE_CLOCK) {
+			continue;
+		}
+
+		record->time_us = r->time_us;
+		record->channel = (enum mouthpad_capture_channel)(type & TYPE_CHANNEL);
+		record->direction = (type & TYPE_TO_DEVICE) ? MOUTHPAD_CAPTURE_TO_DEVICE
+							    : MOUTHPAD_CAPTURE_TO_HOST;
+		record->data = r->pos - len;
+		record->len = len;
+		return true;
+	}
+
+	/* End of data, or a record cut off by a writer that stopped */
+	r->pos = r->end;
+	return false;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Session capture format for relay traffic
+ *
+ * Append-only, little-endian, no index: a writer only ever adds bytes at
+ * the end, and a file cut short by a crash reads back up to its last whole
+ * record.
+ *
+ *   file header   "MPCAP\0" version(1) flags(1) start_us(8)
+ *   record        delta_us(4) type(1) reserved(1) len(2) payload(len)
+ *
+ * start_us is wall-clock time at the start of the session, in microseconds
+ * since the Unix epoch. delta_us is the time since the previous record (or
+ * the start); a gap longer than a u32 is bridged with empty CLOCK records.
+ * type is the channel, with the top bit set for host->relay traffic.
+ * Payloads are what the relay's code paths take, without CDC0 framing:
+ * - CONTROL: an AppToRelayMessage or RelayToAppMessage
+ * - NUS: MouthPad notification or write bytes
+ * - HID: report ID, then the report
+ *
+ * Records are not aligned, so the reader can walk a memory-mapped file and
+ * hand out pointers into it without copying.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef MOUTHPAD_CAPTURE_H_
+#define MOUTHPAD_CAPTURE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOUTHPAD_CAPTURE_VERSION     1
+#define MOUTHPAD_CAPTURE_HEADER_SIZE 16
+#define MOUTHPAD_CAPTURE_RECORD_SIZE 8 /* Record header, before the payload */
+#define MOUTHPAD_CAPTURE_MAX_PAYLOAD UINT16_MAX
+
+enum mouthpad_capture_channel {
+	MOUTHPAD_CAPTURE_CONTROL = 0,
+	MOUTHPAD_CAPTURE_NUS = 1,
+	MOUTHPAD_CAPTURE_HID = 2,
+	MOUTHPAD_CAPTURE_CLOCK = 3, /* Empty; only moves time on */
+};
+
+enum mouthpad_capture_direction {
+	MOUTHPAD_CAPTURE_TO_HOST = 0,   /* Relay->host: notifications, responses */
+	MOUTHPAD_CAPTURE_TO_DEVICE = 1, /* Host->relay: writes, requests */
+};
+
+struct mouthpad_capture_record {
+	uint64_t time_us; /* Since the session start */
+	enum mouthpad_capture_channel channel;
+	enum mouthpad_capture_direction direction;
+	const uint8_t *data;
+	uint16_t len;
+};
+
+/* Time of the last record written, for the next delta */
+struct mouthpad_capture_writer {
+	uint64_t time_us;
+};
+
+struct mouthpad_capture_reader {
+	const uint8_t *pos;
+	const uint8_t *end;
+	uint64_t start_us;
+	uint64_t time_us;
+};
+
+/**
+ * @brief Start a capture: write the file header and reset the writer
+ *
+ * @param out MOUTHPAD_CAPTURE_HEADER_SIZE bytes
+ */
+void mouthpad_capture_start(struct mouthpad_capture_writer *w, uint8_t *out, uint64_t start_us);
+
+/**
+ * @brief Bytes mouthpad_capture_put() needs for a record
+ */
+size_t mouthpad_capture_record_size(const struct mouthpad_capture_writer *w, uint64_t time_us,
+				    size_t len);
+
+/**
+ * @brief Append one record, with CLOCK records first if the gap needs them
+ *
+ * A time earlier than the last record's is written as no gap.
+ *
+ * @param time_us Since the session start
+ * @return Bytes written, or 0 if they do not fit size or len is too long
+ */
+size_t mouthpad_capture_put(struct mouthpad_capture_writer *w, uint8_t *out, size_t size,
+			    uint64_t time_us, enum mouthpad_capture_channel channel,
+			    enum mouthpad_capture_direction direction, const uint8_t *data,
+			    size_t len);
+
+/**
+ * @brief Check the file header and point the reader at the first record
+ *
+ * @return false if data is not a capture this code can read
+ */
+bool mouthpad_capture_open(struct mouthpad_capture_reader *r, const uint8_t *data, size_t len);
+
+/**
+ * @brief Next record, CLOCK records skipped
+ *
+ * record->data points into the capture. A truncated last record ends the
+ * capture like the end of the data does.
+ *
+ * @return false at the end
+ */
+bool mouthpad_capture_next(struct mouthpad_capture_reader *r,
+			   struct mouthpad_capture_record *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_CAPTURE_H_ */
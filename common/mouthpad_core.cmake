@@ -0,0 +1,78 @@
+#
+# Copyright (c) 2025 Robert Dale Smith
+# Copyright (c) 2025 Augmental Tech
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# mouthpad_core: the platform-neutral relay code in common/, listed once for
+# the nRF app, the ESP main component and the host bench. Include this file
+# and add MOUTHPAD_CORE_SOURCES, MOUTHPAD_CORE_INCLUDE_DIRS and
+# MOUTHPAD_CORE_DEFINITIONS to the target. The generated MouthpadRelay code
+# and nanopb live in common/mouthpad-proto and are part of the list.
+#
+# Nothing here may include Zephyr or ESP-IDF headers. Platform services
+# (clocks, queues, USB and NUS writes) are passed in by the caller as
+# function pointers or read back through the platform's own modules, so
+# every file also builds on the host.
+#
+
+set(MOUTHPAD_CORE_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+set(MOUTHPAD_CORE_SOURCES
+  ${MOUTHPAD_CORE_DIR}/bond_table.c
+  ${MOUTHPAD_CORE_DIR}/connection_timing.c
+  ${MOUTHPAD_CORE_DIR}/fault_inject.c
+  ${MOUTHPAD_CORE_DIR}/fw_update.c
+  ${MOUTHPAD_CORE_DIR}/hid_idle.c
+  ${MOUTHPAD_CORE_DIR}/hid_mirror.c
+  ${MOUTHPAD_CORE_DIR}/hid_ring.c
+  ${MOUTHPAD_CORE_DIR}/link_guard.c
+  ${MOUTHPAD_CORE_DIR}/link_history.c
+  ${MOUTHPAD_CORE_DIR}/link_state.c
+  ${MOUTHPAD_CORE_DIR}/link_telemetry.c
+  ${MOUTHPAD_CORE_DIR}/mem_stats.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad_capture.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad_crc16.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad_frame.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad_pass_through.c
+  ${MOUTHPAD_CORE_DIR}/nus_stream.c
+  ${MOUTHPAD_CORE_DIR}/pairing_timing.c
+  ${MOUTHPAD_CORE_DIR}/pass_through_ack.c
+  ${MOUTHPAD_CORE_DIR}/relay_dispatch.c
+  ${MOUTHPAD_CORE_DIR}/scan_schedule.c
+  ${MOUTHPAD_CORE_DIR}/sensor_codec.c
+  ${MOUTHPAD_CORE_DIR}/sensor_stream.c
+  ${MOUTHPAD_CORE_DIR}/stall_watch.c
+  ${MOUTHPAD_CORE_DIR}/thread_stats.c
+  ${MOUTHPAD_CORE_DIR}/time_base.c
+  ${MOUTHPAD_CORE_DIR}/trace_ring.c
+  ${MOUTHPAD_CORE_DIR}/tuning_profile.c
+  ${MOUTHPAD_CORE_DIR}/tx_power.c
+  ${MOUTHPAD_CORE_DIR}/usb_composition.c
+  ${MOUTHPAD_CORE_DIR}/usb_phase.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad-proto/src/C/MouthpadRelay.pb.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad-proto/nanopb/pb_common.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad-proto/nanopb/pb_decode.c
+  ${MOUTHPAD_CORE_DIR}/mouthpad-proto/nanopb/pb_encode.c
+)
+
+set(MOUTHPAD_CORE_INCLUDE_DIRS
+  ${MOUTHPAD_CORE_DIR}
+  ${MOUTHPAD_CORE_DIR}/mouthpad-proto/src/C
+  ${MOUTHPAD_CORE_DIR}/mouthpad-proto/nanopb
+)
+
+# nanopb profile. These change nanopb's struct layouts, so every file that
+# includes pb.h must be built with the same set.
+# - PB_BUFFER_ONLY: every stream is a memory buffer, so the read and write
+#   calls inline to a memcpy instead of going through a function pointer
+# - PB_FIELD_32BIT stays off; no tag or field size reaches 65536
+# - PB_ENABLE_MALLOC is off in pb.h; no field is a pointer
+# Set MOUTHPAD_PROTO_NO_ERRMSG before including this file to drop the error
+# strings as well; PB_GET_ERROR() then reads "(errmsg disabled)".
+set(MOUTHPAD_CORE_DEFINITIONS
+  PB_BUFFER_ONLY=1
+)
+if(MOUTHPAD_PROTO_NO_ERRMSG)
+  list(APPEND MOUTHPAD_CORE_DEFINITIONS PB_NO_ERRMSG=1)
+endif()
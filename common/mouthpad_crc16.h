@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief CRC-16/CCITT-FALSE used by the MouthPad relay framing
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection, no final XOR.
+ * Shared by the nRF and ESP firmwares; the ESP32-S3 build uses the ROM
+ * CRC routine, other targets a slicing-by-4 table.
+ */
+
+#ifndef MOUTHPAD_CRC16_H_
+#define MOUTHPAD_CRC16_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOUTHPAD_CRC16_INIT 0xFFFF
+
+/**
+ * @brief Feed more bytes into a running CRC
+ *
+ * Start from MOUTHPAD_CRC16_INIT; the value after the last chunk is the
+ * CRC of the concatenated data.
+ */
+uint16_t mouthpad_crc16_update(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief CRC of a complete buffer
+ */
+static inline uint16_t mouthpad_crc16(const uint8_t *data, size_t len)
+{
+	return mouthpad_crc16_update(MOUTHPAD_CRC16_INIT, data, len);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_CRC16_H_ */
@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "mouthpad_frame.h"
+#include "mouthpad_crc16.h"
+
+#define MIN_SIZE(a, b) ((a) < (b) ? (a) : (b))
+
+enum deframer_state {
+	STATE_MAGIC1,
+	STATE_MAGIC2,
+	STATE_LENGTH_HIGH,
+	STATE_LENGTH_LOW,
+	STATE_PAYLOAD,
+	STATE_CRC_HIGH,
+	STATE_CRC_LOW,
+	STATE_COBS_CODE,
+	STATE_COBS_DATA,
+	STATE_COBS_SKIP,
+};
+
+/* Code byte of a full COBS block: 254 data bytes and no zero after them */
+#define COBS_BLOCK_FULL 0xFF
+
+void mouthpad_deframer_init(struct mouthpad_deframer *d, mouthpad_deframer_frame_cb_t on_frame,
+			    mouthpad_deframer_error_cb_t on_error, void *user_data)
+{
+	memset(d, 0, sizeof(*d));
+	d->on_frame = on_frame;
+	d->on_error = on_error;
+	d->user_data = user_data;
+	mouthpad_deframer_reset(d);
+}
+
+void mouthpad_deframer_reset(struct mouthpad_deframer *d)
+{
+	d->state = STATE_MAGIC1;
+	d->length = 0;
+	d->pos = 0;
+}
+
+static void frame_dropped(struct mouthpad_deframer *d, enum mouthpad_deframer_error err,
+			  uint16_t value)
+{
+	if (err == MOUTHPAD_DEFRAMER_ERR_LENGTH) {
+		d->length_errors++;
+	} else {
+		d->crc_errors++;
+	}
+
+	if (d->on_error) {
+		d->on_error(err, value, d->user_data);
+	}
+}
+
+/* A COBS block comes next: restart the frame */
+static void cobs_start(struct mouthpad_deframer *d)
+{
+	d->state = STATE_COBS_CODE;
+	d->cobs_code = 0;
+	d->pos = 0;
+}
+
+/* Closing delimiter of a COBS frame */
+static void cobs_end(struct mouthpad_deframer *d)
+{
+	uint16_t len;
+	uint16_t rx_crc;
+
+	if (d->pos == 0) {
+		/* Back-to-back delimiters: the opening one of the next frame */
+		cobs_start(d);
+		return;
+	}
+
+	d->state = STATE_MAGIC1;
+	if (d->pos < MOUTHPAD_FRAME_CRC_SIZE) {
+		frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_CRC, 0);
+		return;
+	}
+
+	len = d->pos - MOUTHPAD_FRAME_CRC_SIZE;
+	rx_crc = ((uint16_t)d->payload[len] << 8) | d->payload[len + 1];
+	if (rx_crc != mouthpad_crc16(d->payload, len)) {
+		frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_CRC, rx_crc);
+		return;
+	}
+
+	d->frames++;
+	d->cobs_frames++;
+	d->cobs = 1;
+	d->on_frame(d->payload, len, d->user_data);
+}
+
+void mouthpad_deframer_feed(struct mouthpad_deframer *d, const uint8_t *data, size_t len)
+{
+	const uint8_t *p = data;
+	const uint8_t *end = data + len;
+
+	while (p < end) {
+		switch (d->state) {
+		case STATE_MAGIC1:
+			while (*p != MOUTHPAD_FRAME_MAGIC1 && *p != MOUTHPAD_FRAME_COBS_DELIM) {
+				if (++p == end) {
+					return;
+				}
+			}
+			if (*p++ == MOUTHPAD_FRAME_MAGIC1) {
+				d->state = STATE_MAGIC2;
+			} else {
+				cobs_start(d);
+			}
+			break;
+
+		case STATE_MAGIC2:
+			if (*p == MOUTHPAD_FRAME_MAGIC2) {
+				d->state = STATE_LENGTH_HIGH;
+				p++;
+			} else if (*p == MOUTHPAD_FRAME_MAGIC1) {
+				/* 0xAA 0xAA 0x55 still starts a frame at the second 0xAA */
+				p++;
+			} else {
+				/* Looked at again, in case it opens a COBS frame */
+				d->state = STATE_MAGIC1;
+			}
+			break;
+
+		case STATE_LENGTH_HIGH:
+			d->length = (uint16_t)*p++ << 8;
+			d->state = STATE_LENGTH_LOW;
+			break;
+
+		case STATE_LENGTH_LOW:
+			d->length |= *p++;
+			if (d->length > MOUTHPAD_FRAME_MAX_PAYLOAD) {
+				d->state = STATE_MAGIC1;
+				frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_LENGTH, d->length);
+				break;
+			}
+			d->pos = 0;
+			d->crc = MOUTHPAD_CRC16_INIT;
+			/* An all-default message encodes to nothing */
+			d->state = d->length ? STATE_PAYLOAD : STATE_CRC_HIGH;
+			break;
+
+		case STATE_PAYLOAD: {
+			size_t n = d->length - d->pos;
+
+			/* Whole payload and CRC in this chunk: hand out a span of the
+			 * caller's buffer instead of copying it.
+			 */
+			if (d->pos == 0 && (size_t)(end - p) >= n + MOUTHPAD_FRAME_CRC_SIZE) {
+				uint16_t rx_crc = ((uint16_t)p[n] << 8) | p[n + 1];
+
+				d->state = STATE_MAGIC1;
+				if (rx_crc != mouthpad_crc16_update(d->crc, p, n)) {
+					frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_CRC, rx_crc);
+				} else {
+					d->frames++;
+					d->cobs = 0;
+					d->on_frame(p, d->length, d->user_data);
+				}
+				p += n + MOUTHPAD_FRAME_CRC_SIZE;
+				break;
+			}
+
+			if (n > (size_t)(end - p)) {
+				n = end - p;
+			}
+			memcpy(&d->payload[d->pos], p, n);
+			d->crc = mouthpad_crc16_update(d->crc, p, n);
+			d->pos += n;
+			p += n;
+			if (d->pos == d->length) {
+				d->state = STATE_CRC_HIGH;
+			}
+			break;
+		}
+
+		case STATE_CRC_HIGH:
+			d->rx_crc = (uint16_t)*p++ << 8;
+			d->state = STATE_CRC_LOW;
+			break;
+
+		case STATE_CRC_LOW:
+			d->rx_crc |= *p++;
+			d->state = STATE_MAGIC1;
+			if (d->rx_crc != d->crc) {
+				frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_CRC, d->rx_crc);
+				break;
+			}
+			d->frames++;
+			d->cobs = 0;
+			d->on_frame(d->payload, d->length, d->user_data);
+			break;
+
+		case STATE_COBS_CODE:
+			if (*p == MOUTHPAD_FRAME_COBS_DELIM) {
+				p++;
+				cobs_end(d);
+				break;
+			}
+			/* Every block but a full one stands for the data and a zero;
+			 * the zero is only written once another block follows
+			 */
+			if (d->cobs_code != 0 && d->cobs_code != COBS_BLOCK_FULL) {
+				if (d->pos == sizeof(d->payload)) {
+					d->state = STATE_COBS_SKIP;
+					frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_LENGTH, d->pos);
+					break;
+				}
+				d->payload[d->pos++] = 0;
+			}
+			d->cobs_code = *p++;
+			d->length = d->cobs_code - 1;
+			if (d->length) {
+				d->state = STATE_COBS_DATA;
+			}
+			break;
+
+		case STATE_COBS_DATA: {
+			size_t n = MIN_SIZE(d->length, (size_t)(end - p));
+			const uint8_t *zero = memchr(p, MOUTHPAD_FRAME_COBS_DELIM, n);
+
+			if (zero) {
+				n = zero - p;
+			}
+			if (d->pos + n > sizeof(d->payload)) {
+				d->state = STATE_COBS_SKIP;
+				frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_LENGTH, d->pos + n);
+				break;
+			}
+			memcpy(&d->payload[d->pos], p, n);
+			d->pos += n;
+			d->length -= n;
+			p += n;
+			if (zero) {
+				/* Cut short; the zero may open the next frame */
+				p++;
+				frame_dropped(d, MOUTHPAD_DEFRAMER_ERR_CRC, 0);
+				cobs_start(d);
+			} else if (d->length == 0) {
+				d->state = STATE_COBS_CODE;
+			}
+			break;
+		}
+
+		case STATE_COBS_SKIP: {
+			const uint8_t *zero = memchr(p, MOUTHPAD_FRAME_COBS_DELIM, end - p);
+
+			if (!zero) {
+				return;
+			}
+			p = zero + 1;
+			d->state = STATE_MAGIC1;
+			break;
+		}
+
+		default:
+			mouthpad_deframer_reset(d);
+			break;
+		}
+	}
+}
+
+size_t mouthpad_deframer_pending(const struct mouthpad_deframer *d)
+{
+	switch (d->state) {
+	case STATE_MAGIC2:
+		return 1;
+	case STATE_LENGTH_HIGH:
+		return 2;
+	case STATE_LENGTH_LOW:
+		return 3;
+	case STATE_PAYLOAD:
+		return MOUTHPAD_FRAME_HEADER_SIZE + d->pos;
+	case STATE_CRC_HIGH:
+		return MOUTHPAD_FRAME_HEADER_SIZE + d->length;
+	case STATE_CRC_LOW:
+		return MOUTHPAD_FRAME_HEADER_SIZE + d->length + 1;
+	case STATE_COBS_CODE:
+	case STATE_COBS_DATA:
+		return 1 + d->pos;
+	default:
+		return 0;
+	}
+}
+
+/* Close the open block and open the next one after it */
+static void cobs_close_block(struct mouthpad_cobs_encoder *e)
+{
+	e->out[e->code_at] = (uint8_t)(e->len - e->code_at);
+	e->code_at = e->len++;
+}
+
+static void cobs_put(struct mouthpad_cobs_encoder *e, const uint8_t *data, size_t len)
+{
+	const uint8_t *end = data + len;
+
+	while (data < end) {
+		/* Copy up to the next zero or the end of a full block at once */
+		size_t room = COBS_BLOCK_FULL - (e->len - e->code_at);
+		size_t n = MIN_SIZE(room, (size_t)(end - data));
+		const uint8_t *zero = memchr(data, 0, n);
+
+		if (zero) {
+			n = zero - data;
+		}
+		memcpy(&e->out[e->len], data, n);
+		e->len += n;
+		data += n;
+
+		if (zero) {
+			data++;
+			cobs_close_block(e);
+		} else if (e->len - e->code_at == COBS_BLOCK_FULL) {
+			cobs_close_block(e);
+		}
+	}
+}
+
+void mouthpad_cobs_begin(struct mouthpad_cobs_encoder *e, uint8_t *out)
+{
+	e->out = out;
+	out[0] = MOUTHPAD_FRAME_COBS_DELIM;
+	e->code_at = 1;
+	e->len = 2;
+	e->crc = MOUTHPAD_CRC16_INIT;
+}
+
+void mouthpad_cobs_put(struct mouthpad_cobs_encoder *e, const uint8_t *data, size_t len)
+{
+	e->crc = mouthpad_crc16_update(e->crc, data, len);
+	cobs_put(e, data, len);
+}
+
+size_t mouthpad_cobs_end(struct mouthpad_cobs_encoder *e)
+{
+	uint8_t crc[MOUTHPAD_FRAME_CRC_SIZE] = {e->crc >> 8, e->crc & 0xFF};
+
+	cobs_put(e, crc, sizeof(crc));
+	e->out[e->code_at] = (uint8_t)(e->len - e->code_at);
+	e->out[e->len++] = MOUTHPAD_FRAME_COBS_DELIM;
+	return e->len;
+}
+
+size_t mouthpad_frame_cobs(uint8_t *out, const uint8_t *payload, size_t len)
+{
+	struct mouthpad_cobs_encoder e;
+
+	mouthpad_cobs_begin(&e, out);
+	mouthpad_cobs_put(&e, payload, len);
+	return mouthpad_cobs_end(&e);
+}
+
+bool mouthpad_channel_parse(const uint8_t *payload, size_t len,
+			    struct mouthpad_channel_frame *out)
+{
+	if (len < MOUTHPAD_CHANNEL_HEADER_SIZE || payload[0] != MOUTHPAD_CHANNEL_MARK) {
+		return false;
+	}
+
+	out->channel = payload[1];
+	out->device_index = payload[2];
+	out->data = &payload[MOUTHPAD_CHANNEL_HEADER_SIZE];
+	out->len = len - MOUTHPAD_CHANNEL_HEADER_SIZE;
+	return true;
+}
+
+size_t mouthpad_channel_header(uint8_t *out, enum mouthpad_channel channel,
+			       uint8_t device_index)
+{
+	out[0] = MOUTHPAD_CHANNEL_MARK;
+	out[1] = (uint8_t)channel;
+	out[2] = device_index;
+	return MOUTHPAD_CHANNEL_HEADER_SIZE;
+}
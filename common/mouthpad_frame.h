@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief MouthPad relay framing: [0xAA 0x55][len_h len_l][payload][crc_h crc_l]
+ *
+ * The length and CRC-16/CCITT (see mouthpad_crc16.h) are big-endian and
+ * cover the payload only. The deframer consumes whole RX chunks: it skips
+ * noise between frames, copies payload runs in one memcpy and updates the
+ * CRC as they arrive, so a frame is complete as soon as its last byte is
+ * fed. A frame that arrives entirely within one chunk is not copied at all.
+ *
+ * Relays with RELAY_FEATURE_COBS_FRAMING also take COBS frames:
+ *
+ *   [0x00][COBS(payload crc_h crc_l)][0x00]
+ *
+ * No length is sent; the zero bytes delimit the frame, so a corrupted
+ * frame costs one pass over its bytes and nothing after the next zero.
+ * The deframer tells the two apart by the first byte and takes either at
+ * any time; a relay answers in the framing of the last frame it received.
+ *
+ * A payload is normally one protobuf message. Relays with
+ * RELAY_FEATURE_RAW_CHANNELS also take payloads behind a channel header:
+ *
+ *   [0x00][channel][device_index][data...]
+ *
+ *   MOUTHPAD_CHANNEL_CONTROL  data is an AppToRelayMessage; device_index 0
+ *   MOUTHPAD_CHANNEL_NUS      data is a MouthPad NUS packet as written or
+ *                             notified, whole; device_index as in
+ *                             PassThroughToApp
+ *
+ * Field number 0 is invalid in protobuf, so no message starts with 0x00:
+ * the first byte tells the two apart, and a decoder that does not know
+ * channels rejects the payload instead of misreading it. A host that sends
+ * channel payloads gets MouthPad notifications back on MOUTHPAD_CHANNEL_NUS
+ * with no protobuf around them; replies to control messages stay bare
+ * RelayToAppMessages. As with COBS, the relay follows the last frame it
+ * received.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef MOUTHPAD_FRAME_H_
+#define MOUTHPAD_FRAME_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOUTHPAD_FRAME_MAGIC1      0xAA
+#define MOUTHPAD_FRAME_MAGIC2      0x55
+#define MOUTHPAD_FRAME_HEADER_SIZE 4 /* 2 magic bytes + 2 length bytes */
+#define MOUTHPAD_FRAME_CRC_SIZE    2
+#define MOUTHPAD_FRAME_OVERHEAD    (MOUTHPAD_FRAME_HEADER_SIZE + MOUTHPAD_FRAME_CRC_SIZE)
+
+#define MOUTHPAD_FRAME_COBS_DELIM 0x00
+
+#define MOUTHPAD_CHANNEL_MARK        0x00
+#define MOUTHPAD_CHANNEL_HEADER_SIZE 3 /* Mark, channel and device index */
+
+enum mouthpad_channel {
+	MOUTHPAD_CHANNEL_CONTROL = 0,
+	MOUTHPAD_CHANNEL_NUS = 1,
+};
+
+/* A payload split by mouthpad_channel_parse() */
+struct mouthpad_channel_frame {
+	uint8_t channel;      /* enum mouthpad_channel, or one this side does not know */
+	uint8_t device_index;
+	const uint8_t *data;  /* Points into the payload */
+	size_t len;
+};
+
+/* Largest COBS frame for a payload of len bytes: both delimiters, and one
+ * code byte per 254 bytes of payload and CRC
+ */
+#define MOUTHPAD_FRAME_COBS_SIZE(len)                                                              \
+	((len) + MOUTHPAD_FRAME_CRC_SIZE + ((len) + MOUTHPAD_FRAME_CRC_SIZE) / 254 + 3)
+
+/* Largest payload the deframer accepts; longer frames are dropped */
+#ifndef MOUTHPAD_FRAME_MAX_PAYLOAD
+#define MOUTHPAD_FRAME_MAX_PAYLOAD 512
+#endif
+
+enum mouthpad_deframer_error {
+	MOUTHPAD_DEFRAMER_ERR_LENGTH, /* Length field exceeds MOUTHPAD_FRAME_MAX_PAYLOAD */
+	MOUTHPAD_DEFRAMER_ERR_CRC,    /* Received CRC does not match the payload */
+};
+
+/* Called with the payload of every frame whose CRC matched */
+typedef void (*mouthpad_deframer_frame_cb_t)(const uint8_t *payload, uint16_t len,
+					     void *user_data);
+
+/* Called when a frame is dropped; value is the length or received CRC */
+typedef void (*mouthpad_deframer_error_cb_t)(enum mouthpad_deframer_error err, uint16_t value,
+					     void *user_data);
+
+struct mouthpad_deframer {
+	uint8_t state;
+	uint8_t cobs_code; /* Code byte of the COBS block being decoded */
+	uint16_t length;   /* Payload length, or bytes left in the COBS block */
+	uint16_t pos;
+	uint16_t crc;
+	uint16_t rx_crc;
+	uint8_t payload[MOUTHPAD_FRAME_MAX_PAYLOAD + MOUTHPAD_FRAME_CRC_SIZE];
+	uint8_t cobs; /* Nonzero if the last frame delivered was COBS */
+
+	mouthpad_deframer_frame_cb_t on_frame;
+	mouthpad_deframer_error_cb_t on_error;
+	void *user_data;
+
+	/* Statistics */
+	uint32_t frames;
+	uint32_t cobs_frames; /* Of frames */
+	uint32_t length_errors;
+	uint32_t crc_errors;
+};
+
+/* COBS frame being written into a flat buffer, see mouthpad_cobs_begin() */
+struct mouthpad_cobs_encoder {
+	uint8_t *out;
+	size_t len;     /* Bytes written so far, the open code byte included */
+	size_t code_at; /* Offset of the open block's code byte */
+	uint16_t crc;
+};
+
+/**
+ * @brief Initialize a deframer
+ *
+ * @param on_error Optional, may be NULL
+ */
+void mouthpad_deframer_init(struct mouthpad_deframer *d, mouthpad_deframer_frame_cb_t on_frame,
+			    mouthpad_deframer_error_cb_t on_error, void *user_data);
+
+/**
+ * @brief Drop any partial frame and search for the next start marker
+ */
+void mouthpad_deframer_reset(struct mouthpad_deframer *d);
+
+/**
+ * @brief Feed a chunk of received bytes
+ *
+ * Callbacks run synchronously, once per completed or dropped frame. The
+ * payload pointer is only valid until the callback returns; it points into
+ * data when the whole frame was contained in this chunk, otherwise into
+ * the deframer's own payload buffer.
+ */
+void mouthpad_deframer_feed(struct mouthpad_deframer *d, const uint8_t *data, size_t len);
+
+/**
+ * @brief Bytes of an unfinished frame taken so far, 0 between frames
+ */
+size_t mouthpad_deframer_pending(const struct mouthpad_deframer *d);
+
+/**
+ * @brief Split a payload that starts with a channel header
+ *
+ * @return false if the payload is a protobuf message, or too short for
+ *         a header
+ */
+bool mouthpad_channel_parse(const uint8_t *payload, size_t len,
+			    struct mouthpad_channel_frame *out);
+
+/**
+ * @brief Write a channel header
+ *
+ * @param out At least MOUTHPAD_CHANNEL_HEADER_SIZE bytes
+ * @return MOUTHPAD_CHANNEL_HEADER_SIZE
+ */
+size_t mouthpad_channel_header(uint8_t *out, enum mouthpad_channel channel,
+			       uint8_t device_index);
+
+/**
+ * @brief Start a COBS frame
+ *
+ * @param out Room for MOUTHPAD_FRAME_COBS_SIZE() of the whole payload
+ */
+void mouthpad_cobs_begin(struct mouthpad_cobs_encoder *e, uint8_t *out);
+
+/**
+ * @brief Append payload bytes; may be called any number of times
+ */
+void mouthpad_cobs_put(struct mouthpad_cobs_encoder *e, const uint8_t *data, size_t len);
+
+/**
+ * @brief Append the CRC and the closing delimiter
+ *
+ * @return Length of the frame in out
+ */
+size_t mouthpad_cobs_end(struct mouthpad_cobs_encoder *e);
+
+/**
+ * @brief Write one whole COBS frame
+ *
+ * @param out Room for MOUTHPAD_FRAME_COBS_SIZE(len)
+ *
+ * @return Length of the frame in out
+ */
+size_t mouthpad_frame_cobs(uint8_t *out, const uint8_t *payload, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_FRAME_H_ */
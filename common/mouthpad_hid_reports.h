@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief MouthPad USB HID report table shared by the nRF and ESP firmwares
+ *
+ * Single source for the USB report descriptor, the input report IDs and
+ * sizes, their neutral (released) state and the legacy consumer-control
+ * translation. Everything here is a macro or static inline so each build
+ * unrolls the per-report work at compile time; no Zephyr or ESP-IDF
+ * headers may be pulled in.
+ */
+
+#ifndef MOUTHPAD_HID_REPORTS_H_
+#define MOUTHPAD_HID_REPORTS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Input reports, one X(name, id, size) entry each. size is the USB payload
+ * length without the report ID byte. The neutral state of every report is
+ * all zeros (no buttons, no motion, no usage, no keys). Expand with a local
+ * X() to unroll per-report code, e.g. release-all.
+ *
+ * - MOUSE_BUTTONS: buttons (5 bits) + padding, wheel, AC pan
+ * - MOUSE_MOTION:  X (12 bits) + Y (12 bits), signed, +/-2047
+ * - CONSUMER:      16-bit consumer usage selector
+ * - KEYBOARD:      modifiers, reserved, 6 key codes
+ */
+#define MOUTHPAD_HID_REPORTS(X) \
+	X(MOUSE_BUTTONS, 1, 3)  \
+	X(MOUSE_MOTION,  2, 3)  \
+	X(CONSUMER,      3, 2)  \
+	X(KEYBOARD,      4, 8)
+
+enum mouthpad_hid_report_id {
+#define MOUTHPAD_HID_REPORT_ID_ENUM(name, id, size) MOUTHPAD_HID_REPORT_ID_##name = (id),
+	MOUTHPAD_HID_REPORTS(MOUTHPAD_HID_REPORT_ID_ENUM)
+#undef MOUTHPAD_HID_REPORT_ID_ENUM
+};
+
+enum mouthpad_hid_report_size {
+#define MOUTHPAD_HID_REPORT_SIZE_ENUM(name, id, size) MOUTHPAD_HID_REPORT_SIZE_##name = (size),
+	MOUTHPAD_HID_REPORTS(MOUTHPAD_HID_REPORT_SIZE_ENUM)
+#undef MOUTHPAD_HID_REPORT_SIZE_ENUM
+};
+
+/* Report IDs are contiguous starting at 1 */
+#define MOUTHPAD_HID_REPORT_ID_MAX   MOUTHPAD_HID_REPORT_ID_KEYBOARD
+
+/* Largest input report payload, without the report ID byte */
+#define MOUTHPAD_HID_REPORT_SIZE_MAX                                              \
+	sizeof(union {                                                            \
+		MOUTHPAD_HID_REPORTS(MOUTHPAD_HID_REPORT_SIZE_MEMBER)             \
+	})
+#define MOUTHPAD_HID_REPORT_SIZE_MEMBER(name, id, size) uint8_t name[size];
+
+/**
+ * @brief USB payload size for a report ID
+ *
+ * @return Payload length without the ID byte, or 0 for an unknown ID
+ */
+static inline uint8_t mouthpad_hid_report_size(uint8_t report_id)
+{
+	switch (report_id) {
+#define MOUTHPAD_HID_REPORT_SIZE_CASE(name, id, size) case (id): return (size);
+	MOUTHPAD_HID_REPORTS(MOUTHPAD_HID_REPORT_SIZE_CASE)
+#undef MOUTHPAD_HID_REPORT_SIZE_CASE
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Check that a payload fits the USB descriptor for its report ID
+ *
+ * Shorter payloads are accepted; callers zero-fill the remainder.
+ */
+static inline bool mouthpad_hid_report_fits(uint8_t report_id, size_t len)
+{
+	uint8_t size = mouthpad_hid_report_size(report_id);
+
+	return size != 0 && len <= size;
+}
+
+/**
+ * Scheduling on the shared IN endpoint. Motion (Report ID 2) is
+ * latest-value: deltas are summed while the endpoint is busy and never
+ * queue up. Every other report is a transition, sent once, in arrival
+ * order, and ahead of pending motion. Only button reports care where the
+ * pointer is, so motion that arrived before a button report goes out
+ * first; consumer and keyboard reports overtake it.
+ */
+static inline bool mouthpad_hid_report_after_motion(uint8_t report_id)
+{
+	return report_id == MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS;
+}
+
+/**
+ * @brief Payload bytes of a report that hold state rather than a delta
+ *
+ * Bit n is payload byte n. Buttons, usages and keys are state: an equal
+ * report tells the host nothing new. Motion, wheel and pan are relative,
+ * so a report with them zero is redundant and a repeat carries zeros. The
+ * combined mouse report's only state is also its buttons, in byte 0.
+ */
+static inline uint8_t mouthpad_hid_report_state_mask(uint8_t report_id)
+{
+	switch (report_id) {
+	case MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS:
+		return 0x01;
+	case MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION:
+		return 0x00;
+	default:
+		return 0xFF;
+	}
+}
+
+/**
+ * Output reports, host to MouthPad, one X(name, id, size) entry each. Only
+ * the output report build option on each firmware puts them in the USB
+ * descriptor. The relay writes them to the MouthPad's HOGP output report
+ * of the same ID.
+ *
+ * - KEYBOARD_LEDS: Num/Caps/Scroll Lock, Compose, Kana (5 bits) + padding
+ */
+#define MOUTHPAD_HID_OUTPUT_REPORTS(X) \
+	X(KEYBOARD_LEDS, 4, 1)
+
+/* Largest output report payload, without the report ID byte */
+#define MOUTHPAD_HID_OUTPUT_SIZE_MAX 1
+
+/**
+ * @brief USB payload size for an output report ID
+ *
+ * @return Payload length without the ID byte, or 0 if the ID has no
+ *         output report
+ */
+static inline uint8_t mouthpad_hid_output_size(uint8_t report_id)
+{
+	switch (report_id) {
+#define MOUTHPAD_HID_OUTPUT_SIZE_CASE(name, id, size) case (id): return (size);
+	MOUTHPAD_HID_OUTPUT_REPORTS(MOUTHPAD_HID_OUTPUT_SIZE_CASE)
+#undef MOUTHPAD_HID_OUTPUT_SIZE_CASE
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Output reports waiting for the BLE write, one slot per report ID. Output
+ * reports carry state (LEDs, controls), so only the latest value of each
+ * ID matters: a new report overwrites an unsent one and the table can
+ * never hold more than one report per ID. Not thread-safe; callers lock.
+ */
+struct mouthpad_hid_output_queue {
+	uint32_t pending; /* bit n: report ID n is waiting */
+	uint8_t len[MOUTHPAD_HID_REPORT_ID_MAX + 1];
+	uint8_t data[MOUTHPAD_HID_REPORT_ID_MAX + 1][MOUTHPAD_HID_OUTPUT_SIZE_MAX];
+};
+
+/**
+ * @brief Queue an output report, replacing any unsent one with the same ID
+ *
+ * @return false if the ID has no output report or the payload is too long
+ */
+static inline bool mouthpad_hid_output_put(struct mouthpad_hid_output_queue *q,
+					   uint8_t report_id, const uint8_t *data,
+					   size_t len)
+{
+	uint8_t size = mouthpad_hid_output_size(report_id);
+
+	if (size == 0 || len > size || report_id > MOUTHPAD_HID_REPORT_ID_MAX) {
+		return false;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		q->data[report_id][i] = i < len ? data[i] : 0;
+	}
+	q->len[report_id] = size;
+	q->pending |= 1u << report_id;
+	return true;
+}
+
+/**
+ * @brief Take the waiting output report with the lowest ID
+ *
+ * @param data MOUTHPAD_HID_OUTPUT_SIZE_MAX bytes
+ * @param len Payload length
+ * @return Report ID, or 0 if nothing is waiting
+ */
+static inline uint8_t mouthpad_hid_output_take(struct mouthpad_hid_output_queue *q,
+					       uint8_t *data, uint8_t *len)
+{
+	if (q->pending == 0) {
+		return 0;
+	}
+
+	uint8_t report_id = (uint8_t)__builtin_ctz(q->pending);
+
+	q->pending &= ~(1u << report_id);
+	*len = q->len[report_id];
+	for (uint8_t i = 0; i < *len; i++) {
+		data[i] = q->data[report_id][i];
+	}
+	return report_id;
+}
+
+/**
+ * @brief Put back a report whose write failed, unless a newer one arrived
+ */
+static inline void mouthpad_hid_output_retry(struct mouthpad_hid_output_queue *q,
+					     uint8_t report_id, const uint8_t *data,
+					     uint8_t len)
+{
+	if (!(q->pending & (1u << report_id))) {
+		mouthpad_hid_output_put(q, report_id, data, len);
+	}
+}
+
+/**
+ * Older MouthPad firmware sends Report ID 3 as a 1-byte bitmap of 8 fixed
+ * consumer controls. Index is the bit number, value the consumer usage.
+ */
+#define MOUTHPAD_HID_CONSUMER_BITMAP_USAGES {                   \
+	0x00CD, /* bit 0: Play/Pause */                         \
+	0x0183, /* bit 1: AL Consumer Control Configuration */  \
+	0x00B5, /* bit 2: Scan Next Track */                    \
+	0x00B6, /* bit 3: Scan Previous Track */                \
+	0x00EA, /* bit 4: Volume Decrement */                   \
+	0x00E9, /* bit 5: Volume Increment */                   \
+	0x0225, /* bit 6: AC Forward */                         \
+	0x0224, /* bit 7: AC Back */                            \
+}
+
+/* Legacy bitmap payload length for Report ID 3 */
+#define MOUTHPAD_HID_CONSUMER_BITMAP_SIZE 1
+
+/**
+ * @brief Translate a legacy consumer bitmap to a 16-bit usage
+ *
+ * @return Usage for the lowest set bit, or 0 (released) if no bit is set
+ */
+static inline uint16_t mouthpad_hid_consumer_usage(uint8_t bitmap)
+{
+	static const uint16_t usages[8] = MOUTHPAD_HID_CONSUMER_BITMAP_USAGES;
+
+	return bitmap ? usages[__builtin_ctz(bitmap)] : 0;
+}
+
+/**
+ * Combined mouse mode, a build option on both firmwares: Report ID 1
+ * carries buttons, X/Y, wheel and AC pan in one report and Report ID 2 is
+ * not in the descriptor, so a drag costs one IN transaction per USB frame
+ * instead of two and buttons never lag motion by a frame. The BLE side
+ * still delivers Reports 1 and 2; the relay merges them.
+ *
+ * - MOUSE:    buttons (5 bits) + padding, X/Y as in MOUSE_MOTION, wheel,
+ *             AC pan
+ */
+#define MOUTHPAD_HID_COMBINED_REPORTS(X) \
+	X(MOUSE,    1, 6)                \
+	X(CONSUMER, 3, 2)                \
+	X(KEYBOARD, 4, 8)
+
+#define MOUTHPAD_HID_COMBINED_REPORT_ID   MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS
+#define MOUTHPAD_HID_COMBINED_REPORT_SIZE 6
+
+/**
+ * @brief Build a combined mouse report
+ *
+ * @param out MOUTHPAD_HID_COMBINED_REPORT_SIZE bytes
+ * @param buttons Report ID 1 payload (buttons, wheel, AC pan)
+ * @param motion Report ID 2 payload (packed X/Y)
+ */
+static inline void mouthpad_hid_combine(uint8_t *out, const uint8_t *buttons,
+					const uint8_t *motion)
+{
+	out[0] = buttons[0];
+	out[1] = motion[0];
+	out[2] = motion[1];
+	out[3] = motion[2];
+	out[4] = buttons[1];
+	out[5] = buttons[2];
+}
+
+/* Mouse application header and Report ID 1 up to the wheel */
+#define MOUTHPAD_HID_REPORT_DESC_MOUSE_HEAD                                             \
+	0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x95,   \
+	0x05, 0x75, 0x01, 0x05, 0x09, 0x19, 0x01, 0x29, 0x05, 0x15, 0x00, 0x25, 0x01,   \
+	0x81, 0x02, 0x95, 0x01, 0x75, 0x03, 0x81, 0x01
+
+/* Wheel and AC pan, then the end of the pointer collection */
+#define MOUTHPAD_HID_REPORT_DESC_WHEEL_PAN                                              \
+	0x75, 0x08, 0x95, 0x01, 0x05, 0x01, 0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x81,   \
+	0x06, 0x05, 0x0C, 0x0A, 0x38, 0x02, 0x95, 0x01, 0x81, 0x06, 0xC0
+
+/* X and Y, signed 12 bits each */
+#define MOUTHPAD_HID_REPORT_DESC_XY                                                     \
+	0x75, 0x0C, 0x95, 0x02, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x16, 0x01, 0xF8,   \
+	0x26, 0xFF, 0x07, 0x81, 0x06
+
+/* Report ID 3, a 16-bit consumer usage */
+#define MOUTHPAD_HID_REPORT_DESC_CONSUMER                                               \
+	0x85, 0x03, 0x05, 0x0C, 0x19, 0x00, 0x2A, 0x3C, 0x02, 0x15, 0x00, 0x26, 0x3C,   \
+	0x02, 0x75, 0x10, 0x95, 0x01, 0x81, 0x00
+
+/* Keyboard application and Report ID 4, up to its closing End Collection */
+#define MOUTHPAD_HID_REPORT_DESC_KEYBOARD                                               \
+	0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x04, 0x05, 0x07, 0x19, 0xE0, 0x29,   \
+	0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01,   \
+	0x75, 0x08, 0x81, 0x01, 0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05,   \
+	0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00
+
+/* Report ID 3 and the end of the mouse application, then the keyboard up to
+ * its closing End Collection
+ */
+#define MOUTHPAD_HID_REPORT_DESC_TAIL                                                   \
+	MOUTHPAD_HID_REPORT_DESC_CONSUMER, 0xC0, MOUTHPAD_HID_REPORT_DESC_KEYBOARD
+
+/* Report ID 4 output: five LEDs and padding */
+#define MOUTHPAD_HID_REPORT_DESC_KEYBOARD_LEDS                                          \
+	0x25, 0x01, 0x95, 0x05, 0x75, 0x01, 0x05, 0x08, 0x19, 0x01, 0x29, 0x05, 0x91,   \
+	0x02, 0x95, 0x01, 0x75, 0x03, 0x91, 0x01
+
+/**
+ * USB HID report descriptor bytes, matching the table above:
+ * mouse application (IDs 1-3) followed by a keyboard application (ID 4).
+ * Logical ranges match the MouthPad BLE descriptor so no scaling is needed.
+ */
+#define MOUTHPAD_HID_REPORT_DESC                                                        \
+	MOUTHPAD_HID_REPORT_DESC_MOUSE_HEAD, MOUTHPAD_HID_REPORT_DESC_WHEEL_PAN,        \
+	0x85, 0x02, 0x09, 0x01, 0xA1, 0x00, MOUTHPAD_HID_REPORT_DESC_XY, 0xC0,          \
+	MOUTHPAD_HID_REPORT_DESC_TAIL, 0xC0
+
+/**
+ * Report descriptor for combined mouse mode, matching
+ * MOUTHPAD_HID_COMBINED_REPORTS: X/Y move into Report ID 1 between the
+ * buttons and the wheel.
+ */
+#define MOUTHPAD_HID_REPORT_DESC_COMBINED                                               \
+	MOUTHPAD_HID_REPORT_DESC_MOUSE_HEAD, MOUTHPAD_HID_REPORT_DESC_XY,               \
+	MOUTHPAD_HID_REPORT_DESC_WHEEL_PAN, MOUTHPAD_HID_REPORT_DESC_TAIL, 0xC0
+
+/* The two descriptors above with MOUTHPAD_HID_OUTPUT_REPORTS added */
+#define MOUTHPAD_HID_REPORT_DESC_OUTPUT                                                 \
+	MOUTHPAD_HID_REPORT_DESC_MOUSE_HEAD, MOUTHPAD_HID_REPORT_DESC_WHEEL_PAN,        \
+	0x85, 0x02, 0x09, 0x01, 0xA1, 0x00, MOUTHPAD_HID_REPORT_DESC_XY, 0xC0,          \
+	MOUTHPAD_HID_REPORT_DESC_TAIL, MOUTHPAD_HID_REPORT_DESC_KEYBOARD_LEDS, 0xC0
+
+#define MOUTHPAD_HID_REPORT_DESC_COMBINED_OUTPUT                                        \
+	MOUTHPAD_HID_REPORT_DESC_MOUSE_HEAD, MOUTHPAD_HID_REPORT_DESC_XY,               \
+	MOUTHPAD_HID_REPORT_DESC_WHEEL_PAN, MOUTHPAD_HID_REPORT_DESC_TAIL,              \
+	MOUTHPAD_HID_REPORT_DESC_KEYBOARD_LEDS, 0xC0
+
+/**
+ * Split interfaces, a build option on both firmwares: the pointer reports
+ * (IDs 1 and 2, or the combined Report ID 1) get a HID interface and IN
+ * endpoint of their own, and consumer control and keyboard (IDs 3 and 4)
+ * another, so a media key never waits behind motion for the endpoint and
+ * each class has its own polling slot. Report IDs and payloads are those
+ * of the tables above.
+ */
+static inline bool mouthpad_hid_report_on_controls(uint8_t report_id)
+{
+	return report_id == MOUTHPAD_HID_REPORT_ID_CONSUMER ||
+	       report_id == MOUTHPAD_HID_REPORT_ID_KEYBOARD;
+}
+
+/* Pointer interface: the mouse application with IDs 1 and 2 */
+#define MOUTHPAD_HID_REPORT_DESC_POINTER                                                \
+	MOUTHPAD_HID_REPORT_DESC_MOUSE_HEAD, MOUTHPAD_HID_REPORT_DESC_WHEEL_PAN,        \
+	0x85, 0x02, 0x09, 0x01, 0xA1, 0x00, MOUTHPAD_HID_REPORT_DESC_XY, 0xC0, 0xC0
+
+/* Pointer interface in combined mouse mode */
+#define MOUTHPAD_HID_REPORT_DESC_POINTER_COMBINED                                       \
+	MOUTHPAD_HID_REPORT_DESC_MOUSE_HEAD, MOUTHPAD_HID_REPORT_DESC_XY,               \
+	MOUTHPAD_HID_REPORT_DESC_WHEEL_PAN, 0xC0
+
+/* Controls interface: a consumer control application (ID 3), then the
+ * keyboard (ID 4)
+ */
+#define MOUTHPAD_HID_REPORT_DESC_CONTROLS                                               \
+	0x05, 0x0C, 0x09, 0x01, 0xA1, 0x01, MOUTHPAD_HID_REPORT_DESC_CONSUMER, 0xC0,    \
+	MOUTHPAD_HID_REPORT_DESC_KEYBOARD, 0xC0
+
+/* Controls interface with MOUTHPAD_HID_OUTPUT_REPORTS added */
+#define MOUTHPAD_HID_REPORT_DESC_CONTROLS_OUTPUT                                        \
+	0x05, 0x0C, 0x09, 0x01, 0xA1, 0x01, MOUTHPAD_HID_REPORT_DESC_CONSUMER, 0xC0,    \
+	MOUTHPAD_HID_REPORT_DESC_KEYBOARD, MOUTHPAD_HID_REPORT_DESC_KEYBOARD_LEDS, 0xC0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_HID_REPORTS_H_ */
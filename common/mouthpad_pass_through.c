@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "mouthpad_pass_through.h"
+#include "MouthpadRelay.pb.h"
+
+/* Protobuf wire types */
+#define WT_VARINT 0
+#define WT_STRING 2
+
+#define KEY(tag, wire_type) ((uint8_t)(((tag) << 3) | (wire_type)))
+
+/* Every key used here is a single byte */
+_Static_assert(mouthware_message_RelayToAppMessage_pass_through_to_app_tag < 16 &&
+		       mouthware_message_PassThroughToApp_fragment_tag < 16 &&
+		       mouthware_message_PassThroughToApp_device_index_tag < 16,
+	       "PassThroughToApp tags no longer fit a one-byte key");
+_Static_assert(mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag < 16 &&
+		       mouthware_message_PassThroughToMouthpad_fragment_tag < 16 &&
+		       mouthware_message_PassThroughToMouthpad_device_index_tag < 16 &&
+		       mouthware_message_PassThroughToMouthpad_sequence_tag < 16,
+	       "PassThroughToMouthpad tags no longer fit a one-byte key");
+
+/* Data and outer lengths are assumed to fit two varint bytes */
+_Static_assert(mouthware_message_PassThroughToApp_size < 16384,
+	       "PassThroughToApp lengths no longer fit two varint bytes");
+
+static size_t varint_size(uint32_t value)
+{
+	size_t n = 1;
+
+	while (value >= 0x80) {
+		value >>= 7;
+		n++;
+	}
+
+	return n;
+}
+
+static size_t put_varint(uint8_t *out, uint32_t value)
+{
+	size_t n = 0;
+
+	while (value >= 0x80) {
+		out[n++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	out[n++] = (uint8_t)value;
+
+	return n;
+}
+
+/* Size of the PassThroughToApp submessage itself */
+static size_t body_size(size_t len, bool more_fragments, uint32_t fragment, uint32_t device_index)
+{
+	size_t n = 0;
+
+	/* proto3 leaves default-valued fields off the wire */
+	if (len > 0) {
+		n += 1 + varint_size(len) + len;
+	}
+	if (more_fragments) {
+		n += 2;
+	}
+	if (fragment != 0) {
+		n += 1 + varint_size(fragment);
+	}
+	if (device_index != 0) {
+		n += 1 + varint_size(device_index);
+	}
+
+	return n;
+}
+
+size_t mouthpad_pass_through_to_app_size(size_t len, bool more_fragments, uint32_t fragment,
+					 uint32_t device_index)
+{
+	size_t body = body_size(len, more_fragments, fragment, device_index);
+
+	return 1 + varint_size(body) + body;
+}
+
+size_t mouthpad_pass_through_to_app_header(uint8_t *out, size_t len, bool more_fragments,
+					   uint32_t fragment, uint32_t device_index)
+{
+	size_t n = 0;
+
+	out[n++] = KEY(mouthware_message_RelayToAppMessage_pass_through_to_app_tag, WT_STRING);
+	n += put_varint(&out[n], body_size(len, more_fragments, fragment, device_index));
+
+	if (len > 0) {
+		out[n++] = KEY(mouthware_message_PassThroughToApp_data_tag, WT_STRING);
+		n += put_varint(&out[n], len);
+	}
+
+	return n;
+}
+
+size_t mouthpad_pass_through_to_app_trailer(uint8_t *out, bool more_fragments, uint32_t fragment,
+					    uint32_t device_index)
+{
+	size_t n = 0;
+
+	if (more_fragments) {
+		out[n++] = KEY(mouthware_message_PassThroughToApp_more_fragments_tag, WT_VARINT);
+		out[n++] = 1;
+	}
+	if (fragment != 0) {
+		out[n++] = KEY(mouthware_message_PassThroughToApp_fragment_tag, WT_VARINT);
+		n += put_varint(&out[n], fragment);
+	}
+	if (device_index != 0) {
+		out[n++] = KEY(mouthware_message_PassThroughToApp_device_index_tag, WT_VARINT);
+		n += put_varint(&out[n], device_index);
+	}
+
+	return n;
+}
+
+size_t mouthpad_pass_through_to_app_encode(uint8_t *out, const uint8_t *data, size_t len,
+					   bool more_fragments, uint32_t fragment,
+					   uint32_t device_index)
+{
+	size_t n = mouthpad_pass_through_to_app_header(out, len, more_fragments, fragment,
+						       device_index);
+
+	if (len > 0) {
+		memcpy(&out[n], data, len);
+		n += len;
+	}
+
+	return n + mouthpad_pass_through_to_app_trailer(&out[n], more_fragments, fragment,
+							device_index);
+}
+
+/* Bounded reader over a received frame */
+struct reader {
+	const uint8_t *pos;
+	const uint8_t *end;
+};
+
+static bool get_varint(struct reader *r, uint64_t *value)
+{
+	uint64_t result = 0;
+
+	for (unsigned int shift = 0; shift < 64 && r->pos < r->end; shift += 7) {
+		uint8_t byte = *r->pos++;
+
+		result |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Reads a length-delimited field into sub, which then covers its value */
+static bool get_delimited(struct reader *r, struct reader *sub)
+{
+	uint64_t len;
+
+	if (!get_varint(r, &len) || len > (uint64_t)(r->end - r->pos)) {
+		return false;
+	}
+
+	sub->pos = r->pos;
+	sub->end = r->pos + len;
+	r->pos = sub->end;
+
+	return true;
+}
+
+static bool peek_body(struct reader *r, struct mouthpad_pass_through_to_mouthpad *out)
+{
+	/* Fields missing from the wire keep their proto3 defaults */
+	*out = (struct mouthpad_pass_through_to_mouthpad){ .data = r->pos };
+
+	while (r->pos < r->end) {
+		uint8_t key = *r->pos++;
+		struct reader data;
+		uint64_t value;
+
+		/* A repeated field overrides the earlier one, as in pb_decode() */
+		switch (key) {
+		case KEY(mouthware_message_PassThroughToMouthpad_data_tag, WT_STRING):
+			if (!get_delimited(r, &data) ||
+			    (size_t)(data.end - data.pos) >
+				    pb_membersize(mouthware_message_PassThroughToMouthpad_data_t,
+						  bytes)) {
+				return false;
+			}
+			out->data = data.pos;
+			out->len = data.end - data.pos;
+			break;
+		case KEY(mouthware_message_PassThroughToMouthpad_reliable_tag, WT_VARINT):
+			if (!get_varint(r, &value)) {
+				return false;
+			}
+			out->reliable = value != 0;
+			break;
+		case KEY(mouthware_message_PassThroughToMouthpad_more_fragments_tag, WT_VARINT):
+			if (!get_varint(r, &value)) {
+				return false;
+			}
+			out->more_fragments = value != 0;
+			break;
+		case KEY(mouthware_message_PassThroughToMouthpad_fragment_tag, WT_VARINT):
+			if (!get_varint(r, &value) || value > UINT32_MAX) {
+				return false;
+			}
+			out->fragment = (uint32_t)value;
+			break;
+		case KEY(mouthware_message_PassThroughToMouthpad_device_index_tag, WT_VARINT):
+			if (!get_varint(r, &value) || value > UINT32_MAX) {
+				return false;
+			}
+			out->device_index = (uint32_t)value;
+			break;
+		case KEY(mouthware_message_PassThroughToMouthpad_ack_tag, WT_VARINT):
+			if (!get_varint(r, &value) || value > UINT32_MAX) {
+				return false;
+			}
+			out->ack = (uint32_t)value;
+			break;
+		case KEY(mouthware_message_PassThroughToMouthpad_sequence_tag, WT_VARINT):
+			if (!get_varint(r, &value) || value > UINT32_MAX) {
+				return false;
+			}
+			out->sequence = (uint32_t)value;
+			break;
+		default:
+			/* Unknown field or wire type: leave it to pb_decode() */
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool mouthpad_pass_through_to_mouthpad_peek(const uint8_t *frame, size_t len,
+					    struct mouthpad_pass_through_to_mouthpad *out)
+{
+	struct reader r = { .pos = frame, .end = frame + len };
+	bool have_body = false;
+	uint64_t destination = 0;
+
+	while (r.pos < r.end) {
+		uint8_t key = *r.pos++;
+		struct reader body;
+
+		switch (key) {
+		case KEY(mouthware_message_AppToRelayMessage_destination_tag, WT_VARINT):
+			if (!get_varint(&r, &destination)) {
+				return false;
+			}
+			break;
+		case KEY(mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag, WT_STRING):
+			/* pb_decode() merges a repeated submessage; not worth copying here */
+			if (have_body || !get_delimited(&r, &body) || !peek_body(&body, out)) {
+				return false;
+			}
+			have_body = true;
+			break;
+		default:
+			/* Another oneof member, i.e. a control message */
+			return false;
+		}
+	}
+
+	return have_body &&
+	       destination ==
+		       mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD;
+}
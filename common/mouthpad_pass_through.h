@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Hand-written pass-through codec for the NUS data path
+ *
+ * Every MouthPad->host NUS packet is wrapped in the same message shape, so
+ * the relays write its tags and varint lengths directly instead of filling
+ * a RelayToAppMessage and walking nanopb's field descriptors. The output is
+ * byte-for-byte what pb_encode() produces for the same field values,
+ * including proto3's omission of empty data and zero fragment and device
+ * index fields.
+ *
+ * The encoding is split around the data so callers can copy the bytes
+ * straight from the NUS notification into their TX frame:
+ *
+ *   [header][data][trailer]
+ *
+ * In the other direction, mouthpad_pass_through_to_mouthpad_peek() picks
+ * host->MouthPad writes out of a received frame without decoding them into
+ * an AppToRelayMessage; everything else still goes through pb_decode().
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef MOUTHPAD_PASS_THROUGH_H_
+#define MOUTHPAD_PASS_THROUGH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Outer tag and length, data tag and length (data length fits 2 varint bytes) */
+#define MOUTHPAD_PASS_THROUGH_TO_APP_HEADER_MAX (1 + 2 + 1 + 2)
+
+/* more_fragments tag and value, fragment and device_index tags and varints */
+#define MOUTHPAD_PASS_THROUGH_TO_APP_TRAILER_MAX (2 + 1 + 5 + 1 + 5)
+
+#define MOUTHPAD_PASS_THROUGH_TO_APP_OVERHEAD                                                  \
+	(MOUTHPAD_PASS_THROUGH_TO_APP_HEADER_MAX + MOUTHPAD_PASS_THROUGH_TO_APP_TRAILER_MAX)
+
+/**
+ * @brief Encoded size of a pass_through_to_app RelayToAppMessage
+ *
+ * @param len Data length, at most the PassThroughToApp data field size
+ * @param device_index 0 for the primary MouthPad, 1 and up for secondary links
+ */
+size_t mouthpad_pass_through_to_app_size(size_t len, bool more_fragments, uint32_t fragment,
+					 uint32_t device_index);
+
+/**
+ * @brief Write the bytes that precede the data
+ *
+ * @param out At least MOUTHPAD_PASS_THROUGH_TO_APP_HEADER_MAX bytes
+ * @return Bytes written
+ */
+size_t mouthpad_pass_through_to_app_header(uint8_t *out, size_t len, bool more_fragments,
+					   uint32_t fragment, uint32_t device_index);
+
+/**
+ * @brief Write the bytes that follow the data
+ *
+ * @param out At least MOUTHPAD_PASS_THROUGH_TO_APP_TRAILER_MAX bytes
+ * @return Bytes written, 0 for an unfragmented message from the primary
+ */
+size_t mouthpad_pass_through_to_app_trailer(uint8_t *out, bool more_fragments, uint32_t fragment,
+					    uint32_t device_index);
+
+/**
+ * @brief Encode the whole message into one buffer
+ *
+ * @param out At least len + MOUTHPAD_PASS_THROUGH_TO_APP_OVERHEAD bytes
+ * @return Bytes written
+ */
+size_t mouthpad_pass_through_to_app_encode(uint8_t *out, const uint8_t *data, size_t len,
+					   bool more_fragments, uint32_t fragment,
+					   uint32_t device_index);
+
+/* A PassThroughToMouthpad found by mouthpad_pass_through_to_mouthpad_peek() */
+struct mouthpad_pass_through_to_mouthpad {
+	const uint8_t *data; /* Points into the peeked frame */
+	size_t len;
+	bool reliable;
+	bool more_fragments;
+	uint32_t fragment;
+	uint32_t device_index;
+	uint32_t ack; /* PassThroughAckMode */
+	uint32_t sequence;
+};
+
+/**
+ * @brief Recognize a host->MouthPad write without decoding the frame
+ *
+ * Succeeds only for an AppToRelayMessage with destination MOUTHPAD whose
+ * body is pass_through_to_mouthpad, holding nothing but the fields known
+ * here and at most the PassThroughToMouthpad data field size. Field values
+ * are the ones pb_decode() would produce; data is not copied.
+ *
+ * @param frame Received AppToRelayMessage payload
+ * @param len Length of frame
+ * @param out Filled in on success, left undefined otherwise
+ * @return true if out describes the write; false if the frame must be
+ *         decoded with pb_decode() instead (control messages, unusual
+ *         encodings and malformed frames)
+ */
+bool mouthpad_pass_through_to_mouthpad_peek(const uint8_t *frame, size_t len,
+					    struct mouthpad_pass_through_to_mouthpad *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_PASS_THROUGH_H_ */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Vendor-defined HID interface carrying raw, timestamped samples
+ *
+ * The mouse reports go to the OS coalesced and filtered. For apps that
+ * want every button and motion report the MouthPad sent, with the time
+ * it arrived, the relay can also enumerate a vendor-defined HID interface
+ * with one 64-byte input report, no report ID, packing several samples:
+ *
+ *   byte 0      sequence number, one more than the last report's
+ *   byte 1      samples in this report (1-9)
+ *   bytes 2-3   samples lost since the last report, little endian,
+ *               saturating
+ *   bytes 4-7   relay receive time of the first sample in us, little
+ *               endian, wrapping
+ *   bytes 8-61  samples, 6 bytes each:
+ *                 bytes 0-1  receive time after the first sample in us,
+ *                            little endian
+ *                 byte 2     report ID (1 buttons, 2 motion)
+ *                 bytes 3-5  the MouthPad's report as it arrived
+ *   bytes 62-63 padding
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef MOUTHPAD_RAW_HID_H_
+#define MOUTHPAD_RAW_HID_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mouthpad_hid_reports.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Input report size; the report carries no report ID */
+#define MOUTHPAD_RAW_HID_REPORT_SIZE 64
+
+#define MOUTHPAD_RAW_HID_HEADER_SIZE  8
+#define MOUTHPAD_RAW_HID_PAYLOAD_SIZE 3
+#define MOUTHPAD_RAW_HID_SAMPLE_SIZE  (3 + MOUTHPAD_RAW_HID_PAYLOAD_SIZE)
+#define MOUTHPAD_RAW_HID_SAMPLES_MAX                                            \
+	((MOUTHPAD_RAW_HID_REPORT_SIZE - MOUTHPAD_RAW_HID_HEADER_SIZE) /        \
+	 MOUTHPAD_RAW_HID_SAMPLE_SIZE)
+
+/* Furthest a sample may be from the first of its report */
+#define MOUTHPAD_RAW_HID_SPAN_US UINT16_MAX
+
+/**
+ * Report descriptor: usage page 0xFF00 (vendor), usage 0x20, one 64-byte
+ * input report. The usage tells it from the relay HID interface.
+ */
+#define MOUTHPAD_RAW_HID_REPORT_DESC                                            \
+	0x06, 0x00, 0xFF, 0x09, 0x20, 0xA1, 0x01, 0x15, 0x00, 0x26, 0xFF, 0x00, \
+	0x75, 0x08, 0x95, MOUTHPAD_RAW_HID_REPORT_SIZE, 0x09, 0x21, 0x81, 0x02, \
+	0xC0
+
+/* A report being filled */
+struct mouthpad_raw_hid_batch {
+	uint8_t report[MOUTHPAD_RAW_HID_REPORT_SIZE];
+	uint32_t base_us;
+	uint8_t count;
+};
+
+/**
+ * @brief Check whether a MouthPad report is carried as a sample
+ */
+static inline bool mouthpad_raw_hid_takes(uint8_t report_id, size_t len)
+{
+	return (report_id == MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS ||
+		report_id == MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION) &&
+	       len >= 1 && len <= MOUTHPAD_RAW_HID_PAYLOAD_SIZE;
+}
+
+/**
+ * @brief Start an empty report
+ *
+ * @param dropped Samples lost since the last report the host was sent
+ */
+static inline void mouthpad_raw_hid_open(struct mouthpad_raw_hid_batch *batch, uint8_t seq,
+					 uint32_t dropped)
+{
+	uint16_t lost = dropped > UINT16_MAX ? UINT16_MAX : (uint16_t)dropped;
+
+	memset(batch->report, 0, sizeof(batch->report));
+	batch->report[0] = seq;
+	batch->report[2] = (uint8_t)lost;
+	batch->report[3] = (uint8_t)(lost >> 8);
+	batch->base_us = 0;
+	batch->count = 0;
+}
+
+/**
+ * @brief Add a sample to a report
+ *
+ * @param now_us Receive time, on the clock of the other samples
+ * @return false if the report is full or now_us is too far from its first
+ *         sample; the report is left as it was
+ */
+static inline bool mouthpad_raw_hid_add(struct mouthpad_raw_hid_batch *batch, uint32_t now_us,
+					uint8_t report_id, const uint8_t *data, size_t len)
+{
+	uint8_t *sample;
+	uint32_t offset;
+
+	if (batch->count >= MOUTHPAD_RAW_HID_SAMPLES_MAX) {
+		return false;
+	}
+	if (batch->count == 0) {
+		batch->base_us = now_us;
+		batch->report[4] = (uint8_t)now_us;
+		batch->report[5] = (uint8_t)(now_us >> 8);
+		batch->report[6] = (uint8_t)(now_us >> 16);
+		batch->report[7] = (uint8_t)(now_us >> 24);
+	}
+	offset = now_us - batch->base_us;
+	if (offset > MOUTHPAD_RAW_HID_SPAN_US) {
+		return false;
+	}
+
+	sample = &batch->report[MOUTHPAD_RAW_HID_HEADER_SIZE +
+				batch->count * MOUTHPAD_RAW_HID_SAMPLE_SIZE];
+	sample[0] = (uint8_t)offset;
+	sample[1] = (uint8_t)(offset >> 8);
+	sample[2] = report_id;
+	memcpy(&sample[3], data, len);
+	batch->report[1] = ++batch->count;
+
+	return true;
+}
+
+/**
+ * @brief Samples lost since the last report, as the report says
+ */
+static inline uint16_t mouthpad_raw_hid_dropped(const struct mouthpad_raw_hid_batch *batch)
+{
+	return (uint16_t)(batch->report[2] | (batch->report[3] << 8));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_RAW_HID_H_ */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Vendor-defined HID interface carrying the relay protocol
+ *
+ * For hosts that block CDC ACM drivers, the relay also enumerates a
+ * vendor-defined HID interface with 64-byte input and output reports on
+ * 1 ms interrupt endpoints. Both directions carry the same byte stream as
+ * CDC0, i.e. MOUTHPAD_FRAME frames, cut into reports. The first byte of
+ * each report is the number of stream bytes that follow (0-63); the rest
+ * of the report is padding. A frame may span reports and a report may
+ * hold the end of one frame and the start of the next.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef MOUTHPAD_RELAY_HID_H_
+#define MOUTHPAD_RELAY_HID_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Input and output report size; the reports carry no report ID */
+#define MOUTHPAD_RELAY_HID_REPORT_SIZE 64
+
+/* Stream bytes per report, after the length byte */
+#define MOUTHPAD_RELAY_HID_CHUNK_MAX (MOUTHPAD_RELAY_HID_REPORT_SIZE - 1)
+
+#define MOUTHPAD_RELAY_HID_POLL_MS 1
+
+/**
+ * Report descriptor: usage page 0xFF00 (vendor), usage 0x01, one 64-byte
+ * input report and one 64-byte output report.
+ */
+#define MOUTHPAD_RELAY_HID_REPORT_DESC                                          \
+	0x06, 0x00, 0xFF, 0x09, 0x01, 0xA1, 0x01, 0x15, 0x00, 0x26, 0xFF, 0x00, \
+	0x75, 0x08, 0x95, MOUTHPAD_RELAY_HID_REPORT_SIZE, 0x09, 0x02, 0x81,     \
+	0x02, 0x95, MOUTHPAD_RELAY_HID_REPORT_SIZE, 0x09, 0x03, 0x91, 0x02,     \
+	0xC0
+
+/**
+ * @brief Fill a report with the next stream bytes
+ *
+ * @param report Report to fill, MOUTHPAD_RELAY_HID_REPORT_SIZE bytes
+ * @return Number of bytes of data taken, at most MOUTHPAD_RELAY_HID_CHUNK_MAX
+ */
+static inline size_t mouthpad_relay_hid_pack(uint8_t *report, const uint8_t *data,
+					     size_t len)
+{
+	size_t n = len < MOUTHPAD_RELAY_HID_CHUNK_MAX ? len : MOUTHPAD_RELAY_HID_CHUNK_MAX;
+
+	report[0] = (uint8_t)n;
+	memcpy(&report[1], data, n);
+	memset(&report[1 + n], 0, MOUTHPAD_RELAY_HID_CHUNK_MAX - n);
+
+	return n;
+}
+
+/**
+ * @brief Stream bytes carried by a received output report
+ *
+ * A length byte larger than the report is clamped, so a short or corrupt
+ * report never reads past the buffer.
+ *
+ * @param report Report as received, len bytes
+ * @return Number of stream bytes, which start at report + 1
+ */
+static inline size_t mouthpad_relay_hid_unpack(const uint8_t *report, size_t len)
+{
+	if (len < 2) {
+		return 0;
+	}
+
+	return report[0] < len - 1 ? report[0] : len - 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_RELAY_HID_H_ */
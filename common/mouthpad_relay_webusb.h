@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief WebUSB vendor bulk interface carrying the relay protocol
+ *
+ * A vendor-class interface (0xFF/0x00/0x00) with one bulk OUT and one bulk
+ * IN endpoint of 64 bytes. Both directions carry the same byte stream as
+ * CDC0, i.e. MOUTHPAD_FRAME frames, with no extra framing; transfers may
+ * split or join frames anywhere. Browsers reach it through navigator.usb,
+ * which skips the OS serial driver.
+ *
+ * The device announces it with two BOS platform capabilities: WebUSB (no
+ * landing page) and MS OS 2.0, whose descriptor set binds WinUSB to the
+ * interface so Windows needs no INF. The set is returned for a vendor
+ * request with bRequest MOUTHPAD_RELAY_WEBUSB_MSOS2_VENDOR_CODE and wIndex
+ * MOUTHPAD_RELAY_WEBUSB_MSOS2_INDEX. bcdUSB must be at least 0x0201 for
+ * hosts to read the BOS descriptor.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef MOUTHPAD_RELAY_WEBUSB_H_
+#define MOUTHPAD_RELAY_WEBUSB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOUTHPAD_RELAY_WEBUSB_EP_SIZE 64
+
+#define MOUTHPAD_RELAY_WEBUSB_VENDOR_CODE       0x01
+#define MOUTHPAD_RELAY_WEBUSB_MSOS2_VENDOR_CODE 0x02
+
+/* wIndex of the MS OS 2.0 descriptor set request */
+#define MOUTHPAD_RELAY_WEBUSB_MSOS2_INDEX 0x07
+
+/**
+ * WebUSB platform capability, UUID 3408B638-09A9-47A0-8BFD-A0768815B665,
+ * version 1.0, no landing page.
+ */
+#define MOUTHPAD_RELAY_WEBUSB_BOS_WEBUSB_LEN 24
+#define MOUTHPAD_RELAY_WEBUSB_BOS_WEBUSB                                        \
+	MOUTHPAD_RELAY_WEBUSB_BOS_WEBUSB_LEN, 0x10, 0x05, 0x00,                 \
+	0x38, 0xB6, 0x08, 0x34, 0xA9, 0x09, 0xA0, 0x47,                         \
+	0x8B, 0xFD, 0xA0, 0x76, 0x88, 0x15, 0xB6, 0x65,                         \
+	0x00, 0x01, MOUTHPAD_RELAY_WEBUSB_VENDOR_CODE, 0x00
+
+/**
+ * MS OS 2.0 platform capability, UUID D8DD60DF-4589-4CC7-9CD2-659D9E648A9F,
+ * Windows 8.1 and later.
+ */
+#define MOUTHPAD_RELAY_WEBUSB_BOS_MSOS2_LEN 28
+#define MOUTHPAD_RELAY_WEBUSB_BOS_MSOS2                                         \
+	MOUTHPAD_RELAY_WEBUSB_BOS_MSOS2_LEN, 0x10, 0x05, 0x00,                  \
+	0xDF, 0x60, 0xDD, 0xD8, 0x89, 0x45, 0xC7, 0x4C,                         \
+	0x9C, 0xD2, 0x65, 0x9D, 0x9E, 0x64, 0x8A, 0x9F,                         \
+	0x00, 0x00, 0x03, 0x06,                                                 \
+	MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC_LEN, 0x00,                             \
+	MOUTHPAD_RELAY_WEBUSB_MSOS2_VENDOR_CODE, 0x00
+
+/* Offset of bFirstInterface in the descriptor set below, for stacks that
+ * only learn the interface number at run time
+ */
+#define MOUTHPAD_RELAY_WEBUSB_MSOS2_ITF_OFFSET 22
+
+/**
+ * MS OS 2.0 descriptor set: header, configuration subset, and a function
+ * subset for interface itf with the WINUSB compatible ID and a fixed
+ * DeviceInterfaceGUIDs registry property.
+ */
+#define MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC_LEN 178
+#define MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC(itf)                                   \
+	/* Set header */                                                        \
+	0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x06,                         \
+	MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC_LEN, 0x00,                             \
+	/* Configuration subset header */                                       \
+	0x08, 0x00, 0x01, 0x00, 0x00, 0x00,                                     \
+	MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC_LEN - 0x0A, 0x00,                      \
+	/* Function subset header */                                            \
+	0x08, 0x00, 0x02, 0x00, (itf), 0x00,                                    \
+	MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC_LEN - 0x12, 0x00,                      \
+	/* Compatible ID */                                                     \
+	0x14, 0x00, 0x03, 0x00, 'W', 'I', 'N', 'U', 'S', 'B', 0, 0,             \
+	0, 0, 0, 0, 0, 0, 0, 0,                                                 \
+	/* Registry property, REG_MULTI_SZ */                                   \
+	0x84, 0x00, 0x04, 0x00, 0x07, 0x00, 0x2A, 0x00,                         \
+	'D', 0, 'e', 0, 'v', 0, 'i', 0, 'c', 0, 'e', 0,                         \
+	'I', 0, 'n', 0, 't', 0, 'e', 0, 'r', 0, 'f', 0,                         \
+	'a', 0, 'c', 0, 'e', 0, 'G', 0, 'U', 0, 'I', 0,                         \
+	'D', 0, 's', 0, 0, 0,                                                   \
+	0x50, 0x00,                                                             \
+	'{', 0, '3', 0, 'F', 0, '6', 0, 'C', 0, '1', 0,                         \
+	'A', 0, '2', 0, 'E', 0, '-', 0, '8', 0, 'D', 0,                         \
+	'4', 0, 'B', 0, '-', 0, '4', 0, 'C', 0, '7', 0,                         \
+	'A', 0, '-', 0, '9', 0, 'E', 0, '1', 0, '5', 0,                         \
+	'-', 0, '6', 0, 'B', 0, '2', 0, 'D', 0, '0', 0,                         \
+	'F', 0, '8', 0, 'A', 0, '7', 0, 'C', 0, '3', 0,                         \
+	'1', 0, '}', 0, 0, 0, 0, 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOUTHPAD_RELAY_WEBUSB_H_ */
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nus_stream.h"
+#include "mouthpad_frame.h"
+
+_Static_assert((NUS_STREAM_WINDOW & (NUS_STREAM_WINDOW - 1)) == 0,
+	       "NUS_STREAM_WINDOW must be a power of two");
+_Static_assert((NUS_STREAM_INFLIGHT_MAX & (NUS_STREAM_INFLIGHT_MAX - 1)) == 0,
+	       "NUS_STREAM_INFLIGHT_MAX must be a power of two");
+
+/* 3 bytes go to the RelayToAppMessage tag and length */
+_Static_assert(mouthware_message_NusStreamStatus_size <= MOUTHPAD_FRAME_MAX_PAYLOAD - 3,
+	       "NusStreamStatus does not fit a frame");
+
+/* A status goes out each time this much more has been forwarded */
+#define STATUS_STEP (NUS_STREAM_WINDOW / 4)
+
+static const struct nus_stream_ops *ops;
+static atomic_uint state;
+static atomic_bool status_due;
+
+/* Byte ring: the RX path fills at head, the pump empties at tail */
+static uint8_t ring[NUS_STREAM_WINDOW];
+static atomic_uint head;
+static atomic_uint tail;
+
+/* Owned by the RX path */
+static atomic_uint received;
+static atomic_uint refused;
+
+/* Owned by the pump */
+static atomic_uint forwarded;
+static atomic_uint packet_size;
+static uint32_t reported_forwarded;
+static uint32_t reported_done;
+
+/* Writes queued by the pump, oldest first, for nus_stream_sent() to
+ * retire. Each is tagged with its stream, so writes left over from a stream
+ * abandoned by reopening are not counted against the new one.
+ */
+struct pending_write {
+	uint16_t len;
+	uint16_t stream;
+};
+
+static struct pending_write pending[NUS_STREAM_INFLIGHT_MAX];
+static atomic_uint queued;
+static atomic_uint retired;
+static atomic_uint stream;
+
+/* Updated by nus_stream_sent() */
+static atomic_uint sent;
+static atomic_uint failed;
+
+void nus_stream_init(const struct nus_stream_ops *platform_ops)
+{
+	ops = platform_ops;
+}
+
+static void request_status(void)
+{
+	atomic_store_explicit(&status_due, true, memory_order_relaxed);
+	ops->kick();
+}
+
+static void handle_control(const mouthware_message_NusStreamControl *control)
+{
+	unsigned int now = atomic_load_explicit(&state, memory_order_relaxed);
+	unsigned int next;
+
+	do {
+		if (control->enabled) {
+			/* Already opening: the pump has yet to reset the ring */
+			next = now == NUS_STREAM_OPENING ? now : NUS_STREAM_OPENING;
+		} else if (now == NUS_STREAM_OPEN) {
+			next = NUS_STREAM_CLOSING;
+		} else if (now == NUS_STREAM_OPENING) {
+			/* Nothing of the new stream was accepted, so nothing to drain */
+			next = NUS_STREAM_CLOSED;
+		} else {
+			next = now;
+		}
+	} while (next != now && !atomic_compare_exchange_weak_explicit(
+					&state, &now, next, memory_order_relaxed,
+					memory_order_relaxed));
+
+	if (control->enabled) {
+		atomic_store_explicit(&received, 0, memory_order_relaxed);
+		atomic_store_explicit(&refused, 0, memory_order_relaxed);
+	}
+
+	request_status();
+}
+
+static int handle_write(const mouthware_message_NusStreamWrite *write)
+{
+	unsigned int h = atomic_load_explicit(&head, memory_order_relaxed);
+	unsigned int t = atomic_load_explicit(&tail, memory_order_acquire);
+	uint32_t expected = atomic_load_explicit(&received, memory_order_relaxed);
+	size_t len = write->data.size;
+
+	if (atomic_load_explicit(&state, memory_order_relaxed) != NUS_STREAM_OPEN ||
+	    write->offset != expected || len == 0 || len > NUS_STREAM_WRITE_MAX ||
+	    len > NUS_STREAM_WINDOW - (h - t)) {
+		atomic_fetch_add_explicit(&refused, 1, memory_order_relaxed);
+		request_status();
+		return -1;
+	}
+
+	unsigned int at = h & (NUS_STREAM_WINDOW - 1);
+	size_t first = len < NUS_STREAM_WINDOW - at ? len : NUS_STREAM_WINDOW - at;
+
+	memcpy(&ring[at], write->data.bytes, first);
+	memcpy(ring, write->data.bytes + first, len - first);
+
+	atomic_store_explicit(&received, expected + len, memory_order_relaxed);
+	atomic_store_explicit(&head, h + len, memory_order_release);
+	ops->kick();
+	return 0;
+}
+
+int nus_stream_handle(const mouthware_message_AppToRelayMessage *message)
+{
+	if (!ops) {
+		return -1;
+	}
+
+	switch (message->which_message_body) {
+	case mouthware_message_AppToRelayMessage_nus_stream_control_tag:
+		handle_control(&message->message_body.nus_stream_control);
+		return 0;
+	case mouthware_message_AppToRelayMessage_nus_stream_write_tag:
+		return handle_write(&message->message_body.nus_stream_write);
+	default:
+		return -1;
+	}
+}
+
+void nus_stream_sent(bool ok)
+{
+	unsigned int r = atomic_load_explicit(&retired, memory_order_relaxed);
+	struct pending_write write;
+
+	/* Several contexts may report completions */
+	do {
+		if (r == atomic_load_explicit(&queued, memory_order_acquire)) {
+			return;
+		}
+		write = pending[r & (NUS_STREAM_INFLIGHT_MAX - 1)];
+	} while (!atomic_compare_exchange_weak_explicit(&retired, &r, r + 1,
+							 memory_order_relaxed,
+							 memory_order_relaxed));
+
+	if (write.stream == (uint16_t)atomic_load_explicit(&stream, memory_order_relaxed)) {
+		atomic_fetch_add_explicit(ok ? &sent : &failed, write.len, memory_order_relaxed);
+	}
+
+	if (ops) {
+		ops->kick();
+	}
+}
+
+static unsigned int in_flight(void)
+{
+	return atomic_load_explicit(&queued, memory_order_relaxed) -
+	       atomic_load_explicit(&retired, memory_order_relaxed);
+}
+
+bool nus_stream_active(void)
+{
+	return atomic_load_explicit(&state, memory_order_relaxed) != NUS_STREAM_CLOSED;
+}
+
+void nus_stream_get_status(mouthware_message_NusStreamStatus *status)
+{
+	*status = (mouthware_message_NusStreamStatus)mouthware_message_NusStreamStatus_init_zero;
+	status->state = atomic_load_explicit(&state, memory_order_relaxed);
+	status->received = atomic_load_explicit(&received, memory_order_relaxed);
+	status->forwarded = atomic_load_explicit(&forwarded, memory_order_relaxed);
+	status->sent = atomic_load_explicit(&sent, memory_order_relaxed);
+	status->failed = atomic_load_explicit(&failed, memory_order_relaxed);
+	status->window = NUS_STREAM_WINDOW;
+	status->packet_size = atomic_load_explicit(&packet_size, memory_order_relaxed);
+	status->refused = atomic_load_explicit(&refused, memory_order_relaxed);
+}
+
+static void send_status(void)
+{
+	mouthware_message_NusStreamStatus status;
+
+	atomic_store_explicit(&status_due, false, memory_order_relaxed);
+	nus_stream_get_status(&status);
+	reported_forwarded = status.forwarded;
+	reported_done = status.sent + status.failed;
+	ops->send_status(&status);
+}
+
+static void open_stream(void)
+{
+	/* The RX path accepts nothing while opening; whatever is left belongs
+	 * to the stream just abandoned
+	 */
+	atomic_store_explicit(&tail, atomic_load_explicit(&head, memory_order_acquire),
+			      memory_order_release);
+
+	atomic_fetch_add_explicit(&stream, 1, memory_order_relaxed);
+	atomic_store_explicit(&forwarded, 0, memory_order_relaxed);
+	atomic_store_explicit(&sent, 0, memory_order_relaxed);
+	atomic_store_explicit(&failed, 0, memory_order_relaxed);
+
+	unsigned int expected = NUS_STREAM_OPENING;
+
+	if (atomic_compare_exchange_strong_explicit(&state, &expected, NUS_STREAM_OPEN,
+						    memory_order_relaxed, memory_order_relaxed)) {
+		send_status();
+	}
+}
+
+/* Count bytes as forwarded and failed together, e.g. when the link is gone */
+static void discard(unsigned int len)
+{
+	atomic_fetch_add_explicit(&forwarded, len, memory_order_relaxed);
+	atomic_fetch_add_explicit(&failed, len, memory_order_relaxed);
+	atomic_store_explicit(&status_due, true, memory_order_relaxed);
+}
+
+static void forward(void)
+{
+	uint16_t packet = ops->packet_size();
+	unsigned int t = atomic_load_explicit(&tail, memory_order_relaxed);
+	unsigned int h;
+
+	if (packet > NUS_STREAM_PACKET_MAX) {
+		packet = NUS_STREAM_PACKET_MAX;
+	}
+	atomic_store_explicit(&packet_size, packet, memory_order_relaxed);
+
+	while ((h = atomic_load_explicit(&head, memory_order_acquire)) != t) {
+		unsigned int len = h - t;
+
+		if (packet == 0) {
+			discard(len);
+			atomic_store_explicit(&tail, h, memory_order_release);
+			return;
+		}
+
+		/* Hold a short packet back while a write is in flight; its
+		 * completion runs the pump again, by when more may have arrived
+		 */
+		unsigned int flying = in_flight();
+
+		if (flying >= NUS_STREAM_INFLIGHT_MAX ||
+		    (len < packet && flying > 0 &&
+		     atomic_load_explicit(&state, memory_order_relaxed) == NUS_STREAM_OPEN)) {
+			return;
+		}
+		if (len > packet) {
+			len = packet;
+		}
+
+		uint8_t data[NUS_STREAM_PACKET_MAX];
+		unsigned int at = t & (NUS_STREAM_WINDOW - 1);
+		unsigned int first = len < NUS_STREAM_WINDOW - at ? len : NUS_STREAM_WINDOW - at;
+
+		memcpy(data, &ring[at], first);
+		memcpy(data + first, ring, len - first);
+
+		/* Queued first, as it may complete before write() returns */
+		unsigned int q = atomic_load_explicit(&queued, memory_order_relaxed);
+
+		pending[q & (NUS_STREAM_INFLIGHT_MAX - 1)] = (struct pending_write){
+			.len = (uint16_t)len,
+			.stream = (uint16_t)atomic_load_explicit(&stream, memory_order_relaxed),
+		};
+		atomic_store_explicit(&queued, q + 1, memory_order_release);
+
+		int err = ops->write(data, len);
+
+		if (err) {
+			atomic_store_explicit(&queued, q, memory_order_relaxed);
+		}
+		if (err > 0) {
+			/* NUS TX queue full; the next completion kicks */
+			return;
+		}
+		if (err < 0) {
+			discard(h - t);
+			atomic_store_explicit(&tail, h, memory_order_release);
+			return;
+		}
+
+		t += len;
+		atomic_fetch_add_explicit(&forwarded, len, memory_order_relaxed);
+		atomic_store_explicit(&tail, t, memory_order_release);
+	}
+}
+
+void nus_stream_pump(void)
+{
+	if (!ops) {
+		return;
+	}
+
+	unsigned int now = atomic_load_explicit(&state, memory_order_acquire);
+
+	if (now == NUS_STREAM_OPENING) {
+		open_stream();
+		now = atomic_load_explicit(&state, memory_order_acquire);
+	}
+
+	if (now == NUS_STREAM_OPEN || now == NUS_STREAM_CLOSING) {
+		forward();
+	}
+
+	bool drained = atomic_load_explicit(&tail, memory_order_relaxed) ==
+		       atomic_load_explicit(&head, memory_order_acquire);
+
+	if (now == NUS_STREAM_CLOSING && drained &&
+	    atomic_compare_exchange_strong_explicit(&state, &now, NUS_STREAM_CLOSED,
+						    memory_order_relaxed, memory_order_relaxed)) {
+		send_status();
+		return;
+	}
+
+	uint32_t done = atomic_load_explicit(&sent, memory_order_relaxed) +
+			atomic_load_explicit(&failed, memory_order_relaxed);
+	bool idle = drained && in_flight() == 0;
+
+	if (atomic_load_explicit(&status_due, memory_order_relaxed) ||
+	    atomic_load_explicit(&forwarded, memory_order_relaxed) - reported_forwarded >=
+		    STATUS_STEP ||
+	    (idle && done != reported_done)) {
+		send_status();
+	}
+}
+
+static const char *state_name(unsigned int state)
+{
+	static const char *const names[] = {
+		[NUS_STREAM_CLOSED] = "closed",
+		[NUS_STREAM_OPENING] = "opening",
+		[NUS_STREAM_OPEN] = "open",
+		[NUS_STREAM_CLOSING] = "closing",
+	};
+
+	return state < sizeof(names) / sizeof(names[0]) ? names[state] : "?";
+}
+
+int nus_stream_format(char *buf, size_t len)
+{
+	mouthware_message_NusStreamStatus status;
+
+	nus_stream_get_status(&status);
+
+	return snprintf(buf, len,
+			"nus stream: %s, %u B received, %u forwarded, %u sent, %u failed, "
+			"%u B packets, %u refused",
+			state_name(status.state), (unsigned int)status.received,
+			(unsigned int)status.forwarded, (unsigned int)status.sent,
+			(unsigned int)status.failed, (unsigned int)status.packet_size,
+			(unsigned int)status.refused);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Bulk stream to the MouthPad over NUS, shared by both relays
+ *
+ * For transfers such as a MouthPad firmware image, where one
+ * PassThroughToMouthpad per NUS write costs a CDC0 round trip per 240
+ * bytes. The host opens the stream with NusStreamControl, then sends
+ * NusStreamWrites in order; the relay copies them into a byte ring on the
+ * CDC0 RX path and the platform's NUS TX context cuts the ring into writes
+ * without response of the link's full ATT payload (MTU - 3), keeping the
+ * NUS TX queue full. Write boundaries on the host side are not kept.
+ *
+ * Flow control is by credit: the host may send bytes up to
+ * NusStreamStatus.forwarded + window. A status goes out as each quarter of
+ * the window is forwarded, when the stream goes idle and after a refused
+ * write, so the host hears of space long before the ring runs dry. A write
+ * that arrives out of sequence or does not fit is refused, and the next
+ * status tells the host where to resume.
+ *
+ * Closing the stream drains what was received first; opening it again
+ * discards anything still queued and starts over at offset 0.
+ *
+ * nus_stream_handle() runs on the RX path, nus_stream_pump() in the NUS TX
+ * context and nus_stream_sent() wherever NUS writes complete; nothing else
+ * is locked.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef NUS_STREAM_H_
+#define NUS_STREAM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Ring bytes, and so the credit window; a power of two */
+#define NUS_STREAM_WINDOW 2048
+
+/* Largest NusStreamWrite, as in NusStreamWrite.data */
+#define NUS_STREAM_WRITE_MAX sizeof(((mouthware_message_NusStreamWrite *)0)->data.bytes)
+
+/* Largest NUS write: 247 byte ATT MTU less the write command header */
+#define NUS_STREAM_PACKET_MAX 244
+
+/* Stream writes queued or in flight at once; a power of two, and at least
+ * the platform's NUS TX window
+ */
+#define NUS_STREAM_INFLIGHT_MAX 16
+
+/* NusStreamStatus.state */
+enum nus_stream_state {
+	NUS_STREAM_CLOSED,
+	NUS_STREAM_OPENING, /* Waiting for the NUS TX context to reset the ring */
+	NUS_STREAM_OPEN,
+	NUS_STREAM_CLOSING, /* Draining what was received */
+};
+
+/* Platform side; every call but kick() comes from nus_stream_pump() */
+struct nus_stream_ops {
+	/* Bytes per NUS write on the current link, at most
+	 * NUS_STREAM_PACKET_MAX; 0 while NUS is not ready
+	 */
+	uint16_t (*packet_size)(void);
+
+	/* Queue one NUS write without response. Return 0, a positive value
+	 * while the NUS TX queue is full (retried once a write completes) or
+	 * a negative one if NUS is gone. Each write queued must later be
+	 * reported to nus_stream_sent(), in order.
+	 */
+	int (*write)(const uint8_t *data, size_t len);
+
+	/* Send a NusStreamStatus to the host */
+	void (*send_status)(const mouthware_message_NusStreamStatus *status);
+
+	/* Arrange for nus_stream_pump() to run in the NUS TX context; any
+	 * context
+	 */
+	void (*kick)(void);
+};
+
+/**
+ * @brief Install the platform hooks; call once before the first message
+ */
+void nus_stream_init(const struct nus_stream_ops *ops);
+
+/**
+ * @brief Handle NusStreamControl or NusStreamWrite
+ *
+ * Only copies and flags; cheap enough for the RX path. Register it inline
+ * for both tags.
+ *
+ * @return 0, or -1 for a write that was refused
+ */
+int nus_stream_handle(const mouthware_message_AppToRelayMessage *message);
+
+/**
+ * @brief Open or close the stream, queue NUS writes and send due statuses;
+ *        NUS TX context only
+ */
+void nus_stream_pump(void);
+
+/**
+ * @brief Report the completion of the oldest write queued by the pump
+ *
+ * @param ok false if the write failed or was dropped with the link
+ */
+void nus_stream_sent(bool ok);
+
+/**
+ * @brief Whether a stream is open or still draining
+ */
+bool nus_stream_active(void);
+
+/**
+ * @brief Current state as sent in NusStreamStatus
+ */
+void nus_stream_get_status(mouthware_message_NusStreamStatus *status);
+
+/**
+ * @brief Current state as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int nus_stream_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NUS_STREAM_H_ */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+
+#include "pairing_timing.h"
+
+static uint32_t (*clock_us)(void);
+
+static struct pairing_timing_record records[PAIRING_TIMING_RECORDS];
+static uint32_t link_up_us;
+static uint32_t next_sequence = 1;
+static size_t newest; /* Index of the newest record */
+static size_t count;  /* Records kept, including an open one */
+
+static struct pairing_timing_record *open_record(void)
+{
+	if (count == 0 || !records[newest].in_progress) {
+		return NULL;
+	}
+
+	return &records[newest];
+}
+
+void pairing_timing_init(uint32_t (*now_us)(void))
+{
+	clock_us = now_us;
+}
+
+void pairing_timing_connected(void)
+{
+	struct pairing_timing_record *record = open_record();
+
+	if (!clock_us) {
+		return;
+	}
+	/* A drop the stack never reported; that record ends here */
+	if (record) {
+		record->in_progress = false;
+	}
+
+	if (count > 0) {
+		newest = (newest + 1) % PAIRING_TIMING_RECORDS;
+	}
+	if (count < PAIRING_TIMING_RECORDS) {
+		count++;
+	}
+
+	records[newest] = (struct pairing_timing_record){
+		.sequence = next_sequence++,
+		.in_progress = true,
+	};
+	link_up_us = clock_us();
+}
+
+void pairing_timing_mark(enum pairing_timing_step step)
+{
+	struct pairing_timing_record *record = open_record();
+
+	if (!record || step >= PAIRING_TIMING_STEP_COUNT || record->step_us[step] != 0) {
+		return;
+	}
+
+	/* 0 means not reached, so a step in the first microsecond counts as 1 */
+	uint32_t elapsed = clock_us() - link_up_us;
+
+	record->step_us[step] = elapsed > 0 ? elapsed : 1;
+}
+
+void pairing_timing_failed(uint8_t reason)
+{
+	struct pairing_timing_record *record = open_record();
+
+	if (record && !record->failed) {
+		record->failed = true;
+		record->fail_reason = reason;
+	}
+}
+
+void pairing_timing_disconnected(void)
+{
+	struct pairing_timing_record *record = open_record();
+
+	if (record) {
+		record->in_progress = false;
+	}
+}
+
+size_t pairing_timing_get(struct pairing_timing_record *out)
+{
+	size_t n = count;
+
+	for (size_t i = 0; i < n; i++) {
+		size_t index = (newest + PAIRING_TIMING_RECORDS - i) % PAIRING_TIMING_RECORDS;
+
+		out[i] = records[index];
+	}
+
+	return n;
+}
+
+static const char *outcome(const struct pairing_timing_record *record)
+{
+	if (record->failed) {
+		return "failed";
+	}
+	if (record->step_us[PAIRING_TIMING_DONE] != 0) {
+		return "paired";
+	}
+	if (record->step_us[PAIRING_TIMING_ENCRYPTED] != 0) {
+		return "bonded";
+	}
+	return record->in_progress ? "pending" : "unencrypted";
+}
+
+size_t pairing_timing_format(const struct pairing_timing_record *record, char *buf, size_t size)
+{
+	static const char *const names[PAIRING_TIMING_STEP_COUNT] = {
+		[PAIRING_TIMING_REQUESTED] = "req",
+		[PAIRING_TIMING_CONFIRM] = "confirm",
+		[PAIRING_TIMING_ENCRYPTED] = "enc",
+		[PAIRING_TIMING_DONE] = "done",
+	};
+	size_t len = 0;
+	int n;
+
+	if (size == 0) {
+		return 0;
+	}
+
+	n = snprintf(buf, size, "#%u %s", (unsigned int)record->sequence, outcome(record));
+	if (n > 0) {
+		len = (size_t)n;
+	}
+	if (record->failed && len < size) {
+		n = snprintf(&buf[len], size - len, " (reason %u)", record->fail_reason);
+		if (n > 0) {
+			len += (size_t)n;
+		}
+	}
+	if (len < size) {
+		n = snprintf(&buf[len], size - len, ":");
+		if (n > 0) {
+			len += (size_t)n;
+		}
+	}
+
+	for (int step = 0; step < PAIRING_TIMING_STEP_COUNT && len < size; step++) {
+		uint32_t us = record->step_us[step];
+
+		if (us != 0) {
+			n = snprintf(&buf[len], size - len, " %s %u.%03u", names[step],
+				     (unsigned int)(us / 1000), (unsigned int)(us % 1000));
+		} else {
+			n = snprintf(&buf[len], size - len, " %s -", names[step]);
+		}
+		if (n > 0) {
+			len += (size_t)n;
+		}
+	}
+
+	return len < size ? len : size - 1;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Per-step timing of pairing and encryption on the MouthPad link,
+ *         shared by both relays
+ *
+ * connection_timing.h shows when the link was encrypted after the scan
+ * started; this splits that time up. Each link gets a record that opens
+ * when it comes up and closes when it drops, and the security code marks
+ * the steps it passes as microseconds after link up:
+ *
+ *   req      security requested, by the relay or the MouthPad
+ *   confirm  numeric comparison answered
+ *   enc      link encrypted
+ *   done     pairing complete, keys distributed
+ *
+ * A new MouthPad goes through all of them, the time between req and enc
+ * being mostly the LE Secure Connections key exchange; a bonded one is
+ * encrypted with its stored key and never reaches done. The most recent
+ * records are kept for the console.
+ *
+ * Records are written from the Bluetooth stack's context and may be read
+ * while one changes; the values are diagnostics only.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef PAIRING_TIMING_H_
+#define PAIRING_TIMING_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum pairing_timing_step {
+	PAIRING_TIMING_REQUESTED, /* Security requested */
+	PAIRING_TIMING_CONFIRM,   /* Numeric comparison answered */
+	PAIRING_TIMING_ENCRYPTED, /* Link encrypted */
+	PAIRING_TIMING_DONE,      /* Pairing complete, keys distributed */
+	PAIRING_TIMING_STEP_COUNT
+};
+
+/* Records kept, newest overwriting oldest */
+#define PAIRING_TIMING_RECORDS 4
+
+struct pairing_timing_record {
+	uint32_t sequence;                           /* Link number since boot, from 1 */
+	uint32_t step_us[PAIRING_TIMING_STEP_COUNT]; /* After link up, 0 if not reached */
+	uint8_t fail_reason;                         /* Stack's reason, when failed */
+	bool failed;
+	bool in_progress;
+};
+
+/**
+ * @brief Set the microsecond clock steps are timed with
+ *
+ * The clock may wrap; a pairing takes far less than a wrap.
+ */
+void pairing_timing_init(uint32_t (*now_us)(void));
+
+/**
+ * @brief The link came up; opens a record
+ */
+void pairing_timing_connected(void);
+
+/**
+ * @brief Record reaching a step in the open record, if not reached yet
+ */
+void pairing_timing_mark(enum pairing_timing_step step);
+
+/**
+ * @brief Pairing or encryption failed on the open record
+ *
+ * @param reason The stack's reason code, for the log
+ */
+void pairing_timing_failed(uint8_t reason);
+
+/**
+ * @brief The link dropped; closes the open record
+ */
+void pairing_timing_disconnected(void);
+
+/**
+ * @brief Copy the kept records, newest first
+ *
+ * @param out At least PAIRING_TIMING_RECORDS entries
+ * @return Records copied
+ */
+size_t pairing_timing_get(struct pairing_timing_record *out);
+
+/**
+ * @brief Format a record as one line, milliseconds after link up, e.g.
+ *        "#2 paired: req 1.204 confirm - enc 84.310 done 96.002"
+ *
+ * @return Length of the line, truncated to fit size
+ */
+size_t pairing_timing_format(const struct pairing_timing_record *record, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PAIRING_TIMING_H_ */
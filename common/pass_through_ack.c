@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "pass_through_ack.h"
+#include "MouthpadRelay.pb.h"
+
+uint32_t pass_through_ack_writes(uint32_t window)
+{
+	return window > 2 ? window / 2 : 1;
+}
+
+/* Report this completion together with everything pending */
+static struct pass_through_ack_report take(struct pass_through_ack *ack, uint32_t sequence)
+{
+	struct pass_through_ack_report report = {
+		.acked = ack->pending + 1,
+		.sequence = sequence,
+	};
+
+	ack->pending = 0;
+	return report;
+}
+
+struct pass_through_ack_report pass_through_ack_complete(struct pass_through_ack *ack,
+							 struct pass_through_ack_tag tag, bool ok,
+							 uint32_t writes)
+{
+	switch (tag.mode) {
+	case mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_NONE:
+		return (struct pass_through_ack_report){ 0 };
+	case mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_ERRORS:
+		return ok ? (struct pass_through_ack_report){ 0 } : take(ack, tag.sequence);
+	case mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_CUMULATIVE:
+		if (ok && ack->pending + 1 < writes) {
+			ack->pending++;
+			ack->sequence = tag.sequence;
+			return (struct pass_through_ack_report){ 0 };
+		}
+		return take(ack, tag.sequence);
+	default:
+		return take(ack, tag.sequence);
+	}
+}
+
+struct pass_through_ack_report pass_through_ack_flush(struct pass_through_ack *ack)
+{
+	struct pass_through_ack_report report = {
+		.acked = ack->pending,
+		.sequence = ack->sequence,
+	};
+
+	ack->pending = 0;
+	return report;
+}
+
+bool pass_through_ack_pending(const struct pass_through_ack *ack)
+{
+	return ack->pending > 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Which PassThroughToMouthpadResponse a completed write gets
+ *
+ * Each PassThroughToMouthpad names the response it wants in its ack field:
+ *
+ *   EACH        one per write, as relays without RELAY_FEATURE_PASS_THROUGH_
+ *               ACK_MODES always send
+ *   ERRORS      only if the write fails
+ *   NONE        never, not even on a failure
+ *   CUMULATIVE  one for every pass_through_ack_writes completions, or once
+ *               the oldest unreported one has waited
+ *               PASS_THROUGH_ACK_INTERVAL_US, and at once on a failure
+ *
+ * A response carries the host's sequence number of the latest write it
+ * covers and how many writes that is, so a host keeping credits counts
+ * acked instead of responses. Writes in CUMULATIVE mode that are still
+ * unreported are counted into the next response whatever its cause; an
+ * EACH or ERRORS write does not have to wait behind them. Successful
+ * ERRORS writes and all NONE writes are never counted, so a host sending
+ * them keeps its own pace within max_in_flight_writes.
+ *
+ * The platform keeps one struct pass_through_ack per MouthPad link, feeds
+ * it every write completion and refusal under its own lock, and arms a
+ * timer while pass_through_ack_pending() holds. Nothing here is
+ * thread-safe. No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef PASS_THROUGH_ACK_H_
+#define PASS_THROUGH_ACK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Longest a CUMULATIVE completion waits for its response */
+#define PASS_THROUGH_ACK_INTERVAL_US 5000
+
+/* What a queued write needs to be answered once it completes */
+struct pass_through_ack_tag {
+	uint32_t sequence;
+	uint32_t mode; /* PassThroughAckMode; unknown values are taken as EACH */
+};
+
+/* Completions of one link not reported yet */
+struct pass_through_ack {
+	uint32_t pending;
+	uint32_t sequence; /* Of the latest of them */
+};
+
+/* A response to send; none when acked is 0 */
+struct pass_through_ack_report {
+	uint32_t acked;
+	uint32_t sequence;
+};
+
+/**
+ * @brief CUMULATIVE writes one response covers on a link
+ *
+ * Half the host's credits, so it has writes left to send while the
+ * response is on its way.
+ *
+ * @param window Writes the host may keep unacknowledged on the link
+ */
+uint32_t pass_through_ack_writes(uint32_t window);
+
+/**
+ * @brief A write completed, or was refused before it was queued
+ *
+ * @param ok The write went through; intermediate fragments count as ok
+ * @param writes From pass_through_ack_writes()
+ * @return The response to send now, if any
+ */
+struct pass_through_ack_report pass_through_ack_complete(struct pass_through_ack *ack,
+							 struct pass_through_ack_tag tag, bool ok,
+							 uint32_t writes);
+
+/**
+ * @brief The interval ran out; report what is pending
+ *
+ * @return The response to send, if any
+ */
+struct pass_through_ack_report pass_through_ack_flush(struct pass_through_ack *ack);
+
+/* Completions are waiting for a flush */
+bool pass_through_ack_pending(const struct pass_through_ack *ack);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PASS_THROUGH_ACK_H_ */
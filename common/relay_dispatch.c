@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "relay_dispatch.h"
+#include "pb_decode.h"
+
+_Static_assert((RELAY_DISPATCH_QUEUE_LEN & (RELAY_DISPATCH_QUEUE_LEN - 1)) == 0,
+	       "RELAY_DISPATCH_QUEUE_LEN must be a power of two");
+
+#define PASS_THROUGH_TAG mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag
+
+static struct relay_dispatch_config cfg;
+
+static struct relay_dispatch_stats stats[RELAY_DISPATCH_TAG_COUNT];
+
+/* Decoded on the RX path, then run there or copied into the queue */
+static mouthware_message_AppToRelayMessage rx_message;
+
+static mouthware_message_AppToRelayMessage queue[RELAY_DISPATCH_QUEUE_LEN];
+static uint32_t queued_at_us[RELAY_DISPATCH_QUEUE_LEN];
+static atomic_uint queue_head; /* Written by the RX path only */
+static atomic_uint queue_tail; /* Written by relay_dispatch_run() only */
+
+static atomic_bool host_channels; /* Last payload had a channel header */
+
+/* The request each context's handler is running, for relay_dispatch_request_id().
+ * Each entry is written by its own context only; others just find that
+ * context does not match theirs.
+ */
+enum { ACTIVE_RX, ACTIVE_QUEUE, ACTIVE_COUNT };
+
+static struct {
+	atomic_uintptr_t context; /* 0 while no request with an ID is running */
+	uint32_t request_id;
+} active[ACTIVE_COUNT];
+
+static uint32_t now_us(void)
+{
+	return cfg.now_us ? cfg.now_us() : 0;
+}
+
+static void record(pb_size_t tag, uint32_t start_us, int err)
+{
+	struct relay_dispatch_stats *s = &stats[tag];
+	uint32_t elapsed = now_us() - start_us;
+
+	if (err) {
+		s->failed++;
+	} else {
+		s->handled++;
+	}
+	s->total_us += elapsed;
+	if (elapsed > s->max_us) {
+		s->max_us = elapsed;
+	}
+}
+
+static int run_pass_through(const struct mouthpad_pass_through_to_mouthpad *pass_through)
+{
+	uint32_t start = now_us();
+	int err = cfg.pass_through(pass_through);
+
+	record(PASS_THROUGH_TAG, start, err);
+	return err;
+}
+
+static void reject(const mouthware_message_AppToRelayMessage *message,
+		   mouthware_message_RequestErrorCode code)
+{
+	if (message->request_id && cfg.reject) {
+		cfg.reject(message->request_id, message->which_message_body, code);
+	}
+}
+
+static int run_handler(const mouthware_message_AppToRelayMessage *message, unsigned int slot)
+{
+	bool tracked = message->request_id && cfg.context;
+
+	if (tracked) {
+		active[slot].request_id = message->request_id;
+		atomic_store_explicit(&active[slot].context, (uintptr_t)cfg.context(),
+				      memory_order_release);
+	}
+
+	uint32_t start = now_us();
+	int err = cfg.table[message->which_message_body].handler(message);
+
+	record(message->which_message_body, start, err);
+
+	if (tracked) {
+		atomic_store_explicit(&active[slot].context, 0, memory_order_relaxed);
+	}
+	if (err) {
+		reject(message, mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_FAILED);
+	}
+	return err;
+}
+
+void relay_dispatch_init(const struct relay_dispatch_config *config)
+{
+	cfg = *config;
+}
+
+enum relay_dispatch_result relay_dispatch_submit(const uint8_t *frame, size_t len)
+{
+	struct mouthpad_pass_through_to_mouthpad pass_through;
+	struct mouthpad_channel_frame channel;
+	bool channels = mouthpad_channel_parse(frame, len, &channel);
+
+	atomic_store_explicit(&host_channels, channels, memory_order_relaxed);
+	if (channels) {
+		switch (channel.channel) {
+		case MOUTHPAD_CHANNEL_NUS:
+			if (channel.len == 0 ||
+			    channel.len > pb_membersize(mouthware_message_PassThroughToMouthpad_data_t,
+							bytes)) {
+				return RELAY_DISPATCH_DECODE_ERROR;
+			}
+			pass_through = (struct mouthpad_pass_through_to_mouthpad){
+				.data = channel.data,
+				.len = channel.len,
+				.device_index = channel.device_index,
+				.ack = mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_NONE,
+			};
+			return run_pass_through(&pass_through) ? RELAY_DISPATCH_FAILED
+							       : RELAY_DISPATCH_DONE;
+		case MOUTHPAD_CHANNEL_CONTROL:
+			frame = channel.data;
+			len = channel.len;
+			break;
+		default:
+			return RELAY_DISPATCH_UNHANDLED;
+		}
+	}
+
+	/* Host->MouthPad writes go out straight from the frame buffer */
+	if (mouthpad_pass_through_to_mouthpad_peek(frame, len, &pass_through)) {
+		return run_pass_through(&pass_through) ? RELAY_DISPATCH_FAILED : RELAY_DISPATCH_DONE;
+	}
+
+	pb_istream_t stream = pb_istream_from_buffer(frame, len);
+
+	if (!pb_decode(&stream, mouthware_message_AppToRelayMessage_fields, &rx_message)) {
+		return RELAY_DISPATCH_DECODE_ERROR;
+	}
+
+	pb_size_t tag = rx_message.which_message_body;
+
+	if (tag == PASS_THROUGH_TAG) {
+		/* Only encodings the peek leaves to nanopb get here */
+		const mouthware_message_PassThroughToMouthpad *pt =
+			&rx_message.message_body.pass_through_to_mouthpad;
+
+		pass_through = (struct mouthpad_pass_through_to_mouthpad){
+			.data = pt->data.bytes,
+			.len = pt->data.size,
+			.reliable = pt->reliable,
+			.more_fragments = pt->more_fragments,
+			.fragment = pt->fragment,
+			.device_index = pt->device_index,
+			.ack = pt->ack,
+			.sequence = pt->sequence,
+		};
+		return run_pass_through(&pass_through) ? RELAY_DISPATCH_FAILED : RELAY_DISPATCH_DONE;
+	}
+
+	if (tag >= RELAY_DISPATCH_TAG_COUNT || !cfg.table[tag].handler) {
+		reject(&rx_message, mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_UNSUPPORTED);
+		return RELAY_DISPATCH_UNHANDLED;
+	}
+
+	if (cfg.table[tag].run_inline) {
+		return run_handler(&rx_message, ACTIVE_RX) ? RELAY_DISPATCH_FAILED
+							   : RELAY_DISPATCH_DONE;
+	}
+
+	unsigned int head = atomic_load_explicit(&queue_head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&queue_tail, memory_order_acquire);
+
+	if (head - tail >= RELAY_DISPATCH_QUEUE_LEN) {
+		stats[tag].dropped++;
+		reject(&rx_message, mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_BUSY);
+		return RELAY_DISPATCH_FULL;
+	}
+
+	unsigned int slot = head & (RELAY_DISPATCH_QUEUE_LEN - 1);
+
+	queue[slot] = rx_message;
+	queued_at_us[slot] = now_us();
+	atomic_store_explicit(&queue_head, head + 1, memory_order_release);
+
+	cfg.kick();
+	return RELAY_DISPATCH_QUEUED;
+}
+
+void relay_dispatch_run(void)
+{
+	unsigned int tail = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+
+	while (tail != atomic_load_explicit(&queue_head, memory_order_acquire)) {
+		unsigned int slot = tail & (RELAY_DISPATCH_QUEUE_LEN - 1);
+		const mouthware_message_AppToRelayMessage *message = &queue[slot];
+		struct relay_dispatch_stats *s = &stats[message->which_message_body];
+		uint32_t wait = now_us() - queued_at_us[slot];
+
+		if (wait > s->max_wait_us) {
+			s->max_wait_us = wait;
+		}
+		run_handler(message, ACTIVE_QUEUE);
+
+		atomic_store_explicit(&queue_tail, ++tail, memory_order_release);
+	}
+}
+
+bool relay_dispatch_channels(void)
+{
+	return atomic_load_explicit(&host_channels, memory_order_relaxed);
+}
+
+uint32_t relay_dispatch_request_id(void)
+{
+	if (!cfg.context) {
+		return 0;
+	}
+
+	uintptr_t self = (uintptr_t)cfg.context();
+
+	for (unsigned int i = 0; i < ACTIVE_COUNT; i++) {
+		if (atomic_load_explicit(&active[i].context, memory_order_acquire) == self) {
+			return active[i].request_id;
+		}
+	}
+	return 0;
+}
+
+size_t relay_dispatch_queued(void)
+{
+	return atomic_load_explicit(&queue_head, memory_order_relaxed) -
+	       atomic_load_explicit(&queue_tail, memory_order_relaxed);
+}
+
+const char *relay_dispatch_get_stats(pb_size_t tag, struct relay_dispatch_stats *out)
+{
+	const char *name = NULL;
+
+	if (tag == PASS_THROUGH_TAG) {
+		name = "pass_through";
+	} else if (tag < RELAY_DISPATCH_TAG_COUNT && cfg.table && cfg.table[tag].handler) {
+		name = cfg.table[tag].name;
+	}
+
+	if (name && out) {
+		*out = stats[tag];
+	}
+	return name;
+}
+
+void relay_dispatch_reset_stats(void)
+{
+	memset(stats, 0, sizeof(stats));
+}
+
+size_t relay_dispatch_format(pb_size_t tag, char *buf, size_t size)
+{
+	struct relay_dispatch_stats s;
+	const char *name = relay_dispatch_get_stats(tag, &s);
+	uint32_t runs;
+
+	if (size == 0 || !name) {
+		return 0;
+	}
+
+	runs = s.handled + s.failed;
+	if (runs == 0 && s.dropped == 0) {
+		return 0;
+	}
+
+	int n = snprintf(buf, size, "%s: %u ok %u failed %u dropped, avg %u max %u wait %u us",
+			 name, (unsigned int)s.handled, (unsigned int)s.failed,
+			 (unsigned int)s.dropped,
+			 (unsigned int)(runs ? s.total_us / runs : 0), (unsigned int)s.max_us,
+			 (unsigned int)s.max_wait_us);
+
+	if (n < 0) {
+		buf[0] = '\0';
+		return 0;
+	}
+	return (size_t)n < size ? (size_t)n : size - 1;
+}
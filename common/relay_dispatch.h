@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Table-driven dispatch of AppToRelayMessages from CDC0
+ *
+ * The CDC0 RX path hands every deframed payload to relay_dispatch_submit().
+ * Host->MouthPad writes are peeked (see mouthpad_pass_through.h), or failing
+ * that decoded, and forwarded on the spot. So are writes on the raw NUS
+ * channel (mouthpad_frame.h), which go out unacknowledged, as with
+ * PASS_THROUGH_ACK_NONE; control channel payloads are unwrapped and
+ * handled like bare ones. Every other message is decoded and
+ * looked up by which_message_body in the platform's handler table. Entries
+ * marked inline run on the RX path too. The rest are copied into a short
+ * queue and run by relay_dispatch_run() from the platform's protocol
+ * context, so a slow handler (a settings erase, assembling DIS strings)
+ * never holds up byte parsing.
+ *
+ * A request may carry a request_id, which the relay echoes in its reply so
+ * the host can keep several requests in flight and match the replies.
+ * While a handler runs, relay_dispatch_request_id() returns its request's
+ * ID to the calling thread, and the platform's send path stamps it into
+ * every RelayToAppMessage that thread builds; replies sent later from
+ * another context carry 0. A request with an ID that is dropped for a full
+ * queue, has no handler, or whose handler fails is answered with a
+ * RequestError instead. PassThroughToMouthpad writes are answered by
+ * PassThroughToMouthpadResponse as their writes complete, and their
+ * request_id is ignored.
+ *
+ * The queue has one producer, the RX path, and one consumer, the protocol
+ * context. Each message type keeps counters: handled, failed, dropped
+ * because the queue was full, and the worst and total handler time plus the
+ * worst time spent queued. They are written without locks and are
+ * diagnostics only.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef RELAY_DISPATCH_H_
+#define RELAY_DISPATCH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+#include "mouthpad_frame.h"
+#include "mouthpad_pass_through.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Table size; every AppToRelayMessage body tag must be below it. Declare
+ * tables with this many entries so one that is not fails to compile.
+ */
+#define RELAY_DISPATCH_TAG_COUNT 32
+
+/* Control messages waiting for the protocol context; further ones are
+ * dropped. Room for a host to pipeline a refresh's worth of requests.
+ */
+#define RELAY_DISPATCH_QUEUE_LEN 8
+
+/**
+ * @brief Handle one decoded message
+ *
+ * @return 0 on success; anything else is counted as a failure
+ */
+typedef int (*relay_dispatch_handler_t)(const mouthware_message_AppToRelayMessage *message);
+
+struct relay_dispatch_entry {
+	const char *name;                 /* For logs and the stats listing */
+	relay_dispatch_handler_t handler;
+	bool run_inline;                  /* Cheap enough for the RX path */
+};
+
+struct relay_dispatch_config {
+	/* RELAY_DISPATCH_TAG_COUNT entries indexed by which_message_body;
+	 * NULL handlers are reported as unhandled
+	 */
+	const struct relay_dispatch_entry *table;
+
+	/* Host->MouthPad write, run on the RX path; same return as a handler */
+	int (*pass_through)(const struct mouthpad_pass_through_to_mouthpad *pass_through);
+
+	/* A message was queued: arrange for relay_dispatch_run() to be called */
+	void (*kick)(void);
+
+	/* Microsecond clock for the handler timings; may wrap */
+	uint32_t (*now_us)(void);
+
+	/* The calling thread or task, for relay_dispatch_request_id(); NULL
+	 * makes that always return 0
+	 */
+	void *(*context)(void);
+
+	/* Send a RequestError for a request with a request_id; may be NULL.
+	 * Called on the context that refused or ran the request.
+	 */
+	void (*reject)(uint32_t request_id, pb_size_t tag, mouthware_message_RequestErrorCode code);
+};
+
+enum relay_dispatch_result {
+	RELAY_DISPATCH_DONE,      /* Handled on the RX path */
+	RELAY_DISPATCH_QUEUED,    /* Handed to the protocol context */
+	RELAY_DISPATCH_DECODE_ERROR,
+	RELAY_DISPATCH_UNHANDLED, /* No handler for this message */
+	RELAY_DISPATCH_FULL,      /* Queue full; the message was dropped */
+	RELAY_DISPATCH_FAILED,    /* Handled on the RX path, which reported an error */
+};
+
+struct relay_dispatch_stats {
+	uint32_t handled;
+	uint32_t failed;
+	uint32_t dropped;
+	uint32_t max_us;       /* Longest handler run */
+	uint64_t total_us;     /* All handler runs */
+	uint32_t max_wait_us;  /* Longest time in the queue, queued messages only */
+};
+
+/**
+ * @brief Install the handler table and platform hooks
+ *
+ * Must be called before the first relay_dispatch_submit(). The config is
+ * copied; the table it points to must stay valid.
+ */
+void relay_dispatch_init(const struct relay_dispatch_config *config);
+
+/**
+ * @brief Dispatch one deframed CDC0 payload; call from the RX path only
+ */
+enum relay_dispatch_result relay_dispatch_submit(const uint8_t *frame, size_t len);
+
+/**
+ * @brief Whether the last payload submitted had a channel header
+ *
+ * While it did, the platform sends MouthPad notifications on
+ * MOUTHPAD_CHANNEL_NUS instead of as PassThroughToApp. Any context.
+ */
+bool relay_dispatch_channels(void);
+
+/**
+ * @brief Run queued messages until the queue is empty
+ *
+ * Call from the protocol context only, after each kick. Runs anything
+ * queued while it is already draining, too.
+ */
+void relay_dispatch_run(void);
+
+/**
+ * @brief request_id of the message whose handler is running on the calling
+ *        thread, or 0 if there is none or it had no ID; safe from any thread
+ */
+uint32_t relay_dispatch_request_id(void);
+
+/**
+ * @brief Messages waiting for the protocol context; safe from any thread
+ */
+size_t relay_dispatch_queued(void);
+
+/**
+ * @brief Counters for one message type
+ *
+ * @return Entry name ("pass_through" for host->MouthPad writes), or NULL if
+ *         the tag has no handler
+ */
+const char *relay_dispatch_get_stats(pb_size_t tag, struct relay_dispatch_stats *stats);
+
+void relay_dispatch_reset_stats(void);
+
+/**
+ * @brief Format the counters for one tag as one line, e.g.
+ *        "device_info_read: 3 ok 0 failed 0 dropped, avg 412 max 1630 wait 2210 us"
+ *
+ * @return Length of the line, truncated to fit size; 0 if the tag has no
+ *         handler or nothing was recorded for it
+ */
+size_t relay_dispatch_format(pb_size_t tag, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_DISPATCH_H_ */
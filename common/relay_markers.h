@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief SystemView marker IDs shared by both relays
+ *
+ * The trace builds put a start/stop marker pair around each hot path so an
+ * offline SystemView timeline shows which thread ran it and what preempted
+ * it. Both relays use the same IDs and names, so their recordings line up.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef RELAY_MARKERS_H_
+#define RELAY_MARKERS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum relay_marker {
+	RELAY_MARKER_HID_INPUT,    /* MouthPad HID report to USB (hogp_notify_cb, transport_hid_handle_input) */
+	RELAY_MARKER_DEFRAME,      /* One USB read through the relay deframer */
+	RELAY_MARKER_PB_DECODE,    /* AppToRelayMessage decode and dispatch */
+	RELAY_MARKER_PB_ENCODE,    /* RelayToAppMessage encode into the TX path */
+	RELAY_MARKER_NUS_TX,       /* GATT write of host data to the MouthPad NUS */
+	RELAY_MARKER_COUNT,
+};
+
+static inline const char *relay_marker_name(enum relay_marker marker)
+{
+	static const char *const names[] = {
+		[RELAY_MARKER_HID_INPUT] = "HID input",
+		[RELAY_MARKER_DEFRAME] = "Deframe",
+		[RELAY_MARKER_PB_DECODE] = "PB decode",
+		[RELAY_MARKER_PB_ENCODE] = "PB encode",
+		[RELAY_MARKER_NUS_TX] = "NUS TX",
+	};
+
+	return marker < RELAY_MARKER_COUNT ? names[marker] : "?";
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_MARKERS_H_ */
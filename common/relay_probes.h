@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief GPIO probe points shared by both relays
+ *
+ * The probe builds give each point its own GPIO and toggle it every time
+ * the point is passed, so every edge on a logic analyzer or a PPK2's
+ * digital inputs is one event, with no logging in the way. The time from
+ * an edge on HID_RX to the next edge on USB_DONE is one report through
+ * the relay. Both relays use the same points in the same order, so one
+ * capture setup fits either.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef RELAY_PROBES_H_
+#define RELAY_PROBES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum relay_probe {
+	RELAY_PROBE_HID_RX,     /* MouthPad HID notification received */
+	RELAY_PROBE_USB_SUBMIT, /* HID input report handed to the USB stack */
+	RELAY_PROBE_USB_DONE,   /* HID IN transfer completed */
+	RELAY_PROBE_FRAME_RX,   /* Relay frame from the host decoded */
+	RELAY_PROBE_NUS_TX,     /* GATT write to the MouthPad NUS issued */
+	RELAY_PROBE_COUNT,
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_PROBES_H_ */
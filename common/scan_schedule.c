@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "scan_schedule.h"
+
+void scan_schedule_init(struct scan_schedule *schedule, const struct scan_schedule_config *config,
+			int64_t now_ms)
+{
+	schedule->config = *config;
+	schedule->boosted_ms = now_ms;
+}
+
+bool scan_schedule_boost(struct scan_schedule *schedule, int64_t now_ms)
+{
+	const struct scan_schedule_config *config = &schedule->config;
+	bool backed_off = config->interval_min &&
+			  now_ms - schedule->boosted_ms >= (int64_t)config->fast_ms;
+
+	schedule->boosted_ms = now_ms;
+	return backed_off;
+}
+
+struct scan_schedule_params scan_schedule_get(const struct scan_schedule *schedule, int64_t now_ms)
+{
+	const struct scan_schedule_config *config = &schedule->config;
+	int64_t elapsed = now_ms - schedule->boosted_ms;
+
+	if (!config->interval_min) {
+		return (struct scan_schedule_params){ config->fast_interval, config->fast_window, 0 };
+	}
+	if (elapsed < (int64_t)config->fast_ms) {
+		return (struct scan_schedule_params){ config->fast_interval, config->fast_window,
+						      (uint32_t)(config->fast_ms - elapsed) };
+	}
+
+	elapsed -= config->fast_ms;
+
+	struct scan_schedule_params params = { .interval = config->interval_min };
+	uint32_t steps = config->step_ms ? (uint32_t)(elapsed / config->step_ms) : UINT32_MAX;
+
+	/* Double per step until the next doubling would pass interval_max */
+	while (steps && params.interval < config->interval_max) {
+		params.interval = params.interval > config->interval_max / 2 ?
+					  config->interval_max : params.interval * 2;
+		steps--;
+	}
+	if (params.interval < config->interval_max) {
+		params.next_ms = config->step_ms - (uint32_t)(elapsed % config->step_ms);
+	}
+
+	params.window = config->window < params.interval ? config->window : params.interval;
+	return params;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Scan duty cycle while no MouthPad is connected
+ *
+ * A boost (boot, a disconnection, a button press, USB resume or a host's
+ * BleConnectionStatusRead with scan_boost) starts fast_ms of scanning with
+ * the platform's full-rate parameters. After that the scan keeps a short
+ * window and its interval starts at interval_min, doubling every step_ms
+ * until it reaches interval_max, where it stays until the next boost. A
+ * MouthPad taken out of its case is still found within an interval, and
+ * one left in it no longer keeps the radio on for hours.
+ *
+ * Intervals and windows are in the controller's 0.625 ms units. An
+ * interval_min of 0 disables the backoff. The platform re-reads the
+ * parameters when scan_schedule_get() said they would change, and
+ * restarts its scan with them. Nothing here is thread-safe. No Zephyr or
+ * ESP-IDF headers may be pulled in.
+ */
+
+#ifndef SCAN_SCHEDULE_H_
+#define SCAN_SCHEDULE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Convert milliseconds to 0.625 ms scan units */
+#define SCAN_SCHEDULE_UNITS(ms) ((uint16_t)((ms) * 8 / 5))
+
+struct scan_schedule_config {
+	uint32_t fast_ms;       /* Full rate after a boost */
+	uint32_t step_ms;       /* Time spent at each backoff interval */
+	uint16_t fast_interval;
+	uint16_t fast_window;
+	uint16_t window;        /* Backoff window */
+	uint16_t interval_min;  /* First backoff interval; 0 never backs off */
+	uint16_t interval_max;  /* Longest backoff interval */
+};
+
+struct scan_schedule {
+	struct scan_schedule_config config;
+	int64_t boosted_ms;
+};
+
+struct scan_schedule_params {
+	uint16_t interval;
+	uint16_t window;
+	uint32_t next_ms; /* Until interval or window change; 0 if they never do */
+};
+
+/* Starts boosted at now_ms */
+void scan_schedule_init(struct scan_schedule *schedule, const struct scan_schedule_config *config,
+			int64_t now_ms);
+
+/**
+ * @brief Go back to full rate for fast_ms
+ *
+ * @return The scan was backed off and has to be restarted to pick it up
+ */
+bool scan_schedule_boost(struct scan_schedule *schedule, int64_t now_ms);
+
+/* Parameters for a scan starting at now_ms */
+struct scan_schedule_params scan_schedule_get(const struct scan_schedule *schedule, int64_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCAN_SCHEDULE_H_ */
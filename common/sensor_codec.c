@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sensor_codec.h"
+#include "sensor_stream.h"
+
+static atomic_bool enabled;
+static atomic_uint keyframe_interval = SENSOR_CODEC_KEYFRAME_INTERVAL_DEFAULT;
+static atomic_bool resync_pending = true;
+
+static atomic_uint frames;
+static atomic_uint keyframes;
+static atomic_uint raw_bytes;
+static atomic_uint coded_bytes;
+
+/* Encoder state, owned by the one caller of sensor_codec_encode() */
+static uint8_t reference[SENSOR_CODEC_FRAME_MAX];
+static size_t reference_len;
+static uint32_t since_keyframe;
+static uint32_t sequence;
+
+static uint16_t word_at(const uint8_t *frame, size_t len, size_t i)
+{
+	uint16_t word = frame[2 * i];
+
+	if (2 * i + 1 < len) {
+		word |= (uint16_t)(frame[2 * i + 1] << 8);
+	}
+	return word;
+}
+
+static void word_put(uint8_t *frame, size_t len, size_t i, uint16_t word)
+{
+	frame[2 * i] = (uint8_t)word;
+	if (2 * i + 1 < len) {
+		frame[2 * i + 1] = (uint8_t)(word >> 8);
+	}
+}
+
+static size_t varint_size(uint32_t value)
+{
+	size_t n = 1;
+
+	while (value >= 0x80) {
+		value >>= 7;
+		n++;
+	}
+	return n;
+}
+
+static size_t varint_put(uint8_t *out, uint32_t value)
+{
+	size_t n = 0;
+
+	while (value >= 0x80) {
+		out[n++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	out[n++] = (uint8_t)value;
+	return n;
+}
+
+/* Delta tokens for data against the reference, or len if they would not
+ * be shorter than the frame itself
+ */
+static size_t encode_delta(const uint8_t *data, size_t len, uint8_t *out)
+{
+	size_t words = (len + 1) / 2;
+	size_t n = 0;
+	uint32_t run = 0;
+
+	for (size_t i = 0; i < words; i++) {
+		int16_t diff = (int16_t)(word_at(data, len, i) - word_at(reference, len, i));
+		uint32_t zigzag;
+		uint32_t token;
+
+		if (diff == 0) {
+			run++;
+			continue;
+		}
+		if (run > 0) {
+			if (n + varint_size(run << 1) >= len) {
+				return len;
+			}
+			n += varint_put(&out[n], run << 1);
+			run = 0;
+		}
+
+		zigzag = (uint16_t)(((uint16_t)diff << 1) ^ (uint16_t)(diff >> 15));
+		token = (zigzag << 1) | 1;
+		if (n + varint_size(token) >= len) {
+			return len;
+		}
+		n += varint_put(&out[n], token);
+	}
+	return n;
+}
+
+void sensor_codec_configure(bool enable, uint32_t interval)
+{
+	atomic_store_explicit(&keyframe_interval,
+			      interval ? interval : SENSOR_CODEC_KEYFRAME_INTERVAL_DEFAULT,
+			      memory_order_relaxed);
+	atomic_store_explicit(&resync_pending, true, memory_order_relaxed);
+	atomic_store_explicit(&enabled, enable, memory_order_relaxed);
+}
+
+bool sensor_codec_enabled(void)
+{
+	return atomic_load_explicit(&enabled, memory_order_relaxed);
+}
+
+bool sensor_codec_wants(const uint8_t *data, size_t len)
+{
+	return sensor_codec_enabled() && len <= SENSOR_CODEC_FRAME_MAX &&
+	       sensor_stream_classify(data, len) == mouthware_message_SensorStream_SENSOR_STREAM_SENSOR;
+}
+
+bool sensor_codec_encode(const uint8_t *data, size_t len, mouthware_message_SensorFrameDelta *out)
+{
+	bool keyframe;
+	size_t coded = len;
+
+	if (!sensor_codec_wants(data, len)) {
+		return false;
+	}
+
+	keyframe = atomic_exchange_explicit(&resync_pending, false, memory_order_relaxed) ||
+		   len != reference_len ||
+		   since_keyframe >= atomic_load_explicit(&keyframe_interval, memory_order_relaxed);
+	if (!keyframe) {
+		coded = encode_delta(data, len, out->data.bytes);
+		keyframe = coded >= len;
+	}
+
+	if (keyframe) {
+		memcpy(out->data.bytes, data, len);
+		coded = len;
+		since_keyframe = 0;
+		atomic_fetch_add_explicit(&keyframes, 1, memory_order_relaxed);
+	} else {
+		since_keyframe++;
+	}
+	memcpy(reference, data, len);
+	reference_len = len;
+
+	out->sequence = sequence++;
+	out->keyframe = keyframe;
+	out->data.size = (pb_size_t)coded;
+
+	atomic_fetch_add_explicit(&frames, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&raw_bytes, len, memory_order_relaxed);
+	atomic_fetch_add_explicit(&coded_bytes, coded, memory_order_relaxed);
+	return true;
+}
+
+void sensor_codec_resync(void)
+{
+	atomic_store_explicit(&resync_pending, true, memory_order_relaxed);
+}
+
+void sensor_codec_get_status(mouthware_message_SensorCodecConfigResponse *response)
+{
+	response->enabled = sensor_codec_enabled();
+	response->keyframe_interval = atomic_load_explicit(&keyframe_interval, memory_order_relaxed);
+	response->frames = atomic_load_explicit(&frames, memory_order_relaxed);
+	response->keyframes = atomic_load_explicit(&keyframes, memory_order_relaxed);
+	response->raw_bytes = atomic_load_explicit(&raw_bytes, memory_order_relaxed);
+	response->coded_bytes = atomic_load_explicit(&coded_bytes, memory_order_relaxed);
+}
+
+int sensor_codec_format(char *buf, size_t len)
+{
+	mouthware_message_SensorCodecConfigResponse status;
+
+	sensor_codec_get_status(&status);
+
+	return snprintf(buf, len,
+			"codec: %s, keyframe every %u, %u frames (%u keyframes), %u -> %u bytes",
+			status.enabled ? "on" : "off", (unsigned int)status.keyframe_interval,
+			(unsigned int)status.frames, (unsigned int)status.keyframes,
+			(unsigned int)status.raw_bytes, (unsigned int)status.coded_bytes);
+}
+
+void sensor_codec_decoder_init(struct sensor_codec_decoder *decoder)
+{
+	memset(decoder, 0, sizeof(*decoder));
+}
+
+static bool varint_get(const uint8_t **pos, const uint8_t *end, uint32_t *value)
+{
+	uint32_t result = 0;
+
+	for (unsigned int shift = 0; shift < 21 && *pos < end; shift += 7) {
+		uint8_t byte = *(*pos)++;
+
+		result |= (uint32_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool apply_delta(struct sensor_codec_decoder *decoder, const uint8_t *pos, const uint8_t *end)
+{
+	size_t words = (decoder->len + 1) / 2;
+	size_t i = 0;
+	uint32_t token;
+
+	while (pos < end) {
+		if (!varint_get(&pos, end, &token)) {
+			return false;
+		}
+		if (!(token & 1)) {
+			i += token >> 1;
+			if (i > words) {
+				return false;
+			}
+			continue;
+		}
+
+		uint32_t zigzag = token >> 1;
+
+		if (i >= words || zigzag > UINT16_MAX) {
+			return false;
+		}
+		uint16_t diff = (uint16_t)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+
+		word_put(decoder->frame, decoder->len, i,
+			 (uint16_t)(word_at(decoder->frame, decoder->len, i) + diff));
+		i++;
+	}
+	return true;
+}
+
+size_t sensor_codec_decode(struct sensor_codec_decoder *decoder,
+			   const mouthware_message_SensorFrameDelta *in)
+{
+	if (in->keyframe) {
+		if (in->data.size == 0 || in->data.size > SENSOR_CODEC_FRAME_MAX) {
+			decoder->errors++;
+			decoder->len = 0;
+			return 0;
+		}
+		memcpy(decoder->frame, in->data.bytes, in->data.size);
+		decoder->len = in->data.size;
+		decoder->sequence = in->sequence;
+		return decoder->len;
+	}
+
+	if (decoder->len == 0 || in->sequence != decoder->sequence + 1) {
+		decoder->skipped++;
+		decoder->len = 0;
+		return 0;
+	}
+	if (!apply_delta(decoder, in->data.bytes, in->data.bytes + in->data.size)) {
+		decoder->errors++;
+		decoder->len = 0;
+		return 0;
+	}
+	decoder->sequence = in->sequence;
+	return decoder->len;
+}
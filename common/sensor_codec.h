@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Delta codec for MouthPad sensor frames, shared by both relays and
+ *         the host library
+ *
+ * Sensor frames (SENSOR_STREAM_SENSOR in sensor_stream.h) carry the
+ * capacitive cells and the other sensor values as little-endian 16-bit
+ * words, most of which change little from one frame to the next. With the
+ * codec enabled by SensorCodecConfigWrite, the relay sends each sensor frame
+ * from the primary MouthPad as a SensorFrameDelta: a keyframe holding the
+ * whole frame, or the difference from the frame before it.
+ *
+ * A delta is a list of unsigned varint tokens over the frame's words, the
+ * last word being a single byte when the length is odd:
+ *
+ *   token even  (token >> 1) words unchanged
+ *   token odd   the next word changed by zig-zag (token >> 1), modulo 2^16
+ *
+ * Words after the last token are unchanged. A delta always has the length
+ * of the frame it follows.
+ *
+ * The relay sends a keyframe first, after keyframe_interval deltas, when the
+ * length changes, when the delta would not be smaller than the frame, and
+ * after any frame it could not queue for CDC0. The host drops deltas from a
+ * SensorFrameDelta.sequence gap until the next keyframe.
+ *
+ * The encoder has one caller, the primary MouthPad's NUS receive path; the
+ * configuration and counters are atomics any context may touch. Decoders
+ * are per host connection.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef SENSOR_CODEC_H_
+#define SENSOR_CODEC_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Longest frame coded; longer notifications still go as PassThroughToApp */
+#define SENSOR_CODEC_FRAME_MAX                                                                 \
+	pb_membersize(mouthware_message_SensorFrameDelta_data_t, bytes)
+
+#define SENSOR_CODEC_KEYFRAME_INTERVAL_DEFAULT 32
+
+/**
+ * @brief Apply a SensorCodecConfigWrite
+ *
+ * The next frame coded is a keyframe.
+ *
+ * @param interval Frames per keyframe, 0 for SENSOR_CODEC_KEYFRAME_INTERVAL_DEFAULT
+ */
+void sensor_codec_configure(bool enable, uint32_t interval);
+
+bool sensor_codec_enabled(void);
+
+/**
+ * @brief Whether a primary MouthPad notification goes through the codec
+ *
+ * @return false if it must go as PassThroughToApp instead: the codec is
+ *         off, or it is not a sensor frame of at most SENSOR_CODEC_FRAME_MAX
+ *         bytes
+ */
+bool sensor_codec_wants(const uint8_t *data, size_t len);
+
+/**
+ * @brief Code a notification sensor_codec_wants() accepted
+ *
+ * @return false, leaving out untouched, if the notification is not one
+ *         sensor_codec_wants() accepts
+ */
+bool sensor_codec_encode(const uint8_t *data, size_t len, mouthware_message_SensorFrameDelta *out);
+
+/**
+ * @brief The last coded frame never reached the host; send a keyframe next
+ */
+void sensor_codec_resync(void);
+
+/**
+ * @brief Fill in a SensorCodecConfigResponse
+ */
+void sensor_codec_get_status(mouthware_message_SensorCodecConfigResponse *response);
+
+/**
+ * @brief Configuration and counters as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int sensor_codec_format(char *buf, size_t len);
+
+struct sensor_codec_decoder {
+	uint8_t frame[SENSOR_CODEC_FRAME_MAX]; /* Last frame decoded */
+	size_t len; /* 0 until a keyframe arrives */
+	uint32_t sequence; /* Of the last frame decoded */
+	uint32_t skipped; /* Deltas dropped waiting for a keyframe */
+	uint32_t errors; /* Malformed deltas */
+};
+
+void sensor_codec_decoder_init(struct sensor_codec_decoder *decoder);
+
+/**
+ * @brief Rebuild the sensor frame a SensorFrameDelta stands for
+ *
+ * @return Length of the frame now in decoder->frame, or 0 if this delta
+ *         cannot be decoded and the host must wait for a keyframe
+ */
+size_t sensor_codec_decode(struct sensor_codec_decoder *decoder,
+			   const mouthware_message_SensorFrameDelta *in);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSOR_CODEC_H_ */
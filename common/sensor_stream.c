@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "sensor_stream.h"
+
+static atomic_uint blocked;
+static atomic_uint forwarded[SENSOR_STREAM_COUNT];
+static atomic_uint dropped[SENSOR_STREAM_COUNT];
+
+static atomic_uint keep_one_in[SENSOR_STREAM_COUNT];
+static atomic_uint min_interval_us[SENSOR_STREAM_COUNT];
+static atomic_uint rate_epoch[SENSOR_STREAM_COUNT]; /* Bumped by each SensorStreamRateWrite */
+static atomic_uint thinned[SENSOR_STREAM_COUNT];
+
+/* Per MouthPad and stream, owned by that MouthPad's sensor_stream_admit() caller */
+struct rate_state {
+	uint32_t epoch; /* Limits this state was built under */
+	uint32_t phase; /* Notifications since the last one kept, modulo keep_one_in */
+	uint64_t due_us; /* When the next notification may be forwarded */
+};
+
+static struct rate_state rate_states[SENSOR_STREAM_DEVICES][SENSOR_STREAM_COUNT];
+
+static atomic_uint seq_received[SENSOR_STREAM_COUNT];
+static atomic_uint seq_lost[SENSOR_STREAM_COUNT];
+static atomic_uint seq_reordered[SENSOR_STREAM_COUNT];
+static atomic_uint seq_gaps[SENSOR_STREAM_COUNT][SENSOR_STREAM_GAP_BINS];
+static atomic_uint seq_epoch[SENSOR_STREAM_DEVICES]; /* Bumped by sensor_stream_sequence_reset() */
+
+/* Per MouthPad and stream, owned by that MouthPad's sensor_stream_admit() caller */
+struct sequence_state {
+	uint32_t epoch;    /* Reset this state was built after */
+	bool seeded;       /* next is known */
+	uint8_t next;      /* Sequence number expected next */
+	uint32_t unfilled; /* Numbers skipped that may still turn up late */
+};
+
+static struct sequence_state sequence_states[SENSOR_STREAM_DEVICES][SENSOR_STREAM_COUNT];
+
+mouthware_message_SensorStream sensor_stream_classify(const uint8_t *data, size_t len)
+{
+	if (len >= SENSOR_STREAM_SENSOR_MIN) {
+		return mouthware_message_SensorStream_SENSOR_STREAM_SENSOR;
+	}
+	if (len >= SENSOR_STREAM_POWER_MIN && data[3] < 0x10) {
+		return mouthware_message_SensorStream_SENSOR_STREAM_POWER;
+	}
+	return mouthware_message_SensorStream_SENSOR_STREAM_OTHER;
+}
+
+/* Whether the stream's rate limits drop this notification */
+static bool thin(mouthware_message_SensorStream stream, uint32_t device_index, uint64_t now_us)
+{
+	struct rate_state *state =
+		&rate_states[device_index < SENSOR_STREAM_DEVICES ? device_index
+								  : SENSOR_STREAM_DEVICES - 1][stream];
+	uint32_t epoch = atomic_load_explicit(&rate_epoch[stream], memory_order_relaxed);
+	uint32_t keep = atomic_load_explicit(&keep_one_in[stream], memory_order_relaxed);
+	uint32_t interval = atomic_load_explicit(&min_interval_us[stream], memory_order_relaxed);
+
+	if (state->epoch != epoch) {
+		state->epoch = epoch;
+		state->phase = 0;
+		state->due_us = 0;
+	}
+
+	if (keep > 1) {
+		uint32_t phase = state->phase;
+
+		state->phase = phase + 1 < keep ? phase + 1 : 0;
+		if (phase != 0) {
+			return true;
+		}
+	}
+
+	if (interval > 0) {
+		if (now_us < state->due_us) {
+			return true;
+		}
+		/* Keep to the interval on average, without bursting after a pause */
+		state->due_us += interval;
+		if (state->due_us <= now_us) {
+			state->due_us = now_us + interval;
+		}
+	}
+	return false;
+}
+
+static unsigned int gap_bin(uint32_t length)
+{
+	unsigned int bin = 0;
+
+	for (length -= 1; length && bin < SENSOR_STREAM_GAP_BINS - 1; length >>= 1) {
+		bin++;
+	}
+	return bin;
+}
+
+/* Check byte 1 against the number the stream should have sent next */
+static void sequence_check(mouthware_message_SensorStream stream, const uint8_t *data,
+			   size_t len, uint32_t device_index)
+{
+	/* Short notifications are OTHER; byte 1 is only read past this */
+	if (stream == mouthware_message_SensorStream_SENSOR_STREAM_OTHER || len < 2 ||
+	    device_index >= SENSOR_STREAM_DEVICES) {
+		return;
+	}
+
+	uint8_t sequence = data[1];
+	struct sequence_state *state = &sequence_states[device_index][stream];
+	uint32_t epoch = atomic_load_explicit(&seq_epoch[device_index], memory_order_relaxed);
+
+	if (state->epoch != epoch) {
+		state->epoch = epoch;
+		state->seeded = false;
+		state->unfilled = 0;
+	}
+
+	atomic_fetch_add_explicit(&seq_received[stream], 1, memory_order_relaxed);
+	if (!state->seeded) {
+		state->seeded = true;
+		state->next = sequence + 1;
+		return;
+	}
+
+	uint8_t skipped = sequence - state->next;
+
+	if (skipped == 0) {
+		state->next = sequence + 1;
+	} else if (skipped < 128) {
+		atomic_fetch_add_explicit(&seq_lost[stream], skipped, memory_order_relaxed);
+		atomic_fetch_add_explicit(&seq_gaps[stream][gap_bin(skipped)], 1,
+					  memory_order_relaxed);
+		state->unfilled += skipped;
+		state->next = sequence + 1;
+	} else {
+		/* Behind the newest: a late one fills a gap, next stays put */
+		atomic_fetch_add_explicit(&seq_reordered[stream], 1, memory_order_relaxed);
+		if (state->unfilled > 0) {
+			state->unfilled--;
+			atomic_fetch_sub_explicit(&seq_lost[stream], 1, memory_order_relaxed);
+		}
+	}
+}
+
+bool sensor_stream_admit(const uint8_t *data, size_t len, uint32_t device_index, uint64_t now_us)
+{
+	mouthware_message_SensorStream stream = sensor_stream_classify(data, len);
+
+	sequence_check(stream, data, len, device_index);
+
+	if (atomic_load_explicit(&blocked, memory_order_relaxed) & (1u << stream)) {
+		atomic_fetch_add_explicit(&dropped[stream], 1, memory_order_relaxed);
+		return false;
+	}
+	if (thin(stream, device_index, now_us)) {
+		atomic_fetch_add_explicit(&thinned[stream], 1, memory_order_relaxed);
+		return false;
+	}
+
+	atomic_fetch_add_explicit(&forwarded[stream], 1, memory_order_relaxed);
+	return true;
+}
+
+void sensor_stream_set_blocked(uint32_t mask)
+{
+	atomic_store_explicit(&blocked, mask & SENSOR_STREAM_ALL, memory_order_relaxed);
+}
+
+uint32_t sensor_stream_blocked(void)
+{
+	return atomic_load_explicit(&blocked, memory_order_relaxed);
+}
+
+bool sensor_stream_set_rate(mouthware_message_SensorStream stream, uint32_t keep,
+			    uint32_t interval)
+{
+	if ((unsigned int)stream >= SENSOR_STREAM_COUNT) {
+		return false;
+	}
+
+	atomic_store_explicit(&keep_one_in[stream], keep, memory_order_relaxed);
+	atomic_store_explicit(&min_interval_us[stream], interval, memory_order_relaxed);
+	atomic_fetch_add_explicit(&rate_epoch[stream], 1, memory_order_relaxed);
+	return true;
+}
+
+void sensor_stream_get_rate(mouthware_message_SensorStream stream,
+			    mouthware_message_SensorStreamRateResponse *response)
+{
+	response->stream = stream;
+	if ((unsigned int)stream >= SENSOR_STREAM_COUNT) {
+		response->keep_one_in = 0;
+		response->min_interval_us = 0;
+		response->thinned = 0;
+		return;
+	}
+
+	response->keep_one_in = atomic_load_explicit(&keep_one_in[stream], memory_order_relaxed);
+	response->min_interval_us =
+		atomic_load_explicit(&min_interval_us[stream], memory_order_relaxed);
+	response->thinned = atomic_load_explicit(&thinned[stream], memory_order_relaxed);
+}
+
+void sensor_stream_get_status(mouthware_message_SensorStreamFilterResponse *response)
+{
+	response->blocked = sensor_stream_blocked();
+	response->sensor_forwarded = atomic_load_explicit(
+		&forwarded[mouthware_message_SensorStream_SENSOR_STREAM_SENSOR], memory_order_relaxed);
+	response->sensor_dropped = atomic_load_explicit(
+		&dropped[mouthware_message_SensorStream_SENSOR_STREAM_SENSOR], memory_order_relaxed);
+	response->power_forwarded = atomic_load_explicit(
+		&forwarded[mouthware_message_SensorStream_SENSOR_STREAM_POWER], memory_order_relaxed);
+	response->power_dropped = atomic_load_explicit(
+		&dropped[mouthware_message_SensorStream_SENSOR_STREAM_POWER], memory_order_relaxed);
+	response->other_forwarded = atomic_load_explicit(
+		&forwarded[mouthware_message_SensorStream_SENSOR_STREAM_OTHER], memory_order_relaxed);
+	response->other_dropped = atomic_load_explicit(
+		&dropped[mouthware_message_SensorStream_SENSOR_STREAM_OTHER], memory_order_relaxed);
+}
+
+void sensor_stream_sequence_reset(uint32_t device_index)
+{
+	if (device_index < SENSOR_STREAM_DEVICES) {
+		atomic_fetch_add_explicit(&seq_epoch[device_index], 1, memory_order_relaxed);
+	}
+}
+
+void sensor_stream_sequence_get(mouthware_message_SensorStream stream,
+				struct sensor_stream_sequence *out)
+{
+	*out = (struct sensor_stream_sequence){0};
+	if ((unsigned int)stream >= SENSOR_STREAM_COUNT) {
+		return;
+	}
+
+	out->received = atomic_load_explicit(&seq_received[stream], memory_order_relaxed);
+	out->lost = atomic_load_explicit(&seq_lost[stream], memory_order_relaxed);
+	out->reordered = atomic_load_explicit(&seq_reordered[stream], memory_order_relaxed);
+	for (unsigned int i = 0; i < SENSOR_STREAM_GAP_BINS; i++) {
+		out->gaps[i] = atomic_load_explicit(&seq_gaps[stream][i], memory_order_relaxed);
+	}
+}
+
+void sensor_stream_sequence_total(struct sensor_stream_sequence *out)
+{
+	struct sensor_stream_sequence power;
+
+	sensor_stream_sequence_get(mouthware_message_SensorStream_SENSOR_STREAM_SENSOR, out);
+	sensor_stream_sequence_get(mouthware_message_SensorStream_SENSOR_STREAM_POWER, &power);
+
+	out->received += power.received;
+	out->lost += power.lost;
+	out->reordered += power.reordered;
+	for (unsigned int i = 0; i < SENSOR_STREAM_GAP_BINS; i++) {
+		out->gaps[i] += power.gaps[i];
+	}
+}
+
+int sensor_stream_format(char *buf, size_t len)
+{
+	mouthware_message_SensorStreamFilterResponse status;
+
+	sensor_stream_get_status(&status);
+
+	return snprintf(buf, len,
+			"streams: blocked 0x%x, sensor %u fwd/%u dropped, power %u/%u, "
+			"other %u/%u",
+			(unsigned int)status.blocked, (unsigned int)status.sensor_forwarded,
+			(unsigned int)status.sensor_dropped, (unsigned int)status.power_forwarded,
+			(unsigned int)status.power_dropped, (unsigned int)status.other_forwarded,
+			(unsigned int)status.other_dropped);
+}
+
+int sensor_stream_rate_format(char *buf, size_t len)
+{
+	static const char *const names[SENSOR_STREAM_COUNT] = {"other", "sensor", "power"};
+	int written = snprintf(buf, len, "rates:");
+
+	for (unsigned int i = 0; i < SENSOR_STREAM_COUNT; i++) {
+		mouthware_message_SensorStreamRateResponse rate;
+
+		if (written < 0 || (size_t)written >= len) {
+			break;
+		}
+		sensor_stream_get_rate((mouthware_message_SensorStream)i, &rate);
+		written += snprintf(buf + written, len - written,
+				    "%s %s 1/%u %uus %u thinned", i ? "," : "", names[i],
+				    (unsigned int)(rate.keep_one_in ? rate.keep_one_in : 1),
+				    (unsigned int)rate.min_interval_us, (unsigned int)rate.thinned);
+	}
+	return written;
+}
+
+int sensor_stream_sequence_format(char *buf, size_t len)
+{
+	static const mouthware_message_SensorStream streams[] = {
+		mouthware_message_SensorStream_SENSOR_STREAM_SENSOR,
+		mouthware_message_SensorStream_SENSOR_STREAM_POWER,
+	};
+	static const char *const names[] = {"sensor", "power"};
+	int written = snprintf(buf, len, "sequence:");
+
+	for (unsigned int i = 0; i < 2; i++) {
+		struct sensor_stream_sequence seq;
+
+		if (written < 0 || (size_t)written >= len) {
+			break;
+		}
+		sensor_stream_sequence_get(streams[i], &seq);
+		written += snprintf(buf + written, len - written,
+				    "%s %s %u rx/%u lost/%u late, gaps %u/%u/%u/%u/%u/%u",
+				    i ? "," : "", names[i], (unsigned int)seq.received,
+				    (unsigned int)seq.lost, (unsigned int)seq.reordered,
+				    (unsigned int)seq.gaps[0], (unsigned int)seq.gaps[1],
+				    (unsigned int)seq.gaps[2], (unsigned int)seq.gaps[3],
+				    (unsigned int)seq.gaps[4], (unsigned int)seq.gaps[5]);
+	}
+	return written;
+}
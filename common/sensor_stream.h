@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief MouthPad stream classifier and filter for the NUS RX path, shared
+ *         by both relays
+ *
+ * The MouthPad sends every stream over the one NUS characteristic. They are
+ * told apart here by the size and header rules the web client applies in
+ * processPacket():
+ *
+ *   138 bytes or more                     SENSOR_STREAM_SENSOR (JCP, IMU,
+ *                                         click and cap-touch frames)
+ *   9 to 137 bytes with byte 3 below 0x10 SENSOR_STREAM_POWER
+ *   anything else                         SENSOR_STREAM_OTHER
+ *
+ * The sensor streams share one header and cannot be separated further
+ * without decoding the MouthPad's own payload.
+ *
+ * Each notification the relay is about to forward goes through
+ * sensor_stream_admit(), which counts it against its stream and refuses it
+ * if the host blocked that stream with SensorStreamFilterWrite. A blocked
+ * stream costs no CDC0 bandwidth and no host CPU; the MouthPad still sends
+ * it over the air. Blocking SENSOR_STREAM_OTHER also hides the MouthPad's
+ * replies to commands. Nothing is blocked at boot or kept across resets.
+ *
+ * A stream that is not blocked may instead be thinned to the rate the host
+ * consumes with SensorStreamRateWrite, separately for each MouthPad:
+ *
+ *   keep_one_in      forward one notification in N
+ *   min_interval_us  forward at most one per interval on average; the one
+ *                    forwarded is the first to arrive once the interval is
+ *                    due, so it is never older than the newest the relay
+ *                    has
+ *
+ * Both apply when both are set. A thinned notification is dropped whole, as
+ * the MouthPad sent it, and the sensor codec only sees the ones kept.
+ *
+ * Sensor and power notifications carry a sequence number in byte 1, which
+ * each stream advances by one per notification. sensor_stream_admit()
+ * checks it before any filter applies, so the counts describe what the
+ * MouthPad sent and the relay received, not what the host asked for:
+ *
+ *   lost       sequence numbers skipped; one that turns up late is taken
+ *              back off
+ *   reordered  notifications behind one already seen, late or repeated
+ *   gaps       each skip, binned by how many numbers it spans
+ *
+ * The number is one byte, so a gap of 128 or more reads as a late
+ * notification. The relay calls sensor_stream_sequence_reset() when a
+ * MouthPad disconnects; the first notification after that only seeds the
+ * count. MouthPads past SENSOR_STREAM_DEVICES are not checked.
+ *
+ * The filter, the limits and the counters are relaxed atomics, so any
+ * context may call any function here except sensor_stream_admit(), which
+ * keeps per-MouthPad state and must have one caller per device_index.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef SENSOR_STREAM_H_
+#define SENSOR_STREAM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Smallest sensor frame: 4 byte header and 134 bytes of sensor data */
+#define SENSOR_STREAM_SENSOR_MIN 138
+
+/* Smallest power frame: 4 byte header and 5 bytes of power data */
+#define SENSOR_STREAM_POWER_MIN 9
+
+#define SENSOR_STREAM_COUNT _mouthware_message_SensorStream_ARRAYSIZE
+
+/* Every bit SensorStreamFilterWrite.blocked may set */
+#define SENSOR_STREAM_ALL ((1u << SENSOR_STREAM_COUNT) - 1)
+
+/* MouthPads thinned separately; higher device indexes share the last */
+#define SENSOR_STREAM_DEVICES 4
+
+/* Sequence gap lengths binned: 1, 2, 3-4, 5-8, 9-16, 17 or more */
+#define SENSOR_STREAM_GAP_BINS 6
+
+/* Sequence counts for one stream or all, every MouthPad together */
+struct sensor_stream_sequence {
+	uint32_t received; /* Notifications whose sequence number was checked */
+	uint32_t lost;
+	uint32_t reordered;
+	uint32_t gaps[SENSOR_STREAM_GAP_BINS];
+};
+
+/**
+ * @brief Which stream a MouthPad notification belongs to
+ */
+mouthware_message_SensorStream sensor_stream_classify(const uint8_t *data, size_t len);
+
+/**
+ * @brief Count a notification and decide whether to forward it
+ *
+ * Call once per notification, before it is split into fragments.
+ *
+ * @param device_index MouthPad it came from, as PassThroughToApp.device_index
+ * @param now_us Monotonic time of arrival in microseconds
+ *
+ * @return false if its stream is blocked or thinned and it must be dropped
+ */
+bool sensor_stream_admit(const uint8_t *data, size_t len, uint32_t device_index, uint64_t now_us);
+
+/**
+ * @brief Set the streams to drop, as SensorStreamFilterWrite.blocked
+ *
+ * Bits for streams this relay does not know are ignored.
+ */
+void sensor_stream_set_blocked(uint32_t mask);
+
+uint32_t sensor_stream_blocked(void);
+
+/**
+ * @brief Apply a SensorStreamRateWrite
+ *
+ * Every MouthPad's next notification on the stream is forwarded.
+ *
+ * @return false if the stream is not one this relay knows
+ */
+bool sensor_stream_set_rate(mouthware_message_SensorStream stream, uint32_t keep_one_in,
+			    uint32_t min_interval_us);
+
+/**
+ * @brief Fill in a SensorStreamRateResponse for one stream
+ */
+void sensor_stream_get_rate(mouthware_message_SensorStream stream,
+			    mouthware_message_SensorStreamRateResponse *response);
+
+/**
+ * @brief Fill in a SensorStreamFilterResponse
+ */
+void sensor_stream_get_status(mouthware_message_SensorStreamFilterResponse *response);
+
+/**
+ * @brief Forget a MouthPad's sequence numbers, e.g. when it disconnects
+ *
+ * Any context; takes effect at its next notification.
+ */
+void sensor_stream_sequence_reset(uint32_t device_index);
+
+/**
+ * @brief Sequence counts since boot for one stream
+ *
+ * The other stream has no sequence number and reads as zeros.
+ */
+void sensor_stream_sequence_get(mouthware_message_SensorStream stream,
+				struct sensor_stream_sequence *out);
+
+/**
+ * @brief Sequence counts since boot, sensor and power streams summed
+ */
+void sensor_stream_sequence_total(struct sensor_stream_sequence *out);
+
+/**
+ * @brief Filter and counters as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int sensor_stream_format(char *buf, size_t len);
+
+/**
+ * @brief Rate limits and thinned counts as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int sensor_stream_rate_format(char *buf, size_t len);
+
+/**
+ * @brief Sequence counts of the sensor and power streams as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int sensor_stream_sequence_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSOR_STREAM_H_ */
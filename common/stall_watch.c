@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stall_watch.h"
+
+#define STALL_SNAPSHOT_MAGIC 0x53544C31u /* "STL1" */
+
+static struct stall_snapshot *snapshot;
+static struct stall_watch_config config;
+
+static atomic_uint stalls;
+static atomic_uint source_stalls[STALL_WATCH_SOURCES_MAX];
+static atomic_uint source_worst_us[STALL_WATCH_SOURCES_MAX];
+
+/* Outstanding probes: send time, and whether this wait was already
+ * snapshotted
+ */
+static atomic_bool probe_pending[STALL_WATCH_SOURCES_MAX];
+static atomic_bool probe_flagged[STALL_WATCH_SOURCES_MAX];
+static atomic_uint probe_sent_us[STALL_WATCH_SOURCES_MAX];
+
+/* Snapshot asked for by a sample: source + 1, 0 for none */
+static atomic_uint capture_source;
+static atomic_uint capture_elapsed_us;
+
+static bool have_captured;
+static uint32_t last_capture_ms;
+
+void stall_watch_init(struct stall_snapshot *retained, bool keep,
+		      const struct stall_watch_config *cfg)
+{
+	if (!keep || retained->magic != STALL_SNAPSHOT_MAGIC ||
+	    retained->check != ~STALL_SNAPSHOT_MAGIC) {
+		memset(retained, 0, sizeof(*retained));
+	}
+
+	config = *cfg;
+	if (config.source_count > STALL_WATCH_SOURCES_MAX) {
+		config.source_count = STALL_WATCH_SOURCES_MAX;
+	}
+	snapshot = retained;
+}
+
+void stall_watch_sample(uint8_t source, uint32_t elapsed_us)
+{
+	if (source >= config.source_count) {
+		return;
+	}
+
+	unsigned int worst = atomic_load_explicit(&source_worst_us[source], memory_order_relaxed);
+
+	while (elapsed_us > worst &&
+	       !atomic_compare_exchange_weak(&source_worst_us[source], &worst, elapsed_us)) {
+	}
+
+	if (elapsed_us <= config.threshold_us) {
+		return;
+	}
+
+	atomic_fetch_add_explicit(&stalls, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&source_stalls[source], 1, memory_order_relaxed);
+
+	/* The watch thread takes it; a second request before then is dropped */
+	unsigned int none = 0;
+
+	atomic_store_explicit(&capture_elapsed_us, elapsed_us, memory_order_relaxed);
+	atomic_compare_exchange_strong(&capture_source, &none, source + 1U);
+}
+
+bool stall_watch_probe_start(uint8_t source)
+{
+	if (source >= config.source_count ||
+	    atomic_load_explicit(&probe_pending[source], memory_order_acquire)) {
+		return false;
+	}
+
+	atomic_store_explicit(&probe_sent_us[source], config.now_us(), memory_order_relaxed);
+	atomic_store_explicit(&probe_flagged[source], false, memory_order_relaxed);
+	atomic_store_explicit(&probe_pending[source], true, memory_order_release);
+	return true;
+}
+
+void stall_watch_probe_done(uint8_t source)
+{
+	if (source >= config.source_count) {
+		return;
+	}
+
+	uint32_t sent = atomic_load_explicit(&probe_sent_us[source], memory_order_relaxed);
+
+	stall_watch_sample(source, config.now_us() - sent);
+	atomic_store_explicit(&probe_pending[source], false, memory_order_release);
+}
+
+static void take_snapshot(uint8_t source, uint32_t elapsed_us)
+{
+	uint32_t now = config.now_ms();
+
+	if (have_captured && now - last_capture_ms < STALL_WATCH_HOLDOFF_MS) {
+		return;
+	}
+	have_captured = true;
+	last_capture_ms = now;
+
+	/* Invalid while it is rewritten, in case of a reset part way */
+	snapshot->magic = 0;
+	snapshot->boot_count = trace_ring_boot_count();
+	snapshot->time_ms = now;
+	snapshot->elapsed_us = elapsed_us;
+	snapshot->source = source;
+	snapshot->thread_count = 0;
+	memset(snapshot->queue_depth, 0, sizeof(snapshot->queue_depth));
+
+	if (config.capture) {
+		config.capture(snapshot);
+	}
+	if (snapshot->thread_count > STALL_WATCH_THREADS_MAX) {
+		snapshot->thread_count = STALL_WATCH_THREADS_MAX;
+	}
+
+	snapshot->check = ~STALL_SNAPSHOT_MAGIC;
+	snapshot->magic = STALL_SNAPSHOT_MAGIC;
+
+	trace_ring_record(TRACE_EVENT_STALL, source, elapsed_us / 1000);
+	for (uint8_t i = 0; i < TRACE_QUEUE_COUNT; i++) {
+		trace_ring_record(TRACE_EVENT_QUEUE_DEPTH, i, snapshot->queue_depth[i]);
+	}
+}
+
+void stall_watch_check(void)
+{
+	if (!snapshot) {
+		return;
+	}
+
+	uint32_t now = config.now_us();
+
+	/* A worker still held up: snapshot while it lasts */
+	for (uint8_t i = 1; i < config.source_count; i++) {
+		if (!atomic_load_explicit(&probe_pending[i], memory_order_acquire) ||
+		    atomic_load_explicit(&probe_flagged[i], memory_order_relaxed)) {
+			continue;
+		}
+
+		uint32_t waited = now - atomic_load_explicit(&probe_sent_us[i], memory_order_relaxed);
+
+		if (waited > config.threshold_us) {
+			atomic_store_explicit(&probe_flagged[i], true, memory_order_relaxed);
+			take_snapshot(i, waited);
+		}
+	}
+
+	unsigned int requested = atomic_exchange_explicit(&capture_source, 0, memory_order_relaxed);
+
+	if (requested) {
+		take_snapshot(requested - 1,
+			      atomic_load_explicit(&capture_elapsed_us, memory_order_relaxed));
+	}
+}
+
+void stall_watch_get(struct stall_watch_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->threshold_us = config.threshold_us;
+	stats->stalls = atomic_load_explicit(&stalls, memory_order_relaxed);
+
+	for (size_t i = 0; i < config.source_count; i++) {
+		stats->source_stalls[i] = atomic_load_explicit(&source_stalls[i],
+							       memory_order_relaxed);
+		stats->source_worst_us[i] = atomic_load_explicit(&source_worst_us[i],
+								 memory_order_relaxed);
+		if (stats->source_worst_us[i] > stats->worst_us) {
+			stats->worst_us = stats->source_worst_us[i];
+		}
+	}
+}
+
+void stall_watch_clear(void)
+{
+	atomic_store_explicit(&stalls, 0, memory_order_relaxed);
+	for (size_t i = 0; i < STALL_WATCH_SOURCES_MAX; i++) {
+		atomic_store_explicit(&source_stalls[i], 0, memory_order_relaxed);
+		atomic_store_explicit(&source_worst_us[i], 0, memory_order_relaxed);
+	}
+	if (snapshot) {
+		snapshot->magic = 0;
+	}
+	have_captured = false;
+}
+
+const char *stall_watch_source_name(uint8_t source)
+{
+	return source < config.source_count ? config.source_names[source] : "?";
+}
+
+static const char *thread_state_name(uint8_t state)
+{
+	static const char *const names[] = {
+		[STALL_THREAD_RUNNING] = "running",
+		[STALL_THREAD_READY] = "ready",
+		[STALL_THREAD_BLOCKED] = "blocked",
+		[STALL_THREAD_SUSPENDED] = "suspended",
+		[STALL_THREAD_OTHER] = "other",
+	};
+
+	return state < sizeof(names) / sizeof(names[0]) ? names[state] : "?";
+}
+
+int stall_watch_format(size_t index, char *buf, size_t len)
+{
+	struct stall_watch_stats stats;
+
+	stall_watch_get(&stats);
+
+	if (index == 0) {
+		return snprintf(buf, len, "Threshold %u us: %u stalls, worst %u us",
+				(unsigned int)stats.threshold_us, (unsigned int)stats.stalls,
+				(unsigned int)stats.worst_us);
+	}
+	index--;
+
+	if (index < config.source_count) {
+		return snprintf(buf, len, "  %-14s %u stalls, worst %u us",
+				config.source_names[index], (unsigned int)stats.source_stalls[index],
+				(unsigned int)stats.source_worst_us[index]);
+	}
+	index -= config.source_count;
+
+	bool held = snapshot && snapshot->magic == STALL_SNAPSHOT_MAGIC &&
+		    snapshot->check == ~STALL_SNAPSHOT_MAGIC;
+
+	if (index == 0) {
+		if (!held) {
+			return snprintf(buf, len, "No snapshot");
+		}
+		return snprintf(buf, len, "Snapshot: boot #%u at %u.%03u s, %s held up %u us",
+				(unsigned int)snapshot->boot_count,
+				(unsigned int)(snapshot->time_ms / 1000),
+				(unsigned int)(snapshot->time_ms % 1000),
+				stall_watch_source_name(snapshot->source),
+				(unsigned int)snapshot->elapsed_us);
+	}
+	if (!held) {
+		return 0;
+	}
+	index--;
+
+	if (index < TRACE_QUEUE_COUNT) {
+		return snprintf(buf, len, "  queue %-10s %u", trace_ring_queue_name(index),
+				(unsigned int)snapshot->queue_depth[index]);
+	}
+	index -= TRACE_QUEUE_COUNT;
+
+	if (index < snapshot->thread_count) {
+		const struct stall_thread *thread = &snapshot->threads[index];
+		char name[STALL_WATCH_NAME_LEN];
+
+		memcpy(name, thread->name, sizeof(name));
+		name[sizeof(name) - 1] = '\0';
+		return snprintf(buf, len, "  %-11s %-9s prio %d", name,
+				thread_state_name(thread->state), thread->priority);
+	}
+
+	return 0;
+}
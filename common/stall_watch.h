@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Latency spike watchdog shared by both relays
+ *
+ * Watches two kinds of delay against one threshold:
+ *
+ * - The HID pipeline (source 0): time from a HOGP notification arriving to
+ *   its report being handed to USB, sampled by the platform for every
+ *   report.
+ * - Worker gaps (sources 1 and up, named by the platform): a watch thread
+ *   wakes every few milliseconds while the user is active, notes how late
+ *   it woke itself, and sends a probe to each worker (a work queue or a
+ *   task). The time until the worker runs the probe is how long it went
+ *   without an iteration.
+ *
+ * A sample over the threshold is counted, and at most once per
+ * STALL_WATCH_HOLDOFF_MS the watch thread takes a snapshot: thread states
+ * and queue depths from the platform. A probe that is still waiting past
+ * the threshold is snapshotted while the stall is in progress, so the
+ * thread holding things up shows as running or ready. The snapshot lives
+ * in retained memory like the trace ring, and a STALL record followed by
+ * QUEUE_DEPTH records marks it in the trace, after the events that led up
+ * to it. The stall count and worst case go out in LinkTelemetry.
+ *
+ * Samples and probes may be noted from any thread. Snapshots are taken and
+ * cleared only from the watch thread or the console; a reader racing a
+ * snapshot may see it half written.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef STALL_WATCH_H_
+#define STALL_WATCH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "trace_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sources, including the pipeline */
+#define STALL_WATCH_SOURCES_MAX 8
+
+/* Source 0; the platform names the rest */
+#define STALL_SOURCE_PIPELINE 0
+
+/* Threads kept in a snapshot; further ones are left out */
+#define STALL_WATCH_THREADS_MAX 16
+
+/* Thread name length including the terminator */
+#define STALL_WATCH_NAME_LEN 12
+
+/* Minimum spacing of snapshots, so a burst keeps its first one */
+#define STALL_WATCH_HOLDOFF_MS 10000
+
+enum stall_thread_state {
+	STALL_THREAD_RUNNING,   /* On a CPU when the snapshot was taken */
+	STALL_THREAD_READY,     /* Runnable, waiting for a CPU */
+	STALL_THREAD_BLOCKED,   /* Waiting on an object or sleeping */
+	STALL_THREAD_SUSPENDED,
+	STALL_THREAD_OTHER,
+};
+
+struct stall_thread {
+	char name[STALL_WATCH_NAME_LEN];
+	int8_t priority;            /* As the platform numbers it */
+	uint8_t state;              /* stall_thread_state */
+};
+
+/* Laid out by the platform in retained memory; contents are owned here */
+struct stall_snapshot {
+	uint32_t magic;             /* Valid only while a snapshot is held */
+	uint32_t check;
+	uint32_t boot_count;        /* Boot it was taken in, as trace_ring_boot_count() */
+	uint32_t time_ms;           /* Since that boot */
+	uint32_t elapsed_us;        /* How long the source had been held up */
+	uint8_t source;
+	uint8_t thread_count;
+	uint16_t queue_depth[TRACE_QUEUE_COUNT];
+	struct stall_thread threads[STALL_WATCH_THREADS_MAX];
+};
+
+struct stall_watch_config {
+	/* source_count names, [0] for the pipeline */
+	const char *const *source_names;
+	size_t source_count;
+
+	uint32_t threshold_us;
+
+	/* Clocks since boot; may wrap */
+	uint32_t (*now_us)(void);
+	uint32_t (*now_ms)(void);
+
+	/* Fill in thread_count, threads and queue_depth; runs on the watch
+	 * thread and must not block on anything a stalled thread may hold
+	 */
+	void (*capture)(struct stall_snapshot *snapshot);
+};
+
+struct stall_watch_stats {
+	uint32_t threshold_us;
+	uint32_t stalls;            /* Samples over the threshold, all sources */
+	uint32_t worst_us;          /* All sources */
+	uint32_t source_stalls[STALL_WATCH_SOURCES_MAX];
+	uint32_t source_worst_us[STALL_WATCH_SOURCES_MAX];
+};
+
+/**
+ * @brief Install the platform hooks and adopt the retained snapshot
+ *
+ * @param keep Keep a snapshot from before the reset; pass what
+ *             trace_ring_init() returned
+ */
+void stall_watch_init(struct stall_snapshot *retained, bool keep,
+		      const struct stall_watch_config *config);
+
+/**
+ * @brief Note one delay; safe from any thread
+ */
+void stall_watch_sample(uint8_t source, uint32_t elapsed_us);
+
+/**
+ * @brief Stamp a probe about to be sent to a worker; watch thread only
+ *
+ * @return false if the previous probe has not run yet, in which case
+ *         nothing should be sent
+ */
+bool stall_watch_probe_start(uint8_t source);
+
+/**
+ * @brief Note a probe run by its worker, as a sample of the wait
+ */
+void stall_watch_probe_done(uint8_t source);
+
+/**
+ * @brief Look for probes held up past the threshold and take any snapshot
+ *        that is due; call from the watch thread after each round of probes
+ */
+void stall_watch_check(void);
+
+void stall_watch_get(struct stall_watch_stats *stats);
+
+/**
+ * @brief Zero the counters and discard the snapshot
+ */
+void stall_watch_clear(void);
+
+const char *stall_watch_source_name(uint8_t source);
+
+/**
+ * @brief One console line of counters or snapshot, for index 0, 1, ...
+ *
+ * @return Characters written, as snprintf; 0 past the last line
+ */
+int stall_watch_format(size_t index, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STALL_WATCH_H_ */
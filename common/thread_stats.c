@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "thread_stats.h"
+#include "mouthpad_frame.h"
+#include "pb_encode.h"
+
+/* Response fields, then a tag and length byte per thread; 3 bytes go to the
+ * RelayToAppMessage tag and length
+ */
+_Static_assert(6 + 6 + THREAD_STATS_RESPONSE_MAX * (2 + mouthware_message_ThreadStat_size) <=
+		       MOUTHPAD_FRAME_MAX_PAYLOAD - 3,
+	       "A full ThreadStatsResponse does not fit a frame");
+
+/* Cumulative counters from the previous read */
+struct previous {
+	uintptr_t id;
+	uint64_t runtime;
+	uint32_t switches;
+};
+
+static struct previous previous[THREAD_STATS_MAX];
+static size_t previous_count;
+static uint64_t previous_total;
+static uint32_t previous_ms;
+
+static const struct previous *find_previous(uintptr_t id)
+{
+	for (size_t i = 0; i < previous_count; i++) {
+		if (previous[i].id == id) {
+			return &previous[i];
+		}
+	}
+	return NULL;
+}
+
+void thread_stats_update(const struct thread_stats_sample *samples, size_t count,
+			 uint64_t total_runtime, uint32_t now_ms,
+			 struct thread_stats_report *report)
+{
+	uint64_t window = total_runtime - previous_total;
+
+	if (count > THREAD_STATS_MAX) {
+		count = THREAD_STATS_MAX;
+	}
+
+	report->window_ms = now_ms - previous_ms;
+	report->count = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		const struct thread_stats_sample *sample = &samples[i];
+		const struct previous *prev = find_previous(sample->id);
+		uint64_t runtime = sample->runtime;
+		uint32_t switches = sample->switches;
+
+		/* A thread new since the last read, or a new one in the same
+		 * place, counts from zero
+		 */
+		if (prev && prev->runtime <= runtime && prev->switches <= switches) {
+			runtime -= prev->runtime;
+			switches -= prev->switches;
+		}
+
+		struct thread_stats_row row = {
+			.cpu_permille = window ? (uint32_t)(runtime * 1000 / window) : 0,
+			.switches = switches,
+			.stack_size = sample->stack_size,
+			.stack_unused = sample->stack_unused,
+		};
+
+		memcpy(row.name, sample->name, sizeof(row.name));
+		row.name[sizeof(row.name) - 1] = '\0';
+
+		/* Insert busiest first; at most THREAD_STATS_MAX rows */
+		size_t at = report->count;
+
+		while (at > 0 && report->rows[at - 1].cpu_permille < row.cpu_permille) {
+			report->rows[at] = report->rows[at - 1];
+			at--;
+		}
+		report->rows[at] = row;
+		report->count++;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		previous[i] = (struct previous){
+			.id = samples[i].id,
+			.runtime = samples[i].runtime,
+			.switches = samples[i].switches,
+		};
+	}
+	previous_count = count;
+	previous_total = total_runtime;
+	previous_ms = now_ms;
+}
+
+/* nanopb callback for ThreadStatsResponse.threads */
+static bool encode_threads(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+	const struct thread_stats_report *report = *arg;
+	size_t count = report->count < THREAD_STATS_RESPONSE_MAX ? report->count
+								 : THREAD_STATS_RESPONSE_MAX;
+
+	for (size_t i = 0; i < count; i++) {
+		const struct thread_stats_row *row = &report->rows[i];
+		mouthware_message_ThreadStat stat = {
+			.cpu_permille = row->cpu_permille,
+			.stack_size = row->stack_size,
+			.stack_unused = row->stack_unused,
+			.context_switches = row->switches,
+		};
+
+		memcpy(stat.name, row->name, sizeof(stat.name));
+		if (!pb_encode_tag_for_field(stream, field) ||
+		    !pb_encode_submessage(stream, mouthware_message_ThreadStat_fields, &stat)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void thread_stats_fill_response(const struct thread_stats_report *report,
+				mouthware_message_ThreadStatsResponse *response)
+{
+	*response = (mouthware_message_ThreadStatsResponse)
+		mouthware_message_ThreadStatsResponse_init_zero;
+	response->window_ms = report->window_ms;
+	response->thread_count = report->count;
+	response->threads.funcs.encode = encode_threads;
+	response->threads.arg = (void *)report;
+}
+
+const char *thread_stats_header(void)
+{
+	return "Thread             CPU  switches   stack used/size";
+}
+
+int thread_stats_format(const struct thread_stats_row *row, char *buf, size_t len)
+{
+	if (row->stack_size == 0) {
+		return snprintf(buf, len, "%-15s %3u.%u%% %9u   %u free", row->name,
+				(unsigned int)(row->cpu_permille / 10),
+				(unsigned int)(row->cpu_permille % 10), (unsigned int)row->switches,
+				(unsigned int)row->stack_unused);
+	}
+
+	return snprintf(buf, len, "%-15s %3u.%u%% %9u %7u/%u", row->name,
+			(unsigned int)(row->cpu_permille / 10), (unsigned int)(row->cpu_permille % 10),
+			(unsigned int)row->switches,
+			(unsigned int)(row->stack_size - row->stack_unused),
+			(unsigned int)row->stack_size);
+}
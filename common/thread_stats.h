@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Per-thread CPU and stack usage shared by both relays
+ *
+ * The platform walks its threads (Zephyr) or tasks (FreeRTOS) and hands
+ * over one sample per thread: cumulative run time, cumulative context
+ * switches and stack figures. This module keeps the previous read and
+ * turns the cumulative counters into shares of the window in between, so
+ * every read covers the time since the one before it, as top does. The
+ * first read covers the time since boot.
+ *
+ * The result is printed by the platform's console command and sent as a
+ * ThreadStatsResponse. Only the busiest THREAD_STATS_RESPONSE_MAX threads
+ * go into the response so it always fits one frame.
+ *
+ * Not thread safe: the platform serialises reads.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef THREAD_STATS_H_
+#define THREAD_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Threads tracked per read; further ones are left out */
+#define THREAD_STATS_MAX 24
+
+/* Name length including the terminator, as in ThreadStat.name */
+#define THREAD_STATS_NAME_LEN sizeof(((mouthware_message_ThreadStat *)0)->name)
+
+/* Threads listed in a ThreadStatsResponse */
+#define THREAD_STATS_RESPONSE_MAX 10
+
+struct thread_stats_sample {
+	uintptr_t id;               /* Stable for the life of the thread */
+	char name[THREAD_STATS_NAME_LEN];
+	uint64_t runtime;           /* Cumulative, in the unit of total_runtime */
+	uint32_t switches;          /* Cumulative switches in; 0 if not counted */
+	uint32_t stack_size;        /* Bytes; 0 if unknown */
+	uint32_t stack_unused;      /* Bytes never touched */
+};
+
+struct thread_stats_row {
+	char name[THREAD_STATS_NAME_LEN];
+	uint32_t cpu_permille;      /* Share of one core over the window */
+	uint32_t switches;          /* Over the window */
+	uint32_t stack_size;
+	uint32_t stack_unused;
+};
+
+struct thread_stats_report {
+	uint32_t window_ms;
+	size_t count;               /* Rows filled in, busiest first */
+	struct thread_stats_row rows[THREAD_STATS_MAX];
+};
+
+/**
+ * @brief Turn one read of every thread into a report
+ *
+ * @param samples One per live thread, in any order
+ * @param total_runtime Cumulative run time of one core, same unit as the
+ *                      samples; the window is its advance since the last read
+ * @param now_ms Any millisecond clock; may wrap
+ */
+void thread_stats_update(const struct thread_stats_sample *samples, size_t count,
+			 uint64_t total_runtime, uint32_t now_ms,
+			 struct thread_stats_report *report);
+
+/**
+ * @brief Fill in a ThreadStatsResponse from a report
+ *
+ * The response refers to report, which must outlive the encode.
+ */
+void thread_stats_fill_response(const struct thread_stats_report *report,
+				mouthware_message_ThreadStatsResponse *response);
+
+/**
+ * @brief One row as a console line
+ *
+ * @return Characters written, as snprintf
+ */
+int thread_stats_format(const struct thread_stats_row *row, char *buf, size_t len);
+
+/**
+ * @brief Column headings matching thread_stats_format()
+ */
+const char *thread_stats_header(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREAD_STATS_H_ */
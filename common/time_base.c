@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "time_base.h"
+
+/* Writer side: time_base_host_sample() and time_base_host_reset() */
+static int64_t window_min;
+static int64_t last_window_min;
+static uint32_t window_count;
+static bool have_last_window;
+
+/* Published offset: odd while being written */
+static atomic_uint offset_seq;
+static int64_t offset_us;
+static uint32_t samples;
+static atomic_bool synced;
+
+static void publish(int64_t offset, uint32_t count)
+{
+	atomic_fetch_add_explicit(&offset_seq, 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	offset_us = offset;
+	samples = count;
+	atomic_fetch_add_explicit(&offset_seq, 1, memory_order_release);
+}
+
+static bool read_offset(int64_t *offset, uint32_t *count)
+{
+	unsigned int seq;
+
+	if (!atomic_load_explicit(&synced, memory_order_acquire)) {
+		return false;
+	}
+	do {
+		seq = atomic_load_explicit(&offset_seq, memory_order_acquire);
+		*offset = offset_us;
+		*count = samples;
+		atomic_thread_fence(memory_order_acquire);
+	} while ((seq & 1) || seq != atomic_load_explicit(&offset_seq, memory_order_relaxed));
+	return true;
+}
+
+void time_base_host_sample(uint64_t host_us, uint64_t relay_us)
+{
+	int64_t diff = (int64_t)(relay_us - host_us);
+	int64_t best;
+
+	if (host_us == 0) {
+		return;
+	}
+
+	if (window_count == 0 || diff < window_min) {
+		window_min = diff;
+	}
+	best = have_last_window && last_window_min < window_min ? last_window_min : window_min;
+
+	if (++window_count == TIME_BASE_SYNC_WINDOW) {
+		last_window_min = window_min;
+		have_last_window = true;
+		window_count = 0;
+	}
+
+	publish(best, samples + 1);
+	atomic_store_explicit(&synced, true, memory_order_release);
+}
+
+bool time_base_host_offset(int64_t *offset)
+{
+	uint32_t count;
+
+	return read_offset(offset, &count);
+}
+
+bool time_base_to_host_us(uint64_t relay_us, uint64_t *host_us)
+{
+	int64_t offset;
+	uint32_t count;
+
+	if (!read_offset(&offset, &count)) {
+		return false;
+	}
+	*host_us = relay_us - (uint64_t)offset;
+	return true;
+}
+
+void time_base_host_reset(void)
+{
+	atomic_store_explicit(&synced, false, memory_order_release);
+	window_count = 0;
+	have_last_window = false;
+	publish(0, 0);
+}
+
+int time_base_format(char *buf, size_t len)
+{
+	int64_t offset;
+	uint64_t magnitude;
+	uint32_t count;
+
+	if (!read_offset(&offset, &count)) {
+		return snprintf(buf, len, "Host clock: not synced");
+	}
+	/* Seconds and microseconds: not every libc prints 64-bit integers */
+	magnitude = offset < 0 ? -(uint64_t)offset : (uint64_t)offset;
+	return snprintf(buf, len, "Host clock: relay - host %s%lu.%06u s, %u echoes",
+			offset < 0 ? "-" : "", (unsigned long)(magnitude / 1000000U),
+			(unsigned int)(magnitude % 1000000U), (unsigned int)count);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief The relay's clock against the host's, shared by both relays
+ *
+ * Each platform's relay_time.h gives the one time base latency work is
+ * done on:
+ *
+ *   relay_time_now32()  raw 32-bit capture, RELAY_TIME_HZ, wrapping; for
+ *                       intervals, taken apart with relay_time_to_us() or
+ *                       relay_time_to_ns()
+ *   relay_time_us64()   microseconds since boot; every time that leaves
+ *                       the relay (echo, HID mirror, raw samples) is one
+ *
+ * Here the relay's microseconds are related to the host's, from the
+ * EchoRequests the host stamps. relay_rx_us - host_timestamp_us is the
+ * clock offset plus the time the request took to arrive, so the smallest
+ * difference over the last TIME_BASE_SYNC_WINDOW to 2 * TIME_BASE_SYNC_WINDOW
+ * echoes is taken as the offset; the window lets it follow the two
+ * crystals drifting apart. The offset keeps the fastest delivery in it, a
+ * few hundred microseconds over USB full speed.
+ *
+ * time_base_host_sample() and time_base_host_reset() are called from one
+ * context; the others may be called from any.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef TIME_BASE_H_
+#define TIME_BASE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Echoes per offset window */
+#define TIME_BASE_SYNC_WINDOW 16
+
+/**
+ * @brief Note an EchoRequest
+ *
+ * @param host_us host_timestamp_us; 0, a host that does not stamp, is
+ *                ignored
+ * @param relay_us relay_time_us64() when the request was handled
+ */
+void time_base_host_sample(uint64_t host_us, uint64_t relay_us);
+
+/**
+ * @brief Relay time minus host time
+ *
+ * @return false before the first stamped echo
+ */
+bool time_base_host_offset(int64_t *offset_us);
+
+/**
+ * @brief Host time of a relay_time_us64() value
+ *
+ * @return false before the first stamped echo
+ */
+bool time_base_to_host_us(uint64_t relay_us, uint64_t *host_us);
+
+/**
+ * @brief Forget the offset, for a host that went away
+ */
+void time_base_host_reset(void);
+
+/**
+ * @brief Offset as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int time_base_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIME_BASE_H_ */
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "trace_ring.h"
+#include "connection_timing.h"
+#include "mouthpad_frame.h"
+#include "mouthpad_hid_reports.h"
+#include "stall_watch.h"
+#include "pb_encode.h"
+
+#define TRACE_RING_MAGIC 0x54524331u /* "TRC1" */
+
+_Static_assert((TRACE_RING_LEN & (TRACE_RING_LEN - 1)) == 0,
+	       "TRACE_RING_LEN must be a power of two");
+
+/* Three varint fields, the records field and 3 bytes for the
+ * RelayToAppMessage tag and length
+ */
+_Static_assert(3 * 6 + 3 + TRACE_RING_RESPONSE_MAX * sizeof(struct trace_record) <=
+		       MOUTHPAD_FRAME_MAX_PAYLOAD - 3,
+	       "A full TraceResponse does not fit a frame");
+
+static struct trace_ring *ring;
+static uint32_t (*clock_ms)(void);
+
+/* Rate limiting for trace_ring_count(); reset every boot */
+static atomic_uint last_count_ms[TRACE_EVENT_COUNT];
+static atomic_uint pending_count[TRACE_EVENT_COUNT];
+
+/* Worst latency recorded this boot, per report ID */
+static atomic_uint latency_max[MOUTHPAD_HID_REPORT_ID_MAX + 1];
+
+static uint16_t saturate16(uint32_t value)
+{
+	return value > UINT16_MAX ? UINT16_MAX : (uint16_t)value;
+}
+
+bool trace_ring_init(struct trace_ring *retained, uint32_t (*now_ms)(void),
+		     enum trace_reset_cause cause)
+{
+	/* Power-on contents are random; a cold boot never keeps them */
+	bool kept = cause != TRACE_RESET_POWER_ON && retained->magic == TRACE_RING_MAGIC &&
+		    retained->check == ~TRACE_RING_MAGIC;
+
+	if (!kept) {
+		memset(retained, 0, sizeof(*retained));
+		retained->magic = TRACE_RING_MAGIC;
+		retained->check = ~TRACE_RING_MAGIC;
+		atomic_init(&retained->head, 0);
+	}
+
+	retained->boot_count++;
+	clock_ms = now_ms;
+	ring = retained;
+
+	trace_ring_record(TRACE_EVENT_BOOT, cause, ring->boot_count);
+	return kept;
+}
+
+void trace_ring_record(enum trace_event type, uint8_t arg, uint32_t value)
+{
+	if (!ring) {
+		return;
+	}
+
+	unsigned int slot = atomic_fetch_add_explicit(&ring->head, 1, memory_order_relaxed);
+
+	ring->records[slot & (TRACE_RING_LEN - 1)] = (struct trace_record){
+		.time_ms = clock_ms(),
+		.value = saturate16(value),
+		.type = type,
+		.arg = arg,
+	};
+}
+
+void trace_ring_count(enum trace_event type, uint8_t arg)
+{
+	if (!ring || type >= TRACE_EVENT_COUNT) {
+		return;
+	}
+
+	uint32_t now = clock_ms();
+	unsigned int pending = atomic_fetch_add_explicit(&pending_count[type], 1,
+							 memory_order_relaxed) + 1;
+	unsigned int last = atomic_load_explicit(&last_count_ms[type], memory_order_relaxed);
+
+	/* The first of a burst is recorded at once, the rest with the next
+	 * one after the gap
+	 */
+	if (last != 0 && now - last < TRACE_RING_RATE_MS) {
+		return;
+	}
+	if (!atomic_compare_exchange_strong(&last_count_ms[type], &last, now ? now : 1)) {
+		return;
+	}
+
+	pending = atomic_exchange_explicit(&pending_count[type], 0, memory_order_relaxed);
+	trace_ring_record(type, arg, pending);
+}
+
+void trace_ring_latency(uint8_t report_id, uint32_t us)
+{
+	if (report_id > MOUTHPAD_HID_REPORT_ID_MAX) {
+		return;
+	}
+
+	unsigned int max = atomic_load_explicit(&latency_max[report_id], memory_order_relaxed);
+
+	while (us > max) {
+		if (atomic_compare_exchange_weak(&latency_max[report_id], &max, us)) {
+			trace_ring_record(TRACE_EVENT_LATENCY_MAX, report_id, us);
+			return;
+		}
+	}
+}
+
+size_t trace_ring_held(void)
+{
+	if (!ring) {
+		return 0;
+	}
+
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+	return head < TRACE_RING_LEN ? head : TRACE_RING_LEN;
+}
+
+bool trace_ring_get(size_t index, struct trace_record *record)
+{
+	size_t held = trace_ring_held();
+
+	if (index >= held) {
+		return false;
+	}
+
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+	*record = ring->records[(head - held + index) & (TRACE_RING_LEN - 1)];
+	return true;
+}
+
+void trace_ring_clear(void)
+{
+	if (ring) {
+		atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+	}
+}
+
+uint32_t trace_ring_boot_count(void)
+{
+	return ring ? ring->boot_count : 0;
+}
+
+struct response_page {
+	uint32_t offset;
+	uint32_t count;
+};
+
+/* nanopb callback for TraceResponse.records: little-endian time_ms, value,
+ * type, arg per record
+ */
+static bool encode_records(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+	const struct response_page *page = *arg;
+
+	if (!pb_encode_tag_for_field(stream, field) ||
+	    !pb_encode_varint(stream, page->count * sizeof(struct trace_record))) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < page->count; i++) {
+		struct trace_record record = {0};
+
+		trace_ring_get(page->offset + i, &record);
+
+		uint8_t bytes[sizeof(record)] = {
+			(uint8_t)record.time_ms,
+			(uint8_t)(record.time_ms >> 8),
+			(uint8_t)(record.time_ms >> 16),
+			(uint8_t)(record.time_ms >> 24),
+			(uint8_t)record.value,
+			(uint8_t)(record.value >> 8),
+			record.type,
+			record.arg,
+		};
+
+		if (!pb_write(stream, bytes, sizeof(bytes))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void trace_ring_fill_response(uint32_t offset, mouthware_message_TraceResponse *response)
+{
+	/* Only one response is encoded at a time */
+	static struct response_page page;
+	size_t held = trace_ring_held();
+
+	page.offset = offset < held ? offset : held;
+	page.count = held - page.offset;
+	if (page.count > TRACE_RING_RESPONSE_MAX) {
+		page.count = TRACE_RING_RESPONSE_MAX;
+	}
+
+	*response = (mouthware_message_TraceResponse)mouthware_message_TraceResponse_init_zero;
+	response->boot_count = trace_ring_boot_count();
+	response->total = ring ? atomic_load_explicit(&ring->head, memory_order_relaxed) : 0;
+	response->offset = page.offset;
+	if (page.count > 0) {
+		response->records.funcs.encode = encode_records;
+		response->records.arg = &page;
+	}
+}
+
+static const char *reset_cause_name(uint8_t cause)
+{
+	static const char *const names[] = {
+		[TRACE_RESET_UNKNOWN] = "unknown",   [TRACE_RESET_POWER_ON] = "power-on",
+		[TRACE_RESET_PIN] = "pin",           [TRACE_RESET_SOFTWARE] = "software",
+		[TRACE_RESET_WATCHDOG] = "watchdog", [TRACE_RESET_BROWNOUT] = "brownout",
+		[TRACE_RESET_PANIC] = "panic",       [TRACE_RESET_WAKE] = "wake",
+	};
+
+	return cause < sizeof(names) / sizeof(names[0]) ? names[cause] : "?";
+}
+
+static const char *path_name(uint8_t path)
+{
+	static const char *const names[] = {
+		[TRACE_PATH_NUS_RX] = "nus-rx",
+		[TRACE_PATH_NUS_TX] = "nus-tx",
+		[TRACE_PATH_HID] = "hid",
+	};
+
+	return path < sizeof(names) / sizeof(names[0]) ? names[path] : "?";
+}
+
+const char *trace_ring_queue_name(uint8_t queue)
+{
+	static const char *const names[] = {
+		[TRACE_QUEUE_CDC_TX] = "cdc-tx",
+		[TRACE_QUEUE_CDC_ASYNC] = "cdc-async",
+		[TRACE_QUEUE_PROTOCOL] = "protocol",
+		[TRACE_QUEUE_NUS_TX] = "nus-tx",
+		[TRACE_QUEUE_NUS_RX] = "nus-rx",
+	};
+
+	return queue < sizeof(names) / sizeof(names[0]) ? names[queue] : "?";
+}
+
+static const char *recovery_name(uint8_t reason)
+{
+	static const char *const names[] = {
+		[TRACE_USB_RECOVERY_TIMEOUT] = "timeout",
+		[TRACE_USB_RECOVERY_UDC_ERROR] = "UDC error",
+		[TRACE_USB_RECOVERY_STACK_ERROR] = "stack error",
+	};
+
+	return reason < sizeof(names) / sizeof(names[0]) ? names[reason] : "?";
+}
+
+int trace_ring_format(const struct trace_record *record, char *buf, size_t len)
+{
+	unsigned int ms = record->time_ms % 1000;
+	unsigned int s = record->time_ms / 1000;
+	unsigned int arg = record->arg;
+	unsigned int value = record->value;
+
+	switch (record->type) {
+	case TRACE_EVENT_BOOT:
+		return snprintf(buf, len, "%6u.%03u boot #%u (%s)", s, ms, value,
+				reset_cause_name(record->arg));
+	case TRACE_EVENT_PHASE:
+		return snprintf(buf, len, "%6u.%03u phase %s +%u ms", s, ms,
+				connection_timing_phase_name(record->arg), value);
+	case TRACE_EVENT_DISCONNECTED:
+		return snprintf(buf, len, "%6u.%03u disconnected (reason 0x%02x)", s, ms, arg);
+	case TRACE_EVENT_DROP:
+		return snprintf(buf, len, "%6u.%03u drop %s x%u", s, ms, path_name(arg), value);
+	case TRACE_EVENT_QUEUE_FULL:
+		return snprintf(buf, len, "%6u.%03u queue %s full x%u", s, ms,
+				trace_ring_queue_name(arg), value);
+	case TRACE_EVENT_USB_RESET:
+		return snprintf(buf, len, "%6u.%03u usb bus reset", s, ms);
+	case TRACE_EVENT_USB_SUSPEND:
+		return snprintf(buf, len, "%6u.%03u usb %s", s, ms, arg ? "suspend" : "resume");
+	case TRACE_EVENT_USB_RECOVERY:
+		return snprintf(buf, len, "%6u.%03u usb recovery reset (%s) attempt %u", s, ms,
+				recovery_name(arg), value);
+	case TRACE_EVENT_LATENCY_MAX:
+		return snprintf(buf, len, "%6u.%03u latency max report %u %u us", s, ms, arg,
+				value);
+	case TRACE_EVENT_STALL:
+		return snprintf(buf, len, "%6u.%03u stall %s %u ms", s, ms,
+				stall_watch_source_name(record->arg), value);
+	case TRACE_EVENT_QUEUE_DEPTH:
+		return snprintf(buf, len, "%6u.%03u   queue %s depth %u", s, ms,
+				trace_ring_queue_name(arg), value);
+	case TRACE_EVENT_USB_RESTART:
+		return snprintf(buf, len, "%6u.%03u usb recovery restart (%s) attempt %u", s, ms,
+				recovery_name(arg), value);
+	case TRACE_EVENT_LINK_RISK:
+		return snprintf(buf, len, "%6u.%03u link %s, RSSI heading for -%u dBm", s, ms,
+				arg ? "at risk" : "safe", value);
+	default:
+		return snprintf(buf, len, "%6u.%03u type %u arg %u value %u", s, ms,
+				(unsigned int)record->type, arg, value);
+	}
+}
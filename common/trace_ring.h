@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Binary event trace kept across resets, shared by both relays
+ *
+ * A ring of compact 8-byte records: connection phases, disconnects, dropped
+ * packets, full queues, USB resets, new worst-case latencies and stalls
+ * (see stall_watch.h). The
+ * platform places the ring in memory that the start-up code leaves alone
+ * (.noinit on nRF, RTC slow memory on ESP), so after a watchdog or software
+ * reset the events leading up to it can still be read over CDC1 or as a
+ * TraceResponse. Power loss clears it.
+ *
+ * Each boot appends a BOOT record carrying the reset cause, so one dump can
+ * span several boots. Times are milliseconds since the boot they belong to.
+ *
+ * Records are claimed with an atomic add and may be written from any
+ * context, interrupts included. A reader racing a writer may see one torn
+ * record; nothing else is locked. Drops and full queues are rate limited so
+ * a burst takes one record rather than the whole ring.
+ *
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef TRACE_RING_H_
+#define TRACE_RING_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Records kept; a power of two so the index survives the head wrapping */
+#define TRACE_RING_LEN 128
+
+/* Records in one TraceResponse */
+#define TRACE_RING_RESPONSE_MAX 48
+
+/* Minimum spacing of DROP and QUEUE_FULL records; the ones in between are
+ * counted into the next record
+ */
+#define TRACE_RING_RATE_MS 100
+
+enum trace_event {
+	TRACE_EVENT_BOOT,         /* arg: trace_reset_cause, value: boot count */
+	TRACE_EVENT_PHASE,        /* arg: connection_timing_phase, value: ms since scan start */
+	TRACE_EVENT_DISCONNECTED, /* arg: HCI reason */
+	TRACE_EVENT_DROP,         /* arg: trace_path, value: drops since the last record */
+	TRACE_EVENT_QUEUE_FULL,   /* arg: trace_queue, value: misses since the last record */
+	TRACE_EVENT_USB_RESET,    /* Host bus reset */
+	TRACE_EVENT_USB_SUSPEND,  /* arg: 1 suspended, 0 resumed */
+	TRACE_EVENT_USB_RECOVERY, /* arg: trace_usb_recovery, value: attempt */
+	TRACE_EVENT_LATENCY_MAX,  /* arg: HID report ID, value: new worst case in us */
+	TRACE_EVENT_STALL,        /* arg: stall_watch source, value: ms held up */
+	TRACE_EVENT_QUEUE_DEPTH,  /* arg: trace_queue, value: depth at the last STALL */
+	TRACE_EVENT_LINK_RISK,    /* arg: 1 at risk, 0 safe again, value: -projected RSSI dBm */
+	TRACE_EVENT_USB_RESTART,  /* arg: trace_usb_recovery, value: attempt */
+	TRACE_EVENT_COUNT,
+};
+
+enum trace_reset_cause {
+	TRACE_RESET_UNKNOWN,
+	TRACE_RESET_POWER_ON,
+	TRACE_RESET_PIN,
+	TRACE_RESET_SOFTWARE,
+	TRACE_RESET_WATCHDOG,
+	TRACE_RESET_BROWNOUT,
+	TRACE_RESET_PANIC,
+	TRACE_RESET_WAKE,
+};
+
+enum trace_path {
+	TRACE_PATH_NUS_RX,      /* MouthPad NUS notifications to CDC0 */
+	TRACE_PATH_NUS_TX,      /* CDC0 pass-through writes to the MouthPad */
+	TRACE_PATH_HID,         /* MouthPad HID reports to USB */
+};
+
+enum trace_queue {
+	TRACE_QUEUE_CDC_TX,     /* CDC0 TX ring */
+	TRACE_QUEUE_CDC_ASYNC,  /* Deferred CDC0 message slots */
+	TRACE_QUEUE_PROTOCOL,   /* Protocol handler queue */
+	TRACE_QUEUE_NUS_TX,     /* Host writes waiting for the MouthPad */
+	TRACE_QUEUE_NUS_RX,     /* MouthPad notifications waiting for CDC0 (ESP) */
+	TRACE_QUEUE_COUNT,
+};
+
+enum trace_usb_recovery {
+	TRACE_USB_RECOVERY_TIMEOUT,
+	TRACE_USB_RECOVERY_UDC_ERROR,
+	TRACE_USB_RECOVERY_STACK_ERROR,
+};
+
+struct trace_record {
+	uint32_t time_ms;
+	uint16_t value;
+	uint8_t type;
+	uint8_t arg;
+};
+
+_Static_assert(sizeof(struct trace_record) == 8, "Trace records are 8 bytes on the wire");
+
+/* Laid out by the platform in retained memory; contents are owned here */
+struct trace_ring {
+	uint32_t magic;
+	uint32_t check;
+	uint32_t boot_count;
+	atomic_uint head;           /* Records written since the last clear */
+	struct trace_record records[TRACE_RING_LEN];
+};
+
+/**
+ * @brief Adopt the retained ring and append this boot's BOOT record
+ *
+ * The ring is kept if it survived the reset intact, and cleared otherwise.
+ * Nothing is recorded before this is called.
+ *
+ * @param now_ms Millisecond clock since boot
+ * @return true if records from before the reset were kept
+ */
+bool trace_ring_init(struct trace_ring *ring, uint32_t (*now_ms)(void),
+		     enum trace_reset_cause cause);
+
+/**
+ * @brief Append one record; safe from any context
+ */
+void trace_ring_record(enum trace_event type, uint8_t arg, uint32_t value);
+
+/**
+ * @brief Count one dropped packet or full queue, rate limited
+ *
+ * @param type TRACE_EVENT_DROP or TRACE_EVENT_QUEUE_FULL
+ */
+void trace_ring_count(enum trace_event type, uint8_t arg);
+
+/**
+ * @brief Note a latency sample; recorded only when it is a new worst case
+ */
+void trace_ring_latency(uint8_t report_id, uint32_t us);
+
+/**
+ * @brief Records held, oldest first from index 0
+ */
+size_t trace_ring_held(void);
+
+/**
+ * @brief Copy one held record
+ *
+ * @return false past the end
+ */
+bool trace_ring_get(size_t index, struct trace_record *record);
+
+/**
+ * @brief Discard every record; the boot count is kept
+ */
+void trace_ring_clear(void);
+
+/**
+ * @brief Fill in a TraceResponse with held records from offset
+ */
+void trace_ring_fill_response(uint32_t offset, mouthware_message_TraceResponse *response);
+
+/**
+ * @brief One record as a console line
+ *
+ * @return Characters written, as snprintf
+ */
+int trace_ring_format(const struct trace_record *record, char *buf, size_t len);
+
+/**
+ * @brief Name of a trace_queue, as in console lines
+ */
+const char *trace_ring_queue_name(uint8_t queue);
+
+/**
+ * @brief Boots counted since the ring was last found invalid
+ */
+uint32_t trace_ring_boot_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_RING_H_ */
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tuning_profile.h"
+
+#define SAVED_VERSION 1
+
+#define PROFILE_FIRST mouthware_message_RelayProfile_RELAY_PROFILE_LOW_LATENCY
+#define PROFILE_LAST  mouthware_message_RelayProfile_RELAY_PROFILE_BATTERY
+
+#define KNOB(name) mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_##name
+
+_Static_assert(PROFILE_LAST - PROFILE_FIRST + 1 == TUNING_PROFILE_PRESETS, "Preset count");
+
+/* What a write may set; the platform's presets are taken as they are */
+static const struct {
+	const char *name;
+	const char *unit;
+	int32_t min;
+	int32_t max;
+} knobs[TUNING_PROFILE_KNOBS] = {
+	[KNOB(ACTIVE_INTERVAL)] = { "active interval", " x 1.25ms", 6, 40 },
+	[KNOB(IDLE_INTERVAL)] = { "idle interval", " x 1.25ms", 6, 400 },
+	[KNOB(IDLE_LATENCY)] = { "idle latency", "", 0, 100 },
+	[KNOB(TX_POWER_TARGET)] = { "TX target", " dBm", -100, -20 },
+	[KNOB(STATUS_LIGHTS)] = { "lights", "", 0, 1 },
+	[KNOB(CDC_COALESCE_US)] = { "coalesce", " us", 0, 20000 },
+};
+
+static const char *const preset_names[] = {
+	[PROFILE_FIRST] = "low-latency",
+	[mouthware_message_RelayProfile_RELAY_PROFILE_BALANCED] = "balanced",
+	[PROFILE_LAST] = "battery",
+};
+
+static struct tuning_profile_config config;
+
+/* Written by the one writer at a time, read by tuning_profile_save() */
+static atomic_uint preset = mouthware_message_RelayProfile_RELAY_PROFILE_BALANCED;
+static atomic_uint overridden;
+static atomic_int overrides[TUNING_PROFILE_KNOBS];
+
+/* Values in force */
+static atomic_int values[TUNING_PROFILE_KNOBS];
+
+static bool idle_fits(int32_t interval, int32_t latency)
+{
+	return !config.max_idle_sleep_ms ||
+	       (uint32_t)(1 + latency) * (uint32_t)interval * 5U / 4U <= config.max_idle_sleep_ms;
+}
+
+/* Work out every knob again and tell the platform which ones moved */
+static void resolve(void)
+{
+	unsigned int p = atomic_load_explicit(&preset, memory_order_relaxed);
+	unsigned int mask = atomic_load_explicit(&overridden, memory_order_relaxed);
+	int32_t want[TUNING_PROFILE_KNOBS];
+	uint32_t changed = 0;
+
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		want[k] = (mask & (1u << k)) ?
+				  atomic_load_explicit(&overrides[k], memory_order_relaxed) :
+				  config.presets[p - PROFILE_FIRST][k];
+	}
+
+	/* An override kept from another preset may no longer fit its latency */
+	while (want[KNOB(IDLE_LATENCY)] > 0 &&
+	       !idle_fits(want[KNOB(IDLE_INTERVAL)], want[KNOB(IDLE_LATENCY)])) {
+		want[KNOB(IDLE_LATENCY)]--;
+	}
+
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		if (atomic_exchange_explicit(&values[k], want[k], memory_order_relaxed) != want[k]) {
+			changed |= 1u << k;
+		}
+	}
+
+	if (changed && config.changed) {
+		config.changed(changed);
+	}
+}
+
+void tuning_profile_init(const struct tuning_profile_config *new_config)
+{
+	config = *new_config;
+	atomic_store_explicit(&preset, mouthware_message_RelayProfile_RELAY_PROFILE_BALANCED,
+			      memory_order_relaxed);
+	atomic_store_explicit(&overridden, 0, memory_order_relaxed);
+
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		atomic_store_explicit(&values[k],
+				      config.presets[mouthware_message_RelayProfile_RELAY_PROFILE_BALANCED -
+						     PROFILE_FIRST][k],
+				      memory_order_relaxed);
+	}
+	if (config.changed) {
+		config.changed(TUNING_PROFILE_ALL);
+	}
+}
+
+static bool in_range(int k, int32_t value)
+{
+	return value >= knobs[k].min && value <= knobs[k].max;
+}
+
+bool tuning_profile_restore(const void *data, size_t len)
+{
+	struct tuning_profile_saved saved;
+	unsigned int mask;
+
+	if (len != sizeof(saved)) {
+		return false;
+	}
+	memcpy(&saved, data, sizeof(saved));
+	if (saved.version != SAVED_VERSION || saved.profile < PROFILE_FIRST ||
+	    saved.profile > PROFILE_LAST || (saved.overridden & ~TUNING_PROFILE_ALL)) {
+		return false;
+	}
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		if ((saved.overridden & (1u << k)) && !in_range(k, saved.values[k])) {
+			return false;
+		}
+	}
+
+	mask = saved.overridden;
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		atomic_store_explicit(&overrides[k], saved.values[k], memory_order_relaxed);
+	}
+	atomic_store_explicit(&overridden, mask, memory_order_relaxed);
+	atomic_store_explicit(&preset, saved.profile, memory_order_relaxed);
+	resolve();
+	return true;
+}
+
+void tuning_profile_save(struct tuning_profile_saved *saved)
+{
+	unsigned int mask = atomic_load_explicit(&overridden, memory_order_relaxed);
+
+	memset(saved, 0, sizeof(*saved));
+	saved->version = SAVED_VERSION;
+	saved->profile = (uint8_t)atomic_load_explicit(&preset, memory_order_relaxed);
+	saved->overridden = (uint16_t)mask;
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		if (mask & (1u << k)) {
+			saved->values[k] = atomic_load_explicit(&overrides[k], memory_order_relaxed);
+		}
+	}
+}
+
+bool tuning_profile_write(const mouthware_message_RelayProfileWrite *write, bool *persist)
+{
+	unsigned int p = atomic_load_explicit(&preset, memory_order_relaxed);
+	unsigned int mask = atomic_load_explicit(&overridden, memory_order_relaxed);
+	int32_t next[TUNING_PROFILE_KNOBS];
+	int32_t interval;
+	int32_t latency;
+
+	*persist = false;
+	if (write->profile != mouthware_message_RelayProfile_RELAY_PROFILE_UNCHANGED &&
+	    (write->profile < PROFILE_FIRST || write->profile > PROFILE_LAST)) {
+		return false;
+	}
+	if (write->profile != mouthware_message_RelayProfile_RELAY_PROFILE_UNCHANGED) {
+		p = write->profile;
+	}
+	if (write->clear_overrides) {
+		mask = 0;
+	}
+
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		next[k] = atomic_load_explicit(&overrides[k], memory_order_relaxed);
+	}
+	for (pb_size_t i = 0; i < write->overrides_count; i++) {
+		const mouthware_message_RelayProfileKnobValue *o = &write->overrides[i];
+
+		if ((unsigned int)o->knob >= (unsigned int)TUNING_PROFILE_KNOBS ||
+		    !in_range(o->knob, o->value)) {
+			return false;
+		}
+		next[o->knob] = o->value;
+		mask |= 1u << o->knob;
+	}
+
+	/* The link must still outlast the idle sleep this asks for */
+	interval = (mask & (1u << KNOB(IDLE_INTERVAL))) ? next[KNOB(IDLE_INTERVAL)] :
+		   config.presets[p - PROFILE_FIRST][KNOB(IDLE_INTERVAL)];
+	latency = (mask & (1u << KNOB(IDLE_LATENCY))) ? next[KNOB(IDLE_LATENCY)] :
+		  config.presets[p - PROFILE_FIRST][KNOB(IDLE_LATENCY)];
+	if (!idle_fits(interval, latency)) {
+		return false;
+	}
+
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		if ((mask & (1u << k)) &&
+		    atomic_exchange_explicit(&overrides[k], next[k], memory_order_relaxed) != next[k]) {
+			*persist = true;
+		}
+	}
+	if (atomic_exchange_explicit(&overridden, mask, memory_order_relaxed) != mask) {
+		*persist = true;
+	}
+	if (atomic_exchange_explicit(&preset, p, memory_order_relaxed) != p) {
+		*persist = true;
+	}
+	resolve();
+	return true;
+}
+
+mouthware_message_RelayProfile tuning_profile_cycle(void)
+{
+	unsigned int p = atomic_load_explicit(&preset, memory_order_relaxed);
+
+	p = p >= PROFILE_LAST ? PROFILE_FIRST : p + 1;
+	atomic_store_explicit(&preset, p, memory_order_relaxed);
+	resolve();
+	return (mouthware_message_RelayProfile)p;
+}
+
+int32_t tuning_profile_get(mouthware_message_RelayProfileKnob knob)
+{
+	return atomic_load_explicit(&values[knob], memory_order_relaxed);
+}
+
+mouthware_message_RelayProfile tuning_profile_preset(void)
+{
+	return (mouthware_message_RelayProfile)atomic_load_explicit(&preset, memory_order_relaxed);
+}
+
+const char *tuning_profile_name(mouthware_message_RelayProfile profile)
+{
+	if (profile < PROFILE_FIRST || profile > PROFILE_LAST) {
+		return "unknown";
+	}
+	return preset_names[profile];
+}
+
+void tuning_profile_get_status(mouthware_message_RelayProfileResponse *response)
+{
+	response->profile = tuning_profile_preset();
+	response->overridden = atomic_load_explicit(&overridden, memory_order_relaxed);
+	response->applied = config.applied;
+	response->values_count = TUNING_PROFILE_KNOBS;
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		response->values[k] = tuning_profile_get(k);
+	}
+}
+
+int tuning_profile_format(char *buf, size_t len)
+{
+	unsigned int mask = atomic_load_explicit(&overridden, memory_order_relaxed);
+	int n = snprintf(buf, len, "profile: %s", tuning_profile_name(tuning_profile_preset()));
+
+	for (int k = 0; k < TUNING_PROFILE_KNOBS; k++) {
+		if (!(config.applied & (1u << k)) || n < 0 || (size_t)n >= len) {
+			continue;
+		}
+		n += snprintf(buf + n, len - n, ", %s %d%s%s", knobs[k].name,
+			      (int)tuning_profile_get(k), knobs[k].unit,
+			      (mask & (1u << k)) ? "*" : "");
+	}
+	return n;
+}
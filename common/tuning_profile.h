@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Runtime tuning profile, shared by both relays
+ *
+ * The knobs of RelayProfileKnob (connection intervals, TX power target,
+ * status lights, CDC0 coalescing) come from one of three presets:
+ *
+ *   LOW_LATENCY  shortest intervals, never relaxed, a stronger link
+ *   BALANCED     the build-time settings
+ *   BATTERY      longer intervals, a weaker link, status lights dark
+ *
+ * with single knobs overridden on top. Overrides are kept when the preset
+ * changes, until a RelayProfileWrite clears them. The platform builds the
+ * presets from its Kconfig, persists tuning_profile_save() and acts on the
+ * knobs; each change calls it back with the knobs whose value moved.
+ *
+ * tuning_profile_restore(), tuning_profile_write() and
+ * tuning_profile_cycle() must not run at once, and call the platform back
+ * in their own context. tuning_profile_get(), tuning_profile_save() and the
+ * status functions may be called from any context.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef TUNING_PROFILE_H_
+#define TUNING_PROFILE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TUNING_PROFILE_KNOBS ((int)_mouthware_message_RelayProfileKnob_ARRAYSIZE)
+
+/* Presets, LOW_LATENCY to BATTERY */
+#define TUNING_PROFILE_PRESETS 3
+
+/* Knob bits the platform is called back with */
+#define TUNING_PROFILE_ALL ((1u << TUNING_PROFILE_KNOBS) - 1)
+
+struct tuning_profile_config {
+	/* Indexed by RelayProfile - 1, then by RelayProfileKnob */
+	int32_t presets[TUNING_PROFILE_PRESETS][TUNING_PROFILE_KNOBS];
+	/* Least time the link may go without an idle connection event,
+	 * (1 + IDLE_LATENCY) * IDLE_INTERVAL, in ms; longer is refused
+	 */
+	uint32_t max_idle_sleep_ms;
+	uint32_t applied; /* Knob bits the platform acts on */
+	/* Runs in the writer's context */
+	void (*changed)(uint32_t knobs);
+};
+
+/* What the platform persists, as one blob */
+struct tuning_profile_saved {
+	uint8_t version;
+	uint8_t profile; /* RelayProfile */
+	uint16_t overridden; /* Knob bits */
+	int32_t values[TUNING_PROFILE_KNOBS]; /* Overrides; others unused */
+};
+
+/**
+ * @brief Start from BALANCED with no overrides
+ *
+ * Calls the platform back with every knob.
+ */
+void tuning_profile_init(const struct tuning_profile_config *config);
+
+/**
+ * @brief Take back what tuning_profile_save() wrote
+ *
+ * @return false if the blob is not one this firmware wrote; the profile is
+ *         left as it was
+ */
+bool tuning_profile_restore(const void *data, size_t len);
+
+void tuning_profile_save(struct tuning_profile_saved *saved);
+
+/**
+ * @brief Apply a RelayProfileWrite
+ *
+ * A write with an unknown preset, an unknown knob or a value out of range
+ * changes nothing.
+ *
+ * @param[out] persist Set if the profile changed and must be saved
+ *
+ * @return false if the write was refused
+ */
+bool tuning_profile_write(const mouthware_message_RelayProfileWrite *write, bool *persist);
+
+/**
+ * @brief Move to the next preset, after BATTERY back to LOW_LATENCY
+ *
+ * @return The preset now in force
+ */
+mouthware_message_RelayProfile tuning_profile_cycle(void);
+
+/**
+ * @brief Value of a knob, override included
+ */
+int32_t tuning_profile_get(mouthware_message_RelayProfileKnob knob);
+
+mouthware_message_RelayProfile tuning_profile_preset(void);
+
+const char *tuning_profile_name(mouthware_message_RelayProfile profile);
+
+/**
+ * @brief Fill in a RelayProfileResponse
+ */
+void tuning_profile_get_status(mouthware_message_RelayProfileResponse *response);
+
+/**
+ * @brief Preset and knobs as one console line; overridden knobs are starred
+ *
+ * @return Characters written, as snprintf
+ */
+int tuning_profile_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TUNING_PROFILE_H_ */
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "tx_power.h"
+
+static struct tx_power_config config = {
+	.min_dbm = 0,
+	.max_dbm = 0,
+	.target_dbm = -70,
+	.margin_db = 10,
+	.step_db = 4,
+};
+
+static atomic_int level;
+static atomic_int peer_tx;
+static atomic_int estimate;
+static atomic_uint raises;
+static atomic_uint cuts;
+
+void tx_power_init(const struct tx_power_config *new_config)
+{
+	config = *new_config;
+	atomic_store_explicit(&level, config.max_dbm, memory_order_relaxed);
+	atomic_store_explicit(&peer_tx, config.peer_tx_dbm, memory_order_relaxed);
+}
+
+int8_t tx_power_connected(void)
+{
+	atomic_store_explicit(&level, config.max_dbm, memory_order_relaxed);
+	atomic_store_explicit(&peer_tx, config.peer_tx_dbm, memory_order_relaxed);
+	return config.max_dbm;
+}
+
+int8_t tx_power_update(int8_t rssi)
+{
+	int now = atomic_load_explicit(&level, memory_order_relaxed);
+	int path_loss = atomic_load_explicit(&peer_tx, memory_order_relaxed) - rssi;
+	int received = now - path_loss;
+	int middle = config.target_dbm + config.margin_db / 2;
+	int want = now;
+
+	atomic_store_explicit(&estimate, received, memory_order_relaxed);
+
+	if (received < config.target_dbm) {
+		want = middle + path_loss;
+	} else if (received > config.target_dbm + config.margin_db) {
+		int excess = received - middle;
+
+		want = now - (excess < config.step_db ? excess : config.step_db);
+	}
+
+	if (want > config.max_dbm) {
+		want = config.max_dbm;
+	}
+	if (want < config.min_dbm) {
+		want = config.min_dbm;
+	}
+	return (int8_t)want;
+}
+
+void tx_power_applied(int8_t level_dbm)
+{
+	int before = atomic_exchange_explicit(&level, level_dbm, memory_order_relaxed);
+
+	if (level_dbm > before) {
+		atomic_fetch_add_explicit(&raises, 1, memory_order_relaxed);
+	} else if (level_dbm < before) {
+		atomic_fetch_add_explicit(&cuts, 1, memory_order_relaxed);
+	}
+}
+
+void tx_power_set_target(int8_t target_dbm)
+{
+	config.target_dbm = target_dbm;
+}
+
+void tx_power_peer_tx(int8_t dbm)
+{
+	atomic_store_explicit(&peer_tx, dbm, memory_order_relaxed);
+}
+
+void tx_power_get_status(struct tx_power_status *status)
+{
+	status->level_dbm = (int8_t)atomic_load_explicit(&level, memory_order_relaxed);
+	status->peer_tx_dbm = (int8_t)atomic_load_explicit(&peer_tx, memory_order_relaxed);
+	status->estimate_dbm = (int8_t)atomic_load_explicit(&estimate, memory_order_relaxed);
+	status->raises = atomic_load_explicit(&raises, memory_order_relaxed);
+	status->cuts = atomic_load_explicit(&cuts, memory_order_relaxed);
+}
+
+int tx_power_format(char *buf, size_t len)
+{
+	struct tx_power_status status;
+
+	tx_power_get_status(&status);
+
+	return snprintf(buf, len,
+			"txpower: %+d dBm (%+d..%+d), MouthPad %+d dBm, receives ~%d dBm "
+			"(target %d), %u raises, %u cuts",
+			status.level_dbm, config.min_dbm, config.max_dbm, status.peer_tx_dbm,
+			status.estimate_dbm, config.target_dbm, (unsigned int)status.raises,
+			(unsigned int)status.cuts);
+}
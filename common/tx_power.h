@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Closed-loop TX power for the primary MouthPad link, shared by both
+ *         relays
+ *
+ * Each connection starts at max_dbm. Every smoothed RSSI reading estimates
+ * what the MouthPad receives from the relay, taking the path loss to be the
+ * same both ways:
+ *
+ *   path loss  = MouthPad TX power - RSSI at the relay
+ *   estimate   = relay TX power - path loss
+ *
+ * The MouthPad's TX power is peer_tx_dbm until it reports its own through
+ * LE Power Control. An estimate below target_dbm raises the level at once
+ * to the middle of the band target_dbm .. target_dbm + margin_db, so a user
+ * moving away loses no packets to retransmission waiting for a ramp. An
+ * estimate above the band cuts it by at most step_db per reading, down to
+ * the middle. The level stays within min_dbm .. max_dbm.
+ *
+ * The platform applies the level tx_power_update() returns to the
+ * connection and reports back what the controller chose, which may be a
+ * nearby step of its own.
+ *
+ * tx_power_connected(), tx_power_update(), tx_power_applied() and
+ * tx_power_set_target() have one caller, the context reading the RSSI; tx_power_peer_tx() and the status
+ * functions may be called from any context.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef TX_POWER_H_
+#define TX_POWER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct tx_power_config {
+	int8_t min_dbm; /* Lowest level used */
+	int8_t max_dbm; /* Highest level, and the level each connection starts at */
+	int8_t target_dbm; /* Least signal the MouthPad should receive */
+	uint8_t margin_db; /* Band above target_dbm the level is left alone in */
+	uint8_t step_db; /* Most the level is cut by per reading */
+	int8_t peer_tx_dbm; /* MouthPad TX power until it reports its own */
+};
+
+struct tx_power_status {
+	int8_t level_dbm; /* Applied to the connection */
+	int8_t peer_tx_dbm;
+	int8_t estimate_dbm; /* What the MouthPad receives, from the last reading */
+	uint32_t raises;
+	uint32_t cuts;
+};
+
+void tx_power_init(const struct tx_power_config *config);
+
+/**
+ * @brief Start a new connection
+ *
+ * @return Level to apply, max_dbm
+ */
+int8_t tx_power_connected(void);
+
+/**
+ * @brief Fold in one smoothed RSSI reading of the connection
+ *
+ * @return Level to apply; the one applied now if nothing is to change
+ */
+int8_t tx_power_update(int8_t rssi);
+
+/**
+ * @brief Record the level the controller chose
+ */
+void tx_power_applied(int8_t level_dbm);
+
+/**
+ * @brief Move target_dbm, for the tuning profile
+ *
+ * Takes effect at the next reading.
+ */
+void tx_power_set_target(int8_t target_dbm);
+
+/**
+ * @brief The MouthPad reported its TX power
+ */
+void tx_power_peer_tx(int8_t dbm);
+
+void tx_power_get_status(struct tx_power_status *status);
+
+/**
+ * @brief Level, estimate and change counts as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int tx_power_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TX_POWER_H_ */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "usb_composition.h"
+#include "MouthpadRelay.pb.h"
+
+#define COMPOSITION(name) mouthware_message_UsbComposition_USB_COMPOSITION_##name
+
+static const char *const names[] = {
+	[COMPOSITION(FULL)] = "full",
+	[COMPOSITION(HID_BRIDGE)] = "bridge",
+	[COMPOSITION(HID_ONLY)] = "hid",
+};
+
+bool usb_composition_valid(uint32_t composition)
+{
+	return composition >= COMPOSITION(FULL) && composition <= COMPOSITION(HID_ONLY);
+}
+
+uint32_t usb_composition_next(uint32_t composition)
+{
+	if (!usb_composition_valid(composition) || composition == COMPOSITION(HID_ONLY)) {
+		return COMPOSITION(FULL);
+	}
+	return composition + 1;
+}
+
+const char *usb_composition_name(uint32_t composition)
+{
+	return usb_composition_valid(composition) ? names[composition] : "?";
+}
+
+uint32_t usb_composition_parse(const char *name)
+{
+	for (uint32_t c = COMPOSITION(FULL); c <= COMPOSITION(HID_ONLY); c++) {
+		if (strcmp(name, names[c]) == 0) {
+			return c;
+		}
+	}
+	return COMPOSITION(UNCHANGED);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Which USB functions a relay enumerates with
+ *
+ *   FULL        every function the firmware was built with: CDC0, CDC1,
+ *               and the relay HID, WebUSB or split controls interface
+ *   HID_BRIDGE  the HID interfaces and CDC0, which carries the relay
+ *               protocol and the NUS bridge
+ *   HID_ONLY    the HID interfaces alone, the relay HID interface included
+ *               when it is built
+ *
+ * Each CDC function makes the host bind a serial driver at every plug-in
+ * and wake, and WebUSB adds BOS and MS OS 2.0 requests; a relay used only
+ * as a mouse enumerates faster without them. The composition is saved by
+ * the platform and read before its USB stack starts, so a change takes
+ * effect at the next enumeration. Without CDC0 and the relay HID interface
+ * the relay protocol is out of reach; the button gesture brings FULL back.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef USB_COMPOSITION_H_
+#define USB_COMPOSITION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Whether a saved or written value names a composition (not UNCHANGED) */
+bool usb_composition_valid(uint32_t composition);
+
+/* The one the button moves to: FULL, HID_BRIDGE, HID_ONLY, FULL, ... */
+uint32_t usb_composition_next(uint32_t composition);
+
+/* Short name for logs and the console */
+const char *usb_composition_name(uint32_t composition);
+
+/**
+ * @brief Composition named on the console
+ *
+ * @return FULL for "full", HID_BRIDGE for "bridge", HID_ONLY for "hid",
+ *         UNCHANGED for anything else
+ */
+uint32_t usb_composition_parse(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_COMPOSITION_H_ */
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "usb_phase.h"
+
+#define BIN_US (USB_PHASE_FRAME_US / USB_PHASE_BINS)
+
+static atomic_uint last_sof_us;
+static atomic_uint sofs;
+static atomic_uint reports;
+static atomic_uint phase_sum_us;
+static atomic_uint waits;
+static atomic_uint wait_sum_us;
+static atomic_uint worst_wait_us;
+static atomic_uint bins[USB_PHASE_BINS];
+
+void usb_phase_sof(uint32_t now_us)
+{
+	atomic_store_explicit(&last_sof_us, now_us, memory_order_relaxed);
+	atomic_fetch_add_explicit(&sofs, 1, memory_order_release);
+}
+
+void usb_phase_submit(uint32_t now_us)
+{
+	if (atomic_load_explicit(&sofs, memory_order_acquire) == 0) {
+		return;
+	}
+
+	/* A late or missed SOF still gives the phase within the frame */
+	uint32_t phase = (now_us - atomic_load_explicit(&last_sof_us, memory_order_relaxed)) %
+			 USB_PHASE_FRAME_US;
+
+	atomic_fetch_add_explicit(&bins[phase / BIN_US], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&phase_sum_us, phase, memory_order_relaxed);
+	atomic_fetch_add_explicit(&reports, 1, memory_order_relaxed);
+}
+
+void usb_phase_done(uint32_t submit_us, uint32_t now_us)
+{
+	uint32_t wait = now_us - submit_us;
+
+	atomic_fetch_add_explicit(&wait_sum_us, wait, memory_order_relaxed);
+	atomic_fetch_add_explicit(&waits, 1, memory_order_relaxed);
+	if (wait > atomic_load_explicit(&worst_wait_us, memory_order_relaxed)) {
+		atomic_store_explicit(&worst_wait_us, wait, memory_order_relaxed);
+	}
+}
+
+void usb_phase_get(struct usb_phase_stats *stats)
+{
+	stats->sofs = atomic_load_explicit(&sofs, memory_order_relaxed);
+	stats->reports = atomic_load_explicit(&reports, memory_order_relaxed);
+	stats->phase_sum_us = atomic_load_explicit(&phase_sum_us, memory_order_relaxed);
+	stats->waits = atomic_load_explicit(&waits, memory_order_relaxed);
+	stats->wait_sum_us = atomic_load_explicit(&wait_sum_us, memory_order_relaxed);
+	stats->worst_wait_us = atomic_load_explicit(&worst_wait_us, memory_order_relaxed);
+	for (int i = 0; i < USB_PHASE_BINS; i++) {
+		stats->bins[i] = atomic_load_explicit(&bins[i], memory_order_relaxed);
+	}
+}
+
+void usb_phase_reset(void)
+{
+	atomic_store_explicit(&reports, 0, memory_order_relaxed);
+	atomic_store_explicit(&phase_sum_us, 0, memory_order_relaxed);
+	atomic_store_explicit(&waits, 0, memory_order_relaxed);
+	atomic_store_explicit(&wait_sum_us, 0, memory_order_relaxed);
+	atomic_store_explicit(&worst_wait_us, 0, memory_order_relaxed);
+	for (int i = 0; i < USB_PHASE_BINS; i++) {
+		atomic_store_explicit(&bins[i], 0, memory_order_relaxed);
+	}
+}
+
+int usb_phase_format(char *buf, size_t len)
+{
+	struct usb_phase_stats stats;
+	int n;
+
+	usb_phase_get(&stats);
+
+	n = snprintf(buf, len, "usb: %u SOFs, %u reports at phase %u us, wait %u us (worst %u), bins",
+		     (unsigned int)stats.sofs, (unsigned int)stats.reports,
+		     (unsigned int)(stats.reports ? stats.phase_sum_us / stats.reports : 0),
+		     (unsigned int)(stats.waits ? stats.wait_sum_us / stats.waits : 0),
+		     (unsigned int)stats.worst_wait_us);
+	for (int i = 0; i < USB_PHASE_BINS && n >= 0 && (size_t)n < len; i++) {
+		n += snprintf(buf + n, len - n, " %u", (unsigned int)stats.bins[i]);
+	}
+	return n;
+}
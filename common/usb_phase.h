@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Where HID reports land in the USB frame, shared by both relays
+ *
+ * The host reads the HID IN endpoint once per frame, shortly after the
+ * Start of Frame, so a report submitted late in a frame waits for the next
+ * one. With the platform passing in each SOF and each report's submit and
+ * completion, this keeps:
+ *
+ *   phase  time from the last SOF to the submit, in USB_PHASE_BINS bins
+ *   wait   time from the submit to the IN transfer completing
+ *
+ * The SOF times are taken in thread context on both platforms, so a phase
+ * carries that thread's scheduling jitter; the wait does not depend on
+ * them.
+ *
+ * Every function may be called from any context.
+ * No Zephyr or ESP-IDF headers may be pulled in.
+ */
+
+#ifndef USB_PHASE_H_
+#define USB_PHASE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Full-speed frame */
+#define USB_PHASE_FRAME_US 1000
+
+/* Phase histogram bins across one frame */
+#define USB_PHASE_BINS 8
+
+struct usb_phase_stats {
+	uint32_t sofs; /* SOFs seen */
+	uint32_t reports; /* Reports submitted with a SOF to measure from */
+	uint32_t phase_sum_us; /* Of those reports; wraps */
+	uint32_t waits; /* Reports read by the host */
+	uint32_t wait_sum_us; /* Of those reports; wraps */
+	uint32_t worst_wait_us;
+	uint32_t bins[USB_PHASE_BINS];
+};
+
+/**
+ * @brief Note a Start of Frame
+ *
+ * @param now_us Microsecond clock shared with the other calls; may wrap
+ */
+void usb_phase_sof(uint32_t now_us);
+
+/**
+ * @brief Note a HID report handed to the USB stack
+ */
+void usb_phase_submit(uint32_t now_us);
+
+/**
+ * @brief Note that a report was read by the host
+ *
+ * @param submit_us Time passed to usb_phase_submit() for the report
+ */
+void usb_phase_done(uint32_t submit_us, uint32_t now_us);
+
+void usb_phase_get(struct usb_phase_stats *stats);
+
+void usb_phase_reset(void);
+
+/**
+ * @brief Mean phase and wait, and the histogram, as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int usb_phase_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_PHASE_H_ */
@@ -0,0 +1,109 @@
+#include "activity.h"
+
+#include <stdbool.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "ACTIVITY";
+
+#define IDLE_US ((int64_t)CONFIG_MOUTHPAD_ACTIVITY_IDLE_MS * 1000)
+#define DEEP_IDLE_US ((int64_t)CONFIG_MOUTHPAD_ACTIVITY_DEEP_IDLE_MS * 1000)
+
+_Static_assert(CONFIG_MOUTHPAD_ACTIVITY_DEEP_IDLE_MS > CONFIG_MOUTHPAD_ACTIVITY_IDLE_MS,
+               "Deep idle must come after idle");
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static activity_level_t s_level = ACTIVITY_DEEP_IDLE; // Nothing has moved since boot
+static int64_t s_last_us;
+static esp_timer_handle_t s_timer;
+
+// esp_timer task only
+static activity_level_t s_published = ACTIVITY_DEEP_IDLE;
+
+static activity_cb_t s_subscribers[CONFIG_MOUTHPAD_ACTIVITY_SUBSCRIBERS];
+static int s_subscriber_count;
+
+// Settle the level from the last stamp, publish a change, arm the next step.
+// Transitions are only published from here, so subscribers see them in order.
+static void activity_timer_callback(void *arg)
+{
+    (void)arg;
+    int64_t now = esp_timer_get_time();
+    int64_t next_us = 0;
+    activity_level_t level;
+
+    taskENTER_CRITICAL(&s_lock);
+    int64_t elapsed = now - s_last_us;
+    if (elapsed >= DEEP_IDLE_US) {
+        level = ACTIVITY_DEEP_IDLE;
+    } else if (elapsed >= IDLE_US) {
+        level = ACTIVITY_IDLE;
+        next_us = DEEP_IDLE_US - elapsed;
+    } else {
+        level = ACTIVITY_ACTIVE;
+        next_us = IDLE_US - elapsed;
+    }
+    s_level = level;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (level != s_published) {
+        s_published = level;
+        ESP_LOGD(TAG, "Activity level %d", level);
+        for (int i = 0; i < s_subscriber_count; i++) {
+            s_subscribers[i](level);
+        }
+    }
+
+    if (next_us > 0) {
+        esp_timer_start_once(s_timer, next_us);
+    }
+}
+
+esp_err_t activity_init(void)
+{
+    esp_timer_create_args_t args = {
+        .callback = &activity_timer_callback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "activity"
+    };
+    return esp_timer_create(&args, &s_timer);
+}
+
+void activity_mark(void)
+{
+    bool wake;
+
+    taskENTER_CRITICAL(&s_lock);
+    s_last_us = esp_timer_get_time();
+    wake = s_level != ACTIVITY_ACTIVE;
+    s_level = ACTIVITY_ACTIVE;
+    taskEXIT_CRITICAL(&s_lock);
+
+    // Publish from the timer task right away; it re-arms itself for idle
+    if (wake && s_timer) {
+        esp_timer_stop(s_timer);
+        esp_timer_start_once(s_timer, 1);
+    }
+}
+
+activity_level_t activity_level(void)
+{
+    activity_level_t level;
+
+    taskENTER_CRITICAL(&s_lock);
+    level = s_level;
+    taskEXIT_CRITICAL(&s_lock);
+    return level;
+}
+
+esp_err_t activity_subscribe(activity_cb_t cb)
+{
+    if (s_subscriber_count >= CONFIG_MOUTHPAD_ACTIVITY_SUBSCRIBERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_subscribers[s_subscriber_count++] = cb;
+    return ESP_OK;
+}
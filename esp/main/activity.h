@@ -0,0 +1,38 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One notion of "the user is doing something", shared by the connection
+// parameters, the LED, and RSSI polling. The HID and NUS paths stamp every
+// forwarded packet; after CONFIG_MOUTHPAD_ACTIVITY_IDLE_MS without one the
+// level drops to idle, after CONFIG_MOUTHPAD_ACTIVITY_DEEP_IDLE_MS to deep
+// idle, and the next packet makes it active again.
+typedef enum {
+    ACTIVITY_ACTIVE = 0,
+    ACTIVITY_IDLE,
+    ACTIVITY_DEEP_IDLE,
+} activity_level_t;
+
+// Called from the esp_timer task on every level change; keep it short
+typedef void (*activity_cb_t)(activity_level_t level);
+
+esp_err_t activity_init(void);
+
+// Note a forwarded packet. One short critical section, so it is cheap
+// enough to call for every report from any task.
+void activity_mark(void);
+
+// Current level; active as soon as a packet was marked
+activity_level_t activity_level(void);
+
+// Register for level changes during init; ESP_ERR_NO_MEM when all
+// CONFIG_MOUTHPAD_ACTIVITY_SUBSCRIBERS slots are taken
+esp_err_t activity_subscribe(activity_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
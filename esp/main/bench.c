@@ -0,0 +1,226 @@
+#include "bench.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include "MouthpadRelay.pb.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hid_latency.h"
+#include "mouthpad_hid_reports.h"
+#include "task_config.h"
+#include "transport_hid.h"
+#include "usb_cdc.h"
+
+#if CONFIG_MOUTHPAD_BENCH
+
+static const char *TAG = "BENCH";
+
+#define BENCH_RATE_MAX     8000
+#define BENCH_DURATION_MAX (60 * 1000)
+
+#define PASS_THROUGH_MAX pb_membersize(mouthware_message_PassThroughToApp_data_t, bytes)
+
+typedef struct {
+    uint32_t attempted;
+    uint32_t failed;      // Refused by the send call
+    uint32_t late;        // Slots skipped because a send overran
+    uint32_t max_call_us;
+    uint32_t peak_queued; // Pass-through: most bytes in the CDC0 TX FIFO
+    bool aborted;
+} bench_result_t;
+
+static bench_params_t s_params;
+static atomic_bool s_running;
+static TaskHandle_t s_task;
+
+static void bench_tick(void *arg)
+{
+    (void)arg;
+    xTaskNotifyGive(s_task);
+}
+
+static bool mouthpad_connected(void)
+{
+    uint8_t addr[6];
+    return transport_hid_get_active_address(addr) == ESP_OK;
+}
+
+// HID: motion alternates one count left and right so the cursor stays put;
+// other reports are all zeros, which presses nothing
+static esp_err_t send_hid(uint32_t seq)
+{
+    uint8_t report[MOUTHPAD_HID_REPORT_SIZE_MAX] = {0};
+
+    if (s_params.report_id == MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION) {
+        // 12-bit X of +1 or -1, Y of 0
+        report[0] = (seq & 1) ? 0xFF : 0x01;
+        report[1] = (seq & 1) ? 0x0F : 0x00;
+    }
+    return transport_hid_inject_input(s_params.report_id, report,
+                                      mouthpad_hid_report_size(s_params.report_id));
+}
+
+static esp_err_t send_pass_through(uint32_t seq)
+{
+    uint8_t data[PASS_THROUGH_MAX];
+
+    // Sequence number up front so a capture shows gaps
+    memset(data, (uint8_t)seq, s_params.size);
+    memcpy(data, &seq, MIN(s_params.size, sizeof(seq)));
+    return usb_cdc_send_pass_through(data, s_params.size, false, 0);
+}
+
+static void run(bench_result_t *result)
+{
+    const esp_timer_create_args_t args = {.callback = bench_tick, .name = "bench"};
+    esp_timer_handle_t timer;
+
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+        result->aborted = true;
+        return;
+    }
+
+    uint32_t slots = (uint32_t)((uint64_t)s_params.rate_hz * s_params.duration_ms / 1000);
+
+    ulTaskNotifyTake(pdTRUE, 0);
+    esp_timer_start_periodic(timer, 1000000 / s_params.rate_hz);
+
+    for (uint32_t seq = 0; result->attempted + result->late < slots; seq++) {
+        // More than one tick pending means slots went by while sending
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        if (ticks > 1) {
+            result->late += ticks - 1;
+        }
+
+        // A real MouthPad would now race the synthetic traffic
+        if (mouthpad_connected()) {
+            result->aborted = true;
+            break;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        esp_err_t ret = s_params.kind == BENCH_HID ? send_hid(seq) : send_pass_through(seq);
+        uint32_t call_us = (uint32_t)(esp_timer_get_time() - t0);
+
+        result->attempted++;
+        result->max_call_us = MAX(result->max_call_us, call_us);
+        if (ret != ESP_OK) {
+            result->failed++;
+        }
+        if (s_params.kind == BENCH_PASS_THROUGH) {
+            result->peak_queued = MAX(result->peak_queued, usb_cdc_tx_queued());
+        }
+    }
+
+    esp_timer_stop(timer);
+    esp_timer_delete(timer);
+}
+
+static void bench_task(void *arg)
+{
+    (void)arg;
+    bench_result_t result = {0};
+    uint32_t received, dropped_before, dropped_after;
+
+    // The tick timer notifies this task
+    s_task = xTaskGetCurrentTaskHandle();
+
+    transport_hid_get_counts(&received, &dropped_before);
+    int64_t start = esp_timer_get_time();
+
+    if (s_params.kind == BENCH_HID) {
+        if (transport_hid_inject_start() == ESP_OK) {
+            run(&result);
+            transport_hid_inject_stop();
+        } else {
+            result.aborted = true;
+        }
+    } else {
+        run(&result);
+    }
+
+    uint32_t elapsed_ms = MAX((uint32_t)((esp_timer_get_time() - start) / 1000), 1);
+    transport_hid_get_counts(&received, &dropped_after);
+
+    // HID reports are queued; the ones usb_hid could not take show up as drops
+    uint32_t dropped = s_params.kind == BENCH_HID ? dropped_after - dropped_before
+                                                  : result.failed;
+    uint32_t sent = result.attempted - MIN(dropped, result.attempted);
+
+    ESP_LOGI(TAG, "=== Bench Results ===");
+    if (result.aborted) {
+        ESP_LOGW(TAG, "Stopped early: a MouthPad connected");
+    }
+    ESP_LOGI(TAG, "Elapsed:    %lu ms", (unsigned long)elapsed_ms);
+    ESP_LOGI(TAG, "Sent:       %lu of %lu (%lu/s)", (unsigned long)sent,
+             (unsigned long)result.attempted, (unsigned long)((uint64_t)sent * 1000 / elapsed_ms));
+    ESP_LOGI(TAG, "Dropped:    %lu", (unsigned long)dropped);
+    ESP_LOGI(TAG, "Late slots: %lu", (unsigned long)result.late);
+    ESP_LOGI(TAG, "Max call:   %lu us", (unsigned long)result.max_call_us);
+
+    if (s_params.kind == BENCH_HID) {
+        hid_latency_stats_t stats;
+        if (hid_latency_get_stats(s_params.report_id, &stats) == ESP_OK) {
+            ESP_LOGI(TAG, "Latency:    p50 %lu p99 %lu max %lu us over %lu reports",
+                     (unsigned long)stats.p50_us, (unsigned long)stats.p99_us,
+                     (unsigned long)stats.max_us, (unsigned long)stats.count);
+        }
+    } else {
+        ESP_LOGI(TAG, "Throughput: %lu B/s",
+                 (unsigned long)((uint64_t)sent * s_params.size * 1000 / elapsed_ms));
+        ESP_LOGI(TAG, "TX FIFO:    peak %lu bytes", (unsigned long)result.peak_queued);
+    }
+
+    s_task = NULL;
+    atomic_store(&s_running, false);
+    vTaskDelete(NULL);
+}
+
+esp_err_t bench_start(const bench_params_t *params)
+{
+    if (params->rate_hz == 0 || params->rate_hz > BENCH_RATE_MAX || params->duration_ms == 0 ||
+        params->duration_ms > BENCH_DURATION_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (params->kind == BENCH_HID && mouthpad_hid_report_size(params->report_id) == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (params->kind == BENCH_PASS_THROUGH &&
+        (params->size == 0 || params->size > PASS_THROUGH_MAX)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool idle = false;
+    if (mouthpad_connected() || !atomic_compare_exchange_strong(&s_running, &idle, true)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_params = *params;
+    hid_latency_reset();
+
+    ESP_LOGI(TAG, "Bench started: %s at %lu Hz for %lu ms",
+             params->kind == BENCH_HID ? "HID" : "pass-through", (unsigned long)params->rate_hz,
+             (unsigned long)params->duration_ms);
+
+    if (xTaskCreatePinnedToCore(bench_task, "bench", TASK_BENCH_STACK_SIZE, NULL,
+                                TASK_BENCH_PRIORITY, NULL, TASK_BENCH_CORE_ID) != pdPASS) {
+        atomic_store(&s_running, false);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+#else // !CONFIG_MOUTHPAD_BENCH
+
+esp_err_t bench_start(const bench_params_t *params)
+{
+    (void)params;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_MOUTHPAD_BENCH
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Synthetic load for the USB side, for the "bench" command on CDC1
+// (CONFIG_MOUTHPAD_BENCH). With no MouthPad connected, a bench task sends
+// at a fixed rate for a fixed time and logs the result when done:
+//
+//   HID: reports go through transport_hid_inject_input(), the same path
+//   as reports from the MouthPad. The latency histograms (hid_latency.h)
+//   are cleared first, so with CONFIG_MOUTHPAD_HID_LATENCY_TRACE they
+//   cover the run.
+//
+//   Pass-through: PassThroughToApp frames go to CDC0 through
+//   usb_cdc_send_pass_through(), like NUS data from the MouthPad. Whatever
+//   reads CDC0 receives them.
+//
+// Slots the task could not keep up with are counted as late and skipped
+// rather than sent as a burst.
+
+typedef enum {
+    BENCH_HID,
+    BENCH_PASS_THROUGH,
+} bench_kind_t;
+
+typedef struct {
+    bench_kind_t kind;
+    uint8_t report_id;    // HID only
+    uint16_t size;        // Pass-through payload bytes
+    uint32_t rate_hz;
+    uint32_t duration_ms;
+} bench_params_t;
+
+// Start a run; returns at once. ESP_ERR_INVALID_STATE while a MouthPad is
+// connected or a run is in progress, ESP_ERR_INVALID_ARG for bad
+// parameters, ESP_ERR_NOT_SUPPORTED without the option.
+esp_err_t bench_start(const bench_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
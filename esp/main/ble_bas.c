@@ -2,6 +2,8 @@
 
 #include "esp_log.h"
 
+#include "link_state.h"
+
 #define TAG "BLE_BAS"
 
 static bool s_ready;
@@ -30,6 +32,7 @@ void ble_bas_reset(void)
 {
     s_ready = false;
     s_battery_level = 0xFF;
+    link_state_set_battery(LINK_STATE_BATTERY_UNKNOWN);
     ESP_LOGI(TAG, "Battery Service reset");
 }
 
@@ -39,11 +42,13 @@ void ble_bas_handle_level(uint8_t level)
         ESP_LOGW(TAG, "Invalid battery level received");
         s_ready = false;
         s_battery_level = 0xFF;
+        link_state_set_battery(LINK_STATE_BATTERY_UNKNOWN);
         return;
     }
 
     s_ready = true;
     s_battery_level = level;
+    link_state_set_battery(level);
     ESP_LOGI(TAG, "Battery level: %u%%", level);
 }
 
@@ -1,21 +1,38 @@
 #include "ble_bonds.h"
 #include "ble_dis.h"
+#include "bond_table.h"
+#include "hid_open_cache.h"
+#include "persist.h"
+#include "relay_protocol.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "esp_gap_ble_api.h"
 #include "esp_gattc_api.h"
+#include "freertos/FreeRTOS.h"
 #include <string.h>
 
 static const char *TAG = "BLE_BONDS";
 
-// NVS namespace and key for storing bonded device
+// NVS namespace and keys; the table is one blob (bond_table.h), the single
+// address of older firmware is moved into it on first boot
 #define NVS_NAMESPACE "ble_bonds"
+#define NVS_KEY_BOND_TABLE "bond_table"
 #define NVS_KEY_BONDED_DEVICE "bonded_dev"
 
-// Bonded device storage
-static bool s_has_bonded_device = false;
-static esp_bd_addr_t s_bonded_device_addr = {0};
+_Static_assert(sizeof(esp_bd_addr_t) == BOND_TABLE_ADDR_LEN, "Address length");
+_Static_assert(CONFIG_MOUTHPAD_MAX_BONDS <= BOND_TABLE_MAX, "Bond table capacity");
+
+// Bonded devices, most recent first. Scan results are checked against it on
+// the Bluetooth task while the HID and console tasks change it.
+static struct bond_table s_bonds;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// The table is written by the persist task (persist.h)
+static int s_persist_id = -1;
+static bool s_erase_legacy;
+
+static void bonds_persist_flush(void);
 
 esp_err_t ble_bonds_init(void)
 {
@@ -33,91 +50,164 @@ esp_err_t ble_bonds_init(void)
         return ret;
     }
 
-    // Try to load bonded device from NVS
+    bond_table_init(&s_bonds, CONFIG_MOUTHPAD_MAX_BONDS);
+
+    // Load the bond table from NVS
     nvs_handle_t nvs_handle;
     ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
     if (ret == ESP_OK) {
-        size_t required_size = sizeof(esp_bd_addr_t);
-        ret = nvs_get_blob(nvs_handle, NVS_KEY_BONDED_DEVICE, s_bonded_device_addr, &required_size);
-        if (ret == ESP_OK && required_size == sizeof(esp_bd_addr_t)) {
-            s_has_bonded_device = true;
-            ESP_LOGI(TAG, "Loaded bonded device: %02X:%02X:%02X:%02X:%02X:%02X",
-                     s_bonded_device_addr[0], s_bonded_device_addr[1], s_bonded_device_addr[2],
-                     s_bonded_device_addr[3], s_bonded_device_addr[4], s_bonded_device_addr[5]);
+        uint8_t blob[BOND_TABLE_BLOB_MAX];
+        size_t required_size = sizeof(blob);
+        ret = nvs_get_blob(nvs_handle, NVS_KEY_BOND_TABLE, blob, &required_size);
+        if (ret == ESP_OK) {
+            if (!bond_table_load(&s_bonds, blob, required_size)) {
+                ESP_LOGW(TAG, "Stored bond table is malformed, ignoring it");
+            }
         } else if (ret == ESP_ERR_NVS_NOT_FOUND) {
-            ESP_LOGI(TAG, "No bonded device found in storage");
+            // Older firmware kept one address; it becomes the first entry
+            esp_bd_addr_t bda;
+            required_size = sizeof(bda);
+            ret = nvs_get_blob(nvs_handle, NVS_KEY_BONDED_DEVICE, bda, &required_size);
+            if (ret == ESP_OK && required_size == sizeof(bda)) {
+                bond_table_use(&s_bonds, bda, NULL);
+                s_erase_legacy = true;
+                ESP_LOGI(TAG, "Migrating single bond to the bond table");
+            } else if (ret != ESP_ERR_NVS_NOT_FOUND) {
+                ESP_LOGW(TAG, "Failed to load bonded device: %s", esp_err_to_name(ret));
+            }
         } else {
-            ESP_LOGW(TAG, "Failed to load bonded device: %s", esp_err_to_name(ret));
+            ESP_LOGW(TAG, "Failed to load bond table: %s", esp_err_to_name(ret));
         }
         nvs_close(nvs_handle);
     } else if (ret != ESP_ERR_NVS_NOT_FOUND) {
         ESP_LOGW(TAG, "Failed to open NVS for reading: %s", esp_err_to_name(ret));
     }
 
-    ESP_LOGI(TAG, "BLE bonding system initialized (has_bond=%d)", s_has_bonded_device);
+    for (size_t i = 0; i < bond_table_count(&s_bonds); i++) {
+        const uint8_t *bda = bond_table_get(&s_bonds, i);
+        ESP_LOGI(TAG, "Loaded bonded device %u: " ESP_BD_ADDR_STR, (unsigned)i, ESP_BD_ADDR_HEX(bda));
+    }
+
+    s_persist_id = persist_register(bonds_persist_flush);
+    if (s_erase_legacy) {
+        persist_request(s_persist_id);
+    }
+
+    ESP_LOGI(TAG, "BLE bonding system initialized (%u of %d bonds)",
+             (unsigned)bond_table_count(&s_bonds), CONFIG_MOUTHPAD_MAX_BONDS);
     return ESP_OK;
 }
 
 bool ble_bonds_has_bonded_device(void)
 {
-    return s_has_bonded_device;
+    return ble_bonds_count() > 0;
 }
 
-esp_err_t ble_bonds_get_bonded_device(esp_bd_addr_t bda)
+size_t ble_bonds_count(void)
 {
-    if (!s_has_bonded_device) {
-        return ESP_ERR_NOT_FOUND;
+    taskENTER_CRITICAL(&s_lock);
+    size_t count = bond_table_count(&s_bonds);
+    taskEXIT_CRITICAL(&s_lock);
+    return count;
+}
+
+esp_err_t ble_bonds_get_device(size_t index, esp_bd_addr_t bda)
+{
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+
+    taskENTER_CRITICAL(&s_lock);
+    const uint8_t *addr = bond_table_get(&s_bonds, index);
+    if (addr) {
+        memcpy(bda, addr, sizeof(esp_bd_addr_t));
+        ret = ESP_OK;
     }
+    taskEXIT_CRITICAL(&s_lock);
+    return ret;
+}
 
-    memcpy(bda, s_bonded_device_addr, sizeof(esp_bd_addr_t));
-    return ESP_OK;
+esp_err_t ble_bonds_get_bonded_device(esp_bd_addr_t bda)
+{
+    return ble_bonds_get_device(0, bda);
 }
 
 bool ble_bonds_is_bonded_device(const esp_bd_addr_t bda)
 {
-    if (!s_has_bonded_device) {
-        return false;
-    }
-
-    return memcmp(bda, s_bonded_device_addr, sizeof(esp_bd_addr_t)) == 0;
+    taskENTER_CRITICAL(&s_lock);
+    bool bonded = bond_table_contains(&s_bonds, bda);
+    taskEXIT_CRITICAL(&s_lock);
+    return bonded;
 }
 
-esp_err_t ble_bonds_store_device(const esp_bd_addr_t bda)
+// Persist task: write the table as it stands, one blob
+static void bonds_persist_flush(void)
 {
-    ESP_LOGI(TAG, "Storing bonded device: %02X:%02X:%02X:%02X:%02X:%02X",
-             bda[0], bda[1], bda[2], bda[3], bda[4], bda[5]);
+    uint8_t blob[BOND_TABLE_BLOB_MAX];
+
+    taskENTER_CRITICAL(&s_lock);
+    size_t len = bond_table_save(&s_bonds, blob, sizeof(blob));
+    taskEXIT_CRITICAL(&s_lock);
 
     // Open NVS for writing
     nvs_handle_t nvs_handle;
     esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to open NVS for writing: %s", esp_err_to_name(ret));
-        return ret;
+        return;
     }
 
-    // Store the device address
-    ret = nvs_set_blob(nvs_handle, NVS_KEY_BONDED_DEVICE, bda, sizeof(esp_bd_addr_t));
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to store bonded device: %s", esp_err_to_name(ret));
-        nvs_close(nvs_handle);
-        return ret;
+    // Store the table, and drop the single address it replaced
+    ret = nvs_set_blob(nvs_handle, NVS_KEY_BOND_TABLE, blob, len);
+    if (ret == ESP_OK && s_erase_legacy) {
+        esp_err_t erase = nvs_erase_key(nvs_handle, NVS_KEY_BONDED_DEVICE);
+        if (erase == ESP_OK || erase == ESP_ERR_NVS_NOT_FOUND) {
+            s_erase_legacy = false;
+        }
+    }
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs_handle);
     }
+    nvs_close(nvs_handle);
 
-    // Commit the changes
-    ret = nvs_commit(nvs_handle);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to commit bonded device: %s", esp_err_to_name(ret));
-        nvs_close(nvs_handle);
-        return ret;
+        ESP_LOGE(TAG, "Failed to store bond table: %s", esp_err_to_name(ret));
+        return;
     }
 
-    nvs_close(nvs_handle);
+    ESP_LOGI(TAG, "Successfully stored bond table (%u bonds)", (unsigned)(blob[1]));
+}
 
-    // Update runtime state
-    memcpy(s_bonded_device_addr, bda, sizeof(esp_bd_addr_t));
-    s_has_bonded_device = true;
+esp_err_t ble_bonds_store_device(const esp_bd_addr_t bda)
+{
+    esp_bd_addr_t evicted;
+
+    // Update runtime state now, NVS in the next quiet spell
+    taskENTER_CRITICAL(&s_lock);
+    enum bond_table_result result = bond_table_use(&s_bonds, bda, evicted);
+    taskEXIT_CRITICAL(&s_lock);
 
-    ESP_LOGI(TAG, "Successfully stored bonded device");
+    if (result == BOND_TABLE_UNCHANGED) {
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "Storing bonded device: %02X:%02X:%02X:%02X:%02X:%02X",
+             bda[0], bda[1], bda[2], bda[3], bda[4], bda[5]);
+
+    if (result == BOND_TABLE_EVICTED) {
+        // Not the connected device; its keys go with its table entry
+        ESP_LOGI(TAG, "Bond table full, dropping least recent " ESP_BD_ADDR_STR,
+                 ESP_BD_ADDR_HEX(evicted));
+        esp_ble_remove_bond_device(evicted);
+        ble_device_info_forget(evicted);
+        hid_open_cache_forget(evicted);
+    }
+
+    relay_protocol_device_info_changed();
+
+    if (s_persist_id < 0) {
+        bonds_persist_flush();
+    } else {
+        persist_request(s_persist_id);
+    }
     return ESP_OK;
 }
 
@@ -128,8 +218,10 @@ esp_err_t ble_bonds_clear_all(void)
     // ESP-IDF's built-in GATT cache will be cleared automatically with bonds
 
     // Clear runtime state
-    s_has_bonded_device = false;
-    memset(s_bonded_device_addr, 0, sizeof(esp_bd_addr_t));
+    taskENTER_CRITICAL(&s_lock);
+    bond_table_clear(&s_bonds);
+    taskEXIT_CRITICAL(&s_lock);
+    relay_protocol_device_info_changed();
 
     // Open NVS for writing
     nvs_handle_t nvs_handle;
@@ -139,11 +231,16 @@ esp_err_t ble_bonds_clear_all(void)
         return ret;
     }
 
-    // Remove the bonded device entry
+    // Remove the bond table, and any single address left from older firmware
+    ret = nvs_erase_key(nvs_handle, NVS_KEY_BOND_TABLE);
+    if (ret != ESP_OK && ret != ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "Failed to erase bond table key: %s", esp_err_to_name(ret));
+    }
     ret = nvs_erase_key(nvs_handle, NVS_KEY_BONDED_DEVICE);
     if (ret != ESP_OK && ret != ESP_ERR_NVS_NOT_FOUND) {
         ESP_LOGW(TAG, "Failed to erase bonded device key: %s", esp_err_to_name(ret));
     }
+    s_erase_legacy = false;
 
     // Commit the changes
     ret = nvs_commit(nvs_handle);
@@ -159,8 +256,9 @@ esp_err_t ble_bonds_clear_all(void)
     // runtime state clearing and NVS erasure above.
     ESP_LOGI(TAG, "BLE stack bonds will be cleared on next restart");
 
-    // Clear saved device info as well
+    // Clear saved device info and HID open caches as well
     ble_device_info_clear_saved();
+    hid_open_cache_clear();
 
     ESP_LOGI(TAG, "All bonds cleared successfully");
     return ESP_OK;
@@ -172,10 +270,15 @@ esp_err_t ble_bonds_get_info_string(char *buffer, size_t buffer_size)
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (s_has_bonded_device) {
-        snprintf(buffer, buffer_size, "%02X:%02X:%02X:%02X:%02X:%02X",
-                 s_bonded_device_addr[0], s_bonded_device_addr[1], s_bonded_device_addr[2],
-                 s_bonded_device_addr[3], s_bonded_device_addr[4], s_bonded_device_addr[5]);
+    esp_bd_addr_t bda;
+    size_t count = ble_bonds_count();
+
+    if (ble_bonds_get_bonded_device(bda) == ESP_OK) {
+        int len = snprintf(buffer, buffer_size, "%02X:%02X:%02X:%02X:%02X:%02X",
+                           bda[0], bda[1], bda[2], bda[3], bda[4], bda[5]);
+        if (count > 1 && len > 0 && (size_t)len < buffer_size) {
+            snprintf(buffer + len, buffer_size - len, " +%u", (unsigned)(count - 1));
+        }
     } else {
         snprintf(buffer, buffer_size, "No bonded device");
     }
@@ -3,6 +3,7 @@
 #include "esp_err.h"
 #include "esp_bt_defs.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -11,8 +12,8 @@ extern "C" {
 /**
  * @brief Initialize the BLE bonding system
  *
- * This module manages pairing with a single MouthPad device and stores
- * the bond information persistently.
+ * This module keeps up to CONFIG_MOUTHPAD_MAX_BONDS bonded MouthPads, most
+ * recently used first, and stores them persistently as one NVS blob.
  *
  * @return esp_err_t ESP_OK on success
  */
@@ -26,7 +27,21 @@ esp_err_t ble_bonds_init(void);
 bool ble_bonds_has_bonded_device(void);
 
 /**
- * @brief Get the bonded device address
+ * @brief Number of bonded devices
+ */
+size_t ble_bonds_count(void);
+
+/**
+ * @brief Get a bonded device address by use order
+ *
+ * @param index 0 for the most recently used
+ * @param[out] bda Buffer to store the device address
+ * @return esp_err_t ESP_OK if it exists, ESP_ERR_NOT_FOUND past the last bond
+ */
+esp_err_t ble_bonds_get_device(size_t index, esp_bd_addr_t bda);
+
+/**
+ * @brief Get the most recently used bonded device address
  *
  * @param[out] bda Buffer to store the bonded device address
  * @return esp_err_t ESP_OK if bonded device exists, ESP_ERR_NOT_FOUND if no bond
@@ -34,15 +49,21 @@ bool ble_bonds_has_bonded_device(void);
 esp_err_t ble_bonds_get_bonded_device(esp_bd_addr_t bda);
 
 /**
- * @brief Check if a device address matches our bonded device
+ * @brief Check if a device address is one of our bonded devices
+ *
+ * A hashed lookup; cheap enough for every scan result, from any task.
  *
  * @param bda Device address to check
- * @return true if this device matches our bonded device
+ * @return true if this device is bonded
  */
 bool ble_bonds_is_bonded_device(const esp_bd_addr_t bda);
 
 /**
- * @brief Store a new bonded device (replaces any existing bond)
+ * @brief Store a bonded device as the most recently used
+ *
+ * A new device added to a full table drops the least recently used one,
+ * and its keys. Takes effect at once; the NVS write follows from the
+ * persist task and is skipped when the address is already the most recent.
  *
  * @param bda Device address to bond with
  * @return esp_err_t ESP_OK on success
@@ -52,7 +73,7 @@ esp_err_t ble_bonds_store_device(const esp_bd_addr_t bda);
 /**
  * @brief Clear all stored bonds
  *
- * This removes the bonded device from storage and clears all BLE bonds.
+ * This removes every bonded device from storage and clears all BLE bonds.
  *
  * @return esp_err_t ESP_OK on success
  */
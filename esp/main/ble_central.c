@@ -120,10 +120,7 @@ static const char *TAG = "BLE_CENTRAL";
 static const char * gap_bt_prop_type_names[5] = {"","BDNAME","COD","RSSI","EIR"};
 #endif
 
-static ble_central_scan_result_t *bt_scan_results = NULL;
 static size_t num_bt_scan_results = 0;
-
-static ble_central_scan_result_t *ble_scan_results = NULL;
 static size_t num_ble_scan_results = 0;
 
 static SemaphoreHandle_t bt_hidh_cb_semaphore = NULL;
@@ -136,6 +133,10 @@ static SemaphoreHandle_t ble_hidh_cb_semaphore = NULL;
 
 static esp_gap_ble_cb_t s_user_ble_cb;
 
+static ble_central_scan_match_cb_t s_scan_match_cb;
+// Set once s_scan_match_cb has stopped the current scan
+static volatile bool s_scan_stopped_early;
+
 #define SIZEOF_ARRAY(a) (sizeof(a)/sizeof(*a))
 
 #if !CONFIG_BT_NIMBLE_ENABLED
@@ -208,61 +209,194 @@ const char *esp_ble_key_type_str(esp_ble_key_type_t key_type)
 }
 #endif /* CONFIG_BT_BLE_ENABLED */
 
-void ble_central_scan_results_free(ble_central_scan_result_t *results)
+/*
+ * Scan results live in a fixed pool, found by BDA through an open-addressed
+ * (linear probing) index, so a busy room costs no heap traffic per device and
+ * no list walk per advertisement. When the pool is full the least recently
+ * seen device makes room. The pool is handed to the caller as a linked list
+ * and stays theirs until ble_central_scan_results_free().
+ */
+#define SCAN_TABLE_SIZE CONFIG_MOUTHPAD_SCAN_TABLE_SIZE
+#define SCAN_INDEX_SIZE (SCAN_TABLE_SIZE * 2)
+#define SCAN_INDEX_EMPTY 0xFF
+#define SCAN_NAME_MAX 31
+
+_Static_assert(SCAN_TABLE_SIZE < SCAN_INDEX_EMPTY, "scan table slots must fit a uint8_t index");
+
+typedef struct {
+    ble_central_scan_result_t result;
+    char name[SCAN_NAME_MAX + 1];
+    uint32_t last_seen;
+    bool in_use;
+} scan_slot_t;
+
+static scan_slot_t s_scan_slots[SCAN_TABLE_SIZE];
+static uint8_t s_scan_index[SCAN_INDEX_SIZE];
+static uint32_t s_scan_clock;
+// Set while the caller holds the results; late events must not touch them
+static bool s_scan_results_taken;
+
+static void scan_table_reset(void)
+{
+    memset(s_scan_slots, 0, sizeof(s_scan_slots));
+    memset(s_scan_index, SCAN_INDEX_EMPTY, sizeof(s_scan_index));
+    s_scan_clock = 0;
+    num_bt_scan_results = 0;
+    num_ble_scan_results = 0;
+}
+
+static size_t scan_index_home(const uint8_t *bda, esp_hid_transport_t transport)
+{
+    // FNV-1a over the address and transport
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 6; i++) {
+        hash = (hash ^ bda[i]) * 16777619u;
+    }
+    hash = (hash ^ (uint8_t)transport) * 16777619u;
+    return hash % SCAN_INDEX_SIZE;
+}
+
+static size_t scan_index_find(const uint8_t *bda, esp_hid_transport_t transport)
 {
-    ble_central_scan_result_t *r = NULL;
-    while (results) {
-        r = results;
-        results = results->next;
-        if (r->name != NULL) {
-            free((char *)r->name);
+    size_t pos = scan_index_home(bda, transport);
+    while (s_scan_index[pos] != SCAN_INDEX_EMPTY) {
+        ble_central_scan_result_t *r = &s_scan_slots[s_scan_index[pos]].result;
+        if (r->transport == transport && memcmp(bda, r->bda, sizeof(r->bda)) == 0) {
+            return pos;
         }
-        free(r);
+        pos = (pos + 1) % SCAN_INDEX_SIZE;
     }
+    return pos;
 }
 
-#if (CONFIG_BT_HID_HOST_ENABLED || CONFIG_BT_BLE_ENABLED)
-static ble_central_scan_result_t *find_scan_result(esp_bd_addr_t bda, ble_central_scan_result_t *results)
+static ble_central_scan_result_t *find_scan_result(const uint8_t *bda, esp_hid_transport_t transport)
 {
-    ble_central_scan_result_t *r = results;
-    while (r) {
-        if (memcmp(bda, r->bda, sizeof(esp_bd_addr_t)) == 0) {
-            return r;
+    size_t pos = scan_index_find(bda, transport);
+    if (s_scan_index[pos] == SCAN_INDEX_EMPTY) {
+        return NULL;
+    }
+    scan_slot_t *slot = &s_scan_slots[s_scan_index[pos]];
+    slot->last_seen = ++s_scan_clock;
+    return &slot->result;
+}
+
+// Backward-shift deletion keeps every probe chain unbroken without tombstones
+static void scan_index_remove(size_t pos)
+{
+    size_t next = (pos + 1) % SCAN_INDEX_SIZE;
+    s_scan_index[pos] = SCAN_INDEX_EMPTY;
+    while (s_scan_index[next] != SCAN_INDEX_EMPTY) {
+        ble_central_scan_result_t *r = &s_scan_slots[s_scan_index[next]].result;
+        size_t home = scan_index_home(r->bda, r->transport);
+        // Move the entry back if the hole lies between its home and where it sits
+        if ((next > pos && (home <= pos || home > next)) ||
+            (next < pos && (home <= pos && home > next))) {
+            s_scan_index[pos] = s_scan_index[next];
+            s_scan_index[next] = SCAN_INDEX_EMPTY;
+            pos = next;
         }
-        r = r->next;
+        next = (next + 1) % SCAN_INDEX_SIZE;
     }
-    return NULL;
 }
-#endif /* (CONFIG_BT_HID_HOST_ENABLED || CONFIG_BT_BLE_ENABLED) */
 
-#if (CONFIG_BT_NIMBLE_ENABLED)
-static ble_central_scan_result_t *find_scan_result(const uint8_t *bda, ble_central_scan_result_t *results)
+// A free slot, or the least recently seen device's once the pool is full
+static scan_slot_t *scan_slot_alloc(void)
 {
-    ble_central_scan_result_t *r = results;
-    while (r) {
-        if (memcmp(bda, r->bda, sizeof(r->bda)) == 0) {
-            return r;
+    scan_slot_t *lru = &s_scan_slots[0];
+    for (int i = 0; i < SCAN_TABLE_SIZE; i++) {
+        if (!s_scan_slots[i].in_use) {
+            return &s_scan_slots[i];
         }
-        r = r->next;
+        if (s_scan_slots[i].last_seen < lru->last_seen) {
+            lru = &s_scan_slots[i];
+        }
+    }
+
+    ble_central_scan_result_t *r = &lru->result;
+    ESP_LOGD(TAG, "Scan table full, evicting " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(r->bda));
+    scan_index_remove(scan_index_find(r->bda, r->transport));
+    if (r->transport == ESP_HID_TRANSPORT_BT) {
+        num_bt_scan_results--;
+    } else {
+        num_ble_scan_results--;
+    }
+    lru->in_use = false;
+    return lru;
+}
+
+static ble_central_scan_result_t *scan_result_insert(const uint8_t *bda, esp_hid_transport_t transport)
+{
+    scan_slot_t *slot = scan_slot_alloc();
+    memset(slot, 0, sizeof(*slot));
+    slot->in_use = true;
+    slot->last_seen = ++s_scan_clock;
+    slot->result.transport = transport;
+    memcpy(slot->result.bda, bda, sizeof(slot->result.bda));
+
+    s_scan_index[scan_index_find(bda, transport)] = (uint8_t)(slot - s_scan_slots);
+    if (transport == ESP_HID_TRANSPORT_BT) {
+        num_bt_scan_results++;
+    } else {
+        num_ble_scan_results++;
     }
-    return NULL;
+    return &slot->result;
 }
+
+static void scan_result_set_name(ble_central_scan_result_t *r, const uint8_t *name, uint8_t name_len)
+{
+    if (name == NULL || name_len == 0) {
+        return;
+    }
+    scan_slot_t *slot = (scan_slot_t *)r;
+    size_t len = name_len < SCAN_NAME_MAX ? name_len : SCAN_NAME_MAX;
+    memcpy(slot->name, name, len);
+    slot->name[len] = 0;
+    r->name = slot->name;
+}
+
+// Link the pool into the list ble_central_scan() returns, BT results first
+static ble_central_scan_result_t *scan_table_take(void)
+{
+    ble_central_scan_result_t *head = NULL;
+    ble_central_scan_result_t **tail = &head;
+#if CONFIG_BT_HID_HOST_ENABLED
+    const esp_hid_transport_t order[] = { ESP_HID_TRANSPORT_BT, ESP_HID_TRANSPORT_BLE };
+#else
+    const esp_hid_transport_t order[] = { ESP_HID_TRANSPORT_BLE };
 #endif
+
+    for (size_t t = 0; t < SIZEOF_ARRAY(order); t++) {
+        for (int i = 0; i < SCAN_TABLE_SIZE; i++) {
+            if (s_scan_slots[i].in_use && s_scan_slots[i].result.transport == order[t]) {
+                *tail = &s_scan_slots[i].result;
+                tail = &s_scan_slots[i].result.next;
+            }
+        }
+    }
+    *tail = NULL;
+    s_scan_results_taken = true;
+    return head;
+}
+
+void ble_central_scan_results_free(ble_central_scan_result_t *results)
+{
+    // Results point into the pool; there is nothing to free one by one
+    (void)results;
+    scan_table_reset();
+    s_scan_results_taken = false;
+}
+
 #if CONFIG_BT_HID_HOST_ENABLED
 static void add_bt_scan_result(esp_bd_addr_t bda, esp_bt_cod_t *cod, esp_bt_uuid_t *uuid, uint8_t *name, uint8_t name_len, int rssi)
 {
-    ble_central_scan_result_t *r = find_scan_result(bda, bt_scan_results);
+    if (s_scan_results_taken) {
+        return;
+    }
+    ble_central_scan_result_t *r = find_scan_result(bda, ESP_HID_TRANSPORT_BT);
     if (r) {
         //Some info may come later
-        if (r->name == NULL && name && name_len) {
-            char *name_s = (char *)malloc(name_len + 1);
-            if (name_s == NULL) {
-                ESP_LOGE(TAG, "Malloc result name failed!");
-                return;
-            }
-            memcpy(name_s, name, name_len);
-            name_s[name_len] = 0;
-            r->name = (const char *)name_s;
+        if (r->name == NULL) {
+            scan_result_set_name(r, name, name_len);
         }
         if (r->bt.uuid.len == 0 && uuid->len) {
             memcpy(&r->bt.uuid, uuid, sizeof(esp_bt_uuid_t));
@@ -273,106 +407,53 @@ static void add_bt_scan_result(esp_bd_addr_t bda, esp_bt_cod_t *cod, esp_bt_uuid
         return;
     }
 
-    r = (ble_central_scan_result_t *)malloc(sizeof(ble_central_scan_result_t));
-    if (r == NULL) {
-        ESP_LOGE(TAG, "Malloc bt_hidh_scan_result_t failed!");
-        return;
-    }
-    r->transport = ESP_HID_TRANSPORT_BT;
-    memcpy(r->bda, bda, sizeof(esp_bd_addr_t));
+    r = scan_result_insert(bda, ESP_HID_TRANSPORT_BT);
     memcpy(&r->bt.cod, cod, sizeof(esp_bt_cod_t));
     memcpy(&r->bt.uuid, uuid, sizeof(esp_bt_uuid_t));
     r->usage = esp_hid_usage_from_cod((uint32_t)cod);
     r->rssi = rssi;
-    r->name = NULL;
-    if (name_len && name) {
-        char *name_s = (char *)malloc(name_len + 1);
-        if (name_s == NULL) {
-            free(r);
-            ESP_LOGE(TAG, "Malloc result name failed!");
-            return;
-        }
-        memcpy(name_s, name, name_len);
-        name_s[name_len] = 0;
-        r->name = (const char *)name_s;
-    }
-    r->next = bt_scan_results;
-    bt_scan_results = r;
-    num_bt_scan_results++;
+    scan_result_set_name(r, name, name_len);
 }
 #endif
 
 #if CONFIG_BT_BLE_ENABLED
-static void add_ble_scan_result(esp_bd_addr_t bda, esp_ble_addr_type_t addr_type, uint16_t appearance, uint8_t *name, uint8_t name_len, int rssi, uint8_t *mfg_data, uint8_t mfg_data_len, bool has_nus_uuid)
+static void add_ble_scan_result(esp_bd_addr_t bda, esp_ble_addr_type_t addr_type, uint16_t appearance, uint8_t *name, uint8_t name_len, int rssi, uint8_t *mfg_data, uint8_t mfg_data_len, bool has_nus_uuid, bool has_mouthpad_mfr)
 {
-    if (find_scan_result(bda, ble_scan_results)) {
-        ESP_LOGW(TAG, "Result already exists!");
+    if (s_scan_results_taken) {
         return;
     }
-    ble_central_scan_result_t *r = (ble_central_scan_result_t *)malloc(sizeof(ble_central_scan_result_t));
-    if (r == NULL) {
-        ESP_LOGE(TAG, "Malloc ble_hidh_scan_result_t failed!");
+    if (find_scan_result(bda, ESP_HID_TRANSPORT_BLE)) {
+        ESP_LOGD(TAG, "Result already exists!");
         return;
     }
-    r->transport = ESP_HID_TRANSPORT_BLE;
-    memcpy(r->bda, bda, sizeof(esp_bd_addr_t));
+    ble_central_scan_result_t *r = scan_result_insert(bda, ESP_HID_TRANSPORT_BLE);
     r->ble.appearance = appearance;
     r->ble.addr_type = addr_type;
     r->ble.has_nus_uuid = has_nus_uuid;
+    r->ble.has_mouthpad_mfr = has_mouthpad_mfr;
     r->usage = esp_hid_usage_from_appearance(appearance);
     r->rssi = rssi;
-    r->name = NULL;
-    if (name_len && name) {
-        char *name_s = (char *)malloc(name_len + 1);
-        if (name_s == NULL) {
-            free(r);
-            ESP_LOGE(TAG, "Malloc result name failed!");
-            return;
-        }
-        memcpy(name_s, name, name_len);
-        name_s[name_len] = 0;
-        r->name = (const char *)name_s;
-    }
-    r->next = ble_scan_results;
-    ble_scan_results = r;
-    num_ble_scan_results++;
+    scan_result_set_name(r, name, name_len);
 }
 #endif /* CONFIG_BT_BLE_ENABLED */
 
 #if CONFIG_BT_NIMBLE_ENABLED
 static void add_ble_scan_result(const uint8_t *bda, uint8_t addr_type, uint16_t appearance, uint8_t *name, uint8_t name_len, int rssi, bool has_nus_uuid)
 {
-    if (find_scan_result(bda, ble_scan_results)) {
-        ESP_LOGW(TAG, "Result already exists!");
+    if (s_scan_results_taken) {
         return;
     }
-    ble_central_scan_result_t *r = (ble_central_scan_result_t *)malloc(sizeof(ble_central_scan_result_t));
-    if (r == NULL) {
-        ESP_LOGE(TAG, "Malloc ble_hidh_scan_result_t failed!");
+    if (find_scan_result(bda, ESP_HID_TRANSPORT_BLE)) {
+        ESP_LOGD(TAG, "Result already exists!");
         return;
     }
-    r->transport = ESP_HID_TRANSPORT_BLE;
-    memcpy(r->bda, bda, sizeof(r->bda));
+    ble_central_scan_result_t *r = scan_result_insert(bda, ESP_HID_TRANSPORT_BLE);
     r->ble.appearance = appearance;
     r->ble.addr_type = addr_type;
     r->ble.has_nus_uuid = has_nus_uuid;
     r->usage = esp_hid_usage_from_appearance(appearance);
     r->rssi = rssi;
-    r->name = NULL;
-    if (name_len && name) {
-        char *name_s = (char *)malloc(name_len + 1);
-        if (name_s == NULL) {
-            free(r);
-            ESP_LOGE(TAG, "Malloc result name failed!");
-            return;
-        }
-        memcpy(name_s, name, name_len);
-        name_s[name_len] = 0;
-        r->name = (const char *)name_s;
-    }
-    r->next = ble_scan_results;
-    ble_scan_results = r;
-    num_ble_scan_results++;
+    scan_result_set_name(r, name, name_len);
 }
 #endif /* CONFIG_BT_BLE_ENABLED */
 
@@ -474,13 +555,26 @@ static void handle_bt_device_result(struct disc_res_param *disc_res)
     }
     GAP_DBG_PRINTF("\n");
 
-    if (cod->major == ESP_BT_COD_MAJOR_DEV_PERIPHERAL || (find_scan_result(disc_res->bda, bt_scan_results) != NULL)) {
+    if (cod->major == ESP_BT_COD_MAJOR_DEV_PERIPHERAL || (find_scan_result(disc_res->bda, ESP_HID_TRANSPORT_BT) != NULL)) {
         add_bt_scan_result(disc_res->bda, cod, &uuid, name, name_len, rssi);
     }
 }
 #endif
 
+// Set while the controller whitelist holds the bonded MouthPad
+static bool s_scan_filter_set;
+
 #if CONFIG_BT_BLE_ENABLED
+#define MOUTHPAD_COMPANY_ID       0x4147
+#define MOUTHPAD_MFR_DATA_PAYLOAD "MP1"
+
+static bool is_mouthpad_mfr_data(const uint8_t *data, uint8_t len)
+{
+    return data != NULL && len >= 2 + sizeof(MOUTHPAD_MFR_DATA_PAYLOAD) - 1 &&
+           (data[0] | (data[1] << 8)) == MOUTHPAD_COMPANY_ID &&
+           memcmp(data + 2, MOUTHPAD_MFR_DATA_PAYLOAD, sizeof(MOUTHPAD_MFR_DATA_PAYLOAD) - 1) == 0;
+}
+
 static void handle_ble_device_result(struct ble_scan_result_evt_param *scan_rst)
 {
 
@@ -534,9 +628,14 @@ static void handle_ble_device_result(struct ble_scan_result_evt_param *scan_rst)
     // Detect NUS UUID in advertisement data
     bool has_nus_uuid = detect_nus_uuid(scan_rst->ble_adv, scan_rst->adv_data_len, scan_rst->scan_rsp_len);
 
+    // The manufacturer data, or the whitelist passing only the bonded
+    // MouthPad, identify it from the primary advertisement alone, for
+    // passive scans that get no scan response with the UUIDs
+    bool has_mouthpad_mfr = is_mouthpad_mfr_data(mfg_data, mfg_data_len);
+
     // For HID devices, show detailed advertisement packet data
-    if (uuid == ESP_GATT_UUID_HID_SVC) {
-        ESP_LOGI(TAG, "=== HID DEVICE ADVERTISEMENT PACKET ===");
+    if (uuid == ESP_GATT_UUID_HID_SVC || has_mouthpad_mfr || s_scan_filter_set) {
+        ESP_LOGI(TAG, "=== HID/MOUTHPAD ADVERTISEMENT PACKET ===");
         ESP_LOGI(TAG, "BDA: " ESP_BD_ADDR_STR ", RSSI: %d, ADDR_TYPE: '%s'",
                  ESP_BD_ADDR_HEX(scan_rst->bda),
                  scan_rst->rssi,
@@ -548,7 +647,8 @@ static void handle_ble_device_result(struct ble_scan_result_evt_param *scan_rst)
             ESP_LOGI(TAG, "NAME: (no name advertised)");
         }
 
-        ESP_LOGI(TAG, "UUID: 0x%04x (HID Service)", uuid);
+        ESP_LOGI(TAG, "UUID: 0x%04x%s", uuid, uuid == ESP_GATT_UUID_HID_SVC ? " (HID Service)" : "");
+        ESP_LOGI(TAG, "MOUTHPAD_MFR: %s", has_mouthpad_mfr ? "YES" : "NO");
         ESP_LOGI(TAG, "APPEARANCE: 0x%04x", appearance);
         ESP_LOGI(TAG, "NUS_UUID: %s", has_nus_uuid ? "YES" : "NO");
 
@@ -574,7 +674,17 @@ static void handle_ble_device_result(struct ble_scan_result_evt_param *scan_rst)
 
         ESP_LOGI(TAG, "==========================================");
 
-        add_ble_scan_result(scan_rst->bda, scan_rst->ble_addr_type, appearance, adv_name, adv_name_len, scan_rst->rssi, mfg_data, mfg_data_len, has_nus_uuid);
+        add_ble_scan_result(scan_rst->bda, scan_rst->ble_addr_type, appearance, adv_name, adv_name_len, scan_rst->rssi, mfg_data, mfg_data_len, has_nus_uuid, has_mouthpad_mfr);
+
+        // Let the caller end the scan on the first device it wants
+        ble_central_scan_result_t *r = find_scan_result(scan_rst->bda, ESP_HID_TRANSPORT_BLE);
+        if (r && s_scan_match_cb && !s_scan_stopped_early && s_scan_match_cb(r)) {
+            if (esp_ble_gap_stop_scanning() == ESP_OK) {
+                s_scan_stopped_early = true;
+            } else {
+                ESP_LOGW(TAG, "esp_ble_gap_stop_scanning failed, waiting out the scan");
+            }
+        }
     } else if (adv_name_len) {
         // For non-HID devices, keep the original debug output
         GAP_DBG_PRINTF("BLE: " ESP_BD_ADDR_STR ", RSSI: %d, UUID: 0x%04x, APPEARANCE: 0x%04x, ADDR_TYPE: '%s', NAME: '%s'\n",
@@ -720,9 +830,19 @@ static void ble_gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_p
     }
     case ESP_GAP_BLE_SCAN_STOP_COMPLETE_EVT: {
         ESP_LOGV(TAG, "BLE GAP EVENT SCAN CANCELED");
+        // No INQ_CMPL follows a stopped scan; release ble_central_scan() here instead
+        if (s_scan_stopped_early) {
+            SEND_BLE_CB();
+        }
         break;
     }
 
+    case ESP_GAP_BLE_UPDATE_WHITELIST_COMPLETE_EVT:
+        if (param->update_whitelist_cmpl.status != ESP_BT_STATUS_SUCCESS) {
+            ESP_LOGE(TAG, "BLE GAP whitelist update failed: 0x%x", param->update_whitelist_cmpl.status);
+        }
+        break;
+
     /*
      * ADVERTISEMENT
      * */
@@ -803,6 +923,11 @@ void ble_central_set_user_ble_callback(esp_gap_ble_cb_t cb)
     s_user_ble_cb = cb;
 }
 
+void ble_central_set_scan_match_callback(ble_central_scan_match_cb_t cb)
+{
+    s_scan_match_cb = cb;
+}
+
 static esp_ble_scan_params_t hid_scan_params = {
     .scan_type              = BLE_SCAN_TYPE_ACTIVE,
     .own_addr_type          = BLE_ADDR_TYPE_PUBLIC,
@@ -828,6 +953,56 @@ static esp_err_t start_ble_scan(uint32_t seconds)
     return ret;
 }
 
+void ble_central_set_scan_timing(uint16_t interval, uint16_t window)
+{
+    hid_scan_params.scan_interval = interval;
+    hid_scan_params.scan_window = window;
+}
+
+void ble_central_set_scan_active(bool active)
+{
+    hid_scan_params.scan_type = active ? BLE_SCAN_TYPE_ACTIVE : BLE_SCAN_TYPE_PASSIVE;
+}
+
+// Address the controller whitelist is scanning for, if any
+static esp_bd_addr_t s_scan_filter_bda;
+
+esp_err_t ble_central_set_scan_filter(const uint8_t *bda)
+{
+    if (bda == NULL ? !s_scan_filter_set :
+        (s_scan_filter_set && memcmp(bda, s_scan_filter_bda, sizeof(esp_bd_addr_t)) == 0)) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = esp_ble_gap_clear_whitelist();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ble_gap_clear_whitelist failed: %d", ret);
+        return ret;
+    }
+    s_scan_filter_set = false;
+    hid_scan_params.scan_filter_policy = BLE_SCAN_FILTER_ALLOW_ALL;
+
+    if (bda == NULL) {
+        return ESP_OK;
+    }
+
+    // The bond does not record the address type, so list the address as both
+    esp_bd_addr_t addr;
+    memcpy(addr, bda, sizeof(addr));
+    if ((ret = esp_ble_gap_update_whitelist(true, addr, BLE_WL_ADDR_TYPE_PUBLIC)) != ESP_OK ||
+        (ret = esp_ble_gap_update_whitelist(true, addr, BLE_WL_ADDR_TYPE_RANDOM)) != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ble_gap_update_whitelist failed: %d", ret);
+        esp_ble_gap_clear_whitelist();
+        return ret;
+    }
+
+    memcpy(s_scan_filter_bda, bda, sizeof(s_scan_filter_bda));
+    s_scan_filter_set = true;
+    hid_scan_params.scan_filter_policy = BLE_SCAN_FILTER_ALLOW_ONLY_WLST;
+    ESP_LOGI(TAG, "Scanning only for " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(bda));
+    return ESP_OK;
+}
+
 esp_err_t ble_central_adv_init(uint16_t appearance, const char *device_name)
 {
 
@@ -1184,6 +1359,7 @@ static esp_err_t init_low_level(uint8_t mode)
     } else
 #endif
     {
+        // BLE only: give the BR/EDR controller memory back to the heap
         ret = esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
         if (ret) {
             ESP_LOGE(TAG, "esp_bt_controller_mem_release failed: %d", ret);
@@ -1278,10 +1454,13 @@ esp_err_t ble_central_init(uint8_t mode)
 
 esp_err_t ble_central_scan(uint32_t seconds, size_t *num_results, ble_central_scan_result_t **results)
 {
-    if (num_bt_scan_results || bt_scan_results || num_ble_scan_results || ble_scan_results) {
+    if (s_scan_results_taken) {
         ESP_LOGE(TAG, "There are old scan results. Free them first!");
         return ESP_FAIL;
     }
+    scan_table_reset();
+
+    s_scan_stopped_early = false;
 
 #if CONFIG_BT_BLE_ENABLED
     if (start_ble_scan(seconds) == ESP_OK) {
@@ -1300,27 +1479,17 @@ esp_err_t ble_central_scan(uint32_t seconds, size_t *num_results, ble_central_sc
 
 
 #if CONFIG_BT_HID_HOST_ENABLED
-    if (start_bt_scan(seconds) == ESP_OK) {
-        WAIT_BT_CB();
-    } else {
-        return ESP_FAIL;
+    // The device the callback picked is already here; skip the inquiry
+    if (!s_scan_stopped_early) {
+        if (start_bt_scan(seconds) == ESP_OK) {
+            WAIT_BT_CB();
+        } else {
+            return ESP_FAIL;
+        }
     }
 #endif
 
     *num_results = num_bt_scan_results + num_ble_scan_results;
-    *results = bt_scan_results;
-    if (num_bt_scan_results) {
-        while (bt_scan_results->next != NULL) {
-            bt_scan_results = bt_scan_results->next;
-        }
-        bt_scan_results->next = ble_scan_results;
-    } else {
-        *results = ble_scan_results;
-    }
-
-    num_bt_scan_results = 0;
-    bt_scan_results = NULL;
-    num_ble_scan_results = 0;
-    ble_scan_results = NULL;
+    *results = scan_table_take();
     return ESP_OK;
 }
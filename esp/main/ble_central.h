@@ -63,20 +63,24 @@ typedef struct ble_central_scan_result_s {
     esp_hid_transport_t transport;
     union {
     #if !CONFIG_BT_NIMBLE_ENABLED
+    #if CONFIG_BT_HID_HOST_ENABLED
         struct {
             esp_bt_cod_t cod;
             esp_bt_uuid_t uuid;
         } bt;
+    #endif
         struct {
             esp_ble_addr_type_t addr_type;
             uint16_t appearance;
             bool has_nus_uuid;
+            bool has_mouthpad_mfr; // MouthPad manufacturer data (0x4147 "MP1")
         } ble;
     #else
         struct {
             uint8_t addr_type;
             uint16_t appearance;
             bool has_nus_uuid;
+            bool has_mouthpad_mfr; // MouthPad manufacturer data (0x4147 "MP1")
         } ble;
     #endif
     };
@@ -86,8 +90,36 @@ esp_err_t ble_central_init(uint8_t mode);
 esp_err_t ble_central_scan(uint32_t seconds, size_t *num_results, ble_central_scan_result_t **results);
 void ble_central_scan_results_free(ble_central_scan_result_t *results);
 
+/**
+ * Called for each BLE HID advertisement as it arrives during ble_central_scan(),
+ * from the Bluetooth task. Returning true stops the scan early; ble_central_scan()
+ * then returns right away, and its results include this one. The callback must not
+ * block or call other Bluetooth APIs.
+ */
+typedef bool (*ble_central_scan_match_cb_t)(const ble_central_scan_result_t *result);
+void ble_central_set_scan_match_callback(ble_central_scan_match_cb_t cb);
+
 void ble_central_set_user_ble_callback(esp_gap_ble_cb_t cb);
 
+/**
+ * Limit the next BLE scans to one address through the controller whitelist, or
+ * pass NULL to hear every advertiser again. Other devices never reach the host,
+ * so their advertisements are not parsed or stored. Call between scans only.
+ */
+esp_err_t ble_central_set_scan_filter(const uint8_t *bda);
+
+/**
+ * Interval and window of the next BLE scans, in 0.625 ms units. Call between
+ * scans only.
+ */
+void ble_central_set_scan_timing(uint16_t interval, uint16_t window);
+
+/**
+ * Send scan requests in the next BLE scans (active), or only listen
+ * (passive). Call between scans only.
+ */
+void ble_central_set_scan_active(bool active);
+
 esp_err_t ble_central_adv_init(uint16_t appearance, const char *device_name);
 esp_err_t ble_central_adv_start(void);
 
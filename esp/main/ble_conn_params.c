@@ -0,0 +1,287 @@
+#include "ble_conn_params.h"
+
+#include <stdbool.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include "esp_gap_ble_api.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+#include "activity.h"
+#include "power.h"
+#include "tuning_profile.h"
+
+static const char *TAG = "BLE_CONN_PARAMS";
+
+// While the relay is active (activity.h) the link runs at the minimum
+// connection interval with no peripheral latency. Once it goes idle the
+// interval and latency are relaxed so the MouthPad can sleep through most
+// connection events, and deep idle raises the latency further; the first new
+// report snaps back. That report is still delivered at the next relaxed
+// event, so keep the idle interval short and save power through the
+// peripheral latency instead.
+//
+// The active interval and the idle interval and latency come from the tuning
+// profile (tuning.h); the defines below are the build-time values. Deep idle
+// raises the profile's idle latency to DEEP_IDLE_LATENCY, unless the profile
+// asks for no latency at all, and never past what the timeout allows.
+#define ACTIVE_INTERVAL 0x06 // 6 * 1.25ms = 7.5ms (minimum allowed)
+#define ACTIVE_LATENCY 0x00
+#define IDLE_INTERVAL CONFIG_MOUTHPAD_CONN_IDLE_INTERVAL
+#define IDLE_LATENCY CONFIG_MOUTHPAD_CONN_IDLE_LATENCY
+#define DEEP_IDLE_LATENCY CONFIG_MOUTHPAD_CONN_DEEP_IDLE_LATENCY
+// USB host suspended: nothing is forwarded, so sleep as long as the link allows
+#define SUSPEND_INTERVAL CONFIG_MOUTHPAD_CONN_SUSPEND_INTERVAL
+#define SUSPEND_LATENCY CONFIG_MOUTHPAD_CONN_SUSPEND_LATENCY
+#define SUPERVISION_TIMEOUT BLE_CONN_PARAMS_TIMEOUT
+
+// Supervision timeout must exceed (1 + latency) * interval * 2
+_Static_assert(SUPERVISION_TIMEOUT * 10 * 4 > (1 + IDLE_LATENCY) * IDLE_INTERVAL * 5 * 2,
+               "Idle connection parameters exceed the supervision timeout");
+_Static_assert(SUPERVISION_TIMEOUT * 10 * 4 > (1 + DEEP_IDLE_LATENCY) * IDLE_INTERVAL * 5 * 2,
+               "Deep idle connection parameters exceed the supervision timeout");
+_Static_assert(SUPERVISION_TIMEOUT * 10 * 4 > (1 + SUSPEND_LATENCY) * SUSPEND_INTERVAL * 5 * 2,
+               "Suspend connection parameters exceed the supervision timeout");
+
+typedef enum {
+    CONN_PARAMS_OFF,
+    CONN_PARAMS_ACTIVE,
+    CONN_PARAMS_RELAXED,
+    CONN_PARAMS_DEEP,
+    CONN_PARAMS_SUSPENDED,
+} conn_params_state_t;
+
+static const struct {
+    const char *name;
+    uint16_t interval;
+    uint16_t latency;
+} s_state_params[] = {
+    [CONN_PARAMS_ACTIVE] = {"active", ACTIVE_INTERVAL, ACTIVE_LATENCY},
+    [CONN_PARAMS_RELAXED] = {"idle", IDLE_INTERVAL, IDLE_LATENCY},
+    [CONN_PARAMS_DEEP] = {"deep idle", IDLE_INTERVAL, DEEP_IDLE_LATENCY},
+    [CONN_PARAMS_SUSPENDED] = {"USB suspended", SUSPEND_INTERVAL, SUSPEND_LATENCY},
+};
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static conn_params_state_t s_applied = CONN_PARAMS_OFF;
+static bool s_connected;
+static bool s_usb_suspended;
+static bool s_at_risk;
+static uint16_t s_applied_interval;
+static uint16_t s_applied_latency;
+static uint16_t s_applied_timeout = SUPERVISION_TIMEOUT;
+static esp_bd_addr_t s_bda;
+
+static void request_params(const esp_bd_addr_t bda, uint16_t interval, uint16_t latency,
+                           uint16_t timeout)
+{
+    esp_ble_conn_update_params_t params = {
+        .bda = {0},
+        .min_int = interval,
+        .max_int = interval,
+        .latency = latency,
+        .timeout = timeout,
+    };
+    memcpy(params.bda, bda, sizeof(esp_bd_addr_t));
+
+    esp_err_t ret = esp_ble_gap_update_conn_params(&params);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to request connection parameters: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "Requested %u x 1.25ms interval, latency %u, timeout %u ms", interval,
+                 latency, timeout * 10);
+    }
+}
+
+static conn_params_state_t wanted_state(activity_level_t level)
+{
+    if (!s_connected) {
+        return CONN_PARAMS_OFF;
+    }
+    if (s_usb_suspended) {
+        return CONN_PARAMS_SUSPENDED;
+    }
+    switch (level) {
+    case ACTIVITY_ACTIVE:
+        return CONN_PARAMS_ACTIVE;
+    case ACTIVITY_IDLE:
+        return CONN_PARAMS_RELAXED;
+    default:
+        return CONN_PARAMS_DEEP;
+    }
+}
+
+#define KNOB(name) mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_##name
+
+// Interval and latency of a state, with the tuning profile applied
+static void wanted_link(conn_params_state_t state, uint16_t *interval, uint16_t *latency)
+{
+    uint32_t idle_latency;
+
+    *interval = s_state_params[state].interval;
+    *latency = s_state_params[state].latency;
+
+    switch (state) {
+    case CONN_PARAMS_ACTIVE:
+        *interval = tuning_profile_get(KNOB(ACTIVE_INTERVAL));
+        break;
+    case CONN_PARAMS_RELAXED:
+        *interval = tuning_profile_get(KNOB(IDLE_INTERVAL));
+        *latency = tuning_profile_get(KNOB(IDLE_LATENCY));
+        break;
+    case CONN_PARAMS_DEEP:
+        *interval = tuning_profile_get(KNOB(IDLE_INTERVAL));
+        idle_latency = tuning_profile_get(KNOB(IDLE_LATENCY));
+        if (!idle_latency) {
+            *latency = 0;
+            break;
+        }
+        // (1 + latency) * interval * 1.25 ms within the idle sleep allowed
+        *latency = MIN(MAX(idle_latency, DEEP_IDLE_LATENCY),
+                       BLE_CONN_PARAMS_MAX_SLEEP_MS * 4U / 5U / *interval - 1U);
+        break;
+    default:
+        break;
+    }
+}
+
+// Supervision timeout in 10 ms units: the link guard's while at risk, but
+// always more than (1 + latency) * interval * 2; call with s_lock held
+static uint16_t wanted_timeout(conn_params_state_t state, uint16_t interval, uint16_t latency)
+{
+#if CONFIG_MOUTHPAD_LINK_GUARD
+    if (!s_at_risk || state == CONN_PARAMS_OFF) {
+        return SUPERVISION_TIMEOUT;
+    }
+
+    uint32_t least = (1U + latency) * interval * 125U * 2U / 1000U + 1U;
+    uint32_t timeout = MAX(CONFIG_MOUTHPAD_LINK_GUARD_TIMEOUT_MS / 10U, least);
+
+    return (uint16_t)MIN(timeout, SUPERVISION_TIMEOUT);
+#else
+    (void)state;
+    (void)interval;
+    (void)latency;
+    return SUPERVISION_TIMEOUT;
+#endif
+}
+
+// Request the parameters for the current inputs; called from the esp_hidh,
+// TinyUSB and esp_timer tasks
+static void conn_params_apply(activity_level_t level)
+{
+    esp_bd_addr_t bda;
+    conn_params_state_t want;
+    uint16_t interval;
+    uint16_t latency;
+    uint16_t timeout;
+    bool change;
+
+    taskENTER_CRITICAL(&s_lock);
+    want = wanted_state(level);
+    wanted_link(want, &interval, &latency);
+    timeout = wanted_timeout(want, interval, latency);
+    change = want != s_applied || interval != s_applied_interval ||
+             latency != s_applied_latency || timeout != s_applied_timeout;
+    s_applied = want;
+    s_applied_interval = interval;
+    s_applied_latency = latency;
+    s_applied_timeout = timeout;
+    memcpy(bda, s_bda, sizeof(bda));
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (!change) {
+        return;
+    }
+
+    // The CPU only needs its maximum clock while reports are flowing
+    power_hid_active(want == CONN_PARAMS_ACTIVE);
+    if (want == CONN_PARAMS_OFF) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "%s: switching connection parameters", s_state_params[want].name);
+    request_params(bda, interval, latency, timeout);
+}
+
+static void activity_changed(activity_level_t level)
+{
+    conn_params_apply(level);
+}
+
+esp_err_t ble_conn_params_init(void)
+{
+    return activity_subscribe(activity_changed);
+}
+
+void ble_conn_params_connecting(const uint8_t *bda)
+{
+    esp_bd_addr_t addr;
+    uint16_t interval;
+    uint16_t latency;
+
+    memcpy(addr, bda, sizeof(addr));
+    wanted_link(CONN_PARAMS_ACTIVE, &interval, &latency);
+
+    // Only used by the connection to this address; idle relaxes it later
+    esp_err_t ret =
+        esp_ble_gap_set_prefer_conn_params(addr, interval, interval, latency, SUPERVISION_TIMEOUT);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set connect parameters: %s", esp_err_to_name(ret));
+    }
+}
+
+void ble_conn_params_connected(const uint8_t *bda)
+{
+    taskENTER_CRITICAL(&s_lock);
+    memcpy(s_bda, bda, sizeof(s_bda));
+    s_connected = true;
+    s_applied = CONN_PARAMS_OFF; // New link: always send the first request
+    taskEXIT_CRITICAL(&s_lock);
+
+    activity_mark();
+    conn_params_apply(ACTIVITY_ACTIVE);
+}
+
+void ble_conn_params_disconnected(void)
+{
+    taskENTER_CRITICAL(&s_lock);
+    s_connected = false;
+    taskEXIT_CRITICAL(&s_lock);
+
+    conn_params_apply(activity_level());
+}
+
+void ble_conn_params_at_risk(bool at_risk)
+{
+    bool change;
+
+    taskENTER_CRITICAL(&s_lock);
+    change = s_at_risk != at_risk;
+    s_at_risk = at_risk;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (change) {
+        conn_params_apply(activity_level());
+    }
+}
+
+void ble_conn_params_usb_suspended(bool suspended)
+{
+    bool change;
+
+    taskENTER_CRITICAL(&s_lock);
+    change = s_usb_suspended != suspended;
+    s_usb_suspended = suspended;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (change) {
+        conn_params_apply(activity_level());
+    }
+}
+
+void ble_conn_params_retune(void)
+{
+    conn_params_apply(activity_level());
+}
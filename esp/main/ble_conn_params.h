@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Supervision timeout, 4 s, in 10 ms units
+#define BLE_CONN_PARAMS_TIMEOUT 400
+
+// Longest (1 + latency) * interval, in ms, the timeout allows
+#define BLE_CONN_PARAMS_MAX_SLEEP_MS (BLE_CONN_PARAMS_TIMEOUT * 10 / 2 - 1)
+
+// Follow the activity level; call once after activity_init()
+esp_err_t ble_conn_params_init(void);
+
+// Create the next connection to bda with the active parameters, so service
+// discovery already runs at the minimum interval; call before
+// esp_hidh_dev_open()
+void ble_conn_params_connecting(const uint8_t *bda);
+
+// Mark the relay active and request the active (lowest latency)
+// parameters; later changes follow the activity level (activity.h)
+void ble_conn_params_connected(const uint8_t *bda);
+
+// Stop managing parameters; call on disconnect
+void ble_conn_params_disconnected(void);
+
+// Follow the link guard (link_guard.h). While the link is at risk the
+// supervision timeout is cut to CONFIG_MOUTHPAD_LINK_GUARD_TIMEOUT_MS, or the
+// least the current interval and latency allow, so a link that drops is
+// given up and reconnected sooner.
+void ble_conn_params_at_risk(bool at_risk);
+
+// Follow the USB suspend state. While suspended the link uses the long
+// CONFIG_MOUTHPAD_CONN_SUSPEND_* parameters and HID activity does not bring
+// it back; resume requests the active parameters. Remembered across
+// reconnects.
+void ble_conn_params_usb_suspended(bool suspended);
+
+// Request the parameters again after the tuning profile changed; safe from
+// any task
+void ble_conn_params_retune(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,9 @@
 #include "ble_dis.h"
+#include "ble_bas.h"
+#include "ble_bonds.h"
+#include "connection_timing.h"
+#include "persist.h"
+#include "relay_protocol.h"
 #include "esp_log.h"
 #include "esp_gap_ble_api.h"
 #include "esp_gattc_api.h"
@@ -10,12 +15,30 @@
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "string.h"
+#include <stdio.h>
 
 static const char *TAG = "BLE_DIS";
 
-// NVS namespace and key for persisting device info
+// NVS namespace and keys for persisting device info: one entry per bonded
+// MouthPad, "di_" and its address in hex. Older firmware kept a single entry
+// under "device_info"; it is moved to the most recent bond on first boot.
 #define NVS_NAMESPACE "ble_dis"
 #define NVS_KEY_DEVICE_INFO "device_info"
+#define NVS_KEY_PREFIX "di_"
+#define NVS_KEY_LEN 16
+
+// Battery Service, read alongside DIS
+#define BAS_SERVICE_UUID 0x180F
+#define BAS_CHAR_LEVEL_UUID 0x2A19
+
+// GATT reads are handed to Bluedroid READ_WINDOW at a time. It queues them
+// and sends the next ATT request as soon as a response arrives, rather than
+// after the response has been through the BTC task and back here.
+#define READ_WINDOW 3
+#define DIS_CHAR_COUNT 7
+#define READ_SLOT_BATTERY DIS_CHAR_COUNT
+#define READ_SLOTS (DIS_CHAR_COUNT + 1)
+#define DIS_SLOT_FIRMWARE 4
 
 // Device info client state
 static esp_gatt_if_t dis_gattc_if = ESP_GATT_IF_NONE;
@@ -27,13 +50,40 @@ static bool dis_service_discovered = false;
 // Service and characteristic handles
 static uint16_t dis_service_start_handle = 0;
 static uint16_t dis_service_end_handle = 0;
-static uint16_t dis_char_handles[7] = {0}; // Handles for the 7 DIS characteristics
+static uint16_t dis_char_handles[DIS_CHAR_COUNT] = {0}; // Handles for the 7 DIS characteristics
+static uint16_t bas_service_start_handle = 0;
+static uint16_t bas_service_end_handle = 0;
+
+// Read scheduler: slots 0-6 are the DIS characteristics, then the battery level
+static uint16_t s_read_handles[READ_SLOTS];
+static uint8_t s_read_queue[READ_SLOTS]; // Slots in issue order
+static uint8_t s_read_queued;
+static uint8_t s_read_issued;
+static uint8_t s_read_outstanding;
+static uint8_t s_dis_pending;            // DIS reads queued and not answered
+
+// The device info came from the cache for this address; reading the firmware
+// revision tells whether it still holds, and only then is the rest read
+static bool s_validating = false;
 
 // Configuration callback
 static ble_device_info_config_t dis_config = {0};
 
 // Current device info
 static ble_device_info_t current_device_info = {0};
+
+// What NVS holds for s_saved_bda, or will once the persist task has written
+// s_pending_info; and an entry of a dropped bond waiting to be erased
+static esp_bd_addr_t s_saved_bda = {0};
+static ble_device_info_t s_saved_info = {0};
+static esp_bd_addr_t s_pending_bda;
+static ble_device_info_t s_pending_info;
+static bool s_pending_dirty = false;
+static esp_bd_addr_t s_forget_bda;
+static bool s_forget_pending = false;
+static bool s_erase_legacy = false;
+static portMUX_TYPE s_pending_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_persist_id = -1;
 static uint8_t chars_read_count = 0;
 static uint8_t chars_found_count = 0;
 
@@ -71,6 +121,8 @@ static const char* char_names[] = {
 // Forward declarations
 static esp_err_t save_device_info_to_nvs(void);
 static esp_err_t load_device_info_from_nvs(void);
+static void device_info_persist_flush(void);
+static bool cache_load(const esp_bd_addr_t bda, ble_device_info_t *info);
 
 esp_err_t ble_device_info_init(const ble_device_info_config_t *config)
 {
@@ -84,6 +136,7 @@ esp_err_t ble_device_info_init(const ble_device_info_config_t *config)
 
     // Load saved device info from NVS if available
     load_device_info_from_nvs();
+    s_persist_id = persist_register(device_info_persist_flush);
 
     ESP_LOGI(TAG, "Device info client initialized");
     return ESP_OK;
@@ -102,11 +155,23 @@ esp_err_t ble_device_info_discover(esp_gatt_if_t gattc_if, uint16_t conn_id, con
     dis_connected = false;
     dis_service_discovered = false;
     memcpy(dis_server_bda, server_bda, sizeof(esp_bd_addr_t));
-    memset(&current_device_info, 0, sizeof(ble_device_info_t));
     memset(dis_char_handles, 0, sizeof(dis_char_handles));
+    bas_service_start_handle = 0;
+    bas_service_end_handle = 0;
     chars_read_count = 0;
     chars_found_count = 0;
 
+    // A MouthPad seen before is answered for from its cache at once; the
+    // reads below then only check its firmware revision
+    s_validating = cache_load(server_bda, &current_device_info);
+    if (s_validating) {
+        ESP_LOGI(TAG, "Device info from cache (firmware %s), validating in the background",
+                 current_device_info.firmware_revision);
+    } else {
+        memset(&current_device_info, 0, sizeof(ble_device_info_t));
+    }
+    relay_protocol_device_info_changed();
+
     // Store device name if provided
     if (device_name && strlen(device_name) > 0) {
         size_t copy_len = (strlen(device_name) < (DIS_MAX_STRING_LEN - 1)) ?
@@ -138,9 +203,41 @@ const ble_device_info_t* ble_device_info_get_current(void)
     return current_device_info.info_complete ? &current_device_info : NULL;
 }
 
-// Save device info to NVS for persistence across reboots
-static esp_err_t save_device_info_to_nvs(void)
+static void cache_key(const esp_bd_addr_t bda, char key[NVS_KEY_LEN])
+{
+    snprintf(key, NVS_KEY_LEN, NVS_KEY_PREFIX "%02x%02x%02x%02x%02x%02x",
+             bda[0], bda[1], bda[2], bda[3], bda[4], bda[5]);
+}
+
+// Cached device info of a MouthPad; only a complete one with a firmware
+// revision to validate it by counts
+static bool cache_load(const esp_bd_addr_t bda, ble_device_info_t *info)
+{
+    char key[NVS_KEY_LEN];
+    nvs_handle_t nvs_handle;
+
+    // The entry NVS holds, or is about to, for the last MouthPad saved
+    if (memcmp(bda, s_saved_bda, sizeof(esp_bd_addr_t)) == 0 && s_saved_info.info_complete) {
+        memcpy(info, &s_saved_info, sizeof(*info));
+        return info->firmware_revision[0] != '\0';
+    }
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return false;
+    }
+    cache_key(bda, key);
+    size_t required_size = sizeof(*info);
+    esp_err_t ret = nvs_get_blob(nvs_handle, key, info, &required_size);
+    nvs_close(nvs_handle);
+
+    return ret == ESP_OK && required_size == sizeof(*info) && info->info_complete &&
+           info->firmware_revision[0] != '\0';
+}
+
+// Write a snapshot of the device info to NVS under its address
+static esp_err_t write_device_info_to_nvs(const esp_bd_addr_t bda, const ble_device_info_t *info)
 {
+    char key[NVS_KEY_LEN];
     nvs_handle_t nvs_handle;
     esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
     if (ret != ESP_OK) {
@@ -148,26 +245,123 @@ static esp_err_t save_device_info_to_nvs(void)
         return ret;
     }
 
-    ret = nvs_set_blob(nvs_handle, NVS_KEY_DEVICE_INFO, &current_device_info, sizeof(ble_device_info_t));
+    cache_key(bda, key);
+    ret = nvs_set_blob(nvs_handle, key, info, sizeof(ble_device_info_t));
     if (ret != ESP_OK) {
         ESP_LOGW(TAG, "Failed to save device info to NVS: %s", esp_err_to_name(ret));
         nvs_close(nvs_handle);
         return ret;
     }
+    if (s_erase_legacy) {
+        esp_err_t erase = nvs_erase_key(nvs_handle, NVS_KEY_DEVICE_INFO);
+        if (erase == ESP_OK || erase == ESP_ERR_NVS_NOT_FOUND) {
+            s_erase_legacy = false;
+        }
+    }
 
     ret = nvs_commit(nvs_handle);
     nvs_close(nvs_handle);
 
     if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "Device info saved to NVS");
+        ESP_LOGI(TAG, "Device info saved to NVS (%s)", key);
     }
 
     return ret;
 }
 
-// Load device info from NVS
+static void erase_device_info_from_nvs(const esp_bd_addr_t bda)
+{
+    char key[NVS_KEY_LEN];
+    nvs_handle_t nvs_handle;
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle) != ESP_OK) {
+        return;
+    }
+    cache_key(bda, key);
+    if (nvs_erase_key(nvs_handle, key) == ESP_OK) {
+        nvs_commit(nvs_handle);
+        ESP_LOGI(TAG, "Erased device info of a dropped bond (%s)", key);
+    }
+    nvs_close(nvs_handle);
+}
+
+// Persist task: write the snapshot taken by save_device_info_to_nvs(), and
+// erase the entry of a bond that was dropped
+static void device_info_persist_flush(void)
+{
+    esp_bd_addr_t bda;
+    esp_bd_addr_t forget;
+    ble_device_info_t info;
+
+    taskENTER_CRITICAL(&s_pending_lock);
+    bool dirty = s_pending_dirty;
+    bool forget_pending = s_forget_pending;
+    s_pending_dirty = false;
+    s_forget_pending = false;
+    if (dirty) {
+        memcpy(bda, s_pending_bda, sizeof(bda));
+        memcpy(&info, &s_pending_info, sizeof(info));
+    }
+    if (forget_pending) {
+        memcpy(forget, s_forget_bda, sizeof(forget));
+    }
+    taskEXIT_CRITICAL(&s_pending_lock);
+
+    if (forget_pending) {
+        erase_device_info_from_nvs(forget);
+    }
+    if (dirty) {
+        write_device_info_to_nvs(bda, &info);
+    }
+}
+
+// Save device info to NVS for persistence across reboots. Runs on the BTC
+// task, so only a snapshot is taken here and only when it differs from
+// what NVS already holds; the persist task does the write.
+static esp_err_t save_device_info_to_nvs(void)
+{
+    if (memcmp(s_saved_bda, dis_server_bda, sizeof(esp_bd_addr_t)) == 0 &&
+        memcmp(&s_saved_info, &current_device_info, sizeof(ble_device_info_t)) == 0) {
+        ESP_LOGD(TAG, "Device info unchanged, not saving");
+        return ESP_OK;
+    }
+
+    memcpy(s_saved_bda, dis_server_bda, sizeof(esp_bd_addr_t));
+    memcpy(&s_saved_info, &current_device_info, sizeof(ble_device_info_t));
+
+    if (s_persist_id < 0) {
+        return write_device_info_to_nvs(s_saved_bda, &s_saved_info);
+    }
+
+    taskENTER_CRITICAL(&s_pending_lock);
+    memcpy(s_pending_bda, dis_server_bda, sizeof(esp_bd_addr_t));
+    memcpy(&s_pending_info, &current_device_info, sizeof(ble_device_info_t));
+    s_pending_dirty = true;
+    taskEXIT_CRITICAL(&s_pending_lock);
+
+    persist_request(s_persist_id);
+    return ESP_OK;
+}
+
+// Load the device info of the most recently used bond from NVS, so it is
+// reported before the MouthPad connects
 static esp_err_t load_device_info_from_nvs(void)
 {
+    esp_bd_addr_t bda;
+
+    if (ble_bonds_get_bonded_device(bda) != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (cache_load(bda, &current_device_info)) {
+        memcpy(s_saved_bda, bda, sizeof(bda));
+        memcpy(&s_saved_info, &current_device_info, sizeof(ble_device_info_t));
+        relay_protocol_device_info_changed();
+        ESP_LOGI(TAG, "Loaded device info from NVS: %s", current_device_info.device_name);
+        return ESP_OK;
+    }
+
+    // Older firmware kept one entry; it belongs to the bond it was read from
     nvs_handle_t nvs_handle;
     esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
     if (ret != ESP_OK) {
@@ -182,17 +376,41 @@ static esp_err_t load_device_info_from_nvs(void)
     nvs_close(nvs_handle);
 
     if (ret == ESP_OK && required_size == sizeof(ble_device_info_t)) {
-        ESP_LOGI(TAG, "Loaded device info from NVS: %s", current_device_info.device_name);
+        relay_protocol_device_info_changed();
+        ESP_LOGI(TAG, "Moving saved device info to the bond cache: %s", current_device_info.device_name);
+        memcpy(dis_server_bda, bda, sizeof(bda));
+        s_erase_legacy = true;
+        save_device_info_to_nvs();
         return ESP_OK;
     } else if (ret == ESP_ERR_NVS_NOT_FOUND) {
         ESP_LOGI(TAG, "No saved device info found in NVS");
     } else {
         ESP_LOGW(TAG, "Failed to load device info from NVS: %s", esp_err_to_name(ret));
     }
+    memset(&current_device_info, 0, sizeof(ble_device_info_t));
 
     return ret;
 }
 
+void ble_device_info_forget(const esp_bd_addr_t bda)
+{
+    if (memcmp(bda, s_saved_bda, sizeof(esp_bd_addr_t)) == 0) {
+        memset(s_saved_bda, 0, sizeof(s_saved_bda));
+        memset(&s_saved_info, 0, sizeof(s_saved_info));
+    }
+
+    taskENTER_CRITICAL(&s_pending_lock);
+    memcpy(s_forget_bda, bda, sizeof(esp_bd_addr_t));
+    s_forget_pending = true;
+    taskEXIT_CRITICAL(&s_pending_lock);
+
+    if (s_persist_id < 0) {
+        device_info_persist_flush();
+    } else {
+        persist_request(s_persist_id);
+    }
+}
+
 bool ble_device_info_has_cached_firmware(void)
 {
     // Check if current_device_info has valid firmware version
@@ -203,6 +421,15 @@ bool ble_device_info_has_cached_firmware(void)
 // Clear saved device info from NVS (called when bonds are cleared)
 esp_err_t ble_device_info_clear_saved(void)
 {
+    // A pending write must not bring it back
+    taskENTER_CRITICAL(&s_pending_lock);
+    s_pending_dirty = false;
+    s_forget_pending = false;
+    taskEXIT_CRITICAL(&s_pending_lock);
+    memset(s_saved_bda, 0, sizeof(s_saved_bda));
+    memset(&s_saved_info, 0, sizeof(ble_device_info_t));
+    s_erase_legacy = false;
+
     nvs_handle_t nvs_handle;
     esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
     if (ret != ESP_OK) {
@@ -210,14 +437,15 @@ esp_err_t ble_device_info_clear_saved(void)
         return ret;
     }
 
-    ret = nvs_erase_key(nvs_handle, NVS_KEY_DEVICE_INFO);
-    if (ret == ESP_OK || ret == ESP_ERR_NVS_NOT_FOUND) {
+    // Every bond's entry, and the single one of older firmware
+    ret = nvs_erase_all(nvs_handle);
+    if (ret == ESP_OK) {
         nvs_commit(nvs_handle);
         ESP_LOGI(TAG, "Cleared saved device info from NVS");
 
         // Also clear current device info
         memset(&current_device_info, 0, sizeof(ble_device_info_t));
-        ret = ESP_OK;
+        relay_protocol_device_info_changed();
     } else {
         ESP_LOGW(TAG, "Failed to clear device info from NVS: %s", esp_err_to_name(ret));
     }
@@ -272,20 +500,227 @@ void ble_device_info_print(const ble_device_info_t *device_info)
     ESP_LOGI(TAG, "==========================");
 }
 
-static void check_info_complete(void)
+static void store_dis_value(int slot, const uint8_t *value, uint16_t len)
+{
+    if (slot == 6) { // PnP ID characteristic (binary data)
+        if (len >= 7) { // PnP ID should be 7 bytes
+            current_device_info.pnp_id.vendor_id_source = value[0];
+            current_device_info.pnp_id.vendor_id = (value[2] << 8) | value[1];
+            current_device_info.pnp_id.product_id = (value[4] << 8) | value[3];
+            current_device_info.pnp_id.product_version = (value[6] << 8) | value[5];
+            current_device_info.has_pnp_id = true;
+        } else {
+            ESP_LOGW(TAG, "PnP ID data too short (%d bytes, expected 7)", len);
+        }
+    } else { // String characteristic
+        // Copy the string data, ensuring null termination
+        size_t copy_len = (len < (DIS_MAX_STRING_LEN - 1)) ? len : (DIS_MAX_STRING_LEN - 1);
+        memcpy(device_info_strings[slot], value, copy_len);
+        device_info_strings[slot][copy_len] = '\0';
+    }
+}
+
+static const char *read_slot_name(int slot)
+{
+    return slot == READ_SLOT_BATTERY ? "Battery Level" : char_names[slot];
+}
+
+static int read_slot_for_handle(uint16_t handle)
+{
+    for (int slot = 0; slot < READ_SLOTS; slot++) {
+        if (s_read_handles[slot] != 0 && s_read_handles[slot] == handle) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+static void read_queue_add(int slot)
 {
-    if (chars_read_count >= chars_found_count && chars_found_count > 0) {
+    if (s_read_handles[slot] == 0 || s_read_queued >= READ_SLOTS) {
+        return;
+    }
+    s_read_queue[s_read_queued++] = (uint8_t)slot;
+    if (slot < DIS_CHAR_COUNT) {
+        s_dis_pending++;
+    }
+}
+
+// Keep up to READ_WINDOW reads with Bluedroid. A read that cannot be issued
+// counts as answered, as a failed read always has.
+static void read_queue_run(void)
+{
+    while (s_read_outstanding < READ_WINDOW && s_read_issued < s_read_queued) {
+        int slot = s_read_queue[s_read_issued++];
+        esp_err_t ret = esp_ble_gattc_read_char(dis_gattc_if, dis_conn_id,
+                                                s_read_handles[slot], ESP_GATT_AUTH_REQ_NONE);
+        if (ret == ESP_OK) {
+            s_read_outstanding++;
+            continue;
+        }
+        ESP_LOGE(TAG, "Failed to read %s: %s", read_slot_name(slot), esp_err_to_name(ret));
+        if (slot < DIS_CHAR_COUNT) {
+            chars_read_count++;
+            s_dis_pending--;
+        }
+    }
+}
+
+// Every DIS read queued has been answered
+static void dis_reads_done(void)
+{
+    if (s_validating) {
+        s_validating = false;
+        ESP_LOGI(TAG, "Cached device info is current (firmware %s)",
+                 current_device_info.firmware_revision);
+    } else {
         current_device_info.info_complete = true;
+        relay_protocol_device_info_changed();
         ESP_LOGI(TAG, "Device info discovery complete (%d characteristics read)", chars_read_count);
 
         // Save device info to NVS for persistence
         save_device_info_to_nvs();
+    }
+
+    // Call completion callback (which will print the device info)
+    if (dis_config.info_complete_cb) {
+        dis_config.info_complete_cb(&current_device_info);
+    }
+}
+
+// The firmware revision read while validating. A match leaves the cached info
+// in place; anything else means the MouthPad was updated, and the cached info
+// is dropped and everything else read.
+static void validate_firmware(const uint8_t *value, uint16_t len)
+{
+    char firmware[DIS_MAX_STRING_LEN];
+    size_t copy_len = (len < (DIS_MAX_STRING_LEN - 1)) ? len : (DIS_MAX_STRING_LEN - 1);
+
+    memcpy(firmware, value, copy_len);
+    firmware[copy_len] = '\0';
+    if (strcmp(firmware, current_device_info.firmware_revision) == 0) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "Firmware changed (%s -> %s), reading device info",
+             current_device_info.firmware_revision, firmware);
+    char device_name[DIS_MAX_STRING_LEN];
+    memcpy(device_name, current_device_info.device_name, sizeof(device_name));
+    memset(&current_device_info, 0, sizeof(ble_device_info_t));
+    memcpy(current_device_info.device_name, device_name, sizeof(device_name));
+    memcpy(current_device_info.firmware_revision, firmware, sizeof(firmware));
+    relay_protocol_device_info_changed();
+    s_validating = false;
+
+    for (int slot = 0; slot < DIS_CHAR_COUNT; slot++) {
+        if (slot != DIS_SLOT_FIRMWARE) {
+            read_queue_add(slot);
+        }
+    }
+}
+
+// Store the handles of the DIS characteristics found
+static void find_dis_chars(void)
+{
+    esp_gattc_char_elem_t char_elem_result[10];
+    uint16_t char_elem_count = 10;
+
+    ESP_LOGD(TAG, "Getting DIS service characteristics - start: %d, end: %d",
+             dis_service_start_handle, dis_service_end_handle);
+
+    esp_gatt_status_t status = esp_ble_gattc_get_all_char(
+        dis_gattc_if, dis_conn_id,
+        dis_service_start_handle,
+        dis_service_end_handle,
+        char_elem_result,
+        &char_elem_count,
+        0
+    );
+
+    ESP_LOGI(TAG, "Get characteristics result: status=%d, count=%d", status, char_elem_count);
+
+    if (status != ESP_GATT_OK || char_elem_count == 0) {
+        ESP_LOGE(TAG, "Failed to get DIS characteristics: status=%d", status);
+        return;
+    }
+
+    // Look for DIS characteristics by UUID and store handles
+    for (int i = 0; i < char_elem_count; i++) {
+        if (char_elem_result[i].uuid.len == ESP_UUID_LEN_16) {
+            uint16_t char_uuid = char_elem_result[i].uuid.uuid.uuid16;
+
+            // Find which DIS characteristic this is
+            for (int j = 0; j < DIS_CHAR_COUNT; j++) {
+                if (char_uuid == dis_char_uuids[j]) {
+                    dis_char_handles[j] = char_elem_result[i].char_handle;
+                    chars_found_count++;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (chars_found_count == 0) {
+        ESP_LOGW(TAG, "No DIS characteristics found");
+    }
+}
+
+// Handle of the Battery Level characteristic, 0 without a Battery Service
+static uint16_t find_battery_level(void)
+{
+    if (bas_service_start_handle == 0) {
+        return 0;
+    }
+
+    esp_gattc_char_elem_t char_elem;
+    uint16_t count = 1;
+    esp_bt_uuid_t level_uuid = {
+        .len = ESP_UUID_LEN_16,
+        .uuid = {.uuid16 = BAS_CHAR_LEVEL_UUID}
+    };
+    esp_gatt_status_t status = esp_ble_gattc_get_char_by_uuid(dis_gattc_if, dis_conn_id,
+                                                              bas_service_start_handle,
+                                                              bas_service_end_handle,
+                                                              level_uuid, &char_elem, &count);
+    if (status != ESP_GATT_OK || count == 0) {
+        ESP_LOGW(TAG, "Battery Level characteristic not found: status=%d", status);
+        return 0;
+    }
+    return char_elem.char_handle;
+}
+
+// Queue the reads for this connection, firmware revision first as it decides
+// whether the cache holds, and the battery level last
+static void start_reads(void)
+{
+    memset(s_read_handles, 0, sizeof(s_read_handles));
+    memcpy(s_read_handles, dis_char_handles, sizeof(dis_char_handles));
+    s_read_handles[READ_SLOT_BATTERY] = find_battery_level();
+    s_read_queued = 0;
+    s_read_issued = 0;
+    s_read_outstanding = 0;
+    s_dis_pending = 0;
+
+    // Without a firmware revision to compare, the cache cannot be checked
+    if (s_validating && dis_char_handles[DIS_SLOT_FIRMWARE] == 0) {
+        ESP_LOGW(TAG, "No firmware revision to validate the cache with");
+        s_validating = false;
+    }
 
-        // Call completion callback (which will print the device info)
-        if (dis_config.info_complete_cb) {
-            dis_config.info_complete_cb(&current_device_info);
+    read_queue_add(DIS_SLOT_FIRMWARE);
+    if (!s_validating) {
+        for (int slot = 0; slot < DIS_CHAR_COUNT; slot++) {
+            if (slot != DIS_SLOT_FIRMWARE) {
+                read_queue_add(slot);
+            }
         }
     }
+    read_queue_add(READ_SLOT_BATTERY);
+
+    if (s_read_queued > 0) {
+        dis_connected = true;
+    }
+    read_queue_run();
 }
 
 void ble_device_info_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp_ble_gattc_cb_param_t *param)
@@ -332,6 +767,14 @@ void ble_device_info_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_
                 ESP_LOGD(TAG, "16-bit Service UUID: 0x%04x (looking for DIS 0x%04x)",
                          param->search_res.srvc_id.uuid.uuid.uuid16, DIS_SERVICE_UUID);
 
+                // The Battery Service is read on this connection as well
+                if (param->search_res.srvc_id.uuid.uuid.uuid16 == BAS_SERVICE_UUID) {
+                    bas_service_start_handle = param->search_res.start_handle;
+                    bas_service_end_handle = param->search_res.end_handle;
+                    ESP_LOGD(TAG, "Battery Service found: start=%d, end=%d",
+                             bas_service_start_handle, bas_service_end_handle);
+                }
+
                 // Check if this is the DIS service
                 if (param->search_res.srvc_id.uuid.uuid.uuid16 == DIS_SERVICE_UUID) {
                     ESP_LOGI(TAG, "Found DIS service (UUID 0x%04x)!", DIS_SERVICE_UUID);
@@ -419,75 +862,16 @@ void ble_device_info_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_
         }
 
         // Process service discovery completion
-        if (dis_service_discovered && param->search_cmpl.conn_id == dis_conn_id) {
+        if (param->search_cmpl.conn_id != dis_conn_id) {
+            break;
+        }
+        if (dis_service_discovered) {
             ESP_LOGI(TAG, "DIS service ready, discovering characteristics...");
+            find_dis_chars();
+        }
+        start_reads();
 
-            // Get all characteristics of the DIS service
-            esp_gattc_char_elem_t char_elem_result[10];
-            uint16_t char_elem_count = 10;
-
-            ESP_LOGD(TAG, "Getting DIS service characteristics - start: %d, end: %d",
-                     dis_service_start_handle, dis_service_end_handle);
-
-            // Use DIS's own GATT interface with its own connection
-            ESP_LOGD(TAG, "Using DIS gattc_if: %d with conn_id: %d", dis_gattc_if, dis_conn_id);
-
-            esp_gatt_status_t status = esp_ble_gattc_get_all_char(
-                dis_gattc_if, dis_conn_id,
-                dis_service_start_handle,
-                dis_service_end_handle,
-                char_elem_result,
-                &char_elem_count,
-                0
-            );
-
-            ESP_LOGI(TAG, "Get characteristics result: status=%d, count=%d", status, char_elem_count);
-
-            if (status == ESP_GATT_OK && char_elem_count > 0) {
-                // ESP_LOGI(TAG, "Found %d characteristics in DIS service", char_elem_count);
-
-                // Look for DIS characteristics by UUID and store handles
-                for (int i = 0; i < char_elem_count; i++) {
-                    if (char_elem_result[i].uuid.len == ESP_UUID_LEN_16) {
-                        uint16_t char_uuid = char_elem_result[i].uuid.uuid.uuid16;
-
-                        // Find which DIS characteristic this is
-                        for (int j = 0; j < 7; j++) {
-                            if (char_uuid == dis_char_uuids[j]) {
-                                dis_char_handles[j] = char_elem_result[i].char_handle;
-                                chars_found_count++;
-                                // ESP_LOGI(TAG, "Found %s characteristic at handle %d",
-                                //          char_names[j], dis_char_handles[j]);
-                                break;
-                            }
-                        }
-                    }
-                }
-
-                // Start reading characteristics
-                if (chars_found_count > 0) {
-                    // ESP_LOGI(TAG, "Starting to read %d DIS characteristics", chars_found_count);
-                    dis_connected = true;
-
-                    // Read first available characteristic
-                    for (int i = 0; i < 7; i++) {
-                        if (dis_char_handles[i] != 0) {
-                            // ESP_LOGI(TAG, "Reading %s...", char_names[i]);
-                            esp_err_t ret = esp_ble_gattc_read_char(dis_gattc_if, dis_conn_id,
-                                                                   dis_char_handles[i], ESP_GATT_AUTH_REQ_NONE);
-                            if (ret != ESP_OK) {
-                                ESP_LOGE(TAG, "Failed to read %s: %s", char_names[i], esp_err_to_name(ret));
-                            }
-                            break; // Only start one read at a time
-                        }
-                    }
-                } else {
-                    ESP_LOGW(TAG, "No DIS characteristics found");
-                }
-            } else {
-                ESP_LOGE(TAG, "Failed to get DIS characteristics: status=%d", status);
-            }
-        } else if (param->search_cmpl.conn_id == dis_conn_id && !dis_service_discovered) {
+        if (!dis_service_discovered) {
             ESP_LOGW(TAG, "DIS service (UUID 0x%04X) not found on this device", DIS_SERVICE_UUID);
             ESP_LOGI(TAG, "This is normal - many BLE HID devices don't implement Device Information Service");
             ESP_LOGI(TAG, "Device info may be available through other means (device name, manufacturer data, etc.)");
@@ -500,74 +884,47 @@ void ble_device_info_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_
             if (dis_config.info_complete_cb) {
                 dis_config.info_complete_cb(&current_device_info);
             }
+        } else if (chars_read_count > 0 && s_dis_pending == 0) {
+            // Every DIS read failed to issue
+            dis_reads_done();
         }
         break;
 
-    case ESP_GATTC_READ_CHAR_EVT:
-        // ESP_LOGI(TAG, "DIS received read response - conn_id: %d, handle: %d, status: %d",
-        //          param->read.conn_id, param->read.handle, param->read.status);
-        if (param->read.status == ESP_GATT_OK) {
-            // Find which characteristic was read
-            for (int i = 0; i < 7; i++) {
-                if (dis_char_handles[i] == param->read.handle) {
-                    chars_read_count++;
-
-                    if (i == 6) { // PnP ID characteristic (binary data)
-                        if (param->read.value_len >= 7) { // PnP ID should be 7 bytes
-                            current_device_info.pnp_id.vendor_id_source = param->read.value[0];
-                            current_device_info.pnp_id.vendor_id = (param->read.value[2] << 8) | param->read.value[1];
-                            current_device_info.pnp_id.product_id = (param->read.value[4] << 8) | param->read.value[3];
-                            current_device_info.pnp_id.product_version = (param->read.value[6] << 8) | param->read.value[5];
-                            current_device_info.has_pnp_id = true;
-
-                            // const char* vendor_source = (current_device_info.pnp_id.vendor_id_source == 0x01) ? "Bluetooth SIG" :
-                            //                            (current_device_info.pnp_id.vendor_id_source == 0x02) ? "USB Forum" : "Unknown";
-                            // ESP_LOGI(TAG, "PnP ID: Source=%s, VID=0x%04X, PID=0x%04X, Ver=0x%04X",
-                            //          vendor_source,
-                            //          current_device_info.pnp_id.vendor_id,
-                            //          current_device_info.pnp_id.product_id,
-                            //          current_device_info.pnp_id.product_version);
-                        } else {
-                            ESP_LOGW(TAG, "PnP ID data too short (%d bytes, expected 7)", param->read.value_len);
-                        }
-                    } else { // String characteristic
-                        // Copy the string data, ensuring null termination
-                        size_t copy_len = (param->read.value_len < (DIS_MAX_STRING_LEN - 1)) ?
-                                          param->read.value_len : (DIS_MAX_STRING_LEN - 1);
-                        memcpy(device_info_strings[i], param->read.value, copy_len);
-                        device_info_strings[i][copy_len] = '\0';
-                        // ESP_LOGI(TAG, "%s: %s", char_names[i], device_info_strings[i]);
-                    }
-
-                    // Start reading next characteristic
-                    bool started_next = false;
-                    for (int j = i + 1; j < 7; j++) {
-                        if (dis_char_handles[j] != 0) {
-                            ESP_LOGD(TAG, "Reading %s...", char_names[j]);
-                            esp_err_t ret = esp_ble_gattc_read_char(dis_gattc_if, param->read.conn_id,
-                                                                   dis_char_handles[j], ESP_GATT_AUTH_REQ_NONE);
-                            if (ret != ESP_OK) {
-                                ESP_LOGE(TAG, "Failed to read %s: %s", char_names[j], esp_err_to_name(ret));
-                            }
-                            started_next = true;
-                            break;
-                        }
-                    }
+    case ESP_GATTC_READ_CHAR_EVT: {
+        int slot = read_slot_for_handle(param->read.handle);
+        if (param->read.conn_id != dis_conn_id || slot < 0) {
+            break;
+        }
+        if (s_read_outstanding > 0) {
+            s_read_outstanding--;
+        }
 
-                    // If no more characteristics to read, check if we're done
-                    if (!started_next) {
-                        check_info_complete();
-                    }
-                    break;
-                }
+        if (param->read.status != ESP_GATT_OK) {
+            ESP_LOGE(TAG, "Failed to read %s: handle=%d, status=%d",
+                     read_slot_name(slot), param->read.handle, param->read.status);
+        } else if (slot == READ_SLOT_BATTERY) {
+            if (param->read.value_len >= 1) {
+                ble_bas_handle_level(param->read.value[0]);
+                connection_timing_mark(CONNECTION_TIMING_BAS_READY);
             }
+        } else if (s_validating && slot == DIS_SLOT_FIRMWARE) {
+            validate_firmware(param->read.value, param->read.value_len);
         } else {
-            ESP_LOGE(TAG, "Failed to read DIS characteristic: handle=%d, status=%d",
-                     param->read.handle, param->read.status);
-            chars_read_count++; // Count failed reads too
-            check_info_complete();
+            store_dis_value(slot, param->read.value, param->read.value_len);
+        }
+
+        // Failed reads count as answered too
+        bool dis_answer = slot < DIS_CHAR_COUNT;
+        if (dis_answer) {
+            chars_read_count++;
+            s_dis_pending--;
+        }
+        read_queue_run();
+        if (dis_answer && s_dis_pending == 0) {
+            dis_reads_done();
         }
         break;
+    }
 
     case ESP_GATTC_DISCONNECT_EVT:
         if (param->disconnect.conn_id == dis_conn_id) {
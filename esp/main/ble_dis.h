@@ -66,6 +66,10 @@ esp_err_t ble_device_info_init(const ble_device_info_config_t *config);
 /**
  * @brief Start device info discovery for DIS on a connected device
  *
+ * Info cached for this device's address is served at once; only its
+ * firmware revision is then read, and everything else is read again only
+ * when that changed. The battery level is read on the same connection.
+ *
  * @param gattc_if GATT client interface to use
  * @param conn_id Connection ID of the connected device
  * @param server_bda BD address of the connected device
@@ -107,6 +111,14 @@ void ble_device_info_print(const ble_device_info_t *device_info);
  */
 bool ble_device_info_has_cached_firmware(void);
 
+/**
+ * @brief Drop the saved device info of one device (call when its bond is
+ *        dropped); the NVS entry is erased by the persist task
+ *
+ * @param bda BD address of the device
+ */
+void ble_device_info_forget(const esp_bd_addr_t bda);
+
 /**
  * @brief Clear saved device info from NVS (call when bonds are cleared)
  *
@@ -4,6 +4,8 @@
 #include "esp_hid_common.h"
 #include "string.h"
 
+#include "link_state.h"
+
 static const char *TAG = "BLE_HID";
 
 // Client state and callbacks
@@ -81,6 +83,7 @@ void ble_hid_client_handle_event(void *handler_args, esp_event_base_t base, int3
             // Update state
             s_active_dev = param->open.dev;
             s_connected = true;
+            link_state_set_ready(LINK_STATE_HID, LINK_STATE_HID);
 
             // Notify transport layer via callback
             if (s_config.connected_cb && bda) {
@@ -130,6 +133,7 @@ void ble_hid_client_handle_event(void *handler_args, esp_event_base_t base, int3
         if (param->close.dev == s_active_dev) {
             s_active_dev = NULL;
             s_connected = false;
+            link_state_set_ready(LINK_STATE_HID, 0);
         }
 
         // Notify transport layer via callback
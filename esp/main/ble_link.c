@@ -0,0 +1,200 @@
+#include "ble_link.h"
+
+#include <string.h>
+#include <sys/param.h>
+
+#include "esp_bt.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "tuning_profile.h"
+#include "tx_power.h"
+
+static const char *TAG = "BLE_LINK";
+
+// Largest LL PDU payload allowed by Data Length Extension
+#define LINK_MAX_TX_OCTETS 251
+
+// No connection handle
+#define LINK_HANDLE_NONE 0xFFFF
+
+#if CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE
+// The controller's connection levels run from -24 dBm in 3 dB steps
+#define LINK_TX_POWER_FLOOR_DBM (-24)
+#define LINK_TX_POWER_STEP_DB 3
+#endif
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static ble_link_info_t s_info;
+static uint16_t s_conn_handle = LINK_HANDLE_NONE;
+
+void ble_link_init(void)
+{
+#if CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE
+    const struct tx_power_config config = {
+        .min_dbm = CONFIG_MOUTHPAD_TX_POWER_MIN_DBM,
+        .max_dbm = CONFIG_MOUTHPAD_TX_POWER_MAX_DBM,
+        .target_dbm = CONFIG_MOUTHPAD_TX_POWER_TARGET_DBM,
+        .margin_db = CONFIG_MOUTHPAD_TX_POWER_MARGIN_DB,
+        .step_db = CONFIG_MOUTHPAD_TX_POWER_STEP_DB,
+        .peer_tx_dbm = CONFIG_MOUTHPAD_TX_POWER_PEER_DBM,
+    };
+
+    tx_power_init(&config);
+#endif
+}
+
+#if CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE
+// Apply the lowest controller level at or above dbm; returns the level set
+static esp_err_t set_tx_power(uint16_t handle, int8_t dbm, int8_t *selected)
+{
+    int index = (dbm - LINK_TX_POWER_FLOOR_DBM + LINK_TX_POWER_STEP_DB - 1) / LINK_TX_POWER_STEP_DB;
+
+    if (index < ESP_PWR_LVL_N24) {
+        index = ESP_PWR_LVL_N24;
+    } else if (index > ESP_PWR_LVL_P20) {
+        index = ESP_PWR_LVL_P20;
+    }
+
+    esp_err_t err = esp_ble_tx_power_set_enhanced(ESP_BLE_ENHANCED_PWR_TYPE_CONN, handle,
+                                                  (esp_power_level_t)index);
+    if (err == ESP_OK) {
+        *selected = (int8_t)MIN(LINK_TX_POWER_FLOOR_DBM + index * LINK_TX_POWER_STEP_DB, 20);
+    }
+    return err;
+}
+#endif
+
+void ble_link_connected(uint16_t conn_handle)
+{
+    taskENTER_CRITICAL(&s_lock);
+    s_conn_handle = conn_handle;
+    taskEXIT_CRITICAL(&s_lock);
+
+#if CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE
+    int8_t selected;
+    esp_err_t err = set_tx_power(conn_handle, tx_power_connected(), &selected);
+
+    if (err == ESP_OK) {
+        tx_power_applied(selected);
+    } else {
+        ESP_LOGW(TAG, "Failed to set connection TX power: %s", esp_err_to_name(err));
+    }
+#endif
+}
+
+void ble_link_rssi(int8_t rssi, bool at_risk)
+{
+#if CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE
+    struct tx_power_status status;
+    uint16_t handle;
+
+    taskENTER_CRITICAL(&s_lock);
+    handle = s_conn_handle;
+    taskEXIT_CRITICAL(&s_lock);
+    if (handle == LINK_HANDLE_NONE) {
+        return;
+    }
+
+    tx_power_set_target(tuning_profile_get(
+        mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_TX_POWER_TARGET));
+    tx_power_get_status(&status);
+    int8_t want = at_risk ? CONFIG_MOUTHPAD_TX_POWER_MAX_DBM : tx_power_update(rssi);
+    if (want == status.level_dbm) {
+        return;
+    }
+
+    int8_t selected;
+    esp_err_t err = set_tx_power(handle, want, &selected);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set TX power %d dBm: %s", want, esp_err_to_name(err));
+        return;
+    }
+    tx_power_applied(selected);
+    ESP_LOGI(TAG, "TX power %+d -> %+d dBm (RSSI %d dBm)", status.level_dbm, selected, rssi);
+#else
+    (void)rssi;
+    (void)at_risk;
+#endif
+}
+
+void ble_link_upgrade(const uint8_t *bda)
+{
+    esp_bd_addr_t addr;
+    memcpy(addr, bda, sizeof(addr));
+
+    ble_link_reset();
+
+#if CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+    // Prefer 2M in both directions; the link stays on 1M if the peer refuses
+    esp_err_t ret = esp_ble_gap_set_preferred_phy(addr, 0, ESP_BLE_GAP_PHY_2M_PREF_MASK,
+                                                  ESP_BLE_GAP_PHY_2M_PREF_MASK,
+                                                  ESP_BLE_GAP_PHY_OPTIONS_NO_PREF);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to request 2M PHY: %s", esp_err_to_name(ret));
+    }
+#endif
+
+    esp_err_t dle_ret = esp_ble_gap_set_pkt_data_len(addr, LINK_MAX_TX_OCTETS);
+    if (dle_ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to request %d-byte data length: %s", LINK_MAX_TX_OCTETS,
+                 esp_err_to_name(dle_ret));
+    } else {
+        ESP_LOGI(TAG, "Requested 2M PHY and %d-byte data length", LINK_MAX_TX_OCTETS);
+    }
+}
+
+void ble_link_handle_gap_event(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
+{
+    switch (event) {
+#if CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+    case ESP_GAP_BLE_PHY_UPDATE_COMPLETE_EVT:
+        if (param->phy_update.status != ESP_BT_STATUS_SUCCESS) {
+            ESP_LOGW(TAG, "PHY update failed: 0x%x", param->phy_update.status);
+            break;
+        }
+        taskENTER_CRITICAL(&s_lock);
+        s_info.tx_phy = param->phy_update.tx_phy;
+        s_info.rx_phy = param->phy_update.rx_phy;
+        taskEXIT_CRITICAL(&s_lock);
+        ESP_LOGI(TAG, "PHY updated: tx=%u rx=%u", param->phy_update.tx_phy,
+                 param->phy_update.rx_phy);
+        break;
+#endif
+    case ESP_GAP_BLE_SET_PKT_LENGTH_COMPLETE_EVT:
+        if (param->pkt_data_length_cmpl.status != ESP_BT_STATUS_SUCCESS) {
+            ESP_LOGW(TAG, "Data length update failed: 0x%x", param->pkt_data_length_cmpl.status);
+            break;
+        }
+        taskENTER_CRITICAL(&s_lock);
+        s_info.tx_octets = param->pkt_data_length_cmpl.params.tx_len;
+        s_info.rx_octets = param->pkt_data_length_cmpl.params.rx_len;
+        taskEXIT_CRITICAL(&s_lock);
+        ESP_LOGI(TAG, "Data length updated: tx=%u rx=%u", param->pkt_data_length_cmpl.params.tx_len,
+                 param->pkt_data_length_cmpl.params.rx_len);
+        break;
+    case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
+        if (param->update_conn_params.status == ESP_BT_STATUS_SUCCESS) {
+            taskENTER_CRITICAL(&s_lock);
+            s_info.interval_us = param->update_conn_params.conn_int * 1250U;
+            taskEXIT_CRITICAL(&s_lock);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void ble_link_reset(void)
+{
+    taskENTER_CRITICAL(&s_lock);
+    memset(&s_info, 0, sizeof(s_info));
+    s_conn_handle = LINK_HANDLE_NONE;
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+void ble_link_get_info(ble_link_info_t *info)
+{
+    taskENTER_CRITICAL(&s_lock);
+    *info = s_info;
+    taskEXIT_CRITICAL(&s_lock);
+}
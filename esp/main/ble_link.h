@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_gap_ble_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Negotiated link layer settings; PHYs use HCI codes (1 = 1M, 2 = 2M,
+// 3 = Coded) and 0 means not reported yet
+typedef struct {
+    uint8_t tx_phy;
+    uint8_t rx_phy;
+    uint16_t tx_octets;
+    uint16_t rx_octets;
+    uint32_t interval_us; // Connection interval from the last parameter update
+} ble_link_info_t;
+
+// Set up the TX power controller (common/tx_power.h); call once at boot
+void ble_link_init(void);
+
+// Request 2M PHY and 251-byte LL PDUs on a new connection
+void ble_link_upgrade(const uint8_t *bda);
+
+// HCI handle of the MouthPad connection, from ESP_GATTC_CONNECT_EVT; the
+// connection starts at CONFIG_MOUTHPAD_TX_POWER_MAX_DBM
+void ble_link_connected(uint16_t conn_handle);
+
+// Feed an RSSI reading of the MouthPad connection; lowers the connection's
+// TX power while the MouthPad would still receive more than
+// CONFIG_MOUTHPAD_TX_POWER_TARGET_DBM, and raises it at once when it would not.
+// While at_risk (link_guard.h) the power is held at the maximum.
+void ble_link_rssi(int8_t rssi, bool at_risk);
+
+// Feed GAP events; picks up the PHY and data length results
+void ble_link_handle_gap_event(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param);
+
+// Forget the negotiated settings; call on disconnect
+void ble_link_reset(void);
+
+void ble_link_get_info(ble_link_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,11 +5,24 @@
 #include "esp_bt_defs.h"
 #include "esp_bt_main.h"
 #include "esp_gatt_common_api.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "string.h"
+#include <stdatomic.h>
+#include <sys/param.h>
+#include "activity.h"
+#include "fault_inject.h"
+#include "mem_stats.h"
+#include "nus_stream.h"
 #include "relay_protocol.h"
+#include "probe.h"
+#include "sensor_stream.h"
+#include "sysview.h"
+#include "task_config.h"
+#include "trace_ring.h"
 
 static const char *TAG = "BLE_NUS";
 
@@ -21,11 +34,13 @@ static bool nus_connected = false;
 static bool nus_service_discovered = false;
 static bool nus_tx_notify_enabled = false;
 static bool nus_connection_ready = false;  // Set when GAP conn params updated
+static uint16_t nus_mtu = ESP_GATT_DEF_BLE_MTU_SIZE;  // ATT MTU of the NUS connection
 
 // Service and characteristic handles
 static esp_gatt_id_t nus_service_handle = {0};
 static uint16_t nus_char_tx_handle = 0;   // Handle for TX characteristic (notifications from server)
 static uint16_t nus_char_rx_handle = 0;   // Handle for RX characteristic (write to server)
+static bool nus_rx_write_nr = false;      // RX characteristic accepts write-without-response
 static uint16_t nus_cccd_handle = 0;      // Handle for CCCD descriptor
 static uint16_t nus_service_start_handle = 0;  // Start handle of NUS service
 static uint16_t nus_service_end_handle = 0;    // End handle of NUS service
@@ -34,21 +49,55 @@ static uint16_t nus_service_end_handle = 0;    // End handle of NUS service
 // Configuration callbacks
 static ble_nus_client_config_t nus_config = {0};
 
-// Queue for sending data
-static QueueHandle_t nus_tx_queue = NULL;
+// Writes waiting for the TX task. Pass-through, echo and other control
+// writes go out ahead of any queued bulk write (stream writes and
+// pass-through payloads longer than one write), so a host command waits for
+// at most the write in hand rather than the whole backlog. Each class keeps
+// its order, and a control write never goes between the segments of one
+// payload.
+static QueueHandle_t nus_tx_control_queue = NULL;
+static QueueHandle_t nus_tx_bulk_queue = NULL;
+
+// Given on each NUS RX write response; writes go out one at a time
+static SemaphoreHandle_t nus_write_done = NULL;
+static volatile esp_err_t nus_write_status = ESP_OK;
+
+// Set while the stack reports the link congested (ESP_GATTC_CONGEST_EVT)
+static volatile bool nus_congested = false;
 
 // Flag to trigger CCCD write from dedicated task
 static volatile bool cccd_write_pending = false;
 
+// CCCD task, notified when discovery or the conn param update completes
+static TaskHandle_t nus_cccd_task_handle = NULL;
+
+// When the NUS GATT connection opened, for the time-to-ready log
+static int64_t nus_open_us = 0;
+
 // Data structure for TX queue
 typedef struct {
     uint8_t data[NUS_MAX_DATA_LEN];
+    const uint8_t *payload;  // Caller's buffer when too long to copy, else NULL
     uint16_t len;
+    bool pass_through;  // Acknowledge to the host once written
+    struct pass_through_ack_tag ack;  // How, for a pass-through write
+    bool reliable;      // Write request rather than write-without-response
+    bool echo;          // Timed for an EchoRequest instead
+    bool stream;        // Bulk stream write (nus_stream.h); with len 0 only runs the pump
 } nus_tx_data_t;
 
+static TaskHandle_t nus_tx_task_handle = NULL;
+
+// Set when nus_stream wants its pump run; the TX task runs it after the item
+// in hand, and a kick from elsewhere notifies the task to wake it
+static atomic_bool stream_pump_due = false;
+
 // Task for handling TX data
 static void nus_tx_task(void *pvParameters);
 
+// nus_stream hooks, defined with the write functions
+static const struct nus_stream_ops stream_ops;
+
 // Task for handling CCCD write
 static void nus_cccd_task(void *pvParameters);
 
@@ -62,22 +111,35 @@ esp_err_t ble_nus_client_init(const ble_nus_client_config_t *config)
     // Store configuration
     memcpy(&nus_config, config, sizeof(ble_nus_client_config_t));
 
-    // Create TX queue
-    nus_tx_queue = xQueueCreate(5, sizeof(nus_tx_data_t));
-    if (nus_tx_queue == NULL) {
+    // Create TX queues
+    nus_tx_control_queue = xQueueCreate(NUS_TX_QUEUE_LEN, sizeof(nus_tx_data_t));
+    nus_tx_bulk_queue = xQueueCreate(NUS_TX_QUEUE_LEN, sizeof(nus_tx_data_t));
+    if (nus_tx_control_queue == NULL || nus_tx_bulk_queue == NULL) {
         ESP_LOGE(TAG, "Failed to create TX queue");
         return ESP_ERR_NO_MEM;
     }
 
+    nus_write_done = xSemaphoreCreateBinary();
+    if (nus_write_done == NULL) {
+        ESP_LOGE(TAG, "Failed to create write semaphore");
+        return ESP_ERR_NO_MEM;
+    }
+
     // Create TX task
-    BaseType_t task_ret = xTaskCreate(nus_tx_task, "nus_tx", 4096, NULL, 5, NULL);
+    BaseType_t task_ret = xTaskCreatePinnedToCore(nus_tx_task, "nus_tx", TASK_NUS_TX_STACK_SIZE, NULL,
+                                                  TASK_NUS_TX_PRIORITY, &nus_tx_task_handle,
+                                                  TASK_NUS_TX_CORE_ID);
     if (task_ret != pdPASS) {
         ESP_LOGE(TAG, "Failed to create TX task");
         return ESP_ERR_NO_MEM;
     }
 
+    nus_stream_init(&stream_ops);
+
     // Create CCCD task for deferred CCCD write operations
-    task_ret = xTaskCreate(nus_cccd_task, "nus_cccd", 4096, NULL, 5, NULL);
+    task_ret = xTaskCreatePinnedToCore(nus_cccd_task, "nus_cccd", TASK_NUS_CCCD_STACK_SIZE, NULL,
+                                       TASK_NUS_CCCD_PRIORITY, &nus_cccd_task_handle,
+                                       TASK_NUS_CCCD_CORE_ID);
     if (task_ret != pdPASS) {
         ESP_LOGE(TAG, "Failed to create CCCD task");
         return ESP_ERR_NO_MEM;
@@ -134,8 +196,13 @@ esp_err_t ble_nus_client_discover_services(esp_gatt_if_t gattc_if, uint16_t conn
     return ESP_OK;
 }
 
-esp_err_t ble_nus_client_send_data(const uint8_t *data, uint16_t len)
+// ack is NULL unless the write is a host pass-through
+static esp_err_t queue_write(const uint8_t *data, uint16_t len,
+                             const struct pass_through_ack_tag *ack, bool reliable,
+                             bool echo, bool stream, TickType_t wait)
 {
+    bool pass_through = ack != NULL;
+
     if (data == NULL || len == 0) {
         ESP_LOGE(TAG, "Invalid data or length");
         return ESP_ERR_INVALID_ARG;
@@ -149,23 +216,126 @@ esp_err_t ble_nus_client_send_data(const uint8_t *data, uint16_t len)
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (len > NUS_MAX_DATA_LEN) {
+    // Only pass-through payloads may be sent by reference
+    if (len > NUS_MAX_DATA_LEN && !pass_through) {
         ESP_LOGE(TAG, "Data length %d exceeds maximum %d", len, NUS_MAX_DATA_LEN);
         return ESP_ERR_INVALID_ARG;
     }
 
     nus_tx_data_t tx_data;
-    memcpy(tx_data.data, data, len);
+    if (len > NUS_MAX_DATA_LEN) {
+        tx_data.payload = data;
+    } else {
+        tx_data.payload = NULL;
+        memcpy(tx_data.data, data, len);
+    }
     tx_data.len = len;
+    tx_data.pass_through = pass_through;
+    if (pass_through) {
+        tx_data.ack = *ack;
+    }
+    tx_data.reliable = reliable;
+    tx_data.echo = echo;
+    tx_data.stream = stream;
 
-    BaseType_t ret = xQueueSend(nus_tx_queue, &tx_data, pdMS_TO_TICKS(100));
+    bool bulk = stream || len > NUS_MAX_DATA_LEN;
+    BaseType_t ret = xQueueSend(bulk ? nus_tx_bulk_queue : nus_tx_control_queue, &tx_data, wait);
+    mem_stats_take(MEM_SITE_NUS_TX, ret == pdTRUE, ble_nus_client_tx_pending());
     if (ret != pdTRUE) {
         ESP_LOGE(TAG, "Failed to queue TX data");
         return ESP_ERR_TIMEOUT;
     }
+    // Counted by the task, so a write queued while it is busy is not missed
+    xTaskNotifyGive(nus_tx_task_handle);
+    activity_mark();
     return ESP_OK;
 }
 
+esp_err_t ble_nus_client_send_data(const uint8_t *data, uint16_t len)
+{
+    return queue_write(data, len, NULL, true, false, false, pdMS_TO_TICKS(100));
+}
+
+esp_err_t ble_nus_client_send_pass_through(const uint8_t *data, uint16_t len, bool reliable,
+                                           struct pass_through_ack_tag ack)
+{
+    // The host keeps within its credits, so a full queue is its error;
+    // never stall the USB RX path waiting for room
+    return queue_write(data, len, &ack, reliable, false, false, 0);
+}
+
+esp_err_t ble_nus_client_send_echo(const uint8_t *data, uint16_t len)
+{
+    return queue_write(data, len, NULL, true, true, false, 0);
+}
+
+// nus_stream hooks: the pump runs in the TX task and feeds its own queue
+
+static uint16_t stream_packet_size(void)
+{
+    if (!ble_nus_client_is_ready()) {
+        return 0;
+    }
+    return MIN(nus_mtu - 3, NUS_MAX_DATA_LEN);
+}
+
+static int stream_write(const uint8_t *data, size_t len)
+{
+    // Copied into the queue entry, and never waits: the TX task is the caller
+    esp_err_t ret = queue_write(data, len, NULL, false, false, true, 0);
+
+    if (ret == ESP_ERR_TIMEOUT) {
+        return 1;
+    }
+    return ret == ESP_OK ? 0 : -1;
+}
+
+static void stream_send_status(const mouthware_message_NusStreamStatus *status)
+{
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_nus_stream_status_tag;
+    relay_msg.message_body.nus_stream_status = *status;
+    relay_protocol_send_response(&relay_msg);
+}
+
+static void stream_kick(void)
+{
+    if (atomic_exchange(&stream_pump_due, true) ||
+        xTaskGetCurrentTaskHandle() == nus_tx_task_handle) {
+        return;
+    }
+
+    xTaskNotifyGive(nus_tx_task_handle);
+}
+
+static const struct nus_stream_ops stream_ops = {
+    .packet_size = stream_packet_size,
+    .write = stream_write,
+    .send_status = stream_send_status,
+    .kick = stream_kick,
+};
+
+_Static_assert(NUS_STREAM_PACKET_MAX >= NUS_MAX_DATA_LEN, "A full NUS write does not fit a stream packet");
+
+uint8_t ble_nus_client_tx_window(void)
+{
+    return NUS_TX_QUEUE_LEN + 1;
+}
+
+uint8_t ble_nus_client_tx_pending(void)
+{
+    if (!nus_tx_control_queue || !nus_tx_bulk_queue) {
+        return 0;
+    }
+    return uxQueueMessagesWaiting(nus_tx_control_queue) + uxQueueMessagesWaiting(nus_tx_bulk_queue);
+}
+
+size_t ble_nus_client_tx_slot_size(void)
+{
+    return sizeof(nus_tx_data_t);
+}
+
 bool ble_nus_client_is_ready(void)
 {
     return nus_connected && nus_service_discovered && nus_tx_notify_enabled;
@@ -192,10 +362,13 @@ void ble_nus_client_debug_status(void)
     ESP_LOGI(TAG, "TX notifications enabled: %s", nus_tx_notify_enabled ? "YES" : "NO");
     ESP_LOGI(TAG, "Connection ready: %s", nus_connection_ready ? "YES" : "NO");
     ESP_LOGI(TAG, "Connection ID: %d", nus_conn_id);
+    ESP_LOGI(TAG, "ATT MTU: %d", nus_mtu);
     ESP_LOGI(TAG, "GATT interface: %d", nus_gattc_if);
     ESP_LOGI(TAG, "Service range: %d-%d", nus_service_start_handle, nus_service_end_handle);
     ESP_LOGI(TAG, "TX handle (notifications FROM device): %d", nus_char_tx_handle);
     ESP_LOGI(TAG, "RX handle (write TO device): %d", nus_char_rx_handle);
+    ESP_LOGI(TAG, "RX write-without-response: %s", nus_rx_write_nr ? "YES" : "NO");
+    ESP_LOGI(TAG, "Link congested: %s", nus_congested ? "YES" : "NO");
     ESP_LOGI(TAG, "Server BD address: %02x:%02x:%02x:%02x:%02x:%02x",
              nus_server_bda[0], nus_server_bda[1], nus_server_bda[2],
              nus_server_bda[3], nus_server_bda[4], nus_server_bda[5]);
@@ -205,6 +378,7 @@ void ble_nus_client_connection_ready(void)
 {
     ESP_LOGI(TAG, "Connection params updated - connection now stable");
     nus_connection_ready = true;
+    xTaskNotifyGive(nus_cccd_task_handle);
 }
 
 void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp_ble_gattc_cb_param_t *param)
@@ -227,8 +401,17 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
                  param->open.conn_id, param->open.status);
 
         if (param->open.status == ESP_GATT_OK && param->open.conn_id == nus_conn_id) {
+            nus_open_us = esp_timer_get_time();
+            nus_mtu = param->open.mtu;
+
+            // Larger writes need fewer ATT packets; the result arrives in CFG_MTU_EVT
+            esp_err_t ret = esp_ble_gattc_send_mtu_req(nus_gattc_if, nus_conn_id);
+            if (ret != ESP_OK) {
+                ESP_LOGW(TAG, "Failed to request MTU exchange: %s", esp_err_to_name(ret));
+            }
+
             ESP_LOGI(TAG, "Starting service discovery on opened NUS GATT connection");
-            esp_err_t ret = esp_ble_gattc_search_service(nus_gattc_if, nus_conn_id, NULL);
+            ret = esp_ble_gattc_search_service(nus_gattc_if, nus_conn_id, NULL);
             if (ret != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to start service discovery: %s", esp_err_to_name(ret));
             }
@@ -242,11 +425,27 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
                  param->disconnect.conn_id, param->disconnect.reason);
 
         if (param->disconnect.conn_id == nus_conn_id) {
+            trace_ring_record(TRACE_EVENT_DISCONNECTED, param->disconnect.reason, 0);
             nus_connected = false;
             nus_service_discovered = false;
             nus_tx_notify_enabled = false;
             nus_connection_ready = false;
+            nus_congested = false;
+            nus_mtu = ESP_GATT_DEF_BLE_MTU_SIZE;
             nus_conn_id = 0xFFFF;
+            sensor_stream_sequence_reset(0);
+
+            // Drop queued writes and release a write waiting for its response;
+            // the stream counts its dropped writes as failed
+            nus_tx_data_t dropped;
+            xQueueReset(nus_tx_control_queue);
+            while (xQueueReceive(nus_tx_bulk_queue, &dropped, 0) == pdTRUE) {
+                if (dropped.stream) {
+                    nus_stream_sent(false);
+                }
+            }
+            nus_write_status = ESP_FAIL;
+            xSemaphoreGive(nus_write_done);
 
             if (nus_config.disconnected_cb) {
                 nus_config.disconnected_cb();
@@ -333,7 +532,9 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
                         // Check for WRITE property - this is where we send data TO the device
                         if (char_elem_result[i].properties & (ESP_GATT_CHAR_PROP_BIT_WRITE | ESP_GATT_CHAR_PROP_BIT_WRITE_NR)) {
                             nus_char_rx_handle = char_elem_result[i].char_handle;
-                            ESP_LOGI(TAG, "Found NUS RX characteristic (WRITE) at handle %d", nus_char_rx_handle);
+                            nus_rx_write_nr = (char_elem_result[i].properties & ESP_GATT_CHAR_PROP_BIT_WRITE_NR) != 0;
+                            ESP_LOGI(TAG, "Found NUS RX characteristic (WRITE%s) at handle %d",
+                                     nus_rx_write_nr ? ", WRITE_NR" : "", nus_char_rx_handle);
                         }
                     } else {
                         ESP_LOGI(TAG, "Characteristic has 16-bit UUID: 0x%04x", char_elem_result[i].uuid.uuid.uuid16);
@@ -347,6 +548,7 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
                     // Signal CCCD task to write CCCD descriptor
                     ESP_LOGI(TAG, "Signaling CCCD task to enable notifications");
                     cccd_write_pending = true;
+                    xTaskNotifyGive(nus_cccd_task_handle);
 
                     nus_connected = true;  // Service is fully discovered
                 } else {
@@ -369,11 +571,16 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
             param->notify.handle == nus_char_tx_handle) {
             // NUS TX characteristic notification - forward to relay protocol
             ESP_LOGD(TAG, "NUS data received: %d bytes", param->notify.value_len);
+            activity_mark();
 
-            esp_err_t ret = relay_protocol_handle_ble_data(param->notify.value, param->notify.value_len);
-            if (ret != ESP_OK) {
-                ESP_LOGW(TAG, "Failed to process BLE data: %s", esp_err_to_name(ret));
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+            if (fault_inject_notification(FAULT_INJECT_NUS)) {
+                break;
             }
+#endif
+
+            // Only copied to the nus_rx task here; a full queue is counted there
+            (void)relay_protocol_handle_ble_data(param->notify.value, param->notify.value_len);
         } else {
             ESP_LOGD(TAG, "Notification from handle %d (not NUS TX %d)",
                      param->notify.handle, nus_char_tx_handle);
@@ -389,16 +596,30 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
                 ESP_LOGE(TAG, "NUS write failed: status=%d", param->write.status);
             }
 
+            nus_write_status = param->write.status == ESP_GATT_OK ? ESP_OK : ESP_FAIL;
+            xSemaphoreGive(nus_write_done);
+
             if (nus_config.data_sent_cb) {
                 nus_config.data_sent_cb(param->write.status == ESP_GATT_OK ? ESP_OK : ESP_FAIL);
             }
         }
         break;
 
+    case ESP_GATTC_CONGEST_EVT:
+        if (param->congest.conn_id == nus_conn_id) {
+            ESP_LOGD(TAG, "Link %s", param->congest.congested ? "congested" : "uncongested");
+            nus_congested = param->congest.congested;
+        }
+        break;
+
     case ESP_GATTC_CFG_MTU_EVT:
         ESP_LOGI(TAG, "=== MTU CONFIGURED ===");
         ESP_LOGI(TAG, "conn_id: %d, status: %d, mtu: %d",
                  param->cfg_mtu.conn_id, param->cfg_mtu.status, param->cfg_mtu.mtu);
+
+        if (param->cfg_mtu.conn_id == nus_conn_id && param->cfg_mtu.status == ESP_GATT_OK) {
+            nus_mtu = param->cfg_mtu.mtu;
+        }
         break;
 
     case ESP_GATTC_WRITE_DESCR_EVT:
@@ -420,6 +641,9 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
                     ESP_LOGI(TAG, "Notification handler registered");
                     nus_tx_notify_enabled = true;
 
+                    ESP_LOGI(TAG, "NUS ready %lld ms after GATT open",
+                             (esp_timer_get_time() - nus_open_us) / 1000);
+
                     // NUS is now fully ready - notify via callback
                     if (nus_config.ready_cb) {
                         ESP_LOGI(TAG, "NUS service is now ready, invoking ready callback");
@@ -444,41 +668,124 @@ void ble_nus_client_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t
     }
 }
 
+// A write-without-response is only accepted while the controller has a
+// free ACL buffer; otherwise the stack drops it. Poll for one, giving up
+// after NUS_TX_BUFFER_WAIT_MS or on disconnect.
+static bool wait_for_tx_buffer(void)
+{
+    TickType_t start = xTaskGetTickCount();
+
+    while (nus_congested || esp_ble_get_cur_sendable_packets_num(nus_conn_id) == 0) {
+        if (!nus_connected || xTaskGetTickCount() - start >= pdMS_TO_TICKS(NUS_TX_BUFFER_WAIT_MS)) {
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+// One ATT write of at most the MTU, completed once its write event arrives.
+// Without a response the event fires once the stack has handed the packet
+// to the controller, so waiting for it costs no round trip and writes
+// pipeline up to the free buffers.
+static esp_err_t write_segment(const uint8_t *data, uint16_t len, bool reliable)
+{
+    if (!nus_connected || !nus_service_discovered || nus_char_rx_handle == 0) {
+        ESP_LOGW(TAG, "NUS client not ready for transmission");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!reliable && !wait_for_tx_buffer()) {
+        ESP_LOGW(TAG, "No free TX buffer after %d ms", NUS_TX_BUFFER_WAIT_MS);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    // Clear a stale response before starting this write
+    xSemaphoreTake(nus_write_done, 0);
+    probe_mark(RELAY_PROBE_NUS_TX);
+    sysview_mark_start(RELAY_MARKER_NUS_TX);
+    esp_err_t ret = esp_ble_gattc_write_char(nus_gattc_if, nus_conn_id, nus_char_rx_handle,
+                                             len, (uint8_t *)data,
+                                             reliable ? ESP_GATT_WRITE_TYPE_RSP : ESP_GATT_WRITE_TYPE_NO_RSP,
+                                             ESP_GATT_AUTH_REQ_NONE);
+    sysview_mark_stop(RELAY_MARKER_NUS_TX);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write NUS RX: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Wait for the response so the queue holds the backlog,
+    // not the GATT client, and completions can be acknowledged
+    if (xSemaphoreTake(nus_write_done, pdMS_TO_TICKS(NUS_WRITE_TIMEOUT_MS)) != pdTRUE) {
+        ESP_LOGW(TAG, "No NUS write response after %d ms", NUS_WRITE_TIMEOUT_MS);
+        return ESP_ERR_TIMEOUT;
+    }
+    return nus_write_status;
+}
+
 static void nus_tx_task(void *pvParameters)
 {
     nus_tx_data_t tx_data;
 
     while (1) {
-        if (xQueueReceive(nus_tx_queue, &tx_data, portMAX_DELAY) == pdTRUE) {
+        // Control writes first; sleep only when both queues are empty and
+        // the stream has nothing due
+        if (xQueueReceive(nus_tx_control_queue, &tx_data, 0) != pdTRUE &&
+            xQueueReceive(nus_tx_bulk_queue, &tx_data, 0) != pdTRUE) {
+            tx_data.len = 0;
+            if (!atomic_load(&stream_pump_due)) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+        }
+
+        if (tx_data.len > 0) {
             ESP_LOGD(TAG, "Sending %d bytes to NUS", tx_data.len);
-            if (nus_connected && nus_service_discovered && nus_char_rx_handle != 0) {
-                esp_err_t ret = esp_ble_gattc_write_char(nus_gattc_if, nus_conn_id, nus_char_rx_handle,
-                                                        tx_data.len, tx_data.data, ESP_GATT_WRITE_TYPE_RSP,
-                                                        ESP_GATT_AUTH_REQ_NONE);
-                if (ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to write NUS RX: %s", esp_err_to_name(ret));
-                }
-            } else {
-                ESP_LOGW(TAG, "NUS client not ready for transmission");
+            const uint8_t *data = tx_data.payload ? tx_data.payload : tx_data.data;
+            bool reliable = tx_data.reliable || !nus_rx_write_nr;
+            int64_t write_us = esp_timer_get_time();
+            esp_err_t ret = ESP_OK;
+
+            // Split into MTU-sized writes; the payload completes with its last one
+            for (uint16_t offset = 0; offset < tx_data.len && ret == ESP_OK; ) {
+                uint16_t segment = MIN(tx_data.len - offset, MIN(nus_mtu - 3, NUS_MAX_WRITE_LEN));
+                ret = write_segment(data + offset, segment, reliable);
+                offset += segment;
             }
+
+            if (tx_data.pass_through) {
+                relay_protocol_pass_through_sent(ret, tx_data.payload, tx_data.ack);
+            } else if (tx_data.echo) {
+                relay_protocol_echo_sent(ret, write_us, esp_timer_get_time());
+            } else if (tx_data.stream) {
+                nus_stream_sent(ret == ESP_OK);
+            }
+        }
+
+        if (atomic_exchange(&stream_pump_due, false)) {
+            nus_stream_pump();
         }
     }
 }
 
 // Dedicated task for CCCD write operations
 // Waits for connection params to be updated (via ble_nus_client_connection_ready)
-// before writing CCCD to ensure BLE stack is stable
+// before writing CCCD to ensure BLE stack is stable. Sleeps until service
+// discovery or the conn param update notifies it, whichever comes second
+// finds both conditions met.
 static void nus_cccd_task(void *pvParameters)
 {
     while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
         // Only write CCCD when:
         // 1. CCCD write is pending (service discovered)
         // 2. Connection params have been updated (connection is stable)
         // 3. TX handle is valid
         if (cccd_write_pending && nus_connection_ready && nus_char_tx_handle != 0) {
-            // Add 100ms delay after connection ready to let stack fully stabilize
             // Connection params event fires, but stack may need a moment to settle
-            vTaskDelay(pdMS_TO_TICKS(100));
+            if (CONFIG_MOUTHPAD_NUS_CCCD_SETTLE_MS > 0) {
+                vTaskDelay(pdMS_TO_TICKS(CONFIG_MOUTHPAD_NUS_CCCD_SETTLE_MS));
+            }
 
             ESP_LOGI(TAG, "CCCD task: Connection stable, preparing CCCD write");
             ESP_LOGI(TAG, "State check - gattc_if: %d, conn_id: %d, tx_handle: %d, connected: %d",
@@ -487,7 +794,6 @@ static void nus_cccd_task(void *pvParameters)
             if (nus_gattc_if == ESP_GATT_IF_NONE || nus_conn_id == 0xFFFF) {
                 ESP_LOGE(TAG, "Invalid GATT state, skipping CCCD write");
                 cccd_write_pending = false;
-                vTaskDelay(pdMS_TO_TICKS(50));
                 continue;
             }
 
@@ -515,7 +821,5 @@ static void nus_cccd_task(void *pvParameters)
 
             cccd_write_pending = false;
         }
-
-        vTaskDelay(pdMS_TO_TICKS(50));  // Check every 50ms
     }
 }
@@ -7,6 +7,9 @@
 #include "esp_bt_main.h"
 #include "esp_gatt_common_api.h"
 #include <stdbool.h>
+#include <stddef.h>
+
+#include "pass_through_ack.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +23,19 @@ extern "C" {
 // Maximum data length for NUS packets
 #define NUS_MAX_DATA_LEN        244  // Leave room for ATT headers
 
+// Largest single NUS write; longer payloads are split into writes of
+// min(MTU - 3, NUS_MAX_WRITE_LEN) bytes
+#define NUS_MAX_WRITE_LEN       512  // ATT attribute value limit
+
+// Writes of each class (control, bulk) that can wait behind the one in flight
+#define NUS_TX_QUEUE_LEN        5
+
+// How long the TX task waits for a write response before moving on
+#define NUS_WRITE_TIMEOUT_MS    1000
+
+// How long an unacknowledged write waits for a free controller buffer
+#define NUS_TX_BUFFER_WAIT_MS   1000
+
 // Callback function types
 typedef void (*ble_nus_client_data_received_cb_t)(const uint8_t *data, uint16_t len);
 typedef void (*ble_nus_client_data_sent_cb_t)(esp_err_t status);
@@ -62,6 +78,54 @@ esp_err_t ble_nus_client_discover_services(esp_gatt_if_t gattc_if, uint16_t conn
  */
 esp_err_t ble_nus_client_send_data(const uint8_t *data, uint16_t len);
 
+/**
+ * @brief Queue a host pass-through write without blocking
+ *
+ * Each write completion is reported to relay_protocol_pass_through_sent()
+ * with ack, which answers the host as ack asks. Unless reliable is set the write goes
+ * out as a write-without-response, so several can share a connection event.
+ *
+ * Payloads are split into MTU-sized writes. Payloads longer than
+ * NUS_MAX_DATA_LEN are not copied: data must stay untouched until its
+ * completion is reported.
+ *
+ * @param data Data to send
+ * @param len Length of data
+ * @param reliable Use an acknowledged write request
+ * @param ack Sequence and ack mode of the host's write
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_TIMEOUT if the queue is full
+ */
+esp_err_t ble_nus_client_send_pass_through(const uint8_t *data, uint16_t len, bool reliable,
+                                           struct pass_through_ack_tag ack);
+
+/**
+ * @brief Queue a timed write for an EchoRequest without blocking
+ *
+ * Sent as an acknowledged write request; its completion is reported to
+ * relay_protocol_echo_sent() with the times the write was issued and its
+ * response arrived. The data is copied.
+ *
+ * @param data Data to send, at most NUS_MAX_DATA_LEN bytes
+ * @param len Length of data
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_TIMEOUT if the queue is full
+ */
+esp_err_t ble_nus_client_send_echo(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Writes that can be outstanding at once: the queue plus the one in flight
+ */
+uint8_t ble_nus_client_tx_window(void);
+
+/**
+ * @brief Writes waiting in the control and bulk queues right now
+ */
+uint8_t ble_nus_client_tx_pending(void);
+
+/**
+ * @brief Bytes per queue entry, for the memory report
+ */
+size_t ble_nus_client_tx_slot_size(void);
+
 /**
  * @brief Check if NUS client is connected and ready
  * 
@@ -29,3 +29,15 @@
     #define BOARD_LCD_BL            GPIO_NUM_15  // Display backlight control
     #define BOARD_PWR_EN            GPIO_NUM_15  // Power enable
 #endif
+
+// GPIO probe pins (CONFIG_MOUTHPAD_PROBE_GPIO), in the order of
+// common/relay_probes.h: HID RX, USB submit, USB done, frame RX, NUS TX
+#if CONFIG_MOUTHPAD_PROBE_GPIO
+#if CONFIG_MOUTHPAD_BOARD_XIAO_ESP32S3
+    // D0, D2, D8, D9, D10, the same header pins as the nRF XIAO
+    #define BOARD_PROBE_GPIOS       {GPIO_NUM_1, GPIO_NUM_3, GPIO_NUM_7, GPIO_NUM_8, GPIO_NUM_9}
+#elif CONFIG_MOUTHPAD_BOARD_LILYGO_T_DISPLAY_S3
+    // Header pins clear of the LCD
+    #define BOARD_PROBE_GPIOS       {GPIO_NUM_1, GPIO_NUM_2, GPIO_NUM_3, GPIO_NUM_16, GPIO_NUM_17}
+#endif
+#endif
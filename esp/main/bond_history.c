@@ -0,0 +1,127 @@
+#include "bond_history.h"
+
+#if CONFIG_MOUTHPAD_LINK_HISTORY
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+
+#include "link_history.h"
+#include "persist.h"
+#include "relay_protocol.h"
+#include "transport_hid.h"
+
+static const char *TAG = "HISTORY";
+
+#define NVS_NAMESPACE "history"
+#define NVS_KEY_BLOB "links"
+
+// link_history_sample() and link_history_save() run in one context: the
+// esp_timer task and the persist task take turns under this
+static SemaphoreHandle_t s_mutex;
+static int s_persist_id = -1;
+static esp_timer_handle_t s_timer;
+
+// Loaded at init, then packed by the flush
+static uint8_t s_blob[LINK_HISTORY_BLOB_MAX];
+
+static void history_changed(void)
+{
+    persist_request(s_persist_id);
+}
+
+// Persist task
+static void history_persist_flush(void)
+{
+    nvs_handle_t nvs_handle;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    size_t len = link_history_save(s_blob, sizeof(s_blob));
+    xSemaphoreGive(s_mutex);
+    if (len == 0) {
+        return;
+    }
+
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS for the link history: %s", esp_err_to_name(ret));
+        return;
+    }
+    ret = nvs_set_blob(nvs_handle, NVS_KEY_BLOB, s_blob, len);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save the link history: %s", esp_err_to_name(ret));
+    }
+}
+
+static void restore(void)
+{
+    size_t len = sizeof(s_blob);
+    nvs_handle_t nvs_handle;
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return;
+    }
+    esp_err_t ret = nvs_get_blob(nvs_handle, NVS_KEY_BLOB, s_blob, &len);
+    nvs_close(nvs_handle);
+    if (ret != ESP_OK) {
+        if (ret != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Saved link history not read: %s", esp_err_to_name(ret));
+        }
+        return;
+    }
+
+    if (link_history_load(s_blob, len)) {
+        ESP_LOGI(TAG, "Loaded %u byte link history", (unsigned int)len);
+    } else {
+        ESP_LOGW(TAG, "Saved link history not recognized (%u bytes), dropped", (unsigned int)len);
+    }
+}
+
+// esp_timer task
+static void sample_timer_callback(void *arg)
+{
+    (void)arg;
+    struct link_telemetry_sample sample;
+    uint8_t addr[6];
+
+    relay_protocol_telemetry_sample(&sample);
+    bool have_addr = sample.connected && transport_hid_get_active_address(addr) == ESP_OK;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    link_history_sample(&sample, have_addr ? addr : NULL);
+    xSemaphoreGive(s_mutex);
+}
+
+esp_err_t bond_history_init(void)
+{
+    const esp_timer_create_args_t args = {
+        .callback = sample_timer_callback,
+        .name = "history",
+    };
+
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_persist_id = persist_register(history_persist_flush);
+    if (s_persist_id < 0) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    link_history_init(history_changed);
+    restore();
+
+    esp_err_t ret = esp_timer_create(&args, &s_timer);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return esp_timer_start_periodic(s_timer, (uint64_t)LINK_HISTORY_SAMPLE_MS * 1000);
+}
+
+#endif // CONFIG_MOUTHPAD_LINK_HISTORY
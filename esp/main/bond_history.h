@@ -0,0 +1,30 @@
+#pragma once
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hourly link history per MouthPad (common/link_history.h). The link is
+// sampled from an esp_timer every LINK_HISTORY_SAMPLE_MS, from the same
+// counters as LinkTelemetry. The history is kept in NVS as one blob and
+// written by the persist task when a bucket closes and when the MouthPad
+// drops. Read by the "history" console command and LinkHistoryRead on CDC0.
+
+#if CONFIG_MOUTHPAD_LINK_HISTORY
+
+// After persist_init() and transport_hid_init(); loads the saved history
+// and starts sampling
+esp_err_t bond_history_init(void);
+
+#else
+
+static inline esp_err_t bond_history_init(void) { return ESP_ERR_NOT_SUPPORTED; }
+
+#endif // CONFIG_MOUTHPAD_LINK_HISTORY
+
+#ifdef __cplusplus
+}
+#endif
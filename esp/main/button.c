@@ -1,5 +1,6 @@
 #include "button.h"
 #include "board_config.h"
+#include "task_config.h"
 #include "driver/gpio.h"
 #include "esp_timer.h"
 #include "esp_log.h"
@@ -24,7 +25,7 @@ typedef struct {
     bool was_pressed;
     uint32_t press_start_time;
     uint32_t last_release_time;
-    bool pending_single_click;
+    uint8_t clicks;  // Short presses waiting out BUTTON_DOUBLE_CLICK_TIME_MS
     esp_timer_handle_t double_click_timer;
     esp_timer_handle_t long_press_timer;
     button_event_callback_t callback;
@@ -126,7 +127,8 @@ esp_err_t button_init(button_event_callback_t callback)
     }
 
     // Create button processing task with lower priority to avoid watchdog issues
-    BaseType_t task_ret = xTaskCreate(button_task, "button_task", 3072, NULL, 3, NULL);
+    BaseType_t task_ret = xTaskCreatePinnedToCore(button_task, "button_task", TASK_BUTTON_STACK_SIZE, NULL,
+                                                  TASK_BUTTON_PRIORITY, NULL, TASK_BUTTON_CORE_ID);
     if (task_ret != pdPASS) {
         ESP_LOGE(TAG, "Failed to create button task");
         gpio_isr_handler_remove(BUTTON_GPIO_PIN);
@@ -220,22 +222,24 @@ static void button_task(void *arg)
                         uint32_t press_duration = button_get_time_ms() - s_button_state.press_start_time;
 
                         if (press_duration < BUTTON_LONG_PRESS_TIME_MS) {
-                            // Short press - check for double-click
+                            // Short press - count it towards a double or triple click
                             uint32_t time_since_last_release = button_get_time_ms() - s_button_state.last_release_time;
 
-                            if (s_button_state.pending_single_click &&
-                                time_since_last_release < BUTTON_DOUBLE_CLICK_TIME_MS) {
-                                // Double-click detected
-                                esp_timer_stop(s_button_state.double_click_timer);
-                                s_button_state.pending_single_click = false;
+                            if (time_since_last_release >= BUTTON_DOUBLE_CLICK_TIME_MS) {
+                                s_button_state.clicks = 0;
+                            }
+                            s_button_state.clicks++;
+                            esp_timer_stop(s_button_state.double_click_timer);
+
+                            if (s_button_state.clicks >= 3) {
+                                // Triple-click detected
+                                s_button_state.clicks = 0;
 
                                 if (s_button_state.callback) {
-                                    s_button_state.callback(BUTTON_EVENT_DOUBLE_CLICK);
+                                    s_button_state.callback(BUTTON_EVENT_TRIPLE_CLICK);
                                 }
                             } else {
-                                // Potential single-click - start timer to wait for double-click
-                                s_button_state.pending_single_click = true;
-                                esp_timer_stop(s_button_state.double_click_timer);
+                                // Single or double click - wait to see whether another follows
                                 esp_timer_start_once(s_button_state.double_click_timer,
                                                    BUTTON_DOUBLE_CLICK_TIME_MS * 1000);
                             }
@@ -251,12 +255,11 @@ static void button_task(void *arg)
 
 static void button_double_click_timeout(void *arg)
 {
-    if (s_button_state.pending_single_click) {
-        s_button_state.pending_single_click = false;
+    uint8_t clicks = s_button_state.clicks;
 
-        if (s_button_state.callback) {
-            s_button_state.callback(BUTTON_EVENT_SINGLE_CLICK);
-        }
+    s_button_state.clicks = 0;
+    if (clicks > 0 && s_button_state.callback) {
+        s_button_state.callback(clicks == 1 ? BUTTON_EVENT_SINGLE_CLICK : BUTTON_EVENT_DOUBLE_CLICK);
     }
 }
 
@@ -264,7 +267,7 @@ static void button_long_press_timeout(void *arg)
 {
     if (s_button_state.is_pressed) {
         // Long-press detected
-        s_button_state.pending_single_click = false;
+        s_button_state.clicks = 0;
 
         if (s_button_state.callback) {
             s_button_state.callback(BUTTON_EVENT_LONG_PRESS);
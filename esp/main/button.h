@@ -12,6 +12,7 @@ extern "C" {
 typedef enum {
     BUTTON_EVENT_SINGLE_CLICK,
     BUTTON_EVENT_DOUBLE_CLICK,
+    BUTTON_EVENT_TRIPLE_CLICK,
     BUTTON_EVENT_LONG_PRESS
 } button_event_t;
 
@@ -0,0 +1,109 @@
+#include "heap_stats.h"
+
+#include <stdatomic.h>
+#include <sys/param.h>
+
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "ble_nus.h"
+#include "task_config.h"
+#include "usb_cdc.h"
+
+// FreeRTOS keeps no stack sizes, so the stack budget check covers the tasks
+// whose sizes are known here: the relay's own from task_config.h and the
+// ESP-IDF ones set in sdkconfig. Tasks not running are skipped.
+static const struct {
+    const char *name;
+    uint32_t size;
+} s_stacks[] = {
+    { "main", CONFIG_ESP_MAIN_TASK_STACK_SIZE },
+    { "esp_timer", CONFIG_ESP_TIMER_TASK_STACK_SIZE },
+    { "TinyUSB", TASK_TINYUSB_STACK_SIZE },
+    { "nus_tx", TASK_NUS_TX_STACK_SIZE },
+    { "nus_rx", TASK_NUS_RX_STACK_SIZE },
+    { "cdc_rx", TASK_CDC_RX_STACK_SIZE },
+    { "relay_proto", TASK_RELAY_PROTO_STACK_SIZE },
+    { "nus_cccd", TASK_NUS_CCCD_STACK_SIZE },
+    { "button_task", TASK_BUTTON_STACK_SIZE },
+    { "hid_out", TASK_HID_OUT_STACK_SIZE },
+    { "hid_scan", TASK_HID_SCAN_STACK_SIZE },
+    { "cdc_log", TASK_CDC_LOG_STACK_SIZE },
+    { "persist", TASK_PERSIST_STACK_SIZE },
+    { "fw_update", TASK_FW_UPDATE_STACK_SIZE },
+    { "stall_watch", TASK_STALL_WATCH_STACK_SIZE },
+    { "stall_relay", TASK_STALL_PROBE_STACK_SIZE },
+    { "stall_bt", TASK_STALL_PROBE_STACK_SIZE },
+    { "bench", TASK_BENCH_STACK_SIZE },
+};
+
+static atomic_uint s_heap_failures;
+
+// Runs in whichever task failed to allocate, possibly with interrupts off
+static void alloc_failed(size_t size, uint32_t caps, const char *function_name) {
+    (void)size;
+    (void)caps;
+    (void)function_name;
+    atomic_fetch_add_explicit(&s_heap_failures, 1, memory_order_relaxed);
+}
+
+esp_err_t heap_stats_init(void) {
+    return heap_caps_register_failed_alloc_callback(alloc_failed);
+}
+
+void heap_stats_read(struct mem_stats_report *report) {
+    multi_heap_info_t info;
+    struct mem_stats_site message;
+    struct mem_stats_site pass_through;
+    struct mem_stats_site nus;
+
+    *report = (struct mem_stats_report){0};
+
+    heap_caps_get_info(&info, MALLOC_CAP_INTERNAL);
+    uint32_t size = info.total_free_bytes + info.total_allocated_bytes;
+    report->heap = (struct mem_stats_heap){
+        .size = size,
+        .used = info.total_allocated_bytes,
+        .max_used = size - info.minimum_free_bytes,
+        .largest_free = info.largest_free_block,
+        .failures = atomic_load_explicit(&s_heap_failures, memory_order_relaxed),
+    };
+
+    // Neither pool keeps a peak of its own; their sites do
+    mem_stats_site_get(MEM_SITE_CDC_MESSAGE, &message);
+    mem_stats_site_get(MEM_SITE_CDC_PASS_THROUGH, &pass_through);
+    mem_stats_site_get(MEM_SITE_NUS_TX, &nus);
+
+    mem_stats_add_pool(report, &(struct mem_stats_pool){
+        .name = "cdc tx fifo",
+        .unit = 1,
+        .size = CONFIG_TINYUSB_CDC_TX_BUFSIZE,
+        .used = usb_cdc_tx_queued(),
+        .max_used = MAX(message.peak, pass_through.peak),
+        .failures = message.failures + pass_through.failures,
+    });
+    mem_stats_add_pool(report, &(struct mem_stats_pool){
+        .name = "nus tx queue",
+        .unit = ble_nus_client_tx_slot_size(),
+        .size = NUS_TX_QUEUE_LEN,
+        .used = ble_nus_client_tx_pending(),
+        .max_used = nus.peak,
+        .failures = nus.failures,
+    });
+
+    for (size_t i = 0; i < sizeof(s_stacks) / sizeof(s_stacks[0]); i++) {
+        TaskHandle_t task = xTaskGetHandle(s_stacks[i].name);
+
+        if (task) {
+            // StackType_t is a byte on ESP-IDF, so the mark is in bytes
+            mem_stats_add_stack(report, s_stacks[i].name, s_stacks[i].size,
+                                uxTaskGetStackHighWaterMark(task));
+        }
+    }
+}
+
+void heap_stats_reset(void) {
+    mem_stats_reset();
+}
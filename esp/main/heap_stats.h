@@ -0,0 +1,28 @@
+#pragma once
+
+#include "esp_err.h"
+
+#include "mem_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Heap and buffer pool usage for "mem" on CDC1 and MemStatsRead on CDC0.
+// The heap figures are the internal heap's, where the Bluetooth host and
+// TinyUSB allocate; the relay paths use the CDC0 TX FIFO and the NUS write
+// queue, which are listed as pools with their peaks and refusals taken
+// from common/mem_stats. The relay's tasks and the main and esp_timer tasks
+// follow with their stack high-water marks and budgets.
+
+// Start counting failed heap allocations; call once, early in boot
+esp_err_t heap_stats_init(void);
+
+void heap_stats_read(struct mem_stats_report *report);
+
+// Restart the pool peaks and site counters; the heap's are since boot
+void heap_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
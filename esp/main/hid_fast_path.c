@@ -0,0 +1,208 @@
+#include "hid_fast_path.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "transport_hid.h"
+
+#if CONFIG_MOUTHPAD_HID_NOTIFY_FAST_PATH
+
+static const char *TAG = "HID_FAST_PATH";
+
+#define HID_SERVICE_UUID      0x1812
+#define HID_REPORT_UUID       0x2A4D
+#define HID_REPORT_REF_UUID   0x2908
+#define HID_REPORT_TYPE_INPUT 1
+
+// More than the MouthPad exposes; a device with more stays on esp_hidh
+#define FAST_PATH_MAX_REPORTS 8
+
+enum {
+    FAST_PATH_IDLE,
+    FAST_PATH_RESOLVING,
+    FAST_PATH_ACTIVE,
+};
+
+typedef struct {
+    uint16_t char_handle;
+    uint16_t ref_handle;
+    uint8_t report_id;
+    bool resolved;
+} fast_path_report_t;
+
+// Filled by hid_fast_path_start() before any read is issued, then only
+// touched by the BTC task until the next start
+static fast_path_report_t s_reports[FAST_PATH_MAX_REPORTS];
+static size_t s_report_count;
+static size_t s_reads_outstanding;
+static uint16_t s_conn_id;
+static atomic_int s_state = FAST_PATH_IDLE;
+
+void hid_fast_path_start(esp_gatt_if_t gattc_if, uint16_t conn_id)
+{
+    esp_gattc_service_elem_t service;
+    uint16_t count = 1;
+    esp_bt_uuid_t uuid = {.len = ESP_UUID_LEN_16, .uuid.uuid16 = HID_SERVICE_UUID};
+
+    atomic_store(&s_state, FAST_PATH_IDLE);
+
+    if (esp_ble_gattc_get_service(gattc_if, conn_id, &uuid, &service, &count, 0) !=
+            ESP_GATT_OK || count == 0) {
+        ESP_LOGW(TAG, "HID service not in the GATT cache, staying on esp_hidh");
+        return;
+    }
+
+    esp_gattc_char_elem_t chars[FAST_PATH_MAX_REPORTS];
+    count = FAST_PATH_MAX_REPORTS;
+    uuid.uuid.uuid16 = HID_REPORT_UUID;
+    if (esp_ble_gattc_get_char_by_uuid(gattc_if, conn_id, service.start_handle,
+                                       service.end_handle, uuid, chars, &count) !=
+            ESP_GATT_OK || count == 0) {
+        ESP_LOGW(TAG, "No Report characteristics found, staying on esp_hidh");
+        return;
+    }
+
+    // Only notifying characteristics can be input reports
+    s_report_count = 0;
+    s_conn_id = conn_id;
+    uuid.uuid.uuid16 = HID_REPORT_REF_UUID;
+    for (uint16_t i = 0; i < count; i++) {
+        if (!(chars[i].properties & ESP_GATT_CHAR_PROP_BIT_NOTIFY)) {
+            continue;
+        }
+
+        esp_gattc_descr_elem_t ref;
+        uint16_t ref_count = 1;
+        if (esp_ble_gattc_get_descr_by_char_handle(gattc_if, conn_id, chars[i].char_handle,
+                                                   uuid, &ref, &ref_count) != ESP_GATT_OK ||
+            ref_count == 0) {
+            ESP_LOGW(TAG, "Report 0x%04x has no Report Reference, staying on esp_hidh",
+                     chars[i].char_handle);
+            return;
+        }
+
+        s_reports[s_report_count++] = (fast_path_report_t){
+            .char_handle = chars[i].char_handle,
+            .ref_handle = ref.handle,
+        };
+    }
+
+    if (s_report_count == 0) {
+        return;
+    }
+
+    // The read results are consumed in hid_fast_path_handle_gattc_event()
+    // so esp_hidh never sees a read it did not issue
+    atomic_store(&s_state, FAST_PATH_RESOLVING);
+    s_reads_outstanding = s_report_count;
+    for (size_t i = 0; i < s_report_count; i++) {
+        esp_err_t ret = esp_ble_gattc_read_char_descr(gattc_if, conn_id, s_reports[i].ref_handle,
+                                                      ESP_GATT_AUTH_REQ_NONE);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Report Reference read failed: %s", esp_err_to_name(ret));
+            atomic_store(&s_state, FAST_PATH_IDLE);
+            return;
+        }
+    }
+}
+
+void hid_fast_path_stop(void)
+{
+    atomic_store(&s_state, FAST_PATH_IDLE);
+}
+
+static fast_path_report_t *find_report(uint16_t handle, bool by_ref)
+{
+    for (size_t i = 0; i < s_report_count; i++) {
+        if ((by_ref ? s_reports[i].ref_handle : s_reports[i].char_handle) == handle) {
+            return &s_reports[i];
+        }
+    }
+    return NULL;
+}
+
+// BTC task: one Report Reference read has completed
+static void handle_ref_read(esp_ble_gattc_cb_param_t *param, fast_path_report_t *report)
+{
+    s_reads_outstanding--;
+
+    if (atomic_load(&s_state) != FAST_PATH_RESOLVING) {
+        return;
+    }
+
+    // Report ID, then report type (1 = input)
+    if (param->read.status != ESP_GATT_OK || param->read.value_len < 2 ||
+        param->read.value[1] != HID_REPORT_TYPE_INPUT) {
+        ESP_LOGW(TAG, "Report 0x%04x is not a readable input report, staying on esp_hidh",
+                 report->char_handle);
+        atomic_store(&s_state, FAST_PATH_IDLE);
+        return;
+    }
+
+    report->report_id = param->read.value[0];
+    report->resolved = true;
+
+    if (s_reads_outstanding == 0) {
+        ESP_LOGI(TAG, "Forwarding %u input reports from GATTC notifications",
+                 (unsigned)s_report_count);
+        atomic_store(&s_state, FAST_PATH_ACTIVE);
+    }
+}
+
+bool hid_fast_path_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
+                                      esp_ble_gattc_cb_param_t *param)
+{
+    (void)gattc_if;
+
+    switch (event) {
+    case ESP_GATTC_NOTIFY_EVT: {
+        if (atomic_load(&s_state) != FAST_PATH_ACTIVE || param->notify.conn_id != s_conn_id) {
+            return false;
+        }
+        fast_path_report_t *report = find_report(param->notify.handle, false);
+        if (report == NULL) {
+            return false;
+        }
+        transport_hid_handle_input(report->report_id, param->notify.value,
+                                   param->notify.value_len);
+        return true;
+    }
+
+    case ESP_GATTC_READ_DESCR_EVT: {
+        if (s_reads_outstanding == 0 || param->read.conn_id != s_conn_id) {
+            return false;
+        }
+        fast_path_report_t *report = find_report(param->read.handle, true);
+        if (report == NULL || report->resolved) {
+            return false;
+        }
+        handle_ref_read(param, report);
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+#else // !CONFIG_MOUTHPAD_HID_NOTIFY_FAST_PATH
+
+void hid_fast_path_start(esp_gatt_if_t gattc_if, uint16_t conn_id)
+{
+    (void)gattc_if;
+    (void)conn_id;
+}
+
+void hid_fast_path_stop(void) {}
+
+bool hid_fast_path_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
+                                      esp_ble_gattc_cb_param_t *param)
+{
+    (void)event;
+    (void)gattc_if;
+    (void)param;
+    return false;
+}
+
+#endif // CONFIG_MOUTHPAD_HID_NOTIFY_FAST_PATH
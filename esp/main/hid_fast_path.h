@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_gattc_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Input report notifications straight from the GATTC callback to
+// transport_hid, skipping the esp_hidh event loop hop
+// (CONFIG_MOUTHPAD_HID_NOTIFY_FAST_PATH). After esp_hidh has opened the
+// device, the Report Reference descriptor of every notifying Report
+// characteristic is read once. When all of them are input reports with a
+// known ID, their notifications are forwarded from the BTC task and never
+// reach esp_hidh. Everything else (setup, battery, feature reports) still
+// goes through esp_hidh. Without the option every call is a no-op.
+
+// Resolve the input report handles of a device esp_hidh has just opened;
+// call from the esp_hidh event task
+void hid_fast_path_start(esp_gatt_if_t gattc_if, uint16_t conn_id);
+
+// Stop forwarding; call on disconnect
+void hid_fast_path_stop(void);
+
+// Feed HID GATTC events ahead of esp_hidh_gattc_event_handler(). Returns
+// true when the event was consumed here and must not be passed on.
+bool hid_fast_path_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
+                                      esp_ble_gattc_cb_param_t *param);
+
+#ifdef __cplusplus
+}
+#endif
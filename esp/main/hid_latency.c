@@ -0,0 +1,117 @@
+#include "hid_latency.h"
+
+#if CONFIG_MOUTHPAD_HID_LATENCY_TRACE
+
+#include <string.h>
+#include <sys/param.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "link_history.h"
+#include "trace_ring.h"
+
+// Latencies are binned into a log-linear histogram, 4 sub-buckets per power
+// of two, so p50/p99 come out with ~25% resolution from a fixed table per
+// report ID without keeping samples. Same layout as the nRF relay so the
+// two can be compared directly.
+#define HIST_SUB_BITS 2
+#define HIST_SUB_COUNT (1U << HIST_SUB_BITS)
+#define HIST_BUCKETS 64 // 1us .. 131ms; anything slower lands in the last one
+
+typedef struct {
+    uint32_t buckets[HIST_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+} latency_hist_t;
+
+static latency_hist_t s_hists[HID_LATENCY_REPORT_ID_MAX];
+static portMUX_TYPE s_hist_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t bucket_index(uint32_t us) {
+    if (us < HIST_SUB_COUNT) {
+        return us;
+    }
+
+    uint32_t msb = 31U - __builtin_clz(us);
+    uint32_t sub = (us >> (msb - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1U);
+    uint32_t idx = ((msb - HIST_SUB_BITS + 1U) << HIST_SUB_BITS) + sub;
+
+    return MIN(idx, HIST_BUCKETS - 1U);
+}
+
+// Largest latency that still falls into bucket idx
+static uint32_t bucket_upper_us(uint32_t idx) {
+    if (idx < HIST_SUB_COUNT) {
+        return idx;
+    }
+
+    uint32_t shift = (idx >> HIST_SUB_BITS) - 1U;
+    uint32_t sub = idx & (HIST_SUB_COUNT - 1U);
+    uint32_t lower = (HIST_SUB_COUNT + sub) << shift;
+
+    return lower + (1U << shift) - 1U;
+}
+
+static uint32_t percentile_us(const latency_hist_t *h, uint32_t pct) {
+    uint32_t target = (uint32_t)(((uint64_t)h->count * pct + 99U) / 100U);
+    uint32_t seen = 0;
+
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            return MIN(bucket_upper_us(i), h->max_us);
+        }
+    }
+
+    return h->max_us;
+}
+
+void hid_latency_record(uint8_t report_id, int64_t start_us) {
+    if (start_us == 0 || report_id == 0 || report_id > HID_LATENCY_REPORT_ID_MAX) {
+        return;
+    }
+
+    int64_t elapsed = esp_timer_get_time() - start_us;
+    uint32_t us = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+    latency_hist_t *h = &s_hists[report_id - 1];
+
+    taskENTER_CRITICAL(&s_hist_lock);
+    h->buckets[bucket_index(us)]++;
+    h->count++;
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+    taskEXIT_CRITICAL(&s_hist_lock);
+
+    trace_ring_latency(report_id, us);
+#if CONFIG_MOUTHPAD_LINK_HISTORY
+    link_history_latency(us);
+#endif
+}
+
+esp_err_t hid_latency_get_stats(uint8_t report_id, hid_latency_stats_t *stats) {
+    if (report_id == 0 || report_id > HID_LATENCY_REPORT_ID_MAX || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    latency_hist_t snapshot;
+    taskENTER_CRITICAL(&s_hist_lock);
+    snapshot = s_hists[report_id - 1];
+    taskEXIT_CRITICAL(&s_hist_lock);
+
+    stats->report_id = report_id;
+    stats->count = snapshot.count;
+    stats->max_us = snapshot.max_us;
+    stats->p50_us = snapshot.count ? percentile_us(&snapshot, 50) : 0;
+    stats->p99_us = snapshot.count ? percentile_us(&snapshot, 99) : 0;
+
+    return ESP_OK;
+}
+
+void hid_latency_reset(void) {
+    taskENTER_CRITICAL(&s_hist_lock);
+    memset(s_hists, 0, sizeof(s_hists));
+    taskEXIT_CRITICAL(&s_hist_lock);
+}
+
+#endif // CONFIG_MOUTHPAD_HID_LATENCY_TRACE
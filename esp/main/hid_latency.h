@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#include "mouthpad_hid_reports.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Every input report ID from the MouthPad report descriptor is tracked
+#define HID_LATENCY_REPORT_ID_MAX MOUTHPAD_HID_REPORT_ID_MAX
+
+typedef struct {
+    uint8_t report_id;
+    uint32_t count;   // Reports measured since boot or last reset
+    uint32_t p50_us;  // Median latency
+    uint32_t p99_us;  // 99th percentile latency
+    uint32_t max_us;  // Worst observed latency
+} hid_latency_stats_t;
+
+#if CONFIG_MOUTHPAD_HID_LATENCY_TRACE
+
+// Timestamp a report as it reaches usb_hid; 0 means not traced
+static inline int64_t hid_latency_start(void) { return esp_timer_get_time(); }
+
+// Record a report whose USB IN transfer completed. Safe from any task.
+void hid_latency_record(uint8_t report_id, int64_t start_us);
+
+// Summary for one report ID (1..HID_LATENCY_REPORT_ID_MAX)
+esp_err_t hid_latency_get_stats(uint8_t report_id, hid_latency_stats_t *stats);
+
+void hid_latency_reset(void);
+
+#else
+
+static inline int64_t hid_latency_start(void) { return 0; }
+
+static inline void hid_latency_record(uint8_t report_id, int64_t start_us) {
+    (void)report_id;
+    (void)start_us;
+}
+
+static inline esp_err_t hid_latency_get_stats(uint8_t report_id, hid_latency_stats_t *stats) {
+    (void)report_id;
+    (void)stats;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline void hid_latency_reset(void) {}
+
+#endif // CONFIG_MOUTHPAD_HID_LATENCY_TRACE
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,630 @@
+#include "hid_open_cache.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_hidh_gattc.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+#include "persist.h"
+
+#if CONFIG_MOUTHPAD_HID_OPEN_CACHE
+
+static const char *TAG = "HID_OPEN_CACHE";
+
+// One entry per bonded MouthPad, "ho_" and its address in hex
+#define NVS_NAMESPACE  "hid_open"
+#define NVS_KEY_PREFIX "ho_"
+#define NVS_KEY_LEN    16
+
+#define DB_HASH_UUID    0x2B2A
+#define DB_HASH_LEN     16
+#define DB_HASH_WAIT_MS 1000
+
+// Values esp_hidh reads while opening that only change with the GATT
+// database; the battery level and the PnP ID (it carries the firmware
+// version) are always read
+static const uint16_t cacheable_uuids[] = {
+    0x2A4B, // Report Map
+    0x2A4A, // HID Information
+    0x2908, // Report Reference
+    0x2907, // External Report Reference
+    0x2A29, // Manufacturer Name
+    0x2A25, // Serial Number
+};
+
+#define OPEN_CACHE_VERSION   1
+#define OPEN_CACHE_READS_MAX 16
+// A report map of a few hundred bytes and a handful of short values
+#define OPEN_CACHE_DATA_MAX  1024
+
+typedef struct {
+    uint16_t handle;
+    uint16_t offset; // Into data
+    uint16_t len;
+    uint8_t descr;   // Read as a descriptor
+    uint8_t reserved;
+} open_cache_read_t;
+
+typedef struct {
+    uint8_t version;
+    uint8_t count;
+    uint16_t data_len;
+    uint8_t hash[DB_HASH_LEN];
+    open_cache_read_t reads[OPEN_CACHE_READS_MAX];
+    uint8_t data[OPEN_CACHE_DATA_MAX];
+} open_cache_entry_t;
+
+// Only the used part of data is stored
+#define ENTRY_SIZE(entry) (offsetof(open_cache_entry_t, data) + (entry)->data_len)
+
+enum {
+    OPEN_IDLE,   // No HID connection
+    OPEN_NEW,    // Connected, nothing read yet
+    OPEN_RECORD, // Reads go out and their values are kept
+    OPEN_HIT,    // Reads are answered from the entry
+    OPEN_PASS,   // No Database Hash; reads go out and are not kept
+    OPEN_DONE,   // esp_hidh has opened the device
+};
+
+static esp_gatt_if_t s_hid_gattc_if = ESP_GATT_IF_NONE;
+static atomic_int s_state = OPEN_IDLE;
+
+// Set on connect by the BTC task; esp_hidh only reads once it has seen it
+static uint16_t s_conn_id;
+static esp_bd_addr_t s_conn_bda;
+
+// The entry being answered from or recorded into. Recording appends on the
+// BTC task while the connection manager waits in esp_hidh_dev_open().
+static open_cache_entry_t s_entry;
+static bool s_entry_full;
+static uint16_t s_record_handle;
+static uint8_t s_record_descr;
+static uint16_t s_answered;
+
+// Database Hash read, issued and waited for from the connection manager
+static SemaphoreHandle_t s_hash_done;
+static atomic_bool s_hash_pending;
+static bool s_hash_ok;
+static uint8_t s_hash[DB_HASH_LEN];
+
+// CCCD writes acknowledged early whose real completion is still to come
+static atomic_int s_writes_acked;
+
+// What NVS holds for s_saved_bda, or will once the persist task has written
+// s_pending_entry; and the entry of a dropped bond waiting to be erased
+static esp_bd_addr_t s_saved_bda;
+static open_cache_entry_t s_saved_entry;
+static esp_bd_addr_t s_pending_bda;
+static open_cache_entry_t s_pending_entry;
+static bool s_pending_dirty;
+static esp_bd_addr_t s_forget_bda;
+static bool s_forget_pending;
+static portMUX_TYPE s_pending_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_persist_id = -1;
+
+esp_err_t __real_esp_ble_gattc_read_char(esp_gatt_if_t gattc_if, uint16_t conn_id,
+                                         uint16_t handle, esp_gatt_auth_req_t auth_req);
+esp_err_t __real_esp_ble_gattc_read_char_descr(esp_gatt_if_t gattc_if, uint16_t conn_id,
+                                               uint16_t handle, esp_gatt_auth_req_t auth_req);
+esp_err_t __real_esp_ble_gattc_write_char_descr(esp_gatt_if_t gattc_if, uint16_t conn_id,
+                                                uint16_t handle, uint16_t value_len,
+                                                uint8_t *value, esp_gatt_write_type_t write_type,
+                                                esp_gatt_auth_req_t auth_req);
+
+static void cache_key(const esp_bd_addr_t bda, char key[NVS_KEY_LEN])
+{
+    snprintf(key, NVS_KEY_LEN, NVS_KEY_PREFIX "%02x%02x%02x%02x%02x%02x",
+             bda[0], bda[1], bda[2], bda[3], bda[4], bda[5]);
+}
+
+static bool entry_valid(const open_cache_entry_t *entry, size_t size)
+{
+    if (size < offsetof(open_cache_entry_t, data) || entry->version != OPEN_CACHE_VERSION ||
+        entry->count > OPEN_CACHE_READS_MAX || entry->data_len > OPEN_CACHE_DATA_MAX ||
+        size != ENTRY_SIZE(entry)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < entry->count; i++) {
+        if (entry->reads[i].offset + entry->reads[i].len > entry->data_len) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool entry_load(const esp_bd_addr_t bda, open_cache_entry_t *entry)
+{
+    char key[NVS_KEY_LEN];
+    nvs_handle_t nvs_handle;
+    bool found = false;
+
+    // The entry NVS holds, or is about to, for the last MouthPad saved
+    taskENTER_CRITICAL(&s_pending_lock);
+    if (memcmp(bda, s_saved_bda, sizeof(esp_bd_addr_t)) == 0 && s_saved_entry.count > 0) {
+        memcpy(entry, &s_saved_entry, ENTRY_SIZE(&s_saved_entry));
+        found = true;
+    }
+    taskEXIT_CRITICAL(&s_pending_lock);
+    if (found) {
+        return true;
+    }
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return false;
+    }
+    cache_key(bda, key);
+    size_t size = sizeof(*entry);
+    esp_err_t ret = nvs_get_blob(nvs_handle, key, entry, &size);
+    nvs_close(nvs_handle);
+
+    return ret == ESP_OK && entry_valid(entry, size) && entry->count > 0;
+}
+
+static esp_err_t entry_write(const esp_bd_addr_t bda, const open_cache_entry_t *entry)
+{
+    char key[NVS_KEY_LEN];
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    cache_key(bda, key);
+    ret = nvs_set_blob(nvs_handle, key, entry, ENTRY_SIZE(entry));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Saved %u reads, %u bytes (%s)", entry->count, entry->data_len, key);
+    } else {
+        ESP_LOGW(TAG, "Failed to save %s: %s", key, esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+static void entry_erase(const esp_bd_addr_t bda)
+{
+    char key[NVS_KEY_LEN];
+    nvs_handle_t nvs_handle;
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle) != ESP_OK) {
+        return;
+    }
+    cache_key(bda, key);
+    if (nvs_erase_key(nvs_handle, key) == ESP_OK) {
+        nvs_commit(nvs_handle);
+        ESP_LOGI(TAG, "Erased the entry of a dropped bond (%s)", key);
+    }
+    nvs_close(nvs_handle);
+}
+
+// Persist task: write the snapshot taken by hid_open_cache_opened(), and
+// erase the entry of a bond that was dropped
+static void open_cache_persist_flush(void)
+{
+    static open_cache_entry_t entry;
+    esp_bd_addr_t bda;
+    esp_bd_addr_t forget;
+
+    taskENTER_CRITICAL(&s_pending_lock);
+    bool dirty = s_pending_dirty;
+    bool forget_pending = s_forget_pending;
+    s_pending_dirty = false;
+    s_forget_pending = false;
+    if (dirty) {
+        memcpy(bda, s_pending_bda, sizeof(bda));
+        memcpy(&entry, &s_pending_entry, ENTRY_SIZE(&s_pending_entry));
+    }
+    if (forget_pending) {
+        memcpy(forget, s_forget_bda, sizeof(forget));
+    }
+    taskEXIT_CRITICAL(&s_pending_lock);
+
+    if (forget_pending) {
+        entry_erase(forget);
+    }
+    if (dirty) {
+        entry_write(bda, &entry);
+    }
+}
+
+void hid_open_cache_init(void)
+{
+    s_hash_done = xSemaphoreCreateBinary();
+    if (!s_hash_done) {
+        ESP_LOGW(TAG, "No semaphore, HID opens uncached");
+        return;
+    }
+    s_persist_id = persist_register(open_cache_persist_flush);
+}
+
+// Characteristic values and descriptors whose UUID is on the list. The
+// lookup is in Bluedroid's GATT cache; a handle it does not resolve is
+// read every time.
+static bool cacheable(esp_gatt_if_t gattc_if, uint16_t conn_id, uint16_t handle)
+{
+    esp_gattc_db_elem_t elem;
+    uint16_t count = 1;
+
+    if (esp_ble_gattc_get_db(gattc_if, conn_id, handle, handle, &elem, &count) != ESP_GATT_OK ||
+        count != 1 || elem.attribute_handle != handle || elem.uuid.len != ESP_UUID_LEN_16) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(cacheable_uuids) / sizeof(cacheable_uuids[0]); i++) {
+        if (elem.uuid.uuid.uuid16 == cacheable_uuids[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Connection manager, inside esp_hidh_dev_open(): read the Database Hash
+// and wait for it. Responses come in request order and esp_hidh has
+// nothing else outstanding, so the next read response is this one.
+static bool read_db_hash(esp_gatt_if_t gattc_if, uint16_t conn_id)
+{
+    esp_bt_uuid_t uuid = {.len = ESP_UUID_LEN_16, .uuid.uuid16 = DB_HASH_UUID};
+
+    if (atomic_load(&s_hash_pending)) {
+        // An earlier one never came back; its response would be taken as this one's
+        return false;
+    }
+    xSemaphoreTake(s_hash_done, 0);
+    s_hash_ok = false;
+    atomic_store(&s_hash_pending, true);
+    if (esp_ble_gattc_read_by_type(gattc_if, conn_id, 0x0001, 0xFFFF, &uuid,
+                                   ESP_GATT_AUTH_REQ_NONE) != ESP_OK) {
+        atomic_store(&s_hash_pending, false);
+        return false;
+    }
+    // On a timeout the response is still taken when it comes, and dropped
+    if (xSemaphoreTake(s_hash_done, pdMS_TO_TICKS(DB_HASH_WAIT_MS)) != pdTRUE) {
+        ESP_LOGW(TAG, "No Database Hash response");
+        return false;
+    }
+    return s_hash_ok;
+}
+
+static void open_cache_begin(esp_gatt_if_t gattc_if, uint16_t conn_id)
+{
+    bool cached = entry_load(s_conn_bda, &s_entry);
+
+    if (!read_db_hash(gattc_if, conn_id)) {
+        ESP_LOGI(TAG, "No Database Hash, HID open not cached");
+        atomic_store(&s_state, OPEN_PASS);
+        return;
+    }
+    if (cached && memcmp(s_entry.hash, s_hash, DB_HASH_LEN) == 0) {
+        ESP_LOGI(TAG, "Database Hash matches, answering %u reads from the cache", s_entry.count);
+        s_answered = 0;
+        atomic_store(&s_state, OPEN_HIT);
+        return;
+    }
+
+    ESP_LOGI(TAG, cached ? "Database Hash changed, reading again" : "No entry, recording the open");
+    memset(&s_entry, 0, offsetof(open_cache_entry_t, data));
+    s_entry.version = OPEN_CACHE_VERSION;
+    memcpy(s_entry.hash, s_hash, DB_HASH_LEN);
+    s_entry_full = false;
+    s_record_handle = 0;
+    atomic_store(&s_state, OPEN_RECORD);
+}
+
+static const open_cache_read_t *find_read(uint16_t handle, bool descr)
+{
+    for (uint8_t i = 0; i < s_entry.count; i++) {
+        if (s_entry.reads[i].handle == handle && s_entry.reads[i].descr == descr) {
+            return &s_entry.reads[i];
+        }
+    }
+    return NULL;
+}
+
+// A read esp_hidh is about to issue: true when it was answered here and
+// must not go out
+static bool open_cache_read(esp_gatt_if_t gattc_if, uint16_t conn_id, uint16_t handle, bool descr)
+{
+    if (gattc_if != s_hid_gattc_if || conn_id != s_conn_id) {
+        return false;
+    }
+    if (atomic_load(&s_state) == OPEN_NEW) {
+        open_cache_begin(gattc_if, conn_id);
+    }
+
+    switch (atomic_load(&s_state)) {
+    case OPEN_HIT: {
+        const open_cache_read_t *read = find_read(handle, descr);
+        if (!read) {
+            return false;
+        }
+        // esp_hidh copies the value and gives its semaphore, which its
+        // wait after this call then takes straight away
+        esp_ble_gattc_cb_param_t param = {
+            .read = {
+                .conn_id = conn_id,
+                .status = ESP_GATT_OK,
+                .handle = handle,
+                .value = &s_entry.data[read->offset],
+                .value_len = read->len,
+            },
+        };
+        s_answered++;
+        esp_hidh_gattc_event_handler(descr ? ESP_GATTC_READ_DESCR_EVT : ESP_GATTC_READ_CHAR_EVT,
+                                     gattc_if, &param);
+        return true;
+    }
+
+    case OPEN_RECORD:
+        s_record_descr = descr;
+        s_record_handle = cacheable(gattc_if, conn_id, handle) ? handle : 0;
+        return false;
+
+    default:
+        return false;
+    }
+}
+
+// BTC task: keep the value of a read made while recording
+static void record_read(const esp_ble_gattc_cb_param_t *param, bool descr)
+{
+    uint16_t handle = s_record_handle;
+
+    s_record_handle = 0;
+    if (handle == 0 || param->read.handle != handle || s_record_descr != descr ||
+        param->read.status != ESP_GATT_OK) {
+        return;
+    }
+    if (s_entry.count == OPEN_CACHE_READS_MAX ||
+        s_entry.data_len + param->read.value_len > OPEN_CACHE_DATA_MAX) {
+        s_entry_full = true;
+        return;
+    }
+
+    open_cache_read_t *read = &s_entry.reads[s_entry.count++];
+    read->handle = handle;
+    read->offset = s_entry.data_len;
+    read->len = param->read.value_len;
+    read->descr = descr;
+    memcpy(&s_entry.data[s_entry.data_len], param->read.value, param->read.value_len);
+    s_entry.data_len += param->read.value_len;
+}
+
+bool hid_open_cache_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
+                                       esp_ble_gattc_cb_param_t *param)
+{
+    if (event == ESP_GATTC_REG_EVT) {
+        if (param->reg.app_id == 0 && param->reg.status == ESP_GATT_OK) {
+            s_hid_gattc_if = gattc_if;
+        }
+        return false;
+    }
+    if (gattc_if != s_hid_gattc_if || s_hid_gattc_if == ESP_GATT_IF_NONE) {
+        return false;
+    }
+
+    switch (event) {
+    case ESP_GATTC_CONNECT_EVT:
+        s_conn_id = param->connect.conn_id;
+        memcpy(s_conn_bda, param->connect.remote_bda, sizeof(s_conn_bda));
+        atomic_store(&s_writes_acked, 0);
+        atomic_store(&s_state, s_hash_done ? OPEN_NEW : OPEN_PASS);
+        return false;
+
+    case ESP_GATTC_DISCONNECT_EVT:
+        if (param->disconnect.conn_id == s_conn_id) {
+            atomic_store(&s_state, OPEN_IDLE);
+            atomic_store(&s_writes_acked, 0);
+            if (atomic_exchange(&s_hash_pending, false)) {
+                xSemaphoreGive(s_hash_done);
+            }
+        }
+        return false;
+
+    case ESP_GATTC_READ_CHAR_EVT:
+        if (atomic_exchange(&s_hash_pending, false)) {
+            s_hash_ok = param->read.status == ESP_GATT_OK &&
+                        param->read.value_len == DB_HASH_LEN;
+            if (s_hash_ok) {
+                memcpy(s_hash, param->read.value, DB_HASH_LEN);
+            }
+            xSemaphoreGive(s_hash_done);
+            return true;
+        }
+        if (atomic_load(&s_state) == OPEN_RECORD) {
+            record_read(param, false);
+        }
+        return false;
+
+    case ESP_GATTC_READ_DESCR_EVT:
+        if (atomic_load(&s_state) == OPEN_RECORD) {
+            record_read(param, true);
+        }
+        return false;
+
+    case ESP_GATTC_WRITE_DESCR_EVT:
+        if (param->write.conn_id != s_conn_id || atomic_load(&s_writes_acked) == 0) {
+            return false;
+        }
+        atomic_fetch_sub(&s_writes_acked, 1);
+        if (param->write.status != ESP_GATT_OK) {
+            ESP_LOGW(TAG, "CCCD write to 0x%04x failed after it was acknowledged: %d",
+                     param->write.handle, param->write.status);
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void hid_open_cache_opened(const esp_bd_addr_t bda)
+{
+    int state = atomic_exchange(&s_state, OPEN_DONE);
+
+    if (state == OPEN_HIT) {
+        ESP_LOGI(TAG, "Opened from the cache, %u reads answered", s_answered);
+        return;
+    }
+    if (state != OPEN_RECORD || memcmp(bda, s_conn_bda, sizeof(esp_bd_addr_t)) != 0) {
+        return;
+    }
+    if (s_entry_full) {
+        ESP_LOGW(TAG, "Open did not fit in an entry, not cached");
+        return;
+    }
+    if (s_entry.count == 0) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&s_pending_lock);
+    memcpy(s_saved_bda, bda, sizeof(esp_bd_addr_t));
+    memcpy(&s_saved_entry, &s_entry, ENTRY_SIZE(&s_entry));
+    if (s_persist_id >= 0) {
+        memcpy(s_pending_bda, bda, sizeof(esp_bd_addr_t));
+        memcpy(&s_pending_entry, &s_entry, ENTRY_SIZE(&s_entry));
+        s_pending_dirty = true;
+    }
+    taskEXIT_CRITICAL(&s_pending_lock);
+
+    if (s_persist_id < 0) {
+        entry_write(bda, &s_entry);
+    } else {
+        persist_request(s_persist_id);
+    }
+}
+
+void hid_open_cache_forget(const esp_bd_addr_t bda)
+{
+    taskENTER_CRITICAL(&s_pending_lock);
+    if (memcmp(bda, s_saved_bda, sizeof(esp_bd_addr_t)) == 0) {
+        memset(s_saved_bda, 0, sizeof(s_saved_bda));
+        s_saved_entry.count = 0;
+        s_saved_entry.data_len = 0;
+    }
+    if (s_pending_dirty && memcmp(bda, s_pending_bda, sizeof(esp_bd_addr_t)) == 0) {
+        s_pending_dirty = false;
+    }
+    memcpy(s_forget_bda, bda, sizeof(esp_bd_addr_t));
+    s_forget_pending = true;
+    taskEXIT_CRITICAL(&s_pending_lock);
+
+    if (s_persist_id < 0) {
+        open_cache_persist_flush();
+    } else {
+        persist_request(s_persist_id);
+    }
+}
+
+void hid_open_cache_clear(void)
+{
+    nvs_handle_t nvs_handle;
+
+    // A pending write must not bring one back
+    taskENTER_CRITICAL(&s_pending_lock);
+    s_pending_dirty = false;
+    s_forget_pending = false;
+    memset(s_saved_bda, 0, sizeof(s_saved_bda));
+    s_saved_entry.count = 0;
+    s_saved_entry.data_len = 0;
+    taskEXIT_CRITICAL(&s_pending_lock);
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle) != ESP_OK) {
+        return;
+    }
+    if (nvs_erase_all(nvs_handle) == ESP_OK) {
+        nvs_commit(nvs_handle);
+        ESP_LOGI(TAG, "Cleared every entry");
+    }
+    nvs_close(nvs_handle);
+}
+
+// esp_hidh's calls, wrapped at link time (esp/main/CMakeLists.txt)
+
+esp_err_t __wrap_esp_ble_gattc_read_char(esp_gatt_if_t gattc_if, uint16_t conn_id,
+                                         uint16_t handle, esp_gatt_auth_req_t auth_req)
+{
+    if (open_cache_read(gattc_if, conn_id, handle, false)) {
+        return ESP_OK;
+    }
+    return __real_esp_ble_gattc_read_char(gattc_if, conn_id, handle, auth_req);
+}
+
+esp_err_t __wrap_esp_ble_gattc_read_char_descr(esp_gatt_if_t gattc_if, uint16_t conn_id,
+                                               uint16_t handle, esp_gatt_auth_req_t auth_req)
+{
+    if (open_cache_read(gattc_if, conn_id, handle, true)) {
+        return ESP_OK;
+    }
+    return __real_esp_ble_gattc_read_char_descr(gattc_if, conn_id, handle, auth_req);
+}
+
+// The CCCD writes of an open answered from the cache still go out, but
+// esp_hidh is told they completed without waiting for the response
+esp_err_t __wrap_esp_ble_gattc_write_char_descr(esp_gatt_if_t gattc_if, uint16_t conn_id,
+                                                uint16_t handle, uint16_t value_len,
+                                                uint8_t *value, esp_gatt_write_type_t write_type,
+                                                esp_gatt_auth_req_t auth_req)
+{
+    bool early = gattc_if == s_hid_gattc_if && conn_id == s_conn_id &&
+                 write_type == ESP_GATT_WRITE_TYPE_RSP && atomic_load(&s_state) == OPEN_HIT;
+
+    if (!early) {
+        return __real_esp_ble_gattc_write_char_descr(gattc_if, conn_id, handle, value_len, value,
+                                                     write_type, auth_req);
+    }
+
+    // Counted first: the response may come before the call returns
+    atomic_fetch_add(&s_writes_acked, 1);
+    esp_err_t ret = __real_esp_ble_gattc_write_char_descr(gattc_if, conn_id, handle, value_len,
+                                                          value, write_type, auth_req);
+    if (ret != ESP_OK) {
+        atomic_fetch_sub(&s_writes_acked, 1);
+        return ret;
+    }
+
+    esp_ble_gattc_cb_param_t param = {
+        .write = {
+            .conn_id = conn_id,
+            .status = ESP_GATT_OK,
+            .handle = handle,
+            .offset = 0,
+        },
+    };
+    esp_hidh_gattc_event_handler(ESP_GATTC_WRITE_DESCR_EVT, gattc_if, &param);
+    return ESP_OK;
+}
+
+#else // !CONFIG_MOUTHPAD_HID_OPEN_CACHE
+
+void hid_open_cache_init(void) {}
+
+bool hid_open_cache_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
+                                       esp_ble_gattc_cb_param_t *param)
+{
+    (void)event;
+    (void)gattc_if;
+    (void)param;
+    return false;
+}
+
+void hid_open_cache_opened(const esp_bd_addr_t bda)
+{
+    (void)bda;
+}
+
+void hid_open_cache_forget(const esp_bd_addr_t bda)
+{
+    (void)bda;
+}
+
+void hid_open_cache_clear(void) {}
+
+#endif // CONFIG_MOUTHPAD_HID_OPEN_CACHE
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_bt_defs.h"
+#include "esp_gattc_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-bond cache of what esp_hidh reads while opening the MouthPad
+// (CONFIG_MOUTHPAD_HID_OPEN_CACHE). esp_hidh_dev_open() reads the report
+// map, HID information and every Report Reference descriptor, then writes
+// each CCCD, one round trip at a time, on every connection; the Bluedroid
+// GATT cache only saves the service discovery. esp_hidh is part of ESP-IDF,
+// so its GATTC read and descriptor write calls are wrapped at link time
+// (esp/main/CMakeLists.txt).
+//
+// On the first read of a connection the MouthPad's Database Hash is read.
+// Without an entry for the bond, or with a different hash, the reads go out
+// as usual and their values are kept; once the device has opened they are
+// stored under the bond's address. With a matching entry, each cached read
+// is answered at once from it, and each CCCD write is sent but acknowledged
+// to esp_hidh without waiting, so the HID host is open about when the link
+// is encrypted. Reads of anything that can change (battery level, PnP ID)
+// always go out. Without the option every call is a no-op.
+
+// Before the first connection, after persist_init()
+void hid_open_cache_init(void);
+
+// Feed HID GATTC events ahead of esp_hidh_gattc_event_handler(). Returns
+// true when the event answers a request of this module and must not be
+// passed on.
+bool hid_open_cache_handle_gattc_event(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
+                                       esp_ble_gattc_cb_param_t *param);
+
+// esp_hidh opened the device; stores what was read if it was not cached
+void hid_open_cache_opened(const esp_bd_addr_t bda);
+
+// The bond was dropped; erase its entry
+void hid_open_cache_forget(const esp_bd_addr_t bda);
+
+// All bonds were cleared; erase every entry
+void hid_open_cache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,9 +11,8 @@
 #define TAG "leds"
 
 #define SCAN_BLINK_INTERVAL_US    800000  /* 0.8s */
-#define ACTIVITY_OFF_US           10000   /* LED off duration during activity */
-#define ACTIVITY_ON_US            30000   /* LED on duration after pulse */
-#define LED_UPDATE_PERIOD_US      50000   /* 50ms */
+#define ACTIVITY_OFF_US           10000   /* LED off part of the activity flicker */
+#define ACTIVITY_ON_US            30000   /* LED on part of the activity flicker */
 
 static bool s_available;
 static leds_state_t s_state = LED_STATE_OFF;
@@ -29,14 +28,46 @@ static const int s_hw_on_level = 1;
 #endif
 static const int s_hw_off_level = 1 - s_hw_on_level;
 
-static bool s_scanning_phase;
-static int64_t s_scanning_toggle_us;
+/* Each state plays a fixed keyframe table. A one-shot esp_timer fires only at
+ * keyframe boundaries and is idle while the LED holds steady, instead of
+ * polling every 50 ms. */
+typedef struct {
+    bool on;
+    uint32_t hold_us; /* 0 = hold until the pattern changes */
+} led_keyframe_t;
 
-static bool s_activity_pending;
-static bool s_activity_phase_on;
-static int64_t s_activity_toggle_us;
+typedef struct {
+    const led_keyframe_t *frames;
+    uint8_t count;
+    bool loop; /* Otherwise falls back to the connected pattern when done */
+} led_pattern_t;
+
+static const led_keyframe_t s_off_frames[] = {{false, 0}};
+static const led_keyframe_t s_scan_frames[] = {
+    {true, SCAN_BLINK_INTERVAL_US},
+    {false, SCAN_BLINK_INTERVAL_US},
+};
+static const led_keyframe_t s_connected_frames[] = {{true, 0}};
+static const led_keyframe_t s_activity_frames[] = {
+    {false, ACTIVITY_OFF_US},
+    {true, ACTIVITY_ON_US},
+};
+
+static const led_pattern_t s_off_pattern = {s_off_frames, 1, false};
+static const led_pattern_t s_scan_pattern = {s_scan_frames, 2, true};
+static const led_pattern_t s_connected_pattern = {s_connected_frames, 1, false};
+static const led_pattern_t s_activity_pattern = {s_activity_frames, 2, true};
+
+static const led_pattern_t *s_pattern = &s_off_pattern;
+static uint8_t s_frame;
+static int64_t s_frame_end_us; /* 0 while holding */
+static bool s_active; /* Connected pattern flickers while the relay is active */
+static bool s_paused; /* USB suspended: dark, but s_state keeps tracking */
+static bool s_dark; /* Tuning profile turned the status lights off; likewise */
 
 static esp_timer_handle_t s_timer;
+
+static void leds_play_state(leds_state_t state);
 #endif
 
 #ifdef BOARD_LED_GPIO
@@ -51,63 +82,61 @@ static void leds_apply(bool level)
     gpio_set_level(s_gpio, level ? s_hw_on_level : s_hw_off_level);
     s_output_level = level;
 }
-#endif
 
-#ifdef BOARD_LED_GPIO
-static void leds_update_task(void *arg)
+/* Called with s_lock held */
+static void enter_frame(uint8_t frame, int64_t now)
 {
-    (void)arg;
-    if (!s_available) {
-        return;
-    }
+    const led_keyframe_t *kf = &s_pattern->frames[frame];
 
+    s_frame = frame;
+    s_frame_end_us = kf->hold_us ? now + kf->hold_us : 0;
+    leds_apply(kf->on);
+}
+
+static void leds_play(const led_pattern_t *pattern)
+{
     int64_t now = esp_timer_get_time();
-    leds_state_t state;
-    bool activity;
+    int64_t hold_us;
+
+    esp_timer_stop(s_timer);
 
     portENTER_CRITICAL(&s_lock);
-    state = s_state;
-    activity = s_activity_pending;
-    bool phase_on = s_activity_phase_on;
+    s_pattern = pattern;
+    enter_frame(0, now);
+    hold_us = s_frame_end_us ? s_frame_end_us - now : 0;
     portEXIT_CRITICAL(&s_lock);
 
-    switch (state) {
-    case LED_STATE_OFF:
-        leds_apply(false);
-        break;
+    if (hold_us > 0) {
+        esp_timer_start_once(s_timer, hold_us);
+    }
+}
 
-    case LED_STATE_SCANNING:
-        if (now - s_scanning_toggle_us >= SCAN_BLINK_INTERVAL_US) {
-            s_scanning_phase = !s_scanning_phase;
-            s_scanning_toggle_us = now;
-        }
-        leds_apply(s_scanning_phase);
-        break;
+static void keyframe_timer_callback(void *arg)
+{
+    (void)arg;
+    int64_t now = esp_timer_get_time();
+    int64_t remaining_us = 0;
 
-    case LED_STATE_CONNECTED:
-    default:
-        if (activity) {
-            if (!phase_on) {
-                leds_apply(false);
-                if (now - s_activity_toggle_us >= ACTIVITY_OFF_US) {
-                    portENTER_CRITICAL(&s_lock);
-                    s_activity_phase_on = true;
-                    s_activity_toggle_us = now;
-                    portEXIT_CRITICAL(&s_lock);
-                }
-            } else {
-                leds_apply(true);
-                if (now - s_activity_toggle_us >= ACTIVITY_ON_US) {
-                    portENTER_CRITICAL(&s_lock);
-                    s_activity_pending = false;
-                    s_activity_phase_on = true;
-                    portEXIT_CRITICAL(&s_lock);
-                }
+    portENTER_CRITICAL(&s_lock);
+    if (s_frame_end_us != 0 && now >= s_frame_end_us) {
+        uint8_t next = s_frame + 1;
+
+        if (next >= s_pattern->count) {
+            if (!s_pattern->loop) {
+                s_pattern = &s_connected_pattern;
             }
-        } else {
-            leds_apply(true);
+            next = 0;
         }
-        break;
+        enter_frame(next, now);
+    }
+    if (s_frame_end_us != 0) {
+        remaining_us = s_frame_end_us - now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    /* Also re-arms a timer that fired early for a pattern replaced meanwhile */
+    if (remaining_us > 0) {
+        esp_timer_start_once(s_timer, remaining_us);
     }
 }
 #endif
@@ -136,18 +165,12 @@ esp_err_t leds_init(void)
         return err;
     }
 
-    int64_t now = esp_timer_get_time();
     gpio_set_level(s_gpio, s_hw_off_level);
     s_output_level = false;
-    s_scanning_phase = false;
-    s_scanning_toggle_us = now;
-    s_activity_pending = false;
-    s_activity_phase_on = true;
-    s_activity_toggle_us = now;
 
     esp_timer_create_args_t args = {
-        .callback = leds_update_task,
-        .name = "led_tick",
+        .callback = keyframe_timer_callback,
+        .name = "led_keyframe",
     };
     err = esp_timer_create(&args, &s_timer);
     if (err != ESP_OK) {
@@ -155,55 +178,109 @@ esp_err_t leds_init(void)
         return err;
     }
 
-    err = esp_timer_start_periodic(s_timer, LED_UPDATE_PERIOD_US);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start LED timer: %s", esp_err_to_name(err));
-        esp_timer_delete(s_timer);
-        s_timer = NULL;
-        return err;
-    }
-
     s_available = true;
     ESP_LOGI(TAG, "Single-colour LED initialised on GPIO %d", s_gpio);
+
+    /* Show whatever was set before the LED was up */
+    portENTER_CRITICAL(&s_lock);
+    leds_state_t state = s_state;
+    portEXIT_CRITICAL(&s_lock);
+    leds_play_state(state);
     return ESP_OK;
 #endif
 }
 
-void leds_set_state(leds_state_t state)
-{
 #ifdef BOARD_LED_GPIO
-    if (!s_available) {
+static void leds_play_state(leds_state_t state)
+{
+    if (s_paused || s_dark) {
+        leds_play(&s_off_pattern);
         return;
     }
-    int64_t now = esp_timer_get_time();
+
+    switch (state) {
+    case LED_STATE_SCANNING:
+        leds_play(&s_scan_pattern);
+        break;
+    case LED_STATE_CONNECTED:
+        leds_play(s_active ? &s_activity_pattern : &s_connected_pattern);
+        break;
+    case LED_STATE_OFF:
+    default:
+        leds_play(&s_off_pattern);
+        break;
+    }
+}
+#endif
+
+void leds_set_state(leds_state_t state)
+{
+#ifdef BOARD_LED_GPIO
     portENTER_CRITICAL(&s_lock);
     s_state = state;
-    if (state == LED_STATE_SCANNING) {
-        s_scanning_phase = true;
-        s_scanning_toggle_us = now;
-    }
-    s_activity_pending = false;
-    s_activity_phase_on = true;
     portEXIT_CRITICAL(&s_lock);
+
+    if (s_available) {
+        leds_play_state(state);
+    }
 #else
     (void)state;
 #endif
 }
 
-void leds_notify_activity(void)
+void leds_set_paused(bool paused)
 {
 #ifdef BOARD_LED_GPIO
-    if (!s_available) {
-        return;
+    leds_state_t state;
+
+    portENTER_CRITICAL(&s_lock);
+    s_paused = paused;
+    state = s_state;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_available) {
+        leds_play_state(state);
     }
-    int64_t now = esp_timer_get_time();
+#else
+    (void)paused;
+#endif
+}
+
+void leds_set_dark(bool dark)
+{
+#ifdef BOARD_LED_GPIO
+    leds_state_t state;
+
     portENTER_CRITICAL(&s_lock);
-    if (s_state == LED_STATE_CONNECTED && !s_activity_pending) {
-        s_activity_pending = true;
-        s_activity_phase_on = false;
-        s_activity_toggle_us = now;
+    s_dark = dark;
+    state = s_state;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_available) {
+        leds_play_state(state);
     }
+#else
+    (void)dark;
+#endif
+}
+
+void leds_set_active(bool active)
+{
+#ifdef BOARD_LED_GPIO
+    leds_state_t state;
+    bool change;
+
+    portENTER_CRITICAL(&s_lock);
+    change = s_active != active;
+    s_active = active;
+    state = s_state;
     portEXIT_CRITICAL(&s_lock);
+
+    if (s_available && change && state == LED_STATE_CONNECTED) {
+        leds_play_state(state);
+    }
+#else
+    (void)active;
 #endif
 }
 
@@ -14,9 +14,21 @@ typedef enum {
     LED_STATE_CONNECTED,
 } leds_state_t;
 
+// The setters may be called before leds_init(); it shows what they set
 esp_err_t leds_init(void);
 void leds_set_state(leds_state_t state);
-void leds_notify_activity(void);
+
+// Flicker the connected pattern while the relay is active (activity.h)
+// instead of holding it steady
+void leds_set_active(bool active);
+
+// Turn the LED off while the USB host is suspended; leds_set_state() still
+// records the state, and it is shown again once unpaused
+void leds_set_paused(bool paused);
+
+// Same, for the tuning profile's STATUS_LIGHTS knob (tuning.h)
+void leds_set_dark(bool dark);
+
 bool leds_is_available(void);
 
 #ifdef __cplusplus
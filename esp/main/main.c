@@ -9,14 +9,21 @@
 #include "esp_bt_main.h"
 #include "esp_event.h"
 #include "esp_gap_ble_api.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_system.h"
 #include "esp_timer.h"
 #include "nvs_flash.h"
 
 #include "esp_hid_common.h"
 #include "esp_hidh.h"
 #include "esp_hidh_gattc.h"
+#include "hid_fast_path.h"
+#include "hid_open_cache.h"
 #include "ble_central.h"
+#include "ble_conn_params.h"
+#include "ble_link.h"
 #include "usb_hid.h"
 #include "driver/uart.h"
 #include "usb_dfu.h"
@@ -30,15 +37,47 @@
 #include "transport_hid.h"
 #include "ble_hid.h"
 #include "ble_bonds.h"
+#include "bond_history.h"
 #include "relay_protocol.h"
+#include "connection_timing.h"
+#include "fault_inject.h"
+#include "link_state.h"
+#include "pairing_timing.h"
+#include "probe.h"
+#include "sysview.h"
+#include "stall_monitor.h"
+#include "trace_ring.h"
+#include "link_guard.h"
+#include "task_config.h"
+#include "power.h"
+#include "activity.h"
+#include "heap_stats.h"
+#include "ota_update.h"
+#include "persist.h"
+#include "usb_comp.h"
+#include "scan_schedule.h"
+#include "tuning.h"
+#include "relay_time.h"
 
 static const char *TAG = "MP_MAIN";
 
+// Nobody watches the signal bar closely while the MouthPad lies unused
+#define RSSI_POLL_PERIOD_US (10 * 1000 * 1000)
+#define RSSI_POLL_DEEP_IDLE_PERIOD_US (60 * 1000 * 1000)
+#if CONFIG_MOUTHPAD_LINK_GUARD
+// A link heading for a drop is watched closely
+#define RSSI_POLL_AT_RISK_PERIOD_US (CONFIG_MOUTHPAD_LINK_GUARD_READ_MS * 1000)
+#endif
+
+// Connection manager task notification bits
+#define CONN_EVENT_SCAN     (1U << 0) // Link down: scan until a MouthPad opens
+#define CONN_EVENT_DISCOVER (1U << 1) // HID open: start NUS and DIS discovery
+
 // s_active_dev now managed by transport_hid and ble_hid modules
 static esp_bd_addr_t s_active_addr;
 static esp_timer_handle_t s_rssi_timer;
 static bool s_rssi_timer_running;
-static esp_timer_handle_t s_service_discovery_timer;
+static TaskHandle_t s_conn_task;
 static bool s_has_active_addr;
 static uint16_t s_active_conn_id = 0xFFFF;
 static esp_gatt_if_t s_active_gattc_if = ESP_GATT_IF_NONE;
@@ -51,11 +90,15 @@ static uint16_t s_active_appearance = 0;
 static uint8_t s_active_manufacturer_data[32] = {0};
 static uint8_t s_active_manufacturer_len = 0;
 
+// Keys were distributed on this link, so its encryption came from pairing
+static bool s_pairing_keys;
+
 // appearance_to_string moved to ble_hid.c
 
 static void schedule_rssi_poll(void)
 {
-    if (!ble_hid_client_is_connected() || !s_has_active_addr) {
+    // Nothing shows RSSI while the host sleeps
+    if (!ble_hid_client_is_connected() || !s_has_active_addr || usb_hid_suspended()) {
         return;
     }
     esp_err_t err = esp_ble_gap_read_rssi(s_active_addr);
@@ -70,6 +113,16 @@ static void rssi_timer_callback(void *arg)
     schedule_rssi_poll();
 }
 
+static uint64_t rssi_poll_period_us(activity_level_t level)
+{
+#if CONFIG_MOUTHPAD_LINK_GUARD
+    if (link_guard_at_risk()) {
+        return RSSI_POLL_AT_RISK_PERIOD_US;
+    }
+#endif
+    return level == ACTIVITY_DEEP_IDLE ? RSSI_POLL_DEEP_IDLE_PERIOD_US : RSSI_POLL_PERIOD_US;
+}
+
 static void start_rssi_timer(void)
 {
     if (s_rssi_timer_running) {
@@ -82,7 +135,7 @@ static void start_rssi_timer(void)
         };
         ESP_ERROR_CHECK(esp_timer_create(&args, &s_rssi_timer));
     }
-    ESP_ERROR_CHECK(esp_timer_start_periodic(s_rssi_timer, 10 * 1000 * 1000));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(s_rssi_timer, rssi_poll_period_us(activity_level())));
     s_rssi_timer_running = true;
 }
 
@@ -97,9 +150,10 @@ static void stop_rssi_timer(void)
 
 // Helper functions log_report and log_addr moved to ble_hid.c
 
-static void service_discovery_timer_callback(void *arg)
+// Connection manager task, once hid_connected_cb() has run
+static void start_service_discovery(void)
 {
-    ESP_LOGI(TAG, "Starting delayed NUS and DIS service discovery");
+    ESP_LOGI(TAG, "Starting NUS and DIS service discovery");
 
     // Start NUS service discovery
 #if ENABLE_NUS_CLIENT_MODE
@@ -128,8 +182,118 @@ static bool addr_matches_active(const uint8_t *addr)
     return s_has_active_addr && addr && memcmp(addr, s_active_addr, sizeof(s_active_addr)) == 0;
 }
 
+static uint32_t uptime_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+static void fault_disconnect(void)
+{
+    esp_bd_addr_t addr;
+
+    if (transport_hid_get_active_address(addr) == ESP_OK) {
+        esp_err_t err = esp_ble_gap_disconnect(addr);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Injected disconnect failed: %s", esp_err_to_name(err));
+        }
+    }
+}
+
+static const struct fault_inject_platform s_fault_platform = {
+    .now_ms = uptime_ms,
+    .delay_us = esp_rom_delay_us,
+    .disconnect = fault_disconnect,
+};
+#endif
+
+// Not cleared at start-up, so it outlives panics, watchdog and software resets
+static __NOINIT_ATTR struct trace_ring s_trace_ring;
+
+static enum trace_reset_cause read_reset_cause(void)
+{
+    switch (esp_reset_reason()) {
+        case ESP_RST_POWERON:
+            return TRACE_RESET_POWER_ON;
+        case ESP_RST_EXT:
+            return TRACE_RESET_PIN;
+        case ESP_RST_SW:
+        case ESP_RST_USB:
+            return TRACE_RESET_SOFTWARE;
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:
+            return TRACE_RESET_WATCHDOG;
+        case ESP_RST_PANIC:
+            return TRACE_RESET_PANIC;
+        case ESP_RST_BROWNOUT:
+            return TRACE_RESET_BROWNOUT;
+        case ESP_RST_DEEPSLEEP:
+            return TRACE_RESET_WAKE;
+        default:
+            return TRACE_RESET_UNKNOWN;
+    }
+}
+
+// There is no shell on this relay: the log and ConnectionTimingRead report timings
+static void log_connection_timing(void)
+{
+    struct connection_timing_record timing[CONNECTION_TIMING_RECORDS];
+    char line[128];
+
+    if (connection_timing_get(timing) > 0) {
+        connection_timing_format(&timing[0], line, sizeof(line));
+        ESP_LOGI(TAG, "Connection timing (ms): %s", line);
+    }
+    connection_timing_format_boot(line, sizeof(line));
+    ESP_LOGI(TAG, "Boot timing (ms): %s", line);
+}
+
+// Where boot went, once app_main is done
+static void log_boot_timing(void)
+{
+    char line[128];
+
+    connection_timing_format_boot(line, sizeof(line));
+    ESP_LOGI(TAG, "Boot timing (ms): %s; init done at %lu", line, (unsigned long)uptime_ms());
+}
+
+// Pairing steps of the current link, once it is encrypted or failed to be
+static void log_pairing_timing(void)
+{
+    struct pairing_timing_record timing[PAIRING_TIMING_RECORDS];
+    char line[128];
+
+    if (pairing_timing_get(timing) > 0) {
+        pairing_timing_format(&timing[0], line, sizeof(line));
+        ESP_LOGI(TAG, "Pairing timing (ms after link up): %s", line);
+    }
+}
+
+// Ahead of a drop: more power now, and a quicker reconnect if it comes
+static void rssi_reading(int8_t rssi)
+{
+#if CONFIG_MOUTHPAD_LINK_GUARD
+    bool was_at_risk = link_guard_at_risk();
+    bool at_risk = link_guard_sample(rssi, uptime_ms());
+
+    if (at_risk != was_at_risk) {
+        ESP_LOGW(TAG, "Link %s (RSSI %d dBm)", at_risk ? "at risk" : "safe again", rssi);
+        ble_conn_params_at_risk(at_risk);
+        if (s_rssi_timer_running) {
+            esp_timer_restart(s_rssi_timer, rssi_poll_period_us(activity_level()));
+        }
+    }
+    ble_link_rssi(rssi, at_risk);
+#else
+    ble_link_rssi(rssi, false);
+#endif
+}
+
 static void gap_callback(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
 {
+    ble_link_handle_gap_event(event, param);
+
     switch (event) {
     case ESP_GAP_BLE_READ_RSSI_COMPLETE_EVT:
         if (param->read_rssi_cmpl.status == ESP_BT_STATUS_SUCCESS &&
@@ -142,10 +306,35 @@ static void gap_callback(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *p
 
             // Update relay protocol with RSSI value
             relay_protocol_update_rssi(param->read_rssi_cmpl.rssi);
+            rssi_reading(param->read_rssi_cmpl.rssi);
         } else {
             ESP_LOGW(TAG, "RSSI read failed: 0x%x", param->read_rssi_cmpl.status);
         }
         break;
+    case ESP_GAP_BLE_SEC_REQ_EVT:
+        pairing_timing_mark(PAIRING_TIMING_REQUESTED);
+        break;
+    case ESP_GAP_BLE_NC_REQ_EVT:
+        pairing_timing_mark(PAIRING_TIMING_CONFIRM);
+        break;
+    case ESP_GAP_BLE_KEY_EVT:
+        // Keys only go over an encrypted link, and only when pairing
+        pairing_timing_mark(PAIRING_TIMING_ENCRYPTED);
+        s_pairing_keys = true;
+        break;
+    case ESP_GAP_BLE_AUTH_CMPL_EVT:
+        if (param->ble_security.auth_cmpl.success) {
+            connection_timing_mark(CONNECTION_TIMING_SECURITY);
+            pairing_timing_mark(PAIRING_TIMING_ENCRYPTED);
+            if (s_pairing_keys) {
+                pairing_timing_mark(PAIRING_TIMING_DONE);
+            }
+        } else {
+            pairing_timing_failed(param->ble_security.auth_cmpl.fail_reason);
+        }
+        power_pairing_active(false);
+        log_pairing_timing();
+        break;
     case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
         if (param->update_conn_params.status == ESP_BT_STATUS_SUCCESS) {
             ESP_LOGI(TAG, "Connection params updated: interval=%d, latency=%d, timeout=%d",
@@ -179,14 +368,19 @@ bool ble_connection_is_fully_ready(void)
 void nus_ready_callback(void)
 {
     ESP_LOGI(TAG, "NUS service is ready");
+    connection_timing_mark(CONNECTION_TIMING_NUS_READY);
+    link_state_set_ready(LINK_STATE_NUS, LINK_STATE_NUS);
 
     // Check if we have cached device info with firmware version
     if (ble_device_info_has_cached_firmware()) {
         ESP_LOGI(TAG, "Cached device info exists - reporting Connected state immediately");
         s_connection_state_reported = true;
-        // Note: Connected state is determined by relay_protocol checking:
-        // s_ble_connected && ble_hid_client_is_connected()
-        // These are already set by hid_connected_cb, so app will see Connected state now
+        link_state_set_ready(LINK_STATE_READY, LINK_STATE_READY);
+        link_state_set_phase(LINK_STATE_CONNECTED);
+        log_connection_timing();
+        relay_protocol_ble_status_changed();
+        // Note: Connected state is read by relay_protocol from the link_state
+        // snapshot; HID was marked ready by ble_hid, so app will see Connected now
     } else {
         ESP_LOGI(TAG, "No cached device info - waiting for DIS to complete before reporting Connected");
         // s_connection_state_reported stays false, will be set in device_info_complete_callback
@@ -198,12 +392,17 @@ static void device_info_complete_callback(const ble_device_info_t *device_info)
 {
     // ESP_LOGI(TAG, "Device info discovery completed for connected device");
     ble_device_info_print(device_info);
+    connection_timing_mark(CONNECTION_TIMING_DIS_READY);
 
     // If we haven't reported Connected state yet, report it now
     if (!s_connection_state_reported) {
         ESP_LOGI(TAG, "DIS complete - now reporting Connected state");
         s_connection_state_reported = true;
+        link_state_set_ready(LINK_STATE_READY, LINK_STATE_READY);
+        link_state_set_phase(LINK_STATE_CONNECTED);
+        log_connection_timing();
         // Connected state is now available to relay protocol queries
+        relay_protocol_ble_status_changed();
     }
 }
 
@@ -239,6 +438,25 @@ static void gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_
         s_active_conn_id = param->connect.conn_id;
         s_active_gattc_if = gattc_if;
         ESP_LOGI(TAG, "GATT client connected, conn_id: %d, gattc_if: %d", s_active_conn_id, s_active_gattc_if);
+        connection_timing_mark(CONNECTION_TIMING_CONNECTED);
+        pairing_timing_connected();
+        s_pairing_keys = false;
+        // Full clock for the key exchange, until the link is encrypted
+        power_pairing_active(true);
+
+        // Full power until the first RSSI readings show the margin
+        ble_link_connected(param->connect.conn_handle);
+
+        // A bonded MouthPad already shares our key: start encryption now
+        // rather than on its security request, so it runs alongside the MTU
+        // exchange and service search, which need none. Protected reads and
+        // CCCD writes that get there first are retried by the stack.
+        if (gattc_if == s_hid_gattc_if && ble_bonds_is_bonded_device(param->connect.remote_bda)) {
+            esp_err_t ret = esp_ble_set_encryption(param->connect.remote_bda, ESP_BLE_SEC_ENCRYPT);
+            if (ret != ESP_OK) {
+                ESP_LOGW(TAG, "Failed to start encryption: %s", esp_err_to_name(ret));
+            }
+        }
 
 #if ENABLE_NUS_CLIENT_MODE
         // NUS service discovery will be triggered from HID open event
@@ -246,6 +464,9 @@ static void gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_
 #endif
     } else if (event == ESP_GATTC_DISCONNECT_EVT) {
         if (param->disconnect.conn_id == s_active_conn_id) {
+            if (param->disconnect.reason == ESP_GATT_CONN_TIMEOUT) {
+                link_guard_dropped();
+            }
             s_active_conn_id = 0xFFFF;
             s_active_gattc_if = ESP_GATT_IF_NONE;
             ESP_LOGI(TAG, "GATT client disconnected, conn_id: %d", param->disconnect.conn_id);
@@ -269,7 +490,13 @@ static void gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_
         // This is a DIS event on the dedicated DIS GATT interface
         ble_device_info_handle_gattc_event(event, gattc_if, param);
     } else {
-        // This is a HID event (or registration event)
+        // This is a HID event (or registration event). Responses to the
+        // open cache's own requests and input notifications taken by the
+        // fast path never reach esp_hidh.
+        if (hid_open_cache_handle_gattc_event(event, gattc_if, param) ||
+            hid_fast_path_handle_gattc_event(event, gattc_if, param)) {
+            return;
+        }
         esp_hidh_gattc_event_handler(event, gattc_if, param);
 
         // For registration events, also forward to NUS if it's app_id 1
@@ -296,11 +523,9 @@ static void hid_connected_cb(esp_hidh_dev_t *dev, const uint8_t *bda)
     if (bda) {
         ESP_LOGI(TAG, "HID device connected: " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(bda));
 
-        // Notify relay protocol that scanning has stopped
-        relay_protocol_update_ble_scanning(false);
-
         memcpy(s_active_addr, bda, sizeof(s_active_addr));
         s_has_active_addr = true;
+        link_guard_connected();
         schedule_rssi_poll();
         start_rssi_timer();
 
@@ -319,48 +544,36 @@ static void hid_connected_cb(esp_hidh_dev_t *dev, const uint8_t *bda)
             return;
         } else {
             ESP_LOGI(TAG, "Connected to bonded device successfully");
+            // Most recently used first; writes nothing when it already was
+            ble_bonds_store_device(bda);
         }
 
 
         // Set device in transport bridge
         transport_hid_set_device(dev, bda);
+        hid_open_cache_opened(bda);
+        hid_fast_path_start(s_hid_gattc_if, s_active_conn_id);
+        connection_timing_mark(CONNECTION_TIMING_HID_READY);
 
-        // Request faster connection parameters for lower latency
-        esp_ble_conn_update_params_t conn_params = {
-            .bda = {0},
-            .min_int = 0x06,  // 6 * 1.25ms = 7.5ms (minimum allowed)
-            .max_int = 0x10,  // 16 * 1.25ms = 20ms
-            .latency = 0x00,  // No slave latency for fastest response
-            .timeout = 0xC8   // 200 * 10ms = 2 seconds
-        };
-        memcpy(conn_params.bda, bda, sizeof(esp_bd_addr_t));
-        esp_err_t update_ret = esp_ble_gap_update_conn_params(&conn_params);
-        if (update_ret != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to request connection parameter update: %s", esp_err_to_name(update_ret));
-        } else {
-            ESP_LOGI(TAG, "Requested faster connection parameters (7.5-20ms interval)");
-        }
+        // Lowest latency while HID is active, relaxed once it goes idle
+        ble_conn_params_connected(bda);
+
+        // Fewer, shorter air packets for HID bursts and NUS transfers
+        ble_link_upgrade(bda);
 
 
         // ESP-IDF's built-in GATT cache handles service caching automatically
         // with CONFIG_BT_GATTC_CACHE_NVS_FLASH=y enabled
 
-        // Start NUS and DIS service discovery after a short delay to prioritize HID readiness
-        if (!s_service_discovery_timer) {
-            esp_timer_create_args_t args = {
-                .callback = &service_discovery_timer_callback,
-                .arg = NULL,
-                .dispatch_method = ESP_TIMER_TASK,
-                .name = "service_discovery"
-            };
-            ESP_ERROR_CHECK(esp_timer_create(&args, &s_service_discovery_timer));
-        }
-        ESP_ERROR_CHECK(esp_timer_start_once(s_service_discovery_timer, 50 * 1000)); // 50ms minimal delay
+        // NUS and DIS discovery run on the lower priority connection
+        // manager, so they start as soon as HID setup is done
+        xTaskNotify(s_conn_task, CONN_EVENT_DISCOVER, eSetBits);
     }
     ble_bas_reset();
     leds_set_state(LED_STATE_CONNECTED);
 
-    // Notify relay protocol of BLE connection
+    // Notify relay protocol of BLE connection; this also ends its scanning
+    // state, so the host sees searching -> connecting with nothing between
     relay_protocol_update_ble_connection(true);
 }
 
@@ -369,8 +582,16 @@ static void hid_disconnected_cb(esp_hidh_dev_t *dev)
     (void)dev;
     ESP_LOGI(TAG, "Device disconnected");
     stop_rssi_timer();
+    hid_fast_path_stop();
     s_has_active_addr = false;
     s_connection_state_reported = false;  // Reset for next connection
+    connection_timing_disconnected();
+    pairing_timing_disconnected();
+    power_pairing_active(false);
+
+    ble_conn_params_disconnected();
+    ble_conn_params_at_risk(false);
+    ble_link_reset();
 
     // Handle disconnect and release any stuck HID inputs
     transport_hid_handle_disconnect();
@@ -400,6 +621,7 @@ static void hid_battery_cb(uint8_t level, esp_err_t status)
 {
     if (status == ESP_OK) {
         ble_bas_handle_level(level);
+        connection_timing_mark(CONNECTION_TIMING_BAS_READY);
     } else {
         ESP_LOGW(TAG, "Battery event error: %d", status);
     }
@@ -429,13 +651,13 @@ static ble_central_scan_result_t *choose_best_result(ble_central_scan_result_t *
                      r->name);
         }
 
-        // Filter for devices with both HID and NUS services (MouthPad devices)
+        // A MouthPad is known by its bond or manufacturer data from the primary
+        // advertisement, or by the NUS UUID a scan response may carry
         if (r->transport == ESP_HID_TRANSPORT_BLE) {
-            bool has_both_services = r->ble.has_nus_uuid;  // NUS UUID indicates MouthPad device
-
-            if (has_both_services) {
-                bool is_bonded_device = ble_bonds_is_bonded_device(r->bda);
+            bool is_bonded_device = ble_bonds_is_bonded_device(r->bda);
+            bool is_mouthpad = is_bonded_device || r->ble.has_mouthpad_mfr || r->ble.has_nus_uuid;
 
+            if (is_mouthpad) {
                 if (has_bonded_device) {
                     // We have a bonded device - only connect to it
                     if (is_bonded_device) {
@@ -459,7 +681,7 @@ static ble_central_scan_result_t *choose_best_result(ble_central_scan_result_t *
                     }
                 }
             } else {
-                ESP_LOGD(TAG, "Skipping device: %s (appearance=0x%04X, no NUS UUID)",
+                ESP_LOGD(TAG, "Skipping device: %s (appearance=0x%04X, not a MouthPad)",
                         r->name ? r->name : "(no name)", r->ble.appearance);
             }
         }
@@ -484,7 +706,7 @@ static ble_central_scan_result_t *choose_best_result(ble_central_scan_result_t *
             if (has_bonded_device) {
                 ESP_LOGI(TAG, "Bonded device not found among %d HID device(s) (waiting for bonded device)", count);
             } else {
-                ESP_LOGI(TAG, "No suitable devices found among %d HID device(s) (need both HID and NUS UUIDs)", count);
+                ESP_LOGI(TAG, "No suitable devices found among %d HID device(s) (need MouthPad data or the NUS UUID)", count);
             }
         }
     }
@@ -492,10 +714,52 @@ static ble_central_scan_result_t *choose_best_result(ble_central_scan_result_t *
     return best;
 }
 
-static void scan_task(void *args)
+// Runs on the Bluetooth task for every HID advertisement: a bonded MouthPad ends
+// the scan at once. First-time pairing still waits out the window so
+// choose_best_result() can pick the strongest RSSI.
+static bool scan_match_bonded(const ble_central_scan_result_t *result)
 {
-    (void)args;
+    if (result->transport != ESP_HID_TRANSPORT_BLE) {
+        return false;
+    }
+
+    // The bonded address alone is enough: passive scans carry no NUS UUID
+    bool bonded = ble_bonds_is_bonded_device(result->bda);
+
+    if (!bonded && !result->ble.has_nus_uuid && !result->ble.has_mouthpad_mfr) {
+        return false;
+    }
+
+    connection_timing_mark(CONNECTION_TIMING_FIRST_ADV);
 
+    return bonded;
+}
+
+// Full rate from boot and after each boost, then backed off; read before
+// every scan
+static struct scan_schedule s_scan_schedule = {
+    .config = {
+        .fast_ms = CONFIG_MOUTHPAD_SCAN_FAST_MS,
+        .step_ms = CONFIG_MOUTHPAD_SCAN_BACKOFF_STEP_MS,
+        .fast_interval = 0x50,  // 50ms
+        .fast_window = 0x30,    // 30ms
+        .window = SCAN_SCHEDULE_UNITS(CONFIG_MOUTHPAD_SCAN_BACKOFF_WINDOW_MS),
+        .interval_min = SCAN_SCHEDULE_UNITS(CONFIG_MOUTHPAD_SCAN_BACKOFF_INTERVAL_MIN_MS),
+        .interval_max = SCAN_SCHEDULE_UNITS(CONFIG_MOUTHPAD_SCAN_BACKOFF_INTERVAL_MAX_MS),
+    },
+};
+static portMUX_TYPE s_scan_schedule_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void scan_boost(void)
+{
+    portENTER_CRITICAL_SAFE(&s_scan_schedule_lock);
+    scan_schedule_boost(&s_scan_schedule, esp_timer_get_time() / 1000);
+    portEXIT_CRITICAL_SAFE(&s_scan_schedule_lock);
+}
+
+// Scan until esp_hidh_dev_open() succeeds; the connection manager runs it
+static void scan_until_open(void)
+{
     while (true) {
         size_t results_len = 0;
         ble_central_scan_result_t *results = NULL;
@@ -512,7 +776,28 @@ static void scan_task(void *args)
             ESP_LOGI(TAG, "Scanning for MouthPad...");
         }
 
-        // Use minimum scan window (1 second) - API doesn't support sub-second scans
+#if CONFIG_MOUTHPAD_SCAN_BONDED_WHITELIST
+        // With a bond, let the controller drop every other advertiser
+        esp_bd_addr_t bonded_bda;
+        ble_central_set_scan_filter(ble_bonds_get_bonded_device(bonded_bda) == ESP_OK ?
+                                    bonded_bda : NULL);
+#endif
+
+        portENTER_CRITICAL(&s_scan_schedule_lock);
+        struct scan_schedule_params scan =
+            scan_schedule_get(&s_scan_schedule, esp_timer_get_time() / 1000);
+        portEXIT_CRITICAL(&s_scan_schedule_lock);
+        ble_central_set_scan_timing(scan.interval, scan.window);
+
+#if CONFIG_MOUTHPAD_SCAN_PASSIVE
+        // A bonded MouthPad is known from its primary advertisement; only
+        // first-time pairing needs scan responses for the NUS UUID
+        ble_central_set_scan_active(!has_bond);
+#endif
+
+        // Use minimum scan window (1 second) - API doesn't support sub-second scans.
+        // A bonded MouthPad stops it early through scan_match_bonded(). A boost
+        // takes effect with the next one.
         ble_central_scan(1, &results_len, &results);
 
         ble_central_scan_result_t *target = NULL;
@@ -532,13 +817,23 @@ static void scan_task(void *args)
 
             // ESP-IDF now handles GATT caching automatically with CONFIG_BT_GATTC_CACHE_NVS_FLASH=y
 
+            // esp_hidh_dev_open() only returns once the device is open
+            connection_timing_set_bonded(ble_bonds_is_bonded_device(target->bda));
+            connection_timing_mark(CONNECTION_TIMING_CONNECT_REQUEST);
+
+            // Discovery is the most round-trip heavy part of setup; run it at
+            // the minimum interval rather than the stack's 30-50 ms default
+            if (target->transport == ESP_HID_TRANSPORT_BLE) {
+                ble_conn_params_connecting(target->bda);
+            }
+
             esp_hidh_dev_t *dev = esp_hidh_dev_open(target->bda, target->transport, target->ble.addr_type);
             if (!dev) {
                 ESP_LOGW(TAG, "Failed to initiate connection, continuing scan");
             } else {
                 ESP_LOGI(TAG, "Connection requested");
                 ble_central_scan_results_free(results);
-                break;
+                return;
             }
         }
 
@@ -549,18 +844,44 @@ static void scan_task(void *args)
         // Minimize delay between scans for fastest discovery
         vTaskDelay(pdMS_TO_TICKS(50));
     }
+}
 
-    vTaskDelete(NULL);
+// Long-lived connection manager: scans when the link goes down and starts
+// discovery when it comes up, so neither waits on a task being created or a
+// timer
+static void conn_task(void *args)
+{
+    (void)args;
+
+    ble_central_set_scan_match_callback(scan_match_bonded);
+
+    while (true) {
+        uint32_t events = 0;
+
+        xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
+        if (events & CONN_EVENT_DISCOVER) {
+            start_service_discovery();
+        }
+        if (events & CONN_EVENT_SCAN) {
+            scan_until_open();
+        }
+    }
 }
 
 static void start_scan_task(void)
 {
     leds_set_state(LED_STATE_SCANNING);
+    scan_boost();
 
     // Notify relay protocol that scanning has started
     relay_protocol_update_ble_scanning(true);
+    connection_timing_scan_started();
 
-    xTaskCreate(scan_task, "hid_scan", 4096, NULL, 2, NULL);
+    if (!s_conn_task) {
+        xTaskCreatePinnedToCore(conn_task, "hid_scan", TASK_HID_SCAN_STACK_SIZE, NULL,
+                                TASK_HID_SCAN_PRIORITY, &s_conn_task, TASK_HID_SCAN_CORE_ID);
+    }
+    xTaskNotify(s_conn_task, CONN_EVENT_SCAN, eSetBits);
 }
 
 // Shared bond reset implementation
@@ -604,13 +925,22 @@ esp_err_t perform_bond_reset(void)
 // Button event handler
 static void button_event_handler(button_event_t event)
 {
+    // Someone is at the relay: find their MouthPad without waiting out a backed-off scan
+    scan_boost();
+
     switch (event) {
         case BUTTON_EVENT_SINGLE_CLICK:
             ESP_LOGI(TAG, "Button single click detected");
             break;
 
         case BUTTON_EVENT_DOUBLE_CLICK:
-            ESP_LOGI(TAG, "Button double click detected");
+            ESP_LOGI(TAG, "Button double click detected - next tuning profile");
+            tuning_cycle();
+            break;
+
+        case BUTTON_EVENT_TRIPLE_CLICK:
+            ESP_LOGI(TAG, "Button triple click detected - next USB composition");
+            usb_comp_cycle();
             break;
 
         case BUTTON_EVENT_LONG_PRESS:
@@ -624,6 +954,41 @@ static void button_event_handler(button_event_t event)
     }
 }
 
+// Host suspended or resumed the bus (TinyUSB task). Park the link on long
+// connection parameters and darken the LED; a MouthPad button press asks the
+// host to wake up (transport_hid.c).
+static void usb_suspend_handler(bool suspended)
+{
+    ble_conn_params_usb_suspended(suspended);
+    leds_set_paused(suspended);
+    if (!suspended) {
+        scan_boost();
+    }
+}
+
+// esp_timer task; the RSSI timer is only started and stopped from the BT tasks
+static void activity_changed(activity_level_t level)
+{
+    leds_set_active(level == ACTIVITY_ACTIVE);
+    if (s_rssi_timer_running) {
+        esp_timer_restart(s_rssi_timer, rssi_poll_period_us(level));
+    }
+}
+
+// TinyUSB, CDC and the relay protocol come up on the relay core while
+// app_main brings up Bluetooth, then app_main is notified
+static void usb_init_task(void *args)
+{
+    TaskHandle_t main_task = args;
+
+    usb_hid_set_suspend_callback(usb_suspend_handler);
+    usb_hid_init();
+    connection_timing_boot_mark(CONNECTION_TIMING_BOOT_USB_STARTED);
+
+    xTaskNotifyGive(main_task);
+    vTaskDelete(NULL);
+}
+
 // Remap UART0 for external logging (J-Link connection)
 static void setup_uart_logging(void)
 {
@@ -648,28 +1013,73 @@ void app_main(void)
 
     ESP_LOGI(TAG, "Initializing MouthPad^USB");
 
-    // Initialize bonding system early (requires NVS)
-    ESP_ERROR_CHECK(ble_bonds_init());
+    bool trace_kept = trace_ring_init(&s_trace_ring, uptime_ms, read_reset_cause());
+    if (trace_kept) {
+        ESP_LOGI(TAG, "Trace kept from before the reset (%lu boots); see \"trace\" on CDC1",
+                 (unsigned long)trace_ring_boot_count());
+    }
 
-    // ESP-IDF's built-in GATT cache is enabled via CONFIG_BT_GATTC_CACHE_NVS_FLASH=y
+    sysview_init();
+    probe_init();
 
-    esp_err_t led_err = leds_init();
-    if (led_err != ESP_OK) {
-        ESP_LOGW(TAG, "LED init failed: %s", esp_err_to_name(led_err));
-    } else {
-        leds_set_state(LED_STATE_SCANNING);
+    // Before the Bluetooth and USB stacks take their share of the heap
+    esp_err_t heap_err = heap_stats_init();
+    if (heap_err != ESP_OK) {
+        ESP_LOGW(TAG, "Heap failure counting not available: %s", esp_err_to_name(heap_err));
     }
 
-    // Initialize button module
-    esp_err_t button_err = button_init(button_event_handler);
-    if (button_err != ESP_OK) {
-        ESP_LOGW(TAG, "Button init failed: %s", esp_err_to_name(button_err));
+    // Boot phases are timed from here on, so set the clock before USB starts
+    connection_timing_init(uptime_ms);
+    pairing_timing_init(relay_time_us32);
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+    fault_inject_init(&s_fault_platform);
+    ESP_LOGW(TAG, "Fault injection built in; see \"fault\" on CDC1");
+#endif
+
+    // Before USB and BLE so their first activity is already accounted for
+    esp_err_t pm_err = power_init();
+    if (pm_err != ESP_OK) {
+        ESP_LOGW(TAG, "Power management init failed: %s", esp_err_to_name(pm_err));
     }
 
+    // Before anything that marks or follows activity
+    ESP_ERROR_CHECK(activity_init());
+    ESP_ERROR_CHECK(persist_init());
+    ESP_ERROR_CHECK(ble_conn_params_init());
+    ble_link_init();
+#if CONFIG_MOUTHPAD_LINK_GUARD
+    const struct link_guard_config guard_config = {
+        .floor_dbm = CONFIG_MOUTHPAD_LINK_GUARD_FLOOR_DBM,
+        .hysteresis_db = CONFIG_MOUTHPAD_LINK_GUARD_HYSTERESIS_DB,
+        .horizon_ms = CONFIG_MOUTHPAD_LINK_GUARD_HORIZON_MS,
+        .hold_ms = CONFIG_MOUTHPAD_LINK_GUARD_HOLD_MS,
+    };
+    link_guard_init(&guard_config);
+#endif
+    ESP_ERROR_CHECK(activity_subscribe(activity_changed));
+    ESP_ERROR_CHECK(stall_monitor_init(trace_kept));
+
+    // Initialize bonding system early (requires NVS)
+    ESP_ERROR_CHECK(ble_bonds_init());
+
+    // ESP-IDF's built-in GATT cache is enabled via CONFIG_BT_GATTC_CACHE_NVS_FLASH=y
+
+    // Before the first connection. The LED is not up yet; it takes the
+    // status light setting when it is.
+    ESP_ERROR_CHECK(tuning_init());
+
     ESP_ERROR_CHECK(ble_bas_init());
-    usb_dfu_init();
 
-    usb_hid_init();
+    // USB enumeration overlaps the Bluetooth bring-up below
+    bool usb_async = xTaskCreatePinnedToCore(usb_init_task, "usb_init", TASK_USB_INIT_STACK_SIZE,
+                                             xTaskGetCurrentTaskHandle(), TASK_USB_INIT_PRIORITY,
+                                             NULL, TASK_USB_INIT_CORE_ID) == pdPASS;
+    if (!usb_async) {
+        ESP_LOGW(TAG, "USB init task not created, starting USB here");
+        usb_hid_set_suspend_callback(usb_suspend_handler);
+        usb_hid_init();
+        connection_timing_boot_mark(CONNECTION_TIMING_BOOT_USB_STARTED);
+    }
 
     // Initialize BLE transport for HID central mode
     ESP_ERROR_CHECK(ble_central_init(HID_HOST_MODE));
@@ -685,12 +1095,19 @@ void app_main(void)
     };
 
     ESP_ERROR_CHECK(esp_hidh_init(&config));
+    hid_open_cache_init();
 
     // Initialize HID transport bridge and BLE HID client
     ESP_LOGI(TAG, "Initializing HID transport bridge");
     ESP_ERROR_CHECK(transport_hid_init());
     ESP_ERROR_CHECK(transport_hid_start());
 
+    // Samples the counters transport_hid keeps
+    esp_err_t history_err = bond_history_init();
+    if (history_err != ESP_OK && history_err != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGW(TAG, "Link history not available: %s", esp_err_to_name(history_err));
+    }
+
     ble_hid_client_config_t hid_config = {
         .connected_cb = hid_connected_cb,
         .disconnected_cb = hid_disconnected_cb,
@@ -717,13 +1134,43 @@ void app_main(void)
     ESP_LOGI(TAG, "Registering separate DIS GATT client app (app_id=2)");
     ESP_ERROR_CHECK(esp_ble_gattc_app_register(2));
 
-    // Initialize Device Info Service client
+    // Initialize Device Info Service client, loading the cached info
     ble_device_info_config_t dis_config = {
         .info_complete_cb = device_info_complete_callback
     };
     ESP_LOGI(TAG, "Initializing Device Info Service client");
     ESP_ERROR_CHECK(ble_device_info_init(&dis_config));
 
+    connection_timing_boot_mark(CONNECTION_TIMING_BOOT_BLE_READY);
+
+    // Scanning reports its state over CDC0, so USB must be up
+    if (usb_async) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
     start_scan_task();
     ESP_LOGI(TAG, "BLE HID central ready");
+
+    // The rest is not needed to find or connect to the MouthPad and comes
+    // up while the scan runs
+    esp_err_t led_err = leds_init();
+    if (led_err != ESP_OK) {
+        ESP_LOGW(TAG, "LED init failed: %s", esp_err_to_name(led_err));
+    }
+
+    // Initialize button module
+    esp_err_t button_err = button_init(button_event_handler);
+    if (button_err != ESP_OK) {
+        ESP_LOGW(TAG, "Button init failed: %s", esp_err_to_name(button_err));
+    }
+
+    usb_dfu_init();
+
+    // Marks a freshly updated image valid, so only once the bridge is up
+    esp_err_t ota_err = ota_update_init();
+    if (ota_err != ESP_OK && ota_err != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Firmware update not available: %s", esp_err_to_name(ota_err));
+    }
+
+    log_boot_timing();
 }
@@ -45,6 +45,16 @@ bool ble_connection_is_fully_ready(void);
  */
 void nus_ready_callback(void);
 
+/**
+ * @brief Scan at full rate again while no MouthPad is connected
+ *
+ * Restarts the fast part of the scan schedule (common/scan_schedule.h); the
+ * next scan picks it up. Called on boot, disconnection, button presses and
+ * USB resume, and for a BleConnectionStatusRead with scan_boost. Safe from
+ * any task.
+ */
+void scan_boost(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,191 @@
+#include "ota_update.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mbedtls/sha256.h"
+#include "fw_update.h"
+#include "relay_protocol.h"
+#include "task_config.h"
+#include "MouthpadRelay.pb.h"
+
+static const char *TAG = "OTA_UPDATE";
+
+// Time for the final FwUpdateStatus to reach the host before the restart
+#define OTA_UPDATE_REBOOT_DELAY_MS 500
+
+static TaskHandle_t s_task;
+static atomic_bool s_available;
+
+// Owned by the fw_update task
+static const esp_partition_t *s_partition;
+static esp_ota_handle_t s_handle;
+static bool s_open;
+static mbedtls_sha256_context s_sha;
+static bool s_reboot;
+
+// The ops return esp_err_t codes negated, as fw_update.h asks of platform
+// errors; FwUpdateStatus.detail then carries -esp_err_t
+static int update_begin(uint32_t size) {
+    s_partition = esp_ota_get_next_update_partition(NULL);
+    if (!s_partition) {
+        return -ESP_ERR_NOT_FOUND;
+    }
+    if (size > s_partition->size) {
+        ESP_LOGW(TAG, "Image of %lu B does not fit %s (%lu B)", (unsigned long)size,
+                 s_partition->label, (unsigned long)s_partition->size);
+        return FW_UPDATE_ERR_TOO_LARGE;
+    }
+
+    // Sequential writes erase each sector as the image reaches it, rather
+    // than the whole image up front with both caches off
+    esp_err_t ret = esp_ota_begin(s_partition, OTA_WITH_SEQUENTIAL_WRITES, &s_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin failed: %s", esp_err_to_name(ret));
+        return -ret;
+    }
+
+    s_open = true;
+    mbedtls_sha256_init(&s_sha);
+    mbedtls_sha256_starts(&s_sha, 0);
+    ESP_LOGI(TAG, "Receiving %lu B into %s", (unsigned long)size, s_partition->label);
+    return 0;
+}
+
+static int update_write(uint32_t offset, const uint8_t *data, size_t len) {
+    (void)offset;
+
+    mbedtls_sha256_update(&s_sha, data, len);
+    esp_err_t ret = esp_ota_write(s_handle, data, len);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_write failed: %s", esp_err_to_name(ret));
+        return -ret;
+    }
+    return 0;
+}
+
+static void update_abort(void) {
+    if (s_open) {
+        esp_ota_abort(s_handle);
+        mbedtls_sha256_free(&s_sha);
+        s_open = false;
+        ESP_LOGI(TAG, "Update dropped");
+    }
+}
+
+static int update_finish(uint32_t size, const uint8_t *sha256) {
+    uint8_t digest[FW_UPDATE_SHA256_LEN];
+
+    (void)size;
+    mbedtls_sha256_finish(&s_sha, digest);
+    if (memcmp(digest, sha256, sizeof(digest)) != 0) {
+        ESP_LOGW(TAG, "SHA-256 mismatch");
+        update_abort();
+        return FW_UPDATE_ERR_VERIFY;
+    }
+
+    mbedtls_sha256_free(&s_sha);
+    s_open = false;
+
+    // Checks the image header, segments and its own appended hash
+    esp_err_t ret = esp_ota_end(s_handle);
+    if (ret == ESP_ERR_OTA_VALIDATE_FAILED) {
+        ESP_LOGW(TAG, "Image rejected by esp_ota_end");
+        return FW_UPDATE_ERR_VERIFY;
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_end failed: %s", esp_err_to_name(ret));
+        return -ret;
+    }
+
+    ret = esp_ota_set_boot_partition(s_partition);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_set_boot_partition failed: %s", esp_err_to_name(ret));
+        return -ret;
+    }
+
+    ESP_LOGI(TAG, "Image verified; %s boots after the next restart", s_partition->label);
+    return 0;
+}
+
+static void update_reboot(void) {
+    // fw_update_process() has sent the last status; restart from the task
+    // loop once it returns
+    s_reboot = true;
+}
+
+static void update_send_status(const mouthware_message_FwUpdateStatus *status) {
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_fw_update_status_tag;
+    relay_msg.message_body.fw_update_status = *status;
+    relay_protocol_send_response(&relay_msg);
+}
+
+static void update_kick(void) {
+    xTaskNotifyGive(s_task);
+}
+
+static const struct fw_update_ops s_ops = {
+    .begin = update_begin,
+    .write = update_write,
+    .finish = update_finish,
+    .abort = update_abort,
+    .reboot = update_reboot,
+    .send_status = update_send_status,
+    .kick = update_kick,
+};
+
+static void fw_update_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        fw_update_process();
+
+        if (s_reboot) {
+            vTaskDelay(pdMS_TO_TICKS(OTA_UPDATE_REBOOT_DELAY_MS));
+            esp_restart();
+        }
+    }
+}
+
+esp_err_t ota_update_init(void) {
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t state;
+
+    // A trial boot after an update; getting this far is the trial
+    if (esp_ota_get_state_partition(running, &state) == ESP_OK &&
+        state == ESP_OTA_IMG_PENDING_VERIFY) {
+        esp_err_t ret = esp_ota_mark_app_valid_cancel_rollback();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Could not mark %s valid: %s", running->label, esp_err_to_name(ret));
+            return ret;
+        }
+        ESP_LOGI(TAG, "Running image %s marked valid", running->label);
+    }
+
+    if (!esp_ota_get_next_update_partition(NULL)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (xTaskCreatePinnedToCore(fw_update_task, "fw_update", TASK_FW_UPDATE_STACK_SIZE, NULL,
+                                TASK_FW_UPDATE_PRIORITY, &s_task,
+                                TASK_FW_UPDATE_CORE_ID) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create fw_update task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    fw_update_init(&s_ops);
+    atomic_store(&s_available, true);
+    return ESP_OK;
+}
+
+bool ota_update_available(void) {
+    return atomic_load(&s_available);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Next-OTA-partition writer for common/fw_update: FwUpdateStart/Chunk/End on
+// CDC0 stream an app image into the partition after the running one while
+// the bridge keeps running. The low priority fw_update task writes it with
+// esp_ota_write(), erasing a sector at a time, and hashes it as it goes;
+// FwUpdateEnd compares the SHA-256, lets esp_ota_end() check the image and
+// sets it as the boot partition.
+//
+// Needs a partition table with two OTA slots (make OTA=1). With rollback on,
+// as sdkconfig.ota sets it, the new image boots once on trial and marks
+// itself valid in ota_update_init(); the bootloader returns to the old one
+// if it resets before that.
+
+// Mark a trial image valid and start the fw_update task. ESP_ERR_NOT_FOUND
+// without an OTA partition to write to.
+esp_err_t ota_update_init(void);
+
+// True once ota_update_init() has succeeded
+bool ota_update_available(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,98 @@
+#include "persist.h"
+
+#include <stdbool.h>
+
+#include "activity.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_config.h"
+
+static const char *TAG = "PERSIST";
+
+#define PERSIST_MAX_CLIENTS 4
+
+// How often a held-back flush looks at the activity level again
+#define PERSIST_RECHECK_MS 1000
+
+static persist_flush_t s_flush[PERSIST_MAX_CLIENTS];
+static int s_client_count;
+
+// Client bits waiting for a flush
+static uint32_t s_pending;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task;
+
+static void persist_task(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        TickType_t start = xTaskGetTickCount();
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_MOUTHPAD_PERSIST_DELAY_MS));
+
+        // Flash writes stall the caches of both cores; wait for the user to
+        // pause, but not forever
+        while (activity_level() == ACTIVITY_ACTIVE &&
+               (xTaskGetTickCount() - start) * portTICK_PERIOD_MS <
+                   CONFIG_MOUTHPAD_PERSIST_MAX_DEFER_MS) {
+            vTaskDelay(pdMS_TO_TICKS(PERSIST_RECHECK_MS));
+        }
+
+        // Taken before flushing so a change made meanwhile asks again
+        taskENTER_CRITICAL(&s_lock);
+        uint32_t pending = s_pending;
+        s_pending = 0;
+        taskEXIT_CRITICAL(&s_lock);
+
+        ESP_LOGD(TAG, "Flushing 0x%02lx", (unsigned long)pending);
+        for (int i = 0; i < s_client_count; i++) {
+            if (pending & (1u << i)) {
+                s_flush[i]();
+            }
+        }
+    }
+}
+
+esp_err_t persist_init(void)
+{
+    if (s_task != NULL) {
+        return ESP_OK;
+    }
+
+    if (xTaskCreatePinnedToCore(persist_task, "persist", TASK_PERSIST_STACK_SIZE, NULL,
+                                TASK_PERSIST_PRIORITY, &s_task,
+                                TASK_PERSIST_CORE_ID) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create persist task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+int persist_register(persist_flush_t flush)
+{
+    if (s_client_count >= PERSIST_MAX_CLIENTS) {
+        return -1;
+    }
+
+    s_flush[s_client_count] = flush;
+    return s_client_count++;
+}
+
+void persist_request(int id)
+{
+    if (id < 0 || s_task == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&s_lock);
+    bool first = s_pending == 0;
+    s_pending |= 1u << id;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (first) {
+        xTaskNotifyGive(s_task);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deferred NVS writes. Modules keep their persistent state in RAM, compare
+// against it, and call persist_request() only when something changed. The
+// persist task runs their flush function CONFIG_MOUTHPAD_PERSIST_DELAY_MS
+// after the first request, once the activity level has left active or
+// CONFIG_MOUTHPAD_PERSIST_MAX_DEFER_MS have passed. Requests made in the
+// meantime are coalesced into that flush, so connection setup never waits
+// on flash and costs no write when nothing changed.
+
+// Called from the persist task; writes whatever is dirty
+typedef void (*persist_flush_t)(void);
+
+// Before any module registers
+esp_err_t persist_init(void);
+
+// Register during init; returns the id for persist_request(), or -1 when
+// all slots are taken
+int persist_register(persist_flush_t flush);
+
+// Have the module's flush run in the next quiet spell; safe from any task
+void persist_request(int id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,178 @@
+#include "power.h"
+
+#if CONFIG_MOUTHPAD_PM
+
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "POWER";
+
+// The CPU runs at CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ only while a lock below
+// asks for it, and drops to CONFIG_MOUTHPAD_PM_MIN_FREQ_MHZ otherwise:
+//
+//   hid  CPU_FREQ_MAX  HID reports flowing (ble_conn_params active state)
+//   cdc  CPU_FREQ_MAX  for CONFIG_MOUTHPAD_PM_CDC_HOLD_MS after CDC0 traffic
+//   usb  APB_FREQ_MAX  USB enumerated and not suspended
+//   pair CPU_FREQ_MAX  link up and not yet encrypted (pairing key exchange)
+//
+// The usb lock keeps the PLL running, which the USB PHY needs, so while the
+// host is awake the floor is the 80 MHz APB clock. Going below it, and into
+// automatic light sleep, only happens while the host has suspended the bus
+// (or it is detached). The BT controller takes its own locks around radio
+// activity and modem-sleeps in between.
+#define CDC_HOLD_US ((int64_t)CONFIG_MOUTHPAD_PM_CDC_HOLD_MS * 1000)
+
+// Host resume signalling drives D- high (K state on a full-speed bus)
+#define USB_DM_GPIO GPIO_NUM_19
+
+static esp_pm_lock_handle_t s_hid_lock;
+static esp_pm_lock_handle_t s_cdc_lock;
+static esp_pm_lock_handle_t s_usb_lock;
+static esp_pm_lock_handle_t s_pair_lock;
+static esp_timer_handle_t s_cdc_timer;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_hid_held;
+static bool s_cdc_held;
+static bool s_usb_held;
+static bool s_pair_held;
+static int64_t s_last_cdc_us;
+
+static void cdc_timer_callback(void *arg)
+{
+    (void)arg;
+    bool release = false;
+    int64_t remaining_us = 0;
+
+    taskENTER_CRITICAL(&s_lock);
+    if (s_cdc_held) {
+        remaining_us = s_last_cdc_us + CDC_HOLD_US - esp_timer_get_time();
+        if (remaining_us <= 0) {
+            s_cdc_held = false;
+            release = true;
+        }
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (release) {
+        esp_pm_lock_release(s_cdc_lock);
+    } else if (remaining_us > 0) {
+        esp_timer_start_once(s_cdc_timer, remaining_us);
+    }
+}
+
+// Take or drop a lock on a state change only; esp_pm locks are counted
+static void set_held(esp_pm_lock_handle_t lock, bool *held, bool want)
+{
+    bool change;
+
+    taskENTER_CRITICAL(&s_lock);
+    change = *held != want;
+    *held = want;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (!change) {
+        return;
+    }
+    if (want) {
+        esp_pm_lock_acquire(lock);
+    } else {
+        esp_pm_lock_release(lock);
+    }
+}
+
+esp_err_t power_init(void)
+{
+    esp_err_t ret;
+
+    ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "hid", &s_hid_lock);
+    if (ret == ESP_OK) {
+        ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "cdc", &s_cdc_lock);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "usb", &s_usb_lock);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "pair", &s_pair_lock);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create PM locks: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    esp_timer_create_args_t args = {
+        .callback = &cdc_timer_callback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "pm_cdc_hold"
+    };
+    ret = esp_timer_create(&args, &s_cdc_timer);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // USB starts out active so enumeration runs at full clock
+    set_held(s_usb_lock, &s_usb_held, true);
+
+#if CONFIG_MOUTHPAD_PM_LIGHT_SLEEP
+    gpio_wakeup_enable(USB_DM_GPIO, GPIO_INTR_HIGH_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+#endif
+
+    esp_pm_config_t config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_MOUTHPAD_PM_MIN_FREQ_MHZ,
+#if CONFIG_MOUTHPAD_PM_LIGHT_SLEEP
+        .light_sleep_enable = true,
+#else
+        .light_sleep_enable = false,
+#endif
+    };
+    ret = esp_pm_configure(&config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_pm_configure failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Power management: %d-%d MHz, light sleep %s", config.min_freq_mhz,
+             config.max_freq_mhz, config.light_sleep_enable ? "on" : "off");
+    return ESP_OK;
+}
+
+void power_hid_active(bool active)
+{
+    set_held(s_hid_lock, &s_hid_held, active);
+}
+
+void power_cdc_activity(void)
+{
+    bool acquire;
+
+    taskENTER_CRITICAL(&s_lock);
+    s_last_cdc_us = esp_timer_get_time();
+    acquire = !s_cdc_held;
+    s_cdc_held = true;
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (acquire) {
+        esp_pm_lock_acquire(s_cdc_lock);
+        esp_timer_stop(s_cdc_timer);
+        esp_timer_start_once(s_cdc_timer, CDC_HOLD_US);
+    }
+}
+
+void power_usb_active(bool active)
+{
+    set_held(s_usb_lock, &s_usb_held, active);
+}
+
+void power_pairing_active(bool active)
+{
+    set_held(s_pair_lock, &s_pair_held, active);
+}
+
+#endif // CONFIG_MOUTHPAD_PM
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_MOUTHPAD_PM
+
+// Configure dynamic frequency scaling and create the activity locks
+esp_err_t power_init(void);
+
+// HID reports are flowing; the CPU stays at its maximum frequency until
+// called with false
+void power_hid_active(bool active);
+
+// Host traffic on CDC0; holds the maximum frequency for
+// CONFIG_MOUTHPAD_PM_CDC_HOLD_MS. Cheap enough to call for every packet.
+void power_cdc_activity(void);
+
+// USB enumerated and not suspended. While it is, the APB clock (and the PLL
+// the USB PHY runs from) stays up and light sleep is blocked.
+void power_usb_active(bool active);
+
+// From link up until the link is encrypted; Bluedroid works out the LE Secure
+// Connections keys in software, and at the maximum frequency it is done sooner
+void power_pairing_active(bool active);
+
+#else
+
+static inline esp_err_t power_init(void) { return ESP_OK; }
+static inline void power_hid_active(bool active) { (void)active; }
+static inline void power_cdc_activity(void) {}
+static inline void power_usb_active(bool active) { (void)active; }
+static inline void power_pairing_active(bool active) { (void)active; }
+
+#endif // CONFIG_MOUTHPAD_PM
+
+#ifdef __cplusplus
+}
+#endif
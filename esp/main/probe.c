@@ -0,0 +1,51 @@
+#include "probe.h"
+
+#if CONFIG_MOUTHPAD_PROBE_GPIO
+
+#include <stdatomic.h>
+
+#include "driver/gpio.h"
+#include "esp_log.h"
+
+#include "board_config.h"
+
+static const char *TAG = "PROBE";
+
+static const gpio_num_t s_pins[RELAY_PROBE_COUNT] = BOARD_PROBE_GPIOS;
+
+// Bit n is the level of probe n's pin
+static atomic_uint s_levels;
+
+void probe_mark(enum relay_probe probe)
+{
+    unsigned int bit = 1u << probe;
+    unsigned int levels = atomic_fetch_xor_explicit(&s_levels, bit, memory_order_relaxed) ^ bit;
+
+    gpio_set_level(s_pins[probe], (levels & bit) != 0);
+}
+
+void probe_init(void)
+{
+    for (int i = 0; i < RELAY_PROBE_COUNT; i++) {
+        gpio_config_t config = {
+            .pin_bit_mask = 1ULL << s_pins[i],
+            .mode = GPIO_MODE_OUTPUT,
+        };
+        esp_err_t err = gpio_config(&config);
+
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Probe %d on GPIO%d failed: %s", i, s_pins[i], esp_err_to_name(err));
+            continue;
+        }
+        gpio_set_level(s_pins[i], 0);
+    }
+    ESP_LOGI(TAG, "GPIO probes on");
+}
+
+#else
+
+void probe_init(void)
+{
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#include "relay_probes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// GPIO toggles at the relay hot paths (common/relay_probes.h), for timing
+// with a logic analyzer or a PPK2. With sdkconfig.probes (make PROBES=1)
+// each point toggles its pin from BOARD_PROBE_GPIOS in board_config.h.
+// Without it they compile to nothing.
+
+#if CONFIG_MOUTHPAD_PROBE_GPIO
+
+void probe_mark(enum relay_probe probe);
+
+#else
+
+static inline void probe_mark(enum relay_probe probe) { (void)probe; }
+
+#endif
+
+// Drive the probe pins low; a no-op without them
+void probe_init(void);
+
+#ifdef __cplusplus
+}
+#endif
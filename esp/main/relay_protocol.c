@@ -1,37 +1,144 @@
 #include "relay_protocol.h"
 
 #include "MouthpadRelay.pb.h"
-#include "pb_decode.h"
 #include "pb_encode.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/ringbuf.h"
 #include "usb_cdc.h"
+#include "usb_hid.h"
 #include "usb_dfu.h"
 #include "ble_nus.h"
 #include "ble_hid.h"
-#include "ble_bas.h"
 #include "ble_dis.h"
+#include "ble_link.h"
 #include "ble_bonds.h"
 #include "transport_hid.h"
 #include "leds.h"
 #include "main.h"
-
+#include "ota_update.h"
+#include "mouthpad_frame.h"
+#include "mouthpad_pass_through.h"
+#include "pass_through_ack.h"
+#include "connection_timing.h"
+#include "hid_latency.h"
+#include "heap_stats.h"
+#include "hid_mirror.h"
+#include "fw_update.h"
+#include "nus_stream.h"
+#include "sensor_codec.h"
+#include "sensor_stream.h"
+#include "link_history.h"
+#include "link_state.h"
+#include "link_telemetry.h"
+#include "relay_dispatch.h"
+#include "relay_time.h"
+#include "stall_watch.h"
+#include "usb_phase.h"
+#include "probe.h"
+#include "sysview.h"
+#include "task_config.h"
+#include "task_stats.h"
+#include "trace_ring.h"
+#include "tuning.h"
+#include "tuning_profile.h"
+#include "usb_comp.h"
+
+#include <stdatomic.h>
 #include <string.h>
+#include <sys/param.h>
 
 static const char *TAG = "RELAY_PROTO";
 
-// Internal state
-static bool s_ble_connected = false;
-static bool s_ble_scanning = false;
-static int32_t s_last_rssi = 0;
+// Last connection status the host was told about, by a pushed
+// BleConnectionStatusResponse or the answer to its own read
+static atomic_int s_reported_status =
+    mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_DISCONNECTED;
+
+// Fragmented PassThroughToMouthpad payloads are reassembled here and queued
+// to the NUS TX task by reference, so the buffer stays busy until the
+// final fragment's completion is reported
+static uint8_t s_pass_through_buf[CONFIG_MOUTHPAD_PASS_THROUGH_MAX_LEN];
+static uint16_t s_pass_through_len = 0;
+static uint32_t s_pass_through_next_fragment = 0;
+static volatile bool s_pass_through_busy = false;
+
+// Completions the host asked to hear about together (pass_through_ack.h).
+// The NUS TX task and relay_proto feed it; the esp_timer task flushes it
+// once the oldest has waited PASS_THROUGH_ACK_INTERVAL_US.
+static struct pass_through_ack s_pass_through_ack;
+static portMUX_TYPE s_pass_through_ack_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t s_pass_through_ack_timer;
+
+// Pass-through losses in each direction, for LinkTelemetry
+static atomic_uint s_nus_rx_dropped;
+static atomic_uint s_nus_tx_dropped;
+
+// MouthPad notifications wait here for the nus_rx task, one item each, so
+// the Bluetooth (BTC) task never waits on the CDC0 TX mutex or TinyUSB
+// behind a host that is slow to read. The notification is copied into the
+// ring once and framed for CDC0 straight from its item.
+static RingbufHandle_t s_nus_rx_ring;
+static atomic_uint s_nus_rx_queue_full;
+
+// EchoRequest waiting for its timed NUS write to the MouthPad; one at a time
+static mouthware_message_EchoResponse s_echo;
+static atomic_bool s_echo_pending;
+
+// Encoded DeviceInfoResponse, rebuilt on the relay_proto task once the
+// generation has moved past the one it was built at. Name, firmware and
+// address strings of up to 63, 63 and 17 characters plus the fixed fields.
+#define DEVICE_INFO_ENCODED_MAX 192
+static atomic_uint s_device_info_generation = 1;
+static unsigned int s_device_info_cached_generation;
+static uint8_t s_device_info_buf[DEVICE_INFO_ENCODED_MAX];
+static size_t s_device_info_len;
+
+// LinkTelemetry stream: the latest LinkTelemetrySubscribe is handed to the
+// esp_timer task, the only one that touches link_telemetry
+static esp_timer_handle_t s_telemetry_timer;
+static portMUX_TYPE s_telemetry_lock = portMUX_INITIALIZER_UNLOCKED;
+static mouthware_message_LinkTelemetrySubscribe s_telemetry_request;
+static bool s_telemetry_request_pending;
+
+// Drains hid_mirror from the esp_timer task, the ring's only consumer
+static esp_timer_handle_t s_mirror_timer;
 
 // Forward declarations
-static esp_err_t handle_ble_connection_status_read(void);
-static esp_err_t handle_device_info_read(void);
-static esp_err_t handle_clear_bonds_write(void);
-static esp_err_t handle_clear_firmware_cache_write(void);
-static esp_err_t handle_dfu_write(void);
-static esp_err_t handle_pass_through_to_mouthpad(const uint8_t *data, size_t len);
+static const char *fill_ble_connection_status(mouthware_message_RelayToAppMessage *relay_msg);
+static esp_err_t handle_ble_connection_status_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_device_info_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_clear_bonds_write(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_clear_firmware_cache_write(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_dfu_write(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_hid_config(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_pass_through_batch_config(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_connection_timing_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_hid_latency_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_link_telemetry_subscribe(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_relay_capabilities_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_echo_request(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_hid_mirror_config(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_thread_stats_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_trace_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_link_history_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_mem_stats_read(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_fw_update(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_nus_stream(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_sensor_stream_filter(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_sensor_codec_config(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_sensor_stream_rate(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_relay_profile(const mouthware_message_AppToRelayMessage *msg);
+static esp_err_t handle_usb_composition(const mouthware_message_AppToRelayMessage *msg);
+static void telemetry_timer_callback(void *arg);
+static void mirror_timer_callback(void *arg);
+static void pass_through_ack_timer_callback(void *arg);
+static esp_err_t handle_pass_through_to_mouthpad(const struct mouthpad_pass_through_to_mouthpad *msg);
+static void reset_pass_through_fragments(void);
+static esp_err_t send_message(const mouthware_message_RelayToAppMessage *relay_msg, bool flush);
 
 // Nanopb callbacks for string encoding
 static bool encode_string_callback(pb_ostream_t *stream, const pb_field_t *field, void * const *arg) {
@@ -44,76 +151,185 @@ static bool encode_string_callback(pb_ostream_t *stream, const pb_field_t *field
     return pb_encode_string(stream, (const uint8_t *)str, strlen(str));
 }
 
-esp_err_t relay_protocol_init(void) {
-    ESP_LOGI(TAG, "Relay protocol initialized");
-    return ESP_OK;
+// Indexed by which_message_body. Inline handlers only touch RAM and run on
+// the cdc_rx task with frame decoding; the rest run on the relay_proto task
+// so they cannot hold up the frames behind them.
+#define RELAY_HANDLER(msg, fn, inl) \
+    [mouthware_message_AppToRelayMessage_##msg##_tag] = { #msg, handle_##fn, inl }
+
+static const struct relay_dispatch_entry s_dispatch_table[RELAY_DISPATCH_TAG_COUNT] = {
+    RELAY_HANDLER(ble_connection_status_read, ble_connection_status_read, false),
+    RELAY_HANDLER(device_info_read, device_info_read, false),
+    RELAY_HANDLER(clear_bonds_write, clear_bonds_write, false),
+    RELAY_HANDLER(dfu_write, dfu_write, false),
+    RELAY_HANDLER(clear_firmware_cache_write, clear_firmware_cache_write, false),
+    RELAY_HANDLER(hid_latency_read, hid_latency_read, false),
+    RELAY_HANDLER(hid_config_read, hid_config, true),
+    RELAY_HANDLER(hid_config_write, hid_config, true),
+    RELAY_HANDLER(pass_through_batch_config_write, pass_through_batch_config, true),
+    RELAY_HANDLER(connection_timing_read, connection_timing_read, false),
+    RELAY_HANDLER(link_telemetry_subscribe, link_telemetry_subscribe, true),
+    RELAY_HANDLER(relay_capabilities_read, relay_capabilities_read, true),
+    RELAY_HANDLER(echo_request, echo_request, true),
+    RELAY_HANDLER(hid_mirror_config_write, hid_mirror_config, true),
+    RELAY_HANDLER(thread_stats_read, thread_stats_read, false),
+    RELAY_HANDLER(trace_read, trace_read, false),
+    RELAY_HANDLER(mem_stats_read, mem_stats_read, false),
+    RELAY_HANDLER(fw_update_start, fw_update, true),
+    RELAY_HANDLER(fw_update_chunk, fw_update, true),
+    RELAY_HANDLER(fw_update_end, fw_update, true),
+    RELAY_HANDLER(nus_stream_control, nus_stream, true),
+    RELAY_HANDLER(nus_stream_write, nus_stream, true),
+    RELAY_HANDLER(sensor_stream_filter_write, sensor_stream_filter, true),
+    RELAY_HANDLER(sensor_codec_config_write, sensor_codec_config, true),
+    RELAY_HANDLER(sensor_stream_rate_write, sensor_stream_rate, true),
+    RELAY_HANDLER(relay_profile_write, relay_profile, false),
+    RELAY_HANDLER(usb_composition_write, usb_composition, false),
+    RELAY_HANDLER(link_history_read, link_history_read, false),
+};
+
+#undef RELAY_HANDLER
+
+static TaskHandle_t s_protocol_task;
+
+static void protocol_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        relay_dispatch_run();
+    }
 }
 
-esp_err_t relay_protocol_handle_usb_data(const uint8_t *data, uint16_t len) {
-    if (!data || len == 0) {
-        ESP_LOGW(TAG, "Invalid USB data");
-        return ESP_ERR_INVALID_ARG;
+static void dispatch_kick(void) {
+    xTaskNotifyGive(s_protocol_task);
+}
+
+static uint32_t dispatch_now_us(void) {
+    return (uint32_t)esp_timer_get_time();
+}
+
+static void *dispatch_context(void) {
+    return xTaskGetCurrentTaskHandle();
+}
+
+// Answer a request with a request_id that was refused or failed
+static void dispatch_reject(uint32_t request_id, pb_size_t tag, mouthware_message_RequestErrorCode code) {
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+
+    relay_msg.request_id = request_id;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_request_error_tag;
+    relay_msg.message_body.request_error.code = code;
+    relay_msg.message_body.request_error.request_tag = tag;
+    relay_protocol_send_response(&relay_msg);
+}
+
+static void forward_ble_data(const uint8_t *data, uint16_t len);
+
+static void nus_rx_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        size_t len;
+        uint8_t *item = xRingbufferReceive(s_nus_rx_ring, &len, portMAX_DELAY);
+
+        if (item == NULL) {
+            continue;
+        }
+        forward_ble_data(item, (uint16_t)len);
+        vRingbufferReturnItem(s_nus_rx_ring, item);
     }
+}
 
-    // Decode AppToRelayMessage
-    mouthware_message_AppToRelayMessage app_msg = mouthware_message_AppToRelayMessage_init_zero;
+esp_err_t relay_protocol_init(void) {
+    s_nus_rx_ring = xRingbufferCreate(CONFIG_MOUTHPAD_NUS_RX_QUEUE_SIZE, RINGBUF_TYPE_NOSPLIT);
+    if (s_nus_rx_ring == NULL ||
+        xTaskCreatePinnedToCore(nus_rx_task, "nus_rx", TASK_NUS_RX_STACK_SIZE, NULL,
+                                TASK_NUS_RX_PRIORITY, NULL, TASK_NUS_RX_CORE_ID) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create NUS RX queue");
+        return ESP_ERR_NO_MEM;
+    }
 
-    pb_istream_t stream = pb_istream_from_buffer(data, len);
-    bool status = pb_decode(&stream, &mouthware_message_AppToRelayMessage_msg, &app_msg);
+    if (xTaskCreatePinnedToCore(protocol_task, "relay_proto", TASK_RELAY_PROTO_STACK_SIZE, NULL,
+                                TASK_RELAY_PROTO_PRIORITY, &s_protocol_task,
+                                TASK_RELAY_PROTO_CORE_ID) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create protocol task");
+        return ESP_ERR_NO_MEM;
+    }
+    relay_dispatch_init(&(struct relay_dispatch_config){
+        .table = s_dispatch_table,
+        .pass_through = handle_pass_through_to_mouthpad,
+        .kick = dispatch_kick,
+        .now_us = dispatch_now_us,
+        .context = dispatch_context,
+        .reject = dispatch_reject,
+    });
+
+    esp_timer_create_args_t args = {
+        .callback = &telemetry_timer_callback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "link_telemetry"
+    };
+    esp_err_t ret = esp_timer_create(&args, &s_telemetry_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create telemetry timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
 
-    if (!status) {
-        ESP_LOGW(TAG, "Failed to decode AppToRelayMessage: %s", PB_GET_ERROR(&stream));
-        return ESP_FAIL;
+    args.callback = &mirror_timer_callback;
+    args.name = "hid_mirror";
+    ret = esp_timer_create(&args, &s_mirror_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create HID mirror timer: %s", esp_err_to_name(ret));
+        return ret;
     }
 
-    ESP_LOGD(TAG, "Decoded AppToRelayMessage, destination=%d, which=%d",
-             app_msg.destination, app_msg.which_message_body);
+    args.callback = &pass_through_ack_timer_callback;
+    args.name = "pass_through_ack";
+    ret = esp_timer_create(&args, &s_pass_through_ack_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create pass-through ack timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
 
-    // Route message based on which_message_body
-    esp_err_t ret = ESP_OK;
+    ESP_LOGI(TAG, "Relay protocol initialized");
+    return ESP_OK;
+}
 
-    switch (app_msg.which_message_body) {
-        case mouthware_message_AppToRelayMessage_ble_connection_status_read_tag:
-            ESP_LOGD(TAG, "Handling BleConnectionStatusRead");
-            ret = handle_ble_connection_status_read();
-            break;
+esp_err_t relay_protocol_handle_usb_data(const uint8_t *data, uint16_t len) {
+    if (!data || len == 0) {
+        ESP_LOGW(TAG, "Invalid USB data");
+        return ESP_ERR_INVALID_ARG;
+    }
 
-        case mouthware_message_AppToRelayMessage_device_info_read_tag:
-            ESP_LOGD(TAG, "Handling DeviceInfoRead");
-            ret = handle_device_info_read();
-            break;
+    probe_mark(RELAY_PROBE_FRAME_RX);
+    sysview_mark_start(RELAY_MARKER_PB_DECODE);
+    enum relay_dispatch_result result = relay_dispatch_submit(data, len);
+    sysview_mark_stop(RELAY_MARKER_PB_DECODE);
 
-        case mouthware_message_AppToRelayMessage_clear_bonds_write_tag:
-            ESP_LOGD(TAG, "Handling ClearBondsWrite");
-            ret = handle_clear_bonds_write();
-            break;
+    switch (result) {
+        case RELAY_DISPATCH_DONE:
+        case RELAY_DISPATCH_QUEUED:
+            return ESP_OK;
 
-        case mouthware_message_AppToRelayMessage_clear_firmware_cache_write_tag:
-            ESP_LOGD(TAG, "Handling ClearFirmwareCacheWrite");
-            ret = handle_clear_firmware_cache_write();
-            break;
+        case RELAY_DISPATCH_DECODE_ERROR:
+            ESP_LOGW(TAG, "Failed to decode AppToRelayMessage (%u bytes)", len);
+            return ESP_FAIL;
 
-        case mouthware_message_AppToRelayMessage_dfu_write_tag:
-            ESP_LOGD(TAG, "Handling DfuWrite");
-            ret = handle_dfu_write();
-            break;
+        case RELAY_DISPATCH_UNHANDLED:
+            ESP_LOGW(TAG, "Unknown message type");
+            return ESP_ERR_NOT_SUPPORTED;
 
-        case mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag:
-            ESP_LOGD(TAG, "Handling PassThroughToMouthpad, len=%d",
-                     app_msg.message_body.pass_through_to_mouthpad.data.size);
-            ret = handle_pass_through_to_mouthpad(
-                app_msg.message_body.pass_through_to_mouthpad.data.bytes,
-                app_msg.message_body.pass_through_to_mouthpad.data.size
-            );
-            break;
+        case RELAY_DISPATCH_FULL:
+            ESP_LOGW(TAG, "Protocol queue full, message dropped");
+            trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_PROTOCOL);
+            return ESP_ERR_NO_MEM;
 
+        case RELAY_DISPATCH_FAILED:
         default:
-            ESP_LOGW(TAG, "Unknown message type: %d", app_msg.which_message_body);
-            ret = ESP_ERR_NOT_SUPPORTED;
-            break;
+            return ESP_FAIL;
     }
-
-    return ret;
 }
 
 esp_err_t relay_protocol_handle_ble_data(const uint8_t *data, uint16_t len) {
@@ -122,46 +338,100 @@ esp_err_t relay_protocol_handle_ble_data(const uint8_t *data, uint16_t len) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    ESP_LOGD(TAG, "Forwarding BLE data to USB: %d bytes", len);
+    // Streams the host has blocked or thinned stop here, before they take
+    // ring space, and are timed as they arrive
+    if (!sensor_stream_admit(data, len, 0, (uint64_t)esp_timer_get_time())) {
+        return ESP_OK;
+    }
 
-    // Create PassThroughToApp message
-    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
-    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_pass_through_to_app_tag;
+    // A full ring means the host is not reading CDC0; the notification is
+    // counted rather than logged, as there may be hundreds a second
+    uint8_t *item;
 
-    // Copy data to passthrough message
-    if (len > sizeof(relay_msg.message_body.pass_through_to_app.data.bytes)) {
-        ESP_LOGW(TAG, "BLE data too large: %d > %d", len,
-                 sizeof(relay_msg.message_body.pass_through_to_app.data.bytes));
-        return ESP_ERR_INVALID_SIZE;
+    if (s_nus_rx_ring == NULL ||
+        xRingbufferSendAcquire(s_nus_rx_ring, (void **)&item, len, 0) != pdTRUE) {
+        atomic_fetch_add_explicit(&s_nus_rx_dropped, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&s_nus_rx_queue_full, 1, memory_order_relaxed);
+        trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_NUS_RX);
+        return ESP_ERR_NO_MEM;
     }
+    memcpy(item, data, len);
+    xRingbufferSendComplete(s_nus_rx_ring, item);
+    return ESP_OK;
+}
 
-    memcpy(relay_msg.message_body.pass_through_to_app.data.bytes, data, len);
-    relay_msg.message_body.pass_through_to_app.data.size = len;
+size_t relay_protocol_nus_rx_queued(void) {
+    if (s_nus_rx_ring == NULL) {
+        return 0;
+    }
+    return CONFIG_MOUTHPAD_NUS_RX_QUEUE_SIZE - xRingbufferGetCurFreeSize(s_nus_rx_ring);
+}
 
-    // Encode and send
-    return relay_protocol_send_response(&relay_msg);
+uint32_t relay_protocol_nus_rx_queue_full(void) {
+    return atomic_load_explicit(&s_nus_rx_queue_full, memory_order_relaxed);
 }
 
-esp_err_t relay_protocol_send_response(const void *message) {
-    const mouthware_message_RelayToAppMessage *relay_msg =
-        (const mouthware_message_RelayToAppMessage *)message;
+// nus_rx task: one notification from the ring to CDC0
+static void forward_ble_data(const uint8_t *data, uint16_t len) {
+    // Sensor frames go delta coded when the host asked for it
+    // (sensor_codec.h). Only the nus_rx task gets here, so the message
+    // can be static rather than on its stack.
+    if (sensor_codec_wants(data, len)) {
+        static mouthware_message_RelayToAppMessage s_sensor_frame_msg;
+
+        s_sensor_frame_msg.which_message_body = mouthware_message_RelayToAppMessage_sensor_frame_delta_tag;
+        if (sensor_codec_encode(data, len, &s_sensor_frame_msg.message_body.sensor_frame_delta)) {
+            if (send_message(&s_sensor_frame_msg, false) != ESP_OK) {
+                sensor_codec_resync();
+                atomic_fetch_add_explicit(&s_nus_rx_dropped, 1, memory_order_relaxed);
+                trace_ring_count(TRACE_EVENT_DROP, TRACE_PATH_NUS_RX);
+            }
+            return;
+        }
+    }
 
-    // Encode the message
-    uint8_t buffer[512];  // Should be large enough for any RelayToAppMessage
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof(buffer));
+    ESP_LOGD(TAG, "Forwarding BLE data to USB: %d bytes", len);
 
-    bool status = pb_encode(&stream, &mouthware_message_RelayToAppMessage_msg, relay_msg);
+    // A host speaking channels takes the notification whole
+    uint16_t max_chunk = pb_membersize(mouthware_message_PassThroughToApp_data_t, bytes);
 
-    if (!status) {
-        ESP_LOGE(TAG, "Failed to encode RelayToAppMessage: %s", PB_GET_ERROR(&stream));
-        return ESP_FAIL;
+    if (relay_dispatch_channels() &&
+        len <= MOUTHPAD_FRAME_MAX_PAYLOAD - MOUTHPAD_CHANNEL_HEADER_SIZE) {
+        max_chunk = len;
     }
 
-    size_t message_length = stream.bytes_written;
-    ESP_LOGD(TAG, "Encoded RelayToAppMessage: %d bytes", message_length);
+    // Notifications longer than one message (large MTU) go out as
+    // numbered fragments for the host to reassemble. Each one is encoded
+    // straight into the CDC frame, bypassing the RelayToAppMessage struct.
+    uint16_t offset = 0;
+    for (uint32_t fragment = 0; offset < len; fragment++) {
+        uint16_t chunk = MIN(len - offset, max_chunk);
+
+        offset += chunk;
+        esp_err_t ret = usb_cdc_send_pass_through(data + offset - chunk, chunk,
+                                                  offset < len, fragment);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to send data via USB CDC: %s", esp_err_to_name(ret));
+            atomic_fetch_add_explicit(&s_nus_rx_dropped, 1, memory_order_relaxed);
+            trace_ring_count(TRACE_EVENT_DROP, TRACE_PATH_NUS_RX);
+            return;
+        }
+    }
+}
+
+esp_err_t relay_protocol_send_response(void *message) {
+    mouthware_message_RelayToAppMessage *relay_msg = (mouthware_message_RelayToAppMessage *)message;
+
+    // A reply built by a request's handler answers that request
+    if (relay_msg->request_id == 0) {
+        relay_msg->request_id = relay_dispatch_request_id();
+    }
+    return send_message(relay_msg, true);
+}
 
-    // Send via USB CDC with framing
-    esp_err_t ret = usb_cdc_send_data(buffer, message_length);
+static esp_err_t send_message(const mouthware_message_RelayToAppMessage *relay_msg, bool flush) {
+    // Encode straight into the CDC TX frame
+    esp_err_t ret = usb_cdc_send_message(mouthware_message_RelayToAppMessage_fields, relay_msg, flush);
     if (ret != ESP_OK) {
         ESP_LOGW(TAG, "Failed to send data via USB CDC: %s", esp_err_to_name(ret));
     }
@@ -170,41 +440,71 @@ esp_err_t relay_protocol_send_response(const void *message) {
 }
 
 void relay_protocol_update_ble_connection(bool connected) {
-    s_ble_connected = connected;
+    if (connected) {
+        // The scan ended with this connection
+        link_state_set_phase(LINK_STATE_CONNECTING);
+    } else {
+        link_state_lost();
+        link_state_set_phase(LINK_STATE_IDLE);
+        // Writes still queued were dropped with the link
+        reset_pass_through_fragments();
+        s_pass_through_busy = false;
+        atomic_store(&s_echo_pending, false);
+    }
     ESP_LOGD(TAG, "BLE connection state updated: %s", connected ? "connected" : "disconnected");
+    relay_protocol_ble_status_changed();
 }
 
 void relay_protocol_update_ble_scanning(bool scanning) {
-    s_ble_scanning = scanning;
+    link_state_set_phase(scanning ? LINK_STATE_SCANNING : LINK_STATE_IDLE);
     ESP_LOGD(TAG, "BLE scanning state updated: %s", scanning ? "scanning" : "not scanning");
+    relay_protocol_ble_status_changed();
+}
+
+void relay_protocol_ble_status_changed(void) {
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    const char *status_str = fill_ble_connection_status(&relay_msg);
+    int status = relay_msg.message_body.ble_connection_status_response.connection_status;
+
+    if (atomic_exchange(&s_reported_status, status) == status) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "BLE status changed: %s", status_str);
+    relay_protocol_send_response(&relay_msg);
 }
 
 void relay_protocol_update_rssi(int32_t rssi) {
-    s_last_rssi = rssi;
+    link_state_set_rssi((int8_t)rssi);
     ESP_LOGD(TAG, "RSSI updated: %d dBm", rssi);
 }
 
 // Command handlers
 
-static esp_err_t handle_ble_connection_status_read(void) {
-    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
-    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_ble_connection_status_response_tag;
+// Returns the status name for logging
+static const char *fill_ble_connection_status(mouthware_message_RelayToAppMessage *relay_msg) {
+    mouthware_message_BleConnectionStatusResponse *response =
+        &relay_msg->message_body.ble_connection_status_response;
+    relay_msg->which_message_body = mouthware_message_RelayToAppMessage_ble_connection_status_response_tag;
 
-    // Determine connection status
+    // Determine connection status from one snapshot
     mouthware_message_RelayBleConnectionStatus status;
     const char *status_str;
+    struct link_state link_now;
+    link_state_get(&link_now);
+    bool link_up = link_now.phase >= LINK_STATE_CONNECTING;
 
     // Connection is fully ready when:
     // 1. BLE and HID are connected AND
     // 2. Either NUS is ready with cached device info OR DIS discovery is complete
-    if (s_ble_connected && ble_hid_client_is_connected() && ble_connection_is_fully_ready()) {
+    if (link_up && (link_now.ready & LINK_STATE_HID) && (link_now.ready & LINK_STATE_READY)) {
         status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTED;
         status_str = "connected";
-    } else if (s_ble_connected && ble_hid_client_is_connected()) {
+    } else if (link_up && (link_now.ready & LINK_STATE_HID)) {
         // HID connected but not fully ready yet (waiting for NUS + DIS)
         status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTING;
         status_str = "connecting";
-    } else if (s_ble_scanning) {
+    } else if (link_now.phase == LINK_STATE_SCANNING) {
         status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_SEARCHING;
         status_str = "searching";
     } else {
@@ -212,103 +512,158 @@ static esp_err_t handle_ble_connection_status_read(void) {
         status_str = "disconnected";
     }
 
-    relay_msg.message_body.ble_connection_status_response.connection_status = status;
-    relay_msg.message_body.ble_connection_status_response.rssi = s_last_rssi;
+    response->connection_status = status;
+    response->rssi = link_now.rssi;
 
-    // Get battery level if available
-    if (ble_bas_is_ready()) {
-        relay_msg.message_body.ble_connection_status_response.battery_level = ble_bas_get_battery_level();
-    } else {
-        relay_msg.message_body.ble_connection_status_response.battery_level = 0;
+    // Battery level if available
+    response->battery_level =
+        link_now.battery_level == LINK_STATE_BATTERY_UNKNOWN ? 0 : link_now.battery_level;
+
+    // Negotiated PHY and data length, reported as 0 until known
+    ble_link_info_t link = {0};
+    if (link_up) {
+        ble_link_get_info(&link);
+    }
+    response->tx_phy = link.tx_phy;
+    response->rx_phy = link.rx_phy;
+    response->max_tx_octets = link.tx_octets;
+    response->max_rx_octets = link.rx_octets;
+    response->connected_devices = link_up ? 1 : 0;
+
+    return status_str;
+}
+
+static esp_err_t handle_ble_connection_status_read(const mouthware_message_AppToRelayMessage *msg) {
+    if (msg->message_body.ble_connection_status_read.scan_boost) {
+        scan_boost();
     }
 
-    ESP_LOGI(TAG, "BLE status: %s, RSSI: %d, Battery: %d%%",
-             status_str, s_last_rssi,
-             relay_msg.message_body.ble_connection_status_response.battery_level);
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    const mouthware_message_BleConnectionStatusResponse *response =
+        &relay_msg.message_body.ble_connection_status_response;
+    const char *status_str = fill_ble_connection_status(&relay_msg);
+
+    atomic_store(&s_reported_status, response->connection_status);
+
+    ESP_LOGI(TAG, "BLE status: %s, RSSI: %d, Battery: %d%%, PHY tx/rx: %u/%u, data length tx/rx: %u/%u",
+             status_str, (int)response->rssi, (int)response->battery_level,
+             (unsigned)response->tx_phy, (unsigned)response->rx_phy,
+             (unsigned)response->max_tx_octets, (unsigned)response->max_rx_octets);
 
     return relay_protocol_send_response(&relay_msg);
 }
 
-static esp_err_t handle_device_info_read(void) {
+void relay_protocol_device_info_changed(void) {
+    atomic_fetch_add(&s_device_info_generation, 1);
+}
+
+static esp_err_t build_device_info(void) {
     mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
     relay_msg.which_message_body = mouthware_message_RelayToAppMessage_device_info_response_tag;
 
     // Device family and board (always available - dongle hardware info)
     // These describe the dongle hardware itself, not the bonded MouthPad
     relay_msg.message_body.device_info_response.family = mouthware_message_DeviceFamily_DEVICE_FAMILY_ESP;
+#if CONFIG_MOUTHPAD_BOARD_XIAO_ESP32S3
+    relay_msg.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_SEEED_XIAO_ESP32S3;
+#elif CONFIG_MOUTHPAD_BOARD_LILYGO_T_DISPLAY_S3
+    relay_msg.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_LILYGO_TDISPLAY_S3;
+#else
+    relay_msg.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_UNSPECIFIED;
+#endif
 
-    // Map board name to enum
-    const char *board_name = CONFIG_MOUTHPAD_BOARD_NAME;
-    if (strcmp(board_name, "seeed_xiao_esp32s3") == 0) {
-        relay_msg.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_SEEED_XIAO_ESP32S3;
-    } else if (strcmp(board_name, "lilygo_tdisplay_s3") == 0) {
-        relay_msg.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_LILYGO_TDISPLAY_S3;
-    } else {
-        relay_msg.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_UNSPECIFIED;
-        ESP_LOGW(TAG, "Unknown board name: %s", board_name);
-    }
-
-    ESP_LOGI(TAG, "Device info: family=esp, board=%s (enum=%d)", board_name, relay_msg.message_body.device_info_response.board);
+    ESP_LOGI(TAG, "Device info: family=esp, board=%s (enum=%d)", CONFIG_MOUTHPAD_BOARD_NAME,
+             relay_msg.message_body.device_info_response.board);
 
     const ble_device_info_t *device_info = ble_device_info_get_current();
+    char address_str[18];
 
     if (!device_info || !device_info->info_complete) {
+        // Family/board only (no bonded MouthPad info)
         ESP_LOGW(TAG, "Device info not available - sending dongle hardware info only (family=esp, board=%s)",
                  CONFIG_MOUTHPAD_BOARD_NAME);
-        // Send response with family/board only (no bonded MouthPad info)
-        return relay_protocol_send_response(&relay_msg);
+    } else {
+        // Bonded MouthPad device info available - add it to the response
+        // Set up callbacks for string fields
+        if (strlen(device_info->device_name) > 0) {
+            relay_msg.message_body.device_info_response.name.funcs.encode = encode_string_callback;
+            relay_msg.message_body.device_info_response.name.arg = (void *)device_info->device_name;
+        }
+
+        if (strlen(device_info->firmware_revision) > 0) {
+            relay_msg.message_body.device_info_response.firmware.funcs.encode = encode_string_callback;
+            relay_msg.message_body.device_info_response.firmware.arg = (void *)device_info->firmware_revision;
+        }
+
+        // Format BLE address as string
+        // Try to get active address first (if connected), otherwise use bonded device address
+        esp_bd_addr_t addr;
+        bool have_address = false;
+
+        if (transport_hid_get_active_address(addr) == ESP_OK) {
+            // Connected - use active address
+            have_address = true;
+        } else if (ble_bonds_get_bonded_device(addr) == ESP_OK) {
+            // Not connected but have bonded device - use bonded address
+            have_address = true;
+        }
+
+        if (have_address) {
+            snprintf(address_str, sizeof(address_str), "%02X:%02X:%02X:%02X:%02X:%02X",
+                     addr[0], addr[1], addr[2],
+                     addr[3], addr[4], addr[5]);
+            relay_msg.message_body.device_info_response.address.funcs.encode = encode_string_callback;
+            relay_msg.message_body.device_info_response.address.arg = address_str;
+        }
+
+        // Set VID/PID from PnP ID
+        if (device_info->has_pnp_id) {
+            relay_msg.message_body.device_info_response.vid = device_info->pnp_id.vendor_id;
+            relay_msg.message_body.device_info_response.pid = device_info->pnp_id.product_id;
+        }
+
+        ESP_LOGI(TAG, "Device info: name=%s, vid=0x%04X, pid=0x%04X",
+                 device_info->device_name,
+                 relay_msg.message_body.device_info_response.vid,
+                 relay_msg.message_body.device_info_response.pid);
     }
 
-    // Bonded MouthPad device info available - add it to the response
-    // Set up callbacks for string fields
-    if (strlen(device_info->device_name) > 0) {
-        relay_msg.message_body.device_info_response.name.funcs.encode = encode_string_callback;
-        relay_msg.message_body.device_info_response.name.arg = (void *)device_info->device_name;
+    pb_ostream_t stream = pb_ostream_from_buffer(s_device_info_buf, sizeof(s_device_info_buf));
+    if (!pb_encode(&stream, mouthware_message_RelayToAppMessage_fields, &relay_msg)) {
+        ESP_LOGE(TAG, "Device info encode failed: %s", PB_GET_ERROR(&stream));
+        return ESP_FAIL;
     }
+    s_device_info_len = stream.bytes_written;
 
-    if (strlen(device_info->firmware_revision) > 0) {
-        relay_msg.message_body.device_info_response.firmware.funcs.encode = encode_string_callback;
-        relay_msg.message_body.device_info_response.firmware.arg = (void *)device_info->firmware_revision;
-    }
+    ESP_LOGI(TAG, "Device info cached (%u bytes)", (unsigned int)s_device_info_len);
+    return ESP_OK;
+}
 
-    // Format BLE address as string
-    // Try to get active address first (if connected), otherwise use bonded device address
-    char address_str[18];
-    esp_bd_addr_t addr;
-    bool have_address = false;
+// Runs on the relay_proto task only, which owns the cached bytes
+static esp_err_t handle_device_info_read(const mouthware_message_AppToRelayMessage *msg) {
+    (void)msg;
 
-    if (transport_hid_get_active_address(addr) == ESP_OK) {
-        // Connected - use active address
-        have_address = true;
-    } else if (ble_bonds_get_bonded_device(addr) == ESP_OK) {
-        // Not connected but have bonded device - use bonded address
-        have_address = true;
-    }
+    // Read before building: a change during the build leaves the cache stale
+    unsigned int generation = atomic_load(&s_device_info_generation);
 
-    if (have_address) {
-        snprintf(address_str, sizeof(address_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-                 addr[0], addr[1], addr[2],
-                 addr[3], addr[4], addr[5]);
-        relay_msg.message_body.device_info_response.address.funcs.encode = encode_string_callback;
-        relay_msg.message_body.device_info_response.address.arg = address_str;
+    if (generation != s_device_info_cached_generation) {
+        esp_err_t ret = build_device_info();
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        s_device_info_cached_generation = generation;
     }
 
-    // Set VID/PID from PnP ID
-    if (device_info->has_pnp_id) {
-        relay_msg.message_body.device_info_response.vid = device_info->pnp_id.vendor_id;
-        relay_msg.message_body.device_info_response.pid = device_info->pnp_id.product_id;
+    esp_err_t ret = usb_cdc_send_frame(s_device_info_buf, s_device_info_len, true);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to send data via USB CDC: %s", esp_err_to_name(ret));
     }
-
-    ESP_LOGI(TAG, "Sending device info: name=%s, vid=0x%04X, pid=0x%04X, family=esp, board=%s",
-             device_info->device_name,
-             relay_msg.message_body.device_info_response.vid,
-             relay_msg.message_body.device_info_response.pid,
-             CONFIG_MOUTHPAD_BOARD_NAME);
-
-    return relay_protocol_send_response(&relay_msg);
+    return ret;
 }
 
-static esp_err_t handle_clear_bonds_write(void) {
+static esp_err_t handle_clear_bonds_write(const mouthware_message_AppToRelayMessage *msg) {
+    (void)msg;
+
     ESP_LOGI(TAG, "ClearBondsWrite command - performing bond reset");
 
     mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
@@ -321,7 +676,9 @@ static esp_err_t handle_clear_bonds_write(void) {
     return relay_protocol_send_response(&relay_msg);
 }
 
-static esp_err_t handle_clear_firmware_cache_write(void) {
+static esp_err_t handle_clear_firmware_cache_write(const mouthware_message_AppToRelayMessage *msg) {
+    (void)msg;
+
     ESP_LOGI(TAG, "=== CLEAR FIRMWARE CACHE REQUEST (via protobuf) ===");
 
     mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
@@ -333,7 +690,9 @@ static esp_err_t handle_clear_firmware_cache_write(void) {
     return relay_protocol_send_response(&relay_msg);
 }
 
-static esp_err_t handle_dfu_write(void) {
+static esp_err_t handle_dfu_write(const mouthware_message_AppToRelayMessage *msg) {
+    (void)msg;
+
     ESP_LOGI(TAG, "=== DFU REQUEST (via protobuf) - entering bootloader ===");
 
     mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
@@ -352,40 +711,670 @@ static esp_err_t handle_dfu_write(void) {
     return ret;
 }
 
-static esp_err_t handle_pass_through_to_mouthpad(const uint8_t *data, size_t len) {
+// HidConfigRead and HidConfigWrite; both reply with the current setting
+static esp_err_t handle_hid_config(const mouthware_message_AppToRelayMessage *msg) {
+    if (msg->which_message_body == mouthware_message_AppToRelayMessage_hid_config_write_tag) {
+        usb_hid_set_motion_interpolation(msg->message_body.hid_config_write.motion_interpolation);
+        usb_hid_set_motion_prediction(msg->message_body.hid_config_write.motion_prediction);
+    }
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_hid_config_response_tag;
+    relay_msg.message_body.hid_config_response.motion_interpolation =
+        usb_hid_motion_interpolation_enabled();
+    relay_msg.message_body.hid_config_response.motion_prediction =
+        usb_hid_motion_prediction_enabled();
+
+    return relay_protocol_send_response(&relay_msg);
+}
+
+static esp_err_t handle_pass_through_batch_config(const mouthware_message_AppToRelayMessage *msg) {
+    (void)msg;
+
+    // Pass-through frames are already coalesced into one USB transfer by
+    // usb_cdc_send_data, so batching is declined and PassThroughToApp stays
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_pass_through_batch_config_response_tag;
+    relay_msg.message_body.pass_through_batch_config_response.enabled = false;
+
+    return relay_protocol_send_response(&relay_msg);
+}
+
+// Tell the host which fast paths it may enable. PassThroughToAppBatch is
+// declined (see above) and there is no RelayStatsRead handler, so neither is
+// listed; nor are secondary MouthPads, which only the nRF relay connects.
+static esp_err_t handle_relay_capabilities_read(const mouthware_message_AppToRelayMessage *msg) {
+    (void)msg;
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_relay_capabilities_response_tag;
+
+    mouthware_message_RelayCapabilitiesResponse *caps = &relay_msg.message_body.relay_capabilities_response;
+#ifdef FIRMWARE_VERSION_STRING
+    strncpy(caps->firmware_version, FIRMWARE_VERSION_STRING, sizeof(caps->firmware_version) - 1);
+#endif
+    caps->features = mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_CREDITS |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_FRAGMENTS |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_LINK_TELEMETRY |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_STATUS_PUSH |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_CONNECTION_TIMING |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_HID_LATENCY |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_ECHO |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_HID_MIRROR |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_TRACE |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_MEM_STATS |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_NUS_STREAM |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_STREAM_FILTER |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_CODEC |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_STREAM_RATE |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_REQUEST_ID |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_COBS_FRAMING |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_TUNING_PROFILE |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_ACK_MODES |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_SCAN_BOOST |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_USB_COMPOSITION |
+                     mouthware_message_RelayFeature_RELAY_FEATURE_RAW_CHANNELS;
+#if CONFIG_MOUTHPAD_TASK_STATS
+    caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_THREAD_STATS;
+#endif
+#if CONFIG_MOUTHPAD_LINK_HISTORY
+    caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_LINK_HISTORY;
+#endif
+    if (ota_update_available()) {
+        caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_FW_UPDATE;
+    }
+    caps->max_frame_size = MOUTHPAD_FRAME_MAX_PAYLOAD;
+    caps->max_in_flight_writes = ble_nus_client_tx_window();
+    caps->batch_window_us = tuning_profile_get(
+        mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_CDC_COALESCE_US);
+    caps->max_pass_through_size = CONFIG_MOUTHPAD_PASS_THROUGH_MAX_LEN;
+    caps->pass_through_ack_writes = pass_through_ack_writes(caps->max_in_flight_writes);
+    caps->pass_through_ack_interval_us = PASS_THROUGH_ACK_INTERVAL_US;
+
+    ESP_LOGI(TAG, "Sending capabilities: features=0x%x, max frame %u, %u writes in flight",
+             (unsigned int)caps->features, (unsigned int)caps->max_frame_size,
+             (unsigned int)caps->max_in_flight_writes);
+    return relay_protocol_send_response(&relay_msg);
+}
+
+static mouthware_message_PassThroughToMouthpadErrorCode pass_through_error_code(esp_err_t status) {
+    if (status == ESP_OK) {
+        return mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED;
+    } else if (status == ESP_ERR_TIMEOUT) {
+        return mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_TIMEOUT;
+    }
+    return mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNKNOWN_ERROR;
+}
+
+// Stamped and answered on the RX path, so relay_rx_us/relay_tx_us bracket
+// only this handler. With via_mouthpad the payload goes out as a timed NUS
+// write and relay_protocol_echo_sent answers once the MouthPad acknowledges.
+static esp_err_t handle_echo_request(const mouthware_message_AppToRelayMessage *msg) {
+    const mouthware_message_EchoRequest *req = &msg->message_body.echo_request;
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_echo_response_tag;
+
+    mouthware_message_EchoResponse *echo = &relay_msg.message_body.echo_response;
+    echo->relay_rx_us = relay_time_us64();
+    echo->host_timestamp_us = req->host_timestamp_us;
+    time_base_host_sample(req->host_timestamp_us, echo->relay_rx_us);
+    echo->sequence = req->sequence;
+    echo->via_mouthpad = req->via_mouthpad;
+
+    if (req->via_mouthpad) {
+        if (!ble_nus_client_is_ready()) {
+            echo->error_code =
+                mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED;
+        } else if (req->payload.size == 0) {
+            echo->error_code =
+                mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_INVALID_MESSAGE;
+        } else if (atomic_exchange(&s_echo_pending, true)) {
+            // The previous probe is still waiting for the MouthPad
+            echo->error_code =
+                mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_TIMEOUT;
+        } else {
+            s_echo = *echo;
+            esp_err_t ret = ble_nus_client_send_echo(req->payload.bytes, req->payload.size);
+            if (ret == ESP_OK) {
+                return ESP_OK;
+            }
+            atomic_store(&s_echo_pending, false);
+            echo->error_code = pass_through_error_code(ret);
+        }
+    }
+
+    echo->relay_tx_us = relay_time_us64();
+    return relay_protocol_send_response(&relay_msg);
+}
+
+void relay_protocol_echo_sent(esp_err_t status, int64_t write_us, int64_t ack_us) {
+    // Nothing to answer if the link dropped while the write was queued
+    if (!atomic_load(&s_echo_pending)) {
+        return;
+    }
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_echo_response_tag;
+
+    mouthware_message_EchoResponse *echo = &relay_msg.message_body.echo_response;
+    *echo = s_echo;
+    atomic_store(&s_echo_pending, false);
+
+    echo->mouthpad_write_us = write_us;
+    if (status == ESP_OK) {
+        echo->mouthpad_ack_us = ack_us;
+    }
+    echo->error_code = pass_through_error_code(status);
+    echo->relay_tx_us = relay_time_us64();
+
+    ESP_LOGD(TAG, "Echo %lu: MouthPad acknowledged in %lld us", (unsigned long)echo->sequence,
+             (long long)(ack_us - write_us));
+    relay_protocol_send_response(&relay_msg);
+}
+
+static esp_err_t handle_connection_timing_read(const mouthware_message_AppToRelayMessage *msg) {
+    const mouthware_message_ConnectionTimingRead *read = &msg->message_body.connection_timing_read;
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_connection_timing_response_tag;
+
+    connection_timing_fill_response(&relay_msg.message_body.connection_timing_response);
+
+    if (read->clear) {
+        connection_timing_clear();
+    }
+
+    ESP_LOGI(TAG, "Sending timings for %d connection attempts%s",
+             relay_msg.message_body.connection_timing_response.records_count,
+             read->clear ? " (cleared)" : "");
+    return relay_protocol_send_response(&relay_msg);
+}
+
+void relay_protocol_telemetry_sample(struct link_telemetry_sample *sample) {
+    ble_link_info_t link = {0};
+    uint32_t hid_reports;
+    uint32_t hid_dropped;
+    struct stall_watch_stats stalls;
+    struct usb_phase_stats usb;
+    struct link_state link_now;
+
+    link_state_get(&link_now);
+    bool link_up = link_now.phase >= LINK_STATE_CONNECTING;
+    if (link_up) {
+        ble_link_get_info(&link);
+    }
+    transport_hid_get_counts(&hid_reports, &hid_dropped);
+    stall_watch_get(&stalls);
+    usb_phase_get(&usb);
+
+    *sample = (struct link_telemetry_sample){
+        .now_ms = (uint32_t)(esp_timer_get_time() / 1000),
+        .connected = link_up,
+        .rssi = link_up ? link_now.rssi : 0,
+        .battery_level =
+            link_now.battery_level == LINK_STATE_BATTERY_UNKNOWN ? 0 : link_now.battery_level,
+        .conn_interval_us = link.interval_us,
+        .tx_phy = link.tx_phy,
+        .rx_phy = link.rx_phy,
+        .hid_reports = hid_reports,
+        .hid_dropped = hid_dropped,
+        .nus_rx_dropped = atomic_load_explicit(&s_nus_rx_dropped, memory_order_relaxed),
+        .nus_tx_dropped = atomic_load_explicit(&s_nus_tx_dropped, memory_order_relaxed),
+        .nus_tx_queued = ble_nus_client_tx_pending(),
+        .cdc_tx_queued = usb_cdc_tx_queued(),
+        .stalls = stalls.stalls,
+        .worst_stall_us = stalls.worst_us,
+        .usb_reports = usb.reports,
+        .usb_phase_sum_us = usb.phase_sum_us,
+        .usb_waits = usb.waits,
+        .usb_wait_sum_us = usb.wait_sum_us,
+    };
+    sensor_stream_sequence_total(&sample->nus_seq);
+}
+
+static void telemetry_timer_callback(void *arg) {
+    (void)arg;
+    mouthware_message_LinkTelemetrySubscribe request;
+    bool pending;
+
+    taskENTER_CRITICAL(&s_telemetry_lock);
+    pending = s_telemetry_request_pending;
+    request = s_telemetry_request;
+    s_telemetry_request_pending = false;
+    taskEXIT_CRITICAL(&s_telemetry_lock);
+
+    if (pending) {
+        uint32_t interval = link_telemetry_subscribe(&request);
+        if (interval) {
+            ESP_LOGI(TAG, "Link telemetry every %lu ms%s", (unsigned long)interval,
+                     request.on_change ? " on change" : "");
+        } else {
+            ESP_LOGI(TAG, "Link telemetry stopped");
+        }
+    }
+
+    uint32_t interval_ms = link_telemetry_interval_ms();
+    if (interval_ms == 0) {
+        return;
+    }
+
+    // No one reads CDC0 while the host sleeps; sampling picks up on resume
+    if (!usb_hid_suspended()) {
+        struct link_telemetry_sample sample;
+        mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+
+        relay_protocol_telemetry_sample(&sample);
+        if (link_telemetry_fill(&sample, &relay_msg.message_body.link_telemetry)) {
+            relay_msg.which_message_body = mouthware_message_RelayToAppMessage_link_telemetry_tag;
+            relay_protocol_send_response(&relay_msg);
+        }
+    }
+
+    // Fails harmlessly if a new subscribe already re-armed the timer
+    esp_timer_start_once(s_telemetry_timer, (uint64_t)interval_ms * 1000);
+}
+
+// The first sample is the reply; it is sent from the esp_timer task
+static esp_err_t handle_link_telemetry_subscribe(const mouthware_message_AppToRelayMessage *msg) {
+    taskENTER_CRITICAL(&s_telemetry_lock);
+    s_telemetry_request = msg->message_body.link_telemetry_subscribe;
+    s_telemetry_request_pending = true;
+    taskEXIT_CRITICAL(&s_telemetry_lock);
+
+    esp_timer_stop(s_telemetry_timer);
+    return esp_timer_start_once(s_telemetry_timer, 1);
+}
+
+static void mirror_timer_callback(void *arg) {
+    (void)arg;
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_hid_mirror_batch_tag;
+
+    // Batches ride the CDC coalescing window rather than forcing a flush.
+    // No one reads CDC0 while the host sleeps, so those are only drained.
+    while (hid_mirror_fill(&relay_msg.message_body.hid_mirror_batch)) {
+        if (!usb_hid_suspended()) {
+            send_message(&relay_msg, false);
+        }
+    }
+
+    if (hid_mirror_enabled()) {
+        esp_timer_start_once(s_mirror_timer, HID_MIRROR_FLUSH_MS * 1000);
+    }
+}
+
+// Batches are sent from the esp_timer task; a last run after turning the
+// mirror off discards what is still buffered
+static esp_err_t handle_hid_mirror_config(const mouthware_message_AppToRelayMessage *msg) {
+    bool enable = msg->message_body.hid_mirror_config_write.enabled;
+    hid_mirror_set_enabled(enable);
+    ESP_LOGI(TAG, "HID mirror %s", enable ? "enabled" : "disabled");
+
+    esp_timer_stop(s_mirror_timer);
+    esp_timer_start_once(s_mirror_timer, enable ? HID_MIRROR_FLUSH_MS * 1000 : 1);
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_hid_mirror_config_response_tag;
+    relay_msg.message_body.hid_mirror_config_response.enabled = enable;
+    return relay_protocol_send_response(&relay_msg);
+}
+
+// The task list is encoded from report, so it is sent before returning;
+// without CONFIG_MOUTHPAD_TASK_STATS this fails and nothing is sent
+static esp_err_t handle_thread_stats_read(const mouthware_message_AppToRelayMessage *msg) {
+    static struct thread_stats_report report;
+    (void)msg;
+
+    esp_err_t ret = task_stats_read(&report);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_thread_stats_response_tag;
+    thread_stats_fill_response(&report, &relay_msg.message_body.thread_stats_response);
+    return relay_protocol_send_response(&relay_msg);
+}
+
+// The records are encoded from the ring, so the page is sent before returning
+static esp_err_t handle_trace_read(const mouthware_message_AppToRelayMessage *msg) {
+    const mouthware_message_TraceRead *read = &msg->message_body.trace_read;
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_trace_response_tag;
+    trace_ring_fill_response(read->offset, &relay_msg.message_body.trace_response);
+
+    esp_err_t ret = relay_protocol_send_response(&relay_msg);
+    if (ret == ESP_OK && read->clear) {
+        trace_ring_clear();
+    }
+    return ret;
+}
+
+// The buckets are encoded from a page link_history keeps, so it is sent
+// before returning
+static esp_err_t handle_link_history_read(const mouthware_message_AppToRelayMessage *msg) {
+#if CONFIG_MOUTHPAD_LINK_HISTORY
+    const mouthware_message_LinkHistoryRead *read = &msg->message_body.link_history_read;
+
+    if (read->clear) {
+        link_history_clear();
+    }
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_link_history_response_tag;
+    link_history_fill_response(read->bond, read->offset,
+                               &relay_msg.message_body.link_history_response);
+    return relay_protocol_send_response(&relay_msg);
+#else
+    (void)msg;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+// The pools are encoded from the report, so it is sent before returning
+static esp_err_t handle_mem_stats_read(const mouthware_message_AppToRelayMessage *msg) {
+    static struct mem_stats_report report;
+
+    heap_stats_read(&report);
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_mem_stats_response_tag;
+    mem_stats_fill_response(&report, &relay_msg.message_body.mem_stats_response);
+
+    esp_err_t ret = relay_protocol_send_response(&relay_msg);
+    if (ret == ESP_OK && msg->message_body.mem_stats_read.reset) {
+        heap_stats_reset();
+    }
+    return ret;
+}
+
+// FwUpdateStart/Chunk/End are only copied aside here; the fw_update task
+// writes them (ota_update.h)
+static esp_err_t handle_fw_update(const mouthware_message_AppToRelayMessage *msg) {
+    return fw_update_handle(msg) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+// NusStreamControl/Write are only copied into the stream ring here; the
+// nus_tx task cuts them into NUS writes (ble_nus.c)
+static esp_err_t handle_nus_stream(const mouthware_message_AppToRelayMessage *msg) {
+    return nus_stream_handle(msg) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+// The filter is applied on the BTC task as notifications arrive
+// (relay_protocol_handle_ble_data)
+static esp_err_t handle_sensor_stream_filter(const mouthware_message_AppToRelayMessage *msg) {
+    sensor_stream_set_blocked(msg->message_body.sensor_stream_filter_write.blocked);
+    ESP_LOGI(TAG, "MouthPad streams blocked: 0x%x", (unsigned)sensor_stream_blocked());
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_sensor_stream_filter_response_tag;
+    sensor_stream_get_status(&relay_msg.message_body.sensor_stream_filter_response);
+    return relay_protocol_send_response(&relay_msg);
+}
+
+static esp_err_t handle_sensor_codec_config(const mouthware_message_AppToRelayMessage *msg) {
+    const mouthware_message_SensorCodecConfigWrite *config = &msg->message_body.sensor_codec_config_write;
+
+    sensor_codec_configure(config->enabled, config->keyframe_interval);
+    ESP_LOGI(TAG, "Sensor codec %s", config->enabled ? "on" : "off");
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_sensor_codec_config_response_tag;
+    sensor_codec_get_status(&relay_msg.message_body.sensor_codec_config_response);
+    return relay_protocol_send_response(&relay_msg);
+}
+
+// Streams are thinned on the BTC task as notifications arrive, like the filter
+static esp_err_t handle_sensor_stream_rate(const mouthware_message_AppToRelayMessage *msg) {
+    const mouthware_message_SensorStreamRateWrite *rate = &msg->message_body.sensor_stream_rate_write;
+
+    if (sensor_stream_set_rate(rate->stream, rate->keep_one_in, rate->min_interval_us)) {
+        ESP_LOGI(TAG, "MouthPad stream %d: 1 in %u, every %u us", (int)rate->stream,
+                 (unsigned)rate->keep_one_in, (unsigned)rate->min_interval_us);
+    } else {
+        ESP_LOGW(TAG, "Unknown MouthPad stream %d", (int)rate->stream);
+    }
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_sensor_stream_rate_response_tag;
+    sensor_stream_get_rate(rate->stream, &relay_msg.message_body.sensor_stream_rate_response);
+    return relay_protocol_send_response(&relay_msg);
+}
+
+// The knobs are acted on by their owners as they change (tuning.h); a refused
+// write is still answered with the profile in force
+static esp_err_t handle_relay_profile(const mouthware_message_AppToRelayMessage *msg) {
+    bool accepted = tuning_write(&msg->message_body.relay_profile_write);
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_relay_profile_response_tag;
+    tuning_profile_get_status(&relay_msg.message_body.relay_profile_response);
+    esp_err_t err = relay_protocol_send_response(&relay_msg);
+    return err != ESP_OK ? err : (accepted ? ESP_OK : ESP_ERR_INVALID_ARG);
+}
+
+static esp_err_t handle_usb_composition(const mouthware_message_AppToRelayMessage *msg) {
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_usb_composition_response_tag;
+    bool accepted = usb_comp_write(&msg->message_body.usb_composition_write,
+                                   &relay_msg.message_body.usb_composition_response);
+    esp_err_t err = relay_protocol_send_response(&relay_msg);
+    return err != ESP_OK ? err : (accepted ? ESP_OK : ESP_ERR_INVALID_ARG);
+}
+
+// Report IDs without data (or a build without CONFIG_MOUTHPAD_HID_LATENCY_TRACE)
+// give an empty response
+static esp_err_t handle_hid_latency_read(const mouthware_message_AppToRelayMessage *msg) {
+    (void)msg;
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_hid_latency_response_tag;
+
+    mouthware_message_HidLatencyResponse *lat = &relay_msg.message_body.hid_latency_response;
+    for (uint8_t id = 1; id <= HID_LATENCY_REPORT_ID_MAX &&
+                         lat->reports_count < sizeof(lat->reports) / sizeof(lat->reports[0]);
+         id++) {
+        hid_latency_stats_t stats;
+
+        if (hid_latency_get_stats(id, &stats) != ESP_OK) {
+            break;
+        }
+        lat->reports[lat->reports_count++] = (mouthware_message_HidLatencyReportStats){
+            .report_id = stats.report_id,
+            .count = stats.count,
+            .p50_us = stats.p50_us,
+            .p99_us = stats.p99_us,
+            .max_us = stats.max_us,
+        };
+    }
+
+    ESP_LOGI(TAG, "Sending HID latency stats for %d report IDs", lat->reports_count);
+    return relay_protocol_send_response(&relay_msg);
+}
+
+// Credits tell the host how many writes it may keep unacknowledged, so it
+// never overflows the NUS TX queue
+static esp_err_t send_pass_through_report(mouthware_message_PassThroughToMouthpadErrorCode error_code,
+                                          struct pass_through_ack_report report,
+                                          uint32_t device_index) {
     mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
     relay_msg.which_message_body = mouthware_message_RelayToAppMessage_pass_through_to_mouthpad_response_tag;
+    relay_msg.message_body.pass_through_to_mouthpad_response.error_code = error_code;
+    relay_msg.message_body.pass_through_to_mouthpad_response.credits = ble_nus_client_tx_window();
+    relay_msg.message_body.pass_through_to_mouthpad_response.device_index = device_index;
+    relay_msg.message_body.pass_through_to_mouthpad_response.sequence = report.sequence;
+    relay_msg.message_body.pass_through_to_mouthpad_response.acked = report.acked;
+
+    return relay_protocol_send_response(&relay_msg);
+}
+
+// A write to the MouthPad completed or was refused; answer it as its ack
+// mode asks
+static esp_err_t send_pass_through_response(mouthware_message_PassThroughToMouthpadErrorCode error_code,
+                                            struct pass_through_ack_tag ack) {
+    bool ok = error_code == mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED;
+    if (!ok) {
+        atomic_fetch_add_explicit(&s_nus_tx_dropped, 1, memory_order_relaxed);
+        trace_ring_count(TRACE_EVENT_DROP, TRACE_PATH_NUS_TX);
+    }
+
+    portENTER_CRITICAL(&s_pass_through_ack_lock);
+    struct pass_through_ack_report report = pass_through_ack_complete(
+        &s_pass_through_ack, ack, ok, pass_through_ack_writes(ble_nus_client_tx_window()));
+    bool pending = pass_through_ack_pending(&s_pass_through_ack);
+    portEXIT_CRITICAL(&s_pass_through_ack_lock);
+
+    // The oldest unreported completion starts the interval; a flush that
+    // finds nothing left sends nothing
+    if (pending && !esp_timer_is_active(s_pass_through_ack_timer)) {
+        esp_timer_start_once(s_pass_through_ack_timer, PASS_THROUGH_ACK_INTERVAL_US);
+    }
+
+    if (report.acked == 0) {
+        return ESP_OK;
+    }
+    return send_pass_through_report(error_code, report, 0);
+}
+
+static void pass_through_ack_timer_callback(void *arg) {
+    (void)arg;
+
+    portENTER_CRITICAL(&s_pass_through_ack_lock);
+    struct pass_through_ack_report report = pass_through_ack_flush(&s_pass_through_ack);
+    portEXIT_CRITICAL(&s_pass_through_ack_lock);
+
+    if (report.acked > 0) {
+        send_pass_through_report(
+            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED,
+            report, 0);
+    }
+}
+
+static struct pass_through_ack_tag write_ack_tag(const struct mouthpad_pass_through_to_mouthpad *msg) {
+    return (struct pass_through_ack_tag){ .sequence = msg->sequence, .mode = msg->ack };
+}
+
+void relay_protocol_pass_through_sent(esp_err_t status, const uint8_t *payload,
+                                      struct pass_through_ack_tag ack) {
+    if (payload == s_pass_through_buf) {
+        s_pass_through_busy = false;
+    }
+
+    send_pass_through_response(pass_through_error_code(status), ack);
+}
+
+static void reset_pass_through_fragments(void) {
+    s_pass_through_len = 0;
+    s_pass_through_next_fragment = 0;
+}
+
+// Append a fragment to the reassembly buffer. Intermediate fragments are
+// acknowledged at once; the final one is acknowledged when the whole
+// payload has been written, and its reliable flag applies to all of it.
+static esp_err_t reassemble_pass_through(const struct mouthpad_pass_through_to_mouthpad *msg) {
+    if (msg->fragment == 0) {
+        if (s_pass_through_busy) {
+            // The previous payload is still being written from the buffer
+            ESP_LOGW(TAG, "Reassembly buffer busy, rejecting new payload");
+            return send_pass_through_response(
+                mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_TIMEOUT,
+                write_ack_tag(msg));
+        }
+        if (s_pass_through_len > 0) {
+            ESP_LOGW(TAG, "Discarding %d bytes of an unfinished payload", s_pass_through_len);
+        }
+        reset_pass_through_fragments();
+    } else if (msg->fragment != s_pass_through_next_fragment) {
+        ESP_LOGW(TAG, "Fragment %lu out of order, expected %lu",
+                 (unsigned long)msg->fragment, (unsigned long)s_pass_through_next_fragment);
+        reset_pass_through_fragments();
+        return send_pass_through_response(
+            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_FRAGMENT_OUT_OF_ORDER,
+            write_ack_tag(msg));
+    }
+
+    if (s_pass_through_len + msg->len > sizeof(s_pass_through_buf)) {
+        ESP_LOGW(TAG, "Reassembled payload exceeds %u bytes", (unsigned)sizeof(s_pass_through_buf));
+        reset_pass_through_fragments();
+        return send_pass_through_response(
+            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_TOO_LARGE,
+            write_ack_tag(msg));
+    }
+
+    memcpy(s_pass_through_buf + s_pass_through_len, msg->data, msg->len);
+    s_pass_through_len += msg->len;
+    s_pass_through_next_fragment++;
+
+    if (msg->more_fragments) {
+        return send_pass_through_response(
+            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED,
+            write_ack_tag(msg));
+    }
+
+    uint16_t len = s_pass_through_len;
+    reset_pass_through_fragments();
+    s_pass_through_busy = true;
+
+    ESP_LOGD(TAG, "Forwarding %d reassembled bytes to MouthPad via NUS", len);
+    esp_err_t ret = ble_nus_client_send_pass_through(s_pass_through_buf, len, msg->reliable,
+                                                     write_ack_tag(msg));
+    if (ret != ESP_OK) {
+        relay_protocol_pass_through_sent(ret, s_pass_through_buf, write_ack_tag(msg));
+    } else if (len <= NUS_MAX_DATA_LEN) {
+        // Short enough to be copied into the queue
+        s_pass_through_busy = false;
+    }
+    return ret;
+}
+
+static esp_err_t handle_pass_through_to_mouthpad(const struct mouthpad_pass_through_to_mouthpad *msg) {
+
+    // This relay connects one MouthPad; there are no secondary links to write to
+    if (msg->device_index != 0) {
+        ESP_LOGW(TAG, "No MouthPad with device index %u", (unsigned int)msg->device_index);
+        // Nothing is pending for a link that does not exist
+        struct pass_through_ack none = { 0 };
+        struct pass_through_ack_report report =
+            pass_through_ack_complete(&none, write_ack_tag(msg), false, 1);
+        if (report.acked == 0) {
+            return ESP_OK;
+        }
+        return send_pass_through_report(
+            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED,
+            report, msg->device_index);
+    }
 
     // Check if NUS is ready
     if (!ble_nus_client_is_ready()) {
         ESP_LOGW(TAG, "NUS not ready, cannot forward data");
-        relay_msg.message_body.pass_through_to_mouthpad_response.error_code =
-            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED;
-        return relay_protocol_send_response(&relay_msg);
+        reset_pass_through_fragments();
+        return send_pass_through_response(
+            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED,
+            write_ack_tag(msg));
     }
 
     // Check message size
-    if (len > 240) {  // Max size from protobuf definition
-        ESP_LOGW(TAG, "Message too large: %d bytes", len);
-        relay_msg.message_body.pass_through_to_mouthpad_response.error_code =
-            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_TOO_LARGE;
-        return relay_protocol_send_response(&relay_msg);
+    if (msg->len > pb_membersize(mouthware_message_PassThroughToMouthpad_data_t, bytes)) {
+        ESP_LOGW(TAG, "Message too large: %d bytes", (int)msg->len);
+        return send_pass_through_response(
+            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_TOO_LARGE,
+            write_ack_tag(msg));
     }
 
-    // Forward data to BLE NUS
-    ESP_LOGD(TAG, "Forwarding %d bytes to MouthPad via NUS", len);
-    esp_err_t ret = ble_nus_client_send_data(data, len);
+    if (msg->more_fragments || msg->fragment != 0) {
+        return reassemble_pass_through(msg);
+    }
+
+    // Forward data to BLE NUS; acknowledged once the write completes
+    ESP_LOGD(TAG, "Forwarding %d bytes to MouthPad via NUS%s", (int)msg->len, msg->reliable ? " (reliable)" : "");
+    esp_err_t ret = ble_nus_client_send_pass_through(msg->data, msg->len, msg->reliable,
+                                                     write_ack_tag(msg));
 
     if (ret == ESP_OK) {
-        relay_msg.message_body.pass_through_to_mouthpad_response.error_code =
-            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED;
-    } else if (ret == ESP_ERR_TIMEOUT) {
-        relay_msg.message_body.pass_through_to_mouthpad_response.error_code =
-            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_TIMEOUT;
-    } else {
-        relay_msg.message_body.pass_through_to_mouthpad_response.error_code =
-            mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNKNOWN_ERROR;
+        return ESP_OK;
     }
 
-    return relay_protocol_send_response(&relay_msg);
+    // Queue full (host exceeded its credits) or not queued at all
+    relay_protocol_pass_through_sent(ret, NULL, write_ack_tag(msg));
+    return ret;
 }
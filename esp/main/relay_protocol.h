@@ -2,9 +2,13 @@
 #define RELAY_PROTOCOL_H
 
 #include "esp_err.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "link_telemetry.h"
+#include "pass_through_ack.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,28 +36,71 @@ esp_err_t relay_protocol_handle_usb_data(const uint8_t *data, uint16_t len);
 /**
  * @brief Process incoming data from BLE NUS
  *
- * Wraps data in PassThroughToApp and sends to USB CDC.
+ * Called on the Bluetooth task. Applies the stream filter and copies the
+ * notification to the NUS RX ring (CONFIG_MOUTHPAD_NUS_RX_QUEUE_SIZE); the
+ * nus_rx task wraps it in PassThroughToApp and sends it to USB CDC.
  *
  * @param data Pointer to received data
  * @param len Length of received data
- * @return ESP_OK on success, error code otherwise
+ * @return ESP_OK if queued or filtered, ESP_ERR_NO_MEM if the ring was full
  */
 esp_err_t relay_protocol_handle_ble_data(const uint8_t *data, uint16_t len);
 
+// Read the link and data path counters as a LinkTelemetry sample; also
+// what the link history (bond_history.h) is kept from. Safe from any task.
+void relay_protocol_telemetry_sample(struct link_telemetry_sample *sample);
+
+// Bytes of notifications waiting for the nus_rx task
+size_t relay_protocol_nus_rx_queued(void);
+
+// Notifications dropped because the NUS RX ring was full
+uint32_t relay_protocol_nus_rx_queue_full(void);
+
+/**
+ * @brief Acknowledge a completed pass-through write to the host
+ *
+ * Called by the NUS TX task for each write queued from a
+ * PassThroughToMouthpad message. Whether a response goes out now, later
+ * with others or not at all is up to the write's ack mode; one that does
+ * carries the host's credits.
+ *
+ * @param status ESP_OK if the MouthPad accepted the write
+ * @param payload Buffer the write was queued by reference from, now free
+ *                for reuse, or NULL if the data was copied
+ * @param ack Sequence and ack mode the write was queued with
+ */
+void relay_protocol_pass_through_sent(esp_err_t status, const uint8_t *payload,
+                                      struct pass_through_ack_tag ack);
+
+/**
+ * @brief Complete an EchoRequest that was sent on to the MouthPad
+ *
+ * Called by the NUS TX task once the timed write queued for the request
+ * has been acknowledged or has failed. Times are esp_timer_get_time().
+ *
+ * @param status ESP_OK if the MouthPad acknowledged the write
+ * @param write_us When the write was handed to the BLE stack
+ * @param ack_us When its write response arrived, or the write gave up
+ */
+void relay_protocol_echo_sent(esp_err_t status, int64_t write_us, int64_t ack_us);
+
 /**
  * @brief Send a response message to the host via USB CDC
  *
- * Encodes RelayToAppMessage and sends via USB CDC with framing.
+ * Encodes RelayToAppMessage and sends via USB CDC with framing. Sent from
+ * a request's handler, a message without a request_id gets that request's.
  *
  * @param message Pointer to RelayToAppMessage to send
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t relay_protocol_send_response(const void *message);
+esp_err_t relay_protocol_send_response(void *message);
 
 /**
  * @brief Notify relay protocol of BLE connection state change
  *
- * Updates internal connection state for status queries.
+ * Updates internal connection state for status queries and pushes a
+ * BleConnectionStatusResponse if the reported status changed.
+ * Connecting also ends the scanning state.
  *
  * @param connected true if connected, false if disconnected
  */
@@ -62,12 +109,31 @@ void relay_protocol_update_ble_connection(bool connected);
 /**
  * @brief Notify relay protocol of BLE scanning state change
  *
- * Updates internal scanning state for status queries.
+ * Updates internal scanning state for status queries and pushes a
+ * BleConnectionStatusResponse if the reported status changed.
  *
  * @param scanning true if scanning, false if not scanning
  */
 void relay_protocol_update_ble_scanning(bool scanning);
 
+/**
+ * @brief Push the connection status to the host if it changed
+ *
+ * Sends an unsolicited BleConnectionStatusResponse when the status the host
+ * last saw (pushed or read) is out of date. Called for state the relay
+ * protocol does not track itself, such as the link becoming fully ready.
+ */
+void relay_protocol_ble_status_changed(void);
+
+/**
+ * @brief Mark the cached DeviceInfoResponse stale
+ *
+ * DeviceInfoRead answers are encoded once and resent until DIS info, the
+ * bonded device or the active HID address changes; whatever changes one of
+ * them calls this. Safe from any task.
+ */
+void relay_protocol_device_info_changed(void);
+
 /**
  * @brief Update RSSI value for connected device
  *
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_timer.h"
+
+#include "time_base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The relay time base (common/time_base.h). esp_timer reads the systimer,
+// which counts on through frequency scaling and is one clock for both
+// cores; the CPU cycle counter is neither, so latency stamps stay on it.
+// Every call may be made from any task or interrupt.
+
+#define RELAY_TIME_HZ 1000000U
+
+// Raw 32-bit capture, RELAY_TIME_HZ, wrapping
+static inline uint32_t relay_time_now32(void) { return (uint32_t)esp_timer_get_time(); }
+
+static inline uint32_t relay_time_to_us(uint32_t ticks) { return ticks; }
+
+static inline uint64_t relay_time_to_ns(uint32_t ticks) { return (uint64_t)ticks * 1000U; }
+
+// Microseconds since boot, the time every stamp leaving the relay uses
+static inline uint64_t relay_time_us64(void) { return (uint64_t)esp_timer_get_time(); }
+
+// Microseconds between a relay_time_now32() and now
+static inline uint32_t relay_time_since_us(uint32_t start)
+{
+    return relay_time_to_us(relay_time_now32() - start);
+}
+
+// Microseconds since boot, 32 bits, wrapping; for clocks shared by the
+// common modules
+static inline uint32_t relay_time_us32(void) { return (uint32_t)relay_time_us64(); }
+
+#ifdef __cplusplus
+}
+#endif
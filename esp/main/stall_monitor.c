@@ -0,0 +1,203 @@
+#include "stall_monitor.h"
+
+#if CONFIG_MOUTHPAD_STALL_WATCH
+
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+#include "activity.h"
+#include "ble_nus.h"
+#include "relay_dispatch.h"
+#include "relay_protocol.h"
+#include "task_config.h"
+#include "usb_cdc.h"
+
+static const char *TAG = "STALL";
+
+enum {
+    SOURCE_PIPELINE = STALL_SOURCE_PIPELINE,
+    SOURCE_WATCH,
+    SOURCE_RELAY_SIDE,
+    SOURCE_BT_SIDE,
+    SOURCE_COUNT,
+};
+
+_Static_assert(SOURCE_COUNT <= STALL_WATCH_SOURCES_MAX, "Too many stall sources");
+
+static const char *const s_source_names[SOURCE_COUNT] = {
+    [SOURCE_PIPELINE] = "hid pipeline",
+    [SOURCE_WATCH] = "watch task",
+    [SOURCE_RELAY_SIDE] = "relay side",
+    [SOURCE_BT_SIDE] = "bt side",
+};
+
+typedef struct {
+    const char *name;
+    uint8_t source;
+    BaseType_t core;
+    TaskHandle_t task;
+} probe_t;
+
+static probe_t s_probes[] = {
+    { .name = "stall_relay", .source = SOURCE_RELAY_SIDE, .core = TASK_RELAY_CORE },
+    { .name = "stall_bt", .source = SOURCE_BT_SIDE, .core = TASK_BT_SIDE_CORE },
+};
+
+static __NOINIT_ATTR struct stall_snapshot s_snapshot;
+
+static TaskHandle_t s_watch_task;
+static atomic_bool s_watching;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+// Slots for uxTaskGetSystemState(), which fails outright if there are more
+// tasks than this
+#define STALL_TASK_SLOTS 32
+static TaskStatus_t s_status[STALL_TASK_SLOTS];
+#endif
+
+static uint32_t uptime_us(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+static uint32_t uptime_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void probe_task(void *arg)
+{
+    const probe_t *probe = arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        stall_watch_probe_done(probe->source);
+    }
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static uint8_t task_state(eTaskState state)
+{
+    switch (state) {
+        case eRunning:
+            return STALL_THREAD_RUNNING;
+        case eReady:
+            return STALL_THREAD_READY;
+        case eBlocked:
+            return STALL_THREAD_BLOCKED;
+        case eSuspended:
+            // Also a task blocked with no timeout
+            return STALL_THREAD_SUSPENDED;
+        default:
+            return STALL_THREAD_OTHER;
+    }
+}
+#endif
+
+// Only counters that are read without waiting on a relay task
+static void capture(struct stall_snapshot *snapshot)
+{
+    snapshot->queue_depth[TRACE_QUEUE_CDC_TX] = MIN(usb_cdc_tx_queued(), UINT16_MAX);
+    snapshot->queue_depth[TRACE_QUEUE_PROTOCOL] = relay_dispatch_queued();
+    snapshot->queue_depth[TRACE_QUEUE_NUS_TX] = ble_nus_client_tx_pending();
+    snapshot->queue_depth[TRACE_QUEUE_NUS_RX] = MIN(relay_protocol_nus_rx_queued(), UINT16_MAX);
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    UBaseType_t count = uxTaskGetSystemState(s_status, STALL_TASK_SLOTS, NULL);
+
+    for (UBaseType_t i = 0; i < count && snapshot->thread_count < STALL_WATCH_THREADS_MAX; i++) {
+        struct stall_thread *thread = &snapshot->threads[snapshot->thread_count++];
+
+        strncpy(thread->name, s_status[i].pcTaskName, sizeof(thread->name) - 1);
+        thread->name[sizeof(thread->name) - 1] = '\0';
+        thread->priority = (int8_t)s_status[i].uxCurrentPriority;
+        thread->state = task_state(s_status[i].eCurrentState);
+    }
+#endif
+}
+
+static void activity_changed(activity_level_t level)
+{
+    bool active = level == ACTIVITY_ACTIVE;
+
+    if (atomic_exchange(&s_watching, active) != active && active) {
+        xTaskNotifyGive(s_watch_task);
+    }
+}
+
+static void watch_task(void *arg)
+{
+    (void)arg;
+    const int64_t period_us = CONFIG_MOUTHPAD_STALL_PERIOD_MS * 1000LL;
+    const TickType_t period = pdMS_TO_TICKS(CONFIG_MOUTHPAD_STALL_PERIOD_MS);
+    TickType_t last_wake = xTaskGetTickCount();
+    int64_t next_us = esp_timer_get_time();
+
+    for (;;) {
+        // Nothing to watch while the user is idle; saves the wakeups
+        if (!atomic_load(&s_watching)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            last_wake = xTaskGetTickCount();
+            next_us = esp_timer_get_time();
+        }
+
+        xTaskDelayUntil(&last_wake, period);
+        next_us += period_us;
+
+        int64_t late = esp_timer_get_time() - next_us;
+
+        stall_watch_sample(SOURCE_WATCH, late > 0 ? (uint32_t)late : 0);
+
+        for (size_t i = 0; i < sizeof(s_probes) / sizeof(s_probes[0]); i++) {
+            if (stall_watch_probe_start(s_probes[i].source)) {
+                xTaskNotifyGive(s_probes[i].task);
+            }
+        }
+
+        stall_watch_check();
+    }
+}
+
+esp_err_t stall_monitor_init(bool keep)
+{
+    stall_watch_init(&s_snapshot, keep, &(struct stall_watch_config){
+        .source_names = s_source_names,
+        .source_count = SOURCE_COUNT,
+        .threshold_us = CONFIG_MOUTHPAD_STALL_THRESHOLD_MS * 1000U,
+        .now_us = uptime_us,
+        .now_ms = uptime_ms,
+        .capture = capture,
+    });
+
+    for (size_t i = 0; i < sizeof(s_probes) / sizeof(s_probes[0]); i++) {
+        if (xTaskCreatePinnedToCore(probe_task, s_probes[i].name, TASK_STALL_PROBE_STACK_SIZE,
+                                    &s_probes[i], TASK_STALL_PROBE_PRIORITY, &s_probes[i].task,
+                                    s_probes[i].core) != pdPASS) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    atomic_store(&s_watching, activity_level() == ACTIVITY_ACTIVE);
+    if (xTaskCreatePinnedToCore(watch_task, "stall_watch", TASK_STALL_WATCH_STACK_SIZE, NULL,
+                                TASK_STALL_WATCH_PRIORITY, &s_watch_task,
+                                TASK_STALL_WATCH_CORE_ID) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = activity_subscribe(activity_changed);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No activity slot; watching all the time");
+        atomic_store(&s_watching, true);
+        xTaskNotifyGive(s_watch_task);
+    }
+
+    return ESP_OK;
+}
+
+#endif // CONFIG_MOUTHPAD_STALL_WATCH
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#include "stall_watch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Latency spike watchdog on FreeRTOS (common/stall_watch.h,
+// CONFIG_MOUTHPAD_STALL_WATCH). While the user is active a watch task wakes
+// every CONFIG_MOUTHPAD_STALL_PERIOD_MS and notifies one probe task on each
+// side, at the relay tasks' priority; the wait until a probe runs is how
+// long a relay task there would have waited. The watch task's own lateness
+// shows the Bluetooth host, esp_timer or interrupts holding its core. HID
+// input is timed through transport_hid_handle_input().
+
+#if CONFIG_MOUTHPAD_STALL_WATCH
+
+// Adopt the retained snapshot and start the tasks. Call after
+// activity_init(); keep is what trace_ring_init() returned.
+esp_err_t stall_monitor_init(bool keep);
+
+// Stamp a report on arrival
+static inline int64_t stall_monitor_start(void) { return esp_timer_get_time(); }
+
+// Note a report handed to USB
+static inline void stall_monitor_pipeline(int64_t start_us)
+{
+    stall_watch_sample(STALL_SOURCE_PIPELINE, (uint32_t)(esp_timer_get_time() - start_us));
+}
+
+#else
+
+static inline esp_err_t stall_monitor_init(bool keep) {
+    (void)keep;
+    return ESP_OK;
+}
+
+static inline int64_t stall_monitor_start(void) { return 0; }
+static inline void stall_monitor_pipeline(int64_t start_us) { (void)start_us; }
+
+#endif // CONFIG_MOUTHPAD_STALL_WATCH
+
+#ifdef __cplusplus
+}
+#endif
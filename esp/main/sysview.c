@@ -0,0 +1,31 @@
+#include "sysview.h"
+
+#if CONFIG_MOUTHPAD_SYSVIEW
+
+// Called by SystemView each time a recording starts, so the marker names
+// reach the host whenever it attaches
+static void send_marker_names(void)
+{
+    for (int i = 0; i < RELAY_MARKER_COUNT; i++) {
+        SEGGER_SYSVIEW_NameMarker(i, relay_marker_name(i));
+    }
+}
+
+static SEGGER_SYSVIEW_MODULE s_relay_module = {
+    .sModule = "M=MouthPadRelay",
+    .NumEvents = 0,
+    .pfSendModuleDesc = send_marker_names,
+};
+
+void sysview_init(void)
+{
+    SEGGER_SYSVIEW_RegisterModule(&s_relay_module);
+}
+
+#else
+
+void sysview_init(void)
+{
+}
+
+#endif
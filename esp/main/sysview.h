@@ -0,0 +1,37 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#include "relay_markers.h"
+
+#if CONFIG_MOUTHPAD_SYSVIEW
+#include "SEGGER_SYSVIEW.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SystemView markers around the relay hot paths (common/relay_markers.h).
+// With sdkconfig.sysview (make SYSVIEW=1) app_trace records task switches
+// and ISRs over JTAG, and these add spans for the relay's own work. Without
+// it they compile to nothing.
+
+#if CONFIG_MOUTHPAD_SYSVIEW
+
+static inline void sysview_mark_start(enum relay_marker marker) { SEGGER_SYSVIEW_MarkStart(marker); }
+static inline void sysview_mark_stop(enum relay_marker marker) { SEGGER_SYSVIEW_MarkStop(marker); }
+
+#else
+
+static inline void sysview_mark_start(enum relay_marker marker) { (void)marker; }
+static inline void sysview_mark_stop(enum relay_marker marker) { (void)marker; }
+
+#endif
+
+// Register the marker names with SystemView; a no-op without it
+void sysview_init(void);
+
+#ifdef __cplusplus
+}
+#endif
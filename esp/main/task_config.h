@@ -0,0 +1,134 @@
+#pragma once
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+
+// Where every relay task runs, selected by the task placement profile in
+// Kconfig. Bluedroid and the BT controller are pinned by their own sdkconfig
+// options; TASK_BT_CORE follows them so the BLE-side tasks below share their
+// core. Priorities and stack sizes are the same in both profiles, only the
+// core assignment changes:
+//
+//   task         priority  split-cores  shared
+//   TinyUSB      5         relay core   core 0
+//   usb_init     5         relay core   any
+//   nus_tx       5         relay core   any
+//   nus_rx       5         relay core   any
+//   cdc_rx       4         relay core   any
+//   relay_proto  4         relay core   any
+//   nus_cccd     5         BT core      any
+//   button_task  3         relay core   any
+//   hid_out      3         BT core      any
+//   hid_scan     2         BT core      any
+//   cdc_log      1         relay core   any
+//   persist      1         relay core   any
+//   fw_update    1         relay core   any
+//   bench        5         BT core      any
+//   stall_watch  15        relay core   any
+//   stall_relay  4         relay core   any
+//   stall_bt     4         BT core      any
+//
+// The esp_hidh event task and the esp_timer task are created by ESP-IDF and
+// keep their sdkconfig placement.
+
+#ifdef CONFIG_BT_BLUEDROID_PINNED_TO_CORE
+#define TASK_BT_CORE CONFIG_BT_BLUEDROID_PINNED_TO_CORE
+#else
+#define TASK_BT_CORE 0
+#endif
+
+#if CONFIG_MOUTHPAD_TASKS_SPLIT_CORES
+// USB and the HID/NUS relay pipeline get the core Bluetooth does not use
+#define TASK_RELAY_CORE     (1 - TASK_BT_CORE)
+#define TASK_BT_SIDE_CORE   TASK_BT_CORE
+#define TASK_TINYUSB_CORE   TASK_RELAY_CORE
+#else
+// Previous behaviour: let the scheduler place tasks, TinyUSB beside Bluetooth
+#define TASK_RELAY_CORE     tskNO_AFFINITY
+#define TASK_BT_SIDE_CORE   tskNO_AFFINITY
+#define TASK_TINYUSB_CORE   0
+#endif
+
+// TinyUSB device task: HID IN completions and CDC traffic
+#define TASK_TINYUSB_PRIORITY       5
+#define TASK_TINYUSB_STACK_SIZE     4096
+#define TASK_TINYUSB_CORE_ID        TASK_TINYUSB_CORE
+
+// Boot only: TinyUSB and CDC setup alongside the Bluetooth bring-up in
+// app_main, then exits
+#define TASK_USB_INIT_PRIORITY      5
+#define TASK_USB_INIT_STACK_SIZE    4096
+#define TASK_USB_INIT_CORE_ID       TASK_RELAY_CORE
+
+// CDC to MouthPad NUS writes
+#define TASK_NUS_TX_PRIORITY        5
+#define TASK_NUS_TX_STACK_SIZE      4096
+#define TASK_NUS_TX_CORE_ID         TASK_RELAY_CORE
+
+// MouthPad notifications to CDC0, off the Bluetooth task
+#define TASK_NUS_RX_PRIORITY        5
+#define TASK_NUS_RX_STACK_SIZE      4096
+#define TASK_NUS_RX_CORE_ID         TASK_RELAY_CORE
+
+// CDC0 and relay interface frames: decode, pass-through and inline handlers
+#define TASK_CDC_RX_PRIORITY        4
+#define TASK_CDC_RX_STACK_SIZE      4096
+#define TASK_CDC_RX_CORE_ID         TASK_RELAY_CORE
+
+// Relay protocol control messages from CDC0 (relay_dispatch.h)
+#define TASK_RELAY_PROTO_PRIORITY   4
+#define TASK_RELAY_PROTO_STACK_SIZE 4096
+#define TASK_RELAY_PROTO_CORE_ID    TASK_RELAY_CORE
+
+// Deferred NUS CCCD writes after discovery
+#define TASK_NUS_CCCD_PRIORITY      5
+#define TASK_NUS_CCCD_STACK_SIZE    4096
+#define TASK_NUS_CCCD_CORE_ID       TASK_BT_SIDE_CORE
+
+// Boot button debounce and gestures
+#define TASK_BUTTON_PRIORITY        3
+#define TASK_BUTTON_STACK_SIZE      3072
+#define TASK_BUTTON_CORE_ID         TASK_RELAY_CORE
+
+// Host output reports to the MouthPad (CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS)
+#define TASK_HID_OUT_PRIORITY       3
+#define TASK_HID_OUT_STACK_SIZE     3072
+#define TASK_HID_OUT_CORE_ID        TASK_BT_SIDE_CORE
+
+// Connection manager: scans until a MouthPad opens, then starts discovery
+#define TASK_HID_SCAN_PRIORITY      2
+#define TASK_HID_SCAN_STACK_SIZE    4096
+#define TASK_HID_SCAN_CORE_ID       TASK_BT_SIDE_CORE
+
+// CDC1 log ring drain
+#define TASK_CDC_LOG_PRIORITY       1
+#define TASK_CDC_LOG_STACK_SIZE     3072
+#define TASK_CDC_LOG_CORE_ID        TASK_RELAY_CORE
+
+// Deferred NVS writes of bond and device info changes (persist.h)
+#define TASK_PERSIST_PRIORITY       1
+#define TASK_PERSIST_STACK_SIZE     3072
+#define TASK_PERSIST_CORE_ID        TASK_RELAY_CORE
+
+// Firmware update writes to the next OTA partition (ota_update.h)
+#define TASK_FW_UPDATE_PRIORITY     1
+#define TASK_FW_UPDATE_STACK_SIZE   4096
+#define TASK_FW_UPDATE_CORE_ID      TASK_RELAY_CORE
+
+// Stall watch (stall_monitor.h): wakes every few ms while the user is
+// active, above every relay task so its own lateness shows the Bluetooth
+// host, esp_timer or interrupts holding the core
+#define TASK_STALL_WATCH_PRIORITY   15
+#define TASK_STALL_WATCH_STACK_SIZE 3072
+#define TASK_STALL_WATCH_CORE_ID    TASK_RELAY_CORE
+
+// Stall probes, one per side at the relay tasks' priority: how long a
+// relay task there waits to run
+#define TASK_STALL_PROBE_PRIORITY   TASK_RELAY_PROTO_PRIORITY
+#define TASK_STALL_PROBE_STACK_SIZE 2048
+
+// Synthetic USB load from the CDC1 "bench" command, one per run (bench.h).
+// Beside Bluetooth, where real input reports come from.
+#define TASK_BENCH_PRIORITY         5
+#define TASK_BENCH_STACK_SIZE       3072
+#define TASK_BENCH_CORE_ID          TASK_BT_SIDE_CORE
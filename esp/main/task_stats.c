@@ -0,0 +1,69 @@
+#include "task_stats.h"
+
+#if CONFIG_MOUTHPAD_TASK_STATS
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+// Slots for uxTaskGetSystemState(), which fails outright if there are more
+// tasks than this. Past THREAD_STATS_MAX, those with the most run time
+// since boot are kept.
+#define TASK_STATS_SLOTS 32
+
+static TaskStatus_t s_status[TASK_STATS_SLOTS];
+static struct thread_stats_sample s_samples[TASK_STATS_SLOTS];
+static atomic_flag s_busy = ATOMIC_FLAG_INIT;
+
+esp_err_t task_stats_read(struct thread_stats_report *report) {
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t count;
+
+    if (atomic_flag_test_and_set(&s_busy)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    count = uxTaskGetSystemState(s_status, TASK_STATS_SLOTS, &total);
+    if (count == 0) {
+        atomic_flag_clear(&s_busy);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *status = &s_status[i];
+        struct thread_stats_sample *sample = &s_samples[i];
+
+        *sample = (struct thread_stats_sample){
+            .id = status->xTaskNumber,
+            .runtime = status->ulRunTimeCounter,
+            // StackType_t is a byte on ESP-IDF, so this is already in bytes
+            .stack_unused = status->usStackHighWaterMark,
+        };
+        strncpy(sample->name, status->pcTaskName, sizeof(sample->name) - 1);
+    }
+
+    // Keep the busiest if there are more tasks than a report holds
+    if (count > THREAD_STATS_MAX) {
+        for (UBaseType_t i = 0; i < THREAD_STATS_MAX; i++) {
+            for (UBaseType_t j = i + 1; j < count; j++) {
+                if (s_samples[j].runtime > s_samples[i].runtime) {
+                    struct thread_stats_sample tmp = s_samples[i];
+                    s_samples[i] = s_samples[j];
+                    s_samples[j] = tmp;
+                }
+            }
+        }
+        count = THREAD_STATS_MAX;
+    }
+
+    thread_stats_update(s_samples, count, total,
+                        (uint32_t)(esp_timer_get_time() / 1000), report);
+
+    atomic_flag_clear(&s_busy);
+    return ESP_OK;
+}
+
+#endif // CONFIG_MOUTHPAD_TASK_STATS
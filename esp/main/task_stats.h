@@ -0,0 +1,39 @@
+#pragma once
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "thread_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-task CPU share and stack high-water mark for the "top" command on
+// CDC1 and ThreadStatsRead on CDC0 (CONFIG_MOUTHPAD_TASK_STATS). Built on
+// uxTaskGetSystemState() and the FreeRTOS run time counters. Each read
+// covers the time since the previous one.
+//
+// CPU shares are of one core, so on the ESP32-S3 the tasks add up to 200%
+// with IDLE0 and IDLE1 taking what is left on each. FreeRTOS does not count
+// context switches or keep stack sizes, so those fields stay 0 and only the
+// unused stack is reported.
+
+#if CONFIG_MOUTHPAD_TASK_STATS
+
+// Read every task. ESP_ERR_INVALID_STATE while another read is running,
+// ESP_ERR_NO_MEM if there are more tasks than slots.
+esp_err_t task_stats_read(struct thread_stats_report *report);
+
+#else
+
+static inline esp_err_t task_stats_read(struct thread_stats_report *report) {
+    (void)report;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_MOUTHPAD_TASK_STATS
+
+#ifdef __cplusplus
+}
+#endif
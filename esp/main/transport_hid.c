@@ -1,9 +1,23 @@
 #include "transport_hid.h"
 #include "usb_hid.h"
-#include "leds.h"
+#include "mouthpad_hid_reports.h"
+#include "activity.h"
+#include "fault_inject.h"
+#include "hid_mirror.h"
+#include "relay_protocol.h"
+#include "probe.h"
+#include "relay_time.h"
+#include "sysview.h"
+#include "stall_monitor.h"
 #include "esp_log.h"
 #include "esp_hidh.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "task_config.h"
+#include "trace_ring.h"
 #include "string.h"
+#include <stdatomic.h>
 
 static const char *TAG = "TRANSPORT_HID";
 
@@ -13,6 +27,75 @@ static esp_hidh_dev_t *s_active_dev = NULL;
 static uint8_t s_active_addr[6] = {0};
 static bool s_has_active_addr = false;
 
+// Written by the input producer (esp_hidh event task or BTC task), read for
+// LinkTelemetry
+static atomic_uint s_reports_received;
+static atomic_uint s_reports_dropped;
+
+// Set while the bench command feeds reports with no MouthPad connected
+static atomic_bool s_injecting;
+
+#if CONFIG_MOUTHPAD_HID_NOTIFY_FAST_PATH
+// usb_hid takes reports from one producer at a time. With the notify fast
+// path, input arrives on the BTC task while esp_hidh can still deliver a
+// few on its event task, and the release on disconnect runs there too.
+static SemaphoreHandle_t s_input_lock;
+#define INPUT_LOCK() xSemaphoreTake(s_input_lock, portMAX_DELAY)
+#define INPUT_UNLOCK() xSemaphoreGive(s_input_lock)
+#else
+#define INPUT_LOCK()
+#define INPUT_UNLOCK()
+#endif
+
+#if CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS
+// Host output reports waiting for the hid_out task, latest value per ID.
+// Filled from the TinyUSB task.
+static struct mouthpad_hid_output_queue s_output_queue;
+static portMUX_TYPE s_output_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_output_task;
+
+// Retry delay when Bluedroid refuses the write (queue full)
+#define OUTPUT_RETRY_MS 5
+
+static void output_task(void *arg)
+{
+    (void)arg;
+    uint8_t data[MOUTHPAD_HID_OUTPUT_SIZE_MAX];
+    uint8_t len;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (true) {
+            taskENTER_CRITICAL(&s_output_lock);
+            uint8_t report_id = mouthpad_hid_output_take(&s_output_queue, data, &len);
+            taskEXIT_CRITICAL(&s_output_lock);
+
+            if (report_id == 0) {
+                break;
+            }
+
+            esp_hidh_dev_t *dev = s_active_dev;
+            if (dev == NULL) {
+                continue;
+            }
+
+            // esp_hidh sends output reports as Write Without Response
+            esp_err_t ret = esp_hidh_dev_output_set(dev, 0, report_id, data, len);
+            if (ret == ESP_ERR_NO_MEM) {
+                taskENTER_CRITICAL(&s_output_lock);
+                mouthpad_hid_output_retry(&s_output_queue, report_id, data, len);
+                taskEXIT_CRITICAL(&s_output_lock);
+                vTaskDelay(pdMS_TO_TICKS(OUTPUT_RETRY_MS));
+            } else if (ret != ESP_OK) {
+                ESP_LOGD(TAG, "Output report %u not written: %s", report_id,
+                         esp_err_to_name(ret));
+            }
+        }
+    }
+}
+#endif
+
 esp_err_t transport_hid_init(void)
 {
     ESP_LOGI(TAG, "Initializing BLE HID to USB HID bridge");
@@ -24,6 +107,26 @@ esp_err_t transport_hid_init(void)
     s_has_active_addr = false;
     memset(s_active_addr, 0, sizeof(s_active_addr));
 
+#if CONFIG_MOUTHPAD_HID_NOTIFY_FAST_PATH
+    if (s_input_lock == NULL) {
+        s_input_lock = xSemaphoreCreateMutex();
+        if (s_input_lock == NULL) {
+            ESP_LOGE(TAG, "Failed to create HID input lock");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+#endif
+
+#if CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS
+    if (s_output_task == NULL &&
+        xTaskCreatePinnedToCore(output_task, "hid_out", TASK_HID_OUT_STACK_SIZE, NULL,
+                                TASK_HID_OUT_PRIORITY, &s_output_task,
+                                TASK_HID_OUT_CORE_ID) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create HID output task");
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+
     ESP_LOGI(TAG, "HID transport bridge initialized successfully");
     return ESP_OK;
 }
@@ -60,6 +163,7 @@ esp_err_t transport_hid_stop(void)
     s_active_dev = NULL;
     s_has_active_addr = false;
     memset(s_active_addr, 0, sizeof(s_active_addr));
+    relay_protocol_device_info_changed();
 
     ESP_LOGI(TAG, "HID transport bridge stopped");
     return ESP_OK;
@@ -85,6 +189,7 @@ esp_err_t transport_hid_set_device(esp_hidh_dev_t *dev, const uint8_t *bda)
     s_active_dev = dev;
     memcpy(s_active_addr, bda, sizeof(s_active_addr));
     s_has_active_addr = true;
+    relay_protocol_device_info_changed();
 
     ESP_LOGI(TAG, "Active HID device set: %02X:%02X:%02X:%02X:%02X:%02X",
              bda[0], bda[1], bda[2], bda[3], bda[4], bda[5]);
@@ -98,6 +203,7 @@ void transport_hid_clear_device(void)
     s_active_dev = NULL;
     s_has_active_addr = false;
     memset(s_active_addr, 0, sizeof(s_active_addr));
+    relay_protocol_device_info_changed();
 }
 
 esp_err_t transport_hid_get_active_address(uint8_t *addr)
@@ -114,35 +220,161 @@ void transport_hid_handle_disconnect(void)
     ESP_LOGI(TAG, "Handling HID device disconnect - releasing stuck inputs");
 
     // Release any stuck HID inputs to prevent buttons/movement from being stuck
+    INPUT_LOCK();
     usb_hid_release_all();
+    INPUT_UNLOCK();
 
     // Clear the device state
     transport_hid_clear_device();
 }
 
-esp_err_t transport_hid_handle_input(uint8_t report_id, const uint8_t *data, uint16_t length)
+static void count_dropped(void)
 {
-    if (!s_bridge_active) {
+    atomic_fetch_add_explicit(&s_reports_dropped, 1, memory_order_relaxed);
+    trace_ring_count(TRACE_EVENT_DROP, TRACE_PATH_HID);
+}
+
+static esp_err_t forward_input(uint8_t report_id, const uint8_t *data, uint16_t length)
+{
+    bool injected = atomic_load_explicit(&s_injecting, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&s_reports_received, 1, memory_order_relaxed);
+
+    if (!s_bridge_active && !injected) {
         ESP_LOGD(TAG, "Bridge not active, dropping HID input");
+        count_dropped();
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (!s_active_dev) {
+    if (!s_active_dev && !injected) {
         ESP_LOGD(TAG, "No active HID device, dropping input");
+        count_dropped();
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Check USB HID readiness dynamically
-    if (!usb_hid_ready()) {
+    // Only require enumeration here; a busy endpoint is handled by usb_hid
+    if (!usb_hid_mounted()) {
         ESP_LOGD(TAG, "USB HID not ready, dropping input");
+        count_dropped();
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Host asleep: queued reports would only arrive as a stale burst on
+    // resume. Drop them, and let a button press wake the host.
+    if (usb_hid_suspended()) {
+        if (report_id == MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS && length >= 1 && data[0] != 0) {
+            usb_hid_remote_wakeup();
+        }
+        count_dropped();
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Forward HID report to USB immediately (fast path)
-    usb_hid_send_report(report_id, data, length);
+    if (report_id == MOUTHPAD_HID_REPORT_ID_CONSUMER &&
+        length == MOUTHPAD_HID_CONSUMER_BITMAP_SIZE) {
+        // Old firmware sends a 1-byte consumer bitmap, translate to 16-bit usage
+        uint16_t usage = mouthpad_hid_consumer_usage(data[0]);
+        uint8_t report[MOUTHPAD_HID_REPORT_SIZE_CONSUMER] = {usage & 0xFF, usage >> 8};
+
+        ESP_LOGD(TAG, "Consumer control: bitmap 0x%02x -> usage 0x%04x", data[0], usage);
+        usb_hid_send_report(report_id, report, sizeof(report));
+    } else {
+        // Queue for USB; never blocks the BT stack on the IN endpoint
+        usb_hid_send_report(report_id, data, length);
+    }
 
-    // Non-critical notification after report sending
-    leds_notify_activity();
+    // Feeds the link parameters, LED and RSSI polling after the report is queued
+    activity_mark();
 
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+esp_err_t transport_hid_handle_input(uint8_t report_id, const uint8_t *data, uint16_t length)
+{
+    esp_err_t ret;
+
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+    // Only the MouthPad's reports; the bench's injected ones pass
+    if (!atomic_load(&s_injecting) && fault_inject_notification(FAULT_INJECT_HID)) {
+        return ESP_OK;
+    }
+#endif
+
+    int64_t start_us = stall_monitor_start();
+
+    probe_mark(RELAY_PROBE_HID_RX);
+    sysview_mark_start(RELAY_MARKER_HID_INPUT);
+    INPUT_LOCK();
+    if (!hid_mirror_enabled()) {
+        ret = forward_input(report_id, data, length);
+    } else {
+        uint64_t rx_us = relay_time_us64();
+        ret = forward_input(report_id, data, length);
+        hid_mirror_record(report_id, data, length, rx_us, relay_time_us64(), ret == ESP_OK);
+    }
+    INPUT_UNLOCK();
+    sysview_mark_stop(RELAY_MARKER_HID_INPUT);
+    stall_monitor_pipeline(start_us);
+    return ret;
+}
+
+esp_err_t transport_hid_inject_start(void)
+{
+    if (s_active_dev != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    atomic_store(&s_injecting, true);
+    usb_hid_set_idle_bypass(true);
+    return ESP_OK;
+}
+
+esp_err_t transport_hid_inject_input(uint8_t report_id, const uint8_t *data, uint16_t length)
+{
+    if (!atomic_load(&s_injecting)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return transport_hid_handle_input(report_id, data, length);
+}
+
+void transport_hid_inject_stop(void)
+{
+    atomic_store(&s_injecting, false);
+    usb_hid_set_idle_bypass(false);
+
+    // Nothing synthetic may stay held down on the host
+    INPUT_LOCK();
+    usb_hid_release_all();
+    INPUT_UNLOCK();
+}
+
+esp_err_t transport_hid_handle_output(uint8_t report_id, const uint8_t *data, uint16_t length)
+{
+#if CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS
+    if (s_active_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    taskENTER_CRITICAL(&s_output_lock);
+    bool queued = mouthpad_hid_output_put(&s_output_queue, report_id, data, length);
+    taskEXIT_CRITICAL(&s_output_lock);
+
+    if (!queued) {
+        ESP_LOGD(TAG, "No output report %u of %u bytes", report_id, length);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xTaskNotifyGive(s_output_task);
+    return ESP_OK;
+#else
+    (void)report_id;
+    (void)data;
+    (void)length;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void transport_hid_get_counts(uint32_t *received, uint32_t *dropped)
+{
+    *received = atomic_load_explicit(&s_reports_received, memory_order_relaxed);
+    *dropped = atomic_load_explicit(&s_reports_dropped, memory_order_relaxed) +
+               usb_hid_dropped_reports();
+}
@@ -3,6 +3,7 @@
 #include "esp_err.h"
 #include "esp_hidh.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,6 +70,8 @@ void transport_hid_handle_disconnect(void);
 /**
  * @brief Handle HID input report (called from BLE HID client)
  *
+ * Also recorded for the HID mirror stream while a host has it enabled.
+ *
  * @param report_id HID report ID
  * @param data Report data
  * @param length Data length
@@ -76,6 +79,54 @@ void transport_hid_handle_disconnect(void);
  */
 esp_err_t transport_hid_handle_input(uint8_t report_id, const uint8_t *data, uint16_t length);
 
+/**
+ * @brief Start feeding synthetic input reports for the bench command
+ *
+ * Injected reports take the same path to USB as reports from the MouthPad.
+ * Only allowed with no MouthPad connected, since usb_hid takes reports from
+ * one producer at a time.
+ *
+ * @return esp_err_t ESP_OK, or ESP_ERR_INVALID_STATE while a device is active
+ */
+esp_err_t transport_hid_inject_start(void);
+
+/**
+ * @brief Forward one synthetic input report
+ *
+ * Same arguments and result as transport_hid_handle_input();
+ * ESP_ERR_INVALID_STATE outside transport_hid_inject_start()/stop().
+ */
+esp_err_t transport_hid_inject_input(uint8_t report_id, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Stop injecting and release anything the synthetic reports left set
+ */
+void transport_hid_inject_stop(void);
+
+/**
+ * @brief Queue a host output report for the MouthPad
+ *
+ * Returns at once; the hid_out task writes it to the active device with
+ * esp_hidh_dev_output_set(). An unsent report is replaced by a newer one
+ * with the same ID. Needs CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS.
+ *
+ * @param report_id HID report ID, listed in MOUTHPAD_HID_OUTPUT_REPORTS
+ * @param data Report payload without the ID byte
+ * @param length Payload length
+ * @return ESP_OK if queued, ESP_ERR_INVALID_ARG for an ID with no output
+ *         report, ESP_ERR_NOT_SUPPORTED without the option
+ */
+esp_err_t transport_hid_handle_output(uint8_t report_id, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Count HID reports since boot
+ *
+ * @param received Reports received from the MouthPad
+ * @param dropped Reports that never reached the host: no USB, host
+ *                suspended, or USB HID queue full
+ */
+void transport_hid_get_counts(uint32_t *received, uint32_t *dropped);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
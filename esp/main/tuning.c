@@ -0,0 +1,184 @@
+#include "tuning.h"
+
+#include <sys/param.h>
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+
+#include "ble_conn_params.h"
+#include "leds.h"
+#include "persist.h"
+#include "relay_protocol.h"
+#include "tuning_profile.h"
+
+static const char *TAG = "TUNING";
+
+#define NVS_NAMESPACE "tuning"
+#define NVS_KEY_PROFILE "profile"
+
+#define KNOB(name) mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_##name
+#define KNOB_BIT(name) (1u << KNOB(name))
+
+#if CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE
+#define TX_TARGET_DBM CONFIG_MOUTHPAD_TX_POWER_TARGET_DBM
+#define TX_TARGET_APPLIED KNOB_BIT(TX_POWER_TARGET)
+#else
+#define TX_TARGET_DBM (-70)
+#define TX_TARGET_APPLIED 0
+#endif
+
+// Serializes the writers: host writes, the button and the restore
+static SemaphoreHandle_t s_mutex;
+static int s_persist_id = -1;
+
+static void tuning_changed(uint32_t knobs)
+{
+    if (knobs & (KNOB_BIT(ACTIVE_INTERVAL) | KNOB_BIT(IDLE_INTERVAL) | KNOB_BIT(IDLE_LATENCY))) {
+        ble_conn_params_retune();
+    }
+    if (knobs & KNOB_BIT(STATUS_LIGHTS)) {
+        leds_set_dark(!tuning_profile_get(KNOB(STATUS_LIGHTS)));
+    }
+    // The TX power target and CDC0 coalescing are read where they are used
+}
+
+static void log_profile(void)
+{
+    char line[160];
+
+    tuning_profile_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+}
+
+// Persist task
+static void tuning_persist_flush(void)
+{
+    struct tuning_profile_saved saved;
+    nvs_handle_t nvs_handle;
+
+    tuning_profile_save(&saved);
+
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS for the tuning profile: %s", esp_err_to_name(ret));
+        return;
+    }
+    ret = nvs_set_blob(nvs_handle, NVS_KEY_PROFILE, &saved, sizeof(saved));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save the tuning profile: %s", esp_err_to_name(ret));
+    }
+}
+
+static void restore(void)
+{
+    struct tuning_profile_saved saved;
+    size_t len = sizeof(saved);
+    nvs_handle_t nvs_handle;
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return;
+    }
+    esp_err_t ret = nvs_get_blob(nvs_handle, NVS_KEY_PROFILE, &saved, &len);
+    nvs_close(nvs_handle);
+    if (ret != ESP_OK) {
+        // A blob of another size does not fit and lands here too
+        if (ret != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Saved tuning profile not read: %s", esp_err_to_name(ret));
+        }
+        return;
+    }
+
+    if (tuning_profile_restore(&saved, len)) {
+        log_profile();
+    } else {
+        ESP_LOGW(TAG, "Saved tuning profile not recognized, keeping balanced");
+    }
+}
+
+esp_err_t tuning_init(void)
+{
+    const struct tuning_profile_config config = {
+        .presets = {
+            [mouthware_message_RelayProfile_RELAY_PROFILE_LOW_LATENCY - 1] = {
+                [KNOB(ACTIVE_INTERVAL)] = 6,
+                [KNOB(IDLE_INTERVAL)] = 6,
+                [KNOB(IDLE_LATENCY)] = 0,
+                [KNOB(TX_POWER_TARGET)] = TX_TARGET_DBM + 6,
+                [KNOB(STATUS_LIGHTS)] = 1,
+                [KNOB(CDC_COALESCE_US)] = 0,
+            },
+            [mouthware_message_RelayProfile_RELAY_PROFILE_BALANCED - 1] = {
+                [KNOB(ACTIVE_INTERVAL)] = 6,
+                [KNOB(IDLE_INTERVAL)] = CONFIG_MOUTHPAD_CONN_IDLE_INTERVAL,
+                [KNOB(IDLE_LATENCY)] = CONFIG_MOUTHPAD_CONN_IDLE_LATENCY,
+                [KNOB(TX_POWER_TARGET)] = TX_TARGET_DBM,
+                [KNOB(STATUS_LIGHTS)] = 1,
+                [KNOB(CDC_COALESCE_US)] = CONFIG_MOUTHPAD_CDC_TX_COALESCE_US,
+            },
+            [mouthware_message_RelayProfile_RELAY_PROFILE_BATTERY - 1] = {
+                [KNOB(ACTIVE_INTERVAL)] = 12,
+                [KNOB(IDLE_INTERVAL)] = CONFIG_MOUTHPAD_CONN_IDLE_INTERVAL,
+                [KNOB(IDLE_LATENCY)] = CONFIG_MOUTHPAD_CONN_DEEP_IDLE_LATENCY,
+                [KNOB(TX_POWER_TARGET)] = TX_TARGET_DBM - 6,
+                [KNOB(STATUS_LIGHTS)] = 0,
+                [KNOB(CDC_COALESCE_US)] = MAX(CONFIG_MOUTHPAD_CDC_TX_COALESCE_US, 1000),
+            },
+        },
+        .max_idle_sleep_ms = BLE_CONN_PARAMS_MAX_SLEEP_MS,
+        .applied = KNOB_BIT(ACTIVE_INTERVAL) | KNOB_BIT(IDLE_INTERVAL) | KNOB_BIT(IDLE_LATENCY) |
+                   TX_TARGET_APPLIED | KNOB_BIT(STATUS_LIGHTS) | KNOB_BIT(CDC_COALESCE_US),
+        .changed = tuning_changed,
+    };
+
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    tuning_profile_init(&config);
+    restore();
+    s_persist_id = persist_register(tuning_persist_flush);
+    return ESP_OK;
+}
+
+bool tuning_write(const mouthware_message_RelayProfileWrite *write)
+{
+    bool persist;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    bool accepted = tuning_profile_write(write, &persist);
+    xSemaphoreGive(s_mutex);
+
+    if (persist && s_persist_id >= 0) {
+        persist_request(s_persist_id);
+    }
+    if (accepted) {
+        log_profile();
+    } else {
+        ESP_LOGW(TAG, "Tuning profile write refused");
+    }
+    return accepted;
+}
+
+void tuning_cycle(void)
+{
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    tuning_profile_cycle();
+    xSemaphoreGive(s_mutex);
+
+    if (s_persist_id >= 0) {
+        persist_request(s_persist_id);
+    }
+    log_profile();
+
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_relay_profile_response_tag;
+    tuning_profile_get_status(&relay_msg.message_body.relay_profile_response);
+    relay_protocol_send_response(&relay_msg);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Runtime tuning profile (common/tuning_profile.h). The presets are built
+// from Kconfig: BALANCED is the build as configured, LOW_LATENCY keeps the
+// link at the minimum interval through idle, aims the TX power 6 dB higher
+// and flushes CDC0 at once, BATTERY doubles the active interval, sleeps at
+// the deep idle latency, aims 6 dB lower, coalesces CDC0 longer and darkens
+// the LED. The profile is kept in NVS and written by the persist task.
+
+// After persist_init(), activity_init() and leds_init(); restores the saved
+// profile
+esp_err_t tuning_init(void);
+
+// Apply a RelayProfileWrite; false if it was refused and nothing changed.
+// Safe from any task.
+bool tuning_write(const mouthware_message_RelayProfileWrite *write);
+
+// Move to the next preset and push a RelayProfileResponse to the host; safe
+// from any task
+void tuning_cycle(void);
+
+#ifdef __cplusplus
+}
+#endif
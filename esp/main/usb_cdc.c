@@ -4,44 +4,78 @@
 #include "esp_system.h"
 #include "esp_mac.h"
 #include "esp_chip_info.h"
+#include "tusb.h"
 #include "tusb_cdc_acm.h"
 // #include "tusb_console.h" // Not needed since we're not using CDC as console
 #include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/ringbuf.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 
 #include <ctype.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 
 #include "usb_dfu.h"
+#include "bench.h"
 #include "ble_bonds.h"
 #include "ble_hid.h"
 #include "ble_dis.h"
 #include "leds.h"
 #include "transport_hid.h"
+#include "tuning_profile.h"
+#include "usb_comp.h"
+#include "usb_hid.h"
 #include "esp_gap_ble_api.h"
 #include "relay_protocol.h"
+#include "task_stats.h"
+#include "trace_ring.h"
 #include "main.h"
+#include "heap_stats.h"
+#include "hid_idle.h"
+#include "mem_stats.h"
+#include "fw_update.h"
+#include "nus_stream.h"
+#include "sensor_codec.h"
+#include "sensor_stream.h"
+#include "tx_power.h"
+#include "link_guard.h"
+#include "link_history.h"
+#include "usb_phase.h"
+#include "ota_update.h"
+#include "pairing_timing.h"
+#include "connection_timing.h"
+#include "fault_inject.h"
+#include "mouthpad_crc16.h"
+#include "mouthpad_frame.h"
+#include "mouthpad_hid_reports.h"
+#include "mouthpad_pass_through.h"
+#include "relay_dispatch.h"
+#include "relay_time.h"
+#include "stall_watch.h"
+#include "sysview.h"
+#include "MouthpadRelay.pb.h"
+#include "pb_encode.h"
+#include "task_config.h"
+#include "power.h"
 
 static const char *TAG = "USB_CDC";
 
-#define CDC_PACKET_MAX_LEN 64
-#define CDC_PACKET_HEADER_LEN 4 // Start markers (2) + length (2)
-#define CDC_PACKET_CRC_LEN 2    // CRC-16 (2 bytes)
-#define CDC_PACKET_TOTAL_OVERHEAD (CDC_PACKET_HEADER_LEN + CDC_PACKET_CRC_LEN)
-
-// Packet framing constants
-#define CDC_PACKET_START_MARKER_1 0xAA
-#define CDC_PACKET_START_MARKER_2 0x55
-
 #define CDC_CMD_BUF_LEN 64
 
 static char s_bridge_cmd_buf[CDC_CMD_BUF_LEN];
 static size_t s_bridge_cmd_len;
+// Set by the first valid frame on CDC0 and cleared when the host closes
+// the port. CDC0 then only feeds the deframer, so a 0x0A inside a frame is
+// not taken for the end of a text line; text commands stay on CDC1.
+static bool s_bridge_binary;
 #if CONFIG_TINYUSB_CDC_COUNT > 1
 static char s_log_cmd_buf[CDC_CMD_BUF_LEN];
 static size_t s_log_cmd_len;
@@ -63,34 +97,60 @@ static usb_cdc_config_t s_cdc_config = {0};
 // CDC connection state per interface
 static bool s_cdc_connected[USB_CDC_PORT_COUNT];
 
+// False in the HID-only composition (usb_comp.h): CDC0 is not in the
+// configuration, so nothing may be queued or flushed on it
+static bool s_bridge_enumerated = true;
+
 #if CONFIG_TINYUSB_CDC_COUNT > 1
-static SemaphoreHandle_t s_log_mutex;
+// CDC1 log pipeline: ESP_LOGx callers format once into s_log_ring without
+// blocking; usb_cdc_log_task drains it to TinyUSB at low priority.
+static RingbufHandle_t s_log_ring;
+static atomic_uint s_log_dropped;
 static vprintf_like_t s_prev_vprintf;
 static int usb_cdc_log_vprintf(const char *fmt, va_list args);
+static void usb_cdc_log_enqueue(const char *data, size_t len);
+static void usb_cdc_log_task(void *arg);
 #endif
 
-// Packet parsing state
-typedef enum {
-  CDC_PARSER_STATE_IDLE,
-  CDC_PARSER_STATE_WAIT_MARKER_1,
-  CDC_PARSER_STATE_WAIT_MARKER_2,
-  CDC_PARSER_STATE_WAIT_LENGTH_HIGH,
-  CDC_PARSER_STATE_WAIT_LENGTH_LOW,
-  CDC_PARSER_STATE_WAIT_DATA,
-  CDC_PARSER_STATE_WAIT_CRC_HIGH,
-  CDC_PARSER_STATE_WAIT_CRC_LOW
-} cdc_parser_state_t;
-
-typedef struct {
-  cdc_parser_state_t state;
-  uint8_t packet_buffer[CDC_PACKET_MAX_LEN];
-  uint16_t packet_length;
-  uint16_t packet_received;
-  uint16_t expected_crc;
-  uint16_t calculated_crc;
-} cdc_parser_t;
-
-static cdc_parser_t s_parser = {0};
+// CDC0 framed writes: one assembly buffer, serialized by s_tx_mutex. Frames
+// are coalesced for up to the tuning profile's CDC_COALESCE_US (tuning.h,
+// CONFIG_MOUTHPAD_CDC_TX_COALESCE_US when balanced) before the partial USB
+// packet is flushed.
+#define CDC_TX_COALESCE_US                                                     \
+  ((uint32_t)tuning_profile_get(                                               \
+      mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_CDC_COALESCE_US))
+
+static SemaphoreHandle_t s_tx_mutex;
+static esp_timer_handle_t s_tx_flush_timer;
+static void tx_flush_timer_cb(void *arg);
+static uint8_t s_tx_frame[MOUTHPAD_FRAME_MAX_PAYLOAD + MOUTHPAD_FRAME_OVERHEAD];
+
+// Set while the host sends COBS frames (RELAY_FEATURE_COBS_FRAMING); they
+// are answered in kind, encoded from s_tx_frame into s_tx_cobs_frame
+static atomic_bool s_tx_cobs;
+static uint8_t s_tx_cobs_frame[MOUTHPAD_FRAME_COBS_SIZE(MOUTHPAD_FRAME_MAX_PAYLOAD)];
+
+// CDC0 frame deframer, fed from the TinyUSB RX callback
+static struct mouthpad_deframer s_deframer;
+
+// Same for the relay HID or WebUSB interface that replaces CDC1
+// (CONFIG_MOUTHPAD_RELAY_HID/_WEBUSB), fed from its TinyUSB callback in the
+// same task. Framed writes follow whichever interface the host last sent a
+// frame on.
+static struct mouthpad_deframer s_relay_deframer;
+static atomic_bool s_route_relay;
+
+// Deframed payloads wait here for the cdc_rx task, one item per frame with
+// a route byte in front, so decoding, protocol handlers and BLE writes
+// never hold up HID IN completions in the TinyUSB task.
+static RingbufHandle_t s_rx_frames;
+
+// Route byte: the frame came in on the relay interface, and was COBS
+#define RX_ROUTE_RELAY 0x01
+#define RX_ROUTE_COBS 0x02
+
+_Static_assert(MOUTHPAD_FRAME_MAX_PAYLOAD >= mouthware_message_AppToRelayMessage_size,
+               "Deframer cannot hold the largest AppToRelayMessage");
 
 static void reset_bridge_cmd_buffer(void) {
   s_bridge_cmd_len = 0;
@@ -104,37 +164,49 @@ static void reset_log_cmd_buffer(void) {
 }
 #endif
 
-static void reset_parser(void) {
-  s_parser.state = CDC_PARSER_STATE_IDLE;
-  s_parser.packet_length = 0;
-  s_parser.packet_received = 0;
-  s_parser.expected_crc = 0;
-  s_parser.calculated_crc = 0;
-  memset(s_parser.packet_buffer, 0, sizeof(s_parser.packet_buffer));
+// Deframer callback in the TinyUSB task: copy the frame out and return
+static void process_packet_data(const uint8_t *data, uint16_t len,
+                                void *user_data) {
+  uint8_t *item;
+
+  if (xRingbufferSendAcquire(s_rx_frames, (void **)&item, 1 + len, 0) !=
+      pdTRUE) {
+    ESP_LOGW(TAG, "CDC RX queue full, dropping %u byte frame", len);
+    trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_PROTOCOL);
+    return;
+  }
+  if (user_data == &s_deframer && !s_bridge_binary) {
+    s_bridge_binary = true;
+    reset_bridge_cmd_buffer();
+  }
+
+  item[0] = (user_data == &s_relay_deframer ? RX_ROUTE_RELAY : 0) |
+            (((struct mouthpad_deframer *)user_data)->cobs ? RX_ROUTE_COBS : 0);
+  memcpy(item + 1, data, len);
+  xRingbufferSendComplete(s_rx_frames, item);
 }
 
-uint16_t usb_cdc_calculate_crc16(const uint8_t *data, uint16_t len) {
-  uint16_t crc = 0xFFFF; // Initial value
+static void usb_cdc_rx_task(void *arg) {
+  (void)arg;
 
-  for (uint16_t i = 0; i < len; i++) {
-    crc ^= (uint16_t)data[i] << 8;
-    for (int j = 0; j < 8; j++) {
-      if (crc & 0x8000) {
-        crc = (crc << 1) ^ 0x1021; // CCITT polynomial
-      } else {
-        crc = crc << 1;
-      }
+  for (;;) {
+    size_t len;
+    uint8_t *item = xRingbufferReceive(s_rx_frames, &len, portMAX_DELAY);
+
+    if (item == NULL) {
+      continue;
     }
-  }
 
-  return crc & 0xFFFF;
-}
+    // Replies follow the interface and framing this frame came in with
+    atomic_store(&s_route_relay, (item[0] & RX_ROUTE_RELAY) != 0);
+    atomic_store(&s_tx_cobs, (item[0] & RX_ROUTE_COBS) != 0);
 
-static void process_packet_data(const uint8_t *data, uint16_t len) {
-  // Forward framed packet data to relay protocol for processing
-  esp_err_t ret = relay_protocol_handle_usb_data(data, len);
-  if (ret != ESP_OK) {
-    ESP_LOGW(TAG, "Failed to process USB data: %s", esp_err_to_name(ret));
+    // Forward framed packet data to relay protocol for processing
+    esp_err_t ret = relay_protocol_handle_usb_data(item + 1, len - 1);
+    vRingbufferReturnItem(s_rx_frames, item);
+    if (ret != ESP_OK) {
+      ESP_LOGW(TAG, "Failed to process USB data: %s", esp_err_to_name(ret));
+    }
   }
 }
 
@@ -166,6 +238,71 @@ static void process_bridge_line(void) {
 }
 
 #if CONFIG_TINYUSB_CDC_COUNT > 1
+// "bench hid <rate_hz> <seconds> [report_id]" or
+// "bench nus <bytes> <rate_hz> <seconds>"; results are logged when done
+static void process_bench_command(const char *args) {
+  bench_params_t params = {0};
+  unsigned long a = 0, b = 0, c = 0;
+  char kind[4] = {0};
+  int n = sscanf(args, "%3s %lu %lu %lu", kind, &a, &b, &c);
+
+  if (strcmp(kind, "hid") == 0 && n >= 3) {
+    params.kind = BENCH_HID;
+    params.rate_hz = a;
+    params.duration_ms = b * 1000;
+    params.report_id = n == 4 ? (uint8_t)c : MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION;
+  } else if (strcmp(kind, "nus") == 0 && n == 4) {
+    params.kind = BENCH_PASS_THROUGH;
+    params.size = (uint16_t)a;
+    params.rate_hz = b;
+    params.duration_ms = c * 1000;
+  } else {
+    ESP_LOGW(TAG, "Usage: bench hid <rate_hz> <seconds> [report_id]");
+    ESP_LOGW(TAG, "       bench nus <bytes> <rate_hz> <seconds>");
+    return;
+  }
+
+  esp_err_t ret = bench_start(&params);
+  if (ret == ESP_ERR_INVALID_STATE) {
+    ESP_LOGW(TAG, "Disconnect the MouthPad first, or wait for the running bench");
+  } else if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Bench not started: %s", esp_err_to_name(ret));
+  }
+}
+
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+// "fault [off | drop hid|nus <permille> | delay hid|nus <permille> <us> |
+// usbbusy <permille> | cdcstall <ms> | disconnect <phase> [count] | seed <n>]";
+// the settings and counts are logged after any change
+static void process_fault_command(char *args) {
+  char *argv[4];
+  size_t argc = 0;
+  char *save = NULL;
+  char line[96];
+
+  for (char *word = strtok_r(args, " ", &save); word != NULL;
+       word = strtok_r(NULL, " ", &save)) {
+    if (argc == sizeof(argv) / sizeof(argv[0])) {
+      argc++;
+      break;
+    }
+    argv[argc++] = word;
+  }
+
+  if (argc > sizeof(argv) / sizeof(argv[0]) ||
+      (argc > 0 && fault_inject_command(argc, argv) != 0)) {
+    ESP_LOGW(TAG, "Usage: fault [off | drop hid|nus <permille> |");
+    ESP_LOGW(TAG, "       delay hid|nus <permille> <us> | usbbusy <permille> |");
+    ESP_LOGW(TAG, "       cdcstall <ms> | disconnect <phase> [count] | seed <n>]");
+    return;
+  }
+
+  for (size_t i = 0; fault_inject_format(i, line, sizeof(line)) > 0; i++) {
+    ESP_LOGI(TAG, "Fault %s", line);
+  }
+}
+#endif
+
 static void process_log_line(void) {
   size_t start = 0;
   size_t end = s_log_cmd_len;
@@ -245,6 +382,192 @@ static void process_log_line(void) {
     ESP_LOGI(TAG, "ESP-IDF: %s", IDF_VER);
     ESP_LOGI(TAG, "Chip: %s rev%d, %d CPU core(s)",
              CONFIG_IDF_TARGET, chip_info.revision, chip_info.cores);
+  } else if ((end - start) == 3 && strncmp(&s_log_cmd_buf[start], "mem", 3) == 0) {
+    ESP_LOGI(TAG, "=== Heap ===");
+    ESP_LOGI(TAG, "Internal: %u free, %u minimum, %u largest block",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+    ESP_LOGI(TAG, "All: %u free, %u minimum",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_DEFAULT),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT));
+
+    static struct mem_stats_report report;
+    char line[80];
+
+    heap_stats_read(&report);
+    for (size_t i = 0; mem_stats_format(&report, i, line, sizeof(line)) > 0; i++) {
+      ESP_LOGI(TAG, "  %s", line);
+    }
+  } else if ((end - start) == 9 && strncmp(&s_log_cmd_buf[start], "mem reset", 9) == 0) {
+    heap_stats_reset();
+    ESP_LOGI(TAG, "Pool peaks and site counters reset");
+  } else if ((end - start) == 8 && strncmp(&s_log_cmd_buf[start], "dispatch", 8) == 0) {
+    char line[128];
+    bool any = false;
+
+    ESP_LOGI(TAG, "=== Relay Message Handlers ===");
+    for (pb_size_t tag = 0; tag < RELAY_DISPATCH_TAG_COUNT; tag++) {
+      if (relay_dispatch_format(tag, line, sizeof(line)) > 0) {
+        ESP_LOGI(TAG, "  %s", line);
+        any = true;
+      }
+    }
+    if (!any) {
+      ESP_LOGI(TAG, "  No messages handled");
+    }
+  } else if ((end - start) == 5 && strncmp(&s_log_cmd_buf[start], "stall", 5) == 0) {
+#if CONFIG_MOUTHPAD_STALL_WATCH
+    char line[80];
+
+    ESP_LOGI(TAG, "=== Stalls ===");
+    for (size_t i = 0; stall_watch_format(i, line, sizeof(line)) > 0; i++) {
+      ESP_LOGI(TAG, "  %s", line);
+    }
+#else
+    ESP_LOGW(TAG, "Stall watch not enabled (CONFIG_MOUTHPAD_STALL_WATCH)");
+#endif
+  } else if ((end - start) == 11 && strncmp(&s_log_cmd_buf[start], "stall clear", 11) == 0) {
+    stall_watch_clear();
+    ESP_LOGI(TAG, "Stall counters and snapshot cleared");
+  } else if ((end - start) == 3 && strncmp(&s_log_cmd_buf[start], "top", 3) == 0) {
+    static struct thread_stats_report report;
+    char line[80];
+    esp_err_t ret = task_stats_read(&report);
+
+    if (ret != ESP_OK) {
+      ESP_LOGW(TAG, "Task stats not available: %s", esp_err_to_name(ret));
+    } else {
+      ESP_LOGI(TAG, "=== Tasks over the last %u ms (CPU per core) ===", (unsigned)report.window_ms);
+      ESP_LOGI(TAG, "  %s", thread_stats_header());
+      for (size_t i = 0; i < report.count; i++) {
+        thread_stats_format(&report.rows[i], line, sizeof(line));
+        ESP_LOGI(TAG, "  %s", line);
+      }
+    }
+  } else if ((end - start) == 8 && strncmp(&s_log_cmd_buf[start], "fwupdate", 8) == 0) {
+    char line[96];
+
+    if (!ota_update_available()) {
+      ESP_LOGI(TAG, "Firmware update needs a partition table with OTA slots (make OTA=1)");
+    } else {
+      fw_update_format(line, sizeof(line));
+      ESP_LOGI(TAG, "%s", line);
+    }
+  } else if ((end - start) == 9 && strncmp(&s_log_cmd_buf[start], "nusstream", 9) == 0) {
+    char line[128];
+
+    nus_stream_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+  } else if ((end - start) == 7 && strncmp(&s_log_cmd_buf[start], "streams", 7) == 0) {
+    char line[160];
+
+    sensor_stream_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+    sensor_stream_rate_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+    sensor_stream_sequence_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+    sensor_codec_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+    ESP_LOGI(TAG, "NUS RX queue: %u bytes waiting, %lu dropped full",
+             (unsigned)relay_protocol_nus_rx_queued(),
+             (unsigned long)relay_protocol_nus_rx_queue_full());
+  } else if ((end - start) == 7 && strncmp(&s_log_cmd_buf[start], "txpower", 7) == 0) {
+#if CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE
+    char line[128];
+
+    tx_power_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+#else
+    ESP_LOGI(TAG, "TX power is fixed (CONFIG_MOUTHPAD_TX_POWER_ADAPTIVE off)");
+#endif
+  } else if ((end - start) == 7 && strncmp(&s_log_cmd_buf[start], "profile", 7) == 0) {
+    char line[160];
+
+    tuning_profile_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+  } else if ((end - start) == 7 && strncmp(&s_log_cmd_buf[start], "usbcomp", 7) == 0) {
+    char line[64];
+
+    usb_comp_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+  } else if ((end - start) == 7 && strncmp(&s_log_cmd_buf[start], "hididle", 7) == 0) {
+    char line[128];
+
+    hid_idle_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+  } else if ((end - start) == 8 && strncmp(&s_log_cmd_buf[start], "usbphase", 8) == 0) {
+#if CONFIG_MOUTHPAD_USB_SOF_PHASE
+    char line[128];
+
+    usb_phase_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+#else
+    ESP_LOGI(TAG, "USB phase is not measured (CONFIG_MOUTHPAD_USB_SOF_PHASE off)");
+#endif
+  } else if ((end - start) == 5 && strncmp(&s_log_cmd_buf[start], "clock", 5) == 0) {
+    char line[80];
+
+    time_base_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s (time base %u Hz)", line, (unsigned int)RELAY_TIME_HZ);
+  } else if ((end - start) == 7 && strncmp(&s_log_cmd_buf[start], "pairing", 7) == 0) {
+    struct pairing_timing_record records[PAIRING_TIMING_RECORDS];
+    char line[128];
+    size_t count = pairing_timing_get(records);
+
+    ESP_LOGI(TAG, "=== Pairing timing (ms after link up) ===");
+    if (count == 0) {
+      ESP_LOGI(TAG, "  No links recorded");
+    }
+    for (size_t i = 0; i < count; i++) {
+      pairing_timing_format(&records[i], line, sizeof(line));
+      ESP_LOGI(TAG, "  %s", line);
+    }
+  } else if ((end - start) == 4 && strncmp(&s_log_cmd_buf[start], "boot", 4) == 0) {
+    char line[128];
+
+    connection_timing_format_boot(line, sizeof(line));
+    ESP_LOGI(TAG, "Boot timing (ms): %s", line);
+  } else if ((end - start) == 5 && strncmp(&s_log_cmd_buf[start], "guard", 5) == 0) {
+#if CONFIG_MOUTHPAD_LINK_GUARD
+    char line[128];
+
+    link_guard_format(line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+#else
+    ESP_LOGI(TAG, "Link guard is off (CONFIG_MOUTHPAD_LINK_GUARD off)");
+#endif
+  } else if ((end - start) == 5 && strncmp(&s_log_cmd_buf[start], "trace", 5) == 0) {
+    struct trace_record record;
+    char line[80];
+
+    ESP_LOGI(TAG, "=== Trace (boot #%u, oldest first) ===", (unsigned)trace_ring_boot_count());
+    for (size_t i = 0; trace_ring_get(i, &record); i++) {
+      trace_ring_format(&record, line, sizeof(line));
+      ESP_LOGI(TAG, "  %s", line);
+    }
+  } else if ((end - start) == 11 && strncmp(&s_log_cmd_buf[start], "trace clear", 11) == 0) {
+    trace_ring_clear();
+    ESP_LOGI(TAG, "Trace cleared");
+  } else if ((end - start) == 7 && strncmp(&s_log_cmd_buf[start], "history", 7) == 0) {
+#if CONFIG_MOUTHPAD_LINK_HISTORY
+    char line[200];
+
+    ESP_LOGI(TAG, "=== Link history (boot #%u) ===", (unsigned)trace_ring_boot_count());
+    for (size_t i = 0; link_history_format(i, line, sizeof(line)) > 0; i++) {
+      ESP_LOGI(TAG, "  %s", line);
+    }
+#else
+    ESP_LOGI(TAG, "Link history is off (CONFIG_MOUTHPAD_LINK_HISTORY off)");
+#endif
+  } else if ((end - start) == 13 && strncmp(&s_log_cmd_buf[start], "history clear", 13) == 0) {
+#if CONFIG_MOUTHPAD_LINK_HISTORY
+    link_history_clear();
+    ESP_LOGI(TAG, "Link history cleared");
+#else
+    ESP_LOGI(TAG, "Link history is off (CONFIG_MOUTHPAD_LINK_HISTORY off)");
+#endif
   } else if ((end - start) == 6 && strncmp(&s_log_cmd_buf[start], "device", 6) == 0) {
     const ble_device_info_t *device_info = ble_device_info_get_current();
     if (device_info && device_info->info_complete) {
@@ -294,14 +617,24 @@ static void process_log_line(void) {
         }
         len += snprintf(info_buf + len, sizeof(info_buf) - len, "==========================\r\n");
 
-        // Write directly to CDC bypassing logging system to prevent interleaving
+        // Queue as one block so log lines cannot interleave with it
         if (s_cdc_connected[USB_CDC_PORT_LOG]) {
-            tinyusb_cdcacm_write_queue(USB_CDC_PORT_LOG, (const uint8_t *)info_buf, len);
-            tinyusb_cdcacm_write_flush(USB_CDC_PORT_LOG, 0);
+            usb_cdc_log_enqueue(info_buf, MIN((size_t)len, sizeof(info_buf) - 1));
         }
     } else {
         ESP_LOGI(TAG, "No device info available - device may not be connected or DIS not yet discovered");
     }
+  } else if ((end - start) > 6 && strncmp(&s_log_cmd_buf[start], "bench ", 6) == 0) {
+    s_log_cmd_buf[end] = '\0';
+    process_bench_command(&s_log_cmd_buf[start + 6]);
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+  } else if ((end - start) == 5 && strncmp(&s_log_cmd_buf[start], "fault", 5) == 0) {
+    s_log_cmd_buf[end] = '\0';
+    process_fault_command(&s_log_cmd_buf[start + 5]);
+  } else if ((end - start) > 6 && strncmp(&s_log_cmd_buf[start], "fault ", 6) == 0) {
+    s_log_cmd_buf[end] = '\0';
+    process_fault_command(&s_log_cmd_buf[start + 6]);
+#endif
   } else {
     ESP_LOGW(TAG, "Ignoring command on CDC1: %.*s", (int)(end - start),
              &s_log_cmd_buf[start]);
@@ -311,76 +644,15 @@ static void process_log_line(void) {
 }
 #endif
 
-static void parse_packet_byte(uint8_t byte) {
-  switch (s_parser.state) {
-  case CDC_PARSER_STATE_IDLE:
-    if (byte == CDC_PACKET_START_MARKER_1) {
-      s_parser.state = CDC_PARSER_STATE_WAIT_MARKER_2;
-    }
-    break;
-
-  case CDC_PARSER_STATE_WAIT_MARKER_2:
-    if (byte == CDC_PACKET_START_MARKER_2) {
-      s_parser.state = CDC_PARSER_STATE_WAIT_LENGTH_HIGH;
-    } else {
-      reset_parser();
-    }
-    break;
-
-  case CDC_PARSER_STATE_WAIT_LENGTH_HIGH:
-    s_parser.packet_length = (uint16_t)byte << 8;
-    s_parser.state = CDC_PARSER_STATE_WAIT_LENGTH_LOW;
-    break;
-
-  case CDC_PARSER_STATE_WAIT_LENGTH_LOW:
-    s_parser.packet_length |= byte;
-    if (s_parser.packet_length > CDC_PACKET_MAX_LEN) {
-      ESP_LOGW(TAG, "Packet length %d exceeds maximum %d",
-               s_parser.packet_length, CDC_PACKET_MAX_LEN);
-      reset_parser();
-    } else {
-      s_parser.packet_received = 0;
-      s_parser.state = CDC_PARSER_STATE_WAIT_DATA;
-    }
-    break;
-
-  case CDC_PARSER_STATE_WAIT_DATA:
-    if (s_parser.packet_received < s_parser.packet_length) {
-      s_parser.packet_buffer[s_parser.packet_received] = byte;
-      s_parser.packet_received++;
-    }
-
-    if (s_parser.packet_received >= s_parser.packet_length) {
-      s_parser.state = CDC_PARSER_STATE_WAIT_CRC_HIGH;
-    }
-    break;
-
-  case CDC_PARSER_STATE_WAIT_CRC_HIGH:
-    s_parser.expected_crc = (uint16_t)byte << 8;
-    s_parser.state = CDC_PARSER_STATE_WAIT_CRC_LOW;
-    break;
-
-  case CDC_PARSER_STATE_WAIT_CRC_LOW:
-    s_parser.expected_crc |= byte;
-
-    // Calculate CRC for received data
-    s_parser.calculated_crc =
-        usb_cdc_calculate_crc16(s_parser.packet_buffer, s_parser.packet_length);
+static void handle_frame_error(enum mouthpad_deframer_error err,
+                               uint16_t value, void *user_data) {
+  (void)user_data;
 
-    if (s_parser.calculated_crc == s_parser.expected_crc) {
-      // Valid packet received
-      process_packet_data(s_parser.packet_buffer, s_parser.packet_length);
-    } else {
-      ESP_LOGW(TAG, "CRC mismatch: expected 0x%04X, calculated 0x%04X",
-               s_parser.expected_crc, s_parser.calculated_crc);
-    }
-
-    reset_parser();
-    break;
-
-  default:
-    reset_parser();
-    break;
+  if (err == MOUTHPAD_DEFRAMER_ERR_LENGTH) {
+    ESP_LOGW(TAG, "Packet length %u exceeds maximum %d", value,
+             MOUTHPAD_FRAME_MAX_PAYLOAD);
+  } else {
+    ESP_LOGW(TAG, "CRC mismatch: received 0x%04X", value);
   }
 }
 
@@ -398,6 +670,10 @@ static void handle_cdc_line_state_changed(int itf, cdcacm_event_t *event) {
   bool rts = event->line_state_changed_data.rts;
 
   s_cdc_connected[itf] = dtr && rts;
+  if (itf == USB_CDC_PORT_BRIDGE && !dtr) {
+    s_bridge_binary = false;
+    reset_bridge_cmd_buffer();
+  }
 
   ESP_LOGI(TAG, "CDC%d line state changed: DTR=%d, RTS=%d, connected=%d", itf,
            dtr, rts, s_cdc_connected[itf]);
@@ -485,15 +761,18 @@ static void handle_cdc_rx(int itf, cdcacm_event_t *event) {
     return;
   }
 
-  uint8_t buf[32];
+  uint8_t buf[64]; // One full-speed bulk packet
   size_t rx = 0;
 
+  power_cdc_activity();
+
   while (tinyusb_cdcacm_read(itf, buf, sizeof(buf), &rx) == ESP_OK && rx > 0) {
-    for (size_t i = 0; i < rx; ++i) {
-      uint8_t byte = buf[i];
-      char ch = (char)byte;
+    sysview_mark_start(RELAY_MARKER_DEFRAME);
+    mouthpad_deframer_feed(&s_deframer, buf, rx);
+    sysview_mark_stop(RELAY_MARKER_DEFRAME);
 
-      parse_packet_byte(byte);
+    for (size_t i = 0; i < rx && !s_bridge_binary; ++i) {
+      char ch = (char)buf[i];
 
       if (ch == '\r') {
         continue;
@@ -530,13 +809,43 @@ esp_err_t usb_cdc_init(const usb_cdc_config_t *config) {
   // Store configuration
   memcpy(&s_cdc_config, config, sizeof(usb_cdc_config_t));
 
-  // Initialize parser and connection bookkeeping
-  reset_parser();
+  // Initialize deframer and connection bookkeeping
+  mouthpad_deframer_init(&s_deframer, process_packet_data, handle_frame_error,
+                         &s_deframer);
+  mouthpad_deframer_init(&s_relay_deframer, process_packet_data,
+                         handle_frame_error, &s_relay_deframer);
   reset_bridge_cmd_buffer();
 #if CONFIG_TINYUSB_CDC_COUNT > 1
   reset_log_cmd_buffer();
 #endif
   memset(s_cdc_connected, 0, sizeof(s_cdc_connected));
+  s_bridge_enumerated = usb_comp_active() !=
+                        mouthware_message_UsbComposition_USB_COMPOSITION_HID_ONLY;
+
+  if (s_tx_mutex == NULL) {
+    s_tx_mutex = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(s_tx_mutex != NULL, ESP_ERR_NO_MEM, TAG,
+                        "Failed to create CDC TX mutex");
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = tx_flush_timer_cb,
+        .name = "cdc_tx_flush",
+    };
+    ESP_RETURN_ON_ERROR(esp_timer_create(&timer_args, &s_tx_flush_timer), TAG,
+                        "Failed to create CDC TX flush timer");
+  }
+
+  if (s_rx_frames == NULL) {
+    s_rx_frames = xRingbufferCreate(CONFIG_MOUTHPAD_CDC_RX_QUEUE_SIZE,
+                                    RINGBUF_TYPE_NOSPLIT);
+    ESP_RETURN_ON_FALSE(s_rx_frames != NULL, ESP_ERR_NO_MEM, TAG,
+                        "Failed to create CDC RX queue");
+    ESP_RETURN_ON_FALSE(xTaskCreatePinnedToCore(usb_cdc_rx_task, "cdc_rx",
+                                                TASK_CDC_RX_STACK_SIZE, NULL,
+                                                TASK_CDC_RX_PRIORITY, NULL,
+                                                TASK_CDC_RX_CORE_ID) == pdPASS,
+                        ESP_ERR_NO_MEM, TAG, "Failed to create CDC RX task");
+  }
 
   ESP_LOGI(TAG, "Initializing %d CDC ports...", USB_CDC_PORT_COUNT);
 
@@ -581,10 +890,16 @@ esp_err_t usb_cdc_init(const usb_cdc_config_t *config) {
 #endif
 
 #if CONFIG_TINYUSB_CDC_COUNT > 1
-  if (s_log_mutex == NULL) {
-    s_log_mutex = xSemaphoreCreateMutex();
-    ESP_RETURN_ON_FALSE(s_log_mutex != NULL, ESP_ERR_NO_MEM, TAG,
-                        "Failed to create CDC log mutex");
+  if (s_log_ring == NULL) {
+    s_log_ring = xRingbufferCreate(CONFIG_MOUTHPAD_CDC_LOG_RING_SIZE,
+                                   RINGBUF_TYPE_BYTEBUF);
+    ESP_RETURN_ON_FALSE(s_log_ring != NULL, ESP_ERR_NO_MEM, TAG,
+                        "Failed to create CDC log ring");
+    ESP_RETURN_ON_FALSE(xTaskCreatePinnedToCore(usb_cdc_log_task, "cdc_log",
+                                                TASK_CDC_LOG_STACK_SIZE, NULL,
+                                                TASK_CDC_LOG_PRIORITY, NULL,
+                                                TASK_CDC_LOG_CORE_ID) == pdPASS,
+                        ESP_ERR_NO_MEM, TAG, "Failed to create CDC log task");
     s_prev_vprintf = esp_log_set_vprintf(usb_cdc_log_vprintf);
     ESP_LOGI(TAG, "CDC%d configured for logging output", USB_CDC_PORT_LOG);
   }
@@ -594,48 +909,283 @@ esp_err_t usb_cdc_init(const usb_cdc_config_t *config) {
   return ESP_OK;
 }
 
-esp_err_t usb_cdc_send_data(const uint8_t *data, uint16_t len) {
+void usb_cdc_relay_received(const uint8_t *data, size_t len) {
+  if (usb_dfu_pending()) {
+    return;
+  }
+
+  power_cdc_activity();
+  sysview_mark_start(RELAY_MARKER_DEFRAME);
+  mouthpad_deframer_feed(&s_relay_deframer, data, len);
+  sysview_mark_stop(RELAY_MARKER_DEFRAME);
+}
+
+// Whether framed writes go to the relay interface rather than CDC0
+static bool tx_route_relay(void) {
+#if CONFIG_MOUTHPAD_RELAY_HID || CONFIG_MOUTHPAD_RELAY_WEBUSB
+  return atomic_load(&s_route_relay) && usb_hid_mounted();
+#else
+  return false;
+#endif
+}
+
+// Queue bytes on the chosen interface; s_tx_mutex must be held
+static size_t tx_queue_locked(bool relay, const uint8_t *data, size_t len) {
+  if (relay) {
+    return usb_hid_relay_write(data, len);
+  }
+  return tinyusb_cdcacm_write_queue(USB_CDC_PORT_BRIDGE, data, len);
+}
+
+static void tx_flush_timer_cb(void *arg) {
+  (void)arg;
+
+  xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+  if (s_bridge_enumerated) {
+    tinyusb_cdcacm_write_flush(USB_CDC_PORT_BRIDGE, 0);
+  }
+  xSemaphoreGive(s_tx_mutex);
+}
+
+// Flush now or arm the coalescing timer; s_tx_mutex must be held.
+// TinyUSB sends each full bulk packet as soon as it is queued; only a
+// partial packet waits for the flush, so later frames can fill it.
+static void tx_flush_locked(bool flush) {
+  uint32_t coalesce_us = CDC_TX_COALESCE_US;
+
+  if (flush || coalesce_us == 0) {
+    esp_timer_stop(s_tx_flush_timer);
+    tinyusb_cdcacm_write_flush(USB_CDC_PORT_BRIDGE, 0);
+  } else if (!esp_timer_is_active(s_tx_flush_timer)) {
+    esp_timer_start_once(s_tx_flush_timer, coalesce_us);
+  }
+}
+
+// A CDC0 stall injected from the console refuses whole frames, as a full
+// FIFO would
+static bool tx_fault_stalled(void) {
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+  return fault_inject_cdc_stalled();
+#else
+  return false;
+#endif
+}
+
+static esp_err_t tx_frame_done(size_t queued, size_t frame_len,
+                               enum mem_site site) {
+  esp_err_t ret = ESP_OK;
+
+  mem_stats_take(site, queued == frame_len, usb_cdc_tx_queued());
+  if (queued != frame_len) {
+    ESP_LOGW(TAG, "CDC0 TX FIFO full, queued %d of %d bytes", (int)queued,
+             (int)frame_len);
+    trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_CDC_TX);
+    ret = ESP_ERR_NO_MEM;
+  }
+
+  if (s_cdc_config.data_sent_cb) {
+    s_cdc_config.data_sent_cb(ret);
+  }
+
+  return ret;
+}
+
+esp_err_t usb_cdc_send_frame(const uint8_t *data, uint16_t len, bool flush) {
   if (data == NULL || len == 0) {
     ESP_LOGE(TAG, "Invalid data or length");
     return ESP_ERR_INVALID_ARG;
   }
 
-  // No length limit needed with proper packet framing
-  // The framing protocol handles variable-length packets
+  if (s_tx_mutex == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
 
   ESP_LOGD(TAG, "Sending %d bytes with packet framing", len);
 
   // Calculate CRC-16 for the payload
-  uint16_t crc = usb_cdc_calculate_crc16(data, len);
+  uint16_t crc = mouthpad_crc16(data, len);
+  uint8_t header[MOUTHPAD_FRAME_HEADER_SIZE] = {
+      MOUTHPAD_FRAME_MAGIC1, MOUTHPAD_FRAME_MAGIC2, (len >> 8) & 0xFF,
+      len & 0xFF};
+  uint8_t crc_bytes[MOUTHPAD_FRAME_CRC_SIZE] = {(crc >> 8) & 0xFF, crc & 0xFF};
+  size_t frame_len = len + MOUTHPAD_FRAME_OVERHEAD;
+  size_t queued;
 
-  // Send dual start markers
-  tinyusb_cdcacm_write_queue(USB_CDC_PORT_BRIDGE,
-                             (uint8_t[]){CDC_PACKET_START_MARKER_1}, 1);
-  tinyusb_cdcacm_write_queue(USB_CDC_PORT_BRIDGE,
-                             (uint8_t[]){CDC_PACKET_START_MARKER_2}, 1);
+  xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
 
-  // Send packet length (2 bytes, big-endian)
-  uint8_t length_bytes[2] = {(len >> 8) & 0xFF, len & 0xFF};
-  tinyusb_cdcacm_write_queue(USB_CDC_PORT_BRIDGE, length_bytes, 2);
+  bool relay = tx_route_relay();
 
-  // Send packet data
-  tinyusb_cdcacm_write_queue(USB_CDC_PORT_BRIDGE, data, len);
+  if (!relay && !s_bridge_enumerated) {
+    xSemaphoreGive(s_tx_mutex);
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  // Send CRC (2 bytes, big-endian)
-  uint8_t crc_bytes[2] = {(crc >> 8) & 0xFF, crc & 0xFF};
-  tinyusb_cdcacm_write_queue(USB_CDC_PORT_BRIDGE, crc_bytes, 2);
+  if (tx_fault_stalled()) {
+    xSemaphoreGive(s_tx_mutex);
+    return tx_frame_done(0, frame_len, MEM_SITE_CDC_MESSAGE);
+  }
 
-  // Flush the queue
-  tinyusb_cdcacm_write_flush(USB_CDC_PORT_BRIDGE, 0);
+  if (len <= MOUTHPAD_FRAME_MAX_PAYLOAD && atomic_load(&s_tx_cobs)) {
+    frame_len = mouthpad_frame_cobs(s_tx_cobs_frame, data, len);
+    queued = tx_queue_locked(relay, s_tx_cobs_frame, frame_len);
+  } else if (len <= MOUTHPAD_FRAME_MAX_PAYLOAD) {
+    // Assemble header + payload + CRC and queue the frame in one call
+    memcpy(s_tx_frame, header, sizeof(header));
+    memcpy(&s_tx_frame[MOUTHPAD_FRAME_HEADER_SIZE], data, len);
+    memcpy(&s_tx_frame[MOUTHPAD_FRAME_HEADER_SIZE + len], crc_bytes,
+           sizeof(crc_bytes));
+    queued = tx_queue_locked(relay, s_tx_frame, frame_len);
+  } else {
+    queued = tx_queue_locked(relay, header, sizeof(header));
+    queued += tx_queue_locked(relay, data, len);
+    queued += tx_queue_locked(relay, crc_bytes, sizeof(crc_bytes));
+  }
 
-  if (s_cdc_config.data_sent_cb) {
-    s_cdc_config.data_sent_cb(ESP_OK);
+  // The relay interface sends as soon as it can; there is nothing to hold
+  if (!relay) {
+    tx_flush_locked(flush);
   }
+  xSemaphoreGive(s_tx_mutex);
 
-  return ESP_OK;
+  return tx_frame_done(queued, frame_len, MEM_SITE_CDC_MESSAGE);
 }
 
-bool usb_cdc_is_ready(void) { return s_cdc_connected[USB_CDC_PORT_BRIDGE]; }
+// Frame the len payload bytes already in s_tx_frame behind the reserved
+// header and queue them; s_tx_mutex must be held and is released here.
+static esp_err_t tx_frame_queue_locked(size_t len, bool flush,
+                                       enum mem_site site) {
+  uint8_t *payload = &s_tx_frame[MOUTHPAD_FRAME_HEADER_SIZE];
+  const uint8_t *frame = s_tx_frame;
+  size_t frame_len;
+  bool relay = tx_route_relay();
+
+  if (!relay && !s_bridge_enumerated) {
+    xSemaphoreGive(s_tx_mutex);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (atomic_load(&s_tx_cobs)) {
+    frame = s_tx_cobs_frame;
+    frame_len = mouthpad_frame_cobs(s_tx_cobs_frame, payload, len);
+  } else {
+    uint16_t crc = mouthpad_crc16(payload, len);
+
+    frame_len = len + MOUTHPAD_FRAME_OVERHEAD;
+    s_tx_frame[0] = MOUTHPAD_FRAME_MAGIC1;
+    s_tx_frame[1] = MOUTHPAD_FRAME_MAGIC2;
+    s_tx_frame[2] = (len >> 8) & 0xFF;
+    s_tx_frame[3] = len & 0xFF;
+    payload[len] = (crc >> 8) & 0xFF;
+    payload[len + 1] = crc & 0xFF;
+  }
+
+  if (tx_fault_stalled()) {
+    xSemaphoreGive(s_tx_mutex);
+    return tx_frame_done(0, frame_len, site);
+  }
+
+  ESP_LOGD(TAG, "Sending %d byte message with packet framing", (int)len);
+
+  size_t queued = tx_queue_locked(relay, frame, frame_len);
+  if (!relay) {
+    tx_flush_locked(flush);
+  }
+  xSemaphoreGive(s_tx_mutex);
+
+  return tx_frame_done(queued, frame_len, site);
+}
+
+esp_err_t usb_cdc_send_message(const pb_msgdesc_t *fields, const void *message,
+                               bool flush) {
+  if (s_tx_mutex == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  uint8_t *payload = &s_tx_frame[MOUTHPAD_FRAME_HEADER_SIZE];
+
+  xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+
+  // nanopb is built with PB_BUFFER_ONLY, so its writes inline to memcpy
+  pb_ostream_t stream =
+      pb_ostream_from_buffer(payload, MOUTHPAD_FRAME_MAX_PAYLOAD);
+
+  // Encode behind the reserved header, then patch in the length
+  sysview_mark_start(RELAY_MARKER_PB_ENCODE);
+  bool encoded = pb_encode(&stream, fields, message);
+  sysview_mark_stop(RELAY_MARKER_PB_ENCODE);
+
+  if (!encoded) {
+    xSemaphoreGive(s_tx_mutex);
+    ESP_LOGE(TAG, "Failed to encode message: %s", PB_GET_ERROR(&stream));
+    return ESP_FAIL;
+  }
+
+  return tx_frame_queue_locked(stream.bytes_written, flush,
+                               MEM_SITE_CDC_MESSAGE);
+}
+
+esp_err_t usb_cdc_send_pass_through(const uint8_t *data, uint16_t len,
+                                    bool more_fragments, uint32_t fragment) {
+  if (s_tx_mutex == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  bool channel = relay_dispatch_channels() && !more_fragments && fragment == 0;
+  size_t overhead = channel ? MOUTHPAD_CHANNEL_HEADER_SIZE
+                            : MOUTHPAD_PASS_THROUGH_TO_APP_OVERHEAD;
+
+  if (len > MOUTHPAD_FRAME_MAX_PAYLOAD - overhead) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+
+  uint8_t *payload = &s_tx_frame[MOUTHPAD_FRAME_HEADER_SIZE];
+  size_t payload_len;
+
+  if (channel) {
+    payload_len = mouthpad_channel_header(payload, MOUTHPAD_CHANNEL_NUS, 0);
+    memcpy(&payload[payload_len], data, len);
+    payload_len += len;
+  } else {
+    payload_len = mouthpad_pass_through_to_app_encode(
+        payload, data, len, more_fragments, fragment, 0);
+  }
+
+  // Pass-through traffic may share USB packets
+  return tx_frame_queue_locked(payload_len, false, MEM_SITE_CDC_PASS_THROUGH);
+}
+
+esp_err_t usb_cdc_send_data(const uint8_t *data, uint16_t len) {
+  return usb_cdc_send_frame(data, len, false);
+}
+
+esp_err_t usb_cdc_flush(void) {
+  if (s_tx_mutex == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+  esp_timer_stop(s_tx_flush_timer);
+  esp_err_t ret = s_bridge_enumerated
+                      ? tinyusb_cdcacm_write_flush(USB_CDC_PORT_BRIDGE, 0)
+                      : ESP_ERR_INVALID_STATE;
+  xSemaphoreGive(s_tx_mutex);
+
+  return ret;
+}
+
+bool usb_cdc_is_ready(void) {
+  return s_cdc_connected[USB_CDC_PORT_BRIDGE] || tx_route_relay();
+}
+
+uint32_t usb_cdc_tx_queued(void) {
+  if (tx_route_relay()) {
+    return usb_hid_relay_tx_queued();
+  }
+  return CONFIG_TINYUSB_CDC_TX_BUFSIZE -
+         tud_cdc_n_write_available(USB_CDC_PORT_BRIDGE);
+}
 
 esp_err_t usb_cdc_update_callbacks(const usb_cdc_config_t *config) {
   if (!config) {
@@ -651,81 +1201,93 @@ esp_err_t usb_cdc_update_callbacks(const usb_cdc_config_t *config) {
 
 #if CONFIG_TINYUSB_CDC_COUNT > 1
 
-#define USB_CDC_LOG_STACK_BUFFER 256
+// Longest log line; longer ones are truncated rather than allocated
+#define USB_CDC_LOG_LINE_MAX 256
 
-static esp_err_t usb_cdc_log_write(const char *data, size_t len) {
-  if (!data || len == 0) {
-    return ESP_OK;
-  }
+// Bytes the drain task takes from the ring per TinyUSB write
+#define USB_CDC_LOG_DRAIN_CHUNK 512
 
-  if (!s_cdc_connected[USB_CDC_PORT_LOG]) {
-    return ESP_ERR_INVALID_STATE;
+// Drop a line, never block the logging task; reported by the drain task
+static void usb_cdc_log_enqueue(const char *data, size_t len) {
+  if (len > 0 && xRingbufferSend(s_log_ring, data, len, 0) != pdTRUE) {
+    atomic_fetch_add_explicit(&s_log_dropped, 1, memory_order_relaxed);
   }
+}
 
-  size_t offset = 0;
-  while (offset < len) {
-    size_t chunk = len - offset;
-    const esp_err_t err = tinyusb_cdcacm_write_queue(
-        USB_CDC_PORT_LOG, (const uint8_t *)&data[offset], chunk);
-    if (err != ESP_OK) {
-      return err;
+// Queue to CDC1, flushing whenever TinyUSB's FIFO fills; drain task only.
+// Returns false if the host stopped reading.
+static bool usb_cdc_log_write(const char *data, size_t len) {
+  while (len > 0) {
+    size_t n = tinyusb_cdcacm_write_queue(USB_CDC_PORT_LOG,
+                                          (const uint8_t *)data, len);
+    data += n;
+    len -= n;
+
+    if (len > 0 && n == 0 &&
+        tinyusb_cdcacm_write_flush(USB_CDC_PORT_LOG, pdMS_TO_TICKS(50)) !=
+            ESP_OK) {
+      return false;
     }
-    offset += chunk;
   }
 
-  return tinyusb_cdcacm_write_flush(USB_CDC_PORT_LOG, 0);
+  return true;
 }
 
-static int usb_cdc_log_vprintf(const char *fmt, va_list args) {
-  if (!s_log_mutex) {
-    return s_prev_vprintf ? s_prev_vprintf(fmt, args) : vprintf(fmt, args);
-  }
-
-  int written_chars = 0;
-  bool handled = false;
-
-  if (xSemaphoreTake(s_log_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-    if (s_cdc_connected[USB_CDC_PORT_LOG]) {
-      va_list length_args;
-      va_copy(length_args, args);
-      int needed = vsnprintf(NULL, 0, fmt, length_args);
-      va_end(length_args);
+static void usb_cdc_log_task(void *arg) {
+  (void)arg;
 
-      if (needed >= 0) {
-        size_t buf_size = (size_t)needed + 1;
-        char stack_buf[USB_CDC_LOG_STACK_BUFFER];
-        char *buffer = stack_buf;
-
-        if (buf_size > sizeof(stack_buf)) {
-          buffer = (char *)malloc(buf_size);
-        }
+  while (true) {
+    size_t len;
+    char *data = xRingbufferReceiveUpTo(s_log_ring, &len, portMAX_DELAY,
+                                        USB_CDC_LOG_DRAIN_CHUNK);
+    if (!data) {
+      continue;
+    }
 
-        if (buffer) {
-          va_list copy_args;
-          va_copy(copy_args, args);
-          vsnprintf(buffer, buf_size, fmt, copy_args);
-          va_end(copy_args);
+    bool connected = s_cdc_connected[USB_CDC_PORT_LOG];
+    unsigned dropped = atomic_exchange(&s_log_dropped, 0);
 
-          if (usb_cdc_log_write(buffer, buf_size - 1) == ESP_OK) {
-            written_chars = needed;
-            handled = true;
-          }
+    if (connected && dropped) {
+      char note[40];
+      int n = snprintf(note, sizeof(note), "[%u log lines dropped]\n", dropped);
+      connected = usb_cdc_log_write(note, n);
+    }
 
-          if (buffer != stack_buf) {
-            free(buffer);
-          }
-        }
+    // Batch everything already buffered into one flush
+    do {
+      if (connected) {
+        connected = usb_cdc_log_write(data, len);
       }
+      vRingbufferReturnItem(s_log_ring, data);
+    } while ((data = xRingbufferReceiveUpTo(s_log_ring, &len, 0,
+                                            USB_CDC_LOG_DRAIN_CHUNK)) != NULL);
+
+    if (connected) {
+      tinyusb_cdcacm_write_flush(USB_CDC_PORT_LOG, 0);
     }
+  }
+}
+
+static int usb_cdc_log_vprintf(const char *fmt, va_list args) {
+  if (!s_log_ring || !s_cdc_connected[USB_CDC_PORT_LOG]) {
+    return s_prev_vprintf ? s_prev_vprintf(fmt, args) : vprintf(fmt, args);
+  }
 
-    xSemaphoreGive(s_log_mutex);
+  // One format pass on the caller's stack, then a non-blocking copy
+  char line[USB_CDC_LOG_LINE_MAX];
+  int needed = vsnprintf(line, sizeof(line), fmt, args);
+  if (needed < 0) {
+    return needed;
   }
 
-  if (handled) {
-    return written_chars;
+  size_t len = (size_t)needed;
+  if (len >= sizeof(line)) {
+    len = sizeof(line) - 1;
+    line[len - 1] = '\n';  // Keep the line break of a truncated line
   }
 
-  return s_prev_vprintf ? s_prev_vprintf(fmt, args) : vprintf(fmt, args);
+  usb_cdc_log_enqueue(line, len);
+  return needed;
 }
 
 #endif // CONFIG_TINYUSB_CDC_COUNT > 1
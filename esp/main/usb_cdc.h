@@ -3,6 +3,8 @@
 #include "esp_err.h"
 #include "stdint.h"
 #include "stdbool.h"
+#include "stddef.h"
+#include "pb.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,13 +30,72 @@ esp_err_t usb_cdc_init(const usb_cdc_config_t *config);
 
 /**
  * @brief Send data through USB CDC with packet framing
- * 
+ *
+ * Queues header, payload and CRC as one write. Unless flush is set, the
+ * last partial USB packet is held for CONFIG_MOUTHPAD_CDC_TX_COALESCE_US so
+ * further frames can share it.
+ *
+ * @param data Data to send
+ * @param len Length of data
+ * @param flush Send the partial USB packet now (latency-critical responses)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the TX FIFO was full
+ */
+esp_err_t usb_cdc_send_frame(const uint8_t *data, uint16_t len, bool flush);
+
+/**
+ * @brief Encode a protobuf message straight into a framed CDC write
+ *
+ * The message is encoded into the TX frame buffer behind a reserved header;
+ * the length is patched in and the CRC computed as bytes are written, so no
+ * intermediate encode buffer is needed.
+ *
+ * @param fields Message descriptor, e.g. mouthware_message_RelayToAppMessage_fields
+ * @param message Message to encode
+ * @param flush Same as for usb_cdc_send_frame()
+ * @return esp_err_t ESP_OK on success, ESP_FAIL if encoding failed
+ */
+esp_err_t usb_cdc_send_message(const pb_msgdesc_t *fields, const void *message,
+                               bool flush);
+
+/**
+ * @brief Send a PassThroughToApp message without going through nanopb
+ *
+ * Writes the fixed RelayToAppMessage tags and lengths and then the data
+ * straight into the TX frame (see mouthpad_pass_through.h); the bytes on
+ * the wire are the same as for usb_cdc_send_message(). While the host
+ * speaks channels (relay_dispatch_channels()), an unfragmented notification
+ * goes out behind a MOUTHPAD_CHANNEL_NUS header instead. Coalesced like
+ * usb_cdc_send_data().
+ *
+ * @param data NUS payload
+ * @param len Length of data, at most the PassThroughToApp data field size,
+ *            or MOUTHPAD_FRAME_MAX_PAYLOAD less the channel header on the
+ *            NUS channel
+ * @param more_fragments Further fragments of the same notification follow
+ * @param fragment Fragment number within the notification
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_SIZE if len is too long
+ */
+esp_err_t usb_cdc_send_pass_through(const uint8_t *data, uint16_t len,
+                                    bool more_fragments, uint32_t fragment);
+
+/**
+ * @brief Send data through USB CDC with packet framing, coalesced
+ *
+ * Same as usb_cdc_send_frame() without an immediate flush.
+ *
  * @param data Data to send
  * @param len Length of data
  * @return esp_err_t ESP_OK on success
  */
 esp_err_t usb_cdc_send_data(const uint8_t *data, uint16_t len);
 
+/**
+ * @brief Flush frames still held by the coalescing window
+ *
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t usb_cdc_flush(void);
+
 /**
  * @brief Check if USB CDC is ready for communication
  * 
@@ -42,6 +103,24 @@ esp_err_t usb_cdc_send_data(const uint8_t *data, uint16_t len);
  */
 bool usb_cdc_is_ready(void);
 
+/**
+ * @brief Bytes queued in the CDC0 TX FIFO and not yet taken by the host
+ */
+uint32_t usb_cdc_tx_queued(void);
+
+/**
+ * @brief Feed stream bytes from the relay HID or WebUSB interface
+ *
+ * Called from tud_hid_set_report_cb or tud_vendor_rx_cb in the TinyUSB
+ * task. Frames are deframed and handled exactly like CDC0 frames, and
+ * framed writes then go to the relay interface until the host sends a
+ * frame on CDC0 again.
+ *
+ * @param data Stream bytes, after the report's length byte for HID
+ * @param len Number of stream bytes
+ */
+void usb_cdc_relay_received(const uint8_t *data, size_t len);
+
 /**
  * @brief Update CDC callbacks after initialization
  * 
@@ -50,15 +129,6 @@ bool usb_cdc_is_ready(void);
  */
 esp_err_t usb_cdc_update_callbacks(const usb_cdc_config_t *config);
 
-/**
- * @brief Calculate CRC-16 (CCITT) for data integrity checking
- * 
- * @param data Data to calculate CRC for
- * @param len Length of data
- * @return uint16_t CRC-16 value
- */
-uint16_t usb_cdc_calculate_crc16(const uint8_t *data, uint16_t len);
-
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,170 @@
+#include "usb_comp.h"
+
+#include <stdio.h>
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+
+#include "relay_protocol.h"
+#include "usb_composition.h"
+
+static const char *TAG = "USB_COMP";
+
+#define NVS_NAMESPACE "usb"
+#define NVS_KEY_COMPOSITION "composition"
+
+#define COMPOSITION(name) mouthware_message_UsbComposition_USB_COMPOSITION_##name
+
+// Long enough for the response to leave over USB before the detach
+#define REENUMERATE_DELAY_US (200 * 1000)
+
+// Saved: enumerated from the next boot on. Active: installed at this one.
+static uint8_t s_saved = COMPOSITION(FULL);
+static uint8_t s_active = COMPOSITION(FULL);
+
+// Serializes the writers: host writes and the button
+static SemaphoreHandle_t s_mutex;
+static esp_timer_handle_t s_restart_timer;
+
+uint32_t usb_comp_load(void)
+{
+    nvs_handle_t nvs_handle;
+    uint8_t value;
+
+    s_mutex = xSemaphoreCreateMutex();
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) == ESP_OK) {
+        esp_err_t ret = nvs_get_u8(nvs_handle, NVS_KEY_COMPOSITION, &value);
+        nvs_close(nvs_handle);
+        if (ret == ESP_OK && usb_composition_valid(value)) {
+            s_saved = value;
+        } else if (ret == ESP_OK) {
+            ESP_LOGW(TAG, "Saved USB composition %u not recognized, keeping full", value);
+        } else if (ret != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Saved USB composition not read: %s", esp_err_to_name(ret));
+        }
+    }
+
+    s_active = s_saved;
+    ESP_LOGI(TAG, "USB composition: %s", usb_composition_name(s_active));
+    return s_active;
+}
+
+uint32_t usb_comp_active(void)
+{
+    return s_active;
+}
+
+static void restart_timer_cb(void *arg)
+{
+    (void)arg;
+
+    ESP_LOGI(TAG, "Re-enumerating as %s", usb_composition_name(s_saved));
+    esp_restart();
+}
+
+// Written at once, as a restart may follow; false if NVS refused it
+static bool save(uint8_t composition)
+{
+    nvs_handle_t nvs_handle;
+
+    if (composition == s_saved) {
+        return true;
+    }
+
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_u8(nvs_handle, NVS_KEY_COMPOSITION, composition);
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs_handle);
+        }
+        nvs_close(nvs_handle);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save the USB composition: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    s_saved = composition;
+    return true;
+}
+
+// Restart if the saved composition is not the active one; s_mutex held
+static bool reenumerate(void)
+{
+    if (s_saved == s_active) {
+        return false;
+    }
+
+    if (!s_restart_timer) {
+        const esp_timer_create_args_t args = {
+            .callback = restart_timer_cb,
+            .name = "usb_comp",
+        };
+        if (esp_timer_create(&args, &s_restart_timer) != ESP_OK) {
+            return false;
+        }
+    }
+    esp_timer_stop(s_restart_timer);
+    return esp_timer_start_once(s_restart_timer, REENUMERATE_DELAY_US) == ESP_OK;
+}
+
+static void get_status(mouthware_message_UsbCompositionResponse *response, bool reenumerating)
+{
+    *response = (mouthware_message_UsbCompositionResponse){
+        .composition = s_saved,
+        .active = s_active,
+        .reenumerating = reenumerating,
+    };
+    ESP_LOGI(TAG, "USB composition: %s saved, %s active", usb_composition_name(s_saved),
+             usb_composition_name(s_active));
+}
+
+bool usb_comp_write(const mouthware_message_UsbCompositionWrite *write,
+                    mouthware_message_UsbCompositionResponse *response)
+{
+    bool accepted = true;
+    bool reenumerating = false;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (write->composition != COMPOSITION(UNCHANGED)) {
+        accepted = usb_composition_valid(write->composition) &&
+                   save((uint8_t)write->composition);
+    }
+    if (accepted && write->reenumerate) {
+        reenumerating = reenumerate();
+    }
+    get_status(response, reenumerating);
+    xSemaphoreGive(s_mutex);
+
+    if (!accepted) {
+        ESP_LOGW(TAG, "USB composition write refused");
+    }
+    return accepted;
+}
+
+void usb_comp_cycle(void)
+{
+    mouthware_message_RelayToAppMessage relay_msg = mouthware_message_RelayToAppMessage_init_zero;
+    bool reenumerating = false;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (save((uint8_t)usb_composition_next(s_saved))) {
+        reenumerating = reenumerate();
+    }
+    relay_msg.which_message_body = mouthware_message_RelayToAppMessage_usb_composition_response_tag;
+    get_status(&relay_msg.message_body.usb_composition_response, reenumerating);
+    xSemaphoreGive(s_mutex);
+
+    relay_protocol_send_response(&relay_msg);
+}
+
+int usb_comp_format(char *buf, size_t len)
+{
+    return snprintf(buf, len, "usb: %s active, %s saved", usb_composition_name(s_active),
+                    usb_composition_name(s_saved));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// USB composition (common/usb_composition.h). Kept in NVS and read by
+// usb_hid_init() before TinyUSB is installed, which picks the configuration
+// descriptor from it. TinyUSB takes its descriptors once, so re-enumerating
+// with another composition takes a restart; the MouthPad reconnects as
+// after any reset.
+
+// Read the saved composition; once, before TinyUSB is installed. Returns
+// the composition to enumerate with, FULL if none was saved.
+uint32_t usb_comp_load(void);
+
+// The composition enumerated now
+uint32_t usb_comp_active(void);
+
+// Apply a UsbCompositionWrite and fill in the response; false if it was
+// refused and nothing changed. A write asking to re-enumerate restarts the
+// relay shortly after, when the saved composition differs from the active
+// one. Safe from any task.
+bool usb_comp_write(const mouthware_message_UsbCompositionWrite *write,
+                    mouthware_message_UsbCompositionResponse *response);
+
+// Save the next composition, push a UsbCompositionResponse to the host and
+// re-enumerate with it; safe from any task
+void usb_comp_cycle(void);
+
+// Saved and active composition as one console line; returns characters
+// written, as snprintf
+int usb_comp_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
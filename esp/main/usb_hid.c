@@ -4,53 +4,140 @@
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
 #include "tinyusb.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/param.h>
 
+#include "connection_timing.h"
+#include "fault_inject.h"
+#include "mouthpad_hid_reports.h"
+#include "mouthpad_relay_hid.h"
+#include "mouthpad_relay_webusb.h"
 #include "usb_cdc.h"
+#include "hid_idle.h"
+#include "hid_latency.h"
+#include "power.h"
+#include "probe.h"
 #include "relay_protocol.h"
+#include "task_config.h"
+#include "trace_ring.h"
+#include "transport_hid.h"
+#include "usb_comp.h"
+#include "usb_composition.h"
+#include "usb_phase.h"
 
 static const char *TAG = "USB_HID";
 
+// The ESP32-S3 has four IN endpoints besides EP0 and all are in use, so the
+// relay HID or WebUSB interface, or the split controls interface, takes the
+// place (and endpoints) of CDC1
+#if CONFIG_MOUTHPAD_RELAY_HID
+#if CONFIG_TINYUSB_CDC_COUNT > 1 || CONFIG_TINYUSB_HID_COUNT < 2
+#error "CONFIG_MOUTHPAD_RELAY_HID needs CDC_COUNT=1 and HID_COUNT=2 (sdkconfig.relay_hid)"
+#endif
+#endif
+#if CONFIG_MOUTHPAD_RELAY_WEBUSB
+#if CONFIG_TINYUSB_CDC_COUNT > 1 || CONFIG_TINYUSB_VENDOR_COUNT < 1
+#error "CONFIG_MOUTHPAD_RELAY_WEBUSB needs CDC_COUNT=1 and VENDOR_COUNT=1 (sdkconfig.relay_webusb)"
+#endif
+#endif
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+#if CONFIG_TINYUSB_CDC_COUNT > 1 || CONFIG_TINYUSB_HID_COUNT < 2
+#error "CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES needs CDC_COUNT=1 and HID_COUNT=2 (sdkconfig.hid_split)"
+#endif
+#endif
+#define RELAY_ITF (CONFIG_MOUTHPAD_RELAY_HID || CONFIG_MOUTHPAD_RELAY_WEBUSB)
+// The slot CDC1 would otherwise take
+#define SECOND_ITF (RELAY_ITF || CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES)
+
 #define CDC0_ITF_NUM_COMM 0
 #define CDC0_ITF_NUM_DATA 1
+#if SECOND_ITF
+// The mouse comes first so it stays TinyUSB HID instance 0
+#define HID_INTERFACE_NUMBER 2
+#define RELAY_INTERFACE_NUMBER 3
+#define CONTROLS_INTERFACE_NUMBER 3
+#define ITF_NUM_TOTAL 4
+#else
 #define CDC1_ITF_NUM_COMM 2
 #define CDC1_ITF_NUM_DATA 3
 #define HID_INTERFACE_NUMBER 4
-#define HID_INSTANCE 0
 #define ITF_NUM_TOTAL 5
+#endif
+#define HID_INSTANCE 0
+#define RELAY_HID_INSTANCE 1
+#define CONTROLS_HID_INSTANCE 1
 
 #define EPNUM_CDC0_NOTIF 0x81
 #define EPNUM_CDC0_OUT 0x02
 #define EPNUM_CDC0_IN 0x82
 #define EPNUM_CDC1_OUT 0x04
 #define EPNUM_CDC1_IN 0x83
+#define RELAY_EP_OUT 0x04
+#define RELAY_EP_IN 0x83
+#define CONTROLS_EP_IN 0x83
 #define HID_EP_IN 0x84
 
 #define HID_EP_SIZE 16
 #define HID_POLL_INTERVAL_MS 1
 
 #define CDC_DESC_LEN_NO_NOTIF (TUD_CDC_DESC_LEN - 7)
+#if CONFIG_MOUTHPAD_RELAY_HID
+#define SECOND_DESC_LEN TUD_HID_INOUT_DESC_LEN
+#elif CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+#define SECOND_DESC_LEN TUD_HID_DESC_LEN
+#elif CONFIG_MOUTHPAD_RELAY_WEBUSB
+#define SECOND_DESC_LEN TUD_VENDOR_DESC_LEN
+#else
+#define SECOND_DESC_LEN CDC_DESC_LEN_NO_NOTIF
+#endif
 #define CONFIG_TOTAL_LEN                                                       \
-  (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + CDC_DESC_LEN_NO_NOTIF +            \
+  (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + SECOND_DESC_LEN +                  \
    TUD_HID_DESC_LEN)
 
+// Same descriptor as the nRF dongle; see common/mouthpad_hid_reports.h
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES && CONFIG_MOUTHPAD_HID_COMBINED_MOUSE
+static const uint8_t mouthpad_report_desc[] = {
+    MOUTHPAD_HID_REPORT_DESC_POINTER_COMBINED};
+#elif CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+static const uint8_t mouthpad_report_desc[] = {
+    MOUTHPAD_HID_REPORT_DESC_POINTER};
+#elif CONFIG_MOUTHPAD_HID_COMBINED_MOUSE && CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS
 static const uint8_t mouthpad_report_desc[] = {
-    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x01, 0x09, 0x01, 0xA1, 0x00,
-    0x95, 0x05, 0x75, 0x01, 0x05, 0x09, 0x19, 0x01, 0x29, 0x05, 0x15, 0x00,
-    0x25, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x03, 0x81, 0x01, 0x75, 0x08,
-    0x95, 0x01, 0x05, 0x01, 0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x81, 0x06,
-    0x05, 0x0C, 0x0A, 0x38, 0x02, 0x95, 0x01, 0x81, 0x06, 0xC0, 0x85, 0x02,
-    0x09, 0x01, 0xA1, 0x00, 0x75, 0x0C, 0x95, 0x02, 0x05, 0x01, 0x09, 0x30,
-    0x09, 0x31, 0x16, 0x01, 0xF8, 0x26, 0xFF, 0x07, 0x81, 0x06, 0xC0, 0xC0,
-    0x05, 0x0C, 0x09, 0x01, 0xA1, 0x01, 0x85, 0x03, 0x15, 0x00, 0x25, 0x01,
-    0x75, 0x01, 0x95, 0x01, 0x09, 0xCD, 0x81, 0x06, 0x0A, 0x83, 0x01, 0x81,
-    0x06, 0x09, 0xB5, 0x81, 0x06, 0x09, 0xB6, 0x81, 0x06, 0x09, 0xEA, 0x81,
-    0x06, 0x09, 0xE9, 0x81, 0x06, 0x0A, 0x25, 0x02, 0x81, 0x06, 0x0A, 0x24,
-    0x02, 0x81, 0x06, 0xC0};
+    MOUTHPAD_HID_REPORT_DESC_COMBINED_OUTPUT};
+#elif CONFIG_MOUTHPAD_HID_COMBINED_MOUSE
+static const uint8_t mouthpad_report_desc[] = {
+    MOUTHPAD_HID_REPORT_DESC_COMBINED};
+#elif CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS
+static const uint8_t mouthpad_report_desc[] = {
+    MOUTHPAD_HID_REPORT_DESC_OUTPUT};
+#else
+static const uint8_t mouthpad_report_desc[] = {MOUTHPAD_HID_REPORT_DESC};
+#endif
+
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES && CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS
+static const uint8_t controls_report_desc[] = {
+    MOUTHPAD_HID_REPORT_DESC_CONTROLS_OUTPUT};
+#elif CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+static const uint8_t controls_report_desc[] = {
+    MOUTHPAD_HID_REPORT_DESC_CONTROLS};
+#endif
+
+// Host output reports arrive on the interface carrying the keyboard
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+#define OUTPUT_HID_INSTANCE CONTROLS_HID_INSTANCE
+#else
+#define OUTPUT_HID_INSTANCE HID_INSTANCE
+#endif
+
+#if CONFIG_MOUTHPAD_RELAY_HID
+static const uint8_t relay_report_desc[] = {MOUTHPAD_RELAY_HID_REPORT_DESC};
+#endif
 
 enum {
   STRID_LANGID = 0,
@@ -60,6 +147,8 @@ enum {
   STRID_CDC0,
   STRID_CDC1,
   STRID_HID,
+  STRID_RELAY,
+  STRID_CONTROLS,
 };
 
 static char serial_str[2 * 6 + 1];
@@ -70,7 +159,9 @@ static const char *string_desc[] = {
   serial_str,
   "MouthPad^NUS",
   "MouthPad^CDC",
-  "MouthPad^HID"
+  "MouthPad^HID",
+  "MouthPad^Relay",
+  "MouthPad^Controls"
 };
 
 #define TUD_CDC_DESCRIPTOR_NO_NOTIF(_itfnum, _stridx, _epout, _epin, _epsize)  \
@@ -95,10 +186,15 @@ static const char *string_desc[] = {
       0, /* Endpoint In */                                                     \
       7, TUSB_DESC_ENDPOINT, _epin, TUSB_XFER_BULK, U16_TO_U8S_LE(_epsize), 0
 
-static const tusb_desc_device_t mouthpad_device_descriptor = {
+// Adjusted in usb_hid_init() for the compositions without CDC1 or WebUSB
+static tusb_desc_device_t mouthpad_device_descriptor = {
     .bLength = sizeof(tusb_desc_device_t),
     .bDescriptorType = TUSB_DESC_DEVICE,
+#if CONFIG_MOUTHPAD_RELAY_WEBUSB
+    .bcdUSB = 0x0210, // Hosts only read the BOS descriptor from 2.01 on
+#else
     .bcdUSB = 0x0200,
+#endif
     .bDeviceClass = TUSB_CLASS_MISC,
     .bDeviceSubClass = MISC_SUBCLASS_COMMON,
     .bDeviceProtocol = MISC_PROTOCOL_IAD,
@@ -121,35 +217,234 @@ static const uint8_t mouthpad_configuration_descriptor[] = {
                           TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
     TUD_CDC_DESCRIPTOR(CDC0_ITF_NUM_COMM, STRID_CDC0, EPNUM_CDC0_NOTIF, 8,
                        EPNUM_CDC0_OUT, EPNUM_CDC0_IN, 64),
+#if CONFIG_MOUTHPAD_RELAY_HID
+    TUD_HID_DESCRIPTOR(HID_INTERFACE_NUMBER, STRID_HID, false,
+                       sizeof(mouthpad_report_desc), HID_EP_IN, HID_EP_SIZE,
+                       HID_POLL_INTERVAL_MS),
+    TUD_HID_INOUT_DESCRIPTOR(RELAY_INTERFACE_NUMBER, STRID_RELAY,
+                             HID_ITF_PROTOCOL_NONE, sizeof(relay_report_desc),
+                             RELAY_EP_OUT, RELAY_EP_IN,
+                             MOUTHPAD_RELAY_HID_REPORT_SIZE,
+                             MOUTHPAD_RELAY_HID_POLL_MS),
+#elif CONFIG_MOUTHPAD_RELAY_WEBUSB
+    TUD_HID_DESCRIPTOR(HID_INTERFACE_NUMBER, STRID_HID, false,
+                       sizeof(mouthpad_report_desc), HID_EP_IN, HID_EP_SIZE,
+                       HID_POLL_INTERVAL_MS),
+    TUD_VENDOR_DESCRIPTOR(RELAY_INTERFACE_NUMBER, STRID_RELAY, RELAY_EP_OUT,
+                          RELAY_EP_IN, MOUTHPAD_RELAY_WEBUSB_EP_SIZE),
+#elif CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+    TUD_HID_DESCRIPTOR(HID_INTERFACE_NUMBER, STRID_HID, false,
+                       sizeof(mouthpad_report_desc), HID_EP_IN, HID_EP_SIZE,
+                       HID_POLL_INTERVAL_MS),
+    TUD_HID_DESCRIPTOR(CONTROLS_INTERFACE_NUMBER, STRID_CONTROLS, false,
+                       sizeof(controls_report_desc), CONTROLS_EP_IN,
+                       HID_EP_SIZE, HID_POLL_INTERVAL_MS),
+#else
     TUD_CDC_DESCRIPTOR_NO_NOTIF(CDC1_ITF_NUM_COMM, STRID_CDC1, EPNUM_CDC1_OUT,
                                 EPNUM_CDC1_IN, 64),
     TUD_HID_DESCRIPTOR(HID_INTERFACE_NUMBER, STRID_HID, false,
                        sizeof(mouthpad_report_desc), HID_EP_IN, HID_EP_SIZE,
                        HID_POLL_INTERVAL_MS),
+#endif
 };
 
 _Static_assert(sizeof(mouthpad_configuration_descriptor) == CONFIG_TOTAL_LEN,
                "Descriptor length mismatch");
 
+// The reduced compositions (usb_comp.h) keep the HID interfaces, their
+// endpoints and their TinyUSB instances, and drop CDC1 or WebUSB, and for
+// HID only CDC0 as well
+#if CONFIG_MOUTHPAD_RELAY_HID || CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+#define HID_ITF_COUNT 2
+#define HID_ITFS_LEN (TUD_HID_DESC_LEN + SECOND_DESC_LEN)
+#else
+#define HID_ITF_COUNT 1
+#define HID_ITFS_LEN TUD_HID_DESC_LEN
+#endif
+
+#if CONFIG_MOUTHPAD_RELAY_HID
+#define HID_ITFS_DESCRIPTOR(_itfnum)                                           \
+  TUD_HID_DESCRIPTOR(_itfnum, STRID_HID, false, sizeof(mouthpad_report_desc),  \
+                     HID_EP_IN, HID_EP_SIZE, HID_POLL_INTERVAL_MS),            \
+      TUD_HID_INOUT_DESCRIPTOR((_itfnum) + 1, STRID_RELAY,                     \
+                               HID_ITF_PROTOCOL_NONE,                          \
+                               sizeof(relay_report_desc), RELAY_EP_OUT,        \
+                               RELAY_EP_IN, MOUTHPAD_RELAY_HID_REPORT_SIZE,    \
+                               MOUTHPAD_RELAY_HID_POLL_MS)
+#elif CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+#define HID_ITFS_DESCRIPTOR(_itfnum)                                           \
+  TUD_HID_DESCRIPTOR(_itfnum, STRID_HID, false, sizeof(mouthpad_report_desc),  \
+                     HID_EP_IN, HID_EP_SIZE, HID_POLL_INTERVAL_MS),            \
+      TUD_HID_DESCRIPTOR((_itfnum) + 1, STRID_CONTROLS, false,                 \
+                         sizeof(controls_report_desc), CONTROLS_EP_IN,         \
+                         HID_EP_SIZE, HID_POLL_INTERVAL_MS)
+#else
+#define HID_ITFS_DESCRIPTOR(_itfnum)                                           \
+  TUD_HID_DESCRIPTOR(_itfnum, STRID_HID, false, sizeof(mouthpad_report_desc),  \
+                     HID_EP_IN, HID_EP_SIZE, HID_POLL_INTERVAL_MS)
+#endif
+
+#define BRIDGE_TOTAL_LEN (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + HID_ITFS_LEN)
+#define HID_ONLY_TOTAL_LEN (TUD_CONFIG_DESC_LEN + HID_ITFS_LEN)
+
+static const uint8_t bridge_configuration_descriptor[] = {
+    TUD_CONFIG_DESCRIPTOR(1, 2 + HID_ITF_COUNT, 0, BRIDGE_TOTAL_LEN,
+                          TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+    TUD_CDC_DESCRIPTOR(CDC0_ITF_NUM_COMM, STRID_CDC0, EPNUM_CDC0_NOTIF, 8,
+                       EPNUM_CDC0_OUT, EPNUM_CDC0_IN, 64),
+    HID_ITFS_DESCRIPTOR(2),
+};
+
+_Static_assert(sizeof(bridge_configuration_descriptor) == BRIDGE_TOTAL_LEN,
+               "Bridge descriptor length mismatch");
+
+static const uint8_t hid_only_configuration_descriptor[] = {
+    TUD_CONFIG_DESCRIPTOR(1, HID_ITF_COUNT, 0, HID_ONLY_TOTAL_LEN,
+                          TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+    HID_ITFS_DESCRIPTOR(0),
+};
+
+_Static_assert(sizeof(hid_only_configuration_descriptor) == HID_ONLY_TOTAL_LEN,
+               "HID-only descriptor length mismatch");
+
+#if CONFIG_MOUTHPAD_RELAY_WEBUSB
+// WebUSB and MS OS 2.0 platform capabilities; see mouthpad_relay_webusb.h
+#define BOS_TOTAL_LEN                                                          \
+  (TUD_BOS_DESC_LEN + MOUTHPAD_RELAY_WEBUSB_BOS_WEBUSB_LEN +                   \
+   MOUTHPAD_RELAY_WEBUSB_BOS_MSOS2_LEN)
+
+static const uint8_t mouthpad_bos_descriptor[] = {
+    TUD_BOS_DESCRIPTOR(BOS_TOTAL_LEN, 2),
+    MOUTHPAD_RELAY_WEBUSB_BOS_WEBUSB,
+    MOUTHPAD_RELAY_WEBUSB_BOS_MSOS2,
+};
+
+_Static_assert(sizeof(mouthpad_bos_descriptor) == BOS_TOTAL_LEN,
+               "BOS descriptor length mismatch");
+
+static const uint8_t mouthpad_msos2_descriptor[] = {
+    MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC(RELAY_INTERFACE_NUMBER)};
+
+_Static_assert(sizeof(mouthpad_msos2_descriptor) ==
+                   MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC_LEN,
+               "MS OS 2.0 descriptor length mismatch");
+#endif
+
 static bool s_usb_ready;
 
+// Host suspend state, written from the TinyUSB task
+static atomic_bool s_usb_suspended;
+static atomic_bool s_wakeup_requested;
+static bool s_remote_wakeup_en;
+static usb_hid_suspend_cb_t s_suspend_cb;
+
+// Redundant reports are not forwarded and unchanged ones are repeated at
+// the idle rate the host set (see hid_idle.h). The hid_idle calls are
+// serialized here: the producer filters, and the drain owner, on whichever
+// context, takes the repeats. The timer only kicks the drain once the
+// next repeat is due, and is armed again from there.
+static portMUX_TYPE s_idle_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t s_idle_timer;
+static atomic_bool s_idle_bypass; // Set while the bench injects reports
+
+static void hid_tx_kick_all(void);
+static void relay_tx_kick(void);
+static void set_suspended(bool suspended);
+static void idle_reset(void);
+static void idle_timer_cb(void *arg);
+
 static void usb_event_cb(tinyusb_event_t *event, void *arg) {
   (void)arg;
   if (event->id == TINYUSB_EVENT_ATTACHED) {
+    // A new enumeration: the host sets its idle rates again
+    idle_reset();
     s_usb_ready = true;
+#if CONFIG_MOUTHPAD_USB_SOF_PHASE
+    tud_sof_cb_enable(true);
+#endif
+    power_usb_active(true);
+    set_suspended(false);
+    connection_timing_boot_mark(CONNECTION_TIMING_BOOT_USB_ENUMERATED);
     ESP_LOGI(TAG, "USB mounted");
   } else if (event->id == TINYUSB_EVENT_DETACHED) {
     s_usb_ready = false;
+    hid_tx_kick_all();
+    relay_tx_kick();
+    power_usb_active(false);
+    set_suspended(false);
     ESP_LOGI(TAG, "USB unmounted");
   }
 }
 
+static void set_suspended(bool suspended) {
+  if (atomic_exchange(&s_usb_suspended, suspended) == suspended) {
+    return;
+  }
+  ESP_LOGI(TAG, "USB %s", suspended ? "suspended" : "resumed");
+  trace_ring_record(TRACE_EVENT_USB_SUSPEND, suspended, 0);
+  if (s_suspend_cb) {
+    s_suspend_cb(suspended);
+  }
+}
+
+// While the host has the bus suspended the relay may light sleep; either
+// resume signalling or the next bus activity brings the clocks back
+void tud_suspend_cb(bool remote_wakeup_en) {
+  s_remote_wakeup_en = remote_wakeup_en;
+  atomic_store(&s_wakeup_requested, false);
+  power_usb_active(false);
+  set_suspended(true);
+}
+
+void tud_resume_cb(void) {
+  power_usb_active(true);
+  set_suspended(false);
+}
+
+void usb_hid_set_suspend_callback(usb_hid_suspend_cb_t cb) { s_suspend_cb = cb; }
+
+bool usb_hid_suspended(void) { return atomic_load(&s_usb_suspended); }
+
+esp_err_t usb_hid_remote_wakeup(void) {
+  if (!usb_hid_suspended()) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!s_remote_wakeup_en) {
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+  if (atomic_exchange(&s_wakeup_requested, true)) {
+    return ESP_OK; // Once per suspend
+  }
+  if (!tud_remote_wakeup()) {
+    ESP_LOGW(TAG, "USB remote wakeup failed");
+    return ESP_FAIL;
+  }
+  ESP_LOGI(TAG, "USB remote wakeup requested");
+  return ESP_OK;
+}
+
 void usb_hid_init(void) {
   uint8_t mac[6] = {0};
   ESP_ERROR_CHECK(esp_efuse_mac_get_default(mac));
   snprintf(serial_str, sizeof(serial_str), "%02X%02X%02X%02X%02X%02X", mac[0],
            mac[1], mac[2], mac[3], mac[4], mac[5]);
 
+  // Before TinyUSB takes the descriptors; only the full composition has the
+  // IAD pairs and the WebUSB BOS descriptor
+  uint32_t composition = usb_comp_load();
+  const uint8_t *config_desc = mouthpad_configuration_descriptor;
+
+  if (composition == mouthware_message_UsbComposition_USB_COMPOSITION_HID_BRIDGE) {
+    config_desc = bridge_configuration_descriptor;
+    mouthpad_device_descriptor.bcdUSB = 0x0200;
+  } else if (composition == mouthware_message_UsbComposition_USB_COMPOSITION_HID_ONLY) {
+    config_desc = hid_only_configuration_descriptor;
+    mouthpad_device_descriptor.bcdUSB = 0x0200;
+    mouthpad_device_descriptor.bDeviceClass = 0;
+    mouthpad_device_descriptor.bDeviceSubClass = 0;
+    mouthpad_device_descriptor.bDeviceProtocol = 0;
+  }
+
   const tinyusb_config_t tusb_cfg = {
       .port = TINYUSB_PORT_FULL_SPEED_0,
       .phy = {
@@ -158,22 +453,28 @@ void usb_hid_init(void) {
           .vbus_monitor_io = -1,
       },
       .task = {
-          .size = 4096,
-          .priority = 5,
-          .xCoreID = 0,
+          .size = TASK_TINYUSB_STACK_SIZE,
+          .priority = TASK_TINYUSB_PRIORITY,
+          .xCoreID = TASK_TINYUSB_CORE_ID,
       },
       .descriptor = {
           .device = &mouthpad_device_descriptor,
           .qualifier = NULL,
           .string = string_desc,
           .string_count = sizeof(string_desc) / sizeof(string_desc[0]),
-          .full_speed_config = mouthpad_configuration_descriptor,
+          .full_speed_config = config_desc,
           .high_speed_config = NULL,
       },
       .event_cb = usb_event_cb,
       .event_arg = NULL,
   };
 
+  const esp_timer_create_args_t idle_timer_args = {
+      .callback = idle_timer_cb,
+      .name = "hid_idle",
+  };
+  ESP_ERROR_CHECK(esp_timer_create(&idle_timer_args, &s_idle_timer));
+
   esp_err_t err = tinyusb_driver_install(&tusb_cfg);
   if (err != ESP_OK) {
     ESP_LOGE(TAG, "tinyusb_driver_install failed: %s", esp_err_to_name(err));
@@ -191,43 +492,853 @@ void usb_hid_init(void) {
   ESP_ERROR_CHECK(relay_protocol_init());
 }
 
-bool usb_hid_ready(void) { return s_usb_ready && tud_hid_ready(); }
+bool usb_hid_ready(void) { return s_usb_ready && tud_hid_n_ready(HID_INSTANCE); }
+
+bool usb_hid_mounted(void) { return s_usb_ready && tud_mounted(); }
+
+// Report ID 2 carries signed 12-bit X/Y with a logical range of +/-2047.
+// Motion that arrives while the IN endpoint is busy is summed here and sent
+// as one report from the next free slot, so deltas are never lost and never
+// replayed late as a backlog of stale reports.
+#define MOTION_REPORT_ID MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION
+#define MOTION_REPORT_SIZE MOUTHPAD_HID_REPORT_SIZE_MOUSE_MOTION
+#define MOTION_DELTA_MAX 2047
+
+// With interpolation enabled, each BLE motion report is instead spread
+// across the 1 ms USB frames until the next expected connection event, so the
+// host sees a smooth 1 kHz stream with the same total displacement. The frame
+// budget follows the measured interval between motion reports (7.5-20 ms).
+#define MOTION_INTERP_FRAMES_DEFAULT 8
+#define MOTION_INTERP_FRAMES_MIN 2
+#define MOTION_INTERP_FRAMES_MAX 20
+#define MOTION_INTERP_IDLE_US 50000 // Longer gaps are a new gesture, not an interval
+
+// With prediction on as well, a motion report that has not arrived by the
+// end of the window is covered by extrapolating the velocity of the last
+// reports of the gesture, one frame at a time, for up to half an interval.
+// What was sent ahead is owed and is taken off the report when it lands; if
+// none lands in time the gesture has ended and the owed motion is sent back,
+// so the total displacement is always the MouthPad's.
+#define MOTION_PREDICT_ONE 256 // Velocity fixed point: counts per frame * 256
+#define MOTION_PREDICT_MIN_REPORTS 2 // Of the gesture before predicting
+
+static portMUX_TYPE s_motion_lock = portMUX_INITIALIZER_UNLOCKED;
+static int32_t s_motion_dx;
+static int32_t s_motion_dy;
+static bool s_motion_pending;
+#ifdef CONFIG_MOUTHPAD_MOTION_INTERPOLATION
+static bool s_interp_enabled = true;
+#else
+static bool s_interp_enabled = false;
+#endif
+#ifdef CONFIG_MOUTHPAD_MOTION_PREDICTION
+static bool s_predict_enabled = true;
+#else
+static bool s_predict_enabled = false;
+#endif
+static uint32_t s_interp_frames = MOTION_INTERP_FRAMES_DEFAULT;
+static uint32_t s_motion_frames_left;
+static int32_t s_velocity_x; // MOTION_PREDICT_ONE fixed point
+static int32_t s_velocity_y;
+static uint32_t s_gesture_reports;
+static uint32_t s_predict_frames_left; // Last one sends the owed motion back
+static int32_t s_predict_frac_x; // Below one count, carried to the next frame
+static int32_t s_predict_frac_y;
+static int32_t s_owed_dx; // Predicted and sent, not yet covered by a report
+static int32_t s_owed_dy;
+static int64_t s_last_motion_us;
+static int64_t s_motion_start_us; // Arrival of the oldest unsent delta, for latency tracing
+
+static int32_t sign_extend_12(uint32_t value) {
+  return (int32_t)(value << 20) >> 20;
+}
+
+static int32_t clamp_delta(int32_t value) {
+  if (value > MOTION_DELTA_MAX) {
+    return MOTION_DELTA_MAX;
+  }
+  if (value < -MOTION_DELTA_MAX) {
+    return -MOTION_DELTA_MAX;
+  }
+  return value;
+}
+
+static void motion_unpack(const uint8_t *data, int32_t *dx, int32_t *dy) {
+  *dx = sign_extend_12(data[0] | ((data[1] & 0x0F) << 8));
+  *dy = sign_extend_12((data[1] >> 4) | (data[2] << 4));
+}
+
+static void motion_pack(int32_t dx, int32_t dy,
+                        uint8_t report[MOTION_REPORT_SIZE]) {
+  uint16_t x = (uint16_t)dx & 0x0FFF;
+  uint16_t y = (uint16_t)dy & 0x0FFF;
+
+  report[0] = (uint8_t)(x & 0xFF);
+  report[1] = (uint8_t)(((x >> 8) & 0x0F) | ((y & 0x0F) << 4));
+  report[2] = (uint8_t)((y >> 4) & 0xFF);
+}
+
+#if CONFIG_MOUTHPAD_HID_COMBINED_MOUSE
+// Motion goes out in Report ID 1 next to the buttons last reported by the
+// MouthPad; wheel and pan are relative, so they are zero unless they came
+// in the same BLE report.
+#define MOTION_TX_ID MOUTHPAD_HID_COMBINED_REPORT_ID
+#define MOTION_TX_SIZE MOUTHPAD_HID_COMBINED_REPORT_SIZE
+
+static atomic_uint s_held_buttons;
+
+static void motion_tx_build(uint8_t report[MOTION_TX_SIZE],
+                            const uint8_t motion[MOTION_REPORT_SIZE]) {
+  const uint8_t buttons[MOUTHPAD_HID_REPORT_SIZE_MOUSE_BUTTONS] = {
+      (uint8_t)atomic_load_explicit(&s_held_buttons, memory_order_relaxed)};
+  mouthpad_hid_combine(report, buttons, motion);
+}
+
+// Size on the wire, which differs from the BLE size for Report ID 1 only
+static size_t usb_report_size(uint8_t report_id) {
+  return report_id == MOUTHPAD_HID_COMBINED_REPORT_ID
+             ? MOUTHPAD_HID_COMBINED_REPORT_SIZE
+             : mouthpad_hid_report_size(report_id);
+}
+#else
+#define MOTION_TX_ID MOTION_REPORT_ID
+#define MOTION_TX_SIZE MOTION_REPORT_SIZE
+
+static void motion_tx_build(uint8_t report[MOTION_TX_SIZE],
+                            const uint8_t motion[MOTION_REPORT_SIZE]) {
+  memcpy(report, motion, MOTION_REPORT_SIZE);
+}
+
+static size_t usb_report_size(uint8_t report_id) {
+  return mouthpad_hid_report_size(report_id);
+}
+#endif
+
+static void motion_clear(void) {
+  taskENTER_CRITICAL(&s_motion_lock);
+  s_motion_dx = 0;
+  s_motion_dy = 0;
+  s_motion_pending = false;
+  s_motion_frames_left = 0;
+  s_motion_start_us = 0;
+  s_gesture_reports = 0;
+  s_predict_frames_left = 0;
+  s_owed_dx = 0;
+  s_owed_dy = 0;
+  taskEXIT_CRITICAL(&s_motion_lock);
+}
+
+// Fold an unsent report back in without touching the interpolation window
+static void motion_restore(const uint8_t *data, int64_t start_us) {
+  int32_t dx, dy;
+  motion_unpack(data, &dx, &dy);
+
+  taskENTER_CRITICAL(&s_motion_lock);
+  s_motion_dx = clamp_delta(s_motion_dx + dx);
+  s_motion_dy = clamp_delta(s_motion_dy + dy);
+  s_motion_pending = true;
+  s_motion_frames_left++;
+  if (start_us != 0) {
+    s_motion_start_us = start_us;
+  }
+  taskEXIT_CRITICAL(&s_motion_lock);
+}
+
+// Fold a report into the velocity and arm the prediction for the window
+// after it; s_motion_lock held
+static void motion_learn_locked(int32_t dx, int32_t dy, bool new_gesture) {
+  int32_t vx = dx * MOTION_PREDICT_ONE / (int32_t)s_interp_frames;
+  int32_t vy = dy * MOTION_PREDICT_ONE / (int32_t)s_interp_frames;
+
+  if (new_gesture || s_gesture_reports == 0) {
+    s_velocity_x = vx;
+    s_velocity_y = vy;
+    s_gesture_reports = 0;
+  } else {
+    s_velocity_x = (s_velocity_x + vx) / 2;
+    s_velocity_y = (s_velocity_y + vy) / 2;
+  }
+  s_gesture_reports++;
+
+  s_predict_frac_x = 0;
+  s_predict_frac_y = 0;
+  s_predict_frames_left =
+      s_interp_enabled && s_predict_enabled &&
+              s_gesture_reports >= MOTION_PREDICT_MIN_REPORTS
+          ? s_interp_frames / 2 + 1
+          : 0;
+}
+
+// One frame of prediction once the window ran out; s_motion_lock held
+static void motion_predict_locked(int32_t *dx, int32_t *dy) {
+  if (s_predict_frames_left == 1) {
+    // Nothing came in time: the gesture ended, undo what was sent ahead
+    *dx = clamp_delta(-s_owed_dx);
+    *dy = clamp_delta(-s_owed_dy);
+    s_owed_dx += *dx;
+    s_owed_dy += *dy;
+    if (s_owed_dx == 0 && s_owed_dy == 0) {
+      s_predict_frames_left = 0;
+      s_gesture_reports = 0;
+    }
+    return;
+  }
+  s_predict_frames_left--;
+
+  int32_t x = s_velocity_x + s_predict_frac_x;
+  int32_t y = s_velocity_y + s_predict_frac_y;
+
+  *dx = x / MOTION_PREDICT_ONE;
+  *dy = y / MOTION_PREDICT_ONE;
+  s_predict_frac_x = x - *dx * MOTION_PREDICT_ONE;
+  s_predict_frac_y = y - *dy * MOTION_PREDICT_ONE;
+  s_owed_dx += *dx;
+  s_owed_dy += *dy;
+}
+
+// Add a motion report from BLE; starts a new interpolation window
+static void motion_accumulate(const uint8_t *data, int64_t start_us) {
+  int32_t dx, dy;
+  int64_t now = esp_timer_get_time();
+  motion_unpack(data, &dx, &dy);
+
+  taskENTER_CRITICAL(&s_motion_lock);
+  int64_t gap_us = now - s_last_motion_us;
+  s_last_motion_us = now;
+  if (gap_us < MOTION_INTERP_IDLE_US) {
+    uint32_t frames = (uint32_t)((gap_us + 500) / 1000);
+    if (frames < MOTION_INTERP_FRAMES_MIN) {
+      frames = MOTION_INTERP_FRAMES_MIN;
+    } else if (frames > MOTION_INTERP_FRAMES_MAX) {
+      frames = MOTION_INTERP_FRAMES_MAX;
+    }
+    // Smooth over connection-event jitter
+    s_interp_frames = (3 * s_interp_frames + frames + 2) / 4;
+  }
+  motion_learn_locked(dx, dy, gap_us >= MOTION_INTERP_IDLE_US);
+  // Part of this report already went out as prediction
+  s_motion_dx = clamp_delta(s_motion_dx + dx - s_owed_dx);
+  s_motion_dy = clamp_delta(s_motion_dy + dy - s_owed_dy);
+  s_owed_dx = 0;
+  s_owed_dy = 0;
+  s_motion_pending = true;
+  s_motion_frames_left = s_interp_enabled ? s_interp_frames : 1;
+  if (s_motion_start_us == 0) {
+    s_motion_start_us = start_us;
+  }
+  taskEXIT_CRITICAL(&s_motion_lock);
+}
+
+// A zero motion report: the MouthPad stopped, which tells the host
+// nothing, but whatever went out as prediction is sent back and nothing
+// more is predicted
+static void motion_stop(void) {
+  taskENTER_CRITICAL(&s_motion_lock);
+  s_last_motion_us = esp_timer_get_time();
+  s_gesture_reports = 0;
+  s_predict_frames_left = 0;
+  if (s_owed_dx != 0 || s_owed_dy != 0) {
+    s_motion_dx = clamp_delta(s_motion_dx - s_owed_dx);
+    s_motion_dy = clamp_delta(s_motion_dy - s_owed_dy);
+    s_owed_dx = 0;
+    s_owed_dy = 0;
+    s_motion_pending = true;
+    if (s_motion_frames_left == 0) {
+      s_motion_frames_left = 1;
+    }
+  }
+  taskEXIT_CRITICAL(&s_motion_lock);
+}
+
+static bool motion_is_pending(void) {
+  taskENTER_CRITICAL(&s_motion_lock);
+  bool pending = s_motion_pending;
+  taskEXIT_CRITICAL(&s_motion_lock);
+  return pending;
+}
+
+// Take pending motion as a packed report; false if nothing is pending.
+// With interpolation on, this is one frame's share of the remaining delta
+// unless all is set (motion must land before a following report), and once
+// the window has run out, a frame of prediction. The latency stamp goes
+// with the first frame taken after new motion arrives.
+static bool motion_take(uint8_t report[MOTION_REPORT_SIZE], bool all,
+                        int64_t *start_us) {
+  int32_t dx, dy;
+
+  taskENTER_CRITICAL(&s_motion_lock);
+  // A report pushed ahead of a button takes real motion only
+  bool pending = s_motion_pending && (!all || s_motion_frames_left > 0);
+  if (!all && s_motion_frames_left == 0 && s_predict_frames_left > 0) {
+    // Nothing else is pending, so the frame is the prediction alone
+    motion_predict_locked(&dx, &dy);
+    s_motion_dx = dx;
+    s_motion_dy = dy;
+  } else if (all || s_motion_frames_left <= 1) {
+    dx = s_motion_dx;
+    dy = s_motion_dy;
+    s_motion_frames_left = 0;
+  } else {
+    dx = s_motion_dx / (int32_t)s_motion_frames_left;
+    dy = s_motion_dy / (int32_t)s_motion_frames_left;
+    s_motion_frames_left--;
+  }
+  s_motion_dx -= dx;
+  s_motion_dy -= dy;
+  s_motion_pending = s_motion_frames_left > 0 || s_predict_frames_left > 0;
+  *start_us = s_motion_start_us;
+  s_motion_start_us = 0;
+  taskEXIT_CRITICAL(&s_motion_lock);
+
+  motion_pack(dx, dy, report);
+  return pending;
+}
+
+void usb_hid_set_motion_interpolation(bool enable) {
+  taskENTER_CRITICAL(&s_motion_lock);
+  s_interp_enabled = enable;
+  taskEXIT_CRITICAL(&s_motion_lock);
+  ESP_LOGI(TAG, "Motion interpolation %s", enable ? "enabled" : "disabled");
+}
+
+bool usb_hid_motion_interpolation_enabled(void) { return s_interp_enabled; }
+
+void usb_hid_set_motion_prediction(bool enable) {
+  taskENTER_CRITICAL(&s_motion_lock);
+  s_predict_enabled = enable;
+  taskEXIT_CRITICAL(&s_motion_lock);
+  ESP_LOGI(TAG, "Motion prediction %s", enable ? "enabled" : "disabled");
+}
+
+bool usb_hid_motion_prediction_enabled(void) { return s_predict_enabled; }
+
+// Reports travel from transport_hid (the only producer) to a HID IN
+// endpoint through a lock-free ring of fixed-size slots. Each ring is
+// drained one report per transfer from tud_hid_report_complete_cb in the
+// TinyUSB task, or by the producer itself when the endpoint is idle, so the
+// BT stack never waits on USB. Motion is not queued here; it stays in the
+// accumulator above until the pointer ring is empty, and is pushed into the
+// ring only ahead of a button report so clicks land where the pointer is
+// (see mouthpad_hid_report_after_motion()). Consumer and keyboard reports go
+// out ahead of pending motion. With split interfaces they have a ring and
+// an endpoint of their own (mouthpad_hid_report_on_controls()).
+#define HID_TX_RING_SLOTS 16 // Must be a power of two
+#define HID_TX_REPORT_MAX MOUTHPAD_HID_REPORT_SIZE_MAX
+
+_Static_assert(HID_TX_REPORT_MAX < HID_EP_SIZE, "HID report exceeds IN endpoint");
+
+typedef struct {
+  uint8_t report_id;
+  uint8_t len;
+  uint8_t data[HID_TX_REPORT_MAX];
+  int64_t start_us; // hid_latency_start() stamp, 0 if not traced
+} hid_tx_slot_t;
+
+typedef struct {
+  hid_tx_slot_t slots[HID_TX_RING_SLOTS];
+  atomic_uint head; // Written by the producer only
+  atomic_uint tail; // Written by the drain owner only
+  atomic_flag draining;
+  uint8_t instance;
+  // The report occupying the IN endpoint, recorded on completion. Set
+  // before submitting since the completion can run on the other core
+  // before tud_hid_n_report() returns.
+  uint8_t inflight_id;
+  int64_t inflight_start_us;
+#if CONFIG_MOUTHPAD_USB_SOF_PHASE
+  uint32_t inflight_submit_us; // usb_phase.h
+#endif
+} hid_tx_queue_t;
+
+static hid_tx_queue_t s_pointer_tx = {
+    .draining = ATOMIC_FLAG_INIT,
+    .instance = HID_INSTANCE,
+};
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+static hid_tx_queue_t s_controls_tx = {
+    .draining = ATOMIC_FLAG_INIT,
+    .instance = CONTROLS_HID_INSTANCE,
+};
+#endif
+static atomic_uint s_tx_dropped;
+
+static hid_tx_queue_t *tx_queue_for(uint8_t report_id) {
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+  if (mouthpad_hid_report_on_controls(report_id)) {
+    return &s_controls_tx;
+  }
+#else
+  (void)report_id;
+#endif
+  return &s_pointer_tx;
+}
+
+// Report IDs an IN endpoint carries
+static uint32_t tx_queue_ids(hid_tx_queue_t *q) {
+  uint32_t ids = 0;
+
+  for (uint8_t id = 1; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+#if CONFIG_MOUTHPAD_HID_COMBINED_MOUSE
+    if (id == MOTION_REPORT_ID) {
+      continue; // Not in the descriptor
+    }
+#endif
+    if (tx_queue_for(id) == q) {
+      ids |= 1u << id;
+    }
+  }
+  return ids;
+}
+
+static uint32_t idle_now_ms(void) {
+  return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void idle_timer_arm(void) {
+  taskENTER_CRITICAL(&s_idle_lock);
+  uint32_t next = hid_idle_next(idle_now_ms());
+  taskEXIT_CRITICAL(&s_idle_lock);
+
+  // Started twice from two contexts, the second start fails harmlessly
+  if (next != HID_IDLE_NEVER && s_idle_timer != NULL &&
+      !esp_timer_is_active(s_idle_timer)) {
+    esp_timer_start_once(s_idle_timer, (uint64_t)MAX(next, 1) * 1000);
+  }
+}
+
+static void idle_reset(void) {
+  taskENTER_CRITICAL(&s_idle_lock);
+  hid_idle_reset();
+  taskEXIT_CRITICAL(&s_idle_lock);
+}
+
+static void idle_forget(uint8_t report_id) {
+  taskENTER_CRITICAL(&s_idle_lock);
+  hid_idle_forget(report_id);
+  taskEXIT_CRITICAL(&s_idle_lock);
+}
+
+static bool idle_filter(uint8_t report_id, const uint8_t *data, size_t len) {
+  if (atomic_load_explicit(&s_idle_bypass, memory_order_relaxed)) {
+    return true;
+  }
+
+  taskENTER_CRITICAL(&s_idle_lock);
+  bool send = hid_idle_filter(report_id, data, len, idle_now_ms());
+  taskEXIT_CRITICAL(&s_idle_lock);
+
+  if (send && hid_idle_get(report_id) != 0) {
+    idle_timer_arm();
+  }
+  return send;
+}
+
+static bool tx_ring_push(hid_tx_queue_t *q, uint8_t report_id,
+                         const uint8_t *data, size_t len, int64_t start_us) {
+  unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+  if (head - tail >= HID_TX_RING_SLOTS) {
+    return false;
+  }
+
+  // Short payloads are zero-filled to the size in the report descriptor
+  hid_tx_slot_t *slot = &q->slots[head & (HID_TX_RING_SLOTS - 1)];
+  slot->report_id = report_id;
+  slot->len = usb_report_size(report_id);
+  memcpy(slot->data, data, len);
+  memset(slot->data + len, 0, slot->len - len);
+  slot->start_us = start_us;
+
+  atomic_store_explicit(&q->head, head + 1, memory_order_release);
+  return true;
+}
+
+static bool tx_ring_empty(hid_tx_queue_t *q) {
+  return atomic_load_explicit(&q->tail, memory_order_relaxed) ==
+         atomic_load_explicit(&q->head, memory_order_acquire);
+}
+
+// Move pending motion into the ring so it is sent before the next report
+static void motion_to_ring(void) {
+  uint8_t motion[MOTION_REPORT_SIZE];
+  uint8_t report[MOTION_TX_SIZE];
+  int64_t start_us;
+
+  if (!motion_take(motion, true, &start_us)) {
+    return;
+  }
+  motion_tx_build(report, motion);
+  if (!tx_ring_push(&s_pointer_tx, MOTION_TX_ID, report, sizeof(report),
+                    start_us)) {
+    motion_restore(motion, start_us);
+  }
+}
+
+static bool hid_submit(hid_tx_queue_t *q, uint8_t report_id,
+                       const uint8_t *data, uint8_t len, int64_t start_us) {
+  q->inflight_id = report_id;
+  q->inflight_start_us = start_us;
+#if CONFIG_MOUTHPAD_USB_SOF_PHASE
+  q->inflight_submit_us = (uint32_t)esp_timer_get_time();
+#endif
+#if CONFIG_MOUTHPAD_FAULT_INJECT
+  if (fault_inject_usb_busy()) {
+    q->inflight_start_us = 0;
+    return false;
+  }
+#endif
+  probe_mark(RELAY_PROBE_USB_SUBMIT);
+  if (!tud_hid_n_report(q->instance, report_id, data, len)) {
+    q->inflight_start_us = 0;
+    return false;
+  }
+#if CONFIG_MOUTHPAD_USB_SOF_PHASE
+  usb_phase_submit(q->inflight_submit_us);
+#endif
+  return true;
+}
+
+// With nothing else to send, an unchanged report whose idle rate ran out.
+// One that cannot be submitted waits for the next timer.
+static void idle_repeat(hid_tx_queue_t *q) {
+  uint8_t report[HID_TX_REPORT_MAX];
+
+  taskENTER_CRITICAL(&s_idle_lock);
+  uint8_t report_id = hid_idle_repeat(tx_queue_ids(q), idle_now_ms(), report);
+  taskEXIT_CRITICAL(&s_idle_lock);
+
+  if (report_id != 0) {
+    hid_submit(q, report_id, report, (uint8_t)usb_report_size(report_id), 0);
+  }
+}
+
+static void idle_timer_cb(void *arg) {
+  (void)arg;
+  hid_tx_kick_all();
+  idle_timer_arm();
+}
+
+// Submit at most one report. Caller must own q->draining.
+static void tx_pump(hid_tx_queue_t *q) {
+  if (!s_usb_ready) {
+    // Host went away: anything queued would be stale by the next mount
+    atomic_store_explicit(&q->tail,
+                          atomic_load_explicit(&q->head, memory_order_acquire),
+                          memory_order_release);
+    if (q == &s_pointer_tx) {
+      motion_clear();
+    }
+    return;
+  }
+
+  if (!tud_hid_n_ready(q->instance)) {
+    return;
+  }
+
+  unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  if (tail != atomic_load_explicit(&q->head, memory_order_acquire)) {
+    const hid_tx_slot_t *slot = &q->slots[tail & (HID_TX_RING_SLOTS - 1)];
+    if (hid_submit(q, slot->report_id, slot->data, slot->len,
+                   slot->start_us)) {
+      atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    }
+    return;
+  }
+
+  if (q == &s_pointer_tx) {
+    uint8_t motion[MOTION_REPORT_SIZE];
+    uint8_t report[MOTION_TX_SIZE];
+    int64_t start_us;
+    if (motion_take(motion, false, &start_us)) {
+      motion_tx_build(report, motion);
+      if (!hid_submit(q, MOTION_TX_ID, report, sizeof(report), start_us)) {
+        motion_restore(motion, start_us);
+      }
+      return;
+    }
+  }
+
+  idle_repeat(q);
+}
+
+static bool tx_has_work(hid_tx_queue_t *q) {
+  return !tx_ring_empty(q) || (q == &s_pointer_tx && motion_is_pending());
+}
+
+// Drain from whichever context finds the endpoint idle. If the other side
+// holds the drain, it re-checks for work after releasing it, so a report
+// pushed meanwhile is never left waiting for an unrelated completion.
+static void hid_tx_kick(hid_tx_queue_t *q) {
+  do {
+    if (atomic_flag_test_and_set(&q->draining)) {
+      return;
+    }
+    tx_pump(q);
+    atomic_flag_clear(&q->draining);
+  } while (s_usb_ready && tud_hid_n_ready(q->instance) && tx_has_work(q));
+}
+
+// Every endpoint, on mount changes
+static void hid_tx_kick_all(void) {
+  hid_tx_kick(&s_pointer_tx);
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+  hid_tx_kick(&s_controls_tx);
+#endif
+}
 
 void usb_hid_send_report(uint8_t report_id, const uint8_t *data, size_t len) {
-  if (!usb_hid_ready()) {
+  int64_t start_us = hid_latency_start();
+
+  if (!usb_hid_mounted()) {
+    motion_clear();
     return;
   }
-  if (!tud_hid_n_report(HID_INSTANCE, report_id, data, (uint8_t)len)) {
-    ESP_LOGW(TAG, "Failed to send HID report id %u len %u", report_id,
+
+  if (!mouthpad_hid_report_fits(report_id, len)) {
+    ESP_LOGW(TAG, "Dropping unsupported report id %u (%u bytes)", report_id,
              (unsigned)len);
+    atomic_fetch_add_explicit(&s_tx_dropped, 1, memory_order_relaxed);
+    return;
+  }
+
+  if (!idle_filter(report_id, data, len)) {
+    if (report_id == MOTION_REPORT_ID) {
+      motion_stop();
+      hid_tx_kick(&s_pointer_tx);
+    }
+    return;
   }
+
+  if (report_id == MOTION_REPORT_ID && len == MOTION_REPORT_SIZE) {
+    motion_accumulate(data, start_us);
+#if CONFIG_MOUTHPAD_HID_COMBINED_MOUSE
+  } else if (report_id == MOUTHPAD_HID_COMBINED_REPORT_ID) {
+    // Buttons take every delta that arrived before them, so a click lands
+    // where the pointer was; later motion follows with the new buttons
+    uint8_t buttons[MOUTHPAD_HID_REPORT_SIZE_MOUSE_BUTTONS] = {0};
+    uint8_t motion[MOTION_REPORT_SIZE] = {0};
+    uint8_t report[MOUTHPAD_HID_COMBINED_REPORT_SIZE];
+    int64_t motion_start_us = 0;
+
+    memcpy(buttons, data, len);
+    bool had_motion = motion_take(motion, true, &motion_start_us);
+    mouthpad_hid_combine(report, buttons, motion);
+    atomic_store_explicit(&s_held_buttons, buttons[0], memory_order_relaxed);
+    if (!tx_ring_push(&s_pointer_tx, report_id, report, sizeof(report),
+                      start_us)) {
+      if (had_motion) {
+        motion_restore(motion, motion_start_us);
+      }
+      idle_forget(report_id);
+      ESP_LOGW(TAG, "HID TX ring full, dropping report id %u", report_id);
+      atomic_fetch_add_explicit(&s_tx_dropped, 1, memory_order_relaxed);
+    }
+#endif
+  } else {
+    if (mouthpad_hid_report_after_motion(report_id)) {
+      motion_to_ring();
+    }
+    if (!tx_ring_push(tx_queue_for(report_id), report_id, data, len,
+                      start_us)) {
+      idle_forget(report_id);
+      ESP_LOGW(TAG, "HID TX ring full, dropping report id %u", report_id);
+      atomic_fetch_add_explicit(&s_tx_dropped, 1, memory_order_relaxed);
+    }
+  }
+
+  hid_tx_kick(tx_queue_for(report_id));
+}
+
+void usb_hid_set_idle_bypass(bool bypass) {
+  atomic_store_explicit(&s_idle_bypass, bypass, memory_order_relaxed);
+}
+
+uint32_t usb_hid_dropped_reports(void) {
+  return atomic_load_explicit(&s_tx_dropped, memory_order_relaxed);
 }
 
 void usb_hid_release_all(void) {
-  if (!usb_hid_ready()) {
+  if (!usb_hid_mounted()) {
     ESP_LOGD(TAG, "USB HID not ready, skipping release");
     return;
   }
 
   ESP_LOGI(TAG, "Releasing all HID inputs to neutral state");
 
-  // Report 1: Mouse buttons + scroll (buttons=0, vscroll=0, hscroll=0)
-  const uint8_t neutral_report1[] = {0x00, 0x00, 0x00};
-  usb_hid_send_report(1, neutral_report1, sizeof(neutral_report1));
+  // Pending deltas belong to the device that just went away
+  motion_clear();
+  // The host gets every neutral report, whatever it was sent last
+  idle_forget(0);
 
-  // Report 2: Mouse movement (x=0, y=0)
-  const uint8_t neutral_report2[] = {0x00, 0x00, 0x00};
-  usb_hid_send_report(2, neutral_report2, sizeof(neutral_report2));
-
-  // Report 3: Consumer control (media keys=0)
-  const uint8_t neutral_report3[] = {0x00};
-  usb_hid_send_report(3, neutral_report3, sizeof(neutral_report3));
+  // Every report's neutral state is all zeros
+  static const uint8_t neutral[HID_TX_REPORT_MAX] = {0};
+#define SEND_NEUTRAL_REPORT(name, id, size) usb_hid_send_report(id, neutral, size);
+  MOUTHPAD_HID_REPORTS(SEND_NEUTRAL_REPORT)
+#undef SEND_NEUTRAL_REPORT
 
   ESP_LOGI(TAG, "All HID inputs released to neutral state");
 }
 
+#if RELAY_ITF
+// CDC0-style byte stream for the relay interface: framed writes land in
+// this ring (callers are serialized by the CDC0 TX mutex) and go out in
+// 64-byte input reports, one per transfer, or as bulk IN packets on the
+// WebUSB interface, drained like the HID TX rings above.
+#define RELAY_TX_RING_SIZE 2048 // Must be a power of two
+
+static uint8_t s_relay_tx_ring[RELAY_TX_RING_SIZE];
+static atomic_uint s_relay_tx_head; // Written by the writer only
+static atomic_uint s_relay_tx_tail; // Written by the drain owner only
+static atomic_flag s_relay_tx_draining = ATOMIC_FLAG_INIT;
+
+static unsigned relay_tx_queued(void) {
+  return atomic_load_explicit(&s_relay_tx_head, memory_order_acquire) -
+         atomic_load_explicit(&s_relay_tx_tail, memory_order_acquire);
+}
+
+#if CONFIG_MOUTHPAD_RELAY_HID
+static bool relay_tx_ready(void) {
+  return tud_hid_n_ready(RELAY_HID_INSTANCE);
+}
+#else
+static bool relay_tx_ready(void) { return tud_vendor_n_write_available(0) > 0; }
+#endif
+
+// Submit at most one report or endpoint's worth. Caller must own
+// s_relay_tx_draining.
+static void relay_tx_pump(void) {
+  unsigned head = atomic_load_explicit(&s_relay_tx_head, memory_order_acquire);
+  unsigned tail = atomic_load_explicit(&s_relay_tx_tail, memory_order_relaxed);
+
+  if (!s_usb_ready) {
+    atomic_store_explicit(&s_relay_tx_tail, head, memory_order_release);
+    return;
+  }
+
+  if (head == tail || !relay_tx_ready()) {
+    return;
+  }
+
+#if CONFIG_MOUTHPAD_RELAY_WEBUSB
+  uint8_t chunk[MOUTHPAD_RELAY_WEBUSB_EP_SIZE];
+  size_t n = MIN(head - tail, sizeof(chunk));
+
+  n = MIN(n, tud_vendor_n_write_available(0));
+  for (size_t i = 0; i < n; i++) {
+    chunk[i] = s_relay_tx_ring[(tail + i) & (RELAY_TX_RING_SIZE - 1)];
+  }
+
+  // Copied into the vendor FIFO; the flush starts the bulk transfer
+  uint32_t written = tud_vendor_n_write(0, chunk, n);
+  tud_vendor_n_write_flush(0);
+  atomic_store_explicit(&s_relay_tx_tail, tail + written,
+                        memory_order_release);
+#else
+  uint8_t chunk[MOUTHPAD_RELAY_HID_CHUNK_MAX];
+  uint8_t report[MOUTHPAD_RELAY_HID_REPORT_SIZE];
+  size_t n = MIN(head - tail, sizeof(chunk));
+
+  for (size_t i = 0; i < n; i++) {
+    chunk[i] = s_relay_tx_ring[(tail + i) & (RELAY_TX_RING_SIZE - 1)];
+  }
+  mouthpad_relay_hid_pack(report, chunk, n);
+
+  // TinyUSB copies the report, so the slot can be reused right away
+  if (tud_hid_n_report(RELAY_HID_INSTANCE, 0, report, sizeof(report))) {
+    atomic_store_explicit(&s_relay_tx_tail, tail + n, memory_order_release);
+  }
+#endif
+}
+
+static void relay_tx_kick(void) {
+  do {
+    if (atomic_flag_test_and_set(&s_relay_tx_draining)) {
+      return;
+    }
+    relay_tx_pump();
+    atomic_flag_clear(&s_relay_tx_draining);
+  } while (s_usb_ready && relay_tx_ready() && relay_tx_queued() != 0);
+}
+
+size_t usb_hid_relay_write(const uint8_t *data, size_t len) {
+  unsigned head = atomic_load_explicit(&s_relay_tx_head, memory_order_relaxed);
+
+  // Whole frames only, so a partial write never desyncs the host deframer
+  if (!usb_hid_mounted() || len > RELAY_TX_RING_SIZE - relay_tx_queued()) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    s_relay_tx_ring[(head + i) & (RELAY_TX_RING_SIZE - 1)] = data[i];
+  }
+  atomic_store_explicit(&s_relay_tx_head, head + len, memory_order_release);
+
+  relay_tx_kick();
+  return len;
+}
+
+uint32_t usb_hid_relay_tx_queued(void) { return relay_tx_queued(); }
+#else
+static void relay_tx_kick(void) {}
+
+size_t usb_hid_relay_write(const uint8_t *data, size_t len) {
+  (void)data;
+  (void)len;
+  return 0;
+}
+
+uint32_t usb_hid_relay_tx_queued(void) { return 0; }
+#endif // RELAY_ITF
+
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report,
+                                uint16_t len) {
+  (void)report;
+  (void)len;
+#if CONFIG_MOUTHPAD_RELAY_HID
+  if (instance == RELAY_HID_INSTANCE) {
+    relay_tx_kick();
+    return;
+  }
+#endif
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+  hid_tx_queue_t *q =
+      instance == CONTROLS_HID_INSTANCE ? &s_controls_tx : &s_pointer_tx;
+#else
+  hid_tx_queue_t *q = &s_pointer_tx;
+  (void)instance;
+#endif
+  probe_mark(RELAY_PROBE_USB_DONE);
+  if (q->inflight_start_us != 0) {
+    hid_latency_record(q->inflight_id, q->inflight_start_us);
+    q->inflight_start_us = 0;
+  }
+#if CONFIG_MOUTHPAD_USB_SOF_PHASE
+  usb_phase_done(q->inflight_submit_us, (uint32_t)esp_timer_get_time());
+#endif
+  hid_tx_kick(q);
+}
+
+#if CONFIG_MOUTHPAD_USB_SOF_PHASE
+// TinyUSB task, once per frame while tud_sof_cb_enable() is on
+void tud_sof_cb(uint32_t frame_count) {
+  (void)frame_count;
+  usb_phase_sof((uint32_t)esp_timer_get_time());
+}
+#endif
+
 uint8_t const *tud_hid_descriptor_report_cb(uint8_t instance) {
+#if CONFIG_MOUTHPAD_RELAY_HID
+  if (instance == RELAY_HID_INSTANCE) {
+    return relay_report_desc;
+  }
+#elif CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+  if (instance == CONTROLS_HID_INSTANCE) {
+    return controls_report_desc;
+  }
+#else
   (void)instance;
+#endif
   return mouthpad_report_desc;
 }
 
@@ -242,12 +1353,115 @@ uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id,
   return 0;
 }
 
+// TinyUSB answers GET_IDLE itself and passes no report ID with SET_IDLE,
+// so the rate holds for every report on the interface
+bool tud_hid_set_idle_cb(uint8_t instance, uint8_t idle_rate) {
+#if CONFIG_MOUTHPAD_RELAY_HID
+  if (instance == RELAY_HID_INSTANCE) {
+    return true;
+  }
+#endif
+#if CONFIG_MOUTHPAD_HID_SPLIT_INTERFACES
+  hid_tx_queue_t *q =
+      instance == CONTROLS_HID_INSTANCE ? &s_controls_tx : &s_pointer_tx;
+#else
+  hid_tx_queue_t *q = &s_pointer_tx;
+  (void)instance;
+#endif
+  uint32_t ids = tx_queue_ids(q);
+
+  for (uint8_t id = 1; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+    if (ids & (1u << id)) {
+      hid_idle_set(id, (uint32_t)idle_rate * HID_IDLE_UNIT_MS);
+    }
+  }
+  ESP_LOGI(TAG, "HID %u idle rate %u ms", instance,
+           (unsigned)idle_rate * HID_IDLE_UNIT_MS);
+  idle_timer_arm();
+  return true;
+}
+
+// Output reports on the relay interface arrive here from the OUT endpoint,
+// or from SET_REPORT on hosts that send them over EP0, in the TinyUSB task
+// like CDC0 RX
 void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id,
                            hid_report_type_t report_type, uint8_t const *buffer,
                            uint16_t bufsize) {
-  (void)instance;
+#if CONFIG_MOUTHPAD_HID_OUTPUT_REPORTS
+  // SET_REPORT(Output) on the MouthPad interface. TinyUSB strips the ID
+  // byte for a control transfer; an interrupt OUT report starts with it.
+  if (instance == OUTPUT_HID_INSTANCE &&
+      report_type != HID_REPORT_TYPE_FEATURE) {
+    if (report_id == 0 && bufsize > 0) {
+      report_id = buffer[0];
+      buffer++;
+      bufsize--;
+    }
+    transport_hid_handle_output(report_id, buffer, bufsize);
+    return;
+  }
+#endif
   (void)report_id;
+#if CONFIG_MOUTHPAD_RELAY_HID
+  if (instance != RELAY_HID_INSTANCE || report_type == HID_REPORT_TYPE_FEATURE) {
+    return;
+  }
+
+  size_t len = mouthpad_relay_hid_unpack(buffer, bufsize);
+  if (len > 0) {
+    usb_cdc_relay_received(&buffer[1], len);
+  }
+#else
+  (void)instance;
   (void)report_type;
   (void)buffer;
   (void)bufsize;
+#endif
+}
+
+#if CONFIG_MOUTHPAD_RELAY_WEBUSB
+// Bulk OUT data on the WebUSB interface, in the TinyUSB task like CDC0 RX.
+// The bytes also sit in the vendor FIFO, which is read empty here.
+void tud_vendor_rx_cb(uint8_t itf, uint8_t const *buffer, uint16_t bufsize) {
+  (void)buffer;
+  (void)bufsize;
+
+  uint8_t chunk[MOUTHPAD_RELAY_WEBUSB_EP_SIZE];
+  uint32_t n;
+  while ((n = tud_vendor_n_read(itf, chunk, sizeof(chunk))) > 0) {
+    usb_cdc_relay_received(chunk, n);
+  }
+}
+
+void tud_vendor_tx_cb(uint8_t itf, uint32_t sent_bytes) {
+  (void)itf;
+  (void)sent_bytes;
+  relay_tx_kick();
+}
+
+uint8_t const *tud_descriptor_bos_cb(void) {
+  if (usb_comp_active() != mouthware_message_UsbComposition_USB_COMPOSITION_FULL) {
+    return NULL;
+  }
+  return mouthpad_bos_descriptor;
 }
+
+// The WebUSB capability has no landing page, so the MS OS 2.0 descriptor
+// set is the only vendor request answered
+bool tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage,
+                                tusb_control_request_t const *request) {
+  if (stage != CONTROL_STAGE_SETUP) {
+    return true;
+  }
+
+  if (request->bmRequestType_bit.type == TUSB_REQ_TYPE_VENDOR &&
+      request->bRequest == MOUTHPAD_RELAY_WEBUSB_MSOS2_VENDOR_CODE &&
+      request->wIndex == MOUTHPAD_RELAY_WEBUSB_MSOS2_INDEX) {
+    return tud_control_xfer(rhport, request,
+                            (void *)(uintptr_t)mouthpad_msos2_descriptor,
+                            sizeof(mouthpad_msos2_descriptor));
+  }
+
+  return false; // Stall anything else
+}
+#endif
@@ -4,14 +4,72 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "esp_err.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void usb_hid_init(void);
 bool usb_hid_ready(void);
+
+/**
+ * @brief Check whether the host has configured the device
+ *
+ * Unlike usb_hid_ready(), this stays true while the HID IN endpoint is
+ * busy with a previous report.
+ */
+bool usb_hid_mounted(void);
+
+/**
+ * @brief Send an input report to the host
+ *
+ * Reports are queued in a lock-free ring and submitted from the TinyUSB
+ * task as each IN transfer completes, so this never blocks. Motion reports
+ * (ID 2) are coalesced while the endpoint is busy; other report IDs are
+ * delivered exactly and in order. Must be called from a single task (the
+ * esp_hidh event task).
+ */
 void usb_hid_send_report(uint8_t report_id, const uint8_t *data, size_t len);
 
+/**
+ * @brief Forward every report, redundant or not
+ *
+ * Set while the bench injects reports, so each one loads USB. Otherwise
+ * reports that tell the host nothing new are not forwarded and unchanged
+ * ones are repeated at the host's idle rate (see common/hid_idle.h).
+ */
+void usb_hid_set_idle_bypass(bool bypass);
+
+/**
+ * @brief Reports dropped since boot by usb_hid_send_report (ring full or
+ * unsupported report ID)
+ */
+uint32_t usb_hid_dropped_reports(void);
+
+/**
+ * @brief Enable or disable 1 kHz motion interpolation
+ *
+ * When enabled, each motion report (ID 2) is spread across the USB frames
+ * until the next expected BLE connection event instead of being sent in a
+ * single frame. Total displacement is unchanged. Not persisted; the boot
+ * default comes from CONFIG_MOUTHPAD_MOTION_INTERPOLATION.
+ */
+void usb_hid_set_motion_interpolation(bool enable);
+bool usb_hid_motion_interpolation_enabled(void);
+
+/**
+ * @brief Enable or disable motion prediction
+ *
+ * With interpolation also on, a motion report that is late is covered by
+ * extrapolating the gesture's recent velocity for up to half an interval.
+ * The predicted motion is taken off the report when it lands, or sent back
+ * if none does, so the total displacement is unchanged. Not persisted; the
+ * boot default comes from CONFIG_MOUTHPAD_MOTION_PREDICTION.
+ */
+void usb_hid_set_motion_prediction(bool enable);
+bool usb_hid_motion_prediction_enabled(void);
+
 /**
  * @brief Send neutral/resting state for all HID reports
  *
@@ -20,6 +78,48 @@ void usb_hid_send_report(uint8_t report_id, const uint8_t *data, size_t len);
  */
 void usb_hid_release_all(void);
 
+/**
+ * @brief Queue framed relay bytes on the relay HID or WebUSB interface
+ *
+ * Only with CONFIG_MOUTHPAD_RELAY_HID or CONFIG_MOUTHPAD_RELAY_WEBUSB. The
+ * bytes go out in 64-byte input reports (see common/mouthpad_relay_hid.h)
+ * as the host polls, or as they are on the WebUSB bulk IN endpoint. Callers must
+ * be serialized; usb_cdc holds its TX mutex.
+ *
+ * @return len if queued, 0 if the ring had no room for all of it or the
+ *         device is not mounted
+ */
+size_t usb_hid_relay_write(const uint8_t *data, size_t len);
+
+/**
+ * @brief Bytes queued for the relay interface and not yet sent
+ */
+uint32_t usb_hid_relay_tx_queued(void);
+
+/**
+ * @brief Called from the TinyUSB task when the host suspends or resumes
+ *
+ * Attach and detach also count as resume.
+ */
+typedef void (*usb_hid_suspend_cb_t)(bool suspended);
+void usb_hid_set_suspend_callback(usb_hid_suspend_cb_t cb);
+
+/**
+ * @brief Check whether the host has suspended the bus
+ *
+ * Reports sent while suspended would reach the host as a stale burst on
+ * resume, so the bridge drops them instead.
+ */
+bool usb_hid_suspended(void);
+
+/**
+ * @brief Ask the suspended host to resume the bus
+ *
+ * Signalled at most once per suspend. Returns ESP_ERR_NOT_SUPPORTED when
+ * the host did not enable remote wakeup before suspending.
+ */
+esp_err_t usb_hid_remote_wakeup(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,946 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Runs the standard relay performance suite and prints the results as one
+ * JSON document, so firmware releases and board variants can be compared
+ * on the same numbers. The suite is versioned: its tests, counts and
+ * durations only change together with suite_version.
+ *
+ *   boot           Milliseconds from reset until USB started, Bluetooth was
+ *                  ready, the first scan, host enumeration and the first HID
+ *                  report of this boot (ConnectionTimingRead)
+ *   echo_usb       1000 CDC0 echoes one at a time: round trip, and how long
+ *                  the relay held each
+ *   echo_mouthpad  200 echoes through the MouthPad: round trip, and the
+ *                  acknowledged NUS write's round trip
+ *   cdc_down       5 s of echoes with a 20-byte payload, 32 in flight:
+ *                  frames and bytes per second from host to relay
+ *   cdc_up         5 s of TraceRead pages, 4 in flight: frames and bytes per
+ *                  second from relay to host
+ *   pass_through   3 s of acknowledged writes to the MouthPad at each of 20,
+ *                  60, 120, 180 and 240 bytes, as many in flight as the
+ *                  relay grants: writes and bytes per second, errors
+ *   hid            10 s of the HID mirror: reports per second, the interval
+ *                  between them, the relay's BLE->USB time, reports lost
+ *                  and not submitted. Move the MouthPad meanwhile.
+ *   reconnect      3 disconnects through the console (CDC1): time until the
+ *                  relay reports the link down and up again, and its phase
+ *                  timings of the new link
+ *
+ * A test the relay or setup cannot run is reported as skipped, with the
+ * reason. The MouthPad tests need one connected; echo_mouthpad and
+ * pass_through also need --ble, bytes the MouthPad ignores, which
+ * pass_through pads with zeros to each size. Progress goes to stderr.
+ *
+ *   mouthpad_bench [-o file] [--ble hex] [--console port] [--only test[,test]...] [port]
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/utsname.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "mouthpad/mouthpad.hpp"
+
+static constexpr unsigned suite_version = 1;
+
+static constexpr size_t echo_payload_max = sizeof(mouthware_message_EchoRequest_payload_t::bytes);
+
+static constexpr unsigned echo_usb_count = 1000;
+static constexpr unsigned echo_mouthpad_count = 200;
+static constexpr uint64_t cdc_down_us = 5 * 1000000;
+static constexpr unsigned cdc_down_in_flight = 32;
+static constexpr size_t cdc_down_payload = 20;
+static constexpr uint64_t cdc_up_us = 5 * 1000000;
+static constexpr unsigned cdc_up_in_flight = 4;
+static constexpr uint64_t pass_through_us = 3 * 1000000;
+static constexpr size_t pass_through_sizes[] = {20, 60, 120, 180, 240};
+static constexpr uint64_t hid_us = 10 * 1000000;
+static constexpr unsigned reconnect_count = 3;
+
+/* Longest wait for one reply before it counts as lost */
+static constexpr uint64_t reply_timeout_us = 1000000;
+
+static mouthpad::event_loop *s_loop;
+static volatile sig_atomic_t s_stop;
+
+static void on_signal(int)
+{
+	s_stop = 1;
+	s_loop->stop();
+}
+
+/* Indented JSON, written as it goes */
+class json {
+public:
+	void open(const char *key = nullptr, char bracket = '{')
+	{
+		field(key);
+		out_ += bracket;
+		depth_++;
+		first_ = true;
+	}
+
+	void close(char bracket = '}')
+	{
+		depth_--;
+		if (!first_) {
+			newline();
+		}
+		out_ += bracket;
+		first_ = false;
+	}
+
+	void open_array(const char *key) { open(key, '['); }
+	void close_array() { close(']'); }
+
+	void number(const char *key, uint64_t value)
+	{
+		field(key);
+		out_ += std::to_string(value);
+	}
+
+	void signed_number(const char *key, int64_t value)
+	{
+		field(key);
+		out_ += std::to_string(value);
+	}
+
+	void real(const char *key, double value)
+	{
+		char buf[32];
+
+		field(key);
+		snprintf(buf, sizeof(buf), "%.1f", value);
+		out_ += buf;
+	}
+
+	void boolean(const char *key, bool value)
+	{
+		field(key);
+		out_ += value ? "true" : "false";
+	}
+
+	void string(const char *key, const std::string &value)
+	{
+		field(key);
+		quote(value);
+	}
+
+	const std::string &text() const { return out_; }
+
+private:
+	void field(const char *key)
+	{
+		if (!first_) {
+			out_ += ',';
+		}
+		if (depth_) {
+			newline();
+		}
+		first_ = false;
+		if (key) {
+			quote(key);
+			out_ += ": ";
+		}
+	}
+
+	void newline()
+	{
+		out_ += '\n';
+		out_.append(depth_ * 2, ' ');
+	}
+
+	void quote(const std::string &s)
+	{
+		out_ += '"';
+		for (unsigned char c : s) {
+			if (c == '"' || c == '\\') {
+				out_ += '\\';
+				out_ += (char)c;
+			} else if (c < 0x20) {
+				char buf[8];
+
+				snprintf(buf, sizeof(buf), "\\u%04x", c);
+				out_ += buf;
+			} else {
+				out_ += (char)c;
+			}
+		}
+		out_ += '"';
+	}
+
+	std::string out_;
+	unsigned depth_ = 0;
+	bool first_ = true;
+};
+
+/* Samples of one quantity, written as count, mean and percentiles */
+class summary {
+public:
+	void add(int64_t value) { samples_.push_back(value > 0 ? (uint64_t)value : 0); }
+
+	void write(json &out, const char *key)
+	{
+		uint64_t sum = 0;
+
+		out.open(key);
+		out.number("n", samples_.size());
+		if (!samples_.empty()) {
+			std::sort(samples_.begin(), samples_.end());
+			for (uint64_t v : samples_) {
+				sum += v;
+			}
+			out.real("mean", (double)sum / samples_.size());
+			out.number("p50", percentile(50));
+			out.number("p90", percentile(90));
+			out.number("p99", percentile(99));
+			out.number("max", samples_.back());
+		}
+		out.close();
+	}
+
+private:
+	uint64_t percentile(unsigned p) const { return samples_[(samples_.size() - 1) * p / 100]; }
+
+	std::vector<uint64_t> samples_;
+};
+
+static bool parse_hex(const char *hex, std::vector<uint8_t> &out)
+{
+	size_t len = strlen(hex);
+
+	if (len == 0 || len % 2) {
+		return false;
+	}
+	for (size_t i = 0; i < len; i += 2) {
+		char byte[3] = {hex[i], hex[i + 1], 0};
+		char *end;
+
+		out.push_back((uint8_t)strtoul(byte, &end, 16));
+		if (*end) {
+			return false;
+		}
+	}
+	return true;
+}
+
+class bench {
+public:
+	bench(const std::string &path, const std::string &console, const std::vector<uint8_t> &ble)
+		: path_(path), console_path_(console), ble_(ble)
+	{
+		mouthpad::relay::callbacks cb;
+
+		cb.on_status = [this](const mouthware_message_BleConnectionStatusResponse &s) {
+			status_ = s;
+			status_count_++;
+		};
+		cb.on_hid_mirror = [this](const mouthpad::hid_mirror_report &r) {
+			if (on_hid_) {
+				on_hid_(r);
+			}
+		};
+		cb.on_message = [this](const mouthware_message_RelayToAppMessage &m) {
+			if (m.which_message_body ==
+			    mouthware_message_RelayToAppMessage_relay_capabilities_response_tag) {
+				caps_ = m.message_body.relay_capabilities_response;
+				has_caps_ = true;
+			}
+			if (on_message_) {
+				on_message_(m);
+			}
+		};
+		cb.on_closed = [this](int err) {
+			fprintf(stderr, "%s closed: %s\n", path_.c_str(), strerror(-err));
+			loop_.stop();
+		};
+		relay_.reset(new mouthpad::relay(loop_, cb));
+	}
+
+	~bench()
+	{
+		if (console_fd_ >= 0) {
+			loop_.remove(console_fd_);
+			close(console_fd_);
+		}
+	}
+
+	int open()
+	{
+		s_loop = &loop_;
+		return relay_->open(path_);
+	}
+
+	/* Capabilities and link state, which decide what can run */
+	bool start()
+	{
+		relay_->read_capabilities();
+		if (!wait([this] { return has_caps_; }, 2 * reply_timeout_us)) {
+			fprintf(stderr, "%s: no RelayCapabilitiesResponse\n", path_.c_str());
+			return false;
+		}
+		return read_status();
+	}
+
+	bool has(uint32_t feature) const { return (caps_.features & feature) != 0; }
+
+	bool connected() const
+	{
+		return status_.connection_status ==
+		       mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTED;
+	}
+
+	void write_header(json &out) const
+	{
+		struct utsname host;
+
+		out.string("suite", "mouthpad_bench");
+		out.number("version", suite_version);
+		if (uname(&host) == 0) {
+			out.open("host");
+			out.string("os", std::string(host.sysname) + " " + host.release);
+			out.string("machine", host.machine);
+			out.close();
+		}
+		out.open("relay");
+		out.string("port", path_);
+		out.string("firmware", caps_.firmware_version);
+		out.number("features", caps_.features);
+		out.number("max_frame_size", caps_.max_frame_size);
+		out.number("max_pass_through_size", caps_.max_pass_through_size);
+		out.number("max_in_flight_writes", caps_.max_in_flight_writes);
+		out.number("batch_window_us", caps_.batch_window_us);
+		out.boolean("cobs_framing", relay_->cobs_framing());
+		out.boolean("raw_channels", relay_->raw_channels());
+		out.close();
+		out.open("mouthpad");
+		out.boolean("connected", connected());
+		if (connected()) {
+			out.signed_number("rssi", status_.rssi);
+			out.number("tx_phy", status_.tx_phy);
+			out.number("rx_phy", status_.rx_phy);
+			out.number("max_tx_octets", status_.max_tx_octets);
+			out.number("max_rx_octets", status_.max_rx_octets);
+		}
+		out.close();
+	}
+
+	/* Every test in suite order, or those in only (",name,...,") */
+	void run(const std::string &only, json &out)
+	{
+		static const struct {
+			const char *name;
+			void (bench::*run)(json &);
+		} tests[] = {
+			{"boot", &bench::boot},
+			{"echo_usb", &bench::echo_usb},
+			{"echo_mouthpad", &bench::echo_mouthpad},
+			{"cdc_down", &bench::cdc_down},
+			{"cdc_up", &bench::cdc_up},
+			{"pass_through", &bench::pass_through},
+			{"hid", &bench::hid},
+			{"reconnect", &bench::reconnect},
+		};
+
+		for (const auto &t : tests) {
+			if (!open_now()) {
+				return;
+			}
+			if (!only.empty() && only.find(std::string(",") + t.name + ",") == std::string::npos) {
+				continue;
+			}
+			fprintf(stderr, "%s...\n", t.name);
+			out.open(t.name);
+			(this->*t.run)(out);
+			out.close();
+			on_message_ = nullptr;
+			on_hid_ = nullptr;
+		}
+	}
+
+	bool open_now() const { return relay_->is_open() && !s_stop; }
+
+private:
+	/* Run the loop until done() or timeout_us; false on timeout or close */
+	bool wait(const std::function<bool()> &done, uint64_t timeout_us)
+	{
+		uint64_t until = mouthpad::steady_us() + timeout_us;
+
+		while (!done()) {
+			if (!open_now() || mouthpad::steady_us() >= until || loop_.run_once(1) < 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/* Run the loop for us, whatever arrives */
+	void idle(uint64_t us)
+	{
+		wait([] { return false; }, us);
+	}
+
+	bool read_status()
+	{
+		uint32_t before = status_count_;
+
+		relay_->read_status();
+		return wait([&] { return status_count_ != before; }, reply_timeout_us);
+	}
+
+	static void skip(json &out, const char *reason) { out.string("skipped", reason); }
+
+	mouthware_message_AppToRelayMessage relay_message(pb_size_t which)
+	{
+		mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+		message.destination =
+			mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+		message.which_message_body = which;
+		return message;
+	}
+
+	bool read_timing(mouthware_message_ConnectionTimingResponse &timing)
+	{
+		bool got = false;
+
+		on_message_ = [&](const mouthware_message_RelayToAppMessage &m) {
+			if (m.which_message_body ==
+			    mouthware_message_RelayToAppMessage_connection_timing_response_tag) {
+				timing = m.message_body.connection_timing_response;
+				got = true;
+			}
+		};
+		relay_->send(relay_message(mouthware_message_AppToRelayMessage_connection_timing_read_tag));
+		bool ok = wait([&] { return got; }, reply_timeout_us);
+
+		on_message_ = nullptr;
+		return ok;
+	}
+
+	void boot(json &out)
+	{
+		mouthware_message_ConnectionTimingResponse timing;
+
+		if (!has(mouthware_message_RelayFeature_RELAY_FEATURE_CONNECTION_TIMING)) {
+			return skip(out, "relay lacks RELAY_FEATURE_CONNECTION_TIMING");
+		}
+		if (!read_timing(timing)) {
+			return skip(out, "no ConnectionTimingResponse");
+		}
+		out.number("usb_started_ms", timing.boot_usb_started_ms);
+		out.number("ble_ready_ms", timing.boot_ble_ready_ms);
+		out.number("scan_started_ms", timing.boot_scan_started_ms);
+		out.number("usb_enumerated_ms", timing.boot_usb_enumerated_ms);
+		out.number("hid_ready_ms", timing.boot_hid_ready_ms);
+	}
+
+	/* count echoes one at a time, with payload through the MouthPad */
+	void echoes(json &out, unsigned count, const std::vector<uint8_t> &payload)
+	{
+		summary round_trip, held, ble;
+		uint32_t lost = 0;
+		uint32_t failed = 0;
+		uint32_t sequence = 0;
+		bool got = false;
+
+		on_message_ = [&](const mouthware_message_RelayToAppMessage &m) {
+			if (m.which_message_body != mouthware_message_RelayToAppMessage_echo_response_tag ||
+			    m.message_body.echo_response.sequence != sequence) {
+				return;
+			}
+			const mouthware_message_EchoResponse &echo = m.message_body.echo_response;
+
+			round_trip.add((int64_t)(mouthpad::steady_us() - echo.host_timestamp_us));
+			held.add((int64_t)(echo.relay_tx_us - echo.relay_rx_us));
+			if (echo.via_mouthpad) {
+				if (echo.error_code == 0 && echo.mouthpad_write_us &&
+				    echo.mouthpad_ack_us > echo.mouthpad_write_us) {
+					ble.add((int64_t)(echo.mouthpad_ack_us - echo.mouthpad_write_us));
+				} else {
+					failed++;
+				}
+			}
+			got = true;
+		};
+
+		for (unsigned i = 0; i < count && open_now(); i++) {
+			sequence = i;
+			got = false;
+			if (relay_->send_echo(sequence, payload.data(), payload.size()) ||
+			    !wait([&] { return got; }, reply_timeout_us)) {
+				lost++;
+			}
+		}
+
+		out.number("sent", count);
+		out.number("lost", lost);
+		round_trip.write(out, "round_trip_us");
+		held.write(out, "relay_us");
+		if (!payload.empty()) {
+			out.number("mouthpad_failed", failed);
+			ble.write(out, "mouthpad_write_us");
+		}
+	}
+
+	void echo_usb(json &out)
+	{
+		if (!has(mouthware_message_RelayFeature_RELAY_FEATURE_ECHO)) {
+			return skip(out, "relay lacks RELAY_FEATURE_ECHO");
+		}
+		echoes(out, echo_usb_count, {});
+	}
+
+	void echo_mouthpad(json &out)
+	{
+		if (!has(mouthware_message_RelayFeature_RELAY_FEATURE_ECHO)) {
+			return skip(out, "relay lacks RELAY_FEATURE_ECHO");
+		}
+		if (!connected()) {
+			return skip(out, "no MouthPad connected");
+		}
+		if (ble_.empty()) {
+			return skip(out, "no --ble payload");
+		}
+		echoes(out, echo_mouthpad_count,
+		       std::vector<uint8_t>(ble_.begin(),
+					    ble_.begin() + std::min(ble_.size(), echo_payload_max)));
+	}
+
+	/* Keep in_flight requests of which outstanding, sent by send_one(),
+	 * for duration_us; replies are counted by the caller's on_message_
+	 */
+	uint64_t pump(unsigned in_flight, uint64_t duration_us, const uint32_t &replies,
+		      uint32_t &sent, const std::function<int()> &send_one)
+	{
+		uint64_t start = mouthpad::steady_us();
+		uint64_t end = start + duration_us;
+
+		while (open_now() && mouthpad::steady_us() < end) {
+			while (sent - replies < in_flight && send_one() == 0) {
+				sent++;
+			}
+			if (loop_.run_once(1) < 0) {
+				break;
+			}
+		}
+		return mouthpad::steady_us() - start;
+	}
+
+	void write_rate(json &out, uint32_t frames, uint64_t bytes, uint64_t elapsed_us)
+	{
+		double seconds = elapsed_us / 1e6;
+
+		out.number("frames", frames);
+		out.real("frames_per_s", frames / seconds);
+		out.real("frame_bytes", frames ? (double)bytes / frames : 0);
+		out.real("bytes_per_s", bytes / seconds);
+	}
+
+	void cdc_down(json &out)
+	{
+		uint32_t sent = 0;
+		uint32_t replies = 0;
+
+		if (!has(mouthware_message_RelayFeature_RELAY_FEATURE_ECHO)) {
+			return skip(out, "relay lacks RELAY_FEATURE_ECHO");
+		}
+		on_message_ = [&](const mouthware_message_RelayToAppMessage &m) {
+			if (m.which_message_body == mouthware_message_RelayToAppMessage_echo_response_tag) {
+				replies++;
+			}
+		};
+
+		/* The payload goes nowhere without via_mouthpad; it only fills the frame */
+		uint64_t tx_before = relay_->stats().tx_bytes;
+		uint64_t elapsed = pump(cdc_down_in_flight, cdc_down_us, replies, sent, [&] {
+			mouthware_message_AppToRelayMessage message =
+				relay_message(mouthware_message_AppToRelayMessage_echo_request_tag);
+			mouthware_message_EchoRequest &echo = message.message_body.echo_request;
+
+			echo.host_timestamp_us = mouthpad::steady_us();
+			echo.sequence = sent;
+			memset(echo.payload.bytes, 0x55, cdc_down_payload);
+			echo.payload.size = cdc_down_payload;
+			return relay_->send(message);
+		});
+		uint32_t answered = replies;
+		uint64_t frame_bytes = sent ? (relay_->stats().tx_bytes - tx_before) / sent : 0;
+
+		wait([&] { return replies == sent; }, reply_timeout_us);
+		write_rate(out, answered, answered * frame_bytes, elapsed);
+		out.number("unanswered", sent - replies);
+	}
+
+	void cdc_up(json &out)
+	{
+		uint32_t sent = 0;
+		uint32_t replies = 0;
+
+		if (!has(mouthware_message_RelayFeature_RELAY_FEATURE_TRACE)) {
+			return skip(out, "relay lacks RELAY_FEATURE_TRACE");
+		}
+		on_message_ = [&](const mouthware_message_RelayToAppMessage &m) {
+			if (m.which_message_body == mouthware_message_RelayToAppMessage_trace_response_tag) {
+				replies++;
+			}
+		};
+
+		/* Pages from the oldest record, never cleared; the bytes read count
+		 * whatever else the relay sends meanwhile too
+		 */
+		uint64_t rx_before = relay_->stats().rx_bytes;
+		uint64_t elapsed = pump(cdc_up_in_flight, cdc_up_us, replies, sent, [&] {
+			return relay_->send(relay_message(mouthware_message_AppToRelayMessage_trace_read_tag));
+		});
+
+		write_rate(out, replies, relay_->stats().rx_bytes - rx_before, elapsed);
+		wait([&] { return replies == sent; }, reply_timeout_us);
+	}
+
+	void pass_through(json &out)
+	{
+		if (!connected()) {
+			return skip(out, "no MouthPad connected");
+		}
+		if (ble_.empty()) {
+			return skip(out, "no --ble payload");
+		}
+
+		out.open_array("sizes");
+		for (size_t size : pass_through_sizes) {
+			out.open();
+			out.number("size", size);
+			if (caps_.max_pass_through_size && size > caps_.max_pass_through_size) {
+				skip(out, "larger than max_pass_through_size");
+			} else {
+				pass_through_size(out, size);
+			}
+			out.close();
+		}
+		out.close_array();
+	}
+
+	void pass_through_size(json &out, size_t size)
+	{
+		std::vector<uint8_t> data(size, 0);
+		uint32_t sent = 0;
+		uint32_t acked = 0;
+		uint32_t errors = 0;
+		uint32_t credits = 1; /* One at a time until the relay says otherwise */
+
+		std::copy(ble_.begin(), ble_.begin() + std::min(ble_.size(), size), data.begin());
+		on_message_ = [&](const mouthware_message_RelayToAppMessage &m) {
+			if (m.which_message_body !=
+			    mouthware_message_RelayToAppMessage_pass_through_to_mouthpad_response_tag) {
+				return;
+			}
+			const mouthware_message_PassThroughToMouthpadResponse &r =
+				m.message_body.pass_through_to_mouthpad_response;
+			uint32_t covered = r.acked ? r.acked : 1;
+
+			acked += covered;
+			if (r.error_code) {
+				errors += covered;
+			}
+			credits = r.credits ? r.credits : 1;
+		};
+
+		uint64_t start = mouthpad::steady_us();
+		uint64_t end = start + pass_through_us;
+
+		while (open_now() && mouthpad::steady_us() < end) {
+			while (sent - acked < credits &&
+			       relay_->send_pass_through(data.data(), size, 0, false,
+							 mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_EACH,
+							 sent + 1) == 0) {
+				sent++;
+			}
+			if (loop_.run_once(1) < 0) {
+				break;
+			}
+		}
+
+		uint64_t elapsed = mouthpad::steady_us() - start;
+		uint32_t done = acked - errors;
+		double seconds = elapsed / 1e6;
+
+		out.number("writes", done);
+		out.real("writes_per_s", done / seconds);
+		out.real("bytes_per_s", (double)done * size / seconds);
+		out.number("errors", errors);
+		out.number("credits", credits);
+
+		/* Let the last writes finish before the next size */
+		wait([&] { return acked >= sent; }, reply_timeout_us);
+	}
+
+	void hid(json &out)
+	{
+		summary relay_us, interval_us;
+		uint32_t reports = 0;
+		uint32_t lost = 0;
+		uint32_t not_submitted = 0;
+		uint32_t next = 0;
+		uint64_t last_rx = 0;
+
+		if (!has(mouthware_message_RelayFeature_RELAY_FEATURE_HID_MIRROR)) {
+			return skip(out, "relay lacks RELAY_FEATURE_HID_MIRROR");
+		}
+		if (!connected()) {
+			return skip(out, "no MouthPad connected");
+		}
+
+		on_hid_ = [&](const mouthpad::hid_mirror_report &r) {
+			if (reports && r.sequence != next) {
+				lost += r.sequence - next;
+			}
+			if (reports) {
+				interval_us.add((int64_t)(r.ble_rx_us - last_rx));
+			}
+			next = r.sequence + 1;
+			last_rx = r.ble_rx_us;
+			reports++;
+			if (r.submitted) {
+				relay_us.add(r.usb_submit_delay_us);
+			} else {
+				not_submitted++;
+			}
+		};
+
+		fprintf(stderr, "  move the MouthPad for %u s\n", (unsigned)(hid_us / 1000000));
+		relay_->set_hid_mirror(true);
+		idle(hid_us);
+		relay_->set_hid_mirror(false);
+		/* The last batch trails the reports it holds */
+		idle(250 * 1000);
+
+		out.number("reports", reports);
+		out.real("reports_per_s", reports / (hid_us / 1e6));
+		out.number("lost", lost);
+		out.number("not_submitted", not_submitted);
+		interval_us.write(out, "interval_us");
+		relay_us.write(out, "relay_us");
+	}
+
+	int open_console()
+	{
+		struct termios tio;
+
+		console_fd_ = ::open(console_path_.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+		if (console_fd_ < 0) {
+			return -errno;
+		}
+		if (tcgetattr(console_fd_, &tio) == 0) {
+			cfmakeraw(&tio);
+			tcsetattr(console_fd_, TCSANOW, &tio);
+		}
+		/* Nothing is parsed from the console; it is only kept drained */
+		return loop_.add(console_fd_, mouthpad::event_loop::readable, [this](unsigned) {
+			char buf[256];
+
+			while (read(console_fd_, buf, sizeof(buf)) > 0) {
+			}
+		});
+	}
+
+	/* Poll the link state every 20 ms until it is up or down */
+	bool wait_link(bool up, uint64_t timeout_us)
+	{
+		uint64_t until = mouthpad::steady_us() + timeout_us;
+
+		while (open_now() && mouthpad::steady_us() < until) {
+			if (read_status() && connected() == up) {
+				return true;
+			}
+			idle(20 * 1000);
+		}
+		return false;
+	}
+
+	void reconnect(json &out)
+	{
+		static const char command[] = "disconnect\r\n";
+		summary down_ms, up_ms;
+		uint32_t failed = 0;
+
+		if (!connected()) {
+			return skip(out, "no MouthPad connected");
+		}
+		if (console_path_.empty()) {
+			return skip(out, "no console port");
+		}
+		int err = open_console();
+
+		if (err) {
+			fprintf(stderr, "%s: %s\n", console_path_.c_str(), strerror(-err));
+			return skip(out, "console did not open");
+		}
+
+		out.open_array("cycles");
+		for (unsigned i = 0; i < reconnect_count && open_now(); i++) {
+			mouthware_message_ConnectionTimingResponse timing;
+			uint64_t start = mouthpad::steady_us();
+
+			out.open();
+			if (write(console_fd_, command, sizeof(command) - 1) != (ssize_t)sizeof(command) - 1 ||
+			    !wait_link(false, 5 * reply_timeout_us)) {
+				failed++;
+				out.string("failed", "link did not go down");
+				out.close();
+				continue;
+			}
+			uint64_t down = mouthpad::steady_us();
+
+			if (!wait_link(true, 30 * reply_timeout_us)) {
+				failed++;
+				out.string("failed", "link did not come back");
+				out.close();
+				break;
+			}
+			uint64_t up = mouthpad::steady_us();
+
+			down_ms.add((int64_t)(down - start) / 1000);
+			up_ms.add((int64_t)(up - start) / 1000);
+			out.number("down_ms", (down - start) / 1000);
+			out.number("up_ms", (up - start) / 1000);
+
+			/* Device information and battery follow the link by a little */
+			idle(2 * reply_timeout_us);
+			if (has(mouthware_message_RelayFeature_RELAY_FEATURE_CONNECTION_TIMING) &&
+			    read_timing(timing) && timing.records_count > 0) {
+				const mouthware_message_ConnectionTimingRecord &r = timing.records[0];
+
+				out.open("phases_ms");
+				out.number("first_adv", r.first_adv_ms);
+				out.number("connect_request", r.connect_request_ms);
+				out.number("connected", r.connected_ms);
+				out.number("security", r.security_ms);
+				out.number("hid_ready", r.hid_ready_ms);
+				out.number("nus_ready", r.nus_ready_ms);
+				out.number("dis_ready", r.dis_ready_ms);
+				out.number("bas_ready", r.bas_ready_ms);
+				out.close();
+			}
+			out.close();
+		}
+		out.close_array();
+		out.number("failed", failed);
+		down_ms.write(out, "down_ms");
+		up_ms.write(out, "up_ms");
+	}
+
+	std::string path_;
+	std::string console_path_;
+	std::vector<uint8_t> ble_;
+	mouthpad::event_loop loop_;
+	std::unique_ptr<mouthpad::relay> relay_;
+	int console_fd_ = -1;
+
+	mouthware_message_RelayCapabilitiesResponse caps_ =
+		mouthware_message_RelayCapabilitiesResponse_init_zero;
+	bool has_caps_ = false;
+	mouthware_message_BleConnectionStatusResponse status_ =
+		mouthware_message_BleConnectionStatusResponse_init_zero;
+	uint32_t status_count_ = 0;
+
+	/* The running test's handlers */
+	std::function<void(const mouthware_message_RelayToAppMessage &)> on_message_;
+	std::function<void(const mouthpad::hid_mirror_report &)> on_hid_;
+};
+
+int main(int argc, char **argv)
+{
+	std::string path;
+	std::string console;
+	std::string output;
+	std::string only;
+	std::vector<uint8_t> ble;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			output = argv[++i];
+		} else if (strcmp(argv[i], "--ble") == 0 && i + 1 < argc) {
+			if (!parse_hex(argv[++i], ble)) {
+				fprintf(stderr, "--ble takes hex bytes\n");
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--console") == 0 && i + 1 < argc) {
+			console = argv[++i];
+		} else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) {
+			only = std::string(",") + argv[++i] + ",";
+		} else {
+			path = argv[i];
+		}
+	}
+
+	/* The console comes with the port when the relay is enumerated */
+	auto relays = mouthpad::enumerate();
+
+	for (const auto &r : relays) {
+		if (path.empty() || r.path == path) {
+			path = r.path;
+			if (console.empty()) {
+				console = r.console;
+			}
+			break;
+		}
+	}
+	if (path.empty()) {
+		fprintf(stderr, "No relay found (%04x:%04x)\n", mouthpad::relay_vendor_id,
+			mouthpad::relay_product_id);
+		return 1;
+	}
+
+	bench b(path, console, ble);
+	int err = b.open();
+
+	if (err) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(-err));
+		return 1;
+	}
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+	if (!b.start()) {
+		return 1;
+	}
+
+	json out;
+
+	out.open();
+	b.write_header(out);
+	out.open("tests");
+	b.run(only, out);
+	out.close();
+	out.boolean("complete", b.open_now());
+	out.close();
+
+	FILE *f = output.empty() ? stdout : fopen(output.c_str(), "w");
+
+	if (!f) {
+		fprintf(stderr, "%s: %s\n", output.c_str(), strerror(errno));
+		return 1;
+	}
+	fprintf(f, "%s\n", out.text().c_str());
+	if (f != stdout) {
+		fclose(f);
+	}
+	return b.open_now() ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Attaches to a running mouthpad_daemon and prints a line per device every
+ * second: notifications, bytes, the worst time an event took from being
+ * read by the daemon to reaching this process, and events this reader
+ * lost. Asks each relay for its BLE status through the daemon at start.
+ * Any number can run at once. Ctrl-C stops it.
+ *
+ *   mouthpad_client [--name /segment]
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "mouthpad/shm_ring.hpp"
+
+static volatile sig_atomic_t s_stop;
+
+static void on_signal(int)
+{
+	s_stop = 1;
+}
+
+/* The daemon stamps events with the same steady clock */
+static uint64_t now_us()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+struct tally {
+	uint32_t notifications;
+	uint64_t bytes;
+	uint64_t worst_wait_us;
+};
+
+int main(int argc, char **argv)
+{
+	mouthpad::shm_reader reader;
+	std::string name = mouthpad::default_shm_name;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+			name = argv[++i];
+		}
+	}
+
+	int err = reader.open(name);
+
+	if (err) {
+		fprintf(stderr, "%s: %s\n", name.c_str(), strerror(-err));
+		return 1;
+	}
+
+	std::vector<tally> tallies(reader.size());
+
+	for (uint32_t d = 0; d < reader.size(); d++) {
+		mouthware_message_AppToRelayMessage message =
+			mouthware_message_AppToRelayMessage_init_zero;
+
+		printf("%u: %s\n", d, reader.path(d).c_str());
+		message.destination =
+			mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+		message.which_message_body =
+			mouthware_message_AppToRelayMessage_ble_connection_status_read_tag;
+		reader.send(d, message);
+	}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	/* Too big for the stack alongside everything else on some targets */
+	auto event = std::make_unique<mouthpad::group_event>();
+	uint64_t next_report = now_us() + 1000000;
+
+	while (!s_stop && !reader.writer_closed()) {
+		reader.wait(100);
+		while (reader.next(*event)) {
+			const mouthpad::group_event &e = *event;
+
+			if (e.device >= tallies.size()) {
+				continue;
+			}
+
+			tally &t = tallies[e.device];
+			uint64_t waited = now_us() - e.time_us;
+
+			if (waited > t.worst_wait_us) {
+				t.worst_wait_us = waited;
+			}
+			switch (e.type) {
+			case mouthpad::group_event::pass_through:
+				t.notifications++;
+				t.bytes += e.len;
+				break;
+			case mouthpad::group_event::status:
+				printf("%u: status %d rssi %d devices %u\n", e.device,
+				       (int)e.body.status.connection_status, (int)e.body.status.rssi,
+				       (unsigned)e.body.status.connected_devices);
+				break;
+			case mouthpad::group_event::closed:
+				printf("%u: closed: %s\n", e.device, strerror(-e.body.err));
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (now_us() < next_report) {
+			continue;
+		}
+		next_report += 1000000;
+		for (uint32_t d = 0; d < tallies.size(); d++) {
+			tally &t = tallies[d];
+
+			printf("%u: %u notifications/s %llu B/s worst wait %lluus lost %llu\n", d,
+			       (unsigned)t.notifications, (unsigned long long)t.bytes,
+			       (unsigned long long)t.worst_wait_us,
+			       (unsigned long long)reader.lost());
+			t = tally{};
+		}
+	}
+
+	if (reader.writer_closed()) {
+		printf("daemon stopped\n");
+	}
+	return 0;
+}
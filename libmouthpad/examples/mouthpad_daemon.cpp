@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Owns every relay found (or the ports given) and publishes their events
+ * into a shared-memory segment (shm_ring.hpp) for any number of
+ * mouthpad_client-style readers. Commands the readers queue are sent on to
+ * the relays. --ws also serves them to browsers over a WebSocket on
+ * 127.0.0.1 (ws_gateway.hpp), which web/script.js connects to with its
+ * Gateway button; --origin lets a page served from elsewhere in, and
+ * --origin null one opened from file://. Prints a line every 10 seconds
+ * with events published, ring drops and gateway traffic. Ctrl-C stops it
+ * and closes the segment.
+ *
+ *   mouthpad_daemon [--batch] [--name /segment] [--slots n]
+ *                   [--ws [port]] [--origin url]... [port...]
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "mouthpad/shm_ring.hpp"
+#include "mouthpad/ws_gateway.hpp"
+
+/* Readers' commands wait at most this long for an event to wake the loop */
+#define COMMAND_POLL_MS 5
+
+static volatile sig_atomic_t s_stop;
+
+static void on_signal(int)
+{
+	s_stop = 1;
+}
+
+static uint64_t now_us()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+int main(int argc, char **argv)
+{
+	mouthpad::event_loop loop;
+	mouthpad::relay_group group;
+	mouthpad::shm_writer writer;
+	mouthpad::ws_gateway gateway(loop, group);
+	std::string name = mouthpad::default_shm_name;
+	size_t slots = 4096;
+	int ws_port = -1;
+	bool batch = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--batch") == 0) {
+			batch = true;
+		} else if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+			name = argv[++i];
+		} else if (strcmp(argv[i], "--slots") == 0 && i + 1 < argc) {
+			slots = strtoul(argv[++i], nullptr, 0);
+		} else if (strcmp(argv[i], "--ws") == 0) {
+			ws_port = mouthpad::ws_gateway::default_port;
+			if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+				ws_port = atoi(argv[++i]);
+			}
+		} else if (strcmp(argv[i], "--origin") == 0 && i + 1 < argc) {
+			gateway.allow_origin(argv[++i]);
+		} else {
+			int err = group.add(argv[i]);
+
+			if (err < 0) {
+				fprintf(stderr, "%s: %s\n", argv[i], strerror(-err));
+			}
+		}
+	}
+	if (group.size() == 0) {
+		group.add_all();
+	}
+	if (group.size() == 0) {
+		fprintf(stderr, "No relay opened\n");
+		return 1;
+	}
+
+	int err = writer.create(name, group, slots);
+
+	if (err) {
+		fprintf(stderr, "%s: %s\n", name.c_str(), strerror(-err));
+		return 1;
+	}
+	if (ws_port >= 0) {
+		err = gateway.listen((uint16_t)ws_port);
+		if (err) {
+			fprintf(stderr, "WebSocket port %d: %s\n", ws_port, strerror(-err));
+			return 1;
+		}
+	}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+	group.start();
+
+	for (uint32_t d = 0; d < group.size(); d++) {
+		printf("%u: %s\n", d, group.path(d).c_str());
+		group.set_batching(d, batch);
+		group.read_status(d);
+	}
+	printf("publishing on %s\n", name.c_str());
+	if (ws_port >= 0) {
+		printf("serving ws://127.0.0.1:%d\n", ws_port);
+	}
+
+	/* The gateway's sockets and the group's wakeups share one loop */
+	loop.add(group.fd(), mouthpad::event_loop::readable, [&](unsigned) {
+		group.wait(0);
+		group.poll([&](const mouthpad::group_event &e) {
+			writer.publish(e);
+			gateway.publish(e);
+			if (e.type == mouthpad::group_event::closed) {
+				printf("%u: closed: %s\n", e.device, strerror(-e.body.err));
+			}
+		});
+		gateway.flush();
+	});
+
+	uint64_t next_report = now_us() + 10000000;
+	uint64_t reported = 0;
+	uint64_t reported_records = 0;
+
+	while (!s_stop) {
+		loop.run_once(COMMAND_POLL_MS);
+		writer.take_commands(
+			[&](uint32_t device, const mouthware_message_AppToRelayMessage &message) {
+				group.send(device, message);
+			});
+
+		if (now_us() < next_report) {
+			continue;
+		}
+		next_report += 10000000;
+
+		uint64_t published = writer.published();
+		uint32_t dropped = 0;
+
+		for (uint32_t d = 0; d < group.size(); d++) {
+			dropped += group.stats(d).dropped;
+		}
+		mouthpad::ws_gateway_stats ws = gateway.stats();
+
+		printf("%llu events/10s, %u dropped in total", (unsigned long long)(published - reported),
+		       (unsigned)dropped);
+		if (ws_port >= 0) {
+			printf(" | ws %u clients %llu records/10s %llu lost", (unsigned)ws.clients,
+			       (unsigned long long)(ws.records - reported_records),
+			       (unsigned long long)ws.lost);
+		}
+		printf("\n");
+		reported = published;
+		reported_records = ws.records;
+	}
+
+	loop.remove(group.fd());
+	gateway.close();
+	group.stop();
+	writer.close();
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Writes MouthPad notifications out as Arrow tables (sensor_export.hpp).
+ * Each capture given becomes <capture>.sensor.arrows, .power.arrows and
+ * .other.arrows beside it, without its .mpcap extension. With --live it
+ * opens the first relay (or the port given) and exports what arrives
+ * under prefix until Ctrl-C.
+ *
+ *   mouthpad_export capture...
+ *   mouthpad_export --live prefix [port]
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "mouthpad/capture.hpp"
+#include "mouthpad/mouthpad.hpp"
+#include "mouthpad/sensor_export.hpp"
+
+static mouthpad::event_loop *s_loop;
+
+static void on_signal(int)
+{
+	s_loop->stop();
+}
+
+static uint64_t wall_us()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::system_clock::now().time_since_epoch())
+		.count();
+}
+
+static void print_rows(const std::string &prefix, const mouthpad::sensor_exporter &exporter)
+{
+	printf("%s: %llu sensor, %llu power, %llu other\n", prefix.c_str(),
+	       (unsigned long long)exporter.rows(mouthware_message_SensorStream_SENSOR_STREAM_SENSOR),
+	       (unsigned long long)exporter.rows(mouthware_message_SensorStream_SENSOR_STREAM_POWER),
+	       (unsigned long long)exporter.rows(mouthware_message_SensorStream_SENSOR_STREAM_OTHER));
+}
+
+static int export_capture(const std::string &path)
+{
+	mouthpad::capture_reader capture;
+	mouthpad::sensor_exporter exporter;
+	std::string prefix = path;
+	int err;
+
+	if (prefix.size() > 6 && prefix.compare(prefix.size() - 6, 6, ".mpcap") == 0) {
+		prefix.resize(prefix.size() - 6);
+	}
+
+	err = capture.open(path);
+	if (!err) {
+		err = exporter.open(prefix);
+	}
+	if (err) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(-err));
+		return 1;
+	}
+
+	exporter.add_capture(capture);
+	print_rows(prefix, exporter);
+	err = exporter.close();
+	if (err) {
+		fprintf(stderr, "%s: %s\n", prefix.c_str(), strerror(-err));
+		return 1;
+	}
+	return 0;
+}
+
+static int export_live(const std::string &prefix, std::string path)
+{
+	mouthpad::event_loop loop;
+	mouthpad::sensor_exporter exporter;
+
+	if (path.empty()) {
+		auto relays = mouthpad::enumerate();
+
+		if (relays.empty()) {
+			fprintf(stderr, "No relay found\n");
+			return 1;
+		}
+		path = relays.front().path;
+	}
+
+	mouthpad::relay::callbacks cb;
+
+	cb.on_pass_through = [&](const mouthpad::pass_through &p) {
+		exporter.add(wall_us(), p.device_index, p.data, p.len);
+	};
+	cb.on_closed = [&](int err) {
+		fprintf(stderr, "%s closed: %s\n", path.c_str(), strerror(-err));
+		loop.stop();
+	};
+
+	mouthpad::relay relay(loop, cb);
+	int err = relay.open(path);
+
+	if (!err) {
+		err = exporter.open(prefix);
+	}
+	if (err) {
+		fprintf(stderr, "%s: %s\n", exporter.is_open() ? prefix.c_str() : path.c_str(),
+			strerror(-err));
+		return 1;
+	}
+
+	s_loop = &loop;
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	relay.read_capabilities();
+	err = loop.run();
+
+	print_rows(prefix, exporter);
+	int close_err = exporter.close();
+
+	if (close_err) {
+		fprintf(stderr, "%s: %s\n", prefix.c_str(), strerror(-close_err));
+		return 1;
+	}
+	return err < 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<std::string> paths;
+	std::string live;
+	int failed = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--live") == 0 && i + 1 < argc) {
+			live = argv[++i];
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+	if (!live.empty()) {
+		return export_live(live, paths.empty() ? std::string() : paths.front());
+	}
+	if (paths.empty()) {
+		fprintf(stderr, "usage: %s capture...\n       %s --live prefix [port]\n", argv[0],
+			argv[0]);
+		return 2;
+	}
+
+	for (const auto &path : paths) {
+		failed |= export_capture(path);
+	}
+	return failed;
+}
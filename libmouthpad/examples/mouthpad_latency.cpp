@@ -0,0 +1,702 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Breaks the MouthPad's HID latency down hop by hop. The relay mirrors
+ * every HID report it forwards (HidMirrorBatch) with its BLE arrival and
+ * USB hand-off times; EchoRequests every 100 ms map the relay's clock onto
+ * steady_us() from the fastest round trip of the last few seconds; and the
+ * relay's HID interface is read as the OS delivers it, from evdev on Linux
+ * and IOHIDManager on macOS. Each input frame the OS delivers is matched
+ * to the last mirrored report handed to USB before it:
+ *
+ *   ble    half the acknowledged NUS write round trip of an echo through
+ *          the MouthPad (--ble only; reports carry no over-the-air time)
+ *   relay  BLE arrival until the relay handed the report to USB HID, for
+ *          every report, matched or not
+ *   usb    hand-off until the host kernel stamped the input event
+ *   os     kernel stamp until this process read it
+ *   echo   half the CDC0 echo round trip, as a cross-check on usb
+ *
+ * Runs for -t seconds (30 by default) or until Ctrl-C, then prints each
+ * hop's percentiles and histogram. --csv writes one row per matched report
+ * and per echo. Reading /dev/input needs the input group or root on Linux,
+ * and Input Monitoring permission on macOS.
+ *
+ *   mouthpad_latency [-t seconds] [--csv file] [--ble hex] [--input /dev/input/eventN]... [port]
+ *
+ * --ble takes bytes the MouthPad ignores, to write with each echo.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <IOKit/hid/IOHIDManager.h>
+#include <future>
+#include <mach/mach_time.h>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "mouthpad/mouthpad.hpp"
+
+/* Echo period, and how many echoes the clock offset is taken from */
+static constexpr uint64_t echo_interval_us = 100 * 1000;
+static constexpr size_t sync_window = 32;
+
+/* An input frame matches a report handed to USB at most this long before
+ * it, or this much after it to allow for clock offset error
+ */
+static constexpr int64_t match_window_us = 20 * 1000;
+static constexpr int64_t match_slack_us = 1000;
+
+/* Mirror batches trail the input they describe; frames are matched once
+ * they are this old
+ */
+static constexpr uint64_t match_delay_us = 250 * 1000;
+
+static mouthpad::event_loop *s_loop;
+
+static void on_signal(int)
+{
+	s_loop->stop();
+}
+
+/* One input report as the OS delivered it, in steady_us() */
+struct host_frame {
+	uint64_t kernel_us; /* Stamped by the kernel's HID input path */
+	uint64_t user_us;   /* Read by this process */
+};
+
+#if defined(__linux__)
+
+/* The relay's evdev nodes, read on the relay's event loop */
+class host_input {
+public:
+	~host_input()
+	{
+		for (int fd : fds_) {
+			loop_->remove(fd);
+			close(fd);
+		}
+	}
+
+	/* The nodes given, or every node with the relay's VID/PID */
+	int open(mouthpad::event_loop &loop, const std::vector<std::string> &paths)
+	{
+		std::vector<std::string> candidates = paths;
+		int err = 0;
+
+		loop_ = &loop;
+		if (candidates.empty()) {
+			DIR *dir = opendir("/dev/input");
+			struct dirent *entry;
+
+			if (!dir) {
+				return -errno;
+			}
+			while ((entry = readdir(dir))) {
+				if (strncmp(entry->d_name, "event", 5) == 0) {
+					candidates.push_back(std::string("/dev/input/") + entry->d_name);
+				}
+			}
+			closedir(dir);
+		}
+
+		for (const auto &path : candidates) {
+			int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+			struct input_id id;
+			int clock = CLOCK_MONOTONIC;
+
+			if (fd < 0) {
+				err = -errno;
+				continue;
+			}
+			if (paths.empty() &&
+			    (ioctl(fd, EVIOCGID, &id) < 0 || id.vendor != mouthpad::relay_vendor_id ||
+			     id.product != mouthpad::relay_product_id)) {
+				close(fd);
+				continue;
+			}
+			/* Event times on steady_clock's clock instead of wall time */
+			if (ioctl(fd, EVIOCSCLOCKID, &clock) < 0 ||
+			    loop.add(fd, mouthpad::event_loop::readable, [this, fd](unsigned) { read_all(fd); })) {
+				close(fd);
+				continue;
+			}
+			fds_.push_back(fd);
+			names_ += (names_.empty() ? "" : " ") + path;
+		}
+		return fds_.empty() ? (err ? err : -ENODEV) : 0;
+	}
+
+	void take(std::vector<host_frame> &out)
+	{
+		out.insert(out.end(), frames_.begin(), frames_.end());
+		frames_.clear();
+	}
+
+	const std::string &names() const { return names_; }
+
+private:
+	void read_all(int fd)
+	{
+		struct input_event events[64];
+		ssize_t n;
+
+		while ((n = read(fd, events, sizeof(events))) > 0) {
+			uint64_t now = mouthpad::steady_us();
+
+			for (size_t i = 0; i < (size_t)n / sizeof(events[0]); i++) {
+				const struct input_event &ev = events[i];
+
+				/* One SYN_REPORT closes each report's events */
+				if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+					frames_.push_back({(uint64_t)ev.input_event_sec * 1000000 +
+								   (uint64_t)ev.input_event_usec,
+							   now});
+				}
+			}
+		}
+	}
+
+	mouthpad::event_loop *loop_ = nullptr;
+	std::vector<int> fds_;
+	std::vector<host_frame> frames_;
+	std::string names_;
+};
+
+#elif defined(__APPLE__)
+
+/* The relay's HID interfaces through IOHIDManager, scheduled on a run loop
+ * thread of its own; frames are handed over under a lock
+ */
+class host_input {
+public:
+	~host_input()
+	{
+		if (thread_.joinable()) {
+			CFRunLoopStop(run_loop_);
+			thread_.join();
+		}
+		if (manager_) {
+			CFRelease(manager_);
+		}
+	}
+
+	int open(mouthpad::event_loop &, const std::vector<std::string> &paths)
+	{
+		if (!paths.empty()) {
+			fprintf(stderr, "--input is ignored on macOS\n");
+		}
+		mach_timebase_info(&timebase_);
+
+		manager_ = IOHIDManagerCreate(kCFAllocatorDefault, kIOHIDOptionsTypeNone);
+		if (!manager_) {
+			return -ENOMEM;
+		}
+
+		int vendor = mouthpad::relay_vendor_id;
+		int product = mouthpad::relay_product_id;
+		CFNumberRef vendor_ref = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &vendor);
+		CFNumberRef product_ref = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &product);
+		const void *keys[] = {CFSTR(kIOHIDVendorIDKey), CFSTR(kIOHIDProductIDKey)};
+		const void *values[] = {vendor_ref, product_ref};
+		CFDictionaryRef match = CFDictionaryCreate(kCFAllocatorDefault, keys, values, 2,
+							   &kCFTypeDictionaryKeyCallBacks,
+							   &kCFTypeDictionaryValueCallBacks);
+
+		IOHIDManagerSetDeviceMatching(manager_, match);
+		CFRelease(match);
+		CFRelease(vendor_ref);
+		CFRelease(product_ref);
+		IOHIDManagerRegisterInputReportWithTimeStampCallback(manager_, on_report, this);
+
+		/* Opened on the thread so the first reports are not missed */
+		std::promise<IOReturn> opened;
+		std::future<IOReturn> result_ready = opened.get_future();
+
+		thread_ = std::thread([this, &opened] {
+			run_loop_ = CFRunLoopGetCurrent();
+			IOHIDManagerScheduleWithRunLoop(manager_, run_loop_, kCFRunLoopDefaultMode);
+
+			IOReturn result = IOHIDManagerOpen(manager_, kIOHIDOptionsTypeNone);
+
+			opened.set_value(result);
+			if (result == kIOReturnSuccess) {
+				CFRunLoopRun();
+			}
+			IOHIDManagerUnscheduleFromRunLoop(manager_, run_loop_, kCFRunLoopDefaultMode);
+		});
+
+		IOReturn result = result_ready.get();
+
+		if (result != kIOReturnSuccess) {
+			thread_.join();
+			return result == kIOReturnNotPermitted ? -EACCES : -EIO;
+		}
+
+		CFSetRef devices = IOHIDManagerCopyDevices(manager_);
+		CFIndex count = devices ? CFSetGetCount(devices) : 0;
+
+		if (devices) {
+			CFRelease(devices);
+		}
+		names_ = std::to_string(count) + " IOHIDManager device(s)";
+		return count ? 0 : -ENODEV;
+	}
+
+	void take(std::vector<host_frame> &out)
+	{
+		std::lock_guard<std::mutex> hold(lock_);
+
+		out.insert(out.end(), frames_.begin(), frames_.end());
+		frames_.clear();
+	}
+
+	const std::string &names() const { return names_; }
+
+private:
+	static void on_report(void *context, IOReturn, void *, IOHIDReportType type, uint32_t,
+			      uint8_t *, CFIndex, uint64_t time_stamp)
+	{
+		host_input *self = static_cast<host_input *>(context);
+		uint64_t now = mouthpad::steady_us();
+
+		if (type != kIOHIDReportTypeInput) {
+			return;
+		}
+		/* Mach absolute time, the clock steady_clock counts on macOS */
+		uint64_t kernel_us = time_stamp * self->timebase_.numer / self->timebase_.denom / 1000;
+		std::lock_guard<std::mutex> hold(self->lock_);
+
+		self->frames_.push_back({kernel_us, now});
+	}
+
+	IOHIDManagerRef manager_ = nullptr;
+	CFRunLoopRef run_loop_ = nullptr;
+	std::thread thread_;
+	mach_timebase_info_data_t timebase_;
+	std::mutex lock_;
+	std::vector<host_frame> frames_;
+	std::string names_;
+};
+
+#endif
+
+/* Relay clock minus steady_us(), from the echo with the fastest round trip
+ * of the last sync_window
+ */
+class clock_sync {
+public:
+	/* @return The echo's one-way CDC0 time, half its round trip */
+	uint64_t add(const mouthware_message_EchoResponse &echo, uint64_t received_us)
+	{
+		uint64_t held = echo.relay_tx_us > echo.relay_rx_us ? echo.relay_tx_us - echo.relay_rx_us : 0;
+		uint64_t round_trip = received_us - echo.host_timestamp_us;
+
+		round_trip = round_trip > held ? round_trip - held : 0;
+		samples_.push_back({round_trip, ((int64_t)echo.relay_rx_us - (int64_t)echo.host_timestamp_us +
+						 (int64_t)echo.relay_tx_us - (int64_t)received_us) /
+							2});
+		if (samples_.size() > sync_window) {
+			samples_.pop_front();
+		}
+		best_ = *std::min_element(samples_.begin(), samples_.end(),
+					  [](const sample &a, const sample &b) {
+						  return a.round_trip_us < b.round_trip_us;
+					  });
+		count_++;
+		return round_trip / 2;
+	}
+
+	bool synced() const { return count_ > 0; }
+	uint32_t count() const { return count_; }
+	uint64_t round_trip_us() const { return best_.round_trip_us; }
+	int64_t offset_us() const { return best_.offset_us; }
+
+	/* A relay clock time in steady_us() */
+	int64_t to_host(uint64_t relay_us) const { return (int64_t)relay_us - best_.offset_us; }
+
+private:
+	struct sample {
+		uint64_t round_trip_us;
+		int64_t offset_us;
+	};
+
+	std::deque<sample> samples_;
+	sample best_ = {};
+	uint32_t count_ = 0;
+};
+
+class histogram {
+public:
+	void add(int64_t us) { samples_.push_back(us > 0 ? (uint64_t)us : 0); }
+
+	void print_summary(const char *name)
+	{
+		if (samples_.empty()) {
+			printf("%-6s %8s\n", name, "-");
+			return;
+		}
+		std::sort(samples_.begin(), samples_.end());
+		printf("%-6s %8zu %8llu %8llu %8llu %8llu\n", name, samples_.size(),
+		       (unsigned long long)percentile(50), (unsigned long long)percentile(90),
+		       (unsigned long long)percentile(99), (unsigned long long)samples_.back());
+	}
+
+	/* Power-of-two buckets from 125 us, one # per 2% of the samples */
+	void print_bars(const char *name) const
+	{
+		static const uint64_t bounds[] = {125, 250, 500, 1000, 2000, 4000, 8000, 16000, 32000};
+		size_t counts[sizeof(bounds) / sizeof(bounds[0]) + 1] = {};
+
+		if (samples_.empty()) {
+			return;
+		}
+		for (uint64_t us : samples_) {
+			size_t b = 0;
+
+			while (b < sizeof(bounds) / sizeof(bounds[0]) && us >= bounds[b]) {
+				b++;
+			}
+			counts[b]++;
+		}
+
+		printf("%s\n", name);
+		for (size_t b = 0; b < sizeof(counts) / sizeof(counts[0]); b++) {
+			char label[24];
+
+			if (b < sizeof(bounds) / sizeof(bounds[0])) {
+				snprintf(label, sizeof(label), "< %llu us", (unsigned long long)bounds[b]);
+			} else {
+				snprintf(label, sizeof(label), ">= %llu us", (unsigned long long)bounds[b - 1]);
+			}
+			printf("  %-12s %7zu %s\n", label, counts[b],
+			       std::string(counts[b] * 50 / samples_.size(), '#').c_str());
+		}
+	}
+
+private:
+	uint64_t percentile(unsigned p) const { return samples_[(samples_.size() - 1) * p / 100]; }
+
+	std::vector<uint64_t> samples_;
+};
+
+struct mirrored {
+	uint32_t sequence;
+	uint8_t report_id;
+	uint64_t ble_rx_us; /* Relay clock */
+	uint32_t relay_us;
+	bool submitted;
+	bool matched;
+};
+
+struct hop_histograms {
+	histogram ble, relay, usb, os, total, echo;
+};
+
+static bool parse_hex(const char *hex, std::vector<uint8_t> &out)
+{
+	size_t len = strlen(hex);
+
+	if (len == 0 || len % 2) {
+		return false;
+	}
+	for (size_t i = 0; i < len; i += 2) {
+		char byte[3] = {hex[i], hex[i + 1], 0};
+		char *end;
+
+		out.push_back((uint8_t)strtoul(byte, &end, 16));
+		if (*end) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Match the host frames older than cutoff_us to the mirrored reports and
+ * drop reports too old to match anything still to come
+ */
+static void correlate(std::vector<host_frame> &frames, std::deque<mirrored> &reports,
+		      const clock_sync &sync, uint64_t cutoff_us, hop_histograms &hops, FILE *csv,
+		      uint32_t &unmatched_frames, uint32_t &unmatched_reports)
+{
+	size_t done = 0;
+
+	/* Frames from several evdev nodes arrive node by node */
+	std::sort(frames.begin(), frames.end(),
+		  [](const host_frame &a, const host_frame &b) { return a.kernel_us < b.kernel_us; });
+	for (; done < frames.size() && frames[done].kernel_us < cutoff_us; done++) {
+		const host_frame &f = frames[done];
+		mirrored *best = nullptr;
+		int64_t best_submit = 0;
+
+		for (auto &r : reports) {
+			int64_t submit = sync.to_host(r.ble_rx_us + r.relay_us);
+
+			if (submit > (int64_t)f.kernel_us + match_slack_us) {
+				break;
+			}
+			if (r.submitted && !r.matched && (int64_t)f.kernel_us - submit <= match_window_us) {
+				best = &r;
+				best_submit = submit;
+			}
+		}
+		if (!best) {
+			unmatched_frames++;
+			continue;
+		}
+
+		int64_t usb = (int64_t)f.kernel_us - best_submit;
+		int64_t os = (int64_t)(f.user_us - f.kernel_us);
+
+		best->matched = true;
+		hops.usb.add(usb);
+		hops.os.add(os);
+		hops.total.add(best->relay_us + usb + os);
+		if (csv) {
+			fprintf(csv, "report,%u,%u,%llu,,%u,%lld,%lld,%lld,\n", (unsigned)best->sequence,
+				(unsigned)best->report_id, (unsigned long long)best->ble_rx_us,
+				(unsigned)best->relay_us, (long long)usb, (long long)os,
+				(long long)(best->relay_us + usb + os));
+		}
+	}
+	frames.erase(frames.begin(), frames.begin() + done);
+
+	while (!reports.empty() &&
+	       sync.to_host(reports.front().ble_rx_us + reports.front().relay_us) + match_window_us <
+		       (int64_t)cutoff_us) {
+		if (reports.front().submitted && !reports.front().matched) {
+			unmatched_reports++;
+		}
+		reports.pop_front();
+	}
+}
+
+int main(int argc, char **argv)
+{
+	mouthpad::event_loop loop;
+	host_input input;
+	clock_sync sync;
+	hop_histograms hops;
+	std::deque<mirrored> reports;
+	std::vector<host_frame> frames;
+	std::vector<std::string> input_paths;
+	std::vector<uint8_t> ble_payload;
+	std::string path;
+	std::string csv_path;
+	FILE *csv = nullptr;
+	unsigned seconds = 30;
+	uint32_t echo_sequence = 0;
+	uint32_t next_sequence = 0;
+	uint32_t mirrored_count = 0;
+	uint32_t not_submitted = 0;
+	uint32_t lost = 0;
+	uint32_t frame_count = 0;
+	uint32_t unmatched_frames = 0;
+	uint32_t unmatched_reports = 0;
+	uint32_t ble_failed = 0;
+	bool mirroring = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+			seconds = (unsigned)atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+			csv_path = argv[++i];
+		} else if (strcmp(argv[i], "--ble") == 0 && i + 1 < argc) {
+			if (!parse_hex(argv[++i], ble_payload)) {
+				fprintf(stderr, "--ble takes hex bytes\n");
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+			input_paths.push_back(argv[++i]);
+		} else {
+			path = argv[i];
+		}
+	}
+
+	if (path.empty()) {
+		auto relays = mouthpad::enumerate();
+
+		if (relays.empty()) {
+			fprintf(stderr, "No relay found (%04x:%04x)\n", mouthpad::relay_vendor_id,
+				mouthpad::relay_product_id);
+			return 1;
+		}
+		path = relays.front().path;
+	}
+
+	mouthpad::relay::callbacks cb;
+
+	cb.on_message = [&](const mouthware_message_RelayToAppMessage &m) {
+		if (m.which_message_body != mouthware_message_RelayToAppMessage_echo_response_tag) {
+			return;
+		}
+		const mouthware_message_EchoResponse &echo = m.message_body.echo_response;
+		uint64_t one_way = sync.add(echo, mouthpad::steady_us());
+		uint64_t ble = 0;
+
+		hops.echo.add(one_way);
+		if (echo.via_mouthpad) {
+			if (echo.mouthpad_ack_us > echo.mouthpad_write_us && echo.mouthpad_write_us) {
+				ble = (echo.mouthpad_ack_us - echo.mouthpad_write_us) / 2;
+				hops.ble.add(ble);
+			} else {
+				ble_failed++;
+			}
+		}
+		if (csv) {
+			fprintf(csv, "echo,%u,,%llu,", (unsigned)echo.sequence,
+				(unsigned long long)echo.relay_rx_us);
+			if (ble) {
+				fprintf(csv, "%llu", (unsigned long long)ble);
+			}
+			fprintf(csv, ",,,,,%llu\n", (unsigned long long)one_way);
+		}
+	};
+	cb.on_hid_mirror = [&](const mouthpad::hid_mirror_report &r) {
+		if (mirrored_count && r.sequence != next_sequence) {
+			lost += r.sequence - next_sequence;
+		}
+		next_sequence = r.sequence + 1;
+		mirrored_count++;
+		if (r.submitted) {
+			hops.relay.add(r.usb_submit_delay_us);
+		} else {
+			not_submitted++;
+		}
+		reports.push_back({r.sequence, r.report_id, r.ble_rx_us, r.usb_submit_delay_us,
+				   r.submitted, false});
+	};
+	cb.on_closed = [&](int err) {
+		fprintf(stderr, "%s closed: %s\n", path.c_str(), strerror(-err));
+		loop.stop();
+	};
+
+	mouthpad::relay relay(loop, cb);
+	int err = relay.open(path);
+
+	if (err) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(-err));
+		return 1;
+	}
+
+	err = input.open(loop, input_paths);
+	if (err) {
+		fprintf(stderr, "No host HID input (%s): usb and os hops are not measured\n",
+			strerror(-err));
+	} else {
+		printf("host input: %s\n", input.names().c_str());
+	}
+
+	if (!csv_path.empty()) {
+		csv = fopen(csv_path.c_str(), "w");
+		if (!csv) {
+			fprintf(stderr, "%s: %s\n", csv_path.c_str(), strerror(errno));
+			return 1;
+		}
+		fprintf(csv, "kind,sequence,report_id,relay_time_us,ble_us,relay_us,usb_us,os_us,"
+			     "total_us,echo_us\n");
+	}
+
+	s_loop = &loop;
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	uint64_t start = mouthpad::steady_us();
+	uint64_t next_echo = start;
+
+	printf("%s: measuring for %u s, move the MouthPad\n", path.c_str(), seconds);
+	while (relay.is_open()) {
+		uint64_t now = mouthpad::steady_us();
+
+		if (now - start >= (uint64_t)seconds * 1000000) {
+			break;
+		}
+		if (now >= next_echo) {
+			relay.send_echo(echo_sequence++, ble_payload.data(), ble_payload.size());
+			next_echo = now + echo_interval_us;
+		}
+		/* Reports are only placed on the host clock once it is known */
+		if (!mirroring && sync.synced()) {
+			relay.set_hid_mirror(true);
+			mirroring = true;
+		}
+
+		if (loop.run_once(10) < 0) {
+			break;
+		}
+
+		size_t before = frames.size();
+
+		input.take(frames);
+		if (!mirroring) {
+			frames.clear();
+		}
+		frame_count += frames.size() - before;
+		correlate(frames, reports, sync, mouthpad::steady_us() - match_delay_us, hops, csv,
+			  unmatched_frames, unmatched_reports);
+	}
+
+	if (relay.is_open() && mirroring) {
+		relay.set_hid_mirror(false);
+		/* Let the last batch arrive */
+		for (uint64_t until = mouthpad::steady_us() + match_delay_us; mouthpad::steady_us() < until;) {
+			loop.run_once(10);
+		}
+	}
+	input.take(frames);
+	correlate(frames, reports, sync, UINT64_MAX / 2, hops, csv, unmatched_frames,
+		  unmatched_reports);
+	if (csv) {
+		fclose(csv);
+	}
+
+	printf("clock sync: %u echoes, best round trip %llu us, relay - host %lld us\n",
+	       (unsigned)sync.count(), (unsigned long long)sync.round_trip_us(),
+	       (long long)sync.offset_us());
+	printf("mirror: %u reports (%u not submitted, %u lost); host: %u frames, %u unmatched; "
+	       "%u submitted reports with no host frame\n",
+	       (unsigned)mirrored_count, (unsigned)not_submitted, (unsigned)lost, (unsigned)frame_count,
+	       (unsigned)unmatched_frames, (unsigned)unmatched_reports);
+	if (ble_failed) {
+		printf("ble: %u echoes through the MouthPad got no acknowledgement\n", (unsigned)ble_failed);
+	}
+
+	printf("\n%-6s %8s %8s %8s %8s %8s  (us)\n", "hop", "n", "p50", "p90", "p99", "max");
+	hops.ble.print_summary("ble");
+	hops.relay.print_summary("relay");
+	hops.usb.print_summary("usb");
+	hops.os.print_summary("os");
+	hops.total.print_summary("total");
+	hops.echo.print_summary("echo");
+
+	printf("\n");
+	hops.ble.print_bars("ble");
+	hops.relay.print_bars("relay");
+	hops.usb.print_bars("usb");
+	hops.os.print_bars("os");
+	hops.total.print_bars("total");
+	hops.echo.print_bars("echo");
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Opens the first relay (or the port given), prints its BLE status once and
+ * then one line per LinkTelemetry sample with the pass-through rate seen on
+ * the host side. Ctrl-C stops it. --capture records the session for
+ * mouthpad_replay and relay_bench.
+ *
+ *   mouthpad_monitor [--batch] [--capture file] [port]
+ */
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+#include "mouthpad/capture.hpp"
+#include "mouthpad/mouthpad.hpp"
+
+static mouthpad::event_loop *s_loop;
+
+static void on_signal(int)
+{
+	s_loop->stop();
+}
+
+int main(int argc, char **argv)
+{
+	mouthpad::event_loop loop;
+	mouthpad::capture_writer capture;
+	std::string path;
+	std::string capture_path;
+	bool batch = false;
+	uint32_t notifications = 0;
+	uint64_t bytes = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--batch") == 0) {
+			batch = true;
+		} else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+			capture_path = argv[++i];
+		} else {
+			path = argv[i];
+		}
+	}
+
+	if (path.empty()) {
+		auto relays = mouthpad::enumerate();
+
+		if (relays.empty()) {
+			fprintf(stderr, "No relay found (%04x:%04x)\n", mouthpad::relay_vendor_id,
+				mouthpad::relay_product_id);
+			return 1;
+		}
+		for (const auto &r : relays) {
+			printf("%s serial %s\n", r.path.c_str(), r.serial.c_str());
+		}
+		path = relays.front().path;
+	}
+
+	mouthpad::relay::callbacks cb;
+
+	cb.on_pass_through = [&](const mouthpad::pass_through &p) {
+		notifications++;
+		bytes += p.len;
+	};
+	cb.on_status = [](const mouthware_message_BleConnectionStatusResponse &s) {
+		printf("status %d rssi %d battery %u%% phy %u/%u devices %u\n", (int)s.connection_status,
+		       (int)s.rssi, (unsigned)s.battery_level, (unsigned)s.tx_phy, (unsigned)s.rx_phy,
+		       (unsigned)s.connected_devices);
+	};
+	cb.on_telemetry = [&](const mouthware_message_LinkTelemetry &t) {
+		printf("#%u %s rssi %d interval %uus hid %u/s | pass-through %u (%llu B) | dropped "
+		       "rx %u tx %u\n",
+		       (unsigned)t.sequence, t.connected ? "up" : "down", (int)t.rssi,
+		       (unsigned)t.conn_interval_us, (unsigned)t.hid_reports_per_s, (unsigned)notifications,
+		       (unsigned long long)bytes, (unsigned)t.nus_rx_dropped, (unsigned)t.nus_tx_dropped);
+		notifications = 0;
+		bytes = 0;
+	};
+	cb.on_closed = [&](int err) {
+		fprintf(stderr, "%s closed: %s\n", path.c_str(), strerror(-err));
+		loop.stop();
+	};
+
+	mouthpad::relay relay(loop, cb);
+	int err = relay.open(path);
+
+	if (err) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(-err));
+		return 1;
+	}
+
+	if (!capture_path.empty()) {
+		err = capture.open(capture_path);
+		if (err) {
+			fprintf(stderr, "%s: %s\n", capture_path.c_str(), strerror(-err));
+			return 1;
+		}
+		relay.set_capture(&capture);
+	}
+
+	s_loop = &loop;
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	relay.read_capabilities();
+	relay.read_status();
+	relay.set_batching(batch);
+	relay.subscribe_telemetry(1000, false);
+
+	err = loop.run();
+
+	if (relay.is_open()) {
+		relay.subscribe_telemetry(0, false);
+	}
+
+	const auto &s = relay.stats();
+
+	printf("frames %u crc errors %u length errors %u decode errors %u decoded %u tx %llu B\n",
+	       (unsigned)s.frames, (unsigned)s.crc_errors, (unsigned)s.length_errors,
+	       (unsigned)s.decode_errors, (unsigned)s.decoded, (unsigned long long)s.tx_bytes);
+	if (capture.is_open()) {
+		relay.set_capture(nullptr);
+		printf("%s: %u records, %llu B\n", capture_path.c_str(), (unsigned)capture.records(),
+		       (unsigned long long)capture.bytes());
+		capture.close();
+	}
+	return err < 0 ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Robert Dale Smith
+# Copyright (c) 2025 Augmental Tech
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Counts MouthPad notifications from a relay for a while and prints the
+# rate, bytes and the longest gap between two of them, the way a test
+# script would before asserting on them. Needs the module built with
+# -DLIBMOUTHPAD_PYTHON=ON and its directory on PYTHONPATH:
+#
+#   PYTHONPATH=build/libmouthpad libmouthpad/examples/mouthpad_rate.py [-t seconds] [port]
+#
+
+import argparse
+import sys
+import time
+
+import mouthpad
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-t", "--seconds", type=float, default=10.0)
+    parser.add_argument("--batch", action="store_true", help="ask the relay to batch")
+    parser.add_argument("port", nargs="?")
+    args = parser.parse_args()
+
+    port = args.port
+    if port is None:
+        relays = mouthpad.enumerate()
+        if not relays:
+            sys.exit("No relay found")
+        port = relays[0].path
+
+    notifications = 0
+    payload_bytes = 0
+    worst_gap_ns = 0
+    last_ns = None
+
+    with mouthpad.Relay(port) as relay:
+        relay.set_batching(args.batch)
+        end = time.monotonic_ns() + int(args.seconds * 1e9)
+
+        while time.monotonic_ns() < end:
+            batch = relay.poll(100)
+            if batch.closed:
+                sys.exit(f"{port} closed")
+
+            # Columns are memoryviews over the batch; no per-event objects
+            kinds = batch.kinds
+            times = batch.times_ns
+            lengths = batch.lengths
+            for i in range(len(batch)):
+                if kinds[i] != mouthpad.PASS_THROUGH:
+                    continue
+                if last_ns is not None:
+                    worst_gap_ns = max(worst_gap_ns, times[i] - last_ns)
+                last_ns = times[i]
+                notifications += 1
+                payload_bytes += lengths[i]
+
+        print(f"{port}: {notifications / args.seconds:.1f} notifications/s, "
+              f"{payload_bytes / args.seconds:.0f} B/s, longest gap {worst_gap_ns / 1e6:.2f} ms")
+        print(relay.stats)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Plays the host side of a capture back into a relay at its recorded pace:
+ * control records are sent as they were encoded, NUS writes through
+ * send_pass_through(). Relay->host records are only counted. At the end it
+ * prints what went out, what came back and the relay's own counters.
+ *
+ *   mouthpad_replay [--speed factor] capture [port]
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "mouthpad/capture.hpp"
+#include "mouthpad/mouthpad.hpp"
+
+static uint64_t now_us()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+int main(int argc, char **argv)
+{
+	mouthpad::event_loop loop;
+	mouthpad::capture_reader capture;
+	mouthpad_capture_record record;
+	std::string capture_path;
+	std::string path;
+	double speed = 1.0;
+	uint32_t sent = 0;
+	uint32_t skipped = 0;
+	uint32_t received = 0;
+	bool closed = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = atof(argv[++i]);
+		} else if (capture_path.empty()) {
+			capture_path = argv[i];
+		} else {
+			path = argv[i];
+		}
+	}
+	if (capture_path.empty() || speed <= 0) {
+		fprintf(stderr, "usage: %s [--speed factor] capture [port]\n", argv[0]);
+		return 2;
+	}
+
+	int err = capture.open(capture_path);
+
+	if (err) {
+		fprintf(stderr, "%s: %s\n", capture_path.c_str(), strerror(-err));
+		return 1;
+	}
+
+	if (path.empty()) {
+		auto relays = mouthpad::enumerate();
+
+		if (relays.empty()) {
+			fprintf(stderr, "No relay found\n");
+			return 1;
+		}
+		path = relays.front().path;
+	}
+
+	mouthpad::relay::callbacks cb;
+
+	cb.on_pass_through = [&](const mouthpad::pass_through &) { received++; };
+	cb.on_closed = [&](int) { closed = true; };
+
+	mouthpad::relay relay(loop, cb);
+
+	err = relay.open(path);
+	if (err) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(-err));
+		return 1;
+	}
+
+	uint64_t start = now_us();
+	uint64_t last_due = 0;
+
+	while (!closed && capture.next(record)) {
+		if (record.direction != MOUTHPAD_CAPTURE_TO_DEVICE) {
+			skipped++;
+			continue;
+		}
+
+		uint64_t due = start + (uint64_t)(record.time_us / speed);
+
+		/* Service the port while waiting for the record's time */
+		for (uint64_t now = now_us(); now < due && !closed; now = now_us()) {
+			loop.run_once((int)((due - now + 999) / 1000));
+		}
+		last_due = due;
+
+		do {
+			err = record.channel == MOUTHPAD_CAPTURE_NUS
+				      ? relay.send_pass_through(record.data, record.len)
+				      : relay.send_payload(record.data, record.len);
+			if (err == -ENOBUFS) {
+				loop.run_once(10);
+			}
+		} while (err == -ENOBUFS && !closed);
+		if (!err) {
+			sent++;
+		}
+	}
+
+	/* Let the last answers come back */
+	for (uint64_t end = now_us() + 500000; !closed && now_us() < end;) {
+		loop.run_once(100);
+	}
+
+	const auto &s = relay.stats();
+
+	printf("%s: sent %u, skipped %u relay->host records, over %.1f s\n", capture_path.c_str(),
+	       sent, skipped, (double)(last_due - start) / 1e6);
+	printf("received %u notifications, %u frames, %u crc errors, %u decode errors\n", received,
+	       (unsigned)s.frames, (unsigned)s.crc_errors, (unsigned)s.decode_errors);
+	return closed ? 1 : 0;
+}
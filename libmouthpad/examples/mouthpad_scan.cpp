@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Offline look at a large capture without reading all of it.
+ *
+ * A session capture (mouthpad_capture.h) gets a time index beside it,
+ * "<capture>.idx", built on first use and reused while the capture is
+ * unchanged; --at prints the records from that time on. Anything else is
+ * taken as raw CDC0 bytes, e.g. as relay_bench replays, and scanned for
+ * frames, printing the counts, the scan rate and, with -n, the first frames.
+ *
+ *   mouthpad_scan [--at seconds] [-n count] capture
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mouthpad/capture.hpp"
+#include "mouthpad/frame_scan.hpp"
+
+static double now_s()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+static void print_bytes(const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len && i < 16; i++) {
+		printf(" %02x", data[i]);
+	}
+	printf(len > 16 ? " ...\n" : "\n");
+}
+
+static int scan_session(mouthpad::capture_reader &capture, const std::string &path, double at,
+			long count)
+{
+	static const char *const channels[] = {"control", "nus", "hid", "clock"};
+	mouthpad::capture_index index;
+	mouthpad_capture_record record;
+	std::string index_path = path + ".idx";
+	double t0 = now_s();
+	int err;
+
+	err = index.load(index_path, capture);
+	if (err) {
+		index.build(capture);
+		err = index.save(index_path);
+		printf("%s: indexed in %.2f s\n", index_path.c_str(), now_s() - t0);
+		if (err) {
+			fprintf(stderr, "%s: %s\n", index_path.c_str(), strerror(-err));
+		}
+	}
+	printf("%s: %.1f MB, %.1f s, %zu index entries\n", path.c_str(),
+	       (double)capture.size() / 1e6, (double)index.duration_us() / 1e6,
+	       index.entries().size());
+
+	if (at < 0) {
+		return 0;
+	}
+
+	t0 = now_s();
+	capture.seek(index, (uint64_t)(at * 1e6));
+	printf("seek to %.3f s in %.1f us\n", at, (now_s() - t0) * 1e6);
+	for (long i = 0; i < count && capture.next(record); i++) {
+		printf("%12.6f %-7s %s %5u:", (double)record.time_us / 1e6,
+		       channels[record.channel & 3],
+		       record.direction == MOUTHPAD_CAPTURE_TO_DEVICE ? "->" : "<-", record.len);
+		print_bytes(record.data, record.len);
+	}
+	return 0;
+}
+
+static int scan_raw(const std::string &path, long count)
+{
+	struct stat st;
+	void *map;
+	int fd;
+
+	fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0 || fstat(fd, &st) < 0) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+		return 1;
+	}
+	if (st.st_size == 0) {
+		printf("%s: empty\n", path.c_str());
+		close(fd);
+		return 0;
+	}
+	map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+		return 1;
+	}
+	madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+	const uint8_t *data = static_cast<const uint8_t *>(map);
+	uint64_t payload = 0;
+	long shown = 0;
+	double t0 = now_s();
+
+	auto stats = mouthpad::scan_frames(
+		data, (size_t)st.st_size,
+		[&](const mouthpad::scanned_frame *frames, size_t n) {
+			for (size_t i = 0; i < n; i++) {
+				payload += frames[i].len;
+				if (shown < count) {
+					printf("%10zu %4u:", frames[i].offset, frames[i].len);
+					print_bytes(frames[i].payload, frames[i].len);
+					shown++;
+				}
+			}
+		});
+	double elapsed = now_s() - t0;
+
+	printf("%s: %.1f MB raw, %llu frames, %llu payload bytes\n", path.c_str(),
+	       (double)st.st_size / 1e6, (unsigned long long)stats.frames,
+	       (unsigned long long)payload);
+	printf("%llu crc errors, %llu length errors, %llu bytes outside frames\n",
+	       (unsigned long long)stats.crc_errors, (unsigned long long)stats.length_errors,
+	       (unsigned long long)stats.skipped);
+	printf("scanned in %.3f s, %.0f MB/s (%s)\n", elapsed,
+	       elapsed > 0 ? (double)st.st_size / 1e6 / elapsed : 0.0, mouthpad::frame_scan_isa());
+	munmap(map, (size_t)st.st_size);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	mouthpad::capture_reader capture;
+	std::string path;
+	double at = -1;
+	long count = -1;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+			at = atof(argv[++i]);
+		} else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			count = atol(argv[++i]);
+		} else {
+			path = argv[i];
+		}
+	}
+	if (path.empty()) {
+		fprintf(stderr, "usage: %s [--at seconds] [-n count] capture\n", argv[0]);
+		return 2;
+	}
+
+	int err = capture.open(path);
+
+	if (err == -EINVAL) {
+		return scan_raw(path, count < 0 ? 0 : count);
+	}
+	if (err) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(-err));
+		return 1;
+	}
+	return scan_session(capture, path, at, count < 0 ? 10 : count);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Opens every relay found (or the ports given) on one relay_group and prints
+ * a line per device every second: notifications, bytes, the worst time an
+ * event waited between being read and reaching this thread, and ring drops.
+ * Ctrl-C stops it.
+ *
+ *   mouthpad_station [--batch] [port...]
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+#include "mouthpad/relay_group.hpp"
+
+static volatile sig_atomic_t s_stop;
+
+static void on_signal(int)
+{
+	s_stop = 1;
+}
+
+static uint64_t now_us()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+struct tally {
+	uint32_t notifications;
+	uint64_t bytes;
+	uint64_t worst_wait_us;
+	bool closed;
+};
+
+int main(int argc, char **argv)
+{
+	mouthpad::relay_group group;
+	bool batch = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--batch") == 0) {
+			batch = true;
+		} else {
+			int err = group.add(argv[i]);
+
+			if (err < 0) {
+				fprintf(stderr, "%s: %s\n", argv[i], strerror(-err));
+			}
+		}
+	}
+	if (group.size() == 0) {
+		group.add_all();
+	}
+	if (group.size() == 0) {
+		fprintf(stderr, "No relay opened\n");
+		return 1;
+	}
+
+	std::vector<tally> tallies(group.size());
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+	group.start();
+
+	for (uint32_t d = 0; d < group.size(); d++) {
+		printf("%u: %s\n", d, group.path(d).c_str());
+		group.set_batching(d, batch);
+		group.read_status(d);
+	}
+
+	uint64_t next_report = now_us() + 1000000;
+
+	while (!s_stop) {
+		group.wait(100);
+		group.poll([&](const mouthpad::group_event &e) {
+			tally &t = tallies[e.device];
+			uint64_t waited = now_us() - e.time_us;
+
+			if (waited > t.worst_wait_us) {
+				t.worst_wait_us = waited;
+			}
+			switch (e.type) {
+			case mouthpad::group_event::pass_through:
+				t.notifications++;
+				t.bytes += e.len;
+				break;
+			case mouthpad::group_event::status:
+				printf("%u: status %d rssi %d devices %u\n", e.device,
+				       (int)e.body.status.connection_status, (int)e.body.status.rssi,
+				       (unsigned)e.body.status.connected_devices);
+				break;
+			case mouthpad::group_event::closed:
+				printf("%u: closed: %s\n", e.device, strerror(-e.body.err));
+				t.closed = true;
+				break;
+			default:
+				break;
+			}
+		});
+
+		if (now_us() < next_report) {
+			continue;
+		}
+		next_report += 1000000;
+		for (uint32_t d = 0; d < group.size(); d++) {
+			tally &t = tallies[d];
+			mouthpad::group_device_stats s = group.stats(d);
+
+			if (t.closed) {
+				continue;
+			}
+			printf("%u: %u notifications/s %llu B/s worst wait %lluus dropped %u\n", d,
+			       (unsigned)t.notifications, (unsigned long long)t.bytes,
+			       (unsigned long long)t.worst_wait_us, (unsigned)s.dropped);
+			t = tally{};
+		}
+	}
+
+	group.stop();
+	return 0;
+}
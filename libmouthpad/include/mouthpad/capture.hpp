@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Recording and reading session captures (common/mouthpad_capture.h)
+ *
+ * A capture_writer given to relay::set_capture() records everything the
+ * relay sends and receives: MouthPad notifications and writes on the NUS
+ * channel, HID reports taken out of HidMirrorBatch messages on the HID
+ * channel, and every other message on the control channel. Records are
+ * appended to a memory buffer and written out in large blocks, so the
+ * cost per record is one memcpy.
+ *
+ * A capture_reader maps a capture and walks it in place; replaying one
+ * only touches the pages being read. With a capture_index built once and
+ * kept next to the capture, it seeks to any time in a multi-hour capture
+ * with a binary search and a walk over at most a few hundred records.
+ */
+
+#ifndef MOUTHPAD_CAPTURE_HPP_
+#define MOUTHPAD_CAPTURE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mouthpad_capture.h"
+
+namespace mouthpad {
+
+class capture_writer {
+public:
+	/* Buffered bytes; written out when half full */
+	static constexpr size_t buffer_size = 256 * 1024;
+
+	capture_writer();
+	~capture_writer();
+
+	capture_writer(const capture_writer &) = delete;
+	capture_writer &operator=(const capture_writer &) = delete;
+
+	/* Create or truncate path and start a session now */
+	int open(const std::string &path);
+
+	/* Write what is buffered and close; returns the first write error */
+	int close();
+
+	bool is_open() const { return fd_ >= 0; }
+
+	/* Microseconds since open() on the steady clock */
+	uint64_t now_us() const;
+
+	void record(mouthpad_capture_channel channel, mouthpad_capture_direction direction,
+		    const uint8_t *data, size_t len)
+	{
+		record_at(now_us(), channel, direction, data, len);
+	}
+
+	/* For records whose time is known better than now, e.g. HID reports */
+	void record_at(uint64_t time_us, mouthpad_capture_channel channel,
+		       mouthpad_capture_direction direction, const uint8_t *data, size_t len);
+
+	int flush();
+
+	uint32_t records() const { return records_; }
+	uint64_t bytes() const { return bytes_; }
+
+private:
+	int fd_ = -1;
+	int err_ = 0;
+	uint64_t start_ = 0;
+	struct mouthpad_capture_writer writer_;
+	std::vector<uint8_t> buf_;
+	size_t used_ = 0;
+	uint32_t records_ = 0;
+	uint64_t bytes_ = 0;
+};
+
+class capture_index;
+
+class capture_reader {
+public:
+	capture_reader() = default;
+	~capture_reader();
+
+	capture_reader(const capture_reader &) = delete;
+	capture_reader &operator=(const capture_reader &) = delete;
+
+	/* Map path; -EINVAL if it is not a capture */
+	int open(const std::string &path);
+	void close();
+
+	/* Records in order; data points into the mapping */
+	bool next(mouthpad_capture_record &record)
+	{
+		return mouthpad_capture_next(&reader_, &record);
+	}
+
+	/* Back to the first record */
+	void rewind();
+
+	/* To the first record at or after time_us since the session start */
+	void seek(const capture_index &index, uint64_t time_us);
+
+	/* Wall-clock session start, microseconds since the Unix epoch */
+	uint64_t start_us() const { return reader_.start_us; }
+
+	size_t size() const { return size_; }
+
+	const uint8_t *data() const { return map_; }
+
+private:
+	const uint8_t *map_ = nullptr;
+	size_t size_ = 0;
+	struct mouthpad_capture_reader reader_ = {};
+};
+
+/*
+ * Time index of a capture, saved beside it as "<capture>.idx". It holds
+ * where a record starts every interval_us of session time, and every
+ * records_max records when traffic is heavy. Little-endian:
+ *
+ *    0  "MPIDX" 0
+ *    6  version u8, reserved u8
+ *    8  capture_size u64   Of the capture it was built from
+ *   16  start_us u64       Ditto; either differing makes the index stale
+ *   24  count u64
+ *   32  count entries of time_us u64, offset u64
+ *
+ * An entry's time is the session time before the record at its offset,
+ * which may be a CLOCK record.
+ */
+class capture_index {
+public:
+	static constexpr uint8_t version = 1;
+	static constexpr uint64_t interval_us = 100 * 1000;
+	static constexpr uint32_t records_max = 1024;
+
+	struct entry {
+		uint64_t time_us;
+		uint64_t offset;
+	};
+
+	/* Walk the capture once; the reader's position is left alone */
+	void build(const capture_reader &capture);
+
+	int save(const std::string &path) const;
+
+	/* -EINVAL if path is not an index, -ESTALE if it is for another capture */
+	int load(const std::string &path, const capture_reader &capture);
+
+	const std::vector<entry> &entries() const { return entries_; }
+
+	/* Time of the last record */
+	uint64_t duration_us() const { return duration_us_; }
+
+private:
+	std::vector<entry> entries_;
+	uint64_t capture_size_ = 0;
+	uint64_t start_us_ = 0;
+	uint64_t duration_us_ = 0;
+};
+
+} /* namespace mouthpad */
+
+#endif /* MOUTHPAD_CAPTURE_HPP_ */
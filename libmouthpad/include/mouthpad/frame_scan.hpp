@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Offline scan of raw CDC0 byte captures for AA 55 frames
+ *
+ * The streaming deframer (mouthpad_frame.h) takes a byte at a time, which
+ * is right for a port and slow for hours of captured traffic. scan_frames()
+ * works on the whole capture in memory, usually a mapping: the magic is
+ * looked for 16 or 32 bytes at a time with SSE2, AVX2 or NEON compares,
+ * and runs of frames are picked out by their lengths first and have their
+ * CRCs checked together afterwards, in batches handed to the caller.
+ *
+ * Where the deframer resumes after a frame with a bad CRC, the scanner
+ * goes back to one byte after that frame's magic, since offline there is
+ * no cost to looking again: a frame hidden by a bad length or a torn frame
+ * is still found. Only AA 55 framing is scanned, not COBS.
+ */
+
+#ifndef MOUTHPAD_FRAME_SCAN_HPP_
+#define MOUTHPAD_FRAME_SCAN_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace mouthpad {
+
+struct scanned_frame {
+	size_t offset; /* Of the magic, from the start of the data */
+	const uint8_t *payload;
+	uint16_t len;
+};
+
+struct frame_scan_stats {
+	uint64_t frames;
+	uint64_t crc_errors;
+	uint64_t length_errors; /* Magic followed by a length over the maximum */
+	uint64_t skipped;       /* Bytes not in a good frame */
+};
+
+/* Good frames, in order; a batch is only valid during the call */
+using frame_batch_handler = std::function<void(const scanned_frame *frames, size_t count)>;
+
+/* Frames checked per batch at most */
+constexpr size_t frame_scan_batch = 64;
+
+/* Offset of the first AA 55 at or after pos, or len if there is none */
+size_t find_frame_magic(const uint8_t *data, size_t len, size_t pos);
+
+/* Vector unit find_frame_magic() runs on: "avx2", "sse2", "neon" or "scalar" */
+const char *frame_scan_isa();
+
+frame_scan_stats scan_frames(const uint8_t *data, size_t len, const frame_batch_handler &on_batch);
+
+} /* namespace mouthpad */
+
+#endif /* MOUTHPAD_FRAME_SCAN_HPP_ */
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Host side of the MouthPad relay protocol on CDC0
+ *
+ * Finds relays by USB VID/PID, opens their CDC0 port non-blocking and runs
+ * it from an event_loop (epoll on Linux, kqueue on macOS). Received frames
+ * go through the firmware's own deframer (common/mouthpad_frame.h) straight
+ * out of the read buffer; MouthPad notifications, batched or not, are
+ * picked out without a protobuf decode and handed over as pointers into
+ * that buffer. Everything else is decoded with the generated
+ * MouthpadRelay code into one message owned by the relay.
+ *
+ * Writes are framed straight into a TX buffer and written at once when the
+ * port takes them; the loop only waits for the port to drain when it does
+ * not. Once a RelayCapabilitiesResponse lists RELAY_FEATURE_COBS_FRAMING,
+ * however it was asked for, writes are COBS-framed, and the relay answers
+ * in kind. Likewise RELAY_FEATURE_RAW_CHANNELS puts writes behind a channel
+ * header (mouthpad_frame.h): unacknowledged pass-through writes go on the
+ * NUS channel without protobuf, and the relay's notifications come back
+ * the same way. A relay and its loop belong to one thread; only
+ * event_loop::stop() may be called from elsewhere.
+ *
+ * Errors are negative errno values, as in the firmware.
+ */
+
+#ifndef MOUTHPAD_MOUTHPAD_HPP_
+#define MOUTHPAD_MOUTHPAD_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MouthpadRelay.pb.h"
+#include "mouthpad_frame.h"
+#include "sensor_codec.h"
+
+namespace mouthpad {
+
+class capture_writer;
+
+/* USB IDs of both relays (ncs/app/Kconfig, esp/main/usb_hid.c) */
+constexpr uint16_t relay_vendor_id = 0x1915;
+constexpr uint16_t relay_product_id = 0xEEEE;
+
+struct device_info {
+	std::string path;       /* CDC0 port: /dev/ttyACM<n> or /dev/cu.usbmodem<serial>1 */
+	std::string serial;     /* USB serial number; empty if the port has none */
+	uint16_t vendor_id;
+	uint16_t product_id;
+	std::string console;    /* CDC1, the maintenance console; empty if the composition has none */
+};
+
+/**
+ * @brief List the CDC0 port of every attached relay
+ *
+ * CDC1, the console, is not listed on its own: of each device's ACM ports
+ * the one with the lowest interface number is listed, with the next one as
+ * its console.
+ */
+std::vector<device_info> enumerate(uint16_t vendor_id = relay_vendor_id,
+				   uint16_t product_id = relay_product_id);
+
+/* Monotonic microseconds from std::chrono::steady_clock: CLOCK_MONOTONIC
+ * on Linux, mach_absolute_time() on macOS. send_echo() stamps requests
+ * with it.
+ */
+uint64_t steady_us();
+
+/* Readiness multiplexer: epoll on Linux, kqueue on macOS */
+class event_loop {
+public:
+	enum : unsigned {
+		readable = 1,
+		writable = 2,
+		hangup = 4, /* Reported whether asked for or not */
+	};
+
+	using handler = std::function<void(unsigned events)>;
+
+	event_loop();
+	~event_loop();
+
+	event_loop(const event_loop &) = delete;
+	event_loop &operator=(const event_loop &) = delete;
+
+	/* Watch fd for events; the handler may add, modify or remove fds */
+	int add(int fd, unsigned events, handler on_ready);
+	int modify(int fd, unsigned events);
+	void remove(int fd);
+
+	/**
+	 * @brief Wait up to timeout_ms (-1 for ever) and run the handlers of
+	 *        the fds that are ready
+	 *
+	 * @return Handlers run, 0 on timeout or stop(), or a negative errno
+	 */
+	int run_once(int timeout_ms);
+
+	/* run_once() until stop() */
+	int run();
+
+	/* End run() and wake run_once(); any thread, and async-signal-safe */
+	void stop();
+
+private:
+	struct watch {
+		unsigned events;
+		handler on_ready;
+	};
+
+	int poll_fd_ = -1;
+	int wake_fd_ = -1;     /* eventfd on Linux; unused with kqueue's EVFILT_USER */
+	std::atomic<bool> stopped_{false};
+	std::unordered_map<int, std::shared_ptr<watch>> watches_;
+};
+
+/* One MouthPad notification, from PassThroughToApp or a batch chunk */
+struct pass_through {
+	const uint8_t *data;    /* Valid during the callback only */
+	size_t len;
+	uint32_t device_index;  /* 0 for the primary MouthPad */
+	uint32_t sequence;      /* Batch chunks only: the relay's notification count */
+	bool batched;
+};
+
+/* One HID report from a HidMirrorBatch, as the relay forwarded it */
+struct hid_mirror_report {
+	uint32_t sequence;      /* Counts every report mirrored; a gap is reports lost */
+	uint8_t report_id;
+	const uint8_t *data;    /* Without the report ID; valid during the callback only */
+	size_t len;
+	uint64_t ble_rx_us;     /* BLE arrival, relay clock: microseconds since relay boot */
+	uint32_t usb_submit_delay_us; /* From BLE arrival until handed to USB HID */
+	bool submitted;         /* false if dropped or folded into a later USB report */
+};
+
+struct relay_stats {
+	uint32_t frames;        /* CRC-checked frames received */
+	uint32_t crc_errors;
+	uint32_t length_errors;
+	uint32_t decode_errors; /* Frames that were not a RelayToAppMessage */
+	uint32_t pass_through;  /* Notifications delivered */
+	uint32_t decoded;       /* Messages that went through pb_decode() */
+	uint64_t rx_bytes;      /* Read from the port, framing included */
+	uint64_t tx_bytes;
+	uint32_t tx_full;       /* Sends refused because the TX buffer was full */
+	uint32_t codec_dropped; /* SensorFrameDeltas lost waiting for a keyframe or malformed */
+};
+
+/* One relay's CDC0 port */
+class relay {
+public:
+	struct callbacks {
+		/* MouthPad notifications; fragments are joined first */
+		std::function<void(const pass_through &)> on_pass_through;
+
+		/* BleConnectionStatusResponse, asked for or pushed */
+		std::function<void(const mouthware_message_BleConnectionStatusResponse &)> on_status;
+
+		/* LinkTelemetry samples after subscribe_telemetry() */
+		std::function<void(const mouthware_message_LinkTelemetry &)> on_telemetry;
+
+		/* Each mirrored HID report after set_hid_mirror(true), oldest
+		 * first. Without it HidMirrorBatch goes to on_message, records
+		 * undecoded.
+		 */
+		std::function<void(const hid_mirror_report &)> on_hid_mirror;
+
+		/* Every other RelayToAppMessage; valid during the callback only.
+		 * Callback fields (thread, mem and trace lists) are not decoded.
+		 */
+		std::function<void(const mouthware_message_RelayToAppMessage &)> on_message;
+
+		/* The port went away or failed; the relay is closed already */
+		std::function<void(int err)> on_closed;
+	};
+
+	/* Answer to request(): err is 0 with the reply, or -EBUSY, -ENOTSUP or
+	 * -EIO from the relay's RequestError, or -ENOTCONN when the port
+	 * closes first, with reply nullptr. The reply is valid during the
+	 * callback only.
+	 */
+	using reply_handler =
+		std::function<void(int err, const mouthware_message_RelayToAppMessage *reply)>;
+
+	/* Bytes of framed writes held while the port is busy */
+	static constexpr size_t tx_buffer_size = 64 * 1024;
+
+	relay(event_loop &loop, callbacks cb);
+	~relay();
+
+	relay(const relay &) = delete;
+	relay &operator=(const relay &) = delete;
+
+	int open(const std::string &path);
+	void close();
+	bool is_open() const { return fd_ >= 0; }
+
+	/**
+	 * @brief Frame and queue a message
+	 *
+	 * @return 0, -ENOBUFS if the TX buffer cannot take it, -EMSGSIZE if it
+	 *         does not fit a frame, -ENOTCONN if not open
+	 */
+	int send(const mouthware_message_AppToRelayMessage &message);
+
+	/**
+	 * @brief Send a message with a fresh request_id and hand its answer to
+	 *        on_reply instead of the other callbacks
+	 *
+	 * Any number may be outstanding. The relay must advertise
+	 * RELAY_FEATURE_REQUEST_ID; older firmware answers without the id and
+	 * the reply goes to the callbacks, leaving on_reply waiting until close.
+	 * Requests with no answer, such as most writes, never call on_reply.
+	 *
+	 * @return As send()
+	 */
+	int request(mouthware_message_AppToRelayMessage &message, reply_handler on_reply);
+
+	/**
+	 * @brief Queue a write to the MouthPad, encoded by hand straight from
+	 *        data into the TX buffer
+	 *
+	 * @param len At most the PassThroughToMouthpad data field, 240 bytes
+	 * @param ack Response wanted; anything but EACH needs the relay to list
+	 *            RELAY_FEATURE_PASS_THROUGH_ACK_MODES. NONE, with reliable
+	 *            and sequence unset, goes on the raw NUS channel where the
+	 *            relay takes it
+	 * @param sequence Echoed in the response that covers the write
+	 */
+	int send_pass_through(const uint8_t *data, size_t len, uint32_t device_index = 0,
+			      bool reliable = false,
+			      mouthware_message_PassThroughAckMode ack =
+				      mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_EACH,
+			      uint32_t sequence = 0);
+
+	/* BleConnectionStatusRead; the answer arrives on on_status. scan_boost
+	 * brings a backed-off scan back to full rate on relays listing
+	 * RELAY_FEATURE_SCAN_BOOST; set it when the user is waiting for the
+	 * MouthPad, not on periodic polls.
+	 */
+	int read_status(bool scan_boost = false);
+
+	/* RelayCapabilitiesRead; the answer arrives on on_message, and writes
+	 * after it are COBS-framed if the relay lists RELAY_FEATURE_COBS_FRAMING,
+	 * and use channels if it lists RELAY_FEATURE_RAW_CHANNELS
+	 */
+	int read_capabilities();
+
+	/* Whether writes are COBS-framed */
+	bool cobs_framing() const { return cobs_; }
+
+	/* Whether writes go behind a channel header */
+	bool raw_channels() const { return channels_; }
+
+	/* LinkTelemetrySubscribe; interval 0 with on_change false stops it */
+	int subscribe_telemetry(uint32_t interval_ms, bool on_change);
+
+	/* PassThroughBatchConfigWrite: several notifications per frame */
+	int set_batching(bool enabled);
+
+	/* SensorStreamFilterWrite: bits (1 << SensorStream) of MouthPad
+	 * streams the relay should stop; 0 forwards everything
+	 */
+	int set_stream_filter(uint32_t blocked);
+
+	/* SensorStreamRateWrite: forward one in keep_one_in notifications of
+	 * a stream, at most one per min_interval_us on average; 0 for both
+	 * forwards everything
+	 */
+	int set_stream_rate(mouthware_message_SensorStream stream, uint32_t keep_one_in,
+			    uint32_t min_interval_us);
+
+	/* RelayProfileWrite: pick a tuning profile (RELAY_PROFILE_UNCHANGED
+	 * keeps the current one) and override up to six knobs on top; the
+	 * RelayProfileResponse arrives on on_message
+	 */
+	int set_profile(mouthware_message_RelayProfile profile,
+			const mouthware_message_RelayProfileKnobValue *overrides = nullptr,
+			size_t count = 0, bool clear_overrides = false);
+
+	/* UsbCompositionWrite: save the USB composition the relay enumerates
+	 * with; reenumerate restarts the relay into it at once, which closes
+	 * this connection. The UsbCompositionResponse arrives on on_message.
+	 */
+	int set_usb_composition(mouthware_message_UsbComposition composition,
+				bool reenumerate = false);
+
+	/* SensorCodecConfigWrite: the relay sends sensor frames as
+	 * SensorFrameDeltas, which are decoded here and delivered on
+	 * on_pass_through like any other notification. keyframe_interval 0
+	 * keeps the relay's default.
+	 */
+	int set_sensor_codec(bool enabled, uint32_t keyframe_interval = 0);
+
+	/* HidMirrorConfigWrite: copy every HID report the relay forwards to
+	 * on_hid_mirror, with its BLE arrival and USB hand-off times
+	 */
+	int set_hid_mirror(bool enabled);
+
+	/* EchoRequest stamped with steady_us(); the EchoResponse arrives on
+	 * on_message. A mouthpad_payload, which the MouthPad must ignore, also
+	 * times an acknowledged NUS write to it.
+	 */
+	int send_echo(uint32_t sequence, const uint8_t *mouthpad_payload = nullptr, size_t len = 0);
+
+	/* Frame and queue an AppToRelayMessage that is already encoded, such
+	 * as a control record from a capture
+	 */
+	int send_payload(const uint8_t *payload, size_t len);
+
+	/* Record all traffic into capture from now on (capture.hpp); nullptr stops */
+	void set_capture(capture_writer *capture) { capture_ = capture; }
+
+	const relay_stats &stats() const { return stats_; }
+
+private:
+	static void frame_thunk(const uint8_t *payload, uint16_t len, void *user_data);
+	static void error_thunk(enum mouthpad_deframer_error err, uint16_t value, void *user_data);
+
+	void on_ready(unsigned events);
+	void read_all();
+	void flush();
+	void fail(int err);
+	bool answer(const mouthware_message_RelayToAppMessage &message);
+
+	void handle_frame(const uint8_t *payload, size_t len);
+	bool handle_pass_through(const uint8_t *body, size_t len);
+	bool handle_batch(const uint8_t *body, size_t len);
+	void deliver(const pass_through &notification, bool more_fragments, uint32_t fragment);
+	bool handle_hid_mirror(const uint8_t *payload, size_t len);
+	void handle_sensor_frame(const mouthware_message_SensorFrameDelta &delta);
+
+	size_t control_header(uint8_t *out) const;
+	uint8_t *tx_claim(size_t len);
+	void tx_commit(uint8_t *frame, size_t payload_len);
+
+	event_loop &loop_;
+	callbacks cb_;
+	int fd_ = -1;
+	bool want_write_ = false;
+
+	struct mouthpad_deframer deframer_;
+	std::vector<uint8_t> rx_buf_;
+
+	/* Unsent bytes are tx_buf_[tx_head_, tx_tail_) */
+	std::vector<uint8_t> tx_buf_;
+	size_t tx_head_ = 0;
+	size_t tx_tail_ = 0;
+
+	/* Writes are COBS-framed, through cobs_buf_ */
+	bool cobs_ = false;
+	uint8_t cobs_buf_[MOUTHPAD_FRAME_COBS_SIZE(MOUTHPAD_FRAME_MAX_PAYLOAD)];
+
+	/* Writes carry a channel header */
+	bool channels_ = false;
+
+	/* Fragments being joined, per device index */
+	struct partial {
+		std::vector<uint8_t> data;
+		uint32_t next;          /* Fragment number expected next */
+	};
+	std::unordered_map<uint32_t, partial> fragments_;
+
+	/* Last sensor frame decoded from SensorFrameDeltas */
+	struct sensor_codec_decoder codec_;
+
+	/* Decode target for non pass-through frames; too big for callers' stacks */
+	std::unique_ptr<mouthware_message_RelayToAppMessage> message_;
+
+	/* request() handlers waiting for their reply, by request_id */
+	std::unordered_map<uint32_t, reply_handler> requests_;
+	uint32_t next_request_id_ = 0;
+
+	relay_stats stats_ = {};
+	capture_writer *capture_ = nullptr;
+};
+
+} /* namespace mouthpad */
+
+#endif /* MOUTHPAD_MOUTHPAD_HPP_ */
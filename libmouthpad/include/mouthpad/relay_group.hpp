@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Several relays serviced by one I/O thread
+ *
+ * A relay_group opens any number of relays on one event_loop and runs it on
+ * its own thread, so adding a device adds an fd to epoll or kqueue, not a
+ * thread. Each device has two single-producer single-consumer rings: events
+ * from the I/O thread to the application and commands back, so neither
+ * side takes a lock and a slow consumer on one device holds up no other.
+ *
+ * Every event is stamped with the steady clock when its frame is read.
+ * poll() merges the per-device rings oldest first; because one thread
+ * stamps and pushes everything, the merged stream is in time order across
+ * devices. A ring that fills up drops new events and counts them rather
+ * than stall the other devices.
+ */
+
+#ifndef MOUTHPAD_RELAY_GROUP_HPP_
+#define MOUTHPAD_RELAY_GROUP_HPP_
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "mouthpad/mouthpad.hpp"
+
+namespace mouthpad {
+
+/* Lock-free ring for one producer thread and one consumer thread */
+template <typename T> class spsc_ring {
+public:
+	/* capacity is rounded up to a power of two */
+	explicit spsc_ring(size_t capacity)
+	{
+		size_t n = 1;
+
+		while (n < capacity) {
+			n <<= 1;
+		}
+		slots_.reset(new T[n]);
+		mask_ = n - 1;
+	}
+
+	/* Producer: slot to fill, or nullptr when full; publish with push() */
+	T *claim()
+	{
+		size_t tail = tail_.load(std::memory_order_relaxed);
+
+		if (tail - head_cache_ > mask_) {
+			head_cache_ = head_.load(std::memory_order_acquire);
+			if (tail - head_cache_ > mask_) {
+				return nullptr;
+			}
+		}
+		return &slots_[tail & mask_];
+	}
+
+	void push()
+	{
+		tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	/* Consumer: oldest slot, or nullptr when empty; release with pop() */
+	T *front()
+	{
+		size_t head = head_.load(std::memory_order_relaxed);
+
+		if (head == tail_cache_) {
+			tail_cache_ = tail_.load(std::memory_order_acquire);
+			if (head == tail_cache_) {
+				return nullptr;
+			}
+		}
+		return &slots_[head & mask_];
+	}
+
+	void pop()
+	{
+		head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+private:
+	std::unique_ptr<T[]> slots_;
+	size_t mask_;
+
+	/* Each side's index and its cached copy of the other's share a line */
+	alignas(64) std::atomic<size_t> head_{0};
+	size_t tail_cache_ = 0;
+	alignas(64) std::atomic<size_t> tail_{0};
+	size_t head_cache_ = 0;
+};
+
+struct group_event {
+	enum kind : uint8_t {
+		pass_through,   /* data[0, len) */
+		status,         /* body.status */
+		telemetry,      /* body.telemetry */
+		message,        /* body.message, callback fields not decoded */
+		closed,         /* body.err; the device stays closed */
+	};
+
+	/* Largest notification kept; longer joined fragments are dropped */
+	static constexpr size_t max_data = MOUTHPAD_FRAME_MAX_PAYLOAD;
+
+	uint64_t time_us;       /* Steady clock when the frame was read */
+	uint32_t device;        /* Index returned by relay_group::add() */
+	kind type;
+	bool batched;
+	uint32_t device_index;  /* MouthPad behind the relay, pass_through only */
+	uint32_t sequence;      /* Batch chunks only */
+	uint16_t len;
+	union {
+		mouthware_message_BleConnectionStatusResponse status;
+		mouthware_message_LinkTelemetry telemetry;
+		mouthware_message_RelayToAppMessage message;
+		int err;
+	} body;
+	uint8_t data[max_data];
+};
+
+struct group_device_stats {
+	uint32_t events;        /* Pushed to the application */
+	uint32_t dropped;       /* Event ring full */
+	uint32_t oversize;      /* Joined notification longer than max_data */
+	uint32_t commands;      /* Taken from the command ring */
+	uint32_t send_errors;   /* Commands the relay refused */
+};
+
+class relay_group {
+public:
+	/**
+	 * @param events_per_device Event ring depth per device
+	 * @param commands_per_device Command ring depth per device
+	 */
+	explicit relay_group(size_t events_per_device = 1024, size_t commands_per_device = 64);
+	~relay_group();
+
+	relay_group(const relay_group &) = delete;
+	relay_group &operator=(const relay_group &) = delete;
+
+	/**
+	 * @brief Open a relay's CDC0 port; before start() only
+	 *
+	 * @param capture Optional; written by the I/O thread until stop()
+	 * @return Device number (0, 1, ...), or a negative errno
+	 */
+	int add(const std::string &path, capture_writer *capture = nullptr);
+
+	/* add() every relay enumerate() finds; returns how many opened */
+	int add_all();
+
+	size_t size() const { return devices_.size(); }
+	const std::string &path(uint32_t device) const;
+
+	/* Start and stop the I/O thread */
+	int start();
+	void stop();
+
+	/*
+	 * The calls below are for one application thread while the group is
+	 * running. They queue a command for the I/O thread and return 0, or
+	 * -ENOBUFS when the device's command ring is full, -EMSGSIZE when the
+	 * data is too long and -ENODEV for an unknown device.
+	 */
+	int send(uint32_t device, const mouthware_message_AppToRelayMessage &message);
+	int send_pass_through(uint32_t device, const uint8_t *data, size_t len,
+			      uint32_t device_index = 0, bool reliable = false,
+			      mouthware_message_PassThroughAckMode ack =
+				      mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_EACH);
+	int read_status(uint32_t device, bool scan_boost = false);
+	int subscribe_telemetry(uint32_t device, uint32_t interval_ms, bool on_change);
+	int set_batching(uint32_t device, bool enabled);
+
+	/**
+	 * @brief Hand queued events to on_event, oldest first across devices
+	 *
+	 * @param max Stop after this many
+	 * @return Events handed over
+	 */
+	size_t poll(const std::function<void(const group_event &)> &on_event,
+		    size_t max = SIZE_MAX);
+
+	/**
+	 * @brief Wait until an event may be queued or timeout_ms passes
+	 *
+	 * @return true if woken by the I/O thread
+	 */
+	bool wait(int timeout_ms);
+
+	/* Readable when wait() would return at once, for the app's own loop */
+	int fd() const { return app_pipe_[0]; }
+
+	/* Written by the I/O thread; read whenever */
+	group_device_stats stats(uint32_t device) const;
+
+private:
+	struct command {
+		enum kind : uint8_t {
+			message,
+			pass_through,
+		};
+
+		kind type;
+		bool reliable;
+		mouthware_message_PassThroughAckMode ack;
+		uint32_t device_index;
+		uint16_t len;
+		union {
+			mouthware_message_AppToRelayMessage message;
+			uint8_t data[mouthware_message_PassThroughToMouthpad_size];
+		} body;
+	};
+
+	struct device;
+
+	void io_thread();
+	void on_commands();
+	void signal_app();
+	command *claim_command(uint32_t device);
+	void push_command(uint32_t device);
+
+	event_loop loop_;
+	size_t events_depth_;
+	size_t commands_depth_;
+	std::vector<std::unique_ptr<device>> devices_;
+	std::thread thread_;
+	bool running_ = false;
+	std::atomic<bool> stopping_{false};
+
+	/* Commands ready: application -> I/O thread */
+	int io_pipe_[2] = {-1, -1};
+	std::atomic<bool> io_signalled_{false};
+
+	/* Events ready: I/O thread -> application */
+	int app_pipe_[2] = {-1, -1};
+	std::atomic<bool> app_signalled_{false};
+};
+
+} /* namespace mouthpad */
+
+#endif /* MOUTHPAD_RELAY_GROUP_HPP_ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief MouthPad notifications as Apache Arrow tables
+ *
+ * A sensor_exporter takes MouthPad notifications, from a capture or as a
+ * relay delivers them, and writes one Arrow IPC stream per class of
+ * sensor_stream.h, so pyarrow, pandas, polars or DuckDB read a session
+ * straight into typed columns:
+ *
+ *   <prefix>.sensor.arrows  time, device, sequence, type, flags,
+ *                           packet_index uint16, cap fixed_size_list<uint16>[44],
+ *                           pressure, pressure_upper, pressure_lower float32,
+ *                           data binary
+ *   <prefix>.power.arrows   time, device, sequence, type, flags, battery uint8,
+ *                           voltage_mv uint16, temperature uint8, status uint8,
+ *                           data binary
+ *   <prefix>.other.arrows   time, device, data binary
+ *
+ * time is a UTC timestamp in microseconds, taken when the host received the
+ * notification; the relay does not stamp notifications. device is
+ * PassThroughToApp.device_index. sequence, type and flags are header bytes
+ * 1, 0 and 2. The sensor fields sit where the web client's SensorView
+ * reads them, with the pressure floats in the byte order it guesses, NaN
+ * when neither order is plausible. The JCP, IMU and click frames share one
+ * header and cannot be told apart or split into axes here, so data keeps
+ * every notification whole for what is not named.
+ *
+ * Rows are held per table until batch_rows have built up and then written
+ * as one record batch, so memory stays bounded however long the session.
+ * The tables are written by hand in the IPC stream format, without the
+ * Arrow libraries. Not thread safe.
+ */
+
+#ifndef MOUTHPAD_SENSOR_EXPORT_HPP_
+#define MOUTHPAD_SENSOR_EXPORT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "sensor_stream.h"
+
+namespace mouthpad {
+
+class capture_reader;
+struct export_table;
+
+class sensor_exporter {
+public:
+	/* Rows per record batch */
+	static constexpr size_t batch_rows = 4096;
+
+	sensor_exporter();
+	~sensor_exporter();
+
+	sensor_exporter(const sensor_exporter &) = delete;
+	sensor_exporter &operator=(const sensor_exporter &) = delete;
+
+	/* Create or truncate the three tables and write their schemas */
+	int open(const std::string &prefix);
+
+	/* Write what is held and end the streams; returns the first write error */
+	int close();
+
+	bool is_open() const;
+
+	/**
+	 * @brief Add one whole notification
+	 *
+	 * @param time_us Microseconds since the Unix epoch
+	 */
+	void add(uint64_t time_us, uint32_t device_index, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Add every MouthPad notification in a capture, from where the
+	 *        reader is
+	 *
+	 * Captures do not keep the device index; every row has device 0.
+	 */
+	void add_capture(capture_reader &capture);
+
+	/* Rows added to a table */
+	uint64_t rows(mouthware_message_SensorStream stream) const;
+
+private:
+	std::unique_ptr<export_table> tables_[SENSOR_STREAM_COUNT];
+};
+
+} /* namespace mouthpad */
+
+#endif /* MOUTHPAD_SENSOR_EXPORT_HPP_ */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Fan-out of a relay_group's events to other processes
+ *
+ * Only one process can hold a relay's CDC0 port. A daemon that owns the
+ * relays publishes every group_event into a POSIX shared-memory segment
+ * with a shm_writer, and any number of processes attach with a shm_reader
+ * and read the same events; the daemon does not know they are there, so
+ * a slow or crashed reader costs nothing but its own losses.
+ *
+ * Events go into a ring of slots, each guarded by the sequence number of
+ * the event it holds. The writer never waits: it zeroes a slot's sequence,
+ * copies the event in and stores the new sequence. A reader copies the
+ * slot out and checks the sequence is still the one it asked for; if the
+ * writer has lapped it in between, the reader counts what it missed and
+ * carries on from the oldest event still in the ring.
+ *
+ * Readers send commands back through a bounded multi-producer queue in
+ * the same segment, which the daemon drains into relay_group::send().
+ * A reader that dies half way through a push stalls the queue behind it
+ * until the daemon restarts; events are unaffected.
+ *
+ * On Linux wait() sleeps on a futex in the segment, which the writer only
+ * wakes while someone is waiting; on macOS it polls every millisecond.
+ * Both sides must be built from the same libmouthpad, as group_event is
+ * copied as it is; the segment header carries its size to catch a mismatch.
+ */
+
+#ifndef MOUTHPAD_SHM_RING_HPP_
+#define MOUTHPAD_SHM_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "mouthpad/relay_group.hpp"
+
+namespace mouthpad {
+
+/* Segment the daemon publishes to unless told otherwise */
+constexpr const char *default_shm_name = "/mouthpad";
+
+struct shm_header;
+
+/* Daemon side: the only writer of a segment */
+class shm_writer {
+public:
+	/* Devices listed in the segment, with their port paths */
+	static constexpr size_t max_devices = 16;
+	static constexpr size_t max_path = 64;
+
+	shm_writer() = default;
+	~shm_writer();
+
+	shm_writer(const shm_writer &) = delete;
+	shm_writer &operator=(const shm_writer &) = delete;
+
+	/**
+	 * @brief Create the segment, replacing one left by a daemon that died
+	 *
+	 * @param slots Event ring depth, rounded up to a power of two
+	 * @param commands Command queue depth, rounded up to a power of two
+	 * @return 0, -EBUSY if a live daemon owns name, or a negative errno
+	 */
+	int create(const std::string &name, const relay_group &group, size_t slots = 4096,
+		   size_t commands = 64);
+
+	/* Mark the segment closed for readers and unlink it */
+	void close();
+
+	bool is_open() const { return header_ != nullptr; }
+
+	/* Copy one event into the ring; never blocks */
+	void publish(const group_event &event);
+
+	/**
+	 * @brief Hand queued reader commands to on_command, oldest first
+	 *
+	 * @return Commands handed over
+	 */
+	size_t take_commands(const std::function<void(
+				     uint32_t device,
+				     const mouthware_message_AppToRelayMessage &message)> &on_command);
+
+	/* Events published so far */
+	uint64_t published() const;
+
+private:
+	std::string name_;
+	shm_header *header_ = nullptr;
+	size_t size_ = 0;
+};
+
+/* Client side: one of any number of readers of a segment */
+class shm_reader {
+public:
+	shm_reader() = default;
+	~shm_reader();
+
+	shm_reader(const shm_reader &) = delete;
+	shm_reader &operator=(const shm_reader &) = delete;
+
+	/**
+	 * @brief Map the daemon's segment; reading starts with the next event
+	 *
+	 * @return 0, -ENOENT if no daemon is publishing, -EPROTO if it was
+	 *         built with a different group_event, or a negative errno
+	 */
+	int open(const std::string &name = default_shm_name);
+	void close();
+
+	bool is_open() const { return header_ != nullptr; }
+
+	/**
+	 * @brief Copy out the next event
+	 *
+	 * @param sequence Set to the event's number in the daemon's stream
+	 * @return true with an event, false when caught up
+	 */
+	bool next(group_event &event, uint64_t *sequence = nullptr);
+
+	/**
+	 * @brief Wait until next() has an event or timeout_ms passes
+	 *
+	 * @return true if one is there
+	 */
+	bool wait(int timeout_ms);
+
+	/* The daemon closed the segment; open() again to find its successor */
+	bool writer_closed() const;
+
+	/* Events overwritten before this reader got to them */
+	uint64_t lost() const { return lost_; }
+
+	/* Relays the daemon opened, by relay_group device number */
+	size_t size() const;
+	std::string path(uint32_t device) const;
+
+	/**
+	 * @brief Queue a message for the daemon to send to a relay
+	 *
+	 * @return 0, -ENOBUFS when the queue is full, -ENODEV for an unknown
+	 *         device or -ENOTCONN if the daemon has gone
+	 */
+	int send(uint32_t device, const mouthware_message_AppToRelayMessage &message);
+
+private:
+	shm_header *header_ = nullptr;
+	size_t size_ = 0;
+	uint64_t next_ = 0;
+	uint64_t lost_ = 0;
+};
+
+} /* namespace mouthpad */
+
+#endif /* MOUTHPAD_SHM_RING_HPP_ */
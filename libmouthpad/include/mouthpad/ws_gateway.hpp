@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief A relay_group's events over a localhost WebSocket
+ *
+ * For browsers without Web Serial, and pages that should not take the port
+ * from native apps: mouthpad_daemon serves its relays to web/script.js
+ * over ws://127.0.0.1. Each event is turned into a record once and
+ * appended to the batch of every client subscribed to it; the batches go
+ * out as one binary WebSocket message each per pass of the daemon's loop.
+ *
+ * Records, little-endian:
+ *
+ *   [kind][device][device_index][0][len lo][len hi][payload...]
+ *
+ *   kind 0  pass-through  MouthPad notification as the MouthPad sent it
+ *   kind 1  message       RelayToAppMessage payload, re-encoded with
+ *                         nanopb; status and telemetry come this way too,
+ *                         and callback fields (device info strings,
+ *                         trace, thread and memory lists, HID mirror
+ *                         records) are left out
+ *   kind 2  closed        The relay's port closed; payload empty
+ *   kind 3  lost          Records this client missed; payload u32 count
+ *
+ * Clients write CDC0 frames, exactly as they would to the port, in binary
+ * messages split anywhere; the gateway deframes them with the firmware's
+ * deframer and sends each AppToRelayMessage to the client's target relay.
+ * Payloads behind a channel header (mouthpad_frame.h) are taken too: NUS
+ * channel writes go to the MouthPad unacknowledged, whatever channels the
+ * relay itself speaks. Records are the same either way.
+ * Text messages set the client's subscription, one command each:
+ *
+ *   devices all | <n>...           Relays to receive (all)
+ *   kinds <kind>...                pass-through status telemetry message
+ *                                  closed (all)
+ *   streams <stream>...            MouthPad streams, sensor_stream.h: sensor
+ *                                  power other (all)
+ *   target <n>                     Relay this client's writes go to (0)
+ *
+ * and are answered with "ok" or "error <reason>".
+ *
+ * A client that does not read keeps at most max_queued bytes queued; past
+ * that its records are dropped, counted and reported with one lost record
+ * once it catches up, so it never holds up the relays or other clients.
+ * Handshakes are only accepted from pages on localhost and any extra
+ * origins given, so other sites cannot drive the relays. Pages opened from
+ * file:// send the origin "null", as do sandboxed iframes and data: URLs on
+ * any site, so it is only accepted when given as an origin itself.
+ */
+
+#ifndef MOUTHPAD_WS_GATEWAY_HPP_
+#define MOUTHPAD_WS_GATEWAY_HPP_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mouthpad/relay_group.hpp"
+
+namespace mouthpad {
+
+struct ws_gateway_stats {
+	uint32_t clients;       /* Connected now, handshake done */
+	uint32_t refused;       /* Bad handshakes and origins */
+	uint64_t messages;      /* Binary messages sent */
+	uint64_t records;       /* Records sent */
+	uint64_t lost;          /* Records dropped for clients that fell behind */
+	uint32_t commands;      /* AppToRelayMessages and NUS channel writes passed on */
+	uint32_t command_errors; /* Undecodable or refused by relay_group::send() */
+};
+
+class ws_gateway {
+public:
+	enum record_kind : uint8_t {
+		record_pass_through = 0,
+		record_message = 1,
+		record_closed = 2,
+		record_lost = 3,
+	};
+
+	static constexpr uint16_t default_port = 8765;
+
+	/* Bytes queued for one client before its records are dropped */
+	static constexpr size_t max_queued = 1024 * 1024;
+
+	/* Largest binary message sent; a bigger batch is split */
+	static constexpr size_t max_message = 64 * 1024;
+
+	/* Relays are reached through group; both outlive the gateway */
+	ws_gateway(event_loop &loop, relay_group &group);
+	~ws_gateway();
+
+	ws_gateway(const ws_gateway &) = delete;
+	ws_gateway &operator=(const ws_gateway &) = delete;
+
+	/* Accept handshakes from this origin too, e.g. https://example.com, or
+	 * "null" for pages opened from file://
+	 */
+	void allow_origin(const std::string &origin) { origins_.push_back(origin); }
+
+	/* Listen on 127.0.0.1:port */
+	int listen(uint16_t port = default_port);
+	void close();
+
+	/* Batch an event for its subscribers */
+	void publish(const group_event &event);
+
+	/* Send every client's batch */
+	void flush();
+
+	ws_gateway_stats stats() const;
+
+private:
+	struct client;
+
+	void on_accept();
+	void on_client(client &c, unsigned events);
+	bool handshake(client &c);
+	bool parse(client &c);
+	void on_message(client &c, uint8_t opcode, std::vector<uint8_t> &data);
+	void on_text(client &c, const std::string &text);
+	void queue(client &c, uint8_t opcode, const uint8_t *data, size_t len);
+	void write_out(client &c);
+	void send_batch(client &c);
+	void drop(client &c);
+	void reap();
+	bool origin_allowed(const std::string &origin) const;
+
+	static void frame_thunk(const uint8_t *payload, uint16_t len, void *user_data);
+
+	event_loop &loop_;
+	relay_group &group_;
+	int listen_fd_ = -1;
+	std::vector<std::string> origins_;
+	std::unordered_map<int, std::unique_ptr<client>> clients_;
+	std::vector<int> dead_;
+	std::vector<uint8_t> record_;
+	ws_gateway_stats stats_ = {};
+};
+
+} /* namespace mouthpad */
+
+#endif /* MOUTHPAD_WS_GATEWAY_HPP_ */
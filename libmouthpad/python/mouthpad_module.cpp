@@ -0,0 +1,909 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Python module "mouthpad" over relay (mouthpad.hpp), written against the
+ * CPython C API so it needs nothing but the interpreter's headers.
+ *
+ * Relay.poll() runs the event loop with the GIL released and collects
+ * everything that arrived into one Batch: pass-through payloads are copied
+ * once, back to back, into the batch's buffer, and per-event fields go into
+ * typed columns. Python sees the buffer and columns through the buffer
+ * protocol (memoryview, numpy.frombuffer) without further copies, and
+ * pays one call per poll rather than one per notification. Status and
+ * telemetry replies are kept decoded and turned into Python objects only
+ * when asked for.
+ *
+ * Event times are steady-clock nanoseconds taken when the event was read,
+ * the same clock as time.monotonic_ns() on Linux and macOS.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "mouthpad/mouthpad.hpp"
+
+namespace {
+
+/* Loop passes per poll() after the first, so a port that never goes quiet
+ * still returns
+ */
+constexpr int poll_passes_max = 16;
+
+enum event_kind : uint8_t {
+	kind_pass_through,
+	kind_status,
+	kind_telemetry,
+	kind_message,
+	kind_closed,
+};
+
+/* One poll()'s events, immutable once handed to Python */
+struct batch_data {
+	std::vector<uint8_t> kinds;
+	std::vector<uint32_t> devices;   /* Pass-through: device index; message: request_id */
+	std::vector<uint32_t> sequences; /* Batch chunk count, or the body tag of a message */
+	std::vector<uint64_t> times_ns;
+	std::vector<uint32_t> offsets;   /* Into payload; pass-through only */
+	std::vector<uint32_t> lengths;
+	std::vector<uint8_t> payload;
+	std::vector<mouthware_message_BleConnectionStatusResponse> status;
+	std::vector<mouthware_message_LinkTelemetry> telemetry;
+	int closed_err = 0;
+
+	void add(event_kind kind, uint32_t device, uint32_t sequence, uint32_t offset,
+		 uint32_t len)
+	{
+		kinds.push_back(kind);
+		devices.push_back(device);
+		sequences.push_back(sequence);
+		times_ns.push_back((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+					   std::chrono::steady_clock::now().time_since_epoch())
+					   .count());
+		offsets.push_back(offset);
+		lengths.push_back(len);
+	}
+};
+
+/* Columns a Batch exposes, in column_object::which */
+enum column_id {
+	column_kinds,
+	column_devices,
+	column_sequences,
+	column_times_ns,
+	column_offsets,
+	column_lengths,
+};
+
+PyObject *os_error(int err)
+{
+	errno = -err;
+	return PyErr_SetFromErrno(PyExc_OSError);
+}
+
+/* Status and telemetry as named tuples */
+
+#define STATUS_FIELDS(X)   \
+	X(connection_status) \
+	X(rssi)              \
+	X(battery_level)     \
+	X(tx_phy)            \
+	X(rx_phy)            \
+	X(max_tx_octets)     \
+	X(max_rx_octets)     \
+	X(connected_devices)
+
+#define TELEMETRY_FIELDS(X) \
+	X(sequence)          \
+	X(connected)         \
+	X(rssi)              \
+	X(battery_level)     \
+	X(conn_interval_us)  \
+	X(tx_phy)            \
+	X(rx_phy)            \
+	X(hid_reports_per_s) \
+	X(hid_dropped)       \
+	X(nus_rx_dropped)    \
+	X(nus_tx_dropped)    \
+	X(nus_tx_queued)     \
+	X(cdc_tx_queued)     \
+	X(interval_ms)       \
+	X(stalls)            \
+	X(worst_stall_us)    \
+	X(usb_wait_us)       \
+	X(usb_phase_us)      \
+	X(nus_seq_lost)      \
+	X(nus_seq_reordered) \
+	X(nus_loss_permille)
+
+/* Integers and enums as int, flags as bool */
+template <typename T> PyObject *field_to_python(T value)
+{
+	return PyLong_FromLongLong((long long)value);
+}
+
+template <> PyObject *field_to_python(bool value)
+{
+	return PyBool_FromLong(value);
+}
+
+#define FIELD_DESC(name) {(char *)#name, nullptr},
+#define FIELD_SET(name) PyStructSequence_SET_ITEM(obj, i++, field_to_python(m.name));
+
+PyStructSequence_Field status_fields[] = {STATUS_FIELDS(FIELD_DESC){nullptr, nullptr}};
+PyStructSequence_Field telemetry_fields[] = {TELEMETRY_FIELDS(FIELD_DESC){nullptr, nullptr}};
+PyStructSequence_Field device_fields[] = {
+	{(char *)"path", nullptr},
+	{(char *)"serial", nullptr},
+	{(char *)"vendor_id", nullptr},
+	{(char *)"product_id", nullptr},
+	{(char *)"console", nullptr},
+	{nullptr, nullptr},
+};
+
+PyStructSequence_Desc status_desc = {"mouthpad.Status", "BleConnectionStatusResponse",
+				     status_fields, (int)(sizeof(status_fields) /
+							  sizeof(status_fields[0]) - 1)};
+PyStructSequence_Desc telemetry_desc = {"mouthpad.Telemetry", "LinkTelemetry sample",
+					telemetry_fields, (int)(sizeof(telemetry_fields) /
+								sizeof(telemetry_fields[0]) - 1)};
+PyStructSequence_Desc device_desc = {"mouthpad.DeviceInfo", "An attached relay's CDC0 port",
+				     device_fields, 5};
+
+PyTypeObject *status_type;
+PyTypeObject *telemetry_type;
+PyTypeObject *device_type;
+
+PyObject *status_to_python(const mouthware_message_BleConnectionStatusResponse &m)
+{
+	PyObject *obj = PyStructSequence_New(status_type);
+	Py_ssize_t i = 0;
+
+	if (obj) {
+		STATUS_FIELDS(FIELD_SET)
+	}
+	return obj;
+}
+
+PyObject *telemetry_to_python(const mouthware_message_LinkTelemetry &m)
+{
+	PyObject *obj = PyStructSequence_New(telemetry_type);
+	Py_ssize_t i = 0;
+
+	if (obj) {
+		TELEMETRY_FIELDS(FIELD_SET)
+	}
+	return obj;
+}
+
+/* Batch */
+
+struct batch_object {
+	PyObject_HEAD
+	std::unique_ptr<batch_data> data;
+};
+
+struct column_object {
+	PyObject_HEAD
+	batch_object *owner;
+	column_id which;
+	Py_ssize_t shape;
+};
+
+PyTypeObject batch_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+PyTypeObject column_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+void batch_dealloc(PyObject *self)
+{
+	reinterpret_cast<batch_object *>(self)->data.~unique_ptr();
+	Py_TYPE(self)->tp_free(self);
+}
+
+Py_ssize_t batch_length(PyObject *self)
+{
+	return (Py_ssize_t)reinterpret_cast<batch_object *>(self)->data->kinds.size();
+}
+
+/* An empty vector may have no storage; buffers must still point somewhere */
+static uint8_t empty_buffer[8];
+
+int batch_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+	auto &payload = reinterpret_cast<batch_object *>(self)->data->payload;
+
+	return PyBuffer_FillInfo(view, self, payload.empty() ? empty_buffer : payload.data(),
+				 (Py_ssize_t)payload.size(), 1, flags);
+}
+
+PyObject *batch_column(PyObject *self, void *closure)
+{
+	column_object *column = PyObject_New(column_object, &column_type);
+	PyObject *view;
+
+	if (!column) {
+		return nullptr;
+	}
+	Py_INCREF(self);
+	column->owner = reinterpret_cast<batch_object *>(self);
+	column->which = (column_id)(intptr_t)closure;
+	column->shape = batch_length(self);
+
+	view = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(column));
+	Py_DECREF(column);
+	return view;
+}
+
+PyObject *batch_payload(PyObject *self, PyObject *arg)
+{
+	const batch_data &b = *reinterpret_cast<batch_object *>(self)->data;
+	Py_ssize_t i = PyLong_AsSsize_t(arg);
+	PyObject *all;
+	PyObject *slice;
+
+	if (i == -1 && PyErr_Occurred()) {
+		return nullptr;
+	}
+	if (i < 0) {
+		i += (Py_ssize_t)b.kinds.size();
+	}
+	if (i < 0 || i >= (Py_ssize_t)b.kinds.size()) {
+		PyErr_SetString(PyExc_IndexError, "event index out of range");
+		return nullptr;
+	}
+
+	all = PyMemoryView_FromObject(self);
+	if (!all) {
+		return nullptr;
+	}
+	slice = PySequence_GetSlice(all, b.offsets[i], (Py_ssize_t)b.offsets[i] + b.lengths[i]);
+	Py_DECREF(all);
+	return slice;
+}
+
+PyObject *batch_status(PyObject *self, void *)
+{
+	const batch_data &b = *reinterpret_cast<batch_object *>(self)->data;
+	PyObject *list = PyList_New((Py_ssize_t)b.status.size());
+
+	for (size_t i = 0; list && i < b.status.size(); i++) {
+		PyObject *item = status_to_python(b.status[i]);
+
+		if (!item) {
+			Py_CLEAR(list);
+			break;
+		}
+		PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+	}
+	return list;
+}
+
+PyObject *batch_telemetry(PyObject *self, void *)
+{
+	const batch_data &b = *reinterpret_cast<batch_object *>(self)->data;
+	PyObject *list = PyList_New((Py_ssize_t)b.telemetry.size());
+
+	for (size_t i = 0; list && i < b.telemetry.size(); i++) {
+		PyObject *item = telemetry_to_python(b.telemetry[i]);
+
+		if (!item) {
+			Py_CLEAR(list);
+			break;
+		}
+		PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+	}
+	return list;
+}
+
+PyObject *batch_closed(PyObject *self, void *)
+{
+	return PyLong_FromLong(reinterpret_cast<batch_object *>(self)->data->closed_err);
+}
+
+PyObject *batch_payload_bytes(PyObject *self, void *)
+{
+	return PyLong_FromSize_t(reinterpret_cast<batch_object *>(self)->data->payload.size());
+}
+
+PyMethodDef batch_methods[] = {
+	{"payload", batch_payload, METH_O,
+	 "payload(i) -> memoryview of event i's bytes in the batch buffer"},
+	{nullptr, nullptr, 0, nullptr},
+};
+
+PyGetSetDef batch_getset[] = {
+	{"kinds", batch_column, nullptr, "Event kinds, uint8 (PASS_THROUGH, STATUS, ...)",
+	 (void *)column_kinds},
+	{"devices", batch_column, nullptr, "uint32: the device index for pass-through, the request_id for MESSAGE",
+	 (void *)column_devices},
+	{"sequences", batch_column, nullptr,
+	 "uint32: the relay's notification count for batch chunks, the body tag for MESSAGE",
+	 (void *)column_sequences},
+	{"times_ns", batch_column, nullptr, "Steady-clock read time, uint64 ns",
+	 (void *)column_times_ns},
+	{"offsets", batch_column, nullptr, "Payload offset in the batch buffer, uint32",
+	 (void *)column_offsets},
+	{"lengths", batch_column, nullptr, "Payload length, uint32", (void *)column_lengths},
+	{"status", batch_status, nullptr, "Status replies in this batch, in order", nullptr},
+	{"telemetry", batch_telemetry, nullptr, "Telemetry samples in this batch, in order",
+	 nullptr},
+	{"closed", batch_closed, nullptr, "Negative errno if the port closed, else 0", nullptr},
+	{"payload_bytes", batch_payload_bytes, nullptr, "Bytes in the batch buffer", nullptr},
+	{nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+PySequenceMethods batch_sequence = {batch_length};
+PyBufferProcs batch_buffer = {batch_getbuffer, nullptr};
+
+/* A column is only ever seen through the memoryview made of it */
+
+void column_dealloc(PyObject *self)
+{
+	Py_DECREF(reinterpret_cast<column_object *>(self)->owner);
+	PyObject_Free(self);
+}
+
+template <typename T> void fill_column(Py_buffer *view, const std::vector<T> &v, const char *format)
+{
+	view->buf = v.empty() ? empty_buffer : (void *)v.data();
+	view->itemsize = sizeof(T);
+	view->len = (Py_ssize_t)(v.size() * sizeof(T));
+	view->format = (char *)format;
+}
+
+int column_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+	column_object *column = reinterpret_cast<column_object *>(self);
+	const batch_data &b = *column->owner->data;
+
+	if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+		PyErr_SetString(PyExc_BufferError, "batch columns are read-only");
+		return -1;
+	}
+
+	switch (column->which) {
+	case column_kinds:
+		fill_column(view, b.kinds, "B");
+		break;
+	case column_devices:
+		fill_column(view, b.devices, "I");
+		break;
+	case column_sequences:
+		fill_column(view, b.sequences, "I");
+		break;
+	case column_times_ns:
+		fill_column(view, b.times_ns, "Q");
+		break;
+	case column_offsets:
+		fill_column(view, b.offsets, "I");
+		break;
+	case column_lengths:
+		fill_column(view, b.lengths, "I");
+		break;
+	}
+
+	view->obj = self;
+	Py_INCREF(self);
+	view->readonly = 1;
+	view->ndim = 1;
+	view->shape = &column->shape;
+	view->strides = &view->itemsize;
+	view->suboffsets = nullptr;
+	view->internal = nullptr;
+	return 0;
+}
+
+PyBufferProcs column_buffer = {column_getbuffer, nullptr};
+
+/* Relay */
+
+struct relay_object {
+	PyObject_HEAD
+	mouthpad::event_loop *loop;
+	mouthpad::relay *relay;
+	batch_data *filling;  /* Target of the callbacks during poll() */
+	size_t last_events;   /* Capacity hint for the next batch */
+	size_t last_payload;
+	bool busy;            /* poll() has the GIL released */
+};
+
+PyTypeObject relay_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+/* Methods that touch the relay while poll() runs on another thread would race it */
+bool relay_usable(relay_object *self)
+{
+	if (self->busy) {
+		PyErr_SetString(PyExc_RuntimeError, "Relay is being polled by another thread");
+		return false;
+	}
+	if (!self->relay->is_open()) {
+		os_error(-ENOTCONN);
+		return false;
+	}
+	return true;
+}
+
+PyObject *relay_new(PyTypeObject *type, PyObject *, PyObject *)
+{
+	relay_object *self = reinterpret_cast<relay_object *>(type->tp_alloc(type, 0));
+
+	if (!self) {
+		return nullptr;
+	}
+
+	self->loop = new mouthpad::event_loop();
+
+	mouthpad::relay::callbacks cb;
+
+	cb.on_pass_through = [self](const mouthpad::pass_through &p) {
+		batch_data *b = self->filling;
+
+		if (!b) {
+			return;
+		}
+		b->add(kind_pass_through, p.device_index, p.sequence, (uint32_t)b->payload.size(),
+		       (uint32_t)p.len);
+		b->payload.insert(b->payload.end(), p.data, p.data + p.len);
+	};
+	cb.on_status = [self](const mouthware_message_BleConnectionStatusResponse &s) {
+		if (self->filling) {
+			self->filling->add(kind_status, 0, 0, 0, 0);
+			self->filling->status.push_back(s);
+		}
+	};
+	cb.on_telemetry = [self](const mouthware_message_LinkTelemetry &t) {
+		if (self->filling) {
+			self->filling->add(kind_telemetry, 0, 0, 0, 0);
+			self->filling->telemetry.push_back(t);
+		}
+	};
+	cb.on_message = [self](const mouthware_message_RelayToAppMessage &m) {
+		if (self->filling) {
+			self->filling->add(kind_message, m.request_id, m.which_message_body, 0, 0);
+		}
+	};
+	cb.on_closed = [self](int err) {
+		if (self->filling) {
+			self->filling->add(kind_closed, 0, 0, 0, 0);
+			self->filling->closed_err = err;
+		}
+	};
+
+	self->relay = new mouthpad::relay(*self->loop, std::move(cb));
+	return reinterpret_cast<PyObject *>(self);
+}
+
+int relay_init(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"path", nullptr};
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	const char *path;
+	int err;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", (char **)keywords, &path)) {
+		return -1;
+	}
+
+	self->relay->close();
+	err = self->relay->open(path);
+	if (err) {
+		errno = -err;
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+		return -1;
+	}
+	return 0;
+}
+
+void relay_dealloc(PyObject *obj)
+{
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+
+	delete self->relay;
+	delete self->loop;
+	Py_TYPE(obj)->tp_free(obj);
+}
+
+PyObject *relay_poll(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"timeout_ms", nullptr};
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	int timeout_ms = 0;
+	int n;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", (char **)keywords, &timeout_ms)) {
+		return nullptr;
+	}
+	if (!relay_usable(self)) {
+		return nullptr;
+	}
+
+	batch_object *batch = PyObject_New(batch_object, &batch_type);
+
+	if (!batch) {
+		return nullptr;
+	}
+	new (&batch->data) std::unique_ptr<batch_data>(new batch_data());
+
+	batch_data *b = batch->data.get();
+
+	b->kinds.reserve(self->last_events);
+	b->devices.reserve(self->last_events);
+	b->sequences.reserve(self->last_events);
+	b->times_ns.reserve(self->last_events);
+	b->offsets.reserve(self->last_events);
+	b->lengths.reserve(self->last_events);
+	b->payload.reserve(self->last_payload);
+
+	self->filling = b;
+	self->busy = true;
+	Py_BEGIN_ALLOW_THREADS
+	n = self->loop->run_once(timeout_ms);
+	for (int pass = 0; n > 0 && pass < poll_passes_max; pass++) {
+		n = self->loop->run_once(0);
+	}
+	Py_END_ALLOW_THREADS
+	self->busy = false;
+	self->filling = nullptr;
+
+	self->last_events = b->kinds.size();
+	self->last_payload = b->payload.size();
+
+	if (n < 0 && n != -EINTR) {
+		Py_DECREF(batch);
+		return os_error(n);
+	}
+	return reinterpret_cast<PyObject *>(batch);
+}
+
+/* 0 -> None, else OSError */
+PyObject *relay_result(int err)
+{
+	if (err) {
+		return os_error(err);
+	}
+	Py_RETURN_NONE;
+}
+
+PyObject *relay_send_pass_through(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"data", "device_index", "reliable", "ack", "sequence",
+					 nullptr};
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	Py_buffer data;
+	unsigned int device_index = 0;
+	int reliable = 0;
+	unsigned int ack = mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_EACH;
+	unsigned int sequence = 0;
+	int err;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|IpII", (char **)keywords, &data,
+					 &device_index, &reliable, &ack, &sequence)) {
+		return nullptr;
+	}
+	if (!relay_usable(self)) {
+		PyBuffer_Release(&data);
+		return nullptr;
+	}
+	err = self->relay->send_pass_through(static_cast<const uint8_t *>(data.buf),
+					     (size_t)data.len, device_index, reliable != 0,
+					     (mouthware_message_PassThroughAckMode)ack, sequence);
+	PyBuffer_Release(&data);
+	return relay_result(err);
+}
+
+PyObject *relay_send_payload(PyObject *obj, PyObject *arg)
+{
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	Py_buffer data;
+	int err;
+
+	if (PyObject_GetBuffer(arg, &data, PyBUF_SIMPLE) < 0) {
+		return nullptr;
+	}
+	if (!relay_usable(self)) {
+		PyBuffer_Release(&data);
+		return nullptr;
+	}
+	err = self->relay->send_payload(static_cast<const uint8_t *>(data.buf), (size_t)data.len);
+	PyBuffer_Release(&data);
+	return relay_result(err);
+}
+
+PyObject *relay_read_status(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"scan_boost", nullptr};
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	int scan_boost = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", (char **)keywords, &scan_boost)) {
+		return nullptr;
+	}
+	return relay_usable(self) ? relay_result(self->relay->read_status(scan_boost)) : nullptr;
+}
+
+PyObject *relay_read_capabilities(PyObject *obj, PyObject *)
+{
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+
+	return relay_usable(self) ? relay_result(self->relay->read_capabilities()) : nullptr;
+}
+
+PyObject *relay_subscribe_telemetry(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"interval_ms", "on_change", nullptr};
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	unsigned int interval_ms;
+	int on_change = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|p", (char **)keywords, &interval_ms,
+					 &on_change)) {
+		return nullptr;
+	}
+	return relay_usable(self)
+		       ? relay_result(self->relay->subscribe_telemetry(interval_ms, on_change != 0))
+		       : nullptr;
+}
+
+PyObject *relay_set_batching(PyObject *obj, PyObject *arg)
+{
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	int enabled = PyObject_IsTrue(arg);
+
+	if (enabled < 0) {
+		return nullptr;
+	}
+	return relay_usable(self) ? relay_result(self->relay->set_batching(enabled != 0))
+				  : nullptr;
+}
+
+PyObject *relay_set_stream_filter(PyObject *obj, PyObject *arg)
+{
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	unsigned long blocked = PyLong_AsUnsignedLong(arg);
+
+	if (blocked == static_cast<unsigned long>(-1) && PyErr_Occurred()) {
+		return nullptr;
+	}
+	return relay_usable(self)
+		       ? relay_result(self->relay->set_stream_filter(static_cast<uint32_t>(blocked)))
+		       : nullptr;
+}
+
+PyObject *relay_set_stream_rate(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"stream", "keep_one_in", "min_interval_us", nullptr};
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	unsigned int stream;
+	unsigned int keep_one_in = 0;
+	unsigned int min_interval_us = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|II", (char **)keywords, &stream,
+					 &keep_one_in, &min_interval_us)) {
+		return nullptr;
+	}
+	return relay_usable(self) ? relay_result(self->relay->set_stream_rate(
+					    static_cast<mouthware_message_SensorStream>(stream),
+					    keep_one_in, min_interval_us))
+				  : nullptr;
+}
+
+PyObject *relay_set_sensor_codec(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"enabled", "keyframe_interval", nullptr};
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+	int enabled;
+	unsigned int keyframe_interval = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "p|I", (char **)keywords, &enabled,
+					 &keyframe_interval)) {
+		return nullptr;
+	}
+	return relay_usable(self) ? relay_result(self->relay->set_sensor_codec(enabled != 0,
+										keyframe_interval))
+				  : nullptr;
+}
+
+PyObject *relay_close(PyObject *obj, PyObject *)
+{
+	relay_object *self = reinterpret_cast<relay_object *>(obj);
+
+	if (self->busy) {
+		PyErr_SetString(PyExc_RuntimeError, "Relay is being polled by another thread");
+		return nullptr;
+	}
+	self->relay->close();
+	Py_RETURN_NONE;
+}
+
+PyObject *relay_is_open(PyObject *obj, void *)
+{
+	return PyBool_FromLong(reinterpret_cast<relay_object *>(obj)->relay->is_open());
+}
+
+PyObject *relay_stats(PyObject *obj, void *)
+{
+	const mouthpad::relay_stats &s = reinterpret_cast<relay_object *>(obj)->relay->stats();
+
+	return Py_BuildValue("{s:I,s:I,s:I,s:I,s:I,s:I,s:K,s:K,s:I,s:I}", "frames", s.frames,
+			     "crc_errors", s.crc_errors, "length_errors", s.length_errors,
+			     "decode_errors", s.decode_errors, "pass_through", s.pass_through,
+			     "decoded", s.decoded, "rx_bytes", (unsigned long long)s.rx_bytes,
+			     "tx_bytes", (unsigned long long)s.tx_bytes, "tx_full", s.tx_full,
+			     "codec_dropped", s.codec_dropped);
+}
+
+PyObject *relay_enter(PyObject *obj, PyObject *)
+{
+	Py_INCREF(obj);
+	return obj;
+}
+
+PyObject *relay_exit(PyObject *obj, PyObject *)
+{
+	return relay_close(obj, nullptr);
+}
+
+PyMethodDef relay_methods[] = {
+	{"poll", (PyCFunction)(void (*)(void))relay_poll, METH_VARARGS | METH_KEYWORDS,
+	 "poll(timeout_ms=0) -> Batch of everything read, waiting up to timeout_ms for the "
+	 "first event (-1 for ever)"},
+	{"send_pass_through", (PyCFunction)(void (*)(void))relay_send_pass_through,
+	 METH_VARARGS | METH_KEYWORDS,
+	 "send_pass_through(data, device_index=0, reliable=False, ack=ACK_EACH, sequence=0): "
+	 "write to the MouthPad"},
+	{"send_payload", relay_send_payload, METH_O,
+	 "send_payload(data): frame and send an encoded AppToRelayMessage"},
+	{"read_status", (PyCFunction)(void (*)(void))relay_read_status, METH_VARARGS | METH_KEYWORDS,
+	 "read_status(scan_boost=False): ask for BleConnectionStatus; the answer arrives in a "
+	 "later Batch. scan_boost brings a backed-off scan back to full rate"},
+	{"read_capabilities", relay_read_capabilities, METH_NOARGS,
+	 "Ask for RelayCapabilities; writes switch to COBS framing if the relay takes it"},
+	{"subscribe_telemetry", (PyCFunction)(void (*)(void))relay_subscribe_telemetry,
+	 METH_VARARGS | METH_KEYWORDS,
+	 "subscribe_telemetry(interval_ms, on_change=False); 0 and False stop it"},
+	{"set_batching", relay_set_batching, METH_O,
+	 "set_batching(enabled): several notifications per frame"},
+	{"set_stream_filter", relay_set_stream_filter, METH_O,
+	 "set_stream_filter(blocked): bits (1 << STREAM_*) of MouthPad streams to stop at the relay"},
+	{"set_stream_rate", (PyCFunction)(void (*)(void))relay_set_stream_rate,
+	 METH_VARARGS | METH_KEYWORDS,
+	 "set_stream_rate(stream, keep_one_in=0, min_interval_us=0): thin a STREAM_* at the relay "
+	 "to one in keep_one_in, at most one per min_interval_us"},
+	{"set_sensor_codec", (PyCFunction)(void (*)(void))relay_set_sensor_codec,
+	 METH_VARARGS | METH_KEYWORDS,
+	 "set_sensor_codec(enabled, keyframe_interval=0): delta-code sensor frames on CDC0; "
+	 "they still arrive as notifications"},
+	{"close", relay_close, METH_NOARGS, nullptr},
+	{"__enter__", relay_enter, METH_NOARGS, nullptr},
+	{"__exit__", relay_exit, METH_VARARGS, nullptr},
+	{nullptr, nullptr, 0, nullptr},
+};
+
+PyGetSetDef relay_getset[] = {
+	{"is_open", relay_is_open, nullptr, nullptr, nullptr},
+	{"stats", relay_stats, nullptr, "Host-side receive and send counters", nullptr},
+	{nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+/* Module */
+
+PyObject *module_enumerate(PyObject *, PyObject *)
+{
+	std::vector<mouthpad::device_info> devices = mouthpad::enumerate();
+	PyObject *list = PyList_New((Py_ssize_t)devices.size());
+
+	for (size_t i = 0; list && i < devices.size(); i++) {
+		PyObject *item = PyStructSequence_New(device_type);
+
+		if (!item) {
+			Py_CLEAR(list);
+			break;
+		}
+		PyStructSequence_SET_ITEM(item, 0, PyUnicode_FromString(devices[i].path.c_str()));
+		PyStructSequence_SET_ITEM(item, 1, PyUnicode_FromString(devices[i].serial.c_str()));
+		PyStructSequence_SET_ITEM(item, 2, PyLong_FromLong(devices[i].vendor_id));
+		PyStructSequence_SET_ITEM(item, 3, PyLong_FromLong(devices[i].product_id));
+		PyStructSequence_SET_ITEM(item, 4, PyUnicode_FromString(devices[i].console.c_str()));
+		PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+	}
+	return list;
+}
+
+PyMethodDef module_methods[] = {
+	{"enumerate", module_enumerate, METH_NOARGS,
+	 "enumerate() -> [DeviceInfo] for the CDC0 port of every attached relay"},
+	{nullptr, nullptr, 0, nullptr},
+};
+
+PyModuleDef module_def = {
+	PyModuleDef_HEAD_INIT, "mouthpad", "MouthPad relay host library", -1, module_methods,
+};
+
+bool init_types()
+{
+	batch_type.tp_name = "mouthpad.Batch";
+	batch_type.tp_basicsize = sizeof(batch_object);
+	batch_type.tp_dealloc = batch_dealloc;
+	batch_type.tp_flags = Py_TPFLAGS_DEFAULT;
+	batch_type.tp_doc = "Events from one Relay.poll(); the buffer holds their payloads";
+	batch_type.tp_as_sequence = &batch_sequence;
+	batch_type.tp_as_buffer = &batch_buffer;
+	batch_type.tp_methods = batch_methods;
+	batch_type.tp_getset = batch_getset;
+
+	column_type.tp_name = "mouthpad._Column";
+	column_type.tp_basicsize = sizeof(column_object);
+	column_type.tp_dealloc = column_dealloc;
+	column_type.tp_flags = Py_TPFLAGS_DEFAULT;
+	column_type.tp_as_buffer = &column_buffer;
+
+	relay_type.tp_name = "mouthpad.Relay";
+	relay_type.tp_basicsize = sizeof(relay_object);
+	relay_type.tp_dealloc = relay_dealloc;
+	relay_type.tp_flags = Py_TPFLAGS_DEFAULT;
+	relay_type.tp_doc = "Relay(path): one relay's CDC0 port; belongs to one thread";
+	relay_type.tp_methods = relay_methods;
+	relay_type.tp_getset = relay_getset;
+	relay_type.tp_new = relay_new;
+	relay_type.tp_init = relay_init;
+
+	status_type = PyStructSequence_NewType(&status_desc);
+	telemetry_type = PyStructSequence_NewType(&telemetry_desc);
+	device_type = PyStructSequence_NewType(&device_desc);
+
+	return status_type && telemetry_type && device_type && PyType_Ready(&batch_type) == 0 &&
+	       PyType_Ready(&column_type) == 0 && PyType_Ready(&relay_type) == 0;
+}
+
+} /* namespace */
+
+PyMODINIT_FUNC PyInit_mouthpad(void)
+{
+	PyObject *m;
+
+	if (!init_types()) {
+		return nullptr;
+	}
+
+	m = PyModule_Create(&module_def);
+	if (!m) {
+		return nullptr;
+	}
+
+	/* PyModule_AddObject() steals a reference when it succeeds */
+	Py_INCREF(&relay_type);
+	PyModule_AddObject(m, "Relay", reinterpret_cast<PyObject *>(&relay_type));
+	Py_INCREF(&batch_type);
+	PyModule_AddObject(m, "Batch", reinterpret_cast<PyObject *>(&batch_type));
+	PyModule_AddObject(m, "Status", reinterpret_cast<PyObject *>(status_type));
+	PyModule_AddObject(m, "Telemetry", reinterpret_cast<PyObject *>(telemetry_type));
+	PyModule_AddObject(m, "DeviceInfo", reinterpret_cast<PyObject *>(device_type));
+	PyModule_AddIntConstant(m, "PASS_THROUGH", kind_pass_through);
+	PyModule_AddIntConstant(m, "STATUS", kind_status);
+	PyModule_AddIntConstant(m, "TELEMETRY", kind_telemetry);
+	PyModule_AddIntConstant(m, "MESSAGE", kind_message);
+	PyModule_AddIntConstant(m, "CLOSED", kind_closed);
+	PyModule_AddIntConstant(m, "STREAM_OTHER", mouthware_message_SensorStream_SENSOR_STREAM_OTHER);
+	PyModule_AddIntConstant(m, "STREAM_SENSOR", mouthware_message_SensorStream_SENSOR_STREAM_SENSOR);
+	PyModule_AddIntConstant(m, "STREAM_POWER", mouthware_message_SensorStream_SENSOR_STREAM_POWER);
+	PyModule_AddIntConstant(m, "ACK_EACH",
+				mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_EACH);
+	PyModule_AddIntConstant(m, "ACK_ERRORS",
+				mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_ERRORS);
+	PyModule_AddIntConstant(m, "ACK_NONE",
+				mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_NONE);
+	PyModule_AddIntConstant(m, "ACK_CUMULATIVE",
+				mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_CUMULATIVE);
+	PyModule_AddIntConstant(m, "VENDOR_ID", mouthpad::relay_vendor_id);
+	PyModule_AddIntConstant(m, "PRODUCT_ID", mouthpad::relay_product_id);
+	return m;
+}
@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mouthpad/capture.hpp"
+#include "mouthpad/mouthpad.hpp"
+
+namespace mouthpad {
+
+namespace {
+
+constexpr size_t index_header_size = 32;
+constexpr size_t index_entry_size = 16;
+
+void put_le64(uint8_t *out, uint64_t v)
+{
+	for (int i = 0; i < 8; i++) {
+		out[i] = (uint8_t)(v >> (8 * i));
+	}
+}
+
+uint64_t get_le64(const uint8_t *in)
+{
+	uint64_t v = 0;
+
+	for (int i = 7; i >= 0; i--) {
+		v = (v << 8) | in[i];
+	}
+	return v;
+}
+
+/* Time of the last record, walking from an entry */
+uint64_t last_time(const capture_reader &capture, const capture_index::entry &from)
+{
+	struct mouthpad_capture_reader r;
+	mouthpad_capture_record record;
+	uint64_t time_us = from.time_us;
+
+	mouthpad_capture_open(&r, capture.data(), capture.size());
+	r.pos = capture.data() + from.offset;
+	r.time_us = from.time_us;
+	while (mouthpad_capture_next(&r, &record)) {
+		time_us = record.time_us;
+	}
+	return time_us;
+}
+
+} /* namespace */
+
+capture_writer::capture_writer() : buf_(buffer_size)
+{
+}
+
+capture_writer::~capture_writer()
+{
+	close();
+}
+
+int capture_writer::open(const std::string &path)
+{
+	uint64_t wall = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::system_clock::now().time_since_epoch())
+				.count();
+
+	if (fd_ >= 0) {
+		return -EALREADY;
+	}
+
+	fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	if (fd_ < 0) {
+		return -errno;
+	}
+
+	start_ = steady_us();
+	err_ = 0;
+	records_ = 0;
+	bytes_ = MOUTHPAD_CAPTURE_HEADER_SIZE;
+	mouthpad_capture_start(&writer_, buf_.data(), wall);
+	used_ = MOUTHPAD_CAPTURE_HEADER_SIZE;
+	return 0;
+}
+
+int capture_writer::close()
+{
+	int err;
+
+	if (fd_ < 0) {
+		return 0;
+	}
+	flush();
+	::close(fd_);
+	fd_ = -1;
+	err = err_;
+	err_ = 0;
+	return err;
+}
+
+uint64_t capture_writer::now_us() const
+{
+	return steady_us() - start_;
+}
+
+void capture_writer::record_at(uint64_t time_us, mouthpad_capture_channel channel,
+			       mouthpad_capture_direction direction, const uint8_t *data,
+			       size_t len)
+{
+	size_t n;
+
+	if (fd_ < 0) {
+		return;
+	}
+	if (used_ + mouthpad_capture_record_size(&writer_, time_us, len) > buf_.size()) {
+		flush();
+	}
+
+	n = mouthpad_capture_put(&writer_, buf_.data() + used_, buf_.size() - used_, time_us,
+				 channel, direction, data, len);
+	if (n == 0) {
+		/* Longer than the format or the buffer holds */
+		return;
+	}
+	used_ += n;
+	records_++;
+	bytes_ += n;
+
+	if (used_ >= buf_.size() / 2) {
+		flush();
+	}
+}
+
+int capture_writer::flush()
+{
+	size_t done = 0;
+
+	while (done < used_) {
+		ssize_t n = write(fd_, buf_.data() + done, used_ - done);
+
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			/* Keep the file whole up to here; later records are lost */
+			if (!err_) {
+				err_ = -errno;
+			}
+			break;
+		}
+		done += (size_t)n;
+	}
+	used_ = 0;
+	return err_;
+}
+
+capture_reader::~capture_reader()
+{
+	close();
+}
+
+int capture_reader::open(const std::string &path)
+{
+	struct stat st;
+	int fd;
+	void *map;
+
+	close();
+
+	fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return -errno;
+	}
+	if (fstat(fd, &st) < 0 || st.st_size < MOUTHPAD_CAPTURE_HEADER_SIZE) {
+		::close(fd);
+		return -EINVAL;
+	}
+
+	map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED) {
+		return -errno;
+	}
+
+	map_ = static_cast<const uint8_t *>(map);
+	size_ = (size_t)st.st_size;
+	if (!mouthpad_capture_open(&reader_, map_, size_)) {
+		close();
+		return -EINVAL;
+	}
+	/* Replay reads front to back */
+	madvise(map, size_, MADV_SEQUENTIAL);
+	return 0;
+}
+
+void capture_reader::close()
+{
+	if (map_) {
+		munmap(const_cast<uint8_t *>(map_), size_);
+		map_ = nullptr;
+		size_ = 0;
+	}
+	reader_ = {};
+}
+
+void capture_reader::rewind()
+{
+	if (map_) {
+		mouthpad_capture_open(&reader_, map_, size_);
+	}
+}
+
+void capture_reader::seek(const capture_index &index, uint64_t time_us)
+{
+	const auto &entries = index.entries();
+	mouthpad_capture_record record;
+	auto after = std::lower_bound(
+		entries.begin(), entries.end(), time_us,
+		[](const capture_index::entry &e, uint64_t t) { return e.time_us < t; });
+
+	rewind();
+	if (!map_) {
+		return;
+	}
+	/* Every record before the last entry earlier than time_us is earlier too */
+	if (after != entries.begin()) {
+		reader_.pos = map_ + (after - 1)->offset;
+		reader_.time_us = (after - 1)->time_us;
+	}
+	for (struct mouthpad_capture_reader probe = reader_;
+	     mouthpad_capture_next(&probe, &record) && record.time_us < time_us;) {
+		reader_ = probe;
+	}
+}
+
+void capture_index::build(const capture_reader &capture)
+{
+	struct mouthpad_capture_reader r;
+	mouthpad_capture_record record;
+	uint32_t since = 0;
+
+	entries_.clear();
+	capture_size_ = capture.size();
+	start_us_ = capture.start_us();
+	duration_us_ = 0;
+	if (!capture.data() || !mouthpad_capture_open(&r, capture.data(), capture.size())) {
+		return;
+	}
+
+	for (struct mouthpad_capture_reader before = r; mouthpad_capture_next(&r, &record);
+	     before = r) {
+		if (entries_.empty() || since >= records_max ||
+		    record.time_us - entries_.back().time_us >= interval_us) {
+			entries_.push_back({before.time_us, (uint64_t)(before.pos - capture.data())});
+			since = 0;
+		}
+		since++;
+		duration_us_ = record.time_us;
+	}
+}
+
+int capture_index::save(const std::string &path) const
+{
+	std::vector<uint8_t> out(index_header_size + entries_.size() * index_entry_size);
+	uint8_t *p = out.data();
+	size_t done = 0;
+	int err = 0;
+	int fd;
+
+	memcpy(p, "MPIDX", 6);
+	p[6] = version;
+	p[7] = 0;
+	put_le64(p + 8, capture_size_);
+	put_le64(p + 16, start_us_);
+	put_le64(p + 24, entries_.size());
+	p += index_header_size;
+	for (const auto &e : entries_) {
+		put_le64(p, e.time_us);
+		put_le64(p + 8, e.offset);
+		p += index_entry_size;
+	}
+
+	fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		return -errno;
+	}
+	while (done < out.size()) {
+		ssize_t n = write(fd, out.data() + done, out.size() - done);
+
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			err = -errno;
+			break;
+		}
+		done += (size_t)n;
+	}
+	::close(fd);
+	return err;
+}
+
+int capture_index::load(const std::string &path, const capture_reader &capture)
+{
+	std::vector<uint8_t> in;
+	struct stat st;
+	size_t done = 0;
+	uint64_t count;
+	uint64_t prev = 0;
+	int fd;
+
+	entries_.clear();
+	duration_us_ = 0;
+
+	fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return -errno;
+	}
+	if (fstat(fd, &st) < 0 || st.st_size < (off_t)index_header_size) {
+		::close(fd);
+		return -EINVAL;
+	}
+	in.resize((size_t)st.st_size);
+	while (done < in.size()) {
+		ssize_t n = read(fd, in.data() + done, in.size() - done);
+
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		done += (size_t)n;
+	}
+	::close(fd);
+
+	count = get_le64(&in[24]);
+	if (done != in.size() || memcmp(in.data(), "MPIDX", 6) != 0 || in[6] != version ||
+	    count != (in.size() - index_header_size) / index_entry_size ||
+	    (in.size() - index_header_size) % index_entry_size) {
+		return -EINVAL;
+	}
+	capture_size_ = get_le64(&in[8]);
+	start_us_ = get_le64(&in[16]);
+	if (!capture.data() || capture_size_ != capture.size() || start_us_ != capture.start_us()) {
+		return -ESTALE;
+	}
+
+	entries_.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		const uint8_t *e = &in[index_header_size + i * index_entry_size];
+
+		entries_[i].time_us = get_le64(e);
+		entries_[i].offset = get_le64(e + 8);
+		/* A seek must land on a record header inside the mapping */
+		if (entries_[i].offset < MOUTHPAD_CAPTURE_HEADER_SIZE ||
+		    entries_[i].offset >= capture_size_ || entries_[i].time_us < prev ||
+		    (i && entries_[i].offset <= entries_[i - 1].offset)) {
+			entries_.clear();
+			return -EINVAL;
+		}
+		prev = entries_[i].time_us;
+	}
+	if (!entries_.empty()) {
+		duration_us_ = last_time(capture, entries_.back());
+	}
+	return 0;
+}
+
+} /* namespace mouthpad */
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <climits>
+#include <map>
+
+#include "mouthpad/mouthpad.hpp"
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fstream>
+#include <limits.h>
+#include <stdlib.h>
+#elif defined(__APPLE__)
+#include <CoreFoundation/CoreFoundation.h>
+#include <IOKit/IOKitLib.h>
+#include <IOKit/serial/IOSerialKeys.h>
+#include <IOKit/usb/USBSpec.h>
+#endif
+
+namespace mouthpad {
+
+namespace {
+
+/* One ACM port and the USB device it belongs to */
+struct candidate {
+	std::string device;     /* Groups the ports of one device */
+	int interface_number;
+	device_info info;
+};
+
+/* Keep the lowest-numbered interface of each device, CDC0, with the next
+ * one, CDC1, as its console
+ */
+std::vector<device_info> first_ports(const std::vector<candidate> &candidates)
+{
+	struct pair {
+		const candidate *data;
+		const candidate *console;
+	};
+	std::map<std::string, pair> best;
+	std::vector<device_info> out;
+
+	for (const auto &c : candidates) {
+		auto &slot = best[c.device];
+
+		if (!slot.data || c.interface_number < slot.data->interface_number) {
+			slot.console = slot.data;
+			slot.data = &c;
+		} else if (!slot.console || c.interface_number < slot.console->interface_number) {
+			slot.console = &c;
+		}
+	}
+	for (const auto &entry : best) {
+		out.push_back(entry.second.data->info);
+		if (entry.second.console) {
+			out.back().console = entry.second.console->info.path;
+		}
+	}
+	std::sort(out.begin(), out.end(),
+		  [](const device_info &a, const device_info &b) { return a.path < b.path; });
+	return out;
+}
+
+#if defined(__linux__)
+
+std::string read_line(const std::string &path)
+{
+	std::ifstream in(path);
+	std::string line;
+
+	std::getline(in, line);
+	return line;
+}
+
+/* sysfs: /sys/class/tty/ttyACM<n>/device is the USB interface, and its
+ * parent the USB device with idVendor, idProduct and serial
+ */
+std::vector<candidate> list_ports(uint16_t vendor_id, uint16_t product_id)
+{
+	std::vector<candidate> out;
+	DIR *dir = opendir("/sys/class/tty");
+
+	if (!dir) {
+		return out;
+	}
+
+	while (struct dirent *entry = readdir(dir)) {
+		std::string name = entry->d_name;
+		char resolved[PATH_MAX];
+
+		if (name.rfind("ttyACM", 0) != 0) {
+			continue;
+		}
+		if (!realpath(("/sys/class/tty/" + name + "/device").c_str(), resolved)) {
+			continue;
+		}
+
+		std::string interface = resolved;
+		std::string device = interface.substr(0, interface.rfind('/'));
+		unsigned long vid = strtoul(read_line(device + "/idVendor").c_str(), nullptr, 16);
+		unsigned long pid = strtoul(read_line(device + "/idProduct").c_str(), nullptr, 16);
+
+		if (vid != vendor_id || pid != product_id) {
+			continue;
+		}
+
+		out.push_back(candidate{
+			device,
+			(int)strtol(read_line(interface + "/bInterfaceNumber").c_str(), nullptr, 16),
+			device_info{"/dev/" + name, read_line(device + "/serial"), (uint16_t)vid,
+				    (uint16_t)pid, ""},
+		});
+	}
+	closedir(dir);
+	return out;
+}
+
+#elif defined(__APPLE__)
+
+/* Nearest ancestor's integer property, or -1 */
+long long parent_number(io_object_t service, CFStringRef key)
+{
+	long long value = -1;
+	CFTypeRef ref = IORegistryEntrySearchCFProperty(
+		service, kIOServicePlane, key, kCFAllocatorDefault,
+		kIORegistryIterateRecursively | kIORegistryIterateParents);
+
+	if (ref) {
+		if (CFGetTypeID(ref) == CFNumberGetTypeID()) {
+			CFNumberGetValue((CFNumberRef)ref, kCFNumberLongLongType, &value);
+		}
+		CFRelease(ref);
+	}
+	return value;
+}
+
+std::string cf_string(CFTypeRef ref)
+{
+	char buf[256];
+
+	if (!ref || CFGetTypeID(ref) != CFStringGetTypeID() ||
+	    !CFStringGetCString((CFStringRef)ref, buf, sizeof(buf), kCFStringEncodingUTF8)) {
+		return "";
+	}
+	return buf;
+}
+
+std::string parent_string(io_object_t service, CFStringRef key)
+{
+	CFTypeRef ref = IORegistryEntrySearchCFProperty(
+		service, kIOServicePlane, key, kCFAllocatorDefault,
+		kIORegistryIterateRecursively | kIORegistryIterateParents);
+	std::string value = cf_string(ref);
+
+	if (ref) {
+		CFRelease(ref);
+	}
+	return value;
+}
+
+/* IOKit: every serial BSD client, with the USB IDs found up its parents */
+std::vector<candidate> list_ports(uint16_t vendor_id, uint16_t product_id)
+{
+	std::vector<candidate> out;
+	CFMutableDictionaryRef match = IOServiceMatching(kIOSerialBSDServiceValue);
+	io_iterator_t it;
+
+	if (!match) {
+		return out;
+	}
+	CFDictionarySetValue(match, CFSTR(kIOSerialBSDTypeKey), CFSTR(kIOSerialBSDAllTypes));
+	if (IOServiceGetMatchingServices(kIOMainPortDefault, match, &it) != KERN_SUCCESS) {
+		return out;
+	}
+
+	while (io_object_t service = IOIteratorNext(it)) {
+		long long vid = parent_number(service, CFSTR(kUSBVendorID));
+		long long pid = parent_number(service, CFSTR(kUSBProductID));
+
+		if (vid == vendor_id && pid == product_id) {
+			CFTypeRef path = IORegistryEntryCreateCFProperty(
+				service, CFSTR(kIOCalloutDeviceKey), kCFAllocatorDefault, 0);
+			std::string serial = parent_string(service, CFSTR(kUSBSerialNumberString));
+			long long location = parent_number(service, CFSTR(kUSBDevicePropertyLocationID));
+
+			out.push_back(candidate{
+				std::to_string(location) + "/" + serial,
+				(int)parent_number(service, CFSTR(kUSBInterfaceNumber)),
+				device_info{cf_string(path), serial, (uint16_t)vid, (uint16_t)pid, ""},
+			});
+			if (path) {
+				CFRelease(path);
+			}
+		}
+		IOObjectRelease(service);
+	}
+	IOObjectRelease(it);
+	return out;
+}
+
+#else
+
+std::vector<candidate> list_ports(uint16_t, uint16_t)
+{
+	return {};
+}
+
+#endif
+
+} /* namespace */
+
+std::vector<device_info> enumerate(uint16_t vendor_id, uint16_t product_id)
+{
+	return first_ports(list_ports(vendor_id, product_id));
+}
+
+} /* namespace mouthpad */
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/event.h>
+#else
+#error "event_loop needs epoll or kqueue"
+#endif
+
+#include "mouthpad/mouthpad.hpp"
+
+namespace mouthpad {
+
+/* Ready fds taken per wait */
+static constexpr int max_events = 16;
+
+uint64_t steady_us()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+#if defined(__linux__)
+
+event_loop::event_loop()
+{
+	poll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+	wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	struct epoll_event ev = {};
+
+	ev.events = EPOLLIN;
+	ev.data.fd = wake_fd_;
+	epoll_ctl(poll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+}
+
+event_loop::~event_loop()
+{
+	::close(wake_fd_);
+	::close(poll_fd_);
+}
+
+static uint32_t to_epoll(unsigned events)
+{
+	return ((events & event_loop::readable) ? (uint32_t)EPOLLIN : 0) |
+	       ((events & event_loop::writable) ? (uint32_t)EPOLLOUT : 0);
+}
+
+int event_loop::add(int fd, unsigned events, handler on_ready)
+{
+	struct epoll_event ev = {};
+
+	ev.events = to_epoll(events);
+	ev.data.fd = fd;
+	if (epoll_ctl(poll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		return -errno;
+	}
+	watches_[fd] = std::make_shared<watch>(watch{events, std::move(on_ready)});
+	return 0;
+}
+
+int event_loop::modify(int fd, unsigned events)
+{
+	auto it = watches_.find(fd);
+	struct epoll_event ev = {};
+
+	if (it == watches_.end()) {
+		return -ENOENT;
+	}
+	ev.events = to_epoll(events);
+	ev.data.fd = fd;
+	if (epoll_ctl(poll_fd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
+		return -errno;
+	}
+	it->second->events = events;
+	return 0;
+}
+
+void event_loop::remove(int fd)
+{
+	if (watches_.erase(fd) > 0) {
+		epoll_ctl(poll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+	}
+}
+
+int event_loop::run_once(int timeout_ms)
+{
+	struct epoll_event events[max_events];
+	int handled = 0;
+	int n = epoll_wait(poll_fd_, events, max_events, timeout_ms);
+
+	if (n < 0) {
+		return errno == EINTR ? 0 : -errno;
+	}
+
+	for (int i = 0; i < n; i++) {
+		int fd = events[i].data.fd;
+
+		if (fd == wake_fd_) {
+			uint64_t count;
+
+			(void)!read(wake_fd_, &count, sizeof(count));
+			continue;
+		}
+
+		auto it = watches_.find(fd);
+
+		if (it == watches_.end()) {
+			/* Removed by an earlier handler in this batch */
+			continue;
+		}
+
+		/* Keep the handler alive even if it removes itself */
+		std::shared_ptr<watch> w = it->second;
+		uint32_t e = events[i].events;
+		unsigned ready = ((e & EPOLLIN) ? (unsigned)readable : 0) |
+				 ((e & EPOLLOUT) ? (unsigned)writable : 0) |
+				 ((e & (EPOLLHUP | EPOLLERR)) ? (unsigned)hangup : 0);
+
+		w->on_ready(ready);
+		handled++;
+	}
+
+	return handled;
+}
+
+void event_loop::stop()
+{
+	uint64_t one = 1;
+
+	stopped_ = true;
+	(void)!write(wake_fd_, &one, sizeof(one));
+}
+
+#else /* kqueue */
+
+/* Identifies the EVFILT_USER event stop() triggers */
+static constexpr uintptr_t wake_ident = 1;
+
+event_loop::event_loop()
+{
+	struct kevent ev;
+
+	poll_fd_ = kqueue();
+	EV_SET(&ev, wake_ident, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+	kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr);
+}
+
+event_loop::~event_loop()
+{
+	::close(poll_fd_);
+}
+
+/* kqueue keeps read and write interest as separate filters */
+static int set_filters(int kq, int fd, unsigned events)
+{
+	struct kevent ev[2];
+
+	EV_SET(&ev[0], fd, EVFILT_READ, (events & event_loop::readable) ? EV_ADD : EV_DELETE, 0,
+	       0, nullptr);
+	EV_SET(&ev[1], fd, EVFILT_WRITE, (events & event_loop::writable) ? EV_ADD : EV_DELETE, 0,
+	       0, nullptr);
+
+	/* Deleting a filter that was never added fails with ENOENT; ignore it */
+	for (auto &e : ev) {
+		if (kevent(kq, &e, 1, nullptr, 0, nullptr) < 0 && !(e.flags & EV_DELETE)) {
+			return -errno;
+		}
+	}
+	return 0;
+}
+
+int event_loop::add(int fd, unsigned events, handler on_ready)
+{
+	int err = set_filters(poll_fd_, fd, events);
+
+	if (err) {
+		return err;
+	}
+	watches_[fd] = std::make_shared<watch>(watch{events, std::move(on_ready)});
+	return 0;
+}
+
+int event_loop::modify(int fd, unsigned events)
+{
+	auto it = watches_.find(fd);
+
+	if (it == watches_.end()) {
+		return -ENOENT;
+	}
+
+	int err = set_filters(poll_fd_, fd, events);
+
+	if (err) {
+		return err;
+	}
+	it->second->events = events;
+	return 0;
+}
+
+void event_loop::remove(int fd)
+{
+	if (watches_.erase(fd) > 0) {
+		set_filters(poll_fd_, fd, 0);
+	}
+}
+
+int event_loop::run_once(int timeout_ms)
+{
+	struct kevent events[max_events];
+	struct timespec ts = {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+	int handled = 0;
+	int n = kevent(poll_fd_, nullptr, 0, events, max_events, timeout_ms < 0 ? nullptr : &ts);
+
+	if (n < 0) {
+		return errno == EINTR ? 0 : -errno;
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (events[i].filter == EVFILT_USER) {
+			continue;
+		}
+
+		auto it = watches_.find((int)events[i].ident);
+
+		if (it == watches_.end()) {
+			continue;
+		}
+
+		std::shared_ptr<watch> w = it->second;
+		unsigned ready = (events[i].filter == EVFILT_READ ? (unsigned)readable : 0) |
+				 (events[i].filter == EVFILT_WRITE ? (unsigned)writable : 0) |
+				 ((events[i].flags & (EV_EOF | EV_ERROR)) ? (unsigned)hangup : 0);
+
+		w->on_ready(ready);
+		handled++;
+	}
+
+	return handled;
+}
+
+void event_loop::stop()
+{
+	struct kevent ev;
+
+	stopped_ = true;
+	EV_SET(&ev, wake_ident, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+	kevent(poll_fd_, &ev, 1, nullptr, 0, nullptr);
+}
+
+#endif
+
+int event_loop::run()
+{
+	int err = 0;
+
+	while (!stopped_ && err >= 0) {
+		err = run_once(-1);
+	}
+	/* A stop() before run() still ends the next one at once */
+	stopped_ = false;
+	return err < 0 ? err : 0;
+}
+
+} /* namespace mouthpad */
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "mouthpad/frame_scan.hpp"
+#include "mouthpad_crc16.h"
+#include "mouthpad_frame.h"
+
+namespace mouthpad {
+
+namespace {
+
+using find_fn = size_t (*)(const uint8_t *, size_t, size_t);
+
+size_t find_scalar(const uint8_t *data, size_t len, size_t pos)
+{
+	while (pos + 1 < len) {
+		const void *hit = memchr(data + pos, MOUTHPAD_FRAME_MAGIC1, len - 1 - pos);
+
+		if (!hit) {
+			break;
+		}
+		pos = (size_t)(static_cast<const uint8_t *>(hit) - data);
+		if (data[pos + 1] == MOUTHPAD_FRAME_MAGIC2) {
+			return pos;
+		}
+		pos++;
+	}
+	return len;
+}
+
+/*
+ * Each compares a block against the first magic byte and the same block
+ * one byte on against the second; a bit set in both is a magic. The last
+ * block ends one byte early so the shifted load stays in the data.
+ */
+#if defined(__x86_64__)
+
+size_t find_sse2(const uint8_t *data, size_t len, size_t pos)
+{
+	const __m128i m1 = _mm_set1_epi8((char)MOUTHPAD_FRAME_MAGIC1);
+	const __m128i m2 = _mm_set1_epi8((char)MOUTHPAD_FRAME_MAGIC2);
+
+	for (; pos + 17 <= len; pos += 16) {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos + 1));
+		unsigned mask = (unsigned)_mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpeq_epi8(a, m1), _mm_cmpeq_epi8(b, m2)));
+
+		if (mask) {
+			return pos + (size_t)__builtin_ctz(mask);
+		}
+	}
+	return find_scalar(data, len, pos);
+}
+
+__attribute__((target("avx2"))) size_t find_avx2(const uint8_t *data, size_t len, size_t pos)
+{
+	const __m256i m1 = _mm256_set1_epi8((char)MOUTHPAD_FRAME_MAGIC1);
+	const __m256i m2 = _mm256_set1_epi8((char)MOUTHPAD_FRAME_MAGIC2);
+
+	for (; pos + 33 <= len; pos += 32) {
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos + 1));
+		unsigned mask = (unsigned)_mm256_movemask_epi8(
+			_mm256_and_si256(_mm256_cmpeq_epi8(a, m1), _mm256_cmpeq_epi8(b, m2)));
+
+		if (mask) {
+			return pos + (size_t)__builtin_ctz(mask);
+		}
+	}
+	return find_sse2(data, len, pos);
+}
+
+#elif defined(__aarch64__)
+
+size_t find_neon(const uint8_t *data, size_t len, size_t pos)
+{
+	const uint8x16_t m1 = vdupq_n_u8(MOUTHPAD_FRAME_MAGIC1);
+	const uint8x16_t m2 = vdupq_n_u8(MOUTHPAD_FRAME_MAGIC2);
+
+	for (; pos + 17 <= len; pos += 16) {
+		uint8x16_t hit = vandq_u8(vceqq_u8(vld1q_u8(data + pos), m1),
+					  vceqq_u8(vld1q_u8(data + pos + 1), m2));
+		/* No movemask on NEON: narrow each byte to a nibble */
+		uint64_t mask = vget_lane_u64(
+			vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+
+		if (mask) {
+			return pos + (size_t)(__builtin_ctzll(mask) >> 2);
+		}
+	}
+	return find_scalar(data, len, pos);
+}
+
+#endif
+
+struct isa {
+	find_fn find;
+	const char *name;
+};
+
+const isa &pick_isa()
+{
+	static const isa picked = [] {
+#if defined(__x86_64__)
+		if (__builtin_cpu_supports("avx2")) {
+			return isa{find_avx2, "avx2"};
+		}
+		return isa{find_sse2, "sse2"};
+#elif defined(__aarch64__)
+		return isa{find_neon, "neon"};
+#else
+		return isa{find_scalar, "scalar"};
+#endif
+	}();
+
+	return picked;
+}
+
+bool crc_ok(const scanned_frame &frame)
+{
+	const uint8_t *crc = frame.payload + frame.len;
+
+	return mouthpad_crc16(frame.payload, frame.len) == (uint16_t)((crc[0] << 8) | crc[1]);
+}
+
+} /* namespace */
+
+size_t find_frame_magic(const uint8_t *data, size_t len, size_t pos)
+{
+	return pick_isa().find(data, len, pos);
+}
+
+const char *frame_scan_isa()
+{
+	return pick_isa().name;
+}
+
+frame_scan_stats scan_frames(const uint8_t *data, size_t len, const frame_batch_handler &on_batch)
+{
+	const find_fn find = pick_isa().find;
+	scanned_frame batch[frame_scan_batch];
+	frame_scan_stats stats = {};
+	uint64_t framed = 0;
+	size_t pos = 0;
+
+	for (;;) {
+		size_t n = 0;
+		size_t next = pos;
+		bool end = false;
+
+		/* Take the lengths on trust and step from frame to frame */
+		while (n < frame_scan_batch) {
+			size_t at = find(data, len, next);
+			size_t payload_len;
+
+			if (len - at < MOUTHPAD_FRAME_HEADER_SIZE) {
+				end = true;
+				break;
+			}
+			payload_len = (size_t)((data[at + 2] << 8) | data[at + 3]);
+			if (payload_len > MOUTHPAD_FRAME_MAX_PAYLOAD ||
+			    len - at < MOUTHPAD_FRAME_OVERHEAD + payload_len) {
+				/* Settle the batch first; a bad CRC in it may mean this
+				 * magic is only payload
+				 */
+				if (n) {
+					break;
+				}
+				/* Too long, or cut off at the end */
+				if (payload_len > MOUTHPAD_FRAME_MAX_PAYLOAD) {
+					stats.length_errors++;
+				}
+				next = at + 1;
+				continue;
+			}
+			batch[n].offset = at;
+			batch[n].payload = data + at + MOUTHPAD_FRAME_HEADER_SIZE;
+			batch[n].len = (uint16_t)payload_len;
+			n++;
+			next = at + MOUTHPAD_FRAME_OVERHEAD + payload_len;
+		}
+
+		/* Then check them; everything after a bad one was found on its word */
+		size_t good = 0;
+
+		while (good < n && crc_ok(batch[good])) {
+			framed += MOUTHPAD_FRAME_OVERHEAD + batch[good].len;
+			good++;
+		}
+		if (good) {
+			stats.frames += good;
+			on_batch(batch, good);
+		}
+		if (good < n) {
+			stats.crc_errors++;
+			pos = batch[good].offset + 1;
+			continue;
+		}
+		if (end) {
+			break;
+		}
+		pos = next;
+	}
+
+	stats.skipped = len - framed;
+	return stats;
+}
+
+} /* namespace mouthpad */
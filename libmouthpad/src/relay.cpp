@@ -0,0 +1,1053 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <pb_decode.h>
+#include <pb_encode.h>
+
+#include "mouthpad/capture.hpp"
+#include "mouthpad/mouthpad.hpp"
+#include "mouthpad_crc16.h"
+
+namespace mouthpad {
+
+/* Bytes taken per read(); a full-speed CDC ACM port delivers 64 at a time */
+static constexpr size_t rx_buffer_size = 16 * 1024;
+
+/* Protobuf wire types */
+static constexpr uint8_t wt_varint = 0;
+static constexpr uint8_t wt_string = 2;
+
+static constexpr uint8_t key(unsigned tag, uint8_t wire_type)
+{
+	return (uint8_t)((tag << 3) | wire_type);
+}
+
+/* As in common/mouthpad_pass_through.c, every key read by hand is one byte */
+static_assert(mouthware_message_RelayToAppMessage_pass_through_to_app_batch_tag < 16 &&
+		      mouthware_message_PassThroughToApp_device_index_tag < 16 &&
+		      mouthware_message_PassThroughToMouthpad_sequence_tag < 16,
+	      "pass-through tags no longer fit a one-byte key");
+
+static constexpr size_t pass_through_max =
+	pb_membersize(mouthware_message_PassThroughToMouthpad_data_t, bytes);
+
+namespace {
+
+/* Bounds-checked protobuf reader over one field's bytes */
+struct reader {
+	const uint8_t *pos;
+	const uint8_t *end;
+
+	bool varint(uint64_t *value)
+	{
+		uint64_t result = 0;
+
+		for (unsigned shift = 0; shift < 64 && pos < end; shift += 7) {
+			uint8_t byte = *pos++;
+
+			result |= (uint64_t)(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) {
+				*value = result;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool delimited(reader *sub)
+	{
+		uint64_t len;
+
+		if (!varint(&len) || len > (uint64_t)(end - pos)) {
+			return false;
+		}
+		*sub = reader{pos, pos + len};
+		pos += len;
+		return true;
+	}
+};
+
+size_t varint_size(uint32_t value)
+{
+	size_t n = 1;
+
+	while (value >= 0x80) {
+		value >>= 7;
+		n++;
+	}
+	return n;
+}
+
+/* Whether a message starts with the two-byte key of a field numbered 16 to 2047 */
+bool has_long_key(const uint8_t *payload, size_t len, unsigned tag, uint8_t wire_type)
+{
+	unsigned k = (tag << 3) | wire_type;
+
+	return len > 1 && payload[0] == (uint8_t)(k | 0x80) && payload[1] == (uint8_t)(k >> 7);
+}
+
+uint8_t *put_varint(uint8_t *out, uint32_t value)
+{
+	while (value >= 0x80) {
+		*out++ = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (uint8_t)value;
+	return out;
+}
+
+} /* namespace */
+
+relay::relay(event_loop &loop, callbacks cb)
+	: loop_(loop), cb_(std::move(cb)), rx_buf_(rx_buffer_size), tx_buf_(tx_buffer_size),
+	  message_(new mouthware_message_RelayToAppMessage())
+{
+	mouthpad_deframer_init(&deframer_, frame_thunk, error_thunk, this);
+	sensor_codec_decoder_init(&codec_);
+}
+
+relay::~relay()
+{
+	close();
+}
+
+int relay::open(const std::string &path)
+{
+	struct termios tio;
+	int fd;
+
+	if (fd_ >= 0) {
+		return -EALREADY;
+	}
+
+	fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	/* CDC ACM ignores the baud rate, but the line discipline must be raw */
+	if (tcgetattr(fd, &tio) == 0) {
+		cfmakeraw(&tio);
+		cfsetspeed(&tio, B115200);
+		tio.c_cflag |= CLOCAL | CREAD;
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+	/* One owner per port, as the Web Serial page gets */
+	ioctl(fd, TIOCEXCL);
+
+	int err = loop_.add(fd, event_loop::readable, [this](unsigned events) { on_ready(events); });
+
+	if (err) {
+		::close(fd);
+		return err;
+	}
+
+	fd_ = fd;
+	want_write_ = false;
+	tx_head_ = tx_tail_ = 0;
+	cobs_ = false;
+	channels_ = false;
+	fragments_.clear();
+	mouthpad_deframer_reset(&deframer_);
+	return 0;
+}
+
+void relay::close()
+{
+	if (fd_ < 0) {
+		return;
+	}
+	loop_.remove(fd_);
+	::close(fd_);
+	fd_ = -1;
+
+	/* Handlers may send again, so empty the table before calling them */
+	auto pending = std::move(requests_);
+
+	requests_.clear();
+	for (auto &entry : pending) {
+		entry.second(-ENOTCONN, nullptr);
+	}
+}
+
+void relay::fail(int err)
+{
+	close();
+	if (cb_.on_closed) {
+		cb_.on_closed(err);
+	}
+}
+
+void relay::on_ready(unsigned events)
+{
+	if (events & (event_loop::readable | event_loop::hangup)) {
+		read_all();
+	}
+	if (fd_ >= 0 && (events & event_loop::writable)) {
+		flush();
+	}
+}
+
+void relay::read_all()
+{
+	while (fd_ >= 0) {
+		ssize_t n = read(fd_, rx_buf_.data(), rx_buf_.size());
+
+		if (n > 0) {
+			stats_.rx_bytes += (uint64_t)n;
+			/* Frames wholly inside this read are handed over in place */
+			mouthpad_deframer_feed(&deframer_, rx_buf_.data(), (size_t)n);
+		} else if (n == 0) {
+			/* Unplugged: the tty reads end-of-file */
+			fail(-ENODEV);
+		} else if (errno == EINTR) {
+			continue;
+		} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return;
+		} else {
+			fail(-errno);
+		}
+	}
+}
+
+void relay::frame_thunk(const uint8_t *payload, uint16_t len, void *user_data)
+{
+	static_cast<relay *>(user_data)->handle_frame(payload, len);
+}
+
+void relay::error_thunk(enum mouthpad_deframer_error err, uint16_t value, void *user_data)
+{
+	relay *self = static_cast<relay *>(user_data);
+
+	(void)value;
+	if (err == MOUTHPAD_DEFRAMER_ERR_CRC) {
+		self->stats_.crc_errors++;
+	} else {
+		self->stats_.length_errors++;
+	}
+}
+
+void relay::handle_frame(const uint8_t *payload, size_t len)
+{
+	reader r{payload, payload + len};
+	reader body;
+
+	stats_.frames++;
+
+	/* Notifications on the NUS channel come without protobuf around them */
+	struct mouthpad_channel_frame channel;
+
+	if (mouthpad_channel_parse(payload, len, &channel)) {
+		if (channel.channel == MOUTHPAD_CHANNEL_NUS) {
+			deliver(pass_through{channel.data, channel.len, channel.device_index, 0, false},
+				false, 0);
+			return;
+		}
+		if (channel.channel != MOUTHPAD_CHANNEL_CONTROL) {
+			stats_.decode_errors++;
+			return;
+		}
+		payload = channel.data;
+		len = channel.len;
+		r = reader{payload, payload + len};
+	}
+
+	/* A pass-through message is a lone oneof member; anything more goes
+	 * through pb_decode() like every other message
+	 */
+	if (len > 0 && (r.pos++, r.delimited(&body)) && r.pos == r.end) {
+		if (payload[0] == key(mouthware_message_RelayToAppMessage_pass_through_to_app_tag,
+				      wt_string) &&
+		    handle_pass_through(body.pos, body.end - body.pos)) {
+			return;
+		}
+		if (payload[0] ==
+			    key(mouthware_message_RelayToAppMessage_pass_through_to_app_batch_tag,
+				wt_string) &&
+		    handle_batch(body.pos, body.end - body.pos)) {
+			return;
+		}
+	}
+
+	/* Mirrored HID reports are recorded one by one */
+	bool mirrored = (capture_ || cb_.on_hid_mirror) &&
+			has_long_key(payload, len, mouthware_message_RelayToAppMessage_hid_mirror_batch_tag,
+				     wt_string) &&
+			handle_hid_mirror(payload, len);
+
+	if (mirrored && cb_.on_hid_mirror) {
+		return;
+	}
+
+	/* Pass-through and sensor frames are recorded per notification by deliver() */
+	if (capture_ && !mirrored && len > 0 &&
+	    payload[0] != key(mouthware_message_RelayToAppMessage_pass_through_to_app_tag,
+			      wt_string) &&
+	    payload[0] != key(mouthware_message_RelayToAppMessage_pass_through_to_app_batch_tag,
+			      wt_string) &&
+	    !has_long_key(payload, len, mouthware_message_RelayToAppMessage_sensor_frame_delta_tag,
+			  wt_string)) {
+		capture_->record(MOUTHPAD_CAPTURE_CONTROL, MOUTHPAD_CAPTURE_TO_HOST, payload, len);
+	}
+
+	mouthware_message_RelayToAppMessage &message = *message_;
+	pb_istream_t stream = pb_istream_from_buffer(payload, len);
+
+	message = mouthware_message_RelayToAppMessage();
+	if (!pb_decode(&stream, mouthware_message_RelayToAppMessage_fields, &message)) {
+		stats_.decode_errors++;
+		return;
+	}
+	stats_.decoded++;
+
+	if (message.which_message_body ==
+	    mouthware_message_RelayToAppMessage_relay_capabilities_response_tag) {
+		cobs_ = (message.message_body.relay_capabilities_response.features &
+			 mouthware_message_RelayFeature_RELAY_FEATURE_COBS_FRAMING) != 0;
+		channels_ = (message.message_body.relay_capabilities_response.features &
+			     mouthware_message_RelayFeature_RELAY_FEATURE_RAW_CHANNELS) != 0;
+	}
+
+	if (message.request_id && answer(message)) {
+		return;
+	}
+
+	switch (message.which_message_body) {
+	case mouthware_message_RelayToAppMessage_pass_through_to_app_tag: {
+		const auto &p = message.message_body.pass_through_to_app;
+
+		deliver(pass_through{p.data.bytes, p.data.size, p.device_index, 0, false},
+			p.more_fragments, p.fragment);
+		return;
+	}
+	case mouthware_message_RelayToAppMessage_sensor_frame_delta_tag:
+		handle_sensor_frame(message.message_body.sensor_frame_delta);
+		return;
+	case mouthware_message_RelayToAppMessage_ble_connection_status_response_tag:
+		if (cb_.on_status) {
+			cb_.on_status(message.message_body.ble_connection_status_response);
+			return;
+		}
+		break;
+	case mouthware_message_RelayToAppMessage_link_telemetry_tag:
+		if (cb_.on_telemetry) {
+			cb_.on_telemetry(message.message_body.link_telemetry);
+			return;
+		}
+		break;
+	default:
+		break;
+	}
+
+	if (cb_.on_message) {
+		cb_.on_message(message);
+	}
+}
+
+/* Hand a reply to the request() waiting for it */
+bool relay::answer(const mouthware_message_RelayToAppMessage &message)
+{
+	auto it = requests_.find(message.request_id);
+	int err = 0;
+
+	if (it == requests_.end()) {
+		return false;
+	}
+	reply_handler on_reply = std::move(it->second);
+
+	requests_.erase(it);
+	if (message.which_message_body == mouthware_message_RelayToAppMessage_request_error_tag) {
+		switch (message.message_body.request_error.code) {
+		case mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_BUSY:
+			err = -EBUSY;
+			break;
+		case mouthware_message_RequestErrorCode_REQUEST_ERROR_CODE_UNSUPPORTED:
+			err = -ENOTSUP;
+			break;
+		default:
+			err = -EIO;
+			break;
+		}
+	}
+	on_reply(err, err ? nullptr : &message);
+	return true;
+}
+
+bool relay::handle_pass_through(const uint8_t *body, size_t len)
+{
+	reader r{body, body + len};
+	pass_through notification = {body, 0, 0, 0, false};
+	bool more_fragments = false;
+	uint32_t fragment = 0;
+
+	while (r.pos < r.end) {
+		uint8_t k = *r.pos++;
+		reader data;
+		uint64_t value;
+
+		switch (k) {
+		case key(mouthware_message_PassThroughToApp_data_tag, wt_string):
+			if (!r.delimited(&data)) {
+				return false;
+			}
+			notification.data = data.pos;
+			notification.len = data.end - data.pos;
+			break;
+		case key(mouthware_message_PassThroughToApp_more_fragments_tag, wt_varint):
+			if (!r.varint(&value)) {
+				return false;
+			}
+			more_fragments = value != 0;
+			break;
+		case key(mouthware_message_PassThroughToApp_fragment_tag, wt_varint):
+			if (!r.varint(&value) || value > UINT32_MAX) {
+				return false;
+			}
+			fragment = (uint32_t)value;
+			break;
+		case key(mouthware_message_PassThroughToApp_device_index_tag, wt_varint):
+			if (!r.varint(&value) || value > UINT32_MAX) {
+				return false;
+			}
+			notification.device_index = (uint32_t)value;
+			break;
+		default:
+			/* Unknown field: leave it to pb_decode() */
+			return false;
+		}
+	}
+
+	deliver(notification, more_fragments, fragment);
+	return true;
+}
+
+/* Next PassThroughChunk of a batch; false at the end or on a bad chunk */
+static bool next_chunk(reader *r, pass_through *out)
+{
+	reader chunk;
+
+	if (r->pos >= r->end ||
+	    *r->pos++ != key(mouthware_message_PassThroughToAppBatch_chunks_tag, wt_string) ||
+	    !r->delimited(&chunk)) {
+		return false;
+	}
+
+	*out = pass_through{chunk.pos, 0, 0, 0, true};
+	while (chunk.pos < chunk.end) {
+		uint8_t k = *chunk.pos++;
+		reader data;
+		uint64_t value;
+
+		if (k == key(mouthware_message_PassThroughChunk_sequence_tag, wt_varint)) {
+			if (!chunk.varint(&value)) {
+				return false;
+			}
+			out->sequence = (uint32_t)value;
+		} else if (k == key(mouthware_message_PassThroughChunk_data_tag, wt_string)) {
+			if (!chunk.delimited(&data)) {
+				return false;
+			}
+			out->data = data.pos;
+			out->len = data.end - data.pos;
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool relay::handle_batch(const uint8_t *body, size_t len)
+{
+	reader r{body, body + len};
+	pass_through notification;
+
+	/* Check the whole batch first so a bad one is not half delivered */
+	while (next_chunk(&r, &notification)) {
+	}
+	if (r.pos != r.end) {
+		return false;
+	}
+
+	r = reader{body, body + len};
+	while (fd_ >= 0 && next_chunk(&r, &notification)) {
+		deliver(notification, false, 0);
+	}
+	return true;
+}
+
+/* HidMirrorBatch, parsed by hand since nanopb leaves its records to a
+ * callback: each report goes to on_hid_mirror, and to the capture as an
+ * HID record [report_id][report] stamped from its BLE receive offset,
+ * counting back from now for the newest.
+ */
+bool relay::handle_hid_mirror(const uint8_t *payload, size_t len)
+{
+	/* Tag 18 takes a two-byte key */
+	static constexpr unsigned batch_key =
+		(mouthware_message_RelayToAppMessage_hid_mirror_batch_tag << 3) | wt_string;
+	static_assert(batch_key >= 0x80 && batch_key < 0x4000, "HidMirrorBatch key is not two bytes");
+
+	reader r{payload, payload + len};
+	reader body;
+	uint64_t newest = 0;
+	uint64_t base_us = 0;
+	uint32_t sequence = 0;
+	uint64_t now = capture_ ? capture_->now_us() : 0;
+
+	if (len < 2 || payload[0] != (uint8_t)(batch_key | 0x80) ||
+	    payload[1] != (uint8_t)(batch_key >> 7)) {
+		return false;
+	}
+	r.pos += 2;
+	if (!r.delimited(&body) || r.pos != r.end) {
+		return false;
+	}
+
+	/* Two passes: check everything and find the newest offset, then deliver */
+	for (int pass = 0; pass < 2; pass++) {
+		reader b = body;
+		uint32_t index = 0;
+
+		while (b.pos < b.end) {
+			uint8_t k = *b.pos++;
+			reader rec;
+			uint64_t value;
+
+			if (k != key(mouthware_message_HidMirrorBatch_records_tag, wt_string)) {
+				if ((k & 7) != wt_varint || !b.varint(&value)) {
+					return false;
+				}
+				if (k == key(mouthware_message_HidMirrorBatch_sequence_tag, wt_varint)) {
+					sequence = (uint32_t)value;
+				} else if (k == key(mouthware_message_HidMirrorBatch_base_us_tag, wt_varint)) {
+					base_us = value;
+				}
+				continue;
+			}
+			if (!b.delimited(&rec)) {
+				return false;
+			}
+
+			uint8_t report[1 + sizeof(mouthware_message_HidMirrorRecord_data_t::bytes)];
+			hid_mirror_report mirrored = {};
+
+			report[0] = 0;
+			mirrored.data = &report[1];
+			mirrored.submitted = true;
+			while (rec.pos < rec.end) {
+				uint8_t rk = *rec.pos++;
+				reader data;
+
+				if (rk == key(mouthware_message_HidMirrorRecord_data_tag, wt_string)) {
+					if (!rec.delimited(&data) ||
+					    (size_t)(data.end - data.pos) > sizeof(report) - 1) {
+						return false;
+					}
+					memcpy(&report[1], data.pos, data.end - data.pos);
+					mirrored.len = data.end - data.pos;
+				} else if ((rk & 7) == wt_varint && rec.varint(&value)) {
+					if (rk == key(mouthware_message_HidMirrorRecord_report_id_tag, wt_varint)) {
+						report[0] = (uint8_t)value;
+						mirrored.report_id = (uint8_t)value;
+					} else if (rk == key(mouthware_message_HidMirrorRecord_ble_rx_offset_us_tag,
+							     wt_varint)) {
+						mirrored.ble_rx_us = value;
+					} else if (rk == key(mouthware_message_HidMirrorRecord_usb_submit_delay_us_tag,
+							     wt_varint)) {
+						mirrored.usb_submit_delay_us = (uint32_t)value;
+					} else if (rk == key(mouthware_message_HidMirrorRecord_not_submitted_tag,
+							     wt_varint)) {
+						mirrored.submitted = value == 0;
+					}
+				} else {
+					return false;
+				}
+			}
+
+			if (pass == 0) {
+				newest = mirrored.ble_rx_us > newest ? mirrored.ble_rx_us : newest;
+				continue;
+			}
+			if (capture_) {
+				uint64_t age = newest - mirrored.ble_rx_us;
+
+				capture_->record_at(now > age ? now - age : 0, MOUTHPAD_CAPTURE_HID,
+						    MOUTHPAD_CAPTURE_TO_HOST, report, 1 + mirrored.len);
+			}
+			if (cb_.on_hid_mirror) {
+				mirrored.sequence = sequence + index;
+				mirrored.ble_rx_us += base_us;
+				cb_.on_hid_mirror(mirrored);
+			}
+			index++;
+		}
+	}
+	return true;
+}
+
+void relay::deliver(const pass_through &notification, bool more_fragments, uint32_t fragment)
+{
+	auto it = fragments_.find(notification.device_index);
+
+	if (!more_fragments && fragment == 0) {
+		/* The common case: one whole notification, still in the RX buffer */
+		if (it != fragments_.end()) {
+			fragments_.erase(it);
+		}
+		stats_.pass_through++;
+		if (capture_) {
+			capture_->record(MOUTHPAD_CAPTURE_NUS, MOUTHPAD_CAPTURE_TO_HOST, notification.data,
+					 notification.len);
+		}
+		if (cb_.on_pass_through) {
+			cb_.on_pass_through(notification);
+		}
+		return;
+	}
+
+	if (fragment == 0) {
+		partial &p = fragments_[notification.device_index];
+
+		p.data.assign(notification.data, notification.data + notification.len);
+		p.next = 1;
+	} else if (it == fragments_.end() || it->second.next != fragment) {
+		/* Lost the start or a middle piece; wait for the next fragment 0 */
+		if (it != fragments_.end()) {
+			fragments_.erase(it);
+		}
+		return;
+	} else {
+		it->second.data.insert(it->second.data.end(), notification.data,
+				       notification.data + notification.len);
+		it->second.next++;
+	}
+
+	if (more_fragments) {
+		return;
+	}
+
+	partial joined = std::move(fragments_[notification.device_index]);
+	pass_through whole = notification;
+
+	fragments_.erase(notification.device_index);
+	whole.data = joined.data.data();
+	whole.len = joined.data.size();
+	stats_.pass_through++;
+	if (capture_) {
+		capture_->record(MOUTHPAD_CAPTURE_NUS, MOUTHPAD_CAPTURE_TO_HOST, whole.data, whole.len);
+	}
+	if (cb_.on_pass_through) {
+		cb_.on_pass_through(whole);
+	}
+}
+
+void relay::handle_sensor_frame(const mouthware_message_SensorFrameDelta &delta)
+{
+	uint32_t lost = codec_.skipped + codec_.errors;
+	size_t len = sensor_codec_decode(&codec_, &delta);
+
+	stats_.codec_dropped += codec_.skipped + codec_.errors - lost;
+	if (len > 0) {
+		deliver(pass_through{codec_.frame, len, 0, 0, false}, false, 0);
+	}
+}
+
+/* Control channel header for a write, if the relay takes channels */
+size_t relay::control_header(uint8_t *out) const
+{
+	return channels_ ? mouthpad_channel_header(out, MOUTHPAD_CHANNEL_CONTROL, 0) : 0;
+}
+
+uint8_t *relay::tx_claim(size_t len)
+{
+	/* The payload goes behind the header either way; a COBS frame is
+	 * written over it from the start
+	 */
+	size_t need = std::max<size_t>(MOUTHPAD_FRAME_OVERHEAD + len,
+				       cobs_ ? MOUTHPAD_FRAME_COBS_SIZE(len) : 0);
+
+	if (fd_ < 0) {
+		return nullptr;
+	}
+	if (tx_tail_ + need > tx_buf_.size() && tx_head_ > 0) {
+		memmove(tx_buf_.data(), tx_buf_.data() + tx_head_, tx_tail_ - tx_head_);
+		tx_tail_ -= tx_head_;
+		tx_head_ = 0;
+	}
+	if (tx_tail_ + need > tx_buf_.size()) {
+		stats_.tx_full++;
+		return nullptr;
+	}
+	return tx_buf_.data() + tx_tail_;
+}
+
+void relay::tx_commit(uint8_t *frame, size_t payload_len)
+{
+	if (cobs_) {
+		size_t n = mouthpad_frame_cobs(cobs_buf_, frame + MOUTHPAD_FRAME_HEADER_SIZE,
+					       payload_len);
+
+		memcpy(frame, cobs_buf_, n);
+		tx_tail_ += n;
+	} else {
+		uint16_t crc = mouthpad_crc16(frame + MOUTHPAD_FRAME_HEADER_SIZE, payload_len);
+
+		frame[0] = MOUTHPAD_FRAME_MAGIC1;
+		frame[1] = MOUTHPAD_FRAME_MAGIC2;
+		frame[2] = (uint8_t)(payload_len >> 8);
+		frame[3] = (uint8_t)payload_len;
+		frame[MOUTHPAD_FRAME_HEADER_SIZE + payload_len] = (uint8_t)(crc >> 8);
+		frame[MOUTHPAD_FRAME_HEADER_SIZE + payload_len + 1] = (uint8_t)crc;
+		tx_tail_ += MOUTHPAD_FRAME_OVERHEAD + payload_len;
+	}
+
+	/* Already waiting for the port to drain: the loop writes it */
+	if (!want_write_) {
+		flush();
+	}
+}
+
+void relay::flush()
+{
+	while (tx_head_ < tx_tail_) {
+		ssize_t n = write(fd_, tx_buf_.data() + tx_head_, tx_tail_ - tx_head_);
+
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				if (!want_write_) {
+					want_write_ = true;
+					loop_.modify(fd_, event_loop::readable | event_loop::writable);
+				}
+				return;
+			}
+			fail(-errno);
+			return;
+		}
+		tx_head_ += (size_t)n;
+		stats_.tx_bytes += (uint64_t)n;
+	}
+
+	tx_head_ = tx_tail_ = 0;
+	if (want_write_) {
+		want_write_ = false;
+		loop_.modify(fd_, event_loop::readable);
+	}
+}
+
+int relay::send(const mouthware_message_AppToRelayMessage &message)
+{
+	uint8_t *frame;
+	size_t header;
+	pb_ostream_t stream;
+
+	if (fd_ < 0) {
+		return -ENOTCONN;
+	}
+	frame = tx_claim(MOUTHPAD_CHANNEL_HEADER_SIZE + mouthware_message_AppToRelayMessage_size);
+	if (!frame) {
+		return -ENOBUFS;
+	}
+
+	header = control_header(frame + MOUTHPAD_FRAME_HEADER_SIZE);
+	stream = pb_ostream_from_buffer(frame + MOUTHPAD_FRAME_HEADER_SIZE + header,
+					mouthware_message_AppToRelayMessage_size);
+	if (!pb_encode(&stream, mouthware_message_AppToRelayMessage_fields, &message)) {
+		return -EMSGSIZE;
+	}
+
+	if (capture_) {
+		capture_->record(MOUTHPAD_CAPTURE_CONTROL, MOUTHPAD_CAPTURE_TO_DEVICE,
+				 frame + MOUTHPAD_FRAME_HEADER_SIZE + header, stream.bytes_written);
+	}
+	tx_commit(frame, header + stream.bytes_written);
+	return 0;
+}
+
+int relay::request(mouthware_message_AppToRelayMessage &message, reply_handler on_reply)
+{
+	int err;
+
+	/* 0 means no id; skip it and any id still waiting after a wrap */
+	do {
+		message.request_id = ++next_request_id_;
+	} while (message.request_id == 0 || requests_.count(message.request_id));
+
+	err = send(message);
+	if (err) {
+		return err;
+	}
+	requests_[message.request_id] = std::move(on_reply);
+	return 0;
+}
+
+int relay::set_hid_mirror(bool enabled)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_hid_mirror_config_write_tag;
+	message.message_body.hid_mirror_config_write.enabled = enabled;
+	return send(message);
+}
+
+int relay::send_echo(uint32_t sequence, const uint8_t *mouthpad_payload, size_t len)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+	mouthware_message_EchoRequest &echo = message.message_body.echo_request;
+
+	if (len > sizeof(echo.payload.bytes)) {
+		return -EMSGSIZE;
+	}
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_echo_request_tag;
+	echo.host_timestamp_us = steady_us();
+	echo.sequence = sequence;
+	echo.via_mouthpad = len > 0;
+	memcpy(echo.payload.bytes, mouthpad_payload, len);
+	echo.payload.size = (pb_size_t)len;
+	return send(message);
+}
+
+int relay::send_payload(const uint8_t *payload, size_t len)
+{
+	uint8_t *frame;
+	size_t header;
+
+	if (fd_ < 0) {
+		return -ENOTCONN;
+	}
+	if (len > MOUTHPAD_FRAME_MAX_PAYLOAD - MOUTHPAD_CHANNEL_HEADER_SIZE) {
+		return -EMSGSIZE;
+	}
+	frame = tx_claim(MOUTHPAD_CHANNEL_HEADER_SIZE + len);
+	if (!frame) {
+		return -ENOBUFS;
+	}
+
+	header = control_header(frame + MOUTHPAD_FRAME_HEADER_SIZE);
+	memcpy(frame + MOUTHPAD_FRAME_HEADER_SIZE + header, payload, len);
+	if (capture_) {
+		capture_->record(MOUTHPAD_CAPTURE_CONTROL, MOUTHPAD_CAPTURE_TO_DEVICE, payload, len);
+	}
+	tx_commit(frame, header + len);
+	return 0;
+}
+
+int relay::send_pass_through(const uint8_t *data, size_t len, uint32_t device_index,
+			     bool reliable, mouthware_message_PassThroughAckMode ack,
+			     uint32_t sequence)
+{
+	size_t body;
+	size_t payload;
+	uint8_t *frame;
+	uint8_t *out;
+
+	if (fd_ < 0) {
+		return -ENOTCONN;
+	}
+	if (len > pass_through_max) {
+		return -EMSGSIZE;
+	}
+
+	/* Unacknowledged writes go on the NUS channel as they are */
+	if (channels_ && !reliable && sequence == 0 && device_index <= UINT8_MAX &&
+	    ack == mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_NONE) {
+		frame = tx_claim(MOUTHPAD_CHANNEL_HEADER_SIZE + len);
+		if (!frame) {
+			return -ENOBUFS;
+		}
+		out = frame + MOUTHPAD_FRAME_HEADER_SIZE;
+		out += mouthpad_channel_header(out, MOUTHPAD_CHANNEL_NUS, (uint8_t)device_index);
+		memcpy(out, data, len);
+		if (capture_) {
+			capture_->record(MOUTHPAD_CAPTURE_NUS, MOUTHPAD_CAPTURE_TO_DEVICE, data, len);
+		}
+		tx_commit(frame, MOUTHPAD_CHANNEL_HEADER_SIZE + len);
+		return 0;
+	}
+
+	body = 1 + varint_size((uint32_t)len) + len + (reliable ? 2 : 0) +
+	       (device_index ? 1 + varint_size(device_index) : 0) +
+	       (ack ? 1 + varint_size((uint32_t)ack) : 0) +
+	       (sequence ? 1 + varint_size(sequence) : 0);
+	payload = 2 + 1 + varint_size((uint32_t)body) + body;
+
+	frame = tx_claim(MOUTHPAD_CHANNEL_HEADER_SIZE + payload);
+	if (!frame) {
+		return -ENOBUFS;
+	}
+
+	/* AppToRelayMessage { destination = MOUTHPAD, pass_through_to_mouthpad } */
+	out = frame + MOUTHPAD_FRAME_HEADER_SIZE;
+	out += control_header(out);
+	payload += out - (frame + MOUTHPAD_FRAME_HEADER_SIZE);
+	*out++ = key(mouthware_message_AppToRelayMessage_destination_tag, wt_varint);
+	*out++ = mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD;
+	*out++ = key(mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag, wt_string);
+	out = put_varint(out, (uint32_t)body);
+	*out++ = key(mouthware_message_PassThroughToMouthpad_data_tag, wt_string);
+	out = put_varint(out, (uint32_t)len);
+	memcpy(out, data, len);
+	out += len;
+	if (reliable) {
+		*out++ = key(mouthware_message_PassThroughToMouthpad_reliable_tag, wt_varint);
+		*out++ = 1;
+	}
+	if (device_index) {
+		*out++ = key(mouthware_message_PassThroughToMouthpad_device_index_tag, wt_varint);
+		out = put_varint(out, device_index);
+	}
+	if (ack) {
+		*out++ = key(mouthware_message_PassThroughToMouthpad_ack_tag, wt_varint);
+		out = put_varint(out, (uint32_t)ack);
+	}
+	if (sequence) {
+		*out++ = key(mouthware_message_PassThroughToMouthpad_sequence_tag, wt_varint);
+		out = put_varint(out, sequence);
+	}
+
+	if (capture_) {
+		capture_->record(MOUTHPAD_CAPTURE_NUS, MOUTHPAD_CAPTURE_TO_DEVICE, data, len);
+	}
+	tx_commit(frame, payload);
+	return 0;
+}
+
+int relay::read_status(bool scan_boost)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body =
+		mouthware_message_AppToRelayMessage_ble_connection_status_read_tag;
+	message.message_body.ble_connection_status_read.scan_boost = scan_boost;
+	return send(message);
+}
+
+int relay::read_capabilities()
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body =
+		mouthware_message_AppToRelayMessage_relay_capabilities_read_tag;
+	return send(message);
+}
+
+int relay::subscribe_telemetry(uint32_t interval_ms, bool on_change)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_link_telemetry_subscribe_tag;
+	message.message_body.link_telemetry_subscribe.interval_ms = interval_ms;
+	message.message_body.link_telemetry_subscribe.on_change = on_change;
+	return send(message);
+}
+
+int relay::set_batching(bool enabled)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body =
+		mouthware_message_AppToRelayMessage_pass_through_batch_config_write_tag;
+	message.message_body.pass_through_batch_config_write.enabled = enabled;
+	return send(message);
+}
+
+int relay::set_sensor_codec(bool enabled, uint32_t keyframe_interval)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_sensor_codec_config_write_tag;
+	message.message_body.sensor_codec_config_write.enabled = enabled;
+	message.message_body.sensor_codec_config_write.keyframe_interval = keyframe_interval;
+	return send(message);
+}
+
+int relay::set_stream_filter(uint32_t blocked)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body =
+		mouthware_message_AppToRelayMessage_sensor_stream_filter_write_tag;
+	message.message_body.sensor_stream_filter_write.blocked = blocked;
+	return send(message);
+}
+
+int relay::set_stream_rate(mouthware_message_SensorStream stream, uint32_t keep_one_in,
+			   uint32_t min_interval_us)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_sensor_stream_rate_write_tag;
+	message.message_body.sensor_stream_rate_write.stream = stream;
+	message.message_body.sensor_stream_rate_write.keep_one_in = keep_one_in;
+	message.message_body.sensor_stream_rate_write.min_interval_us = min_interval_us;
+	return send(message);
+}
+
+int relay::set_profile(mouthware_message_RelayProfile profile,
+		       const mouthware_message_RelayProfileKnobValue *overrides, size_t count,
+		       bool clear_overrides)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+	mouthware_message_RelayProfileWrite &write = message.message_body.relay_profile_write;
+
+	if (count > sizeof(write.overrides) / sizeof(write.overrides[0])) {
+		return -EINVAL;
+	}
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_relay_profile_write_tag;
+	write.profile = profile;
+	write.clear_overrides = clear_overrides;
+	write.overrides_count = (pb_size_t)count;
+	for (size_t i = 0; i < count; i++) {
+		write.overrides[i] = overrides[i];
+	}
+	return send(message);
+}
+
+int relay::set_usb_composition(mouthware_message_UsbComposition composition, bool reenumerate)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_usb_composition_write_tag;
+	message.message_body.usb_composition_write.composition = composition;
+	message.message_body.usb_composition_write.reenumerate = reenumerate;
+	return send(message);
+}
+
+} /* namespace mouthpad */
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "mouthpad/relay_group.hpp"
+
+namespace mouthpad {
+
+struct relay_group::device {
+	device(relay_group &group, uint32_t id, const std::string &path, size_t events,
+	       size_t commands)
+		: group(group), id(id), path(path), events(events), commands(commands)
+	{
+	}
+
+	relay_group &group;
+	uint32_t id;
+	std::string path;
+	std::unique_ptr<mouthpad::relay> relay;
+	spsc_ring<group_event> events;
+	spsc_ring<command> commands;
+
+	/* I/O thread only: fill the slot claim() returns, then publish() */
+	group_event *claim(group_event::kind type);
+	void publish();
+
+	/* Written by the I/O thread, read by stats() */
+	std::atomic<uint32_t> pushed{0};
+	std::atomic<uint32_t> dropped{0};
+	std::atomic<uint32_t> oversize{0};
+	std::atomic<uint32_t> taken{0};
+	std::atomic<uint32_t> send_errors{0};
+};
+
+static uint64_t now_us()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+/* Non-blocking pipe for wakeups; pipe2() is Linux only */
+static int wake_pipe(int fds[2])
+{
+	if (pipe(fds) < 0) {
+		return -errno;
+	}
+	for (int i = 0; i < 2; i++) {
+		fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+		fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+	}
+	return 0;
+}
+
+static void drain(int fd)
+{
+	uint8_t buf[64];
+
+	while (read(fd, buf, sizeof(buf)) > 0) {
+	}
+}
+
+group_event *relay_group::device::claim(group_event::kind type)
+{
+	group_event *e = events.claim();
+
+	if (!e) {
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	e->time_us = now_us();
+	e->device = id;
+	e->type = type;
+	e->batched = false;
+	e->device_index = 0;
+	e->sequence = 0;
+	e->len = 0;
+	return e;
+}
+
+void relay_group::device::publish()
+{
+	events.push();
+	pushed.fetch_add(1, std::memory_order_relaxed);
+	group.signal_app();
+}
+
+relay_group::relay_group(size_t events_per_device, size_t commands_per_device)
+	: events_depth_(events_per_device), commands_depth_(commands_per_device)
+{
+	wake_pipe(io_pipe_);
+	wake_pipe(app_pipe_);
+	loop_.add(io_pipe_[0], event_loop::readable, [this](unsigned) { on_commands(); });
+}
+
+relay_group::~relay_group()
+{
+	stop();
+	devices_.clear();
+	loop_.remove(io_pipe_[0]);
+	for (int fd : {io_pipe_[0], io_pipe_[1], app_pipe_[0], app_pipe_[1]}) {
+		::close(fd);
+	}
+}
+
+int relay_group::add(const std::string &path, capture_writer *capture)
+{
+	uint32_t id = (uint32_t)devices_.size();
+	relay::callbacks cb;
+
+	if (running_) {
+		return -EBUSY;
+	}
+
+	auto d = std::make_unique<device>(*this, id, path, events_depth_, commands_depth_);
+	device *dev = d.get();
+
+	cb.on_pass_through = [dev](const pass_through &p) {
+		if (p.len > group_event::max_data) {
+			dev->oversize.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		group_event *e = dev->claim(group_event::pass_through);
+
+		if (!e) {
+			return;
+		}
+		e->batched = p.batched;
+		e->device_index = p.device_index;
+		e->sequence = p.sequence;
+		e->len = (uint16_t)p.len;
+		memcpy(e->data, p.data, p.len);
+		dev->publish();
+	};
+	cb.on_status = [dev](const mouthware_message_BleConnectionStatusResponse &s) {
+		group_event *e = dev->claim(group_event::status);
+
+		if (e) {
+			e->body.status = s;
+			dev->publish();
+		}
+	};
+	cb.on_telemetry = [dev](const mouthware_message_LinkTelemetry &t) {
+		group_event *e = dev->claim(group_event::telemetry);
+
+		if (e) {
+			e->body.telemetry = t;
+			dev->publish();
+		}
+	};
+	cb.on_message = [dev](const mouthware_message_RelayToAppMessage &m) {
+		group_event *e = dev->claim(group_event::message);
+
+		if (e) {
+			e->body.message = m;
+			dev->publish();
+		}
+	};
+	cb.on_closed = [dev](int err) {
+		group_event *e = dev->claim(group_event::closed);
+
+		if (e) {
+			e->body.err = err;
+			dev->publish();
+		}
+	};
+
+	d->relay = std::make_unique<relay>(loop_, cb);
+	d->relay->set_capture(capture);
+
+	int err = d->relay->open(path);
+
+	if (err) {
+		return err;
+	}
+	devices_.push_back(std::move(d));
+	return (int)id;
+}
+
+int relay_group::add_all()
+{
+	int opened = 0;
+
+	for (const auto &info : enumerate()) {
+		if (add(info.path) >= 0) {
+			opened++;
+		}
+	}
+	return opened;
+}
+
+const std::string &relay_group::path(uint32_t device) const
+{
+	return devices_.at(device)->path;
+}
+
+int relay_group::start()
+{
+	if (running_) {
+		return -EALREADY;
+	}
+	stopping_ = false;
+	running_ = true;
+	thread_ = std::thread([this] { io_thread(); });
+	return 0;
+}
+
+void relay_group::stop()
+{
+	if (!running_) {
+		return;
+	}
+	stopping_ = true;
+	loop_.stop();
+	thread_.join();
+	running_ = false;
+}
+
+void relay_group::io_thread()
+{
+	while (!stopping_) {
+		if (loop_.run_once(-1) < 0) {
+			break;
+		}
+	}
+}
+
+void relay_group::signal_app()
+{
+	uint8_t one = 1;
+
+	/* One pipe write until the application next waits, not one per event */
+	if (!app_signalled_.load(std::memory_order_relaxed) && !app_signalled_.exchange(true)) {
+		(void)!write(app_pipe_[1], &one, 1);
+	}
+}
+
+void relay_group::on_commands()
+{
+	/* Drain before clearing so a signal sent in between is not lost */
+	drain(io_pipe_[0]);
+	io_signalled_ = false;
+
+	for (auto &d : devices_) {
+		while (command *c = d->commands.front()) {
+			int err;
+
+			if (c->type == command::message) {
+				err = d->relay->send(c->body.message);
+			} else {
+				err = d->relay->send_pass_through(c->body.data, c->len, c->device_index,
+								  c->reliable, c->ack);
+			}
+			d->commands.pop();
+			d->taken.fetch_add(1, std::memory_order_relaxed);
+			if (err) {
+				d->send_errors.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+}
+
+relay_group::command *relay_group::claim_command(uint32_t device)
+{
+	if (device >= devices_.size()) {
+		return nullptr;
+	}
+	return devices_[device]->commands.claim();
+}
+
+void relay_group::push_command(uint32_t device)
+{
+	uint8_t one = 1;
+
+	devices_[device]->commands.push();
+	if (!io_signalled_.exchange(true)) {
+		(void)!write(io_pipe_[1], &one, 1);
+	}
+}
+
+int relay_group::send(uint32_t device, const mouthware_message_AppToRelayMessage &message)
+{
+	if (device >= devices_.size()) {
+		return -ENODEV;
+	}
+
+	command *c = claim_command(device);
+
+	if (!c) {
+		return -ENOBUFS;
+	}
+	c->type = command::message;
+	c->body.message = message;
+	push_command(device);
+	return 0;
+}
+
+int relay_group::send_pass_through(uint32_t device, const uint8_t *data, size_t len,
+				   uint32_t device_index, bool reliable,
+				   mouthware_message_PassThroughAckMode ack)
+{
+	if (device >= devices_.size()) {
+		return -ENODEV;
+	}
+	if (len > pb_membersize(mouthware_message_PassThroughToMouthpad_data_t, bytes)) {
+		return -EMSGSIZE;
+	}
+
+	command *c = claim_command(device);
+
+	if (!c) {
+		return -ENOBUFS;
+	}
+	c->type = command::pass_through;
+	c->reliable = reliable;
+	c->ack = ack;
+	c->device_index = device_index;
+	c->len = (uint16_t)len;
+	memcpy(c->body.data, data, len);
+	push_command(device);
+	return 0;
+}
+
+int relay_group::read_status(uint32_t device, bool scan_boost)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body =
+		mouthware_message_AppToRelayMessage_ble_connection_status_read_tag;
+	message.message_body.ble_connection_status_read.scan_boost = scan_boost;
+	return send(device, message);
+}
+
+int relay_group::subscribe_telemetry(uint32_t device, uint32_t interval_ms, bool on_change)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body = mouthware_message_AppToRelayMessage_link_telemetry_subscribe_tag;
+	message.message_body.link_telemetry_subscribe.interval_ms = interval_ms;
+	message.message_body.link_telemetry_subscribe.on_change = on_change;
+	return send(device, message);
+}
+
+int relay_group::set_batching(uint32_t device, bool enabled)
+{
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+
+	message.destination =
+		mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY;
+	message.which_message_body =
+		mouthware_message_AppToRelayMessage_pass_through_batch_config_write_tag;
+	message.message_body.pass_through_batch_config_write.enabled = enabled;
+	return send(device, message);
+}
+
+size_t relay_group::poll(const std::function<void(const group_event &)> &on_event, size_t max)
+{
+	size_t handed = 0;
+
+	/* Linear merge: the heads are few and already in order per device */
+	while (handed < max) {
+		device *oldest = nullptr;
+		group_event *first = nullptr;
+
+		for (auto &d : devices_) {
+			group_event *e = d->events.front();
+
+			if (e && (!first || e->time_us < first->time_us)) {
+				oldest = d.get();
+				first = e;
+			}
+		}
+		if (!first) {
+			break;
+		}
+		on_event(*first);
+		oldest->events.pop();
+		handed++;
+	}
+	return handed;
+}
+
+bool relay_group::wait(int timeout_ms)
+{
+	struct pollfd pfd = {app_pipe_[0], POLLIN, 0};
+
+	if (::poll(&pfd, 1, timeout_ms) <= 0) {
+		return false;
+	}
+	drain(app_pipe_[0]);
+	app_signalled_ = false;
+	return true;
+}
+
+group_device_stats relay_group::stats(uint32_t device) const
+{
+	const auto &d = *devices_.at(device);
+
+	return group_device_stats{
+		d.pushed.load(std::memory_order_relaxed),
+		d.dropped.load(std::memory_order_relaxed),
+		d.oversize.load(std::memory_order_relaxed),
+		d.taken.load(std::memory_order_relaxed),
+		d.send_errors.load(std::memory_order_relaxed),
+	};
+}
+
+} /* namespace mouthpad */
@@ -0,0 +1,586 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+#include "mouthpad/capture.hpp"
+#include "mouthpad/sensor_export.hpp"
+
+namespace mouthpad {
+
+namespace {
+
+/* Sensor frame fields, as web/script.js SensorView reads them */
+constexpr size_t header_size = 4;
+constexpr size_t packet_index_offset = header_size;
+constexpr size_t cap_offset = header_size + 20;
+constexpr size_t cap_cells = 44;
+constexpr size_t pressure_offset = header_size + 108;
+constexpr size_t pressure_upper_offset = pressure_offset + 17;
+constexpr size_t pressure_lower_offset = pressure_offset + 21;
+
+/* Arrow format enums (Schema.fbs, Message.fbs) */
+constexpr int16_t metadata_v5 = 4;
+constexpr uint8_t header_schema = 1;
+constexpr uint8_t header_record_batch = 3;
+constexpr uint8_t type_int = 2;
+constexpr uint8_t type_floating_point = 3;
+constexpr uint8_t type_binary = 4;
+constexpr uint8_t type_timestamp = 10;
+constexpr uint8_t type_fixed_size_list = 16;
+constexpr int16_t precision_single = 1;
+constexpr int16_t unit_microsecond = 2;
+
+/*
+ * Just enough of a FlatBuffers builder for Arrow's IPC metadata. As with
+ * the real one, the buffer grows towards its front, so an object is built
+ * before anything that refers to it; objects are named by their distance
+ * from the end of the buffer.
+ */
+class flatbuffer {
+public:
+	size_t size() const { return buf_.size(); }
+
+	template <typename T> void prepend(T value)
+	{
+		uint8_t bytes[sizeof(T)];
+		uint64_t v = 0;
+
+		memcpy(&v, &value, sizeof(T));
+		for (size_t i = 0; i < sizeof(T); i++) {
+			bytes[i] = (uint8_t)(v >> (8 * i));
+		}
+		align(sizeof(T), sizeof(T));
+		buf_.insert(buf_.begin(), bytes, bytes + sizeof(T));
+	}
+
+	uint32_t string(const char *s)
+	{
+		size_t len = strlen(s);
+
+		align(len + 1, 4);
+		buf_.insert(buf_.begin(), 0);
+		buf_.insert(buf_.begin(), s, s + len);
+		prepend<uint32_t>((uint32_t)len);
+		return (uint32_t)size();
+	}
+
+	/* FieldNode and Buffer are both a pair of longs */
+	uint32_t pairs(const std::vector<std::pair<int64_t, int64_t>> &v)
+	{
+		align(v.size() * 16, 8);
+		for (auto it = v.rbegin(); it != v.rend(); ++it) {
+			prepend<int64_t>(it->second);
+			prepend<int64_t>(it->first);
+		}
+		prepend<uint32_t>((uint32_t)v.size());
+		return (uint32_t)size();
+	}
+
+	uint32_t tables(const std::vector<uint32_t> &v)
+	{
+		for (auto it = v.rbegin(); it != v.rend(); ++it) {
+			reference(*it);
+		}
+		prepend<uint32_t>((uint32_t)v.size());
+		return (uint32_t)size();
+	}
+
+	void start_table()
+	{
+		fields_.clear();
+		table_start_ = size();
+	}
+
+	template <typename T> void add(uint16_t id, T value)
+	{
+		prepend(value);
+		fields_.push_back({id, (uint32_t)size()});
+	}
+
+	void add_reference(uint16_t id, uint32_t object)
+	{
+		reference(object);
+		fields_.push_back({id, (uint32_t)size()});
+	}
+
+	uint32_t end_table()
+	{
+		std::vector<uint16_t> offsets;
+		uint32_t table;
+
+		prepend<int32_t>(0);
+		table = (uint32_t)size();
+		for (const auto &f : fields_) {
+			if (f.id >= offsets.size()) {
+				offsets.resize(f.id + 1u, 0);
+			}
+			offsets[f.id] = (uint16_t)(table - f.at);
+		}
+		for (auto it = offsets.rbegin(); it != offsets.rend(); ++it) {
+			prepend<uint16_t>(*it);
+		}
+		prepend<uint16_t>((uint16_t)(table - table_start_));
+		prepend<uint16_t>((uint16_t)(4 + 2 * offsets.size()));
+
+		/* The table points back at its vtable, which sits just before it */
+		int32_t back = (int32_t)(size() - table);
+
+		for (size_t i = 0; i < 4; i++) {
+			buf_[size() - table + i] = (uint8_t)((uint32_t)back >> (8 * i));
+		}
+		return table;
+	}
+
+	const std::vector<uint8_t> &finish(uint32_t root)
+	{
+		align(4, 8);
+		reference(root);
+		return buf_;
+	}
+
+private:
+	struct field {
+		uint16_t id;
+		uint32_t at;
+	};
+
+	/* Pad so that len more bytes leave the buffer aligned */
+	void align(size_t len, size_t alignment)
+	{
+		buf_.insert(buf_.begin(), (alignment - (size() + len) % alignment) % alignment, 0);
+	}
+
+	void reference(uint32_t object)
+	{
+		align(4, 4);
+		prepend<uint32_t>((uint32_t)(size() + 4 - object));
+	}
+
+	std::vector<uint8_t> buf_;
+	std::vector<field> fields_;
+	size_t table_start_ = 0;
+};
+
+enum class column_type { u8, u16, u32, f32, timestamp, binary, cap };
+
+struct column_def {
+	const char *name;
+	column_type type;
+};
+
+struct column {
+	column_def def;
+	std::vector<uint8_t> values;
+	std::vector<int32_t> offsets; /* binary only: one past each row */
+
+	template <typename T> void put(T value)
+	{
+		uint8_t bytes[sizeof(T)];
+
+		memcpy(bytes, &value, sizeof(T));
+		values.insert(values.end(), bytes, bytes + sizeof(T));
+	}
+};
+
+const column_def other_columns[] = {
+	{"time", column_type::timestamp},
+	{"device", column_type::u32},
+	{"data", column_type::binary},
+};
+
+const column_def sensor_columns[] = {
+	{"time", column_type::timestamp},
+	{"device", column_type::u32},
+	{"sequence", column_type::u8},
+	{"type", column_type::u8},
+	{"flags", column_type::u8},
+	{"packet_index", column_type::u16},
+	{"cap", column_type::cap},
+	{"pressure", column_type::f32},
+	{"pressure_upper", column_type::f32},
+	{"pressure_lower", column_type::f32},
+	{"data", column_type::binary},
+};
+
+const column_def power_columns[] = {
+	{"time", column_type::timestamp},
+	{"device", column_type::u32},
+	{"sequence", column_type::u8},
+	{"type", column_type::u8},
+	{"flags", column_type::u8},
+	{"battery", column_type::u8},
+	{"voltage_mv", column_type::u16},
+	{"temperature", column_type::u8},
+	{"status", column_type::u8},
+	{"data", column_type::binary},
+};
+
+const char *const table_names[SENSOR_STREAM_COUNT] = {"other", "sensor", "power"};
+
+uint16_t get_le16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+float get_f32(const uint8_t *p, bool little_endian)
+{
+	uint32_t v = little_endian ? (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+					     (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24
+				   : (uint32_t)p[3] | (uint32_t)p[2] << 8 |
+					     (uint32_t)p[1] << 16 | (uint32_t)p[0] << 24;
+	float f;
+
+	memcpy(&f, &v, sizeof(f));
+	return f;
+}
+
+bool plausible(float f)
+{
+	return std::isfinite(f) && f >= 0 && f < 1000;
+}
+
+size_t pad8(size_t len)
+{
+	return (len + 7) & ~(size_t)7;
+}
+
+/* Field for a column; fixed-size lists carry their item as a child */
+uint32_t build_field(flatbuffer &fb, const char *name, column_type type)
+{
+	uint32_t child = 0;
+	uint32_t type_table;
+	uint8_t type_id;
+
+	if (type == column_type::cap) {
+		child = build_field(fb, "item", column_type::u16);
+	}
+	uint32_t children = fb.tables(child ? std::vector<uint32_t>{child} : std::vector<uint32_t>{});
+	uint32_t timezone = type == column_type::timestamp ? fb.string("UTC") : 0;
+	uint32_t name_string = fb.string(name);
+
+	fb.start_table();
+	switch (type) {
+	case column_type::u8:
+	case column_type::u16:
+	case column_type::u32:
+		type_id = type_int;
+		fb.add<int32_t>(0, type == column_type::u8 ? 8 : type == column_type::u16 ? 16 : 32);
+		fb.add<uint8_t>(1, 0);
+		break;
+	case column_type::f32:
+		type_id = type_floating_point;
+		fb.add<int16_t>(0, precision_single);
+		break;
+	case column_type::timestamp:
+		type_id = type_timestamp;
+		fb.add<int16_t>(0, unit_microsecond);
+		fb.add_reference(1, timezone);
+		break;
+	case column_type::binary:
+		type_id = type_binary;
+		break;
+	case column_type::cap:
+	default:
+		type_id = type_fixed_size_list;
+		fb.add<int32_t>(0, (int32_t)cap_cells);
+		break;
+	}
+	type_table = fb.end_table();
+
+	fb.start_table();
+	fb.add_reference(0, name_string);
+	fb.add<uint8_t>(1, 0);
+	fb.add<uint8_t>(2, type_id);
+	fb.add_reference(3, type_table);
+	fb.add_reference(5, children);
+	return fb.end_table();
+}
+
+} /* namespace */
+
+struct export_table {
+	int fd = -1;
+	int err = 0;
+	std::vector<column> columns;
+	size_t held = 0;
+	uint64_t rows = 0;
+
+	~export_table() { finish(); }
+
+	void write(const uint8_t *data, size_t len)
+	{
+		size_t done = 0;
+
+		while (!err && done < len) {
+			ssize_t n = ::write(fd, data + done, len - done);
+
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				err = -errno;
+				break;
+			}
+			done += (size_t)n;
+		}
+	}
+
+	/* Continuation marker, metadata length, metadata, then the body */
+	void write_message(const std::vector<uint8_t> &metadata, const std::vector<uint8_t> &body)
+	{
+		uint8_t prefix[8] = {0xff, 0xff, 0xff, 0xff};
+		uint32_t len = (uint32_t)metadata.size();
+
+		for (size_t i = 0; i < 4; i++) {
+			prefix[4 + i] = (uint8_t)(len >> (8 * i));
+		}
+		write(prefix, sizeof(prefix));
+		write(metadata.data(), metadata.size());
+		write(body.data(), body.size());
+	}
+
+	void write_schema()
+	{
+		flatbuffer fb;
+		std::vector<uint32_t> fields;
+
+		for (const auto &c : columns) {
+			fields.push_back(build_field(fb, c.def.name, c.def.type));
+		}
+		uint32_t field_vector = fb.tables(fields);
+
+		fb.start_table();
+		fb.add<int16_t>(0, 0); /* Little-endian */
+		fb.add_reference(1, field_vector);
+		uint32_t schema = fb.end_table();
+
+		fb.start_table();
+		fb.add<int16_t>(0, metadata_v5);
+		fb.add<uint8_t>(1, header_schema);
+		fb.add_reference(2, schema);
+		fb.add<int64_t>(3, 0);
+		write_message(fb.finish(fb.end_table()), {});
+	}
+
+	/* Body buffers in column order, each padded to 8 bytes */
+	void flush()
+	{
+		std::vector<std::pair<int64_t, int64_t>> nodes;
+		std::vector<std::pair<int64_t, int64_t>> buffers;
+		std::vector<uint8_t> body;
+		flatbuffer fb;
+
+		if (!held) {
+			return;
+		}
+		auto add_buffer = [&](const void *data, size_t len) {
+			buffers.push_back({(int64_t)body.size(), (int64_t)len});
+			body.insert(body.end(), static_cast<const uint8_t *>(data),
+				    static_cast<const uint8_t *>(data) + len);
+			body.resize(pad8(body.size()), 0);
+		};
+
+		for (auto &c : columns) {
+			nodes.push_back({(int64_t)held, 0});
+			/* No nulls: every validity bitmap is left out */
+			add_buffer(nullptr, 0);
+			if (c.def.type == column_type::binary) {
+				add_buffer(c.offsets.data(), c.offsets.size() * sizeof(int32_t));
+			} else if (c.def.type == column_type::cap) {
+				nodes.push_back({(int64_t)(held * cap_cells), 0});
+				add_buffer(nullptr, 0);
+			}
+			add_buffer(c.values.data(), c.values.size());
+			c.values.clear();
+			c.offsets.assign(1, 0);
+		}
+
+		uint32_t node_vector = fb.pairs(nodes);
+		uint32_t buffer_vector = fb.pairs(buffers);
+
+		fb.start_table();
+		fb.add<int64_t>(0, (int64_t)held);
+		fb.add_reference(1, node_vector);
+		fb.add_reference(2, buffer_vector);
+		uint32_t batch = fb.end_table();
+
+		fb.start_table();
+		fb.add<int16_t>(0, metadata_v5);
+		fb.add<uint8_t>(1, header_record_batch);
+		fb.add_reference(2, batch);
+		fb.add<int64_t>(3, (int64_t)body.size());
+		write_message(fb.finish(fb.end_table()), body);
+		held = 0;
+	}
+
+	/* Write what is held and the end-of-stream marker */
+	int finish()
+	{
+		static const uint8_t eos[8] = {0xff, 0xff, 0xff, 0xff, 0, 0, 0, 0};
+		int result;
+
+		if (fd < 0) {
+			return 0;
+		}
+		flush();
+		write(eos, sizeof(eos));
+		::close(fd);
+		fd = -1;
+		result = err;
+		err = 0;
+		return result;
+	}
+};
+
+sensor_exporter::sensor_exporter() = default;
+
+sensor_exporter::~sensor_exporter()
+{
+	close();
+}
+
+int sensor_exporter::open(const std::string &prefix)
+{
+	static const std::pair<const column_def *, size_t> defs[SENSOR_STREAM_COUNT] = {
+		{other_columns, sizeof(other_columns) / sizeof(other_columns[0])},
+		{sensor_columns, sizeof(sensor_columns) / sizeof(sensor_columns[0])},
+		{power_columns, sizeof(power_columns) / sizeof(power_columns[0])},
+	};
+
+	if (is_open()) {
+		return -EALREADY;
+	}
+
+	for (size_t i = 0; i < SENSOR_STREAM_COUNT; i++) {
+		std::string path = prefix + "." + table_names[i] + ".arrows";
+		auto t = std::make_unique<export_table>();
+
+		t->fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (t->fd < 0) {
+			int err = -errno;
+
+			close();
+			return err;
+		}
+		for (size_t j = 0; j < defs[i].second; j++) {
+			t->columns.push_back({defs[i].first[j], {}, {0}});
+		}
+		t->write_schema();
+		tables_[i] = std::move(t);
+	}
+	return 0;
+}
+
+int sensor_exporter::close()
+{
+	int err = 0;
+
+	for (auto &t : tables_) {
+		if (t) {
+			int e = t->finish();
+
+			if (!err) {
+				err = e;
+			}
+			t.reset();
+		}
+	}
+	return err;
+}
+
+bool sensor_exporter::is_open() const
+{
+	return tables_[0] != nullptr;
+}
+
+void sensor_exporter::add(uint64_t time_us, uint32_t device_index, const uint8_t *data,
+			  size_t len)
+{
+	mouthware_message_SensorStream stream = sensor_stream_classify(data, len);
+	export_table *t = tables_[stream].get();
+
+	if (!t) {
+		return;
+	}
+
+	column *c = t->columns.data();
+
+	(c++)->put<uint64_t>(time_us);
+	(c++)->put<uint32_t>(device_index);
+
+	if (stream == mouthware_message_SensorStream_SENSOR_STREAM_SENSOR) {
+		float pressure[3] = {NAN, NAN, NAN};
+
+		(c++)->put<uint8_t>(data[1]);
+		(c++)->put<uint8_t>(data[0]);
+		(c++)->put<uint8_t>(data[2]);
+		(c++)->put<uint16_t>(get_le16(data + packet_index_offset));
+		for (size_t i = 0; i < cap_cells; i++) {
+			c->put<uint16_t>(get_le16(data + cap_offset + 2 * i));
+		}
+		c++;
+		/* Big-endian unless that gives implausible values, as the web client */
+		for (bool little_endian : {false, true}) {
+			float p = get_f32(data + pressure_offset, little_endian);
+			float u = get_f32(data + pressure_upper_offset, little_endian);
+			float l = get_f32(data + pressure_lower_offset, little_endian);
+
+			if (plausible(p) && plausible(u) && plausible(l)) {
+				pressure[0] = p;
+				pressure[1] = u;
+				pressure[2] = l;
+				break;
+			}
+		}
+		for (float p : pressure) {
+			(c++)->put<float>(p);
+		}
+	} else if (stream == mouthware_message_SensorStream_SENSOR_STREAM_POWER) {
+		(c++)->put<uint8_t>(data[1]);
+		(c++)->put<uint8_t>(data[0]);
+		(c++)->put<uint8_t>(data[2]);
+		(c++)->put<uint8_t>(data[4]);
+		(c++)->put<uint16_t>(get_le16(data + 5));
+		(c++)->put<uint8_t>(data[7]);
+		(c++)->put<uint8_t>(data[8]);
+	}
+
+	c->values.insert(c->values.end(), data, data + len);
+	c->offsets.push_back((int32_t)c->values.size());
+
+	t->rows++;
+	if (++t->held == batch_rows) {
+		t->flush();
+	}
+}
+
+void sensor_exporter::add_capture(capture_reader &capture)
+{
+	mouthpad_capture_record record;
+
+	while (capture.next(record)) {
+		if (record.channel == MOUTHPAD_CAPTURE_NUS &&
+		    record.direction == MOUTHPAD_CAPTURE_TO_HOST) {
+			add(capture.start_us() + record.time_us, 0, record.data, record.len);
+		}
+	}
+}
+
+uint64_t sensor_exporter::rows(mouthware_message_SensorStream stream) const
+{
+	const auto &t = tables_[stream];
+
+	return t ? t->rows : 0;
+}
+
+} /* namespace mouthpad */
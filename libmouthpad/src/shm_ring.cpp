@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "mouthpad/shm_ring.hpp"
+
+namespace mouthpad {
+
+/* "MPSH": the segment is initialised and laid out as below */
+static constexpr uint32_t shm_magic = 0x4853504d;
+static constexpr uint32_t shm_version = 1;
+
+/*
+ * Segment: header, then the event slots, then the command cells. The
+ * atomics are shared between processes, so they must not need a lock.
+ */
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics need hardware support");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+struct shm_header {
+	std::atomic<uint32_t> magic;  /* Stored last by create() */
+	uint32_t version;
+	uint32_t event_size;          /* sizeof(group_event) of the writer */
+	uint32_t slot_count;
+	uint32_t command_count;
+	uint32_t devices;
+	int32_t writer_pid;
+	std::atomic<uint32_t> closed;
+	uint64_t slots_offset;
+	uint64_t commands_offset;
+	char paths[shm_writer::max_devices][shm_writer::max_path];
+
+	/* Written by the writer on every event */
+	alignas(64) std::atomic<uint64_t> head; /* Events published */
+	std::atomic<uint32_t> wake;   /* Futex word, bumped while anyone waits */
+	std::atomic<uint32_t> waiters;
+
+	/* Claimed by readers with compare-and-swap */
+	alignas(64) std::atomic<uint64_t> command_tail;
+
+	/* The writer's alone */
+	alignas(64) uint64_t command_head;
+};
+
+/* Holds event n while sequence is n + 1; 0 while being written */
+struct alignas(64) shm_slot {
+	std::atomic<uint64_t> sequence;
+	group_event event;
+};
+
+/* Bounded queue cell: free for push n while sequence is n, full while n + 1 */
+struct alignas(64) shm_command {
+	std::atomic<uint64_t> sequence;
+	uint32_t device;
+	mouthware_message_AppToRelayMessage message;
+};
+
+static size_t pow2(size_t n)
+{
+	size_t p = 1;
+
+	while (p < n) {
+		p <<= 1;
+	}
+	return p;
+}
+
+static shm_slot *slots(shm_header *h)
+{
+	return reinterpret_cast<shm_slot *>(reinterpret_cast<uint8_t *>(h) + h->slots_offset);
+}
+
+static shm_command *commands(shm_header *h)
+{
+	return reinterpret_cast<shm_command *>(reinterpret_cast<uint8_t *>(h) +
+					       h->commands_offset);
+}
+
+/* Bytes of an event worth copying: the data array is only used up to len */
+static size_t event_bytes(const group_event &event)
+{
+	return offsetof(group_event, data) + (event.len <= group_event::max_data ? event.len : 0);
+}
+
+static bool pid_alive(int32_t pid)
+{
+	return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static void wake_all(shm_header *h)
+{
+	h->wake.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&h->wake), FUTEX_WAKE, INT_MAX, nullptr,
+		nullptr, 0);
+#endif
+}
+
+static void *map(int fd, size_t size, int prot)
+{
+	void *p = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+
+	return p == MAP_FAILED ? nullptr : p;
+}
+
+/* ------------------------------------------------------------------------ */
+
+shm_writer::~shm_writer()
+{
+	close();
+}
+
+int shm_writer::create(const std::string &name, const relay_group &group, size_t slot_depth,
+		       size_t command_depth)
+{
+	if (header_) {
+		return -EALREADY;
+	}
+
+	/* A segment whose writer still runs belongs to another daemon */
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+
+	if (fd >= 0) {
+		struct stat st;
+		bool busy = false;
+
+		if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(shm_header)) {
+			auto *old = static_cast<shm_header *>(map(fd, sizeof(shm_header), PROT_READ));
+
+			if (old) {
+				busy = old->magic.load(std::memory_order_acquire) == shm_magic &&
+				       !old->closed.load() && pid_alive(old->writer_pid);
+				munmap(old, sizeof(shm_header));
+			}
+		}
+		::close(fd);
+		if (busy) {
+			return -EBUSY;
+		}
+		shm_unlink(name.c_str());
+	}
+
+	size_t slot_count = pow2(slot_depth);
+	size_t command_count = pow2(command_depth);
+	size_t slots_offset = (sizeof(shm_header) + 63) & ~(size_t)63;
+	size_t commands_offset = slots_offset + slot_count * sizeof(shm_slot);
+	size_t size = commands_offset + command_count * sizeof(shm_command);
+
+	fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		return -errno;
+	}
+	if (ftruncate(fd, (off_t)size) < 0) {
+		int err = -errno;
+
+		::close(fd);
+		shm_unlink(name.c_str());
+		return err;
+	}
+
+	auto *h = static_cast<shm_header *>(map(fd, size, PROT_READ | PROT_WRITE));
+	int err = h ? 0 : -errno;
+
+	::close(fd);
+	if (!h) {
+		shm_unlink(name.c_str());
+		return err;
+	}
+
+	/* ftruncate() zeroed it: every slot is empty, every atomic 0 */
+	h->version = shm_version;
+	h->event_size = sizeof(group_event);
+	h->slot_count = (uint32_t)slot_count;
+	h->command_count = (uint32_t)command_count;
+	h->writer_pid = (int32_t)getpid();
+	h->slots_offset = slots_offset;
+	h->commands_offset = commands_offset;
+	h->devices = (uint32_t)std::min(group.size(), max_devices);
+	for (uint32_t d = 0; d < h->devices; d++) {
+		strncpy(h->paths[d], group.path(d).c_str(), max_path - 1);
+	}
+	for (size_t i = 0; i < command_count; i++) {
+		commands(h)[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	h->magic.store(shm_magic, std::memory_order_release);
+
+	name_ = name;
+	header_ = h;
+	size_ = size;
+	return 0;
+}
+
+void shm_writer::close()
+{
+	if (!header_) {
+		return;
+	}
+	header_->closed.store(1);
+	wake_all(header_);
+	munmap(header_, size_);
+	shm_unlink(name_.c_str());
+	header_ = nullptr;
+}
+
+void shm_writer::publish(const group_event &event)
+{
+	shm_header *h = header_;
+	uint64_t n = h->head.load(std::memory_order_relaxed);
+	shm_slot &slot = slots(h)[n & (h->slot_count - 1)];
+
+	/* Readers that copy while this runs see the sequence change and retry */
+	slot.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(&slot.event, &event, event_bytes(event));
+	slot.sequence.store(n + 1, std::memory_order_release);
+
+	/* Paired with wait(): either it sees the new head or we see it waiting */
+	h->head.store(n + 1, std::memory_order_seq_cst);
+	if (h->waiters.load(std::memory_order_seq_cst) != 0) {
+		wake_all(h);
+	}
+}
+
+size_t shm_writer::take_commands(
+	const std::function<void(uint32_t device,
+				 const mouthware_message_AppToRelayMessage &message)> &on_command)
+{
+	shm_header *h = header_;
+	size_t taken = 0;
+
+	for (;;) {
+		uint64_t n = h->command_head;
+		shm_command &cell = commands(h)[n & (h->command_count - 1)];
+
+		if (cell.sequence.load(std::memory_order_acquire) != n + 1) {
+			break;
+		}
+		if (cell.device < h->devices) {
+			on_command(cell.device, cell.message);
+		}
+		cell.sequence.store(n + h->command_count, std::memory_order_release);
+		h->command_head = n + 1;
+		taken++;
+	}
+	return taken;
+}
+
+uint64_t shm_writer::published() const
+{
+	return header_ ? header_->head.load(std::memory_order_relaxed) : 0;
+}
+
+/* ------------------------------------------------------------------------ */
+
+shm_reader::~shm_reader()
+{
+	close();
+}
+
+int shm_reader::open(const std::string &name)
+{
+	close();
+
+	int fd = shm_open(name.c_str(), O_RDWR, 0);
+
+	if (fd < 0) {
+		return -errno;
+	}
+
+	struct stat st;
+
+	if (fstat(fd, &st) < 0) {
+		int err = -errno;
+
+		::close(fd);
+		return err;
+	}
+	if ((size_t)st.st_size < sizeof(shm_header)) {
+		::close(fd);
+		return -ENOENT;
+	}
+
+	auto *h = static_cast<shm_header *>(map(fd, (size_t)st.st_size, PROT_READ | PROT_WRITE));
+	int err = h ? 0 : -errno;
+
+	::close(fd);
+	if (!h) {
+		return err;
+	}
+	if (h->magic.load(std::memory_order_acquire) != shm_magic) {
+		err = -ENOENT;
+	} else if (h->version != shm_version || h->event_size != sizeof(group_event)) {
+		err = -EPROTO;
+	}
+	if (err) {
+		munmap(h, (size_t)st.st_size);
+		return err;
+	}
+
+	header_ = h;
+	size_ = (size_t)st.st_size;
+	next_ = h->head.load(std::memory_order_acquire);
+	lost_ = 0;
+	return 0;
+}
+
+void shm_reader::close()
+{
+	if (header_) {
+		munmap(header_, size_);
+		header_ = nullptr;
+	}
+}
+
+bool shm_reader::next(group_event &event, uint64_t *sequence)
+{
+	shm_header *h = header_;
+	uint64_t count = h->slot_count;
+
+	for (;;) {
+		uint64_t head = h->head.load(std::memory_order_acquire);
+
+		if (next_ >= head) {
+			return false;
+		}
+		if (head - next_ > count) {
+			lost_ += head - count - next_;
+			next_ = head - count;
+		}
+
+		shm_slot &slot = slots(h)[next_ & (count - 1)];
+
+		/* Being rewritten for next_ + count: this one is gone */
+		if (slot.sequence.load(std::memory_order_acquire) != next_ + 1) {
+			lost_++;
+			next_++;
+			continue;
+		}
+
+		memcpy(&event, &slot.event, offsetof(group_event, data));
+		if (event.len > group_event::max_data) {
+			event.len = 0;
+		}
+		memcpy(event.data, slot.event.data, event.len);
+
+		/* Overwritten while copying: what was copied may be torn */
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != next_ + 1) {
+			lost_++;
+			next_++;
+			continue;
+		}
+
+		if (sequence) {
+			*sequence = next_;
+		}
+		next_++;
+		return true;
+	}
+}
+
+bool shm_reader::wait(int timeout_ms)
+{
+	shm_header *h = header_;
+
+	if (h->head.load(std::memory_order_acquire) > next_) {
+		return true;
+	}
+	if (h->closed.load()) {
+		return false;
+	}
+
+#if defined(__linux__)
+	struct timespec ts = {timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000};
+
+	h->waiters.fetch_add(1, std::memory_order_seq_cst);
+
+	uint32_t word = h->wake.load(std::memory_order_acquire);
+
+	if (h->head.load(std::memory_order_seq_cst) <= next_ && !h->closed.load()) {
+		syscall(SYS_futex, reinterpret_cast<uint32_t *>(&h->wake), FUTEX_WAIT, word,
+			timeout_ms < 0 ? nullptr : &ts, nullptr, 0);
+	}
+	h->waiters.fetch_sub(1, std::memory_order_relaxed);
+#else
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+	while (h->head.load(std::memory_order_acquire) <= next_ && !h->closed.load() &&
+	       (timeout_ms < 0 || std::chrono::steady_clock::now() < deadline)) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+#endif
+	return h->head.load(std::memory_order_acquire) > next_;
+}
+
+bool shm_reader::writer_closed() const
+{
+	return header_->closed.load() != 0;
+}
+
+size_t shm_reader::size() const
+{
+	return header_ ? header_->devices : 0;
+}
+
+std::string shm_reader::path(uint32_t device) const
+{
+	if (!header_ || device >= header_->devices) {
+		return std::string();
+	}
+	return std::string(header_->paths[device], strnlen(header_->paths[device],
+							   shm_writer::max_path));
+}
+
+int shm_reader::send(uint32_t device, const mouthware_message_AppToRelayMessage &message)
+{
+	shm_header *h = header_;
+
+	if (!h || h->closed.load()) {
+		return -ENOTCONN;
+	}
+	if (device >= h->devices) {
+		return -ENODEV;
+	}
+
+	uint64_t mask = h->command_count - 1;
+	uint64_t n = h->command_tail.load(std::memory_order_relaxed);
+	shm_command *cell;
+
+	for (;;) {
+		cell = &commands(h)[n & mask];
+
+		int64_t diff = (int64_t)(cell->sequence.load(std::memory_order_acquire) - n);
+
+		if (diff == 0) {
+			if (h->command_tail.compare_exchange_weak(n, n + 1,
+								  std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			return -ENOBUFS;
+		} else {
+			n = h->command_tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	cell->device = device;
+	cell->message = message;
+	cell->sequence.store(n + 1, std::memory_order_release);
+	return 0;
+}
+
+} /* namespace mouthpad */
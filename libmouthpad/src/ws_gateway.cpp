@@ -0,0 +1,804 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <pb_decode.h>
+#include <pb_encode.h>
+
+#include "mouthpad/ws_gateway.hpp"
+#include "sensor_stream.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 /* macOS: SO_NOSIGPIPE is set on each socket instead */
+#endif
+
+namespace mouthpad {
+
+/* Handshake requests longer than this are refused */
+static constexpr size_t max_request = 8192;
+
+enum : uint8_t {
+	op_continuation = 0x0,
+	op_text = 0x1,
+	op_binary = 0x2,
+	op_close = 0x8,
+	op_ping = 0x9,
+	op_pong = 0xa,
+};
+
+enum : uint8_t {
+	kind_pass_through = 1 << group_event::pass_through,
+	kind_status = 1 << group_event::status,
+	kind_telemetry = 1 << group_event::telemetry,
+	kind_message = 1 << group_event::message,
+	kind_closed = 1 << group_event::closed,
+	kind_all = 0x1f,
+};
+
+struct ws_gateway::client {
+	ws_gateway *gateway;
+	int fd;
+	bool open = false;      /* Handshake answered */
+	bool closing = false;   /* Drop once out is written */
+	std::string request;
+
+	/* Received bytes not yet parsed, and a fragmented message so far */
+	std::vector<uint8_t> in;
+	std::vector<uint8_t> message;
+	uint8_t message_opcode = 0;
+
+	/* Unsent bytes are out[out_head, end) */
+	std::vector<uint8_t> out;
+	size_t out_head = 0;
+
+	/* Records for the next binary message */
+	std::vector<uint8_t> batch;
+	uint32_t lost = 0;
+
+	/* Subscription */
+	uint32_t devices = UINT32_MAX;
+	uint8_t kinds = kind_all;
+	uint32_t streams = SENSOR_STREAM_ALL;
+	uint32_t target = 0;
+
+	struct mouthpad_deframer deframer;
+
+	size_t queued() const { return out.size() - out_head + batch.size(); }
+};
+
+/* ------------------------------------------------------------------------
+ * Handshake: Sec-WebSocket-Accept is base64(SHA-1(key + GUID))
+ * ------------------------------------------------------------------------ */
+
+static uint32_t rol(uint32_t x, int n)
+{
+	return (x << n) | (x >> (32 - n));
+}
+
+static void sha1(const uint8_t *data, size_t len, uint8_t digest[20])
+{
+	uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+	std::vector<uint8_t> msg(data, data + len);
+	uint64_t bits = (uint64_t)len * 8;
+
+	msg.push_back(0x80);
+	while (msg.size() % 64 != 56) {
+		msg.push_back(0);
+	}
+	for (int i = 7; i >= 0; i--) {
+		msg.push_back((uint8_t)(bits >> (i * 8)));
+	}
+
+	for (size_t block = 0; block < msg.size(); block += 64) {
+		uint32_t w[80];
+
+		for (int i = 0; i < 16; i++) {
+			const uint8_t *p = &msg[block + i * 4];
+
+			w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+		}
+		for (int i = 16; i < 80; i++) {
+			w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+		}
+
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+
+		for (int i = 0; i < 80; i++) {
+			uint32_t f, k;
+
+			if (i < 20) {
+				f = (b & c) | (~b & d);
+				k = 0x5a827999;
+			} else if (i < 40) {
+				f = b ^ c ^ d;
+				k = 0x6ed9eba1;
+			} else if (i < 60) {
+				f = (b & c) | (b & d) | (c & d);
+				k = 0x8f1bbcdc;
+			} else {
+				f = b ^ c ^ d;
+				k = 0xca62c1d6;
+			}
+
+			uint32_t t = rol(a, 5) + f + e + k + w[i];
+
+			e = d;
+			d = c;
+			c = rol(b, 30);
+			b = a;
+			a = t;
+		}
+		h[0] += a;
+		h[1] += b;
+		h[2] += c;
+		h[3] += d;
+		h[4] += e;
+	}
+
+	for (int i = 0; i < 20; i++) {
+		digest[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+	}
+}
+
+static std::string base64(const uint8_t *data, size_t len)
+{
+	static const char table[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string s;
+
+	for (size_t i = 0; i < len; i += 3) {
+		uint32_t v = (uint32_t)data[i] << 16;
+
+		if (i + 1 < len) {
+			v |= (uint32_t)data[i + 1] << 8;
+		}
+		if (i + 2 < len) {
+			v |= data[i + 2];
+		}
+		s += table[(v >> 18) & 0x3f];
+		s += table[(v >> 12) & 0x3f];
+		s += i + 1 < len ? table[(v >> 6) & 0x3f] : '=';
+		s += i + 2 < len ? table[v & 0x3f] : '=';
+	}
+	return s;
+}
+
+static std::string lower(std::string s)
+{
+	std::transform(s.begin(), s.end(), s.begin(),
+		       [](unsigned char ch) { return (char)std::tolower(ch); });
+	return s;
+}
+
+static std::string trim(const std::string &s)
+{
+	size_t begin = s.find_first_not_of(" \t");
+	size_t end = s.find_last_not_of(" \t\r");
+
+	return begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+/* ------------------------------------------------------------------------ */
+
+ws_gateway::ws_gateway(event_loop &loop, relay_group &group) : loop_(loop), group_(group)
+{
+}
+
+ws_gateway::~ws_gateway()
+{
+	close();
+}
+
+int ws_gateway::listen(uint16_t port)
+{
+	struct sockaddr_in addr = {};
+	int one = 1;
+	int fd;
+
+	if (listen_fd_ >= 0) {
+		return -EALREADY;
+	}
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return -errno;
+	}
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+	/* Loopback only: the gateway has no authentication of its own */
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || ::listen(fd, 16) < 0) {
+		int err = -errno;
+
+		::close(fd);
+		return err;
+	}
+
+	int err = loop_.add(fd, event_loop::readable, [this](unsigned) { on_accept(); });
+
+	if (err) {
+		::close(fd);
+		return err;
+	}
+	listen_fd_ = fd;
+	return 0;
+}
+
+void ws_gateway::close()
+{
+	for (auto &entry : clients_) {
+		loop_.remove(entry.first);
+		::close(entry.first);
+	}
+	clients_.clear();
+	dead_.clear();
+	stats_.clients = 0;
+	if (listen_fd_ >= 0) {
+		loop_.remove(listen_fd_);
+		::close(listen_fd_);
+		listen_fd_ = -1;
+	}
+}
+
+void ws_gateway::on_accept()
+{
+	for (;;) {
+		int fd = accept(listen_fd_, nullptr, nullptr);
+		int one = 1;
+
+		if (fd < 0) {
+			return;
+		}
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+		setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+		auto c = std::make_unique<client>();
+		client *cp = c.get();
+
+		c->gateway = this;
+		c->fd = fd;
+		mouthpad_deframer_init(&c->deframer, frame_thunk, nullptr, cp);
+		if (loop_.add(fd, event_loop::readable,
+			      [this, cp](unsigned events) { on_client(*cp, events); }) != 0) {
+			::close(fd);
+			continue;
+		}
+		clients_[fd] = std::move(c);
+	}
+}
+
+void ws_gateway::on_client(client &c, unsigned events)
+{
+	if (events & event_loop::writable) {
+		write_out(c);
+	}
+	if (c.closing && !c.open) {
+		/* Dropped by write_out() */
+	} else if (events & event_loop::readable) {
+		uint8_t buf[4096];
+		ssize_t n;
+
+		while ((n = read(c.fd, buf, sizeof(buf))) > 0) {
+			if (!c.open) {
+				c.request.append((const char *)buf, (size_t)n);
+			} else {
+				c.in.insert(c.in.end(), buf, buf + n);
+			}
+		}
+		if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+			drop(c);
+		} else if (!c.open && !handshake(c)) {
+			drop(c);
+		} else if (c.open && !parse(c)) {
+			drop(c);
+		}
+	} else if (events & event_loop::hangup) {
+		drop(c);
+	}
+	reap();
+}
+
+bool ws_gateway::origin_allowed(const std::string &origin) const
+{
+	/* Native clients send no Origin. file:// pages send "null", but so do
+	 * sandboxed iframes and data: URLs on any site; it must be allowed by name
+	 */
+	if (origin.empty()) {
+		return true;
+	}
+	for (const char *local : {"http://localhost", "http://127.0.0.1", "https://localhost",
+				  "https://127.0.0.1"}) {
+		size_t n = strlen(local);
+
+		if (origin.compare(0, n, local) == 0 && (origin.size() == n || origin[n] == ':')) {
+			return true;
+		}
+	}
+	return std::find(origins_.begin(), origins_.end(), origin) != origins_.end();
+}
+
+/* Answer the HTTP upgrade once the request is complete; false to drop */
+bool ws_gateway::handshake(client &c)
+{
+	static const char guid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+	size_t end = c.request.find("\r\n\r\n");
+
+	if (end == std::string::npos) {
+		return c.request.size() < max_request;
+	}
+
+	std::istringstream lines(c.request.substr(0, end));
+	std::string line, key, origin;
+	bool upgrade = false;
+
+	std::getline(lines, line);
+	if (line.compare(0, 4, "GET ") != 0) {
+		stats_.refused++;
+		return false;
+	}
+	while (std::getline(lines, line)) {
+		size_t colon = line.find(':');
+
+		if (colon == std::string::npos) {
+			continue;
+		}
+
+		std::string name = lower(trim(line.substr(0, colon)));
+		std::string value = trim(line.substr(colon + 1));
+
+		if (name == "upgrade") {
+			upgrade = lower(value) == "websocket";
+		} else if (name == "sec-websocket-key") {
+			key = value;
+		} else if (name == "origin") {
+			origin = value;
+		}
+	}
+
+	if (!upgrade || key.empty() || !origin_allowed(origin)) {
+		static const char refused[] = "HTTP/1.1 403 Forbidden\r\nContent-Length: 0\r\n\r\n";
+
+		stats_.refused++;
+		(void)!send(c.fd, refused, sizeof(refused) - 1, MSG_NOSIGNAL);
+		return false;
+	}
+
+	uint8_t digest[20];
+	std::string accept = key + guid;
+
+	sha1((const uint8_t *)accept.data(), accept.size(), digest);
+
+	std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+			       "Upgrade: websocket\r\n"
+			       "Connection: Upgrade\r\n"
+			       "Sec-WebSocket-Accept: " +
+			       base64(digest, sizeof(digest)) + "\r\n\r\n";
+
+	c.out.insert(c.out.end(), response.begin(), response.end());
+	c.in.assign(c.request.begin() + end + 4, c.request.end());
+	c.request.clear();
+	c.request.shrink_to_fit();
+	c.open = true;
+	stats_.clients++;
+	write_out(c);
+	return parse(c);
+}
+
+/* Take every whole frame out of c.in; false on a protocol error */
+bool ws_gateway::parse(client &c)
+{
+	size_t pos = 0;
+
+	while (c.in.size() - pos >= 2) {
+		const uint8_t *p = &c.in[pos];
+		size_t avail = c.in.size() - pos;
+		bool fin = p[0] & 0x80;
+		uint8_t opcode = p[0] & 0x0f;
+		uint64_t len = p[1] & 0x7f;
+		size_t header = 2;
+
+		/* Client frames must be masked */
+		if (!(p[1] & 0x80)) {
+			return false;
+		}
+		if (len == 126) {
+			if (avail < 4) {
+				break;
+			}
+			len = (uint64_t)p[2] << 8 | p[3];
+			header = 4;
+		} else if (len == 127) {
+			if (avail < 10) {
+				break;
+			}
+			len = 0;
+			for (int i = 0; i < 8; i++) {
+				len = len << 8 | p[2 + i];
+			}
+			header = 10;
+		}
+		if (len > max_message || c.message.size() + len > max_message) {
+			return false;
+		}
+		if (avail < header + 4 + len) {
+			break;
+		}
+
+		const uint8_t *mask = p + header;
+		const uint8_t *payload = mask + 4;
+
+		if (opcode >= op_close) {
+			std::vector<uint8_t> control(payload, payload + len);
+
+			for (size_t i = 0; i < control.size(); i++) {
+				control[i] ^= mask[i % 4];
+			}
+			on_message(c, opcode, control);
+		} else {
+			if (opcode != op_continuation) {
+				c.message.clear();
+				c.message_opcode = opcode;
+			}
+			for (size_t i = 0; i < len; i++) {
+				c.message.push_back(payload[i] ^ mask[i % 4]);
+			}
+			if (fin) {
+				on_message(c, c.message_opcode, c.message);
+				c.message.clear();
+			}
+		}
+		pos += header + 4 + len;
+	}
+
+	c.in.erase(c.in.begin(), c.in.begin() + pos);
+	return true;
+}
+
+void ws_gateway::on_message(client &c, uint8_t opcode, std::vector<uint8_t> &data)
+{
+	switch (opcode) {
+	case op_binary:
+		/* CDC0 frames, however the client split them */
+		mouthpad_deframer_feed(&c.deframer, data.data(), data.size());
+		break;
+	case op_text:
+		on_text(c, std::string(data.begin(), data.end()));
+		break;
+	case op_ping:
+		queue(c, op_pong, data.data(), data.size());
+		break;
+	case op_close:
+		queue(c, op_close, data.data(), std::min<size_t>(data.size(), 2));
+		c.closing = true;
+		break;
+	default:
+		break;
+	}
+	write_out(c);
+}
+
+/* A whole decimal number below limit, or limit */
+static unsigned long parse_below(const std::string &word, unsigned long limit)
+{
+	unsigned long value;
+	auto end = word.data() + word.size();
+	auto result = std::from_chars(word.data(), end, value);
+
+	if (word.empty() || result.ec != std::errc() || result.ptr != end || value >= limit) {
+		return limit;
+	}
+	return value;
+}
+
+void ws_gateway::on_text(client &c, const std::string &text)
+{
+	std::istringstream words(text);
+	std::string command, word;
+	std::string error;
+
+	words >> command;
+	if (command == "devices") {
+		uint32_t devices = 0;
+
+		while (words >> word) {
+			if (word == "all") {
+				devices = UINT32_MAX;
+			} else if (parse_below(word, 32) < 32) {
+				devices |= 1u << parse_below(word, 32);
+			} else {
+				error = "bad device " + word;
+			}
+		}
+		if (error.empty()) {
+			c.devices = devices;
+		}
+	} else if (command == "kinds") {
+		static const char *const names[] = {"pass-through", "status", "telemetry", "message",
+						    "closed"};
+		uint8_t kinds = 0;
+
+		while (words >> word) {
+			auto it = std::find(std::begin(names), std::end(names), word);
+
+			if (it == std::end(names)) {
+				error = "bad kind " + word;
+			} else {
+				kinds |= 1 << (it - std::begin(names));
+			}
+		}
+		if (error.empty()) {
+			c.kinds = kinds;
+		}
+	} else if (command == "streams") {
+		uint32_t streams = 0;
+
+		while (words >> word) {
+			if (word == "other") {
+				streams |= 1u << mouthware_message_SensorStream_SENSOR_STREAM_OTHER;
+			} else if (word == "sensor") {
+				streams |= 1u << mouthware_message_SensorStream_SENSOR_STREAM_SENSOR;
+			} else if (word == "power") {
+				streams |= 1u << mouthware_message_SensorStream_SENSOR_STREAM_POWER;
+			} else {
+				error = "bad stream " + word;
+			}
+		}
+		if (error.empty()) {
+			c.streams = streams;
+		}
+	} else if (command == "target") {
+		unsigned long target = group_.size();
+
+		if (words >> word) {
+			target = parse_below(word, group_.size());
+		}
+		if (target < group_.size()) {
+			c.target = (uint32_t)target;
+		} else {
+			error = "no such device";
+		}
+	} else {
+		error = "unknown command";
+	}
+
+	std::string reply = error.empty() ? "ok" : "error " + error;
+
+	queue(c, op_text, (const uint8_t *)reply.data(), reply.size());
+}
+
+/* One CDC0 frame from a client: an AppToRelayMessage for its target, bare
+ * or on the control channel, or a write on the NUS channel
+ */
+void ws_gateway::frame_thunk(const uint8_t *payload, uint16_t len, void *user_data)
+{
+	client &c = *static_cast<client *>(user_data);
+	ws_gateway &g = *c.gateway;
+	mouthware_message_AppToRelayMessage message = mouthware_message_AppToRelayMessage_init_zero;
+	struct mouthpad_channel_frame channel;
+	size_t size = len;
+
+	if (mouthpad_channel_parse(payload, len, &channel)) {
+		if (channel.channel == MOUTHPAD_CHANNEL_NUS) {
+			if (g.group_.send_pass_through(
+				    c.target, channel.data, channel.len, channel.device_index, false,
+				    mouthware_message_PassThroughAckMode_PASS_THROUGH_ACK_NONE) != 0) {
+				g.stats_.command_errors++;
+				return;
+			}
+			g.stats_.commands++;
+			return;
+		}
+		if (channel.channel != MOUTHPAD_CHANNEL_CONTROL) {
+			g.stats_.command_errors++;
+			return;
+		}
+		payload = channel.data;
+		size = channel.len;
+	}
+
+	pb_istream_t stream = pb_istream_from_buffer(payload, size);
+
+	if (!pb_decode(&stream, mouthware_message_AppToRelayMessage_fields, &message) ||
+	    g.group_.send(c.target, message) != 0) {
+		g.stats_.command_errors++;
+		return;
+	}
+	g.stats_.commands++;
+}
+
+void ws_gateway::queue(client &c, uint8_t opcode, const uint8_t *data, size_t len)
+{
+	uint8_t header[10];
+	size_t n = 2;
+
+	header[0] = 0x80 | opcode;
+	if (len < 126) {
+		header[1] = (uint8_t)len;
+	} else if (len <= UINT16_MAX) {
+		header[1] = 126;
+		header[2] = (uint8_t)(len >> 8);
+		header[3] = (uint8_t)len;
+		n = 4;
+	} else {
+		header[1] = 127;
+		for (int i = 0; i < 8; i++) {
+			header[2 + i] = (uint8_t)((uint64_t)len >> (56 - i * 8));
+		}
+		n = 10;
+	}
+	c.out.insert(c.out.end(), header, header + n);
+	c.out.insert(c.out.end(), data, data + len);
+}
+
+void ws_gateway::write_out(client &c)
+{
+	while (c.out_head < c.out.size()) {
+		ssize_t n = send(c.fd, &c.out[c.out_head], c.out.size() - c.out_head, MSG_NOSIGNAL);
+
+		if (n < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				loop_.modify(c.fd, event_loop::readable | event_loop::writable);
+				return;
+			}
+			drop(c);
+			return;
+		}
+		c.out_head += (size_t)n;
+	}
+
+	c.out.clear();
+	c.out_head = 0;
+	loop_.modify(c.fd, event_loop::readable);
+	if (c.closing) {
+		drop(c);
+	}
+}
+
+void ws_gateway::publish(const group_event &e)
+{
+	uint8_t kind = (uint8_t)(1 << e.type);
+	uint32_t stream = 0;
+
+	record_.resize(6);
+	record_[1] = (uint8_t)e.device;
+	record_[2] = (uint8_t)e.device_index;
+	record_[3] = 0;
+
+	switch (e.type) {
+	case group_event::pass_through:
+		record_[0] = record_pass_through;
+		record_.insert(record_.end(), e.data, e.data + e.len);
+		stream = 1u << sensor_stream_classify(e.data, e.len);
+		break;
+	case group_event::closed:
+		record_[0] = record_closed;
+		break;
+	default: {
+		mouthware_message_RelayToAppMessage message = {};
+		uint8_t buf[MOUTHPAD_FRAME_MAX_PAYLOAD];
+		pb_ostream_t stream_out = pb_ostream_from_buffer(buf, sizeof(buf));
+
+		if (e.type == group_event::status) {
+			message.which_message_body =
+				mouthware_message_RelayToAppMessage_ble_connection_status_response_tag;
+			message.message_body.ble_connection_status_response = e.body.status;
+		} else if (e.type == group_event::telemetry) {
+			message.which_message_body = mouthware_message_RelayToAppMessage_link_telemetry_tag;
+			message.message_body.link_telemetry = e.body.telemetry;
+		} else {
+			message = e.body.message;
+		}
+		if (!pb_encode(&stream_out, mouthware_message_RelayToAppMessage_fields, &message)) {
+			return;
+		}
+		record_[0] = record_message;
+		record_.insert(record_.end(), buf, buf + stream_out.bytes_written);
+		break;
+	}
+	}
+	record_[4] = (uint8_t)(record_.size() - 6);
+	record_[5] = (uint8_t)((record_.size() - 6) >> 8);
+
+	for (auto &entry : clients_) {
+		client &c = *entry.second;
+
+		if (!c.open || c.closing || !(c.kinds & kind) || e.device >= 32 ||
+		    !(c.devices & (1u << e.device)) || (stream && !(c.streams & stream))) {
+			continue;
+		}
+
+		/* Room for the record and a lost record ahead of it */
+		if (c.queued() + record_.size() + 10 > max_queued) {
+			c.lost++;
+			stats_.lost++;
+			continue;
+		}
+		if (c.batch.size() + record_.size() + 10 > max_message) {
+			send_batch(c);
+		}
+		if (c.lost) {
+			uint8_t lost[10] = {record_lost, 0, 0, 0, 4, 0, (uint8_t)c.lost,
+					    (uint8_t)(c.lost >> 8), (uint8_t)(c.lost >> 16),
+					    (uint8_t)(c.lost >> 24)};
+
+			c.batch.insert(c.batch.end(), lost, lost + sizeof(lost));
+			c.lost = 0;
+		}
+		c.batch.insert(c.batch.end(), record_.begin(), record_.end());
+		stats_.records++;
+	}
+}
+
+void ws_gateway::send_batch(client &c)
+{
+	queue(c, op_binary, c.batch.data(), c.batch.size());
+	c.batch.clear();
+	stats_.messages++;
+}
+
+void ws_gateway::flush()
+{
+	for (auto &entry : clients_) {
+		client &c = *entry.second;
+
+		if (!c.batch.empty()) {
+			send_batch(c);
+			write_out(c);
+		}
+	}
+	reap();
+}
+
+/* Close now; freed by reap(), as the caller may still hold it */
+void ws_gateway::drop(client &c)
+{
+	if (std::find(dead_.begin(), dead_.end(), c.fd) != dead_.end()) {
+		return;
+	}
+	loop_.remove(c.fd);
+	if (c.open) {
+		stats_.clients--;
+	}
+	c.open = false;
+	c.closing = true;
+	dead_.push_back(c.fd);
+}
+
+void ws_gateway::reap()
+{
+	for (int fd : dead_) {
+		::close(fd);
+		clients_.erase(fd);
+	}
+	dead_.clear();
+}
+
+ws_gateway_stats ws_gateway::stats() const
+{
+	return stats_;
+}
+
+} /* namespace mouthpad */
@@ -14,6 +14,8 @@
 
 #include "ble_bas.h"
 #include "ble_central.h"
+#include "connection_timing.h"
+#include "relay_bus.h"
 
 #define LOG_MODULE_NAME ble_bas
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -85,22 +87,22 @@ uint8_t ble_bas_get_battery_level(void)
 	return current_battery_level;
 }
 
-ble_bas_rgb_color_t ble_bas_get_battery_color(ble_bas_color_mode_t mode)
+ble_bas_rgb_color_t ble_bas_battery_color(uint8_t battery_level, ble_bas_color_mode_t mode)
 {
 	ble_bas_rgb_color_t color = {0, 0, 0}; /* Default to off */
 	
 	/* If battery level is invalid/unknown, default to green (assume full battery) */
-	if (current_battery_level == 0xFF || current_battery_level > 100) {
+	if (battery_level == 0xFF || battery_level > 100) {
 		color.green = 255;
 		return color;
 	}
 	
 	if (mode == BAS_COLOR_MODE_DISCRETE) {
 		/* Segmented colors optimized for GPIO LEDs */
-		if (current_battery_level >= 50) {
+		if (battery_level >= 50) {
 			/* Green: 100-50% */
 			color.green = 255;
-		} else if (current_battery_level >= 10) {
+		} else if (battery_level >= 10) {
 			/* Yellow: 49-10% */
 			color.red = 255;
 			color.green = 255;
@@ -110,46 +112,57 @@ ble_bas_rgb_color_t ble_bas_get_battery_color(ble_bas_color_mode_t mode)
 		}
 	} else {
 		/* Gradient mode: smooth transition from green to red */
-		if (current_battery_level >= 50) {
+		if (battery_level >= 50) {
 			/* Green to yellow gradient (100% to 50%) */
 			/* Green stays at 255, red increases from 0 to 255 */
 			color.green = 255;
-			color.red = (uint8_t)(255 * (100 - current_battery_level) / 50);
+			color.red = (uint8_t)(255 * (100 - battery_level) / 50);
 		} else {
 			/* Yellow to red gradient (50% to 0%) */
 			/* Red stays at 255, green decreases from 255 to 0 */
 			color.red = 255;
-			color.green = (uint8_t)(255 * current_battery_level / 50);
+			color.green = (uint8_t)(255 * battery_level / 50);
 		}
 	}
 	
 	return color;
 }
 
+ble_bas_rgb_color_t ble_bas_get_battery_color(ble_bas_color_mode_t mode)
+{
+	return ble_bas_battery_color(current_battery_level, mode);
+}
+
 /* Battery Service callback implementations */
 static void battery_notify_cb(struct bt_bas_client *bas, uint8_t battery_level)
 {
+	uint8_t previous = current_battery_level;
+
 	if (battery_level == BT_BAS_VAL_INVALID) {
 		LOG_WRN("Battery notification aborted");
 		current_battery_level = 0xFF; /* Mark as invalid */
 	} else {
 		LOG_INF("=== BATTERY LEVEL: %d%% ===", battery_level);
 		current_battery_level = battery_level; /* Store current level */
+		connection_timing_mark(CONNECTION_TIMING_BAS_READY);
+	}
+
+	/* The MouthPad repeats its level; only a new one is worth a redraw */
+	if (current_battery_level != previous) {
+		relay_bus_telemetry_battery(current_battery_level);
 	}
 }
 
-static void battery_discovery_completed_cb(struct bt_gatt_dm *dm, void *context)
+int ble_bas_handles_assign(struct bt_gatt_dm *dm)
 {
 	int err;
 
-	LOG_INF("Battery Service discovery completed");
-
 	bt_gatt_dm_data_print(dm);
 
 	err = bt_bas_handles_assign(dm, &bas);
 	if (err) {
 		LOG_ERR("Could not assign BAS handles: %d", err);
-		goto cleanup;
+		return err;
 	}
 
 	if (bt_bas_notify_supported(&bas)) {
@@ -170,7 +183,17 @@ static void battery_discovery_completed_cb(struct bt_gatt_dm *dm, void *context)
 		}
 	}
 
-cleanup:
+	return err;
+}
+
+static void battery_discovery_completed_cb(struct bt_gatt_dm *dm, void *context)
+{
+	int err;
+
+	LOG_INF("Battery Service discovery completed");
+
+	ble_bas_handles_assign(dm);
+
 	err = bt_gatt_dm_data_release(dm);
 	if (err) {
 		LOG_ERR("Could not release battery discovery data: %d", err);
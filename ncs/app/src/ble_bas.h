@@ -9,6 +9,7 @@
 #define BLE_BAS_H_
 
 #include <zephyr/bluetooth/conn.h>
+#include <bluetooth/gatt_dm.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +30,16 @@ int ble_bas_init(void);
  */
 int ble_bas_discover(struct bt_conn *conn);
 
+/**
+ * @brief Take the handles from a discovered Battery Service and subscribe
+ *
+ * The caller releases the discovery data.
+ *
+ * @param dm Discovery data for the Battery Service
+ * @return 0 on success, negative error code on failure
+ */
+int ble_bas_handles_assign(struct bt_gatt_dm *dm);
+
 /**
  * @brief Check if Battery Service is ready and operational
  * 
@@ -75,6 +86,17 @@ typedef struct {
  */
 ble_bas_rgb_color_t ble_bas_get_battery_color(ble_bas_color_mode_t mode);
 
+/**
+ * @brief Get the LED color for any battery level
+ *
+ * For building lookup tables ahead of the level being known.
+ *
+ * @param battery_level Percentage (0-100); anything else is shown as full
+ * @param mode Color mode (discrete quarters or smooth gradient)
+ * @return RGB color structure representing the battery level
+ */
+ble_bas_rgb_color_t ble_bas_battery_color(uint8_t battery_level, ble_bas_color_mode_t mode);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,6 +7,18 @@
 
 #include "ble_central.h"
 #include "ble_dis.h"
+#include "ble_discovery.h"
+#include "ble_conn_params.h"
+#include "connection_timing.h"
+#include "link_state.h"
+#include "oled_display.h"
+#include "pairing_timing.h"
+#include "relay_device_info.h"
+#include "relay_events.h"
+#include "relay_store.h"
+#include "relay_workq.h"
+#include "scan_schedule.h"
+#include "trace_ring.h"
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/hci.h>
@@ -37,8 +49,28 @@ enum ble_central_state {
 static struct bt_conn *default_conn;
 static struct k_work scan_work;
 static struct k_work_delayable scan_indicator_work;
+static struct k_work_delayable scan_schedule_work;
+static void scan_schedule_handler(struct k_work *work);
 static enum ble_central_state connection_state = BLE_CENTRAL_STATE_DISCONNECTED;
 
+/* The same phases, in the link-state snapshot */
+static const uint8_t snapshot_phase[] = {
+	[BLE_CENTRAL_STATE_DISCONNECTED] = LINK_STATE_IDLE,
+	[BLE_CENTRAL_STATE_SCANNING] = LINK_STATE_SCANNING,
+	[BLE_CENTRAL_STATE_CONNECTING] = LINK_STATE_CONNECTING,
+	[BLE_CENTRAL_STATE_CONNECTED] = LINK_STATE_CONNECTED,
+};
+
+/* Every transition wakes the main thread, which pushes the new status to the host */
+static void set_connection_state(enum ble_central_state state)
+{
+	if (connection_state != state) {
+		connection_state = state;
+		link_state_set_phase(snapshot_phase[state]);
+		relay_events_post(RELAY_EVENT_LINK);
+	}
+}
+
 /* Scanning mode for multi-bond support */
 typedef enum {
 	SCAN_MODE_NORMAL,      /* Connect to any bonded device */
@@ -55,6 +87,33 @@ static int64_t additional_scan_start_time = 0;
 /* Track if any bonded devices are advertising in current scan session */
 static bool bonded_device_seen_advertising = false;
 
+/* Controller-side reconnect to bonded devices (CONFIG_BLE_BONDED_AUTO_CONNECT) */
+static bool auto_connect_active = false;
+
+/* Set when an auto-connect attempt timed out: scan with the host filters
+ * (which also accept a new MouthPad) until the next disconnection
+ */
+static bool auto_connect_fallback = false;
+
+/* Set while the pending auto-connect is for a secondary MouthPad
+ * (CONFIG_BLE_MULTI_MOUTHPAD); its result goes to the secondary callbacks
+ */
+static bool auto_connect_secondary = false;
+
+/* Full rate after a boost, then backed off; see scan_schedule.h */
+static struct scan_schedule scan_schedule;
+static K_SPINLOCK_DEFINE(scan_schedule_lock);
+
+static const struct scan_schedule_config scan_schedule_config = {
+	.fast_ms = CONFIG_BLE_SCAN_FAST_MS,
+	.step_ms = CONFIG_BLE_SCAN_BACKOFF_STEP_MS,
+	.fast_interval = 0x0010, /* 10ms, with the window: continuous */
+	.fast_window = 0x0010,
+	.window = SCAN_SCHEDULE_UNITS(CONFIG_BLE_SCAN_BACKOFF_WINDOW_MS),
+	.interval_min = SCAN_SCHEDULE_UNITS(CONFIG_BLE_SCAN_BACKOFF_INTERVAL_MIN_MS),
+	.interval_max = SCAN_SCHEDULE_UNITS(CONFIG_BLE_SCAN_BACKOFF_INTERVAL_MAX_MS),
+};
+
 /* Multi-bond device tracking */
 /* MAX_BONDED_DEVICES and struct bonded_device are defined in ble_central.h */
 
@@ -62,6 +121,11 @@ static struct bonded_device bonded_devices[MAX_BONDED_DEVICES];
 static uint8_t bonded_device_count = 0;
 static K_MUTEX_DEFINE(bonded_devices_mutex);
 
+/* Slots in the saved record (relay_store.h); a bond found only through
+ * bt_foreach_bond has its slot written at its next connection
+ */
+static atomic_t bond_stored;
+
 /* Device UUID tracking - to verify both HID and NUS across multiple packets */
 struct device_uuid_state {
 	bt_addr_le_t addr;
@@ -70,10 +134,23 @@ struct device_uuid_state {
 	bool has_mfr_data;
 	int8_t rssi;
 	int64_t timestamp;
+	char name[32]; /* From advertising data, "" if none seen yet */
 };
 
-static struct device_uuid_state tracked_devices[4];
-static K_MUTEX_DEFINE(tracked_devices_mutex);
+/* Hash table of recently seen advertisers. Each address lives in one of the
+ * TRACKED_DEVICE_PROBES slots after its hash, so a lookup is a fixed number of
+ * compares however crowded the room is. A new device takes the first stale
+ * slot there, or the least recently seen one.
+ *
+ * It is only touched from the BT RX thread (scan and connection callbacks),
+ * so there is no lock; entries age out by timestamp instead of a timer, which
+ * would be a second writer.
+ */
+#define TRACKED_DEVICES_SIZE 32 /* Power of two */
+#define TRACKED_DEVICE_PROBES 4
+#define TRACKED_DEVICE_TTL_MS 10000
+
+static struct device_uuid_state tracked_devices[TRACKED_DEVICES_SIZE];
 
 /* Device type detection */
 static bool is_nus_device(const struct bt_scan_device_info *device_info);
@@ -83,6 +160,9 @@ static bool is_mouthpad_manufacturer_data(const struct bt_scan_device_info *devi
 /* Callback functions for external modules */
 static ble_central_connected_cb_t connected_cb;
 static ble_central_disconnected_cb_t disconnected_cb;
+static ble_central_secondary_connected_cb_t secondary_connected_cb;
+static ble_central_disconnected_cb_t secondary_disconnected_cb;
+static ble_central_standby_cb_t standby_cb;
 
 /* BLE Central callbacks */
 static void connected(struct bt_conn *conn, uint8_t conn_err);
@@ -112,11 +192,12 @@ static void auth_cancel(struct bt_conn *conn);
 static void pairing_complete(struct bt_conn *conn, bool bonded);
 static void pairing_failed(struct bt_conn *conn, enum bt_security_err reason);
 
-/* Settings persistence for bonded device name */
+/* Per-key bond entries older firmware wrote, read once into the record
+ * (relay_store.h)
+ */
 static int bonded_name_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg);
-static int bonded_name_commit(void);
 
-SETTINGS_STATIC_HANDLER_DEFINE(ble_central, "ble_central", NULL, bonded_name_set, bonded_name_commit, NULL);
+SETTINGS_STATIC_HANDLER_DEFINE(ble_central, "ble_central", NULL, bonded_name_set, NULL, NULL);
 
 /* Connection callbacks structure */
 BT_CONN_CB_DEFINE(conn_callbacks) = {
@@ -137,6 +218,10 @@ static void scan_no_match(struct bt_scan_device_info *device_info, bool connecta
 /* Forward declaration for additional scan timeout check */
 static void check_additional_scan_timeout(void);
 
+/* Forward declarations for bonded auto-connect */
+static void stop_auto_connect(void);
+static void fallback_device_name(const bt_addr_le_t *addr, char *device_name);
+
 /* Scan callbacks structure */
 BT_SCAN_CB_INIT(scan_cb, scan_filter_match, scan_no_match,
 		scan_connecting_error, scan_connecting);
@@ -155,6 +240,46 @@ static struct bt_conn_auth_info_cb conn_auth_info_callbacks = {
 	.pairing_failed = pairing_failed
 };
 
+/* Name a device connected without advertising data from its bond */
+static void name_device_from_bond(struct bt_conn *conn)
+{
+	char device_name[13];
+	fallback_device_name(bt_conn_get_dst(conn), device_name);
+
+	extern void ble_transport_set_device_name(const char *name);
+	ble_transport_set_device_name(device_name);
+
+	oled_display_device_found(device_name);
+}
+
+/* Make an already connected, encrypted secondary link the primary one. The
+ * reference held for the secondary link becomes default_conn's.
+ */
+static void promote_standby(struct bt_conn *conn)
+{
+	char addr[BT_ADDR_LE_STR_LEN];
+
+	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
+	LOG_INF("PROMOTING HOT-STANDBY DEVICE: %s", addr);
+
+	/* Its record shows the switch: no scan, connection or pairing to wait for */
+	connection_timing_scan_started();
+	connection_timing_set_bonded(true);
+	connection_timing_mark(CONNECTION_TIMING_CONNECT_REQUEST);
+	connection_timing_mark(CONNECTION_TIMING_CONNECTED);
+	connection_timing_mark(CONNECTION_TIMING_SECURITY);
+
+	default_conn = conn;
+	name_device_from_bond(conn);
+
+	set_connection_state(BLE_CENTRAL_STATE_CONNECTING);
+	LOG_INF("*** STATE SET TO CONNECTING (waiting for service discovery) ***");
+
+	if (connected_cb) {
+		connected_cb(conn);
+	}
+}
+
 /* Connection callback implementations */
 static void connected(struct bt_conn *conn, uint8_t conn_err)
 {
@@ -163,12 +288,33 @@ static void connected(struct bt_conn *conn, uint8_t conn_err)
 
 	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
 
+	/* A secondary link, or a secondary attempt that ended; one that
+	 * completes after the primary dropped becomes the primary instead
+	 */
+	if (auto_connect_secondary && (conn_err || default_conn)) {
+		auto_connect_secondary = false;
+		auto_connect_active = false;
+
+		if (secondary_connected_cb) {
+			secondary_connected_cb(conn, conn_err);
+		}
+		return;
+	}
+	auto_connect_secondary = false;
+
 	if (conn_err) {
 		LOG_ERR("CONNECTION FAILED: %s, error: 0x%02x (%s)", addr, conn_err,
 			bt_hci_err_to_str(conn_err));
 
+		/* An auto-connect failing on its own (normally the timeout) */
+		if (auto_connect_active) {
+			auto_connect_active = false;
+			auto_connect_fallback = true;
+			LOG_INF("No bonded MouthPad connected - falling back to filtered scan");
+		}
+
 		/* Connection failed - return to disconnected state */
-		connection_state = BLE_CENTRAL_STATE_DISCONNECTED;
+		set_connection_state(BLE_CENTRAL_STATE_DISCONNECTED);
 		LOG_INF("*** STATE SET TO DISCONNECTED (connection failed) ***");
 
 		/* Clean up connection reference if it was stored */
@@ -179,18 +325,28 @@ static void connected(struct bt_conn *conn, uint8_t conn_err)
 
 		/* Always restart scanning after connection failure */
 		LOG_INF("Restarting scan after connection failure");
-		(void)k_work_submit(&scan_work);
+		(void)k_work_submit_to_queue(&relay_workq_protocol, &scan_work);
 
 		return;
 	}
 
 	LOG_INF("CONNECTED TO DEVICE: %s", addr);
 
+	connection_timing_mark(CONNECTION_TIMING_CONNECTED);
+	connection_timing_set_bonded(ble_central_is_device_bonded(bt_conn_get_dst(conn)));
+	pairing_timing_connected();
+
 	/* Store connection reference */
 	default_conn = bt_conn_ref(conn);
 
+	/* An auto-connect saw no advertising data: name the device from the bond */
+	if (auto_connect_active) {
+		auto_connect_active = false;
+		name_device_from_bond(conn);
+	}
+
 	/* Update state to CONNECTING - will transition to CONNECTED when services are ready */
-	connection_state = BLE_CENTRAL_STATE_CONNECTING;
+	set_connection_state(BLE_CENTRAL_STATE_CONNECTING);
 	LOG_INF("*** STATE SET TO CONNECTING (waiting for service discovery) ***");
 
 	/* Stop scanning */
@@ -214,6 +370,9 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 	LOG_INF("DISCONNECTED FROM DEVICE: %s, reason: 0x%02x (%s)", addr, reason, bt_hci_err_to_str(reason));
 
 	if (default_conn != conn) {
+		if (secondary_disconnected_cb) {
+			secondary_disconnected_cb(conn, reason);
+		}
 		return;
 	}
 
@@ -221,9 +380,17 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 	default_conn = NULL;
 
 	/* Update state to disconnected */
-	connection_state = BLE_CENTRAL_STATE_DISCONNECTED;
+	set_connection_state(BLE_CENTRAL_STATE_DISCONNECTED);
 	LOG_INF("*** STATE SET TO DISCONNECTED (device disconnected) ***");
 
+	connection_timing_disconnected();
+	pairing_timing_disconnected();
+	trace_ring_record(TRACE_EVENT_DISCONNECTED, reason, 0);
+
+	/* The device we just lost is the likeliest to come back: try the fast path first */
+	auto_connect_fallback = false;
+	ble_central_scan_boost();
+
 	/* Stop any background scanning */
 	stop_background_scan();
 
@@ -232,8 +399,16 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 		disconnected_cb(conn, reason);
 	}
 
+	/* A hot-standby MouthPad takes over without a scan */
+	struct bt_conn *standby = standby_cb ? standby_cb() : NULL;
+
+	if (standby) {
+		promote_standby(standby);
+		return;
+	}
+
 	LOG_INF("RESTARTING SCAN AFTER DISCONNECTION");
-	(void)k_work_submit(&scan_work);
+	(void)k_work_submit_to_queue(&relay_workq_protocol, &scan_work);
 }
 
 static void security_changed(struct bt_conn *conn, bt_security_t level,
@@ -245,9 +420,28 @@ static void security_changed(struct bt_conn *conn, bt_security_t level,
 
 	if (!err) {
 		LOG_INF("Security changed: %s level %u", addr, level);
+		connection_timing_mark(CONNECTION_TIMING_SECURITY);
+		if (conn == default_conn) {
+			pairing_timing_mark(PAIRING_TIMING_ENCRYPTED);
+		}
 	} else {
 		LOG_WRN("Security failed: %s level %u err %d %s", addr, level, err,
 			bt_security_err_to_str(err));
+		if (conn == default_conn) {
+			pairing_timing_failed(err);
+		}
+	}
+}
+
+/* Pairing steps of the primary link so far */
+static void log_pairing_timing(void)
+{
+	struct pairing_timing_record timing[PAIRING_TIMING_RECORDS];
+	char line[128];
+
+	if (pairing_timing_get(timing) > 0) {
+		pairing_timing_format(&timing[0], line, sizeof(line));
+		LOG_INF("Pairing timing (ms after link up): %s", line);
 	}
 }
 
@@ -275,39 +469,73 @@ static void scan_indicator_handler(struct k_work *work)
 			LOG_INF("Scanning for MouthPad...");
 		}
 		/* Re-schedule for next message */
-		k_work_schedule(&scan_indicator_work, K_SECONDS(1));
+		k_work_schedule_for_queue(&relay_workq_background, &scan_indicator_work, K_SECONDS(1));
 	}
 }
 
+static uint32_t tracked_device_hash(const bt_addr_le_t *addr)
+{
+	/* FNV-1a over the address and its type */
+	uint32_t hash = 2166136261u;
+
+	for (int i = 0; i < ARRAY_SIZE(addr->a.val); i++) {
+		hash = (hash ^ addr->a.val[i]) * 16777619u;
+	}
+	return (hash ^ addr->type) * 16777619u;
+}
+
+static bool tracked_device_is_live(const struct device_uuid_state *state, int64_t now)
+{
+	return state->timestamp != 0 && now - state->timestamp < TRACKED_DEVICE_TTL_MS;
+}
+
+/* Find the live entry for addr, or NULL */
+static struct device_uuid_state *find_device_state(const bt_addr_le_t *addr)
+{
+	int64_t now = k_uptime_get();
+	uint32_t home = tracked_device_hash(addr);
+
+	for (int i = 0; i < TRACKED_DEVICE_PROBES; i++) {
+		struct device_uuid_state *state =
+			&tracked_devices[(home + i) & (TRACKED_DEVICES_SIZE - 1)];
+
+		if (tracked_device_is_live(state, now) && bt_addr_le_eq(&state->addr, addr)) {
+			return state;
+		}
+	}
+
+	return NULL;
+}
+
 /* Helper function to find or create device UUID state */
 static struct device_uuid_state *find_or_create_device_state(const bt_addr_le_t *addr)
 {
-	int64_t now = k_uptime_get();
-	int oldest_idx = 0;
-	int64_t oldest_time = now;
+	struct device_uuid_state *state = find_device_state(addr);
+	if (state) {
+		return state;
+	}
 
-	k_mutex_lock(&tracked_devices_mutex, K_FOREVER);
+	/* Not found - reuse the first stale slot, else the least recently seen */
+	int64_t now = k_uptime_get();
+	uint32_t home = tracked_device_hash(addr);
+	struct device_uuid_state *oldest = NULL;
 
-	/* First try to find existing entry */
-	for (int i = 0; i < ARRAY_SIZE(tracked_devices); i++) {
-		if (bt_addr_le_cmp(&tracked_devices[i].addr, addr) == 0) {
-			k_mutex_unlock(&tracked_devices_mutex);
-			return &tracked_devices[i];
+	for (int i = 0; i < TRACKED_DEVICE_PROBES; i++) {
+		state = &tracked_devices[(home + i) & (TRACKED_DEVICES_SIZE - 1)];
+		if (!tracked_device_is_live(state, now)) {
+			oldest = state;
+			break;
 		}
-		/* Track oldest entry for potential reuse */
-		if (tracked_devices[i].timestamp < oldest_time) {
-			oldest_time = tracked_devices[i].timestamp;
-			oldest_idx = i;
+		if (!oldest || state->timestamp < oldest->timestamp) {
+			oldest = state;
 		}
 	}
 
-	/* Not found - reuse oldest entry */
-	memset(&tracked_devices[oldest_idx], 0, sizeof(struct device_uuid_state));
-	bt_addr_le_copy(&tracked_devices[oldest_idx].addr, addr);
-	tracked_devices[oldest_idx].timestamp = now;
+	memset(oldest, 0, sizeof(*oldest));
+	bt_addr_le_copy(&oldest->addr, addr);
+	oldest->timestamp = now;
 
-	k_mutex_unlock(&tracked_devices_mutex);
-	return &tracked_devices[oldest_idx];
+	return oldest;
 }
 
 /* Scan callback implementations */
@@ -353,6 +581,8 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 		}
 	}
 
+	connection_timing_mark(CONNECTION_TIMING_FIRST_ADV);
+
 	int8_t rssi = device_info->recv_info->rssi;
 
 	/* Find or create device state to track UUIDs across multiple packets */
@@ -373,12 +603,9 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 		return;
 	}
 
-	/* Verify device has both HID and NUS services (accumulated across packets) */
-	if (!dev_state->has_hid || !dev_state->has_nus) {
-		/* Still waiting for both UUIDs - don't log to reduce spam */
-		return;
-	}
-
+	/* A bonded address or the MouthPad manufacturer data identifies it from
+	 * the primary advertisement alone, with no scan response to wait for
+	 */
 	if (!is_bonded && !dev_state->has_mfr_data) {
 		LOG_DBG("Skipping device %s: missing expected manufacturer data", addr);
 		return;
@@ -386,7 +613,7 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 
 	/* CRITICAL: Set connecting state IMMEDIATELY before any logging or processing
 	 * This ensures status queries return CONNECTING as soon as we decide to connect */
-	connection_state = BLE_CENTRAL_STATE_CONNECTING;
+	set_connection_state(BLE_CENTRAL_STATE_CONNECTING);
 	LOG_INF("*** STATE SET TO CONNECTING ***");
 
 	/* Device has both services - log and proceed with connection */
@@ -405,26 +632,7 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 		LOG_INF("Extracted device name from advertising: '%s'", device_name);
 		device_name[12] = '\0';  /* Truncate to 12 chars for display */
 	} else {
-		/* Fallback to checking stored names */
-		const char *stored_name = get_stored_device_name_for_addr(device_info->recv_info->addr);
-		if (stored_name) {
-			strncpy(device_name, stored_name, 12);
-			device_name[12] = '\0';
-			LOG_INF("Using stored device name: '%s'", device_name);
-		} else {
-			/* Final fallback - use shortened address */
-			char addr_str[BT_ADDR_LE_STR_LEN];
-			bt_addr_le_to_str(device_info->recv_info->addr, addr_str, sizeof(addr_str));
-			/* Use last 12 chars of address */
-			int addr_len = strlen(addr_str);
-			if (addr_len > 12) {
-				strncpy(device_name, addr_str + addr_len - 12, 12);
-			} else {
-				strncpy(device_name, addr_str, 12);
-			}
-			device_name[12] = '\0';
-			LOG_INF("No device name found, using address: '%s'", device_name);
-		}
+		fallback_device_name(device_info->recv_info->addr, device_name);
 	}
 
 	/* Store device name in transport layer */
@@ -432,7 +640,6 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 	ble_transport_set_device_name(device_name);
 
 	/* Update display to show device found */
-	extern int oled_display_device_found(const char *device_name);
 	oled_display_device_found(device_name);
 
 	/* Manually initiate connection (since auto-connect is disabled) */
@@ -449,22 +656,24 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 		bt_conn_unref(existing_conn); /* Unref the actual connection */
 	}
 
-	/* Create connection with default parameters */
+	/* Create connection with the active (lowest latency) parameters */
 	struct bt_conn *conn = NULL;
-	struct bt_le_conn_param *conn_param = BT_LE_CONN_PARAM_DEFAULT;
+	struct bt_le_conn_param *conn_param = BLE_CONN_PARAMS_ACTIVE;
 
 	err = bt_conn_le_create(device_info->recv_info->addr, BT_CONN_LE_CREATE_CONN,
 				conn_param, &conn);
 	if (err) {
 		LOG_ERR("Failed to create connection (err %d)", err);
 		/* Restart scanning on error */
-		connection_state = BLE_CENTRAL_STATE_DISCONNECTED;
+		set_connection_state(BLE_CENTRAL_STATE_DISCONNECTED);
 		LOG_INF("*** STATE SET TO DISCONNECTED (bt_conn_le_create failed) ***");
-		k_work_schedule(&scan_indicator_work, K_SECONDS(1));
-		(void)k_work_submit(&scan_work);
+		k_work_schedule_for_queue(&relay_workq_background, &scan_indicator_work, K_SECONDS(1));
+		(void)k_work_submit_to_queue(&relay_workq_protocol, &scan_work);
 		return;
 	}
 
+	connection_timing_mark(CONNECTION_TIMING_CONNECT_REQUEST);
+
 	/* bt_conn_le_create returns with a reference, but we don't store it here
 	 * The 'connected' callback will get the connection and create its own reference
 	 * So we need to unref this one to avoid leaking */
@@ -473,6 +682,53 @@ static void scan_filter_match(struct bt_scan_device_info *device_info,
 	LOG_INF("Connection creation initiated successfully");
 }
 
+/* Name for a device without a name in its advertising, at most 12 characters.
+ * A bond's saved name comes first: the advertising-name cache expires after
+ * TRACKED_DEVICE_TTL_MS and is empty after a controller auto-connect.
+ */
+static void fallback_device_name(const bt_addr_le_t *addr, char *device_name)
+{
+	bool bonded_name = false;
+
+	k_mutex_lock(&bonded_devices_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_BONDED_DEVICES; i++) {
+		if (bonded_devices[i].is_valid && bonded_devices[i].name[0] != '\0' &&
+		    bt_addr_le_eq(&bonded_devices[i].addr, addr)) {
+			strncpy(device_name, bonded_devices[i].name, 12);
+			device_name[12] = '\0';
+			bonded_name = true;
+			break;
+		}
+	}
+	k_mutex_unlock(&bonded_devices_mutex);
+
+	if (bonded_name) {
+		LOG_INF("Using bonded device name: '%s'", device_name);
+		return;
+	}
+
+	/* Fallback to checking stored names */
+	const char *stored_name = get_stored_device_name_for_addr(addr);
+	if (stored_name) {
+		strncpy(device_name, stored_name, 12);
+		device_name[12] = '\0';
+		LOG_INF("Using stored device name: '%s'", device_name);
+	} else {
+		/* Final fallback - use shortened address */
+		char addr_str[BT_ADDR_LE_STR_LEN];
+		bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+		/* Use last 12 chars of address */
+		int addr_len = strlen(addr_str);
+		if (addr_len > 12) {
+			strncpy(device_name, addr_str + addr_len - 12, 12);
+		} else {
+			strncpy(device_name, addr_str, 12);
+		}
+		device_name[12] = '\0';
+		LOG_INF("No device name found, using address: '%s'", device_name);
+	}
+}
+
 static void scan_connecting_error(struct bt_scan_device_info *device_info)
 {
 	char addr[BT_ADDR_LE_STR_LEN];
@@ -507,6 +763,10 @@ static void pairing_complete(struct bt_conn *conn, bool bonded)
 	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
 
 	LOG_INF("Pairing completed: %s, bonded: %d", addr, bonded);
+	if (conn == default_conn) {
+		pairing_timing_mark(PAIRING_TIMING_DONE);
+		log_pairing_timing();
+	}
 
 	/* If bonded, add to bonded devices list */
 	if (bonded) {
@@ -539,9 +799,13 @@ static void pairing_failed(struct bt_conn *conn, enum bt_security_err reason)
 
 	LOG_WRN("Pairing failed conn: %s, reason %d %s", addr, reason,
 		bt_security_err_to_str(reason));
+	if (conn == default_conn) {
+		pairing_timing_failed(reason);
+		log_pairing_timing();
+	}
 }
 
-/* Settings handlers for persisting bonded device name */
+/* Older firmware's ble_central/bond_<n>/name and .../addr keys */
 static int bonded_name_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
 {
 	int rc;
@@ -661,61 +925,66 @@ static void display_bonded_devices(void)
 	k_mutex_unlock(&bonded_devices_mutex);
 }
 
-static int bonded_name_commit(void)
+/* Section layout, per valid slot: slot, address, name length, name */
+size_t ble_central_store_save(uint8_t *buf, size_t size)
 {
-	/* Settings have been loaded - names are now populated in bonded_devices array */
-	LOG_INF("Settings loaded for %d bonded devices", bonded_device_count);
-
-	/* Display all bonded devices */
-	display_bonded_devices();
-
-	return 0;
-}
+	size_t len = 0;
 
-/* Save bonded device address to persistent settings */
-static void save_bonded_device_addr(int bond_idx, const bt_addr_le_t *addr)
-{
-	if (!IS_ENABLED(CONFIG_SETTINGS)) {
-		return;
-	}
+	k_mutex_lock(&bonded_devices_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_BONDED_DEVICES; i++) {
+		const struct bonded_device *dev = &bonded_devices[i];
+		size_t name_len = strlen(dev->name);
 
-	if (bond_idx < 0 || bond_idx >= MAX_BONDED_DEVICES) {
-		return;
+		if (!dev->is_valid) {
+			continue;
+		}
+		if (size - len < 2 + sizeof(bt_addr_le_t) + name_len) {
+			LOG_WRN("Bond %d does not fit the record", i);
+			break;
+		}
+		buf[len++] = (uint8_t)i;
+		memcpy(&buf[len], &dev->addr, sizeof(bt_addr_le_t));
+		len += sizeof(bt_addr_le_t);
+		buf[len++] = (uint8_t)name_len;
+		memcpy(&buf[len], dev->name, name_len);
+		len += name_len;
+		atomic_set_bit(&bond_stored, i);
 	}
+	k_mutex_unlock(&bonded_devices_mutex);
 
-	char key[64];
-	snprintf(key, sizeof(key), "ble_central/bond_%d/addr", bond_idx);
-
-	int err = settings_save_one(key, addr, sizeof(bt_addr_le_t));
-	if (err) {
-		LOG_ERR("Failed to save bond %d address to settings (err %d)", bond_idx, err);
-	} else {
-		char addr_str[BT_ADDR_LE_STR_LEN];
-		bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
-		LOG_DBG("Saved bond %d address to settings: %s", bond_idx, addr_str);
-	}
+	return len;
 }
 
-/* Save bonded device name to persistent settings */
-static void save_bonded_device_name(int bond_idx, const char *name)
+void ble_central_store_load(const uint8_t *buf, size_t len)
 {
-	if (!IS_ENABLED(CONFIG_SETTINGS)) {
-		return;
-	}
+	size_t pos = 0;
 
-	if (bond_idx < 0 || bond_idx >= MAX_BONDED_DEVICES) {
-		return;
-	}
+	k_mutex_lock(&bonded_devices_mutex, K_FOREVER);
+	while (len - pos >= 2 + sizeof(bt_addr_le_t)) {
+		uint8_t slot = buf[pos];
+		size_t name_len = buf[pos + 1 + sizeof(bt_addr_le_t)];
+		struct bonded_device *dev;
+
+		if (slot >= MAX_BONDED_DEVICES || name_len >= sizeof(dev->name) ||
+		    len - pos < 2 + sizeof(bt_addr_le_t) + name_len) {
+			LOG_WRN("Bond section malformed at %u", (unsigned int)pos);
+			break;
+		}
 
-	char key[64];
-	snprintf(key, sizeof(key), "ble_central/bond_%d/name", bond_idx);
+		dev = &bonded_devices[slot];
+		if (!dev->is_valid) {
+			bonded_device_count++;
+		}
+		memcpy(&dev->addr, &buf[pos + 1], sizeof(bt_addr_le_t));
+		memcpy(dev->name, &buf[pos + 2 + sizeof(bt_addr_le_t)], name_len);
+		dev->name[name_len] = '\0';
+		dev->is_valid = true;
+		dev->last_seen = 0;
+		atomic_set_bit(&bond_stored, slot);
 
-	int err = settings_save_one(key, name, name ? strlen(name) : 0);
-	if (err) {
-		LOG_ERR("Failed to save bond %d name to settings (err %d)", bond_idx, err);
-	} else {
-		LOG_INF("Saved bond %d name to settings: '%s'", bond_idx, name ? name : "");
+		pos += 2 + sizeof(bt_addr_le_t) + name_len;
 	}
+	k_mutex_unlock(&bonded_devices_mutex);
 }
 
 /* Helper to check and store bonded device */
@@ -728,7 +997,6 @@ static void check_bonded_device(const struct bt_bond_info *info, void *user_data
 	ble_dis_info_t dis_info;
 	memset(&dis_info, 0, sizeof(dis_info));
 
-	extern int ble_dis_load_info_for_addr(const bt_addr_le_t *addr, ble_dis_info_t *out_info);
 	int err = ble_dis_load_info_for_addr(&info->addr, &dis_info);
 	if (err != 0) {
 		LOG_WRN("Failed to load DIS info for %s (err: %d)", addr, err);
@@ -771,6 +1039,7 @@ static void check_bonded_device(const struct bt_bond_info *info, void *user_data
 	}
 
 	k_mutex_unlock(&bonded_devices_mutex);
+	relay_device_info_invalidate();
 }
 
 /* Helper structure for UUID search */
@@ -904,6 +1173,7 @@ int ble_central_init(void)
 		return err;
 	}
 	LOG_INF("Bluetooth initialized successfully");
+	connection_timing_boot_mark(CONNECTION_TIMING_BOOT_BLE_READY);
 
 	/* Register authentication callbacks */
 	err = bt_conn_auth_cb_register(&conn_auth_callbacks);
@@ -926,11 +1196,18 @@ int ble_central_init(void)
 	bonded_device_count = 0;
 	k_mutex_unlock(&bonded_devices_mutex);
 
-	/* Load settings BEFORE enumerating bonds (fixes bond restoration after reboot) */
+	/* Load settings BEFORE enumerating bonds (fixes bond restoration after reboot).
+	 * Only the subtrees in use: the stack's keys and the tuning profile,
+	 * then the relay's own record in one read.
+	 */
 	if (IS_ENABLED(CONFIG_SETTINGS)) {
 		LOG_INF("Loading settings...");
-		settings_load();
+		settings_load_subtree("bt");
+		settings_load_subtree("tuning");
 	}
+	relay_store_load();
+	LOG_INF("Settings loaded for %d bonded devices", bonded_device_count);
+	display_bonded_devices();
 
 	/* Check if we have any bonded devices (AFTER settings loaded) */
 	bt_foreach_bond(BT_ID_DEFAULT, check_bonded_device, NULL);
@@ -947,11 +1224,150 @@ int ble_central_init(void)
 	/* Initialize scan work */
 	k_work_init(&scan_work, scan_work_handler);
 	k_work_init_delayable(&scan_indicator_work, scan_indicator_handler);
+	k_work_init_delayable(&scan_schedule_work, scan_schedule_handler);
+	scan_schedule_init(&scan_schedule, &scan_schedule_config, k_uptime_get());
 	LOG_INF("Scan module initialized");
 
 	return 0;
 }
 
+/* Show the scanning state once either scan flavour is running */
+static void enter_scanning_state(void)
+{
+	/* Update state to scanning */
+	set_connection_state(BLE_CENTRAL_STATE_SCANNING);
+	LOG_INF("*** STATE SET TO SCANNING ***");
+
+	connection_timing_scan_started();
+
+	/* Start scanning indicator */
+	k_work_schedule_for_queue(&relay_workq_background, &scan_indicator_work, K_NO_WAIT);
+
+	/* Update display to show scanning status */
+	oled_display_scanning();
+}
+
+static struct scan_schedule_params scan_schedule_params_now(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&scan_schedule_lock);
+	struct scan_schedule_params params = scan_schedule_get(&scan_schedule, k_uptime_get());
+
+	k_spin_unlock(&scan_schedule_lock, key);
+	return params;
+}
+
+/* Restart the scan with the next step of the schedule once it is due */
+static void scan_schedule_arm(uint32_t next_ms)
+{
+	if (next_ms) {
+		k_work_reschedule_for_queue(&relay_workq_protocol, &scan_schedule_work,
+					    K_MSEC(next_ms));
+	} else {
+		k_work_cancel_delayable(&scan_schedule_work);
+	}
+}
+
+static void scan_schedule_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (connection_state == BLE_CENTRAL_STATE_SCANNING) {
+		LOG_INF("Scan schedule step");
+		(void)ble_central_start_scan();
+	}
+}
+
+void ble_central_scan_boost(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&scan_schedule_lock);
+	bool restart = scan_schedule_boost(&scan_schedule, k_uptime_get());
+
+	k_spin_unlock(&scan_schedule_lock, key);
+
+	if (restart && connection_state == BLE_CENTRAL_STATE_SCANNING) {
+		LOG_INF("Scan boosted to full rate");
+		(void)k_work_submit_to_queue(&relay_workq_protocol, &scan_work);
+	}
+}
+
+/* Let the controller connect to the first bonded device it hears, without
+ * reporting advertisements to the host. Bonds are on the resolving list, so
+ * this also matches their resolvable private addresses. Bonded devices that
+ * are already connected are left off the list.
+ */
+static int start_auto_connect(bool secondary)
+{
+	int listed = 0;
+	int err = bt_le_filter_accept_list_clear();
+	if (err) {
+		return err;
+	}
+
+	k_mutex_lock(&bonded_devices_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_BONDED_DEVICES && !err; i++) {
+		if (!bonded_devices[i].is_valid) {
+			continue;
+		}
+
+		struct bt_conn *conn = bt_conn_lookup_addr_le(BT_ID_DEFAULT, &bonded_devices[i].addr);
+
+		if (conn) {
+			bt_conn_unref(conn);
+			continue;
+		}
+
+		err = bt_le_filter_accept_list_add(&bonded_devices[i].addr);
+		listed++;
+	}
+	k_mutex_unlock(&bonded_devices_mutex);
+
+	if (err) {
+		return err;
+	}
+	if (listed == 0) {
+		return -ENOENT;
+	}
+
+	/* Same schedule as the filtered scan below; a secondary attempt scans
+	 * a quarter of the time so the primary link keeps most of the radio
+	 */
+	struct scan_schedule_params scan = scan_schedule_params_now();
+	const struct bt_conn_le_create_param create_param = {
+		.options = BT_CONN_LE_OPT_NONE,
+		.interval = secondary ? MIN(scan.interval * 4, 0x4000) : scan.interval,
+		.window = scan.window,
+		.timeout = CONFIG_BLE_BONDED_AUTO_CONNECT_TIMEOUT_MS / 10,
+	};
+
+	auto_connect_active = true;
+	auto_connect_secondary = secondary;
+	err = bt_conn_le_create_auto(&create_param, BLE_CONN_PARAMS_ACTIVE);
+	if (err) {
+		auto_connect_active = false;
+		auto_connect_secondary = false;
+		return err;
+	}
+
+	LOG_INF("Auto-connecting to %d %sbonded device(s) from the accept list", listed,
+		secondary ? "secondary " : "");
+	return 0;
+}
+
+static void stop_auto_connect(void)
+{
+	if (!auto_connect_active) {
+		return;
+	}
+
+	/* Cleared first so the resulting connection failure is not taken for a timeout */
+	auto_connect_active = false;
+
+	int err = bt_conn_create_auto_stop();
+	if (err) {
+		LOG_WRN("Failed to stop auto-connect (err %d)", err);
+	}
+}
+
 int ble_central_start_scan(void)
 {
 	int err;
@@ -974,6 +1390,20 @@ int ble_central_start_scan(void)
 		return err;
 	}
 
+	stop_auto_connect();
+
+	/* Bonded reconnect needs no host-side advertisement parsing */
+	if (IS_ENABLED(CONFIG_BLE_BONDED_AUTO_CONNECT) && scan_mode == SCAN_MODE_NORMAL &&
+	    bonded_device_count > 0 && !auto_connect_fallback) {
+		err = start_auto_connect(false);
+		if (!err) {
+			enter_scanning_state();
+			scan_schedule_arm(scan_schedule_params_now().next_ms);
+			return 0;
+		}
+		LOG_WRN("Cannot start auto-connect (err %d), using filtered scan", err);
+	}
+
 	bt_scan_filter_remove_all();
 
 	/* Add UUID filters for both HID and NUS services (MouthPad has both) */
@@ -989,6 +1419,33 @@ int ble_central_start_scan(void)
 		return err;
 	}
 
+	/* The advertisers that are identified without a scan response: MouthPad
+	 * manufacturer data, and the bonded addresses
+	 */
+	static uint8_t mfr_filter_data[] = {
+		MOUTHPAD_COMPANY_ID & 0xFF, MOUTHPAD_COMPANY_ID >> 8, 'M', 'P', '1',
+	};
+	const struct bt_scan_manufacturer_data mfr_filter = {
+		.data = mfr_filter_data,
+		.data_len = sizeof(mfr_filter_data),
+	};
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA, &mfr_filter);
+	if (err) {
+		LOG_ERR("Cannot add manufacturer data scan filter (err %d)", err);
+		return err;
+	}
+
+	k_mutex_lock(&bonded_devices_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_BONDED_DEVICES; i++) {
+		if (bonded_devices[i].is_valid &&
+		    bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &bonded_devices[i].addr)) {
+			/* Past CONFIG_BT_SCAN_ADDRESS_CNT the UUIDs still find it */
+			break;
+		}
+	}
+	k_mutex_unlock(&bonded_devices_mutex);
+
 	/* Enable UUID filters - bond checking happens in scan_filter_match */
 	if (scan_mode == SCAN_MODE_ADDITIONAL) {
 		LOG_INF("Enabling HID+NUS UUID filter in ADDITIONAL scan mode (%d bonded, looking for NEW device)",
@@ -1002,55 +1459,58 @@ int ble_central_start_scan(void)
 		LOG_INF("Enabling HID+NUS UUID filter (no bonded devices - will pair with first MouthPad found)");
 	}
 
-	/* Enable filters with match_all=false (OR logic) so we get callbacks for devices with HID or NUS
-	 * We'll manually verify both UUIDs are present in scan_filter_match callback */
-	err = bt_scan_filter_enable(BT_SCAN_UUID_FILTER, false);
+	/* Enable filters with match_all=false (OR logic) so we get callbacks for devices with HID or NUS,
+	 * the manufacturer data or a bonded address; scan_filter_match decides which to connect to */
+	err = bt_scan_filter_enable(BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER |
+				    BT_SCAN_ADDR_FILTER, false);
 	if (err) {
 		LOG_ERR("Filters cannot be turned on (err %d)", err);
 		return err;
 	}
 
-	/* Set aggressive scan parameters for faster device discovery
-	 * Interval: 0x0010 = 16 * 0.625ms = 10ms (how often to start scanning)
-	 * Window: 0x0010 = 16 * 0.625ms = 10ms (how long to scan each time)
-	 * Setting interval == window means continuous scanning for fastest pairing
+	/* No scan requests once bonded (CONFIG_BLE_SCAN_PASSIVE): a MouthPad
+	 * being paired for the first time may only be recognisable from its
+	 * scan response
+	 */
+	bool active = !IS_ENABLED(CONFIG_BLE_SCAN_PASSIVE) || scan_mode == SCAN_MODE_ADDITIONAL ||
+		      bonded_device_count == 0;
+
+	/* Continuous 10ms/10ms scanning for fastest pairing after a boost,
+	 * duty-cycled once the schedule backs off
 	 */
+	struct scan_schedule_params scan = scan_schedule_params_now();
 	struct bt_le_scan_param scan_param = {
-		.type = BT_LE_SCAN_TYPE_ACTIVE,
+		.type = active ? BT_LE_SCAN_TYPE_ACTIVE : BT_LE_SCAN_TYPE_PASSIVE,
 		.options = BT_LE_SCAN_OPT_FILTER_DUPLICATE,
-		.interval = 0x0010,  /* 10ms */
-		.window = 0x0010,    /* 10ms - continuous scanning */
+		.interval = scan.interval,
+		.window = scan.window,
 	};
 
 	err = bt_scan_params_set(&scan_param);
 	if (err) {
 		LOG_WRN("Failed to set scan parameters (err %d), using defaults", err);
 	} else {
-		LOG_INF("Set aggressive scan parameters: interval=10ms, window=10ms (continuous)");
+		LOG_INF("Scan parameters: %s, interval=%u, window=%u (0.625ms units)",
+			active ? "active" : "passive", scan.interval, scan.window);
 	}
 
-	err = bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
+	err = bt_scan_start(active ? BT_SCAN_TYPE_SCAN_ACTIVE : BT_SCAN_TYPE_SCAN_PASSIVE);
 	if (err) {
 		LOG_ERR("Scanning failed to start (err %d)", err);
 		return err;
 	}
 
-	/* Update state to scanning */
-	connection_state = BLE_CENTRAL_STATE_SCANNING;
-	LOG_INF("*** STATE SET TO SCANNING ***");
-
-	/* Start scanning indicator */
-	k_work_schedule(&scan_indicator_work, K_NO_WAIT);
-
-	/* Update display to show scanning status */
-	extern int oled_display_scanning(void);
-	oled_display_scanning();
+	enter_scanning_state();
+	scan_schedule_arm(scan.next_ms);
 
 	return 0;
 }
 
 int ble_central_stop_scan(void)
 {
+	stop_auto_connect();
+	(void)k_work_cancel_delayable(&scan_schedule_work);
+
 	return bt_scan_stop();
 }
 
@@ -1115,6 +1575,31 @@ void ble_central_register_disconnected_cb(ble_central_disconnected_cb_t cb)
 	disconnected_cb = cb;
 }
 
+void ble_central_register_secondary_cbs(ble_central_secondary_connected_cb_t connected,
+					ble_central_disconnected_cb_t disconnected)
+{
+	secondary_connected_cb = connected;
+	secondary_disconnected_cb = disconnected;
+}
+
+void ble_central_register_standby_cb(ble_central_standby_cb_t cb)
+{
+	standby_cb = cb;
+}
+
+int ble_central_connect_secondary(void)
+{
+	if (connection_state != BLE_CENTRAL_STATE_CONNECTED) {
+		return -ENOTCONN;
+	}
+
+	if (auto_connect_active) {
+		return -EALREADY;
+	}
+
+	return start_auto_connect(true);
+}
+
 struct k_work *ble_central_get_scan_work(void)
 {
 	return &scan_work;
@@ -1273,43 +1758,22 @@ static int extract_device_name_from_scan(struct bt_scan_device_info *device_info
 	return -ENOENT;
 }
 
-/* Store device names from advertising data for later use */
-static char pending_device_names[8][32]; /* Store up to 8 device names */
-static bt_addr_le_t pending_device_addrs[8];
-static int pending_device_count = 0;
-
-/* Store device name for a specific address */
+/* Store device name from advertising data for later use */
 static void store_device_name_for_addr(const bt_addr_le_t *addr, const char *name)
 {
-	/* Check if we already have this device */
-	for (int i = 0; i < pending_device_count; i++) {
-		if (bt_addr_le_cmp(&pending_device_addrs[i], addr) == 0) {
-			/* Update existing entry */
-			strncpy(pending_device_names[i], name, sizeof(pending_device_names[i]) - 1);
-			pending_device_names[i][sizeof(pending_device_names[i]) - 1] = '\0';
-			return;
-		}
-	}
-	
-	/* Add new entry if we have space */
-	if (pending_device_count < ARRAY_SIZE(pending_device_names)) {
-		pending_device_addrs[pending_device_count] = *addr;
-		strncpy(pending_device_names[pending_device_count], name, 
-		        sizeof(pending_device_names[pending_device_count]) - 1);
-		pending_device_names[pending_device_count][sizeof(pending_device_names[pending_device_count]) - 1] = '\0';
-		pending_device_count++;
-	}
+	struct device_uuid_state *state = find_or_create_device_state(addr);
+
+	strncpy(state->name, name, sizeof(state->name) - 1);
+	state->name[sizeof(state->name) - 1] = '\0';
+	state->timestamp = k_uptime_get();
 }
 
 /* Get stored device name for a specific address */
 static const char *get_stored_device_name_for_addr(const bt_addr_le_t *addr)
 {
-	for (int i = 0; i < pending_device_count; i++) {
-		if (bt_addr_le_cmp(&pending_device_addrs[i], addr) == 0) {
-			return pending_device_names[i];
-		}
-	}
-	return NULL;
+	const struct device_uuid_state *state = find_device_state(addr);
+
+	return (state && state->name[0]) ? state->name : NULL;
 }
 
 /* Scan no_match callback to capture device names from all advertising packets */
@@ -1359,15 +1823,20 @@ int ble_central_add_bonded_device(const bt_addr_le_t *addr, const char *name)
 	for (int i = 0; i < MAX_BONDED_DEVICES; i++) {
 		if (bonded_devices[i].is_valid && bt_addr_le_eq(&bonded_devices[i].addr, addr)) {
 			/* Already bonded - update name and timestamp */
-			if (name) {
+			bool changed = false;
+
+			if (name && strncmp(bonded_devices[i].name, name,
+					    sizeof(bonded_devices[i].name) - 1) != 0) {
 				strncpy(bonded_devices[i].name, name, sizeof(bonded_devices[i].name) - 1);
 				bonded_devices[i].name[sizeof(bonded_devices[i].name) - 1] = '\0';
-				save_bonded_device_name(i, name);
+				changed = true;
 			}
 			bonded_devices[i].last_seen = k_uptime_get_32();
 
-			/* Save address to ensure it persists across reboots */
-			save_bonded_device_addr(i, addr);
+			/* Bonds found only through bt_foreach_bond are not in the record yet */
+			if (changed || !atomic_test_bit(&bond_stored, i)) {
+				relay_store_request();
+			}
 
 			char addr_str[BT_ADDR_LE_STR_LEN];
 			bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
@@ -1400,10 +1869,7 @@ int ble_central_add_bonded_device(const bt_addr_le_t *addr, const char *name)
 				bonded_device_count, MAX_BONDED_DEVICES, addr_str, name ? name : "no name");
 
 			/* Save to persistent settings */
-			save_bonded_device_addr(i, addr);
-			if (name) {
-				save_bonded_device_name(i, name);
-			}
+			relay_store_request();
 
 			ret = 0;
 			goto unlock;
@@ -1431,8 +1897,8 @@ int ble_central_add_bonded_device(const bt_addr_le_t *addr, const char *name)
 			bonded_devices[oldest_idx].name[0] ? bonded_devices[oldest_idx].name : "no name");
 
 		/* Clear DIS info for the device being removed */
-		extern void ble_dis_clear_saved_for_addr(const bt_addr_le_t *addr);
 		ble_dis_clear_saved_for_addr(&bonded_devices[oldest_idx].addr);
+		ble_discovery_clear_cache_for_addr(&bonded_devices[oldest_idx].addr);
 
 		/* Unbond from BT stack */
 		int err = bt_unpair(BT_ID_DEFAULT, &bonded_devices[oldest_idx].addr);
@@ -1440,12 +1906,7 @@ int ble_central_add_bonded_device(const bt_addr_le_t *addr, const char *name)
 			LOG_ERR("Failed to unpair device (err %d)", err);
 		}
 
-		/* Clear settings for this slot */
-		char key[64];
-		snprintf(key, sizeof(key), "ble_central/bond_%d/name", oldest_idx);
-		settings_delete(key);
-		snprintf(key, sizeof(key), "ble_central/bond_%d/addr", oldest_idx);
-		settings_delete(key);
+		atomic_clear_bit(&bond_stored, oldest_idx);
 
 		/* Replace with new device */
 		bt_addr_le_copy(&bonded_devices[oldest_idx].addr, addr);
@@ -1465,16 +1926,14 @@ int ble_central_add_bonded_device(const bt_addr_le_t *addr, const char *name)
 			oldest_idx, new_addr_str, name ? name : "no name");
 
 		/* Save to persistent settings */
-		save_bonded_device_addr(oldest_idx, addr);
-		if (name) {
-			save_bonded_device_name(oldest_idx, name);
-		}
+		relay_store_request();
 
 		ret = 0;
 	}
 
 unlock:
 	k_mutex_unlock(&bonded_devices_mutex);
+	relay_device_info_invalidate();
 	return ret;
 }
 
@@ -1492,17 +1951,10 @@ int ble_central_remove_bonded_device(const bt_addr_le_t *addr)
 			LOG_INF("Removing bonded device: %s (%s)", addr_str, bonded_devices[i].name);
 
 			/* Clear DIS info for the device being removed */
-			extern void ble_dis_clear_saved_for_addr(const bt_addr_le_t *addr);
 			ble_dis_clear_saved_for_addr(addr);
+			ble_discovery_clear_cache_for_addr(addr);
 
-			/* Clear settings for this slot */
-			if (IS_ENABLED(CONFIG_SETTINGS)) {
-				char key[64];
-				snprintf(key, sizeof(key), "ble_central/bond_%d/name", i);
-				settings_delete(key);
-				snprintf(key, sizeof(key), "ble_central/bond_%d/addr", i);
-				settings_delete(key);
-			}
+			atomic_clear_bit(&bond_stored, i);
 
 			/* Clear in-memory data */
 			bonded_devices[i].is_valid = false;
@@ -1510,6 +1962,7 @@ int ble_central_remove_bonded_device(const bt_addr_le_t *addr)
 			bonded_devices[i].name[0] = '\0';
 			bonded_devices[i].last_seen = 0;
 			bonded_device_count--;
+			relay_store_request();
 
 			ret = 0;
 			break;
@@ -1517,6 +1970,7 @@ int ble_central_remove_bonded_device(const bt_addr_le_t *addr)
 	}
 
 	k_mutex_unlock(&bonded_devices_mutex);
+	relay_device_info_invalidate();
 
 	return ret;
 }
@@ -1566,27 +2020,21 @@ void ble_central_clear_bonded_device(void)
 	/* Clear all bonds */
 	memset(bonded_devices, 0, sizeof(bonded_devices));
 	bonded_device_count = 0;
+	atomic_clear(&bond_stored);
 
 	k_mutex_unlock(&bonded_devices_mutex);
+	relay_device_info_invalidate();
 
 	/* Reset scan mode to NORMAL (in case it was in ADDITIONAL mode) */
 	scan_mode = SCAN_MODE_NORMAL;
 
-	/* Delete saved device names from persistent settings */
-	if (IS_ENABLED(CONFIG_SETTINGS)) {
-		for (int i = 0; i < MAX_BONDED_DEVICES; i++) {
-			char key[64];
-			snprintf(key, sizeof(key), "ble_central/bond_%d/name", i);
-			settings_delete(key);
+	/* The accept list still holds the cleared bonds; the failure callback rescans */
+	stop_auto_connect();
 
-			snprintf(key, sizeof(key), "ble_central/bond_%d/addr", i);
-			settings_delete(key);
+	ble_discovery_clear_cache();
 
-			/* Yield to prevent blocking too long during flash operations */
-			k_yield();
-		}
-		LOG_INF("Deleted all bonded device names from persistent storage");
-	}
+	/* The record is written without the slots and caches */
+	relay_store_request();
 
 	LOG_INF("All bonded device tracking cleared - will pair with any MouthPad");
 }
@@ -1628,35 +2076,11 @@ bool ble_central_get_bonded_device_addr(bt_addr_le_t *out_addr, char *out_name,
 	return false;
 }
 
-/* Query if actively scanning for devices */
-bool ble_central_is_scanning(void)
-{
-	bool result = connection_state == BLE_CENTRAL_STATE_SCANNING;
-	LOG_INF("is_scanning query: state=%d, returning %d", connection_state, result);
-	return result;
-}
-
-/* Query if connection attempt is in progress */
-bool ble_central_is_connecting(void)
-{
-	bool result = connection_state == BLE_CENTRAL_STATE_CONNECTING;
-	LOG_INF("is_connecting query: state=%d, returning %d", connection_state, result);
-	return result;
-}
-
-/* Query if connected to a device */
-bool ble_central_is_connected(void)
-{
-	bool result = connection_state == BLE_CENTRAL_STATE_CONNECTED;
-	LOG_INF("is_connected query: state=%d, returning %d", connection_state, result);
-	return result;
-}
-
 /* Mark that GATT services are ready - transitions from CONNECTING to CONNECTED */
 void ble_central_mark_services_ready(void)
 {
 	if (connection_state == BLE_CENTRAL_STATE_CONNECTING) {
-		connection_state = BLE_CENTRAL_STATE_CONNECTED;
+		set_connection_state(BLE_CENTRAL_STATE_CONNECTED);
 		LOG_INF("*** STATE SET TO CONNECTED (services ready) ***");
 	} else {
 		LOG_WRN("mark_services_ready called but state is not CONNECTING (state=%d)", connection_state);
@@ -19,6 +19,11 @@ int ble_central_start_scan(void);
 int ble_central_stop_scan(void);
 int ble_central_start_additional_scan(void);  /* Scan for NEW device (ignore already bonded) */
 
+/* The user wants the MouthPad now: scan at full rate again (scan_schedule.h).
+ * Safe from any thread; the next scan picks it up if none is running.
+ */
+void ble_central_scan_boost(void);
+
 /* Connection management */
 struct bt_conn *ble_central_get_default_conn(void);
 void ble_central_set_default_conn(struct bt_conn *conn);
@@ -30,6 +35,30 @@ typedef void (*ble_central_disconnected_cb_t)(struct bt_conn *conn, uint8_t reas
 void ble_central_register_connected_cb(ble_central_connected_cb_t cb);
 void ble_central_register_disconnected_cb(ble_central_disconnected_cb_t cb);
 
+/* Secondary MouthPad links (CONFIG_BLE_MULTI_MOUTHPAD). connected is also
+ * called with a non-zero err when an attempt ends without a connection;
+ * disconnected is called for every link other than the primary one.
+ */
+typedef void (*ble_central_secondary_connected_cb_t)(struct bt_conn *conn, uint8_t err);
+
+void ble_central_register_secondary_cbs(ble_central_secondary_connected_cb_t connected,
+					ble_central_disconnected_cb_t disconnected);
+
+/* Auto-connect to a bonded MouthPad that is not connected yet, with a lower
+ * scan duty cycle than the primary reconnect. Returns -ENOTCONN unless the
+ * primary MouthPad is ready, -EALREADY while an auto-connect is pending and
+ * -ENOENT when every bonded MouthPad is connected.
+ */
+int ble_central_connect_secondary(void);
+
+/* Called when the primary MouthPad disconnects (CONFIG_BLE_HOT_STANDBY).
+ * Returns a connected, encrypted secondary link to promote to primary,
+ * passing its reference on, or NULL to scan as usual.
+ */
+typedef struct bt_conn *(*ble_central_standby_cb_t)(void);
+
+void ble_central_register_standby_cb(ble_central_standby_cb_t cb);
+
 /* Get scan work for external scheduling */
 struct k_work *ble_central_get_scan_work(void);
 
@@ -61,14 +90,13 @@ void ble_central_clear_bonded_device(void);  /* Clears ALL bonds */
 /* Get bonded device address and name (returns first bonded device for backwards compatibility) */
 bool ble_central_get_bonded_device_addr(bt_addr_le_t *out_addr, char *out_name, size_t name_size);
 
-/* Scanning state query */
-bool ble_central_is_scanning(void);
-
-/* Connecting state query */
-bool ble_central_is_connecting(void);
+/* Bond slots and names as their relay_store.h section; save returns bytes used */
+size_t ble_central_store_save(uint8_t *buf, size_t size);
+void ble_central_store_load(const uint8_t *buf, size_t len);
 
-/* Connected state query */
-bool ble_central_is_connected(void);
+/* The scanning, connecting and connected phases are read from the
+ * link-state snapshot (link_state.h)
+ */
 
 /* Mark that GATT services are ready - transitions from CONNECTING to CONNECTED */
 void ble_central_mark_services_ready(void);
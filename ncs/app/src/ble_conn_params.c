@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Adaptive BLE connection parameters driven by the activity level
+ *
+ * While the relay is active the link runs at the minimum connection
+ * interval with no peripheral latency, so each report reaches USB at the
+ * next connection event. Once the shared tracker (relay_activity.h) goes
+ * idle the interval and peripheral latency are relaxed so the MouthPad can
+ * sleep through most connection events, and deep idle raises the latency
+ * further. The first report after that snaps the link back to the active
+ * parameters; it is still delivered at the next (relaxed) connection event,
+ * only the reports after it wait for the update instant.
+ *
+ * While the USB host has suspended the bus nothing is forwarded, and the
+ * link drops to the suspend parameters until the host resumes; activity
+ * does not bring it back early.
+ *
+ * The active parameters come in two link profiles. The HID profile keeps
+ * the controller's defaults from prj.conf: short connection events that
+ * are not extended, one report each way per event. A NUS backlog (a bulk
+ * stream, or pass-through writes piling up) switches to the bulk profile:
+ * CONFIG_BLE_LINK_PROFILE_BULK_INTERVAL, events as long as the interval and
+ * extended while either side has data, and the largest data length, so
+ * each event carries as many full packets as fit. The SoftDevice
+ * Controller takes a new event length when a connection is created or
+ * updated, so it is set before the interval change that goes with it.
+ * The link returns to the HID profile CONFIG_BLE_LINK_PROFILE_HOLD_MS after
+ * the last backlog.
+ *
+ * The active interval and the idle interval and latency come from the
+ * tuning profile (relay_tuning.h); the table below holds the build-time
+ * values. Deep idle raises the profile's idle latency to
+ * CONFIG_BLE_CONN_PARAMS_DEEP_IDLE_LATENCY, unless the profile asks for no
+ * latency at all, and never past what the supervision timeout allows.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+
+#if defined(CONFIG_BT_LL_SOFTDEVICE)
+#include <sdc_hci_vs.h>
+#endif
+
+#include "ble_conn_params.h"
+#include "ble_central.h"
+#include "relay_activity.h"
+#include "relay_bus.h"
+#include "relay_workq.h"
+#include "tuning_profile.h"
+
+LOG_MODULE_REGISTER(ble_conn_params, LOG_LEVEL_INF);
+
+/* Supervision timeout must exceed (1 + latency) * interval * 2 */
+BUILD_ASSERT(BLE_CONN_PARAMS_TIMEOUT * 10 * 4 >
+		     (1 + CONFIG_BLE_CONN_PARAMS_IDLE_LATENCY) *
+			     CONFIG_BLE_CONN_PARAMS_IDLE_INTERVAL * 5 * 2,
+	     "Idle connection parameters exceed the supervision timeout");
+BUILD_ASSERT(BLE_CONN_PARAMS_TIMEOUT * 10 * 4 >
+		     (1 + CONFIG_BLE_CONN_PARAMS_DEEP_IDLE_LATENCY) *
+			     CONFIG_BLE_CONN_PARAMS_IDLE_INTERVAL * 5 * 2,
+	     "Deep idle connection parameters exceed the supervision timeout");
+BUILD_ASSERT(BLE_CONN_PARAMS_TIMEOUT * 10 * 4 >
+		     (1 + CONFIG_BLE_CONN_PARAMS_SUSPEND_LATENCY) *
+			     CONFIG_BLE_CONN_PARAMS_SUSPEND_INTERVAL * 5 * 2,
+	     "Suspend connection parameters exceed the supervision timeout");
+BUILD_ASSERT(BLE_CONN_PARAMS_TIMEOUT * 10 * 4 > CONFIG_BLE_LINK_PROFILE_BULK_INTERVAL * 5 * 2,
+	     "Bulk connection parameters exceed the supervision timeout");
+
+enum conn_params_state {
+	CONN_PARAMS_OFF,
+	CONN_PARAMS_ACTIVE,
+	CONN_PARAMS_BULK,
+	CONN_PARAMS_RELAXED,
+	CONN_PARAMS_DEEP,
+	CONN_PARAMS_SUSPENDED,
+};
+
+static const struct {
+	const char *name;
+	uint16_t interval;
+	uint16_t latency;
+} state_params[] = {
+	[CONN_PARAMS_ACTIVE] = { "active", BLE_CONN_PARAMS_ACTIVE_INTERVAL,
+				 BLE_CONN_PARAMS_ACTIVE_LATENCY },
+	[CONN_PARAMS_BULK] = { "bulk", CONFIG_BLE_LINK_PROFILE_BULK_INTERVAL,
+			       BLE_CONN_PARAMS_ACTIVE_LATENCY },
+	[CONN_PARAMS_RELAXED] = { "idle", CONFIG_BLE_CONN_PARAMS_IDLE_INTERVAL,
+				  CONFIG_BLE_CONN_PARAMS_IDLE_LATENCY },
+	[CONN_PARAMS_DEEP] = { "deep idle", CONFIG_BLE_CONN_PARAMS_IDLE_INTERVAL,
+			       CONFIG_BLE_CONN_PARAMS_DEEP_IDLE_LATENCY },
+	[CONN_PARAMS_SUSPENDED] = { "USB suspended", CONFIG_BLE_CONN_PARAMS_SUSPEND_INTERVAL,
+				    CONFIG_BLE_CONN_PARAMS_SUSPEND_LATENCY },
+};
+
+static atomic_t connected;
+static atomic_t usb_suspended;
+static atomic_t at_risk; /* Short supervision timeout wanted */
+static atomic_t backlog; /* Bulk profile wanted */
+static atomic_t backlog_ms; /* Uptime of the last backlog reported */
+
+#define KNOB(name) mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_##name
+
+/* Protocol work queue only */
+static enum conn_params_state applied = CONN_PARAMS_OFF;
+static uint16_t applied_interval;
+static uint16_t applied_latency;
+static uint16_t applied_timeout = BLE_CONN_PARAMS_TIMEOUT;
+static bool bulk_events; /* Controller set for the bulk profile */
+
+static void update_work_handler(struct k_work *work);
+static K_WORK_DEFINE(update_work, update_work_handler);
+
+static void hold_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(hold_work, hold_work_handler);
+
+static void request_params(uint16_t interval_min, uint16_t interval_max, uint16_t latency,
+			   uint16_t timeout)
+{
+	struct bt_conn *conn = ble_central_get_default_conn();
+	struct bt_le_conn_param param = {
+		.interval_min = interval_min,
+		.interval_max = interval_max,
+		.latency = latency,
+		.timeout = timeout,
+	};
+
+	if (!conn) {
+		return;
+	}
+
+	int err = bt_conn_le_param_update(conn, &param);
+
+	if (err && err != -EALREADY) {
+		LOG_WRN("Failed to request connection parameters (err %d)", err);
+	}
+}
+
+#if defined(CONFIG_BT_LL_SOFTDEVICE)
+/* Blocks this queue only, for one HCI round-trip */
+static int vendor_cmd(uint16_t opcode, const void *params, size_t len)
+{
+	struct net_buf *buf = bt_hci_cmd_alloc(K_MSEC(100));
+
+	if (!buf) {
+		return -ENOBUFS;
+	}
+	net_buf_add_mem(buf, params, len);
+	return bt_hci_cmd_send_sync(opcode, buf, NULL);
+}
+#endif
+
+/* Connection event length and extension for the HID or bulk profile. These
+ * are controller-wide, so the secondary links created meanwhile get them too.
+ */
+static void set_event_profile(bool bulk)
+{
+#if defined(CONFIG_BT_LL_SOFTDEVICE)
+	sdc_hci_cmd_vs_event_length_set_t length = {
+		.event_length_us = bulk ? CONFIG_BLE_LINK_PROFILE_BULK_INTERVAL * 1250
+					: CONFIG_BT_CTLR_SDC_MAX_CONN_EVENT_LEN_DEFAULT,
+	};
+	sdc_hci_cmd_vs_conn_event_extend_t extend = {
+		.enable = bulk || IS_ENABLED(CONFIG_BT_CTLR_SDC_CONN_EVENT_EXTEND_DEFAULT),
+	};
+	int err = vendor_cmd(SDC_HCI_OPCODE_CMD_VS_EVENT_LENGTH_SET, &length, sizeof(length));
+
+	if (!err) {
+		err = vendor_cmd(SDC_HCI_OPCODE_CMD_VS_CONN_EVENT_EXTEND, &extend, sizeof(extend));
+	}
+	if (err) {
+		LOG_WRN("Failed to set %s connection events (err %d)", bulk ? "bulk" : "HID", err);
+	}
+#else
+	ARG_UNUSED(bulk);
+#endif
+	bulk_events = bulk;
+}
+
+static void request_data_len(void)
+{
+	struct bt_conn *conn = ble_central_get_default_conn();
+
+	if (!conn) {
+		return;
+	}
+
+	int err = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+
+	if (err && err != -EALREADY) {
+		LOG_WRN("Failed to request data length (err %d)", err);
+	}
+}
+
+static enum conn_params_state wanted_state(enum relay_activity_level level)
+{
+	if (!atomic_get(&connected)) {
+		return CONN_PARAMS_OFF;
+	}
+	if (atomic_get(&usb_suspended)) {
+		return CONN_PARAMS_SUSPENDED;
+	}
+	/* A backlog is traffic, whatever the activity level says yet */
+	if (atomic_get(&backlog)) {
+		return CONN_PARAMS_BULK;
+	}
+
+	switch (level) {
+	case RELAY_ACTIVITY_ACTIVE:
+		return CONN_PARAMS_ACTIVE;
+	case RELAY_ACTIVITY_IDLE:
+		return CONN_PARAMS_RELAXED;
+	default:
+		return CONN_PARAMS_DEEP;
+	}
+}
+
+/* Interval and latency of a state, with the tuning profile applied */
+static void wanted_link(enum conn_params_state state, uint16_t *interval, uint16_t *latency)
+{
+	uint32_t idle_latency;
+
+	*interval = state_params[state].interval;
+	*latency = state_params[state].latency;
+
+	switch (state) {
+	case CONN_PARAMS_ACTIVE:
+		*interval = tuning_profile_get(KNOB(ACTIVE_INTERVAL));
+		break;
+	case CONN_PARAMS_RELAXED:
+		*interval = tuning_profile_get(KNOB(IDLE_INTERVAL));
+		*latency = tuning_profile_get(KNOB(IDLE_LATENCY));
+		break;
+	case CONN_PARAMS_DEEP:
+		*interval = tuning_profile_get(KNOB(IDLE_INTERVAL));
+		idle_latency = tuning_profile_get(KNOB(IDLE_LATENCY));
+		if (!idle_latency) {
+			*latency = 0;
+			break;
+		}
+		/* (1 + latency) * interval * 1.25 ms within the idle sleep allowed */
+		*latency = MIN(MAX(idle_latency, CONFIG_BLE_CONN_PARAMS_DEEP_IDLE_LATENCY),
+			       BLE_CONN_PARAMS_MAX_SLEEP_MS * 4U / 5U / *interval - 1U);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Supervision timeout in 10 ms units for a link: the guard's while at
+ * risk, but always more than (1 + latency) * interval * 2
+ */
+static uint16_t wanted_timeout(enum conn_params_state state, uint16_t interval,
+			       uint16_t latency)
+{
+#if defined(CONFIG_BLE_LINK_GUARD)
+	uint32_t least;
+
+	if (!atomic_get(&at_risk) || state == CONN_PARAMS_OFF) {
+		return BLE_CONN_PARAMS_TIMEOUT;
+	}
+
+	least = (1U + latency) * interval * 125U * 2U / 1000U + 1U;
+	return CLAMP(MAX(CONFIG_BLE_LINK_GUARD_TIMEOUT_MS / 10U, least), 10U,
+		     BLE_CONN_PARAMS_TIMEOUT);
+#else
+	ARG_UNUSED(state);
+	ARG_UNUSED(interval);
+	ARG_UNUSED(latency);
+	return BLE_CONN_PARAMS_TIMEOUT;
+#endif
+}
+
+/* Protocol work queue: request the parameters for the current inputs */
+static void conn_params_apply(enum relay_activity_level level)
+{
+	enum conn_params_state want = wanted_state(level);
+	uint16_t interval;
+	uint16_t latency;
+	uint16_t timeout;
+
+	wanted_link(want, &interval, &latency);
+	timeout = wanted_timeout(want, interval, latency);
+	if (want == applied && interval == applied_interval && latency == applied_latency &&
+	    timeout == applied_timeout) {
+		return;
+	}
+
+	applied = want;
+	applied_interval = interval;
+	applied_latency = latency;
+	applied_timeout = timeout;
+	if ((want == CONN_PARAMS_BULK) != bulk_events) {
+		set_event_profile(want == CONN_PARAMS_BULK);
+	}
+	if (want == CONN_PARAMS_OFF) {
+		return;
+	}
+	if (want == CONN_PARAMS_BULK) {
+		request_data_len();
+	}
+
+	LOG_INF("%s: requesting %u x 1.25ms interval, latency %u, timeout %u ms",
+		state_params[want].name, interval, latency, timeout * 10);
+	request_params(interval, interval, latency, timeout);
+}
+
+static void update_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	conn_params_apply(relay_activity_level());
+}
+
+static void hold_work_handler(struct k_work *work)
+{
+	uint32_t quiet = k_uptime_get_32() - (uint32_t)atomic_get(&backlog_ms);
+
+	if (quiet < CONFIG_BLE_LINK_PROFILE_HOLD_MS) {
+		k_work_reschedule_for_queue(&relay_workq_protocol, k_work_delayable_from_work(work),
+					    K_MSEC(CONFIG_BLE_LINK_PROFILE_HOLD_MS - quiet));
+		return;
+	}
+
+	atomic_clear(&backlog);
+	conn_params_apply(relay_activity_level());
+}
+
+/* Already on the protocol work queue */
+static void activity_changed(const struct zbus_channel *chan)
+{
+	const struct relay_activity_msg *msg = zbus_chan_const_msg(chan);
+
+	conn_params_apply(msg->level);
+}
+
+ZBUS_LISTENER_DEFINE(conn_params_activity, activity_changed);
+ZBUS_CHAN_ADD_OBS(relay_chan_activity, conn_params_activity, RELAY_BUS_PRIO_CONTROL);
+
+void ble_conn_params_connected(struct bt_conn *conn)
+{
+	ARG_UNUSED(conn);
+
+	/* A new link starts from the active parameters it was created with */
+	relay_activity_mark();
+	atomic_set(&connected, 1);
+	k_work_submit_to_queue(&relay_workq_protocol, &update_work);
+}
+
+void ble_conn_params_disconnected(void)
+{
+	atomic_set(&connected, 0);
+	k_work_submit_to_queue(&relay_workq_protocol, &update_work);
+}
+
+void ble_conn_params_backlog(void)
+{
+	atomic_set(&backlog_ms, (atomic_val_t)k_uptime_get_32());
+	if (!atomic_set(&backlog, 1)) {
+		k_work_submit_to_queue(&relay_workq_protocol, &update_work);
+		k_work_reschedule_for_queue(&relay_workq_protocol, &hold_work,
+					    K_MSEC(CONFIG_BLE_LINK_PROFILE_HOLD_MS));
+	}
+}
+
+void ble_conn_params_at_risk(bool risk)
+{
+	if (atomic_set(&at_risk, risk) != risk) {
+		k_work_submit_to_queue(&relay_workq_protocol, &update_work);
+	}
+}
+
+void ble_conn_params_retune(void)
+{
+	k_work_submit_to_queue(&relay_workq_protocol, &update_work);
+}
+
+void ble_conn_params_usb_suspended(bool suspended)
+{
+	if (atomic_set(&usb_suspended, suspended) != suspended) {
+		k_work_submit_to_queue(&relay_workq_protocol, &update_work);
+	}
+}
+
+static void le_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+			     uint16_t timeout)
+{
+	if (conn != ble_central_get_default_conn()) {
+		return;
+	}
+
+	LOG_INF("Connection parameters updated: interval %u x 1.25ms, latency %u, timeout %u ms",
+		interval, latency, timeout * 10);
+}
+
+BT_CONN_CB_DEFINE(conn_params_callbacks) = {
+	.le_param_updated = le_param_updated,
+};
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BLE_CONN_PARAMS_H_
+#define BLE_CONN_PARAMS_H_
+
+#include <zephyr/bluetooth/conn.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Active: minimum interval (7.5ms), no peripheral latency, 4s supervision timeout */
+#define BLE_CONN_PARAMS_ACTIVE_INTERVAL 6
+#define BLE_CONN_PARAMS_ACTIVE_LATENCY  0
+#define BLE_CONN_PARAMS_TIMEOUT         400
+
+/* Longest (1 + latency) * interval, in ms, the timeout allows */
+#define BLE_CONN_PARAMS_MAX_SLEEP_MS (BLE_CONN_PARAMS_TIMEOUT * 10 / 2 - 1)
+
+/* Connection parameters to create the connection with */
+#define BLE_CONN_PARAMS_ACTIVE                                                           \
+	BT_LE_CONN_PARAM(BLE_CONN_PARAMS_ACTIVE_INTERVAL, BLE_CONN_PARAMS_ACTIVE_INTERVAL, \
+			 BLE_CONN_PARAMS_ACTIVE_LATENCY, BLE_CONN_PARAMS_TIMEOUT)
+
+/**
+ * @brief Start managing connection parameters for a new connection
+ *
+ * Marks the relay active, so the link keeps the active parameters until
+ * the activity tracker reports idle.
+ *
+ * @param conn Newly established connection
+ */
+void ble_conn_params_connected(struct bt_conn *conn);
+
+/**
+ * @brief Stop managing connection parameters
+ *
+ * Call on disconnect.
+ */
+void ble_conn_params_disconnected(void);
+
+/**
+ * @brief Report a NUS backlog
+ *
+ * Switches the link to the bulk profile until no backlog has been reported
+ * for CONFIG_BLE_LINK_PROFILE_HOLD_MS. May be called from any context.
+ */
+void ble_conn_params_backlog(void);
+
+/**
+ * @brief Follow the link guard (link_guard.h)
+ *
+ * While the link is at risk the supervision timeout is cut to
+ * CONFIG_BLE_LINK_GUARD_TIMEOUT_MS, or the least the current interval and
+ * latency allow, so a link that drops is given up and reconnected sooner.
+ * May be called from any context.
+ *
+ * @param at_risk true while the guard expects the link to drop
+ */
+void ble_conn_params_at_risk(bool at_risk);
+
+/**
+ * @brief Request the parameters again after the tuning profile changed
+ *
+ * May be called from any context.
+ */
+void ble_conn_params_retune(void);
+
+/**
+ * @brief Follow the USB host suspend state
+ *
+ * While suspended the link uses the long suspend interval and peripheral
+ * latency; on resume the parameters for the current activity level are
+ * requested again. Remembered across reconnects.
+ *
+ * @param suspended true when the host suspended the bus
+ */
+void ble_conn_params_usb_suspended(bool suspended);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_CONN_PARAMS_H_ */
@@ -11,12 +11,15 @@
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/util.h>
 #include <bluetooth/gatt_dm.h>
 #include <string.h>
 
 #include "ble_dis.h"
 #include "ble_central.h"
+#include "relay_device_info.h"
+#include "relay_store.h"
 
 #define LOG_MODULE_NAME ble_dis
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -62,7 +65,10 @@ static ble_dis_info_t device_info; /* Active device's DIS info */
 static bool dis_ready = false;
 static struct bt_conn *current_conn = NULL;
 
-/* In-memory cache for all bonded devices' DIS info (loaded from flash at boot) */
+#if defined(CONFIG_BLE_DIS_CACHE)
+/* In-memory cache for all bonded devices' DIS info (loaded from flash at boot,
+ * saved as a relay_store.h section)
+ */
 #define MAX_DIS_CACHE_ENTRIES 4
 struct dis_cache_entry {
 	bt_addr_le_t addr;
@@ -73,64 +79,7 @@ static struct dis_cache_entry dis_cache[MAX_DIS_CACHE_ENTRIES];
 
 /* Mutex to protect dis_cache from concurrent access */
 static K_MUTEX_DEFINE(dis_cache_mutex);
-
-/* Forward declarations needed by work handler */
-static void build_dis_settings_key(const bt_addr_le_t *addr, char *key, size_t key_len);
-
-int ble_dis_load_info_for_addr(const bt_addr_le_t *addr, ble_dis_info_t *out_info);
-
-/* Work queue item for deferred flash writes */
-static struct k_work clear_fw_cache_work;
-static bool clear_fw_cache_pending = false;
-
-static void clear_fw_cache_work_handler(struct k_work *work) {
-	ARG_UNUSED(work);
-
-	LOG_INF("Clearing cached firmware version for all bonded devices (deferred)");
-
-	/* Get list of bonded devices from ble_central */
-	extern int ble_central_get_bonded_devices(struct bonded_device *out_list, size_t max_count);
-
-	struct bonded_device bonds[4];
-	int count = ble_central_get_bonded_devices(bonds, 4);
-
-	if (count <= 0) {
-		LOG_DBG("No bonded devices to clear firmware from");
-		clear_fw_cache_pending = false;
-		return;
-	}
-
-	/* Clear firmware version for each bonded device */
-	for (int i = 0; i < count; i++) {
-		if (bonds[i].is_valid) {
-			/* Load existing DIS info */
-			ble_dis_info_t dis_info;
-			int err = ble_dis_load_info_for_addr(&bonds[i].addr, &dis_info);
-			if (err != 0) {
-				continue;
-			}
-
-			/* Clear only the firmware version field */
-			dis_info.has_firmware_version = false;
-			dis_info.firmware_version[0] = '\0';
-
-			/* Save back to flash storage */
-			char key[64];
-			build_dis_settings_key(&bonds[i].addr, key, sizeof(key));
-			err = settings_save_one(key, &dis_info, sizeof(ble_dis_info_t));
-			if (err) {
-				LOG_ERR("Failed to save DIS info after clearing firmware (err %d)", err);
-			} else {
-				char addr_str[BT_ADDR_LE_STR_LEN];
-				bt_addr_le_to_str(&bonds[i].addr, addr_str, sizeof(addr_str));
-				LOG_INF("Cleared cached firmware in flash for: %s", addr_str);
-			}
-		}
-	}
-
-	clear_fw_cache_pending = false;
-	LOG_INF("Cleared cached firmware for %d device(s) in flash", count);
-}
+#endif /* CONFIG_BLE_DIS_CACHE */
 
 /* Expected device identity strings */
 #define DIS_EXPECTED_MANUFACTURER_NAME "Augmental"
@@ -166,17 +115,128 @@ static struct bt_gatt_dm_cb dis_discovery_cb = {
 		.error_found = dis_discovery_error_found_cb,
 };
 
-/* Settings storage for persistent DIS info across power cycles */
-/* Build settings key for a specific device address */
-static void build_dis_settings_key(const bt_addr_le_t *addr, char *key_buf, size_t buf_size) {
-	/* Create clean hex string from address bytes + type for settings key */
-	/* Format: "ble_dis/<6 hex bytes><type>/info" e.g., "ble_dis/F01A5F522A3E_1/info" */
-	snprintf(key_buf, buf_size, "ble_dis/%02X%02X%02X%02X%02X%02X_%d/info",
-			 addr->a.val[5], addr->a.val[4], addr->a.val[3],
-			 addr->a.val[2], addr->a.val[1], addr->a.val[0],
-			 addr->type);
+#if defined(CONFIG_BLE_DIS_CACHE)
+/* Strings of a section entry, in this order, each saved as length then bytes */
+#define DIS_STRINGS 5
+
+static char *dis_string(ble_dis_info_t *info, int n, size_t *size) {
+	switch (n) {
+	case 0:
+		*size = sizeof(info->firmware_version);
+		return info->firmware_version;
+	case 1:
+		*size = sizeof(info->device_name);
+		return info->device_name;
+	case 2:
+		*size = sizeof(info->hardware_revision);
+		return info->hardware_revision;
+	case 3:
+		*size = sizeof(info->manufacturer_name);
+		return info->manufacturer_name;
+	default:
+		*size = sizeof(info->model_number);
+		return info->model_number;
+	}
+}
+
+/* Section entry: address, has_* flags, vendor and product ID, strings */
+#define DIS_ENTRY_FIXED (sizeof(bt_addr_le_t) + 1 + 4)
+
+size_t ble_dis_store_save(uint8_t *buf, size_t size) {
+	size_t len = 0;
+
+	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
+		ble_dis_info_t *info = &dis_cache[i].info;
+		size_t need = DIS_ENTRY_FIXED;
+
+		if (!dis_cache[i].valid) {
+			continue;
+		}
+		for (int n = 0; n < DIS_STRINGS; n++) {
+			size_t str_size;
+
+			need += 1 + strnlen(dis_string(info, n, &str_size), str_size - 1);
+		}
+		if (size - len < need) {
+			LOG_WRN("DIS cache entry %d does not fit the record", i);
+			break;
+		}
+
+		memcpy(&buf[len], &dis_cache[i].addr, sizeof(bt_addr_le_t));
+		len += sizeof(bt_addr_le_t);
+		buf[len++] = (info->has_firmware_version << 0) | (info->has_device_name << 1) |
+			     (info->has_hardware_revision << 2) | (info->has_manufacturer_name << 3) |
+			     (info->has_model_number << 4) | (info->has_pnp_id << 5);
+		sys_put_le16(info->vendor_id, &buf[len]);
+		sys_put_le16(info->product_id, &buf[len + 2]);
+		len += 4;
+		for (int n = 0; n < DIS_STRINGS; n++) {
+			size_t str_size;
+			const char *str = dis_string(info, n, &str_size);
+			size_t str_len = strnlen(str, str_size - 1);
+
+			buf[len++] = (uint8_t)str_len;
+			memcpy(&buf[len], str, str_len);
+			len += str_len;
+		}
+	}
+	k_mutex_unlock(&dis_cache_mutex);
+
+	return len;
 }
 
+void ble_dis_store_load(const uint8_t *buf, size_t len) {
+	size_t pos = 0;
+	int slot = 0;
+
+	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
+	while (slot < MAX_DIS_CACHE_ENTRIES && len - pos >= DIS_ENTRY_FIXED) {
+		struct dis_cache_entry entry = {.valid = true};
+		ble_dis_info_t *info = &entry.info;
+		uint8_t flags;
+		bool ok = true;
+
+		memcpy(&entry.addr, &buf[pos], sizeof(bt_addr_le_t));
+		pos += sizeof(bt_addr_le_t);
+		flags = buf[pos++];
+		info->has_firmware_version = flags & BIT(0);
+		info->has_device_name = flags & BIT(1);
+		info->has_hardware_revision = flags & BIT(2);
+		info->has_manufacturer_name = flags & BIT(3);
+		info->has_model_number = flags & BIT(4);
+		info->has_pnp_id = flags & BIT(5);
+		info->vendor_id = sys_get_le16(&buf[pos]);
+		info->product_id = sys_get_le16(&buf[pos + 2]);
+		pos += 4;
+
+		for (int n = 0; n < DIS_STRINGS && ok; n++) {
+			size_t str_size;
+			char *str = dis_string(info, n, &str_size);
+			size_t str_len = pos < len ? buf[pos] : str_size;
+
+			ok = str_len < str_size && len - pos - 1 >= str_len;
+			if (ok) {
+				memcpy(str, &buf[pos + 1], str_len);
+				str[str_len] = '\0';
+				pos += 1 + str_len;
+			}
+		}
+		if (!ok) {
+			LOG_WRN("DIS section malformed at entry %d", slot);
+			break;
+		}
+
+		dis_cache[slot++] = entry;
+	}
+	k_mutex_unlock(&dis_cache_mutex);
+
+	LOG_INF("Loaded %d DIS cache entries", slot);
+}
+
+/* Put device_info in the in-memory cache; the flash write follows later
+ * and only if it differs from what the cache already held
+ */
 static int save_dis_info_to_settings(const bt_addr_le_t *addr) {
 	if (!IS_ENABLED(CONFIG_SETTINGS)) {
 		return 0;
@@ -187,49 +247,70 @@ static int save_dis_info_to_settings(const bt_addr_le_t *addr) {
 		return -EINVAL;
 	}
 
-	char key[64];
-	build_dis_settings_key(addr, key, sizeof(key));
-
-	LOG_INF("Saving DIS info for device: has_fw=%d, fw='%s', has_name=%d, name='%s', has_pnp=%d, vid=0x%04X, pid=0x%04X",
-			device_info.has_firmware_version, device_info.firmware_version,
-			device_info.has_device_name, device_info.device_name,
-			device_info.has_pnp_id, device_info.vendor_id, device_info.product_id);
-
-	int err = settings_save_one(key, &device_info, sizeof(ble_dis_info_t));
-	if (err) {
-		LOG_ERR("Failed to save DIS info to settings (err %d)", err);
-		return err;
-	}
-
-	LOG_INF("Saved DIS info to persistent storage: %s", key);
-
-	/* Also update in-memory cache (protected by mutex) */
 	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
-	bool found = false;
+	struct dis_cache_entry *entry = NULL;
 	for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
 		if (dis_cache[i].valid && bt_addr_le_cmp(&dis_cache[i].addr, addr) == 0) {
-			/* Update existing entry */
-			memcpy(&dis_cache[i].info, &device_info, sizeof(ble_dis_info_t));
-			LOG_DBG("Updated in-memory cache entry %d", i);
-			found = true;
+			entry = &dis_cache[i];
 			break;
 		}
 	}
 
-	/* If not found, add new entry */
-	if (!found) {
+	if (entry && memcmp(&entry->info, &device_info, sizeof(ble_dis_info_t)) == 0) {
+		k_mutex_unlock(&dis_cache_mutex);
+		LOG_DBG("DIS info unchanged, not saving");
+		return 0;
+	}
+
+	if (!entry) {
 		for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
 			if (!dis_cache[i].valid) {
-				memcpy(&dis_cache[i].addr, addr, sizeof(bt_addr_le_t));
-				memcpy(&dis_cache[i].info, &device_info, sizeof(ble_dis_info_t));
-				dis_cache[i].valid = true;
+				entry = &dis_cache[i];
+				memcpy(&entry->addr, addr, sizeof(bt_addr_le_t));
+				entry->valid = true;
 				LOG_INF("Added new in-memory cache entry %d", i);
 				break;
 			}
 		}
 	}
+
+	if (entry) {
+		memcpy(&entry->info, &device_info, sizeof(ble_dis_info_t));
+	}
 	k_mutex_unlock(&dis_cache_mutex);
 
+	LOG_INF("DIS info changed: has_fw=%d, fw='%s', has_name=%d, name='%s', has_pnp=%d, vid=0x%04X, pid=0x%04X",
+			device_info.has_firmware_version, device_info.firmware_version,
+			device_info.has_device_name, device_info.device_name,
+			device_info.has_pnp_id, device_info.vendor_id, device_info.product_id);
+
+	relay_device_info_invalidate();
+
+	if (!entry) {
+		/* One entry per bond, so only a bond the table lost gets here */
+		LOG_WRN("DIS cache full, info not saved");
+		return -ENOMEM;
+	}
+
+	relay_store_request();
+	return 0;
+}
+
+/* Older firmware's keys, "ble_dis/<6 hex bytes>_<type>/info" e.g.
+ * "ble_dis/F01A5F522A3E_1/info"; address from the part after "ble_dis/"
+ */
+static int parse_dis_settings_name(const char *name, bt_addr_le_t *addr) {
+	uint8_t be[6];
+
+	if (strlen(name) < 14 || name[12] != '_' ||
+		hex2bin(name, 12, be, sizeof(be)) != sizeof(be)) {
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < 6; i++) {
+		addr->a.val[i] = be[5 - i];
+	}
+	addr->type = name[13] - '0';
 	return 0;
 }
 
@@ -242,11 +323,9 @@ static int settings_set_cb(const char *name, size_t len, settings_read_cb read_c
 		ble_dis_info_t temp_info;
 		ssize_t bytes_read = read_cb(cb_arg, &temp_info, sizeof(ble_dis_info_t));
 		if (bytes_read == sizeof(ble_dis_info_t)) {
-			/* Parse address from key format: "<addr>/info" */
+			/* Parse address from key format: "<addr>_<type>/info" */
 			bt_addr_le_t addr;
-			if (bt_addr_le_from_str(name, "RPA", &addr) == 0 ||
-				bt_addr_le_from_str(name, "random", &addr) == 0 ||
-				bt_addr_le_from_str(name, "public", &addr) == 0) {
+			if (parse_dis_settings_name(name, &addr) == 0) {
 				/* Find empty slot in cache (protected by mutex) */
 				k_mutex_lock(&dis_cache_mutex, K_FOREVER);
 				for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
@@ -267,7 +346,19 @@ static int settings_set_cb(const char *name, size_t len, settings_read_cb read_c
 	return -ENOENT;
 }
 
+/* Read once to move them into the record (relay_store.h) */
 SETTINGS_STATIC_HANDLER_DEFINE(ble_dis, "ble_dis", NULL, settings_set_cb, NULL, NULL);
+#else
+
+/* Nothing to keep; the info read is only reported */
+static int save_dis_info_to_settings(const bt_addr_le_t *addr) {
+	ARG_UNUSED(addr);
+
+	relay_device_info_invalidate();
+	return 0;
+}
+
+#endif /* CONFIG_BLE_DIS_CACHE */
 
 /* Public API implementations */
 int ble_dis_init(void) {
@@ -277,9 +368,6 @@ int ble_dis_init(void) {
 	 */
 	dis_ready = false;
 
-	/* Initialize work queue for deferred flash writes */
-	k_work_init(&clear_fw_cache_work, clear_fw_cache_work_handler);
-
 	LOG_INF("DIS init - device_info state: has_fw=%d, fw='%s', has_pnp=%d, vid=0x%04X, pid=0x%04X",
 			device_info.has_firmware_version, device_info.firmware_version,
 			device_info.has_pnp_id, device_info.vendor_id, device_info.product_id);
@@ -344,7 +432,10 @@ const ble_dis_info_t *ble_dis_get_info(void) {
 	return NULL;
 }
 
+#if defined(CONFIG_BLE_DIS_CACHE)
 int ble_dis_load_info_for_addr(const bt_addr_le_t *addr, ble_dis_info_t *out_info) {
+	int err = -ENOENT;
+
 	if (!addr || !out_info) {
 		return -EINVAL;
 	}
@@ -353,21 +444,24 @@ int ble_dis_load_info_for_addr(const bt_addr_le_t *addr, ble_dis_info_t *out_inf
 		return -ENOTSUP;
 	}
 
-	char key[64];
-	build_dis_settings_key(addr, key, sizeof(key));
-
-	/* Use settings_load_one to load the data directly */
-	ssize_t len = settings_load_one(key, out_info, sizeof(ble_dis_info_t));
-	if (len <= 0) {
-		LOG_DBG("No DIS info found for device (key: %s, len: %d)", key, (int) len);
-		return -ENOENT;
+	/* The cache holds everything the record does; no flash read */
+	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
+		if (dis_cache[i].valid && bt_addr_le_cmp(&dis_cache[i].addr, addr) == 0) {
+			*out_info = dis_cache[i].info;
+			err = 0;
+			break;
+		}
 	}
+	k_mutex_unlock(&dis_cache_mutex);
 
-	if (out_info->has_device_name) {
+	if (err) {
+		LOG_DBG("No DIS info cached for device");
+	} else if (out_info->has_device_name) {
 		LOG_DBG("Loaded DIS info for device: name='%s'", out_info->device_name);
 	}
 
-	return 0;
+	return err;
 }
 
 void ble_dis_clear_saved_for_addr(const bt_addr_le_t *addr) {
@@ -375,79 +469,72 @@ void ble_dis_clear_saved_for_addr(const bt_addr_le_t *addr) {
 		return;
 	}
 
-	char key[64];
-	build_dis_settings_key(addr, key, sizeof(key));
-
-	LOG_INF("Clearing DIS info for device: %s", key);
+	char addr_str[BT_ADDR_LE_STR_LEN];
+	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+	LOG_INF("Clearing DIS info for device: %s", addr_str);
 
-	int err = settings_delete(key);
-	if (err && err != -ENOENT) {
-		LOG_ERR("Failed to delete DIS info (err %d)", err);
-	} else {
-		LOG_DBG("Cleared DIS info from storage");
+	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
+		if (dis_cache[i].valid && bt_addr_le_cmp(&dis_cache[i].addr, addr) == 0) {
+			dis_cache[i].valid = false;
+			break;
+		}
 	}
+	k_mutex_unlock(&dis_cache_mutex);
+
+	relay_store_request();
+	relay_device_info_invalidate();
 }
+#endif /* CONFIG_BLE_DIS_CACHE */
 
 void ble_dis_clear_saved(void) {
 	LOG_INF("Clearing all saved DIS info");
 
 	/* Clear in-memory cache */
 	memset(&device_info, 0, sizeof(device_info));
+	relay_device_info_invalidate();
 
 	/* Note: Per-device DIS info in settings will be cleaned up when bonds are cleared */
 	/* This function now just clears the global cache */
 }
 
+#if defined(CONFIG_BLE_DIS_CACHE)
 void ble_dis_clear_cached_firmware_for_addr(const bt_addr_le_t *addr) {
-	if (!addr || !IS_ENABLED(CONFIG_SETTINGS)) {
-		return;
-	}
-
-	/* Load existing DIS info */
-	ble_dis_info_t dis_info;
-	int err = ble_dis_load_info_for_addr(addr, &dis_info);
+	bool found = false;
 
-	if (err != 0) {
-		LOG_DBG("No cached DIS info to clear firmware from");
+	if (!addr || !IS_ENABLED(CONFIG_SETTINGS)) {
 		return;
 	}
 
-	/* Clear only the firmware version field */
-	dis_info.has_firmware_version = false;
-	dis_info.firmware_version[0] = '\0';
-
-	/* Save back to flash storage */
-	char key[64];
-	build_dis_settings_key(addr, key, sizeof(key));
-
-	err = settings_save_one(key, &dis_info, sizeof(ble_dis_info_t));
-	if (err) {
-		LOG_ERR("Failed to save DIS info after clearing firmware (err %d)", err);
-	} else {
-		char addr_str[BT_ADDR_LE_STR_LEN];
-		bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
-		LOG_INF("Cleared cached firmware version in flash for device: %s", addr_str);
-	}
-
-	/* Also clear from in-memory cache (protected by mutex) */
 	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
 	for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
 		if (dis_cache[i].valid && bt_addr_le_cmp(&dis_cache[i].addr, addr) == 0) {
 			dis_cache[i].info.has_firmware_version = false;
 			dis_cache[i].info.firmware_version[0] = '\0';
 			LOG_INF("Cleared cached firmware version in memory cache entry %d", i);
+			found = true;
 			break;
 		}
 	}
 	k_mutex_unlock(&dis_cache_mutex);
+
+	if (!found) {
+		LOG_DBG("No cached DIS info to clear firmware from");
+		return;
+	}
+
+	relay_store_request();
+	relay_device_info_invalidate();
 }
+#endif /* CONFIG_BLE_DIS_CACHE */
 
 void ble_dis_clear_all_cached_firmware(void) {
 	LOG_INF("Clearing cached firmware version for all devices");
 
+	int cleared = 0;
+#if defined(CONFIG_BLE_DIS_CACHE)
 	/* Clear all in-memory cache entries immediately (protected by mutex) */
 	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
-	int cleared = 0;
 	for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
 		if (dis_cache[i].valid && dis_cache[i].info.has_firmware_version) {
 			dis_cache[i].info.has_firmware_version = false;
@@ -456,18 +543,18 @@ void ble_dis_clear_all_cached_firmware(void) {
 		}
 	}
 	k_mutex_unlock(&dis_cache_mutex);
+#endif
 
 	/* Also clear current device_info */
 	device_info.has_firmware_version = false;
 	device_info.firmware_version[0] = '\0';
 
 	LOG_INF("Cleared firmware from %d in-memory cache entries", cleared);
+	relay_device_info_invalidate();
 
-	/* Submit work to clear flash asynchronously (non-blocking) */
-	if (!clear_fw_cache_pending) {
-		clear_fw_cache_pending = true;
-		k_work_submit(&clear_fw_cache_work);
-		LOG_INF("Submitted deferred flash clear work");
+	/* The record follows in the next quiet spell */
+	if (cleared > 0) {
+		relay_store_request();
 	}
 }
 
@@ -479,9 +566,10 @@ static void load_cache_for_addr(const bt_addr_le_t *addr) {
 		return;
 	}
 
+	bool found = false;
+#if defined(CONFIG_BLE_DIS_CACHE)
 	/* Search for this address in the cache (protected by mutex) */
 	k_mutex_lock(&dis_cache_mutex, K_FOREVER);
-	bool found = false;
 	for (int i = 0; i < MAX_DIS_CACHE_ENTRIES; i++) {
 		if (dis_cache[i].valid && bt_addr_le_cmp(&dis_cache[i].addr, addr) == 0) {
 			/* Found cached info for this device */
@@ -491,6 +579,7 @@ static void load_cache_for_addr(const bt_addr_le_t *addr) {
 		}
 	}
 	k_mutex_unlock(&dis_cache_mutex);
+#endif
 
 	if (found) {
 		LOG_INF("Loaded cached DIS from memory: has_fw=%d, fw='%s'",
@@ -694,6 +783,17 @@ static dis_read_step_t on_connection_read_steps[] = {
 		},
 };
 
+/* Handle-based steps already answered by one Read Multiple Variable request */
+static bool read_multiple_done;
+
+#define DIS_READ_MULTIPLE_MAX ARRAY_SIZE(on_connection_read_steps)
+
+static struct bt_gatt_read_params read_multiple_params;
+static uint16_t read_multiple_handles[DIS_READ_MULTIPLE_MAX];
+static dis_read_step_t *read_multiple_steps[DIS_READ_MULTIPLE_MAX];
+static size_t read_multiple_index;
+static size_t read_multiple_rsp_len;
+
 /* Advance the read pipeline starting from next_step.
  * Skips steps whose handle is zero (characteristic not found on remote).
  * The last step in the array is always an action step that terminates the pipeline. */
@@ -714,6 +814,11 @@ static void advance_read_pipeline(dis_read_step_t *step) {
 			advance_read_pipeline(step + 1);
 			return;
 		}
+
+		if (read_multiple_done) {
+			advance_read_pipeline(step + 1);
+			return;
+		}
 	}
 
 	step->params.func = dis_read_generic_cb;
@@ -728,13 +833,84 @@ static void advance_read_pipeline(dis_read_step_t *step) {
 	}
 }
 
-/* DIS Discovery callbacks */
-static void dis_discovery_completed_cb(struct bt_gatt_dm *dm, void *context) {
-	int err;
+/* Values come back in request order, each cut to what fitted in the response */
+static uint8_t dis_read_multiple_cb(struct bt_conn *conn, uint8_t err,
+									struct bt_gatt_read_params *params,
+									const void *data, uint16_t length) {
+	if (err) {
+		LOG_INF("Read Multiple Variable failed (err 0x%02x), reading one by one", err);
+		advance_read_pipeline(&on_connection_read_steps[0]);
+		return BT_GATT_ITER_STOP;
+	}
+
+	if (data) {
+		if (read_multiple_index < params->handle_count) {
+			read_multiple_steps[read_multiple_index++]->process_fn(data, length, 0);
+		}
+		read_multiple_rsp_len += sizeof(uint16_t) + length;
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	/* A full response may have truncated the last value */
+	if (read_multiple_index < params->handle_count ||
+		read_multiple_rsp_len >= bt_gatt_get_mtu(conn) - 1) {
+		LOG_INF("Read Multiple Variable response incomplete, reading one by one");
+	} else {
+		LOG_INF("Read %zu DIS characteristics in one request", params->handle_count);
+		read_multiple_done = true;
+	}
+
+	advance_read_pipeline(&on_connection_read_steps[0]);
+	return BT_GATT_ITER_STOP;
+}
+
+/* Start the pipeline. With CONFIG_BLE_DIS_READ_MULTIPLE all handle-based
+ * steps are first read in one Read Multiple Variable request; the pipeline
+ * then only runs the other steps, or all of them if the request fails. */
+static void start_read_pipeline(void) {
+	size_t count = 0;
+
+	read_multiple_done = false;
+
+	if (IS_ENABLED(CONFIG_BLE_DIS_READ_MULTIPLE)) {
+		for (size_t i = 0; i < ARRAY_SIZE(on_connection_read_steps); i++) {
+			dis_read_step_t *step = &on_connection_read_steps[i];
+
+			if (step->handle_ptr != NULL && *step->handle_ptr != 0) {
+				read_multiple_handles[count] = *step->handle_ptr;
+				read_multiple_steps[count++] = step;
+			}
+		}
+	}
+
+	/* A single handle is just a plain read */
+	if (count < 2) {
+		advance_read_pipeline(&on_connection_read_steps[0]);
+		return;
+	}
+
+	read_multiple_index = 0;
+	read_multiple_rsp_len = 0;
+	read_multiple_params = (struct bt_gatt_read_params){
+			.func = dis_read_multiple_cb,
+			.handle_count = count,
+			.multiple = {.handles = read_multiple_handles, .variable = true},
+	};
+
+	LOG_INF("Starting Read Multiple Variable of %zu DIS characteristics", count);
+
+	int err = bt_gatt_read(current_conn, &read_multiple_params);
+	if (err) {
+		LOG_WRN("Failed to start Read Multiple Variable: %d", err);
+		advance_read_pipeline(&on_connection_read_steps[0]);
+	}
+}
+
+void ble_dis_handles_assign(struct bt_gatt_dm *dm) {
 	const struct bt_gatt_dm_attr *gatt_chrc;
 	const struct bt_gatt_dm_attr *gatt_desc;
 
-	LOG_INF("Device Information Service discovery completed");
+	current_conn = bt_gatt_dm_conn_get(dm);
 	bt_gatt_dm_data_print(dm);
 
 	/* Find Firmware Revision characteristic */
@@ -787,17 +963,35 @@ static void dis_discovery_completed_cb(struct bt_gatt_dm *dm, void *context) {
 		}
 	}
 
-	/* Release discovery data */
-	err = bt_gatt_dm_data_release(dm);
-	if (err) {
-		LOG_ERR("Could not release DIS discovery data: %d", err);
-	}
+	/* Start the read pipeline from the first step */
+	start_read_pipeline();
+}
+
+void ble_dis_handles_get(struct ble_dis_handles *handles) {
+	*handles = (struct ble_dis_handles){
+		.fw_rev = fw_rev_handle,
+		.hw_rev = hw_rev_handle,
+		.mfr_name = mfr_name_handle,
+		.model_number = model_number_handle,
+		.pnp_id = pnp_id_handle,
+	};
+}
+
+void ble_dis_handles_set(struct bt_conn *conn, const struct ble_dis_handles *handles) {
+	current_conn = conn;
+	fw_rev_handle = handles->fw_rev;
+	hw_rev_handle = handles->hw_rev;
+	mfr_name_handle = handles->mfr_name;
+	model_number_handle = handles->model_number;
+	pnp_id_handle = handles->pnp_id;
+
+	LOG_INF("Using cached DIS handles");
 
 	/* Start the read pipeline from the first step */
-	advance_read_pipeline(&on_connection_read_steps[0]);
+	start_read_pipeline();
 }
 
-static void dis_discovery_service_not_found_cb(struct bt_conn *conn, void *context) {
+void ble_dis_service_not_found(struct bt_conn *conn) {
 	LOG_INF("Device Information Service not found during discovery");
 	current_conn = conn;
 
@@ -806,6 +1000,22 @@ static void dis_discovery_service_not_found_cb(struct bt_conn *conn, void *conte
 	advance_read_pipeline(&on_connection_read_steps[0]);
 }
 
+/* DIS Discovery callbacks */
+static void dis_discovery_completed_cb(struct bt_gatt_dm *dm, void *context) {
+	LOG_INF("Device Information Service discovery completed");
+
+	ble_dis_handles_assign(dm);
+
+	int err = bt_gatt_dm_data_release(dm);
+	if (err) {
+		LOG_ERR("Could not release DIS discovery data: %d", err);
+	}
+}
+
+static void dis_discovery_service_not_found_cb(struct bt_conn *conn, void *context) {
+	ble_dis_service_not_found(conn);
+}
+
 static void dis_discovery_error_found_cb(struct bt_conn *conn, int err, void *context) {
 	LOG_ERR("Device Information Service discovery failed: %d", err);
 	current_conn = conn;
@@ -8,7 +8,10 @@
 #ifndef BLE_DIS_H_
 #define BLE_DIS_H_
 
+#include <errno.h>
+#include <stddef.h>
 #include <zephyr/bluetooth/conn.h>
+#include <bluetooth/gatt_dm.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -61,59 +64,76 @@ int ble_dis_init(void);
 int ble_dis_discover(struct bt_conn *conn);
 
 /**
- * @brief Check if Device Information Service discovery is complete
+ * @brief Take the handles from a discovered DIS service and start reading
  *
- * @return true if DIS discovery is complete and data is available, false otherwise
+ * The discovery complete callback fires once the reads finish. The caller
+ * releases the discovery data.
+ *
+ * @param dm Discovery data for the Device Information Service
  */
-bool ble_dis_is_ready(void);
+void ble_dis_handles_assign(struct bt_gatt_dm *dm);
 
 /**
- * @brief Reset Device Information Service state on disconnect
+ * @brief Read what is available without DIS (the device name)
  *
- * Clears all cached device information.
+ * For a discovery pass that finished without finding the service; the
+ * discovery complete callback fires once the reads finish.
+ *
+ * @param conn BLE connection that was discovered
  */
-void ble_dis_reset(void);
+void ble_dis_service_not_found(struct bt_conn *conn);
+
+/* Characteristic value handles read on connection; 0 if not present */
+struct ble_dis_handles {
+	uint16_t fw_rev;
+	uint16_t hw_rev;
+	uint16_t mfr_name;
+	uint16_t model_number;
+	uint16_t pnp_id;
+};
 
 /**
- * @brief Get the cached device information
- *
- * @return Pointer to device information structure, or NULL if not available
+ * @brief Get the handles found by the last discovery
  */
-const ble_dis_info_t *ble_dis_get_info(void);
+void ble_dis_handles_get(struct ble_dis_handles *handles);
 
 /**
- * @brief Load device information for a specific bonded device address
+ * @brief Use previously discovered handles and start reading
  *
- * @param addr BLE address of the bonded device
- * @param out_info Output structure to fill with device info
- * @return 0 on success, negative error code if not found or on failure
+ * Same as ble_dis_handles_assign() without a discovery.
+ *
+ * @param conn BLE connection to read from
+ * @param handles Handles from an earlier discovery of the same database
  */
-int ble_dis_load_info_for_addr(const bt_addr_le_t *addr, ble_dis_info_t *out_info);
+void ble_dis_handles_set(struct bt_conn *conn, const struct ble_dis_handles *handles);
 
 /**
- * @brief Clear saved device information for a specific address
+ * @brief Check if Device Information Service discovery is complete
  *
- * @param addr BLE address of the device to clear
+ * @return true if DIS discovery is complete and data is available, false otherwise
  */
-void ble_dis_clear_saved_for_addr(const bt_addr_le_t *addr);
+bool ble_dis_is_ready(void);
 
 /**
- * @brief Clear all saved device information from persistent storage
+ * @brief Reset Device Information Service state on disconnect
  *
- * This should be called when bonds are cleared to remove cached DIS info.
+ * Clears all cached device information.
  */
-void ble_dis_clear_saved(void);
+void ble_dis_reset(void);
 
 /**
- * @brief Clear cached firmware version for a specific device
+ * @brief Get the cached device information
  *
- * Loads the cached DIS info, clears only the firmware version field,
- * and saves it back. This forces firmware version to be re-read on
- * next connection (useful after MouthPad firmware update).
+ * @return Pointer to device information structure, or NULL if not available
+ */
+const ble_dis_info_t *ble_dis_get_info(void);
+
+/**
+ * @brief Clear all saved device information from persistent storage
  *
- * @param addr BLE address of the device
+ * This should be called when bonds are cleared to remove cached DIS info.
  */
-void ble_dis_clear_cached_firmware_for_addr(const bt_addr_le_t *addr);
+void ble_dis_clear_saved(void);
 
 /**
  * @brief Clear cached firmware version for all bonded devices
@@ -157,6 +177,86 @@ typedef void (*ble_dis_discovery_complete_cb_t)(struct bt_conn *conn);
  */
 void ble_dis_set_discovery_complete_cb(ble_dis_discovery_complete_cb_t cb);
 
+/* Info of every bonded MouthPad, kept in the relay_store.h record; without
+ * it only the connected MouthPad's info is known, once DIS has been read
+ */
+#if defined(CONFIG_BLE_DIS_CACHE)
+
+/**
+ * @brief Load device information for a specific bonded device address
+ *
+ * @param addr BLE address of the bonded device
+ * @param out_info Output structure to fill with device info
+ * @return 0 on success, negative error code if not found or on failure
+ */
+int ble_dis_load_info_for_addr(const bt_addr_le_t *addr, ble_dis_info_t *out_info);
+
+/**
+ * @brief Clear saved device information for a specific address
+ *
+ * @param addr BLE address of the device to clear
+ */
+void ble_dis_clear_saved_for_addr(const bt_addr_le_t *addr);
+
+/**
+ * @brief Clear cached firmware version for a specific device
+ *
+ * Loads the cached DIS info, clears only the firmware version field,
+ * and saves it back. This forces firmware version to be re-read on
+ * next connection (useful after MouthPad firmware update).
+ *
+ * @param addr BLE address of the device
+ */
+void ble_dis_clear_cached_firmware_for_addr(const bt_addr_le_t *addr);
+
+/**
+ * @brief Pack the per-device info cache as its relay_store.h section
+ *
+ * Strings are saved at their length, not their buffer size.
+ *
+ * @return Bytes used, 0 when there is nothing to save
+ */
+size_t ble_dis_store_save(uint8_t *buf, size_t size);
+
+/**
+ * @brief Fill the per-device info cache from its relay_store.h section at boot
+ */
+void ble_dis_store_load(const uint8_t *buf, size_t len);
+
+#else
+
+static inline int ble_dis_load_info_for_addr(const bt_addr_le_t *addr, ble_dis_info_t *out_info)
+{
+	ARG_UNUSED(addr);
+	ARG_UNUSED(out_info);
+	return -ENOENT;
+}
+
+static inline void ble_dis_clear_saved_for_addr(const bt_addr_le_t *addr)
+{
+	ARG_UNUSED(addr);
+}
+
+static inline void ble_dis_clear_cached_firmware_for_addr(const bt_addr_le_t *addr)
+{
+	ARG_UNUSED(addr);
+}
+
+static inline size_t ble_dis_store_save(uint8_t *buf, size_t size)
+{
+	ARG_UNUSED(buf);
+	ARG_UNUSED(size);
+	return 0;
+}
+
+static inline void ble_dis_store_load(const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(buf);
+	ARG_UNUSED(len);
+}
+
+#endif /* CONFIG_BLE_DIS_CACHE */
+
 #ifdef __cplusplus
 }
 #endif
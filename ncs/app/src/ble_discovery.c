@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/gatt_dm.h>
+#include <bluetooth/services/nus.h>
+
+#include "ble_discovery.h"
+#include "ble_hid.h"
+#include "ble_nus_client.h"
+#include "ble_dis.h"
+#include "ble_bas.h"
+#include "relay_store.h"
+
+#define LOG_MODULE_NAME ble_discovery
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+enum discovered_service {
+	SERVICE_HID = BIT(0),
+	SERVICE_NUS = BIT(1),
+	SERVICE_DIS = BIT(2),
+	SERVICE_BAS = BIT(3),
+};
+
+enum discovery_pass {
+	PASS_FULL,       /* Every primary service, NULL UUID */
+	PASS_CACHED,     /* NUS/DIS handles came from the handle cache */
+	PASS_CACHED_HID, /* then one bt_gatt_dm per remaining service */
+	PASS_CACHED_BAS,
+};
+
+/* Handles that can be reused while the peer's Database Hash is unchanged.
+ * HOGP and BAS clients only take their handles from a bt_gatt_dm, so just
+ * which of those services exist is remembered for them.
+ */
+struct gatt_cache_entry {
+	bt_addr_le_t addr;
+	uint8_t db_hash[16];
+	uint8_t services; /* enum discovered_service bits */
+	struct bt_nus_client_handles nus;
+	struct ble_dis_handles dis;
+};
+
+#define MAX_GATT_CACHE_ENTRIES 4
+static struct {
+	struct gatt_cache_entry entry;
+	bool valid;
+} gatt_cache[MAX_GATT_CACHE_ENTRIES];
+
+/* Mutex to protect gatt_cache from concurrent access */
+static K_MUTEX_DEFINE(gatt_cache_mutex);
+
+/* Services handed to their clients during the current pass */
+static uint32_t discovered;
+
+/* Services the cache says the peer has, for the cached passes */
+static uint32_t cached_services;
+
+static enum discovery_pass pass;
+
+/* Database Hash read at the start of this connection, if the peer has one */
+static uint8_t db_hash[16];
+static bool db_hash_valid;
+static struct bt_gatt_read_params db_hash_params;
+
+/* When the pass started, for the summary log */
+static int64_t discovery_start_time;
+
+static void discovery_completed_cb(struct bt_gatt_dm *dm, void *context);
+static void discovery_service_not_found_cb(struct bt_conn *conn, void *context);
+static void discovery_error_found_cb(struct bt_conn *conn, int err, void *context);
+
+static const struct bt_gatt_dm_cb discovery_cb = {
+	.completed = discovery_completed_cb,
+	.service_not_found = discovery_service_not_found_cb,
+	.error_found = discovery_error_found_cb,
+};
+
+/* Hand one service to its client; the first instance of each wins */
+static void dispatch_service(struct bt_gatt_dm *dm)
+{
+	const struct bt_gatt_service_val *svc =
+		bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm));
+
+	if (!bt_uuid_cmp(svc->uuid, BT_UUID_HIDS) && !(discovered & SERVICE_HID)) {
+		LOG_INF("HID service found - assigning HOGP handles");
+		discovered |= SERVICE_HID;
+		ble_hid_handles_assign(dm);
+	} else if (!bt_uuid_cmp(svc->uuid, BT_UUID_NUS_SERVICE) && !(discovered & SERVICE_NUS)) {
+		LOG_INF("NUS service found");
+		discovered |= SERVICE_NUS;
+		ble_nus_client_handles_assign(dm);
+	} else if (!bt_uuid_cmp(svc->uuid, BT_UUID_DIS) && !(discovered & SERVICE_DIS)) {
+		LOG_INF("Device Information Service found");
+		discovered |= SERVICE_DIS;
+		ble_dis_handles_assign(dm);
+	} else if (!bt_uuid_cmp(svc->uuid, BT_UUID_BAS) && !(discovered & SERVICE_BAS)) {
+		LOG_INF("Battery Service found");
+		discovered |= SERVICE_BAS;
+		ble_bas_handles_assign(dm);
+	}
+}
+
+/* Remember what a full pass found, keyed by the peer's identity address */
+static void gatt_cache_save(struct bt_conn *conn)
+{
+	if (!IS_ENABLED(CONFIG_BLE_GATT_HANDLE_CACHE) || !db_hash_valid ||
+	    !(discovered & SERVICE_NUS)) {
+		return;
+	}
+
+	struct gatt_cache_entry entry = {
+		.services = discovered,
+	};
+
+	bt_addr_le_copy(&entry.addr, bt_conn_get_dst(conn));
+	memcpy(entry.db_hash, db_hash, sizeof(entry.db_hash));
+	ble_nus_client_handles_get(&entry.nus);
+	if (discovered & SERVICE_DIS) {
+		ble_dis_handles_get(&entry.dis);
+	}
+
+	k_mutex_lock(&gatt_cache_mutex, K_FOREVER);
+	int slot = -1;
+	for (int i = 0; i < MAX_GATT_CACHE_ENTRIES; i++) {
+		if (gatt_cache[i].valid && bt_addr_le_eq(&gatt_cache[i].entry.addr, &entry.addr)) {
+			slot = i;
+			break;
+		}
+		if (!gatt_cache[i].valid && slot < 0) {
+			slot = i;
+		}
+	}
+	if (slot >= 0) {
+		gatt_cache[slot].entry = entry;
+		gatt_cache[slot].valid = true;
+	}
+	k_mutex_unlock(&gatt_cache_mutex);
+
+	if (slot < 0) {
+		LOG_WRN("GATT handle cache full, not saving");
+		return;
+	}
+
+	relay_store_request();
+}
+
+static bool gatt_cache_lookup(const bt_addr_le_t *addr, struct gatt_cache_entry *out)
+{
+	bool found = false;
+
+	k_mutex_lock(&gatt_cache_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_GATT_CACHE_ENTRIES; i++) {
+		if (gatt_cache[i].valid && bt_addr_le_eq(&gatt_cache[i].entry.addr, addr) &&
+		    !memcmp(gatt_cache[i].entry.db_hash, db_hash, sizeof(db_hash))) {
+			*out = gatt_cache[i].entry;
+			found = true;
+			break;
+		}
+	}
+	k_mutex_unlock(&gatt_cache_mutex);
+
+	return found;
+}
+
+size_t ble_discovery_store_save(uint8_t *buf, size_t size)
+{
+	size_t len = 0;
+
+	if (!IS_ENABLED(CONFIG_BLE_GATT_HANDLE_CACHE)) {
+		return 0;
+	}
+
+	k_mutex_lock(&gatt_cache_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_GATT_CACHE_ENTRIES; i++) {
+		if (!gatt_cache[i].valid) {
+			continue;
+		}
+		if (size - len < sizeof(struct gatt_cache_entry)) {
+			LOG_WRN("GATT cache entry %d does not fit the record", i);
+			break;
+		}
+		memcpy(&buf[len], &gatt_cache[i].entry, sizeof(struct gatt_cache_entry));
+		len += sizeof(struct gatt_cache_entry);
+	}
+	k_mutex_unlock(&gatt_cache_mutex);
+
+	return len;
+}
+
+void ble_discovery_store_load(const uint8_t *buf, size_t len)
+{
+	int count = 0;
+
+	/* Entries are saved as they are in RAM; another layout is dropped and
+	 * the next full discovery saves it again
+	 */
+	if (!IS_ENABLED(CONFIG_BLE_GATT_HANDLE_CACHE) ||
+	    len % sizeof(struct gatt_cache_entry) != 0) {
+		return;
+	}
+
+	k_mutex_lock(&gatt_cache_mutex, K_FOREVER);
+	for (size_t pos = 0; pos < len && count < MAX_GATT_CACHE_ENTRIES;
+	     pos += sizeof(struct gatt_cache_entry)) {
+		memcpy(&gatt_cache[count].entry, &buf[pos], sizeof(struct gatt_cache_entry));
+		gatt_cache[count].valid = true;
+		count++;
+	}
+	k_mutex_unlock(&gatt_cache_mutex);
+
+	LOG_DBG("Loaded %d GATT cache entries", count);
+}
+
+/* Older firmware's "ble_gatt/<6 hex bytes>_<type>" keys, read once to move
+ * them into the record (relay_store.h)
+ */
+static int gatt_settings_set_cb(const char *name, size_t len, settings_read_cb read_cb,
+				void *cb_arg)
+{
+	struct gatt_cache_entry entry;
+
+	/* The entry carries its own address, so the key needs no parsing */
+	if (len != sizeof(entry) || read_cb(cb_arg, &entry, sizeof(entry)) != sizeof(entry)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&gatt_cache_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_GATT_CACHE_ENTRIES; i++) {
+		if (!gatt_cache[i].valid) {
+			gatt_cache[i].entry = entry;
+			gatt_cache[i].valid = true;
+			LOG_DBG("Loaded GATT cache entry %d (%s)", i, name);
+			break;
+		}
+	}
+	k_mutex_unlock(&gatt_cache_mutex);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(ble_gatt, "ble_gatt", NULL, gatt_settings_set_cb, NULL, NULL);
+
+void ble_discovery_clear_cache_for_addr(const bt_addr_le_t *addr)
+{
+	if (!addr || !IS_ENABLED(CONFIG_BLE_GATT_HANDLE_CACHE)) {
+		return;
+	}
+
+	k_mutex_lock(&gatt_cache_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_GATT_CACHE_ENTRIES; i++) {
+		if (gatt_cache[i].valid && bt_addr_le_eq(&gatt_cache[i].entry.addr, addr)) {
+			gatt_cache[i].valid = false;
+		}
+	}
+	k_mutex_unlock(&gatt_cache_mutex);
+
+	relay_store_request();
+}
+
+void ble_discovery_clear_cache(void)
+{
+	if (!IS_ENABLED(CONFIG_BLE_GATT_HANDLE_CACHE)) {
+		return;
+	}
+
+	for (int i = 0; i < MAX_GATT_CACHE_ENTRIES; i++) {
+		bt_addr_le_t addr;
+		bool valid;
+
+		k_mutex_lock(&gatt_cache_mutex, K_FOREVER);
+		valid = gatt_cache[i].valid;
+		bt_addr_le_copy(&addr, &gatt_cache[i].entry.addr);
+		k_mutex_unlock(&gatt_cache_mutex);
+
+		if (valid) {
+			ble_discovery_clear_cache_for_addr(&addr);
+		}
+	}
+}
+
+/* The pass is over: tell clients about the services it did not find */
+static void discovery_finished(struct bt_conn *conn)
+{
+	if (pass == PASS_FULL) {
+		gatt_cache_save(conn);
+	}
+
+	LOG_INF("GATT discovery finished in %lld ms%s (HID:%d NUS:%d DIS:%d BAS:%d)",
+		k_uptime_get() - discovery_start_time, pass == PASS_FULL ? "" : " from cache",
+		!!(discovered & SERVICE_HID),
+		!!(discovered & SERVICE_NUS), !!(discovered & SERVICE_DIS),
+		!!(discovered & SERVICE_BAS));
+
+	if (!(discovered & SERVICE_HID)) {
+		LOG_WRN("HID service not found");
+	}
+	if (!(discovered & SERVICE_NUS)) {
+		LOG_WRN("NUS service not found");
+	}
+	if (!(discovered & SERVICE_DIS)) {
+		ble_dis_service_not_found(conn);
+	}
+	if (!(discovered & SERVICE_BAS)) {
+		LOG_INF("Battery Service not found");
+	}
+}
+
+static int start_full_pass(struct bt_conn *conn)
+{
+	pass = PASS_FULL;
+
+	/* A NULL UUID walks every primary service, one completed call each */
+	int err = bt_gatt_dm_start(conn, NULL, &discovery_cb, NULL);
+	if (err) {
+		LOG_ERR("Could not start GATT discovery (err %d)", err);
+	}
+
+	return err;
+}
+
+/* Discover the next cache-hit service that still needs a bt_gatt_dm */
+static void next_cached_pass(struct bt_conn *conn)
+{
+	const struct bt_uuid *uuid;
+
+	if (pass < PASS_CACHED_HID && (cached_services & SERVICE_HID)) {
+		pass = PASS_CACHED_HID;
+		uuid = BT_UUID_HIDS;
+	} else if (pass < PASS_CACHED_BAS && (cached_services & SERVICE_BAS)) {
+		pass = PASS_CACHED_BAS;
+		uuid = BT_UUID_BAS;
+	} else {
+		discovery_finished(conn);
+		return;
+	}
+
+	int err = bt_gatt_dm_start(conn, uuid, &discovery_cb, NULL);
+	if (err) {
+		LOG_ERR("Could not start GATT discovery (err %d)", err);
+		discovery_finished(conn);
+	}
+}
+
+static void use_cached_handles(struct bt_conn *conn, const struct gatt_cache_entry *entry)
+{
+	LOG_INF("Database Hash unchanged - using cached GATT handles");
+
+	cached_services = entry->services;
+	pass = PASS_CACHED;
+
+	discovered |= SERVICE_NUS;
+	ble_nus_client_handles_set(conn, &entry->nus);
+
+	/* A DIS absent from the cache is reported when the passes finish */
+	if (entry->services & SERVICE_DIS) {
+		discovered |= SERVICE_DIS;
+		ble_dis_handles_set(conn, &entry->dis);
+	}
+
+	next_cached_pass(conn);
+}
+
+static uint8_t db_hash_read_cb(struct bt_conn *conn, uint8_t err,
+			       struct bt_gatt_read_params *params, const void *data,
+			       uint16_t length)
+{
+	struct gatt_cache_entry entry;
+
+	ARG_UNUSED(params);
+
+	if (!err && data && length == sizeof(db_hash)) {
+		memcpy(db_hash, data, sizeof(db_hash));
+		db_hash_valid = true;
+	}
+
+	if (!db_hash_valid) {
+		/* No hash: the peer does not support caching, always discover */
+		LOG_DBG("No Database Hash (err 0x%02x)", err);
+		start_full_pass(conn);
+	} else if (gatt_cache_lookup(bt_conn_get_dst(conn), &entry)) {
+		use_cached_handles(conn, &entry);
+	} else {
+		start_full_pass(conn);
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+int ble_discovery_start(struct bt_conn *conn)
+{
+	discovered = 0;
+	db_hash_valid = false;
+	discovery_start_time = k_uptime_get();
+
+	if (!IS_ENABLED(CONFIG_BLE_GATT_HANDLE_CACHE)) {
+		return start_full_pass(conn);
+	}
+
+	/* The Database Hash decides whether last connection's handles still hold */
+	db_hash_params = (struct bt_gatt_read_params){
+		.func = db_hash_read_cb,
+		.handle_count = 0,
+		.by_uuid.uuid = BT_UUID_GATT_DB_HASH,
+		.by_uuid.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE,
+		.by_uuid.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE,
+	};
+
+	int err = bt_gatt_read(conn, &db_hash_params);
+	if (err) {
+		LOG_WRN("Could not read Database Hash (err %d)", err);
+		return start_full_pass(conn);
+	}
+
+	return 0;
+}
+
+static void discovery_completed_cb(struct bt_gatt_dm *dm, void *context)
+{
+	ARG_UNUSED(context);
+
+	dispatch_service(dm);
+
+	int err = bt_gatt_dm_data_release(dm);
+	if (err) {
+		LOG_ERR("Could not release discovery data (err %d)", err);
+	}
+
+	if (pass != PASS_FULL) {
+		next_cached_pass(bt_gatt_dm_conn_get(dm));
+		return;
+	}
+
+	err = bt_gatt_dm_continue(dm, NULL);
+	if (err) {
+		LOG_ERR("Could not continue GATT discovery (err %d)", err);
+		discovery_finished(bt_gatt_dm_conn_get(dm));
+	}
+}
+
+static void discovery_service_not_found_cb(struct bt_conn *conn, void *context)
+{
+	ARG_UNUSED(context);
+
+	if (pass != PASS_FULL) {
+		/* Gone despite the unchanged hash; the next pass or the summary copes */
+		next_cached_pass(conn);
+		return;
+	}
+
+	/* With a NULL UUID this marks the end of the database */
+	discovery_finished(conn);
+}
+
+static void discovery_error_found_cb(struct bt_conn *conn, int err, void *context)
+{
+	ARG_UNUSED(context);
+
+	LOG_ERR("GATT discovery failed (err %d)", err);
+	discovery_finished(conn);
+}
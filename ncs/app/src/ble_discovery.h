@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Single-pass GATT discovery for the HID, NUS, DIS and BAS clients
+ *
+ * One bt_gatt_dm run walks every primary service on the peer. Each service
+ * the relay uses is handed to its client as soon as it is discovered, so a
+ * client's own follow-up reads (HOGP report map, DIS strings) overlap with
+ * discovery of the services after it instead of waiting for a separate
+ * discovery of their own.
+ *
+ * With CONFIG_BLE_GATT_HANDLE_CACHE the NUS and DIS handles a full pass
+ * found are saved per bonded peer together with its Database Hash. When a
+ * reconnect reads the same hash they are assigned directly, and only HIDS
+ * and BAS, whose clients need a bt_gatt_dm, are discovered.
+ */
+
+#ifndef BLE_DISCOVERY_H_
+#define BLE_DISCOVERY_H_
+
+#include <zephyr/bluetooth/conn.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Discover the peer's GATT database and dispatch it to the clients
+ *
+ * Services the pass does not find are reported to the clients that need
+ * to know (DIS still reads the device name) when it ends.
+ *
+ * @param conn Connection to discover
+ * @return 0 if discovery started, negative error code otherwise
+ */
+int ble_discovery_start(struct bt_conn *conn);
+
+/**
+ * @brief Forget the cached GATT handles of one peer
+ *
+ * @param addr Identity address of the bond being removed
+ */
+void ble_discovery_clear_cache_for_addr(const bt_addr_le_t *addr);
+
+/**
+ * @brief Forget the cached GATT handles of every peer
+ */
+void ble_discovery_clear_cache(void);
+
+/**
+ * @brief Pack the handle cache as its relay_store.h section
+ *
+ * @return Bytes used, 0 when there is nothing to save
+ */
+size_t ble_discovery_store_save(uint8_t *buf, size_t size);
+
+/**
+ * @brief Fill the handle cache from its relay_store.h section at boot
+ */
+void ble_discovery_store_load(const uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_DISCOVERY_H_ */
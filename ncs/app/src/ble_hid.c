@@ -7,6 +7,7 @@
 
 #include <zephyr/types.h>
 #include <stddef.h>
+#include <string.h>
 #include <errno.h>
 #include <zephyr/kernel.h>
 
@@ -27,54 +28,44 @@
 #include <zephyr/usb/class/usbd_hid.h>
 
 #include "ble_hid.h"
+#include "fault_inject.h"
+#include "mouthpad_hid_reports.h"
+#include "hid_latency.h"
+#include "hid_mirror.h"
+#include "hid_ring.h"
+#include "usb_phase.h"
+#include "relay_activity.h"
+#include "relay_bus.h"
+#include "relay_time.h"
+#include "relay_probe.h"
+#include "relay_stall_watch.h"
+#include "relay_stats.h"
+#include "relay_sysview.h"
+#include "relay_workq.h"
+#include "usb_hid.h"
+#include "usb_raw_hid.h"
 
 /* Forward declarations for direct USB access */
-extern const struct device *hid_dev;
 extern struct k_sem ep_write_sem;
 
-/* Forward declaration for connection state check */
-extern bool ble_transport_is_connected(void);
-
 LOG_MODULE_REGISTER(ble_hid, LOG_LEVEL_INF);
 
 /* Callback registration */
-static ble_hid_data_received_cb_t data_received_callback = NULL;
 static ble_hid_ready_cb_t ready_callback = NULL;
 
-/**
- * Consumer Control usage codes for backwards compatibility.
- * Maps old 1-byte bitmap format to new 16-bit usage selector format.
- * Old firmware used 8 individual bit flags, new descriptor uses usage codes.
- */
-static const uint16_t consumer_bitmap_to_usage[] = {
-	0x00CD,  /* bit 0: Play/Pause */
-	0x0183,  /* bit 1: AL Consumer Control Configuration */
-	0x00B5,  /* bit 2: Scan Next Track */
-	0x00B6,  /* bit 3: Scan Previous Track */
-	0x00EA,  /* bit 4: Volume Decrement */
-	0x00E9,  /* bit 5: Volume Increment */
-	0x0225,  /* bit 6: AC Forward */
-	0x0224,  /* bit 7: AC Back */
-};
+/* NUS or HID client ready, from relay_chan_link_state, read for every report */
+static atomic_t link_connected;
 
-/**
- * Translate old consumer control bitmap to new 16-bit usage format.
- * Returns the usage code for the first set bit, or 0 if no bits set.
- */
-static uint16_t translate_consumer_bitmap(uint8_t bitmap)
+static void link_state_changed(const struct zbus_channel *chan)
 {
-	if (bitmap == 0) {
-		return 0;
-	}
-	/* Find first set bit and return corresponding usage */
-	for (int i = 0; i < 8; i++) {
-		if (bitmap & (1 << i)) {
-			return consumer_bitmap_to_usage[i];
-		}
-	}
-	return 0;
+	const struct relay_link_state_msg *msg = zbus_chan_const_msg(chan);
+
+	atomic_set(&link_connected, msg->connected);
 }
 
+ZBUS_LISTENER_DEFINE(ble_hid_link_state, link_state_changed);
+ZBUS_CHAN_ADD_OBS(relay_chan_link_state, ble_hid_link_state, RELAY_BUS_PRIO_STATE);
+
 /**
  * Switch between boot protocol and report protocol mode.
  */
@@ -152,102 +143,535 @@ static const struct bt_hogp_init_params hogp_init_params = {
 	.pm_update_cb  = hogp_pm_update_cb
 };
 
-/* HOGP callback implementations */
-static uint8_t hogp_notify_cb(struct bt_hogp *hogp,
-			     struct bt_hogp_rep_info *rep,
-			     uint8_t err,
-			     const uint8_t *data)
+/* Pre-sized USB TX buffers, one per report ID, with the ID byte already in
+ * place so the BLE payload is written straight in behind it. The USB stack
+ * transmits from these buffers without copying, and since no input_report_done
+ * op is registered, hid_device_submit_report() holds on to the buffer until
+ * the IN transfer has completed. All submits for a given report ID happen
+ * from the HID forwarding thread (the BT RX thread in boot protocol mode,
+ * when no report mode notification arrives), except Report ID 2 (and
+ * Report ID 1 in combined mouse mode) which is guarded by motion_lock. With CONFIG_USB_HID_SPLIT,
+ * consumer and keyboard reports go to an interface of their own
+ * (usb_hid_dev_for()) and never wait for a pointer transfer.
+ */
+struct hid_tx_buf {
+	uint8_t report[1 + MOUTHPAD_HID_REPORT_SIZE_MAX];
+} __aligned(4);
+
+static struct hid_tx_buf hid_tx_bufs[MOUTHPAD_HID_REPORT_ID_MAX] = {
+#define HID_TX_BUF_INIT(name, id, size) [(id) - 1] = { .report = { (id) } },
+	MOUTHPAD_HID_REPORTS(HID_TX_BUF_INIT)
+#undef HID_TX_BUF_INIT
+};
+
+/* Payload area of the TX buffer for report_id, or NULL if untracked */
+static inline uint8_t *hid_tx_payload(uint8_t report_id)
 {
-	uint8_t size = bt_hogp_rep_size(rep);
-	uint8_t i;
+	if (report_id == 0 || report_id > MOUTHPAD_HID_REPORT_ID_MAX) {
+		return NULL;
+	}
+	return &hid_tx_bufs[report_id - 1].report[1];
+}
 
-	if (!data) {
-		return BT_GATT_ITER_STOP;
+/* Size on the wire, which differs from the BLE size for Report ID 1 only
+ * in combined mouse mode
+ */
+static inline uint8_t hid_tx_size(uint8_t report_id)
+{
+	if (IS_ENABLED(CONFIG_HID_COMBINED_MOUSE) &&
+	    report_id == MOUTHPAD_HID_COMBINED_REPORT_ID) {
+		return MOUTHPAD_HID_COMBINED_REPORT_SIZE;
 	}
+	return mouthpad_hid_report_size(report_id);
+}
 
-	/* Check if still connected - prevent forwarding stale HID data during disconnect */
-	if (!ble_transport_is_connected()) {
-		LOG_DBG("Ignoring HID report - BLE disconnected");
-		return BT_GATT_ITER_STOP;
+/* Submit the TX buffer for report_id as a full-size report. The submit
+ * returns once the host has read the report.
+ */
+static inline int hid_tx_submit(uint8_t report_id)
+{
+	int ret;
+#if defined(CONFIG_USB_HID_SOF_PHASE)
+	uint32_t submit_us = relay_time_us32();
+
+	usb_phase_submit(submit_us);
+#endif
+
+	if (IS_ENABLED(CONFIG_RELAY_FAULT_INJECT) && fault_inject_usb_busy()) {
+		return -EAGAIN;
 	}
 
-	LOG_DBG("Notification, id: %u, size: %u, data:",
-	       bt_hogp_rep_id(rep),
-	       size);
-	for (i = 0; i < size; ++i) {
-		LOG_DBG(" 0x%x", data[i]);
+	relay_probe(RELAY_PROBE_USB_SUBMIT);
+	ret = hid_device_submit_report(usb_hid_dev_for(report_id), 1 + hid_tx_size(report_id),
+				       hid_tx_bufs[report_id - 1].report);
+	if (ret == 0) {
+		relay_probe(RELAY_PROBE_USB_DONE);
+#if defined(CONFIG_USB_HID_SOF_PHASE)
+		usb_phase_done(submit_us, relay_time_us32());
+#endif
 	}
-	LOG_DBG("\n");
+	return ret;
+}
 
-	// Handle different report types based on Report ID
-	uint8_t report_id = bt_hogp_rep_id(rep);
-	
-	// Button detection for buzzer feedback - check Report ID 1 (buttons)
+/* Report ID 2 carries signed 12-bit X/Y with a logical range of +/-2047 */
+#define MOTION_REPORT_ID   MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION
+#define MOTION_REPORT_SIZE MOUTHPAD_HID_REPORT_SIZE_MOUSE_MOTION
+#define MOTION_DELTA_MAX   2047
+#define MOTION_RETRY_DELAY K_MSEC(1)
+
+/* Relative motion that has not reached the host yet. When a motion report
+ * cannot be submitted, its deltas are summed here and sent as one report on
+ * the next free IN slot, so cursor movement is neither lost nor replayed
+ * late as a queue of stale reports. motion_lock also serializes the submit
+ * itself so the accumulator never disagrees with what reached USB.
+ *
+ * With CONFIG_HID_COMBINED_MOUSE, Report ID 1 goes through here too: the
+ * buttons are held state, and wheel and pan are summed like X/Y, so every
+ * flush is one combined report.
+ */
+static struct {
+	int32_t dx;
+	int32_t dy;
+	bool pending;
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+	uint8_t buttons;
+	int32_t wheel;
+	int32_t pan;
+#endif
+} motion_acc;
+static K_MUTEX_DEFINE(motion_lock);
+
+static void motion_retry_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(motion_retry_work, motion_retry_handler);
+
+/* Set while the bench command injects reports with no MouthPad connected,
+ * so the accumulator keeps their motion instead of discarding it
+ */
+static atomic_t inject_active;
+
+static int32_t sign_extend_12(uint32_t value)
+{
+	return (int32_t)(value << 20) >> 20;
+}
+
+static void motion_clear_locked(void)
+{
+	motion_acc.dx = 0;
+	motion_acc.dy = 0;
+	motion_acc.pending = false;
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+	motion_acc.wheel = 0;
+	motion_acc.pan = 0;
+#endif
+}
+
+static void motion_pack(int32_t dx, int32_t dy, uint8_t *out)
+{
+	uint16_t x = (uint16_t)dx & 0x0FFF;
+	uint16_t y = (uint16_t)dy & 0x0FFF;
+
+	out[0] = x & 0xFF;
+	out[1] = ((x >> 8) & 0x0F) | ((y & 0x0F) << 4);
+	out[2] = (y >> 4) & 0xFF;
+}
+
+/**
+ * Submit the accumulated motion as a single Report ID 2, or as Report ID 1
+ * in combined mouse mode. Must be called with motion_lock held.
+ *
+ * Returns 0 when sent (or nothing was pending), -EAGAIN when the deltas
+ * were kept for a retry, or the submit error when they were discarded.
+ */
+static int motion_flush_locked(void)
+{
+	if (!motion_acc.pending) {
+		return 0;
+	}
+
+	if (!atomic_get(&link_connected) && !atomic_get(&inject_active)) {
+		motion_clear_locked();
+		return -ENOTCONN;
+	}
+
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+	uint8_t motion[MOTION_REPORT_SIZE];
+	const uint8_t buttons[MOUTHPAD_HID_REPORT_SIZE_MOUSE_BUTTONS] = {
+		motion_acc.buttons,
+		(uint8_t)CLAMP(motion_acc.wheel, INT8_MIN + 1, INT8_MAX),
+		(uint8_t)CLAMP(motion_acc.pan, INT8_MIN + 1, INT8_MAX),
+	};
+
+	motion_pack(motion_acc.dx, motion_acc.dy, motion);
+	mouthpad_hid_combine(hid_tx_payload(MOUTHPAD_HID_COMBINED_REPORT_ID), buttons, motion);
+
+	int ret = hid_tx_submit(MOUTHPAD_HID_COMBINED_REPORT_ID);
+#else
+	motion_pack(motion_acc.dx, motion_acc.dy, hid_tx_payload(MOTION_REPORT_ID));
+
+	int ret = hid_tx_submit(MOTION_REPORT_ID);
+#endif
+
+	if (ret == 0) {
+		motion_clear_locked();
+		return 0;
+	}
+
+	if (ret == -EACCES) {
+		/* Interface disabled or suspended - motion would be stale on resume */
+		motion_clear_locked();
+		return ret;
+	}
+
+	k_work_schedule_for_queue(&relay_workq_realtime, &motion_retry_work, MOTION_RETRY_DELAY);
+	return -EAGAIN;
+}
+
+static int motion_flush(void)
+{
+	int ret;
+
+	k_mutex_lock(&motion_lock, K_FOREVER);
+	ret = motion_flush_locked();
+	k_mutex_unlock(&motion_lock);
+
+	return ret;
+}
+
+/* Add a BLE motion report to the accumulator and try to send it */
+static int motion_submit(const uint8_t *data)
+{
+	int32_t dx = sign_extend_12(data[0] | ((data[1] & 0x0F) << 8));
+	int32_t dy = sign_extend_12((data[1] >> 4) | (data[2] << 4));
+	int ret;
+
+	k_mutex_lock(&motion_lock, K_FOREVER);
+	motion_acc.dx = CLAMP(motion_acc.dx + dx, -MOTION_DELTA_MAX, MOTION_DELTA_MAX);
+	motion_acc.dy = CLAMP(motion_acc.dy + dy, -MOTION_DELTA_MAX, MOTION_DELTA_MAX);
+	motion_acc.pending = true;
+	ret = motion_flush_locked();
+	k_mutex_unlock(&motion_lock);
+
+	return ret;
+}
+
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+/* Fold a Report ID 1 payload (buttons, wheel, AC pan) into the accumulator
+ * and send it together with any motion that arrived before it
+ */
+static int mouse_buttons_submit(const uint8_t *data, uint8_t size)
+{
+	uint8_t buttons[MOUTHPAD_HID_REPORT_SIZE_MOUSE_BUTTONS] = {0};
+	int ret;
+
+	memcpy(buttons, data, MIN(size, sizeof(buttons)));
+
+	k_mutex_lock(&motion_lock, K_FOREVER);
+	motion_acc.buttons = buttons[0];
+	motion_acc.wheel += (int8_t)buttons[1];
+	motion_acc.pan += (int8_t)buttons[2];
+	motion_acc.pending = true;
+	ret = motion_flush_locked();
+	k_mutex_unlock(&motion_lock);
+
+	return ret;
+}
+#endif
+
+/* Send pending motion ahead of report_id if it has to go first: buttons
+ * land where the cursor is, other reports overtake motion. In combined
+ * mouse mode the accumulator may hold a button change, which keeps its
+ * place in line.
+ */
+static void motion_flush_before(uint8_t report_id)
+{
+	if (IS_ENABLED(CONFIG_HID_COMBINED_MOUSE) ||
+	    mouthpad_hid_report_after_motion(report_id)) {
+		motion_flush();
+	}
+}
+
+static void motion_retry_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	motion_flush();
+}
+
+/* Copy a report into the HID mirror stream; rx_us is 0 while it is off */
+static void mirror_report(uint8_t report_id, const uint8_t *data, uint8_t size,
+			  uint64_t rx_us, bool submitted)
+{
+	if (rx_us) {
+		hid_mirror_record(report_id, data, size, rx_us, relay_time_us64(), submitted);
+	}
+}
+
+/* Check a report against what the host was last sent. A legacy consumer
+ * bitmap is compared as the usage it becomes. The bench injects reports to
+ * load USB, so they all go.
+ */
+static bool idle_filter(uint8_t report_id, const uint8_t *data, uint8_t size)
+{
+	uint8_t usage[MOUTHPAD_HID_REPORT_SIZE_CONSUMER];
+
+	if (atomic_get(&inject_active)) {
+		return true;
+	}
+	if (report_id == MOUTHPAD_HID_REPORT_ID_CONSUMER &&
+	    size == MOUTHPAD_HID_CONSUMER_BITMAP_SIZE) {
+		sys_put_le16(mouthpad_hid_consumer_usage(data[0]), usage);
+		return usb_hid_idle_filter(report_id, usage, sizeof(usage));
+	}
+	return usb_hid_idle_filter(report_id, data, size);
+}
+
+/* Forward one input report to USB: the common part of a HOGP notification
+ * and a report injected by the bench command. rx_stamp and mirror_rx are
+ * taken when the report arrived.
+ *
+ * Returns 0 when submitted, -EAGAIN when motion was coalesced for a retry,
+ * -EACCES while the host is suspended, -EALREADY for a report that tells
+ * the host nothing new, -ENOTSUP for a report the USB descriptor cannot
+ * carry, or the submit error.
+ */
+static int forward_input_report(uint8_t report_id, const uint8_t *data, uint8_t size,
+				uint32_t rx_stamp, uint64_t mirror_rx)
+{
+	int ret = -ENOTSUP;
+
+	// Button detection for click feedback - check Report ID 1 (buttons)
+	uint8_t pressed = 0;
 	if (report_id == 1 && size >= 1) {
 		static uint8_t last_buttons = 0;
 		uint8_t current_buttons = data[0];  // Raw BLE data, no Report ID prepended yet
 		
-		// Detect left click (bit 0) - press only (0->1 transition)
-		if ((current_buttons & 0x01) && !(last_buttons & 0x01)) {
-			LOG_DBG("LEFT CLICK DETECTED - buzzing");
-			extern void buzzer_click_left(void);
-			buzzer_click_left();
-		}
-		
-		// Detect right click (bit 1) - press only (0->1 transition)  
-		if ((current_buttons & 0x02) && !(last_buttons & 0x02)) {
-			LOG_DBG("RIGHT CLICK DETECTED - buzzing");
-			extern void buzzer_click_right(void);
-			buzzer_click_right();
-		}
-		
+		// Press only (0->1 transition); the click sound is queued after forwarding
+		pressed = current_buttons & ~last_buttons;
 		last_buttons = current_buttons;
 	}
-	
+
+	/* Host asleep: the IN endpoint is not polled, so a submit would block
+	 * this thread until resume. Drop the report and let a press wake it.
+	 */
+	if (usb_hid_is_suspended()) {
+		if (pressed) {
+			usb_hid_remote_wakeup();
+		}
+		mirror_report(report_id, data, size, mirror_rx, false);
+		return -EACCES;
+	}
+
+	/* Raw samples want every report, before any of them is filtered */
+	usb_raw_hid_sample(report_id, data, size);
+
+	/* All-zero motion or an unchanged state: not worth an IN transfer,
+	 * which would hold up the next real report behind it
+	 */
+	if (size >= 1 && !idle_filter(report_id, data, size)) {
+		mirror_report(report_id, data, size, mirror_rx, false);
+		return -EALREADY;
+	}
+
 	// Parse and forward each report ID independently
 	if (size >= 1) {
-		int ret;
-
-		/* Handle Report ID 3 (Consumer Control) backwards compatibility */
-		if (report_id == 3 && size == 1) {
-			/* Old firmware sends 1-byte bitmap, translate to 16-bit usage */
-			uint16_t usage = translate_consumer_bitmap(data[0]);
-			uint8_t consumer_report[3] = {
-				0x03,              /* Report ID 3 */
-				usage & 0xFF,     /* Usage low byte */
-				(usage >> 8) & 0xFF  /* Usage high byte */
-			};
+		uint8_t *payload = hid_tx_payload(report_id);
+
+		if (report_id == MOTION_REPORT_ID && size == MOTION_REPORT_SIZE) {
+			/* Coalesce X/Y deltas instead of dropping them when USB is busy */
+			ret = motion_submit(data);
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+		} else if (report_id == MOUTHPAD_HID_COMBINED_REPORT_ID &&
+			   mouthpad_hid_report_fits(report_id, size)) {
+			ret = mouse_buttons_submit(data, size);
+#endif
+		} else if (report_id == MOUTHPAD_HID_REPORT_ID_CONSUMER &&
+			   size == MOUTHPAD_HID_CONSUMER_BITMAP_SIZE) {
+			/* Old firmware sends a 1-byte consumer bitmap, translate to 16-bit usage */
+			uint16_t usage = mouthpad_hid_consumer_usage(data[0]);
+
 			LOG_DBG("Consumer control: bitmap 0x%02x -> usage 0x%04x", data[0], usage);
-			ret = hid_device_submit_report(hid_dev, sizeof(consumer_report), consumer_report);
+			sys_put_le16(usage, payload);
+			motion_flush_before(report_id);
+			ret = hid_tx_submit(report_id);
+		} else if (!mouthpad_hid_report_fits(report_id, size) ||
+			   report_id == MOTION_REPORT_ID) {
+			/* Not representable in the USB report descriptor */
+			LOG_WRN("Dropping unsupported report id %u size %u", report_id, size);
+			usb_hid_idle_forget(report_id);
+			mirror_report(report_id, data, size, mirror_rx, false);
+			return -ENOTSUP;
 		} else {
-			/* Send directly to USB for zero latency */
-			uint8_t report_with_id[size + 1];
-			report_with_id[0] = report_id;
-			for (uint8_t i = 0; i < size; i++) {
-				report_with_id[i + 1] = data[i];
-			}
-			ret = hid_device_submit_report(hid_dev, size + 1, report_with_id);
+			uint8_t usb_size = mouthpad_hid_report_size(report_id);
+
+			memcpy(payload, data, size);
+			memset(payload + size, 0, usb_size - size);
+			motion_flush_before(report_id);
+			ret = hid_tx_submit(report_id);
 		}
 
-		if (ret) {
+		/* Submits complete with the IN transfer, so this is after it went out */
+		mirror_report(report_id, data, size, mirror_rx, ret == 0);
+
+		if (ret == -EAGAIN) {
+			/* Only the accumulator paths keep a report for a retry */
+			LOG_DBG("USB busy, motion coalesced for next report");
+		} else if (ret) {
 			LOG_ERR("HID write error, %d", ret);
+			usb_hid_idle_forget(report_id);
 		} else {
-			// LOG_DBG("Report %u sent directly to USB", report_id);
+			/* No input_report_done op is registered, so the submit above
+			 * only returns once the IN transfer has completed.
+			 */
+			hid_latency_record(report_id, rx_stamp);
 
-			/* Trigger data activity callback for LED indication */
-			if (data_received_callback) {
-				data_received_callback(data, size);
-			}
-
-			/* Mark HID-specific data activity for LED indication */
-			extern void ble_transport_mark_hid_data_activity(void);
-			ble_transport_mark_hid_data_activity();
+			relay_activity_mark();
 		}
 	}
-	
+
+	/* Once, after the report went out: click feedback, stats */
+	struct relay_hid_report_msg msg = {
+		.report_id = report_id,
+		.size = size,
+		.pressed = pressed,
+		.sent = ret == 0,
+	};
+
+	memcpy(msg.data, data, MIN(size, sizeof(msg.data)));
+	relay_bus_publish(&relay_chan_hid_report, &msg);
+
+	return ret;
+}
+
+/* HOGP callback implementations */
+
+/* Notifications are copied here in the BT RX thread and forwarded to USB
+ * by ble_hid_fwd_thread, so a slow submit, log line or click sound never
+ * holds up the next GATT notification, NUS included
+ */
+static struct hid_ring hid_rx_ring;
+static K_SEM_DEFINE(hid_fwd_sem, 0, 1);
+
+static uint8_t hogp_notify_handle(struct bt_hogp_rep_info *rep, const uint8_t *data,
+				  uint32_t stall_stamp)
+{
+	uint8_t size = bt_hogp_rep_size(rep);
+	struct hid_ring_entry *entry;
+
+	if (!data) {
+		return BT_GATT_ITER_STOP;
+	}
+
+	/* Check if still connected - prevent forwarding stale HID data during disconnect */
+	if (!atomic_get(&link_connected)) {
+		LOG_DBG("Ignoring HID report - BLE disconnected");
+		return BT_GATT_ITER_STOP;
+	}
+
+	if (size > HID_RING_DATA_MAX) {
+		/* Not representable in the USB report descriptor */
+		LOG_WRN("Dropping unsupported report id %u size %u", bt_hogp_rep_id(rep), size);
+		usb_hid_idle_forget(bt_hogp_rep_id(rep));
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	entry = hid_ring_claim(&hid_rx_ring);
+	if (!entry) {
+		/* The forwarding thread is a whole ring behind; USB is stuck */
+		relay_stats_add(RELAY_STATS_HID, RELAY_STATS_DROPPED, 1);
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	entry->latency_stamp = hid_latency_start();
+	entry->mirror_us = hid_mirror_enabled() ? relay_time_us64() : 0;
+	entry->stall_stamp = stall_stamp;
+	entry->report_id = bt_hogp_rep_id(rep);
+	entry->size = size;
+	memcpy(entry->data, data, size);
+	hid_ring_publish(&hid_rx_ring);
+	k_sem_give(&hid_fwd_sem);
+
 	return BT_GATT_ITER_CONTINUE;
 }
 
+static uint8_t hogp_notify_cb(struct bt_hogp *hogp,
+			     struct bt_hogp_rep_info *rep,
+			     uint8_t err,
+			     const uint8_t *data)
+{
+	relay_probe(RELAY_PROBE_HID_RX);
+
+	if (IS_ENABLED(CONFIG_RELAY_FAULT_INJECT) && fault_inject_notification(FAULT_INJECT_HID)) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	return hogp_notify_handle(rep, data, relay_stall_watch_start());
+}
+
+/* Forwards reports in arrival order. Each submit returns once the host has
+ * read the report, and reports arriving meanwhile wait in the ring.
+ */
+static void ble_hid_fwd_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	const struct hid_ring_entry *entry;
+
+	hid_ring_init(&hid_rx_ring);
+
+	for (;;) {
+		k_sem_take(&hid_fwd_sem, K_FOREVER);
+
+		while ((entry = hid_ring_peek(&hid_rx_ring)) != NULL) {
+			/* Queued before the link dropped: stale now */
+			if (atomic_get(&link_connected)) {
+				LOG_DBG("Notification, id: %u, size: %u", entry->report_id, entry->size);
+				LOG_HEXDUMP_DBG(entry->data, entry->size, "data:");
+
+				relay_sysview_mark_start(RELAY_MARKER_HID_INPUT);
+				forward_input_report(entry->report_id, entry->data, entry->size,
+						     entry->latency_stamp, entry->mirror_us);
+				relay_sysview_mark_stop(RELAY_MARKER_HID_INPUT);
+
+				relay_stall_watch_pipeline(entry->stall_stamp);
+			}
+			hid_ring_release(&hid_rx_ring);
+		}
+	}
+}
+
+K_THREAD_DEFINE(ble_hid_fwd_tid, CONFIG_BLE_HID_FWD_STACK_SIZE, ble_hid_fwd_thread,
+		NULL, NULL, NULL, CONFIG_BLE_HID_FWD_PRIORITY, 0, 0);
+
+int ble_hid_inject_start(void)
+{
+	if (atomic_get(&link_connected)) {
+		return -EBUSY;
+	}
+
+	atomic_set(&inject_active, 1);
+	return 0;
+}
+
+int ble_hid_inject_report(uint8_t report_id, const uint8_t *data, uint8_t size)
+{
+	if (!atomic_get(&inject_active)) {
+		return -EPERM;
+	}
+
+	return forward_input_report(report_id, data, size, hid_latency_start(),
+				    hid_mirror_enabled() ? relay_time_us64() : 0);
+}
+
+void ble_hid_inject_stop(void)
+{
+	k_mutex_lock(&motion_lock, K_FOREVER);
+	atomic_set(&inject_active, 0);
+	motion_clear_locked();
+	k_mutex_unlock(&motion_lock);
+}
+
 static uint8_t hogp_boot_mouse_report(struct bt_hogp *hogp,
 				     struct bt_hogp_rep_info *rep,
 				     uint8_t err,
@@ -260,13 +684,20 @@ static uint8_t hogp_boot_mouse_report(struct bt_hogp *hogp,
 	}
 
 	/* Check if still connected - prevent forwarding stale HID data during disconnect */
-	if (!ble_transport_is_connected()) {
+	if (!atomic_get(&link_connected)) {
 		LOG_DBG("Ignoring HID report - BLE disconnected");
 		return BT_GATT_ITER_STOP;
 	}
 
 	LOG_HEXDUMP_DBG(data, size, "Boot mouse report:");
 
+	/* Boot mouse buttons (3 bits) as the Report ID 1 they are sent as */
+	const uint8_t boot_report[MOUTHPAD_HID_REPORT_SIZE_MOUSE_BUTTONS] = { data[0] & 0x07 };
+
+	if (!idle_filter(MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS, boot_report, sizeof(boot_report))) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
 	// DEBUG: Analyze the BLE boot mouse data structure
 	if (size >= 1) {
 		uint8_t buttons = data[0] & 0x07;  // BLE boot mouse uses 3 bits for buttons
@@ -279,29 +710,36 @@ static uint8_t hogp_boot_mouse_report(struct bt_hogp *hogp,
 			(size >= 2) ? (int8_t)data[1] : 0);
 	}
 
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+	/* Boot mouse buttons (3 bits) map straight onto the combined report */
+	const uint8_t boot_buttons = data[0] & 0x07;
+	int ret = mouse_buttons_submit(&boot_buttons, sizeof(boot_buttons));
+#else
 	/* Forward boot mouse report directly to USB as Report ID 1 */
 	/* Convert BLE boot mouse format to USB HID Report ID 1 format */
-	uint8_t report_with_id[3];  // Report ID + Buttons + Wheel
-	report_with_id[0] = 1;  // Report ID 1 for boot mouse
+	uint8_t *payload = hid_tx_payload(MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS);
 
 	/* Convert BLE boot mouse buttons (3 bits) to USB HID buttons (5 bits) */
 	uint8_t ble_buttons = data[0] & 0x07;  // Extract 3 button bits from BLE
 	uint8_t usb_buttons = ble_buttons;      // Map directly (left=bit0, right=bit1, middle=bit2)
-	report_with_id[1] = usb_buttons;        // Buttons byte (5 bits used, 3 bits padding)
+	payload[0] = usb_buttons;               // Buttons byte (5 bits used, 3 bits padding)
 
-	/* Set wheel to 0 for now (BLE boot mouse doesn't have wheel in standard format) */
-	report_with_id[2] = 0x00;  // Wheel byte
+	/* Set wheel and AC pan to 0 (BLE boot mouse doesn't have them in standard format) */
+	payload[1] = 0x00;  // Wheel byte
+	payload[2] = 0x00;  // AC pan byte
 
 	/* Send directly to USB for zero latency */
-	int ret = hid_device_submit_report(hid_dev, 3, report_with_id);  // Always 3 bytes: Report ID + Buttons + Wheel
-	if (ret) {
+	int ret = hid_tx_submit(MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS);
+#endif
+	if (ret == -EAGAIN) {
+		LOG_DBG("USB busy, boot mouse report coalesced for retry");
+	} else if (ret) {
 		LOG_ERR("HID write error, %d", ret);
+		usb_hid_idle_forget(MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS);
 	} else {
 		LOG_DBG("Boot mouse report sent directly to USB");
 
-		/* Mark HID-specific data activity for LED indication */
-		extern void ble_transport_mark_hid_data_activity(void);
-		ble_transport_mark_hid_data_activity();
+		relay_activity_mark();
 	}
 
 	return BT_GATT_ITER_CONTINUE;
@@ -328,7 +766,7 @@ static uint8_t hogp_boot_kbd_report(struct bt_hogp *hogp,
 
 static void hogp_ready_cb(struct bt_hogp *hogp)
 {
-	k_work_submit(&hids_ready_work);
+	k_work_submit_to_queue(&relay_workq_realtime, &hids_ready_work);
 }
 
 /* Auto-detect and switch to optimal protocol mode */
@@ -581,6 +1019,13 @@ int ble_hid_discover(struct bt_conn *conn)
 	int err;
 	
 	LOG_INF("Starting HID service discovery...");
+
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+	/* Buttons held on the previous link must not stick to new motion */
+	k_mutex_lock(&motion_lock, K_FOREVER);
+	motion_acc.buttons = 0;
+	k_mutex_unlock(&motion_lock);
+#endif
 	
 	err = bt_gatt_dm_start(conn, BT_UUID_HIDS, &discovery_cb, &hogp);
 	if (err) {
@@ -596,14 +1041,109 @@ bool ble_hid_is_ready(void)
 	return hid_ready;
 }
 
+#if IS_ENABLED(CONFIG_HID_OUTPUT_REPORTS)
+/* Host output reports waiting for their BLE write, latest value per report
+ * ID. Filled from the USB stack thread, drained on the realtime work queue.
+ */
+static struct mouthpad_hid_output_queue output_queue;
+static struct k_spinlock output_lock;
+
+/* Retry delay when the stack has no TX buffer for the write */
+#define OUTPUT_RETRY_MS 5
+
+static void output_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(output_work, output_work_handler);
+
+static struct bt_hogp_rep_info *output_rep_find(uint8_t report_id)
+{
+	struct bt_hogp_rep_info *rep = NULL;
+
+	if (bt_hogp_pm_get(&hogp) == BT_HIDS_PM_BOOT) {
+		return report_id == MOUTHPAD_HID_REPORT_ID_KEYBOARD ? hogp.rep_boot.kbd_out : NULL;
+	}
+
+	while ((rep = bt_hogp_rep_next(&hogp, rep)) != NULL) {
+		if (bt_hogp_rep_type(rep) == BT_HIDS_REPORT_TYPE_OUTPUT &&
+		    bt_hogp_rep_id(rep) == report_id) {
+			return rep;
+		}
+	}
+	return NULL;
+}
+
+static void output_work_handler(struct k_work *work)
+{
+	uint8_t data[MOUTHPAD_HID_OUTPUT_SIZE_MAX];
+	uint8_t report_id;
+	uint8_t len;
+
+	ARG_UNUSED(work);
+
+	for (;;) {
+		k_spinlock_key_t key = k_spin_lock(&output_lock);
+
+		report_id = mouthpad_hid_output_take(&output_queue, data, &len);
+		k_spin_unlock(&output_lock, key);
+
+		if (report_id == 0) {
+			return;
+		}
+		if (!hid_ready) {
+			continue;
+		}
+
+		struct bt_hogp_rep_info *rep = output_rep_find(report_id);
+
+		if (rep == NULL) {
+			LOG_DBG("MouthPad has no output report %u", report_id);
+			continue;
+		}
+
+		int err = bt_hogp_rep_write_wo_rsp(&hogp, rep, data, len, hidc_write_cb);
+
+		if (err == -ENOMEM) {
+			key = k_spin_lock(&output_lock);
+			mouthpad_hid_output_retry(&output_queue, report_id, data, len);
+			k_spin_unlock(&output_lock, key);
+			k_work_reschedule_for_queue(&relay_workq_realtime, &output_work,
+						    K_MSEC(OUTPUT_RETRY_MS));
+			return;
+		}
+		if (err) {
+			LOG_WRN("Output report %u write failed (err %d)", report_id, err);
+		}
+	}
+}
+#endif /* CONFIG_HID_OUTPUT_REPORTS */
+
 int ble_hid_send_report(const uint8_t *data, uint16_t len)
 {
 	if (!hid_ready) {
 		return -EAGAIN;
 	}
-	
-	// Implementation would go here if needed
+
+#if IS_ENABLED(CONFIG_HID_OUTPUT_REPORTS)
+	if (len < 1) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&output_lock);
+	bool queued = mouthpad_hid_output_put(&output_queue, data[0], &data[1], len - 1);
+
+	k_spin_unlock(&output_lock, key);
+
+	if (!queued) {
+		return -EINVAL;
+	}
+
+	/* Leaves a pending retry where it is */
+	k_work_schedule_for_queue(&relay_workq_realtime, &output_work, K_NO_WAIT);
 	return 0;
+#else
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+	return -ENOTSUP;
+#endif
 }
 
 struct bt_hogp *ble_hid_get_hogp(void)
@@ -647,12 +1187,6 @@ void ble_hid_handle_buttons(uint32_t button_state, uint32_t has_changed)
 	/* For now, we can call this manually via ble_hid_auto_detect_mode() */
 }
 
-int ble_hid_register_data_received_cb(ble_hid_data_received_cb_t cb)
-{
-	data_received_callback = cb;
-	return 0;
-}
-
 int ble_hid_register_ready_cb(ble_hid_ready_cb_t cb)
 {
 	ready_callback = cb;
@@ -672,28 +1206,36 @@ int ble_hid_auto_detect_mode(void)
 	return 0;
 }
 
+int ble_hid_handles_assign(struct bt_gatt_dm *dm)
+{
+	bt_gatt_dm_data_print(dm);
+
+	int err = bt_hogp_handles_assign(dm, &hogp);
+	if (err) {
+		LOG_ERR("Could not assign HOGP handles (err %d)", err);
+		return err;
+	}
+
+	LOG_INF("HOGP handles assigned");
+	return 0;
+}
+
 /* Discovery callback implementations */
 static void discovery_completed_cb(struct bt_gatt_dm *dm, void *context)
 {
-	struct bt_hogp *hogp = context;
 	int err;
 
-	LOG_INF("The discovery procedure succeeded");
+	ARG_UNUSED(context);
 
-	bt_gatt_dm_data_print(dm);
+	LOG_INF("The discovery procedure succeeded");
 
-	err = bt_hogp_handles_assign(dm, hogp);
-	if (err) {
-		LOG_ERR("Could not assign HOGP handles (err %d)", err);
-	}
+	ble_hid_handles_assign(dm);
 
 	/* CRITICAL: Must release GATT DM data to allow subsequent discoveries */
 	err = bt_gatt_dm_data_release(dm);
 	if (err) {
 		LOG_ERR("Could not release discovery data (err %d)", err);
 	}
-
-	LOG_INF("HOGP ready");
 }
 
 static void discovery_service_not_found_cb(struct bt_conn *conn, void *context)
@@ -11,6 +11,7 @@
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/conn.h>
 #include <bluetooth/services/hogp.h>
+#include <bluetooth/gatt_dm.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,17 @@ int ble_hid_init(void);
  */
 int ble_hid_discover(struct bt_conn *conn);
 
+/**
+ * @brief Take the HOGP handles from a discovered HID service
+ *
+ * The ready callback fires once HOGP has read the report map and report
+ * references. The caller releases the discovery data.
+ *
+ * @param dm Discovery data for the HID service
+ * @return 0 on success, negative error code on failure
+ */
+int ble_hid_handles_assign(struct bt_gatt_dm *dm);
+
 /**
  * @brief Check if HID is ready for use
  * 
@@ -41,11 +53,17 @@ int ble_hid_discover(struct bt_conn *conn);
 bool ble_hid_is_ready(void);
 
 /**
- * @brief Send a HID report
- * 
- * @param data The report data to send
- * @param len The length of the report data
- * @return 0 on success, negative error code on failure
+ * @brief Queue a host output report for the MouthPad
+ *
+ * Returns at once; the report is written to the HOGP output report with
+ * the same ID as Write Without Response from the realtime work queue. An
+ * unsent report is replaced by a newer one with the same ID. Needs
+ * CONFIG_HID_OUTPUT_REPORTS.
+ *
+ * @param data Report ID, then the payload
+ * @param len The length of data
+ * @return 0 if queued, -EAGAIN if HID is not ready, -EINVAL if the ID has
+ *         no output report, -ENOTSUP without the option
  */
 int ble_hid_send_report(const uint8_t *data, uint16_t len);
 
@@ -86,24 +104,45 @@ uint8_t (*ble_hid_get_boot_kbd_cb(void))(struct bt_hogp *, struct bt_hogp_rep_in
 void ble_hid_handle_buttons(uint32_t button_state, uint32_t has_changed);
 
 /* Callback function types */
-typedef void (*ble_hid_data_received_cb_t)(const uint8_t *data, uint16_t len);
 typedef void (*ble_hid_ready_cb_t)(void);
 
 /**
- * @brief Register data received callback
+ * @brief Register ready callback
  *
- * @param cb Callback function for data received events
+ * @param cb Callback function for ready events
  * @return 0 on success, negative error code on failure
  */
-int ble_hid_register_data_received_cb(ble_hid_data_received_cb_t cb);
+int ble_hid_register_ready_cb(ble_hid_ready_cb_t cb);
+
+/**
+ * @brief Start feeding synthetic input reports for the bench command
+ *
+ * Injected reports take the same path to USB as HOGP notifications, from
+ * the caller's thread. Only allowed with no MouthPad connected, since the
+ * per-report USB buffers have a single writer.
+ *
+ * @return 0 on success, -EBUSY while a MouthPad is connected
+ */
+int ble_hid_inject_start(void);
 
 /**
- * @brief Register ready callback
+ * @brief Forward one synthetic input report to USB
  *
- * @param cb Callback function for ready events
- * @return 0 on success, negative error code on failure
+ * @param report_id Report ID as it would arrive over BLE
+ * @param data Report payload without the ID
+ * @param size Payload length
+ *
+ * @return 0 when submitted, -EAGAIN when motion was coalesced for a retry,
+ *         -EACCES while the host is suspended, -ENOTSUP for a report USB
+ *         cannot carry, -EPERM outside ble_hid_inject_start()/stop(), or
+ *         the submit error
  */
-int ble_hid_register_ready_cb(ble_hid_ready_cb_t cb);
+int ble_hid_inject_report(uint8_t report_id, const uint8_t *data, uint8_t size);
+
+/**
+ * @brief Stop injecting; motion still held for a retry is discarded
+ */
+void ble_hid_inject_stop(void);
 
 /**
  * @brief Manually trigger auto-detection and mode switching
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief L2CAP connection-oriented channel to the MouthPad for bulk data
+ *
+ * A MouthPad that listens for an LE credit-based channel says so with the
+ * bulk PSM characteristic next to its NUS characteristics. Once NUS is
+ * ready the PSM is read by UUID and the channel opened; SDUs of up to
+ * CONFIG_BLE_L2CAP_BULK_MTU bytes then go out segmented by the stack and
+ * paced by the MouthPad's credits, with neither an ATT header nor an ATT
+ * round trip per write. The bulk NUS stream (relay_nus_stream.c) moves onto
+ * the channel while it is open, and what the MouthPad sends on it is
+ * forwarded like a NUS notification. A MouthPad without the characteristic,
+ * or a channel that will not open, leaves everything on NUS.
+ *
+ * SDUs are sent from relay_workq_realtime and complete on the Bluetooth
+ * TX side, in order; the callbacks waiting for them are kept in a ring
+ * under a spinlock.
+ */
+
+#include <stdio.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/att.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/l2cap.h>
+#include <zephyr/bluetooth/uuid.h>
+
+#include "ble_l2cap_bulk.h"
+#include "relay_time.h"
+#include "relay_workq.h"
+
+LOG_MODULE_REGISTER(ble_l2cap_bulk, LOG_LEVEL_INF);
+
+#define BULK_TX_BUFS CONFIG_BLE_L2CAP_BULK_TX_BUFS
+
+#define BULK_BUF_SIZE BT_L2CAP_SDU_BUF_SIZE(CONFIG_BLE_L2CAP_BULK_MTU)
+
+NET_BUF_POOL_FIXED_DEFINE(bulk_tx_pool, BULK_TX_BUFS, BULK_BUF_SIZE,
+			  CONFIG_BT_CONN_TX_USER_DATA_SIZE, NULL);
+
+/* Each received SDU is handed on and freed before the next one completes */
+NET_BUF_POOL_FIXED_DEFINE(bulk_rx_pool, 2, BULK_BUF_SIZE, 0, NULL);
+
+static const struct bt_uuid_128 psm_uuid = BT_UUID_INIT_128(BLE_L2CAP_BULK_PSM_UUID_VAL);
+
+static struct bt_l2cap_le_chan bulk_chan;
+static struct bt_conn *bulk_conn;
+static uint16_t bulk_psm;
+static atomic_t bulk_open;
+static ble_l2cap_bulk_received_cb_t received_cb;
+
+static struct bt_gatt_read_params psm_read;
+
+static void connect_work_handler(struct k_work *work);
+
+static K_WORK_DEFINE(connect_work, connect_work_handler);
+
+/* Callbacks of the SDUs sent and not completed, oldest at head */
+static struct {
+	ble_l2cap_bulk_sent_cb_t cb;
+	int64_t issued;
+} pending[BULK_TX_BUFS];
+static size_t pending_head;
+static size_t pending_count;
+static struct k_spinlock pending_lock;
+
+/* Since boot, for the console */
+static uint32_t sdus_sent;
+static uint32_t sdus_failed;
+static uint32_t sdus_received;
+
+/* Remove the oldest pending SDU; false if there is none */
+static bool pending_pop(ble_l2cap_bulk_sent_cb_t *cb, int64_t *issued)
+{
+	k_spinlock_key_t key = k_spin_lock(&pending_lock);
+	bool found = pending_count > 0;
+
+	if (found) {
+		*cb = pending[pending_head].cb;
+		*issued = pending[pending_head].issued;
+		pending_head = (pending_head + 1) % BULK_TX_BUFS;
+		pending_count--;
+	}
+	k_spin_unlock(&pending_lock, key);
+
+	return found;
+}
+
+static void bulk_connected(struct bt_l2cap_chan *chan)
+{
+	ARG_UNUSED(chan);
+
+	atomic_set(&bulk_open, 1);
+	LOG_INF("Bulk channel open on PSM 0x%04x: tx mtu %u mps %u, rx mtu %u", bulk_psm,
+		bulk_chan.tx.mtu, bulk_chan.tx.mps, bulk_chan.rx.mtu);
+}
+
+static void bulk_disconnected(struct bt_l2cap_chan *chan)
+{
+	ble_l2cap_bulk_sent_cb_t cb;
+	int64_t issued;
+
+	ARG_UNUSED(chan);
+
+	if (atomic_set(&bulk_open, 0)) {
+		LOG_INF("Bulk channel closed; bulk data stays on NUS");
+	}
+
+	/* SDUs still queued in the stack went nowhere */
+	while (pending_pop(&cb, &issued)) {
+		sdus_failed++;
+		cb(BT_ATT_ERR_UNLIKELY, issued, relay_time_us64());
+	}
+}
+
+static void bulk_sent(struct bt_l2cap_chan *chan)
+{
+	ble_l2cap_bulk_sent_cb_t cb;
+	int64_t issued;
+
+	ARG_UNUSED(chan);
+
+	if (pending_pop(&cb, &issued)) {
+		sdus_sent++;
+		cb(0, issued, relay_time_us64());
+	}
+}
+
+static struct net_buf *bulk_alloc_buf(struct bt_l2cap_chan *chan)
+{
+	ARG_UNUSED(chan);
+
+	return net_buf_alloc(&bulk_rx_pool, K_NO_WAIT);
+}
+
+static int bulk_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+	ARG_UNUSED(chan);
+
+	sdus_received++;
+	if (received_cb) {
+		received_cb(buf->data, buf->len);
+	}
+
+	return 0;
+}
+
+static const struct bt_l2cap_chan_ops bulk_ops = {
+	.connected = bulk_connected,
+	.disconnected = bulk_disconnected,
+	.sent = bulk_sent,
+	.alloc_buf = bulk_alloc_buf,
+	.recv = bulk_recv,
+};
+
+static void connect_work_handler(struct k_work *work)
+{
+	int err;
+
+	ARG_UNUSED(work);
+
+	if (!bulk_conn) {
+		return;
+	}
+
+	bulk_chan = (struct bt_l2cap_le_chan){
+		.chan.ops = &bulk_ops,
+		.rx.mtu = CONFIG_BLE_L2CAP_BULK_MTU,
+	};
+
+	err = bt_l2cap_chan_connect(bulk_conn, &bulk_chan.chan, bulk_psm);
+	if (err) {
+		LOG_WRN("Bulk channel connect failed (err %d); staying on NUS", err);
+	}
+	bt_conn_unref(bulk_conn);
+	bulk_conn = NULL;
+}
+
+static uint8_t psm_read_cb(struct bt_conn *conn, uint8_t err, struct bt_gatt_read_params *params,
+			   const void *data, uint16_t length)
+{
+	ARG_UNUSED(params);
+
+	if (err) {
+		/* Attribute not found: a MouthPad without the bulk channel */
+		LOG_INF("No bulk PSM (ATT 0x%02x); bulk data stays on NUS", err);
+		return BT_GATT_ITER_STOP;
+	}
+
+	if (!data || length != sizeof(uint16_t)) {
+		return BT_GATT_ITER_STOP;
+	}
+
+	bulk_psm = sys_get_le16(data);
+	bulk_conn = bt_conn_ref(conn);
+	k_work_submit_to_queue(&relay_workq_protocol, &connect_work);
+
+	return BT_GATT_ITER_STOP;
+}
+
+void ble_l2cap_bulk_init(ble_l2cap_bulk_received_cb_t received)
+{
+	received_cb = received;
+}
+
+void ble_l2cap_bulk_connect(struct bt_conn *conn)
+{
+	int err;
+
+	if (atomic_get(&bulk_open) || bulk_conn) {
+		return;
+	}
+
+	psm_read = (struct bt_gatt_read_params){
+		.func = psm_read_cb,
+		.handle_count = 0,
+		.by_uuid = {
+			.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE,
+			.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE,
+			.uuid = &psm_uuid.uuid,
+		},
+	};
+
+	err = bt_gatt_read(conn, &psm_read);
+	if (err) {
+		LOG_WRN("Bulk PSM read failed (err %d); staying on NUS", err);
+	}
+}
+
+bool ble_l2cap_bulk_ready(void)
+{
+	return atomic_get(&bulk_open);
+}
+
+uint16_t ble_l2cap_bulk_sdu_len(void)
+{
+	if (!ble_l2cap_bulk_ready()) {
+		return 0;
+	}
+
+	return MIN(bulk_chan.tx.mtu, CONFIG_BLE_L2CAP_BULK_MTU);
+}
+
+int ble_l2cap_bulk_send(const uint8_t *data, uint16_t len, ble_l2cap_bulk_sent_cb_t cb)
+{
+	struct net_buf *buf;
+	k_spinlock_key_t key;
+	int err;
+
+	if (!ble_l2cap_bulk_ready()) {
+		return -ENOTCONN;
+	}
+
+	if (len > ble_l2cap_bulk_sdu_len()) {
+		return -EMSGSIZE;
+	}
+
+	buf = net_buf_alloc(&bulk_tx_pool, K_NO_WAIT);
+	if (!buf) {
+		return -ENOBUFS;
+	}
+	net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+	net_buf_add_mem(buf, data, len);
+
+	/* Queued before the send, as the SDU may complete before it returns */
+	key = k_spin_lock(&pending_lock);
+	pending[(pending_head + pending_count) % BULK_TX_BUFS].cb = cb;
+	pending[(pending_head + pending_count) % BULK_TX_BUFS].issued = relay_time_us64();
+	pending_count++;
+	k_spin_unlock(&pending_lock, key);
+
+	err = bt_l2cap_chan_send(&bulk_chan.chan, buf);
+	if (err < 0) {
+		/* Not queued, so no completion comes for it: take it back */
+		key = k_spin_lock(&pending_lock);
+		if (pending_count > 0) {
+			pending_count--;
+		}
+		k_spin_unlock(&pending_lock, key);
+		net_buf_unref(buf);
+		return err;
+	}
+
+	return 0;
+}
+
+size_t ble_l2cap_bulk_pending(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&pending_lock);
+	size_t count = pending_count;
+
+	k_spin_unlock(&pending_lock, key);
+
+	return count;
+}
+
+int ble_l2cap_bulk_format(char *buf, size_t len)
+{
+	if (!ble_l2cap_bulk_ready()) {
+		return snprintf(buf, len, "l2cap: closed, bulk on NUS; sent %u failed %u received %u",
+				sdus_sent, sdus_failed, sdus_received);
+	}
+
+	return snprintf(buf, len,
+			"l2cap: PSM 0x%04x sdu %u credits %ld; sent %u failed %u received %u pending %u",
+			bulk_psm, ble_l2cap_bulk_sdu_len(), (long)atomic_get(&bulk_chan.tx.credits),
+			sdus_sent, sdus_failed, sdus_received, (unsigned int)ble_l2cap_bulk_pending());
+}
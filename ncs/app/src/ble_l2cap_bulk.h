@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BLE_L2CAP_BULK_H_
+#define BLE_L2CAP_BULK_H_
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/bluetooth/conn.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* MouthPad bulk PSM characteristic: a uint16 LE PSM the MouthPad listens
+ * on, next to the NUS characteristics (NUS base UUID, 0x0004)
+ */
+#define BLE_L2CAP_BULK_PSM_UUID_VAL \
+	BT_UUID_128_ENCODE(0x6e400004, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+
+/* Completion of one bulk write, as ble_nus_timed_callback_t */
+typedef void (*ble_l2cap_bulk_sent_cb_t)(uint8_t err, int64_t issued, int64_t completed);
+
+/* Data the MouthPad sent on the channel, one SDU per call */
+typedef void (*ble_l2cap_bulk_received_cb_t)(const uint8_t *data, uint16_t len);
+
+#if defined(CONFIG_BLE_L2CAP_BULK)
+
+/**
+ * @brief Set where received SDUs go; call once before the first connection
+ */
+void ble_l2cap_bulk_init(ble_l2cap_bulk_received_cb_t received);
+
+/**
+ * @brief NUS is ready: look for the bulk PSM and open the channel
+ *
+ * Reads the PSM characteristic by UUID; without one the MouthPad stays on
+ * NUS and nothing more happens on this connection.
+ *
+ * @param conn The primary MouthPad link
+ */
+void ble_l2cap_bulk_connect(struct bt_conn *conn);
+
+/**
+ * @brief Whether the channel is open
+ */
+bool ble_l2cap_bulk_ready(void);
+
+/**
+ * @brief Largest SDU to send: the MouthPad's MTU, capped at
+ *        CONFIG_BLE_L2CAP_BULK_MTU; 0 while the channel is closed
+ */
+uint16_t ble_l2cap_bulk_sdu_len(void);
+
+/**
+ * @brief Send one SDU
+ *
+ * cb is called exactly once if this returns 0, in the order the SDUs were
+ * sent, and with an error for those still queued when the channel closes.
+ *
+ * @return 0, -ENOBUFS while every TX buffer is taken, -ENOTCONN while the
+ *         channel is closed, or another error from the stack
+ */
+int ble_l2cap_bulk_send(const uint8_t *data, uint16_t len, ble_l2cap_bulk_sent_cb_t cb);
+
+/**
+ * @brief SDUs sent and not completed yet
+ */
+size_t ble_l2cap_bulk_pending(void);
+
+/**
+ * @brief Channel state and counts as one console line
+ *
+ * @return Characters written, as snprintf, or -ENOTSUP without
+ *         CONFIG_BLE_L2CAP_BULK
+ */
+int ble_l2cap_bulk_format(char *buf, size_t len);
+
+#else
+
+static inline void ble_l2cap_bulk_init(ble_l2cap_bulk_received_cb_t received)
+{
+	ARG_UNUSED(received);
+}
+
+static inline void ble_l2cap_bulk_connect(struct bt_conn *conn)
+{
+	ARG_UNUSED(conn);
+}
+
+static inline bool ble_l2cap_bulk_ready(void)
+{
+	return false;
+}
+
+static inline uint16_t ble_l2cap_bulk_sdu_len(void)
+{
+	return 0;
+}
+
+static inline int ble_l2cap_bulk_send(const uint8_t *data, uint16_t len,
+				      ble_l2cap_bulk_sent_cb_t cb)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+	ARG_UNUSED(cb);
+	return -ENOTSUP;
+}
+
+static inline size_t ble_l2cap_bulk_pending(void)
+{
+	return 0;
+}
+
+static inline int ble_l2cap_bulk_format(char *buf, size_t len)
+{
+	ARG_UNUSED(buf);
+	ARG_UNUSED(len);
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_BLE_L2CAP_BULK */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_L2CAP_BULK_H_ */
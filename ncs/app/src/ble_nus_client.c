@@ -6,15 +6,23 @@
  */
 
 #include "ble_nus_client.h"
+#include "mem_stats.h"
+#include "relay_probe.h"
+#include "relay_sysview.h"
+#include "relay_time.h"
+#include "relay_workq.h"
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/att.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/gatt.h>
 #include <bluetooth/services/nus_client.h>
 #include <bluetooth/services/nus.h>
 #include <bluetooth/gatt_dm.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <string.h>
 
 LOG_MODULE_REGISTER(ble_nus_client, LOG_LEVEL_INF);
 
@@ -27,12 +35,55 @@ static ble_nus_data_sent_cb_t data_sent_cb;
 static ble_nus_mtu_exchange_cb_t mtu_exchange_cb;
 static ble_nus_discovery_complete_cb_t discovery_complete_cb;
 
-/* Semaphore for NUS write operations */
-K_SEM_DEFINE(nus_write_sem, 0, 1);
+/* Writes are issued straight to GATT rather than through bt_nus_client_send,
+ * which allows only one in flight. Each slot owns its data and write params
+ * until the write completes.
+ */
+#define NUS_TX_INFLIGHT_MAX CONFIG_BT_ATT_TX_COUNT
+#define NUS_TX_SLOTS (CONFIG_BLE_NUS_TX_QUEUE_DEPTH + NUS_TX_INFLIGHT_MAX)
+
+/* Slots a bulk stream write may not take while another is outstanding, so
+ * a control write finds one while the stream keeps the rest full. The
+ * stream resumes on its next completion, so with none outstanding it may
+ * take any slot.
+ */
+#define NUS_TX_CONTROL_RESERVE 2
+
+BUILD_ASSERT(NUS_TX_SLOTS > NUS_TX_CONTROL_RESERVE, "No NUS write slots left for the stream");
+
+struct nus_tx_slot {
+	struct bt_gatt_write_params params;
+	ble_nus_timed_sent_cb_t timed_cb; /* Timed or stream write; NULL: report to data_sent_cb */
+	struct pass_through_ack_tag ack; /* Handed to data_sent_cb */
+	int64_t issued;
+	uint16_t len;
+	bool reliable;
+	bool bulk;
+	uint8_t data[BLE_NUS_CLIENT_TX_MAX_LEN];
+};
+
+K_MEM_SLAB_DEFINE_STATIC(nus_tx_slab, sizeof(struct nus_tx_slot), NUS_TX_SLOTS, 4);
+
+/* Filled slots waiting for an ATT TX buffer, oldest first. Pass-through,
+ * echo and other control writes are handed to GATT ahead of any queued
+ * stream write, so a host command waits for at most the writes already in
+ * flight rather than the whole stream backlog. Each class keeps its order.
+ */
+K_MSGQ_DEFINE(nus_tx_control_msgq, sizeof(struct nus_tx_slot *), NUS_TX_SLOTS, 4);
+K_MSGQ_DEFINE(nus_tx_bulk_msgq, sizeof(struct nus_tx_slot *), NUS_TX_SLOTS, 4);
+
+/* Writes handed to GATT and not yet completed */
+static atomic_t nus_tx_inflight;
+
+/* Stream writes queued or in flight */
+static atomic_t nus_tx_bulk;
+
+static void nus_tx_work_handler(struct k_work *work);
+
+static K_WORK_DEFINE(nus_tx_work, nus_tx_work_handler);
 
 /* NUS Client callbacks */
 static uint8_t nus_data_received(struct bt_nus_client *nus, const uint8_t *data, uint16_t len);
-static void nus_data_sent(struct bt_nus_client *nus, uint8_t err, const uint8_t *const data, uint16_t len);
 
 /* Discovery callbacks */
 static void discovery_complete(struct bt_gatt_dm *dm, void *context);
@@ -62,36 +113,116 @@ static uint8_t nus_data_received(struct bt_nus_client *nus, const uint8_t *data,
 	return BT_GATT_ITER_CONTINUE;
 }
 
-static void nus_data_sent(struct bt_nus_client *nus, uint8_t err, const uint8_t *const data, uint16_t len)
+/* Free the slot, report the result and refill the freed ATT TX buffer */
+static void nus_tx_complete(struct nus_tx_slot *slot, uint8_t err)
 {
-	ARG_UNUSED(nus);
-	ARG_UNUSED(data);
-	ARG_UNUSED(len);
+	int64_t completed = relay_time_us64();
+	ble_nus_timed_sent_cb_t timed_cb = slot->timed_cb;
+	struct pass_through_ack_tag ack = slot->ack;
+	int64_t issued = slot->issued;
 
-	k_sem_give(&nus_write_sem);
+	if (slot->bulk) {
+		atomic_dec(&nus_tx_bulk);
+	}
+	k_mem_slab_free(&nus_tx_slab, slot);
+	atomic_dec(&nus_tx_inflight);
 
 	if (err) {
 		LOG_WRN("ATT error code: 0x%02X", err);
 	}
 
-	// Call external data sent callback if registered
-	if (data_sent_cb) {
-		data_sent_cb(err);
+	if (timed_cb) {
+		timed_cb(err, issued, completed);
+	} else if (data_sent_cb) {
+		// Call external data sent callback if registered
+		data_sent_cb(err, ack);
 	}
+
+	k_work_submit_to_queue(&relay_workq_realtime, &nus_tx_work);
 }
 
-/* Discovery callback implementations */
-static void discovery_complete(struct bt_gatt_dm *dm, void *context)
+static void nus_write_rsp(struct bt_conn *conn, uint8_t err, struct bt_gatt_write_params *params)
 {
-	struct bt_nus_client *nus = context;
-	LOG_INF("Service discovery completed");
+	ARG_UNUSED(conn);
 
-	bt_gatt_dm_data_print(dm);
+	nus_tx_complete(CONTAINER_OF(params, struct nus_tx_slot, params), err);
+}
+
+static void nus_write_cmd_sent(struct bt_conn *conn, void *user_data)
+{
+	ARG_UNUSED(conn);
 
-	bt_nus_handles_assign(dm, nus);
-	bt_nus_subscribe_receive(nus);
+	nus_tx_complete(user_data, 0);
+}
 
-	bt_gatt_dm_data_release(dm);
+static int nus_tx_issue(struct nus_tx_slot *slot)
+{
+	if (!nus_client.conn) {
+		return -ENOTCONN;
+	}
+
+	slot->issued = relay_time_us64();
+	if (slot->reliable) {
+		slot->params.func = nus_write_rsp;
+		slot->params.handle = nus_client.handles.rx;
+		slot->params.offset = 0;
+		slot->params.data = slot->data;
+		slot->params.length = slot->len;
+#if defined(CONFIG_BT_EATT)
+		/* The unenhanced bearer takes one request at a time and also
+		 * carries HOGP, BAS and DIS; once Enhanced ATT bearers are up,
+		 * keep write requests on those so neither waits for the other
+		 */
+		slot->params.chan_opt = bt_eatt_count(nus_client.conn) > 0 ?
+					BT_ATT_CHAN_OPT_ENHANCED_ONLY : BT_ATT_CHAN_OPT_NONE;
+#endif
+		return bt_gatt_write(nus_client.conn, &slot->params);
+	}
+
+	/* Completes once the command has been sent, so up to
+	 * NUS_TX_INFLIGHT_MAX share each connection event
+	 */
+	return bt_gatt_write_without_response_cb(nus_client.conn, nus_client.handles.rx,
+						 slot->data, slot->len, false,
+						 nus_write_cmd_sent, slot);
+}
+
+/* Next write to hand to GATT: control writes first */
+static int nus_tx_next(struct nus_tx_slot **slot)
+{
+	if (k_msgq_get(&nus_tx_control_msgq, slot, K_NO_WAIT) == 0) {
+		return 0;
+	}
+	return k_msgq_get(&nus_tx_bulk_msgq, slot, K_NO_WAIT);
+}
+
+/* Hand queued writes to GATT while ATT TX buffers are free. Runs only on
+ * the real-time work queue, so the in-flight check and increment cannot race.
+ */
+static void nus_tx_work_handler(struct k_work *work)
+{
+	struct nus_tx_slot *slot;
+
+	ARG_UNUSED(work);
+
+	while (atomic_get(&nus_tx_inflight) < NUS_TX_INFLIGHT_MAX && nus_tx_next(&slot) == 0) {
+		atomic_inc(&nus_tx_inflight);
+
+		relay_probe(RELAY_PROBE_NUS_TX);
+		relay_sysview_mark_start(RELAY_MARKER_NUS_TX);
+		int err = nus_tx_issue(slot);
+		relay_sysview_mark_stop(RELAY_MARKER_NUS_TX);
+
+		if (err) {
+			LOG_WRN("NUS write failed (err %d)", err);
+			nus_tx_complete(slot, BT_ATT_ERR_UNLIKELY);
+		}
+	}
+}
+
+static void handles_ready(void)
+{
+	bt_nus_subscribe_receive(&nus_client);
 
 	// Call external discovery complete callback if registered
 	if (discovery_complete_cb) {
@@ -99,6 +230,38 @@ static void discovery_complete(struct bt_gatt_dm *dm, void *context)
 	}
 }
 
+void ble_nus_client_handles_assign(struct bt_gatt_dm *dm)
+{
+	bt_gatt_dm_data_print(dm);
+
+	bt_nus_handles_assign(dm, &nus_client);
+	handles_ready();
+}
+
+void ble_nus_client_handles_get(struct bt_nus_client_handles *handles)
+{
+	*handles = nus_client.handles;
+}
+
+void ble_nus_client_handles_set(struct bt_conn *conn, const struct bt_nus_client_handles *handles)
+{
+	/* Everything bt_nus_handles_assign() would take from the discovery */
+	nus_client.conn = conn;
+	nus_client.handles = *handles;
+	handles_ready();
+}
+
+/* Discovery callback implementations */
+static void discovery_complete(struct bt_gatt_dm *dm, void *context)
+{
+	ARG_UNUSED(context);
+	LOG_INF("Service discovery completed");
+
+	ble_nus_client_handles_assign(dm);
+
+	bt_gatt_dm_data_release(dm);
+}
+
 static void discovery_service_not_found(struct bt_conn *conn, void *context)
 {
 	LOG_INF("Service not found");
@@ -135,7 +298,6 @@ int ble_nus_client_init(void)
 	struct bt_nus_client_init_param init = {
 		.cb = {
 			.received = nus_data_received,
-			.sent = nus_data_sent,
 		}
 	};
 
@@ -149,13 +311,111 @@ int ble_nus_client_init(void)
 	return err;
 }
 
-int ble_nus_client_send_data(const uint8_t *data, uint16_t len)
+static int nus_tx_queue(const uint8_t *data, uint16_t len, bool reliable, bool bulk,
+			ble_nus_timed_sent_cb_t timed_cb, struct pass_through_ack_tag ack)
 {
+	struct nus_tx_slot *slot;
+
 	if (!data || len == 0) {
 		return -EINVAL;
 	}
 
-	return bt_nus_client_send(&nus_client, data, len);
+	if (len > sizeof(slot->data)) {
+		return -EMSGSIZE;
+	}
+
+	if ((bulk && atomic_get(&nus_tx_bulk) > 0 &&
+	     k_mem_slab_num_free_get(&nus_tx_slab) <= NUS_TX_CONTROL_RESERVE) ||
+	    k_mem_slab_alloc(&nus_tx_slab, (void **)&slot, K_NO_WAIT) != 0) {
+		mem_stats_take(MEM_SITE_NUS_TX, false, 0);
+		return -ENOBUFS;
+	}
+	mem_stats_take(MEM_SITE_NUS_TX, true, k_mem_slab_num_used_get(&nus_tx_slab));
+
+	slot->timed_cb = timed_cb;
+	slot->ack = ack;
+	slot->issued = 0;
+	slot->len = len;
+	slot->reliable = reliable;
+	slot->bulk = bulk;
+	if (bulk) {
+		atomic_inc(&nus_tx_bulk);
+	}
+	memcpy(slot->data, data, len);
+
+	/* Cannot fail: each queue has room for every slot */
+	k_msgq_put(bulk ? &nus_tx_bulk_msgq : &nus_tx_control_msgq, &slot, K_NO_WAIT);
+
+	k_work_submit_to_queue(&relay_workq_realtime, &nus_tx_work);
+	return 0;
+}
+
+int ble_nus_client_send_data(const uint8_t *data, uint16_t len, bool reliable,
+			     struct pass_through_ack_tag ack)
+{
+	return nus_tx_queue(data, len, reliable, false, NULL, ack);
+}
+
+int ble_nus_client_send_timed(const uint8_t *data, uint16_t len, ble_nus_timed_sent_cb_t cb)
+{
+	return nus_tx_queue(data, len, true, false, cb, (struct pass_through_ack_tag){ 0 });
+}
+
+int ble_nus_client_send_stream(const uint8_t *data, uint16_t len, ble_nus_timed_sent_cb_t cb)
+{
+	return nus_tx_queue(data, len, false, true, cb, (struct pass_through_ack_tag){ 0 });
+}
+
+void ble_nus_client_reset_tx(void)
+{
+	struct nus_tx_slot *slot;
+
+	/* Writes in flight complete with an error on disconnect */
+	while (nus_tx_next(&slot) == 0) {
+		ble_nus_timed_sent_cb_t timed_cb = slot->timed_cb;
+
+		if (slot->bulk) {
+			atomic_dec(&nus_tx_bulk);
+		}
+		k_mem_slab_free(&nus_tx_slab, slot);
+		if (timed_cb) {
+			timed_cb(BT_ATT_ERR_UNLIKELY, 0, relay_time_us64());
+		}
+	}
+}
+
+uint8_t ble_nus_client_tx_window(void)
+{
+	/* Every slot: queued plus in flight */
+	return NUS_TX_SLOTS;
+}
+
+uint8_t ble_nus_client_tx_pending(void)
+{
+	return k_mem_slab_num_used_get(&nus_tx_slab);
+}
+
+size_t ble_nus_client_tx_slot_size(void)
+{
+	return sizeof(struct nus_tx_slot);
+}
+
+uint8_t ble_nus_client_stream_pending(void)
+{
+	return atomic_get(&nus_tx_bulk);
+}
+
+uint32_t ble_nus_client_att_bearers(void)
+{
+	if (!nus_client.conn) {
+		return 0;
+	}
+
+#if defined(CONFIG_BT_EATT)
+	return 1 + bt_eatt_count(nus_client.conn);
+#else
+	return 1;
+#endif
 }
 
 void ble_nus_client_discover(struct bt_conn *conn)
@@ -206,6 +466,16 @@ int ble_nus_client_exchange_mtu(struct bt_conn *conn)
 	exchange_params.func = exchange_func;
 	// Request maximum MTU (247 bytes) to handle bigger packets
 	err = bt_gatt_exchange_mtu(conn, &exchange_params);
+	if (err == -EALREADY) {
+		/* A promoted hot-standby link exchanged its MTU while secondary */
+		uint16_t mtu = bt_gatt_get_mtu(conn);
+
+		LOG_INF("MTU already exchanged: MTU = %d bytes", mtu);
+		if (mtu_exchange_cb) {
+			mtu_exchange_cb(mtu);
+		}
+		return 0;
+	}
 	if (err) {
 		LOG_WRN("MTU exchange failed (err %d)", err);
 	}
@@ -15,16 +15,83 @@
 #include <bluetooth/services/nus_client.h>
 #include <bluetooth/gatt_dm.h>
 
+#include "pass_through_ack.h"
+
+/* Largest NUS write: 247 byte ATT MTU less the write request header */
+#define BLE_NUS_CLIENT_TX_MAX_LEN 244
+
 /* NUS Client initialization and control functions */
 int ble_nus_client_init(void);
-int ble_nus_client_send_data(const uint8_t *data, uint16_t len);
+
+/* Queue a write to the NUS RX characteristic. Up to CONFIG_BT_ATT_TX_COUNT
+ * writes are outstanding at once and each completion is reported to the
+ * data sent callback, with ack. Unless reliable is set the write is sent
+ * without response. Returns -ENOBUFS if every slot is in use.
+ */
+int ble_nus_client_send_data(const uint8_t *data, uint16_t len, bool reliable,
+			     struct pass_through_ack_tag ack);
+
+/* Completion of a timed write: err is an ATT error code, 0 on success;
+ * issued and completed are relay_time_us64(), issued 0 if it never went out
+ */
+typedef void (*ble_nus_timed_sent_cb_t)(uint8_t err, int64_t issued, int64_t completed);
+
+/* Queue an acknowledged write like ble_nus_client_send_data, but report its
+ * completion to cb, not the data sent callback, with when it was handed to
+ * GATT and when its write response arrived. Dropping the queue reports it
+ * failed, so cb is always called once.
+ */
+int ble_nus_client_send_timed(const uint8_t *data, uint16_t len, ble_nus_timed_sent_cb_t cb);
+
+/* Queue a write without response like ble_nus_client_send_data, but report
+ * its completion to cb, not the data sent callback. For the bulk stream
+ * (nus_stream.h); completions arrive in the order the writes were queued,
+ * and dropping the queue reports them failed. Stream writes go out after
+ * any queued data or timed write, and while one is outstanding the next
+ * leaves a couple of slots free for those, returning -ENOBUFS instead.
+ */
+int ble_nus_client_send_stream(const uint8_t *data, uint16_t len, ble_nus_timed_sent_cb_t cb);
+
+/* Drop queued writes, e.g. on disconnect */
+void ble_nus_client_reset_tx(void);
+
+/* Writes that can be outstanding at once: queued plus in flight */
+uint8_t ble_nus_client_tx_window(void);
+
+/* Writes outstanding right now: queued plus in flight */
+uint8_t ble_nus_client_tx_pending(void);
+
+/* Stream writes outstanding right now: queued plus in flight */
+uint8_t ble_nus_client_stream_pending(void);
+
+/* Bytes per write slot, for the memory report */
+size_t ble_nus_client_tx_slot_size(void);
+
+/* ATT bearers open to the MouthPad: the unenhanced one plus any Enhanced
+ * ATT ones (CONFIG_BT_EATT); 0 before NUS has a connection. Write requests
+ * use only the enhanced ones while there are any.
+ */
+uint32_t ble_nus_client_att_bearers(void);
 
 /* Service discovery */
 void ble_nus_client_discover(struct bt_conn *conn);
 
+/* Take the handles from a discovered NUS service, subscribe to notifications
+ * and invoke the discovery complete callback. The caller releases the data.
+ */
+void ble_nus_client_handles_assign(struct bt_gatt_dm *dm);
+
+/* Handles of the current NUS service, e.g. for the GATT handle cache */
+void ble_nus_client_handles_get(struct bt_nus_client_handles *handles);
+
+/* Use previously discovered handles without running discovery; subscribes
+ * and invokes the discovery complete callback like handles_assign
+ */
+void ble_nus_client_handles_set(struct bt_conn *conn, const struct bt_nus_client_handles *handles);
+
 /* Callback registration for external modules */
 typedef void (*ble_nus_data_received_cb_t)(const uint8_t *data, uint16_t len);
-typedef void (*ble_nus_data_sent_cb_t)(uint8_t err);
+typedef void (*ble_nus_data_sent_cb_t)(uint8_t err, struct pass_through_ack_tag ack);
 
 void ble_nus_client_register_data_received_cb(ble_nus_data_received_cb_t cb);
 void ble_nus_client_register_data_sent_cb(ble_nus_data_sent_cb_t cb);
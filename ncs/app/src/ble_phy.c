@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief PHY of the primary link chosen from its smoothed RSSI
+ *
+ * The link starts on 2M, which halves the airtime of every packet, and
+ * steps down to 1M and then Coded S2 as the smoothed RSSI from the
+ * transport's periodic reads falls, trading speed for range. Each step
+ * has a floor:
+ *
+ *   2M     down to 1M below CONFIG_BLE_PHY_2M_MIN_RSSI
+ *   1M     down to Coded S2 below CONFIG_BLE_PHY_1M_MIN_RSSI
+ *
+ * and the link steps back up only once the RSSI is CONFIG_BLE_PHY_HYSTERESIS
+ * dB above the floor it fell through. No change is asked for within
+ * CONFIG_BLE_PHY_DWELL_MS of the last one, so a user moving about the edge
+ * of a band does not flap between PHYs. A PHY the MouthPad has not taken
+ * by the end of that time is not asked for again on this connection.
+ * While the link guard (link_guard.h) expects the link to drop, each
+ * reading steps one PHY toward range at once, whatever the RSSI.
+ *
+ * The readings arrive on relay_workq_background; the PHY update callback
+ * runs on the Bluetooth RX thread, so the shared state is atomic.
+ */
+
+#include <stdio.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gap.h>
+
+#include "ble_phy.h"
+#include "ble_central.h"
+
+LOG_MODULE_REGISTER(ble_phy, LOG_LEVEL_INF);
+
+BUILD_ASSERT(CONFIG_BLE_PHY_1M_MIN_RSSI < CONFIG_BLE_PHY_2M_MIN_RSSI,
+	     "The 1M floor must lie below the 2M floor");
+
+/* From the fastest PHY to the longest range */
+enum phy_step {
+	PHY_STEP_2M,
+	PHY_STEP_1M,
+	PHY_STEP_CODED,
+	PHY_STEP_COUNT,
+	PHY_STEP_NONE = PHY_STEP_COUNT,
+};
+
+static const struct {
+	const char *name;
+	uint8_t phy; /* BT_GAP_LE_PHY_* */
+	uint16_t options; /* BT_CONN_LE_PHY_OPT_* */
+} steps[PHY_STEP_COUNT] = {
+	[PHY_STEP_2M] = { "2M", BT_GAP_LE_PHY_2M, BT_CONN_LE_PHY_OPT_NONE },
+	[PHY_STEP_1M] = { "1M", BT_GAP_LE_PHY_1M, BT_CONN_LE_PHY_OPT_NONE },
+	[PHY_STEP_CODED] = { "Coded S2", BT_GAP_LE_PHY_CODED, BT_CONN_LE_PHY_OPT_CODED_S2 },
+};
+
+/* Lowest RSSI each step is kept at; Coded has none */
+static const int8_t step_floor[PHY_STEP_CODED] = {
+	[PHY_STEP_2M] = CONFIG_BLE_PHY_2M_MIN_RSSI,
+	[PHY_STEP_1M] = CONFIG_BLE_PHY_1M_MIN_RSSI,
+};
+
+static atomic_t active;
+static atomic_t current = ATOMIC_INIT(PHY_STEP_1M); /* Every link starts on 1M */
+static atomic_t requested = ATOMIC_INIT(PHY_STEP_NONE);
+static atomic_t requested_ms; /* Uptime of the last request */
+static atomic_t refused; /* BIT(step) for each step the MouthPad did not take */
+static atomic_t switches;
+
+static enum phy_step step_of(uint8_t phy)
+{
+	switch (phy) {
+	case BT_GAP_LE_PHY_2M:
+		return PHY_STEP_2M;
+	case BT_GAP_LE_PHY_CODED:
+		return PHY_STEP_CODED;
+	default:
+		return PHY_STEP_1M;
+	}
+}
+
+static enum phy_step wanted_step(enum phy_step step, int8_t rssi)
+{
+	while (step < PHY_STEP_CODED && rssi < step_floor[step]) {
+		step++;
+	}
+	while (step > PHY_STEP_2M &&
+	       rssi >= step_floor[step - 1] + CONFIG_BLE_PHY_HYSTERESIS) {
+		step--;
+	}
+	return step;
+}
+
+static void request_step(struct bt_conn *conn, enum phy_step step)
+{
+	struct bt_conn_le_phy_param param = {
+		.options = steps[step].options,
+		.pref_tx_phy = steps[step].phy,
+		.pref_rx_phy = steps[step].phy,
+	};
+	int err;
+
+	atomic_set(&requested, step);
+	atomic_set(&requested_ms, (atomic_val_t)k_uptime_get_32());
+
+	err = bt_conn_le_phy_update(conn, &param);
+	if (err) {
+		LOG_WRN("Failed to request %s PHY (err %d)", steps[step].name, err);
+	}
+}
+
+void ble_phy_connected(struct bt_conn *conn)
+{
+	atomic_set(&current, PHY_STEP_1M);
+	atomic_clear(&refused);
+	atomic_set(&active, 1);
+
+	request_step(conn, PHY_STEP_2M);
+}
+
+void ble_phy_disconnected(void)
+{
+	atomic_clear(&active);
+	atomic_set(&requested, PHY_STEP_NONE);
+}
+
+void ble_phy_rssi(int8_t rssi, bool at_risk)
+{
+	struct bt_conn *conn = ble_central_get_default_conn();
+	enum phy_step step = (enum phy_step)atomic_get(&current);
+	enum phy_step pending = (enum phy_step)atomic_get(&requested);
+	uint32_t held = k_uptime_get_32() - (uint32_t)atomic_get(&requested_ms);
+	bool in_flight = pending != PHY_STEP_NONE && pending != step;
+	enum phy_step want;
+
+	if (!conn || !atomic_get(&active)) {
+		return;
+	}
+	if (held < CONFIG_BLE_PHY_DWELL_MS) {
+		if (!at_risk || in_flight) {
+			return;
+		}
+	} else if (in_flight) {
+		LOG_WRN("MouthPad did not take %s PHY, not asking again", steps[pending].name);
+		atomic_or(&refused, BIT(pending));
+	}
+	atomic_set(&requested, PHY_STEP_NONE);
+
+	want = wanted_step(step, rssi);
+	if (at_risk && want <= step && step < PHY_STEP_CODED) {
+		want = step + 1;
+	}
+
+	/* Stop short of a step the MouthPad did not take */
+	while (want != step && (atomic_get(&refused) & BIT(want))) {
+		want += want > step ? -1 : 1;
+	}
+	if (want == step) {
+		return;
+	}
+
+	LOG_INF("RSSI %d dBm%s: %s -> %s PHY", rssi, at_risk ? " (at risk)" : "",
+		steps[step].name, steps[want].name);
+	request_step(conn, want);
+}
+
+int ble_phy_format(char *buf, size_t len)
+{
+	enum phy_step step = (enum phy_step)atomic_get(&current);
+	atomic_val_t refused_mask = atomic_get(&refused);
+
+	return snprintf(buf, len, "phy: %s, %u switches%s%s%s",
+			atomic_get(&active) ? steps[step].name : "not connected",
+			(unsigned int)atomic_get(&switches),
+			refused_mask ? ", refused" : "",
+			(refused_mask & BIT(PHY_STEP_2M)) ? " 2M" : "",
+			(refused_mask & BIT(PHY_STEP_CODED)) ? " Coded" : "");
+}
+
+static void le_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *param)
+{
+	enum phy_step step;
+
+	if (conn != ble_central_get_default_conn()) {
+		return;
+	}
+
+	step = step_of(param->tx_phy);
+	if (atomic_set(&current, step) != step) {
+		atomic_inc(&switches);
+	}
+	LOG_INF("PHY updated: TX %s, RX %s", steps[step].name, steps[step_of(param->rx_phy)].name);
+}
+
+BT_CONN_CB_DEFINE(phy_callbacks) = {
+	.le_phy_updated = le_phy_updated,
+};
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BLE_PHY_H_
+#define BLE_PHY_H_
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/bluetooth/conn.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_BLE_PHY_ADAPTIVE)
+
+/**
+ * @brief Start managing the PHY of a new primary connection
+ *
+ * Requests 2M; the RSSI readings move it from there.
+ *
+ * @param conn Newly established connection
+ */
+void ble_phy_connected(struct bt_conn *conn);
+
+/**
+ * @brief Stop managing the PHY
+ *
+ * Call on disconnect.
+ */
+void ble_phy_disconnected(void);
+
+/**
+ * @brief Feed one smoothed RSSI reading of the primary connection
+ *
+ * Requests a PHY change when the reading crosses a threshold and the
+ * current PHY has been held for CONFIG_BLE_PHY_DWELL_MS. While the link is
+ * at risk (link_guard.h) each reading steps one PHY toward range instead,
+ * without waiting.
+ *
+ * @param rssi Smoothed connection RSSI in dBm
+ * @param at_risk The link guard expects the link to drop
+ */
+void ble_phy_rssi(int8_t rssi, bool at_risk);
+
+/**
+ * @brief PHY state and switch count as one console line
+ *
+ * @return Characters written, as snprintf, or -ENOTSUP without
+ *         CONFIG_BLE_PHY_ADAPTIVE
+ */
+int ble_phy_format(char *buf, size_t len);
+
+#else
+
+static inline void ble_phy_connected(struct bt_conn *conn)
+{
+	ARG_UNUSED(conn);
+}
+
+static inline void ble_phy_disconnected(void)
+{
+}
+
+static inline void ble_phy_rssi(int8_t rssi, bool at_risk)
+{
+	ARG_UNUSED(rssi);
+	ARG_UNUSED(at_risk);
+}
+
+static inline int ble_phy_format(char *buf, size_t len)
+{
+	ARG_UNUSED(buf);
+	ARG_UNUSED(len);
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_BLE_PHY_ADAPTIVE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_PHY_H_ */
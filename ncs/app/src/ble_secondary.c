@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/sys/atomic.h>
+#include <bluetooth/gatt_dm.h>
+#include <bluetooth/services/nus.h>
+#include <bluetooth/services/nus_client.h>
+#include <string.h>
+
+#include "ble_secondary.h"
+#include "ble_central.h"
+#include "ble_conn_params.h"
+#include "ble_nus_client.h"
+#include "usb_cdc.h"
+#include "relay_workq.h"
+#include "sensor_stream.h"
+
+LOG_MODULE_REGISTER(ble_secondary, LOG_LEVEL_INF);
+
+#define SECONDARY_LINKS CONFIG_BLE_SECONDARY_MOUTHPADS
+
+BUILD_ASSERT(CONFIG_BT_MAX_CONN >= 1 + SECONDARY_LINKS,
+	     "CONFIG_BT_MAX_CONN too small for the secondary MouthPad links");
+
+/* 30-50ms interval, 4s supervision timeout: NUS traffic only, so the
+ * primary's HID link keeps most of the radio. A hot standby also lets the
+ * MouthPad skip connection events until it is promoted.
+ */
+#if defined(CONFIG_BLE_HOT_STANDBY)
+#define SECONDARY_LATENCY CONFIG_BLE_HOT_STANDBY_LATENCY
+#else
+#define SECONDARY_LATENCY 0
+#endif
+
+#define SECONDARY_CONN_PARAMS \
+	BT_LE_CONN_PARAM(24, 40, SECONDARY_LATENCY, BLE_CONN_PARAMS_TIMEOUT)
+
+/* The supervision timeout must outlast the skipped events at 50ms */
+BUILD_ASSERT((1 + SECONDARY_LATENCY) * 50 * 2 < BLE_CONN_PARAMS_TIMEOUT * 10,
+	     "CONFIG_BLE_HOT_STANDBY_LATENCY too high for the supervision timeout");
+
+/* Retry interval while another discovery holds bt_gatt_dm */
+#define DISCOVERY_RETRY_MS 100
+
+struct secondary_link {
+	struct bt_conn *conn;
+	struct bt_nus_client nus;
+	struct bt_gatt_exchange_params exchange_params;
+	bool discovery_pending;
+	bool nus_ready;
+	atomic_t tx_busy;
+	struct pass_through_ack_tag tx_ack; /* Of the write in flight */
+	uint8_t tx_buf[BLE_NUS_CLIENT_TX_MAX_LEN];
+};
+
+static struct secondary_link links[SECONDARY_LINKS];
+
+static ble_secondary_sent_cb_t sent_cb;
+
+static void connect_work_handler(struct k_work *work);
+static void discovery_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(connect_work, connect_work_handler);
+static K_WORK_DELAYABLE_DEFINE(discovery_work, discovery_work_handler);
+
+static uint32_t link_device_index(const struct secondary_link *link)
+{
+	return (uint32_t)(link - links) + 1;
+}
+
+/* The link on conn, or a free link for NULL */
+static struct secondary_link *find_link(const struct bt_conn *conn)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+		if (links[i].conn == conn) {
+			return &links[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void link_drop(struct secondary_link *link)
+{
+	int err = bt_conn_disconnect(link->conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+
+	if (err) {
+		LOG_WRN("MouthPad %u: disconnect failed (err %d)", link_device_index(link), err);
+	}
+}
+
+static void connect_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (!find_link(NULL)) {
+		return;
+	}
+
+	int err = ble_central_connect_secondary();
+
+	switch (err) {
+	case 0:
+		break;
+	case -ENOTCONN:
+		/* Primary not ready: ble_secondary_primary_ready() starts again */
+	case -ENOENT:
+		/* Every bonded MouthPad is already connected */
+		break;
+	default:
+		LOG_DBG("Secondary connect not started (err %d), retrying", err);
+		k_work_reschedule_for_queue(&relay_workq_protocol, &connect_work, K_MSEC(CONFIG_BLE_SECONDARY_RETRY_MS));
+		break;
+	}
+}
+
+static void discovery_completed(struct bt_gatt_dm *dm, void *context)
+{
+	struct secondary_link *link = context;
+
+	bt_nus_handles_assign(dm, &link->nus);
+	bt_nus_subscribe_receive(&link->nus);
+	bt_gatt_dm_data_release(dm);
+
+	link->nus_ready = true;
+	LOG_INF("MouthPad %u: NUS ready", link_device_index(link));
+
+	/* bt_gatt_dm is free again: the next link's discovery, then the next link */
+	k_work_reschedule_for_queue(&relay_workq_protocol, &discovery_work, K_NO_WAIT);
+	k_work_reschedule_for_queue(&relay_workq_protocol, &connect_work, K_NO_WAIT);
+}
+
+static void discovery_service_not_found(struct bt_conn *conn, void *context)
+{
+	struct secondary_link *link = context;
+
+	ARG_UNUSED(conn);
+
+	LOG_WRN("MouthPad %u: no NUS service", link_device_index(link));
+	link_drop(link);
+	k_work_reschedule_for_queue(&relay_workq_protocol, &discovery_work, K_NO_WAIT);
+}
+
+static void discovery_error(struct bt_conn *conn, int err, void *context)
+{
+	struct secondary_link *link = context;
+
+	ARG_UNUSED(conn);
+
+	LOG_WRN("MouthPad %u: NUS discovery failed (err %d)", link_device_index(link), err);
+	link_drop(link);
+	k_work_reschedule_for_queue(&relay_workq_protocol, &discovery_work, K_NO_WAIT);
+}
+
+static const struct bt_gatt_dm_cb discovery_cb = {
+	.completed = discovery_completed,
+	.service_not_found = discovery_service_not_found,
+	.error_found = discovery_error,
+};
+
+/* bt_gatt_dm runs one discovery at a time and the primary's may hold it */
+static void discovery_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+		struct secondary_link *link = &links[i];
+
+		if (!link->conn || !link->discovery_pending) {
+			continue;
+		}
+
+		int err = bt_gatt_dm_start(link->conn, BT_UUID_NUS_SERVICE, &discovery_cb, link);
+
+		if (err == -EALREADY || err == -EBUSY) {
+			k_work_reschedule_for_queue(&relay_workq_protocol, &discovery_work, K_MSEC(DISCOVERY_RETRY_MS));
+			return;
+		}
+
+		link->discovery_pending = false;
+
+		if (err) {
+			LOG_WRN("MouthPad %u: cannot start NUS discovery (err %d)",
+				link_device_index(link), err);
+			link_drop(link);
+			continue;
+		}
+
+		return;
+	}
+}
+
+static uint8_t nus_received(struct bt_nus_client *nus, const uint8_t *data, uint16_t len)
+{
+	struct secondary_link *link = CONTAINER_OF(nus, struct secondary_link, nus);
+
+	if (!sensor_stream_admit(data, len, link_device_index(link),
+				 k_ticks_to_us_floor64(k_uptime_ticks()))) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	int err = usb_cdc_send_pass_through(data, len, link_device_index(link));
+
+	if (err) {
+		LOG_DBG("MouthPad %u: %u bytes dropped (err %d)", link_device_index(link), len, err);
+	}
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static void nus_sent(struct bt_nus_client *nus, uint8_t err, const uint8_t *data, uint16_t len)
+{
+	struct secondary_link *link = CONTAINER_OF(nus, struct secondary_link, nus);
+	/* Taken before the link is free for the next write */
+	struct pass_through_ack_tag ack = link->tx_ack;
+
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+
+	atomic_clear(&link->tx_busy);
+	sensor_stream_sequence_reset(link_device_index(link));
+
+	if (sent_cb) {
+		sent_cb(link_device_index(link), err, ack);
+	}
+}
+
+static void exchange_func(struct bt_conn *conn, uint8_t err, struct bt_gatt_exchange_params *params)
+{
+	ARG_UNUSED(params);
+
+	if (err) {
+		LOG_WRN("Secondary MTU exchange failed (err %u)", err);
+	} else {
+		LOG_DBG("Secondary MTU %u", bt_gatt_get_mtu(conn));
+	}
+}
+
+static void secondary_connected(struct bt_conn *conn, uint8_t conn_err)
+{
+	if (conn_err) {
+		LOG_DBG("No secondary MouthPad connected (err 0x%02x)", conn_err);
+		k_work_reschedule_for_queue(&relay_workq_protocol, &connect_work, K_MSEC(CONFIG_BLE_SECONDARY_RETRY_MS));
+		return;
+	}
+
+	struct secondary_link *link = find_link(NULL);
+
+	if (!link) {
+		LOG_WRN("No free secondary link");
+		bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+		return;
+	}
+
+	link->conn = bt_conn_ref(conn);
+	LOG_INF("MouthPad %u connected", link_device_index(link));
+
+	link->exchange_params.func = exchange_func;
+	int err = bt_gatt_exchange_mtu(conn, &link->exchange_params);
+
+	if (err) {
+		LOG_WRN("MouthPad %u: MTU exchange failed (err %d)", link_device_index(link), err);
+	}
+
+	err = bt_conn_le_param_update(conn, SECONDARY_CONN_PARAMS);
+	if (err) {
+		LOG_WRN("MouthPad %u: parameter update failed (err %d)", link_device_index(link),
+			err);
+	}
+
+	/* NUS discovery waits for encryption, as on the primary link */
+	err = bt_conn_set_security(conn, BT_SECURITY_L2);
+	if (err) {
+		LOG_WRN("MouthPad %u: cannot set security (err %d)", link_device_index(link), err);
+		link_drop(link);
+	}
+}
+
+static void secondary_disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	struct secondary_link *link = find_link(conn);
+
+	if (!link) {
+		return;
+	}
+
+	LOG_INF("MouthPad %u disconnected (reason 0x%02x)", link_device_index(link), reason);
+
+	bt_conn_unref(link->conn);
+	link->conn = NULL;
+	link->discovery_pending = false;
+	link->nus_ready = false;
+	atomic_clear(&link->tx_busy);
+
+	k_work_reschedule_for_queue(&relay_workq_protocol, &connect_work, K_MSEC(CONFIG_BLE_SECONDARY_RETRY_MS));
+}
+
+static void security_changed(struct bt_conn *conn, bt_security_t level, enum bt_security_err err)
+{
+	struct secondary_link *link = find_link(conn);
+
+	if (!link) {
+		return;
+	}
+
+	if (err) {
+		LOG_WRN("MouthPad %u: security failed (err %d)", link_device_index(link), err);
+		link_drop(link);
+		return;
+	}
+
+	if (!link->nus_ready && !link->discovery_pending) {
+		link->discovery_pending = true;
+		k_work_reschedule_for_queue(&relay_workq_protocol, &discovery_work, K_NO_WAIT);
+	}
+}
+
+#if defined(CONFIG_BLE_HOT_STANDBY)
+/* The primary MouthPad dropped: hand the first ready link to ble_central.
+ * It stays connected and encrypted; with CONFIG_BLE_GATT_HANDLE_CACHE a
+ * MouthPad that was primary before has only HIDS and BAS discovered again.
+ */
+static struct bt_conn *take_standby(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+		struct secondary_link *link = &links[i];
+
+		if (!link->nus_ready) {
+			continue;
+		}
+
+		struct bt_conn *conn = link->conn;
+
+		LOG_INF("MouthPad %u becomes the primary", link_device_index(link));
+
+		/* The primary NUS client subscribes again after discovery */
+		int err = bt_gatt_unsubscribe(conn, &link->nus.tx_notif_params);
+
+		if (err) {
+			LOG_WRN("MouthPad %u: unsubscribe failed (err %d)", link_device_index(link),
+				err);
+		}
+
+		link->conn = NULL;
+		link->nus_ready = false;
+		atomic_clear(&link->tx_busy);
+
+		return conn;
+	}
+
+	return NULL;
+}
+#endif
+
+BT_CONN_CB_DEFINE(secondary_conn_callbacks) = {
+	.security_changed = security_changed,
+};
+
+int ble_secondary_init(void)
+{
+	const struct bt_nus_client_init_param init = {
+		.cb = {
+			.received = nus_received,
+			.sent = nus_sent,
+		},
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+		int err = bt_nus_client_init(&links[i].nus, &init);
+
+		if (err) {
+			LOG_ERR("Secondary NUS client init failed (err %d)", err);
+			return err;
+		}
+	}
+
+	ble_central_register_secondary_cbs(secondary_connected, secondary_disconnected);
+#if defined(CONFIG_BLE_HOT_STANDBY)
+	ble_central_register_standby_cb(take_standby);
+#endif
+
+	LOG_INF("Up to %d secondary MouthPad(s)", SECONDARY_LINKS);
+	return 0;
+}
+
+void ble_secondary_primary_ready(void)
+{
+	k_work_reschedule_for_queue(&relay_workq_protocol, &connect_work, K_NO_WAIT);
+}
+
+int ble_secondary_send(uint32_t device_index, const uint8_t *data, uint16_t len,
+		       struct pass_through_ack_tag ack)
+{
+	if (device_index == 0 || device_index > ARRAY_SIZE(links)) {
+		return -ENOTCONN;
+	}
+
+	struct secondary_link *link = &links[device_index - 1];
+
+	if (!link->nus_ready) {
+		return -ENOTCONN;
+	}
+
+	if (len > sizeof(link->tx_buf)) {
+		return -EMSGSIZE;
+	}
+
+	/* bt_nus_client_send keeps the buffer until the write completes */
+	if (atomic_test_and_set_bit(&link->tx_busy, 0)) {
+		return -ENOBUFS;
+	}
+
+	memcpy(link->tx_buf, data, len);
+	link->tx_ack = ack;
+
+	int err = bt_nus_client_send(&link->nus, link->tx_buf, len);
+
+	if (err) {
+		atomic_clear(&link->tx_busy);
+	}
+
+	return err;
+}
+
+uint8_t ble_secondary_count(void)
+{
+	uint8_t count = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+		count += links[i].nus_ready ? 1 : 0;
+	}
+
+	return count;
+}
+
+void ble_secondary_register_sent_cb(ble_secondary_sent_cb_t cb)
+{
+	sent_cb = cb;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief NUS links to bonded MouthPads besides the primary one
+ *
+ * With CONFIG_BLE_MULTI_MOUTHPAD, once the primary MouthPad is ready the
+ * relay auto-connects to the other bonded MouthPads, one at a time, up to
+ * CONFIG_BLE_SECONDARY_MOUTHPADS links. Each link is encrypted, has its NUS
+ * service discovered and is kept at a relaxed connection interval. Device
+ * index 0 is the primary MouthPad; secondary links are numbered from 1 by
+ * slot, and their NUS data is sent to the host as PassThroughToApp with
+ * that device_index.
+ *
+ * Only NUS is bridged: HID, battery and device information still come from
+ * the primary MouthPad. With CONFIG_BLE_HOT_STANDBY the links run at high
+ * peripheral latency and ble_central promotes a ready one to primary when
+ * the primary MouthPad disconnects.
+ */
+
+#ifndef BLE_SECONDARY_H_
+#define BLE_SECONDARY_H_
+
+#include <errno.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#include "pass_through_ack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Called as each write to a secondary MouthPad completes; err is an ATT
+ * error code, 0 on success, and ack is what the write was sent with
+ */
+typedef void (*ble_secondary_sent_cb_t)(uint32_t device_index, uint8_t err,
+					struct pass_through_ack_tag ack);
+
+#if defined(CONFIG_BLE_MULTI_MOUTHPAD)
+
+/**
+ * @brief Set up the secondary NUS clients and the ble_central callbacks
+ *
+ * @return 0 on success, negative error code otherwise
+ */
+int ble_secondary_init(void);
+
+/**
+ * @brief The primary MouthPad is ready; start connecting secondaries
+ */
+void ble_secondary_primary_ready(void);
+
+/**
+ * @brief Write to the NUS RX characteristic of a secondary MouthPad
+ *
+ * One write is outstanding per link; its completion is reported to the
+ * sent callback.
+ *
+ * @param device_index Secondary device index, from 1
+ * @param ack Handed back to the sent callback with the completion
+ * @return 0 if the write was queued, -ENOTCONN if no MouthPad with that
+ *         index is ready, -ENOBUFS while the previous write is in flight,
+ *         -EMSGSIZE if len exceeds one NUS write
+ */
+int ble_secondary_send(uint32_t device_index, const uint8_t *data, uint16_t len,
+		       struct pass_through_ack_tag ack);
+
+/**
+ * @brief Secondary MouthPads whose NUS service is ready
+ */
+uint8_t ble_secondary_count(void);
+
+void ble_secondary_register_sent_cb(ble_secondary_sent_cb_t cb);
+
+#else
+
+static inline int ble_secondary_init(void)
+{
+	return 0;
+}
+
+static inline void ble_secondary_primary_ready(void)
+{
+}
+
+static inline int ble_secondary_send(uint32_t device_index, const uint8_t *data, uint16_t len,
+				     struct pass_through_ack_tag ack)
+{
+	ARG_UNUSED(device_index);
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+	ARG_UNUSED(ack);
+	return -ENOTCONN;
+}
+
+static inline uint8_t ble_secondary_count(void)
+{
+	return 0;
+}
+
+static inline void ble_secondary_register_sent_cb(ble_secondary_sent_cb_t cb)
+{
+	ARG_UNUSED(cb);
+}
+
+#endif /* CONFIG_BLE_MULTI_MOUTHPAD */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_SECONDARY_H_ */
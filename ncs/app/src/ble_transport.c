@@ -14,16 +14,35 @@
 #include <zephyr/bluetooth/hci_types.h>
 #include <zephyr/bluetooth/addr.h>
 #include <zephyr/sys/byteorder.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "ble_transport.h"
 #include "ble_central.h"
 #include "ble_nus_client.h"
+#include "ble_l2cap_bulk.h"
 #include "ble_hid.h"
 #include "ble_bas.h"
+#include "ble_conn_params.h"
+#include "ble_phy.h"
+#include "ble_tx_power.h"
+#include "link_guard.h"
+#include "link_state.h"
 #include "ble_dis.h"
+#include "oled_display.h"
 #include "usb_cdc.h"
 #include "usb_hid.h"
+#include "relay_stats.h"
+#include "connection_timing.h"
+#include "fault_inject.h"
+#include "pairing_timing.h"
+#include "ble_discovery.h"
+#include "ble_secondary.h"
+#include "relay_workq.h"
+#include "relay_activity.h"
+#include "relay_bus.h"
+#include "relay_device_info.h"
+#include "sensor_stream.h"
 
 #define LOG_MODULE_NAME ble_transport
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -31,6 +50,9 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 /* USB CDC callback */
 static usb_cdc_send_cb_t usb_cdc_send_callback = NULL;
 
+/* NUS write completion callback */
+static ble_nus_sent_callback_t nus_sent_callback = NULL;
+
 /* NUS Bridge state */
 static bool nus_client_ready = false;
 static bool mtu_exchange_complete = false;
@@ -43,23 +65,33 @@ static bool hid_discovery_complete = false;
 /* Connection state tracking for sound effects */
 static bool fully_connected = false;
 
-/* Data activity tracking for LED indication */
-static bool data_activity = false;
-static int64_t last_data_time = 0;
-
-/* HID-only data activity tracking for LED indication */
-static bool hid_data_activity = false;
-static int64_t last_hid_data_time = 0;
-
 /* RSSI tracking - stored from advertising during scan */
 static int8_t last_known_rssi = 0;
 
+/* Last value given to relay_bus_telemetry_rssi() */
+static int8_t published_rssi;
+
 /* Connected device name tracking */
 static char connected_device_name[32] = "MouthPad USB";  /* Shortened to fit 12 char limit */
 
-/* RSSI reading infrastructure */
+/* RSSI reading infrastructure. HCI Read RSSI blocks the sending thread for
+ * a controller round-trip, so it runs on the background work queue, away
+ * from HID setup and the CDC output work.
+ */
+#define RSSI_READ_INTERVAL           K_SECONDS(2)
+#define RSSI_READ_INTERVAL_DEEP_IDLE K_SECONDS(10)  /* Nobody is looking */
+
+/* Each reading moves the smoothed RSSI 1/4 of the way (as a shift) */
+#define RSSI_EWMA_SHIFT 2
+
 static struct k_work_delayable rssi_read_work;
 static bool rssi_reading_active = false;
+static bool rssi_paused = false;  /* USB host suspended; nothing shows RSSI */
+
+/* Smoothed connection RSSI in 1/16 dBm; readings since connecting */
+static int32_t rssi_ewma_x16;
+static uint32_t rssi_read_count;
+static bool at_risk_applied; /* Last link guard state passed on */
 
 /* HID Bridge callbacks */
 static ble_data_callback_t hid_data_callback = NULL;
@@ -67,65 +99,78 @@ static ble_ready_callback_t hid_ready_callback = NULL;
 
 /* Internal callback functions */
 static void ble_nus_data_received_cb(const uint8_t *data, uint16_t len);
+static void ble_nus_data_sent_cb(uint8_t err, struct pass_through_ack_tag ack);
 static void rssi_read_work_handler(struct k_work *work);
+static k_timeout_t rssi_read_interval(void);
 static void dis_discovery_complete_cb(struct bt_conn *conn);
 static void ble_nus_discovery_complete_cb(void);
 static void ble_nus_mtu_exchange_cb(uint16_t mtu);
-static void ble_hid_data_received_cb(const uint8_t *data, uint16_t len);
 static void ble_hid_discovery_complete_cb(void);
 static void ble_central_connected_cb(struct bt_conn *conn);
 static void ble_central_disconnected_cb(struct bt_conn *conn, uint8_t reason);
 static void gatt_discover(struct bt_conn *conn);
 
 static bool nus_discovery_complete = false;
+static bool dis_discovery_complete = false;
+
+/* Tell the other modules, and the main thread, where the link stands */
+static void publish_link_state(void)
+{
+	const struct relay_link_state_msg msg = {
+		.connected = ble_transport_is_connected(),
+		.ready = fully_connected,
+	};
+
+	link_state_set_ready(LINK_STATE_HID | LINK_STATE_NUS | LINK_STATE_READY,
+			     (hid_client_ready ? LINK_STATE_HID : 0) |
+				     (nus_client_ready ? LINK_STATE_NUS : 0) |
+				     (fully_connected ? LINK_STATE_READY : 0));
+
+	relay_bus_publish(&relay_chan_link_state, &msg);
+}
+
+/* Report CONNECTED once: the bridge is operational with firmware info */
+static void services_ready(void)
+{
+	if (fully_connected) {
+		return;
+	}
+
+	ble_central_mark_services_ready();
+
+	/* The primary is up: further bonded MouthPads may connect now */
+	ble_secondary_primary_ready();
+
+	/* Log how long this connection took to get here */
+	struct connection_timing_record timing[CONNECTION_TIMING_RECORDS];
+	char line[128];
+
+	if (connection_timing_get(timing) > 0) {
+		connection_timing_format(&timing[0], line, sizeof(line));
+		LOG_INF("Connection timing (ms): %s", line);
+	}
+
+	/* Mark as fully connected; the buzzer plays the connection sound */
+	fully_connected = true;
+	publish_link_state();
+}
 
 static void nus_discovery_completed_cb(void)
 {
 	LOG_INF("=== NUS DISCOVERY COMPLETED ===");
 	nus_discovery_complete = true;
 
-	/* Load cached DIS info from in-memory cache for the connected device */
-	struct bt_conn *conn = ble_central_get_default_conn();
-	if (conn) {
-		const bt_addr_le_t *addr = bt_conn_get_dst(conn);
-		extern void ble_dis_load_cache_for_connected_device(const bt_addr_le_t *addr);
-		ble_dis_load_cache_for_connected_device(addr);
-	}
-
 	/* Check if we have cached firmware version from previous connection */
 	extern bool ble_dis_has_cached_firmware(void);
-	if (ble_dis_has_cached_firmware()) {
-		/* Fast path: We have cached device info, can report CONNECTED immediately */
-		LOG_INF("HID and NUS complete with cached firmware - reporting CONNECTED immediately");
-		ble_central_mark_services_ready();
-		fully_connected = true;
-		extern void buzzer_connected(void);
-		buzzer_connected();
-
-		/* Still start DIS discovery in background to refresh cached data */
-		LOG_INF("Starting DIS discovery in background to refresh cached firmware info...");
-		extern int ble_dis_discover(struct bt_conn *conn);
-		ble_dis_discover(ble_central_get_default_conn());
-		/* DIS completion won't re-trigger buzzer since fully_connected is already true */
+	if (ble_dis_has_cached_firmware() || dis_discovery_complete) {
+		/* Fast path: firmware info is cached or already read, report CONNECTED now;
+		 * DIS reads still refresh the cache in the background
+		 */
+		LOG_INF("NUS complete with firmware info - reporting CONNECTED immediately");
+		services_ready();
 	} else {
 		/* Slow path: No cached firmware, must wait for DIS before marking CONNECTED */
-		LOG_INF("HID and NUS discovery complete - waiting for DIS firmware before marking CONNECTED");
-
-		/* Now start DIS discovery after NUS is complete */
-		LOG_INF("Starting DIS (Device Information Service) discovery after NUS completion...");
-		extern int ble_dis_discover(struct bt_conn *conn);
-		int dis_err = ble_dis_discover(ble_central_get_default_conn());
-		if (dis_err != 0) {
-			LOG_ERR("DIS discovery failed (err %d)", dis_err);
-			/* If DIS fails, mark as connected anyway */
-			ble_central_mark_services_ready();
-			fully_connected = true;
-			extern void buzzer_connected(void);
-			buzzer_connected();
-		} else {
-			LOG_INF("DIS discovery started successfully - will mark CONNECTED when firmware is retrieved");
-		}
-		/* DIS completion callback will mark services ready and trigger BAS discovery */
+		LOG_INF("NUS discovery complete - waiting for DIS firmware before marking CONNECTED");
 	}
 }
 
@@ -147,12 +192,14 @@ int ble_transport_init(void)
 
 	/* Register NUS Client callbacks */
 	ble_nus_client_register_data_received_cb(ble_nus_data_received_cb);
+	ble_nus_client_register_data_sent_cb(ble_nus_data_sent_cb);
 	ble_nus_client_register_discovery_complete_cb(ble_nus_discovery_complete_cb);
 	ble_nus_client_register_mtu_exchange_cb(ble_nus_mtu_exchange_cb);
+	/* The bulk channel's data takes the NUS notification path */
+	ble_l2cap_bulk_init(ble_nus_data_received_cb);
 	
 	/* Register HID Client callbacks */
 	LOG_INF("Registering BLE HID callbacks...");
-	ble_hid_register_data_received_cb(ble_hid_data_received_cb);
 	ble_hid_register_ready_cb(ble_hid_discovery_complete_cb);
 	LOG_INF("BLE HID callbacks registered successfully");
 	
@@ -192,7 +239,18 @@ int ble_transport_init(void)
 	}
 	LOG_INF("BLE HID client initialized successfully");
 
-	/* Initialize RSSI reading work */
+#if defined(CONFIG_BLE_LINK_GUARD)
+	const struct link_guard_config guard_config = {
+		.floor_dbm = CONFIG_BLE_LINK_GUARD_FLOOR_DBM,
+		.hysteresis_db = CONFIG_BLE_LINK_GUARD_HYSTERESIS_DB,
+		.horizon_ms = CONFIG_BLE_LINK_GUARD_HORIZON_MS,
+		.hold_ms = CONFIG_BLE_LINK_GUARD_HOLD_MS,
+	};
+
+	link_guard_init(&guard_config);
+#endif
+
+	/* Initialize RSSI reading work; it slows down with the activity level */
 	k_work_init_delayable(&rssi_read_work, rssi_read_work_handler);
 
 	/* Start scanning */
@@ -225,29 +283,123 @@ int ble_transport_start_bridging(void)
 	return 0;
 }
 
-int ble_transport_send_nus_data(const uint8_t *data, uint16_t len)
+int ble_transport_send_nus_data(const uint8_t *data, uint16_t len, bool reliable,
+				struct pass_through_ack_tag ack)
 {
 	if (!nus_client_ready) {
 		LOG_WRN("NUS client not ready");
 		return -ENOTCONN;
 	}
 
-	LOG_INF("BLE Transport sending %d bytes to NUS", len);
-	int err = ble_nus_client_send_data(data, len);
+	relay_stats_packet(RELAY_STATS_NUS_TX, len);
+	RELAY_TRACE("BLE Transport sending %d bytes to NUS", len);
+	int err = ble_nus_client_send_data(data, len, reliable, ack);
 	if (err) {
 		LOG_ERR("BLE Transport send failed: %d", err);
+		relay_stats_add(RELAY_STATS_NUS_TX, RELAY_STATS_DROPPED, 1);
 	} else {
-		LOG_INF("BLE Transport send successful");
-		data_activity = true;  // Mark data activity for LED indication
+		relay_activity_mark();
+		if (ble_nus_client_tx_pending() >= CONFIG_BLE_LINK_PROFILE_BULK_BACKLOG) {
+			ble_conn_params_backlog();
+		}
 	}
 	return err;
 }
 
+int ble_transport_send_nus_timed(const uint8_t *data, uint16_t len, ble_nus_timed_callback_t cb)
+{
+	if (!nus_client_ready) {
+		return -ENOTCONN;
+	}
+
+	return ble_nus_client_send_timed(data, len, cb);
+}
+
+/* Whether stream writes go over the bulk L2CAP channel. Follows the channel
+ * only while no stream write is outstanding on either path, so the bytes
+ * reach the MouthPad in order and complete in order. Stream context only.
+ */
+static bool stream_on_l2cap;
+
+static void stream_choose_path(void)
+{
+	if (stream_on_l2cap != ble_l2cap_bulk_ready() && ble_nus_client_stream_pending() == 0 &&
+	    ble_l2cap_bulk_pending() == 0) {
+		stream_on_l2cap = !stream_on_l2cap;
+		LOG_INF("Bulk stream now on %s", stream_on_l2cap ? "the L2CAP channel" : "NUS");
+	}
+}
+
+int ble_transport_send_nus_stream(const uint8_t *data, uint16_t len, ble_nus_timed_callback_t cb)
+{
+	if (!nus_client_ready) {
+		return -ENOTCONN;
+	}
+
+	stream_choose_path();
+
+	int err = stream_on_l2cap ? ble_l2cap_bulk_send(data, len, cb)
+				  : ble_nus_client_send_stream(data, len, cb);
+
+	if (!err) {
+		relay_stats_packet(RELAY_STATS_NUS_TX, len);
+		relay_activity_mark();
+		ble_conn_params_backlog();
+	}
+	return err;
+}
+
+uint16_t ble_transport_get_nus_write_len(void)
+{
+	struct bt_conn *conn = ble_central_get_default_conn();
+
+	if (!nus_client_ready || !conn) {
+		return 0;
+	}
+
+	return MIN(bt_gatt_get_mtu(conn) - 3, BLE_NUS_CLIENT_TX_MAX_LEN);
+}
+
+uint16_t ble_transport_get_stream_write_len(void)
+{
+	stream_choose_path();
+
+	if (stream_on_l2cap) {
+		return nus_client_ready ? ble_l2cap_bulk_sdu_len() : 0;
+	}
+	return ble_transport_get_nus_write_len();
+}
+
 bool ble_transport_is_nus_ready(void)
 {
 	return nus_client_ready;
 }
 
+int ble_transport_register_nus_sent_callback(ble_nus_sent_callback_t cb)
+{
+	nus_sent_callback = cb;
+	return 0;
+}
+
+uint8_t ble_transport_get_nus_tx_window(void)
+{
+	return ble_nus_client_tx_window();
+}
+
+uint8_t ble_transport_get_nus_tx_pending(void)
+{
+	return ble_nus_client_tx_pending();
+}
+
+static void ble_nus_data_sent_cb(uint8_t err, struct pass_through_ack_tag ack)
+{
+	relay_stats_add(RELAY_STATS_NUS_TX, err ? RELAY_STATS_DROPPED : RELAY_STATS_BRIDGED, 1);
+
+	if (nus_sent_callback) {
+		nus_sent_callback(err, ack);
+	}
+}
+
 /* Future HID Transport functions */
 int ble_transport_register_hid_data_callback(ble_data_callback_t cb)
 {
@@ -274,7 +426,7 @@ int ble_transport_send_hid_data(const uint8_t *data, uint16_t len)
 		LOG_ERR("BLE Transport HID send failed: %d", err);
 	} else {
 		LOG_DBG("BLE Transport HID send successful");
-		data_activity = true;  // Mark data activity for LED indication
+		relay_activity_mark();
 	}
 	return err;
 }
@@ -287,41 +439,51 @@ bool ble_transport_is_hid_ready(void)
 /* Internal callback functions */
 static void ble_nus_data_received_cb(const uint8_t *data, uint16_t len)
 {
-	LOG_INF("NUS data received: %d bytes", len);
+	relay_stats_packet(RELAY_STATS_NUS_RX, len);
+	RELAY_TRACE("NUS data received: %d bytes", len);
+
+	if (IS_ENABLED(CONFIG_RELAY_FAULT_INJECT) && fault_inject_notification(FAULT_INJECT_NUS)) {
+		return;
+	}
 	
 	// Only process data after MTU exchange is complete
 	if (!mtu_exchange_complete) {
 		LOG_DBG("Skipping data - MTU exchange not complete");
+		relay_stats_add(RELAY_STATS_NUS_RX, RELAY_STATS_DROPPED, 1);
 		return;
 	}
 	
 	// Debug: Log the first few bytes to see what we're getting
 	if (len > 0) {
-		LOG_INF("First bytes: %02x %02x %02x %02x", 
+		RELAY_TRACE("First bytes: %02x %02x %02x %02x", 
 			data[0], len > 1 ? data[1] : 0, len > 2 ? data[2] : 0, len > 3 ? data[3] : 0);
 	}
 	
 	// Filter out 2-byte echo responses (73 XX format)
 	if (len == 2 && data[0] == 0x73) {
 		LOG_DBG("Skipping 2-byte echo: 73 %02x", data[1]);
+		relay_stats_add(RELAY_STATS_NUS_RX, RELAY_STATS_ECHO_FILTERED, 1);
 		return;
 	}
 	
 	// Don't echo back single characters (likely echo from our input)
 	if (len == 1) {
 		LOG_DBG("Skipping single character echo");
+		relay_stats_add(RELAY_STATS_NUS_RX, RELAY_STATS_ECHO_FILTERED, 1);
 		return;
 	}
 	
 	// For larger packets, try to identify the structure
 	if (len >= 4) {
-		LOG_INF("PACKET STRUCTURE: Type=0x%02x, Length=%d", data[0], len);
+		RELAY_TRACE("PACKET STRUCTURE: Type=0x%02x, Length=%d", data[0], len);
 	}
 	
-	// Mark data activity for LED indication
-	data_activity = true;
-	last_data_time = k_uptime_get();
-	LOG_DBG("=== DATA ACTIVITY MARKED ===");
+	relay_activity_mark();
+	
+	// Streams the host has blocked or thinned stop here, before CDC0
+	if (!sensor_stream_admit(data, len, 0, k_ticks_to_us_floor64(k_uptime_ticks()))) {
+		return;
+	}
 	
 	// Bridge NUS data directly to USB CDC
 	if (usb_cdc_send_callback) {
@@ -339,21 +501,35 @@ static void ble_nus_discovery_complete_cb(void)
 {
 	LOG_INF("NUS client ready - service discovery complete");
 	nus_client_ready = true;
+	connection_timing_mark(CONNECTION_TIMING_NUS_READY);
+	publish_link_state();
+	ble_l2cap_bulk_connect(ble_central_get_default_conn());
 	LOG_INF("NUS client ready - bridge operational");
 	
 	/* Trigger HID discovery after NUS discovery completes */
 	nus_discovery_completed_cb();
 }
 
-static void ble_hid_data_received_cb(const uint8_t *data, uint16_t len)
+/* Reports forwarded by ble_hid.c, from relay_chan_hid_report */
+static void hid_report_forwarded(const struct zbus_channel *chan)
 {
+	const struct relay_hid_report_msg *msg = zbus_chan_const_msg(chan);
+	const uint8_t *data = msg->data;
+	uint16_t len = MIN(msg->size, sizeof(msg->data));
+
+	if (!msg->sent) {
+		return;
+	}
+
 	LOG_DBG("=== BLE HID DATA RECEIVED ===");
 	LOG_DBG("HID data received: %d bytes", len);
 	LOG_DBG("HID discovery status: ready=%d, complete=%d", hid_client_ready, hid_discovery_complete);
+	relay_stats_packet(RELAY_STATS_HID, len);
 	
 	// Only process data after HID discovery is complete
 	if (!hid_discovery_complete) {
 		LOG_DBG("Skipping HID data - HID discovery not complete");
+		relay_stats_add(RELAY_STATS_HID, RELAY_STATS_DROPPED, 1);
 		return;
 	}
 	
@@ -366,28 +542,28 @@ static void ble_hid_data_received_cb(const uint8_t *data, uint16_t len)
 	// Filter out 2-byte echo responses (73 XX format)
 	if (len == 2 && data[0] == 0x73) {
 		LOG_DBG("Skipping 2-byte echo: 73 %02x", data[1]);
+		relay_stats_add(RELAY_STATS_HID, RELAY_STATS_ECHO_FILTERED, 1);
 		return;
 	}
 	
 	// Don't echo back single characters (likely echo from our input)
 	if (len == 1) {
 		LOG_DBG("Skipping single character echo");
+		relay_stats_add(RELAY_STATS_HID, RELAY_STATS_ECHO_FILTERED, 1);
 		return;
 	}
 	
 	// For larger packets, try to identify the structure
 	if (len >= 4) {
-		LOG_INF("HID PACKET STRUCTURE: Type=0x%02x, Length=%d", data[0], len);
+		RELAY_TRACE("HID PACKET STRUCTURE: Type=0x%02x, Length=%d", data[0], len);
 	}
 	
-	// Mark data activity for LED indication
-	data_activity = true;
-	last_data_time = k_uptime_get();
-	LOG_DBG("=== DATA ACTIVITY MARKED ===");
+	relay_activity_mark();
 	
 	// Bridge HID data directly to USB HID
 	// Note: HID data is already sent directly to USB in ble_hid.c for zero latency
 	// No need to duplicate the USB sending here to avoid semaphore conflicts
+	relay_stats_add(RELAY_STATS_HID, RELAY_STATS_BRIDGED, 1);
 	if (hid_data_callback) {
 		LOG_DBG("Calling USB HID callback with %d bytes", len);
 		hid_data_callback(data, len);
@@ -396,46 +572,42 @@ static void ble_hid_data_received_cb(const uint8_t *data, uint16_t len)
 	}
 }
 
+ZBUS_LISTENER_DEFINE(transport_hid_report, hid_report_forwarded);
+ZBUS_CHAN_ADD_OBS(relay_chan_hid_report, transport_hid_report, RELAY_BUS_PRIO_STATS);
+
 static void ble_hid_discovery_complete_cb(void)
 {
 	LOG_INF("=== BLE HID DISCOVERY COMPLETE ===");
-	LOG_INF("HID client ready - service discovery complete");
+	/* Input flows as soon as HOGP is ready; the rest of discovery carries on */
 	hid_client_ready = true;
 	hid_discovery_complete = true;
-	LOG_INF("HID client ready - starting NUS discovery");
+	connection_timing_mark(CONNECTION_TIMING_HID_READY);
+	/* Enhanced ATT bearers are set up once the link is secured, so by now */
+	connection_timing_set_att_bearers(ble_nus_client_att_bearers());
+	LOG_INF("ATT bearers: %u", ble_nus_client_att_bearers());
+	publish_link_state();
 	LOG_INF("BLE HID discovery status: ready=%d, complete=%d", hid_client_ready, hid_discovery_complete);
-
-	/* Start NUS discovery after HID is complete */
-	LOG_INF("Starting NUS service discovery after HID completion...");
-	ble_nus_client_discover(ble_central_get_default_conn());
-	/* NUS will trigger DIS discovery when it completes, then DIS will trigger BAS */
 }
 
-/* Callback when DIS discovery completes - mark services ready and start BAS discovery */
+/* Callback when DIS reads complete - report CONNECTED if NUS is ready too */
 static void dis_discovery_complete_cb(struct bt_conn *conn)
 {
-	LOG_INF("DIS discovery completed - HID, NUS, and DIS (firmware) are ready");
-
-	/* Only mark services ready and play buzzer if not already done (slow path) */
-	if (!fully_connected) {
-		/* Slow path: NUS didn't have cached firmware, so DIS completion triggers CONNECTED */
-		LOG_INF("Marking services ready and reporting CONNECTED (slow path - no cached firmware)");
-		ble_central_mark_services_ready();
+	ARG_UNUSED(conn);
 
-		/* Mark as fully connected - eligible for disconnect sound */
-		fully_connected = true;
+	dis_discovery_complete = true;
+	connection_timing_mark(CONNECTION_TIMING_DIS_READY);
 
-		/* Play happy connection sound - full bridge is now operational with firmware info! */
-		extern void buzzer_connected(void);
-		buzzer_connected();
-	} else {
+	if (fully_connected) {
 		/* Fast path: Already marked connected when NUS completed, just refreshing DIS data */
 		LOG_INF("DIS discovery complete (background refresh - already CONNECTED via cached firmware)");
+	} else if (nus_discovery_complete) {
+		/* Slow path: NUS didn't have cached firmware, so DIS completion triggers CONNECTED */
+		LOG_INF("Marking services ready and reporting CONNECTED (slow path - no cached firmware)");
+		services_ready();
+	} else {
+		/* The discovery pass reached DIS first; NUS completion reports CONNECTED */
+		LOG_INF("DIS discovery complete - waiting for NUS");
 	}
-
-	/* Start BAS discovery after DIS (runs in background, not critical for CONNECTED state) */
-	LOG_INF("Starting BAS (Battery Service) discovery...");
-	ble_bas_discover(conn);
 }
 
 static void gatt_discover(struct bt_conn *conn)
@@ -451,18 +623,16 @@ static void gatt_discover(struct bt_conn *conn)
 
 	/* Reset discovery state */
 	nus_discovery_complete = false;
+	dis_discovery_complete = false;
 
-	/* Start HID (HOGP) discovery FIRST for fastest input passthrough */
-	LOG_INF("Starting HID service discovery first for fastest input...");
-	int hid_err = ble_hid_discover(conn);
-	if (hid_err != 0) {
-		LOG_ERR("HID discovery failed to start (err %d), starting NUS anyway", hid_err);
-		/* If HID fails to start, begin NUS discovery immediately */
-		LOG_INF("Starting NUS service discovery...");
-		ble_nus_client_discover(conn);
-	}
-	/* Otherwise, NUS discovery will be started when HID completes */
-	/* DIS and BAS will be started after NUS completes */
+	/* Load cached DIS info for this device before fresh DIS reads can land */
+	extern void ble_dis_load_cache_for_connected_device(const bt_addr_le_t *addr);
+	ble_dis_load_cache_for_connected_device(bt_conn_get_dst(conn));
+
+	/* One pass over the database; HID, NUS, DIS and BAS are each set up as
+	 * soon as their service is found, so HOGP's reads overlap the rest
+	 */
+	ble_discovery_start(conn);
 }
 
 static void ble_central_connected_cb(struct bt_conn *conn)
@@ -471,26 +641,19 @@ static void ble_central_connected_cb(struct bt_conn *conn)
 
 	LOG_INF("BLE Central connected - starting setup");
 
+	/* DeviceInfoResponse now reports this peer's address */
+	relay_device_info_invalidate();
+
 	/* Update display to show pairing status */
-	extern int oled_display_pairing(void);
 	oled_display_pairing();
 
-	/* Request optimal connection parameters for better signal and responsiveness */
-	struct bt_le_conn_param conn_params = {
-		.interval_min = 16,    /* 20ms (16 * 1.25ms) */
-		.interval_max = 40,    /* 50ms (40 * 1.25ms) */
-		.latency = 0,          /* No latency for responsiveness */
-		.timeout = 400         /* 4 seconds (400 * 10ms) */
-	};
-	
-	err = bt_conn_le_param_update(conn, &conn_params);
-	if (err) {
-		LOG_WRN("Failed to request connection parameter update (err %d)", err);
-	} else {
-		LOG_INF("Connection parameter update requested (20-50ms interval, 0 latency)");
-	}
+	/* Lowest latency while HID is active, relaxed once it goes idle */
+	ble_conn_params_connected(conn);
 
-#if defined(CONFIG_BT_USER_PHY_UPDATE)
+#if defined(CONFIG_BLE_PHY_ADAPTIVE)
+	/* 2M first; the RSSI readings move it from there */
+	ble_phy_connected(conn);
+#elif defined(CONFIG_BT_USER_PHY_UPDATE)
 	/* Request PHY update for better throughput or range */
 	struct bt_conn_le_phy_param phy_params = {
 		.options = BT_CONN_LE_PHY_OPT_NONE,
@@ -506,6 +669,9 @@ static void ble_central_connected_cb(struct bt_conn *conn)
 	}
 #endif
 
+	/* Full power until the first RSSI readings show the margin */
+	ble_tx_power_connected(conn);
+
 	// Perform MTU exchange using the NUS client module
 	err = ble_nus_client_exchange_mtu(conn);
 	if (err) {
@@ -514,18 +680,29 @@ static void ble_central_connected_cb(struct bt_conn *conn)
 		LOG_INF("MTU exchange initiated successfully");
 	}
 
+	pairing_timing_mark(PAIRING_TIMING_REQUESTED);
 	err = bt_conn_set_security(conn, BT_SECURITY_L2);
 	if (err) {
 		LOG_WRN("Failed to set security: %d", err);
-		gatt_discover(conn);
 	} else {
-		LOG_INF("Security setup successful");
-		gatt_discover(conn);
+		LOG_INF("Security requested");
 	}
 
+	/* Not after security_changed: services, characteristics and DIS need no
+	 * encryption, so discovery (or the cached handles) overlaps it, and the
+	 * protected HID and NUS CCC writes are retried by ATT once it is up
+	 * (CONFIG_BT_ATT_RETRY_ON_SEC_ERR)
+	 */
+	gatt_discover(conn);
+
 	/* Start periodic RSSI reading */
+	link_guard_connected();
 	rssi_reading_active = true;
-	k_work_schedule(&rssi_read_work, K_SECONDS(2));  /* First read in 2 seconds */
+	rssi_read_count = 0;
+	at_risk_applied = false;
+	if (!rssi_paused) {
+		k_work_schedule_for_queue(&relay_workq_background, &rssi_read_work, rssi_read_interval());
+	}
 	LOG_INF("Started periodic RSSI reading");
 }
 
@@ -542,19 +719,23 @@ static void ble_central_disconnected_cb(struct bt_conn *conn, uint8_t reason)
 		LOG_ERR("Failed to send USB HID release-all (err %d)", ret);
 	}
 
-	/* Then play disconnection sound if we were fully connected */
-	if (fully_connected) {
-		extern void buzzer_disconnected(void);
-		buzzer_disconnected();
-		LOG_INF("Played disconnection sound (was fully connected)");
-	} else {
-		LOG_INF("Skipped disconnection sound (was not fully connected)");
+	ble_conn_params_disconnected();
+	ble_conn_params_at_risk(false);
+	ble_phy_disconnected();
+	sensor_stream_sequence_reset(0);
+	if (reason == BT_HCI_ERR_CONN_TIMEOUT) {
+		link_guard_dropped();
 	}
-	
-	// Reset ready states for both NUS and HID
+
+	// Reset ready states for both NUS and HID; the buzzer plays the
+	// disconnection sound if the link was fully connected
 	nus_client_ready = false;
+	ble_nus_client_reset_tx();
 	hid_client_ready = false;
 	hid_discovery_complete = false;
+	fully_connected = false;
+	link_state_lost();
+	publish_link_state();
 
 	/* Stop periodic RSSI reading */
 	rssi_reading_active = false;
@@ -562,11 +743,12 @@ static void ble_central_disconnected_cb(struct bt_conn *conn, uint8_t reason)
 	LOG_INF("Stopped periodic RSSI reading");
 	mtu_exchange_complete = false;
 	nus_discovery_complete = false;
-	fully_connected = false;
+	dis_discovery_complete = false;
 	
 	/* Reset device name to default */
 	strncpy(connected_device_name, "MouthPad USB", sizeof(connected_device_name) - 1);
 	connected_device_name[sizeof(connected_device_name) - 1] = '\0';
+	relay_device_info_invalidate();
 	
 	// Reset battery service state
 	ble_bas_reset();
@@ -593,114 +775,94 @@ bool ble_transport_is_connected(void)
 	return nus_client_ready || hid_client_ready;
 }
 
-bool ble_transport_has_data_activity(void)
+#if defined(CONFIG_BT_USER_PHY_UPDATE)
+static uint8_t phy_to_hci(uint8_t phy)
 {
-	// Check if we've had data activity within the last 100ms
-	int64_t current_time = k_uptime_get();
-	if (data_activity && (current_time - last_data_time) < 100) {
-		LOG_DBG("BLE data activity detected (time diff: %lld ms)", current_time - last_data_time);
-		return true;
+	switch (phy) {
+	case BT_GAP_LE_PHY_1M:
+		return BT_HCI_LE_PHY_1M;
+	case BT_GAP_LE_PHY_2M:
+		return BT_HCI_LE_PHY_2M;
+	case BT_GAP_LE_PHY_CODED:
+		return BT_HCI_LE_PHY_CODED;
+	default:
+		return 0;
 	}
-	
-	// Reset if it's been too long
-	if ((current_time - last_data_time) >= 100) {
-		data_activity = false;
-	}
-	
-	return false;
 }
+#endif
 
-void ble_transport_mark_data_activity(void)
+int ble_transport_get_link_info(struct ble_transport_link_info *info)
 {
-	data_activity = true;
-	last_data_time = k_uptime_get();
-	LOG_DBG("=== DATA ACTIVITY MARKED (DIRECT) ===");
+	struct bt_conn *conn = ble_central_get_default_conn();
+	struct bt_conn_info conn_info;
+
+	memset(info, 0, sizeof(*info));
+	if (!conn || bt_conn_get_info(conn, &conn_info) != 0) {
+		return -ENOTCONN;
+	}
+
+	info->interval_us = conn_info.le.interval * 1250U;
+
+#if defined(CONFIG_BT_USER_PHY_UPDATE)
+	info->tx_phy = phy_to_hci(conn_info.le.phy->tx_phy);
+	info->rx_phy = phy_to_hci(conn_info.le.phy->rx_phy);
+#endif
+#if defined(CONFIG_BT_USER_DATA_LEN_UPDATE)
+	info->tx_max_len = conn_info.le.data_len->tx_max_len;
+	info->rx_max_len = conn_info.le.data_len->rx_max_len;
+#endif
+
+	return 0;
 }
 
-void ble_transport_mark_hid_data_activity(void)
+/* Consumers hear of the smoothed RSSI only when it moves past the hysteresis */
+static void rssi_publish(int8_t rssi)
 {
-	hid_data_activity = true;
-	last_hid_data_time = k_uptime_get();
-	LOG_DBG("=== HID DATA ACTIVITY MARKED ===");
+	published_rssi = rssi;
+	relay_bus_telemetry_rssi(rssi);
 }
 
-bool ble_transport_has_hid_data_activity(void)
+/* Fold a reading into the smoothed RSSI; the first of a connection seeds it */
+static int8_t rssi_smooth(int8_t sample)
 {
-	// Check if we've had HID data activity within the last 100ms
-	int64_t current_time = k_uptime_get();
-	if (hid_data_activity && (current_time - last_hid_data_time) < 100) {
-		LOG_DBG("HID data activity detected (time diff: %lld ms)", current_time - last_hid_data_time);
-		return true;
-	}
+	int32_t sample_x16 = (int32_t)sample * 16;
 
-	// Reset if it's been too long
-	if ((current_time - last_hid_data_time) >= 100) {
-		hid_data_activity = false;
+	if (rssi_read_count == 0) {
+		rssi_ewma_x16 = sample_x16;
+	} else {
+		rssi_ewma_x16 += (sample_x16 - rssi_ewma_x16) / (1 << RSSI_EWMA_SHIFT);
 	}
 
-	return false;
+	/* Round to the nearest dBm */
+	return (int8_t)((rssi_ewma_x16 + (rssi_ewma_x16 < 0 ? -8 : 8)) / 16);
 }
 
-int8_t ble_transport_get_rssi(void)
+static k_timeout_t rssi_read_interval(void)
 {
-	static int64_t last_rssi_read_time = 0;
-	static uint32_t rssi_read_attempts = 0;
-	
-	if (!ble_transport_is_connected()) {
-		return 0;  /* Return 0 for no connection */
+#if defined(CONFIG_BLE_LINK_GUARD)
+	if (link_guard_at_risk()) {
+		return K_MSEC(CONFIG_BLE_LINK_GUARD_READ_MS);
 	}
-	
-	/* Only try to read RSSI every 2 seconds to avoid overwhelming the system */
-	int64_t current_time = k_uptime_get();
-	if (current_time - last_rssi_read_time < 2000) {
-		LOG_DBG("Using cached RSSI: %d dBm", last_known_rssi);
-		return last_known_rssi;
-	}
-	
-	last_rssi_read_time = current_time;
-	rssi_read_attempts++;
-	
-	/* Get the connection and try to read real RSSI */
-	int8_t current_rssi = last_known_rssi;
-	struct bt_conn *conn = ble_central_get_default_conn();
-	
-	if (conn) {
-		/* Log connection info for debugging */
-		struct bt_conn_info info;
-		int err = bt_conn_get_info(conn, &info);
-		if (err == 0 && info.type == BT_CONN_TYPE_LE) {
-			LOG_DBG("Connection info - interval: %d, latency: %d, timeout: %d",
-			        info.le.interval, info.le.latency, info.le.timeout);
-			
-#if defined(CONFIG_BT_USER_PHY_UPDATE)
-			if (info.le.phy) {
-				LOG_DBG("PHY info - TX: %d, RX: %d", 
-				        info.le.phy->tx_phy, info.le.phy->rx_phy);
-			}
 #endif
-#if defined(CONFIG_BT_USER_DATA_LEN_UPDATE)
-			if (info.le.data_len) {
-				LOG_DBG("Data len - TX max: %d, RX max: %d",
-				        info.le.data_len->tx_max_len, info.le.data_len->rx_max_len);
-			}
-#endif
-		}
-		
-		/* Use the real RSSI value (updated by periodic nRF controller reads) */
-		current_rssi = last_known_rssi;
+	return relay_activity_level() == RELAY_ACTIVITY_DEEP_IDLE ? RSSI_READ_INTERVAL_DEEP_IDLE
+								  : RSSI_READ_INTERVAL;
+}
+
+/* Protocol work queue: move the pending read to the new interval */
+static void rssi_activity_changed(const struct zbus_channel *chan)
+{
+	ARG_UNUSED(chan);
+
+	if (rssi_reading_active && !rssi_paused) {
+		k_work_reschedule_for_queue(&relay_workq_background, &rssi_read_work,
+					    rssi_read_interval());
 	}
-	
-	/* Bound the RSSI to reasonable values */
-	if (current_rssi > -20) current_rssi = -20;
-	if (current_rssi < -100) current_rssi = -100;
-	
-	LOG_DBG("Current RSSI: %d dBm (real measurement)", current_rssi);
-	
-	return current_rssi;
 }
 
+ZBUS_LISTENER_DEFINE(rssi_activity, rssi_activity_changed);
+ZBUS_CHAN_ADD_OBS(relay_chan_activity, rssi_activity, RELAY_BUS_PRIO_CONTROL);
 
-/* RSSI work handler - reads actual connection RSSI using HCI command */
+/* RSSI work handler - reads actual connection RSSI using HCI command, on relay_workq_background */
 static void rssi_read_work_handler(struct k_work *work)
 {
 	if (!ble_transport_is_connected()) {
@@ -719,19 +881,26 @@ static void rssi_read_work_handler(struct k_work *work)
 	struct net_buf *buf, *rsp = NULL;
 	struct bt_hci_cp_read_rssi *cp;
 	struct bt_hci_rp_read_rssi *rp;
+	uint16_t handle;
 	int err;
 	
-	/* Allocate HCI command buffer */
-	buf = bt_hci_cmd_alloc(K_FOREVER);
+	err = bt_hci_get_conn_handle(conn, &handle);
+	if (err) {
+		LOG_WRN("No HCI handle for RSSI read (err %d)", err);
+		goto schedule_next;
+	}
+
+	/* Skip a reading rather than wait long for a command buffer */
+	buf = bt_hci_cmd_alloc(K_MSEC(100));
 	if (!buf) {
-		LOG_ERR("Failed to allocate HCI buffer for RSSI read");
+		LOG_WRN("No HCI buffer for RSSI read, skipping");
 		goto schedule_next;
 	}
 	
 	cp = net_buf_add(buf, sizeof(*cp));
-	cp->handle = sys_cpu_to_le16(bt_conn_index(conn));
+	cp->handle = sys_cpu_to_le16(handle);
 	
-	/* Send synchronous HCI Read RSSI command */
+	/* Blocks this queue only, for one HCI round-trip */
 	err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
 	if (err) {
 		LOG_ERR("HCI Read RSSI failed (err %d)", err);
@@ -744,24 +913,35 @@ static void rssi_read_work_handler(struct k_work *work)
 		goto cleanup_and_schedule;
 	}
 	
-	/* Update RSSI with real measurement */
-	int8_t new_rssi = rp->rssi;
+	/* Report the smoothed value so single-event fades do not show */
+	int8_t new_rssi = rssi_smooth(rp->rssi);
 	
 	/* Log RSSI updates */
-	static uint32_t rssi_read_count = 0;
 	rssi_read_count++;
 	
 	if (rssi_read_count == 1) {
-		LOG_INF("=== REAL-TIME CONNECTION RSSI ===");
-		LOG_INF("Successfully reading live connection RSSI via HCI commands!");
 		LOG_INF("Initial connection RSSI: %d dBm", new_rssi);
-	} else if (new_rssi != last_known_rssi) {
-		LOG_INF("RSSI CHANGE: %d -> %d dBm (signal strength updated)", last_known_rssi, new_rssi);
+		rssi_publish(new_rssi);
+	} else if (abs(new_rssi - published_rssi) >= CONFIG_BLE_RSSI_REPORT_HYSTERESIS) {
+		LOG_INF("RSSI CHANGE: %d -> %d dBm (raw %d dBm)", published_rssi, new_rssi, rp->rssi);
+		rssi_publish(new_rssi);
 	} else if (rssi_read_count % 15 == 0) {  /* Every 30 seconds */
 		LOG_INF("Connection RSSI: %d dBm (stable)", new_rssi);
 	}
 	
 	last_known_rssi = new_rssi;
+
+	/* Ahead of a drop: more range now, and a quicker reconnect if it comes */
+	bool at_risk = IS_ENABLED(CONFIG_BLE_LINK_GUARD) &&
+		       link_guard_sample(new_rssi, k_uptime_get_32());
+
+	if (at_risk != at_risk_applied) {
+		LOG_WRN("Link %s (RSSI %d dBm)", at_risk ? "at risk" : "safe again", new_rssi);
+		at_risk_applied = at_risk;
+		ble_conn_params_at_risk(at_risk);
+	}
+	ble_phy_rssi(new_rssi, at_risk);
+	ble_tx_power_rssi(new_rssi, at_risk);
 	
 cleanup_and_schedule:
 	if (rsp) {
@@ -769,9 +949,20 @@ cleanup_and_schedule:
 	}
 
 schedule_next:
-	/* Schedule next RSSI reading in 2 seconds */
-	if (rssi_reading_active) {
-		k_work_schedule(&rssi_read_work, K_SECONDS(2));
+	/* Schedule next RSSI reading, 2 s or 10 s once deep idle, faster at risk */
+	if (rssi_reading_active && !rssi_paused) {
+		k_work_schedule_for_queue(&relay_workq_background, &rssi_read_work, rssi_read_interval());
+	}
+}
+
+void ble_transport_set_rssi_paused(bool paused)
+{
+	rssi_paused = paused;
+
+	if (paused) {
+		k_work_cancel_delayable(&rssi_read_work);
+	} else if (rssi_reading_active) {
+		k_work_schedule_for_queue(&relay_workq_background, &rssi_read_work, K_NO_WAIT);
 	}
 }
 
@@ -779,6 +970,7 @@ void ble_transport_set_rssi(int8_t rssi)
 {
 	last_known_rssi = rssi;
 	LOG_DBG("RSSI updated to %d dBm", rssi);
+	rssi_publish(rssi);
 }
 
 void ble_transport_set_device_name(const char *name)
@@ -787,6 +979,7 @@ void ble_transport_set_device_name(const char *name)
 		strncpy(connected_device_name, name, sizeof(connected_device_name) - 1);
 		connected_device_name[sizeof(connected_device_name) - 1] = '\0';
 		LOG_INF("Connected device name set to: %s", connected_device_name);
+		relay_device_info_invalidate();
 	}
 }
 
@@ -11,6 +11,8 @@
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/conn.h>
 
+#include "pass_through_ack.h"
+
 /* Callback function types */
 typedef void (*ble_data_callback_t)(const uint8_t *data, uint16_t len);
 typedef void (*ble_ready_callback_t)(void);
@@ -27,16 +29,60 @@ int ble_transport_register_usb_cdc_callback(usb_cdc_send_cb_t cb);
 int ble_transport_register_usb_hid_callback(ble_data_callback_t cb);
 
 /* NUS Transport functions */
-int ble_transport_send_nus_data(const uint8_t *data, uint16_t len);
+int ble_transport_send_nus_data(const uint8_t *data, uint16_t len, bool reliable,
+				struct pass_through_ack_tag ack);
 bool ble_transport_is_nus_ready(void);
 
+/* Called as each NUS write completes; err is an ATT error code, 0 on
+ * success, and ack is what the write was sent with
+ */
+typedef void (*ble_nus_sent_callback_t)(uint8_t err, struct pass_through_ack_tag ack);
+int ble_transport_register_nus_sent_callback(ble_nus_sent_callback_t cb);
+
+/* Acknowledged NUS write reported to cb instead of the sent callback, with
+ * when it was issued and completed in relay_time_us64(); issued is 0 if the
+ * write never went out. cb is called exactly once if this returns 0.
+ */
+typedef void (*ble_nus_timed_callback_t)(uint8_t err, int64_t issued, int64_t completed);
+int ble_transport_send_nus_timed(const uint8_t *data, uint16_t len, ble_nus_timed_callback_t cb);
+
+/* Bulk stream write without response (nus_stream.h), reported to cb in
+ * order like a timed write; issued is 0 if it never went out. Goes over
+ * the bulk L2CAP channel (ble_l2cap_bulk.h) instead while that is open.
+ */
+int ble_transport_send_nus_stream(const uint8_t *data, uint16_t len, ble_nus_timed_callback_t cb);
+
+/* Payload of one NUS write on the current link: ATT MTU - 3, capped at the
+ * NUS TX slot size; 0 while NUS is not ready
+ */
+uint16_t ble_transport_get_nus_write_len(void);
+
+/* Payload of one bulk stream write: an SDU on the bulk L2CAP channel while
+ * the stream uses it, otherwise as ble_transport_get_nus_write_len()
+ */
+uint16_t ble_transport_get_stream_write_len(void);
+
+/* NUS writes that may be outstanding at once without a -ENOBUFS */
+uint8_t ble_transport_get_nus_tx_window(void);
+
+/* NUS writes queued or in flight right now */
+uint8_t ble_transport_get_nus_tx_pending(void);
+
 /* Connection status */
 bool ble_transport_is_connected(void);
-bool ble_transport_has_data_activity(void);
-bool ble_transport_has_hid_data_activity(void);
-void ble_transport_mark_hid_data_activity(void);
-int8_t ble_transport_get_rssi(void);
 void ble_transport_set_rssi(int8_t rssi);
+/* Stop the periodic RSSI reads while nothing displays them */
+void ble_transport_set_rssi_paused(bool paused);
+
+/* Negotiated link layer settings; PHYs use HCI codes (1 = 1M, 2 = 2M, 3 = Coded) */
+struct ble_transport_link_info {
+	uint8_t tx_phy;
+	uint8_t rx_phy;
+	uint16_t tx_max_len;
+	uint16_t rx_max_len;
+	uint32_t interval_us;
+};
+int ble_transport_get_link_info(struct ble_transport_link_info *info);
 
 /* Device name functions */
 void ble_transport_set_device_name(const char *name);
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief TX power of the primary link, closed on its smoothed RSSI
+ *
+ * The level comes from the shared controller (tx_power.h) and is applied
+ * to the connection handle with the Zephyr vendor Write TX Power Level
+ * command, which the SoftDevice Controller rounds to a step the radio has.
+ * Advertising and scanning keep CONFIG_BT_CTLR_TX_PWR_DBM.
+ *
+ * With LE Power Control (CONFIG_BT_TRANSMIT_POWER_CONTROL) the MouthPad is
+ * asked for its TX power at connect, and reports each change, so the path
+ * loss does not rest on CONFIG_BLE_TX_POWER_PEER_DBM.
+ *
+ * While the link guard (link_guard.h) expects the link to drop, the level
+ * is held at CONFIG_BT_CTLR_TX_PWR_DBM. The target follows the tuning
+ * profile (relay_tuning.h).
+ *
+ * The readings arrive on relay_workq_background, which also sends the
+ * command.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/init.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/hci_vs.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "ble_tx_power.h"
+#include "ble_central.h"
+#include "tx_power.h"
+#include "tuning_profile.h"
+
+LOG_MODULE_REGISTER(ble_tx_power, LOG_LEVEL_INF);
+
+BUILD_ASSERT(CONFIG_BLE_TX_POWER_MIN_DBM <= CONFIG_BT_CTLR_TX_PWR_DBM,
+	     "Minimum TX power above the controller's default");
+
+/* LE Power Control: TX power not available */
+#define TX_POWER_UNAVAILABLE 127
+
+static int set_level(struct bt_conn *conn, int8_t level, int8_t *selected)
+{
+	struct bt_hci_cp_vs_write_tx_power_level *cp;
+	struct bt_hci_rp_vs_write_tx_power_level *rp;
+	struct net_buf *buf, *rsp = NULL;
+	uint16_t handle;
+	int err;
+
+	err = bt_hci_get_conn_handle(conn, &handle);
+	if (err) {
+		return err;
+	}
+
+	buf = bt_hci_cmd_alloc(K_MSEC(100));
+	if (!buf) {
+		return -ENOBUFS;
+	}
+
+	cp = net_buf_add(buf, sizeof(*cp));
+	cp->handle_type = BT_HCI_VS_LL_HANDLE_TYPE_CONN;
+	cp->handle = sys_cpu_to_le16(handle);
+	cp->tx_power_level = level;
+
+	/* Blocks this queue only, for one HCI round-trip */
+	err = bt_hci_cmd_send_sync(BT_HCI_OP_VS_WRITE_TX_POWER_LEVEL, buf, &rsp);
+	if (err) {
+		return err;
+	}
+
+	rp = (void *)rsp->data;
+	err = rp->status ? -EIO : 0;
+	*selected = rp->selected_tx_power;
+	net_buf_unref(rsp);
+	return err;
+}
+
+void ble_tx_power_connected(struct bt_conn *conn)
+{
+	tx_power_applied(tx_power_connected());
+
+#if defined(CONFIG_BT_TRANSMIT_POWER_CONTROL)
+	int err = bt_conn_le_enable_tx_power_reporting(conn, false, true);
+
+	if (!err) {
+		err = bt_conn_le_get_remote_tx_power_level(conn, BT_CONN_LE_TX_POWER_PHY_1M);
+	}
+	if (err) {
+		LOG_DBG("No LE Power Control (err %d), assuming %d dBm", err,
+			CONFIG_BLE_TX_POWER_PEER_DBM);
+	}
+#else
+	ARG_UNUSED(conn);
+#endif
+}
+
+void ble_tx_power_rssi(int8_t rssi, bool at_risk)
+{
+	struct bt_conn *conn = ble_central_get_default_conn();
+	struct tx_power_status status;
+	int8_t want;
+	int8_t selected;
+	int err;
+
+	if (!conn) {
+		return;
+	}
+
+	tx_power_set_target(tuning_profile_get(
+		mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_TX_POWER_TARGET));
+	tx_power_get_status(&status);
+	want = at_risk ? CONFIG_BT_CTLR_TX_PWR_DBM : tx_power_update(rssi);
+	if (want == status.level_dbm) {
+		return;
+	}
+
+	err = set_level(conn, want, &selected);
+	if (err) {
+		LOG_WRN("Failed to set TX power %d dBm (err %d)", want, err);
+		return;
+	}
+
+	tx_power_applied(selected);
+	LOG_INF("TX power %+d -> %+d dBm (RSSI %d dBm)", status.level_dbm, selected, rssi);
+}
+
+#if defined(CONFIG_BT_TRANSMIT_POWER_CONTROL)
+static void tx_power_report(struct bt_conn *conn, const struct bt_conn_le_tx_power_report *report)
+{
+	if (conn != ble_central_get_default_conn() ||
+	    report->reason == BT_HCI_LE_TX_POWER_REPORT_REASON_LOCAL_CHANGED ||
+	    report->tx_power_level == TX_POWER_UNAVAILABLE) {
+		return;
+	}
+
+	LOG_INF("MouthPad TX power %d dBm", report->tx_power_level);
+	tx_power_peer_tx(report->tx_power_level);
+}
+
+BT_CONN_CB_DEFINE(tx_power_callbacks) = {
+	.tx_power_report = tx_power_report,
+};
+#endif
+
+static int ble_tx_power_init(void)
+{
+	const struct tx_power_config config = {
+		.min_dbm = CONFIG_BLE_TX_POWER_MIN_DBM,
+		.max_dbm = CONFIG_BT_CTLR_TX_PWR_DBM,
+		.target_dbm = CONFIG_BLE_TX_POWER_TARGET_DBM,
+		.margin_db = CONFIG_BLE_TX_POWER_MARGIN_DB,
+		.step_db = CONFIG_BLE_TX_POWER_STEP_DB,
+		.peer_tx_dbm = CONFIG_BLE_TX_POWER_PEER_DBM,
+	};
+
+	tx_power_init(&config);
+	return 0;
+}
+
+SYS_INIT(ble_tx_power_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BLE_TX_POWER_H_
+#define BLE_TX_POWER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/bluetooth/conn.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_BLE_TX_POWER_ADAPTIVE)
+
+/**
+ * @brief Start controlling the TX power of a new primary connection
+ *
+ * The connection starts at CONFIG_BT_CTLR_TX_PWR_DBM; with LE Power Control
+ * the MouthPad is asked for its own TX power.
+ *
+ * @param conn Newly established connection
+ */
+void ble_tx_power_connected(struct bt_conn *conn);
+
+/**
+ * @brief Feed one smoothed RSSI reading of the primary connection
+ *
+ * Blocks for one HCI round-trip when the level changes.
+ *
+ * @param rssi Smoothed connection RSSI in dBm
+ * @param at_risk The link guard expects the link to drop: full power
+ */
+void ble_tx_power_rssi(int8_t rssi, bool at_risk);
+
+#else
+
+static inline void ble_tx_power_connected(struct bt_conn *conn)
+{
+	ARG_UNUSED(conn);
+}
+
+static inline void ble_tx_power_rssi(int8_t rssi, bool at_risk)
+{
+	ARG_UNUSED(rssi);
+	ARG_UNUSED(at_risk);
+}
+
+#endif /* CONFIG_BLE_TX_POWER_ADAPTIVE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_TX_POWER_H_ */
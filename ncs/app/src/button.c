@@ -12,14 +12,17 @@
 #include <zephyr/logging/log.h>
 
 #include "button.h"
+#include "relay_workq.h"
 
 #define LOG_MODULE_NAME button
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 /* Button timing constants */
 #define DEBOUNCE_TIME_MS        50      /* Button debounce time */
-#define DOUBLE_CLICK_TIMEOUT_MS 300     /* Max time between clicks for double-click */
+#define DOUBLE_CLICK_TIMEOUT_MS 300     /* Max time between clicks of a double or triple click */
 #define HOLD_TIME_MS            2000    /* Time to trigger hold event */
+#define SETTLE_TIME_MS          10      /* Pull-up settling before the first read */
+#define POLL_INTERVAL_MS        10      /* Sampling when the pin has no interrupt */
 
 /* Button detection - check for sw0 alias (standard user button) */
 #if DT_NODE_EXISTS(DT_ALIAS(sw0)) && DT_NODE_HAS_PROP(DT_ALIAS(sw0), gpios)
@@ -33,26 +36,64 @@ static const struct gpio_dt_spec button = GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios)
 static bool button_ready = false;
 static button_event_callback_t event_callback = NULL;
 static bool pin_stuck_low = false;  /* Workaround for hardware issue */
+static bool pin_settled = false;    /* Initial level read, stuck-low decided */
+#if HAS_USER_BUTTON
+static struct gpio_callback button_cb;
+#endif
 
 /* Button state machine */
 typedef enum {
     BUTTON_STATE_IDLE,
     BUTTON_STATE_PRESSED,
-    BUTTON_STATE_RELEASED,
     BUTTON_STATE_WAIT_DOUBLE,
     BUTTON_STATE_HOLD_DETECTED,
 } button_state_t;
 
+/* The pin interrupt (or, without one, a sampling timer) restarts the
+ * debounce timer on every edge. The state machine runs from the timer
+ * callbacks once the level has been stable for DEBOUNCE_TIME_MS, with
+ * one-shot timers for hold and double-click timing, so the main thread
+ * never has to poll. Clicks are counted until DOUBLE_CLICK_TIMEOUT_MS
+ * pass without another press; a third click is reported at once. Events are handed to the background work queue
+ * because the hold action clears bonds from flash.
+ */
 static button_state_t button_state = BUTTON_STATE_IDLE;
-static uint32_t button_timer = 0;
-static uint32_t press_start_time = 0;
-static bool button_pressed_raw = false;
 static bool button_pressed_debounced = false;
+static int64_t press_start_time;
+static uint8_t clicks; /* Released so far in this click sequence */
+static struct k_spinlock state_lock;
+
+static void debounce_timer_handler(struct k_timer *timer);
+static void hold_timer_handler(struct k_timer *timer);
+static void double_click_timer_handler(struct k_timer *timer);
+static void sample_timer_handler(struct k_timer *timer);
+static K_TIMER_DEFINE(debounce_timer, debounce_timer_handler, NULL);
+static K_TIMER_DEFINE(hold_timer, hold_timer_handler, NULL);
+static K_TIMER_DEFINE(double_click_timer, double_click_timer_handler, NULL);
+static K_TIMER_DEFINE(sample_timer, sample_timer_handler, NULL);
+
+K_MSGQ_DEFINE(button_event_queue, sizeof(button_event_t), 4, 4);
+static void button_event_work_handler(struct k_work *work);
+static K_WORK_DEFINE(button_event_work, button_event_work_handler);
 
 /* Private function declarations */
-static void process_button_state_machine(void);
+static bool read_pressed_raw(void);
 static void trigger_button_event(button_event_t event);
 
+#if HAS_USER_BUTTON
+static void button_edge(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+    ARG_UNUSED(port);
+    ARG_UNUSED(cb);
+    ARG_UNUSED(pins);
+
+    /* Restarted on every bounce; fires once the level holds */
+    if (pin_settled) {
+        k_timer_start(&debounce_timer, K_MSEC(DEBOUNCE_TIME_MS), K_NO_WAIT);
+    }
+}
+#endif
+
 int button_init(void)
 {
     int ret;
@@ -73,23 +114,23 @@ int button_init(void)
         return ret;
     }
     
-    /* Give pull-up time to settle */
-    k_sleep(K_MSEC(10));
-    
-    /* Test initial pin state and detect stuck-low condition */
-    int initial_state = gpio_pin_get_dt(&button);
-    LOG_INF("User button GPIO configured. Port: %p, Pin: %d, Initial state: %d", 
-            button.port, button.pin, initial_state);
-    
-    /* Check if pin is stuck low (common hardware issue) */
-    if (initial_state == 0) {
-        LOG_WRN("Button pin appears stuck low - enabling workaround mode");
-        pin_stuck_low = true;
+    /* Both edges, so presses and releases (or the stuck-low pulses) are seen */
+    gpio_init_callback(&button_cb, button_edge, BIT(button.pin));
+    ret = gpio_add_callback(button.port, &button_cb);
+    if (ret == 0) {
+        ret = gpio_pin_interrupt_configure_dt(&button, GPIO_INT_EDGE_BOTH);
+    }
+    if (ret != 0) {
+        LOG_WRN("Button interrupt unavailable (err %d) - sampling every %d ms", ret,
+                POLL_INTERVAL_MS);
+        k_timer_start(&sample_timer, K_MSEC(POLL_INTERVAL_MS), K_MSEC(POLL_INTERVAL_MS));
     }
     
     button_ready = true;
     button_state = BUTTON_STATE_IDLE;
-    button_timer = 0;
+    
+    /* The first debounce expiry reads the initial level once the pull-up settled */
+    k_timer_start(&debounce_timer, K_MSEC(SETTLE_TIME_MS), K_NO_WAIT);
     
     LOG_INF("User button initialized successfully");
 #else
@@ -110,148 +151,149 @@ bool button_is_available(void)
     return button_ready;
 }
 
-int button_update(void)
+/* Private function implementations */
+
+static bool read_pressed_raw(void)
 {
-    if (!button_ready) {
-        return 0;  /* Silently ignore if no button */
-    }
-    
 #if HAS_USER_BUTTON
-    /* Read raw button state */
     int pin_state = gpio_pin_get_dt(&button);
     
     if (pin_stuck_low) {
         /* Workaround: if pin is stuck low, treat brief high pulses as button presses */
-        button_pressed_raw = (pin_state == 1);  /* High pulse means pressed */
-    } else {
-        /* Normal operation: active low */
-        button_pressed_raw = (pin_state == 0);  /* Active low - 0 means pressed */
+        return pin_state == 1;  /* High pulse means pressed */
     }
     
-    /* Debug logging for troubleshooting */
-    static uint32_t last_debug_time = 0;
-    static int last_pin_state = -1;
-    
-    uint32_t current_time = k_uptime_get_32();
-    
-    /* Log when pin state changes or periodically */
-    if (pin_state != last_pin_state || (current_time - last_debug_time) > 1000) {
-        // LOG_INF("BUTTON DEBUG: pin=%d, raw=%d, debounced=%d, state=%d", 
-        //         pin_state, button_pressed_raw, button_pressed_debounced, button_state);
-        last_pin_state = pin_state;
-        last_debug_time = current_time;
-    }
-    
-    /* Simple debouncing */
-    static uint32_t last_debounce_time = 0;
-    static bool last_raw_state = false;
-    
-    if (button_pressed_raw != last_raw_state) {
-        last_debounce_time = k_uptime_get_32();
-    }
-    
-    if ((k_uptime_get_32() - last_debounce_time) > DEBOUNCE_TIME_MS) {
-        button_pressed_debounced = button_pressed_raw;
-    }
-    
-    last_raw_state = button_pressed_raw;
-    
-    /* Process button state machine */
-    process_button_state_machine();
+    /* Normal operation: active low */
+    return pin_state == 0;  /* Active low - 0 means pressed */
+#else
+    return false;
 #endif
-    
-    return 0;
 }
 
-/* Private function implementations */
-
-static void process_button_state_machine(void)
+/* Level stable for DEBOUNCE_TIME_MS (or, the first time, the pull-up settled) */
+static void debounce_timer_handler(struct k_timer *timer)
 {
-    uint32_t current_time = k_uptime_get_32();
-    static button_state_t last_state = BUTTON_STATE_IDLE;
-    
-    /* Log state changes */
-    if (button_state != last_state) {
-        LOG_INF("STATE CHANGE: %d -> %d", last_state, button_state);
-        last_state = button_state;
-    }
-    
-    switch (button_state) {
-    case BUTTON_STATE_IDLE:
-        if (button_pressed_debounced) {
-            button_state = BUTTON_STATE_PRESSED;
-            press_start_time = current_time;
-            LOG_INF("=== BUTTON PRESSED - STARTING TIMER ===");
-        }
-        break;
+    ARG_UNUSED(timer);
+
+#if HAS_USER_BUTTON
+    if (!pin_settled) {
+        /* Test initial pin state and detect stuck-low condition */
+        int initial_state = gpio_pin_get_dt(&button);
+        LOG_INF("User button GPIO configured. Port: %p, Pin: %d, Initial state: %d", 
+                button.port, button.pin, initial_state);
         
-    case BUTTON_STATE_PRESSED:
-        if (!button_pressed_debounced) {
-            /* Button released */
-            uint32_t press_duration = current_time - press_start_time;
-            LOG_INF("=== BUTTON RELEASED - Duration: %u ms ===", press_duration);
-            
-            if (press_duration >= HOLD_TIME_MS) {
-                /* Hold was already detected, go back to idle */
-                button_state = BUTTON_STATE_IDLE;
-                LOG_INF("Released after hold detection");
-            } else {
-                /* Normal press/release - wait for potential double-click */
-                button_state = BUTTON_STATE_WAIT_DOUBLE;
-                button_timer = current_time;
-                LOG_INF("Short press - waiting for double-click (%u ms)", press_duration);
-            }
-        } else {
-            /* Still pressed - check for hold */
-            uint32_t press_duration = current_time - press_start_time;
-            if (press_duration >= HOLD_TIME_MS) {
-                button_state = BUTTON_STATE_HOLD_DETECTED;
-                trigger_button_event(BUTTON_EVENT_HOLD);
-                LOG_INF("=== HOLD EVENT TRIGGERED - Duration: %u ms ===", press_duration);
-            } else {
-                /* Log progress towards hold every 500ms */
-                static uint32_t last_progress_log = 0;
-                if ((current_time - last_progress_log) > 500) {
-                    LOG_DBG("Hold progress: %u/%u ms", press_duration, HOLD_TIME_MS);
-                    last_progress_log = current_time;
-                }
-            }
+        /* Check if pin is stuck low (common hardware issue) */
+        if (initial_state == 0) {
+            LOG_WRN("Button pin appears stuck low - enabling workaround mode");
+            pin_stuck_low = true;
         }
-        break;
-        
-    case BUTTON_STATE_WAIT_DOUBLE:
-        if (button_pressed_debounced) {
-            /* Second press detected */
-            button_state = BUTTON_STATE_PRESSED;
-            press_start_time = current_time;
-            trigger_button_event(BUTTON_EVENT_DOUBLE_CLICK);
-            LOG_DBG("Double-click event triggered");
-        } else if ((current_time - button_timer) >= DOUBLE_CLICK_TIMEOUT_MS) {
-            /* Timeout - single click */
-            button_state = BUTTON_STATE_IDLE;
-            trigger_button_event(BUTTON_EVENT_CLICK);
-            LOG_DBG("Single click event triggered");
+        pin_settled = true;
+        return;
+    }
+#endif
+
+    bool pressed = read_pressed_raw();
+    k_spinlock_key_t key = k_spin_lock(&state_lock);
+
+    if (pressed == button_pressed_debounced) {
+        k_spin_unlock(&state_lock, key);
+        return;  /* Bounced back */
+    }
+    button_pressed_debounced = pressed;
+
+    if (pressed) {
+        if (button_state == BUTTON_STATE_WAIT_DOUBLE) {
+            /* Another click of the sequence */
+            k_timer_stop(&double_click_timer);
+        } else {
+            clicks = 0;
+            LOG_INF("=== BUTTON PRESSED - STARTING TIMER ===");
         }
-        break;
-        
-    case BUTTON_STATE_HOLD_DETECTED:
-        if (!button_pressed_debounced) {
-            /* Button released after hold */
+        button_state = BUTTON_STATE_PRESSED;
+        press_start_time = k_uptime_get();
+        k_timer_start(&hold_timer, K_MSEC(HOLD_TIME_MS), K_NO_WAIT);
+    } else if (button_state == BUTTON_STATE_PRESSED) {
+        k_timer_stop(&hold_timer);
+        if (++clicks == 3) {
             button_state = BUTTON_STATE_IDLE;
-            LOG_DBG("Button released after hold");
+            trigger_button_event(BUTTON_EVENT_TRIPLE_CLICK);
+            LOG_DBG("Triple-click event triggered");
+        } else {
+            /* Normal press/release - wait for another click */
+            button_state = BUTTON_STATE_WAIT_DOUBLE;
+            k_timer_start(&double_click_timer, K_MSEC(DOUBLE_CLICK_TIMEOUT_MS), K_NO_WAIT);
+            LOG_INF("Short press %u - waiting for another click (%u ms)", clicks,
+                    (uint32_t)(k_uptime_get() - press_start_time));
         }
-        break;
+    } else if (button_state == BUTTON_STATE_HOLD_DETECTED) {
+        /* Button released after hold */
+        button_state = BUTTON_STATE_IDLE;
+        LOG_DBG("Button released after hold");
+    }
+
+    k_spin_unlock(&state_lock, key);
+}
+
+static void hold_timer_handler(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    k_spinlock_key_t key = k_spin_lock(&state_lock);
+    if (button_state == BUTTON_STATE_PRESSED) {
+        button_state = BUTTON_STATE_HOLD_DETECTED;
+        trigger_button_event(BUTTON_EVENT_HOLD);
+        LOG_INF("=== HOLD EVENT TRIGGERED - Duration: %u ms ===", HOLD_TIME_MS);
+    }
+    k_spin_unlock(&state_lock, key);
+}
+
+static void double_click_timer_handler(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
 
-    case BUTTON_STATE_RELEASED:
-        /* Unused state - retained for compatibility */
+    k_spinlock_key_t key = k_spin_lock(&state_lock);
+    if (button_state == BUTTON_STATE_WAIT_DOUBLE) {
+        /* Timeout - the sequence ended at one or two clicks */
         button_state = BUTTON_STATE_IDLE;
-        break;
+        trigger_button_event(clicks == 1 ? BUTTON_EVENT_CLICK : BUTTON_EVENT_DOUBLE_CLICK);
+        LOG_DBG("%s event triggered", clicks == 1 ? "Single click" : "Double-click");
+    }
+    k_spin_unlock(&state_lock, key);
+}
+
+/* Fallback without a pin interrupt: treat a level change like an edge */
+static void sample_timer_handler(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    static bool last_raw_state;
+    bool pressed = read_pressed_raw();
+
+    if (pin_settled && pressed != last_raw_state) {
+        k_timer_start(&debounce_timer, K_MSEC(DEBOUNCE_TIME_MS), K_NO_WAIT);
     }
+    last_raw_state = pressed;
 }
 
+/* Timer context: queue the event for the callback on the background queue */
 static void trigger_button_event(button_event_t event)
 {
-    if (event_callback) {
-        event_callback(event);
+    if (k_msgq_put(&button_event_queue, &event, K_NO_WAIT) != 0) {
+        LOG_WRN("Button event %d dropped", event);
+        return;
+    }
+    k_work_submit_to_queue(&relay_workq_background, &button_event_work);
+}
+
+static void button_event_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    button_event_t event;
+
+    while (k_msgq_get(&button_event_queue, &event, K_NO_WAIT) == 0) {
+        if (event_callback) {
+            event_callback(event);
+        }
     }
-}
\ No newline at end of file
+}
@@ -8,8 +8,10 @@
 #ifndef BUTTON_H_
 #define BUTTON_H_
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <zephyr/sys/util.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,6 +24,7 @@ typedef enum {
     BUTTON_EVENT_NONE,         /**< No event */
     BUTTON_EVENT_CLICK,        /**< Single click */
     BUTTON_EVENT_DOUBLE_CLICK, /**< Double click */
+    BUTTON_EVENT_TRIPLE_CLICK, /**< Triple click */
     BUTTON_EVENT_HOLD,         /**< Long hold */
 } button_event_t;
 
@@ -32,18 +35,24 @@ typedef enum {
  */
 typedef void (*button_event_callback_t)(button_event_t event);
 
+#if defined(CONFIG_RELAY_BUTTON)
+
 /**
  * @brief Initialize the button subsystem
  * 
  * Detects and configures available user button (XIAO expansion board or Feather)
  * 
- * @return 0 on success, negative error code on failure
+ * @return 0 on success, -ENOTSUP without CONFIG_RELAY_BUTTON, or another
+ *         negative error code on failure
  */
 int button_init(void);
 
 /**
  * @brief Register callback for button events
  * 
+ * Called from the background work queue; the pin interrupt and timers
+ * drive the button, no polling is needed.
+ * 
  * @param callback Function to call when button events occur
  */
 void button_register_callback(button_event_callback_t callback);
@@ -55,15 +64,24 @@ void button_register_callback(button_event_callback_t callback);
  */
 bool button_is_available(void);
 
-/**
- * @brief Update button state and process events
- * 
- * Should be called periodically from main loop to handle
- * button debouncing and event detection
- * 
- * @return 0 on success, negative error code on failure
- */
-int button_update(void);
+#else
+
+static inline int button_init(void)
+{
+	return -ENOTSUP;
+}
+
+static inline void button_register_callback(button_event_callback_t callback)
+{
+	ARG_UNUSED(callback);
+}
+
+static inline bool button_is_available(void)
+{
+	return false;
+}
+
+#endif /* CONFIG_RELAY_BUTTON */
 
 #ifdef __cplusplus
 }
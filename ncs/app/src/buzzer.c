@@ -11,6 +11,8 @@
 #include <zephyr/logging/log.h>
 
 #include "buzzer.h"
+#include "relay_bus.h"
+#include "relay_workq.h"
 
 #define LOG_MODULE_NAME buzzer
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -23,23 +25,145 @@ static bool buzzer_available = false;
 /* PWM channel for buzzer */
 #define BUZZER_PWM_CHANNEL 0
 
-/* Click sound parameters */
-#define CLICK_FREQUENCY_HZ  2000    /* 2kHz click */
-#define CLICK_DURATION_MS   5       /* 5ms short click */
+/* Tone sequencer: each sound is a table of steps played by a delayable work
+ * item on the background work queue. Callers, including the BT RX path,
+ * only put a request on a small queue; PWM is reconfigured from the work
+ * item, and sounds play one after another in the order requested.
+ */
+struct tone_step {
+    uint16_t frequency_hz;  /* 0 = silent gap */
+    uint32_t duration_us;
+};
+
+#define TONE(hz, us) { .frequency_hz = (hz), .duration_us = (us) }
+
+static const struct tone_step click_left_steps[] = {
+    TONE(2500, 4000),    /* Higher pitch, short duration */
+};
+
+static const struct tone_step click_right_steps[] = {
+    TONE(1800, 6000),    /* Lower pitch, slightly longer */
+};
+
+static const struct tone_step click_double_steps[] = {
+    TONE(3000, 3000),    /* Two short high-pitched beeps */
+    TONE(0, 2000),
+    TONE(3000, 3000),
+};
+
+static const struct tone_step click_mechanical_steps[] = {
+    TONE(800, 2000),     /* Mimics a mechanical switch */
+};
+
+static const struct tone_step click_pop_steps[] = {
+    TONE(2000, 1000),    /* Quick sweep from high to low */
+    TONE(0, 500),
+    TONE(1500, 1000),
+    TONE(0, 500),
+    TONE(1000, 1000),
+};
+
+static const struct tone_step connected_steps[] = {
+    TONE(800, 80000),    /* Low C */
+    TONE(0, 10000),
+    TONE(1000, 80000),   /* E */
+    TONE(0, 10000),
+    TONE(1200, 120000),  /* G - longer and higher */
+};
+
+static const struct tone_step disconnected_steps[] = {
+    TONE(1200, 80000),   /* High G */
+    TONE(0, 10000),
+    TONE(1000, 80000),   /* E */
+    TONE(0, 10000),
+    TONE(800, 120000),   /* Low C - longer and lower */
+};
+
+struct tone_request {
+    const struct tone_step *steps;  /* NULL: single beep below */
+    uint8_t count;
+    struct tone_step beep;
+};
+
+#define TONE_QUEUE_DEPTH 4
+
+K_MSGQ_DEFINE(tone_queue, sizeof(struct tone_request), TONE_QUEUE_DEPTH, 4);
+
+static struct k_work_delayable sequencer_work;
+static struct tone_request current;  /* Only touched by sequencer_work and buzzer_stop */
+static uint8_t current_step;
+static bool playing;
+
+static void buzzer_pwm_set(uint32_t frequency_hz)
+{
+    struct pwm_dt_spec pwm_spec = {
+        .dev = pwm_dev,
+        .channel = BUZZER_PWM_CHANNEL,
+        .flags = PWM_POLARITY_NORMAL
+    };
+    uint32_t period_ns = 0;
+    int ret;
+
+    if (frequency_hz > 0) {
+        /* Calculate PWM period from frequency, 50% duty cycle */
+        period_ns = 1000000000U / frequency_hz;
+    }
+
+    pwm_spec.period = period_ns;
+    ret = pwm_set_dt(&pwm_spec, period_ns, period_ns / 2);
+    if (ret != 0) {
+        LOG_ERR("Failed to set PWM for buzzer (err %d)", ret);
+    }
+}
+
+/* Play the next step of the current sound, or start the next queued one */
+static void sequencer_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
 
-/* Work queue for non-blocking buzzer operations */
-static struct k_work_delayable buzzer_stop_work;
+    if (playing) {
+        current_step++;
+    }
+
+    uint8_t count = current.steps ? current.count : 1;
+
+    if (!playing || current_step >= count) {
+        if (k_msgq_get(&tone_queue, &current, K_NO_WAIT) != 0) {
+            buzzer_pwm_set(0);
+            playing = false;
+            LOG_DBG("Buzzer stopped");
+            return;
+        }
+        playing = true;
+        current_step = 0;
+    }
+
+    const struct tone_step *step = current.steps ? &current.steps[current_step] : &current.beep;
 
-/* Function to stop buzzer after delay */
-static void buzzer_stop_work_handler(struct k_work *work) __maybe_unused;
-static void buzzer_stop_work_handler(struct k_work *work)
+    buzzer_pwm_set(step->frequency_hz);
+    k_work_schedule_for_queue(&relay_workq_background, &sequencer_work,
+                              K_USEC(step->duration_us));
+}
+
+/* Queue a sound; safe from any context, including BT callbacks */
+static void sequencer_post(const struct tone_request *req)
 {
-    if (buzzer_ready && pwm_dev) {
-        pwm_set_dt(&(struct pwm_dt_spec){pwm_dev, BUZZER_PWM_CHANNEL, 0, PWM_POLARITY_NORMAL}, 0, 0);
-        LOG_DBG("Buzzer stopped");
+    if (!buzzer_available || !buzzer_ready) {
+        return;  /* Silently skip if no buzzer */
+    }
+
+    if (k_msgq_put(&tone_queue, req, K_NO_WAIT) != 0) {
+        LOG_DBG("Tone queue full - sound dropped");
+        return;
     }
+
+    /* Starts playback if idle; a sound already playing picks it up next */
+    k_work_schedule_for_queue(&relay_workq_background, &sequencer_work, K_NO_WAIT);
 }
 
+#define SEQUENCER_POST(table) \
+    sequencer_post(&(struct tone_request){ .steps = (table), .count = ARRAY_SIZE(table) })
+
 int buzzer_init(void)
 {
 #if !defined(CONFIG_BOARD_XIAO_BLE)
@@ -63,8 +187,8 @@ int buzzer_init(void)
     buzzer_available = true;
     LOG_INF("Buzzer PWM device detected, initializing...");
 
-    /* Initialize work queue for delayed stop */
-    k_work_init_delayable(&buzzer_stop_work, buzzer_stop_work_handler);
+    /* Initialize the tone sequencer */
+    k_work_init_delayable(&sequencer_work, sequencer_work_handler);
 
     /* Test buzzer with a short beep */
     buzzer_ready = true;
@@ -82,141 +206,82 @@ void buzzer_click(void)
 
 void buzzer_click_left(void)
 {
-    if (!buzzer_available || !buzzer_ready) {
-        return;  /* Silently skip if no buzzer */
-    }
-    
-    /* Left click: Higher pitch, short duration */
-    buzzer_beep(2500, 4);  /* 2.5kHz for 4ms */
-    
-    LOG_DBG("Left click buzz generated");
+    SEQUENCER_POST(click_left_steps);
 }
 
 void buzzer_click_right(void)
 {
-    if (!buzzer_available || !buzzer_ready) {
-        return;  /* Silently skip if no buzzer */
-    }
-    
-    /* Right click: Lower pitch, slightly longer */
-    buzzer_beep(1800, 6);  /* 1.8kHz for 6ms */
-    
-    LOG_DBG("Right click buzz generated");
+    SEQUENCER_POST(click_right_steps);
 }
 
 void buzzer_click_double(void)
 {
-    if (!buzzer_available || !buzzer_ready) {
-        return;  /* Silently skip if no buzzer */
-    }
-    
-    /* Double click: Two short high-pitched beeps */
-    buzzer_beep(3000, 3);     /* First beep: 3kHz for 3ms */
-    k_sleep(K_MSEC(2));       /* 2ms gap */
-    buzzer_beep(3000, 3);     /* Second beep: 3kHz for 3ms */
-    
-    LOG_DBG("Double click buzz generated");
+    SEQUENCER_POST(click_double_steps);
 }
 
 void buzzer_click_mechanical(void)
 {
-    if (!buzzer_available || !buzzer_ready) {
-        return;  /* Silently skip if no buzzer */
-    }
-    
-    /* Mechanical click: Low pitched, very short */
-    buzzer_beep(800, 2);   /* 800Hz for 2ms - mimics mechanical switch */
-    
-    LOG_DBG("Mechanical click buzz generated");
+    SEQUENCER_POST(click_mechanical_steps);
 }
 
 void buzzer_click_pop(void)
 {
-    if (!buzzer_available || !buzzer_ready) {
-        return;  /* Silently skip if no buzzer */
-    }
-    
-    /* Pop sound: Quick frequency sweep */
-    buzzer_beep(2000, 1);   /* Start at 2kHz */
-    k_sleep(K_USEC(500));   /* Tiny gap */
-    buzzer_beep(1500, 1);   /* Drop to 1.5kHz */
-    k_sleep(K_USEC(500));   /* Tiny gap */
-    buzzer_beep(1000, 1);   /* Finish at 1kHz */
-    
-    LOG_DBG("Pop click buzz generated");
+    SEQUENCER_POST(click_pop_steps);
 }
 
 void buzzer_connected(void)
 {
-    if (!buzzer_available || !buzzer_ready) {
-        return;  /* Silently skip if no buzzer */
-    }
-    
-    /* Happy connection sound: Rising melody */
-    buzzer_beep(800, 80);   /* Low C */
-    k_sleep(K_MSEC(10));    /* Short gap */
-    buzzer_beep(1000, 80);  /* E */
-    k_sleep(K_MSEC(10));    /* Short gap */
-    buzzer_beep(1200, 120); /* G - longer and higher */
-    
-    LOG_DBG("Connection success buzz generated");
+    SEQUENCER_POST(connected_steps);
 }
 
 void buzzer_disconnected(void)
 {
-    if (!buzzer_available || !buzzer_ready) {
-        return;  /* Silently skip if no buzzer */
+    SEQUENCER_POST(disconnected_steps);
+}
+
+/* A click for each button press, once its report went out */
+static void hid_report_feedback(const struct zbus_channel *chan)
+{
+    const struct relay_hid_report_msg *msg = zbus_chan_const_msg(chan);
+
+    if (msg->pressed & 0x01) {
+        buzzer_click_left();
+    }
+    if (msg->pressed & 0x02) {
+        buzzer_click_right();
     }
-    
-    /* Sad disconnection sound: Falling melody (opposite of connected) */
-    buzzer_beep(1200, 80);  /* High G */
-    k_sleep(K_MSEC(10));    /* Short gap */
-    buzzer_beep(1000, 80);  /* E */
-    k_sleep(K_MSEC(10));    /* Short gap */
-    buzzer_beep(800, 120);  /* Low C - longer and lower */
-    
-    LOG_DBG("Disconnection sad buzz generated");
 }
 
-void buzzer_beep(uint32_t frequency_hz, uint32_t duration_ms)
+/* Chime when the link becomes ready, and when a ready link is lost */
+static void link_feedback(const struct zbus_channel *chan)
 {
-    if (!buzzer_available || !buzzer_ready || !pwm_dev) {
-        return;  /* Silently skip if no buzzer */
+    const struct relay_link_state_msg *msg = zbus_chan_const_msg(chan);
+    static bool was_ready;
+
+    if (msg->ready && !was_ready) {
+        buzzer_connected();
+    } else if (!msg->ready && was_ready) {
+        buzzer_disconnected();
     }
-    
+    was_ready = msg->ready;
+}
+
+ZBUS_LISTENER_DEFINE(buzzer_hid_report, hid_report_feedback);
+ZBUS_CHAN_ADD_OBS(relay_chan_hid_report, buzzer_hid_report, RELAY_BUS_PRIO_FEEDBACK);
+ZBUS_LISTENER_DEFINE(buzzer_link_state, link_feedback);
+ZBUS_CHAN_ADD_OBS(relay_chan_link_state, buzzer_link_state, RELAY_BUS_PRIO_FEEDBACK);
+
+void buzzer_beep(uint32_t frequency_hz, uint32_t duration_ms)
+{
     /* Validate frequency range */
     if (frequency_hz < 100 || frequency_hz > 10000) {
         LOG_WRN("Frequency %u Hz out of range (100-10000 Hz)", frequency_hz);
         return;
     }
-    
-    /* Calculate PWM period from frequency */
-    uint32_t period_ns = 1000000000U / frequency_hz;  /* Period in nanoseconds */
-    uint32_t pulse_ns = period_ns / 2;                 /* 50% duty cycle */
-    
-    /* Set PWM to generate tone */
-    struct pwm_dt_spec pwm_spec = {
-        .dev = pwm_dev,
-        .channel = BUZZER_PWM_CHANNEL,
-        .period = period_ns,
-        .flags = PWM_POLARITY_NORMAL
-    };
-    
-    int ret = pwm_set_dt(&pwm_spec, period_ns, pulse_ns);
-    if (ret != 0) {
-        LOG_ERR("Failed to set PWM for buzzer (err %d)", ret);
-        return;
-    }
-    
-    /* Cancel any existing stop work */
-    k_work_cancel_delayable(&buzzer_stop_work);
-    
-    /* Schedule stop after duration */
-    if (duration_ms > 0) {
-        k_work_schedule(&buzzer_stop_work, K_MSEC(duration_ms));
-    }
-    
-    LOG_DBG("Buzzer beep: %u Hz for %u ms", frequency_hz, duration_ms);
+
+    sequencer_post(&(struct tone_request){
+        .beep = TONE(frequency_hz, duration_ms * USEC_PER_MSEC),
+    });
 }
 
 void buzzer_stop(void)
@@ -224,21 +289,15 @@ void buzzer_stop(void)
     if (!buzzer_available || !buzzer_ready) {
         return;  /* Silently skip if no buzzer */
     }
-    
-    /* Cancel any pending stop work */
-    k_work_cancel_delayable(&buzzer_stop_work);
-    
-    /* Stop PWM immediately */
-    if (pwm_dev) {
-        struct pwm_dt_spec pwm_spec = {
-            .dev = pwm_dev,
-            .channel = BUZZER_PWM_CHANNEL,
-            .period = 0,
-            .flags = PWM_POLARITY_NORMAL
-        };
-        pwm_set_dt(&pwm_spec, 0, 0);
-    }
-    
+
+    struct k_work_sync sync;
+
+    /* Drop queued sounds; the sequencer finds nothing and silences the PWM */
+    k_msgq_purge(&tone_queue);
+    k_work_cancel_delayable_sync(&sequencer_work, &sync);
+    playing = false;
+    k_work_schedule_for_queue(&relay_workq_background, &sequencer_work, K_NO_WAIT);
+
     LOG_DBG("Buzzer stopped manually");
 }
 
@@ -8,17 +8,26 @@
 #ifndef BUZZER_H_
 #define BUZZER_H_
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <zephyr/sys/util.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined(CONFIG_RELAY_BUZZER)
+
 /**
  * @brief Initialize the passive buzzer
  * 
- * @return 0 on success, negative error code on failure
+ * The sound functions below only queue the sound and return; it is played
+ * from the background work queue after any sounds queued before it. They
+ * are safe to call from Bluetooth callbacks.
+ *
+ * @return 0 on success, -ENOTSUP without CONFIG_RELAY_BUZZER, or another
+ *         negative error code on failure
  */
 int buzzer_init(void);
 
@@ -98,6 +107,62 @@ void buzzer_stop(void);
  */
 bool buzzer_is_available(void);
 
+#else
+
+static inline int buzzer_init(void)
+{
+	return -ENOTSUP;
+}
+
+static inline void buzzer_click(void)
+{
+}
+
+static inline void buzzer_click_left(void)
+{
+}
+
+static inline void buzzer_click_right(void)
+{
+}
+
+static inline void buzzer_click_double(void)
+{
+}
+
+static inline void buzzer_click_mechanical(void)
+{
+}
+
+static inline void buzzer_click_pop(void)
+{
+}
+
+static inline void buzzer_connected(void)
+{
+}
+
+static inline void buzzer_disconnected(void)
+{
+}
+
+static inline void buzzer_beep(uint32_t frequency_hz, uint32_t duration_ms)
+{
+	ARG_UNUSED(frequency_hz);
+	ARG_UNUSED(duration_ms);
+}
+
+static inline void buzzer_stop(void)
+{
+}
+
+static inline bool buzzer_is_available(void)
+{
+	return false;
+}
+
+#endif /* CONFIG_RELAY_BUZZER */
+
 #ifdef __cplusplus
 }
 #endif
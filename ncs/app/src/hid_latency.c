@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief BLE->USB HID latency histograms
+ *
+ * Each report is stamped on entry to the HOGP notification callback and
+ * again once the USB HID IN transfer has completed. Latencies are binned
+ * into a log-linear histogram (4 sub-buckets per power of two) so p50/p99
+ * can be reported with ~25% resolution from a fixed 256-byte table per
+ * report ID, without storing individual samples.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "hid_latency.h"
+#include "link_history.h"
+#include "trace_ring.h"
+
+/* 1us .. 131ms; anything slower lands in the last bucket */
+#define HIST_SUB_BITS    2
+#define HIST_SUB_COUNT   (1U << HIST_SUB_BITS)
+#define HIST_BUCKETS     64
+
+struct latency_hist {
+	uint32_t buckets[HIST_BUCKETS];
+	uint32_t count;
+	uint32_t max_us;
+};
+
+static struct latency_hist hists[HID_LATENCY_REPORT_ID_MAX];
+static struct k_spinlock hist_lock;
+
+static uint32_t bucket_index(uint32_t us)
+{
+	if (us < HIST_SUB_COUNT) {
+		return us;
+	}
+
+	uint32_t msb = 31U - __builtin_clz(us);
+	uint32_t sub = (us >> (msb - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1U);
+	uint32_t idx = ((msb - HIST_SUB_BITS + 1U) << HIST_SUB_BITS) + sub;
+
+	return MIN(idx, HIST_BUCKETS - 1U);
+}
+
+/* Largest latency (in us) that still falls into bucket idx */
+static uint32_t bucket_upper_us(uint32_t idx)
+{
+	if (idx < HIST_SUB_COUNT) {
+		return idx;
+	}
+
+	uint32_t shift = (idx >> HIST_SUB_BITS) - 1U;
+	uint32_t sub = idx & (HIST_SUB_COUNT - 1U);
+	uint32_t lower = (HIST_SUB_COUNT + sub) << shift;
+
+	return lower + BIT(shift) - 1U;
+}
+
+static uint32_t percentile_us(const struct latency_hist *h, uint32_t pct)
+{
+	uint32_t target = DIV_ROUND_UP((uint64_t)h->count * pct, 100U);
+	uint32_t seen = 0;
+
+	for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+		seen += h->buckets[i];
+		if (seen >= target) {
+			return MIN(bucket_upper_us(i), h->max_us);
+		}
+	}
+
+	return h->max_us;
+}
+
+void hid_latency_record(uint8_t report_id, uint32_t start)
+{
+	if (report_id == 0 || report_id > HID_LATENCY_REPORT_ID_MAX) {
+		return;
+	}
+
+	uint32_t us = relay_time_since_us(start);
+	struct latency_hist *h = &hists[report_id - 1];
+	k_spinlock_key_t key = k_spin_lock(&hist_lock);
+
+	h->buckets[bucket_index(us)]++;
+	h->count++;
+	if (us > h->max_us) {
+		h->max_us = us;
+	}
+
+	k_spin_unlock(&hist_lock, key);
+
+	trace_ring_latency(report_id, us);
+	if (IS_ENABLED(CONFIG_RELAY_LINK_HISTORY)) {
+		link_history_latency(us);
+	}
+}
+
+int hid_latency_get_stats(uint8_t report_id, struct hid_latency_stats *stats)
+{
+	if (report_id == 0 || report_id > HID_LATENCY_REPORT_ID_MAX || !stats) {
+		return -EINVAL;
+	}
+
+	struct latency_hist snapshot;
+	k_spinlock_key_t key = k_spin_lock(&hist_lock);
+
+	snapshot = hists[report_id - 1];
+	k_spin_unlock(&hist_lock, key);
+
+	stats->report_id = report_id;
+	stats->count = snapshot.count;
+	stats->max_us = snapshot.max_us;
+	stats->p50_us = snapshot.count ? percentile_us(&snapshot, 50) : 0;
+	stats->p99_us = snapshot.count ? percentile_us(&snapshot, 99) : 0;
+
+	return 0;
+}
+
+void hid_latency_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&hist_lock);
+
+	memset(hists, 0, sizeof(hists));
+	k_spin_unlock(&hist_lock, key);
+}
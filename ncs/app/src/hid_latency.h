@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef HID_LATENCY_H_
+#define HID_LATENCY_H_
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include "mouthpad_hid_reports.h"
+#include "relay_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Every input report ID from the MouthPad report descriptor is tracked */
+#define HID_LATENCY_REPORT_ID_MAX MOUTHPAD_HID_REPORT_ID_MAX
+
+/**
+ * @brief Latency summary for one HID report ID
+ */
+struct hid_latency_stats {
+	uint8_t report_id;  /**< HID report ID */
+	uint32_t count;     /**< Number of reports measured since last reset */
+	uint32_t p50_us;    /**< Median BLE->USB latency in microseconds */
+	uint32_t p99_us;    /**< 99th percentile latency in microseconds */
+	uint32_t max_us;    /**< Worst observed latency in microseconds */
+};
+
+#if defined(CONFIG_HID_LATENCY_TRACE)
+
+/**
+ * @brief Take an entry timestamp for a HID report
+ *
+ * Call on arrival of the HOGP notification, before any processing.
+ *
+ * @return relay_time_now32() capture to pass to hid_latency_record()
+ */
+static inline uint32_t hid_latency_start(void)
+{
+	return relay_time_now32();
+}
+
+/**
+ * @brief Record the latency of a report whose USB IN transfer completed
+ *
+ * @param report_id HID report ID (1..HID_LATENCY_REPORT_ID_MAX)
+ * @param start Timestamp returned by hid_latency_start()
+ */
+void hid_latency_record(uint8_t report_id, uint32_t start);
+
+/**
+ * @brief Get the latency summary for one report ID
+ *
+ * @param report_id HID report ID (1..HID_LATENCY_REPORT_ID_MAX)
+ * @param stats Output summary
+ * @return 0 on success, -EINVAL for an untracked report ID
+ */
+int hid_latency_get_stats(uint8_t report_id, struct hid_latency_stats *stats);
+
+/**
+ * @brief Clear all latency histograms
+ */
+void hid_latency_reset(void);
+
+#else
+
+static inline uint32_t hid_latency_start(void)
+{
+	return 0;
+}
+
+static inline void hid_latency_record(uint8_t report_id, uint32_t start)
+{
+	ARG_UNUSED(report_id);
+	ARG_UNUSED(start);
+}
+
+static inline int hid_latency_get_stats(uint8_t report_id, struct hid_latency_stats *stats)
+{
+	ARG_UNUSED(report_id);
+	ARG_UNUSED(stats);
+	return -ENOTSUP;
+}
+
+static inline void hid_latency_reset(void)
+{
+}
+
+#endif /* CONFIG_HID_LATENCY_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HID_LATENCY_H_ */
@@ -11,13 +11,19 @@
 #include <zephyr/drivers/led_strip.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
+#include <string.h>
 
 #include "leds.h"
 #include "ble_bas.h"
+#include "relay_workq.h"
 
 #define LOG_MODULE_NAME leds
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
+/* Animation timing */
+#define SCAN_BLINK_MS        500
+#define ACTIVITY_FLICKER_MS  50
+
 /* NeoPixel support detection */
 #if DT_NODE_EXISTS(DT_NODELABEL(neopixel)) && \
     (DT_SAME_NODE(DT_ALIAS(led0), DT_NODELABEL(neopixel)) || \
@@ -49,16 +55,53 @@ static bool led_blue_available = false;
 /* LED state tracking */
 static bool leds_ready = false;
 static led_state_t current_state = LED_STATE_OFF;
-static uint32_t animation_counter = 0;
-static bool animation_phase = false;
+static uint8_t pattern_level = 0xFE;  /* Battery level the pattern was built with */
 static uint8_t battery_color_mode = BAS_COLOR_MODE_GRADIENT;
 
+/* Animation engine: each state is a short table of keyframes, built when the
+ * state or battery level changes and then stepped by a kernel timer, so no
+ * thread wakes up to animate. GPIO LEDs are written straight from the timer;
+ * NeoPixel frames are handed to the background work queue, whose SPI write
+ * goes out by EasyDMA and is skipped when the color has not changed.
+ * Keyframe colors are as they go out: NeoPixel ones carry the brightness.
+ */
+#define KEYFRAMES_MAX 2
+
+struct led_keyframe {
+    ble_bas_rgb_color_t color;
+    uint16_t hold_ms;  /* 0 = hold until the pattern changes */
+};
+
+static struct led_keyframe keyframes[KEYFRAMES_MAX];
+static uint8_t keyframe_count;
+static uint8_t keyframe_index;
+static struct k_spinlock keyframe_lock;
+
+static void keyframe_timer_handler(struct k_timer *timer);
+static K_TIMER_DEFINE(keyframe_timer, keyframe_timer_handler, NULL);
+
+#if HAS_NEOPIXEL
+static ble_bas_rgb_color_t neopixel_pending;  /* Frame waiting for neopixel_work */
+static void neopixel_work_handler(struct k_work *work);
+static K_WORK_DEFINE(neopixel_work, neopixel_work_handler);
+#endif
+
 /* NeoPixel brightness control (0-255, default 25 for comfortable viewing) */
 #if HAS_NEOPIXEL
 static uint8_t neopixel_brightness = 25;
+
+/* Strip color for each battery level, brightness applied; rebuilt when the
+ * color mode changes, so following the battery is a lookup
+ */
+static ble_bas_rgb_color_t battery_lut[101];
 #endif
 
 /* Private function declarations */
+static uint8_t pattern_build(led_state_t state, struct led_keyframe *frames);
+static ble_bas_rgb_color_t output_color(ble_bas_rgb_color_t color);
+static ble_bas_rgb_color_t battery_color(void);
+static void battery_lut_build(void);
+static void pattern_play(const struct led_keyframe *frames, uint8_t count);
 static void set_rgb_color(ble_bas_rgb_color_t color);
 static void set_gpio_leds(ble_bas_rgb_color_t color);
 static int init_gpio_leds(void);
@@ -117,78 +160,32 @@ int leds_set_state(led_state_t state)
     }
     
     if (state != current_state) {
+        struct led_keyframe frames[KEYFRAMES_MAX];
+
         LOG_DBG("LED state change: %d -> %d", current_state, state);
         current_state = state;
-        animation_counter = 0;
-        animation_phase = false;
-        
-        /* Immediately apply state for non-animated states */
-        if (state == LED_STATE_OFF) {
-            ble_bas_rgb_color_t off_color = {0, 0, 0};
-            set_rgb_color(off_color);
-        } else if (state == LED_STATE_CONNECTED) {
-            ble_bas_rgb_color_t battery_color = ble_bas_get_battery_color(battery_color_mode);
-            set_rgb_color(battery_color);
-        }
+        pattern_play(frames, pattern_build(state, frames));
     }
     
     return 0;
 }
 
-int leds_update(void)
+void leds_update(void)
 {
     if (!leds_ready) {
-        return 0;  /* Silently ignore if no LEDs */
+        return;  /* Silently ignore if no LEDs */
     }
     
-    animation_counter++;
-    
-    switch (current_state) {
-    case LED_STATE_OFF:
-        /* Nothing to do */
-        break;
-        
-    case LED_STATE_SCANNING:
-        /* Blue blink every 500ms */
-        if (animation_counter >= 500) {
-            if (animation_phase) {
-                ble_bas_rgb_color_t blue_color = {0, 0, 255};
-                set_rgb_color(blue_color);
-            } else {
-                ble_bas_rgb_color_t off_color = {0, 0, 0};
-                set_rgb_color(off_color);
-            }
-            animation_phase = !animation_phase;
-            animation_counter = 0;
-        }
-        break;
-        
-    case LED_STATE_CONNECTED:
-        /* Solid battery-aware color - already set in leds_set_state() */
-        /* But update periodically in case battery level changed */
-        if (animation_counter >= 1000) {
-            ble_bas_rgb_color_t battery_color = ble_bas_get_battery_color(battery_color_mode);
-            set_rgb_color(battery_color);
-            animation_counter = 0;
-        }
-        break;
-        
-    case LED_STATE_DATA_ACTIVITY:
-        /* Flicker every 50ms for better visibility */
-        if (animation_counter % 50 == 0) {
-            if (animation_phase) {
-                ble_bas_rgb_color_t battery_color = ble_bas_get_battery_color(battery_color_mode);
-                set_rgb_color(battery_color);
-            } else {
-                ble_bas_rgb_color_t off_color = {0, 0, 0};
-                set_rgb_color(off_color);
-            }
-            animation_phase = !animation_phase;
-        }
-        break;
+    if (current_state != LED_STATE_CONNECTED && current_state != LED_STATE_DATA_ACTIVITY) {
+        return;  /* Pattern does not depend on the battery */
+    }
+
+    /* Rebuild the keyframes only when the battery level moved */
+    if (ble_bas_get_battery_level() != pattern_level) {
+        struct led_keyframe frames[KEYFRAMES_MAX];
+
+        pattern_play(frames, pattern_build(current_state, frames));
     }
-    
-    return 0;
 }
 
 bool leds_is_available(void)
@@ -199,8 +196,12 @@ bool leds_is_available(void)
 void leds_set_battery_color_mode(uint8_t mode)
 {
     battery_color_mode = mode;
+    battery_lut_build();
     LOG_INF("Battery LED color mode set to: %s", 
             (mode == BAS_COLOR_MODE_DISCRETE) ? "DISCRETE" : "GRADIENT");
+
+    /* Next leds_update() shows the new colors */
+    pattern_level = 0xFE;
 }
 
 bool leds_has_neopixel(void)
@@ -214,15 +215,137 @@ bool leds_has_neopixel(void)
 
 /* Private function implementations */
 
+/* Keyframes for a state; returns how many were written */
+static uint8_t pattern_build(led_state_t state, struct led_keyframe *frames)
+{
+    const ble_bas_rgb_color_t off_color = {0, 0, 0};
+
+    switch (state) {
+    case LED_STATE_SCANNING:
+        /* Blue blink every 500ms */
+        frames[0] = (struct led_keyframe){output_color((ble_bas_rgb_color_t){0, 0, 255}),
+                                          SCAN_BLINK_MS};
+        frames[1] = (struct led_keyframe){off_color, SCAN_BLINK_MS};
+        return 2;
+
+    case LED_STATE_CONNECTED:
+        /* Solid battery-aware color; rebuilt when the battery level changes */
+        frames[0] = (struct led_keyframe){battery_color(), 0};
+        return 1;
+
+    case LED_STATE_DATA_ACTIVITY:
+        /* Flicker every 50ms for better visibility */
+        frames[0] = (struct led_keyframe){battery_color(), ACTIVITY_FLICKER_MS};
+        frames[1] = (struct led_keyframe){off_color, ACTIVITY_FLICKER_MS};
+        return 2;
+
+    case LED_STATE_OFF:
+    default:
+        frames[0] = (struct led_keyframe){off_color, 0};
+        return 1;
+    }
+}
+
+/* A color as it goes out: NeoPixel frames are scaled by brightness here, once
+ * per pattern, rather than on every write
+ */
+static ble_bas_rgb_color_t output_color(ble_bas_rgb_color_t color)
+{
+#if HAS_NEOPIXEL
+    color.red = (color.red * neopixel_brightness) / 255;
+    color.green = (color.green * neopixel_brightness) / 255;
+    color.blue = (color.blue * neopixel_brightness) / 255;
+#endif
+    return color;
+}
+
+/* Output color for the current battery level, noted for leds_update() */
+static ble_bas_rgb_color_t battery_color(void)
+{
+    pattern_level = ble_bas_get_battery_level();
+
+#if HAS_NEOPIXEL
+    /* Unknown is shown as full, the 100% entry in both modes */
+    return battery_lut[pattern_level <= 100 ? pattern_level : 100];
+#else
+    return ble_bas_battery_color(pattern_level, battery_color_mode);
+#endif
+}
+
+static void battery_lut_build(void)
+{
+#if HAS_NEOPIXEL
+    for (uint8_t level = 0; level < ARRAY_SIZE(battery_lut); level++) {
+        battery_lut[level] = output_color(ble_bas_battery_color(level, battery_color_mode));
+    }
+#endif
+}
+
+/* Replace the running pattern and show its first keyframe */
+static void pattern_play(const struct led_keyframe *frames, uint8_t count)
+{
+    k_timer_stop(&keyframe_timer);
+
+    k_spinlock_key_t key = k_spin_lock(&keyframe_lock);
+    memcpy(keyframes, frames, count * sizeof(frames[0]));
+    keyframe_count = count;
+    keyframe_index = 0;
+    k_spin_unlock(&keyframe_lock, key);
+
+    set_rgb_color(frames[0].color);
+    if (count > 1 && frames[0].hold_ms > 0) {
+        k_timer_start(&keyframe_timer, K_MSEC(frames[0].hold_ms), K_NO_WAIT);
+    }
+}
+
+/* Timer expiry (ISR): advance to the next keyframe and arm its hold time */
+static void keyframe_timer_handler(struct k_timer *timer)
+{
+    struct led_keyframe frame;
+
+    k_spinlock_key_t key = k_spin_lock(&keyframe_lock);
+    if (keyframe_count < 2) {
+        k_spin_unlock(&keyframe_lock, key);
+        return;
+    }
+    keyframe_index = (keyframe_index + 1) % keyframe_count;
+    frame = keyframes[keyframe_index];
+    k_spin_unlock(&keyframe_lock, key);
+
+    set_rgb_color(frame.color);
+    if (frame.hold_ms > 0) {
+        k_timer_start(timer, K_MSEC(frame.hold_ms), K_NO_WAIT);
+    }
+}
+
+/* Called from thread or timer context */
 static void set_rgb_color(ble_bas_rgb_color_t color)
 {
 #if HAS_NEOPIXEL
-    set_neopixel_color(color);
+    /* The strip driver blocks on its SPI transfer; write it from a thread */
+    k_spinlock_key_t key = k_spin_lock(&keyframe_lock);
+    neopixel_pending = color;
+    k_spin_unlock(&keyframe_lock, key);
+
+    k_work_submit_to_queue(&relay_workq_background, &neopixel_work);
 #else
     set_gpio_leds(color);
 #endif
 }
 
+#if HAS_NEOPIXEL
+static void neopixel_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    k_spinlock_key_t key = k_spin_lock(&keyframe_lock);
+    ble_bas_rgb_color_t color = neopixel_pending;
+    k_spin_unlock(&keyframe_lock, key);
+
+    set_neopixel_color(color);
+}
+#endif
+
 #if HAS_NEOPIXEL
 static void set_neopixel_color(ble_bas_rgb_color_t color)
 {
@@ -230,10 +353,16 @@ static void set_neopixel_color(ble_bas_rgb_color_t color)
         return;
     }
 
-    /* Scale colors by brightness to prevent blinding brightness */
-    neopixel_color.r = (color.red * neopixel_brightness) / 255;
-    neopixel_color.g = (color.green * neopixel_brightness) / 255;
-    neopixel_color.b = (color.blue * neopixel_brightness) / 255;
+    /* Already scaled by output_color(); a repeat of the last frame (a
+     * pattern rebuilt at the same level, off after off) costs no transfer
+     */
+    if (neopixel_color.r == color.red && neopixel_color.g == color.green &&
+        neopixel_color.b == color.blue) {
+        return;
+    }
+    neopixel_color.r = color.red;
+    neopixel_color.g = color.green;
+    neopixel_color.b = color.blue;
 
     led_strip_update_rgb(neopixel_dev, &neopixel_color, 1);
 }
@@ -293,6 +422,7 @@ static int init_neopixel(void)
     }
 
     LOG_INF("NeoPixel initialized successfully");
+    battery_lut_build();
 
     /* Brief startup indication - short blue pulse */
     struct led_rgb startup_blue = {0, 0, (64 * neopixel_brightness) / 255};
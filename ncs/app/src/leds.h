@@ -8,8 +8,10 @@
 #ifndef LEDS_H_
 #define LEDS_H_
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <zephyr/sys/util.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,12 +27,15 @@ typedef enum {
     LED_STATE_DATA_ACTIVITY, /**< Fast flicker battery-aware color - data transfer */
 } led_state_t;
 
+#if defined(CONFIG_RELAY_LEDS)
+
 /**
  * @brief Initialize the LED subsystem
  * 
  * Detects and configures available LEDs (NeoPixel or GPIO)
  * 
- * @return 0 on success, negative error code on failure
+ * @return 0 on success, -ENOTSUP without CONFIG_RELAY_LEDS, or another
+ *         negative error code on failure
  */
 int leds_init(void);
 
@@ -43,14 +48,12 @@ int leds_init(void);
 int leds_set_state(led_state_t state);
 
 /**
- * @brief Update LED animation/timing
- * 
- * Should be called periodically from main loop to handle
- * blinking and flicker animations
+ * @brief Refresh battery-aware LED colors
  * 
- * @return 0 on success, negative error code on failure
+ * Call when the battery level may have changed. Blinking and flicker
+ * animations are stepped by a timer and need no further calls.
  */
-int leds_update(void);
+void leds_update(void);
 
 /**
  * @brief Check if LED subsystem is available
@@ -73,6 +76,40 @@ void leds_set_battery_color_mode(uint8_t mode);
  */
 bool leds_has_neopixel(void);
 
+#else
+
+static inline int leds_init(void)
+{
+	return -ENOTSUP;
+}
+
+static inline int leds_set_state(led_state_t state)
+{
+	ARG_UNUSED(state);
+	return 0;
+}
+
+static inline void leds_update(void)
+{
+}
+
+static inline bool leds_is_available(void)
+{
+	return false;
+}
+
+static inline void leds_set_battery_color_mode(uint8_t mode)
+{
+	ARG_UNUSED(mode);
+}
+
+static inline bool leds_has_neopixel(void)
+{
+	return false;
+}
+
+#endif /* CONFIG_RELAY_LEDS */
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,22 +12,68 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/shell/shell.h>
 #include <zephyr/drivers/hwinfo.h>
+#include <stdlib.h>
 #include <string.h>
 #include <nrf.h>
 
 #include "usb_cdc.h"
 #include "usb_hid.h"
+#include "usb_relay_hid.h"
+#include "usb_relay_webusb.h"
 #include "ble_transport.h"
 #include "ble_central.h"
+#include "ble_secondary.h"
 #include "ble_bas.h"
 #include "ble_dis.h"
+#include "ble_conn_params.h"
+#include "ble_l2cap_bulk.h"
+#include "ble_phy.h"
+#include "ble_tx_power.h"
 #include "oled_display.h"
 #include "buzzer.h"
 #include "leds.h"
 #include "button.h"
+#include "hid_idle.h"
+#include "hid_latency.h"
+#include "relay_activity.h"
+#include "relay_bench.h"
+#include "relay_device_info.h"
+#include "relay_dispatch.h"
+#include "relay_events.h"
+#include "relay_fw_update.h"
+#include "relay_hid_mirror.h"
+#include "relay_link_history.h"
+#include "relay_mem_stats.h"
+#include "relay_nus_stream.h"
+#include "relay_stall_watch.h"
+#include "relay_stats.h"
+#include "relay_probe.h"
+#include "relay_sysview.h"
+#include "relay_telemetry.h"
+#include "relay_thread_stats.h"
+#include "relay_time.h"
+#include "relay_tuning.h"
+#include "relay_usb_composition.h"
+#include "relay_workq.h"
+#include "connection_timing.h"
+#include "fault_inject.h"
+#include "pairing_timing.h"
+#include "fw_update.h"
+#include "nus_stream.h"
+#include "sensor_codec.h"
+#include "sensor_stream.h"
+#include "stall_watch.h"
+#include "trace_ring.h"
+#include "tuning_profile.h"
+#include "tx_power.h"
+#include "link_guard.h"
+#include "link_history.h"
+#include "link_state.h"
+#include "usb_phase.h"
+#include "mouthpad_frame.h"
+#include "mouthpad_pass_through.h"
+#include "pass_through_ack.h"
 #include "MouthpadRelay.pb.h"
-#include "pb_decode.h"
-#include "pb_encode.h"
 
 #define LOG_MODULE_NAME main
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -44,12 +90,13 @@ static void clear_ble_pairings(void)
 	ble_transport_clear_bonds();
 
 	/* Clear saved DIS info since bonded device is being removed */
-	extern void ble_dis_clear_saved(void);
 	ble_dis_clear_saved();
 
 	LOG_INF("BLE bonds cleared - ready for new pairing");
 }
 
+#if defined(CONFIG_RELAY_SHELL)
+
 /* Shell command: Enter DFU bootloader mode */
 static int cmd_dfu(const struct shell *sh, size_t argc, char **argv)
 {
@@ -104,6 +151,22 @@ static int cmd_reset(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+/* Shell command: Drop the primary MouthPad link; the relay reconnects as usual */
+static int cmd_disconnect(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (!ble_central_get_default_conn()) {
+		shell_print(sh, "No MouthPad connected");
+		return 0;
+	}
+	shell_print(sh, "Disconnecting MouthPad...");
+	ble_transport_disconnect();
+
+	return 0;
+}
+
 /* Shell command: Restart firmware */
 static int cmd_restart(const struct shell *sh, size_t argc, char **argv)
 {
@@ -177,595 +240,2065 @@ static int cmd_clear_fw_cache(const struct shell *sh, size_t argc, char **argv)
 	ARG_UNUSED(argv);
 
 	shell_print(sh, "Clearing cached firmware versions for all bonds...");
-	extern void ble_dis_clear_all_cached_firmware(void);
 	ble_dis_clear_all_cached_firmware();
 	shell_print(sh, "Done. Firmware versions will be re-read on next connection.");
 
 	return 0;
 }
 
-SHELL_CMD_REGISTER(bonds, NULL, "Display bonded devices", cmd_bonds);
-SHELL_CMD_REGISTER(clearfwcache, NULL, "Clear cached firmware versions", cmd_clear_fw_cache);
-SHELL_CMD_REGISTER(dfu, NULL, "Enter DFU bootloader mode", cmd_dfu);
-SHELL_CMD_REGISTER(reset, NULL, "Reset stored BLE bonds", cmd_reset);
-SHELL_CMD_REGISTER(restart, NULL, "Restart firmware", cmd_restart);
-SHELL_CMD_REGISTER(serial, NULL, "Display USB serial number", cmd_serial);
-SHELL_CMD_REGISTER(version, NULL, "Display firmware version", cmd_version);
-
-/* Battery color indication mode - automatically set based on LED hardware */
-/* GPIO LEDs use discrete mode, NeoPixel uses gradient mode */
-
-/* Button event callback function */
-static void button_event_callback(button_event_t event)
+/* Shell command: Display CDC0 TX ring buffer usage */
+static int cmd_cdc(const struct shell *sh, size_t argc, char **argv)
 {
-	switch (event) {
-	case BUTTON_EVENT_CLICK:
-		LOG_INF("=== BUTTON CLICK ===");
-		/* Reserved for future functionality */
-		break;
-
-	case BUTTON_EVENT_DOUBLE_CLICK:
-		LOG_INF("=== BUTTON DOUBLE CLICK ===");
-		/* Reserved for future functionality */
-		break;
+	struct usb_cdc_tx_stats stats;
 
-	case BUTTON_EVENT_HOLD:
-		LOG_INF("=== BUTTON HOLD - CLEARING BLE BONDS ===");
-		/* Clear BLE bonds and reset for new pairing */
-		clear_ble_pairings();
-		break;
-		
-	default:
-		break;
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			shell_error(sh, "Usage: cdc [reset]");
+			return -EINVAL;
+		}
+		usb_cdc_reset_tx_stats();
+		shell_print(sh, "CDC0 high-water marks and drop counts cleared");
+		return 0;
 	}
+
+	usb_cdc_get_tx_stats(&stats);
+	shell_print(sh, "=== CDC0 TX Ring ===");
+	shell_print(sh, "Capacity:   %u bytes", stats.capacity);
+	shell_print(sh, "Queued:     %u bytes", stats.used);
+	shell_print(sh, "High-water: %u bytes", stats.high_water);
+	shell_print(sh, "Dropped:    %u frames", stats.dropped);
+	shell_print(sh, "Msg slots:  %u/%u in use, high-water %u, %u dropped", stats.msg_slots_used,
+		    stats.msg_slots, stats.msg_high_water, stats.msg_dropped);
+	shell_print(sh, "RX ring:    %u bytes, high-water %u, paused %u times", stats.rx_capacity,
+		    stats.rx_high_water, stats.rx_throttles);
+	shell_print(sh, "====================");
+
+	return 0;
 }
 
-/* USB HID callback function */
-static void usb_hid_data_callback(const uint8_t *data, uint16_t len)
+/* Shell command: Display BLE->USB HID latency histograms */
+static int cmd_latency(const struct shell *sh, size_t argc, char **argv)
 {
-	// This callback is for USB HID data going TO USB (BLE->USB bridge)
-	// Button detection is now handled in BLE HID layer where we have Report ID context
-	
-	// Bridge USB HID data to BLE HID
-	if (ble_transport_is_hid_ready()) {
-		LOG_DBG("BLE HID is ready, sending %d bytes", len);
-		int err = ble_transport_send_hid_data(data, len);
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			shell_error(sh, "Usage: latency [reset]");
+			return -EINVAL;
+		}
+		hid_latency_reset();
+		usb_phase_reset();
+		shell_print(sh, "HID latency histograms cleared");
+		return 0;
+	}
+
+	shell_print(sh, "=== BLE->USB HID Latency (us) ===");
+	shell_print(sh, "  ID      count     p50     p99     max");
+	for (uint8_t id = 1; id <= HID_LATENCY_REPORT_ID_MAX; id++) {
+		struct hid_latency_stats stats;
+		int err = hid_latency_get_stats(id, &stats);
+
 		if (err) {
-			LOG_ERR("USB HID→BLE HID FAILED (err %d)", err);
-		} else {
-			LOG_DBG("USB HID data sent to BLE HID successfully");
+			shell_error(sh, "Latency tracing not available (err %d)", err);
+			return err;
 		}
-	} else {
-		LOG_DBG("HID client not ready - waiting for service discovery");
+		shell_print(sh, "  %2u %10u %7u %7u %7u", stats.report_id, stats.count,
+			    stats.p50_us, stats.p99_us, stats.max_us);
+	}
+	if (IS_ENABLED(CONFIG_USB_HID_SOF_PHASE)) {
+		char line[128];
+
+		usb_phase_format(line, sizeof(line));
+		shell_print(sh, "%s", line);
+	}
+	{
+		char line[80];
+
+		time_base_format(line, sizeof(line));
+		shell_print(sh, "%s (time base %u Hz)", line, (unsigned int)RELAY_TIME_HZ);
 	}
+	shell_print(sh, "=================================");
+
+	return 0;
 }
 
-/* nanopb string encoding callback for device info strings */
-static bool encode_string_callback(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+/* Shell command: Display NUS/HID data path counters */
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv)
 {
-	const char *str = (const char *)(*arg);
+	static const char *const path_names[RELAY_STATS_PATH_COUNT] = {
+		[RELAY_STATS_NUS_RX] = "NUS RX",
+		[RELAY_STATS_NUS_TX] = "NUS TX",
+		[RELAY_STATS_HID] = "HID",
+	};
+
+	if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+		relay_stats_reset();
+		shell_print(sh, "Data path counters cleared");
+		return 0;
+	}
+
+	if (argc == 3 && strcmp(argv[1], "trace") == 0 &&
+	    (strcmp(argv[2], "on") == 0 || strcmp(argv[2], "off") == 0)) {
+		relay_stats_set_trace(strcmp(argv[2], "on") == 0);
+		shell_print(sh, "Per-packet trace logging %s", argv[2]);
+		return 0;
+	}
 
-	if (!str || str[0] == '\0') {
-		return true;  /* Empty string, nothing to encode */
+	if (argc > 1) {
+		shell_error(sh, "Usage: stats [reset | trace on|off]");
+		return -EINVAL;
 	}
 
-	if (!pb_encode_tag_for_field(stream, field)) {
-		return false;
+	shell_print(sh, "=== Data Path Counters ===");
+	shell_print(sh, "  Path      packets      bytes   echo   dropped    bridged");
+	for (int path = 0; path < RELAY_STATS_PATH_COUNT; path++) {
+		struct relay_stats_snapshot stats;
+
+		relay_stats_get(path, &stats);
+		shell_print(sh, "  %-6s %10u %10u %6u %9u %10u", path_names[path], stats.packets,
+			    stats.bytes, stats.echo_filtered, stats.dropped, stats.bridged);
 	}
+	shell_print(sh, "Trace: %s", relay_stats_trace_enabled() ? "on" : "off");
+	shell_print(sh, "==========================");
 
-	return pb_encode_string(stream, (const uint8_t *)str, strlen(str));
+	return 0;
 }
 
-int usb_cdc_send_proto_message(mouthware_message_RelayToAppMessage message)
+/* Shell command: Display per-phase timings of recent connections */
+static int cmd_timing(const struct shell *sh, size_t argc, char **argv)
 {
-	uint8_t dataPacket[1024];
-	pb_ostream_t stream = pb_ostream_from_buffer(dataPacket, sizeof(dataPacket));
-	if (!pb_encode(&stream, mouthware_message_RelayToAppMessage_fields, &message)) {
-		LOG_ERR("Encoding failed: %s\n", PB_GET_ERROR(&stream));
-		return -1;
+	struct connection_timing_record records[CONNECTION_TIMING_RECORDS];
+	struct pairing_timing_record pairings[PAIRING_TIMING_RECORDS];
+	char line[128];
+
+	if (argc == 2 && strcmp(argv[1], "clear") == 0) {
+		connection_timing_clear();
+		shell_print(sh, "Connection timings cleared");
+		return 0;
+	}
+
+	if (argc > 1) {
+		shell_error(sh, "Usage: timing [clear]");
+		return -EINVAL;
+	}
+
+	size_t count = connection_timing_get(records);
+
+	shell_print(sh, "=== Connection Timing (ms after scan start) ===");
+	connection_timing_format_boot(line, sizeof(line));
+	shell_print(sh, "  %s (ms after boot)", line);
+	if (count == 0) {
+		shell_print(sh, "  No connection attempts recorded");
+	}
+	for (size_t i = 0; i < count; i++) {
+		connection_timing_format(&records[i], line, sizeof(line));
+		shell_print(sh, "  %s", line);
+	}
+	count = pairing_timing_get(pairings);
+	shell_print(sh, "--- Pairing (ms after link up) ---");
+	for (size_t i = 0; i < count; i++) {
+		pairing_timing_format(&pairings[i], line, sizeof(line));
+		shell_print(sh, "  %s", line);
 	}
-	return usb_cdc_send_data(dataPacket, stream.bytes_written);
+	shell_print(sh, "===============================================");
+
+	return 0;
 }
 
-int mouthpad_nus_data_received_callback(const uint8_t *data, uint16_t len)
+/* Shell command: Display per-thread CPU and stack usage since the last read */
+static int cmd_top(const struct shell *sh, size_t argc, char **argv)
 {
-	/* Forward data from MouthPad (BLE NUS) to USB CDC0 - minimal logging to keep CDC0 clean */
-	LOG_DBG("NUS→CDC: %d bytes", len);
+	static struct thread_stats_report report;
+	char line[80];
+	int err;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
 
-	// take binary data received via BLE, wrap it in a RelayToAppMessage and send it to the USB CDC
-	mouthware_message_RelayToAppMessage message = mouthware_message_RelayToAppMessage_init_zero;
-	message.which_message_body = mouthware_message_RelayToAppMessage_pass_through_to_app_tag;
-	message.message_body.pass_through_to_app.data.size = len;
-	memcpy(message.message_body.pass_through_to_app.data.bytes, data, len);
+	err = relay_thread_stats_read(&report);
+	if (err) {
+		shell_error(sh, "Thread stats not available (err %d)", err);
+		return err;
+	}
 
-	return usb_cdc_send_proto_message_async(message);
-}
+	shell_print(sh, "=== Threads over the last %u ms ===", report.window_ms);
+	shell_print(sh, "  %s", thread_stats_header());
+	for (size_t i = 0; i < report.count; i++) {
+		thread_stats_format(&report.rows[i], line, sizeof(line));
+		shell_print(sh, "  %s", line);
+	}
+	shell_print(sh, "==================================");
 
+	return 0;
+}
 
-int main(void)
+/* Shell command: Display heap and buffer pool usage */
+static int cmd_mem(const struct shell *sh, size_t argc, char **argv)
 {
+	static struct mem_stats_report report;
+	char line[80];
 	int err;
 
-	LOG_INF("=== MouthPad^USB Starting === Built: %s %s", __DATE__, __TIME__);
-
-	/* Initialize USB device stack (HID + CDC) */
-	LOG_INF("Initializing USB device stack...");
-	err = usb_init();
-	if (err != 0) {
-		LOG_ERR("usb_init failed (err %d)", err);
+	if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+		relay_mem_stats_reset();
+		shell_print(sh, "Pool peaks and site counters reset");
 		return 0;
 	}
-	LOG_INF("USB device stack initialized successfully");
 
-	/* Initialize USB CDC (get CDC0 device reference) */
-	LOG_INF("Initializing USB CDC...");
-	err = usb_cdc_init();
-	if (err != 0) {
-		LOG_ERR("usb_cdc_init failed (err %d)", err);
-		return 0;
+	if (argc > 1) {
+		shell_error(sh, "Usage: mem [reset]");
+		return -EINVAL;
 	}
-	LOG_INF("USB CDC initialized successfully");
 
-	/* Debug: Test HWINFO device ID reading */
-	uint8_t hwid[8];
-	ssize_t hwid_len = hwinfo_get_device_id(hwid, sizeof(hwid));
-	if (hwid_len > 0) {
-		LOG_INF("USB Serial Number: %02X%02X%02X%02X%02X%02X%02X%02X",
-			hwid[0], hwid[1], hwid[2], hwid[3],
-			hwid[4], hwid[5], hwid[6], hwid[7]);
-	} else {
-		LOG_ERR("HWINFO get_device_id failed: %d", hwid_len);
+	err = relay_mem_stats_read(&report);
+	if (err) {
+		shell_error(sh, "Memory stats not available (err %d)", err);
+		return err;
 	}
 
-	/* Initialize OLED Display */
-	err = oled_display_init();
-	if (err != 0) {
-		LOG_WRN("oled_display_init failed (err %d) - continuing without display", err);
-		/* Continue without display - it's not critical for core functionality */
-	} else {
-		/* Show splash screen with Augmental logo */
-		oled_display_splash_screen(2000);  /* Show logo for 2 seconds */
+	shell_print(sh, "=== Memory ===");
+	for (size_t i = 0; mem_stats_format(&report, i, line, sizeof(line)) > 0; i++) {
+		shell_print(sh, "  %s", line);
 	}
+	shell_print(sh, "==============");
 
-	/* Initialize Passive Buzzer */
-	err = buzzer_init();
-	if (err != 0) {
-		LOG_WRN("buzzer_init failed (err %d) - continuing without buzzer", err);
-		/* Continue without buzzer - it's not critical for core functionality */
-	} else if (buzzer_is_available()) {
-		LOG_INF("Passive Buzzer initialized successfully");
+	return 0;
+}
+
+/* Shell command: Display the firmware update in progress */
+static int cmd_fwupdate(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[96];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (!IS_ENABLED(CONFIG_RELAY_FW_UPDATE)) {
+		shell_error(sh, "Firmware update needs an MCUboot build (make MCUBOOT=1)");
+		return -ENOTSUP;
 	}
 
-	/* Initialize BLE Transport */
-	LOG_INF("Initializing BLE Transport...");
-	err = ble_transport_init();
-	if (err != 0) {
-		LOG_ERR("ble_transport_init failed (err %d)", err);
-		return 0;
+	fw_update_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+
+	return 0;
+}
+
+/* Shell command: Display HID idle rates and suppressed reports */
+static int cmd_hididle(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[128];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	hid_idle_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+
+	return 0;
+}
+
+/* Shell command: Display the tuning profile */
+static int cmd_profile(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[160];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	tuning_profile_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+
+	return 0;
+}
+
+/* Shell command: Display the USB composition */
+static int cmd_usbcomp(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[64];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	relay_usb_composition_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+
+	return 0;
+}
+
+/* Shell command: Display the bulk NUS stream */
+static int cmd_nusstream(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[128];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (!IS_ENABLED(CONFIG_RELAY_NUS_STREAM)) {
+		shell_error(sh, "NUS stream disabled (CONFIG_RELAY_NUS_STREAM)");
+		return -ENOTSUP;
 	}
-	LOG_INF("BLE Transport initialized successfully");
 
-	/* Register USB callbacks with BLE Transport */
-	ble_transport_register_usb_cdc_callback((usb_cdc_send_cb_t)mouthpad_nus_data_received_callback);
-	ble_transport_register_usb_hid_callback(usb_hid_data_callback);
+	nus_stream_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+	if (ble_l2cap_bulk_format(line, sizeof(line)) >= 0) {
+		shell_print(sh, "%s", line);
+	}
 
-	/* Start bridging */
-	ble_transport_start_bridging();
+	return 0;
+}
 
-	LOG_INF("Starting USB ↔ BLE bridge (NUS + HID)");
+/* Shell command: Display the primary link PHY and TX power and their changes */
+static int cmd_phy(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[128];
 
-	/* Initialize LED subsystem */
-	LOG_INF("Initializing LED subsystem...");
-	err = leds_init();
-	if (err != 0) {
-		LOG_WRN("leds_init failed (err %d) - continuing without LEDs", err);
-		/* Continue without LEDs - not critical for core functionality */
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (ble_phy_format(line, sizeof(line)) >= 0) {
+		shell_print(sh, "%s", line);
 	} else {
-		LOG_INF("LED subsystem initialized successfully");
-		
-		/* Choose color mode based on LED hardware */
-		if (leds_has_neopixel()) {
-			/* NeoPixel supports smooth gradients */
-			leds_set_battery_color_mode(BAS_COLOR_MODE_GRADIENT);
-			LOG_INF("Using gradient mode for NeoPixel LEDs");
-		} else {
-			/* GPIO LEDs work better with discrete colors */
-			leds_set_battery_color_mode(BAS_COLOR_MODE_DISCRETE);
-			LOG_INF("Using discrete mode for GPIO LEDs");
-		}
-		
-		leds_set_state(LED_STATE_SCANNING);  /* Start in scanning state */
+		shell_print(sh, "phy: fixed (CONFIG_BLE_PHY_ADAPTIVE off)");
 	}
-	
-	/* Initialize User Button */
-	LOG_INF("Initializing user button...");
-	err = button_init();
-	if (err != 0) {
-		LOG_WRN("button_init failed (err %d) - continuing without button", err);
-		/* Continue without button - not critical for core functionality */
+	if (IS_ENABLED(CONFIG_BLE_TX_POWER_ADAPTIVE)) {
+		tx_power_format(line, sizeof(line));
+		shell_print(sh, "%s", line);
 	} else {
-		LOG_INF("User button initialized successfully");
-		button_register_callback(button_event_callback);
+		shell_print(sh, "txpower: fixed (CONFIG_BLE_TX_POWER_ADAPTIVE off)");
 	}
-	
-	static int display_update_counter = 0;
-
-	/* Reset display state after splash screen to ensure status updates work */
-	if (oled_display_is_available()) {
-		oled_display_reset_state();
+	if (IS_ENABLED(CONFIG_BLE_LINK_GUARD)) {
+		link_guard_format(line, sizeof(line));
+		shell_print(sh, "%s", line);
 	}
 
-	/* Packet framing state machine for CDC RX */
-	enum {
-		FRAME_STATE_SEARCH_MAGIC1,  // Looking for 0xAA
-		FRAME_STATE_SEARCH_MAGIC2,  // Looking for 0x55
-		FRAME_STATE_LENGTH_HIGH,    // Reading length high byte
-		FRAME_STATE_LENGTH_LOW,     // Reading length low byte
-		FRAME_STATE_PAYLOAD,        // Reading payload
-		FRAME_STATE_CRC_HIGH,       // Reading CRC high byte
-		FRAME_STATE_CRC_LOW         // Reading CRC low byte
-	} frame_state = FRAME_STATE_SEARCH_MAGIC1;
+	return 0;
+}
+
+/* Shell command: Display the MouthPad stream filter, rate limits and sensor codec */
+static int cmd_streams(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[160];
 
-	static uint8_t frame_buffer[512];
-	static uint16_t frame_length = 0;
-	static uint16_t frame_pos = 0;
-	static uint16_t expected_crc = 0;
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
 
-	LOG_INF("Entering main loop...");
+	sensor_stream_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+	sensor_stream_rate_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+	sensor_stream_sequence_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
+	sensor_codec_format(line, sizeof(line));
+	shell_print(sh, "%s", line);
 
-	for (;;) {
-		/* USB CDC ↔ BLE NUS Bridge */
-
-		/* Check BLE connection status and HID data activity */
-		bool is_connected = ble_transport_is_connected();
-		bool ble_hid_activity = ble_transport_has_hid_data_activity();
-		uint8_t battery_level = ble_bas_get_battery_level();
-		int8_t rssi_dbm = is_connected ? ble_transport_get_rssi() : 0;
-
-		// Check for data from USB CDC - parse framed packets [0xAA 0x55][len][payload][CRC]
-		uint8_t c;
-		int bytes_read = usb_cdc_receive_data(&c, 1);
-
-		if (bytes_read > 0) {
-			switch (frame_state) {
-				case FRAME_STATE_SEARCH_MAGIC1:
-					if (c == 0xAA) {
-						frame_state = FRAME_STATE_SEARCH_MAGIC2;
-					}
-					break;
-
-				case FRAME_STATE_SEARCH_MAGIC2:
-					if (c == 0x55) {
-						frame_state = FRAME_STATE_LENGTH_HIGH;
-						frame_pos = 0;
-					} else if (c != 0xAA) {
-						// Not magic byte sequence, restart search
-						frame_state = FRAME_STATE_SEARCH_MAGIC1;
-					}
-					// If c == 0xAA, stay in SEARCH_MAGIC2 (could be start of new frame)
-					break;
-
-				case FRAME_STATE_LENGTH_HIGH:
-					frame_length = (uint16_t)c << 8;
-					frame_state = FRAME_STATE_LENGTH_LOW;
-					break;
-
-				case FRAME_STATE_LENGTH_LOW:
-					frame_length |= c;
-					if (frame_length > sizeof(frame_buffer)) {
-						LOG_ERR("Frame too large: %d bytes", frame_length);
-						frame_state = FRAME_STATE_SEARCH_MAGIC1;
-					} else {
-						frame_state = FRAME_STATE_PAYLOAD;
-						frame_pos = 0;
-					}
-					break;
-
-				case FRAME_STATE_PAYLOAD:
-					frame_buffer[frame_pos++] = c;
-					if (frame_pos >= frame_length) {
-						frame_state = FRAME_STATE_CRC_HIGH;
-					}
-					break;
-
-				case FRAME_STATE_CRC_HIGH:
-					expected_crc = (uint16_t)c << 8;
-					frame_state = FRAME_STATE_CRC_LOW;
-					break;
-
-				case FRAME_STATE_CRC_LOW:
-					expected_crc |= c;
-
-					// Validate CRC
-					uint16_t calculated_crc = calculate_crc16(frame_buffer, frame_length);
-					if (calculated_crc != expected_crc) {
-						LOG_ERR("CRC mismatch: calc=0x%04X, expected=0x%04X", calculated_crc, expected_crc);
-						frame_state = FRAME_STATE_SEARCH_MAGIC1;
-						break;
-					}
-
-					// Valid framed packet received!
-					LOG_DBG("Framed packet RX: %d bytes", frame_length);
-
-					// Decode protobuf message
-					mouthware_message_AppToRelayMessage message;
-					pb_istream_t stream = pb_istream_from_buffer(frame_buffer, frame_length);
-					if (!pb_decode(&stream, mouthware_message_AppToRelayMessage_fields, &message)) {
-						LOG_ERR("Protobuf decode failed: %s", PB_GET_ERROR(&stream));
-						frame_state = FRAME_STATE_SEARCH_MAGIC1;
-						break;
-					}
-
-					// Handle message
-					switch (message.destination) {
-						case mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_RELAY:
-							if (message.which_message_body == mouthware_message_AppToRelayMessage_ble_connection_status_read_tag) {
-								mouthware_message_RelayToAppMessage response = mouthware_message_RelayToAppMessage_init_zero;
-								response.which_message_body = mouthware_message_RelayToAppMessage_ble_connection_status_response_tag;
-
-								/* Use ble_central state machine as the ONLY source of truth for connection status */
-								LOG_INF("=== BLE STATUS QUERY ===");
-								bool central_connecting = ble_central_is_connecting();
-								bool central_scanning = ble_central_is_scanning();
-								bool central_connected = ble_central_is_connected();
-								LOG_INF("Query state: connecting=%d, scanning=%d, connected=%d (transport is_connected=%d)",
-								        central_connecting, central_scanning, central_connected, is_connected);
-
-								if (central_connecting) {
-									LOG_INF("Reporting: CONNECTING");
-									response.message_body.ble_connection_status_response.connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTING;
-								} else if (central_scanning) {
-									LOG_INF("Reporting: SEARCHING");
-									response.message_body.ble_connection_status_response.connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_SEARCHING;
-								} else if (central_connected) {
-									LOG_INF("Reporting: CONNECTED (via ble_central state)");
-									response.message_body.ble_connection_status_response.connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTED;
-								} else {
-									/* Default to DISCONNECTED if all other checks fail */
-									LOG_INF("Reporting: DISCONNECTED");
-									response.message_body.ble_connection_status_response.connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_DISCONNECTED;
-								}
-
-								response.message_body.ble_connection_status_response.rssi = rssi_dbm;
-								response.message_body.ble_connection_status_response.battery_level = battery_level;
-								usb_cdc_send_proto_message_async(response);
-							} else if (message.which_message_body == mouthware_message_AppToRelayMessage_device_info_read_tag) {
-								/* Handle DeviceInfoRead request */
-								mouthware_message_RelayToAppMessage response = mouthware_message_RelayToAppMessage_init_zero;
-								response.which_message_body = mouthware_message_RelayToAppMessage_device_info_response_tag;
-
-								/* Check if we have a bonded device (even if disconnected) */
-								bt_addr_le_t bonded_addr;
-								static char bonded_name[32];
-								bool has_bonded = ble_central_get_bonded_device_addr(&bonded_addr, bonded_name, sizeof(bonded_name));
-
-								/* Get BLE address - prefer active connection, fallback to bonded address */
-								static char ble_addr_str[BT_ADDR_STR_LEN];
-								struct bt_conn *conn = ble_central_get_default_conn();
-
-								if (conn) {
-									/* Device is currently connected - get address from connection */
-									const bt_addr_le_t *addr_le = bt_conn_get_dst(conn);
-									bt_addr_to_str(&addr_le->a, ble_addr_str, sizeof(ble_addr_str));
-									response.message_body.device_info_response.address.funcs.encode = encode_string_callback;
-									response.message_body.device_info_response.address.arg = (void *)ble_addr_str;
-								} else if (has_bonded) {
-									/* Device is bonded but not connected - return cached address */
-									bt_addr_to_str(&bonded_addr.a, ble_addr_str, sizeof(ble_addr_str));
-									response.message_body.device_info_response.address.funcs.encode = encode_string_callback;
-									response.message_body.device_info_response.address.arg = (void *)ble_addr_str;
-								}
-
-								/* Get device name - prefer live name from active connection, fallback to cached name */
-								const char *device_name = NULL;
-								if (conn) {
-									/* Get advertised device name from BLE transport (live connection) */
-									device_name = ble_transport_get_device_name();
-								}
-
-								/* If no live name available but we have a cached bonded name, use that */
-								if ((!device_name || device_name[0] == '\0') && has_bonded && bonded_name[0] != '\0') {
-									device_name = bonded_name;
-								}
-
-								/* Encode device name if we have one */
-								if (device_name && device_name[0] != '\0') {
-									response.message_body.device_info_response.name.funcs.encode = encode_string_callback;
-									response.message_body.device_info_response.name.arg = (void *)device_name;
-								}
-
-								/* Get device info from DIS client for the specific device
-								 * Prefer connected device, fallback to first bonded device */
-								static ble_dis_info_t dis_info_buf;
-								const bt_addr_le_t *target_addr = NULL;
-
-								if (conn) {
-									/* Get DIS info for currently connected device */
-									target_addr = bt_conn_get_dst(conn);
-								} else if (has_bonded) {
-									/* Get DIS info for first bonded device */
-									target_addr = &bonded_addr;
-								}
-
-								int dis_err = -ENOENT;
-								if (target_addr) {
-									dis_err = ble_dis_load_info_for_addr(target_addr, &dis_info_buf);
-								}
-
-								if (dis_err == 0) {
-									LOG_INF("DIS info loaded: has_fw=%d, has_pnp=%d",
-										dis_info_buf.has_firmware_version, dis_info_buf.has_pnp_id);
-									/* Firmware version */
-									if (dis_info_buf.has_firmware_version) {
-										LOG_INF("DIS firmware: %s", dis_info_buf.firmware_version);
-										response.message_body.device_info_response.firmware.funcs.encode = encode_string_callback;
-										response.message_body.device_info_response.firmware.arg = (void *)dis_info_buf.firmware_version;
-									}
-									/* VID and PID from PnP ID */
-									if (dis_info_buf.has_pnp_id) {
-										LOG_INF("DIS PnP ID: VID=0x%04X, PID=0x%04X",
-											dis_info_buf.vendor_id, dis_info_buf.product_id);
-										response.message_body.device_info_response.vid = dis_info_buf.vendor_id;
-										response.message_body.device_info_response.pid = dis_info_buf.product_id;
-									}
-								} else {
-									LOG_WRN("DIS info not available for device (err: %d)", dis_err);
-								}
-
-								/* Device family and board (always available) */
-								response.message_body.device_info_response.family = mouthware_message_DeviceFamily_DEVICE_FAMILY_NRF;
-
-								/* Map board name string to enum value */
-								const char *board_name;
-								#ifdef CONFIG_DONGLE_VARIANT_STRING
-									const char *variant_str = CONFIG_DONGLE_VARIANT_STRING;
-									if (variant_str && variant_str[0] != '\0') {
-										board_name = variant_str;
-									} else {
-										board_name = CONFIG_BOARD;
-									}
-								#else
-									board_name = CONFIG_BOARD;
-								#endif
-
-								/* Map board name to enum */
-								if (strcmp(board_name, "seeed_xiao_nrf52840") == 0) {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_SEEED_XIAO_NRF52840;
-								} else if (strcmp(board_name, "nrf52840dongle_nrf52840") == 0 || strcmp(board_name, "nordic_nrf52840dongle") == 0) {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_NORDIC_NRF52840DONGLE;
-								} else if (strcmp(board_name, "nrf52840_blip") == 0 || strcmp(board_name, "aprbrother_nrf52840") == 0) {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_APRBROTHER_NRF52840;
-								} else if (strcmp(board_name, "raytac_mdbt50q_rx") == 0) {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_RAYTAC_MDBT50Q_RX;
-								} else if (strcmp(board_name, "raytac_mdbt50q_cx_40") == 0) {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_RAYTAC_MDBT50Q_CX_40;
-								} else if (strcmp(board_name, "nrf52840_mdk") == 0 || strcmp(board_name, "makerdiary_nrf52840_mdk") == 0) {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_MAKERDIARY_NRF52840_MDK;
-								} else if (strcmp(board_name, "adafruit_feather_nrf52840") == 0) {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_ADAFRUIT_FEATHER_NRF52840;
-								} else {
-									response.message_body.device_info_response.board = mouthware_message_DeviceBoard_DEVICE_BOARD_UNSPECIFIED;
-									LOG_WRN("Unknown board name: %s", board_name);
-								}
-
-								LOG_INF("Device info: family=nrf, board=%s (enum=%d)", board_name, response.message_body.device_info_response.board);
-
-								LOG_INF("Sending device info: bonded=%d, connected=%d, Addr=%s, Name=%s",
-									has_bonded, conn != NULL,
-									(conn || has_bonded) ? ble_addr_str : "(none)",
-									(device_name && device_name[0] != '\0') ? device_name : "(none)");
-
-								usb_cdc_send_proto_message_async(response);
-							} else if (message.which_message_body == mouthware_message_AppToRelayMessage_clear_bonds_write_tag) {
-								/* Handle ClearBondsWrite request */
-								LOG_INF("=== CLEAR BONDS REQUEST (via protobuf) ===");
-
-								/* Clear BLE bonds using existing logic */
-								clear_ble_pairings();
-
-								/* Send success response */
-								mouthware_message_RelayToAppMessage response = mouthware_message_RelayToAppMessage_init_zero;
-								response.which_message_body = mouthware_message_RelayToAppMessage_clear_bonds_response_tag;
-								response.message_body.clear_bonds_response.success = true;
-
-								LOG_INF("Bonds cleared successfully, sending response");
-								usb_cdc_send_proto_message_async(response);
-							} else if (message.which_message_body == mouthware_message_AppToRelayMessage_clear_firmware_cache_write_tag) {
-								/* Handle ClearFirmwareCacheWrite request */
-								LOG_INF("=== CLEAR FIRMWARE CACHE REQUEST (via protobuf) ===");
-
-								/* Clear cached firmware versions for all bonded devices */
-								extern void ble_dis_clear_all_cached_firmware(void);
-								ble_dis_clear_all_cached_firmware();
-
-								/* Send success response */
-								mouthware_message_RelayToAppMessage response = mouthware_message_RelayToAppMessage_init_zero;
-								response.which_message_body = mouthware_message_RelayToAppMessage_clear_firmware_cache_response_tag;
-								response.message_body.clear_firmware_cache_response.success = true;
-
-								LOG_INF("Firmware cache cleared, sending response");
-								usb_cdc_send_proto_message_async(response);
-							} else if (message.which_message_body == mouthware_message_AppToRelayMessage_dfu_write_tag) {
-								/* Handle DfuWrite request - enter bootloader mode */
-								LOG_INF("=== DFU REQUEST (via protobuf) - entering bootloader ===");
-
-								/* Send success response before reset */
-								mouthware_message_RelayToAppMessage response = mouthware_message_RelayToAppMessage_init_zero;
-								response.which_message_body = mouthware_message_RelayToAppMessage_dfu_response_tag;
-								response.message_body.dfu_response.success = true;
-
-								usb_cdc_send_proto_message_async(response);
-
-								/* Give time for response to be sent */
-								k_sleep(K_MSEC(100));
-
-								/* Disable USB pullup to trigger disconnect before reset */
-								NRF_USBD->USBPULLUP = 0;
-								k_msleep(50);
-
-								/* Set GPREGRET magic value for UF2 bootloader */
-								NRF_POWER->GPREGRET = 0x57;
-
-								/* Perform system reset */
-								NVIC_SystemReset();
-							}
-							break;
-
-						case mouthware_message_AppToRelayMessageDestination_APP_RELAY_MESSAGE_DESTINATION_MOUTHPAD:
-							if (message.which_message_body == mouthware_message_AppToRelayMessage_pass_through_to_mouthpad_tag) {
-								if (ble_transport_is_nus_ready()) {
-									LOG_DBG("CDC→NUS: %d bytes", message.message_body.pass_through_to_mouthpad.data.size);
-									err = ble_transport_send_nus_data(message.message_body.pass_through_to_mouthpad.data.bytes, message.message_body.pass_through_to_mouthpad.data.size);
-									if (err) {
-										LOG_WRN("CDC→NUS failed (err %d)", err);
-									}
-								} else {
-									LOG_DBG("NUS not ready, dropping %d bytes", message.message_body.pass_through_to_mouthpad.data.size);
-								}
-							}
-							break;
-
-						default:
-							LOG_WRN("Invalid destination: %d", message.destination);
-							break;
-					}
-
-					// Reset for next frame
-					frame_state = FRAME_STATE_SEARCH_MAGIC1;
-					break;
-			}
-		}
-		
-		/* Update LED state based on connection and HID activity only */
-		if (leds_is_available()) {
-			if (is_connected && ble_hid_activity) {
-				leds_set_state(LED_STATE_DATA_ACTIVITY);
-			} else if (is_connected) {
-				leds_set_state(LED_STATE_CONNECTED);
-			} else {
-				leds_set_state(LED_STATE_SCANNING);
-			}
+	return 0;
+}
 
-			/* Update LED animations */
-			leds_update();
-		}
-		
-		/* Update button state */
-		if (button_is_available()) {
-			button_update();
-		}
+/* Shell command: Display the event trace kept across resets */
+static int cmd_trace(const struct shell *sh, size_t argc, char **argv)
+{
+	struct trace_record record;
+	char line[80];
 
-		// Update OLED display every 500ms for responsive connection status updates (if available)
-		// Reduced frequency to avoid overwhelming RSSI reads
-		if (oled_display_is_available()) {
-			display_update_counter++;
-			if (display_update_counter >= 500) {
-				oled_display_update_status(battery_level, is_connected, rssi_dbm);
-				display_update_counter = 0;
-			}
-		}
-		
-		// Small delay to prevent busy waiting
-		k_sleep(K_MSEC(1));
+	if (argc == 2 && strcmp(argv[1], "clear") == 0) {
+		trace_ring_clear();
+		shell_print(sh, "Trace cleared");
+		return 0;
+	}
+
+	if (argc > 1) {
+		shell_error(sh, "Usage: trace [clear]");
+		return -EINVAL;
+	}
+
+	shell_print(sh, "=== Trace (boot #%u, oldest first) ===", trace_ring_boot_count());
+	for (size_t i = 0; trace_ring_get(i, &record); i++) {
+		trace_ring_format(&record, line, sizeof(line));
+		shell_print(sh, "  %s", line);
+	}
+	shell_print(sh, "======================================");
+
+	return 0;
+}
+
+/* Shell command: Display pipeline and worker stalls and the last snapshot */
+static int cmd_stall(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[80];
+	int len;
+
+	if (argc == 2 && strcmp(argv[1], "clear") == 0) {
+		stall_watch_clear();
+		shell_print(sh, "Stall counters and snapshot cleared");
+		return 0;
+	}
+
+	if (argc > 1) {
+		shell_error(sh, "Usage: stall [clear]");
+		return -EINVAL;
+	}
+
+	if (!IS_ENABLED(CONFIG_RELAY_STALL_WATCH)) {
+		shell_error(sh, "Stall watch not enabled (CONFIG_RELAY_STALL_WATCH)");
+		return -ENOTSUP;
+	}
+
+	shell_print(sh, "=== Stalls ===");
+	for (size_t i = 0; (len = stall_watch_format(i, line, sizeof(line))) > 0; i++) {
+		shell_print(sh, "%s", line);
+	}
+	shell_print(sh, "==============");
+
+	return 0;
+}
+
+/* Shell command: Display per-message relay protocol handler timings */
+static int cmd_dispatch(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[128];
+	bool any = false;
+
+	if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+		relay_dispatch_reset_stats();
+		shell_print(sh, "Relay message counters cleared");
+		return 0;
+	}
+
+	if (argc > 1) {
+		shell_error(sh, "Usage: dispatch [reset]");
+		return -EINVAL;
+	}
+
+	shell_print(sh, "=== Relay Message Handlers ===");
+	for (pb_size_t tag = 0; tag < RELAY_DISPATCH_TAG_COUNT; tag++) {
+		if (relay_dispatch_format(tag, line, sizeof(line)) > 0) {
+			shell_print(sh, "  %s", line);
+			any = true;
+		}
+	}
+	if (!any) {
+		shell_print(sh, "  No messages handled");
+	}
+	shell_print(sh, "==============================");
+
+	return 0;
+}
+
+/* Shell command: Inject faults into the relay paths, or display them */
+static int cmd_fault(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[96];
+	int len;
+
+	if (!IS_ENABLED(CONFIG_RELAY_FAULT_INJECT)) {
+		shell_error(sh, "Fault injection not enabled (CONFIG_RELAY_FAULT_INJECT)");
+		return -ENOTSUP;
+	}
+
+	if (argc > 1 && fault_inject_command(argc - 1, &argv[1]) != 0) {
+		shell_error(sh, "Usage: fault [off | drop hid|nus <permille> |");
+		shell_error(sh, "       delay hid|nus <permille> <us> | usbbusy <permille> |");
+		shell_error(sh, "       cdcstall <ms> | disconnect <phase> [count] | seed <n>]");
+		return -EINVAL;
+	}
+
+	shell_print(sh, "=== Faults ===");
+	for (size_t i = 0; (len = fault_inject_format(i, line, sizeof(line))) > 0; i++) {
+		shell_print(sh, "  %s", line);
+	}
+	shell_print(sh, "==============");
+
+	return 0;
+}
+
+/* Shell command: Display the hourly link history per MouthPad */
+static int cmd_history(const struct shell *sh, size_t argc, char **argv)
+{
+	char line[200];
+	int len;
+
+	if (!IS_ENABLED(CONFIG_RELAY_LINK_HISTORY)) {
+		shell_error(sh, "Link history not enabled (CONFIG_RELAY_LINK_HISTORY)");
+		return -ENOTSUP;
+	}
+
+	if (argc == 2 && strcmp(argv[1], "clear") == 0) {
+		link_history_clear();
+		shell_print(sh, "Link history cleared at the next sample");
+		return 0;
+	}
+
+	if (argc > 1) {
+		shell_error(sh, "Usage: history [clear]");
+		return -EINVAL;
+	}
+
+	shell_print(sh, "=== Link history (boot #%u, oldest hour first) ===",
+		    trace_ring_boot_count());
+	shell_print(sh, "  rssi mean/p95 dBm, latency p50/p95/p99, phy 1M/2M/Coded,");
+	shell_print(sh, "  profile low latency/balanced/battery");
+	for (size_t i = 0; (len = link_history_format(i, line, sizeof(line))) > 0; i++) {
+		shell_print(sh, "  %s", line);
+	}
+	shell_print(sh, "===================================================");
+
+	return 0;
+}
+
+/* Shell command: Drive the USB side with synthetic HID reports or
+ * pass-through frames, no MouthPad needed
+ */
+static int cmd_bench(const struct shell *sh, size_t argc, char **argv)
+{
+	struct relay_bench_params params = {0};
+	struct relay_bench_result result;
+	int err;
+
+	if (strcmp(argv[1], "hid") == 0) {
+		params.kind = RELAY_BENCH_HID;
+		params.rate_hz = strtoul(argv[2], NULL, 10);
+		params.duration_ms = strtoul(argv[3], NULL, 10) * MSEC_PER_SEC;
+		params.report_id = argc > 4 ? strtoul(argv[4], NULL, 10)
+					    : MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION;
+	} else if (strcmp(argv[1], "nus") == 0 && argc == 5) {
+		params.kind = RELAY_BENCH_PASS_THROUGH;
+		params.size = strtoul(argv[2], NULL, 10);
+		params.rate_hz = strtoul(argv[3], NULL, 10);
+		params.duration_ms = strtoul(argv[4], NULL, 10) * MSEC_PER_SEC;
+	} else {
+		shell_error(sh, "Usage: bench hid <rate_hz> <seconds> [report_id]");
+		shell_error(sh, "       bench nus <bytes> <rate_hz> <seconds>");
+		return -EINVAL;
+	}
+
+	err = relay_bench_run(&params, &result);
+	if (err == -EBUSY) {
+		shell_error(sh, "Disconnect the MouthPad first, or wait for the running bench");
+		return err;
+	} else if (err) {
+		shell_error(sh, "Bench not started (err %d)", err);
+		return err;
+	}
+
+	uint32_t elapsed_ms = MAX(result.elapsed_ms, 1);
+
+	shell_print(sh, "=== Bench Results ===");
+	if (result.aborted) {
+		shell_warn(sh, "Stopped early: a MouthPad connected");
+	}
+	shell_print(sh, "Elapsed:    %u ms", result.elapsed_ms);
+	shell_print(sh, "Sent:       %u of %u (%u/s)", result.sent, result.attempted,
+		    (uint32_t)((uint64_t)result.sent * MSEC_PER_SEC / elapsed_ms));
+	if (params.kind == RELAY_BENCH_HID) {
+		shell_print(sh, "Coalesced:  %u", result.coalesced);
+	}
+	shell_print(sh, "Dropped:    %u", result.dropped);
+	shell_print(sh, "Late slots: %u", result.late);
+	shell_print(sh, "Max call:   %u us", result.max_call_us);
+
+	if (params.kind == RELAY_BENCH_HID) {
+		struct hid_latency_stats stats;
+
+		if (hid_latency_get_stats(params.report_id, &stats) == 0) {
+			shell_print(sh, "Latency:    p50 %u p99 %u max %u us over %u reports",
+				    stats.p50_us, stats.p99_us, stats.max_us, stats.count);
+		}
+	} else {
+		shell_print(sh, "Throughput: %u B/s",
+			    (uint32_t)((uint64_t)result.sent * params.size * MSEC_PER_SEC /
+				       elapsed_ms));
+		shell_print(sh, "TX ring:    peak %u bytes, %u frames dropped", result.ring_peak,
+			    result.ring_dropped);
+	}
+	shell_print(sh, "=====================");
+
+	return 0;
+}
+
+SHELL_CMD_ARG_REGISTER(bench, NULL,
+		       "Drive USB with synthetic load (bench hid <rate_hz> <s> [id] | nus <bytes> <rate_hz> <s>)",
+		       cmd_bench, 4, 1);
+SHELL_CMD_REGISTER(bonds, NULL, "Display bonded devices", cmd_bonds);
+SHELL_CMD_ARG_REGISTER(cdc, NULL, "Display CDC0 TX ring usage (cdc [reset])", cmd_cdc, 1, 1);
+SHELL_CMD_REGISTER(clearfwcache, NULL, "Clear cached firmware versions", cmd_clear_fw_cache);
+SHELL_CMD_REGISTER(dfu, NULL, "Enter DFU bootloader mode", cmd_dfu);
+SHELL_CMD_REGISTER(disconnect, NULL, "Drop the MouthPad link (it reconnects)", cmd_disconnect);
+SHELL_CMD_ARG_REGISTER(dispatch, NULL, "Display relay message handler timings (dispatch [reset])",
+		       cmd_dispatch, 1, 1);
+SHELL_CMD_ARG_REGISTER(fault, NULL,
+		       "Inject faults for resilience testing (fault [off | drop | delay | usbbusy | cdcstall | disconnect | seed])",
+		       cmd_fault, 1, 4);
+SHELL_CMD_REGISTER(fwupdate, NULL, "Display the firmware update in progress", cmd_fwupdate);
+SHELL_CMD_REGISTER(hididle, NULL, "Display HID idle rates and suppressed reports", cmd_hididle);
+SHELL_CMD_ARG_REGISTER(history, NULL, "Display the hourly link history per MouthPad (history [clear])",
+		       cmd_history, 1, 1);
+SHELL_CMD_ARG_REGISTER(latency, NULL, "Display BLE->USB HID latency (latency [reset])", cmd_latency, 1, 1);
+SHELL_CMD_ARG_REGISTER(mem, NULL, "Display heap and buffer pool usage (mem [reset])", cmd_mem, 1, 1);
+SHELL_CMD_REGISTER(nusstream, NULL, "Display the bulk NUS stream to the MouthPad", cmd_nusstream);
+SHELL_CMD_REGISTER(phy, NULL, "Display the primary link PHY, TX power and link guard", cmd_phy);
+SHELL_CMD_REGISTER(profile, NULL, "Display the tuning profile (* overridden)", cmd_profile);
+SHELL_CMD_REGISTER(streams, NULL, "Display the MouthPad stream filter and sensor codec", cmd_streams);
+SHELL_CMD_REGISTER(reset, NULL, "Reset stored BLE bonds", cmd_reset);
+SHELL_CMD_REGISTER(restart, NULL, "Restart firmware", cmd_restart);
+SHELL_CMD_REGISTER(serial, NULL, "Display USB serial number", cmd_serial);
+SHELL_CMD_REGISTER(usbcomp, NULL, "Display the USB composition (active, saved)", cmd_usbcomp);
+SHELL_CMD_ARG_REGISTER(stall, NULL, "Display pipeline and worker stalls (stall [clear])", cmd_stall,
+		       1, 1);
+SHELL_CMD_ARG_REGISTER(stats, NULL, "Display NUS/HID data path counters (stats [reset | trace on|off])",
+		       cmd_stats, 1, 2);
+SHELL_CMD_ARG_REGISTER(timing, NULL, "Display per-phase connection timings (timing [clear])",
+		       cmd_timing, 1, 1);
+SHELL_CMD_REGISTER(top, NULL, "Display per-thread CPU, switches and stack since the last read",
+		   cmd_top);
+SHELL_CMD_ARG_REGISTER(trace, NULL, "Display the event trace kept across resets (trace [clear])",
+		       cmd_trace, 1, 1);
+SHELL_CMD_REGISTER(version, NULL, "Display firmware version", cmd_version);
+
+#endif /* CONFIG_RELAY_SHELL */
+
+/* Battery color indication mode - automatically set based on LED hardware */
+/* GPIO LEDs use discrete mode, NeoPixel uses gradient mode */
+
+/* Button event callback function */
+static void button_event_callback(button_event_t event)
+{
+	/* Someone is at the relay: find their MouthPad without waiting out a backed-off scan */
+	ble_central_scan_boost();
+
+	switch (event) {
+	case BUTTON_EVENT_CLICK:
+		LOG_INF("=== BUTTON CLICK ===");
+		/* Reserved for future functionality */
+		break;
+
+	case BUTTON_EVENT_DOUBLE_CLICK:
+		LOG_INF("=== BUTTON DOUBLE CLICK - NEXT TUNING PROFILE ===");
+		relay_tuning_cycle();
+		break;
+
+	case BUTTON_EVENT_TRIPLE_CLICK:
+		LOG_INF("=== BUTTON TRIPLE CLICK - NEXT USB COMPOSITION ===");
+		relay_usb_composition_cycle();
+		break;
+
+	case BUTTON_EVENT_HOLD:
+		LOG_INF("=== BUTTON HOLD - CLEARING BLE BONDS ===");
+		/* Clear BLE bonds and reset for new pairing */
+		clear_ble_pairings();
+		break;
+		
+	default:
+		break;
+	}
+}
+
+/* Host output report (report ID first), from the USB stack thread. It is
+ * only queued here; ble_hid writes it to the MouthPad.
+ */
+static void usb_hid_data_callback(const uint8_t *data, uint16_t len)
+{
+	if (ble_transport_is_hid_ready()) {
+		int err = ble_transport_send_hid_data(data, len);
+		if (err) {
+			LOG_DBG("USB HID output report not queued (err %d)", err);
+		}
+	} else {
+		LOG_DBG("HID client not ready - output report dropped");
+	}
+}
+
+int mouthpad_nus_data_received_callback(const uint8_t *data, uint16_t len)
+{
+	/* Forward data from MouthPad (BLE NUS) to USB CDC0 - minimal logging to keep CDC0 clean */
+	LOG_DBG("NUS→CDC: %d bytes", len);
+
+	// Sensor frames go delta coded when the host asked for it (sensor_codec.h)
+	if (sensor_codec_wants(data, len)) {
+		mouthware_message_RelayToAppMessage *message = usb_cdc_message_reserve();
+
+		if (!message) {
+			sensor_codec_resync();
+			relay_stats_add(RELAY_STATS_NUS_RX, RELAY_STATS_DROPPED, 1);
+			return -ENOMEM;
+		}
+		if (sensor_codec_encode(data, len, &message->message_body.sensor_frame_delta)) {
+			message->which_message_body =
+				mouthware_message_RelayToAppMessage_sensor_frame_delta_tag;
+			usb_cdc_message_commit(message);
+			relay_stats_add(RELAY_STATS_NUS_RX, RELAY_STATS_BRIDGED, 1);
+			return 0;
+		}
+		/* Turned off in the meantime */
+		usb_cdc_message_abort(message);
+	}
+
+	// take binary data received via BLE, wrap it in a PassThroughToApp and send it to the USB CDC
+	int err = usb_cdc_send_pass_through(data, len, 0);
+
+	relay_stats_add(RELAY_STATS_NUS_RX, err ? RELAY_STATS_DROPPED : RELAY_STATS_BRIDGED, 1);
+
+	return err;
+}
+
+#if defined(CONFIG_BLE_MULTI_MOUTHPAD)
+#define PASS_THROUGH_LINKS (1 + CONFIG_BLE_SECONDARY_MOUTHPADS)
+#else
+#define PASS_THROUGH_LINKS 1
+#endif
+
+/* Completions the host asked to hear about together, by device index
+ * (pass_through_ack.h). Fed from the BT RX thread, the real-time and the
+ * protocol work queues; flushed on the protocol work queue once the oldest
+ * has waited PASS_THROUGH_ACK_INTERVAL_US.
+ */
+static struct pass_through_ack pass_through_acks[PASS_THROUGH_LINKS];
+static struct k_spinlock pass_through_ack_lock;
+
+static void pass_through_ack_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(pass_through_ack_work, pass_through_ack_work_handler);
+
+/* How many writes the host may keep unacknowledged, so it never overflows
+ * the NUS TX queue; a secondary MouthPad takes one write at a time
+ */
+static uint32_t pass_through_credits(uint32_t device_index)
+{
+	return device_index == 0 ? ble_transport_get_nus_tx_window() : 1;
+}
+
+static void pass_through_to_mouthpad_report(mouthware_message_PassThroughToMouthpadErrorCode error_code,
+					    uint32_t device_index,
+					    struct pass_through_ack_report report)
+{
+	mouthware_message_RelayToAppMessage *message = usb_cdc_message_reserve();
+
+	if (!message) {
+		return;
+	}
+
+	message->which_message_body = mouthware_message_RelayToAppMessage_pass_through_to_mouthpad_response_tag;
+	message->message_body.pass_through_to_mouthpad_response.error_code = error_code;
+	message->message_body.pass_through_to_mouthpad_response.credits =
+		pass_through_credits(device_index);
+	message->message_body.pass_through_to_mouthpad_response.device_index = device_index;
+	message->message_body.pass_through_to_mouthpad_response.sequence = report.sequence;
+	message->message_body.pass_through_to_mouthpad_response.acked = report.acked;
+	usb_cdc_message_commit(message);
+}
+
+/* A PassThroughToMouthpad write completed or was refused; answer it as its
+ * ack mode asks
+ */
+static void pass_through_to_mouthpad_respond(mouthware_message_PassThroughToMouthpadErrorCode error_code,
+					     uint32_t device_index,
+					     struct pass_through_ack_tag ack)
+{
+	bool ok = error_code ==
+		  mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED;
+	/* Nothing is pending for a device index that does not exist */
+	struct pass_through_ack none = {0};
+	struct pass_through_ack *state = device_index < ARRAY_SIZE(pass_through_acks)
+						 ? &pass_through_acks[device_index]
+						 : &none;
+	k_spinlock_key_t key = k_spin_lock(&pass_through_ack_lock);
+	struct pass_through_ack_report report = pass_through_ack_complete(
+		state, ack, ok, pass_through_ack_writes(pass_through_credits(device_index)));
+	bool pending = pass_through_ack_pending(state);
+
+	k_spin_unlock(&pass_through_ack_lock, key);
+
+	/* Left alone while scheduled, so the oldest completion sets the
+	 * deadline; a flush that finds nothing left sends nothing
+	 */
+	if (pending) {
+		k_work_schedule_for_queue(&relay_workq_protocol, &pass_through_ack_work,
+					  K_USEC(PASS_THROUGH_ACK_INTERVAL_US));
+	}
+
+	if (report.acked > 0) {
+		pass_through_to_mouthpad_report(error_code, device_index, report);
+	}
+}
+
+static void pass_through_ack_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(pass_through_acks); i++) {
+		k_spinlock_key_t key = k_spin_lock(&pass_through_ack_lock);
+		struct pass_through_ack_report report = pass_through_ack_flush(&pass_through_acks[i]);
+
+		k_spin_unlock(&pass_through_ack_lock, key);
+
+		if (report.acked > 0) {
+			pass_through_to_mouthpad_report(
+				mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED,
+				i, report);
+		}
+	}
+}
+
+static mouthware_message_PassThroughToMouthpadErrorCode pass_through_error_code(int err)
+{
+	switch (err) {
+	case 0:
+		return mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNSPECIFIED;
+	case -ENOBUFS:
+		/* NUS TX queue full: the host sent more than its credits */
+		return mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_TIMEOUT;
+	case -EMSGSIZE:
+		return mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_TOO_LARGE;
+	default:
+		return mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_UNKNOWN_ERROR;
+	}
+}
+
+/* NUS write completed (BT RX thread or the real-time work queue) */
+static void nus_write_sent(uint8_t err, struct pass_through_ack_tag ack)
+{
+	pass_through_to_mouthpad_respond(pass_through_error_code(err ? -EIO : 0), 0, ack);
+}
+
+/* Write to a secondary MouthPad completed (BT RX thread) */
+static void secondary_write_sent(uint32_t device_index, uint8_t err,
+				 struct pass_through_ack_tag ack)
+{
+	pass_through_to_mouthpad_respond(pass_through_error_code(err ? -EIO : 0), device_index,
+					 ack);
+}
+
+/* Forward a host->MouthPad write to NUS; the data is copied into the NUS TX queue.
+ * Failures are reported to the host here and returned for the dispatch counters.
+ */
+static int pass_through_to_mouthpad_forward(const struct mouthpad_pass_through_to_mouthpad *pt)
+{
+	struct pass_through_ack_tag ack = {.sequence = pt->sequence, .mode = pt->ack};
+	int err;
+
+	if (pt->more_fragments || pt->fragment != 0) {
+		/* No reassembly buffer here; refuse rather than forward a partial payload */
+		LOG_WRN("Fragmented pass-through not supported");
+		pass_through_to_mouthpad_respond(
+			mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_INVALID_MESSAGE,
+			pt->device_index, ack);
+		return -EMSGSIZE;
+	}
+
+	if (pt->device_index != 0) {
+		err = ble_secondary_send(pt->device_index, pt->data, pt->len, ack);
+		if (err == -ENOTCONN) {
+			LOG_DBG("MouthPad %u not ready, dropping %zu bytes", pt->device_index, pt->len);
+			pass_through_to_mouthpad_respond(
+				mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED,
+				pt->device_index, ack);
+		} else if (err) {
+			LOG_WRN("CDC→MouthPad %u failed (err %d)", pt->device_index, err);
+			pass_through_to_mouthpad_respond(pass_through_error_code(err), pt->device_index,
+							 ack);
+		}
+		/* Otherwise acknowledged by secondary_write_sent */
+		return err;
+	}
+
+	if (!ble_transport_is_nus_ready()) {
+		LOG_DBG("NUS not ready, dropping %zu bytes", pt->len);
+		pass_through_to_mouthpad_respond(
+			mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED,
+			0, ack);
+		return -ENOTCONN;
+	}
+
+	LOG_DBG("CDC→NUS: %zu bytes", pt->len);
+	err = ble_transport_send_nus_data(pt->data, pt->len, pt->reliable, ack);
+	if (err) {
+		LOG_WRN("CDC→NUS failed (err %d)", err);
+		pass_through_to_mouthpad_respond(pass_through_error_code(err), 0, ack);
+	}
+	/* Otherwise acknowledged by nus_write_sent once the write completes */
+	return err;
+}
+
+/* BleConnectionStatusResponse for the current link, for a status query or a pushed change */
+static void ble_connection_status_fill(mouthware_message_RelayToAppMessage *response)
+{
+	mouthware_message_BleConnectionStatusResponse *status =
+		&response->message_body.ble_connection_status_response;
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_ble_connection_status_response_tag;
+
+	/* One snapshot; the phase is the ble_central state machine's */
+	struct link_state link_now;
+
+	link_state_get(&link_now);
+	LOG_DBG("Link state v%u: phase=%u, ready=0x%x", link_now.version, link_now.phase,
+		link_now.ready);
+
+	switch (link_now.phase) {
+	case LINK_STATE_CONNECTING:
+		status->connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTING;
+		break;
+	case LINK_STATE_SCANNING:
+		status->connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_SEARCHING;
+		break;
+	case LINK_STATE_CONNECTED:
+		status->connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_CONNECTED;
+		break;
+	default:
+		status->connection_status = mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_DISCONNECTED;
+		break;
+	}
+
+	status->rssi = link_state_is_up(&link_now) ? link_now.rssi : 0;
+	status->battery_level = link_now.battery_level;
+	status->connected_devices =
+		(link_now.phase == LINK_STATE_CONNECTED ? 1 : 0) + ble_secondary_count();
+
+	struct ble_transport_link_info link;
+
+	if (ble_transport_get_link_info(&link) == 0) {
+		status->tx_phy = link.tx_phy;
+		status->rx_phy = link.rx_phy;
+		status->max_tx_octets = link.tx_max_len;
+		status->max_rx_octets = link.rx_max_len;
+	}
+}
+
+static int handle_ble_connection_status_read(const mouthware_message_AppToRelayMessage *message)
+{
+	if (message->message_body.ble_connection_status_read.scan_boost) {
+		ble_central_scan_boost();
+	}
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	LOG_INF("=== BLE STATUS QUERY ===");
+	ble_connection_status_fill(response);
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle DeviceInfoRead request */
+static int handle_device_info_read(const mouthware_message_AppToRelayMessage *message)
+{
+	return relay_device_info_send(message->request_id);
+}
+
+/* Handle ClearBondsWrite request */
+static int handle_clear_bonds_write(const mouthware_message_AppToRelayMessage *message)
+{
+	ARG_UNUSED(message);
+
+	LOG_INF("=== CLEAR BONDS REQUEST (via protobuf) ===");
+
+	/* Clear BLE bonds using existing logic */
+	clear_ble_pairings();
+
+	/* Send success response */
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_clear_bonds_response_tag;
+	response->message_body.clear_bonds_response.success = true;
+
+	LOG_INF("Bonds cleared successfully, sending response");
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle ClearFirmwareCacheWrite request */
+static int handle_clear_firmware_cache_write(const mouthware_message_AppToRelayMessage *message)
+{
+	ARG_UNUSED(message);
+
+	LOG_INF("=== CLEAR FIRMWARE CACHE REQUEST (via protobuf) ===");
+
+	/* Clear cached firmware versions for all bonded devices */
+	ble_dis_clear_all_cached_firmware();
+
+	/* Send success response */
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_clear_firmware_cache_response_tag;
+	response->message_body.clear_firmware_cache_response.success = true;
+
+	LOG_INF("Firmware cache cleared, sending response");
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle HidLatencyRead request - report per-report-ID histograms */
+static int handle_hid_latency_read(const mouthware_message_AppToRelayMessage *message)
+{
+	ARG_UNUSED(message);
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_hid_latency_response_tag;
+
+	mouthware_message_HidLatencyResponse *lat = &response->message_body.hid_latency_response;
+	for (uint8_t id = 1; id <= HID_LATENCY_REPORT_ID_MAX &&
+	     lat->reports_count < ARRAY_SIZE(lat->reports); id++) {
+		struct hid_latency_stats stats;
+
+		if (hid_latency_get_stats(id, &stats) != 0) {
+			break;
+		}
+		lat->reports[lat->reports_count++] = (mouthware_message_HidLatencyReportStats){
+			.report_id = stats.report_id,
+			.count = stats.count,
+			.p50_us = stats.p50_us,
+			.p99_us = stats.p99_us,
+			.max_us = stats.max_us,
+		};
+	}
+
+	LOG_INF("Sending HID latency stats for %d report IDs", lat->reports_count);
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle RelayStatsRead request - report NUS/HID data path counters */
+static int handle_relay_stats_read(const mouthware_message_AppToRelayMessage *message)
+{
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_relay_stats_response_tag;
+
+	mouthware_message_RelayStatsResponse *rs = &response->message_body.relay_stats_response;
+	mouthware_message_RelayStatsPathCounters *paths[RELAY_STATS_PATH_COUNT] = {
+		[RELAY_STATS_NUS_RX] = &rs->nus_rx,
+		[RELAY_STATS_NUS_TX] = &rs->nus_tx,
+		[RELAY_STATS_HID] = &rs->hid,
+	};
+	for (int path = 0; path < RELAY_STATS_PATH_COUNT; path++) {
+		struct relay_stats_snapshot stats;
+
+		relay_stats_get(path, &stats);
+		*paths[path] = (mouthware_message_RelayStatsPathCounters){
+			.packets = stats.packets,
+			.bytes = stats.bytes,
+			.echo_filtered = stats.echo_filtered,
+			.dropped = stats.dropped,
+			.bridged = stats.bridged,
+		};
+	}
+	rs->has_nus_rx = true;
+	rs->has_nus_tx = true;
+	rs->has_hid = true;
+
+	if (message->message_body.relay_stats_read.reset) {
+		relay_stats_reset();
+	}
+
+	LOG_INF("Sending data path counters%s",
+		message->message_body.relay_stats_read.reset ? " (reset)" : "");
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle ConnectionTimingRead request - report recent connection phase timings */
+static int handle_connection_timing_read(const mouthware_message_AppToRelayMessage *message)
+{
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_connection_timing_response_tag;
+
+	connection_timing_fill_response(&response->message_body.connection_timing_response);
+
+	if (message->message_body.connection_timing_read.clear) {
+		connection_timing_clear();
+	}
+
+	LOG_INF("Sending timings for %d connection attempts%s",
+		response->message_body.connection_timing_response.records_count,
+		message->message_body.connection_timing_read.clear ? " (cleared)" : "");
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle LinkTelemetrySubscribe - samples are pushed from the background queue */
+static int handle_link_telemetry_subscribe(const mouthware_message_AppToRelayMessage *message)
+{
+	relay_telemetry_subscribe(&message->message_body.link_telemetry_subscribe);
+
+	return 0;
+}
+
+/* Handle HidMirrorConfigWrite - batches are pushed from the background queue */
+static int handle_hid_mirror_config(const mouthware_message_AppToRelayMessage *message)
+{
+	bool enable = message->message_body.hid_mirror_config_write.enabled;
+
+	relay_hid_mirror_enable(enable);
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_hid_mirror_config_response_tag;
+	response->message_body.hid_mirror_config_response.enabled = enable;
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle ThreadStatsRead - per-thread CPU and stack usage since the last read */
+static int handle_thread_stats_read(const mouthware_message_AppToRelayMessage *message)
+{
+	static struct thread_stats_report report;
+	static mouthware_message_RelayToAppMessage response;
+	int err;
+
+	err = relay_thread_stats_read(&report);
+	if (err) {
+		return err;
+	}
+
+	response = (mouthware_message_RelayToAppMessage)mouthware_message_RelayToAppMessage_init_zero;
+	response.which_message_body = mouthware_message_RelayToAppMessage_thread_stats_response_tag;
+	response.request_id = message->request_id;
+	thread_stats_fill_response(&report, &response.message_body.thread_stats_response);
+
+	/* The thread list is encoded from report, so send it from here */
+	return usb_cdc_send_message(mouthware_message_RelayToAppMessage_fields, &response);
+}
+
+/* Handle MemStatsRead - heap and buffer pool usage */
+static int handle_mem_stats_read(const mouthware_message_AppToRelayMessage *message)
+{
+	static struct mem_stats_report report;
+	static mouthware_message_RelayToAppMessage response;
+	int err;
+
+	err = relay_mem_stats_read(&report);
+	if (err) {
+		return err;
+	}
+
+	response = (mouthware_message_RelayToAppMessage)mouthware_message_RelayToAppMessage_init_zero;
+	response.which_message_body = mouthware_message_RelayToAppMessage_mem_stats_response_tag;
+	response.request_id = message->request_id;
+	mem_stats_fill_response(&report, &response.message_body.mem_stats_response);
+
+	/* The pools are encoded from report, so send it from here */
+	err = usb_cdc_send_message(mouthware_message_RelayToAppMessage_fields, &response);
+	if (!err && message->message_body.mem_stats_read.reset) {
+		relay_mem_stats_reset();
+	}
+	return err;
+}
+
+/* Handle TraceRead - one page of the event trace kept across resets */
+static int handle_trace_read(const mouthware_message_AppToRelayMessage *message)
+{
+	const mouthware_message_TraceRead *read = &message->message_body.trace_read;
+	static mouthware_message_RelayToAppMessage response;
+	int err;
+
+	response = (mouthware_message_RelayToAppMessage)mouthware_message_RelayToAppMessage_init_zero;
+	response.which_message_body = mouthware_message_RelayToAppMessage_trace_response_tag;
+	response.request_id = message->request_id;
+	trace_ring_fill_response(read->offset, &response.message_body.trace_response);
+
+	/* The records are encoded from the ring, so send it from here */
+	err = usb_cdc_send_message(mouthware_message_RelayToAppMessage_fields, &response);
+	if (!err && read->clear) {
+		trace_ring_clear();
+	}
+	return err;
+}
+
+/* Handle LinkHistoryRead - one page of one MouthPad's hourly history */
+static int handle_link_history_read(const mouthware_message_AppToRelayMessage *message)
+{
+	const mouthware_message_LinkHistoryRead *read = &message->message_body.link_history_read;
+	static mouthware_message_RelayToAppMessage response;
+
+	if (!IS_ENABLED(CONFIG_RELAY_LINK_HISTORY)) {
+		return -ENOTSUP;
+	}
+	if (read->clear) {
+		link_history_clear();
+	}
+
+	response = (mouthware_message_RelayToAppMessage)mouthware_message_RelayToAppMessage_init_zero;
+	response.which_message_body = mouthware_message_RelayToAppMessage_link_history_response_tag;
+	response.request_id = message->request_id;
+	link_history_fill_response(read->bond, read->offset,
+				   &response.message_body.link_history_response);
+
+	/* The buckets are encoded from a page link_history keeps, so send it from here */
+	return usb_cdc_send_message(mouthware_message_RelayToAppMessage_fields, &response);
+}
+
+/* Handle FwUpdateStart/Chunk/End - copied aside here, written to flash
+ * from the background work queue (relay_fw_update.h)
+ */
+static int handle_fw_update(const mouthware_message_AppToRelayMessage *message)
+{
+	return fw_update_handle(message);
+}
+
+/* Handle NusStreamControl/Write - copied into the stream ring here, cut
+ * into NUS writes on the real-time work queue (relay_nus_stream.h)
+ */
+static int handle_nus_stream(const mouthware_message_AppToRelayMessage *message)
+{
+	return nus_stream_handle(message);
+}
+
+/* Handle SensorStreamFilterWrite - the filter is applied on the BT RX
+ * thread as notifications arrive (sensor_stream.h)
+ */
+static int handle_sensor_stream_filter(const mouthware_message_AppToRelayMessage *message)
+{
+	sensor_stream_set_blocked(message->message_body.sensor_stream_filter_write.blocked);
+	LOG_INF("MouthPad streams blocked: 0x%x", sensor_stream_blocked());
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_sensor_stream_filter_response_tag;
+	sensor_stream_get_status(&response->message_body.sensor_stream_filter_response);
+
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle SensorStreamRateWrite - streams are thinned on the BT RX thread
+ * as notifications arrive (sensor_stream.h)
+ */
+static int handle_sensor_stream_rate(const mouthware_message_AppToRelayMessage *message)
+{
+	const mouthware_message_SensorStreamRateWrite *rate =
+		&message->message_body.sensor_stream_rate_write;
+
+	if (sensor_stream_set_rate(rate->stream, rate->keep_one_in, rate->min_interval_us)) {
+		LOG_INF("MouthPad stream %d: 1 in %u, every %u us", rate->stream,
+			rate->keep_one_in, rate->min_interval_us);
+	} else {
+		LOG_WRN("Unknown MouthPad stream %d", rate->stream);
+	}
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_sensor_stream_rate_response_tag;
+	sensor_stream_get_rate(rate->stream, &response->message_body.sensor_stream_rate_response);
+
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle RelayProfileWrite - the knobs are acted on by their owners as
+ * they change (relay_tuning.h)
+ */
+static int handle_relay_profile(const mouthware_message_AppToRelayMessage *message)
+{
+	return relay_tuning_write(&message->message_body.relay_profile_write);
+}
+
+/* Handle UsbCompositionWrite - the classes are picked when USB starts,
+ * so a change needs a re-enumeration (relay_usb_composition.h)
+ */
+static int handle_usb_composition(const mouthware_message_AppToRelayMessage *message)
+{
+	return relay_usb_composition_write(&message->message_body.usb_composition_write);
+}
+
+/* Handle SensorCodecConfigWrite - frames are coded on the BT RX thread
+ * as they arrive (sensor_codec.h)
+ */
+static int handle_sensor_codec_config(const mouthware_message_AppToRelayMessage *message)
+{
+	const mouthware_message_SensorCodecConfigWrite *config =
+		&message->message_body.sensor_codec_config_write;
+
+	sensor_codec_configure(config->enabled, config->keyframe_interval);
+	LOG_INF("Sensor codec %s", config->enabled ? "on" : "off");
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_sensor_codec_config_response_tag;
+	sensor_codec_get_status(&response->message_body.sensor_codec_config_response);
+
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle HidConfigRead/Write - motion interpolation and prediction are
+ * ESP-only, so always report them as off to let the app tell the difference */
+static int handle_hid_config(const mouthware_message_AppToRelayMessage *message)
+{
+	ARG_UNUSED(message);
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_hid_config_response_tag;
+	response->message_body.hid_config_response.motion_interpolation = false;
+	response->message_body.hid_config_response.motion_prediction = false;
+
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle PassThroughBatchConfigWrite - batch MouthPad notifications */
+static int handle_pass_through_batch_config_write(const mouthware_message_AppToRelayMessage *message)
+{
+	bool enabled = message->message_body.pass_through_batch_config_write.enabled;
+
+	usb_cdc_set_pass_through_batching(enabled);
+	LOG_INF("Pass-through batching %s", enabled ? "enabled" : "disabled");
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_pass_through_batch_config_response_tag;
+	response->message_body.pass_through_batch_config_response.enabled = usb_cdc_pass_through_batching();
+
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle RelayCapabilitiesRead - tell the host which fast paths it may enable */
+static int handle_relay_capabilities_read(const mouthware_message_AppToRelayMessage *message)
+{
+	ARG_UNUSED(message);
+
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_relay_capabilities_response_tag;
+
+	mouthware_message_RelayCapabilitiesResponse *caps = &response->message_body.relay_capabilities_response;
+
+#ifdef FIRMWARE_VERSION_STRING
+	strncpy(caps->firmware_version, FIRMWARE_VERSION_STRING, sizeof(caps->firmware_version) - 1);
+#endif
+	/* Host->MouthPad fragments are refused, so PASS_THROUGH_FRAGMENTS is not listed */
+	caps->features = mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_BATCH |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_CREDITS |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_LINK_TELEMETRY |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_STATUS_PUSH |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_RELAY_STATS |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_CONNECTION_TIMING |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_HID_LATENCY |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_ECHO |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_HID_MIRROR |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_TRACE |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_STREAM_FILTER |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_CODEC |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_SENSOR_STREAM_RATE |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_REQUEST_ID |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_COBS_FRAMING |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_TUNING_PROFILE |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_PASS_THROUGH_ACK_MODES |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_SCAN_BOOST |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_USB_COMPOSITION |
+			 mouthware_message_RelayFeature_RELAY_FEATURE_RAW_CHANNELS;
+	if (IS_ENABLED(CONFIG_RELAY_THREAD_STATS)) {
+		caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_THREAD_STATS;
+	}
+	if (IS_ENABLED(CONFIG_RELAY_MEM_STATS)) {
+		caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_MEM_STATS;
+	}
+	if (IS_ENABLED(CONFIG_RELAY_FW_UPDATE)) {
+		caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_FW_UPDATE;
+	}
+	if (IS_ENABLED(CONFIG_RELAY_NUS_STREAM)) {
+		caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_NUS_STREAM;
+	}
+	if (IS_ENABLED(CONFIG_RELAY_LINK_HISTORY)) {
+		caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_LINK_HISTORY;
+	}
+	if (IS_ENABLED(CONFIG_BLE_MULTI_MOUTHPAD)) {
+		caps->features |= mouthware_message_RelayFeature_RELAY_FEATURE_SECONDARY_MOUTHPADS;
+	}
+	caps->max_frame_size = MOUTHPAD_FRAME_MAX_PAYLOAD;
+	caps->max_in_flight_writes = ble_transport_get_nus_tx_window();
+	/* The async CDC0 work sends, and batches, whatever is queued when it runs */
+	caps->batch_window_us = 0;
+	caps->max_pass_through_size = SIZEOF_FIELD(mouthware_message_PassThroughToMouthpad_data_t, bytes);
+	/* For the primary; a secondary's single credit makes every response cover one */
+	caps->pass_through_ack_writes = pass_through_ack_writes(caps->max_in_flight_writes);
+	caps->pass_through_ack_interval_us = PASS_THROUGH_ACK_INTERVAL_US;
+
+	LOG_INF("Sending capabilities: features=0x%x, max frame %u, %u writes in flight",
+		(unsigned int)caps->features, (unsigned int)caps->max_frame_size,
+		(unsigned int)caps->max_in_flight_writes);
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* EchoRequest waiting for its timed NUS write to the MouthPad; one at a time */
+static mouthware_message_EchoResponse echo_pending;
+static atomic_t echo_busy;
+
+/* Timed NUS write for an EchoRequest completed (BT RX thread or the real-time work queue) */
+static void echo_sent(uint8_t err, int64_t issued, int64_t completed)
+{
+	mouthware_message_RelayToAppMessage *message = usb_cdc_message_reserve();
+
+	if (message) {
+		mouthware_message_EchoResponse *echo = &message->message_body.echo_response;
+
+		message->which_message_body = mouthware_message_RelayToAppMessage_echo_response_tag;
+		*echo = echo_pending;
+		if (issued) {
+			echo->mouthpad_write_us = issued;
+			echo->mouthpad_ack_us = err ? 0 : completed;
+		}
+		echo->error_code = pass_through_error_code(err ? -EIO : 0);
+		echo->relay_tx_us = relay_time_us64();
+	}
+	atomic_clear(&echo_busy);
+
+	if (message) {
+		usb_cdc_message_commit(message);
+	}
+}
+
+/* Handle EchoRequest - stamped and answered on the CDC0 RX path, so
+ * relay_rx_us and relay_tx_us bracket only this handler. With via_mouthpad
+ * the payload goes out as a timed NUS write and echo_sent answers.
+ */
+static int handle_echo_request(const mouthware_message_AppToRelayMessage *message)
+{
+	const mouthware_message_EchoRequest *request = &message->message_body.echo_request;
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	mouthware_message_EchoResponse *echo = &response->message_body.echo_response;
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_echo_response_tag;
+	echo->relay_rx_us = relay_time_us64();
+	echo->host_timestamp_us = request->host_timestamp_us;
+	time_base_host_sample(request->host_timestamp_us, echo->relay_rx_us);
+	echo->sequence = request->sequence;
+	echo->via_mouthpad = request->via_mouthpad;
+
+	if (request->via_mouthpad) {
+		if (!ble_transport_is_nus_ready()) {
+			echo->error_code =
+				mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_MESSAGE_NOT_CONNECTED;
+		} else if (request->payload.size == 0) {
+			echo->error_code =
+				mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_INVALID_MESSAGE;
+		} else if (atomic_set(&echo_busy, 1)) {
+			/* The previous probe is still waiting for the MouthPad */
+			echo->error_code =
+				mouthware_message_PassThroughToMouthpadErrorCode_PASS_THROUGH_TO_MOUTHPAD_ERROR_CODE_TIMEOUT;
+		} else {
+			echo_pending = *echo;
+
+			int err = ble_transport_send_nus_timed(request->payload.bytes,
+							       request->payload.size, echo_sent);
+
+			if (!err) {
+				usb_cdc_message_abort(response);
+				return 0;
+			}
+			atomic_clear(&echo_busy);
+			echo->error_code = pass_through_error_code(err);
+		}
+	}
+
+	echo->relay_tx_us = relay_time_us64();
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Handle DfuWrite request - enter bootloader mode */
+static int handle_dfu_write(const mouthware_message_AppToRelayMessage *message)
+{
+	ARG_UNUSED(message);
+
+	LOG_INF("=== DFU REQUEST (via protobuf) - entering bootloader ===");
+
+	/* Send success response before reset */
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (response) {
+		response->which_message_body = mouthware_message_RelayToAppMessage_dfu_response_tag;
+		response->message_body.dfu_response.success = true;
+		usb_cdc_message_commit(response);
+	}
+
+	/* Give time for response to be sent */
+	k_sleep(K_MSEC(100));
+
+	/* Disable USB pullup to trigger disconnect before reset */
+	NRF_USBD->USBPULLUP = 0;
+	k_msleep(50);
+
+	/* Set GPREGRET magic value for UF2 bootloader */
+	NRF_POWER->GPREGRET = 0x57;
+
+	/* Perform system reset */
+	NVIC_SystemReset();
+
+	return 0;
+}
+
+/* Indexed by which_message_body. Inline handlers only touch RAM; the rest
+ * run on the protocol work queue so they cannot stall CDC0 parsing.
+ */
+#define RELAY_HANDLER(msg, fn, inl) \
+	[mouthware_message_AppToRelayMessage_##msg##_tag] = { #msg, handle_##fn, inl }
+
+static const struct relay_dispatch_entry relay_dispatch_table[RELAY_DISPATCH_TAG_COUNT] = {
+	RELAY_HANDLER(ble_connection_status_read, ble_connection_status_read, false),
+	RELAY_HANDLER(device_info_read, device_info_read, false),
+	RELAY_HANDLER(clear_bonds_write, clear_bonds_write, false),
+	RELAY_HANDLER(dfu_write, dfu_write, false),
+	RELAY_HANDLER(clear_firmware_cache_write, clear_firmware_cache_write, false),
+	RELAY_HANDLER(hid_latency_read, hid_latency_read, false),
+	RELAY_HANDLER(hid_config_read, hid_config, true),
+	RELAY_HANDLER(hid_config_write, hid_config, true),
+	RELAY_HANDLER(pass_through_batch_config_write, pass_through_batch_config_write, true),
+	RELAY_HANDLER(relay_stats_read, relay_stats_read, false),
+	RELAY_HANDLER(connection_timing_read, connection_timing_read, false),
+	RELAY_HANDLER(link_telemetry_subscribe, link_telemetry_subscribe, true),
+	RELAY_HANDLER(relay_capabilities_read, relay_capabilities_read, true),
+	RELAY_HANDLER(echo_request, echo_request, true),
+	RELAY_HANDLER(hid_mirror_config_write, hid_mirror_config, true),
+	RELAY_HANDLER(thread_stats_read, thread_stats_read, false),
+	RELAY_HANDLER(trace_read, trace_read, false),
+	RELAY_HANDLER(mem_stats_read, mem_stats_read, false),
+	RELAY_HANDLER(fw_update_start, fw_update, true),
+	RELAY_HANDLER(fw_update_chunk, fw_update, true),
+	RELAY_HANDLER(fw_update_end, fw_update, true),
+	RELAY_HANDLER(nus_stream_control, nus_stream, true),
+	RELAY_HANDLER(nus_stream_write, nus_stream, true),
+	RELAY_HANDLER(sensor_stream_filter_write, sensor_stream_filter, true),
+	RELAY_HANDLER(sensor_codec_config_write, sensor_codec_config, true),
+	RELAY_HANDLER(sensor_stream_rate_write, sensor_stream_rate, true),
+	RELAY_HANDLER(relay_profile_write, relay_profile, false),
+	RELAY_HANDLER(usb_composition_write, usb_composition, false),
+	RELAY_HANDLER(link_history_read, link_history_read, false),
+};
+
+#undef RELAY_HANDLER
+
+static struct k_work relay_dispatch_work;
+
+static void relay_dispatch_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	relay_dispatch_run();
+}
+
+static void relay_dispatch_kick(void)
+{
+	k_work_submit_to_queue(&relay_workq_protocol, &relay_dispatch_work);
+}
+
+static uint32_t uptime_us(void)
+{
+	return relay_time_us32();
+}
+
+static void *current_thread(void)
+{
+	return k_current_get();
+}
+
+/* Answer a request with a request_id that was refused or failed */
+static void relay_dispatch_reject(uint32_t request_id, pb_size_t tag,
+				  mouthware_message_RequestErrorCode code)
+{
+	mouthware_message_RelayToAppMessage *message = usb_cdc_message_reserve();
+
+	if (!message) {
+		return;
+	}
+
+	message->request_id = request_id;
+	message->which_message_body = mouthware_message_RelayToAppMessage_request_error_tag;
+	message->message_body.request_error.code = code;
+	message->message_body.request_error.request_tag = tag;
+	usb_cdc_message_commit(message);
+}
+
+/* CDC0, relay HID and WebUSB RX deframers; only touched by cdc_rx_thread */
+static struct mouthpad_deframer cdc_rx_deframer;
+static struct mouthpad_deframer relay_hid_rx_deframer;
+static struct mouthpad_deframer webusb_rx_deframer;
+
+BUILD_ASSERT(MOUTHPAD_FRAME_MAX_PAYLOAD >= mouthware_message_AppToRelayMessage_size,
+	     "Deframer cannot hold the largest AppToRelayMessage");
+
+static void cdc_rx_frame(const uint8_t *payload, uint16_t len, void *user_data)
+{
+	LOG_DBG("Framed packet RX: %d bytes", len);
+
+	/* Replies and streams follow the interface the host last used */
+	if (user_data == &relay_hid_rx_deframer) {
+		usb_cdc_set_route(USB_CDC_ROUTE_RELAY_HID);
+	} else if (user_data == &webusb_rx_deframer) {
+		usb_cdc_set_route(USB_CDC_ROUTE_WEBUSB);
+	} else {
+		usb_cdc_set_route(USB_CDC_ROUTE_CDC0);
+	}
+	usb_cdc_set_cobs(((struct mouthpad_deframer *)user_data)->cobs);
+
+	relay_probe(RELAY_PROBE_FRAME_RX);
+	relay_sysview_mark_start(RELAY_MARKER_PB_DECODE);
+	enum relay_dispatch_result result = relay_dispatch_submit(payload, len);
+	relay_sysview_mark_stop(RELAY_MARKER_PB_DECODE);
+
+	switch (result) {
+	case RELAY_DISPATCH_DECODE_ERROR:
+		LOG_ERR("Protobuf decode failed (%d bytes)", len);
+		break;
+	case RELAY_DISPATCH_UNHANDLED:
+		LOG_WRN("No handler for relay message");
+		break;
+	case RELAY_DISPATCH_FULL:
+		LOG_WRN("Protocol queue full, relay message dropped");
+		trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_PROTOCOL);
+		break;
+	default:
+		break;
+	}
+}
+
+static void cdc_rx_frame_error(enum mouthpad_deframer_error err, uint16_t value, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (err == MOUTHPAD_DEFRAMER_ERR_LENGTH) {
+		LOG_ERR("Frame too large: %d bytes", value);
+	} else {
+		LOG_ERR("CRC mismatch: received=0x%04X", value);
+	}
+}
+
+/* CDC0 RX thread: sleeps until the UART IRQ signals data, then drains the
+ * RX ring buffer in bulk so a whole frame is parsed in one wakeup. Relay
+ * HID output reports and WebUSB bulk OUT data are read here too, so relay
+ * messages are still submitted from one thread.
+ */
+#define CDC_RX_THREAD_STACK_SIZE 2048
+#define CDC_RX_THREAD_PRIORITY   5
+
+static void cdc_rx_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	uint8_t chunk[128];
+
+	k_work_init(&relay_dispatch_work, relay_dispatch_work_handler);
+	relay_dispatch_init(&(struct relay_dispatch_config){
+		.table = relay_dispatch_table,
+		.pass_through = pass_through_to_mouthpad_forward,
+		.kick = relay_dispatch_kick,
+		.now_us = uptime_us,
+		.context = current_thread,
+		.reject = relay_dispatch_reject,
+	});
+	mouthpad_deframer_init(&cdc_rx_deframer, cdc_rx_frame, cdc_rx_frame_error,
+			       &cdc_rx_deframer);
+	mouthpad_deframer_init(&relay_hid_rx_deframer, cdc_rx_frame, cdc_rx_frame_error,
+			       &relay_hid_rx_deframer);
+	mouthpad_deframer_init(&webusb_rx_deframer, cdc_rx_frame, cdc_rx_frame_error,
+			       &webusb_rx_deframer);
+
+	for (;;) {
+		usb_cdc_wait_for_data(K_FOREVER);
+
+		const uint8_t *xfer;
+		size_t xfer_len;
+		int len;
+
+		while ((len = usb_cdc_receive_data(chunk, sizeof(chunk))) > 0) {
+			relay_sysview_mark_start(RELAY_MARKER_DEFRAME);
+			mouthpad_deframer_feed(&cdc_rx_deframer, chunk, len);
+			relay_sysview_mark_stop(RELAY_MARKER_DEFRAME);
+		}
+		while ((len = usb_relay_hid_receive(chunk, sizeof(chunk))) > 0) {
+			relay_sysview_mark_start(RELAY_MARKER_DEFRAME);
+			mouthpad_deframer_feed(&relay_hid_rx_deframer, chunk, len);
+			relay_sysview_mark_stop(RELAY_MARKER_DEFRAME);
+		}
+		/* Parsed in place in the USB stack's buffer */
+		while ((xfer_len = usb_relay_webusb_rx_peek(&xfer)) > 0) {
+			relay_sysview_mark_start(RELAY_MARKER_DEFRAME);
+			mouthpad_deframer_feed(&webusb_rx_deframer, xfer, xfer_len);
+			relay_sysview_mark_stop(RELAY_MARKER_DEFRAME);
+			usb_relay_webusb_rx_done();
+		}
+	}
+}
+
+K_THREAD_DEFINE(cdc_rx_tid, CDC_RX_THREAD_STACK_SIZE, cdc_rx_thread, NULL, NULL, NULL,
+		CDC_RX_THREAD_PRIORITY, 0, 0);
+
+static uint32_t uptime_ms(void)
+{
+	return k_uptime_get_32();
+}
+
+static void fault_delay_us(uint32_t us)
+{
+	k_busy_wait(us);
+}
+
+static const struct fault_inject_platform fault_platform = {
+	.now_ms = uptime_ms,
+	.delay_us = fault_delay_us,
+	.disconnect = ble_transport_disconnect,
+};
+
+/* Left alone by the start-up code, so it outlives soft and watchdog resets */
+static __noinit struct trace_ring trace_ring_retained;
+
+static enum trace_reset_cause read_reset_cause(void)
+{
+	uint32_t cause = 0;
+
+	if (hwinfo_get_reset_cause(&cause) != 0) {
+		return TRACE_RESET_UNKNOWN;
+	}
+	/* RESETREAS accumulates until cleared */
+	hwinfo_clear_reset_cause();
+
+	if (cause & RESET_WATCHDOG) {
+		return TRACE_RESET_WATCHDOG;
+	} else if (cause & RESET_CPU_LOCKUP) {
+		return TRACE_RESET_PANIC;
+	} else if (cause & RESET_SOFTWARE) {
+		return TRACE_RESET_SOFTWARE;
+	} else if (cause & RESET_PIN) {
+		return TRACE_RESET_PIN;
+	} else if (cause & RESET_BROWNOUT) {
+		return TRACE_RESET_BROWNOUT;
+	} else if (cause & RESET_LOW_POWER_WAKE) {
+		return TRACE_RESET_WAKE;
+	} else if (cause & RESET_POR) {
+		return TRACE_RESET_POWER_ON;
+	}
+	/* The nRF52 reports nothing after power-on, nor if the bootloader
+	 * cleared it; the ring's own check tells those apart
+	 */
+	return TRACE_RESET_UNKNOWN;
+}
+
+/* Protocol work queue: the LEDs and display follow the shared activity level */
+int main(void)
+{
+	int err;
+
+	LOG_INF("=== MouthPad^USB Starting === Built: %s %s", __DATE__, __TIME__);
+
+	bool trace_kept = trace_ring_init(&trace_ring_retained, uptime_ms, read_reset_cause());
+
+	if (trace_kept) {
+		LOG_INF("Trace kept from before the reset (%u boots); see \"trace\"",
+			trace_ring_boot_count());
+	}
+	relay_stall_watch_init(trace_kept);
+
+	/* Time boot and connection phases; before USB so enumeration is caught */
+	connection_timing_init(uptime_ms);
+	pairing_timing_init(relay_time_us32);
+	if (IS_ENABLED(CONFIG_RELAY_FAULT_INJECT)) {
+		fault_inject_init(&fault_platform);
+		LOG_WRN("Fault injection built in; see \"fault\"");
+	}
+
+	/* Initialize USB device stack (HID + CDC) */
+	LOG_INF("Initializing USB device stack...");
+	err = usb_init();
+	if (err != 0) {
+		LOG_ERR("usb_init failed (err %d)", err);
+		return 0;
+	}
+	LOG_INF("USB device stack initialized successfully");
+	connection_timing_boot_mark(CONNECTION_TIMING_BOOT_USB_STARTED);
+
+	/* Initialize USB CDC (get CDC0 device reference) */
+	LOG_INF("Initializing USB CDC...");
+	err = usb_cdc_init();
+	if (err != 0) {
+		LOG_ERR("usb_cdc_init failed (err %d)", err);
+		return 0;
+	}
+	LOG_INF("USB CDC initialized successfully");
+
+	/* Debug: Test HWINFO device ID reading */
+	uint8_t hwid[8];
+	ssize_t hwid_len = hwinfo_get_device_id(hwid, sizeof(hwid));
+	if (hwid_len > 0) {
+		LOG_INF("USB Serial Number: %02X%02X%02X%02X%02X%02X%02X%02X",
+			hwid[0], hwid[1], hwid[2], hwid[3],
+			hwid[4], hwid[5], hwid[6], hwid[7]);
+	} else {
+		LOG_ERR("HWINFO get_device_id failed: %d", hwid_len);
+	}
+
+	/* Bluetooth comes up next, while USB enumerates in the background: a
+	 * MouthPad that is already advertising can reconnect while the splash
+	 * screen plays. Settings (bonds) are loaded inside, ahead of the first
+	 * scan, since the bonded accept list depends on them.
+	 */
+	/* Initialize BLE Transport */
+	LOG_INF("Initializing BLE Transport...");
+	err = ble_transport_init();
+	if (err != 0) {
+		LOG_ERR("ble_transport_init failed (err %d)", err);
+		return 0;
+	}
+	LOG_INF("BLE Transport initialized successfully");
+
+	/* Register USB callbacks with BLE Transport */
+	ble_transport_register_usb_cdc_callback((usb_cdc_send_cb_t)mouthpad_nus_data_received_callback);
+	usb_hid_register_output_cb(usb_hid_data_callback);
+	ble_transport_register_nus_sent_callback(nus_write_sent);
+
+	/* Further bonded MouthPads, NUS only (CONFIG_BLE_MULTI_MOUTHPAD) */
+	err = ble_secondary_init();
+	if (err != 0) {
+		LOG_WRN("ble_secondary_init failed (err %d) - primary MouthPad only", err);
+	}
+	ble_secondary_register_sent_cb(secondary_write_sent);
+
+	err = relay_nus_stream_init();
+	if (err != 0 && err != -ENOTSUP) {
+		LOG_WRN("relay_nus_stream_init failed (err %d) - no NUS stream", err);
+	}
+
+	/* Settings are up once ble_transport_init() has loaded the bonds */
+	err = relay_link_history_init();
+	if (err != 0 && err != -ENOTSUP) {
+		LOG_WRN("relay_link_history_init failed (err %d) - no link history", err);
+	}
+
+	/* Start bridging */
+	ble_transport_start_bridging();
+
+	LOG_INF("Starting USB ↔ BLE bridge (NUS + HID)");
+
+	/* Confirms a freshly updated image, so only once the bridge is up */
+	err = relay_fw_update_init();
+	if (err != 0 && err != -ENOTSUP) {
+		LOG_WRN("relay_fw_update_init failed (err %d) - no firmware update", err);
+	}
+
+	/* Initialize OLED Display; -ENOTSUP without CONFIG_RELAY_OLED */
+	err = oled_display_init();
+	if (err == 0) {
+		/* Augmental logo for 2 seconds, drawn by the display thread */
+		oled_display_splash_screen(2000);
+	} else if (err != -ENOTSUP) {
+		LOG_WRN("oled_display_init failed (err %d) - continuing without display", err);
+		/* Continue without display - it's not critical for core functionality */
+	}
+
+	/* Initialize Passive Buzzer; -ENOTSUP without CONFIG_RELAY_BUZZER */
+	err = buzzer_init();
+	if (err != 0 && err != -ENOTSUP) {
+		LOG_WRN("buzzer_init failed (err %d) - continuing without buzzer", err);
+		/* Continue without buzzer - it's not critical for core functionality */
+	} else if (buzzer_is_available()) {
+		LOG_INF("Passive Buzzer initialized successfully");
+	}
+
+	/* Initialize LED subsystem; -ENOTSUP without CONFIG_RELAY_LEDS */
+	err = leds_init();
+	if (err != 0 && err != -ENOTSUP) {
+		LOG_WRN("leds_init failed (err %d) - continuing without LEDs", err);
+		/* Continue without LEDs - not critical for core functionality */
+	} else if (err == 0) {
+		LOG_INF("LED subsystem initialized successfully");
+		
+		/* Choose color mode based on LED hardware */
+		if (leds_has_neopixel()) {
+			/* NeoPixel supports smooth gradients */
+			leds_set_battery_color_mode(BAS_COLOR_MODE_GRADIENT);
+			LOG_INF("Using gradient mode for NeoPixel LEDs");
+		} else {
+			/* GPIO LEDs work better with discrete colors */
+			leds_set_battery_color_mode(BAS_COLOR_MODE_DISCRETE);
+			LOG_INF("Using discrete mode for GPIO LEDs");
+		}
+		
+		leds_set_state(LED_STATE_SCANNING);  /* Start in scanning state */
+	}
+	
+	/* Initialize User Button; -ENOTSUP without CONFIG_RELAY_BUTTON */
+	err = button_init();
+	if (err != 0 && err != -ENOTSUP) {
+		LOG_WRN("button_init failed (err %d) - continuing without button", err);
+		/* Continue without button - not critical for core functionality */
+	} else if (err == 0) {
+		LOG_INF("User button initialized successfully");
+		button_register_callback(button_event_callback);
+	}
+	
+	/* Reset display state so the first status update is queued behind the splash */
+	if (oled_display_is_available()) {
+		oled_display_reset_state();
+	}
+
+	LOG_INF("Entering main loop...");
+
+	/* Everything is stale on the first pass */
+	uint32_t events = RELAY_EVENTS_ALL;
+	bool bridge_parked = false;
+	bool lights_off = false;
+	bool display_dimmed = false;
+	mouthware_message_RelayBleConnectionStatus reported_status =
+		mouthware_message_RelayBleConnectionStatus_RELAY_CONNECTION_STATUS_DISCONNECTED;
+	int32_t reported_rssi = 0;
+	uint32_t reported_battery = 0xFF;
+
+	for (;;) {
+		/* CDC0 → relay/NUS traffic is handled by cdc_rx_thread. This thread
+		 * only refreshes status outputs, and sleeps until a relay event;
+		 * the activity tracker posts one when the level changes. LED
+		 * animations and the button run from their own timers.
+		 */
+		struct link_state link_now;
+
+		link_state_get(&link_now);
+
+		bool is_connected = link_state_is_up(&link_now);
+		enum relay_activity_level activity = relay_activity_level();
+
+		/* Host suspended the bus: slow the link down and blank every output
+		 * until it resumes. A MouthPad button press requests the wakeup
+		 * (see ble_hid.c).
+		 */
+		if (usb_hid_is_suspended() != bridge_parked) {
+			bridge_parked = !bridge_parked;
+			LOG_INF("Bridge %s", bridge_parked ? "parked for USB suspend" : "resumed");
+
+			ble_conn_params_usb_suspended(bridge_parked);
+			ble_transport_set_rssi_paused(bridge_parked);
+			if (!bridge_parked) {
+				ble_central_scan_boost();
+			}
+			events |= RELAY_EVENTS_ALL;
+		}
+
+		/* The battery profile keeps the LEDs and the OLED dark too */
+		if ((bridge_parked || !relay_tuning_lights()) != lights_off) {
+			lights_off = !lights_off;
+			if (oled_display_is_available()) {
+				oled_display_set_sleep(lights_off);
+			}
+			events |= RELAY_EVENTS_ALL;
+		}
+
+		/* Update LED state based on connection and activity level only */
+		if (leds_is_available()) {
+			if (lights_off) {
+				leds_set_state(LED_STATE_OFF);
+			} else if (is_connected && activity == RELAY_ACTIVITY_ACTIVE) {
+				leds_set_state(LED_STATE_DATA_ACTIVITY);
+			} else if (is_connected) {
+				leds_set_state(LED_STATE_CONNECTED);
+			} else {
+				leds_set_state(LED_STATE_SCANNING);
+			}
+
+			/* Follow the battery level in the connected colors */
+			if (events & RELAY_EVENT_STATUS) {
+				leds_update();
+			}
+		}
+
+		/* Dim the panel once nobody has touched the MouthPad for a while */
+		if (oled_display_is_available() &&
+		    (activity == RELAY_ACTIVITY_DEEP_IDLE) != display_dimmed) {
+			display_dimmed = !display_dimmed;
+			oled_display_set_dimmed(display_dimmed);
+		}
+
+		/* Push connection state, battery and RSSI changes to the host instead of
+		 * waiting for its next BleConnectionStatusRead. RSSI only arrives once it
+		 * has moved past CONFIG_BLE_RSSI_REPORT_HYSTERESIS. Held back while parked;
+		 * resuming re-runs this.
+		 */
+		if (!bridge_parked && (events & (RELAY_EVENT_LINK | RELAY_EVENT_STATUS))) {
+			mouthware_message_RelayToAppMessage *status = usb_cdc_message_reserve();
+
+			if (status) {
+				const mouthware_message_BleConnectionStatusResponse *now =
+					&status->message_body.ble_connection_status_response;
+
+				ble_connection_status_fill(status);
+				if (now->connection_status != reported_status ||
+				    now->rssi != reported_rssi ||
+				    now->battery_level != reported_battery) {
+					reported_status = now->connection_status;
+					reported_rssi = now->rssi;
+					reported_battery = now->battery_level;
+					usb_cdc_message_commit(status);
+				} else {
+					usb_cdc_message_abort(status);
+				}
+			}
+		}
+
+		/* Redraw the status screen only when something it shows may have changed */
+		if (oled_display_is_available() && !lights_off &&
+		    (events & (RELAY_EVENT_LINK | RELAY_EVENT_STATUS))) {
+			oled_display_update_status(link_now.battery_level, is_connected,
+						   is_connected ? link_now.rssi : 0);
+		}
+
+		events = k_event_wait(&relay_events, RELAY_EVENTS_ALL, false, K_FOREVER);
+		k_event_clear(&relay_events, events);
 	}
 }
@@ -1,9 +0,0 @@
-#include <stdio.h>
-
-#define TEST(x) \
-    if (!(x)) { \
-        fprintf(stderr, "\033[31;1mFAILED:\033[22;39m %s:%d %s\n", __FILE__, __LINE__, #x); \
-        status = 1; \
-    } else { \
-        printf("\033[32;1mOK:\033[22;39m %s\n", #x); \
-    }
@@ -1,3 +0,0 @@
-#include "pb.h"
-#include "pb_common.h"
-#include "pb_decode.h"
@@ -1,3 +0,0 @@
-#import "pb.h"
-#import <pb_common.h>
-#include "pb_decode.h"
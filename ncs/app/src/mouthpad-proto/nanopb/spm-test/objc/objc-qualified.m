@@ -1,3 +0,0 @@
-#import "nanopb/pb.h"
-#import <nanopb/pb_common.h>
-#include "nanopb/pb_decode.h"
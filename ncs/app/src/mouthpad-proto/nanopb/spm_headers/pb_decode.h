@@ -1 +0,0 @@
-#include "nanopb/pb_decode.h"
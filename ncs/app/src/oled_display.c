@@ -11,6 +11,8 @@
 #include <zephyr/drivers/display.h>
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/util.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -52,18 +54,96 @@ static bool display_available = false;
 static uint8_t font_width;
 static uint8_t font_height;
 
-/* Status tracking */
+/* Last status requested by the caller, so unchanged updates are not queued */
 static uint8_t last_battery_level = 0xFF;
 static bool last_connection_state = false;
 static int8_t last_rssi_dbm = 0;
 
+/* Rendering runs on its own low-priority thread. The public oled_display_*
+ * calls only store the screen they want in a single-slot mailbox and wake
+ * the thread; a newer request replaces one that has not been drawn yet, so
+ * a burst of updates costs one redraw of the latest state. The I2C transfers
+ * themselves already go through TWIM EasyDMA; the thread just keeps the
+ * caller (BT RX, CDC, main loop) from blocking on them.
+ */
+enum display_screen {
+    SCREEN_CLEAR,
+    SCREEN_STATUS,
+    SCREEN_MESSAGE,
+    SCREEN_DEVICE_INFO,
+    SCREEN_SCANNING,
+    SCREEN_DEVICE_FOUND,
+    SCREEN_PAIRING,
+    SCREEN_SLEEP
+};
+
+struct display_request {
+    enum display_screen screen;
+    uint8_t battery_level;
+    bool is_connected;
+    int8_t rssi_dbm;
+    uint32_t connection_count;
+    char text[32];
+};
+
+static struct display_request pending_request;
+static bool request_pending;
+static uint32_t splash_duration_ms;
+static bool splash_pending;  /* Kept apart so a later request cannot replace it */
+static bool display_sleeping;  /* Requests other than a wake are dropped */
+static uint8_t contrast_level = 255;
+static bool contrast_pending;
+
+#define CONTRAST_FULL   255
+#define CONTRAST_DIMMED 16
+static bool panel_blanked;     /* Render thread only */
+static struct k_spinlock request_lock;
+static K_SEM_DEFINE(request_sem, 0, 1);
+
+/* Status screen, drawn per widget into a page-layout copy of the SSD1306
+ * GDDRAM. Each widget is one 16-pixel text line (two pages); after drawing
+ * it, only the column span that differs from what the panel already shows
+ * is written over I2C. Any full-screen CFB draw makes the panel contents
+ * unknown again, and the next status update rewrites every widget.
+ */
+#define PANEL_PAGES_MAX   8
+#define PANEL_WIDTH_MAX   128
+#define WIDGET_PAGES      2
+
+enum status_widget {
+    WIDGET_TITLE,
+    WIDGET_STATUS,
+    WIDGET_BATTERY,
+    WIDGET_SIGNAL,
+    WIDGET_COUNT
+};
+
+static uint8_t status_fb[PANEL_PAGES_MAX][PANEL_WIDTH_MAX];
+static uint8_t panel_fb[PANEL_PAGES_MAX][PANEL_WIDTH_MAX];  /* What the panel shows */
+static bool panel_known;
+static uint16_t panel_width;
+static uint8_t panel_pages;
+static const struct cfb_font *status_font;  /* NULL: full CFB redraws only */
+
 /* Private function declarations */
 static int oled_display_setup_font(void);
 static int oled_display_invert(void);
 static int oled_display_set_contrast(uint8_t contrast);
-static void oled_display_invert_bitmap(const uint8_t *src, uint8_t *dst, size_t size);
-static int oled_display_invert_framebuffer(void);
 static const char* rssi_to_signal_bars(int8_t rssi_dbm);
+static int oled_display_finalize(void);
+static void status_font_setup(void);
+static int status_widget_draw(enum status_widget widget, const char *text);
+static int splash_screen_show(uint32_t duration_ms);
+static int render_clear(void);
+static int render_status(const char *title, uint8_t battery_level, bool is_connected,
+                         int8_t rssi_dbm);
+static int render_message(const char *message);
+static int render_device_info(const char *device_name, uint32_t connection_count);
+static int render_scanning(void);
+static int render_device_found(const char *device_name);
+static int render_pairing(void);
+static int render_sleep(void);
+static void display_post(const struct display_request *req);
 
 int oled_display_init(void)
 {
@@ -114,7 +194,10 @@ int oled_display_init(void)
         LOG_INF("Display inverted: white text on black background");
     }
 
+    status_font_setup();
+
     /* Clear display completely */
+    panel_known = false;
     ret = cfb_framebuffer_clear(display_dev, true);
     if (ret != 0) {
         LOG_ERR("Failed to clear framebuffer (err %d)", ret);
@@ -130,118 +213,109 @@ int oled_display_init(void)
     return 0;
 }
 
-int oled_display_clear(void)
+static int render_clear(void)
 {
     if (!display_available || !display_ready) {
         return 0;  /* Silently skip if no display */
     }
 
+    panel_known = false;
     int ret = cfb_framebuffer_clear(display_dev, true);
     if (ret != 0) {
         LOG_ERR("Failed to clear display (err %d)", ret);
         return ret;
     }
 
-    return cfb_framebuffer_finalize(display_dev);
+    return oled_display_finalize();
 }
 
-int oled_display_update_status(uint8_t battery_level, bool is_connected, int8_t rssi_dbm)
+static int render_status(const char *title, uint8_t battery_level, bool is_connected,
+                         int8_t rssi_dbm)
 {
-    char battery_str[32];
-    char status_str[40];
+    char lines[WIDGET_COUNT][32];
     int ret;
 
-    if (!display_available || !display_ready) {
-        return 0;  /* Silently skip if no display */
-    }
-
-    /* Only update if something changed */
-    if (battery_level == last_battery_level && 
-        is_connected == last_connection_state &&
-        rssi_dbm == last_rssi_dbm) {
-        return 0;
-    }
-
-    /* Clear display */
-    ret = cfb_framebuffer_clear(display_dev, false);
-    if (ret != 0) {
-        LOG_ERR("Failed to clear framebuffer (err %d)", ret);
-        return ret;
-    }
-
-    /* Ensure display stays inverted during status transitions */
-    ret = oled_display_invert();
-    if (ret != 0) {
-        LOG_WRN("Failed to reapply inversion during status update (err %d)", ret);
-        /* Continue anyway - display will still work */
-    }
-
-    /* Use much larger line spacing for clear separation */
-    uint16_t line_spacing = 16;  /* 3 lines fit: 0, 16, 32 */
-    uint16_t y_pos = 0;
-
-    /* Line 1: Device name - use connected device name when connected, otherwise default */
-    extern const char *ble_transport_get_device_name(void);
-    const char *full_title = is_connected ? ble_transport_get_device_name() : "MouthPad^USB";
-    
-    /* Truncate title to 12 characters for display */
-    char display_title[13];  /* 12 chars + null terminator */
-    strncpy(display_title, full_title, 12);
-    display_title[12] = '\0';
-    
-    cfb_print(display_dev, display_title, 0, y_pos);
-    y_pos += line_spacing;
+    /* Line 1: Device name, truncated to 12 characters for display */
+    snprintf(lines[WIDGET_TITLE], sizeof(lines[WIDGET_TITLE]), "%.12s", title);
 
     /* Line 2: Connection status */
-    if (is_connected) {
-        strcpy(status_str, "Connected");
-    } else {
-        strcpy(status_str, "Scanning...");
-    }
-    cfb_print(display_dev, status_str, 0, y_pos);
-    y_pos += line_spacing;
+    strcpy(lines[WIDGET_STATUS], is_connected ? "Connected" : "Scanning...");
 
     /* Line 3: Battery status with icon */
     if (battery_level == 0xFF || battery_level > 100) {
-        strcpy(battery_str, "");  /* Just "" for unknown */
+        lines[WIDGET_BATTERY][0] = '\0';  /* Just "" for unknown */
     } else {
         /* Create battery icon based on charge level */
-        char battery_icon[8];
+        const char *battery_icon;
         if (battery_level > 75) {
-            strcpy(battery_icon, "[||||]");  /* Full battery */
+            battery_icon = "[||||]";  /* Full battery */
         } else if (battery_level > 50) {
-            strcpy(battery_icon, "[|||.]");  /* 3/4 battery */
+            battery_icon = "[|||.]";  /* 3/4 battery */
         } else if (battery_level > 25) {
-            strcpy(battery_icon, "[||..]");  /* 1/2 battery */
+            battery_icon = "[||..]";  /* 1/2 battery */
         } else if (battery_level > 10) {
-            strcpy(battery_icon, "[|...]");  /* 1/4 battery */
+            battery_icon = "[|...]";  /* 1/4 battery */
         } else {
-            strcpy(battery_icon, "[....]");  /* Low battery */
+            battery_icon = "[....]";  /* Low battery */
         }
-        snprintf(battery_str, sizeof(battery_str), "%s %d%%", battery_icon, battery_level);
+        snprintf(lines[WIDGET_BATTERY], sizeof(lines[WIDGET_BATTERY]), "%s %d%%",
+                 battery_icon, battery_level);
     }
-    cfb_print(display_dev, battery_str, 0, y_pos);
-    y_pos += line_spacing;
 
     /* Line 4: Signal strength (only when connected) */
     if (is_connected) {
-        const char* signal_bars = rssi_to_signal_bars(rssi_dbm);
-        char signal_str[32];
-        snprintf(signal_str, sizeof(signal_str), "%s%ddBm", signal_bars, rssi_dbm);
-        cfb_print(display_dev, signal_str, 0, y_pos);
+        snprintf(lines[WIDGET_SIGNAL], sizeof(lines[WIDGET_SIGNAL]), "%s%ddBm",
+                 rssi_to_signal_bars(rssi_dbm), rssi_dbm);
+    } else {
+        lines[WIDGET_SIGNAL][0] = '\0';
     }
 
-    /* Update display - hardware inversion is already set */
-    ret = cfb_framebuffer_finalize(display_dev);
-    if (ret != 0) {
-        LOG_ERR("Failed to finalize framebuffer (err %d)", ret);
-        return ret;
-    }
+    if (status_font) {
+        /* Coming back from another screen: make sure it is still inverted */
+        if (!panel_known) {
+            ret = oled_display_invert();
+            if (ret != 0) {
+                LOG_WRN("Failed to reapply inversion during status update (err %d)", ret);
+            }
+        }
 
-    /* Update last known state */
-    last_battery_level = battery_level;
-    last_connection_state = is_connected;
-    last_rssi_dbm = rssi_dbm;
+        for (int w = 0; w < WIDGET_COUNT; w++) {
+            ret = status_widget_draw(w, lines[w]);
+            if (ret != 0) {
+                LOG_ERR("Failed to write status widget %d (err %d)", w, ret);
+                return ret;
+            }
+        }
+
+        /* Every widget has now been written at least once */
+        panel_known = true;
+    } else {
+        /* Clear display */
+        ret = cfb_framebuffer_clear(display_dev, false);
+        if (ret != 0) {
+            LOG_ERR("Failed to clear framebuffer (err %d)", ret);
+            return ret;
+        }
+
+        /* Ensure display stays inverted during status transitions */
+        ret = oled_display_invert();
+        if (ret != 0) {
+            LOG_WRN("Failed to reapply inversion during status update (err %d)", ret);
+            /* Continue anyway - display will still work */
+        }
+
+        /* Use much larger line spacing for clear separation */
+        for (int w = 0; w < WIDGET_COUNT; w++) {
+            cfb_print(display_dev, lines[w], 0, w * WIDGET_PAGES * 8);
+        }
+
+        /* Update display - hardware inversion is already set */
+        ret = oled_display_finalize();
+        if (ret != 0) {
+            LOG_ERR("Failed to finalize framebuffer (err %d)", ret);
+            return ret;
+        }
+    }
 
     LOG_DBG("Display updated: battery=%d%%, connected=%s, rssi=%ddBm", 
             battery_level, is_connected ? "yes" : "no", rssi_dbm);
@@ -249,14 +323,10 @@ int oled_display_update_status(uint8_t battery_level, bool is_connected, int8_t
     return 0;
 }
 
-int oled_display_message(const char *message)
+static int render_message(const char *message)
 {
     int ret;
 
-    if (!display_available || !display_ready || !message) {
-        return 0;  /* Silently skip if no display or invalid message */
-    }
-
     /* Clear display */
     ret = cfb_framebuffer_clear(display_dev, false);
     if (ret != 0) {
@@ -268,7 +338,7 @@ int oled_display_message(const char *message)
     cfb_print(display_dev, message, 0, 0);
 
     /* Update display */
-    ret = cfb_framebuffer_finalize(display_dev);
+    ret = oled_display_finalize();
     if (ret != 0) {
         LOG_ERR("Failed to finalize framebuffer (err %d)", ret);
         return ret;
@@ -277,15 +347,11 @@ int oled_display_message(const char *message)
     return 0;
 }
 
-int oled_display_device_info(const char *device_name, uint32_t connection_count)
+static int render_device_info(const char *device_name, uint32_t connection_count)
 {
     char count_str[32];
     int ret;
 
-    if (!display_available || !display_ready || !device_name) {
-        return 0;  /* Silently skip if no display or invalid device name */
-    }
-
     /* Clear display */
     ret = cfb_framebuffer_clear(display_dev, false);
     if (ret != 0) {
@@ -317,7 +383,7 @@ int oled_display_device_info(const char *device_name, uint32_t connection_count)
     cfb_print(display_dev, uptime_str, 0, font_height * 3);
 
     /* Update display */
-    ret = cfb_framebuffer_finalize(display_dev);
+    ret = oled_display_finalize();
     if (ret != 0) {
         LOG_ERR("Failed to finalize framebuffer (err %d)", ret);
         return ret;
@@ -326,7 +392,389 @@ int oled_display_device_info(const char *device_name, uint32_t connection_count)
     return 0;
 }
 
+int oled_display_clear(void)
+{
+    struct display_request req = { .screen = SCREEN_CLEAR };
+
+    display_post(&req);
+    return 0;
+}
+
+int oled_display_update_status(uint8_t battery_level, bool is_connected, int8_t rssi_dbm)
+{
+    struct display_request req = {
+        .screen = SCREEN_STATUS,
+        .battery_level = battery_level,
+        .is_connected = is_connected,
+        .rssi_dbm = rssi_dbm
+    };
+
+    if (!display_available || !display_ready) {
+        return 0;  /* Silently skip if no display */
+    }
+
+    /* Only update if something changed */
+    if (battery_level == last_battery_level && 
+        is_connected == last_connection_state &&
+        rssi_dbm == last_rssi_dbm) {
+        return 0;
+    }
+
+    /* Title: connected device name when connected, otherwise default. Copied
+     * now so the render thread never reads the transport's buffer.
+     */
+    extern const char *ble_transport_get_device_name(void);
+    const char *full_title = is_connected ? ble_transport_get_device_name() : "MouthPad^USB";
+
+    strncpy(req.text, full_title, sizeof(req.text) - 1);
+
+    /* Update last requested state */
+    last_battery_level = battery_level;
+    last_connection_state = is_connected;
+    last_rssi_dbm = rssi_dbm;
+
+    display_post(&req);
+    return 0;
+}
+
+int oled_display_message(const char *message)
+{
+    struct display_request req = { .screen = SCREEN_MESSAGE };
+
+    if (!message) {
+        return 0;  /* Silently skip invalid message */
+    }
+
+    strncpy(req.text, message, sizeof(req.text) - 1);
+    display_post(&req);
+    return 0;
+}
+
+int oled_display_device_info(const char *device_name, uint32_t connection_count)
+{
+    struct display_request req = {
+        .screen = SCREEN_DEVICE_INFO,
+        .connection_count = connection_count
+    };
+
+    if (!device_name) {
+        return 0;  /* Silently skip invalid device name */
+    }
+
+    strncpy(req.text, device_name, sizeof(req.text) - 1);
+    display_post(&req);
+    return 0;
+}
+
+int oled_display_scanning(void)
+{
+    struct display_request req = { .screen = SCREEN_SCANNING };
+
+    display_post(&req);
+    return 0;
+}
+
+int oled_display_device_found(const char *device_name)
+{
+    struct display_request req = { .screen = SCREEN_DEVICE_FOUND };
+
+    if (device_name) {
+        strncpy(req.text, device_name, sizeof(req.text) - 1);
+    }
+    display_post(&req);
+    return 0;
+}
+
+int oled_display_pairing(void)
+{
+    struct display_request req = { .screen = SCREEN_PAIRING };
+
+    display_post(&req);
+    return 0;
+}
+
+int oled_display_set_dimmed(bool dimmed)
+{
+    if (!display_available || !display_ready) {
+        return 0;  /* Silently skip if no display */
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&request_lock);
+    contrast_level = dimmed ? CONTRAST_DIMMED : CONTRAST_FULL;
+    contrast_pending = true;
+    k_spin_unlock(&request_lock, key);
+
+    k_sem_give(&request_sem);
+    return 0;
+}
+
+int oled_display_set_sleep(bool sleep)
+{
+    struct display_request req = { .screen = SCREEN_SLEEP };
+
+    if (!display_available || !display_ready) {
+        return 0;  /* Silently skip if no display */
+    }
+
+    if (!sleep) {
+        k_spinlock_key_t key = k_spin_lock(&request_lock);
+        display_sleeping = false;
+        k_spin_unlock(&request_lock, key);
+
+        /* The next request turns the panel back on; make sure status is one */
+        oled_display_reset_state();
+        return 0;
+    }
+
+    /* Posted and locked in one step so nothing can replace the sleep */
+    k_spinlock_key_t key = k_spin_lock(&request_lock);
+    pending_request = req;
+    request_pending = true;
+    display_sleeping = true;
+    k_spin_unlock(&request_lock, key);
+
+    k_sem_give(&request_sem);
+    return 0;
+}
+
 /* Private function implementations */
+
+/* Replace whatever is waiting to be drawn; safe from any thread or ISR */
+static void display_post(const struct display_request *req)
+{
+    if (!display_available || !display_ready) {
+        return;  /* Silently skip if no display */
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&request_lock);
+    if (display_sleeping) {
+        k_spin_unlock(&request_lock, key);
+        return;
+    }
+    pending_request = *req;
+    request_pending = true;
+    k_spin_unlock(&request_lock, key);
+
+    k_sem_give(&request_sem);
+}
+
+static int render_request(const struct display_request *req)
+{
+    if (req->screen != SCREEN_SLEEP && panel_blanked) {
+        int ret = display_blanking_off(display_dev);
+
+        if (ret != 0) {
+            return ret;
+        }
+        panel_blanked = false;
+    }
+
+    switch (req->screen) {
+    case SCREEN_CLEAR:
+        return render_clear();
+    case SCREEN_STATUS:
+        return render_status(req->text, req->battery_level, req->is_connected,
+                             req->rssi_dbm);
+    case SCREEN_MESSAGE:
+        return render_message(req->text);
+    case SCREEN_DEVICE_INFO:
+        return render_device_info(req->text, req->connection_count);
+    case SCREEN_SCANNING:
+        return render_scanning();
+    case SCREEN_DEVICE_FOUND:
+        return render_device_found(req->text);
+    case SCREEN_PAIRING:
+        return render_pairing();
+    case SCREEN_SLEEP:
+        return render_sleep();
+    }
+
+    return -EINVAL;
+}
+
+static void display_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1) {
+        struct display_request req;
+        bool have_request;
+        bool splash;
+        bool contrast;
+        uint8_t contrast_value;
+        uint32_t duration_ms;
+        int ret;
+
+        k_sem_take(&request_sem, K_FOREVER);
+
+        k_spinlock_key_t key = k_spin_lock(&request_lock);
+        splash = splash_pending;
+        duration_ms = splash_duration_ms;
+        splash_pending = false;
+        k_spin_unlock(&request_lock, key);
+
+        if (splash) {
+            ret = splash_screen_show(duration_ms);
+            if (ret != 0) {
+                LOG_WRN("Splash screen failed (err %d)", ret);
+            }
+        }
+
+        /* The splash leaves the panel at full contrast */
+        key = k_spin_lock(&request_lock);
+        contrast = contrast_pending;
+        contrast_value = contrast_level;
+        contrast_pending = false;
+        k_spin_unlock(&request_lock, key);
+
+        if (contrast || (splash && contrast_value != CONTRAST_FULL)) {
+            oled_display_set_contrast(contrast_value);
+        }
+
+        key = k_spin_lock(&request_lock);
+        req = pending_request;
+        have_request = request_pending;
+        request_pending = false;
+        k_spin_unlock(&request_lock, key);
+
+        if (!have_request) {
+            continue;
+        }
+
+        ret = render_request(&req);
+        if (ret != 0) {
+            LOG_WRN("Render of screen %d failed (err %d)", req.screen, ret);
+        }
+    }
+}
+
+K_THREAD_DEFINE(oled_display_tid, CONFIG_OLED_DISPLAY_THREAD_STACK_SIZE, display_thread,
+                NULL, NULL, NULL, CONFIG_OLED_DISPLAY_THREAD_PRIORITY, 0, 0);
+
+/* Push the whole CFB framebuffer; the status screen shadow no longer matches */
+static int oled_display_finalize(void)
+{
+    panel_known = false;
+    return cfb_framebuffer_finalize(display_dev);
+}
+
+/* Use CFB's font 0 for the status widgets, drawing its glyphs ourselves */
+static void status_font_setup(void)
+{
+    const struct cfb_font *font;
+    uint16_t width = cfb_get_display_parameter(display_dev, CFB_DISPLAY_WIDTH);
+    uint16_t height = cfb_get_display_parameter(display_dev, CFB_DISPLAY_HEIGHT);
+
+    STRUCT_SECTION_GET(cfb_font, 0, &font);
+
+    if (!(font->caps & CFB_FONT_MONO_VPACKED) || font->height % 8 != 0 ||
+        font->height > WIDGET_PAGES * 8 || width > PANEL_WIDTH_MAX ||
+        height > PANEL_PAGES_MAX * 8) {
+        LOG_WRN("Font or panel layout unsupported - status screen uses full redraws");
+        status_font = NULL;
+        return;
+    }
+
+    status_font = font;
+    panel_width = width;
+    panel_pages = height / 8;
+}
+
+static uint8_t reverse_bits(uint8_t b)
+{
+    b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+    b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+    b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+    return b;
+}
+
+/* Draw one widget's text into status_fb and write the columns that changed */
+static int status_widget_draw(enum status_widget widget, const char *text)
+{
+    const struct cfb_font *font = status_font;
+    uint8_t page = widget * WIDGET_PAGES;
+    uint8_t font_pages = font->height / 8;
+    uint16_t x;
+    int x0 = -1;
+    int x1 = -1;
+
+    if (page + WIDGET_PAGES > panel_pages) {
+        return 0;  /* Panel too short for this line */
+    }
+
+    for (uint8_t p = 0; p < WIDGET_PAGES; p++) {
+        memset(status_fb[page + p], 0, panel_width);
+    }
+
+    for (x = 0; *text && x + font->width <= panel_width; text++, x += font->width) {
+        uint8_t c = (uint8_t)*text;
+
+        if (c < font->first_char || c > font->last_char) {
+            continue;  /* Left blank, like cfb_print */
+        }
+
+        const uint8_t *glyph = (const uint8_t *)font->data +
+                               (c - font->first_char) * font->width * font_pages;
+
+        for (uint8_t col = 0; col < font->width; col++) {
+            for (uint8_t p = 0; p < font_pages; p++) {
+                uint8_t byte = glyph[col * font_pages + p];
+
+                if (font->caps & CFB_FONT_MSB_FIRST) {
+                    byte = reverse_bits(byte);
+                }
+                status_fb[page + p][x + col] = byte;
+            }
+        }
+    }
+
+    /* Smallest column span covering every changed byte in the widget */
+    for (x = 0; x < panel_width; x++) {
+        for (uint8_t p = 0; p < WIDGET_PAGES; p++) {
+            if (!panel_known || status_fb[page + p][x] != panel_fb[page + p][x]) {
+                if (x0 < 0) {
+                    x0 = x;
+                }
+                x1 = x;
+                break;
+            }
+        }
+    }
+
+    if (x0 < 0) {
+        return 0;  /* Widget unchanged */
+    }
+
+    static uint8_t tx_buf[WIDGET_PAGES * PANEL_WIDTH_MAX];
+    uint16_t span = x1 - x0 + 1;
+
+    for (uint8_t p = 0; p < WIDGET_PAGES; p++) {
+        memcpy(&tx_buf[p * span], &status_fb[page + p][x0], span);
+    }
+
+    struct display_buffer_descriptor desc = {
+        .buf_size = span * WIDGET_PAGES,
+        .width = span,
+        .height = WIDGET_PAGES * 8,
+        .pitch = span,
+        .frame_incomplete = false
+    };
+
+    int ret = display_write(display_dev, x0, page * 8, &desc, tx_buf);
+    if (ret != 0) {
+        panel_known = false;
+        return ret;
+    }
+
+    for (uint8_t p = 0; p < WIDGET_PAGES; p++) {
+        memcpy(&panel_fb[page + p][x0], &status_fb[page + p][x0], span);
+    }
+
+    return 0;
+}
+
 static int oled_display_setup_font(void)
 {
     int ret;
@@ -464,23 +912,29 @@ static int oled_display_set_contrast(uint8_t contrast)
     return 0;
 }
 
-/* Invert bitmap data (flip all bits) */
-static void oled_display_invert_bitmap(const uint8_t *src, uint8_t *dst, size_t size)
-{
-    for (size_t i = 0; i < size; i++) {
-        dst[i] = ~src[i];  /* Invert all bits */
-    }
-}
-
 /* Display splash screen with Augmental logo */
 int oled_display_splash_screen(uint32_t duration_ms)
 {
-    int ret;
-
     if (!display_available || !display_ready) {
         return 0;  /* Silently skip if no display */
     }
 
+    k_spinlock_key_t key = k_spin_lock(&request_lock);
+    splash_duration_ms = duration_ms;
+    splash_pending = true;
+    k_spin_unlock(&request_lock, key);
+
+    k_sem_give(&request_sem);
+    return 0;
+}
+
+/* Logo, fade out and the first status frame, on the render thread. Requests
+ * posted meanwhile wait in the mailbox and the latest is drawn right after.
+ */
+static int splash_screen_show(uint32_t duration_ms)
+{
+    int ret;
+
     LOG_INF("Displaying Augmental logo splash screen...");
 
     /* Clear display first using CFB */
@@ -491,7 +945,7 @@ int oled_display_splash_screen(uint32_t duration_ms)
     }
     
     /* Finalize CFB to ensure display is cleared */
-    ret = cfb_framebuffer_finalize(display_dev);
+    ret = oled_display_finalize();
     if (ret != 0) {
         LOG_ERR("Failed to finalize clear framebuffer (err %d)", ret);
         return ret;
@@ -504,11 +958,6 @@ int oled_display_splash_screen(uint32_t duration_ms)
         /* Continue anyway */
     }
 
-    /* Invert the bitmap data for proper display with hardware inversion */
-    static uint8_t inverted_logo[128 * 64 / 8];  /* Buffer for inverted logo */
-    oled_display_invert_bitmap(augmental_logo_bitmap, inverted_logo, 
-                               AUGMENTAL_LOGO_WIDTH * AUGMENTAL_LOGO_HEIGHT / 8);
-    
     /* Prepare buffer descriptor */
     struct display_buffer_descriptor desc = {
         .buf_size = AUGMENTAL_LOGO_WIDTH * AUGMENTAL_LOGO_HEIGHT / 8,
@@ -518,8 +967,8 @@ int oled_display_splash_screen(uint32_t duration_ms)
         .frame_incomplete = false
     };
 
-    /* Write the inverted bitmap to the display */
-    ret = display_write(display_dev, 0, 0, &desc, inverted_logo);
+    /* Write the logo, stored pre-inverted for hardware inversion */
+    ret = display_write(display_dev, 0, 0, &desc, augmental_logo_bitmap);
     if (ret != 0) {
         LOG_ERR("Failed to write logo bitmap (err %d)", ret);
         /* Fall back to text display on error */
@@ -529,7 +978,7 @@ int oled_display_splash_screen(uint32_t duration_ms)
         cfb_print(display_dev, "AUGMENTAL", center_x, center_y);
         cfb_print(display_dev, "TECH", center_x + 20, center_y + font_height + 4);
         
-        ret = cfb_framebuffer_finalize(display_dev);
+        ret = oled_display_finalize();
         if (ret != 0) {
             LOG_ERR("Failed to finalize text fallback (err %d)", ret);
             return ret;
@@ -577,7 +1026,7 @@ int oled_display_splash_screen(uint32_t duration_ms)
     cfb_print(display_dev, "Scanning...", 0, y_pos);
     
     /* Finalize the content while display is still OFF */
-    ret = cfb_framebuffer_finalize(display_dev);
+    ret = oled_display_finalize();
     if (ret != 0) {
         LOG_ERR("Failed to finalize status display (err %d)", ret);
         return ret;
@@ -601,15 +1050,30 @@ int oled_display_splash_screen(uint32_t duration_ms)
         LOG_WRN("Failed to reapply inversion after splash screen (err %d)", ret);
         /* Continue anyway */
     }
-    
-    /* Reset the display state so the next update will work properly */
-    oled_display_reset_state();
 
     LOG_INF("Splash screen complete - transitioned to status display");
 
     return 0;
 }
 
+/* Panel off (SSD1306 display-off command); GDDRAM keeps its contents */
+static int render_sleep(void)
+{
+    int ret;
+
+    if (panel_blanked) {
+        return 0;
+    }
+
+    ret = display_blanking_on(display_dev);
+    if (ret != 0) {
+        return ret;
+    }
+
+    panel_blanked = true;
+    return 0;
+}
+
 /* Reset display state to force next status update */
 void oled_display_reset_state(void)
 {
@@ -619,14 +1083,10 @@ void oled_display_reset_state(void)
     last_rssi_dbm = -100;  /* Different from any typical value */
 }
 
-int oled_display_scanning(void)
+static int render_scanning(void)
 {
     int ret;
-    
-    if (!display_available || !display_ready) {
-        return 0;  /* Silently skip if no display */
-    }
-    
+
     /* Clear display */
     ret = cfb_framebuffer_clear(display_dev, false);
     if (ret != 0) {
@@ -651,7 +1111,7 @@ int oled_display_scanning(void)
     cfb_print(display_dev, "Scanning...", 0, y_pos);
     
     /* Update display */
-    ret = cfb_framebuffer_finalize(display_dev);
+    ret = oled_display_finalize();
     if (ret != 0) {
         LOG_ERR("Failed to finalize framebuffer (err %d)", ret);
         return ret;
@@ -668,14 +1128,10 @@ int oled_display_scanning(void)
     return 0;
 }
 
-int oled_display_device_found(const char *device_name)
+static int render_device_found(const char *device_name)
 {
     int ret;
-    
-    if (!display_available || !display_ready) {
-        return 0;  /* Silently skip if no display */
-    }
-    
+
     /* Clear display */
     ret = cfb_framebuffer_clear(display_dev, false);
     if (ret != 0) {
@@ -700,7 +1156,7 @@ int oled_display_device_found(const char *device_name)
     cfb_print(display_dev, "Pairing...", 0, y_pos);
     
     /* Update display */
-    ret = cfb_framebuffer_finalize(display_dev);
+    ret = oled_display_finalize();
     if (ret != 0) {
         LOG_ERR("Failed to finalize framebuffer (err %d)", ret);
         return ret;
@@ -713,18 +1169,14 @@ int oled_display_device_found(const char *device_name)
         /* Continue anyway */
     }
     
-    LOG_DBG("Device found status displayed: %s", device_name ? device_name : "Unknown");
+    LOG_DBG("Device found status displayed: %s", device_name[0] ? device_name : "Unknown");
     return 0;
 }
 
-int oled_display_pairing(void)
+static int render_pairing(void)
 {
     int ret;
-    
-    if (!display_available || !display_ready) {
-        return 0;  /* Silently skip if no display */
-    }
-    
+
     /* Clear display */
     ret = cfb_framebuffer_clear(display_dev, false);
     if (ret != 0) {
@@ -749,7 +1201,7 @@ int oled_display_pairing(void)
     cfb_print(display_dev, "Pairing...", 0, y_pos);
     
     /* Update display */
-    ret = cfb_framebuffer_finalize(display_dev);
+    ret = oled_display_finalize();
     if (ret != 0) {
         LOG_ERR("Failed to finalize framebuffer (err %d)", ret);
         return ret;
@@ -766,53 +1218,6 @@ int oled_display_pairing(void)
     return 0;
 }
 
-/* Custom framebuffer inversion function that directly manipulates pixel data */
-__maybe_unused static int oled_display_invert_framebuffer(void)
-{
-    if (!display_available || !display_ready) {
-        return 0;  /* Silently skip if no display */
-    }
-
-    /* Get direct access to the display buffer */
-    size_t buffer_size;
-    
-    /* For SSD1306 128x64 display = 128 * 64 / 8 = 1024 bytes */
-    buffer_size = display_cols * display_rows / 8;
-    
-    /* Try to get the CFB buffer - this might not work directly */
-    /* So we'll use display_write with an inverted pattern instead */
-    
-    /* Create a temporary buffer for the inverted data */
-    static uint8_t inverted_buffer[1024]; /* Max size for 128x64 display */
-    
-    /* First, we need to read the current framebuffer content */
-    /* Since we can't directly read from CFB, we'll use display_read if available */
-    /* or work with a known pattern */
-    
-    /* For now, let's create a fully inverted pattern */
-    for (size_t i = 0; i < buffer_size && i < sizeof(inverted_buffer); i++) {
-        inverted_buffer[i] = 0xFF; /* All pixels on = dark background */
-    }
-    
-    /* Write the inverted pattern to the display */
-    struct display_buffer_descriptor desc = {
-        .buf_size = buffer_size,
-        .width = display_cols,
-        .height = display_rows,
-        .pitch = display_cols,
-        .frame_incomplete = false
-    };
-    
-    int ret = display_write(display_dev, 0, 0, &desc, inverted_buffer);
-    if (ret != 0) {
-        LOG_ERR("Failed to write inverted framebuffer (err %d)", ret);
-        return ret;
-    }
-    
-    LOG_DBG("Framebuffer manually inverted");
-    return 0;
-}
-
 /* Convert RSSI value to signal strength bars */
 static const char* rssi_to_signal_bars(int8_t rssi_dbm)
 {
@@ -8,17 +8,26 @@
 #ifndef OLED_DISPLAY_H_
 #define OLED_DISPLAY_H_
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <zephyr/sys/util.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined(CONFIG_RELAY_OLED)
+
 /**
  * @brief Initialize the OLED display
  * 
- * @return 0 on success, negative error code on failure
+ * The screen functions below only queue the requested screen for the render
+ * thread and return immediately; only the most recent request is drawn if
+ * several arrive before it runs.
+ *
+ * @return 0 on success, -ENOTSUP without CONFIG_RELAY_OLED, or another
+ *         negative error code on failure
  */
 int oled_display_init(void);
 
@@ -66,7 +75,10 @@ bool oled_display_is_available(void);
 /**
  * @brief Display splash screen with Augmental logo
  * 
- * @param duration_ms How long to show splash screen (0 = show until next update)
+ * Shown by the render thread for duration_ms, then faded out. Screens
+ * requested in the meantime are held and the latest is drawn afterwards.
+ *
+ * @param duration_ms How long to hold the logo before fading out
  * @return 0 on success, negative error code on failure
  */
 int oled_display_splash_screen(uint32_t duration_ms);
@@ -104,6 +116,105 @@ int oled_display_device_found(const char *device_name);
  */
 int oled_display_pairing(void);
 
+/**
+ * @brief Turn the panel off or allow it back on
+ * 
+ * While asleep every other request is dropped. Waking only allows drawing
+ * again; the next request (normally a status update, which is forced)
+ * turns the panel back on.
+ * @param sleep true to turn the panel off
+ * @return 0 on success, negative error code on failure
+ */
+int oled_display_set_sleep(bool sleep);
+
+/**
+ * @brief Lower the panel contrast, or restore it
+ * 
+ * Used while the relay is deep idle; takes effect between draws.
+ * @param dimmed true for the low contrast level
+ * @return 0 on success, negative error code on failure
+ */
+int oled_display_set_dimmed(bool dimmed);
+
+#else
+
+static inline int oled_display_init(void)
+{
+	return -ENOTSUP;
+}
+
+static inline int oled_display_clear(void)
+{
+	return 0;
+}
+
+static inline int oled_display_update_status(uint8_t battery_level, bool is_connected,
+					     int8_t rssi_dbm)
+{
+	ARG_UNUSED(battery_level);
+	ARG_UNUSED(is_connected);
+	ARG_UNUSED(rssi_dbm);
+	return 0;
+}
+
+static inline int oled_display_message(const char *message)
+{
+	ARG_UNUSED(message);
+	return 0;
+}
+
+static inline int oled_display_device_info(const char *device_name, uint32_t connection_count)
+{
+	ARG_UNUSED(device_name);
+	ARG_UNUSED(connection_count);
+	return 0;
+}
+
+static inline bool oled_display_is_available(void)
+{
+	return false;
+}
+
+static inline int oled_display_splash_screen(uint32_t duration_ms)
+{
+	ARG_UNUSED(duration_ms);
+	return 0;
+}
+
+static inline void oled_display_reset_state(void)
+{
+}
+
+static inline int oled_display_scanning(void)
+{
+	return 0;
+}
+
+static inline int oled_display_device_found(const char *device_name)
+{
+	ARG_UNUSED(device_name);
+	return 0;
+}
+
+static inline int oled_display_pairing(void)
+{
+	return 0;
+}
+
+static inline int oled_display_set_sleep(bool sleep)
+{
+	ARG_UNUSED(sleep);
+	return 0;
+}
+
+static inline int oled_display_set_dimmed(bool dimmed)
+{
+	ARG_UNUSED(dimmed);
+	return 0;
+}
+
+#endif /* CONFIG_RELAY_OLED */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+#include "relay_activity.h"
+#include "relay_bus.h"
+#include "relay_workq.h"
+
+LOG_MODULE_REGISTER(relay_activity, LOG_LEVEL_INF);
+
+#define IDLE_MS      CONFIG_RELAY_ACTIVITY_IDLE_MS
+#define DEEP_IDLE_MS CONFIG_RELAY_ACTIVITY_DEEP_IDLE_MS
+
+BUILD_ASSERT(DEEP_IDLE_MS > IDLE_MS, "Deep idle must come after idle");
+
+/* Nothing has moved since boot */
+static atomic_t level = ATOMIC_INIT(RELAY_ACTIVITY_DEEP_IDLE);
+static atomic_t last_activity_ms;
+
+/* Work queue only */
+static enum relay_activity_level published = RELAY_ACTIVITY_DEEP_IDLE;
+
+static void activity_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(activity_work, activity_work_handler);
+
+static const char *level_name(enum relay_activity_level lvl)
+{
+	switch (lvl) {
+	case RELAY_ACTIVITY_ACTIVE:
+		return "active";
+	case RELAY_ACTIVITY_IDLE:
+		return "idle";
+	default:
+		return "deep idle";
+	}
+}
+
+/* Work queue: settle the level from the last stamp, publish, arm the next step */
+static void activity_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	uint32_t last = (uint32_t)atomic_get(&last_activity_ms);
+	uint32_t elapsed = k_uptime_get_32() - last;
+	enum relay_activity_level now_level;
+	uint32_t next_ms = 0;
+
+	if (elapsed >= DEEP_IDLE_MS) {
+		now_level = RELAY_ACTIVITY_DEEP_IDLE;
+	} else if (elapsed >= IDLE_MS) {
+		now_level = RELAY_ACTIVITY_IDLE;
+		next_ms = DEEP_IDLE_MS - elapsed;
+	} else {
+		now_level = RELAY_ACTIVITY_ACTIVE;
+		next_ms = IDLE_MS - elapsed;
+	}
+
+	if (now_level != RELAY_ACTIVITY_ACTIVE) {
+		atomic_set(&level, now_level);
+		/* A mark that saw the old active level did not reschedule us */
+		if ((uint32_t)atomic_get(&last_activity_ms) != last) {
+			atomic_set(&level, RELAY_ACTIVITY_ACTIVE);
+			now_level = RELAY_ACTIVITY_ACTIVE;
+			next_ms = IDLE_MS;
+		}
+	}
+
+	if (now_level != published) {
+		const struct relay_activity_msg msg = { .level = now_level };
+
+		published = now_level;
+		LOG_DBG("Activity: %s", level_name(now_level));
+		relay_bus_publish(&relay_chan_activity, &msg);
+	}
+
+	if (next_ms) {
+		k_work_reschedule_for_queue(&relay_workq_protocol, &activity_work,
+					    K_MSEC(next_ms));
+	}
+}
+
+void relay_activity_mark(void)
+{
+	atomic_set(&last_activity_ms, (atomic_val_t)k_uptime_get_32());
+
+	if (atomic_get(&level) != RELAY_ACTIVITY_ACTIVE &&
+	    atomic_set(&level, RELAY_ACTIVITY_ACTIVE) != RELAY_ACTIVITY_ACTIVE) {
+		k_work_reschedule_for_queue(&relay_workq_protocol, &activity_work, K_NO_WAIT);
+	}
+}
+
+enum relay_activity_level relay_activity_level(void)
+{
+	return (enum relay_activity_level)atomic_get(&level);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Shared user activity level
+ *
+ * The HID and NUS fast paths stamp every forwarded packet here. The level
+ * drops to idle after CONFIG_RELAY_ACTIVITY_IDLE_MS without traffic and to
+ * deep idle after CONFIG_RELAY_ACTIVITY_DEEP_IDLE_MS, and flips back to
+ * active on the next packet. Each transition is published on
+ * relay_chan_activity (relay_bus.h) from the protocol work queue, whose
+ * listeners (connection parameters, RSSI sampling, LEDs, display) run
+ * there, so they all back off together.
+ */
+
+#ifndef RELAY_ACTIVITY_H_
+#define RELAY_ACTIVITY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum relay_activity_level {
+	RELAY_ACTIVITY_ACTIVE,
+	RELAY_ACTIVITY_IDLE,
+	RELAY_ACTIVITY_DEEP_IDLE,
+};
+
+/**
+ * @brief Note a forwarded packet
+ *
+ * One atomic store while already active. Safe from any context, including
+ * the BT RX thread for every report.
+ */
+void relay_activity_mark(void);
+
+/**
+ * @brief Current level, as last published or just marked active
+ */
+enum relay_activity_level relay_activity_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_ACTIVITY_H_ */
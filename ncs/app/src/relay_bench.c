@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+#include "relay_bench.h"
+#include "ble_hid.h"
+#include "ble_transport.h"
+#include "hid_latency.h"
+#include "mouthpad_hid_reports.h"
+#include "usb_cdc.h"
+
+LOG_MODULE_REGISTER(relay_bench, LOG_LEVEL_INF);
+
+#if IS_ENABLED(CONFIG_RELAY_BENCH)
+
+/* Above the shell, level with the other USB TX threads */
+#define RELAY_BENCH_THREAD_STACK_SIZE 1536
+#define RELAY_BENCH_THREAD_PRIORITY   5
+
+#define RELAY_BENCH_RATE_MAX     8000
+#define RELAY_BENCH_DURATION_MAX (60 * MSEC_PER_SEC)
+
+#define PASS_THROUGH_MAX sizeof(((mouthware_message_PassThroughToApp *)0)->data.bytes)
+
+static const struct relay_bench_params *bench_params;
+static struct relay_bench_result *bench_result;
+static atomic_t bench_busy;
+static K_SEM_DEFINE(bench_start, 0, 1);
+static K_SEM_DEFINE(bench_done, 0, 1);
+
+/* HID: motion alternates one count left and right so the cursor stays put;
+ * other reports are all zeros, which presses nothing
+ */
+static int bench_send_hid(uint8_t report_id, uint32_t seq)
+{
+	uint8_t report[MOUTHPAD_HID_REPORT_SIZE_MAX] = {0};
+
+	if (report_id == MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION) {
+		/* 12-bit X of +1 or -1, Y of 0 */
+		report[0] = (seq & 1) ? 0xFF : 0x01;
+		report[1] = (seq & 1) ? 0x0F : 0x00;
+	}
+
+	return ble_hid_inject_report(report_id, report, mouthpad_hid_report_size(report_id));
+}
+
+static int bench_send_pass_through(uint16_t size, uint32_t seq)
+{
+	uint8_t data[PASS_THROUGH_MAX];
+
+	/* Sequence number up front so a capture shows gaps */
+	memset(data, (uint8_t)seq, size);
+	memcpy(data, &seq, MIN(size, sizeof(seq)));
+
+	return usb_cdc_send_pass_through(data, size, 0);
+}
+
+static void bench_account(struct relay_bench_result *result, int ret)
+{
+	if (ret == 0) {
+		result->sent++;
+	} else if (ret == -EAGAIN) {
+		result->coalesced++;
+	} else {
+		result->dropped++;
+	}
+}
+
+static void bench_execute(const struct relay_bench_params *params,
+			  struct relay_bench_result *result)
+{
+	int64_t period = MAX(k_us_to_ticks_ceil64(USEC_PER_SEC / params->rate_hz), 1);
+	int64_t start = k_uptime_ticks();
+	int64_t end = start + k_ms_to_ticks_ceil64(params->duration_ms);
+	int64_t next = start;
+
+	for (uint32_t seq = 0; next < end; seq++) {
+		k_sleep(K_TIMEOUT_ABS_TICKS(next));
+
+		/* A real notification would now race the injected ones */
+		if (ble_transport_is_connected()) {
+			result->aborted = -ENOTCONN;
+			break;
+		}
+
+		uint32_t t0 = k_cycle_get_32();
+		int ret = params->kind == RELAY_BENCH_HID
+				  ? bench_send_hid(params->report_id, seq)
+				  : bench_send_pass_through(params->size, seq);
+		uint32_t call_us = k_cyc_to_us_floor32(k_cycle_get_32() - t0);
+
+		result->attempted++;
+		result->max_call_us = MAX(result->max_call_us, call_us);
+		bench_account(result, ret);
+
+		/* Behind by a whole slot: skip ahead instead of bursting */
+		next += period;
+		int64_t now = k_uptime_ticks();
+
+		if (now > next + period) {
+			int64_t missed = (now - next) / period;
+
+			result->late += (uint32_t)missed;
+			next += missed * period;
+		}
+	}
+
+	result->elapsed_ms = (uint32_t)k_ticks_to_ms_floor64(k_uptime_ticks() - start);
+}
+
+static void relay_bench_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		k_sem_take(&bench_start, K_FOREVER);
+
+		const struct relay_bench_params *params = bench_params;
+		struct relay_bench_result *result = bench_result;
+
+		if (params->kind == RELAY_BENCH_HID) {
+			if (ble_hid_inject_start() != 0) {
+				result->aborted = -ENOTCONN;
+				k_sem_give(&bench_done);
+				continue;
+			}
+			bench_execute(params, result);
+			ble_hid_inject_stop();
+		} else {
+			struct usb_cdc_tx_stats stats;
+
+			bench_execute(params, result);
+			usb_cdc_get_tx_stats(&stats);
+			result->ring_dropped = stats.dropped;
+			result->ring_peak = stats.high_water;
+		}
+
+		k_sem_give(&bench_done);
+	}
+}
+
+K_THREAD_DEFINE(relay_bench_tid, RELAY_BENCH_THREAD_STACK_SIZE, relay_bench_thread, NULL, NULL,
+		NULL, RELAY_BENCH_THREAD_PRIORITY, 0, 0);
+
+int relay_bench_run(const struct relay_bench_params *params, struct relay_bench_result *result)
+{
+	if (params->rate_hz == 0 || params->rate_hz > RELAY_BENCH_RATE_MAX ||
+	    params->duration_ms == 0 || params->duration_ms > RELAY_BENCH_DURATION_MAX) {
+		return -EINVAL;
+	}
+	if (params->kind == RELAY_BENCH_HID && mouthpad_hid_report_size(params->report_id) == 0) {
+		return -EINVAL;
+	}
+	if (params->kind == RELAY_BENCH_PASS_THROUGH &&
+	    (params->size == 0 || params->size > PASS_THROUGH_MAX)) {
+		return -EINVAL;
+	}
+	if (ble_transport_is_connected() || !atomic_cas(&bench_busy, 0, 1)) {
+		return -EBUSY;
+	}
+
+	memset(result, 0, sizeof(*result));
+	hid_latency_reset();
+	usb_cdc_reset_tx_stats();
+
+	LOG_INF("Bench started: %s at %u Hz for %u ms",
+		params->kind == RELAY_BENCH_HID ? "HID" : "pass-through", params->rate_hz,
+		params->duration_ms);
+
+	bench_params = params;
+	bench_result = result;
+	k_sem_give(&bench_start);
+	k_sem_take(&bench_done, K_FOREVER);
+
+	atomic_set(&bench_busy, 0);
+	return 0;
+}
+
+#else /* !CONFIG_RELAY_BENCH */
+
+int relay_bench_run(const struct relay_bench_params *params, struct relay_bench_result *result)
+{
+	ARG_UNUSED(params);
+	ARG_UNUSED(result);
+
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_RELAY_BENCH */
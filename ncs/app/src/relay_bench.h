@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Synthetic load for the USB side of the relay
+ *
+ * Drives the USB paths at a fixed rate with no MouthPad in the loop, for
+ * the "bench" shell command on CDC1. HID runs feed reports through
+ * ble_hid_inject_report(), the same forwarding as a HOGP notification, so
+ * the latency histograms (see hid_latency.h) cover them. Pass-through runs
+ * queue PassThroughToApp frames for CDC0 through usb_cdc_send_pass_through(),
+ * as NUS data from the MouthPad would be; whatever reads CDC0 receives them.
+ * The latency histograms and the CDC0 TX counters are cleared when a run
+ * starts.
+ *
+ * A run happens on its own thread and the caller blocks until it ends.
+ * Slots the sender could not keep up with are counted as late and skipped
+ * rather than sent as a burst. Only available with CONFIG_RELAY_BENCH and
+ * no MouthPad connected.
+ */
+
+#ifndef RELAY_BENCH_H_
+#define RELAY_BENCH_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum relay_bench_kind {
+	RELAY_BENCH_HID,
+	RELAY_BENCH_PASS_THROUGH,
+};
+
+struct relay_bench_params {
+	enum relay_bench_kind kind;
+	uint8_t report_id;     /* HID only */
+	uint16_t size;         /* Pass-through payload bytes */
+	uint32_t rate_hz;
+	uint32_t duration_ms;
+};
+
+struct relay_bench_result {
+	uint32_t attempted;    /* Send slots the schedule reached */
+	uint32_t sent;         /* Accepted by the USB path */
+	uint32_t coalesced;    /* HID motion folded into a later report */
+	uint32_t dropped;      /* Refused or failed */
+	uint32_t late;         /* Schedule slots skipped because a send overran */
+	uint32_t elapsed_ms;
+	uint32_t max_call_us;  /* Longest single send call */
+	uint32_t ring_dropped; /* Pass-through: frames the CDC0 TX ring dropped */
+	uint32_t ring_peak;    /* Pass-through: most bytes queued in the TX ring */
+	int aborted;           /* 0, or -ENOTCONN if a MouthPad connected */
+};
+
+/**
+ * @brief Run one bench pass and wait for it to finish
+ *
+ * @return 0 when the run started (result->aborted tells whether it ran to
+ *         the end), -EBUSY while a MouthPad is connected or another run is
+ *         in progress, -EINVAL for bad parameters, -ENOTSUP without
+ *         CONFIG_RELAY_BENCH
+ */
+int relay_bench_run(const struct relay_bench_params *params, struct relay_bench_result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_BENCH_H_ */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "relay_bus.h"
+#include "link_state.h"
+
+LOG_MODULE_REGISTER(relay_bus, LOG_LEVEL_INF);
+
+ZBUS_CHAN_DEFINE(relay_chan_hid_report, struct relay_hid_report_msg, NULL, NULL,
+		 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(relay_chan_link_state, struct relay_link_state_msg, NULL, NULL,
+		 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(false));
+
+/* Nothing has moved since boot, as relay_activity starts */
+ZBUS_CHAN_DEFINE(relay_chan_activity, struct relay_activity_msg, NULL, NULL,
+		 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(.level = RELAY_ACTIVITY_DEEP_IDLE));
+
+ZBUS_CHAN_DEFINE(relay_chan_telemetry, struct relay_telemetry_msg, NULL, NULL,
+		 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(.rssi = 0, .battery_level = 0xFF));
+
+void relay_bus_publish(const struct zbus_channel *chan, const void *msg)
+{
+	int err = zbus_chan_pub(chan, msg, K_NO_WAIT);
+
+	if (err) {
+		LOG_DBG("Message dropped (err %d)", err);
+	}
+}
+
+/* Change one field and tell the observers, without waiting */
+static void telemetry_update(int8_t *rssi, uint8_t *battery_level)
+{
+	struct relay_telemetry_msg *msg;
+
+	if (zbus_chan_claim(&relay_chan_telemetry, K_NO_WAIT)) {
+		LOG_DBG("Telemetry dropped");
+		return;
+	}
+
+	msg = zbus_chan_msg(&relay_chan_telemetry);
+	if (rssi) {
+		msg->rssi = *rssi;
+	}
+	if (battery_level) {
+		msg->battery_level = *battery_level;
+	}
+	zbus_chan_finish(&relay_chan_telemetry);
+
+	if (zbus_chan_notify(&relay_chan_telemetry, K_NO_WAIT)) {
+		LOG_DBG("Telemetry not notified");
+	}
+}
+
+void relay_bus_telemetry_rssi(int8_t rssi)
+{
+	link_state_set_rssi(rssi);
+	telemetry_update(&rssi, NULL);
+}
+
+void relay_bus_telemetry_battery(uint8_t battery_level)
+{
+	link_state_set_battery(battery_level);
+	telemetry_update(NULL, &battery_level);
+}
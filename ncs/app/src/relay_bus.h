@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Internal event channels between the relay's modules (zbus)
+ *
+ * A module that learns something publishes it once on its channel, and the
+ * modules that care observe the channel instead of being called by name:
+ *
+ * - relay_chan_hid_report: each MouthPad input report, once forwarded
+ * - relay_chan_link_state: MouthPad link up, ready or lost
+ * - relay_chan_activity: activity level changes (relay_activity.h)
+ * - relay_chan_telemetry: battery level or smoothed RSSI changed
+ *
+ * Observers are listeners, added with ZBUS_CHAN_ADD_OBS() and run in the
+ * publisher's context in priority order, RELAY_BUS_PRIO_* first. A listener
+ * only stores state, counts, or posts to a queue of its own (the buzzer
+ * sequencer, relay_events, a work queue), so the publisher, which may be
+ * the BT RX thread for every report, never waits on one.
+ */
+
+#ifndef RELAY_BUS_H_
+#define RELAY_BUS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "mouthpad_hid_reports.h"
+#include "relay_activity.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Observer priorities, lowest first */
+#define RELAY_BUS_PRIO_STATE    1 /* State other modules read on their hot path */
+#define RELAY_BUS_PRIO_CONTROL  2 /* Link and radio control */
+#define RELAY_BUS_PRIO_FEEDBACK 3 /* Buzzer, LEDs, display, host status */
+#define RELAY_BUS_PRIO_STATS    4 /* Counters */
+
+struct relay_hid_report_msg {
+	uint8_t report_id;
+	uint8_t size; /* As received; data holds the first bytes */
+	uint8_t pressed; /* Buttons that went down, Report ID 1 only */
+	bool sent; /* The USB host has it */
+	uint8_t data[MOUTHPAD_HID_REPORT_SIZE_MAX];
+};
+
+struct relay_link_state_msg {
+	bool connected; /* NUS or HID client ready */
+	bool ready; /* Services ready; CONNECTED reported to the host */
+};
+
+struct relay_activity_msg {
+	enum relay_activity_level level;
+};
+
+struct relay_telemetry_msg {
+	int8_t rssi; /* Smoothed, dBm */
+	uint8_t battery_level; /* %, 0xFF when unknown */
+};
+
+ZBUS_CHAN_DECLARE(relay_chan_hid_report, relay_chan_link_state, relay_chan_activity,
+		  relay_chan_telemetry);
+
+/**
+ * @brief Publish without waiting
+ *
+ * A message that finds the channel taken by another publisher is dropped,
+ * so a hot path never blocks here.
+ */
+void relay_bus_publish(const struct zbus_channel *chan, const void *msg);
+
+/**
+ * @brief Publish a new RSSI, keeping the battery level
+ *
+ * The link-state snapshot (link_state.h) takes it too, as does the
+ * battery level below.
+ */
+void relay_bus_telemetry_rssi(int8_t rssi);
+
+/**
+ * @brief Publish a new battery level, keeping the RSSI
+ */
+void relay_bus_telemetry_battery(uint8_t battery_level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_BUS_H_ */
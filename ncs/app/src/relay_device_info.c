@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/addr.h>
+#include <zephyr/bluetooth/conn.h>
+#include <string.h>
+
+#include "relay_device_info.h"
+#include "ble_central.h"
+#include "ble_dis.h"
+#include "ble_transport.h"
+#include "usb_cdc.h"
+#include "MouthpadRelay.pb.h"
+#include "pb_encode.h"
+
+LOG_MODULE_REGISTER(relay_device_info, LOG_LEVEL_INF);
+
+/* CONFIG_DONGLE_BOARD_ID holds raw DeviceBoard values */
+BUILD_ASSERT(mouthware_message_DeviceBoard_DEVICE_BOARD_SEEED_XIAO_NRF52840 == 1 &&
+	     mouthware_message_DeviceBoard_DEVICE_BOARD_NORDIC_NRF52840DONGLE == 2 &&
+	     mouthware_message_DeviceBoard_DEVICE_BOARD_APRBROTHER_NRF52840 == 3 &&
+	     mouthware_message_DeviceBoard_DEVICE_BOARD_RAYTAC_MDBT50Q_RX == 4 &&
+	     mouthware_message_DeviceBoard_DEVICE_BOARD_RAYTAC_MDBT50Q_CX_40 == 5 &&
+	     mouthware_message_DeviceBoard_DEVICE_BOARD_MAKERDIARY_NRF52840_MDK == 6 &&
+	     mouthware_message_DeviceBoard_DEVICE_BOARD_ADAFRUIT_FEATHER_NRF52840 == 7,
+	     "DONGLE_BOARD_ID defaults in Kconfig are out of step with DeviceBoard");
+
+/* Outer tag and length, then address, name and firmware strings (at most 17,
+ * 31 and 63 characters, each with a 2 byte header), VID, PID, family, board.
+ */
+#define DEVICE_INFO_ENCODED_MAX 160
+
+/* request_id, appended to the cached encoding per send: 2 byte tag, varint */
+#define DEVICE_INFO_REQUEST_ID_MAX (2 + 5)
+
+/* Bumped on every change to the inputs; the cache holds the value it was
+ * built at. Starts ahead of the cache so the first read builds.
+ */
+static atomic_t generation = ATOMIC_INIT(1);
+
+/* Only touched from the protocol work queue */
+static atomic_val_t cached_generation;
+static uint8_t cached[DEVICE_INFO_ENCODED_MAX + DEVICE_INFO_REQUEST_ID_MAX];
+static size_t cached_len;
+
+/* nanopb string encoding callback for device info strings */
+static bool encode_string_callback(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+	const char *str = (const char *)(*arg);
+
+	if (!str || str[0] == '\0') {
+		return true;  /* Empty string, nothing to encode */
+	}
+
+	if (!pb_encode_tag_for_field(stream, field)) {
+		return false;
+	}
+
+	return pb_encode_string(stream, (const uint8_t *)str, strlen(str));
+}
+
+static int device_info_build(void)
+{
+	/* Static like the cache; only encoded from here */
+	static mouthware_message_RelayToAppMessage response;
+	mouthware_message_DeviceInfoResponse *info = &response.message_body.device_info_response;
+
+	response = (mouthware_message_RelayToAppMessage)mouthware_message_RelayToAppMessage_init_zero;
+	response.which_message_body = mouthware_message_RelayToAppMessage_device_info_response_tag;
+
+	/* Check if we have a bonded device (even if disconnected) */
+	bt_addr_le_t bonded_addr;
+	static char bonded_name[32];
+	bool has_bonded = ble_central_get_bonded_device_addr(&bonded_addr, bonded_name, sizeof(bonded_name));
+
+	/* Get BLE address - prefer active connection, fallback to bonded address */
+	static char ble_addr_str[BT_ADDR_STR_LEN];
+	struct bt_conn *conn = ble_central_get_default_conn();
+	const bt_addr_le_t *target_addr = NULL;
+
+	if (conn) {
+		/* Device is currently connected - get address from connection */
+		target_addr = bt_conn_get_dst(conn);
+	} else if (has_bonded) {
+		/* Device is bonded but not connected - return cached address */
+		target_addr = &bonded_addr;
+	}
+
+	if (target_addr) {
+		bt_addr_to_str(&target_addr->a, ble_addr_str, sizeof(ble_addr_str));
+		info->address.funcs.encode = encode_string_callback;
+		info->address.arg = (void *)ble_addr_str;
+	}
+
+	/* Get device name - prefer live name from active connection, fallback to cached name */
+	const char *device_name = NULL;
+	if (conn) {
+		/* Get advertised device name from BLE transport (live connection) */
+		device_name = ble_transport_get_device_name();
+	}
+
+	/* If no live name available but we have a cached bonded name, use that */
+	if ((!device_name || device_name[0] == '\0') && has_bonded && bonded_name[0] != '\0') {
+		device_name = bonded_name;
+	}
+
+	if (device_name && device_name[0] != '\0') {
+		info->name.funcs.encode = encode_string_callback;
+		info->name.arg = (void *)device_name;
+	}
+
+	/* DIS info for the same device: connected, else first bonded */
+	static ble_dis_info_t dis_info_buf;
+	int dis_err = -ENOENT;
+
+	if (target_addr) {
+		dis_err = ble_dis_load_info_for_addr(target_addr, &dis_info_buf);
+	}
+
+	if (dis_err == 0) {
+		LOG_INF("DIS info loaded: has_fw=%d, has_pnp=%d",
+			dis_info_buf.has_firmware_version, dis_info_buf.has_pnp_id);
+		/* Firmware version */
+		if (dis_info_buf.has_firmware_version) {
+			LOG_INF("DIS firmware: %s", dis_info_buf.firmware_version);
+			info->firmware.funcs.encode = encode_string_callback;
+			info->firmware.arg = (void *)dis_info_buf.firmware_version;
+		}
+		/* VID and PID from PnP ID */
+		if (dis_info_buf.has_pnp_id) {
+			LOG_INF("DIS PnP ID: VID=0x%04X, PID=0x%04X",
+				dis_info_buf.vendor_id, dis_info_buf.product_id);
+			info->vid = dis_info_buf.vendor_id;
+			info->pid = dis_info_buf.product_id;
+		}
+	} else {
+		LOG_WRN("DIS info not available for device (err: %d)", dis_err);
+	}
+
+	/* Device family and board (always available) */
+	info->family = mouthware_message_DeviceFamily_DEVICE_FAMILY_NRF;
+	info->board = (mouthware_message_DeviceBoard)CONFIG_DONGLE_BOARD_ID;
+
+	if (CONFIG_DONGLE_BOARD_ID == 0) {
+		LOG_WRN("Unknown board name: %s", CONFIG_DONGLE_BOARD_NAME);
+	}
+
+	pb_ostream_t stream = pb_ostream_from_buffer(cached, DEVICE_INFO_ENCODED_MAX);
+
+	if (!pb_encode(&stream, mouthware_message_RelayToAppMessage_fields, &response)) {
+		LOG_ERR("Device info encode failed: %s", PB_GET_ERROR(&stream));
+		return -EMSGSIZE;
+	}
+	cached_len = stream.bytes_written;
+
+	LOG_INF("Device info: family=nrf, board=%s (enum=%d)", CONFIG_DONGLE_BOARD_NAME, info->board);
+
+	LOG_INF("Device info cached: bonded=%d, connected=%d, Addr=%s, Name=%s, %u bytes",
+		has_bonded, conn != NULL,
+		target_addr ? ble_addr_str : "(none)",
+		(device_name && device_name[0] != '\0') ? device_name : "(none)",
+		(unsigned int)cached_len);
+
+	return 0;
+}
+
+void relay_device_info_invalidate(void)
+{
+	atomic_inc(&generation);
+}
+
+int relay_device_info_send(uint32_t request_id)
+{
+	/* Read before building: a change during the build leaves the cache stale */
+	atomic_val_t current = atomic_get(&generation);
+
+	if (current != cached_generation) {
+		int err = device_info_build();
+
+		if (err) {
+			return err;
+		}
+		cached_generation = current;
+	}
+
+	/* Fields may come in any order, so the ID goes after the cached ones */
+	pb_ostream_t stream = pb_ostream_from_buffer(&cached[cached_len], DEVICE_INFO_REQUEST_ID_MAX);
+
+	if (request_id &&
+	    (!pb_encode_tag(&stream, PB_WT_VARINT, mouthware_message_RelayToAppMessage_request_id_tag) ||
+	     !pb_encode_varint(&stream, request_id))) {
+		return -EMSGSIZE;
+	}
+
+	return usb_cdc_send_data(cached, cached_len + stream.bytes_written);
+}
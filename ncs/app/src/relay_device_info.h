@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief DeviceInfoResponse for DeviceInfoRead requests on CDC0
+ *
+ * The response is assembled from the bonding list, the active connection
+ * and the DIS record held in settings, then kept as encoded bytes. Repeat
+ * reads resend those bytes without touching settings or nanopb. Whatever
+ * changes one of those inputs calls relay_device_info_invalidate(), and the
+ * next read rebuilds the response.
+ */
+
+#ifndef RELAY_DEVICE_INFO_H_
+#define RELAY_DEVICE_INFO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Mark the cached response stale
+ *
+ * Call after a change to DIS info, to the bonding list or to the active
+ * connection. Cheap and safe from any context.
+ */
+void relay_device_info_invalidate(void);
+
+/**
+ * @brief Send the DeviceInfoResponse to the host
+ *
+ * Rebuilds the response first if it is stale. Call from the protocol work
+ * queue only.
+ *
+ * @param request_id DeviceInfoRead's request_id, echoed in the response
+ * @return 0 on success, negative errno otherwise
+ */
+int relay_device_info_send(uint32_t request_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_DEVICE_INFO_H_ */
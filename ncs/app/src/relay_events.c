@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "relay_events.h"
+#include "relay_bus.h"
+
+K_EVENT_DEFINE(relay_events);
+
+/* The main thread redraws from the modules' state, so a channel only has
+ * to wake it
+ */
+static void wake_main(const struct zbus_channel *chan)
+{
+	if (chan == &relay_chan_link_state) {
+		relay_events_post(RELAY_EVENT_LINK);
+	} else if (chan == &relay_chan_activity) {
+		relay_events_post(RELAY_EVENT_ACTIVITY);
+	} else if (chan == &relay_chan_telemetry) {
+		relay_events_post(RELAY_EVENT_STATUS);
+	}
+}
+
+ZBUS_LISTENER_DEFINE(relay_events_wake, wake_main);
+ZBUS_CHAN_ADD_OBS(relay_chan_link_state, relay_events_wake, RELAY_BUS_PRIO_FEEDBACK);
+ZBUS_CHAN_ADD_OBS(relay_chan_activity, relay_events_wake, RELAY_BUS_PRIO_FEEDBACK);
+ZBUS_CHAN_ADD_OBS(relay_chan_telemetry, relay_events_wake, RELAY_BUS_PRIO_FEEDBACK);
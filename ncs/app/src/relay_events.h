@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Events that wake the main thread
+ *
+ * The main thread refreshes the LEDs and the OLED, and pushes connection
+ * status changes to the host, only when one of these is posted; it has no
+ * timeouts of its own. The button runs from its own
+ * interrupt and timers. Producers post from any context, including
+ * ISRs and the Bluetooth RX thread; post on state changes only, never per
+ * HID report. Link state, activity and telemetry published on relay_bus.h
+ * channels post LINK, ACTIVITY and STATUS themselves.
+ */
+
+#ifndef RELAY_EVENTS_H_
+#define RELAY_EVENTS_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RELAY_EVENT_LINK         BIT(0) /* Central state changed, services ready, or link lost */
+#define RELAY_EVENT_ACTIVITY     BIT(1) /* Activity level changed (relay_activity.h) */
+#define RELAY_EVENT_STATUS       BIT(2) /* Battery level or RSSI changed */
+#define RELAY_EVENT_USB_SUSPEND  BIT(3) /* USB host suspended or resumed the bus */
+#define RELAY_EVENT_PROFILE      BIT(4) /* Tuning profile turned the status lights on or off */
+
+#define RELAY_EVENTS_ALL (RELAY_EVENT_LINK | RELAY_EVENT_ACTIVITY | RELAY_EVENT_STATUS | \
+			  RELAY_EVENT_USB_SUSPEND | RELAY_EVENT_PROFILE)
+
+extern struct k_event relay_events;
+
+static inline void relay_events_post(uint32_t events)
+{
+	k_event_post(&relay_events, events);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_EVENTS_H_ */
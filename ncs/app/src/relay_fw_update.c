@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/dfu/flash_img.h>
+#include <zephyr/dfu/mcuboot.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/reboot.h>
+
+#include "relay_fw_update.h"
+#include "relay_workq.h"
+#include "usb_cdc.h"
+#include "fw_update.h"
+
+LOG_MODULE_REGISTER(relay_fw_update, LOG_LEVEL_INF);
+
+/* Time for the final FwUpdateStatus to reach the host before the reset */
+#define REBOOT_DELAY_MS 500
+
+static struct flash_img_context img;
+static struct k_work process_work;
+static struct k_work_delayable reboot_work;
+
+static int update_begin(uint32_t size)
+{
+	int err = flash_img_init(&img);
+
+	if (err) {
+		LOG_ERR("Secondary slot not available (err %d)", err);
+		return err;
+	}
+	if (size > img.flash_area->fa_size) {
+		LOG_WRN("Image of %u B does not fit the %u B slot", size,
+			(uint32_t)img.flash_area->fa_size);
+		return FW_UPDATE_ERR_TOO_LARGE;
+	}
+
+	LOG_INF("Receiving %u B into the secondary slot", size);
+	return 0;
+}
+
+static int update_write(uint32_t offset, const uint8_t *data, size_t len)
+{
+	ARG_UNUSED(offset);
+
+	return flash_img_buffered_write(&img, data, len, false);
+}
+
+static int update_finish(uint32_t size, const uint8_t *sha256)
+{
+	/* The flush also erases the slot's trailer, left over from any image
+	 * written there before
+	 */
+	int err = flash_img_buffered_write(&img, NULL, 0, true);
+
+	if (err) {
+		return err;
+	}
+
+	err = flash_img_check(&img, &(struct flash_img_check){.match = sha256, .clen = size},
+			      img.flash_area->fa_id);
+	if (err) {
+		LOG_WRN("Image check failed (err %d)", err);
+		return FW_UPDATE_ERR_VERIFY;
+	}
+
+	err = boot_request_upgrade(BOOT_UPGRADE_TEST);
+	if (err) {
+		LOG_ERR("Upgrade request failed (err %d)", err);
+		return err;
+	}
+
+	LOG_INF("Image verified; it runs after the next reset");
+	return 0;
+}
+
+static void update_abort(void)
+{
+	/* Nothing is marked until update_finish(); the partial image is left
+	 * for the next update to overwrite
+	 */
+	LOG_INF("Update dropped");
+}
+
+static void reboot_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	sys_reboot(SYS_REBOOT_COLD);
+}
+
+static void update_reboot(void)
+{
+	k_work_schedule_for_queue(&relay_workq_background, &reboot_work,
+				  K_MSEC(REBOOT_DELAY_MS));
+}
+
+static void update_send_status(const mouthware_message_FwUpdateStatus *status)
+{
+	mouthware_message_RelayToAppMessage *message = usb_cdc_message_reserve();
+
+	if (!message) {
+		return;
+	}
+
+	message->which_message_body = mouthware_message_RelayToAppMessage_fw_update_status_tag;
+	message->message_body.fw_update_status = *status;
+	usb_cdc_message_commit(message);
+}
+
+static void update_kick(void)
+{
+	k_work_submit_to_queue(&relay_workq_background, &process_work);
+}
+
+static void process_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	fw_update_process();
+}
+
+static const struct fw_update_ops ops = {
+	.begin = update_begin,
+	.write = update_write,
+	.finish = update_finish,
+	.abort = update_abort,
+	.reboot = update_reboot,
+	.send_status = update_send_status,
+	.kick = update_kick,
+};
+
+int relay_fw_update_init(void)
+{
+	k_work_init(&process_work, process_work_handler);
+	k_work_init_delayable(&reboot_work, reboot_work_handler);
+
+	/* A test upgrade reverts at the next reset unless confirmed; getting
+	 * this far in main() is the test
+	 */
+	if (!boot_is_img_confirmed()) {
+		int err = boot_write_img_confirmed();
+
+		if (err) {
+			LOG_ERR("Could not confirm the running image (err %d)", err);
+			return err;
+		}
+		LOG_INF("Running image confirmed");
+	}
+
+	fw_update_init(&ops);
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief MCUboot secondary slot writer for common/fw_update
+ *
+ * Chunks are written through flash_img with progressive erase from the
+ * background work queue, so the slot is erased a page at a time as the
+ * image arrives and the bridge keeps running. FwUpdateEnd checks the
+ * SHA-256 over the written bytes and requests a test upgrade; the new
+ * image confirms itself in relay_fw_update_init(), and MCUboot reverts to
+ * the old one if it never gets that far. Needs an MCUboot build
+ * (make MCUBOOT=1); the UF2 and Nordic DFU layouts have no secondary slot.
+ */
+
+#ifndef RELAY_FW_UPDATE_H_
+#define RELAY_FW_UPDATE_H_
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_FW_UPDATE)
+
+/**
+ * @brief Confirm the running image and install the fw_update hooks
+ *
+ * @return 0 on success, or a negative errno
+ */
+int relay_fw_update_init(void);
+
+#else
+
+static inline int relay_fw_update_init(void)
+{
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_RELAY_FW_UPDATE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_FW_UPDATE_H_ */
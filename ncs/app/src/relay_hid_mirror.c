@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "relay_hid_mirror.h"
+#include "hid_mirror.h"
+#include "relay_workq.h"
+#include "usb_cdc.h"
+#include "usb_hid.h"
+
+LOG_MODULE_REGISTER(relay_hid_mirror, LOG_LEVEL_INF);
+
+static void mirror_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(mirror_work, mirror_work_handler);
+
+/* Background work queue: the only consumer of the hid_mirror ring */
+static void mirror_work_handler(struct k_work *work)
+{
+	/* Only this handler touches it, so it need not sit on the queue's stack */
+	static mouthware_message_RelayToAppMessage message;
+
+	ARG_UNUSED(work);
+
+	message = (mouthware_message_RelayToAppMessage)mouthware_message_RelayToAppMessage_init_zero;
+	message.which_message_body = mouthware_message_RelayToAppMessage_hid_mirror_batch_tag;
+
+	/* The batch points into hid_mirror, so it is encoded straight into the
+	 * TX ring rather than queued. No one reads CDC0 while the host sleeps,
+	 * so those batches are only drained.
+	 */
+	while (hid_mirror_fill(&message.message_body.hid_mirror_batch)) {
+		if (!usb_hid_is_suspended()) {
+			usb_cdc_send_message(mouthware_message_RelayToAppMessage_fields, &message);
+		}
+	}
+
+	if (hid_mirror_enabled()) {
+		k_work_schedule_for_queue(&relay_workq_background, &mirror_work,
+					  K_MSEC(HID_MIRROR_FLUSH_MS));
+	}
+}
+
+void relay_hid_mirror_enable(bool enable)
+{
+	hid_mirror_set_enabled(enable);
+	LOG_INF("HID mirror %s", enable ? "enabled" : "disabled");
+
+	/* A last run after turning it off discards what is still buffered */
+	k_work_reschedule_for_queue(&relay_workq_background, &mirror_work,
+				    enable ? K_MSEC(HID_MIRROR_FLUSH_MS) : K_NO_WAIT);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief HID mirror stream to the host on CDC0
+ *
+ * ble_hid records every HID input report into common/hid_mirror while the
+ * host has the mirror on; this drains the records every
+ * HID_MIRROR_FLUSH_MS on the background work queue and sends them as
+ * HidMirrorBatch messages, so mirroring never holds up the HID path.
+ * Nothing is sent while the USB host is suspended.
+ */
+
+#ifndef RELAY_HID_MIRROR_H_
+#define RELAY_HID_MIRROR_H_
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Turn the mirror on or off, as asked by HidMirrorConfigWrite
+ *
+ * Safe from any thread.
+ */
+void relay_hid_mirror_enable(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_HID_MIRROR_H_ */
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include "relay_link_history.h"
+#include "link_history.h"
+#include "ble_central.h"
+#include "relay_persist.h"
+#include "relay_telemetry.h"
+#include "relay_workq.h"
+
+LOG_MODULE_REGISTER(relay_link_history, LOG_LEVEL_INF);
+
+#define SETTINGS_KEY "relay/history"
+
+/* Deferred write of the history (relay_persist.h) */
+static struct relay_persist history_persist;
+
+/* Loaded at init, then packed by the flush; both on relay_workq_background
+ * or before the sampling starts
+ */
+static uint8_t blob[LINK_HISTORY_BLOB_MAX];
+
+static void sample_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(sample_work, sample_work_handler);
+
+static void history_changed(void)
+{
+	relay_persist_request(&history_persist);
+}
+
+/* relay_workq_background, as the sampling */
+static void history_flush(void)
+{
+	size_t len = link_history_save(blob, sizeof(blob));
+	int err;
+
+	if (!IS_ENABLED(CONFIG_SETTINGS) || len == 0) {
+		return;
+	}
+
+	err = settings_save_one(SETTINGS_KEY, blob, len);
+	if (err) {
+		LOG_WRN("Failed to save the link history (err %d)", err);
+	}
+}
+
+static void sample_work_handler(struct k_work *work)
+{
+	struct link_telemetry_sample sample;
+	struct bt_conn *conn = ble_central_get_default_conn();
+	uint8_t addr[6];
+	bool have_addr = false;
+
+	ARG_UNUSED(work);
+
+	relay_telemetry_sample(&sample);
+	if (sample.connected && conn) {
+		const bt_addr_le_t *dst = bt_conn_get_dst(conn);
+
+		/* Most significant byte first, as printed */
+		for (size_t i = 0; i < sizeof(addr); i++) {
+			addr[i] = dst->a.val[sizeof(addr) - 1 - i];
+		}
+		have_addr = true;
+	}
+	link_history_sample(&sample, have_addr ? addr : NULL);
+
+	k_work_reschedule_for_queue(&relay_workq_background, &sample_work,
+				    K_MSEC(LINK_HISTORY_SAMPLE_MS));
+}
+
+int relay_link_history_init(void)
+{
+	link_history_init(history_changed);
+	relay_persist_init(&history_persist, history_flush);
+
+	if (IS_ENABLED(CONFIG_SETTINGS)) {
+		ssize_t len = settings_load_one(SETTINGS_KEY, blob, sizeof(blob));
+
+		if (len > 0 && link_history_load(blob, (size_t)len)) {
+			LOG_INF("Loaded %d byte link history", (int)len);
+		} else if (len > 0) {
+			LOG_WRN("Saved link history not recognized (%d bytes), dropped", (int)len);
+		}
+	}
+
+	k_work_schedule_for_queue(&relay_workq_background, &sample_work,
+				  K_MSEC(LINK_HISTORY_SAMPLE_MS));
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Hourly link history per MouthPad (common/link_history.h)
+ *
+ * The link is sampled on relay_workq_background every
+ * LINK_HISTORY_SAMPLE_MS, from the same counters as LinkTelemetry. The
+ * history is kept in settings under "relay/history" and written through
+ * relay_persist.h when a bucket closes and when the MouthPad drops. Read by
+ * the "history" shell command and LinkHistoryRead on CDC0.
+ */
+
+#ifndef RELAY_LINK_HISTORY_H_
+#define RELAY_LINK_HISTORY_H_
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_LINK_HISTORY)
+
+/**
+ * @brief Load the saved history and start sampling
+ *
+ * Call once, after the settings subsystem is up (ble_transport_init()).
+ *
+ * @return 0 on success, or a negative errno
+ */
+int relay_link_history_init(void);
+
+#else
+
+static inline int relay_link_history_init(void)
+{
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_RELAY_LINK_HISTORY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_LINK_HISTORY_H_ */
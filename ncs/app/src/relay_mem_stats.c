@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include "relay_mem_stats.h"
+#include "ble_nus_client.h"
+#include "usb_cdc.h"
+
+#if K_HEAP_MEM_POOL_SIZE > 0
+/* The heap behind k_malloc(); the kernel does not declare it publicly */
+extern struct k_heap _system_heap;
+#endif
+
+static void read_heap(struct mem_stats_heap *heap)
+{
+#if K_HEAP_MEM_POOL_SIZE > 0
+	struct sys_memory_stats stats;
+
+	if (sys_heap_runtime_stats_get(&_system_heap.heap, &stats) == 0) {
+		*heap = (struct mem_stats_heap){
+			.size = stats.free_bytes + stats.allocated_bytes,
+			.used = stats.allocated_bytes,
+			.max_used = stats.max_allocated_bytes,
+		};
+	}
+#else
+	ARG_UNUSED(heap);
+#endif
+}
+
+static void read_stack(const struct k_thread *thread, void *user_data)
+{
+	struct mem_stats_report *report = user_data;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+	char id[MEM_STATS_NAME_LEN];
+	size_t unused;
+
+	if (k_thread_stack_space_get(thread, &unused) != 0) {
+		return;
+	}
+
+	if (!name || name[0] == '\0') {
+		snprintk(id, sizeof(id), "%p", thread);
+		name = id;
+	}
+
+	mem_stats_add_stack(report, name, thread->stack_info.size, unused);
+}
+
+int relay_mem_stats_read(struct mem_stats_report *report)
+{
+	struct usb_cdc_tx_stats cdc;
+	struct mem_stats_site nus;
+
+	*report = (struct mem_stats_report){0};
+	read_heap(&report->heap);
+
+	usb_cdc_get_tx_stats(&cdc);
+	mem_stats_add_pool(report, &(struct mem_stats_pool){
+		.name = "cdc tx ring",
+		.unit = 1,
+		.size = cdc.capacity,
+		.used = cdc.used,
+		.max_used = cdc.high_water,
+		.failures = cdc.dropped,
+	});
+	mem_stats_add_pool(report, &(struct mem_stats_pool){
+		.name = "cdc msg slab",
+		.unit = cdc.msg_slot_size,
+		.size = cdc.msg_slots,
+		.used = cdc.msg_slots_used,
+		.max_used = cdc.msg_high_water,
+		.failures = cdc.msg_dropped,
+	});
+
+	/* The NUS slab keeps no peak of its own; its only site does */
+	mem_stats_site_get(MEM_SITE_NUS_TX, &nus);
+	mem_stats_add_pool(report, &(struct mem_stats_pool){
+		.name = "nus tx slab",
+		.unit = ble_nus_client_tx_slot_size(),
+		.size = ble_nus_client_tx_window(),
+		.used = ble_nus_client_tx_pending(),
+		.max_used = nus.peak,
+		.failures = nus.failures,
+	});
+
+	/* Unlocked: the stack scans would otherwise hold off interrupts */
+	k_thread_foreach_unlocked(read_stack, report);
+
+	return 0;
+}
+
+void relay_mem_stats_reset(void)
+{
+	usb_cdc_reset_tx_stats();
+	mem_stats_reset();
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Heap and buffer pool usage for common/mem_stats
+ *
+ * The heap figures come from the system heap behind k_malloc(), which only
+ * the Bluetooth and USB stacks draw on; the relay paths use the CDC0 TX
+ * rings and the async message and NUS write slabs listed as pools. Every
+ * thread's stack is listed with its high-water mark and checked against
+ * its budget. Read by the "mem" shell command and MemStatsRead on CDC0.
+ */
+
+#ifndef RELAY_MEM_STATS_H_
+#define RELAY_MEM_STATS_H_
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include "mem_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_MEM_STATS)
+
+/**
+ * @brief Fill in a report; takes the CDC0 TX lock and scans every thread
+ *        stack, so not from an ISR
+ *
+ * @return 0 on success, or a negative errno
+ */
+int relay_mem_stats_read(struct mem_stats_report *report);
+
+/**
+ * @brief Restart the pool peaks, refusal counts and site counters
+ */
+void relay_mem_stats_reset(void);
+
+#else
+
+static inline int relay_mem_stats_read(struct mem_stats_report *report)
+{
+	ARG_UNUSED(report);
+	return -ENOTSUP;
+}
+
+static inline void relay_mem_stats_reset(void)
+{
+}
+
+#endif /* CONFIG_RELAY_MEM_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_MEM_STATS_H_ */
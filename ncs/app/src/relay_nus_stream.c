@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "relay_nus_stream.h"
+#include "ble_transport.h"
+#include "ble_nus_client.h"
+#include "relay_workq.h"
+#include "usb_cdc.h"
+#include "nus_stream.h"
+
+LOG_MODULE_REGISTER(relay_nus_stream, LOG_LEVEL_INF);
+
+static struct k_work pump_work;
+
+static uint16_t stream_packet_size(void)
+{
+	return ble_transport_get_stream_write_len();
+}
+
+/* NUS write completed (BT RX thread or the real-time work queue) */
+static void stream_sent(uint8_t err, int64_t issued, int64_t completed)
+{
+	ARG_UNUSED(issued);
+	ARG_UNUSED(completed);
+
+	nus_stream_sent(err == 0);
+}
+
+static int stream_write(const uint8_t *data, size_t len)
+{
+	int err = ble_transport_send_nus_stream(data, len, stream_sent);
+
+	if (err == -ENOBUFS) {
+		return 1;
+	}
+	if (err) {
+		LOG_WRN("Stream write failed (err %d)", err);
+	}
+	return err;
+}
+
+static void stream_send_status(const mouthware_message_NusStreamStatus *status)
+{
+	mouthware_message_RelayToAppMessage *message = usb_cdc_message_reserve();
+
+	if (!message) {
+		return;
+	}
+
+	message->which_message_body = mouthware_message_RelayToAppMessage_nus_stream_status_tag;
+	message->message_body.nus_stream_status = *status;
+	usb_cdc_message_commit(message);
+}
+
+static void stream_kick(void)
+{
+	k_work_submit_to_queue(&relay_workq_realtime, &pump_work);
+}
+
+static void pump_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	nus_stream_pump();
+}
+
+static const struct nus_stream_ops ops = {
+	.packet_size = stream_packet_size,
+	.write = stream_write,
+	.send_status = stream_send_status,
+	.kick = stream_kick,
+};
+
+BUILD_ASSERT(NUS_STREAM_PACKET_MAX >= BLE_NUS_CLIENT_TX_MAX_LEN,
+	     "A full NUS write does not fit a stream packet");
+
+int relay_nus_stream_init(void)
+{
+	k_work_init(&pump_work, pump_work_handler);
+	nus_stream_init(&ops);
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief NUS writer for common/nus_stream
+ *
+ * The pump runs on the real-time work queue beside the NUS TX work, and
+ * cuts the stream into writes without response of the full ATT payload.
+ * Each write holds the link in the bulk profile (ble_conn_params.h) for the
+ * whole transfer: long connection events, extended while there is data, at
+ * the largest data length. 2M PHY is requested at connect.
+ */
+
+#ifndef RELAY_NUS_STREAM_H_
+#define RELAY_NUS_STREAM_H_
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_NUS_STREAM)
+
+/**
+ * @brief Install the nus_stream hooks
+ *
+ * @return 0 on success, or a negative errno
+ */
+int relay_nus_stream_init(void);
+
+#else
+
+static inline int relay_nus_stream_init(void)
+{
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_RELAY_NUS_STREAM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_NUS_STREAM_H_ */
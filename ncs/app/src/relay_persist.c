@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "relay_activity.h"
+#include "relay_persist.h"
+#include "relay_workq.h"
+
+LOG_MODULE_REGISTER(relay_persist, LOG_LEVEL_INF);
+
+#define DELAY_MS     CONFIG_RELAY_PERSIST_DELAY_MS
+#define MAX_DEFER_MS CONFIG_RELAY_PERSIST_MAX_DEFER_MS
+
+/* How often a held-back flush looks at the activity level again */
+#define RECHECK_MS 1000
+
+/* Flash erases stall the CPU and the radio scheduling, so wait until the
+ * user stops moving, but not forever
+ */
+static void persist_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct relay_persist *persist = CONTAINER_OF(dwork, struct relay_persist, work);
+	uint32_t waited = k_uptime_get_32() - persist->requested_ms;
+
+	if (relay_activity_level() == RELAY_ACTIVITY_ACTIVE && waited < MAX_DEFER_MS) {
+		k_work_reschedule_for_queue(&relay_workq_background, dwork,
+					    K_MSEC(MIN(RECHECK_MS, MAX_DEFER_MS - waited)));
+		return;
+	}
+
+	/* Cleared first so a change made during the flush asks again */
+	atomic_set(&persist->pending, 0);
+	LOG_DBG("Flushing after %u ms", waited);
+	persist->flush();
+}
+
+void relay_persist_init(struct relay_persist *persist, relay_persist_flush_t flush)
+{
+	k_work_init_delayable(&persist->work, persist_work_handler);
+	persist->flush = flush;
+	atomic_set(&persist->pending, 0);
+}
+
+void relay_persist_request(struct relay_persist *persist)
+{
+	if (!atomic_cas(&persist->pending, 0, 1)) {
+		return;
+	}
+
+	persist->requested_ms = k_uptime_get_32();
+	k_work_schedule_for_queue(&relay_workq_background, &persist->work, K_MSEC(DELAY_MS));
+}
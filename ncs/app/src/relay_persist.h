@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Deferred settings writes
+ *
+ * Modules keep their persistent state in RAM, compare against it, and only
+ * mark it dirty when something changed. relay_persist_request() then runs
+ * the module's flush function on relay_workq_background
+ * CONFIG_RELAY_PERSIST_DELAY_MS later, once the relay activity level has
+ * left active or CONFIG_RELAY_PERSIST_MAX_DEFER_MS have passed. Requests
+ * made while one is pending are coalesced into that single flush, so a
+ * connection setup costs at most one write per key and none when nothing
+ * changed.
+ */
+
+#ifndef RELAY_PERSIST_H_
+#define RELAY_PERSIST_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Runs on relay_workq_background; writes whatever is dirty */
+typedef void (*relay_persist_flush_t)(void);
+
+struct relay_persist {
+	struct k_work_delayable work;
+	relay_persist_flush_t flush;
+	atomic_t pending;
+	uint32_t requested_ms;
+};
+
+/**
+ * @brief Set up a deferred writer; call once during init
+ */
+void relay_persist_init(struct relay_persist *persist, relay_persist_flush_t flush);
+
+/**
+ * @brief Have the flush function run in the next quiet spell
+ *
+ * Safe from any thread. Does nothing while a flush is already pending.
+ */
+void relay_persist_request(struct relay_persist *persist);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_PERSIST_H_ */
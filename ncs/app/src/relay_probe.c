@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "relay_probe.h"
+
+LOG_MODULE_REGISTER(relay_probe, LOG_LEVEL_INF);
+
+#define PROBE_NODE DT_PATH(zephyr_user)
+
+BUILD_ASSERT(DT_NODE_HAS_PROP(PROBE_NODE, relay_probe_gpios),
+	     "CONFIG_RELAY_PROBE_GPIO needs relay-probe-gpios in zephyr,user (snippet probes)");
+
+#define PROBE_PIN(i) GPIO_DT_SPEC_GET_BY_IDX_OR(PROBE_NODE, relay_probe_gpios, i, {0})
+
+BUILD_ASSERT(RELAY_PROBE_COUNT == 5, "One PROBE_PIN() per probe");
+
+const struct gpio_dt_spec relay_probe_pins[RELAY_PROBE_COUNT] = {
+	PROBE_PIN(0), PROBE_PIN(1), PROBE_PIN(2), PROBE_PIN(3), PROBE_PIN(4),
+};
+
+static int relay_probe_init(void)
+{
+	for (int i = 0; i < RELAY_PROBE_COUNT; i++) {
+		const struct gpio_dt_spec *pin = &relay_probe_pins[i];
+		int err;
+
+		if (!pin->port) {
+			continue;
+		}
+		if (!gpio_is_ready_dt(pin)) {
+			LOG_ERR("Probe %d GPIO not ready", i);
+			continue;
+		}
+
+		err = gpio_pin_configure_dt(pin, GPIO_OUTPUT_INACTIVE);
+		if (err) {
+			LOG_ERR("Probe %d GPIO configure failed (err %d)", i, err);
+		}
+	}
+
+	LOG_INF("GPIO probes on");
+	return 0;
+}
+
+SYS_INIT(relay_probe_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief GPIO toggles at the relay hot paths, for external timing
+ *
+ * With the probes snippet (make PROBES=1) each point of
+ * common/relay_probes.h toggles the pin at the same index of the
+ * relay-probe-gpios property of the zephyr,user devicetree node; points
+ * past the end of the list have no pin. Without it they compile to
+ * nothing.
+ */
+
+#ifndef RELAY_PROBE_H_
+#define RELAY_PROBE_H_
+
+#include <zephyr/kernel.h>
+
+#include "relay_probes.h"
+
+#if defined(CONFIG_RELAY_PROBE_GPIO)
+#include <zephyr/drivers/gpio.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_PROBE_GPIO)
+
+extern const struct gpio_dt_spec relay_probe_pins[RELAY_PROBE_COUNT];
+
+static inline void relay_probe(enum relay_probe probe)
+{
+	const struct gpio_dt_spec *pin = &relay_probe_pins[probe];
+
+	if (pin->port) {
+		gpio_pin_toggle_dt(pin);
+	}
+}
+
+#else
+
+static inline void relay_probe(enum relay_probe probe)
+{
+	ARG_UNUSED(probe);
+}
+
+#endif /* CONFIG_RELAY_PROBE_GPIO */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_PROBE_H_ */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Data path counters in the log, for simulation runs
+ *
+ * Under BabbleSim there is no host to send RelayStatsRead or type "stats",
+ * so the relay's side of a run against ncs/sim/mouthpad_peer is read from
+ * the log instead. Each interval in which a counter moved logs one
+ * "METRIC relay" line with the totals, the NUS RX rate over the interval
+ * and the link parameters. Connection phase timings are already logged on
+ * every connection (see ble_transport.c).
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+#include "ble_transport.h"
+#include "relay_stats.h"
+#include "relay_workq.h"
+#include "usb_cdc.h"
+
+LOG_MODULE_REGISTER(relay_sim_report, LOG_LEVEL_INF);
+
+static void report_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(report_work, report_work_handler);
+
+static struct relay_stats_snapshot last_hid;
+static struct relay_stats_snapshot last_nus_rx;
+
+static void report_work_handler(struct k_work *work)
+{
+	struct relay_stats_snapshot hid;
+	struct relay_stats_snapshot nus_rx;
+	struct ble_transport_link_info link = {0};
+	struct usb_cdc_tx_stats cdc;
+
+	ARG_UNUSED(work);
+
+	relay_stats_get(RELAY_STATS_HID, &hid);
+	relay_stats_get(RELAY_STATS_NUS_RX, &nus_rx);
+
+	if (hid.packets != last_hid.packets || nus_rx.packets != last_nus_rx.packets) {
+		uint32_t nus_bytes = nus_rx.bytes - last_nus_rx.bytes;
+
+		ble_transport_get_link_info(&link);
+		usb_cdc_get_tx_stats(&cdc);
+
+		LOG_INF("METRIC relay hid=%u hid_dropped=%u nus_rx=%u nus_rx_bytes=%u "
+			"nus_rx_bps=%u nus_rx_dropped=%u cdc_dropped=%u interval_us=%u phy=%u/%u",
+			hid.packets, hid.dropped, nus_rx.packets, nus_rx.bytes,
+			(uint32_t)((uint64_t)nus_bytes * 8 * MSEC_PER_SEC /
+				   CONFIG_RELAY_SIM_REPORT_INTERVAL_MS),
+			nus_rx.dropped, cdc.dropped, link.interval_us, link.tx_phy, link.rx_phy);
+
+		last_hid = hid;
+		last_nus_rx = nus_rx;
+	}
+
+	k_work_schedule_for_queue(&relay_workq_background, &report_work,
+				  K_MSEC(CONFIG_RELAY_SIM_REPORT_INTERVAL_MS));
+}
+
+static int relay_sim_report_init(void)
+{
+	k_work_schedule_for_queue(&relay_workq_background, &report_work,
+				  K_MSEC(CONFIG_RELAY_SIM_REPORT_INTERVAL_MS));
+	return 0;
+}
+
+SYS_INIT(relay_sim_report_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
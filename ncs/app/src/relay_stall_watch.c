@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <string.h>
+
+#include "relay_stall_watch.h"
+#include "ble_nus_client.h"
+#include "relay_activity.h"
+#include "relay_bus.h"
+#include "relay_dispatch.h"
+#include "relay_workq.h"
+#include "usb_cdc.h"
+
+LOG_MODULE_REGISTER(relay_stall_watch, LOG_LEVEL_INF);
+
+#define STALL_WATCH_THREAD_STACK_SIZE 1024
+#define STALL_WATCH_THREAD_PRIORITY   0
+
+enum {
+	SOURCE_PIPELINE = STALL_SOURCE_PIPELINE,
+	SOURCE_WATCH,
+	SOURCE_REALTIME,
+	SOURCE_PROTOCOL,
+	SOURCE_BACKGROUND,
+	SOURCE_SYSTEM,
+	SOURCE_COUNT,
+};
+
+BUILD_ASSERT(SOURCE_COUNT <= STALL_WATCH_SOURCES_MAX);
+
+static const char *const source_names[SOURCE_COUNT] = {
+	[SOURCE_PIPELINE] = "hid pipeline",
+	[SOURCE_WATCH] = "watch thread",
+	[SOURCE_REALTIME] = "realtime wq",
+	[SOURCE_PROTOCOL] = "protocol wq",
+	[SOURCE_BACKGROUND] = "background wq",
+	[SOURCE_SYSTEM] = "system wq",
+};
+
+struct probe {
+	struct k_work work;
+	struct k_work_q *queue;
+	uint8_t source;
+};
+
+static struct probe probes[] = {
+	{ .queue = &relay_workq_realtime, .source = SOURCE_REALTIME },
+	{ .queue = &relay_workq_protocol, .source = SOURCE_PROTOCOL },
+	{ .queue = &relay_workq_background, .source = SOURCE_BACKGROUND },
+	{ .queue = &k_sys_work_q, .source = SOURCE_SYSTEM },
+};
+
+static __noinit struct stall_snapshot snapshot_retained;
+
+static atomic_t watching;
+static K_SEM_DEFINE(watch_wake, 0, 1);
+
+static uint32_t uptime_us(void)
+{
+	return relay_time_us32();
+}
+
+static uint32_t uptime_ms(void)
+{
+	return k_uptime_get_32();
+}
+
+static void probe_handler(struct k_work *work)
+{
+	struct probe *probe = CONTAINER_OF(work, struct probe, work);
+
+	stall_watch_probe_done(probe->source);
+}
+
+static uint8_t thread_state(const struct k_thread *thread)
+{
+	uint8_t state = thread->base.thread_state;
+
+	if (thread == k_current_get()) {
+		return STALL_THREAD_RUNNING;
+	}
+	if (state & _THREAD_SUSPENDED) {
+		return STALL_THREAD_SUSPENDED;
+	}
+	if (state & (_THREAD_PENDING | _THREAD_SLEEPING)) {
+		return STALL_THREAD_BLOCKED;
+	}
+	if (state & _THREAD_QUEUED) {
+		return STALL_THREAD_READY;
+	}
+	return STALL_THREAD_OTHER;
+}
+
+static void capture_thread(const struct k_thread *thread, void *user_data)
+{
+	struct stall_snapshot *snapshot = user_data;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+
+	if (snapshot->thread_count >= STALL_WATCH_THREADS_MAX) {
+		return;
+	}
+
+	struct stall_thread *entry = &snapshot->threads[snapshot->thread_count++];
+
+	if (name && name[0] != '\0') {
+		strncpy(entry->name, name, sizeof(entry->name) - 1);
+		entry->name[sizeof(entry->name) - 1] = '\0';
+	} else {
+		snprintk(entry->name, sizeof(entry->name), "%p", thread);
+	}
+	entry->priority = (int8_t)thread->base.prio;
+	entry->state = thread_state(thread);
+}
+
+/* Only counters that are read without a lock: a stalled thread may hold one */
+static void capture(struct stall_snapshot *snapshot)
+{
+	snapshot->queue_depth[TRACE_QUEUE_CDC_TX] = MIN(usb_cdc_tx_queued(), UINT16_MAX);
+	snapshot->queue_depth[TRACE_QUEUE_CDC_ASYNC] = usb_cdc_async_queued();
+	snapshot->queue_depth[TRACE_QUEUE_PROTOCOL] = relay_dispatch_queued();
+	snapshot->queue_depth[TRACE_QUEUE_NUS_TX] = ble_nus_client_tx_pending();
+
+	k_thread_foreach_unlocked(capture_thread, snapshot);
+}
+
+static void activity_changed(const struct zbus_channel *chan)
+{
+	const struct relay_activity_msg *msg = zbus_chan_const_msg(chan);
+	bool active = msg->level == RELAY_ACTIVITY_ACTIVE;
+
+	if (atomic_set(&watching, active) != active && active) {
+		k_sem_give(&watch_wake);
+	}
+}
+
+ZBUS_LISTENER_DEFINE(stall_watch_activity, activity_changed);
+ZBUS_CHAN_ADD_OBS(relay_chan_activity, stall_watch_activity, RELAY_BUS_PRIO_STATE);
+
+static void watch_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	const int64_t period = k_ms_to_ticks_ceil64(CONFIG_RELAY_STALL_WATCH_PERIOD_MS);
+	int64_t next = k_uptime_ticks();
+
+	for (;;) {
+		/* Nothing to watch while the user is idle; saves the wakeups */
+		if (!atomic_get(&watching)) {
+			k_sem_take(&watch_wake, K_FOREVER);
+			next = k_uptime_ticks();
+		}
+
+		next += period;
+		k_sleep(K_TIMEOUT_ABS_TICKS(next));
+
+		int64_t late = k_uptime_ticks() - next;
+
+		stall_watch_sample(SOURCE_WATCH, late > 0 ? k_ticks_to_us_floor32(late) : 0);
+
+		for (size_t i = 0; i < ARRAY_SIZE(probes); i++) {
+			if (stall_watch_probe_start(probes[i].source) &&
+			    k_work_submit_to_queue(probes[i].queue, &probes[i].work) < 0) {
+				/* Queue draining; do not leave the probe outstanding */
+				stall_watch_probe_done(probes[i].source);
+			}
+		}
+
+		stall_watch_check();
+	}
+}
+
+K_THREAD_DEFINE(stall_watch_tid, STALL_WATCH_THREAD_STACK_SIZE, watch_thread, NULL, NULL, NULL,
+		STALL_WATCH_THREAD_PRIORITY, 0, K_TICKS_FOREVER);
+
+void relay_stall_watch_init(bool keep)
+{
+	stall_watch_init(&snapshot_retained, keep, &(struct stall_watch_config){
+		.source_names = source_names,
+		.source_count = SOURCE_COUNT,
+		.threshold_us = CONFIG_RELAY_STALL_WATCH_THRESHOLD_MS * USEC_PER_MSEC,
+		.now_us = uptime_us,
+		.now_ms = uptime_ms,
+		.capture = capture,
+	});
+
+	for (size_t i = 0; i < ARRAY_SIZE(probes); i++) {
+		k_work_init(&probes[i].work, probe_handler);
+	}
+
+	atomic_set(&watching, relay_activity_level() == RELAY_ACTIVITY_ACTIVE);
+
+	k_thread_start(stall_watch_tid);
+}
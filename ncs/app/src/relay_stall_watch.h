@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Latency spike watchdog on Zephyr (see common/stall_watch.h)
+ *
+ * A watch thread at the highest preemptible priority wakes every
+ * CONFIG_RELAY_STALL_WATCH_PERIOD_MS while the user is active and probes
+ * the three relay work queues and the system work queue. Its own lateness
+ * shows cooperative threads and interrupts holding the CPU. HOGP
+ * notifications are timed from arrival to USB submission by the caller.
+ */
+
+#ifndef RELAY_STALL_WATCH_H_
+#define RELAY_STALL_WATCH_H_
+
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#include "relay_time.h"
+#include "stall_watch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_STALL_WATCH)
+
+/**
+ * @brief Adopt the retained snapshot and start watching
+ *
+ * @param keep What trace_ring_init() returned
+ */
+void relay_stall_watch_init(bool keep);
+
+/**
+ * @brief Stamp a HOGP notification on arrival
+ */
+static inline uint32_t relay_stall_watch_start(void)
+{
+	return relay_time_now32();
+}
+
+/**
+ * @brief Note a report handed to USB
+ *
+ * @param start What relay_stall_watch_start() returned for it
+ */
+static inline void relay_stall_watch_pipeline(uint32_t start)
+{
+	stall_watch_sample(STALL_SOURCE_PIPELINE, relay_time_since_us(start));
+}
+
+#else
+
+static inline void relay_stall_watch_init(bool keep)
+{
+	ARG_UNUSED(keep);
+}
+
+static inline uint32_t relay_stall_watch_start(void)
+{
+	return 0;
+}
+
+static inline void relay_stall_watch_pipeline(uint32_t start)
+{
+	ARG_UNUSED(start);
+}
+
+#endif /* CONFIG_RELAY_STALL_WATCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_STALL_WATCH_H_ */
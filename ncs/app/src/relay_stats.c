@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief NUS/HID data path counters
+ *
+ * Counters are plain atomics so the BT RX thread, the work queues
+ * and the CDC threads can all count without a lock. Per-packet logging is
+ * replaced by these counters; it can still be turned on at runtime with
+ * "stats trace on" when the individual packets matter.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "relay_stats.h"
+#include "trace_ring.h"
+
+BUILD_ASSERT(RELAY_STATS_NUS_RX == (int)TRACE_PATH_NUS_RX &&
+		     RELAY_STATS_NUS_TX == (int)TRACE_PATH_NUS_TX &&
+		     RELAY_STATS_HID == (int)TRACE_PATH_HID,
+	     "Trace drop records use the relay_stats path numbers");
+
+static atomic_t counters[RELAY_STATS_PATH_COUNT][RELAY_STATS_COUNTER_COUNT];
+static atomic_t trace_enabled;
+
+void relay_stats_add(enum relay_stats_path path, enum relay_stats_counter counter, uint32_t n)
+{
+	if (path >= RELAY_STATS_PATH_COUNT || counter >= RELAY_STATS_COUNTER_COUNT) {
+		return;
+	}
+
+	atomic_add(&counters[path][counter], (atomic_val_t)n);
+	if (counter == RELAY_STATS_DROPPED) {
+		trace_ring_count(TRACE_EVENT_DROP, path);
+	}
+}
+
+void relay_stats_get(enum relay_stats_path path, struct relay_stats_snapshot *snapshot)
+{
+	if (path >= RELAY_STATS_PATH_COUNT) {
+		*snapshot = (struct relay_stats_snapshot){0};
+		return;
+	}
+
+	atomic_t *c = counters[path];
+
+	snapshot->packets = (uint32_t)atomic_get(&c[RELAY_STATS_PACKETS]);
+	snapshot->bytes = (uint32_t)atomic_get(&c[RELAY_STATS_BYTES]);
+	snapshot->echo_filtered = (uint32_t)atomic_get(&c[RELAY_STATS_ECHO_FILTERED]);
+	snapshot->dropped = (uint32_t)atomic_get(&c[RELAY_STATS_DROPPED]);
+	snapshot->bridged = (uint32_t)atomic_get(&c[RELAY_STATS_BRIDGED]);
+}
+
+void relay_stats_reset(void)
+{
+	for (int path = 0; path < RELAY_STATS_PATH_COUNT; path++) {
+		for (int counter = 0; counter < RELAY_STATS_COUNTER_COUNT; counter++) {
+			atomic_clear(&counters[path][counter]);
+		}
+	}
+}
+
+void relay_stats_set_trace(bool enable)
+{
+	atomic_set(&trace_enabled, enable ? 1 : 0);
+}
+
+bool relay_stats_trace_enabled(void)
+{
+	return atomic_get(&trace_enabled) != 0;
+}
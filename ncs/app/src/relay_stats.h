@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RELAY_STATS_H_
+#define RELAY_STATS_H_
+
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Data paths through the relay
+ */
+enum relay_stats_path {
+	RELAY_STATS_NUS_RX, /**< MouthPad NUS notifications to CDC0 */
+	RELAY_STATS_NUS_TX, /**< CDC0 pass-through writes to the MouthPad */
+	RELAY_STATS_HID,    /**< MouthPad HOGP reports to USB HID */
+	RELAY_STATS_PATH_COUNT,
+};
+
+/**
+ * @brief Counters kept per data path
+ */
+enum relay_stats_counter {
+	RELAY_STATS_PACKETS,       /**< Packets entering the path */
+	RELAY_STATS_BYTES,         /**< Payload bytes entering the path */
+	RELAY_STATS_ECHO_FILTERED, /**< Packets discarded as echoes */
+	RELAY_STATS_DROPPED,       /**< Packets lost to errors or an unready link */
+	RELAY_STATS_BRIDGED,       /**< Packets delivered to the other side */
+	RELAY_STATS_COUNTER_COUNT,
+};
+
+/**
+ * @brief Snapshot of one path's counters
+ */
+struct relay_stats_snapshot {
+	uint32_t packets;
+	uint32_t bytes;
+	uint32_t echo_filtered;
+	uint32_t dropped;
+	uint32_t bridged;
+};
+
+/**
+ * @brief Add to a counter; safe from any context
+ *
+ * @param path Data path
+ * @param counter Counter on that path
+ * @param n Amount to add
+ */
+void relay_stats_add(enum relay_stats_path path, enum relay_stats_counter counter, uint32_t n);
+
+/**
+ * @brief Count one packet of len bytes entering a path
+ */
+static inline void relay_stats_packet(enum relay_stats_path path, uint16_t len)
+{
+	relay_stats_add(path, RELAY_STATS_PACKETS, 1);
+	relay_stats_add(path, RELAY_STATS_BYTES, len);
+}
+
+/**
+ * @brief Read one path's counters
+ *
+ * @param path Data path
+ * @param snapshot Output counters
+ */
+void relay_stats_get(enum relay_stats_path path, struct relay_stats_snapshot *snapshot);
+
+/**
+ * @brief Clear every counter
+ */
+void relay_stats_reset(void);
+
+/**
+ * @brief Enable or disable per-packet trace logging (off at boot)
+ */
+void relay_stats_set_trace(bool enable);
+
+/**
+ * @brief Whether per-packet trace logging is enabled
+ */
+bool relay_stats_trace_enabled(void);
+
+/**
+ * @brief LOG_INF in the calling module, only while tracing is enabled
+ */
+#define RELAY_TRACE(...)                                                                           \
+	do {                                                                                       \
+		if (relay_stats_trace_enabled()) {                                                 \
+			LOG_INF(__VA_ARGS__);                                                      \
+		}                                                                                  \
+	} while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_STATS_H_ */
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "ble_central.h"
+#include "ble_dis.h"
+#include "ble_discovery.h"
+#include "mouthpad_crc16.h"
+#include "relay_persist.h"
+#include "relay_store.h"
+
+LOG_MODULE_REGISTER(relay_store, LOG_LEVEL_INF);
+
+#define HEADER_LEN         6
+#define SECTION_HEADER_LEN 3
+
+/* Four bonds with full names, Device Information and handles fit */
+#define RECORD_MAX 2048
+
+/* Keys deleted per legacy subtree at most; there are fewer */
+#define LEGACY_KEYS_MAX 16
+#define LEGACY_NAME_MAX 48
+
+struct section {
+	uint8_t id;
+	/* Pack the module's table into buf; returns bytes used, 0 for none */
+	size_t (*save)(uint8_t *buf, size_t size);
+	/* Unpack what save wrote */
+	void (*load)(const uint8_t *buf, size_t len);
+};
+
+static const struct section sections[] = {
+	{RELAY_STORE_BONDS, ble_central_store_save, ble_central_store_load},
+	{RELAY_STORE_DIS, ble_dis_store_save, ble_dis_store_load},
+	{RELAY_STORE_GATT, ble_discovery_store_save, ble_discovery_store_load},
+};
+
+/* Where older firmware kept the same data, a key per entry */
+static const char *const legacy_subtrees[] = {"ble_central", "ble_dis", "ble_gatt"};
+
+static struct relay_persist store_persist;
+
+/* Read into at boot; after that only the flush on relay_workq_background
+ * uses it
+ */
+static uint8_t record[RECORD_MAX];
+
+/* The record in flash, so an identical one is not written again */
+static size_t stored_len;
+static uint16_t stored_crc;
+
+/* Migrated from the per-key entries; delete them once the record is written */
+static bool legacy_pending;
+
+static size_t pack(void)
+{
+	size_t len = HEADER_LEN;
+
+	for (size_t i = 0; i < ARRAY_SIZE(sections); i++) {
+		size_t used;
+
+		if (RECORD_MAX - len <= SECTION_HEADER_LEN) {
+			LOG_WRN("Record full, section %u not saved", sections[i].id);
+			break;
+		}
+		used = sections[i].save(&record[len + SECTION_HEADER_LEN],
+					RECORD_MAX - len - SECTION_HEADER_LEN);
+		if (used == 0) {
+			continue;
+		}
+		record[len] = sections[i].id;
+		sys_put_le16((uint16_t)used, &record[len + 1]);
+		len += SECTION_HEADER_LEN + used;
+	}
+
+	record[0] = RELAY_STORE_VERSION;
+	record[1] = 0;
+	sys_put_le16((uint16_t)(len - HEADER_LEN), &record[2]);
+	sys_put_le16(mouthpad_crc16(&record[HEADER_LEN], len - HEADER_LEN), &record[4]);
+	return len;
+}
+
+/* Header, CRC and section lengths all check out */
+static bool record_valid(size_t len)
+{
+	size_t pos = HEADER_LEN;
+
+	if (len < HEADER_LEN || record[0] != RELAY_STORE_VERSION ||
+	    HEADER_LEN + sys_get_le16(&record[2]) != len ||
+	    sys_get_le16(&record[4]) != mouthpad_crc16(&record[HEADER_LEN], len - HEADER_LEN)) {
+		return false;
+	}
+
+	while (pos < len) {
+		if (len - pos < SECTION_HEADER_LEN) {
+			return false;
+		}
+		pos += SECTION_HEADER_LEN + sys_get_le16(&record[pos + 1]);
+	}
+	return pos == len;
+}
+
+static void unpack(size_t len)
+{
+	size_t pos = HEADER_LEN;
+
+	while (pos < len) {
+		uint8_t id = record[pos];
+		size_t size = sys_get_le16(&record[pos + 1]);
+
+		pos += SECTION_HEADER_LEN;
+		/* Sections of a newer layout are skipped */
+		for (size_t i = 0; i < ARRAY_SIZE(sections); i++) {
+			if (sections[i].id == id) {
+				sections[i].load(&record[pos], size);
+				break;
+			}
+		}
+		pos += size;
+	}
+}
+
+static int find_legacy_key(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg,
+			   void *param)
+{
+	char *name = param;
+
+	ARG_UNUSED(len);
+	ARG_UNUSED(read_cb);
+	ARG_UNUSED(cb_arg);
+
+	if (!key) {
+		return 0;
+	}
+	snprintf(name, LEGACY_NAME_MAX, "%s", key);
+
+	/* One at a time: the backend is not walked while deleting */
+	return 1;
+}
+
+static void delete_legacy(void)
+{
+	char name[LEGACY_NAME_MAX];
+	char key[64];
+	int deleted = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(legacy_subtrees); i++) {
+		for (int n = 0; n < LEGACY_KEYS_MAX; n++) {
+			name[0] = '\0';
+			settings_load_subtree_direct(legacy_subtrees[i], find_legacy_key, name);
+			if (name[0] == '\0') {
+				break;
+			}
+			snprintf(key, sizeof(key), "%s/%s", legacy_subtrees[i], name);
+			if (settings_delete(key) != 0) {
+				break;
+			}
+			deleted++;
+		}
+	}
+
+	LOG_INF("Deleted %d per-key entries", deleted);
+}
+
+/* relay_persist flush: pack every section, write if anything changed */
+static void store_flush(void)
+{
+	size_t len = pack();
+	uint16_t crc = sys_get_le16(&record[4]);
+	int err;
+
+	if (len == stored_len && crc == stored_crc) {
+		LOG_DBG("Record unchanged");
+		return;
+	}
+
+	err = settings_save_one(RELAY_STORE_KEY, record, len);
+	if (err) {
+		LOG_ERR("Failed to save the record (err %d)", err);
+		return;
+	}
+	stored_len = len;
+	stored_crc = crc;
+	LOG_INF("Saved %u byte record", (unsigned int)len);
+
+	if (legacy_pending) {
+		legacy_pending = false;
+		delete_legacy();
+	}
+}
+
+void relay_store_load(void)
+{
+	ssize_t len;
+
+	relay_persist_init(&store_persist, store_flush);
+	if (!IS_ENABLED(CONFIG_SETTINGS)) {
+		return;
+	}
+
+	len = settings_load_one(RELAY_STORE_KEY, record, sizeof(record));
+	if (len > 0 && record_valid((size_t)len)) {
+		stored_len = (size_t)len;
+		stored_crc = sys_get_le16(&record[4]);
+		unpack((size_t)len);
+		LOG_INF("Loaded %d byte record", (int)len);
+		return;
+	}
+	if (len > 0) {
+		LOG_WRN("Record not valid (%d bytes), dropped", (int)len);
+	}
+
+	/* Older firmware, or no record yet: take what the per-key entries hold
+	 * and write it as a record
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(legacy_subtrees); i++) {
+		settings_load_subtree(legacy_subtrees[i]);
+	}
+	legacy_pending = true;
+	relay_store_request();
+}
+
+void relay_store_request(void)
+{
+	if (IS_ENABLED(CONFIG_SETTINGS)) {
+		relay_persist_request(&store_persist);
+	}
+}
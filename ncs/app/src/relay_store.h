@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief The relay's own persistent data as one settings record
+ *
+ * The bond slots and their names (ble_central), the Device Information
+ * cache (ble_dis) and the GATT handle cache (ble_discovery) are sections
+ * of a single record under RELAY_STORE_KEY. Boot reads it with one
+ * settings_load_one() and checks its CRC before any section is handed
+ * over, instead of a full settings_load() dispatching a key per slot,
+ * name and cache entry:
+ *
+ *   version   1 byte, RELAY_STORE_VERSION
+ *   reserved  1 byte, 0
+ *   length    2 bytes LE, of the sections that follow
+ *   crc       2 bytes LE, CRC-16/CCITT-FALSE of the sections
+ *   section   id 1 byte, length 2 bytes LE, then that many bytes; repeated
+ *
+ * Each module packs its section from its RAM table and unpacks it at boot.
+ * A change calls relay_store_request(); the deferred flush (relay_persist.h)
+ * packs every section again and writes the record only if it differs from
+ * the one in flash, so a connection setup that touches all three tables
+ * costs one write.
+ *
+ * A record that is missing, of another version or fails its CRC is
+ * dropped. The per-key entries older firmware wrote are then read once
+ * through their settings handlers, written back as a record and deleted.
+ */
+
+#ifndef RELAY_STORE_H_
+#define RELAY_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RELAY_STORE_KEY     "relay/store"
+#define RELAY_STORE_VERSION 1
+
+enum relay_store_section_id {
+	RELAY_STORE_BONDS = 1, /* Bond slots and names */
+	RELAY_STORE_DIS = 2,   /* Device Information per bonded MouthPad */
+	RELAY_STORE_GATT = 3,  /* Discovered handles per bonded MouthPad */
+};
+
+/**
+ * @brief Read the record and hand each section to its module
+ *
+ * Call once from ble_central_init(), after the Bluetooth stack's own
+ * settings are loaded and before the bonds are enumerated.
+ */
+void relay_store_load(void);
+
+/**
+ * @brief A section changed; have the record written in the next quiet spell
+ *
+ * Safe from any thread. Requests made while one is pending are coalesced.
+ */
+void relay_store_request(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_STORE_H_ */
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include "relay_sysview.h"
+
+/* Called by SystemView each time a recording starts, so the marker names
+ * reach the host whenever it attaches
+ */
+static void send_marker_names(void)
+{
+	for (int i = 0; i < RELAY_MARKER_COUNT; i++) {
+		SEGGER_SYSVIEW_NameMarker(i, relay_marker_name(i));
+	}
+}
+
+static SEGGER_SYSVIEW_MODULE relay_module = {
+	.sModule = "M=MouthPadRelay",
+	.NumEvents = 0,
+	.pfSendModuleDesc = send_marker_names,
+};
+
+static int relay_sysview_init(void)
+{
+	SEGGER_SYSVIEW_RegisterModule(&relay_module);
+	return 0;
+}
+
+/* Zephyr starts SystemView before the application level */
+SYS_INIT(relay_sysview_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief SystemView markers around the relay hot paths
+ *
+ * With the sysview snippet (make SYSVIEW=1) Zephyr records thread switches,
+ * ISRs and kernel calls over RTT, and these markers add spans for the
+ * relay's own work (see common/relay_markers.h). Without it they compile
+ * to nothing.
+ */
+
+#ifndef RELAY_SYSVIEW_H_
+#define RELAY_SYSVIEW_H_
+
+#include <zephyr/kernel.h>
+
+#include "relay_markers.h"
+
+#if defined(CONFIG_RELAY_SYSVIEW)
+#include <SEGGER_SYSVIEW.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_SYSVIEW)
+
+static inline void relay_sysview_mark_start(enum relay_marker marker)
+{
+	SEGGER_SYSVIEW_MarkStart(marker);
+}
+
+static inline void relay_sysview_mark_stop(enum relay_marker marker)
+{
+	SEGGER_SYSVIEW_MarkStop(marker);
+}
+
+#else
+
+static inline void relay_sysview_mark_start(enum relay_marker marker)
+{
+	ARG_UNUSED(marker);
+}
+
+static inline void relay_sysview_mark_stop(enum relay_marker marker)
+{
+	ARG_UNUSED(marker);
+}
+
+#endif /* CONFIG_RELAY_SYSVIEW */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_SYSVIEW_H_ */
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "relay_telemetry.h"
+#include "link_telemetry.h"
+#include "link_state.h"
+#include "ble_transport.h"
+#include "relay_stats.h"
+#include "relay_workq.h"
+#include "stall_watch.h"
+#include "usb_cdc.h"
+#include "usb_hid.h"
+#include "usb_phase.h"
+
+LOG_MODULE_REGISTER(relay_telemetry, LOG_LEVEL_INF);
+
+/* Latest request from the CDC RX thread, applied on the work queue */
+static struct k_spinlock request_lock;
+static mouthware_message_LinkTelemetrySubscribe request;
+static bool request_pending;
+
+static void telemetry_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(telemetry_work, telemetry_work_handler);
+
+void relay_telemetry_sample(struct link_telemetry_sample *sample)
+{
+	struct relay_stats_snapshot hid;
+	struct relay_stats_snapshot nus_rx;
+	struct relay_stats_snapshot nus_tx;
+	struct ble_transport_link_info link;
+	struct usb_cdc_tx_stats cdc;
+	struct stall_watch_stats stalls;
+	struct usb_phase_stats usb;
+	struct link_state link_now;
+
+	link_state_get(&link_now);
+	relay_stats_get(RELAY_STATS_HID, &hid);
+	relay_stats_get(RELAY_STATS_NUS_RX, &nus_rx);
+	relay_stats_get(RELAY_STATS_NUS_TX, &nus_tx);
+	ble_transport_get_link_info(&link);
+	usb_cdc_get_tx_stats(&cdc);
+	stall_watch_get(&stalls);
+	usb_phase_get(&usb);
+
+	*sample = (struct link_telemetry_sample){
+		.now_ms = k_uptime_get_32(),
+		.connected = link_now.phase == LINK_STATE_CONNECTED,
+		.rssi = link_state_is_up(&link_now) ? link_now.rssi : 0,
+		.battery_level = link_now.battery_level,
+		.conn_interval_us = link.interval_us,
+		.tx_phy = link.tx_phy,
+		.rx_phy = link.rx_phy,
+		.hid_reports = hid.packets,
+		.hid_dropped = hid.dropped,
+		.nus_rx_dropped = nus_rx.dropped,
+		.nus_tx_dropped = nus_tx.dropped,
+		.nus_tx_queued = ble_transport_get_nus_tx_pending(),
+		.cdc_tx_queued = cdc.used,
+		.stalls = stalls.stalls,
+		.worst_stall_us = stalls.worst_us,
+		.usb_reports = usb.reports,
+		.usb_phase_sum_us = usb.phase_sum_us,
+		.usb_waits = usb.waits,
+		.usb_wait_sum_us = usb.wait_sum_us,
+	};
+	sensor_stream_sequence_total(&sample->nus_seq);
+}
+
+/* Background work queue: the only context that touches link_telemetry */
+static void telemetry_work_handler(struct k_work *work)
+{
+	mouthware_message_LinkTelemetrySubscribe req;
+	bool pending;
+
+	ARG_UNUSED(work);
+
+	K_SPINLOCK(&request_lock) {
+		pending = request_pending;
+		req = request;
+		request_pending = false;
+	}
+
+	if (pending) {
+		uint32_t interval = link_telemetry_subscribe(&req);
+
+		if (interval) {
+			LOG_INF("Link telemetry every %u ms%s", interval,
+				req.on_change ? " on change" : "");
+		} else {
+			LOG_INF("Link telemetry stopped");
+		}
+	}
+
+	uint32_t interval = link_telemetry_interval_ms();
+
+	if (interval == 0) {
+		return;
+	}
+
+	/* No one reads CDC0 while the host sleeps; sampling picks up on resume */
+	if (!usb_hid_is_suspended()) {
+		mouthware_message_RelayToAppMessage *message = usb_cdc_message_reserve();
+
+		if (message) {
+			struct link_telemetry_sample sample;
+
+			relay_telemetry_sample(&sample);
+			if (link_telemetry_fill(&sample, &message->message_body.link_telemetry)) {
+				message->which_message_body =
+					mouthware_message_RelayToAppMessage_link_telemetry_tag;
+				usb_cdc_message_commit(message);
+			} else {
+				usb_cdc_message_abort(message);
+			}
+		}
+	}
+
+	k_work_reschedule_for_queue(&relay_workq_background, &telemetry_work, K_MSEC(interval));
+}
+
+void relay_telemetry_subscribe(const mouthware_message_LinkTelemetrySubscribe *req)
+{
+	K_SPINLOCK(&request_lock) {
+		request = *req;
+		request_pending = true;
+	}
+
+	k_work_reschedule_for_queue(&relay_workq_background, &telemetry_work, K_NO_WAIT);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief LinkTelemetry stream to the host on CDC0
+ *
+ * Samples RSSI, battery, link settings, data path counters and queue
+ * depths at the subscribed period on the background work queue, and sends
+ * the ones common/link_telemetry picks. Nothing is sent while the USB host
+ * is suspended.
+ */
+
+#ifndef RELAY_TELEMETRY_H_
+#define RELAY_TELEMETRY_H_
+
+#include "MouthpadRelay.pb.h"
+#include "link_telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Apply a LinkTelemetrySubscribe from the host
+ *
+ * Safe from any thread; the first sample is sent from the work queue.
+ */
+void relay_telemetry_subscribe(const mouthware_message_LinkTelemetrySubscribe *req);
+
+/**
+ * @brief Read the link and data path counters as a LinkTelemetry sample
+ *
+ * Also what the link history (relay_link_history.h) is kept from.
+ */
+void relay_telemetry_sample(struct link_telemetry_sample *sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_TELEMETRY_H_ */
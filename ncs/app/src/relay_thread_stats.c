@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <string.h>
+
+#include "relay_thread_stats.h"
+
+static K_MUTEX_DEFINE(read_lock);
+
+/* Filled by the thread walk, under read_lock */
+static struct thread_stats_sample samples[THREAD_STATS_MAX];
+static size_t sample_count;
+
+static void sample_thread(const struct k_thread *thread, void *user_data)
+{
+	struct thread_stats_sample *sample;
+	k_thread_runtime_stats_t runtime;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+	size_t unused;
+
+	ARG_UNUSED(user_data);
+
+	if (sample_count >= ARRAY_SIZE(samples)) {
+		return;
+	}
+	sample = &samples[sample_count++];
+	*sample = (struct thread_stats_sample){
+		.id = (uintptr_t)thread,
+		.stack_size = thread->stack_info.size,
+	};
+
+	if (name && name[0] != '\0') {
+		strncpy(sample->name, name, sizeof(sample->name) - 1);
+	} else {
+		snprintk(sample->name, sizeof(sample->name), "%p", thread);
+	}
+
+	if (k_thread_runtime_stats_get((k_tid_t)thread, &runtime) == 0) {
+		sample->runtime = runtime.execution_cycles;
+	}
+
+	/* Each window opens when the thread is switched in */
+	sample->switches = thread->base.usage.num_windows;
+
+	if (k_thread_stack_space_get(thread, &unused) == 0) {
+		sample->stack_unused = unused;
+	}
+}
+
+int relay_thread_stats_read(struct thread_stats_report *report)
+{
+	k_thread_runtime_stats_t all;
+	int err;
+
+	k_mutex_lock(&read_lock, K_FOREVER);
+
+	err = k_thread_runtime_stats_all_get(&all);
+	if (err == 0) {
+		/* Unlocked: the stack scans would otherwise hold off interrupts */
+		sample_count = 0;
+		k_thread_foreach_unlocked(sample_thread, NULL);
+		thread_stats_update(samples, sample_count, all.execution_cycles,
+				    k_uptime_get_32(), report);
+	}
+
+	k_mutex_unlock(&read_lock);
+
+	return err;
+}
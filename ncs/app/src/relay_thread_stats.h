@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Per-thread CPU and stack usage from Zephyr's runtime stats
+ *
+ * Walks every thread for its run time, switch count and unused stack, and
+ * hands them to common/thread_stats. Each read covers the time since the
+ * previous one, whether it came from the "top" shell command or a
+ * ThreadStatsRead on CDC0.
+ */
+
+#ifndef RELAY_THREAD_STATS_H_
+#define RELAY_THREAD_STATS_H_
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include "thread_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_THREAD_STATS)
+
+/**
+ * @brief Read every thread; safe from any thread, reads are serialised
+ *
+ * Scans each thread's stack for its high-water mark, so it takes a while
+ * with many threads; call it from the protocol queue or the shell.
+ *
+ * @return 0 on success, or a negative errno
+ */
+int relay_thread_stats_read(struct thread_stats_report *report);
+
+#else
+
+static inline int relay_thread_stats_read(struct thread_stats_report *report)
+{
+	ARG_UNUSED(report);
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_RELAY_THREAD_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_THREAD_STATS_H_ */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+
+#include "relay_time.h"
+
+/* Well inside the 268 s the 32-bit count takes to wrap */
+#define WRAP_CHECK_PERIOD K_SECONDS(60)
+
+static struct k_spinlock lock;
+static uint32_t last_low;
+static uint32_t high;
+
+uint64_t relay_time_now64(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint32_t low = relay_time_now32();
+	uint64_t now;
+
+	if (low < last_low) {
+		high++;
+	}
+	last_low = low;
+	now = ((uint64_t)high << 32) | low;
+	k_spin_unlock(&lock, key);
+	return now;
+}
+
+static void wrap_check(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	(void)relay_time_now64();
+}
+
+static K_TIMER_DEFINE(wrap_timer, wrap_check, NULL);
+
+/* Running before anything is stamped; captures before this read 0 */
+static int relay_time_start(void)
+{
+	nrf_timer_task_trigger(RELAY_TIME_TIMER, NRF_TIMER_TASK_STOP);
+	nrf_timer_mode_set(RELAY_TIME_TIMER, NRF_TIMER_MODE_TIMER);
+	nrf_timer_bit_width_set(RELAY_TIME_TIMER, NRF_TIMER_BIT_WIDTH_32);
+	/* Prescaler 0: the full 16 MHz */
+	nrf_timer_prescaler_set(RELAY_TIME_TIMER, 0);
+	nrf_timer_task_trigger(RELAY_TIME_TIMER, NRF_TIMER_TASK_CLEAR);
+	nrf_timer_task_trigger(RELAY_TIME_TIMER, NRF_TIMER_TASK_START);
+	return 0;
+}
+
+SYS_INIT(relay_time_start, PRE_KERNEL_1, 0);
+
+static int relay_time_watch_wrap(void)
+{
+	k_timer_start(&wrap_timer, WRAP_CHECK_PERIOD, WRAP_CHECK_PERIOD);
+	return 0;
+}
+
+SYS_INIT(relay_time_watch_wrap, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief The relay time base (common/time_base.h)
+ *
+ * With CONFIG_RELAY_TIME_HFTIMER a TIMER runs free at 16 MHz from boot
+ * and a capture is a task trigger and a register read, 62.5 ns a tick
+ * where k_cycle_get_32() is the 32.768 kHz RTC. The 32-bit count wraps
+ * every 268 s; relay_time_now64() carries it into a high word, and a
+ * kernel timer reads it often enough not to miss a wrap. Without it the
+ * same calls fall back to the kernel clock.
+ *
+ * Every call may be made from any context except zero-latency interrupts.
+ */
+
+#ifndef RELAY_TIME_H_
+#define RELAY_TIME_H_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/time_units.h>
+
+#include "time_base.h"
+
+#if defined(CONFIG_RELAY_TIME_HFTIMER)
+#include <hal/nrf_timer.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_RELAY_TIME_HFTIMER)
+
+#define RELAY_TIME_HZ    16000000U
+#define RELAY_TIME_TIMER CONCAT(NRF_TIMER, CONFIG_RELAY_TIME_TIMER)
+
+/**
+ * @brief Raw 32-bit capture, RELAY_TIME_HZ, wrapping
+ */
+static inline uint32_t relay_time_now32(void)
+{
+	/* CC[0] is shared by every caller; the key keeps the pair together */
+	unsigned int key = irq_lock();
+	uint32_t now;
+
+	nrf_timer_task_trigger(RELAY_TIME_TIMER, NRF_TIMER_TASK_CAPTURE0);
+	now = nrf_timer_cc_get(RELAY_TIME_TIMER, NRF_TIMER_CC_CHANNEL0);
+	irq_unlock(key);
+	return now;
+}
+
+/**
+ * @brief 64-bit capture, RELAY_TIME_HZ, since boot
+ */
+uint64_t relay_time_now64(void);
+
+static inline uint32_t relay_time_to_us(uint32_t ticks)
+{
+	return ticks / (RELAY_TIME_HZ / USEC_PER_SEC);
+}
+
+static inline uint64_t relay_time_to_ns(uint32_t ticks)
+{
+	return (uint64_t)ticks * NSEC_PER_USEC / (RELAY_TIME_HZ / USEC_PER_SEC);
+}
+
+/**
+ * @brief Microseconds since boot, the time every stamp leaving the relay uses
+ */
+static inline uint64_t relay_time_us64(void)
+{
+	return relay_time_now64() / (RELAY_TIME_HZ / USEC_PER_SEC);
+}
+
+#else
+
+#define RELAY_TIME_HZ CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC
+
+static inline uint32_t relay_time_now32(void)
+{
+	return k_cycle_get_32();
+}
+
+static inline uint32_t relay_time_to_us(uint32_t ticks)
+{
+	return k_cyc_to_us_floor32(ticks);
+}
+
+static inline uint64_t relay_time_to_ns(uint32_t ticks)
+{
+	return k_cyc_to_ns_floor64(ticks);
+}
+
+static inline uint64_t relay_time_us64(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+#endif /* CONFIG_RELAY_TIME_HFTIMER */
+
+/**
+ * @brief Microseconds between a relay_time_now32() and now
+ */
+static inline uint32_t relay_time_since_us(uint32_t start)
+{
+	return relay_time_to_us(relay_time_now32() - start);
+}
+
+/**
+ * @brief Microseconds since boot, 32 bits, wrapping; for clocks shared by
+ * the common modules
+ */
+static inline uint32_t relay_time_us32(void)
+{
+	return (uint32_t)relay_time_us64();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_TIME_H_ */
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include "relay_tuning.h"
+#include "tuning_profile.h"
+#include "ble_conn_params.h"
+#include "relay_events.h"
+#include "relay_persist.h"
+#include "relay_workq.h"
+#include "usb_cdc.h"
+
+LOG_MODULE_REGISTER(relay_tuning, LOG_LEVEL_INF);
+
+#define KNOB(name) mouthware_message_RelayProfileKnob_RELAY_PROFILE_KNOB_##name
+#define KNOB_BIT(name) BIT(KNOB(name))
+
+#define SETTINGS_KEY "tuning/profile"
+
+#if defined(CONFIG_BLE_TX_POWER_ADAPTIVE)
+#define TX_TARGET_DBM CONFIG_BLE_TX_POWER_TARGET_DBM
+#define TX_TARGET_APPLIED KNOB_BIT(TX_POWER_TARGET)
+#else
+#define TX_TARGET_DBM -70
+#define TX_TARGET_APPLIED 0
+#endif
+
+/* Deferred write of the profile (relay_persist.h) */
+static struct relay_persist tuning_persist;
+
+/* Blob read by settings_load(), restored on the protocol work queue */
+static struct tuning_profile_saved loaded;
+static size_t loaded_len;
+
+static void restore_work_handler(struct k_work *work);
+static K_WORK_DEFINE(restore_work, restore_work_handler);
+
+static void cycle_work_handler(struct k_work *work);
+static K_WORK_DEFINE(cycle_work, cycle_work_handler);
+
+static void tuning_changed(uint32_t knobs)
+{
+	if (knobs & (KNOB_BIT(ACTIVE_INTERVAL) | KNOB_BIT(IDLE_INTERVAL) | KNOB_BIT(IDLE_LATENCY))) {
+		ble_conn_params_retune();
+	}
+	if (knobs & KNOB_BIT(STATUS_LIGHTS)) {
+		relay_events_post(RELAY_EVENT_PROFILE);
+	}
+	/* The TX power target is picked up at the next RSSI reading */
+}
+
+static void tuning_persist_flush(void)
+{
+	struct tuning_profile_saved saved;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_SETTINGS)) {
+		return;
+	}
+
+	tuning_profile_save(&saved);
+	err = settings_save_one(SETTINGS_KEY, &saved, sizeof(saved));
+	if (err) {
+		LOG_WRN("Failed to save the tuning profile (err %d)", err);
+	}
+}
+
+static int send_status(void)
+{
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body = mouthware_message_RelayToAppMessage_relay_profile_response_tag;
+	tuning_profile_get_status(&response->message_body.relay_profile_response);
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+static void log_profile(void)
+{
+	char line[160];
+
+	tuning_profile_format(line, sizeof(line));
+	LOG_INF("%s", line);
+}
+
+int relay_tuning_write(const mouthware_message_RelayProfileWrite *write)
+{
+	bool persist;
+	bool accepted = tuning_profile_write(write, &persist);
+	int err;
+
+	if (persist) {
+		relay_persist_request(&tuning_persist);
+	}
+	if (accepted) {
+		log_profile();
+	} else {
+		LOG_WRN("Tuning profile write refused");
+	}
+
+	err = send_status();
+	return err ? err : (accepted ? 0 : -EINVAL);
+}
+
+static void cycle_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	tuning_profile_cycle();
+	relay_persist_request(&tuning_persist);
+	log_profile();
+	send_status();
+}
+
+void relay_tuning_cycle(void)
+{
+	k_work_submit_to_queue(&relay_workq_protocol, &cycle_work);
+}
+
+bool relay_tuning_lights(void)
+{
+	return tuning_profile_get(KNOB(STATUS_LIGHTS)) != 0;
+}
+
+static void restore_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (tuning_profile_restore(&loaded, loaded_len)) {
+		log_profile();
+	} else {
+		LOG_WRN("Saved tuning profile not recognized, keeping balanced");
+	}
+}
+
+static int tuning_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+			       void *cb_arg)
+{
+	ssize_t read;
+
+	if (strcmp(name, "profile") != 0) {
+		return -ENOENT;
+	}
+
+	read = read_cb(cb_arg, &loaded, sizeof(loaded));
+	if (read < 0) {
+		return (int)read;
+	}
+	/* A blob of another size is refused by the restore */
+	loaded_len = len;
+	k_work_submit_to_queue(&relay_workq_protocol, &restore_work);
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(tuning, "tuning", NULL, tuning_settings_set, NULL, NULL);
+
+static int relay_tuning_init(void)
+{
+	const struct tuning_profile_config config = {
+		.presets = {
+			[mouthware_message_RelayProfile_RELAY_PROFILE_LOW_LATENCY - 1] = {
+				[KNOB(ACTIVE_INTERVAL)] = BLE_CONN_PARAMS_ACTIVE_INTERVAL,
+				[KNOB(IDLE_INTERVAL)] = BLE_CONN_PARAMS_ACTIVE_INTERVAL,
+				[KNOB(IDLE_LATENCY)] = 0,
+				[KNOB(TX_POWER_TARGET)] = TX_TARGET_DBM + 6,
+				[KNOB(STATUS_LIGHTS)] = 1,
+			},
+			[mouthware_message_RelayProfile_RELAY_PROFILE_BALANCED - 1] = {
+				[KNOB(ACTIVE_INTERVAL)] = BLE_CONN_PARAMS_ACTIVE_INTERVAL,
+				[KNOB(IDLE_INTERVAL)] = CONFIG_BLE_CONN_PARAMS_IDLE_INTERVAL,
+				[KNOB(IDLE_LATENCY)] = CONFIG_BLE_CONN_PARAMS_IDLE_LATENCY,
+				[KNOB(TX_POWER_TARGET)] = TX_TARGET_DBM,
+				[KNOB(STATUS_LIGHTS)] = 1,
+			},
+			[mouthware_message_RelayProfile_RELAY_PROFILE_BATTERY - 1] = {
+				[KNOB(ACTIVE_INTERVAL)] = BLE_CONN_PARAMS_ACTIVE_INTERVAL * 2,
+				[KNOB(IDLE_INTERVAL)] = CONFIG_BLE_CONN_PARAMS_IDLE_INTERVAL,
+				[KNOB(IDLE_LATENCY)] = CONFIG_BLE_CONN_PARAMS_DEEP_IDLE_LATENCY,
+				[KNOB(TX_POWER_TARGET)] = TX_TARGET_DBM - 6,
+				[KNOB(STATUS_LIGHTS)] = 0,
+			},
+		},
+		.max_idle_sleep_ms = BLE_CONN_PARAMS_MAX_SLEEP_MS,
+		/* CDC0 coalescing is the ESP relay's */
+		.applied = KNOB_BIT(ACTIVE_INTERVAL) | KNOB_BIT(IDLE_INTERVAL) |
+			   KNOB_BIT(IDLE_LATENCY) | TX_TARGET_APPLIED | KNOB_BIT(STATUS_LIGHTS),
+		.changed = tuning_changed,
+	};
+
+	relay_persist_init(&tuning_persist, tuning_persist_flush);
+	tuning_profile_init(&config);
+	return 0;
+}
+
+SYS_INIT(relay_tuning_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Runtime tuning profile (common/tuning_profile.h) on the nRF relay
+ *
+ * The presets are built from Kconfig: BALANCED is the build as configured,
+ * LOW_LATENCY keeps the link at the minimum interval through idle and aims
+ * CONFIG_BLE_TX_POWER_TARGET_DBM 6 dB higher, BATTERY doubles the active
+ * interval, sleeps at the deep idle latency, aims 6 dB lower and darkens
+ * the LEDs and the OLED. The profile is kept in settings under "tuning".
+ *
+ * Writes, button cycling and the restore at boot all run on
+ * relay_workq_protocol.
+ */
+
+#ifndef RELAY_TUNING_H_
+#define RELAY_TUNING_H_
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Apply a RelayProfileWrite and answer with a RelayProfileResponse
+ *
+ * Protocol work queue.
+ *
+ * @return 0, or -EINVAL if the write was refused (the response still
+ *         carries the profile in force), -ENOMEM if no response was sent
+ */
+int relay_tuning_write(const mouthware_message_RelayProfileWrite *write);
+
+/**
+ * @brief Move to the next preset and tell the host
+ *
+ * Safe from any context, including the button's timers.
+ */
+void relay_tuning_cycle(void);
+
+/**
+ * @brief Whether the status lights (LEDs, OLED) are on
+ */
+bool relay_tuning_lights(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_TUNING_H_ */
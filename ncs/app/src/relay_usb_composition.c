@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/reboot.h>
+
+#include "relay_usb_composition.h"
+#include "relay_workq.h"
+#include "usb_cdc.h"
+#include "usb_composition.h"
+
+LOG_MODULE_REGISTER(relay_usb_composition, LOG_LEVEL_INF);
+
+#define COMPOSITION(name) mouthware_message_UsbComposition_USB_COMPOSITION_##name
+
+#define SETTINGS_KEY "usb/composition"
+
+/* Long enough for the response to leave over USB before the detach */
+#define REENUMERATE_DELAY_MS 200
+
+/* Saved: enumerated from the next boot on. Active: registered at this one. */
+static uint8_t saved = COMPOSITION(FULL);
+static uint8_t active = COMPOSITION(FULL);
+
+static void cycle_work_handler(struct k_work *work);
+static K_WORK_DEFINE(cycle_work, cycle_work_handler);
+
+static void reboot_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(reboot_work, reboot_work_handler);
+
+static int usb_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	uint8_t value;
+	ssize_t read;
+
+	if (strcmp(name, "composition") != 0) {
+		return -ENOENT;
+	}
+	if (len != sizeof(value)) {
+		return -EINVAL;
+	}
+
+	read = read_cb(cb_arg, &value, sizeof(value));
+	if (read < 0) {
+		return (int)read;
+	}
+	if (!usb_composition_valid(value)) {
+		LOG_WRN("Saved USB composition %u not recognized, keeping full", value);
+		return 0;
+	}
+	saved = value;
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(usb_composition, "usb", NULL, usb_settings_set, NULL, NULL);
+
+uint32_t relay_usb_composition_load(void)
+{
+	if (IS_ENABLED(CONFIG_SETTINGS)) {
+		/* Bluetooth initializes settings later; this comes first */
+		int err = settings_subsys_init();
+
+		if (err) {
+			LOG_WRN("Settings unavailable (err %d), enumerating full", err);
+		} else {
+			settings_load_subtree("usb");
+		}
+	}
+
+	active = saved;
+	LOG_INF("USB composition: %s", usb_composition_name(active));
+	return active;
+}
+
+uint32_t relay_usb_composition_active(void)
+{
+	return active;
+}
+
+static void reboot_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	LOG_INF("Re-enumerating as %s", usb_composition_name(saved));
+	sys_reboot(SYS_REBOOT_COLD);
+}
+
+/* Save a new composition; false if the write to flash failed */
+static bool save(uint8_t composition)
+{
+	int err;
+
+	if (composition == saved) {
+		return true;
+	}
+	if (IS_ENABLED(CONFIG_SETTINGS)) {
+		/* Written at once, as a reboot may follow */
+		err = settings_save_one(SETTINGS_KEY, &composition, sizeof(composition));
+		if (err) {
+			LOG_WRN("Failed to save the USB composition (err %d)", err);
+			return false;
+		}
+	}
+	saved = composition;
+	return true;
+}
+
+static int send_status(bool reenumerating)
+{
+	mouthware_message_RelayToAppMessage *response = usb_cdc_message_reserve();
+
+	if (!response) {
+		return -ENOMEM;
+	}
+
+	response->which_message_body =
+		mouthware_message_RelayToAppMessage_usb_composition_response_tag;
+	response->message_body.usb_composition_response =
+		(mouthware_message_UsbCompositionResponse){
+			.composition = saved,
+			.active = active,
+			.reenumerating = reenumerating,
+		};
+	usb_cdc_message_commit(response);
+	return 0;
+}
+
+/* Re-enumerate if the saved composition is not the active one */
+static bool reenumerate(void)
+{
+	if (saved == active) {
+		return false;
+	}
+
+	k_work_schedule_for_queue(&relay_workq_background, &reboot_work,
+				  K_MSEC(REENUMERATE_DELAY_MS));
+	return true;
+}
+
+int relay_usb_composition_write(const mouthware_message_UsbCompositionWrite *write)
+{
+	bool accepted = true;
+	bool reenumerating = false;
+	int err;
+
+	if (write->composition != COMPOSITION(UNCHANGED)) {
+		accepted = usb_composition_valid(write->composition) &&
+			   save((uint8_t)write->composition);
+	}
+	if (accepted) {
+		if (write->reenumerate) {
+			reenumerating = reenumerate();
+		}
+		LOG_INF("USB composition: %s saved, %s active", usb_composition_name(saved),
+			usb_composition_name(active));
+	} else {
+		LOG_WRN("USB composition write refused");
+	}
+
+	err = send_status(reenumerating);
+	return err ? err : (accepted ? 0 : -EINVAL);
+}
+
+static void cycle_work_handler(struct k_work *work)
+{
+	bool reenumerating = false;
+
+	ARG_UNUSED(work);
+
+	if (save((uint8_t)usb_composition_next(saved))) {
+		reenumerating = reenumerate();
+	}
+	LOG_INF("USB composition: %s saved, %s active", usb_composition_name(saved),
+		usb_composition_name(active));
+	send_status(reenumerating);
+}
+
+void relay_usb_composition_cycle(void)
+{
+	k_work_submit_to_queue(&relay_workq_protocol, &cycle_work);
+}
+
+int relay_usb_composition_format(char *buf, size_t len)
+{
+	return snprintf(buf, len, "usb: %s active, %s saved", usb_composition_name(active),
+			usb_composition_name(saved));
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief USB composition (common/usb_composition.h) on the nRF relay
+ *
+ * The composition is kept in settings under "usb/composition" and read by
+ * usb_init() ahead of the other settings, since the USB classes are
+ * registered before Bluetooth comes up. The stack registers its classes
+ * once, so re-enumerating with another composition takes a reboot; the
+ * MouthPad reconnects as after any reset.
+ *
+ * Writes and button cycling run on relay_workq_protocol.
+ */
+
+#ifndef RELAY_USB_COMPOSITION_H_
+#define RELAY_USB_COMPOSITION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MouthpadRelay.pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Read the saved composition; once, before the USB classes register
+ *
+ * @return The composition to enumerate with, FULL if none was saved
+ */
+uint32_t relay_usb_composition_load(void);
+
+/**
+ * @brief The composition enumerated now
+ */
+uint32_t relay_usb_composition_active(void);
+
+/**
+ * @brief Apply a UsbCompositionWrite and answer with a UsbCompositionResponse
+ *
+ * Protocol work queue. The relay reboots shortly after the response when
+ * the write asks to re-enumerate and the saved composition differs from
+ * the active one.
+ *
+ * @return 0, -EINVAL if the write was refused (the response still carries
+ *         the saved composition), -ENOMEM if no response was sent
+ */
+int relay_usb_composition_write(const mouthware_message_UsbCompositionWrite *write);
+
+/**
+ * @brief Save the next composition, tell the host and re-enumerate with it
+ *
+ * Safe from any context, including the button's timers.
+ */
+void relay_usb_composition_cycle(void);
+
+/**
+ * @brief Saved and active composition as one console line
+ *
+ * @return Characters written, as snprintf
+ */
+int relay_usb_composition_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_USB_COMPOSITION_H_ */
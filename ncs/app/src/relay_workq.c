@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include "relay_workq.h"
+
+K_THREAD_STACK_DEFINE(realtime_stack, CONFIG_RELAY_WORKQ_REALTIME_STACK_SIZE);
+K_THREAD_STACK_DEFINE(protocol_stack, CONFIG_RELAY_WORKQ_PROTOCOL_STACK_SIZE);
+K_THREAD_STACK_DEFINE(background_stack, CONFIG_RELAY_WORKQ_BACKGROUND_STACK_SIZE);
+
+struct k_work_q relay_workq_realtime;
+struct k_work_q relay_workq_protocol;
+struct k_work_q relay_workq_background;
+
+static void start(struct k_work_q *queue, k_thread_stack_t *stack, size_t stack_size,
+		  int priority, const char *name)
+{
+	const struct k_work_queue_config config = {
+		.name = name,
+	};
+
+	k_work_queue_init(queue);
+	k_work_queue_start(queue, stack, stack_size, priority, &config);
+}
+
+static int relay_workq_init(void)
+{
+	start(&relay_workq_realtime, realtime_stack, K_THREAD_STACK_SIZEOF(realtime_stack),
+	      CONFIG_RELAY_WORKQ_REALTIME_PRIORITY, "workq_realtime");
+	start(&relay_workq_protocol, protocol_stack, K_THREAD_STACK_SIZEOF(protocol_stack),
+	      CONFIG_RELAY_WORKQ_PROTOCOL_PRIORITY, "workq_protocol");
+	start(&relay_workq_background, background_stack, K_THREAD_STACK_SIZEOF(background_stack),
+	      CONFIG_RELAY_WORKQ_BACKGROUND_PRIORITY, "workq_background");
+
+	return 0;
+}
+
+/* Before main() and the Bluetooth callbacks that submit to the queues */
+SYS_INIT(relay_workq_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
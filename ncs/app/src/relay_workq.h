@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief The relay's work queues, by how soon their work must run
+ *
+ * - relay_workq_realtime: input and pass-through traffic (HID setup and
+ *   retries, CDC TX encoding, NUS writes)
+ * - relay_workq_protocol: connection management (scanning, connection
+ *   parameters, secondary links) and host control messages (relay_dispatch.h)
+ * - relay_workq_background: anything slow or cosmetic (flash writes, RSSI
+ *   reads, display and buzzer timers, USB enumeration watchdog)
+ *
+ * The system work queue is left to the Zephyr stacks. The queues start
+ * before main() runs.
+ */
+
+#ifndef RELAY_WORKQ_H_
+#define RELAY_WORKQ_H_
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct k_work_q relay_workq_realtime;
+extern struct k_work_q relay_workq_protocol;
+extern struct k_work_q relay_workq_background;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_WORKQ_H_ */
@@ -19,10 +19,20 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(usbd_sample_config);
 
+#include "mouthpad_relay_webusb.h"
+#include "relay_usb_composition.h"
+#include "usb_composition.h"
+#include "usb_relay_webusb.h"
+
 #define ZEPHYR_PROJECT_USB_VID 0x1915 /* Augmental Tech VID */
 
-/* By default, do not register the USB DFU class DFU mode instance. */
-static const char *const blocklist[] = {
+#define COMPOSITION(name) mouthware_message_UsbComposition_USB_COMPOSITION_##name
+
+/* By default, do not register the USB DFU class DFU mode instance. The
+ * classes the USB composition leaves out (relay_usb_composition.h) are
+ * added behind it before the classes register.
+ */
+static const char *blocklist[5] = {
     "dfu_dfu",
     NULL,
 };
@@ -153,14 +163,53 @@ static const struct usb_bos_capability_lpm bos_cap_lpm = {
 USBD_DESC_BOS_DEFINE(sample_usbext, sizeof(bos_cap_lpm), &bos_cap_lpm);
 #endif
 
+#if IS_ENABLED(CONFIG_RELAY_WEBUSB)
+/* WebUSB and MS OS 2.0 platform capabilities for the relay WebUSB
+ * interface; see mouthpad_relay_webusb.h
+ */
+static const uint8_t bos_cap_webusb[] = {MOUTHPAD_RELAY_WEBUSB_BOS_WEBUSB};
+static const uint8_t bos_cap_msos2[] = {MOUTHPAD_RELAY_WEBUSB_BOS_MSOS2};
+
+/* The interface number is patched in on request, once the stack has
+ * numbered the interfaces
+ */
+static uint8_t msos2_desc[] = {MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC(0)};
+
+BUILD_ASSERT(sizeof(msos2_desc) == MOUTHPAD_RELAY_WEBUSB_MSOS2_DESC_LEN,
+             "MS OS 2.0 descriptor length mismatch");
+
+static int msos2_to_host_cb(const struct usbd_context *const ctx,
+                            const struct usb_setup_packet *const setup,
+                            struct net_buf *const buf) {
+  if (setup->wIndex != MOUTHPAD_RELAY_WEBUSB_MSOS2_INDEX) {
+    return -ENOTSUP;
+  }
+
+  msos2_desc[MOUTHPAD_RELAY_WEBUSB_MSOS2_ITF_OFFSET] =
+      usb_relay_webusb_interface();
+  net_buf_add_mem(buf, msos2_desc,
+                  MIN(net_buf_tailroom(buf), sizeof(msos2_desc)));
+  return 0;
+}
+
+/* No landing page, so WebUSB needs no vendor request of its own */
+USBD_DESC_BOS_DEFINE(relay_webusb_bos, sizeof(bos_cap_webusb), bos_cap_webusb);
+USBD_DESC_BOS_VREQ_DEFINE(relay_msos2_bos, sizeof(bos_cap_msos2), bos_cap_msos2,
+                          MOUTHPAD_RELAY_WEBUSB_MSOS2_VENDOR_CODE,
+                          msos2_to_host_cb, NULL);
+#endif
+
 static void sample_fix_code_triple(struct usbd_context *uds_ctx,
                                    const enum usbd_speed speed) {
-  /* Always use class code information from Interface Descriptors */
-  if (IS_ENABLED(CONFIG_USBD_CDC_ACM_CLASS) ||
-      IS_ENABLED(CONFIG_USBD_CDC_ECM_CLASS) ||
-      IS_ENABLED(CONFIG_USBD_CDC_NCM_CLASS) ||
-      IS_ENABLED(CONFIG_USBD_MIDI2_CLASS) ||
-      IS_ENABLED(CONFIG_USBD_AUDIO2_CLASS)) {
+  /* Always use class code information from Interface Descriptors; a
+   * HID-only composition has no associated interfaces
+   */
+  if (relay_usb_composition_active() != COMPOSITION(HID_ONLY) &&
+      (IS_ENABLED(CONFIG_USBD_CDC_ACM_CLASS) ||
+       IS_ENABLED(CONFIG_USBD_CDC_ECM_CLASS) ||
+       IS_ENABLED(CONFIG_USBD_CDC_NCM_CLASS) ||
+       IS_ENABLED(CONFIG_USBD_MIDI2_CLASS) ||
+       IS_ENABLED(CONFIG_USBD_AUDIO2_CLASS))) {
     /*
      * Class with multiple interfaces have an Interface
      * Association Descriptor available, use an appropriate triple
@@ -194,11 +243,50 @@ static void cdc_assign_interface_string(const struct device *dev,
   desc->if0.iInterface = idx;
   desc->if1.iInterface = idx;
 }
+
+static const char *cdc_class_name(const struct device *dev) {
+  const struct cdc_acm_uart_config *cfg = dev->config;
+
+  return (cfg != NULL && cfg->c_data != NULL) ? cfg->c_data->name : NULL;
+}
 #endif /* CONFIG_USBD_CDC_ACM_CLASS */
 
+static void blocklist_add(const char *name) {
+  for (size_t i = 0U; i < ARRAY_SIZE(blocklist) - 1U; i++) {
+    if (blocklist[i] == NULL) {
+      blocklist[i] = name;
+      return;
+    }
+  }
+}
+
+/* Leave the classes out that the composition has no place for */
+static void blocklist_composition(uint32_t composition) {
+  if (composition == COMPOSITION(FULL)) {
+    return;
+  }
+
+  if (IS_ENABLED(CONFIG_RELAY_WEBUSB)) {
+    blocklist_add("relay_webusb");
+  }
+#if IS_ENABLED(CONFIG_USBD_CDC_ACM_CLASS)
+#if DT_NODE_EXISTS(DT_NODELABEL(cdc_acm_uart1))
+  blocklist_add(cdc_class_name(DEVICE_DT_GET(DT_NODELABEL(cdc_acm_uart1))));
+#endif
+#if DT_NODE_EXISTS(DT_NODELABEL(cdc_acm_uart0))
+  if (composition == COMPOSITION(HID_ONLY)) {
+    blocklist_add(cdc_class_name(DEVICE_DT_GET(DT_NODELABEL(cdc_acm_uart0))));
+  }
+#endif
+#endif
+}
+
 struct usbd_context *sample_usbd_setup_device(usbd_msg_cb_t msg_cb) {
+  uint32_t composition = relay_usb_composition_active();
   int err;
 
+  blocklist_composition(composition);
+
   /* Populate serial descriptor string for device identification */
   memset(serial_number_str, 0, sizeof(serial_number_str));
   uint8_t hwid[8];
@@ -357,6 +445,29 @@ struct usbd_context *sample_usbd_setup_device(usbd_msg_cb_t msg_cb) {
   }
 #endif
 
+#if IS_ENABLED(CONFIG_RELAY_WEBUSB)
+  if (composition != COMPOSITION(FULL)) {
+    /* No WebUSB interface to announce */
+    return &sample_usbd;
+  }
+
+  /* Hosts only read the BOS descriptor from bcdUSB 2.01 on */
+  (void)usbd_device_set_bcd_usb(&sample_usbd, USBD_SPEED_FS, 0x0201);
+  (void)usbd_device_set_bcd_usb(&sample_usbd, USBD_SPEED_HS, 0x0201);
+
+  err = usbd_add_descriptor(&sample_usbd, &relay_webusb_bos);
+  if (err) {
+    LOG_ERR("Failed to add WebUSB BOS descriptor (%d)", err);
+    return NULL;
+  }
+
+  err = usbd_add_descriptor(&sample_usbd, &relay_msos2_bos);
+  if (err) {
+    LOG_ERR("Failed to add MS OS 2.0 BOS descriptor (%d)", err);
+    return NULL;
+  }
+#endif
+
   return &sample_usbd;
 }
 
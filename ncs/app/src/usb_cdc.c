@@ -12,8 +12,21 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/drivers/uart.h>
 #include <zephyr/sys/ring_buffer.h>
+#include <string.h>
 #include "MouthpadRelay.pb.h"
 #include "pb_encode.h"
+#include "fault_inject.h"
+#include "mem_stats.h"
+#include "mouthpad_crc16.h"
+#include "mouthpad_frame.h"
+#include "mouthpad_pass_through.h"
+#include "relay_dispatch.h"
+#include "relay_sysview.h"
+#include "relay_workq.h"
+#include "sensor_codec.h"
+#include "trace_ring.h"
+#include "usb_relay_hid.h"
+#include "usb_relay_webusb.h"
 
 LOG_MODULE_REGISTER(usb_cdc, LOG_LEVEL_INF);
 
@@ -25,6 +38,68 @@ static const struct device *cdc_acm_dev;
 static uint8_t cdc0_rx_ringbuf_data[CDC0_RX_RINGBUF_SIZE];
 static struct ring_buf cdc0_rx_ringbuf;
 
+/* Given by the IRQ callback whenever new RX data lands in the ring buffer */
+static K_SEM_DEFINE(cdc0_rx_sem, 0, 1);
+
+/* Set while RX interrupts are off because the ring buffer filled up */
+static atomic_t cdc0_rx_throttled;
+
+/* Free space needed before RX resumes, so the host is not let in for a
+ * few bytes at a time while the parser catches up
+ */
+#define CDC0_RX_RESUME_SPACE (CDC0_RX_RINGBUF_SIZE / 4)
+
+/* Times RX was paused, and most bytes ever waiting, since the last reset */
+static atomic_t cdc0_rx_throttles;
+static atomic_t cdc0_rx_high_water;
+
+/* Ring buffer for CDC0 TX frames, drained by the UART IRQ callback */
+#define CDC0_TX_RINGBUF_SIZE 2048
+static uint8_t cdc0_tx_ringbuf_data[CDC0_TX_RINGBUF_SIZE];
+static struct ring_buf cdc0_tx_ringbuf;
+
+/* How long a sender waits for the host to drain a full TX ring */
+#define CDC0_TX_WAIT_TIMEOUT K_MSEC(50)
+
+/* Keeps each frame contiguous in the TX ring when several threads send */
+static K_MUTEX_DEFINE(cdc0_tx_lock);
+
+/* Given by the IRQ callback whenever it frees TX ring space */
+static K_SEM_DEFINE(cdc0_tx_space_sem, 0, 1);
+
+/* Set when a sender gave up waiting for space; later senders then drop
+ * immediately instead of each stalling until the host reads again.
+ */
+static atomic_t cdc0_tx_stalled;
+
+static uint32_t cdc0_tx_high_water;
+static uint32_t cdc0_tx_dropped;
+
+/* Ring buffers for frames to the relay HID and WebUSB interfaces, each
+ * drained by its TX thread. Framed writes go to one of them instead of
+ * CDC0 while the host last sent a frame over that interface and it is
+ * still configured.
+ */
+#define RELAY_HID_TX_RINGBUF_SIZE CDC0_TX_RINGBUF_SIZE
+RING_BUF_DECLARE(relay_hid_tx_ringbuf, RELAY_HID_TX_RINGBUF_SIZE);
+#define WEBUSB_TX_RINGBUF_SIZE CDC0_TX_RINGBUF_SIZE
+RING_BUF_DECLARE(webusb_tx_ringbuf, WEBUSB_TX_RINGBUF_SIZE);
+static atomic_t tx_route = USB_CDC_ROUTE_CDC0;
+
+/* Ring the frames written under the current cdc0_tx_lock hold go to */
+static struct ring_buf *tx_ring = &cdc0_tx_ringbuf;
+
+/* Set while the host sends COBS frames (RELAY_FEATURE_COBS_FRAMING); they
+ * are answered in kind
+ */
+static atomic_t tx_cobs;
+
+/* A COBS frame's length is only known once it is encoded, so it is built
+ * here and then copied into the ring; cdc0_tx_lock guards both
+ */
+static uint8_t tx_cobs_buf[MOUTHPAD_FRAME_COBS_SIZE(MOUTHPAD_FRAME_MAX_PAYLOAD)];
+static struct mouthpad_cobs_encoder tx_cobs_encoder;
+
 /* Work structures for async USB CDC message sending */
 static struct k_work usb_cdc_async_work;
 
@@ -41,47 +116,221 @@ struct usb_cdc_async_data_t {
 	mouthware_message_RelayToAppMessage message;
 };
 
-/* Work handler for async USB CDC message sending */
-static void usb_cdc_async_work_handler(struct k_work *work)
+/* Fixed pool of async message slots, so bursts never touch the heap */
+K_MEM_SLAB_DEFINE_STATIC(usb_cdc_async_slab, sizeof(struct usb_cdc_async_data_t),
+			 CONFIG_USB_CDC_ASYNC_MSG_SLOTS, 4);
+
+static atomic_t usb_cdc_async_high_water;
+static atomic_t usb_cdc_async_dropped;
+
+/* Set by the host with PassThroughBatchConfigWrite */
+static atomic_t pass_through_batching;
+
+/* Sequence number of the next pass-through chunk; work handler only */
+static uint32_t pass_through_sequence;
+
+/* A batch frame must stay within the host's deframer limit, which matches
+ * ours; 3 bytes go to the RelayToAppMessage tag and length.
+ */
+#define PASS_THROUGH_BATCH_MAX_BYTES (MOUTHPAD_FRAME_MAX_PAYLOAD - 3)
+
+/* Worst-case encoding of one chunk beyond its data: chunks tag and length,
+ * sequence tag and varint, data tag and length
+ */
+#define PASS_THROUGH_CHUNK_OVERHEAD (1 + 2 + 1 + 5 + 1 + 2)
+
+BUILD_ASSERT(SIZEOF_FIELD(mouthware_message_PassThroughToApp_data_t, bytes) +
+		     PASS_THROUGH_CHUNK_OVERHEAD <= PASS_THROUGH_BATCH_MAX_BYTES,
+	     "A full pass-through message does not fit a batch frame");
+
+/* Consecutive pass-through slots sent as one PassThroughToAppBatch */
+struct pass_through_batch {
+	struct usb_cdc_async_data_t *items[CONFIG_USB_CDC_ASYNC_MSG_SLOTS];
+	size_t count;
+	uint32_t sequence;
+};
+
+static int tx_put_message(const pb_msgdesc_t *fields, const void *message);
+static int tx_put_pass_through(const mouthware_message_PassThroughToApp *pass_through);
+
+/* Take cdc0_tx_lock and pick the ring for the frames written under it */
+static void tx_lock(void)
 {
-	struct usb_cdc_async_data_t *async_data;
-	
-	/* Get message from FIFO */
-	async_data = k_fifo_get(&fifo_usb_cdc_async_data, K_NO_WAIT);
-	if (!async_data) {
-		return;
-	}
-	
-	/* Send the message synchronously (this will be quick) */
-	uint8_t dataPacket[1024];
-	pb_ostream_t stream = pb_ostream_from_buffer(dataPacket, sizeof(dataPacket));
-	if (!pb_encode(&stream, mouthware_message_RelayToAppMessage_fields, &async_data->message)) {
-		LOG_ERR("Async encoding failed: %s\n", PB_GET_ERROR(&stream));
+	k_mutex_lock(&cdc0_tx_lock, K_FOREVER);
+
+	switch (atomic_get(&tx_route)) {
+	case USB_CDC_ROUTE_RELAY_HID:
+		tx_ring = usb_relay_hid_ready() ? &relay_hid_tx_ringbuf : &cdc0_tx_ringbuf;
+		break;
+	case USB_CDC_ROUTE_WEBUSB:
+		tx_ring = usb_relay_webusb_ready() ? &webusb_tx_ringbuf : &cdc0_tx_ringbuf;
+		break;
+	default:
+		tx_ring = &cdc0_tx_ringbuf;
+		break;
+	}
+}
+
+/* Start moving frames written to ring out over USB */
+static void tx_kick(struct ring_buf *ring)
+{
+	if (ring == &relay_hid_tx_ringbuf) {
+		usb_relay_hid_tx_kick();
+	} else if (ring == &webusb_tx_ringbuf) {
+		usb_relay_webusb_tx_kick();
 	} else {
-		usb_cdc_send_data(dataPacket, stream.bytes_written);
+		/* The IRQ callback moves the frame into the USB FIFO */
+		uart_irq_tx_enable(cdc_acm_dev);
 	}
-	
-	/* Free the async data */
-	k_free(async_data);
 }
 
-/* Calculate CRC-16 (CCITT) for data integrity checking */
-uint16_t calculate_crc16(const uint8_t *data, uint16_t len)
+static bool is_pass_through(const struct usb_cdc_async_data_t *async_data)
+{
+	return async_data->message.which_message_body ==
+	       mouthware_message_RelayToAppMessage_pass_through_to_app_tag;
+}
+
+/* PassThroughChunk carries no device index, so only the primary MouthPad's
+ * data goes into batches
+ */
+static bool is_batchable_pass_through(const struct usb_cdc_async_data_t *async_data)
+{
+	return is_pass_through(async_data) &&
+	       async_data->message.message_body.pass_through_to_app.device_index == 0;
+}
+
+static size_t pass_through_batch_cost(const struct usb_cdc_async_data_t *async_data)
+{
+	return async_data->message.message_body.pass_through_to_app.data.size +
+	       PASS_THROUGH_CHUNK_OVERHEAD;
+}
+
+/* nanopb callback for PassThroughToAppBatch.chunks: encodes each chunk
+ * straight from its message slot instead of copying it into a
+ * PassThroughChunk first. Runs for the sizing pass and the real one.
+ */
+static bool encode_pass_through_chunks(pb_ostream_t *stream, const pb_field_t *field,
+				       void * const *arg)
 {
-	uint16_t crc = 0xFFFF; // Initial value
-	
-	for (uint16_t i = 0; i < len; i++) {
-		crc ^= (uint16_t)data[i] << 8;
-		for (int j = 0; j < 8; j++) {
-			if (crc & 0x8000) {
-				crc = (crc << 1) ^ 0x1021; // CCITT polynomial
-			} else {
-				crc = crc << 1;
+	const struct pass_through_batch *batch = *arg;
+
+	for (size_t i = 0; i < batch->count; i++) {
+		const mouthware_message_PassThroughToApp_data_t *data =
+			&batch->items[i]->message.message_body.pass_through_to_app.data;
+		uint32_t sequence = batch->sequence + i;
+		pb_ostream_t sizing = PB_OSTREAM_SIZING;
+
+		pb_encode_varint(&sizing, sequence);
+		pb_encode_varint(&sizing, data->size);
+
+		if (!pb_encode_tag_for_field(stream, field) ||
+		    !pb_encode_varint(stream, 2 + sizing.bytes_written + data->size) ||
+		    !pb_encode_tag(stream, PB_WT_VARINT,
+				   mouthware_message_PassThroughChunk_sequence_tag) ||
+		    !pb_encode_varint(stream, sequence) ||
+		    !pb_encode_tag(stream, PB_WT_STRING,
+				   mouthware_message_PassThroughChunk_data_tag) ||
+		    !pb_encode_string(stream, data->bytes, data->size)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Send first and the pass-through slots queued right behind it as one batch
+ * frame, with cdc0_tx_lock held. Frees every slot it sends.
+ */
+static int tx_put_pass_through_batch(struct usb_cdc_async_data_t *first)
+{
+	struct pass_through_batch batch = {
+		.items = { first },
+		.count = 1,
+		.sequence = pass_through_sequence,
+	};
+	size_t bytes = pass_through_batch_cost(first);
+	struct usb_cdc_async_data_t *next;
+
+	/* Only this handler takes from the FIFO, so the peeked head stays put */
+	while (batch.count < ARRAY_SIZE(batch.items) &&
+	       (next = k_fifo_peek_head(&fifo_usb_cdc_async_data)) != NULL &&
+	       is_batchable_pass_through(next) &&
+	       bytes + pass_through_batch_cost(next) <= PASS_THROUGH_BATCH_MAX_BYTES) {
+		bytes += pass_through_batch_cost(next);
+		batch.items[batch.count++] = k_fifo_get(&fifo_usb_cdc_async_data, K_NO_WAIT);
+	}
+
+	/* Only the work handler gets here, under cdc0_tx_lock */
+	static mouthware_message_RelayToAppMessage message;
+
+	message = (mouthware_message_RelayToAppMessage)mouthware_message_RelayToAppMessage_init_zero;
+	message.which_message_body = mouthware_message_RelayToAppMessage_pass_through_to_app_batch_tag;
+	message.message_body.pass_through_to_app_batch.chunks.funcs.encode =
+		encode_pass_through_chunks;
+	message.message_body.pass_through_to_app_batch.chunks.arg = &batch;
+
+	int err = cdc_acm_dev ? tx_put_message(mouthware_message_RelayToAppMessage_fields, &message)
+			      : -ENODEV;
+
+	/* Dropped chunks still use up their numbers so the host sees the gap */
+	pass_through_sequence += batch.count;
+
+	for (size_t i = 0; i < batch.count; i++) {
+		k_mem_slab_free(&usb_cdc_async_slab, batch.items[i]);
+	}
+
+	return err;
+}
+
+/* Work handler for async USB CDC message sending */
+static void usb_cdc_async_work_handler(struct k_work *work)
+{
+	struct usb_cdc_async_data_t *async_data;
+	bool queued = false;
+
+	ARG_UNUSED(work);
+
+	/* Drain the whole FIFO: several commits may have coalesced into this
+	 * one run. Frames are encoded back-to-back under one lock and the TX
+	 * interrupt is kicked once for the batch, or sooner if the ring fills.
+	 */
+	tx_lock();
+	while ((async_data = k_fifo_get(&fifo_usb_cdc_async_data, K_NO_WAIT)) != NULL) {
+		if (atomic_get(&pass_through_batching) && is_batchable_pass_through(async_data)) {
+			if (tx_put_pass_through_batch(async_data) == 0) {
+				queued = true;
 			}
+			continue;
 		}
+
+		if (cdc_acm_dev) {
+			/* NUS data skips the descriptor walk */
+			int err = is_pass_through(async_data)
+					  ? tx_put_pass_through(
+						    &async_data->message.message_body.pass_through_to_app)
+					  : tx_put_message(mouthware_message_RelayToAppMessage_fields,
+							   &async_data->message);
+
+			if (err == 0) {
+				queued = true;
+			} else if (async_data->message.which_message_body ==
+				   mouthware_message_RelayToAppMessage_sensor_frame_delta_tag) {
+				/* The host cannot decode the next delta without this one */
+				sensor_codec_resync();
+			}
+		}
+
+		/* Return the slot to the pool */
+		k_mem_slab_free(&usb_cdc_async_slab, async_data);
+	}
+
+	struct ring_buf *ring = tx_ring;
+
+	k_mutex_unlock(&cdc0_tx_lock);
+
+	if (queued) {
+		tx_kick(ring);
 	}
-	
-	return crc & 0xFFFF;
 }
 
 /* UART interrupt callback for CDC0 */
@@ -92,13 +341,57 @@ static void cdc0_uart_callback(const struct device *dev, void *user_data)
 	uart_irq_update(dev);
 
 	if (uart_irq_rx_ready(dev)) {
-		uint8_t buffer[64];
-		int recv_len;
+		bool received = false;
+
+		/* Read straight into the ring buffer until the FIFO is empty */
+		for (;;) {
+			uint8_t *buf;
+			uint32_t space = ring_buf_put_claim(&cdc0_rx_ringbuf, &buf, CDC0_RX_RINGBUF_SIZE);
 
-		recv_len = uart_fifo_read(dev, buffer, sizeof(buffer));
-		if (recv_len > 0) {
-			LOG_INF("CDC0 IRQ RX: %d bytes", recv_len);
-			ring_buf_put(&cdc0_rx_ringbuf, buffer, recv_len);
+			if (space == 0) {
+				/* Full: stop taking data so the host is NAKed instead of
+				 * losing bytes; the RX thread re-enables once it drains.
+				 */
+				uart_irq_rx_disable(dev);
+				atomic_set(&cdc0_rx_throttled, 1);
+				atomic_inc(&cdc0_rx_throttles);
+				received = true;
+				break;
+			}
+
+			int recv_len = uart_fifo_read(dev, buf, space);
+
+			ring_buf_put_finish(&cdc0_rx_ringbuf, MAX(recv_len, 0));
+			if (recv_len <= 0) {
+				break;
+			}
+			received = true;
+		}
+
+		/* Wake the RX thread once for the whole batch */
+		if (received) {
+			k_sem_give(&cdc0_rx_sem);
+		}
+	}
+
+	if (uart_irq_tx_ready(dev)) {
+		uint8_t *buf;
+		uint32_t len = ring_buf_get_claim(&cdc0_tx_ringbuf, &buf, CDC0_TX_RINGBUF_SIZE);
+
+		if (len == 0) {
+			uart_irq_tx_disable(dev);
+			/* A sender may have queued data after the claim above */
+			if (!ring_buf_is_empty(&cdc0_tx_ringbuf)) {
+				uart_irq_tx_enable(dev);
+			}
+		} else {
+			int sent = uart_fifo_fill(dev, buf, len);
+
+			ring_buf_get_finish(&cdc0_tx_ringbuf, MAX(sent, 0));
+			if (sent > 0) {
+				atomic_set(&cdc0_tx_stalled, 0);
+				k_sem_give(&cdc0_tx_space_sem);
+			}
 		}
 	}
 }
@@ -117,6 +410,7 @@ int usb_cdc_init(void)
 
 	/* Initialize ring buffer for CDC0 RX */
 	ring_buf_init(&cdc0_rx_ringbuf, sizeof(cdc0_rx_ringbuf_data), cdc0_rx_ringbuf_data);
+	ring_buf_init(&cdc0_tx_ringbuf, sizeof(cdc0_tx_ringbuf_data), cdc0_tx_ringbuf_data);
 
 	/* Set up interrupt-driven UART for CDC0 */
 	uart_irq_callback_user_data_set(cdc_acm_dev, cdc0_uart_callback, NULL);
@@ -133,6 +427,104 @@ int usb_cdc_init(void)
 }
 
 /* Send data to USB CDC with robust packet framing */
+/* Wait, with cdc0_tx_lock held, until tx_ring has room for frame_len
+ * bytes. Waits for the IRQ callback to make room unless the host has already
+ * stopped reading, so a stalled port never blocks callers repeatedly.
+ */
+static int tx_wait_for_space(uint32_t frame_len)
+{
+	if (IS_ENABLED(CONFIG_RELAY_FAULT_INJECT) && fault_inject_cdc_stalled()) {
+		cdc0_tx_dropped++;
+		trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_CDC_TX);
+		return -EAGAIN;
+	}
+
+	/* Frames queued earlier under this hold are not moving yet; the
+	 * drain takes from the ring without cdc0_tx_lock, so start it now
+	 */
+	if (ring_buf_space_get(tx_ring) < frame_len) {
+		tx_kick(tx_ring);
+	}
+
+	while (ring_buf_space_get(tx_ring) < frame_len) {
+		if (atomic_get(&cdc0_tx_stalled) ||
+		    k_sem_take(&cdc0_tx_space_sem, CDC0_TX_WAIT_TIMEOUT) != 0) {
+			atomic_set(&cdc0_tx_stalled, 1);
+			cdc0_tx_dropped++;
+			trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_CDC_TX);
+			LOG_DBG("CDC0 TX ring full, dropping %u byte frame", frame_len);
+			return -EAGAIN;
+		}
+	}
+
+	return 0;
+}
+
+/* Copy into claimed TX ring space; committed later by ring_buf_put_finish */
+static bool tx_claim_write(const uint8_t *data, size_t len)
+{
+	while (len > 0) {
+		uint8_t *dst;
+		uint32_t n = ring_buf_put_claim(tx_ring, &dst, len);
+
+		if (n == 0) {
+			return false;
+		}
+		memcpy(dst, data, n);
+		data += n;
+		len -= n;
+	}
+
+	return true;
+}
+
+/* pb_ostream_t callback: encode straight into the TX ring, CRC on the fly */
+static bool tx_ostream_write(pb_ostream_t *stream, const pb_byte_t *buf, size_t count)
+{
+	uint16_t *crc = stream->state;
+
+	*crc = mouthpad_crc16_update(*crc, buf, count);
+	return tx_claim_write(buf, count);
+}
+
+/* pb_ostream_t callback for a COBS frame */
+static bool tx_cobs_ostream_write(pb_ostream_t *stream, const pb_byte_t *buf, size_t count)
+{
+	ARG_UNUSED(stream);
+
+	mouthpad_cobs_put(&tx_cobs_encoder, buf, count);
+	return true;
+}
+
+/* Close the COBS frame in tx_cobs_buf and queue it. Called with
+ * cdc0_tx_lock held.
+ */
+static int tx_put_cobs(void)
+{
+	size_t frame_len = mouthpad_cobs_end(&tx_cobs_encoder);
+	int err = tx_wait_for_space(frame_len);
+
+	if (err) {
+		return err;
+	}
+
+	ring_buf_put(tx_ring, tx_cobs_buf, frame_len);
+	cdc0_tx_high_water = MAX(cdc0_tx_high_water, ring_buf_size_get(tx_ring));
+
+	return 0;
+}
+
+static void tx_frame_queued(void)
+{
+	struct ring_buf *ring = tx_ring;
+
+	cdc0_tx_high_water = MAX(cdc0_tx_high_water, ring_buf_size_get(ring));
+	k_mutex_unlock(&cdc0_tx_lock);
+
+	tx_kick(ring);
+}
+
+/* Send data through USB CDC with packet framing */
 int usb_cdc_send_data(const uint8_t *data, uint16_t len)
 {
 	if (!data || len == 0) {
@@ -144,31 +536,286 @@ int usb_cdc_send_data(const uint8_t *data, uint16_t len)
 		return -ENODEV;
 	}
 
+	uint32_t frame_len = len + MOUTHPAD_FRAME_OVERHEAD;
+
+	if (frame_len > CDC0_TX_RINGBUF_SIZE) {
+		return -EMSGSIZE;
+	}
+
 	LOG_DBG("Forwarding %d bytes to CDC with framing", len);
-	
+
 	// Calculate CRC-16 for the payload
-	uint16_t crc = calculate_crc16(data, len);
-	
-	// Send dual start markers
-	uart_poll_out(cdc_acm_dev, 0xAA); // First start marker
-	uart_poll_out(cdc_acm_dev, 0x55); // Second start marker
-	
-	// Send packet length (2 bytes, big-endian)
-	uart_poll_out(cdc_acm_dev, (len >> 8) & 0xFF); // High byte
-	uart_poll_out(cdc_acm_dev, len & 0xFF);        // Low byte
-	
-	// Send packet data
-	for (uint16_t i = 0; i < len; i++) {
-		uart_poll_out(cdc_acm_dev, data[i]);
-	}
-	
-	// Send CRC (2 bytes, big-endian)
-	uart_poll_out(cdc_acm_dev, (crc >> 8) & 0xFF); // CRC high byte
-	uart_poll_out(cdc_acm_dev, crc & 0xFF);        // CRC low byte
-	
+	uint16_t crc = mouthpad_crc16(data, len);
+
+	// Dual start markers, then packet length (2 bytes, big-endian)
+	const uint8_t header[] = {
+		MOUTHPAD_FRAME_MAGIC1, MOUTHPAD_FRAME_MAGIC2, (len >> 8) & 0xFF, len & 0xFF
+	};
+	// CRC (2 bytes, big-endian)
+	const uint8_t trailer[] = { (crc >> 8) & 0xFF, crc & 0xFF };
+
+	tx_lock();
+
+	if (atomic_get(&tx_cobs)) {
+		if (len > MOUTHPAD_FRAME_MAX_PAYLOAD) {
+			k_mutex_unlock(&cdc0_tx_lock);
+			return -EMSGSIZE;
+		}
+
+		mouthpad_cobs_begin(&tx_cobs_encoder, tx_cobs_buf);
+		mouthpad_cobs_put(&tx_cobs_encoder, data, len);
+
+		int err = tx_put_cobs();
+
+		if (err) {
+			k_mutex_unlock(&cdc0_tx_lock);
+			return err;
+		}
+		tx_frame_queued();
+		return 0;
+	}
+
+	int err = tx_wait_for_space(frame_len);
+
+	if (err) {
+		k_mutex_unlock(&cdc0_tx_lock);
+		return err;
+	}
+
+	ring_buf_put(tx_ring, header, sizeof(header));
+	ring_buf_put(tx_ring, data, len);
+	ring_buf_put(tx_ring, trailer, sizeof(trailer));
+	tx_frame_queued();
+
+	return 0;
+}
+
+/* Encode a protobuf message straight into the TX ring as one frame. Called
+ * with cdc0_tx_lock held; the caller enables the TX interrupt afterwards.
+ */
+static int tx_put_message(const pb_msgdesc_t *fields, const void *message)
+{
+	size_t len;
+
+	/* Sizing pass: the length goes in the header ahead of the payload */
+	if (!pb_get_encoded_size(&len, fields, message)) {
+		LOG_ERR("Failed to size message");
+		return -EINVAL;
+	}
+
+	uint32_t frame_len = len + MOUTHPAD_FRAME_OVERHEAD;
+
+	if (len == 0 || frame_len > CDC0_TX_RINGBUF_SIZE) {
+		return len == 0 ? -EINVAL : -EMSGSIZE;
+	}
+
+	if (atomic_get(&tx_cobs)) {
+		pb_ostream_t cobs_stream = {
+			.callback = tx_cobs_ostream_write,
+			.max_size = len,
+		};
+
+		if (len > MOUTHPAD_FRAME_MAX_PAYLOAD) {
+			return -EMSGSIZE;
+		}
+
+		mouthpad_cobs_begin(&tx_cobs_encoder, tx_cobs_buf);
+		relay_sysview_mark_start(RELAY_MARKER_PB_ENCODE);
+		bool encoded = pb_encode(&cobs_stream, fields, message);
+		relay_sysview_mark_stop(RELAY_MARKER_PB_ENCODE);
+
+		if (!encoded) {
+			LOG_ERR("Encoding failed: %s", PB_GET_ERROR(&cobs_stream));
+			return -EIO;
+		}
+		return tx_put_cobs();
+	}
+
+	const uint8_t header[] = {
+		MOUTHPAD_FRAME_MAGIC1, MOUTHPAD_FRAME_MAGIC2, (len >> 8) & 0xFF, len & 0xFF
+	};
+	uint16_t crc = MOUTHPAD_CRC16_INIT;
+	pb_ostream_t stream = {
+		.callback = tx_ostream_write,
+		.state = &crc,
+		.max_size = len,
+	};
+
+	int err = tx_wait_for_space(frame_len);
+
+	if (err) {
+		return err;
+	}
+
+	relay_sysview_mark_start(RELAY_MARKER_PB_ENCODE);
+	bool encoded = tx_claim_write(header, sizeof(header)) && pb_encode(&stream, fields, message);
+	relay_sysview_mark_stop(RELAY_MARKER_PB_ENCODE);
+
+	if (!encoded) {
+		/* Nothing is committed until ring_buf_put_finish */
+		ring_buf_put_finish(tx_ring, 0);
+		LOG_ERR("Encoding failed: %s", PB_GET_ERROR(&stream));
+		return -EIO;
+	}
+
+	const uint8_t trailer[] = { (crc >> 8) & 0xFF, crc & 0xFF };
+
+	tx_claim_write(trailer, sizeof(trailer));
+	ring_buf_put_finish(tx_ring, frame_len);
+	cdc0_tx_high_water = MAX(cdc0_tx_high_water, ring_buf_size_get(tx_ring));
+
+	return 0;
+}
+
+/* Frame a PassThroughToApp with the hand encoder instead of pb_encode: the
+ * fixed tags and lengths go around the data, which is copied into the TX
+ * ring once. A host speaking channels gets the data behind a channel
+ * header instead, with nothing after it. Called with cdc0_tx_lock held,
+ * like tx_put_message.
+ */
+static int tx_put_pass_through(const mouthware_message_PassThroughToApp *pass_through)
+{
+	const uint8_t *data = pass_through->data.bytes;
+	size_t data_len = pass_through->data.size;
+	bool channel = relay_dispatch_channels() && !pass_through->more_fragments &&
+		       pass_through->fragment == 0;
+	size_t len = channel ? MOUTHPAD_CHANNEL_HEADER_SIZE + data_len
+			     : mouthpad_pass_through_to_app_size(data_len,
+								 pass_through->more_fragments,
+								 pass_through->fragment,
+								 pass_through->device_index);
+	uint32_t frame_len = len + MOUTHPAD_FRAME_OVERHEAD;
+
+	if (frame_len > CDC0_TX_RINGBUF_SIZE) {
+		return -EMSGSIZE;
+	}
+
+	uint8_t header[MOUTHPAD_FRAME_HEADER_SIZE + MOUTHPAD_PASS_THROUGH_TO_APP_HEADER_MAX] = {
+		MOUTHPAD_FRAME_MAGIC1, MOUTHPAD_FRAME_MAGIC2, (len >> 8) & 0xFF, len & 0xFF
+	};
+	uint8_t trailer[MOUTHPAD_PASS_THROUGH_TO_APP_TRAILER_MAX + MOUTHPAD_FRAME_CRC_SIZE];
+	size_t header_len = MOUTHPAD_FRAME_HEADER_SIZE;
+	size_t trailer_len = 0;
+
+	if (channel) {
+		header_len += mouthpad_channel_header(&header[MOUTHPAD_FRAME_HEADER_SIZE],
+						      MOUTHPAD_CHANNEL_NUS,
+						      pass_through->device_index);
+	} else {
+		header_len += mouthpad_pass_through_to_app_header(
+			&header[MOUTHPAD_FRAME_HEADER_SIZE], data_len,
+			pass_through->more_fragments, pass_through->fragment,
+			pass_through->device_index);
+		trailer_len = mouthpad_pass_through_to_app_trailer(
+			trailer, pass_through->more_fragments, pass_through->fragment,
+			pass_through->device_index);
+	}
+
+	if (atomic_get(&tx_cobs)) {
+		if (len > MOUTHPAD_FRAME_MAX_PAYLOAD) {
+			return -EMSGSIZE;
+		}
+
+		mouthpad_cobs_begin(&tx_cobs_encoder, tx_cobs_buf);
+		mouthpad_cobs_put(&tx_cobs_encoder, &header[MOUTHPAD_FRAME_HEADER_SIZE],
+				  header_len - MOUTHPAD_FRAME_HEADER_SIZE);
+		mouthpad_cobs_put(&tx_cobs_encoder, data, data_len);
+		mouthpad_cobs_put(&tx_cobs_encoder, trailer, trailer_len);
+		return tx_put_cobs();
+	}
+
+	uint16_t crc = mouthpad_crc16_update(MOUTHPAD_CRC16_INIT,
+					     &header[MOUTHPAD_FRAME_HEADER_SIZE],
+					     header_len - MOUTHPAD_FRAME_HEADER_SIZE);
+
+	crc = mouthpad_crc16_update(crc, data, data_len);
+	crc = mouthpad_crc16_update(crc, trailer, trailer_len);
+	trailer[trailer_len++] = (crc >> 8) & 0xFF;
+	trailer[trailer_len++] = crc & 0xFF;
+
+	int err = tx_wait_for_space(frame_len);
+
+	if (err) {
+		return err;
+	}
+
+	tx_claim_write(header, header_len);
+	tx_claim_write(data, data_len);
+	tx_claim_write(trailer, trailer_len);
+	ring_buf_put_finish(tx_ring, frame_len);
+	cdc0_tx_high_water = MAX(cdc0_tx_high_water, ring_buf_size_get(tx_ring));
+
 	return 0;
 }
 
+/* Encode a protobuf message straight into the TX ring as one frame */
+int usb_cdc_send_message(const pb_msgdesc_t *fields, const void *message)
+{
+	if (!cdc_acm_dev) {
+		LOG_WRN("CDC ACM device not initialized");
+		return -ENODEV;
+	}
+
+	tx_lock();
+	int err = tx_put_message(fields, message);
+	struct ring_buf *ring = tx_ring;
+
+	k_mutex_unlock(&cdc0_tx_lock);
+
+	if (!err) {
+		tx_kick(ring);
+	}
+
+	return err;
+}
+
+void usb_cdc_get_tx_stats(struct usb_cdc_tx_stats *stats)
+{
+	k_mutex_lock(&cdc0_tx_lock, K_FOREVER);
+	stats->capacity = CDC0_TX_RINGBUF_SIZE;
+	stats->used = ring_buf_size_get(&cdc0_tx_ringbuf) +
+		      ring_buf_size_get(&relay_hid_tx_ringbuf) +
+		      ring_buf_size_get(&webusb_tx_ringbuf);
+	stats->high_water = cdc0_tx_high_water;
+	stats->dropped = cdc0_tx_dropped;
+	k_mutex_unlock(&cdc0_tx_lock);
+
+	stats->msg_slots = CONFIG_USB_CDC_ASYNC_MSG_SLOTS;
+	stats->msg_slot_size = sizeof(struct usb_cdc_async_data_t);
+	stats->msg_slots_used = k_mem_slab_num_used_get(&usb_cdc_async_slab);
+	stats->msg_high_water = atomic_get(&usb_cdc_async_high_water);
+	stats->msg_dropped = atomic_get(&usb_cdc_async_dropped);
+
+	stats->rx_capacity = CDC0_RX_RINGBUF_SIZE;
+	stats->rx_high_water = atomic_get(&cdc0_rx_high_water);
+	stats->rx_throttles = atomic_get(&cdc0_rx_throttles);
+}
+
+uint32_t usb_cdc_tx_queued(void)
+{
+	return ring_buf_size_get(&cdc0_tx_ringbuf) + ring_buf_size_get(&relay_hid_tx_ringbuf) +
+	       ring_buf_size_get(&webusb_tx_ringbuf);
+}
+
+uint32_t usb_cdc_async_queued(void)
+{
+	return k_mem_slab_num_used_get(&usb_cdc_async_slab);
+}
+
+void usb_cdc_reset_tx_stats(void)
+{
+	k_mutex_lock(&cdc0_tx_lock, K_FOREVER);
+	cdc0_tx_high_water = ring_buf_size_get(&cdc0_tx_ringbuf);
+	cdc0_tx_dropped = 0;
+	k_mutex_unlock(&cdc0_tx_lock);
+
+	atomic_set(&usb_cdc_async_high_water, k_mem_slab_num_used_get(&usb_cdc_async_slab));
+	atomic_set(&usb_cdc_async_dropped, 0);
+
+	atomic_set(&cdc0_rx_high_water, ring_buf_size_get(&cdc0_rx_ringbuf));
+	atomic_set(&cdc0_rx_throttles, 0);
+}
+
 /* Receive data from USB CDC */
 int usb_cdc_receive_data(uint8_t *buffer, uint16_t max_len)
 {
@@ -181,7 +828,68 @@ int usb_cdc_receive_data(uint8_t *buffer, uint16_t max_len)
 	}
 
 	/* Read from ring buffer (filled by interrupt callback) */
-	return ring_buf_get(&cdc0_rx_ringbuf, buffer, max_len);
+	uint32_t queued = ring_buf_size_get(&cdc0_rx_ringbuf);
+	int len = ring_buf_get(&cdc0_rx_ringbuf, buffer, max_len);
+
+	if (queued > (uint32_t)atomic_get(&cdc0_rx_high_water)) {
+		atomic_set(&cdc0_rx_high_water, queued);
+	}
+
+	/* The RX thread reads until the ring is empty, so resuming on a
+	 * threshold cannot leave RX off for good
+	 */
+	if (ring_buf_space_get(&cdc0_rx_ringbuf) >= CDC0_RX_RESUME_SPACE &&
+	    atomic_cas(&cdc0_rx_throttled, 1, 0)) {
+		uart_irq_rx_enable(cdc_acm_dev);
+	}
+
+	return len;
+}
+
+/* Wait until the IRQ callback has put new data in the RX ring buffer */
+int usb_cdc_wait_for_data(k_timeout_t timeout)
+{
+	return k_sem_take(&cdc0_rx_sem, timeout);
+}
+
+void usb_cdc_wake_rx(void)
+{
+	k_sem_give(&cdc0_rx_sem);
+}
+
+void usb_cdc_set_route(enum usb_cdc_route route)
+{
+	/* A stall seen on one interface says nothing about another */
+	if (atomic_set(&tx_route, route) != route) {
+		atomic_set(&cdc0_tx_stalled, 0);
+	}
+}
+
+void usb_cdc_set_cobs(bool cobs)
+{
+	atomic_set(&tx_cobs, cobs);
+}
+
+static size_t tx_take(struct ring_buf *ring, uint8_t *buffer, size_t max_len)
+{
+	uint32_t n = ring_buf_get(ring, buffer, max_len);
+
+	if (n > 0) {
+		atomic_set(&cdc0_tx_stalled, 0);
+		k_sem_give(&cdc0_tx_space_sem);
+	}
+
+	return n;
+}
+
+size_t usb_cdc_relay_hid_take(uint8_t *buffer, size_t max_len)
+{
+	return tx_take(&relay_hid_tx_ringbuf, buffer, max_len);
+}
+
+size_t usb_cdc_webusb_take(uint8_t *buffer, size_t max_len)
+{
+	return tx_take(&webusb_tx_ringbuf, buffer, max_len);
 }
 
 /* Get CDC ACM device for external use */
@@ -190,26 +898,103 @@ const struct device *usb_cdc_get_uart_device(void)
 	return cdc_acm_dev;
 }
 
-/* Send USB CDC proto message asynchronously (non-blocking) */
-int usb_cdc_send_proto_message_async(mouthware_message_RelayToAppMessage message)
+void usb_cdc_set_pass_through_batching(bool enable)
+{
+	atomic_set(&pass_through_batching, enable);
+}
+
+bool usb_cdc_pass_through_batching(void)
+{
+	return atomic_get(&pass_through_batching);
+}
+
+/* Take a slot from the pool without clearing it; NULL (counted) when empty */
+static struct usb_cdc_async_data_t *async_slot_alloc(enum mem_site site)
 {
 	struct usb_cdc_async_data_t *async_data;
-	
-	/* Allocate memory for async data */
-	async_data = k_malloc(sizeof(struct usb_cdc_async_data_t));
+
+	if (k_mem_slab_alloc(&usb_cdc_async_slab, (void **)&async_data, K_NO_WAIT) != 0) {
+		mem_stats_take(site, false, 0);
+		atomic_inc(&usb_cdc_async_dropped);
+		trace_ring_count(TRACE_EVENT_QUEUE_FULL, TRACE_QUEUE_CDC_ASYNC);
+		LOG_DBG("No free async USB CDC message slot");
+		return NULL;
+	}
+
+	atomic_val_t used = k_mem_slab_num_used_get(&usb_cdc_async_slab);
+	atomic_val_t high_water;
+
+	mem_stats_take(site, true, used);
+
+	do {
+		high_water = atomic_get(&usb_cdc_async_high_water);
+	} while (used > high_water && !atomic_cas(&usb_cdc_async_high_water, high_water, used));
+
+	return async_data;
+}
+
+/* Send USB CDC proto message asynchronously (non-blocking) */
+mouthware_message_RelayToAppMessage *usb_cdc_message_reserve(void)
+{
+	struct usb_cdc_async_data_t *async_data = async_slot_alloc(MEM_SITE_CDC_MESSAGE);
+
 	if (!async_data) {
-		LOG_ERR("Failed to allocate memory for async USB CDC message");
-		return -ENOMEM;
+		return NULL;
 	}
-	
-	/* Copy the message */
-	async_data->message = message;
-	
+
+	async_data->message = (mouthware_message_RelayToAppMessage)
+		mouthware_message_RelayToAppMessage_init_zero;
+	/* A reply built by a request's handler answers that request */
+	async_data->message.request_id = relay_dispatch_request_id();
+
+	return &async_data->message;
+}
+
+void usb_cdc_message_commit(mouthware_message_RelayToAppMessage *message)
+{
+	struct usb_cdc_async_data_t *async_data =
+		CONTAINER_OF(message, struct usb_cdc_async_data_t, message);
+
 	/* Put message in FIFO */
 	k_fifo_put(&fifo_usb_cdc_async_data, async_data);
-	
+
 	/* Submit work to work queue */
-	k_work_submit(&usb_cdc_async_work);
-	
+	k_work_submit_to_queue(&relay_workq_realtime, &usb_cdc_async_work);
+}
+
+void usb_cdc_message_abort(mouthware_message_RelayToAppMessage *message)
+{
+	k_mem_slab_free(&usb_cdc_async_slab,
+			CONTAINER_OF(message, struct usb_cdc_async_data_t, message));
+}
+
+int usb_cdc_send_pass_through(const uint8_t *data, size_t len, uint32_t device_index)
+{
+	if (len > SIZEOF_FIELD(mouthware_message_PassThroughToApp_data_t, bytes)) {
+		return -EMSGSIZE;
+	}
+
+	struct usb_cdc_async_data_t *async_data = async_slot_alloc(MEM_SITE_CDC_PASS_THROUGH);
+
+	if (!async_data) {
+		return -ENOMEM;
+	}
+
+	/* Set only the fields that get encoded rather than zeroing the whole
+	 * slot; this runs for every NUS notification
+	 */
+	mouthware_message_PassThroughToApp *pass_through =
+		&async_data->message.message_body.pass_through_to_app;
+
+	async_data->message.which_message_body =
+		mouthware_message_RelayToAppMessage_pass_through_to_app_tag;
+	pass_through->data.size = len;
+	memcpy(pass_through->data.bytes, data, len);
+	pass_through->more_fragments = false;
+	pass_through->fragment = 0;
+	pass_through->device_index = device_index;
+
+	usb_cdc_message_commit(&async_data->message);
+
 	return 0;
 }
@@ -26,18 +26,99 @@ struct uart_data_t {
 	uint16_t len;
 };
 
+/* CDC0 TX ring buffer usage in bytes, and async message slot usage */
+struct usb_cdc_tx_stats {
+	uint32_t capacity;   /* Ring buffer size */
+	uint32_t used;       /* Bytes queued right now */
+	uint32_t high_water; /* Most bytes ever queued since the last reset */
+	uint32_t dropped;    /* Frames dropped because the ring stayed full */
+
+	uint32_t msg_slots;      /* Async message pool size */
+	uint32_t msg_slot_size;  /* Bytes per slot */
+	uint32_t msg_slots_used; /* Slots reserved or queued right now */
+	uint32_t msg_high_water; /* Most slots ever in use since the last reset */
+	uint32_t msg_dropped;    /* Reservations refused because the pool was empty */
+
+	uint32_t rx_capacity;   /* RX ring buffer size */
+	uint32_t rx_high_water; /* Most bytes ever waiting for the parser since the last reset */
+	uint32_t rx_throttles;  /* Times RX was paused, NAKing the host, because the ring filled */
+};
+
 /* USB CDC initialization and control functions */
 int usb_cdc_init(void);
 int usb_cdc_send_data(const uint8_t *data, uint16_t len);
+void usb_cdc_get_tx_stats(struct usb_cdc_tx_stats *stats);
+
+/* Bytes and async message slots queued right now, read without taking the
+ * TX lock; for diagnostics from a context that must not block
+ */
+uint32_t usb_cdc_tx_queued(void);
+uint32_t usb_cdc_async_queued(void);
+void usb_cdc_reset_tx_stats(void);
 int usb_cdc_receive_data(uint8_t *buffer, uint16_t max_len);
 
+/* Block until CDC0 RX data is available (0) or the timeout expires (-EAGAIN) */
+int usb_cdc_wait_for_data(k_timeout_t timeout);
+
+/* Wake usb_cdc_wait_for_data(); the relay HID and WebUSB interfaces share
+ * its RX thread
+ */
+void usb_cdc_wake_rx(void);
+
+/* Interfaces carrying the framed relay protocol */
+enum usb_cdc_route {
+	USB_CDC_ROUTE_CDC0,
+	USB_CDC_ROUTE_RELAY_HID,
+	USB_CDC_ROUTE_WEBUSB,
+};
+
+/* Pick the interface framed writes go to. Set by the RX thread from the
+ * interface each frame arrived on; CDC0 is used anyway while the chosen
+ * interface is not configured.
+ */
+void usb_cdc_set_route(enum usb_cdc_route route);
+
+/* Frame writes in COBS rather than [0xAA 0x55][len] (see mouthpad_frame.h).
+ * Set by the RX thread from the framing of each frame the host sent.
+ */
+void usb_cdc_set_cobs(bool cobs);
+
+/* Take up to max_len queued bytes for the relay HID interface; its TX
+ * thread only. Returns the number of bytes taken.
+ */
+size_t usb_cdc_relay_hid_take(uint8_t *buffer, size_t max_len);
+
+/* Same for the WebUSB interface */
+size_t usb_cdc_webusb_take(uint8_t *buffer, size_t max_len);
+
 #include "MouthpadRelay.pb.h"
 
-/* Async USB CDC proto message sending (non-blocking) */
-int usb_cdc_send_proto_message_async(mouthware_message_RelayToAppMessage message);
+/* Encode a protobuf message directly into the CDC0 TX ring as one frame */
+int usb_cdc_send_message(const pb_msgdesc_t *fields, const void *message);
 
-/* CRC calculation for packet framing */
-uint16_t calculate_crc16(const uint8_t *data, uint16_t len);
+/* Async USB CDC proto message sending (non-blocking). Reserve a zeroed
+ * message slot from the pool, fill it in place, then commit it to queue it
+ * for the real-time work queue, or abort to return it unsent. Reserve returns
+ * NULL (and counts a drop) when every slot is in use.
+ */
+mouthware_message_RelayToAppMessage *usb_cdc_message_reserve(void);
+void usb_cdc_message_commit(mouthware_message_RelayToAppMessage *message);
+void usb_cdc_message_abort(mouthware_message_RelayToAppMessage *message);
+
+/* Queue NUS data as a PassThroughToApp message. Only the data is copied
+ * into the slot, and unbatched frames are written by the hand encoder in
+ * mouthpad_pass_through.h rather than pb_encode. Returns -EMSGSIZE if len
+ * exceeds the data field, -ENOMEM if every slot is in use. device_index is
+ * 0 for the primary MouthPad and 1.. for secondary links.
+ */
+int usb_cdc_send_pass_through(const uint8_t *data, size_t len, uint32_t device_index);
+
+/* When enabled, queued PassThroughToApp messages are sent as
+ * PassThroughToAppBatch frames of consecutive sequence-numbered chunks.
+ * Data from secondary MouthPads is always sent unbatched.
+ */
+void usb_cdc_set_pass_through_batching(bool enable);
+bool usb_cdc_pass_through_batching(void);
 
 /* Get UART device for external use */
 const struct device *usb_cdc_get_uart_device(void);
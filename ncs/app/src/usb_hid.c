@@ -14,11 +14,24 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/sys/util.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/usb/usbd.h>
 #include <zephyr/usb/class/usbd_hid.h>
 #include <zephyr/logging/log.h>
 #include <nrf.h>
 #include "sample_usbd.h"
+#include "connection_timing.h"
+#include "hid_idle.h"
+#include "mouthpad_hid_reports.h"
+#include "relay_events.h"
+#include "relay_time.h"
+#include "relay_usb_composition.h"
+#include "relay_workq.h"
+#include "trace_ring.h"
+#include "usb_hid.h"
+#include "usb_phase.h"
+#include "usb_relay_hid.h"
+#include "usb_raw_hid.h"
 
 LOG_MODULE_REGISTER(usb_mouse, LOG_LEVEL_INF);
 
@@ -35,6 +48,14 @@ static const struct gpio_dt_spec led2 = GPIO_DT_SPEC_GET(DT_ALIAS(led2), gpios);
 const struct device *hid_dev;
 struct k_sem ep_write_sem;
 
+#if defined(CONFIG_USB_HID_SPLIT)
+BUILD_ASSERT(DT_NODE_EXISTS(DT_NODELABEL(hid_controls)),
+	     "CONFIG_USB_HID_SPLIT needs the hid_controls node (snippet hidsplit)");
+
+/* Consumer control and keyboard, when split off hid_dev */
+const struct device *hid_controls_dev;
+#endif
+
 /* USB device context for new stack */
 static struct usbd_context *usbd_ctx;
 
@@ -42,6 +63,17 @@ static struct usbd_context *usbd_ctx;
 static struct k_work_delayable usb_enum_check_work;
 static bool usb_enumerated = false;
 
+/* USB-only restart: usbd_disable(), then usbd_enable() after the hold */
+static void usb_restart_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(usb_restart_work, usb_restart_handler);
+static atomic_t usb_restarting;
+static atomic_t usb_restarts; /* Since the host last configured the device */
+static bool usb_restart_held;
+
+/* Host suspend state; the main loop parks the bridge while it is set */
+static atomic_t usb_suspended;
+static atomic_t wakeup_requested;
+
 #define USB_ENUM_TIMEOUT_MS 3000  /* 3 seconds - balanced: fast recovery with safety margin */
 #define USB_ENUM_RETRY_MAGIC 0xE1  /* Magic value to track retry */
 
@@ -50,49 +82,48 @@ static bool usb_enumerated = false;
  * ============================================================================ */
 
 /* USB HID Report Descriptor for MouthPad device
- * 
- * Report Structure:
- * - Report ID 1: Buttons (5 bits) + Padding (3 bits) + Wheel (8 bits) = 16 bits
- * - Report ID 2: X movement (12 bits) + Y movement (12 bits) = 24 bits  
- * - Report ID 3: Consumer controls (volume, media keys, etc.)
- * 
- * This descriptor matches the MouthPad BLE device exactly to eliminate scaling
+ *
+ * Report IDs, sizes and layout live in the shared mouthpad_hid_reports.h
+ * table so the nRF and ESP firmwares enumerate identically.
  */
 static const uint8_t hid_report_desc[] = {
-	0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x95, 
-	0x05, 0x75, 0x01, 0x05, 0x09, 0x19, 0x01, 0x29, 0x05, 0x15, 0x00, 0x25, 0x01, 
-	0x81, 0x02, 0x95, 0x01, 0x75, 0x03, 0x81, 0x01, 0x75, 0x08, 0x95, 0x01, 0x05, 
-	0x01, 0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x81, 0x06, 0x05, 0x0C, 0x0A, 0x38, 
-	0x02, 0x95, 0x01, 0x81, 0x06, 0xC0, 0x85, 0x02, 0x09, 0x01, 0xA1, 0x00, 0x75, 
-	0x0C, 0x95, 0x02, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x16, 0x01, 0xF8, 0x26, 
-	0xFF, 0x07, 0x81, 0x06, 0xC0, 0x85, 0x03, 0x05, 0x0C, 0x19, 0x00, 0x2A, 0x3C, 
-	0x02, 0x15, 0x00, 0x26, 0x3C, 0x02, 0x75, 0x10, 0x95, 0x01, 0x81, 0x00, 0xC0, 
-	0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x04, 0x05, 0x07, 0x19, 0xE0, 0x29, 
-	0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01, 
-	0x75, 0x08, 0x81, 0x01, 0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05, 
-	0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0
+#if IS_ENABLED(CONFIG_USB_HID_SPLIT) && IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+	MOUTHPAD_HID_REPORT_DESC_POINTER_COMBINED
+#elif IS_ENABLED(CONFIG_USB_HID_SPLIT)
+	MOUTHPAD_HID_REPORT_DESC_POINTER
+#elif IS_ENABLED(CONFIG_HID_COMBINED_MOUSE) && IS_ENABLED(CONFIG_HID_OUTPUT_REPORTS)
+	MOUTHPAD_HID_REPORT_DESC_COMBINED_OUTPUT
+#elif IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+	MOUTHPAD_HID_REPORT_DESC_COMBINED
+#elif IS_ENABLED(CONFIG_HID_OUTPUT_REPORTS)
+	MOUTHPAD_HID_REPORT_DESC_OUTPUT
+#else
+	MOUTHPAD_HID_REPORT_DESC
+#endif
 };
 
-/* ============================================================================
- * CONSTANTS AND ENUMERATIONS
- * ============================================================================ */
+#if defined(CONFIG_USB_HID_SPLIT)
+/* Consumer control (ID 3) and keyboard (ID 4) on hid_controls */
+static const uint8_t hid_controls_desc[] = {
+#if IS_ENABLED(CONFIG_HID_OUTPUT_REPORTS)
+	MOUTHPAD_HID_REPORT_DESC_CONTROLS_OUTPUT
+#else
+	MOUTHPAD_HID_REPORT_DESC_CONTROLS
+#endif
+};
+#endif
 
-/* Maximum size for HID reports */
-#define MAX_REPORT_SIZE 8
+/* Receives host output reports, report ID first */
+static usb_hid_output_cb_t output_cb;
 
-/* Report structure indices for parsing */
-enum mouse_report1_idx {
-	MOUSE_BTN_REPORT_IDX = 0,    /* Buttons byte */
-	MOUSE_WHEEL_REPORT_IDX = 1,  /* Wheel byte */
-	MOUSE_REPORT1_COUNT = 2,     /* Total bytes in Report 1 */
-};
+/* Redundant reports are not forwarded and unchanged ones are repeated at
+ * the idle rate the host set (hid_idle.h). The lock serializes the BT RX
+ * thread's filtering with the repeats, sent from the realtime queue.
+ */
+static struct k_spinlock idle_lock;
 
-enum mouse_report2_idx {
-	MOUSE_X_LOW_REPORT_IDX = 0,           /* X low 8 bits */
-	MOUSE_X_HIGH_Y_LOW_REPORT_IDX = 1,    /* X high 4 bits + Y low 4 bits */
-	MOUSE_Y_HIGH_REPORT_IDX = 2,          /* Y high 8 bits */
-	MOUSE_REPORT2_COUNT = 3,              /* Total bytes in Report 2 */
-};
+static void idle_repeat_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(idle_repeat_work, idle_repeat_handler);
 
 /* ============================================================================
  * USB CALLBACK FUNCTIONS
@@ -102,9 +133,9 @@ enum mouse_report2_idx {
  * @brief Trigger USB enumeration retry via system reset
  *
  * Increments retry counter and performs system reset if under retry limit.
- * Used for both timeout-based and error-based recovery.
+ * The last resort once USB-only restarts have not helped.
  */
-static void trigger_usb_recovery_reset(const char *reason)
+static void trigger_usb_recovery_reset(const char *reason, enum trace_usb_recovery cause)
 {
 	/* Check retry counter to prevent infinite reboot loop */
 	uint8_t retry_count = NRF_POWER->GPREGRET2;
@@ -120,6 +151,7 @@ static void trigger_usb_recovery_reset(const char *reason)
 
 	/* Increment retry counter */
 	NRF_POWER->GPREGRET2 = retry_count + 1;
+	trace_ring_record(TRACE_EVENT_USB_RECOVERY, cause, retry_count + 1);
 
 	/* Extended disconnect - longer on each retry to handle stubborn hosts/hubs */
 	NRF_USBD->USBPULLUP = 0;
@@ -128,6 +160,76 @@ static void trigger_usb_recovery_reset(const char *reason)
 	NVIC_SystemReset();
 }
 
+/**
+ * @brief Restart the USB device stack only, keeping the MouthPad link
+ *
+ * Runs twice on the background queue: first to disable the stack, which
+ * drops the pullup, then CONFIG_USB_SOFT_RECOVERY_HOLD_MS later to enable
+ * it again and re-arm the enumeration watchdog.
+ */
+static void usb_restart_handler(struct k_work *work)
+{
+	int err;
+
+	ARG_UNUSED(work);
+
+	if (!usb_restart_held) {
+		err = usbd_disable(usbd_ctx);
+		if (err && err != -EALREADY) {
+			LOG_ERR("USB disable failed (err %d)", err);
+		}
+		usb_restart_held = true;
+		k_work_reschedule_for_queue(&relay_workq_background, &usb_restart_work,
+					    K_MSEC(CONFIG_USB_SOFT_RECOVERY_HOLD_MS));
+		return;
+	}
+
+	usb_restart_held = false;
+	usb_enumerated = false;
+	err = usbd_enable(usbd_ctx);
+	atomic_clear(&usb_restarting);
+	if (err && err != -EALREADY) {
+		LOG_ERR("USB enable failed (err %d)", err);
+		trigger_usb_recovery_reset("enable failed", TRACE_USB_RECOVERY_STACK_ERROR);
+		return;
+	}
+
+	LOG_INF("USB restarted - waiting for enumeration");
+	k_work_reschedule_for_queue(&relay_workq_background, &usb_enum_check_work,
+				    K_MSEC(USB_ENUM_TIMEOUT_MS));
+}
+
+/**
+ * @brief Recover from an enumeration failure
+ *
+ * Restarts USB alone up to CONFIG_USB_SOFT_RECOVERY_ATTEMPTS times in a
+ * row, so the MouthPad stays connected and a flaky hub costs a fraction of
+ * a second, then falls back to a system reset. Called from the usbd thread
+ * and the background queue.
+ */
+static void trigger_usb_recovery(const char *reason, enum trace_usb_recovery cause)
+{
+	atomic_val_t attempt;
+
+	if (atomic_get(&usb_restarting)) {
+		return;
+	}
+
+	attempt = atomic_inc(&usb_restarts) + 1;
+	if (usbd_ctx == NULL || attempt > CONFIG_USB_SOFT_RECOVERY_ATTEMPTS) {
+		trigger_usb_recovery_reset(reason, cause);
+		return;
+	}
+
+	LOG_WRN("USB enumeration failed (%s) - restarting USB only (attempt %ld/%d)",
+		reason, (long)attempt, CONFIG_USB_SOFT_RECOVERY_ATTEMPTS);
+	trace_ring_record(TRACE_EVENT_USB_RESTART, cause, (uint16_t)attempt);
+
+	atomic_set(&usb_restarting, 1);
+	k_work_cancel_delayable(&usb_enum_check_work);
+	k_work_reschedule_for_queue(&relay_workq_background, &usb_restart_work, K_NO_WAIT);
+}
+
 /**
  * @brief USB enumeration check handler
  *
@@ -142,7 +244,19 @@ static void usb_enum_check_handler(struct k_work *work)
 		return;
 	}
 
-	trigger_usb_recovery_reset("timeout");
+	trigger_usb_recovery("timeout", TRACE_USB_RECOVERY_TIMEOUT);
+}
+
+static void usb_set_suspended(bool suspended)
+{
+	if (suspended) {
+		atomic_clear(&wakeup_requested);
+	}
+	if (atomic_set(&usb_suspended, suspended) != suspended) {
+		LOG_INF("USB %s", suspended ? "suspended" : "resumed");
+		trace_ring_record(TRACE_EVENT_USB_SUSPEND, suspended, 0);
+		relay_events_post(RELAY_EVENT_USB_SUSPEND);
+	}
 }
 
 /**
@@ -157,11 +271,18 @@ static void usb_msg_cb(struct usbd_context *const ctx,
 
 	switch (msg->type) {
 	case USBD_MSG_RESET:
+		trace_ring_record(TRACE_EVENT_USB_RESET, 0, 0);
+		/* Idle rates go back to their default; the host sets them again */
+		K_SPINLOCK(&idle_lock) {
+			hid_idle_reset();
+		}
+		/* A reset also ends a suspend */
+		usb_set_suspended(false);
 		/* Bus reset detected - enumeration is starting */
 		if (!usb_enumerated) {
 			LOG_DBG("USB reset detected - starting enumeration watchdog");
 			/* (Re)start watchdog on each reset attempt */
-			k_work_reschedule(&usb_enum_check_work, K_MSEC(USB_ENUM_TIMEOUT_MS));
+			k_work_reschedule_for_queue(&relay_workq_background, &usb_enum_check_work, K_MSEC(USB_ENUM_TIMEOUT_MS));
 		}
 		break;
 
@@ -171,8 +292,10 @@ static void usb_msg_cb(struct usbd_context *const ctx,
 			/* USB successfully enumerated - cancel watchdog */
 			usb_enumerated = true;
 			k_work_cancel_delayable(&usb_enum_check_work);
-			/* Clear retry counter on successful enumeration */
+			/* Clear retry counters on successful enumeration */
 			NRF_POWER->GPREGRET2 = 0;
+			atomic_clear(&usb_restarts);
+			connection_timing_boot_mark(CONNECTION_TIMING_BOOT_USB_ENUMERATED);
 			LOG_INF("USB enumeration successful");
 		}
 		break;
@@ -180,13 +303,13 @@ static void usb_msg_cb(struct usbd_context *const ctx,
 	case USBD_MSG_UDC_ERROR:
 		/* Hardware controller error - restart immediately */
 		LOG_ERR("USB controller error detected");
-		trigger_usb_recovery_reset("UDC error");
+		trigger_usb_recovery("UDC error", TRACE_USB_RECOVERY_UDC_ERROR);
 		break;
 
 	case USBD_MSG_STACK_ERROR:
 		/* Unrecoverable stack error - restart immediately */
 		LOG_ERR("USB stack error detected");
-		trigger_usb_recovery_reset("stack error");
+		trigger_usb_recovery("stack error", TRACE_USB_RECOVERY_STACK_ERROR);
 		break;
 
 	case USBD_MSG_VBUS_READY:
@@ -205,10 +328,19 @@ static void usb_msg_cb(struct usbd_context *const ctx,
 		}
 		/* Cable unplugged - cancel watchdog */
 		k_work_cancel_delayable(&usb_enum_check_work);
+		usb_set_suspended(false);
+		break;
+
+	case USBD_MSG_SUSPEND:
+		usb_set_suspended(true);
+		break;
+
+	case USBD_MSG_RESUME:
+		usb_set_suspended(false);
 		break;
 
 	default:
-		/* Other events (SUSPEND, RESUME, etc.) - no action needed */
+		/* Other events - no action needed */
 		break;
 	}
 }
@@ -235,6 +367,35 @@ static int hid_get_report(const struct device *dev, const uint8_t type,
 	return 0;
 }
 
+/**
+ * @brief Hand a host output report to the registered callback
+ *
+ * Runs in the USB stack thread; the callback only queues it.
+ */
+static void hid_output_forward(uint8_t id, const uint8_t *buf, uint16_t len)
+{
+	uint8_t size = mouthpad_hid_output_size(id);
+	uint8_t report[1 + MOUTHPAD_HID_OUTPUT_SIZE_MAX];
+
+	if (!IS_ENABLED(CONFIG_HID_OUTPUT_REPORTS) || output_cb == NULL || size == 0) {
+		return;
+	}
+
+	/* Skip the report ID byte if the stack left it in */
+	if (len == size + 1 && buf[0] == id) {
+		buf++;
+		len--;
+	}
+	if (len > size) {
+		LOG_DBG("Output report %u too long (%u bytes)", id, len);
+		return;
+	}
+
+	report[0] = id;
+	memcpy(&report[1], buf, len);
+	output_cb(report, 1 + len);
+}
+
 /**
  * @brief HID set report callback
  */
@@ -242,24 +403,112 @@ static int hid_set_report(const struct device *dev, const uint8_t type,
 			  const uint8_t id, const uint16_t len, const uint8_t *const buf)
 {
 	LOG_DBG("Set report: type %u id %u len %u", type, id, len);
+
+	if (type == HID_REPORT_TYPE_OUTPUT) {
+		hid_output_forward(id, buf, len);
+	}
 	return 0;
 }
 
+/* Report IDs in the descriptor of an interface */
+static uint32_t idle_report_ids(const struct device *dev)
+{
+	uint32_t ids = 0;
+
+	for (uint8_t id = 1; id <= MOUTHPAD_HID_REPORT_ID_MAX; id++) {
+		if (IS_ENABLED(CONFIG_HID_COMBINED_MOUSE) &&
+		    id == MOUTHPAD_HID_REPORT_ID_MOUSE_MOTION) {
+			continue;
+		}
+		if (dev == NULL || usb_hid_dev_for(id) == dev) {
+			ids |= BIT(id);
+		}
+	}
+	return ids;
+}
+
+/* Size on the wire; Report ID 1 is larger in combined mouse mode */
+static uint8_t idle_report_size(uint8_t id)
+{
+	if (IS_ENABLED(CONFIG_HID_COMBINED_MOUSE) && id == MOUTHPAD_HID_COMBINED_REPORT_ID) {
+		return MOUTHPAD_HID_COMBINED_REPORT_SIZE;
+	}
+	return mouthpad_hid_report_size(id);
+}
+
+/* Schedule the next repeat unless one is already scheduled */
+static void idle_arm(void)
+{
+	uint32_t next;
+
+	K_SPINLOCK(&idle_lock) {
+		next = hid_idle_next(k_uptime_get_32());
+	}
+	if (next != HID_IDLE_NEVER) {
+		k_work_schedule_for_queue(&relay_workq_realtime, &idle_repeat_work, K_MSEC(next));
+	}
+}
+
+/* One repeat per run; the submit returns once the host has read it. A
+ * suspended host reads nothing, and the next report sent arms it again.
+ */
+static void idle_repeat_handler(struct k_work *work)
+{
+	static uint8_t report[1 + MOUTHPAD_HID_REPORT_SIZE_MAX];
+	uint8_t id = 0;
+	int err;
+
+	ARG_UNUSED(work);
+
+	if (usb_hid_is_suspended()) {
+		return;
+	}
+
+	K_SPINLOCK(&idle_lock) {
+		id = hid_idle_repeat(idle_report_ids(NULL), k_uptime_get_32(), &report[1]);
+	}
+	if (id != 0) {
+		report[0] = id;
+		err = hid_device_submit_report(usb_hid_dev_for(id), 1 + idle_report_size(id),
+					       report);
+		if (err) {
+			LOG_DBG("Idle repeat of report %u failed (err %d)", id, err);
+		}
+	}
+	idle_arm();
+}
+
 /**
  * @brief HID set idle callback
+ *
+ * Report ID 0 sets every report on the interface. The duration is in ms.
  */
 static void hid_set_idle(const struct device *dev, const uint8_t id, const uint32_t duration)
 {
-	LOG_DBG("Set Idle %u to %u", id, duration);
+	LOG_INF("HID %s idle rate of report %u: %u ms", dev->name, id, duration);
+
+	if (id == 0) {
+		uint32_t ids = idle_report_ids(dev);
+
+		for (uint8_t i = 1; i <= MOUTHPAD_HID_REPORT_ID_MAX; i++) {
+			if (ids & BIT(i)) {
+				hid_idle_set(i, duration);
+			}
+		}
+	} else {
+		hid_idle_set(id, duration);
+	}
+	idle_arm();
 }
 
 /**
  * @brief HID get idle callback
+ *
+ * Report ID 0 answers with the interface's first report.
  */
 static uint32_t hid_get_idle(const struct device *dev, const uint8_t id)
 {
-	LOG_DBG("Get Idle %u", id);
-	return 0;
+	return hid_idle_get(id != 0 ? id : find_lsb_set(idle_report_ids(dev)) - 1);
 }
 
 /**
@@ -278,7 +527,23 @@ static void hid_output_report(const struct device *dev, const uint16_t len,
 			      const uint8_t *const buf)
 {
 	LOG_HEXDUMP_DBG(buf, len, "HID output report");
+
+	if (len > 1) {
+		hid_output_forward(buf[0], &buf[1], len - 1);
+	}
+}
+
+#if defined(CONFIG_USB_HID_SOF_PHASE)
+/* usbd thread, once per frame and interface */
+static void hid_sof(const struct device *dev)
+{
+	if (dev != hid_dev) {
+		return;
+	}
+
+	usb_phase_sof(relay_time_us32());
 }
+#endif
 
 /* USB HID operations structure for new stack */
 static struct hid_device_ops hid_ops = {
@@ -289,12 +554,40 @@ static struct hid_device_ops hid_ops = {
 	.get_idle = hid_get_idle,
 	.set_protocol = hid_set_protocol,
 	.output_report = hid_output_report,
+#if defined(CONFIG_USB_HID_SOF_PHASE)
+	.sof = hid_sof,
+#endif
 };
 
 /* ============================================================================
  * PUBLIC FUNCTIONS
  * ============================================================================ */
 
+void usb_hid_register_output_cb(usb_hid_output_cb_t cb)
+{
+	output_cb = cb;
+}
+
+bool usb_hid_idle_filter(uint8_t report_id, const uint8_t *data, uint8_t size)
+{
+	bool send;
+
+	K_SPINLOCK(&idle_lock) {
+		send = hid_idle_filter(report_id, data, size, k_uptime_get_32());
+	}
+	if (send && hid_idle_get(report_id) != 0) {
+		idle_arm();
+	}
+	return send;
+}
+
+void usb_hid_idle_forget(uint8_t report_id)
+{
+	K_SPINLOCK(&idle_lock) {
+		hid_idle_forget(report_id);
+	}
+}
+
 /**
  * @brief Initialize USB HID device
  * 
@@ -340,8 +633,8 @@ int usb_init(void)
 	LOG_INF("No blue LED available for status indication");
 #endif
 
-	/* Get USB HID device from device tree */
-	hid_dev = DEVICE_DT_GET_ONE(zephyr_hid_device);
+	/* Get USB HID device from device tree; relay_hid is the other one */
+	hid_dev = DEVICE_DT_GET(DT_NODELABEL(hid_dev_0));
 	if (!device_is_ready(hid_dev)) {
 		LOG_ERR("HID Device is not ready");
 		return -ENODEV;
@@ -359,6 +652,37 @@ int usb_init(void)
 	}
 	LOG_INF("HID device registered successfully");
 
+#if defined(CONFIG_USB_HID_SPLIT)
+	/* Same callbacks; the output reports arrive on this one */
+	hid_controls_dev = DEVICE_DT_GET(DT_NODELABEL(hid_controls));
+	if (!device_is_ready(hid_controls_dev)) {
+		LOG_ERR("Controls HID device is not ready");
+		return -ENODEV;
+	}
+
+	ret = hid_device_register(hid_controls_dev,
+				  hid_controls_desc, sizeof(hid_controls_desc),
+				  &hid_ops);
+	if (ret != 0) {
+		LOG_ERR("Failed to register controls HID device, %d", ret);
+		return ret;
+	}
+#endif
+
+	/* The relay interface is optional; CDC0 still carries the protocol */
+	ret = usb_relay_hid_init();
+	if (ret != 0) {
+		LOG_WRN("Relay HID interface unavailable (err %d)", ret);
+	}
+
+	ret = usb_raw_hid_init();
+	if (ret != 0) {
+		LOG_WRN("Raw HID interface unavailable (err %d)", ret);
+	}
+
+	/* Picks the classes sample_usbd_init_device() registers */
+	relay_usb_composition_load();
+
 	/* Initialize USB device context */
 	usbd_ctx = sample_usbd_init_device(usb_msg_cb);
 	if (usbd_ctx == NULL) {
@@ -377,7 +701,7 @@ int usb_init(void)
 	LOG_INF("USB device stack enabled successfully");
 
 	/* Start USB enumeration watchdog as fallback (main watchdog starts on RESET) */
-	k_work_schedule(&usb_enum_check_work, K_MSEC(USB_ENUM_TIMEOUT_MS));
+	k_work_schedule_for_queue(&relay_workq_background, &usb_enum_check_work, K_MSEC(USB_ENUM_TIMEOUT_MS));
 	LOG_INF("USB enumeration watchdog armed (%d ms timeout, starts on RESET)", USB_ENUM_TIMEOUT_MS);
 
 	LOG_INF("USB HID device initialized successfully");
@@ -385,6 +709,18 @@ int usb_init(void)
 	return 0;
 }
 
+const struct device *usb_hid_dev_for(uint8_t report_id)
+{
+#if defined(CONFIG_USB_HID_SPLIT)
+	if (mouthpad_hid_report_on_controls(report_id)) {
+		return hid_controls_dev;
+	}
+#else
+	ARG_UNUSED(report_id);
+#endif
+	return hid_dev;
+}
+
 /**
  * @brief Send HID report to USB HID device
  * 
@@ -407,7 +743,7 @@ int usb_hid_send_report(const uint8_t *data, uint16_t len)
 	LOG_DBG("Sending HID report: %d bytes", len);
 	
 	/* Send the HID report using new stack API */
-	ret = hid_device_submit_report(hid_dev, len, data);
+	ret = hid_device_submit_report(usb_hid_dev_for(data[0]), len, data);
 	if (ret != 0) {
 		LOG_ERR("Failed to send HID report (err %d)", ret);
 		return ret;
@@ -437,90 +773,37 @@ int usb_hid_send_release_all(void)
 		return -ENODEV;
 	}
 
-	/* Report ID 1: Release all buttons and wheel */
-	uint8_t report1[] = {
-		0x01,  /* Report ID 1 */
-		0x00,  /* No buttons pressed */
-		0x00,  /* No wheel movement */
-		0x00   /* No AC Pan */
-	};
-
-	/* Report ID 2: No X/Y movement */
-	uint8_t report2[] = {
-		0x02,  /* Report ID 2 */
-		0x00,  /* X movement low byte = 0 */
-		0x00,  /* X high/Y low = 0 */
-		0x00   /* Y high byte = 0 */
-	};
-
-	/* Report ID 3: Release all consumer controls (16-bit usage selector) */
-	uint8_t report3[] = {
-		0x03,  /* Report ID 3 */
-		0x00,  /* Consumer control usage low byte */
-		0x00   /* Consumer control usage high byte */
-	};
-
-	/* Report ID 4: Release all keyboard keys */
-	uint8_t report4[] = {
-		0x04,  /* Report ID 4 */
-		0x00,  /* Modifier keys */
-		0x00,  /* Reserved */
-		0x00,  /* Key 1 */
-		0x00,  /* Key 2 */
-		0x00,  /* Key 3 */
-		0x00,  /* Key 4 */
-		0x00,  /* Key 5 */
-		0x00   /* Key 6 */
-	};
-
 	/* Send clear reports 3 times to ensure USB host processes them */
 	for (int round = 0; round < 3; round++) {
 		LOG_INF("Clear reports round %d/3", round + 1);
 
-		/* Send Report 1 - Release all buttons/wheel */
-		ret = usb_hid_send_report(report1, sizeof(report1));
-		if (ret != 0) {
-			LOG_ERR("Failed to send release report 1 round %d (err %d)", round + 1, ret);
-			failed_count++;
-		} else {
-			LOG_INF("Release report 1 sent round %d (buttons/wheel cleared)", round + 1);
-		}
-		k_msleep(10);  /* 10ms delay between reports */
-
-		/* Send Report 2 - Stop all movement */
-		ret = usb_hid_send_report(report2, sizeof(report2));
-		if (ret != 0) {
-			LOG_ERR("Failed to send release report 2 round %d (err %d)", round + 1, ret);
-			failed_count++;
-		} else {
-			LOG_INF("Release report 2 sent round %d (X/Y movement cleared)", round + 1);
-		}
-		k_msleep(10);  /* 10ms delay between reports */
-
-		/* Send Report 3 - Release consumer controls */
-		ret = usb_hid_send_report(report3, sizeof(report3));
-		if (ret != 0) {
-			LOG_ERR("Failed to send release report 3 round %d (err %d)", round + 1, ret);
-			failed_count++;
-		} else {
-			LOG_INF("Release report 3 sent round %d (consumer controls cleared)", round + 1);
-		}
-		k_msleep(10);  /* 10ms delay between reports */
-
-		/* Send Report 4 - Release keyboard keys */
-		ret = usb_hid_send_report(report4, sizeof(report4));
-		if (ret != 0) {
-			LOG_ERR("Failed to send release report 4 round %d (err %d)", round + 1, ret);
-			failed_count++;
-		} else {
-			LOG_INF("Release report 4 sent round %d (keyboard cleared)", round + 1);
+		/* Neutral state is all zeros for every report in the shared tables */
+#define SEND_NEUTRAL_REPORT(name, id, size)                                                     \
+		{                                                                               \
+			static const uint8_t neutral_##name[1 + (size)] = { (id) };             \
+			ret = usb_hid_send_report(neutral_##name, sizeof(neutral_##name));      \
+			if (ret != 0) {                                                         \
+				LOG_ERR("Failed to send release report %d round %d (err %d)",   \
+					(id), round + 1, ret);                                  \
+				failed_count++;                                                 \
+			}                                                                       \
+			k_msleep(10);  /* 10ms delay between reports */                         \
 		}
+#if IS_ENABLED(CONFIG_HID_COMBINED_MOUSE)
+		MOUTHPAD_HID_COMBINED_REPORTS(SEND_NEUTRAL_REPORT)
+#else
+		MOUTHPAD_HID_REPORTS(SEND_NEUTRAL_REPORT)
+#endif
+#undef SEND_NEUTRAL_REPORT
 
 		if (round < 2) {
 			k_msleep(20);  /* Longer delay between rounds */
 		}
 	}
 
+	/* Sent around the idle filter, so the next report goes whatever it holds */
+	usb_hid_idle_forget(0);
+
 	if (failed_count > 0) {
 		LOG_WRN("HID release-all completed with %d failed report(s)", failed_count);
 		return -EIO;
@@ -529,3 +812,30 @@ int usb_hid_send_release_all(void)
 	LOG_INF("=== HID RELEASE-ALL COMPLETE - 3 ROUNDS SENT ===");
 	return 0;
 }
+
+bool usb_hid_is_suspended(void)
+{
+	return atomic_get(&usb_suspended) != 0;
+}
+
+int usb_hid_remote_wakeup(void)
+{
+	int ret;
+
+	if (usbd_ctx == NULL || !usb_hid_is_suspended()) {
+		return -EINVAL;
+	}
+
+	if (atomic_set(&wakeup_requested, 1)) {
+		return -EALREADY;
+	}
+
+	ret = usbd_wakeup_request(usbd_ctx);
+	if (ret != 0) {
+		LOG_WRN("USB remote wakeup failed (err %d)", ret);
+		return ret;
+	}
+
+	LOG_INF("USB remote wakeup requested");
+	return 0;
+}
@@ -30,6 +30,36 @@ int usb_init(void);
  */
 int usb_hid_send_report(const uint8_t *data, uint16_t len);
 
+/**
+ * @brief HID device that carries a report ID
+ *
+ * The MouthPad interface, or with CONFIG_USB_HID_SPLIT the controls
+ * interface for consumer control and keyboard reports.
+ */
+const struct device *usb_hid_dev_for(uint8_t report_id);
+
+/**
+ * @brief Check whether an input report tells the host anything new
+ *
+ * Repeated all-zero motion and button, consumer and keyboard reports equal
+ * to the last one are redundant, unless the idle rate the host set with
+ * SET_IDLE asks for a repeat (see common/hid_idle.h). A report that passes
+ * is taken as sent. Safe from any thread.
+ *
+ * @param data Payload as it goes to USB, without the ID byte
+ * @return false if the report should not be forwarded
+ */
+bool usb_hid_idle_filter(uint8_t report_id, const uint8_t *data, uint8_t size);
+
+/**
+ * @brief Let the next report of an ID through whatever it holds
+ *
+ * For a report that passed usb_hid_idle_filter() but was not sent.
+ *
+ * @param report_id Report ID, or 0 for every report
+ */
+void usb_hid_idle_forget(uint8_t report_id);
+
 /**
  * @brief Send HID release-all report to clear any stuck inputs
  *
@@ -40,4 +70,39 @@ int usb_hid_send_report(const uint8_t *data, uint16_t len);
  */
 int usb_hid_send_release_all(void);
 
+/**
+ * @brief Check whether the USB host has suspended the bus
+ *
+ * Nothing is read from the HID IN endpoint while suspended, so reports
+ * must not be submitted. Changes post RELAY_EVENT_USB_SUSPEND.
+ *
+ * @return true between USB suspend and the following resume or reset
+ */
+bool usb_hid_is_suspended(void);
+
+/**
+ * @brief Ask the suspended host to resume the bus
+ *
+ * Sent at most once per suspend; later calls return -EALREADY. Safe from
+ * any thread.
+ *
+ * @return 0 on success, negative error code if the host did not enable
+ *         remote wakeup or the bus is not suspended
+ */
+int usb_hid_remote_wakeup(void);
+
+/**
+ * @brief Output report callback, report ID in data[0]
+ */
+typedef void (*usb_hid_output_cb_t)(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Register the receiver for host output reports
+ *
+ * Called from the USB stack thread for output reports listed in
+ * MOUTHPAD_HID_OUTPUT_REPORTS, with CONFIG_HID_OUTPUT_REPORTS only. It
+ * must not block.
+ */
+void usb_hid_register_output_cb(usb_hid_output_cb_t cb);
+
 #endif /* USB_H */
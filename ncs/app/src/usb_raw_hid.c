@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/usb/class/hid.h>
+#include <zephyr/usb/class/usbd_hid.h>
+
+#include "usb_raw_hid.h"
+#include "mouthpad_raw_hid.h"
+#include "relay_time.h"
+#include "usb_hid.h"
+
+LOG_MODULE_REGISTER(usb_raw_hid, LOG_LEVEL_INF);
+
+#if defined(CONFIG_USB_HID_RAW)
+
+BUILD_ASSERT(DT_NODE_EXISTS(DT_NODELABEL(hid_raw)),
+	     "CONFIG_USB_HID_RAW needs the hid_raw node (snippet hidraw)");
+
+static const struct device *const raw_hid_dev = DEVICE_DT_GET(DT_NODELABEL(hid_raw));
+
+static const uint8_t raw_report_desc[] = {
+	MOUTHPAD_RAW_HID_REPORT_DESC
+};
+
+static atomic_t raw_hid_configured;
+
+/* Closed reports waiting for the host */
+K_MSGQ_DEFINE(raw_hid_msgq, MOUTHPAD_RAW_HID_REPORT_SIZE, CONFIG_USB_HID_RAW_QUEUE_SIZE, 4);
+
+/* The report being filled, its sequence number and what was lost before it */
+static struct k_spinlock raw_lock;
+static struct mouthpad_raw_hid_batch batch;
+static uint8_t next_seq;
+static uint32_t dropped;
+
+/* Given on a new sample or when the interface comes and goes */
+static K_SEM_DEFINE(raw_hid_tx_sem, 0, 1);
+
+/* Queue the report being filled, if it holds anything, and start the next */
+static void close_locked(void)
+{
+	if (batch.count == 0) {
+		return;
+	}
+
+	if (k_msgq_put(&raw_hid_msgq, batch.report, K_NO_WAIT) == 0) {
+		next_seq++;
+	} else {
+		/* The host is not keeping up; the next report says how many */
+		dropped += mouthpad_raw_hid_dropped(&batch) + batch.count;
+	}
+	mouthpad_raw_hid_open(&batch, next_seq, dropped);
+	dropped = 0;
+}
+
+static void raw_hid_iface_ready(const struct device *dev, const bool ready)
+{
+	ARG_UNUSED(dev);
+
+	LOG_INF("Raw HID interface is %s", ready ? "ready" : "not ready");
+
+	/* Whatever was queued for the last session is not worth sending */
+	K_SPINLOCK(&raw_lock) {
+		k_msgq_purge(&raw_hid_msgq);
+		dropped = 0;
+		mouthpad_raw_hid_open(&batch, next_seq, 0);
+	}
+	atomic_set(&raw_hid_configured, ready);
+	k_sem_give(&raw_hid_tx_sem);
+}
+
+static int raw_hid_get_report(const struct device *dev, const uint8_t type,
+			      const uint8_t id, const uint16_t len, uint8_t *const buf)
+{
+	return 0;
+}
+
+static struct hid_device_ops raw_hid_ops = {
+	.iface_ready = raw_hid_iface_ready,
+	.get_report = raw_hid_get_report,
+};
+
+void usb_raw_hid_sample(uint8_t report_id, const uint8_t *data, uint8_t size)
+{
+	uint32_t now = relay_time_us32();
+
+	if (!mouthpad_raw_hid_takes(report_id, size) || !atomic_get(&raw_hid_configured)) {
+		return;
+	}
+
+	K_SPINLOCK(&raw_lock) {
+		if (!mouthpad_raw_hid_add(&batch, now, report_id, data, size)) {
+			close_locked();
+			mouthpad_raw_hid_add(&batch, now, report_id, data, size);
+		}
+	}
+	k_sem_give(&raw_hid_tx_sem);
+}
+
+/* Sends closed reports, one per poll, and closes the one being filled once
+ * it is full or its first sample has waited CONFIG_USB_HID_RAW_BATCH_US.
+ * Samples arriving while a report is in flight share the next one. Without
+ * an input_report_done callback hid_device_submit_report() returns once the
+ * host has taken the report.
+ */
+#define RAW_HID_TX_THREAD_STACK_SIZE 1024
+#define RAW_HID_TX_THREAD_PRIORITY   5
+
+static void raw_hid_tx_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	uint8_t report[MOUTHPAD_RAW_HID_REPORT_SIZE];
+
+	for (;;) {
+		k_timeout_t wait = K_FOREVER;
+
+		if (k_msgq_get(&raw_hid_msgq, report, K_NO_WAIT) != 0) {
+			K_SPINLOCK(&raw_lock) {
+				uint32_t age = relay_time_us32() - batch.base_us;
+
+				if (batch.count == 0) {
+					/* Nothing to send */
+				} else if (batch.count >= MOUTHPAD_RAW_HID_SAMPLES_MAX ||
+					   age >= CONFIG_USB_HID_RAW_BATCH_US) {
+					close_locked();
+				} else {
+					wait = K_USEC(CONFIG_USB_HID_RAW_BATCH_US - age);
+				}
+			}
+			if (k_msgq_get(&raw_hid_msgq, report, K_NO_WAIT) != 0) {
+				k_sem_take(&raw_hid_tx_sem, wait);
+				continue;
+			}
+		}
+
+		/* Nothing is read while the host is away or asleep */
+		if (!atomic_get(&raw_hid_configured) || usb_hid_is_suspended()) {
+			continue;
+		}
+
+		int err = hid_device_submit_report(raw_hid_dev, sizeof(report), report);
+
+		if (err) {
+			LOG_DBG("Raw HID report not sent (err %d)", err);
+		}
+	}
+}
+
+K_THREAD_DEFINE(raw_hid_tx_tid, RAW_HID_TX_THREAD_STACK_SIZE, raw_hid_tx_thread,
+		NULL, NULL, NULL, RAW_HID_TX_THREAD_PRIORITY, 0, 0);
+
+int usb_raw_hid_init(void)
+{
+	if (!device_is_ready(raw_hid_dev)) {
+		LOG_ERR("Raw HID device is not ready");
+		return -ENODEV;
+	}
+
+	int ret = hid_device_register(raw_hid_dev, raw_report_desc,
+				      sizeof(raw_report_desc), &raw_hid_ops);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to register raw HID device, %d", ret);
+		return ret;
+	}
+
+	LOG_INF("Raw HID device registered: %s", raw_hid_dev->name);
+	return 0;
+}
+
+#else /* !CONFIG_USB_HID_RAW */
+
+int usb_raw_hid_init(void)
+{
+	return 0;
+}
+
+void usb_raw_hid_sample(uint8_t report_id, const uint8_t *data, uint8_t size)
+{
+	ARG_UNUSED(report_id);
+	ARG_UNUSED(data);
+	ARG_UNUSED(size);
+}
+
+#endif /* CONFIG_USB_HID_RAW */
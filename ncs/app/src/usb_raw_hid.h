@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Raw button and motion samples over a vendor-defined HID interface
+ *
+ * With CONFIG_USB_HID_RAW the hid_raw devicetree node adds a HID interface
+ * whose 64-byte input reports carry every button and motion report the
+ * MouthPad sent, stamped with its arrival, several to a report (see
+ * mouthpad_raw_hid.h). The mouse reports to the OS do not change. Samples
+ * are only taken while the host has the interface configured. Without the
+ * option every call is a no-op.
+ */
+
+#ifndef USB_RAW_HID_H_
+#define USB_RAW_HID_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Register the raw HID interface; call before the USB stack starts
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int usb_raw_hid_init(void);
+
+/**
+ * @brief Take a MouthPad input report as a sample, on arrival
+ *
+ * Reports other than buttons and motion are ignored. Never blocks.
+ */
+void usb_raw_hid_sample(uint8_t report_id, const uint8_t *data, uint8_t size);
+
+#endif /* USB_RAW_HID_H_ */
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/usb/class/hid.h>
+#include <zephyr/usb/class/usbd_hid.h>
+
+#include "usb_relay_hid.h"
+#include "mouthpad_relay_hid.h"
+#include "usb_cdc.h"
+#include "usb_hid.h"
+
+LOG_MODULE_REGISTER(usb_relay_hid, LOG_LEVEL_INF);
+
+#if DT_NODE_EXISTS(DT_NODELABEL(relay_hid))
+
+static const struct device *const relay_hid_dev = DEVICE_DT_GET(DT_NODELABEL(relay_hid));
+
+static const uint8_t relay_report_desc[] = {
+	MOUTHPAD_RELAY_HID_REPORT_DESC
+};
+
+static atomic_t relay_hid_configured;
+
+/* Output report bytes, drained by the CDC0 RX thread */
+#define RELAY_HID_RX_RINGBUF_SIZE 1024
+RING_BUF_DECLARE(relay_hid_rx_ringbuf, RELAY_HID_RX_RINGBUF_SIZE);
+
+/* Given when usb_cdc queues bytes or the interface comes and goes */
+static K_SEM_DEFINE(relay_hid_tx_sem, 0, 1);
+
+static void relay_hid_iface_ready(const struct device *dev, const bool ready)
+{
+	ARG_UNUSED(dev);
+
+	LOG_INF("Relay HID interface is %s", ready ? "ready" : "not ready");
+	atomic_set(&relay_hid_configured, ready);
+	k_sem_give(&relay_hid_tx_sem);
+}
+
+/* USB stack thread: queue the stream bytes for the CDC0 RX thread */
+static void relay_hid_stream_received(const uint8_t *buf, uint16_t len)
+{
+	size_t n = mouthpad_relay_hid_unpack(buf, len);
+
+	if (n == 0) {
+		return;
+	}
+
+	/* A short put loses bytes mid-frame; the deframer resyncs on the
+	 * next frame's magic and CRC
+	 */
+	if (ring_buf_put(&relay_hid_rx_ringbuf, &buf[1], n) != n) {
+		LOG_DBG("Relay HID RX ring full");
+	}
+	usb_cdc_wake_rx();
+}
+
+static int relay_hid_get_report(const struct device *dev, const uint8_t type,
+				const uint8_t id, const uint16_t len, uint8_t *const buf)
+{
+	return 0;
+}
+
+/* Hosts without an OUT endpoint driver send output reports over EP0 */
+static int relay_hid_set_report(const struct device *dev, const uint8_t type,
+				const uint8_t id, const uint16_t len, const uint8_t *const buf)
+{
+	if (type == HID_REPORT_TYPE_OUTPUT) {
+		relay_hid_stream_received(buf, len);
+	}
+
+	return 0;
+}
+
+static void relay_hid_output_report(const struct device *dev, const uint16_t len,
+				    const uint8_t *const buf)
+{
+	relay_hid_stream_received(buf, len);
+}
+
+static struct hid_device_ops relay_hid_ops = {
+	.iface_ready = relay_hid_iface_ready,
+	.get_report = relay_hid_get_report,
+	.set_report = relay_hid_set_report,
+	.output_report = relay_hid_output_report,
+};
+
+/* Moves what usb_cdc queued into input reports, one per poll. Without an
+ * input_report_done callback hid_device_submit_report() returns once the
+ * host has taken the report, so one report buffer is enough.
+ */
+#define RELAY_HID_TX_THREAD_STACK_SIZE 1024
+#define RELAY_HID_TX_THREAD_PRIORITY   5
+
+static void relay_hid_tx_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	uint8_t chunk[MOUTHPAD_RELAY_HID_CHUNK_MAX];
+	uint8_t report[MOUTHPAD_RELAY_HID_REPORT_SIZE];
+
+	for (;;) {
+		size_t n;
+
+		k_sem_take(&relay_hid_tx_sem, K_FOREVER);
+
+		while ((n = usb_cdc_relay_hid_take(chunk, sizeof(chunk))) > 0) {
+			/* Nothing is read while the host is away or asleep */
+			if (!atomic_get(&relay_hid_configured) || usb_hid_is_suspended()) {
+				continue;
+			}
+
+			mouthpad_relay_hid_pack(report, chunk, n);
+
+			int err = hid_device_submit_report(relay_hid_dev, sizeof(report), report);
+
+			if (err) {
+				LOG_DBG("Relay HID report not sent (err %d)", err);
+			}
+		}
+	}
+}
+
+K_THREAD_DEFINE(relay_hid_tx_tid, RELAY_HID_TX_THREAD_STACK_SIZE, relay_hid_tx_thread,
+		NULL, NULL, NULL, RELAY_HID_TX_THREAD_PRIORITY, 0, 0);
+
+int usb_relay_hid_init(void)
+{
+	if (!device_is_ready(relay_hid_dev)) {
+		LOG_ERR("Relay HID device is not ready");
+		return -ENODEV;
+	}
+
+	int ret = hid_device_register(relay_hid_dev, relay_report_desc,
+				      sizeof(relay_report_desc), &relay_hid_ops);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to register relay HID device, %d", ret);
+		return ret;
+	}
+
+	LOG_INF("Relay HID device registered: %s", relay_hid_dev->name);
+	return 0;
+}
+
+bool usb_relay_hid_ready(void)
+{
+	return atomic_get(&relay_hid_configured) != 0;
+}
+
+int usb_relay_hid_receive(uint8_t *buffer, uint16_t max_len)
+{
+	return ring_buf_get(&relay_hid_rx_ringbuf, buffer, max_len);
+}
+
+void usb_relay_hid_tx_kick(void)
+{
+	k_sem_give(&relay_hid_tx_sem);
+}
+
+#else /* !DT_NODE_EXISTS(DT_NODELABEL(relay_hid)) */
+
+int usb_relay_hid_init(void)
+{
+	LOG_INF("No relay HID interface in devicetree");
+	return 0;
+}
+
+bool usb_relay_hid_ready(void)
+{
+	return false;
+}
+
+int usb_relay_hid_receive(uint8_t *buffer, uint16_t max_len)
+{
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(max_len);
+
+	return 0;
+}
+
+void usb_relay_hid_tx_kick(void)
+{
+}
+
+#endif /* DT_NODE_EXISTS(DT_NODELABEL(relay_hid)) */
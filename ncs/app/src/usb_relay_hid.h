@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Relay protocol over the vendor-defined HID interface
+ *
+ * The relay_hid devicetree node adds a HID interface with 64-byte input and
+ * output reports on 1 ms interrupt endpoints, for hosts that block CDC ACM.
+ * It carries the CDC0 byte stream cut into reports (see
+ * mouthpad_relay_hid.h). Output report bytes are read by the CDC0 RX thread
+ * into their own deframer; usb_cdc sends framed writes here instead of to
+ * CDC0 while the host is talking over this interface. Without the node
+ * every call is a no-op.
+ */
+
+#ifndef USB_RELAY_HID_H_
+#define USB_RELAY_HID_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Register the relay HID interface; call before the USB stack starts
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int usb_relay_hid_init(void);
+
+/**
+ * @brief Check whether the host has the relay HID interface configured
+ */
+bool usb_relay_hid_ready(void);
+
+/**
+ * @brief Read stream bytes taken from output reports; CDC0 RX thread only
+ *
+ * usb_cdc_wait_for_data() also returns when new bytes arrive here.
+ *
+ * @return Number of bytes read, 0 if there are none
+ */
+int usb_relay_hid_receive(uint8_t *buffer, uint16_t max_len);
+
+/**
+ * @brief Wake the TX thread after usb_cdc queued bytes for the interface
+ */
+void usb_relay_hid_tx_kick(void);
+
+#endif /* USB_RELAY_HID_H_ */
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/usb/udc.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/usb/usbd.h>
+
+#include "usb_relay_webusb.h"
+#include "mouthpad_relay_webusb.h"
+#include "usb_cdc.h"
+#include "usb_hid.h"
+
+LOG_MODULE_REGISTER(usb_relay_webusb, LOG_LEVEL_INF);
+
+#if IS_ENABLED(CONFIG_RELAY_WEBUSB)
+
+/* Bytes per bulk transfer in either direction */
+#define RELAY_WEBUSB_XFER_SIZE (4 * MOUTHPAD_RELAY_WEBUSB_EP_SIZE)
+
+struct relay_webusb_desc {
+	struct usb_if_descriptor if0;
+	struct usb_ep_descriptor if0_out_ep;
+	struct usb_ep_descriptor if0_in_ep;
+	struct usb_desc_header nil_desc;
+};
+
+/* Full speed only; the stack fills in the interface and endpoint numbers */
+static struct relay_webusb_desc relay_webusb_desc = {
+	.if0 = {
+		.bLength = sizeof(struct usb_if_descriptor),
+		.bDescriptorType = USB_DESC_INTERFACE,
+		.bInterfaceNumber = 0,
+		.bAlternateSetting = 0,
+		.bNumEndpoints = 2,
+		.bInterfaceClass = USB_BCC_VENDOR,
+		.bInterfaceSubClass = 0,
+		.bInterfaceProtocol = 0,
+		.iInterface = 0,
+	},
+	.if0_out_ep = {
+		.bLength = sizeof(struct usb_ep_descriptor),
+		.bDescriptorType = USB_DESC_ENDPOINT,
+		.bEndpointAddress = 0x01,
+		.bmAttributes = USB_EP_TYPE_BULK,
+		.wMaxPacketSize = sys_cpu_to_le16(MOUTHPAD_RELAY_WEBUSB_EP_SIZE),
+		.bInterval = 0,
+	},
+	.if0_in_ep = {
+		.bLength = sizeof(struct usb_ep_descriptor),
+		.bDescriptorType = USB_DESC_ENDPOINT,
+		.bEndpointAddress = 0x81,
+		.bmAttributes = USB_EP_TYPE_BULK,
+		.wMaxPacketSize = sys_cpu_to_le16(MOUTHPAD_RELAY_WEBUSB_EP_SIZE),
+		.bInterval = 0,
+	},
+	.nil_desc = {
+		.bLength = 0,
+		.bDescriptorType = 0,
+	},
+};
+
+static const struct usb_desc_header *relay_webusb_fs_desc[] = {
+	(struct usb_desc_header *)&relay_webusb_desc.if0,
+	(struct usb_desc_header *)&relay_webusb_desc.if0_out_ep,
+	(struct usb_desc_header *)&relay_webusb_desc.if0_in_ep,
+	(struct usb_desc_header *)&relay_webusb_desc.nil_desc,
+};
+
+static struct usbd_class_data *relay_webusb_c_data;
+static atomic_t relay_webusb_enabled;
+static atomic_t relay_webusb_rx_armed;
+
+/* Completed bulk OUT transfers, read in place by the CDC0 RX thread */
+static K_FIFO_DEFINE(relay_webusb_rx_fifo);
+
+/* Transfer the CDC0 RX thread is reading; owned by that thread */
+static struct net_buf *relay_webusb_rx_cur;
+
+/* OUT transfers queued, waiting in the FIFO or being read. One in flight
+ * while the last is parsed keeps the endpoint busy without holding more of
+ * the shared UDC buffer pool.
+ */
+#define RELAY_WEBUSB_RX_BUFS 2
+static atomic_t relay_webusb_rx_held;
+
+/* Given when usb_cdc queues bytes or the interface comes and goes */
+static K_SEM_DEFINE(relay_webusb_tx_sem, 0, 1);
+
+/* Given when the IN transfer in flight completes or is cancelled */
+static K_SEM_DEFINE(relay_webusb_in_done, 0, 1);
+
+/* Queue one OUT transfer if none is queued and fewer than
+ * RELAY_WEBUSB_RX_BUFS are held, so the host is NAKed rather than bytes
+ * dropped. Runs from the USB stack thread and the CDC0 RX thread.
+ */
+static void relay_webusb_rx_arm(void)
+{
+	if (!atomic_get(&relay_webusb_enabled) ||
+	    atomic_get(&relay_webusb_rx_held) >= RELAY_WEBUSB_RX_BUFS ||
+	    !atomic_cas(&relay_webusb_rx_armed, 0, 1)) {
+		return;
+	}
+
+	struct net_buf *buf = usbd_ep_buf_alloc(relay_webusb_c_data,
+						relay_webusb_desc.if0_out_ep.bEndpointAddress,
+						RELAY_WEBUSB_XFER_SIZE);
+
+	if (buf == NULL) {
+		atomic_set(&relay_webusb_rx_armed, 0);
+		LOG_WRN("No buffer for WebUSB OUT transfer");
+		return;
+	}
+
+	atomic_inc(&relay_webusb_rx_held);
+
+	int err = usbd_ep_enqueue(relay_webusb_c_data, buf);
+
+	if (err) {
+		net_buf_unref(buf);
+		atomic_dec(&relay_webusb_rx_held);
+		atomic_set(&relay_webusb_rx_armed, 0);
+		LOG_WRN("WebUSB OUT transfer not queued (err %d)", err);
+	}
+}
+
+static int relay_webusb_request(struct usbd_class_data *const c_data, struct net_buf *buf,
+				int err)
+{
+	struct usbd_context *uds_ctx = usbd_class_get_ctx(c_data);
+	struct udc_buf_info *bi = udc_get_buf_info(buf);
+
+	if (bi->ep == relay_webusb_desc.if0_out_ep.bEndpointAddress) {
+		if (err == 0 && buf->len > 0) {
+			/* Handed over as is; freed once the RX thread has read it */
+			k_fifo_put(&relay_webusb_rx_fifo, buf);
+			usb_cdc_wake_rx();
+		} else {
+			usbd_ep_buf_free(uds_ctx, buf);
+			atomic_dec(&relay_webusb_rx_held);
+		}
+		atomic_set(&relay_webusb_rx_armed, 0);
+		if (err != -ECONNABORTED) {
+			relay_webusb_rx_arm();
+		}
+		return 0;
+	}
+
+	usbd_ep_buf_free(uds_ctx, buf);
+	k_sem_give(&relay_webusb_in_done);
+	return 0;
+}
+
+static void relay_webusb_enable(struct usbd_class_data *const c_data)
+{
+	LOG_INF("WebUSB interface is ready");
+	atomic_set(&relay_webusb_enabled, 1);
+	relay_webusb_rx_arm();
+	k_sem_give(&relay_webusb_tx_sem);
+}
+
+/* The stack cancels queued transfers, which completes them with
+ * -ECONNABORTED
+ */
+static void relay_webusb_disable(struct usbd_class_data *const c_data)
+{
+	LOG_INF("WebUSB interface is not ready");
+	atomic_set(&relay_webusb_enabled, 0);
+	k_sem_give(&relay_webusb_tx_sem);
+}
+
+static void *relay_webusb_get_desc(struct usbd_class_data *const c_data,
+				   const enum usbd_speed speed)
+{
+	ARG_UNUSED(speed);
+
+	return relay_webusb_fs_desc;
+}
+
+static int relay_webusb_init(struct usbd_class_data *const c_data)
+{
+	relay_webusb_c_data = c_data;
+	return 0;
+}
+
+static struct usbd_class_api relay_webusb_api = {
+	.request = relay_webusb_request,
+	.enable = relay_webusb_enable,
+	.disable = relay_webusb_disable,
+	.get_desc = relay_webusb_get_desc,
+	.init = relay_webusb_init,
+};
+
+USBD_DEFINE_CLASS(relay_webusb, &relay_webusb_api, NULL, NULL);
+
+/* Moves what usb_cdc queued into bulk IN transfers, one in flight at a
+ * time. The bytes are taken straight into the transfer buffer, which the
+ * controller sends as up to four packets. The host reads one packet per
+ * transfer, so no ZLP is needed after a transfer that ends on a packet
+ * boundary.
+ */
+#define RELAY_WEBUSB_TX_THREAD_STACK_SIZE 1024
+#define RELAY_WEBUSB_TX_THREAD_PRIORITY   5
+
+static void relay_webusb_tx_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		k_sem_take(&relay_webusb_tx_sem, K_FOREVER);
+
+		for (;;) {
+			struct net_buf *buf = NULL;
+			size_t n;
+
+			/* Nothing is read while the host is away or asleep */
+			if (atomic_get(&relay_webusb_enabled) && !usb_hid_is_suspended()) {
+				buf = usbd_ep_buf_alloc(relay_webusb_c_data,
+							relay_webusb_desc.if0_in_ep.bEndpointAddress,
+							RELAY_WEBUSB_XFER_SIZE);
+				if (buf == NULL) {
+					LOG_DBG("No buffer for WebUSB IN transfer");
+				}
+			}
+
+			if (buf == NULL) {
+				uint8_t scrap[MOUTHPAD_RELAY_WEBUSB_EP_SIZE];
+
+				if (usb_cdc_webusb_take(scrap, sizeof(scrap)) == 0) {
+					break;
+				}
+				continue;
+			}
+
+			n = usb_cdc_webusb_take(net_buf_tail(buf), net_buf_tailroom(buf));
+			if (n == 0) {
+				net_buf_unref(buf);
+				break;
+			}
+			net_buf_add(buf, n);
+
+			int err = usbd_ep_enqueue(relay_webusb_c_data, buf);
+
+			if (err) {
+				net_buf_unref(buf);
+				LOG_DBG("WebUSB IN transfer not queued (err %d)", err);
+				continue;
+			}
+
+			k_sem_take(&relay_webusb_in_done, K_FOREVER);
+		}
+	}
+}
+
+K_THREAD_DEFINE(relay_webusb_tx_tid, RELAY_WEBUSB_TX_THREAD_STACK_SIZE, relay_webusb_tx_thread,
+		NULL, NULL, NULL, RELAY_WEBUSB_TX_THREAD_PRIORITY, 0, 0);
+
+bool usb_relay_webusb_ready(void)
+{
+	return atomic_get(&relay_webusb_enabled) != 0;
+}
+
+uint8_t usb_relay_webusb_interface(void)
+{
+	return relay_webusb_desc.if0.bInterfaceNumber;
+}
+
+size_t usb_relay_webusb_rx_peek(const uint8_t **data)
+{
+	if (relay_webusb_rx_cur == NULL) {
+		relay_webusb_rx_cur = k_fifo_get(&relay_webusb_rx_fifo, K_NO_WAIT);
+		if (relay_webusb_rx_cur == NULL) {
+			return 0;
+		}
+	}
+
+	*data = relay_webusb_rx_cur->data;
+	return relay_webusb_rx_cur->len;
+}
+
+void usb_relay_webusb_rx_done(void)
+{
+	if (relay_webusb_rx_cur == NULL) {
+		return;
+	}
+
+	usbd_ep_buf_free(usbd_class_get_ctx(relay_webusb_c_data), relay_webusb_rx_cur);
+	relay_webusb_rx_cur = NULL;
+	atomic_dec(&relay_webusb_rx_held);
+	relay_webusb_rx_arm();
+}
+
+void usb_relay_webusb_tx_kick(void)
+{
+	k_sem_give(&relay_webusb_tx_sem);
+}
+
+#else /* !CONFIG_RELAY_WEBUSB */
+
+bool usb_relay_webusb_ready(void)
+{
+	return false;
+}
+
+uint8_t usb_relay_webusb_interface(void)
+{
+	return 0;
+}
+
+size_t usb_relay_webusb_rx_peek(const uint8_t **data)
+{
+	ARG_UNUSED(data);
+
+	return 0;
+}
+
+void usb_relay_webusb_rx_done(void)
+{
+}
+
+void usb_relay_webusb_tx_kick(void)
+{
+}
+
+#endif /* CONFIG_RELAY_WEBUSB */
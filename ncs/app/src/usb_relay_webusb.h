@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Relay protocol over the WebUSB vendor bulk interface
+ *
+ * CONFIG_RELAY_WEBUSB adds a vendor-class interface with 64-byte bulk
+ * endpoints carrying the CDC0 byte stream unchanged (see
+ * mouthpad_relay_webusb.h); sample_usbd_init.c adds the BOS descriptors
+ * that point browsers and Windows at it. Bulk OUT data is read by the CDC0
+ * RX thread into its own deframer; usb_cdc sends framed writes here
+ * instead of to CDC0 while the host is talking over this interface.
+ * Without the option every call is a no-op.
+ */
+
+#ifndef USB_RELAY_WEBUSB_H_
+#define USB_RELAY_WEBUSB_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Check whether the host has the WebUSB interface configured
+ */
+bool usb_relay_webusb_ready(void);
+
+/**
+ * @brief Interface number the USB stack gave the WebUSB interface
+ *
+ * Only valid once the classes are registered; the MS OS 2.0 descriptor
+ * set names it.
+ */
+uint8_t usb_relay_webusb_interface(void);
+
+/**
+ * @brief Oldest bulk OUT transfer not yet read; CDC0 RX thread only
+ *
+ * The bytes are left in the USB stack's buffer and stay valid until
+ * usb_relay_webusb_rx_done(). usb_cdc_wait_for_data() also returns when a
+ * new transfer arrives. Only a couple of transfers are held at once; the
+ * host is NAKed, rather than bytes dropped, until one is done with.
+ *
+ * @param data Set to the first byte of the transfer
+ *
+ * @return Bytes in the transfer, 0 if there is none
+ */
+size_t usb_relay_webusb_rx_peek(const uint8_t **data);
+
+/**
+ * @brief Free the transfer usb_relay_webusb_rx_peek() returned and queue
+ *        the next one
+ */
+void usb_relay_webusb_rx_done(void);
+
+/**
+ * @brief Wake the TX thread after usb_cdc queued bytes for the interface
+ */
+void usb_relay_webusb_tx_kick(void);
+
+#endif /* USB_RELAY_WEBUSB_H_ */
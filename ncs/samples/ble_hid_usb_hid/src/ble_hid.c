@@ -24,14 +24,12 @@
 
 #include <zephyr/settings/settings.h>
 #include <zephyr/logging/log.h>
-#include <zephyr/usb/usb_device.h>
-#include <zephyr/usb/class/usb_hid.h>
 
 #include "ble_hid.h"
-
-/* Forward declarations for direct USB access */
-extern const struct device *hid_dev;
-extern struct k_sem ep_write_sem;
+#include "hid_latency.h"
+#include "mouthpad_hid_reports.h"
+#include "relay_probe.h"
+#include "usb_hid.h"
 
 LOG_MODULE_REGISTER(ble_hid, LOG_LEVEL_INF);
 
@@ -117,46 +115,37 @@ static const struct bt_hogp_init_params hogp_init_params = {
 };
 
 /* HOGP callback implementations */
+
+/* Straight to USB on the BT RX thread, stamped and probed where the relay
+ * stamps and probes, so the two builds measure the same span
+ */
+static void forward_report(uint8_t report_id, const uint8_t *data, uint8_t size)
+{
+	uint32_t stamp;
+	int ret;
+
+	relay_probe(RELAY_PROBE_HID_RX);
+	stamp = hid_latency_start();
+
+	ret = usb_hid_send(report_id, data, size);
+	if (ret == 0) {
+		hid_latency_record(report_id, stamp);
+	} else {
+		LOG_DBG("Report %u not sent (err %d)", report_id, ret);
+	}
+}
+
 static uint8_t hogp_notify_cb(struct bt_hogp *hogp,
 			     struct bt_hogp_rep_info *rep,
 			     uint8_t err,
 			     const uint8_t *data)
 {
-	uint8_t size = bt_hogp_rep_size(rep);
-	uint8_t i;
-
 	if (!data) {
 		return BT_GATT_ITER_STOP;
 	}
-	printk("Notification, id: %u, size: %u, data:",
-	       bt_hogp_rep_id(rep),
-	       size);
-	for (i = 0; i < size; ++i) {
-		printk(" 0x%x", data[i]);
-	}
-	printk("\n");
-	
-	// Handle different report types based on Report ID
-	uint8_t report_id = bt_hogp_rep_id(rep);
-	
-	// Parse and forward each report ID independently
-	if (size >= 1) {
-		/* Send directly to USB for zero latency */
-		uint8_t report_with_id[size + 1];
-		report_with_id[0] = report_id;
-		for (uint8_t i = 0; i < size; i++) {
-			report_with_id[i + 1] = data[i];
-		}
-		
-		int ret = hid_int_ep_write(hid_dev, report_with_id, size + 1, NULL);
-		if (ret) {
-			printk("HID write error, %d", ret);
-		} else {
-			k_sem_take(&ep_write_sem, K_FOREVER);
-			// printk("Report %u sent directly to USB", report_id);
-		}
-	}
-	
+
+	forward_report(bt_hogp_rep_id(rep), data, bt_hogp_rep_size(rep));
+
 	return BT_GATT_ITER_CONTINUE;
 }
 
@@ -165,37 +154,13 @@ static uint8_t hogp_boot_mouse_report(struct bt_hogp *hogp,
 				     uint8_t err,
 				     const uint8_t *data)
 {
-	uint8_t size = bt_hogp_rep_size(rep);
-
 	if (!data) {
 		return BT_GATT_ITER_STOP;
 	}
-	
-	printk("Boot mouse report: size=%u, data:", size);
-	for (uint8_t i = 0; i < size; i++) {
-		printk(" 0x%02x", data[i]);
-	}
-	printk("\n");
-	
-	/* Forward boot mouse report directly to USB as Report ID 1 */
+
 	/* Boot reports are always sent as Report ID 1 (buttons + wheel) */
-	uint8_t report_with_id[size + 1];
-	report_with_id[0] = 1;  // Report ID 1 for boot mouse
-	
-	/* Copy the raw boot mouse data */
-	for (uint8_t i = 0; i < size; i++) {
-		report_with_id[i + 1] = data[i];
-	}
-	
-	/* Send directly to USB for zero latency */
-	int ret = hid_int_ep_write(hid_dev, report_with_id, size + 1, NULL);
-	if (ret) {
-		printk("HID write error, %d", ret);
-	} else {
-		k_sem_take(&ep_write_sem, K_FOREVER);
-		printk("Boot mouse report sent directly to USB");
-	}
-	
+	forward_report(MOUTHPAD_HID_REPORT_ID_MOUSE_BUTTONS, data, bt_hogp_rep_size(rep));
+
 	return BT_GATT_ITER_CONTINUE;
 }
 
@@ -25,17 +25,11 @@
 #include <zephyr/settings/settings.h>
 
 #include <zephyr/logging/log.h>
-#include <zephyr/usb/usb_device.h>
-#include <zephyr/usb/class/usb_hid.h>
 
 #include "ble_hid.h"
 #include "ble_central.h"
 #include "ble_transport.h"
 
-/* Forward declarations for direct USB access */
-extern const struct device *hid_dev;
-extern struct k_sem ep_write_sem;
-
 LOG_MODULE_REGISTER(ble_transport, LOG_LEVEL_INF);
 
 /* Give controller time to settle before starting scan */
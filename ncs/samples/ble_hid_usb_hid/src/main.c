@@ -9,13 +9,38 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/version.h>
 #include "ble_transport.h"
+#include "hid_latency.h"
 #include "usb_hid.h"
 
 LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
+/* How often the latency histograms are logged over RTT */
+#define LATENCY_LOG_PERIOD K_SECONDS(10)
+
+/* Counts at the last log, so an idle link logs nothing */
+static uint32_t logged_count[HID_LATENCY_REPORT_ID_MAX + 1];
+
+/* Same figures as "latency" on the relay's CDC1 shell */
+static void log_latency(void)
+{
+	for (uint8_t id = 1; id <= HID_LATENCY_REPORT_ID_MAX; id++) {
+		struct hid_latency_stats stats;
+
+		if (hid_latency_get_stats(id, &stats) != 0) {
+			return;
+		}
+		if (stats.count == logged_count[id]) {
+			continue;
+		}
+		logged_count[id] = stats.count;
+		LOG_INF("latency id %u: n %u p50 %u p99 %u max %u us", stats.report_id,
+			stats.count, stats.p50_us, stats.p99_us, stats.max_us);
+	}
+}
+
 int main(void)
 {
-    printk("MouthPad^USB :: HID Sample Started\n");
+    printk("MouthPad^USB :: HID reference build started\n");
     printk("Build: %s %s %s\n", KERNEL_VERSION_STRING, __DATE__, __TIME__);
 
 	/* Initialize BLE Transport */
@@ -31,4 +56,13 @@ int main(void)
 	}
 
 	printk("MouthPad^USB Bridge initialization complete\n");
+
+	if (!IS_ENABLED(CONFIG_HID_LATENCY_TRACE)) {
+		return 0;
+	}
+
+	while (true) {
+		k_sleep(LATENCY_LOG_PERIOD);
+		log_latency();
+	}
 }
@@ -8,17 +8,28 @@
 #ifndef USB_H
 #define USB_H
 
+#include <stdint.h>
 #include <zephyr/kernel.h>
 
 /**
  * @brief Initialize USB HID device
  *
- * This function initializes the USB HID device as a mouse,
- * sets up the necessary callbacks, and starts the main loop
- * for handling mouse input events.
+ * Registers the MouthPad report descriptor on the mouse interface
+ * (hid_dev_0) and enables the USB device stack with that interface only.
  *
  * @return 0 on success, negative error code on failure
  */
 int usb_init(void);
 
+/**
+ * @brief Send one MouthPad report to the host
+ *
+ * Padded to the descriptor's size for report_id; returns once the host
+ * has read the report.
+ *
+ * @return 0 on success, -EINVAL for an unknown report ID, -EAGAIN while
+ *         the interface is not configured, or an error from the stack
+ */
+int usb_hid_send(uint8_t report_id, const uint8_t *data, uint8_t size);
+
 #endif /* USB_H */
@@ -0,0 +1,10 @@
+# Sysbuild configuration for the reference latency build
+
+# Same flash layout as the relay on the boards that have one (app/pm_static_*.yml)
+string(REPLACE "/" "_" board_pm_name "${BOARD}${BOARD_QUALIFIERS}")
+foreach(pm_name ${board_pm_name} ${BOARD})
+  if(EXISTS ${APP_DIR}/../../app/pm_static_${pm_name}.yml)
+    set(PM_STATIC_YML_FILE ${APP_DIR}/../../app/pm_static_${pm_name}.yml CACHE INTERNAL "")
+    break()
+  endif()
+endforeach()
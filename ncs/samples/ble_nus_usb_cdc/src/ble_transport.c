@@ -15,6 +15,7 @@
 #include "ble_central.h"
 #include "ble_nus_client.h"
 #include "usb_cdc.h"
+#include "throughput.h"
 
 #define LOG_MODULE_NAME ble_transport
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -149,6 +150,12 @@ bool ble_transport_is_hid_ready(void)
 /* Internal callback functions */
 static void ble_nus_data_received_cb(const uint8_t *data, uint16_t len)
 {
+	/* Measurement traffic skips the logging and echo filter below */
+	if (throughput_active()) {
+		throughput_on_rx(data, len);
+		return;
+	}
+
 	LOG_INF("NUS data received: %d bytes", len);
 	
 	// Only process data after MTU exchange is complete
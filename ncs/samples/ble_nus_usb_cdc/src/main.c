@@ -14,6 +14,7 @@
 
 #include "usb_cdc.h"
 #include "ble_transport.h"
+#include "throughput.h"
 
 #define LOG_MODULE_NAME central_uart
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
@@ -47,6 +48,9 @@ int main(void)
 	/* Start bridging */
 	ble_transport_start_bridging();
 
+	/* Measure the bridge once before serving the host */
+	throughput_run();
+
 	LOG_INF("Starting USB ↔ BLE bridge");
 
 	for (;;) {
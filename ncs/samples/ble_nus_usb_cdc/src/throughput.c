@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gap.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+
+#include "throughput.h"
+#include "ble_central.h"
+#include "ble_nus_client.h"
+#include "ble_transport.h"
+#include "usb_cdc.h"
+#include "peer_nus_commands.h"
+
+LOG_MODULE_REGISTER(throughput, LOG_LEVEL_INF);
+
+#define PING_COUNT 10
+
+/* Connection intervals in 1.25 ms units: 7.5, 15, 30 and 50 ms */
+static const uint16_t intervals[] = {6, 12, 24, 40};
+
+static const uint8_t phys[] = {BT_GAP_LE_PHY_1M, BT_GAP_LE_PHY_2M};
+
+/* Largest notification payload for an ATT MTU of 23, 64 and 247. The MTU
+ * is exchanged once per connection, so smaller MTUs are stood in for by
+ * the payload size.
+ */
+static const uint16_t payloads[] = {20, 61, 244};
+
+#define COMBINATIONS (ARRAY_SIZE(phys) * ARRAY_SIZE(intervals) * ARRAY_SIZE(payloads))
+
+struct throughput_result {
+	uint8_t phy;
+	uint16_t interval;
+	uint16_t payload;
+	uint32_t ble_bps;      /* Notification payload bytes per second */
+	uint32_t cdc_bps;      /* Bytes per second accepted by CDC */
+	uint32_t cdc_busy_pct; /* Share of the stream spent in the CDC write */
+	uint32_t lost;         /* Notifications the peer sent that never arrived */
+	uint32_t rtt_p50_us;
+	uint32_t rtt_max_us;
+	int err;
+};
+
+enum throughput_phase {
+	PHASE_IDLE,
+	PHASE_STREAM,
+	PHASE_PING,
+};
+
+static atomic_t phase;
+static K_SEM_DEFINE(stream_done, 0, 1);
+static K_SEM_DEFINE(ping_done, 0, 1);
+static K_SEM_DEFINE(link_updated, 0, 1);
+
+/* Written on the BT RX thread during a phase, read once it has ended */
+static uint32_t rx_packets;
+static uint32_t rx_bytes;
+static uint32_t rx_expected;
+static uint32_t cdc_bytes;
+static uint32_t cdc_cycles;
+static uint32_t first_cycle;
+static uint32_t last_cycle;
+static uint32_t ping_rtt_us;
+
+static struct throughput_result results[COMBINATIONS];
+
+static void le_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+			     uint16_t timeout)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(interval);
+	ARG_UNUSED(latency);
+	ARG_UNUSED(timeout);
+
+	k_sem_give(&link_updated);
+}
+
+static void le_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *param)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(param);
+
+	k_sem_give(&link_updated);
+}
+
+BT_CONN_CB_DEFINE(throughput_conn_callbacks) = {
+	.le_param_updated = le_param_updated,
+	.le_phy_updated = le_phy_updated,
+};
+
+bool throughput_active(void)
+{
+	return atomic_get(&phase) != PHASE_IDLE;
+}
+
+void throughput_on_rx(const uint8_t *data, uint16_t len)
+{
+	uint32_t now = k_cycle_get_32();
+
+	if (atomic_get(&phase) == PHASE_PING) {
+		if (len >= 5 && data[0] == PEER_NUS_CMD_PING) {
+			ping_rtt_us = k_cyc_to_us_floor32(now - sys_get_le32(&data[1]));
+			k_sem_give(&ping_done);
+		}
+		return;
+	}
+
+	if (len == PEER_NUS_STREAM_END_LEN) {
+		rx_expected = sys_get_le32(data);
+		k_sem_give(&stream_done);
+		return;
+	}
+
+	if (rx_packets == 0) {
+		first_cycle = now;
+	}
+	last_cycle = now;
+	rx_packets++;
+	rx_bytes += len;
+
+	/* The same CDC framing and write as the bridge */
+	uint32_t t0 = k_cycle_get_32();
+
+	if (usb_cdc_send_data(data, len) == 0) {
+		cdc_bytes += len;
+	}
+	cdc_cycles += k_cycle_get_32() - t0;
+}
+
+/* Writes with response go one at a time */
+static int send_command(const uint8_t *data, uint16_t len)
+{
+	int err;
+
+	for (int i = 0; i < 1000; i++) {
+		err = ble_nus_client_send_data(data, len);
+		if (err != -EALREADY && err != -ENOMEM) {
+			break;
+		}
+		k_sleep(K_MSEC(1));
+	}
+	return err;
+}
+
+static int set_link(struct bt_conn *conn, uint8_t phy, uint16_t interval)
+{
+	const struct bt_conn_le_phy_param phy_param = {
+		.options = BT_CONN_LE_PHY_OPT_NONE,
+		.pref_tx_phy = phy,
+		.pref_rx_phy = phy,
+	};
+	int err;
+
+	k_sem_reset(&link_updated);
+	err = bt_conn_le_phy_update(conn, &phy_param);
+	if (err) {
+		return err;
+	}
+	k_sem_take(&link_updated, K_SECONDS(5));
+
+	k_sem_reset(&link_updated);
+	err = bt_conn_le_param_update(conn, BT_LE_CONN_PARAM(interval, interval, 0, 400));
+	if (err == -EALREADY) {
+		return 0;
+	}
+	if (err) {
+		return err;
+	}
+	if (k_sem_take(&link_updated, K_SECONDS(5))) {
+		return -ETIMEDOUT;
+	}
+	return 0;
+}
+
+static int measure_stream(uint16_t payload, struct throughput_result *result)
+{
+	uint8_t cmd[PEER_NUS_CMD_STREAM_LEN] = {PEER_NUS_CMD_STREAM};
+	int err;
+
+	sys_put_le16(payload, &cmd[1]);
+	sys_put_le32(CONFIG_NUS_THROUGHPUT_DURATION_MS, &cmd[3]);
+
+	rx_packets = 0;
+	rx_bytes = 0;
+	rx_expected = 0;
+	cdc_bytes = 0;
+	cdc_cycles = 0;
+	k_sem_reset(&stream_done);
+	atomic_set(&phase, PHASE_STREAM);
+
+	err = send_command(cmd, sizeof(cmd));
+	if (!err && k_sem_take(&stream_done, K_MSEC(CONFIG_NUS_THROUGHPUT_DURATION_MS + 5000))) {
+		err = -ETIMEDOUT;
+	}
+	atomic_set(&phase, PHASE_IDLE);
+	if (err) {
+		return err;
+	}
+
+	uint32_t span_us = MAX(k_cyc_to_us_floor32(last_cycle - first_cycle), 1);
+
+	result->ble_bps = (uint32_t)((uint64_t)rx_bytes * USEC_PER_SEC / span_us);
+	result->cdc_bps = (uint32_t)((uint64_t)cdc_bytes * USEC_PER_SEC / span_us);
+	result->cdc_busy_pct = MIN(k_cyc_to_us_floor32(cdc_cycles) * 100 / span_us, 100);
+	result->lost = rx_expected > rx_packets ? rx_expected - rx_packets : 0;
+	return 0;
+}
+
+static int measure_ping(struct throughput_result *result)
+{
+	uint32_t rtt[PING_COUNT];
+	uint8_t cmd[5] = {PEER_NUS_CMD_PING};
+	int count = 0;
+
+	atomic_set(&phase, PHASE_PING);
+	for (int i = 0; i < PING_COUNT; i++) {
+		k_sem_reset(&ping_done);
+		sys_put_le32(k_cycle_get_32(), &cmd[1]);
+		if (send_command(cmd, sizeof(cmd)) || k_sem_take(&ping_done, K_SECONDS(2))) {
+			continue;
+		}
+		rtt[count++] = ping_rtt_us;
+	}
+	atomic_set(&phase, PHASE_IDLE);
+
+	if (count == 0) {
+		return -ETIMEDOUT;
+	}
+
+	/* Insertion sort; ten values */
+	for (int i = 1; i < count; i++) {
+		uint32_t v = rtt[i];
+		int j = i - 1;
+
+		while (j >= 0 && rtt[j] > v) {
+			rtt[j + 1] = rtt[j];
+			j--;
+		}
+		rtt[j + 1] = v;
+	}
+	result->rtt_p50_us = rtt[count / 2];
+	result->rtt_max_us = rtt[count - 1];
+	return 0;
+}
+
+static void print_table(size_t count)
+{
+	printk("\n=== NUS -> CDC throughput (%d ms per run) ===\n", CONFIG_NUS_THROUGHPUT_DURATION_MS);
+	printk("PHY  CI ms  payload  BLE B/s  CDC B/s  CDC busy  lost  RTT p50/max ms  e2e ms\n");
+
+	for (size_t i = 0; i < count; i++) {
+		const struct throughput_result *r = &results[i];
+
+		if (r->err) {
+			printk("%s  %3u.%02u  %7u  failed (err %d)\n",
+			       r->phy == BT_GAP_LE_PHY_2M ? "2M" : "1M", r->interval * 125 / 100,
+			       r->interval * 125 % 100, r->payload, r->err);
+			continue;
+		}
+
+		/* One-way BLE estimate plus the CDC write for one notification */
+		uint32_t cdc_us = r->ble_bps ? (uint32_t)((uint64_t)r->cdc_busy_pct * 10000 /
+							   (r->ble_bps / r->payload + 1)) : 0;
+		uint32_t e2e_us = r->rtt_p50_us / 2 + cdc_us;
+
+		printk("%s  %3u.%02u  %7u  %7u  %7u  %7u%%  %4u  %6u.%01u/%u.%01u  %3u.%01u\n",
+		       r->phy == BT_GAP_LE_PHY_2M ? "2M" : "1M", r->interval * 125 / 100,
+		       r->interval * 125 % 100, r->payload, r->ble_bps, r->cdc_bps,
+		       r->cdc_busy_pct, r->lost, r->rtt_p50_us / 1000, (r->rtt_p50_us / 100) % 10,
+		       r->rtt_max_us / 1000, (r->rtt_max_us / 100) % 10, e2e_us / 1000,
+		       (e2e_us / 100) % 10);
+	}
+	printk("==============================================\n");
+}
+
+void throughput_run(void)
+{
+	size_t count = 0;
+
+	printk("Throughput mode: waiting for the NUS peer...\n");
+	while (!ble_transport_is_nus_ready()) {
+		k_sleep(K_MSEC(100));
+	}
+	/* Let the MTU exchange, pairing and CCC write finish */
+	k_sleep(K_SECONDS(1));
+
+	struct bt_conn *conn = ble_central_get_default_conn();
+
+	if (!conn) {
+		printk("Throughput mode: peer disconnected\n");
+		return;
+	}
+	conn = bt_conn_ref(conn);
+
+	uint16_t payload_max = bt_gatt_get_mtu(conn) - 3;
+
+	for (size_t p = 0; p < ARRAY_SIZE(phys); p++) {
+		for (size_t i = 0; i < ARRAY_SIZE(intervals); i++) {
+			for (size_t s = 0; s < ARRAY_SIZE(payloads); s++) {
+				struct throughput_result *r = &results[count++];
+
+				*r = (struct throughput_result){
+					.phy = phys[p],
+					.interval = intervals[i],
+					.payload = payloads[s],
+				};
+
+				if (payloads[s] > payload_max) {
+					r->err = -EMSGSIZE;
+					continue;
+				}
+
+				r->err = set_link(conn, phys[p], intervals[i]);
+				if (!r->err) {
+					r->err = measure_stream(payloads[s], r);
+				}
+				if (!r->err) {
+					r->err = measure_ping(r);
+				}
+				LOG_INF("Run %u/%u done (err %d)", count, COMBINATIONS, r->err);
+			}
+		}
+	}
+
+	bt_conn_unref(conn);
+	print_table(count);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief NUS to CDC throughput mode
+ *
+ * With CONFIG_NUS_THROUGHPUT the sample measures its own bridge before it
+ * starts bridging. The peer must answer the commands in
+ * ncs/sim/include/peer_nus_commands.h, as ncs/sim/mouthpad_peer does. For
+ * each PHY, connection interval and payload size the peer streams pattern
+ * data, which goes through the usual NUS client callback and out over CDC,
+ * and then answers a few pings. A summary table goes to the console.
+ */
+
+#ifndef THROUGHPUT_H
+#define THROUGHPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_NUS_THROUGHPUT)
+
+/* Wait for the NUS client, run every combination and print the table */
+void throughput_run(void);
+
+/* True while a measurement owns the NUS RX path */
+bool throughput_active(void);
+
+/* NUS notification during a measurement; forwards it to CDC */
+void throughput_on_rx(const uint8_t *data, uint16_t len);
+
+#else
+
+static inline void throughput_run(void)
+{
+}
+
+static inline bool throughput_active(void)
+{
+	return false;
+}
+
+static inline void throughput_on_rx(const uint8_t *data, uint16_t len)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+}
+
+#endif /* CONFIG_NUS_THROUGHPUT */
+
+#endif /* THROUGHPUT_H */
@@ -228,7 +228,7 @@ int usb_cdc_send_data(const uint8_t *data, uint16_t len)
 		return -EINVAL;
 	}
 
-	printk("*** FORWARDING %d BYTES TO CDC WITH NEW FRAMING ***\n", len);
+	LOG_DBG("Forwarding %d bytes to CDC", len);
 	
 	// Calculate CRC-16 for the payload
 	uint16_t crc = calculate_crc16(data, len);
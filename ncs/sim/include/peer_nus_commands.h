@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief NUS commands understood by the simulated MouthPad
+ *
+ * A central writes these to the NUS RX characteristic of
+ * ncs/sim/mouthpad_peer to make it produce traffic on demand; the
+ * throughput mode of ncs/samples/ble_nus_usb_cdc uses them. All integers
+ * are little-endian.
+ *
+ * - Stream: 'S', payload size (2 bytes), duration in ms (4 bytes). The
+ *   peer sends notifications of that size back to back for that long,
+ *   each starting with its sequence number (4 bytes) followed by the low
+ *   byte of the sequence number repeated. It then sends one end marker of
+ *   PEER_NUS_STREAM_END_LEN bytes holding the number of notifications.
+ * - Ping: 'P' followed by up to PEER_NUS_PING_MAX - 1 bytes. The peer
+ *   notifies the same bytes straight back.
+ */
+
+#ifndef PEER_NUS_COMMANDS_H_
+#define PEER_NUS_COMMANDS_H_
+
+#define PEER_NUS_CMD_STREAM     'S'
+#define PEER_NUS_CMD_STREAM_LEN 7
+#define PEER_NUS_CMD_PING       'P'
+#define PEER_NUS_PING_MAX       20
+
+/* Stream notifications are never this short */
+#define PEER_NUS_STREAM_END_LEN 4
+#define PEER_NUS_STREAM_MIN     8
+
+#endif /* PEER_NUS_COMMANDS_H_ */
@@ -0,0 +1,698 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Simulated MouthPad for BabbleSim runs of the relay
+ *
+ * Advertises like a MouthPad (HIDS, NUS and the "MP1" manufacturer data the
+ * relay looks for) with the report map from common/mouthpad_hid_reports.h.
+ * Once the relay has connected and subscribed, the scenarios enabled in
+ * Kconfig run one after another:
+ *
+ * - reconnect storm: drop the link and time how long the relay takes to
+ *   connect again and to subscribe again
+ * - bursty motion: motion reports at a fixed rate in bursts separated by
+ *   idle gaps, a click at the end of each burst
+ * - large NUS transfer: MTU-sized notifications back to back
+ *
+ * It also streams and echoes on request over NUS (see peer_nus_commands.h).
+ *
+ * Results are logged as "METRIC <scenario> key=value ..." lines. Under
+ * BabbleSim all times are simulated, so a run with the same seeds gives the
+ * same numbers; it also runs on a real nRF52 board as a stand-in MouthPad.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/services/hids.h>
+#include <bluetooth/services/nus.h>
+
+#include "mouthpad_hid_reports.h"
+#include "peer_nus_commands.h"
+
+LOG_MODULE_REGISTER(mouthpad_peer, LOG_LEVEL_INF);
+
+/* Input reports in the HIDS report group, in report ID order */
+#define REP_INDEX_BUTTONS 0
+#define REP_INDEX_MOTION  1
+
+/* Company ID and payload the relay expects from an unbonded MouthPad */
+#define MOUTHPAD_COMPANY_ID 0x4147
+
+#define EVT_CONNECTED    BIT(0)
+#define EVT_DISCONNECTED BIT(1)
+#define EVT_NUS_ENABLED  BIT(2)
+
+/* Notifications whose completion is still awaited, for motion latency */
+#define PENDING_MAX 64
+
+#define NUS_CHUNK_MAX 244
+
+BT_HIDS_DEF(hids_obj, MOUTHPAD_HID_REPORT_SIZE_MOUSE_BUTTONS, MOUTHPAD_HID_REPORT_SIZE_MOUSE_MOTION,
+	    MOUTHPAD_HID_REPORT_SIZE_CONSUMER, MOUTHPAD_HID_REPORT_SIZE_KEYBOARD);
+
+static const uint8_t report_map[] = {MOUTHPAD_HID_REPORT_DESC};
+
+static const struct bt_data ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	BT_DATA_BYTES(BT_DATA_UUID16_ALL, BT_UUID_16_ENCODE(BT_UUID_HIDS_VAL)),
+	BT_DATA_BYTES(BT_DATA_MANUFACTURER_DATA, BT_BYTES_LIST_LE16(MOUTHPAD_COMPANY_ID), 'M', 'P',
+		      '1'),
+	BT_DATA(BT_DATA_NAME_COMPLETE, CONFIG_BT_DEVICE_NAME, sizeof(CONFIG_BT_DEVICE_NAME) - 1),
+};
+
+static const struct bt_data sd[] = {
+	BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_NUS_VAL),
+};
+
+static K_EVENT_DEFINE(peer_events);
+static struct k_spinlock conn_lock;
+static struct bt_conn *peer_conn;
+static int64_t connected_at;
+
+static void adv_work_handler(struct k_work *work);
+static K_WORK_DEFINE(adv_work, adv_work_handler);
+
+/* Send timestamps of motion notifications, oldest first */
+static struct k_spinlock pending_lock;
+static int64_t pending[PENDING_MAX];
+static uint32_t pending_head;
+static uint32_t pending_count;
+
+static atomic_t nus_sent;
+
+struct metric {
+	uint32_t n;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+};
+
+static struct metric motion_latency;
+
+static uint32_t ticks_to_us(int64_t ticks)
+{
+	return (uint32_t)k_ticks_to_us_floor64(ticks);
+}
+
+static void metric_add(struct metric *m, uint32_t value)
+{
+	if (m->n == 0 || value < m->min) {
+		m->min = value;
+	}
+	if (value > m->max) {
+		m->max = value;
+	}
+	m->sum += value;
+	m->n++;
+}
+
+static void metric_log(const char *scenario, const char *name, const struct metric *m)
+{
+	LOG_INF("METRIC %s %s n=%u min=%u avg=%u max=%u", scenario, name, m->n, m->min,
+		m->n ? (uint32_t)(m->sum / m->n) : 0, m->max);
+}
+
+/* Reference to the current connection, or NULL; the caller unrefs */
+static struct bt_conn *conn_get(void)
+{
+	struct bt_conn *conn = NULL;
+
+	K_SPINLOCK(&conn_lock) {
+		if (peer_conn) {
+			conn = bt_conn_ref(peer_conn);
+		}
+	}
+	return conn;
+}
+
+static void adv_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	int err = bt_le_adv_start(BT_LE_ADV_CONN_FAST_1, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+
+	if (err && err != -EALREADY) {
+		LOG_ERR("Advertising failed to start (err %d)", err);
+	}
+}
+
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+	if (err) {
+		LOG_WRN("Connection failed (err 0x%02x)", err);
+		return;
+	}
+
+	bt_hids_connected(&hids_obj, conn);
+
+	K_SPINLOCK(&conn_lock) {
+		peer_conn = bt_conn_ref(conn);
+		connected_at = k_uptime_ticks();
+	}
+	k_event_clear(&peer_events, EVT_DISCONNECTED);
+	k_event_post(&peer_events, EVT_CONNECTED);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	struct bt_conn *old = NULL;
+
+	LOG_INF("Disconnected (reason 0x%02x)", reason);
+	bt_hids_disconnected(&hids_obj, conn);
+
+	K_SPINLOCK(&conn_lock) {
+		if (peer_conn == conn) {
+			old = peer_conn;
+			peer_conn = NULL;
+		}
+	}
+	if (old) {
+		bt_conn_unref(old);
+	}
+
+	/* Anything still in flight will not complete */
+	K_SPINLOCK(&pending_lock) {
+		pending_count = 0;
+	}
+
+	k_event_clear(&peer_events, EVT_CONNECTED | EVT_NUS_ENABLED);
+	k_event_post(&peer_events, EVT_DISCONNECTED);
+}
+
+static void recycled(void)
+{
+	k_work_submit(&adv_work);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.connected = connected,
+	.disconnected = disconnected,
+	.recycled = recycled,
+};
+
+static void nus_send_enabled(enum bt_nus_send_status status)
+{
+	if (status == BT_NUS_SEND_STATUS_ENABLED) {
+		k_event_post(&peer_events, EVT_NUS_ENABLED);
+	} else {
+		k_event_clear(&peer_events, EVT_NUS_ENABLED);
+	}
+}
+
+static void nus_sent_cb(struct bt_conn *conn)
+{
+	ARG_UNUSED(conn);
+	atomic_inc(&nus_sent);
+}
+
+#if IS_ENABLED(CONFIG_PEER_NUS_COMMANDS)
+
+#define NUS_COMMAND_THREAD_PRIORITY 7
+
+struct nus_command {
+	uint8_t len;
+	uint8_t data[PEER_NUS_PING_MAX];
+};
+
+K_MSGQ_DEFINE(nus_commands, sizeof(struct nus_command), 4, 4);
+
+static void nus_received(struct bt_conn *conn, const uint8_t *const data, uint16_t len)
+{
+	struct nus_command cmd = {.len = MIN(len, sizeof(cmd.data))};
+
+	ARG_UNUSED(conn);
+
+	if (len == 0) {
+		return;
+	}
+	memcpy(cmd.data, data, cmd.len);
+	if (k_msgq_put(&nus_commands, &cmd, K_NO_WAIT)) {
+		LOG_WRN("NUS command dropped");
+	}
+}
+
+static int nus_send_retry(struct bt_conn *conn, const uint8_t *data, uint16_t len)
+{
+	int err;
+
+	for (int i = 0; i < 100; i++) {
+		err = bt_nus_send(conn, data, len);
+		if (err != -ENOMEM && err != -EAGAIN) {
+			break;
+		}
+		k_sleep(K_MSEC(1));
+	}
+	return err;
+}
+
+static void command_stream(struct bt_conn *conn, const struct nus_command *cmd)
+{
+	static uint8_t chunk[NUS_CHUNK_MAX];
+	uint8_t end_marker[PEER_NUS_STREAM_END_LEN];
+	uint32_t seq = 0;
+
+	if (cmd->len < PEER_NUS_CMD_STREAM_LEN) {
+		return;
+	}
+
+	uint32_t size = CLAMP(sys_get_le16(&cmd->data[1]), PEER_NUS_STREAM_MIN,
+			      MIN(bt_nus_get_mtu(conn), sizeof(chunk)));
+	int64_t end = k_uptime_ticks() + k_ms_to_ticks_ceil64(sys_get_le32(&cmd->data[3]));
+
+	while (k_uptime_ticks() < end) {
+		memset(chunk, (uint8_t)seq, size);
+		sys_put_le32(seq, chunk);
+
+		int err = bt_nus_send(conn, chunk, size);
+
+		if (err == -ENOMEM || err == -EAGAIN) {
+			k_sleep(K_MSEC(1));
+			continue;
+		}
+		if (err) {
+			return;
+		}
+		seq++;
+	}
+
+	sys_put_le32(seq, end_marker);
+	nus_send_retry(conn, end_marker, sizeof(end_marker));
+}
+
+static void nus_command_thread(void *p1, void *p2, void *p3)
+{
+	struct nus_command cmd;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		k_msgq_get(&nus_commands, &cmd, K_FOREVER);
+
+		struct bt_conn *conn = conn_get();
+
+		if (!conn) {
+			continue;
+		}
+		if (cmd.data[0] == PEER_NUS_CMD_STREAM) {
+			command_stream(conn, &cmd);
+		} else if (cmd.data[0] == PEER_NUS_CMD_PING) {
+			nus_send_retry(conn, cmd.data, cmd.len);
+		}
+		bt_conn_unref(conn);
+	}
+}
+
+K_THREAD_DEFINE(nus_command_tid, CONFIG_PEER_NUS_COMMAND_STACK_SIZE, nus_command_thread, NULL,
+		NULL, NULL, NUS_COMMAND_THREAD_PRIORITY, 0, 0);
+
+#endif /* CONFIG_PEER_NUS_COMMANDS */
+
+static struct bt_nus_cb nus_callbacks = {
+#if IS_ENABLED(CONFIG_PEER_NUS_COMMANDS)
+	.received = nus_received,
+#endif
+	.send_enabled = nus_send_enabled,
+	.sent = nus_sent_cb,
+};
+
+/* Notifications complete in the order they were queued */
+static void motion_sent(struct bt_conn *conn, void *user_data)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(user_data);
+
+	int64_t now = k_uptime_ticks();
+
+	K_SPINLOCK(&pending_lock) {
+		if (pending_count > 0) {
+			metric_add(&motion_latency, ticks_to_us(now - pending[pending_head]));
+			pending_head = (pending_head + 1) % PENDING_MAX;
+			pending_count--;
+		}
+	}
+}
+
+/* One count left or right, alternately, so the cursor stays put */
+static int send_motion(struct bt_conn *conn, uint32_t seq)
+{
+	uint8_t report[MOUTHPAD_HID_REPORT_SIZE_MOUSE_MOTION] = {
+		(seq & 1) ? 0xFF : 0x01,
+		(seq & 1) ? 0x0F : 0x00,
+		0x00,
+	};
+	bool tracked = false;
+	int err;
+
+	K_SPINLOCK(&pending_lock) {
+		if (pending_count < PENDING_MAX) {
+			pending[(pending_head + pending_count) % PENDING_MAX] = k_uptime_ticks();
+			pending_count++;
+			tracked = true;
+		}
+	}
+
+	err = bt_hids_inp_rep_send(&hids_obj, conn, REP_INDEX_MOTION, report, sizeof(report),
+				   tracked ? motion_sent : NULL);
+
+	/* Not queued, so no completion will pop it */
+	if (err && tracked) {
+		K_SPINLOCK(&pending_lock) {
+			if (pending_count > 0) {
+				pending_count--;
+			}
+		}
+	}
+	return err;
+}
+
+static int send_buttons(struct bt_conn *conn, uint8_t buttons)
+{
+	uint8_t report[MOUTHPAD_HID_REPORT_SIZE_MOUSE_BUTTONS] = {buttons};
+	int err;
+
+	/* A transition must not be lost: wait for a buffer */
+	for (int i = 0; i < 100; i++) {
+		err = bt_hids_inp_rep_send(&hids_obj, conn, REP_INDEX_BUTTONS, report,
+					   sizeof(report), NULL);
+		if (err != -ENOMEM) {
+			break;
+		}
+		k_sleep(K_MSEC(1));
+	}
+	return err;
+}
+
+/* Connected and subscribed to NUS and the motion report; returns when the
+ * relay is ready, in ticks, or a negative error
+ */
+static int64_t wait_ready(void)
+{
+	uint8_t idle[MOUTHPAD_HID_REPORT_SIZE_MOUSE_MOTION] = {0};
+	int64_t deadline = k_uptime_ticks() + k_ms_to_ticks_ceil64(CONFIG_PEER_READY_TIMEOUT_MS);
+
+	if (!k_event_wait_all(&peer_events, EVT_CONNECTED | EVT_NUS_ENABLED, false,
+			      K_MSEC(CONFIG_PEER_READY_TIMEOUT_MS))) {
+		return -ETIMEDOUT;
+	}
+
+	/* HIDS reports no subscriptions, but a notification to a client that
+	 * has not subscribed is refused
+	 */
+	for (;;) {
+		struct bt_conn *conn = conn_get();
+		int err = -ENOTCONN;
+
+		if (conn) {
+			err = bt_hids_inp_rep_send(&hids_obj, conn, REP_INDEX_MOTION, idle,
+						   sizeof(idle), NULL);
+			bt_conn_unref(conn);
+		}
+		if (err == 0) {
+			return k_uptime_ticks();
+		}
+		if (!conn || k_uptime_ticks() > deadline) {
+			return -ETIMEDOUT;
+		}
+		k_sleep(K_MSEC(1));
+	}
+}
+
+static void scenario_reconnect(void)
+{
+	struct metric connect = {0};
+	struct metric ready = {0};
+	uint32_t failed = 0;
+
+	LOG_INF("Scenario: reconnect storm, %d cycles", CONFIG_PEER_RECONNECT_CYCLES);
+
+	for (int i = 0; i < CONFIG_PEER_RECONNECT_CYCLES; i++) {
+		k_sleep(K_MSEC(CONFIG_PEER_RECONNECT_HOLD_MS));
+
+		struct bt_conn *conn = conn_get();
+
+		if (!conn) {
+			failed++;
+			break;
+		}
+
+		int64_t dropped_at = k_uptime_ticks();
+
+		bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+		bt_conn_unref(conn);
+		k_event_wait(&peer_events, EVT_DISCONNECTED, false, K_SECONDS(5));
+
+		int64_t ready_at = wait_ready();
+
+		if (ready_at < 0) {
+			failed++;
+			break;
+		}
+
+		int64_t up_at;
+
+		K_SPINLOCK(&conn_lock) {
+			up_at = connected_at;
+		}
+		metric_add(&connect, k_ticks_to_ms_floor32(up_at - dropped_at));
+		metric_add(&ready, k_ticks_to_ms_floor32(ready_at - up_at));
+	}
+
+	metric_log("reconnect", "connect_ms", &connect);
+	metric_log("reconnect", "subscribe_ms", &ready);
+	LOG_INF("METRIC reconnect failed=%u", failed);
+}
+
+static void scenario_motion(void)
+{
+	int64_t period = MAX(k_us_to_ticks_ceil64(USEC_PER_SEC / CONFIG_PEER_MOTION_RATE_HZ), 1);
+	uint32_t sent = 0;
+	uint32_t busy = 0;
+	uint32_t late = 0;
+	uint32_t active_ms = 0;
+	int aborted = 0;
+
+	LOG_INF("Scenario: motion, %d bursts of %d ms at %d Hz", CONFIG_PEER_MOTION_BURSTS,
+		CONFIG_PEER_MOTION_BURST_MS, CONFIG_PEER_MOTION_RATE_HZ);
+
+	K_SPINLOCK(&pending_lock) {
+		motion_latency = (struct metric){0};
+		pending_count = 0;
+	}
+
+	for (int burst = 0; burst < CONFIG_PEER_MOTION_BURSTS && !aborted; burst++) {
+		struct bt_conn *conn = conn_get();
+
+		if (!conn) {
+			aborted = -ENOTCONN;
+			break;
+		}
+
+		int64_t start = k_uptime_ticks();
+		int64_t end = start + k_ms_to_ticks_ceil64(CONFIG_PEER_MOTION_BURST_MS);
+		int64_t next = start;
+
+		for (uint32_t seq = 0; next < end; seq++) {
+			k_sleep(K_TIMEOUT_ABS_TICKS(next));
+
+			int err = send_motion(conn, seq);
+
+			if (err == 0) {
+				sent++;
+			} else if (err == -ENOMEM) {
+				busy++;
+			} else {
+				aborted = err;
+				break;
+			}
+
+			/* Behind by a whole slot: skip ahead instead of bursting */
+			next += period;
+			int64_t now = k_uptime_ticks();
+
+			if (now > next + period) {
+				int64_t missed = (now - next) / period;
+
+				late += (uint32_t)missed;
+				next += missed * period;
+			}
+		}
+
+		if (!aborted) {
+			send_buttons(conn, 0x01);
+			send_buttons(conn, 0x00);
+		}
+		bt_conn_unref(conn);
+
+		active_ms += k_ticks_to_ms_floor32(k_uptime_ticks() - start);
+		k_sleep(K_MSEC(CONFIG_PEER_MOTION_GAP_MS));
+	}
+
+	struct metric latency;
+
+	K_SPINLOCK(&pending_lock) {
+		latency = motion_latency;
+	}
+
+	LOG_INF("METRIC motion sent=%u busy=%u late=%u rate_hz=%u aborted=%d", sent, busy, late,
+		active_ms ? (uint32_t)((uint64_t)sent * MSEC_PER_SEC / active_ms) : 0, aborted);
+	metric_log("motion", "latency_us", &latency);
+}
+
+static void scenario_nus(void)
+{
+	static uint8_t chunk[NUS_CHUNK_MAX];
+	struct bt_conn *conn = conn_get();
+	uint32_t offset = 0;
+	uint32_t notifications = 0;
+	uint32_t busy = 0;
+	int err = 0;
+
+	if (!conn) {
+		LOG_INF("METRIC nus aborted=%d", -ENOTCONN);
+		return;
+	}
+
+	uint32_t size = MIN(bt_nus_get_mtu(conn), sizeof(chunk));
+
+	LOG_INF("Scenario: NUS transfer, %d bytes in %u byte notifications", CONFIG_PEER_NUS_BYTES,
+		size);
+
+	atomic_set(&nus_sent, 0);
+	int64_t start = k_uptime_ticks();
+
+	while (offset < CONFIG_PEER_NUS_BYTES) {
+		uint32_t len = MIN(size, CONFIG_PEER_NUS_BYTES - offset);
+
+		/* Offset up front so a capture on CDC0 shows gaps */
+		memset(chunk, (uint8_t)notifications, len);
+		sys_put_le32(offset, chunk);
+
+		err = bt_nus_send(conn, chunk, len);
+		if (err == -ENOMEM || err == -EAGAIN) {
+			busy++;
+			k_sleep(K_MSEC(1));
+			continue;
+		}
+		if (err) {
+			break;
+		}
+		offset += len;
+		notifications++;
+	}
+
+	/* Throughput counts until the last notification has gone out */
+	for (int i = 0; i < 5000 && atomic_get(&nus_sent) < notifications; i++) {
+		k_sleep(K_MSEC(1));
+	}
+
+	uint32_t elapsed_ms = MAX(k_ticks_to_ms_floor32(k_uptime_ticks() - start), 1);
+
+	bt_conn_unref(conn);
+
+	LOG_INF("METRIC nus bytes=%u notifications=%u busy=%u elapsed_ms=%u throughput_bps=%u "
+		"aborted=%d",
+		offset, notifications, busy, elapsed_ms,
+		(uint32_t)((uint64_t)offset * 8 * MSEC_PER_SEC / elapsed_ms), err);
+}
+
+static int hids_init(void)
+{
+	static const uint8_t sizes[] = {
+#define REPORT_SIZE(name, id, size) (size),
+		MOUTHPAD_HID_REPORTS(REPORT_SIZE)
+#undef REPORT_SIZE
+	};
+	static const uint8_t ids[] = {
+#define REPORT_ID(name, id, size) (id),
+		MOUTHPAD_HID_REPORTS(REPORT_ID)
+#undef REPORT_ID
+	};
+	struct bt_hids_init_param param = {0};
+
+	param.rep_map.data = report_map;
+	param.rep_map.size = sizeof(report_map);
+	param.info.bcd_hid = 0x0101;
+	param.info.b_country_code = 0x00;
+	param.info.flags = BT_HIDS_REMOTE_WAKE | BT_HIDS_NORMALLY_CONNECTABLE;
+
+	for (size_t i = 0; i < ARRAY_SIZE(ids); i++) {
+		struct bt_hids_inp_rep *rep = &param.inp_rep_group_init.reports[i];
+
+		rep->id = ids[i];
+		rep->size = sizes[i];
+		param.inp_rep_group_init.cnt++;
+	}
+
+	return bt_hids_init(&hids_obj, &param);
+}
+
+int main(void)
+{
+	int err;
+
+	LOG_INF("=== Simulated MouthPad ===");
+
+	err = bt_enable(NULL);
+	if (err) {
+		LOG_ERR("Bluetooth init failed (err %d)", err);
+		return 0;
+	}
+
+	err = hids_init();
+	if (err) {
+		LOG_ERR("HIDS init failed (err %d)", err);
+		return 0;
+	}
+
+	err = bt_nus_init(&nus_callbacks);
+	if (err) {
+		LOG_ERR("NUS init failed (err %d)", err);
+		return 0;
+	}
+
+	k_work_submit(&adv_work);
+
+	/* No scenarios: only answer NUS commands */
+	if (!IS_ENABLED(CONFIG_PEER_SCENARIO_RECONNECT) && !IS_ENABLED(CONFIG_PEER_SCENARIO_MOTION) &&
+	    !IS_ENABLED(CONFIG_PEER_SCENARIO_NUS)) {
+		return 0;
+	}
+
+	if (wait_ready() < 0) {
+		LOG_ERR("Relay did not connect and subscribe");
+		LOG_INF("METRIC done failed=1");
+		return 0;
+	}
+	LOG_INF("Relay connected and subscribed");
+
+	if (IS_ENABLED(CONFIG_PEER_SCENARIO_RECONNECT)) {
+		k_sleep(K_MSEC(CONFIG_PEER_SETTLE_MS));
+		scenario_reconnect();
+	}
+	if (IS_ENABLED(CONFIG_PEER_SCENARIO_MOTION) && wait_ready() >= 0) {
+		k_sleep(K_MSEC(CONFIG_PEER_SETTLE_MS));
+		scenario_motion();
+	}
+	if (IS_ENABLED(CONFIG_PEER_SCENARIO_NUS) && wait_ready() >= 0) {
+		k_sleep(K_MSEC(CONFIG_PEER_SETTLE_MS));
+		scenario_nus();
+	}
+
+	LOG_INF("METRIC done failed=0");
+	return 0;
+}
@@ -0,0 +1,51 @@
+#!/bin/sh
+#
+# Copyright (c) 2025 Robert Dale Smith
+# Copyright (c) 2025 Augmental Tech
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Run the relay against the simulated MouthPad on one simulated 2.4 GHz
+# radio and print the METRIC lines from both. Same seeds, same numbers.
+#
+# Usage: run_bsim.sh <relay zephyr.exe> <peer zephyr.exe>
+# Environment: BSIM_OUT_PATH (required), SIM_SECONDS (120), SEED (1),
+#              LOG_DIR (build-sim/logs)
+
+set -eu
+
+if [ $# -ne 2 ]; then
+	echo "Usage: $0 <relay zephyr.exe> <peer zephyr.exe>" >&2
+	exit 2
+fi
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH is not set, see ncs/README.md}"
+
+RELAY_EXE=$(realpath "$1")
+PEER_EXE=$(realpath "$2")
+SIM_SECONDS=${SIM_SECONDS:-120}
+SEED=${SEED:-1}
+LOG_DIR=$(realpath -m "${LOG_DIR:-build-sim/logs}")
+SIM_ID=mouthpad_$$
+
+mkdir -p "$LOG_DIR"
+cd "$BSIM_OUT_PATH/bin"
+
+"$RELAY_EXE" -s="$SIM_ID" -d=0 -rs="$SEED" > "$LOG_DIR/relay.log" 2>&1 &
+RELAY_PID=$!
+"$PEER_EXE" -s="$SIM_ID" -d=1 -rs="$((SEED + 1))" > "$LOG_DIR/peer.log" 2>&1 &
+PEER_PID=$!
+
+./bs_2G4_phy_v1 -s="$SIM_ID" -D=2 -sim_length="$((SIM_SECONDS * 1000000))" \
+	> "$LOG_DIR/phy.log" 2>&1
+
+wait "$RELAY_PID" "$PEER_PID" || true
+
+echo "=== Simulated MouthPad ==="
+grep -h "METRIC" "$LOG_DIR/peer.log" | sed 's/.*METRIC /  /' || true
+echo "=== Relay ==="
+grep -h "Connection timing" "$LOG_DIR/relay.log" | sed 's/.*: /  timing /' || true
+grep -h "METRIC relay" "$LOG_DIR/relay.log" | tail -n 1 | sed 's/.*METRIC /  /' || true
+echo "Logs in $LOG_DIR"
+
+# A run that never finished its scenarios fails
+grep -q "METRIC done failed=0" "$LOG_DIR/peer.log"
@@ -0,0 +1,352 @@
+// CDC0 deframer for the web client. Runs as a Web Worker so deframing and
+// CRC stay off the UI thread; the page loads it as a plain script too, for
+// CRC16_TABLE and as a fallback where workers are unavailable.
+//
+// Received chunks are copied into a fixed Uint8Array ring, and each
+// complete frame's payload is copied once into its own ArrayBuffer, which
+// is transferred to the page rather than cloned. Nothing is shifted or
+// re-sliced as bytes are consumed, so fragmented input costs the same as
+// whole frames.
+//
+// Frame formats, as processBuffer() used to accept them:
+//   [0xAA][0x55][LEN_H][LEN_L][DATA...][CRC_H][CRC_L]   relay firmware
+//   [0xAA][LEN_L][LEN_H][DATA...][0x55]                 older firmware
+// and, from relays with RELAY_FEATURE.COBS_FRAMING:
+//   [0x00][COBS(DATA... CRC_H CRC_L)][0x00]
+// which is told apart by its first byte. cobs is set when the last frame
+// was COBS, so the page can answer in kind.
+//
+// When mouthpad_core.wasm (built from web/wasm) sits next to this file, the
+// worker uses WasmDeframer instead: the firmware's own C deframer and
+// nanopb decoder, which also unwraps pass-through messages. It only knows
+// the relay firmware's format.
+
+// CRC-16/CCITT-FALSE lookup table (polynomial 0x1021), one entry per byte value
+const CRC16_TABLE = (() => {
+    const table = new Uint16Array(256);
+    for (let i = 0; i < 256; i++) {
+        let crc = i << 8;
+        for (let j = 0; j < 8; j++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+        table[i] = crc & 0xFFFF;
+    }
+    return table;
+})();
+
+// Longest payload accepted; the firmware's limit is 512 (MOUTHPAD_FRAME_MAX_PAYLOAD)
+const DEFRAMER_MAX_PAYLOAD = 1000;
+
+// Ring size; a power of two, and larger than any frame
+const DEFRAMER_RING_SIZE = 1 << 14;
+
+// Longest COBS frame between its delimiters: payload, CRC and code bytes
+const DEFRAMER_MAX_COBS = DEFRAMER_MAX_PAYLOAD + 2 + Math.ceil((DEFRAMER_MAX_PAYLOAD + 2) / 254);
+
+class MouthpadDeframer {
+    constructor() {
+        this.ring = new Uint8Array(DEFRAMER_RING_SIZE);
+        this.mask = DEFRAMER_RING_SIZE - 1;
+        this.reset();
+    }
+
+    reset() {
+        this.head = 0; // Next byte to parse; head and tail only grow
+        this.tail = 0; // Next byte to write
+        this.crcErrors = 0; // CRC or old-format end marker mismatches
+        this.lengthErrors = 0;
+        this.discarded = 0; // Bytes skipped looking for a frame start
+        this.cobs = false; // Last frame was COBS
+    }
+
+    at(i) {
+        return this.ring[(this.head + i) & this.mask];
+    }
+
+    // Copy len bytes from offset into a new ArrayBuffer
+    copyOut(offset, len) {
+        const out = new Uint8Array(len);
+        const start = (this.head + offset) & this.mask;
+        const first = Math.min(len, DEFRAMER_RING_SIZE - start);
+        out.set(this.ring.subarray(start, start + first));
+        if (first < len) {
+            out.set(this.ring.subarray(0, len - first), first);
+        }
+        return out.buffer;
+    }
+
+    crcOver(offset, len) {
+        let crc = 0xFFFF;
+        for (let i = 0; i < len; i++) {
+            crc = ((crc << 8) ^ CRC16_TABLE[((crc >> 8) ^ this.ring[(this.head + offset + i) & this.mask]) & 0xFF]) & 0xFFFF;
+        }
+        return crc;
+    }
+
+    drop(n) {
+        this.head += n;
+    }
+
+    // Decode the COBS frame whose closing zero is at end; null if malformed
+    decodeCobs(end) {
+        const out = new Uint8Array(end - 1);
+        let n = 0;
+        for (let i = 1; i < end;) {
+            const code = this.at(i++);
+            if (i + code - 1 > end) {
+                return null;
+            }
+            for (const stop = i + code - 1; i < stop; i++) {
+                out[n++] = this.at(i);
+            }
+            if (code !== 0xFF && i < end) {
+                out[n++] = 0;
+            }
+        }
+        return out.subarray(0, n);
+    }
+
+    // COBS frame at head; false to wait for more bytes
+    parseCobs(frames, avail) {
+        let end = 1;
+        while (end < avail && this.at(end) !== 0x00) end++;
+
+        if (end === avail) {
+            if (avail - 1 <= DEFRAMER_MAX_COBS) {
+                return false;
+            }
+            // No closing zero in reach: nothing up to here is a frame
+            this.lengthErrors++;
+            this.drop(avail);
+            return true;
+        }
+        if (end === 1) {
+            this.drop(1); // Back-to-back delimiters: the second opens the next frame
+            return true;
+        }
+
+        const decoded = this.decodeCobs(end);
+        if (decoded && decoded.length - 2 > DEFRAMER_MAX_PAYLOAD) {
+            this.lengthErrors++;
+            this.drop(end);
+            return true;
+        }
+        if (!decoded || decoded.length < 2) {
+            this.crcErrors++;
+            this.drop(end); // The zero may open the next frame
+            return true;
+        }
+
+        const len = decoded.length - 2;
+        let crc = 0xFFFF;
+        for (let i = 0; i < len; i++) {
+            crc = ((crc << 8) ^ CRC16_TABLE[((crc >> 8) ^ decoded[i]) & 0xFF]) & 0xFFFF;
+        }
+        if (crc !== ((decoded[len] << 8) | decoded[len + 1])) {
+            this.crcErrors++;
+            this.drop(end);
+            return true;
+        }
+
+        frames.push({ oldFormat: false, payload: decoded.slice(0, len).buffer });
+        this.cobs = true;
+        this.drop(end + 1);
+        return true;
+    }
+
+    // Feed one received chunk; returns {frames: [{oldFormat, payload}], partial}
+    // where payload is an ArrayBuffer and partial is the bytes of an
+    // unfinished frame left waiting
+    push(data) {
+        const frames = [];
+        let pos = 0;
+
+        // A chunk larger than the free space is taken in pieces; parsing
+        // always leaves less than one frame behind
+        while (pos < data.length) {
+            const free = DEFRAMER_RING_SIZE - (this.tail - this.head);
+            const n = Math.min(free, data.length - pos);
+            const start = this.tail & this.mask;
+            const first = Math.min(n, DEFRAMER_RING_SIZE - start);
+            this.ring.set(data.subarray(pos, pos + first), start);
+            if (first < n) {
+                this.ring.set(data.subarray(pos + first, pos + n), 0);
+            }
+            this.tail += n;
+            pos += n;
+            this.parse(frames);
+        }
+        return { frames, partial: this.tail - this.head };
+    }
+
+    parse(frames) {
+        while (this.tail - this.head >= 5) {
+            const avail = this.tail - this.head;
+
+            // Resynchronise on 0xAA or a COBS delimiter, keeping the last
+            // bytes in case a start is split
+            let start = 0;
+            while (start < avail - 4 && this.at(start) !== 0xAA && this.at(start) !== 0x00) start++;
+            if (start === avail - 4) {
+                this.discarded += start;
+                this.drop(start);
+                return;
+            }
+            this.discarded += start;
+            this.drop(start);
+
+            if (this.at(0) === 0x00) {
+                if (!this.parseCobs(frames, avail - start)) {
+                    return; // Wait for the closing zero
+                }
+                continue;
+            }
+
+            const newFormat = this.at(1) === 0x55;
+            const len = newFormat ? (this.at(2) << 8) | this.at(3) : this.at(1) | (this.at(2) << 8);
+            const total = newFormat ? len + 6 : len + 4;
+
+            if (len > DEFRAMER_MAX_PAYLOAD) {
+                this.lengthErrors++;
+                this.drop(1);
+                continue;
+            }
+            if (this.tail - this.head < total) {
+                return; // Wait for the rest
+            }
+
+            if (newFormat) {
+                const crc = (this.at(4 + len) << 8) | this.at(5 + len);
+                if (crc !== this.crcOver(4, len)) {
+                    this.crcErrors++;
+                    this.drop(1);
+                    continue;
+                }
+                frames.push({ oldFormat: false, payload: this.copyOut(4, len) });
+                this.cobs = false;
+            } else {
+                if (this.at(3 + len) !== 0x55) {
+                    this.crcErrors++;
+                    this.drop(1);
+                    continue;
+                }
+                frames.push({ oldFormat: true, payload: this.copyOut(3, len) });
+            }
+            this.drop(total);
+        }
+    }
+
+    // Error counts since the last call
+    takeErrors() {
+        const errors = { crc: this.crcErrors, length: this.lengthErrors, discarded: this.discarded };
+        this.crcErrors = 0;
+        this.lengthErrors = 0;
+        this.discarded = 0;
+        return errors;
+    }
+}
+
+// Record kinds written by mouthpad_wasm_feed(), in web/wasm/mouthpad_wasm.c
+const WASM_RECORD_KINDS = ['pass-through', 'chunk', 'message', 'raw'];
+const WASM_RECORD_HEADER = 12;
+
+// Same interface as MouthpadDeframer, over the WebAssembly module. Frames
+// carry a kind: 'pass-through' (a PassThroughToApp, with moreFragments,
+// fragment and deviceIndex), 'chunk' (one notification of a batch, with
+// its sequence), 'message' (any other relay message, still encoded) or
+// 'raw' (not a relay message).
+class WasmDeframer {
+    static async load(url) {
+        const response = await fetch(url);
+        if (!response.ok) {
+            throw new Error(`${url}: ${response.status}`);
+        }
+        const { instance } = await WebAssembly.instantiate(await response.arrayBuffer(), {});
+        return new WasmDeframer(instance.exports);
+    }
+
+    constructor(exports) {
+        this.wasm = exports;
+        if (exports._initialize) {
+            exports._initialize();
+        }
+        this.input = exports.mouthpad_wasm_input();
+        this.inputSize = exports.mouthpad_wasm_input_size();
+        this.output = exports.mouthpad_wasm_output();
+        this.stats = exports.mouthpad_wasm_stats();
+        this.reset();
+    }
+
+    reset() {
+        this.wasm.mouthpad_wasm_reset();
+    }
+
+    push(data) {
+        const frames = [];
+
+        for (let pos = 0; pos < data.length; pos += this.inputSize) {
+            const piece = data.subarray(pos, pos + this.inputSize);
+            new Uint8Array(this.wasm.memory.buffer, this.input, piece.length).set(piece);
+
+            const written = this.wasm.mouthpad_wasm_feed(piece.length);
+            const view = new DataView(this.wasm.memory.buffer, this.output, written);
+
+            for (let at = 0; at < written;) {
+                const len = view.getUint16(at + 2, true);
+                const start = this.output + at + WASM_RECORD_HEADER;
+                const frame = {
+                    kind: WASM_RECORD_KINDS[view.getUint8(at)],
+                    payload: this.wasm.memory.buffer.slice(start, start + len)
+                };
+
+                if (frame.kind === 'pass-through') {
+                    frame.moreFragments = (view.getUint8(at + 1) & 1) !== 0;
+                    frame.fragment = view.getUint32(at + 4, true);
+                    frame.deviceIndex = view.getUint32(at + 8, true);
+                } else if (frame.kind === 'chunk') {
+                    frame.sequence = view.getUint32(at + 4, true);
+                }
+                frames.push(frame);
+                at += WASM_RECORD_HEADER + len;
+            }
+        }
+        return { frames, partial: this.wasm.mouthpad_wasm_pending() };
+    }
+
+    takeErrors() {
+        const stats = new Uint32Array(this.wasm.memory.buffer, this.stats, 4);
+        const errors = { crc: stats[0], length: stats[1], decode: stats[2], overflow: stats[3], discarded: 0 };
+        stats.fill(0);
+        return errors;
+    }
+}
+
+// Worker side: {type: 'data', buffer, generation} in, one 'frames' message
+// per chunk out with the payload buffers transferred. Messages wait for the
+// WebAssembly module to load or fail before any is handled.
+if (typeof WorkerGlobalScope !== 'undefined' && self instanceof WorkerGlobalScope) {
+    let deframer = new MouthpadDeframer();
+    const ready = WasmDeframer.load('mouthpad_core.wasm').then((wasm) => {
+        deframer = wasm;
+        self.postMessage({ type: 'deframer', name: 'WebAssembly' });
+    }, () => {});
+
+    self.onmessage = (event) => ready.then(() => {
+        const msg = event.data;
+
+        if (msg.type === 'reset') {
+            deframer.reset();
+            return;
+        }
+        if (msg.type === 'data') {
+            const result = deframer.push(new Uint8Array(msg.buffer));
+            self.postMessage({
+                type: 'frames',
+                generation: msg.generation,
+                frames: result.frames,
+                partial: result.partial,
+                errors: deframer.takeErrors()
+            }, result.frames.map(f => f.payload));
+        }
+    });
+}
@@ -1,18 +1,712 @@
+// CRC16_TABLE and MouthpadDeframer come from deframer.js
+
+// RelayCapabilitiesResponse.features bits (RelayFeature)
+const RELAY_FEATURE = {
+    PASS_THROUGH_BATCH: 1 << 0,
+    PASS_THROUGH_CREDITS: 1 << 1,
+    PASS_THROUGH_FRAGMENTS: 1 << 2,
+    LINK_TELEMETRY: 1 << 3,
+    STATUS_PUSH: 1 << 4,
+    SECONDARY_MOUTHPADS: 1 << 5,
+    RELAY_STATS: 1 << 6,
+    CONNECTION_TIMING: 1 << 7,
+    HID_LATENCY: 1 << 8,
+    ECHO: 1 << 9,
+    HID_MIRROR: 1 << 10,
+    THREAD_STATS: 1 << 11,
+    TRACE: 1 << 12,
+    MEM_STATS: 1 << 13,
+    FW_UPDATE: 1 << 14,
+    NUS_STREAM: 1 << 15,
+    SENSOR_STREAM_FILTER: 1 << 16,
+    SENSOR_CODEC: 1 << 17,
+    SENSOR_STREAM_RATE: 1 << 18,
+    REQUEST_ID: 1 << 19,
+    COBS_FRAMING: 1 << 20,
+    TUNING_PROFILE: 1 << 21,
+    PASS_THROUGH_ACK_MODES: 1 << 22,
+    SCAN_BOOST: 1 << 23,
+    USB_COMPOSITION: 1 << 24,
+    RAW_CHANNELS: 1 << 25,
+    LINK_HISTORY: 1 << 26,
+};
+
+// Channel header on a frame payload (common/mouthpad_frame.h):
+// [0x00][channel][device_index][data...]
+const CHANNEL_CONTROL = 0;
+const CHANNEL_NUS = 1;
+
+// RequestError.code names, by value
+const REQUEST_ERROR_CODES = ['unspecified', 'busy', 'unsupported', 'failed'];
+
+// How long sendRelayRequest() waits for a reply to a request with an id
+const RELAY_REQUEST_TIMEOUT_MS = 2000;
+
+// MouthPad streams as the relay classifies them (SensorStream); bit
+// (1 << value) in setStreamFilter(), and the stream setStreamRate() thins
+const SENSOR_STREAM = {
+    OTHER: 0,
+    SENSOR: 1,
+    POWER: 2,
+};
+
+// Firmware without RelayCapabilitiesRead never answers it
+const RELAY_CAPABILITIES_TIMEOUT_MS = 1000;
+
+// An EchoRequest not answered within this is counted as lost
+const ECHO_TIMEOUT_MS = 500;
+
+// Relay USB IDs, and the class of its WebUSB interface (vendor specific)
+const MOUTHPAD_USB_VENDOR_ID = 0x1915;
+const MOUTHPAD_USB_PRODUCT_ID = 0xEEEE;
+const WEBUSB_INTERFACE_CLASS = 0xFF;
+
+// mouthpad_daemon --ws (libmouthpad/include/mouthpad/ws_gateway.hpp);
+// ?gateway=ws://host:port picks another
+const MOUTHPAD_GATEWAY_URL = new URLSearchParams(location.search).get('gateway') || 'ws://127.0.0.1:8765';
+
+// Record kinds in the gateway's binary messages
+const GATEWAY_RECORD = {
+    PASS_THROUGH: 0,
+    MESSAGE: 1,
+    CLOSED: 2,
+    LOST: 3,
+};
+
+// Log rows kept; the oldest is overwritten by each new one
+const LOG_CAPACITY = 5000;
+
+// Height of one log row in px; must match .log-row in styles.css
+const LOG_ROW_HEIGHT = 18;
+
+// Rows rendered beyond each edge of the visible ones
+const LOG_OVERSCAN = 10;
+
+// Circular log shown through a virtualized viewport. Entries are kept as
+// given, a message or the received bytes, and are only formatted when
+// their row scrolls into view; the DOM holds just the visible rows and is
+// updated at most once per animation frame however fast entries arrive.
+class LogView {
+    constructor(container) {
+        this.container = container;
+        this.entries = new Array(LOG_CAPACITY);
+        this.first = 0; // Index of the oldest entry in entries
+        this.count = 0;
+        this.overwritten = 0; // Entries dropped off the top since the last render
+        this.followTail = true; // Scrolled to the bottom: keep showing new rows
+        this.renderPending = false;
+        this.rowPool = [];
+
+        container.textContent = '';
+        this.spacer = document.createElement('div');
+        this.spacer.className = 'log-spacer';
+        this.rows = document.createElement('div');
+        this.rows.className = 'log-rows';
+        this.spacer.appendChild(this.rows);
+        container.appendChild(this.spacer);
+
+        container.addEventListener('scroll', () => {
+            this.followTail = container.scrollTop + container.clientHeight >=
+                container.scrollHeight - LOG_ROW_HEIGHT;
+            this.scheduleRender();
+        });
+    }
+
+    // entry: { time, type, message } or { time, type: 'raw', bytes }
+    push(entry) {
+        this.entries[(this.first + this.count) % LOG_CAPACITY] = entry;
+        if (this.count < LOG_CAPACITY) {
+            this.count++;
+        } else {
+            this.first = (this.first + 1) % LOG_CAPACITY;
+            this.overwritten++;
+        }
+        this.scheduleRender();
+    }
+
+    clear() {
+        this.entries.fill(undefined);
+        this.first = 0;
+        this.count = 0;
+        this.overwritten = 0;
+        this.followTail = true;
+        this.scheduleRender();
+    }
+
+    entry(i) {
+        return this.entries[(this.first + i) % LOG_CAPACITY];
+    }
+
+    scheduleRender() {
+        if (!this.renderPending) {
+            this.renderPending = true;
+            requestAnimationFrame(() => this.render());
+        }
+    }
+
+    render() {
+        const container = this.container;
+
+        this.renderPending = false;
+        this.spacer.style.height = `${this.count * LOG_ROW_HEIGHT}px`;
+        if (this.followTail) {
+            container.scrollTop = container.scrollHeight;
+        } else if (this.overwritten) {
+            // Keep the rows being read in place as older ones drop off
+            container.scrollTop -= this.overwritten * LOG_ROW_HEIGHT;
+        }
+        this.overwritten = 0;
+
+        const top = Math.max(0, Math.floor(container.scrollTop / LOG_ROW_HEIGHT) - LOG_OVERSCAN);
+        const bottom = Math.min(this.count,
+            Math.ceil((container.scrollTop + container.clientHeight) / LOG_ROW_HEIGHT) + LOG_OVERSCAN);
+
+        this.rows.style.transform = `translateY(${top * LOG_ROW_HEIGHT}px)`;
+        while (this.rowPool.length < bottom - top) {
+            const row = document.createElement('div');
+            row.appendChild(document.createElement('span')).className = 'timestamp';
+            row.appendChild(document.createTextNode(' '));
+            row.appendChild(document.createElement('span'));
+            this.rows.appendChild(row);
+            this.rowPool.push(row);
+        }
+
+        this.rowPool.forEach((row, k) => {
+            const entry = top + k < bottom ? this.entry(top + k) : null;
+            if (row.entry === entry) return;
+            row.entry = entry;
+            row.hidden = !entry;
+            if (!entry) return;
+            const raw = entry.type === 'raw';
+            row.className = raw ? 'log-entry log-row raw' : `log-entry log-row log-${entry.type}`;
+            row.firstChild.textContent = LogView.timestamp(entry);
+            row.lastChild.className = raw ? 'hex-data' : '';
+            row.lastChild.textContent = LogView.text(entry);
+        });
+    }
+
+    static timestamp(entry) {
+        return `[${new Date(entry.time).toLocaleTimeString()}]`;
+    }
+
+    // Hex is only produced here, for rows in view and for exports
+    static text(entry) {
+        if (entry.type !== 'raw') return entry.message;
+        const bytes = entry.bytes;
+        const sizeIndicator = bytes.length > 64 ? '📦' : bytes.length > 32 ? '📄' : '📝';
+        let hex = '';
+        for (let i = 0; i < bytes.length; i++) {
+            hex += (i ? ' ' : '') + (bytes[i] < 16 ? '0' : '') + bytes[i].toString(16);
+        }
+        return `${sizeIndicator} ${hex}`;
+    }
+
+    toText() {
+        const lines = [];
+        for (let i = 0; i < this.count; i++) {
+            const entry = this.entry(i);
+            lines.push(`${LogView.timestamp(entry)} ${LogView.text(entry)}`);
+        }
+        return lines.join('\n');
+    }
+}
+
+// Sensor payload: the 134 bytes after the 4-byte header of a 138-byte packet
+const SENSOR_PAYLOAD_LEN = 134;
+const SENSOR_CAP_OFFSET = 20; // 44 little-endian uint16 capacitance cells
+const SENSOR_CAP_CELLS = 44;
+const SENSOR_PRESSURE_OFFSET = 108; // Float32 reading, thresholds at +17 and +21
+
+// Pressure samples kept for the scrolling plot
+const SENSOR_HISTORY = 256;
+
+// Cells of the 6x8 grid with no electrode, counted before the grid is
+// flipped for display, as processCapacitiveData() lays them out
+const SENSOR_EMPTY_CELLS = [0, 7, 40, 47];
+
+// Live capacitive heatmap and pressure plot. Each sensor packet is decoded
+// with a DataView straight into preallocated typed arrays; the canvases are
+// redrawn at most once per animation frame from the latest packet, and
+// packets arriving in between only add their pressure to the plot history.
+class SensorView {
+    constructor(heatmapCanvas, plotCanvas) {
+        this.heatmap = heatmapCanvas.getContext('2d');
+        this.plot = plotCanvas.getContext('2d');
+        this.cells = new Uint16Array(SENSOR_CAP_CELLS);
+        this.pressure = new Float32Array(SENSOR_HISTORY);
+        this.upper = new Float32Array(SENSOR_HISTORY);
+        this.lower = new Float32Array(SENSOR_HISTORY);
+        this.samples = 0; // Pressure samples written, oldest overwritten first
+        this.renderPending = false;
+        this.cellBackground = getComputedStyle(heatmapCanvas).getPropertyValue('--grid-cell-bg').trim() || '#2a2a2a';
+
+        // Sensor index shown in each of the 48 display cells, -1 for none
+        this.cellSource = new Int8Array(48).fill(-1);
+        for (let i = 0, sensor = 0; i < 48; i++) {
+            if (!SENSOR_EMPTY_CELLS.includes(i)) {
+                this.cellSource[47 - i] = sensor++;
+            }
+        }
+
+        this.render();
+    }
+
+    // packet: Uint8Array holding the 4-byte header and the sensor payload
+    update(packet) {
+        if (packet.length < 4 + SENSOR_PAYLOAD_LEN) return;
+
+        const view = new DataView(packet.buffer, packet.byteOffset + 4, SENSOR_PAYLOAD_LEN);
+
+        for (let i = 0; i < SENSOR_CAP_CELLS; i++) {
+            this.cells[i] = view.getUint16(SENSOR_CAP_OFFSET + 2 * i, true);
+        }
+
+        // Same byte order guess as processPressureData(): big-endian unless
+        // that gives implausible values
+        let littleEndian = false;
+        for (let attempt = 0; attempt < 2; attempt++) {
+            const p = view.getFloat32(SENSOR_PRESSURE_OFFSET, littleEndian);
+            const u = view.getFloat32(SENSOR_PRESSURE_OFFSET + 17, littleEndian);
+            const l = view.getFloat32(SENSOR_PRESSURE_OFFSET + 21, littleEndian);
+            if (SensorView.plausible(p) && SensorView.plausible(u) && SensorView.plausible(l)) {
+                const slot = this.samples % SENSOR_HISTORY;
+                this.pressure[slot] = p;
+                this.upper[slot] = u;
+                this.lower[slot] = l;
+                this.samples++;
+                break;
+            }
+            littleEndian = true;
+        }
+
+        if (!this.renderPending) {
+            this.renderPending = true;
+            requestAnimationFrame(() => this.render());
+        }
+    }
+
+    static plausible(value) {
+        return Number.isFinite(value) && value >= 0 && value < 1000;
+    }
+
+    render() {
+        this.renderPending = false;
+        this.drawHeatmap();
+        this.drawPlot();
+    }
+
+    drawHeatmap() {
+        const ctx = this.heatmap;
+        const w = ctx.canvas.width / 8;
+        const h = ctx.canvas.height / 6;
+
+        ctx.fillStyle = this.cellBackground;
+        ctx.fillRect(0, 0, ctx.canvas.width, ctx.canvas.height);
+        ctx.font = '12px sans-serif';
+        ctx.textAlign = 'center';
+        ctx.textBaseline = 'middle';
+
+        for (let d = 0; d < 48; d++) {
+            const source = this.cellSource[d];
+            if (source < 0) continue;
+
+            // Values past 10000 are read beyond the data; shown as 0
+            let value = this.cells[source];
+            if (value > 10000) value = 0;
+
+            // Transparent to gold (#dca32f) over 0..1000, as the DOM grid was
+            const intensity = Math.min(1, value / 1000);
+            const x = (d % 8) * w;
+            const y = Math.floor(d / 8) * h;
+
+            ctx.fillStyle = `rgba(${Math.round(220 * intensity)}, ${Math.round(163 * intensity)}, ${Math.round(47 * intensity)}, ${intensity})`;
+            ctx.fillRect(x + 1, y + 1, w - 2, h - 2);
+            ctx.fillStyle = '#ffffff';
+            ctx.fillText(value, x + w / 2, y + h / 2);
+        }
+    }
+
+    drawPlot() {
+        const ctx = this.plot;
+        const width = ctx.canvas.width;
+        const height = ctx.canvas.height;
+        const n = Math.min(this.samples, SENSOR_HISTORY);
+
+        ctx.fillStyle = '#f8f9fa';
+        ctx.fillRect(0, 0, width, height);
+        ctx.strokeStyle = '#e9ecef';
+        ctx.lineWidth = 1;
+        ctx.beginPath();
+        for (let i = 0; i <= 10; i++) {
+            ctx.moveTo((width / 10) * i, 0);
+            ctx.lineTo((width / 10) * i, height);
+        }
+        for (let i = 0; i <= 5; i++) {
+            ctx.moveTo(0, (height / 5) * i);
+            ctx.lineTo(width, (height / 5) * i);
+        }
+        ctx.stroke();
+        if (n < 2) return;
+
+        // Scale to the samples on screen, thresholds included
+        let min = Infinity;
+        let max = -Infinity;
+        for (let i = 0; i < n; i++) {
+            min = Math.min(min, this.pressure[i], this.upper[i], this.lower[i]);
+            max = Math.max(max, this.pressure[i], this.upper[i], this.lower[i]);
+        }
+        const range = max - min || 1;
+
+        this.drawTrace(this.lower, n, min, range, '#adb5bd', 1);
+        this.drawTrace(this.upper, n, min, range, '#adb5bd', 1);
+        this.drawTrace(this.pressure, n, min, range, '#007bff', 2);
+    }
+
+    // Newest sample at the right edge
+    drawTrace(values, n, min, range, color, lineWidth) {
+        const ctx = this.plot;
+        const width = ctx.canvas.width;
+        const height = ctx.canvas.height;
+        const first = this.samples - n;
+
+        ctx.strokeStyle = color;
+        ctx.lineWidth = lineWidth;
+        ctx.beginPath();
+        for (let i = 0; i < n; i++) {
+            const x = width - ((n - 1 - i) / (SENSOR_HISTORY - 1)) * width;
+            const y = height - ((values[(first + i) % SENSOR_HISTORY] - min) / range) * height;
+            if (i === 0) {
+                ctx.moveTo(x, y);
+            } else {
+                ctx.lineTo(x, y);
+            }
+        }
+        ctx.stroke();
+    }
+}
+
+// Dashboard samples kept per series, one per DASHBOARD_POLL_MS
+const DASHBOARD_HISTORY = 300;
+
+// How often the dashboard takes a sample and polls the relay's counters
+const DASHBOARD_POLL_MS = 1000;
+
+// Samples kept for the JSON export, about ten hours
+const DASHBOARD_EXPORT_SAMPLES = 36000;
+
+// A session capture stops growing past this
+const CAPTURE_MAX_BYTES = 32 * 1024 * 1024;
+
+// Dashboard sparklines, keyed into each sample
+const DASHBOARD_SERIES = [
+    { key: 'rssi', label: 'RSSI', unit: 'dBm' },
+    { key: 'intervalMs', label: 'Conn interval', unit: 'ms' },
+    { key: 'hidRate', label: 'HID reports', unit: '/s' },
+    { key: 'usbRttMs', label: 'USB round trip', unit: 'ms' },
+    { key: 'hidP50Ms', label: 'HID latency p50', unit: 'ms' },
+    { key: 'hidP99Ms', label: 'HID latency p99', unit: 'ms' },
+    { key: 'hidDropped', label: 'HID drops', unit: '/s' },
+    { key: 'nusRxDropped', label: 'NUS rx drops', unit: '/s' },
+    { key: 'nusLossPct', label: 'NUS sequence loss', unit: '%' },
+    { key: 'nusTxDropped', label: 'NUS tx drops', unit: '/s' },
+    { key: 'nusTxQueued', label: 'NUS tx queue', unit: '' },
+    { key: 'cdcTxQueued', label: 'CDC tx queue', unit: 'B' },
+    { key: 'stalls', label: 'Stalls', unit: '/s' },
+    { key: 'usbWaitMs', label: 'USB poll wait', unit: 'ms' },
+];
+
+// Rebuilds MouthPad sensor frames from SensorFrameDelta, as
+// sensor_codec_decode() in common/sensor_codec.c does. A delta is a list of
+// varint tokens over the frame's little-endian 16-bit words: an even token
+// skips token / 2 unchanged words, an odd one adds the zig-zag value
+// token >> 1 to the next word. After a sequence gap, deltas are dropped
+// until the next keyframe.
+class SensorCodecDecoder {
+    constructor() {
+        this.reset();
+    }
+
+    reset() {
+        this.frame = null; // Last frame decoded; null until a keyframe
+        this.sequence = 0;
+        this.skipped = 0;
+        this.errors = 0;
+    }
+
+    // Returns a copy of the decoded frame, or null if there is none yet
+    decode(sequence, keyframe, data) {
+        if (keyframe) {
+            this.frame = data.length ? data.slice() : null;
+            this.sequence = sequence;
+            if (!this.frame) this.errors++;
+            return this.frame && this.frame.slice();
+        }
+        if (!this.frame || sequence !== ((this.sequence + 1) >>> 0)) {
+            this.frame = null;
+            this.skipped++;
+            return null;
+        }
+        if (!this.apply(data)) {
+            this.frame = null;
+            this.errors++;
+            return null;
+        }
+        this.sequence = sequence;
+        return this.frame.slice();
+    }
+
+    apply(data) {
+        const frame = this.frame;
+        const words = (frame.length + 1) >> 1;
+        let i = 0;
+        let pos = 0;
+
+        while (pos < data.length) {
+            let token = 0;
+            let shift = 0;
+            let byte;
+            do {
+                if (pos >= data.length || shift > 14) return false;
+                byte = data[pos++];
+                token |= (byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+
+            if (!(token & 1)) {
+                i += token >>> 1;
+                if (i > words) return false;
+                continue;
+            }
+            const zigzag = token >>> 1;
+            if (i >= words || zigzag > 0xFFFF) return false;
+
+            const hasHigh = 2 * i + 1 < frame.length;
+            const word = ((frame[2 * i] | (hasHigh ? frame[2 * i + 1] << 8 : 0)) +
+                          ((zigzag >>> 1) ^ -(zigzag & 1))) & 0xFFFF;
+            frame[2 * i] = word & 0xFF;
+            if (hasHigh) frame[2 * i + 1] = word >> 8;
+            i++;
+        }
+        return true;
+    }
+}
+
+// Relay traffic recorded in the session capture format of
+// common/mouthpad_capture.h, for mouthpad_replay and relay_bench
+class SessionCapture {
+    constructor() {
+        this.startMs = performance.now();
+        this.lastUs = 0;
+        this.chunks = [];
+        this.bytes = 0;
+        this.full = false;
+
+        // "MPCAP\0" version(1) flags(1) start_us(8)
+        const header = new DataView(new ArrayBuffer(16));
+        [0x4D, 0x50, 0x43, 0x41, 0x50, 0x00, 1, 0].forEach((b, i) => header.setUint8(i, b));
+        header.setBigUint64(8, BigInt(Date.now()) * 1000n, true);
+        this.chunks.push(header.buffer);
+    }
+
+    // channel: 0 CONTROL, 1 NUS, 2 HID; toDevice for host->relay traffic
+    put(channel, toDevice, data) {
+        if (this.full) return;
+        if (this.bytes + data.length > CAPTURE_MAX_BYTES) {
+            this.full = true;
+            return;
+        }
+
+        const nowUs = Math.max(this.lastUs, Math.round((performance.now() - this.startMs) * 1000));
+        let delta = nowUs - this.lastUs;
+        this.lastUs = nowUs;
+
+        // Gaps beyond a u32 are bridged with empty CLOCK records
+        while (delta > 0xFFFFFFFF) {
+            this.putRecord(0xFFFFFFFF, 3, new Uint8Array(0));
+            delta -= 0xFFFFFFFF;
+        }
+        this.putRecord(delta, channel | (toDevice ? 0x80 : 0), data);
+    }
+
+    putRecord(delta, type, data) {
+        const record = new Uint8Array(8 + data.length);
+        const view = new DataView(record.buffer);
+        view.setUint32(0, delta, true);
+        view.setUint8(4, type);
+        view.setUint16(6, data.length, true);
+        record.set(data, 8);
+        this.chunks.push(record);
+        this.bytes += record.length;
+    }
+
+    toBlob() {
+        return new Blob(this.chunks, { type: 'application/octet-stream' });
+    }
+}
+
+// Live view of the relay's health: one canvas sparkline per series in
+// DASHBOARD_SERIES plus a few lines of text. Samples go into fixed
+// Float64Array rings; drawing waits for the next animation frame and is
+// skipped while the panel is hidden.
+class Dashboard {
+    constructor(panel, sparkContainer, textContainer) {
+        this.panel = panel;
+        this.text = textContainer;
+        this.samples = []; // Every sample, for the JSON export
+        this.count = 0;
+        this.renderPending = false;
+        this.series = DASHBOARD_SERIES.map(spec => {
+            const cell = document.createElement('div');
+            const label = document.createElement('div');
+            const value = document.createElement('span');
+            const canvas = document.createElement('canvas');
+
+            cell.className = 'spark';
+            label.className = 'spark-label';
+            label.textContent = `${spec.label} `;
+            label.appendChild(value);
+            canvas.width = 160;
+            canvas.height = 32;
+            cell.appendChild(label);
+            cell.appendChild(canvas);
+            sparkContainer.appendChild(cell);
+            return { ...spec, value, ctx: canvas.getContext('2d'), data: new Float64Array(DASHBOARD_HISTORY) };
+        });
+        this.lines = {};
+    }
+
+    reset() {
+        this.samples = [];
+        this.count = 0;
+        this.lines = {};
+        this.text.textContent = '';
+        this.scheduleRender();
+    }
+
+    // sample: { time, ...values keyed as DASHBOARD_SERIES }; absent values leave a gap
+    push(sample) {
+        const slot = this.count % DASHBOARD_HISTORY;
+        for (const series of this.series) {
+            const value = sample[series.key];
+            series.data[slot] = value === undefined ? NaN : value;
+        }
+        this.count++;
+        if (this.samples.length >= DASHBOARD_EXPORT_SAMPLES) {
+            this.samples.shift();
+        }
+        this.samples.push(sample);
+        this.scheduleRender();
+    }
+
+    // One line of text per key, replaced on each call
+    setLine(key, text) {
+        let line = this.lines[key];
+        if (!line) {
+            line = this.lines[key] = document.createElement('div');
+            this.text.appendChild(line);
+        }
+        line.textContent = text;
+    }
+
+    scheduleRender() {
+        if (!this.renderPending && !this.panel.hidden) {
+            this.renderPending = true;
+            requestAnimationFrame(() => this.render());
+        }
+    }
+
+    render() {
+        this.renderPending = false;
+        const n = Math.min(this.count, DASHBOARD_HISTORY);
+        const first = this.count - n;
+
+        for (const series of this.series) {
+            const ctx = series.ctx;
+            const width = ctx.canvas.width;
+            const height = ctx.canvas.height;
+            let min = Infinity;
+            let max = -Infinity;
+
+            for (let i = 0; i < n; i++) {
+                const v = series.data[(first + i) % DASHBOARD_HISTORY];
+                if (!Number.isNaN(v)) {
+                    min = Math.min(min, v);
+                    max = Math.max(max, v);
+                }
+            }
+            const latest = n ? series.data[(this.count - 1) % DASHBOARD_HISTORY] : NaN;
+            series.value.textContent = Number.isNaN(latest) ? '-' :
+                `${Number.isInteger(latest) ? latest : latest.toFixed(2)} ${series.unit} (${min === Infinity ? '-' : `${+min.toFixed(2)}..${+max.toFixed(2)}`})`;
+
+            ctx.clearRect(0, 0, width, height);
+            if (min === Infinity) continue;
+            const range = max - min || 1;
+
+            // Newest sample at the right edge; a missing one breaks the line
+            ctx.strokeStyle = '#4a9eff';
+            ctx.lineWidth = 1.5;
+            ctx.beginPath();
+            let drawing = false;
+            for (let i = 0; i < n; i++) {
+                const v = series.data[(first + i) % DASHBOARD_HISTORY];
+                if (Number.isNaN(v)) {
+                    drawing = false;
+                    continue;
+                }
+                const x = width - ((n - 1 - i) / (DASHBOARD_HISTORY - 1)) * width;
+                const y = height - 2 - ((v - min) / range) * (height - 4);
+                if (drawing) {
+                    ctx.lineTo(x, y);
+                } else {
+                    ctx.moveTo(x, y);
+                    drawing = true;
+                }
+            }
+            ctx.stroke();
+        }
+    }
+}
+
 class MouthPadController {
     constructor() {
         this.port = null;
         this.reader = null;
         this.writer = null;
+        this.usbDevice = null; // Set instead of port when connected over WebUSB
+        this.usbInterface = null;
+        this.usbEndpointIn = null;
+        this.socket = null; // Set instead of port when connected through the gateway
         this.isConnected = false;
         this.gridData = new Array(48).fill(0); // 8x6 grid
-        this.dataBuffer = []; // Buffer for handling USB CDC fragmentation
+        this.deframer = null; // Worker running deframer.js, or a MouthpadDeframer here
+        this.deframerGeneration = 0; // Frames from before the last reset are dropped
         this.lastPacketTime = null; // Track when we last received data
         this.packetFragmentationCount = 0; // Track packet fragmentation
         this.lastFragmentationTime = null; // Track when fragmentation occurred
+        this.passThroughSequence = null; // Next expected batched pass-through chunk
+        this.sensorCodec = new SensorCodecDecoder(); // Sensor frames sent as SensorFrameDelta
+        this.passThroughFragments = null; // Fragments of a notification being reassembled
+        this.relayCapabilities = null; // Last RelayCapabilitiesResponse, null until answered
+        this.capabilitiesTimer = null;
+        this.echoWaiter = null; // Resolves the outstanding EchoRequest
+        this.pendingRequests = new Map(); // request_id -> {what, resolve} for sendRelayRequest()
+        this.nextRequestId = 0;
+        this.dashboardTimer = null; // Samples and polls while the dashboard is open
+        this.dashboardSample = {}; // Latest value of each dashboard series
+        this.dashboardReports = {}; // Latest HID latency, relay stats and connection timing
+        this.lastTelemetry = null; // Previous LinkTelemetry, for drop rates
+        this.capture = null; // SessionCapture recording since the dashboard opened
+        this.hidMirror = null; // Mirrored HID reports while the mirror is on
+        this.fwUpdate = null; // Image being streamed by updateFirmware()
+        this.nusStream = null; // Data being streamed by streamToMouthpad()
         
         // Log view mode (raw vs details)
         this.logViewMode = 'details'; // 'details' or 'raw'
         
+        // Per-packet sensor analysis in the log; set from the console, it is
+        // too slow to keep up with a JCP stream
+        this.sensorDebug = false;
+        
         // Pressure data storage for charting (like Mac app)
         this.pressureHistory = [];
         this.maxPressureHistoryLength = 100; // Keep last 100 readings
@@ -51,24 +745,35 @@ class MouthPadController {
         this.lastFlagsBits = null;
         
         this.initializeElements();
+        this.startDeframer();
         this.bindEvents();
-        this.createGrid();
-        this.initializePressureChart();
+        this.sensorView = new SensorView(this.touchpadCanvas, this.pressureChart);
         this.updateConnectionStatus('disconnected');
     }
 
     initializeElements() {
         this.connectBtn = document.getElementById('connectBtn');
+        this.connectUsbBtn = document.getElementById('connectUsbBtn');
+        this.connectGatewayBtn = document.getElementById('connectGatewayBtn');
         this.disconnectBtn = document.getElementById('disconnectBtn');
         this.statusIndicator = document.getElementById('statusIndicator');
         this.statusText = document.getElementById('statusText');
         this.terminal = document.getElementById('terminal');
+        this.logView = new LogView(this.terminal);
+        this.logView.push({ time: Date.now(), type: 'info', message: 'MouthPad Controller Ready...' });
         this.customCommand = document.getElementById('customCommand');
         this.sendCustomBtn = document.getElementById('sendCustomBtn');
         this.clearLogBtn = document.getElementById('clearLogBtn');
         this.exportLogBtn = document.getElementById('exportLogBtn');
         this.logViewToggleBtn = document.getElementById('logViewToggleBtn');
-        this.touchpadGrid = document.getElementById('touchpadGrid');
+        this.dashboardBtn = document.getElementById('dashboardBtn');
+        this.dashboardPanel = document.getElementById('dashboard');
+        this.exportSessionBtn = document.getElementById('exportSessionBtn');
+        this.exportCaptureBtn = document.getElementById('exportCaptureBtn');
+        this.dashboard = new Dashboard(this.dashboardPanel, document.getElementById('dashboardSparks'),
+                                       document.getElementById('dashboardText'));
+        this.echoTestBtn = document.getElementById('echoTestBtn');
+        this.touchpadCanvas = document.getElementById('touchpadCanvas');
         this.minPressure = document.getElementById('minPressure');
         this.maxPressure = document.getElementById('maxPressure');
         this.activeCells = document.getElementById('activeCells');
@@ -81,12 +786,32 @@ class MouthPadController {
     }
 
     bindEvents() {
-        this.connectBtn.addEventListener('click', () => this.connect());
+        if (navigator.serial) {
+            this.connectBtn.addEventListener('click', () => this.connect());
+        } else {
+            this.connectBtn.style.display = 'none';
+        }
+        this.connectGatewayBtn.addEventListener('click', () => this.connectGateway());
+        if (navigator.usb) {
+            this.connectUsbBtn.addEventListener('click', () => this.connectWebUsb());
+            navigator.usb.addEventListener('disconnect', (event) => {
+                if (event.device === this.usbDevice) {
+                    this.log('WebUSB device unplugged', 'warn');
+                    this.disconnect();
+                }
+            });
+        } else {
+            this.connectUsbBtn.style.display = 'none';
+        }
         this.disconnectBtn.addEventListener('click', () => this.disconnect());
         this.sendCustomBtn.addEventListener('click', () => this.sendCustomCommand());
         this.clearLogBtn.addEventListener('click', () => this.clearLog());
         this.exportLogBtn.addEventListener('click', () => this.exportLog());
         this.logViewToggleBtn.addEventListener('click', () => this.toggleLogView());
+        this.echoTestBtn.addEventListener('click', () => this.runEchoTest());
+        this.dashboardBtn.addEventListener('click', () => this.toggleDashboard());
+        this.exportSessionBtn.addEventListener('click', () => this.exportSession());
+        this.exportCaptureBtn.addEventListener('click', () => this.exportCapture());
         
         // Command buttons
         document.querySelectorAll('.btn-command').forEach(btn => {
@@ -105,6 +830,20 @@ class MouthPadController {
     }
 
     async connect() {
+        // A relay already granted over WebUSB is used without asking: it
+        // skips the OS serial driver and its buffering
+        if (navigator.usb) {
+            const devices = await navigator.usb.getDevices();
+            const device = devices.find((d) =>
+                d.vendorId === MOUTHPAD_USB_VENDOR_ID && d.productId === MOUTHPAD_USB_PRODUCT_ID);
+            if (device) {
+                await this.connectWebUsb(device);
+                if (this.isConnected) {
+                    return;
+                }
+            }
+        }
+
         try {
             this.updateConnectionStatus('connecting');
             this.log('Connecting to serial port...', 'info');
@@ -112,8 +851,8 @@ class MouthPadController {
             // Request serial port access with MouthPad USB filter
             this.port = await navigator.serial.requestPort({
                 filters: [{ 
-                    usbVendorId: 0x1915,  // Nordic Semiconductor
-                    usbProductId: 0xEEEE   // MouthPad
+                    usbVendorId: MOUTHPAD_USB_VENDOR_ID,  // Nordic Semiconductor
+                    usbProductId: MOUTHPAD_USB_PRODUCT_ID   // MouthPad
                 }]
             });
             await this.port.open({ baudRate: 115200 });
@@ -126,12 +865,185 @@ class MouthPadController {
             // Start reading data
             this.startReading();
 
+            // Fast paths are enabled once the relay lists them
+            this.requestCapabilities();
+
         } catch (error) {
             this.log(`Connection failed: ${error.message}`, 'error');
             this.updateConnectionStatus('disconnected');
         }
     }
 
+    // Open the relay's vendor bulk interface. Without a device, ask the user
+    // to pick one; only relays whose firmware has the interface are listed.
+    async connectWebUsb(device = null) {
+        try {
+            this.updateConnectionStatus('connecting');
+            this.log('Connecting over WebUSB...', 'info');
+
+            if (!device) {
+                device = await navigator.usb.requestDevice({
+                    filters: [{
+                        vendorId: MOUTHPAD_USB_VENDOR_ID,
+                        productId: MOUTHPAD_USB_PRODUCT_ID,
+                        classCode: WEBUSB_INTERFACE_CLASS
+                    }]
+                });
+            }
+
+            await device.open();
+            if (device.configuration === null) {
+                await device.selectConfiguration(1);
+            }
+
+            const iface = device.configuration.interfaces.find((i) =>
+                i.alternates[0].interfaceClass === WEBUSB_INTERFACE_CLASS);
+            if (!iface) {
+                await device.close();
+                throw new Error('firmware has no WebUSB interface');
+            }
+            await device.claimInterface(iface.interfaceNumber);
+
+            const endpoints = iface.alternates[0].endpoints;
+            const endpointOut = endpoints.find((e) => e.direction === 'out');
+
+            this.usbDevice = device;
+            this.usbInterface = iface.interfaceNumber;
+            this.usbEndpointIn = endpoints.find((e) => e.direction === 'in');
+
+            // Same interface as the Web Serial writer, so senders need not care
+            this.writer = {
+                write: (data) => device.transferOut(endpointOut.endpointNumber, data),
+                close: async () => {}
+            };
+            this.isConnected = true;
+            this.updateConnectionStatus('connected');
+            this.log('Connected to MouthPad USB over WebUSB!', 'success');
+
+            this.startUsbReading();
+
+            // Fast paths are enabled once the relay lists them
+            this.requestCapabilities();
+
+        } catch (error) {
+            this.log(`WebUSB connection failed: ${error.message}`, 'error');
+            this.usbDevice = null;
+            this.writer = null;
+            this.updateConnectionStatus('disconnected');
+        }
+    }
+
+    // Connect to mouthpad_daemon's WebSocket gateway, which owns the relay
+    // and shares it with native apps. Records arrive already deframed and
+    // batched; writes are the same CDC0 frames as over the port.
+    async connectGateway(url = MOUTHPAD_GATEWAY_URL) {
+        try {
+            this.updateConnectionStatus('connecting');
+            this.log(`Connecting to gateway ${url}...`, 'info');
+
+            const socket = new WebSocket(url);
+            socket.binaryType = 'arraybuffer';
+            await new Promise((resolve, reject) => {
+                socket.onopen = resolve;
+                socket.onerror = () => reject(new Error('gateway not reachable (is mouthpad_daemon --ws running?)'));
+            });
+
+            // This page drives one relay: the daemon's first
+            socket.send('devices 0');
+            socket.send('target 0');
+            socket.onmessage = (event) => this.handleGatewayMessage(event.data);
+            socket.onclose = () => {
+                if (this.socket === socket) {
+                    this.log('Gateway closed the connection', 'warn');
+                    this.disconnect();
+                }
+            };
+
+            this.socket = socket;
+            // Same interface as the Web Serial writer, so senders need not care
+            this.writer = {
+                write: async (data) => socket.send(data),
+                close: async () => {}
+            };
+            this.isConnected = true;
+            this.updateConnectionStatus('connected');
+            this.log('Connected to MouthPad USB through the gateway!', 'success');
+
+            // Fast paths are enabled once the relay lists them
+            this.requestCapabilities();
+
+        } catch (error) {
+            this.log(`Gateway connection failed: ${error.message}`, 'error');
+            this.socket = null;
+            this.writer = null;
+            this.updateConnectionStatus('disconnected');
+        }
+    }
+
+    // One gateway message: several records of [kind][device][device_index][0][len u16][payload]
+    handleGatewayMessage(data) {
+        if (typeof data === 'string') {
+            if (data !== 'ok') {
+                this.log(`Gateway: ${data}`, 'warn');
+            }
+            return;
+        }
+
+        const view = new DataView(data);
+        this.lastPacketTime = Date.now();
+        if (this.logViewMode === 'raw') {
+            this.logRaw(new Uint8Array(data));
+        }
+
+        for (let pos = 0; pos + 6 <= data.byteLength;) {
+            const kind = view.getUint8(pos);
+            const length = view.getUint16(pos + 4, true);
+            const payload = new Uint8Array(data, pos + 6, length);
+            pos += 6 + length;
+
+            switch (kind) {
+                case GATEWAY_RECORD.PASS_THROUGH:
+                    this.processPacket(payload);
+                    break;
+                case GATEWAY_RECORD.MESSAGE:
+                    this.processFrame(payload);
+                    break;
+                case GATEWAY_RECORD.CLOSED:
+                    this.log('Relay port closed on the gateway', 'warn');
+                    break;
+                case GATEWAY_RECORD.LOST:
+                    this.log(`*** ${new DataView(data, payload.byteOffset, 4).getUint32(0, true)} RECORD(S) DROPPED by the gateway, page fell behind ***`, 'warn');
+                    break;
+            }
+        }
+    }
+
+    // One packet per transfer: a transfer ending on a packet boundary is
+    // not followed by a zero-length packet, so a longer read could stall
+    async startUsbReading() {
+        const device = this.usbDevice;
+        const endpoint = this.usbEndpointIn;
+
+        try {
+            while (this.usbDevice === device) {
+                const result = await device.transferIn(endpoint.endpointNumber, endpoint.packetSize);
+                if (result.status === 'stall') {
+                    await device.clearHalt('in', endpoint.endpointNumber);
+                    continue;
+                }
+                if (result.data && result.data.byteLength > 0) {
+                    this.processReceivedData(new Uint8Array(result.data.buffer,
+                        result.data.byteOffset, result.data.byteLength));
+                }
+            }
+        } catch (error) {
+            // Closing the device fails the read in flight
+            if (this.usbDevice === device) {
+                this.log(`Reading error: ${error.message}`, 'error');
+            }
+        }
+    }
+
     async disconnect() {
         try {
             // Cancel any ongoing read operations
@@ -153,267 +1065,1374 @@ class MouthPadController {
                 }
                 this.writer = null;
             }
-            
-            // Close the serial port
-            if (this.port) {
-                try {
-                    await this.port.close();
-                    this.log('Serial port closed successfully', 'info');
-                } catch (error) {
-                    this.log(`Port close error: ${error.message}`, 'warn');
-                }
-                this.port = null;
+            
+            // Close the WebUSB device
+            if (this.usbDevice) {
+                const device = this.usbDevice;
+                this.usbDevice = null;
+                try {
+                    await device.releaseInterface(this.usbInterface);
+                    await device.close();
+                    this.log('WebUSB device closed successfully', 'info');
+                } catch (error) {
+                    this.log(`WebUSB close error: ${error.message}`, 'warn');
+                }
+            }
+
+            // Close the gateway connection
+            if (this.socket) {
+                const socket = this.socket;
+                this.socket = null;
+                socket.close();
+                this.log('Gateway connection closed', 'info');
+            }
+
+            // Close the serial port
+            if (this.port) {
+                try {
+                    await this.port.close();
+                    this.log('Serial port closed successfully', 'info');
+                } catch (error) {
+                    this.log(`Port close error: ${error.message}`, 'warn');
+                }
+                this.port = null;
+            }
+            
+            // Clear any remaining data
+            this.resetDeframer();
+            clearTimeout(this.capabilitiesTimer);
+            this.capabilitiesTimer = null;
+            this.relayCapabilities = null;
+            this.pendingRequests.forEach(pending => pending.resolve(null));
+            
+            // Reset connection state
+            this.isConnected = false;
+            this.updateConnectionStatus('disconnected');
+            this.log('Disconnected from serial port - port should now be available for other applications', 'success');
+            
+        } catch (error) {
+            this.log(`Disconnect error: ${error.message}`, 'error');
+            // Force cleanup even if there's an error
+            this.reader = null;
+            this.writer = null;
+            this.port = null;
+            this.usbDevice = null;
+            this.socket = null;
+            this.isConnected = false;
+            this.updateConnectionStatus('disconnected');
+        }
+    }
+
+    async startReading() {
+        try {
+            this.reader = this.port.readable.getReader();
+            
+            while (true) {
+                const { value, done } = await this.reader.read();
+                if (done) break;
+                
+                // Process received data
+                this.processReceivedData(value);
+            }
+        } catch (error) {
+            this.log(`Reading error: ${error.message}`, 'error');
+        }
+    }
+
+    // Deframing runs in a worker; pages opened from file:// cannot start
+    // one, so the same deframer then runs here
+    startDeframer() {
+        try {
+            this.deframer = new Worker('deframer.js');
+            this.deframer.onmessage = (event) => {
+                if (event.data.type === 'deframer') {
+                    this.log(`Deframing with ${event.data.name}`, 'info');
+                } else if (event.data.generation === this.deframerGeneration) {
+                    this.handleFrames(event.data);
+                }
+            };
+            this.deframer.onerror = (event) => {
+                this.log(`Deframer worker failed (${event.message || 'not loaded'}), deframing on the page`, 'warn');
+                this.deframer = new MouthpadDeframer();
+            };
+        } catch (error) {
+            this.log(`Deframer worker unavailable (${error.message}), deframing on the page`, 'warn');
+            this.deframer = new MouthpadDeframer();
+        }
+    }
+
+    resetDeframer() {
+        this.deframerGeneration++;
+        if (this.deframer instanceof MouthpadDeframer) {
+            this.deframer.reset();
+        } else if (this.deframer) {
+            this.deframer.postMessage({ type: 'reset' });
+        }
+    }
+
+    processReceivedData(data) {
+        // Log raw hex data if in raw mode
+        if (this.logViewMode === 'raw') {
+            this.logRaw(data);
+        } else {
+            this.log(`Received ${data.length} bytes of binary data`, 'data');
+        }
+        
+        // Update last packet time
+        this.lastPacketTime = Date.now();
+
+        if (this.deframer instanceof MouthpadDeframer) {
+            const result = this.deframer.push(data);
+            result.errors = this.deframer.takeErrors();
+            this.handleFrames(result);
+            return;
+        }
+
+        // Readers hand over a fresh buffer per chunk, so it can be
+        // transferred rather than copied when the view covers all of it
+        const whole = data.byteOffset === 0 && data.byteLength === data.buffer.byteLength;
+        const buffer = whole ? data.buffer : data.slice().buffer;
+        this.deframer.postMessage({ type: 'data', buffer, generation: this.deframerGeneration }, [buffer]);
+    }
+
+    // One received chunk's worth of frames from the deframer, in order
+    handleFrames(result) {
+        if (result.errors.crc) {
+            this.log(`*** ${result.errors.crc} FRAME(S) FAILED CRC OR END MARKER, dropped ***`, 'warn');
+        }
+        if (result.errors.length) {
+            this.log(`*** ${result.errors.length} INVALID FRAME LENGTH(S), start marker skipped ***`, 'warn');
+        }
+        if (result.errors.decode) {
+            this.log(`*** ${result.errors.decode} MALFORMED PASS-THROUGH BATCH(ES) OR UNKNOWN CHANNEL FRAME(S) ***`, 'warn');
+        }
+        if (result.errors.overflow) {
+            this.log(`*** ${result.errors.overflow} DEFRAMED RECORD(S) DROPPED, output full ***`, 'warn');
+        }
+
+        if (result.frames.length > 0 && this.packetFragmentationCount > 0) {
+            this.log(`*** PACKET RECOVERY: frame completed after ${this.packetFragmentationCount} fragmented chunk(s) ***`, 'info');
+            this.packetFragmentationCount = 0;
+        }
+        if (result.partial > 0) {
+            this.packetFragmentationCount++;
+            this.lastFragmentationTime = Date.now();
+        }
+
+        for (const frame of result.frames) {
+            const payload = new Uint8Array(frame.payload);
+
+            // Frames from the WebAssembly deframer arrive already decoded
+            switch (frame.kind) {
+                case 'pass-through':
+                    this.passThroughPackets(payload, frame.moreFragments, frame.fragment, frame.deviceIndex)
+                        .forEach(packet => this.processPacket(packet));
+                    break;
+                case 'chunk':
+                    this.processPacket(this.batchChunk(frame.sequence, payload));
+                    break;
+                case 'message':
+                    this.processFrame(payload);
+                    break;
+                case 'raw':
+                    this.processPacket(payload);
+                    break;
+                default:
+                    if (frame.oldFormat) {
+                        this.processPacket(payload);
+                    } else {
+                        this.processFrame(payload);
+                    }
+            }
+        }
+    }
+    
+    // Relay firmware wraps MouthPad data in a RelayToAppMessage, or puts it
+    // on the NUS channel once the page writes channel frames; older
+    // firmware framed the raw MouthPad packet, which is passed on unchanged
+    processFrame(payload) {
+        // No protobuf message starts with 0x00
+        if (payload.length >= 3 && payload[0] === 0x00) {
+            const data = payload.subarray(3);
+            if (payload[1] === CHANNEL_NUS) {
+                this.passThroughPackets(data, false, 0, payload[2]).forEach(packet => this.processPacket(packet));
+            } else if (payload[1] === CHANNEL_CONTROL) {
+                this.processFrame(data);
+            } else {
+                this.log(`*** FRAME ON UNKNOWN CHANNEL ${payload[1]}, dropped ***`, 'warn');
+            }
+            return;
+        }
+        const packets = this.unwrapRelayMessage(payload);
+
+        if (packets === null) {
+            this.processPacket(payload);
+            return;
+        }
+        packets.forEach(packet => this.processPacket(packet));
+    }
+
+    // Minimal protobuf reader: returns [value, nextPos], or null if truncated.
+    // 64-bit values lose precision above 2^53.
+    // The third element is the low 32 bits as a signed int32, exact even
+    // for the ten-byte encoding of a negative int32.
+    readVarint(bytes, pos) {
+        let value = 0;
+        let low = 0;
+        for (let shift = 0; shift < 70 && pos < bytes.length; shift += 7) {
+            const b = bytes[pos++];
+            value += (b & 0x7F) * 2 ** shift;
+            if (shift < 32) low |= (b & 0x7F) << shift;
+            if ((b & 0x80) === 0) return [value, pos, low];
+        }
+        return null;
+    }
+
+    // Varint fields as an object: names[i] is the name for tag i + 1, null
+    // to skip it. Missing fields read as 0, as protobuf defaults them.
+    varintFields(fields, names) {
+        const result = {};
+        names.forEach((name, i) => {
+            if (!name) return;
+            const f = fields.find(b => b.tag === i + 1 && b.wireType === 0);
+            result[name] = f ? f.value : 0;
+        });
+        return result;
+    }
+
+    // Split a message into {tag, wireType, value} fields; null if malformed.
+    // Length-delimited values are byte arrays, varints are numbers.
+    readProtoFields(bytes) {
+        const fields = [];
+        let pos = 0;
+        while (pos < bytes.length) {
+            const key = this.readVarint(bytes, pos);
+            if (!key) return null;
+            const tag = Math.floor(key[0] / 8);
+            const wireType = key[0] & 7;
+            pos = key[1];
+            if (wireType === 0) {
+                const v = this.readVarint(bytes, pos);
+                if (!v) return null;
+                fields.push({ tag, wireType, value: v[0], int32: v[2] });
+                pos = v[1];
+            } else if (wireType === 2) {
+                const len = this.readVarint(bytes, pos);
+                if (!len || len[1] + len[0] > bytes.length) return null;
+                fields.push({ tag, wireType, value: bytes.slice(len[1], len[1] + len[0]) });
+                pos = len[1] + len[0];
+            } else {
+                return null;
+            }
+        }
+        return fields;
+    }
+
+    // One PassThroughToApp: the MouthPad packets it completes, none while a
+    // fragmented notification is still arriving
+    passThroughPackets(bytes, more, fragment, deviceIndex) {
+        // Only the primary MouthPad (device_index 0) is shown here
+        if (deviceIndex) {
+            this.log(`Skipping pass-through from secondary MouthPad ${deviceIndex}`, 'info');
+            return [];
+        }
+
+        if (!more && fragment === 0) {
+            this.passThroughFragments = null;
+            return bytes.length ? [bytes] : [];
+        }
+        // Notifications larger than one message arrive as numbered fragments
+        if (fragment === 0) {
+            this.passThroughFragments = [];
+        } else if (!this.passThroughFragments || fragment !== this.passThroughFragments.length) {
+            this.log(`*** PASS-THROUGH FRAGMENT ${fragment} OUT OF ORDER, dropping notification ***`, 'warn');
+            this.passThroughFragments = null;
+            return [];
+        }
+        this.passThroughFragments.push(bytes);
+        if (more) return [];
+
+        const packet = new Uint8Array(this.passThroughFragments.reduce((n, f) => n + f.length, 0));
+        let offset = 0;
+        for (const f of this.passThroughFragments) {
+            packet.set(f, offset);
+            offset += f.length;
+        }
+        this.passThroughFragments = null;
+        return [packet];
+    }
+
+    // One PassThroughChunk of a batch: checks its sequence, returns its packet
+    batchChunk(sequence, bytes) {
+        if (this.passThroughSequence !== null && sequence !== this.passThroughSequence) {
+            this.log(`*** PASS-THROUGH GAP: expected chunk ${this.passThroughSequence}, got ${sequence} ***`, 'warn');
+        }
+        this.passThroughSequence = (sequence + 1) >>> 0;
+        return bytes;
+    }
+
+    // RelayToAppMessage pass-through (tag 3) and pass-through batch (tag 10)
+    // frames yield the MouthPad packets they carry, oldest first. Other relay
+    // messages yield no packets; null means the frame is not a relay message.
+    // A reply with a request_id (tag 100) also settles its sendRelayRequest().
+    unwrapRelayMessage(payload) {
+        const fields = this.readProtoFields(payload);
+        if (!fields || fields.length < 1 || fields[0].wireType !== 2 ||
+            fields[0].tag < 1 || fields[0].tag > 28 ||
+            fields.slice(1).some(f => f.tag !== 100 || f.wireType !== 0)) {
+            return null;
+        }
+
+        const body = this.readProtoFields(fields[0].value);
+        if (!body) return null;
+
+        const requestId = fields.length > 1 ? fields[fields.length - 1].value : 0;
+        if (requestId && this.pendingRequests.has(requestId)) {
+            this.pendingRequests.get(requestId).resolve(fields[0].tag === 28 ? null : { tag: fields[0].tag, body });
+        }
+
+        // Pass-through and sensor frames are recorded per MouthPad packet by processPacket()
+        if (this.capture && fields[0].tag !== 3 && fields[0].tag !== 10 && fields[0].tag !== 26) {
+            this.capture.put(0, false, payload);
+        }
+
+        switch (fields[0].tag) {
+            case 3: { // PassThroughToApp { bytes data = 1; bool more_fragments = 2; uint32 fragment = 3; uint32 device_index = 4 }
+                const device = body.find(f => f.tag === 4 && f.wireType === 0);
+                const data = body.find(f => f.tag === 1 && f.wireType === 2);
+                const more = body.some(f => f.tag === 2 && f.wireType === 0 && f.value);
+                const frag = body.find(f => f.tag === 3 && f.wireType === 0);
+                return this.passThroughPackets(data ? data.value : new Uint8Array(0), more,
+                                               frag ? frag.value : 0, device ? device.value : 0);
+            }
+            case 10: { // PassThroughToAppBatch { repeated PassThroughChunk chunks = 1 }
+                const packets = [];
+                for (const f of body) {
+                    if (f.tag !== 1 || f.wireType !== 2) continue;
+                    const chunk = this.readProtoFields(f.value) || [];
+                    const seq = chunk.find(c => c.tag === 1 && c.wireType === 0);
+                    const data = chunk.find(c => c.tag === 2 && c.wireType === 2);
+                    packets.push(this.batchChunk(seq ? seq.value : 0, data ? data.value : new Uint8Array(0)));
+                }
+                return packets;
+            }
+            case 8: { // HidLatencyResponse { repeated HidLatencyReportStats reports = 1 }
+                       // HidLatencyReportStats { uint32 report_id = 1; uint32 count = 2; uint32 p50_us = 3;
+                       //   uint32 p99_us = 4; uint32 max_us = 5 }
+                this.handleHidLatency(body.filter(f => f.tag === 1 && f.wireType === 2)
+                    .map(f => this.varintFields(this.readProtoFields(f.value) || [],
+                                                ['reportId', 'count', 'p50Us', 'p99Us', 'maxUs'])));
+                return [];
+            }
+            case 12: { // RelayStatsResponse { RelayStatsPathCounters nus_rx = 1; nus_tx = 2; hid = 3 }
+                       // RelayStatsPathCounters { uint32 packets = 1; uint32 bytes = 2; uint32 echo_filtered = 3;
+                       //   uint32 dropped = 4; uint32 bridged = 5 }
+                const path = tag => {
+                    const f = body.find(b => b.tag === tag && b.wireType === 2);
+                    return this.varintFields(f ? this.readProtoFields(f.value) || [] : [],
+                                             ['packets', 'bytes', 'echoFiltered', 'dropped', 'bridged']);
+                };
+                this.handleRelayStats({ nusRx: path(1), nusTx: path(2), hid: path(3) });
+                return [];
+            }
+            case 13: { // ConnectionTimingResponse { repeated ConnectionTimingRecord records = 1;
+                       //   uint32 boot_usb_enumerated_ms = 2; uint32 boot_hid_ready_ms = 3;
+                       //   uint32 boot_usb_started_ms = 4; uint32 boot_ble_ready_ms = 5;
+                       //   uint32 boot_scan_started_ms = 6 }
+                       // ConnectionTimingRecord { uint32 sequence = 1; bool bonded = 2; bool in_progress = 3;
+                       //   uint32 first_adv_ms = 4 ... bas_ready_ms = 11; uint32 att_bearers = 12 }, newest first
+                const timing = this.varintFields(body, [null, 'bootUsbEnumeratedMs', 'bootHidReadyMs',
+                                                       'bootUsbStartedMs', 'bootBleReadyMs',
+                                                       'bootScanStartedMs']);
+                timing.records = body.filter(f => f.tag === 1 && f.wireType === 2)
+                    .map(f => this.varintFields(this.readProtoFields(f.value) || [],
+                                                ['sequence', 'bonded', 'inProgress', 'firstAdvMs', 'connectRequestMs',
+                                                 'connectedMs', 'securityMs', 'hidReadyMs', 'nusReadyMs',
+                                                 'disReadyMs', 'basReadyMs', 'attBearers']));
+                this.handleConnectionTiming(timing);
+                return [];
+            }
+            case 14: { // LinkTelemetry { uint32 sequence = 1; bool connected = 2; int32 rssi = 3; uint32 battery_level = 4;
+                       //   uint32 conn_interval_us = 5; uint32 tx_phy = 6; uint32 rx_phy = 7; uint32 hid_reports_per_s = 8;
+                       //   uint32 hid_dropped = 9; uint32 nus_rx_dropped = 10; uint32 nus_tx_dropped = 11;
+                       //   uint32 nus_tx_queued = 12; uint32 cdc_tx_queued = 13; uint32 interval_ms = 14;
+                       //   uint32 stalls = 15; uint32 worst_stall_us = 16; uint32 usb_wait_us = 17;
+                       //   uint32 usb_phase_us = 18; uint32 nus_seq_lost = 19; uint32 nus_seq_reordered = 20;
+                       //   uint32 nus_loss_permille = 21; repeated uint32 nus_gap_lengths = 22 }
+                const telemetry = this.varintFields(body, ['sequence', 'connected', 'rssi', 'batteryLevel',
+                    'connIntervalUs', 'txPhy', 'rxPhy', 'hidReportsPerS', 'hidDropped', 'nusRxDropped',
+                    'nusTxDropped', 'nusTxQueued', 'cdcTxQueued', 'intervalMs', 'stalls', 'worstStallUs', 'usbWaitUs', 'usbPhaseUs',
+                    'nusSeqLost', 'nusSeqReordered', 'nusLossPermille']);
+                const rssi = body.find(f => f.tag === 3 && f.wireType === 0);
+                telemetry.rssi = rssi ? rssi.int32 : 0;
+                // Packed; one count per gap length bin
+                const gaps = body.find(f => f.tag === 22 && f.wireType === 2);
+                telemetry.nusGapLengths = [];
+                for (let pos = 0, v; gaps && (v = this.readVarint(gaps.value, pos)); pos = v[1]) {
+                    telemetry.nusGapLengths.push(v[0]);
+                }
+                this.handleLinkTelemetry(telemetry);
+                return [];
+            }
+            case 11: { // PassThroughBatchConfigResponse { bool enabled = 1 }
+                const enabled = body.some(f => f.tag === 1 && f.value);
+                this.log(`Relay pass-through batching ${enabled ? 'enabled' : 'not supported'}`, 'info');
+                return [];
+            }
+            case 15: { // RelayCapabilitiesResponse { string firmware_version = 1; uint32 features = 2; uint32 max_frame_size = 3;
+                       //   uint32 max_in_flight_writes = 4; uint32 batch_window_us = 5; uint32 max_pass_through_size = 6;
+                       //   uint32 pass_through_ack_writes = 7; uint32 pass_through_ack_interval_us = 8 }
+                const value = tag => {
+                    const f = body.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                const version = body.find(f => f.tag === 1 && f.wireType === 2);
+                this.handleRelayCapabilities({
+                    firmwareVersion: version ? new TextDecoder().decode(new Uint8Array(version.value)) : '',
+                    features: value(2),
+                    maxFrameSize: value(3),
+                    maxInFlightWrites: value(4),
+                    batchWindowUs: value(5),
+                    maxPassThroughSize: value(6),
+                    passThroughAckWrites: value(7),
+                    passThroughAckIntervalUs: value(8),
+                });
+                return [];
+            }
+            case 16: { // EchoResponse { uint64 host_timestamp_us = 1; uint32 sequence = 2; uint64 relay_rx_us = 3; uint64 relay_tx_us = 4;
+                       //   bool via_mouthpad = 5; uint64 mouthpad_write_us = 6; uint64 mouthpad_ack_us = 7; PassThroughToMouthpadErrorCode error_code = 8 }
+                const value = tag => {
+                    const f = body.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                const reply = {
+                    receivedAt: performance.now(),
+                    sequence: value(2),
+                    relayRxUs: value(3),
+                    relayTxUs: value(4),
+                    mouthpadWriteUs: value(6),
+                    mouthpadAckUs: value(7),
+                    errorCode: value(8),
+                };
+                if (this.echoWaiter && this.echoWaiter.sequence === reply.sequence) {
+                    this.echoWaiter.resolve(reply);
+                }
+                return [];
+            }
+            case 17: { // HidMirrorConfigResponse { bool enabled = 1 }
+                const enabled = body.some(f => f.tag === 1 && f.value);
+                this.log(`Relay HID mirror ${enabled ? 'enabled' : 'disabled'}`, 'info');
+                return [];
+            }
+            case 18: { // HidMirrorBatch { uint32 sequence = 1; uint64 base_us = 2; repeated HidMirrorRecord records = 3 }
+                       // HidMirrorRecord { uint32 report_id = 1; bytes data = 2; uint32 ble_rx_offset_us = 3;
+                       //   uint32 usb_submit_delay_us = 4; bool not_submitted = 5 }
+                const value = (fields, tag) => {
+                    const f = fields.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                const baseUs = value(body, 2);
+                const records = body.filter(f => f.tag === 3 && f.wireType === 2).map(f => {
+                    const record = this.readProtoFields(f.value) || [];
+                    const data = record.find(r => r.tag === 2 && r.wireType === 2);
+                    return {
+                        reportId: value(record, 1),
+                        data: data ? Array.from(data.value) : [],
+                        bleRxUs: baseUs + value(record, 3),
+                        usbSubmitDelayUs: value(record, 4),
+                        submitted: !value(record, 5),
+                    };
+                });
+                this.handleHidMirrorBatch(value(body, 1), records);
+                return [];
+            }
+            case 19: { // ThreadStatsResponse { uint32 window_ms = 1; uint32 thread_count = 2; repeated ThreadStat threads = 3 }
+                       // ThreadStat { string name = 1; uint32 cpu_permille = 2; uint32 stack_size = 3;
+                       //   uint32 stack_unused = 4; uint32 context_switches = 5 }
+                const value = (fields, tag) => {
+                    const f = fields.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                this.log(`Relay threads over the last ${value(body, 1)} ms (${value(body, 2)} alive, busiest first):`, 'info');
+                body.filter(f => f.tag === 3 && f.wireType === 2).forEach(f => {
+                    const thread = this.readProtoFields(f.value) || [];
+                    const name = thread.find(t => t.tag === 1 && t.wireType === 2);
+                    const size = value(thread, 3);
+                    const unused = value(thread, 4);
+                    const stack = size ? `stack ${size - unused}/${size}` : `stack ${unused} free`;
+                    this.log(`  ${name ? new TextDecoder().decode(new Uint8Array(name.value)) : '?'}: ` +
+                             `${(value(thread, 2) / 10).toFixed(1)}% CPU, ${value(thread, 5)} switches, ${stack}`, 'info');
+                });
+                return [];
+            }
+            case 20: { // TraceResponse { uint32 boot_count = 1; uint32 total = 2; uint32 offset = 3; bytes records = 4 }
+                       // Each record: u32 time_ms, u16 value, u8 type, u8 arg, little endian
+                const value = (tag) => {
+                    const f = body.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                const types = ['boot', 'phase', 'disconnected', 'drop', 'queue full', 'usb reset',
+                               'usb suspend', 'usb recovery', 'latency max', 'stall',
+                               'queue depth', 'link risk', 'usb restart'];
+                const data = body.find(f => f.tag === 4 && f.wireType === 2);
+                const bytes = data ? data.value : [];
+                const offset = value(3);
+                const held = Math.min(value(2), 128);
+                if (offset === 0) {
+                    this.log(`Relay trace: boot #${value(1)}, ${value(2)} records since the last clear, oldest first:`, 'info');
+                }
+                for (let i = 0; i + 8 <= bytes.length; i += 8) {
+                    const timeMs = (bytes[i] | (bytes[i + 1] << 8) | (bytes[i + 2] << 16) | (bytes[i + 3] << 24)) >>> 0;
+                    const recordValue = bytes[i + 4] | (bytes[i + 5] << 8);
+                    const type = types[bytes[i + 6]] || `type ${bytes[i + 6]}`;
+                    this.log(`  ${(timeMs / 1000).toFixed(3)} s ${type} arg ${bytes[i + 7]} value ${recordValue}`, 'info');
+                }
+                const next = offset + bytes.length / 8;
+                if (bytes.length > 0 && next < held) {
+                    this.readTrace(next);
+                }
+                return [];
+            }
+            case 21: { // MemStatsResponse { uint32 heap_size = 1; uint32 heap_used = 2; uint32 heap_max_used = 3;
+                       //   uint32 heap_largest_free = 4; uint32 heap_failures = 5; repeated MemPool pools = 6;
+                       //   repeated MemSite sites = 7; uint32 stacks_checked = 8; uint32 stacks_tight = 9;
+                       //   uint32 stack_spare = 10 }
+                       // MemPool { string name = 1; uint32 unit = 2; uint32 size = 3; uint32 used = 4;
+                       //   uint32 max_used = 5; uint32 failures = 6 }
+                       // MemSite { string name = 1; uint32 calls = 2; uint32 failures = 3; uint32 peak = 4 }
+                const value = (fields, tag) => {
+                    const f = fields.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                const name = (fields) => {
+                    const f = fields.find(b => b.tag === 1 && b.wireType === 2);
+                    return f ? new TextDecoder().decode(new Uint8Array(f.value)) : '?';
+                };
+                this.log(`Relay heap: ${value(body, 2)}/${value(body, 1)} bytes used, peak ${value(body, 3)}, ` +
+                         `largest free ${value(body, 4)}, ${value(body, 5)} failed`, 'info');
+                body.filter(f => f.tag === 6 && f.wireType === 2).forEach(f => {
+                    const pool = this.readProtoFields(f.value) || [];
+                    this.log(`  pool ${name(pool)}: ${value(pool, 4)}/${value(pool, 3)} x ${value(pool, 2)} bytes, ` +
+                             `peak ${value(pool, 5)}, ${value(pool, 6)} refused`, 'info');
+                });
+                body.filter(f => f.tag === 7 && f.wireType === 2).forEach(f => {
+                    const site = this.readProtoFields(f.value) || [];
+                    this.log(`  site ${name(site)}: ${value(site, 2)} takes, ${value(site, 3)} refused, ` +
+                             `peak ${value(site, 4)}`, 'info');
+                });
+                if (value(body, 8) > 0) {
+                    this.log(`  stacks: ${value(body, 8)} checked, ${value(body, 9)} tight, ` +
+                             `${value(body, 10)} bytes to spare`, value(body, 9) > 0 ? 'warn' : 'info');
+                }
+                return [];
+            }
+            case 22: { // FwUpdateStatus { uint32 state = 1; uint32 size = 2; uint32 offset = 3; uint32 written = 4;
+                       //   uint32 window = 5; uint32 chunk_max = 6; uint32 error = 7; sint32 detail = 8 }
+                const value = (tag) => {
+                    const f = body.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                this.handleFwUpdateStatus({
+                    state: value(1), size: value(2), offset: value(3), written: value(4),
+                    window: value(5), chunkMax: value(6), error: value(7),
+                    detail: value(8) % 2 ? -(value(8) + 1) / 2 : value(8) / 2,
+                });
+                return [];
+            }
+            case 23: { // NusStreamStatus { uint32 state = 1; uint32 received = 2; uint32 forwarded = 3;
+                       //   uint32 sent = 4; uint32 failed = 5; uint32 window = 6; uint32 packet_size = 7;
+                       //   uint32 refused = 8 }
+                const value = (tag) => {
+                    const f = body.find(b => b.tag === tag && b.wireType === 0);
+                    return f ? f.value : 0;
+                };
+                this.handleNusStreamStatus({
+                    state: value(1), received: value(2), forwarded: value(3), sent: value(4),
+                    failed: value(5), window: value(6), packetSize: value(7), refused: value(8),
+                });
+                return [];
+            }
+            case 24: { // SensorStreamFilterResponse { uint32 blocked = 1; uint32 sensor_forwarded = 2;
+                       //   uint32 sensor_dropped = 3; uint32 power_forwarded = 4; uint32 power_dropped = 5;
+                       //   uint32 other_forwarded = 6; uint32 other_dropped = 7 }
+                const s = this.varintFields(body, ['blocked', 'sensorForwarded', 'sensorDropped',
+                    'powerForwarded', 'powerDropped', 'otherForwarded', 'otherDropped']);
+                const blocked = Object.keys(SENSOR_STREAM)
+                    .filter(name => s.blocked & (1 << SENSOR_STREAM[name]))
+                    .map(name => name.toLowerCase());
+                this.log(`Relay stream filter: ${blocked.length ? 'blocking ' + blocked.join(', ') : 'forwarding all'}` +
+                         ` (forwarded/dropped: sensor ${s.sensorForwarded}/${s.sensorDropped},` +
+                         ` power ${s.powerForwarded}/${s.powerDropped}, other ${s.otherForwarded}/${s.otherDropped})`, 'info');
+                return [];
+            }
+            case 25: { // SensorCodecConfigResponse { bool enabled = 1; uint32 keyframe_interval = 2; uint32 frames = 3;
+                       //   uint32 keyframes = 4; uint32 raw_bytes = 5; uint32 coded_bytes = 6 }
+                const c = this.varintFields(body, ['enabled', 'keyframeInterval', 'frames', 'keyframes',
+                    'rawBytes', 'codedBytes']);
+                const ratio = c.rawBytes ? ` (${(100 * c.codedBytes / c.rawBytes).toFixed(1)}% of raw)` : '';
+                this.log(`Relay sensor codec ${c.enabled ? 'on' : 'off'}, keyframe every ${c.keyframeInterval}:` +
+                         ` ${c.frames} frames, ${c.keyframes} keyframes, ${c.rawBytes} -> ${c.codedBytes} bytes${ratio}`, 'info');
+                return [];
+            }
+            case 26: { // SensorFrameDelta { uint32 sequence = 1; bool keyframe = 2; bytes data = 3 }
+                const seq = body.find(f => f.tag === 1 && f.wireType === 0);
+                const keyframe = body.some(f => f.tag === 2 && f.wireType === 0 && f.value);
+                const data = body.find(f => f.tag === 3 && f.wireType === 2);
+                const hadFrame = this.sensorCodec.frame !== null;
+                const frame = this.sensorCodec.decode(seq ? seq.value : 0, keyframe,
+                                                      data ? data.value : new Uint8Array(0));
+                if (!frame) {
+                    if (hadFrame) {
+                        this.log('*** SENSOR FRAME GAP: waiting for the next keyframe ***', 'warn');
+                    }
+                    return [];
+                }
+                return [frame];
+            }
+            case 27: { // SensorStreamRateResponse { SensorStream stream = 1; uint32 keep_one_in = 2;
+                       //   uint32 min_interval_us = 3; uint32 thinned = 4 }
+                const r = this.varintFields(body, ['stream', 'keepOneIn', 'minIntervalUs', 'thinned']);
+                const name = (Object.keys(SENSOR_STREAM).find(k => SENSOR_STREAM[k] === r.stream) || `#${r.stream}`).toLowerCase();
+                this.log(`Relay ${name} stream rate: 1 in ${r.keepOneIn || 1}, every ${r.minIntervalUs} us` +
+                         ` (${r.thinned} thinned)`, 'info');
+                return [];
+            }
+            case 28: { // RequestError { RequestErrorCode code = 1; uint32 request_tag = 2 }
+                const e = this.varintFields(body, ['code', 'requestTag']);
+                this.log(`Relay refused request ${requestId} (AppToRelayMessage tag ${e.requestTag}): ` +
+                         `${REQUEST_ERROR_CODES[e.code] || e.code}`, 'warn');
+                return [];
+            }
+            default:
+                return [];
+        }
+    }
+
+    // Frame a payload the way the relay firmware expects:
+    // [0xAA][0x55][LEN_H][LEN_L][DATA...][CRC_H][CRC_L]
+    // or, once the relay has reported RELAY_FEATURE.COBS_FRAMING,
+    // [0x00][COBS(DATA... CRC_H CRC_L)][0x00], which it then answers in.
+    // Once it has reported RELAY_FEATURE.RAW_CHANNELS, DATA goes on the
+    // control channel, and MouthPad notifications come back on the NUS
+    // channel without a RelayToAppMessage around them.
+    frameData(payload) {
+        if (this.capture) {
+            this.capture.put(0, true, Uint8Array.from(payload));
+        }
+        if (this.relayCapabilities && (this.relayCapabilities.features & RELAY_FEATURE.RAW_CHANNELS)) {
+            payload = [0x00, CHANNEL_CONTROL, 0x00, ...payload];
+        }
+        const crc = this.calculateCRC16(payload);
+        if (this.relayCapabilities && (this.relayCapabilities.features & RELAY_FEATURE.COBS_FRAMING)) {
+            return this.encodeCobs([...payload, crc >> 8, crc & 0xFF]);
+        }
+        return new Uint8Array([0xAA, 0x55, payload.length >> 8, payload.length & 0xFF,
+                               ...payload, crc >> 8, crc & 0xFF]);
+    }
+
+    // Both delimiters included
+    encodeCobs(data) {
+        const out = new Uint8Array(data.length + Math.ceil(data.length / 254) + 3);
+        let codeAt = 1;
+        let n = 2;
+        for (const byte of data) {
+            if (byte !== 0) {
+                out[n++] = byte;
+            }
+            if (byte === 0 || n - codeAt === 0xFF) {
+                out[codeAt] = n - codeAt;
+                codeAt = n++;
+            }
+        }
+        out[codeAt] = n - codeAt;
+        return out.subarray(0, n + 1);
+    }
+
+    // AppToRelayMessage { destination = RELAY, relay_capabilities_read = {} }
+    async requestCapabilities() {
+        clearTimeout(this.capabilitiesTimer);
+        this.relayCapabilities = null;
+        this.capabilitiesTimer = setTimeout(() => {
+            this.capabilitiesTimer = null;
+            // Older firmware: ask for batching as before; it ignores what it does not know
+            this.log('Relay did not report capabilities, assuming older firmware', 'info');
+            this.requestPassThroughBatching();
+        }, RELAY_CAPABILITIES_TIMEOUT_MS);
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0x7A, 0x00]));
+        } catch (error) {
+            this.log(`Failed to request relay capabilities: ${error.message}`, 'warn');
+        }
+    }
+
+    handleRelayCapabilities(caps) {
+        clearTimeout(this.capabilitiesTimer);
+        this.capabilitiesTimer = null;
+        this.relayCapabilities = caps;
+
+        const names = Object.keys(RELAY_FEATURE).filter(name => caps.features & RELAY_FEATURE[name]);
+        this.log(`Relay firmware ${caps.firmwareVersion || '(unknown)'}: ${names.join(', ') || 'no optional features'}; ` +
+                 `frames up to ${caps.maxFrameSize} bytes, ${caps.maxInFlightWrites} writes in flight`, 'info');
+
+        // Raw channels already take the protobuf off every notification;
+        // batching would put it back, and wins on relays that do both
+        if ((caps.features & RELAY_FEATURE.PASS_THROUGH_BATCH) && !(caps.features & RELAY_FEATURE.RAW_CHANNELS)) {
+            this.requestPassThroughBatching();
+        }
+        // Someone opened the page to use the MouthPad: a backed-off relay scans at full rate again.
+        // ble_connection_status_read = { scan_boost: true }
+        if (caps.features & RELAY_FEATURE.SCAN_BOOST) {
+            this.sendRelayRequest([0x12, 0x02, 0x08, 0x01], 'boost relay scan');
+        }
+        if (this.dashboardTimer) {
+            this.requestDashboardSetup();
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, pass_through_batch_config_write = { enabled } }
+    async requestPassThroughBatching(enabled = true) {
+        const message = [0x08, 0x01, 0x5A, 0x02, 0x08, enabled ? 1 : 0];
+        this.passThroughSequence = null;
+        try {
+            await this.writer.write(this.frameData(message));
+        } catch (error) {
+            this.log(`Failed to request pass-through batching: ${error.message}`, 'warn');
+        }
+    }
+
+    // Protobuf varint bytes for a non-negative integer up to 2^53
+    encodeVarint(value) {
+        const bytes = [];
+        while (value >= 0x80) {
+            bytes.push((value % 0x80) | 0x80);
+            value = Math.floor(value / 0x80);
+        }
+        bytes.push(value);
+        return bytes;
+    }
+
+    // AppToRelayMessage { destination = RELAY, echo_request = { ... } }; resolves
+    // with the decoded EchoResponse, or null after ECHO_TIMEOUT_MS
+    async sendEcho(sequence, payload = []) {
+        const sentAt = performance.now();
+        const body = [0x08, ...this.encodeVarint(Math.round(sentAt * 1000)),
+                      0x10, ...this.encodeVarint(sequence)];
+        if (payload.length) {
+            body.push(0x18, 0x01, 0x22, payload.length, ...payload);
+        }
+        const reply = new Promise(resolve => {
+            const timer = setTimeout(() => resolve(null), ECHO_TIMEOUT_MS);
+            this.echoWaiter = { sequence, resolve: r => { clearTimeout(timer); resolve(r); } };
+        });
+        await this.writer.write(this.frameData([0x08, 0x01, 0x82, 0x01, body.length, ...body]));
+        const result = await reply;
+        this.echoWaiter = null;
+        return result && { ...result, rttMs: result.receivedAt - sentAt };
+    }
+
+    // Round trips through the relay, split into the USB leg (host RTT minus
+    // the relay's own handling time) and, with a payload, the BLE leg (NUS
+    // write to ATT write response). The payload is written to the MouthPad
+    // as-is, so only pass bytes it ignores; from the console:
+    // mouthpadController.runEchoTest(100, [0x00])
+    async runEchoTest(count = 100, payload = []) {
+        if (!this.isConnected) {
+            this.log('Not connected to serial port', 'error');
+            return;
+        }
+        if (this.relayCapabilities && !(this.relayCapabilities.features & RELAY_FEATURE.ECHO)) {
+            this.log('Relay firmware does not answer EchoRequest', 'warn');
+            return;
+        }
+
+        const usb = [], ble = [], relay = [];
+        let lost = 0, failed = 0;
+        for (let sequence = 0; sequence < count; sequence++) {
+            let reply;
+            try {
+                reply = await this.sendEcho(sequence, payload);
+            } catch (error) {
+                this.log(`Echo test stopped: ${error.message}`, 'error');
+                return;
+            }
+            if (!reply) {
+                lost++;
+            } else if (reply.errorCode) {
+                failed++;
+            } else {
+                const relayMs = (reply.relayTxUs - reply.relayRxUs) / 1000;
+                relay.push(relayMs);
+                usb.push(reply.rttMs - relayMs);
+                if (payload.length) {
+                    ble.push((reply.mouthpadAckUs - reply.mouthpadWriteUs) / 1000);
+                }
+            }
+        }
+
+        const summary = samples => {
+            if (!samples.length) return 'no samples';
+            samples.sort((a, b) => a - b);
+            const at = q => samples[Math.min(samples.length - 1, Math.floor(q * samples.length))].toFixed(2);
+            return `min ${at(0)} / median ${at(0.5)} / p99 ${at(0.99)} ms`;
+        };
+        this.log(`Echo x${count}${payload.length ? ' via MouthPad' : ''}: ${lost} lost, ${failed} failed`, 'info');
+        this.log(`  USB round trip: ${summary(usb)}`, 'info');
+        this.log(`  Relay handling: ${summary(relay)}`, 'info');
+        if (payload.length) {
+            this.log(`  BLE write to ack: ${summary(ble)}`, 'info');
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, hid_mirror_config_write = { enabled } }.
+    // Turning the mirror off logs a summary; the records stay in
+    // mouthpadController.hidMirror.records for export from the console.
+    async setHidMirror(enabled = true) {
+        if (enabled) {
+            this.hidMirror = { records: [], nextSequence: null, lost: 0 };
+        } else if (this.hidMirror) {
+            this.logHidMirrorSummary();
+        }
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0x8A, 0x01, 0x02, 0x08, enabled ? 1 : 0]));
+        } catch (error) {
+            this.log(`Failed to configure HID mirror: ${error.message}`, 'warn');
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, sensor_stream_filter_write = { blocked } }.
+    // Streams named here are stopped at the relay and never reach CDC0, e.g.
+    // setStreamFilter(['sensor']) while only power data is wanted; no
+    // argument forwards everything again. The reply logs the counts.
+    async setStreamFilter(streams = []) {
+        const unknown = streams.filter(name => !(name.toUpperCase() in SENSOR_STREAM));
+        if (unknown.length) {
+            this.log(`Unknown stream ${unknown.join(', ')}; streams are ${Object.keys(SENSOR_STREAM).join(', ').toLowerCase()}`, 'warn');
+            return;
+        }
+        const blocked = streams.reduce((mask, name) => mask | (1 << SENSOR_STREAM[name.toUpperCase()]), 0);
+        const body = blocked ? [0x08, ...this.encodeVarint(blocked)] : [];
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0xD2, 0x01, body.length, ...body]));
+        } catch (error) {
+            this.log(`Failed to set the relay stream filter: ${error.message}`, 'warn');
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, sensor_stream_rate_write =
+    // { stream, keep_one_in, min_interval_us } }. Thins a stream at the relay
+    // to what the page draws, e.g. setStreamRate('sensor', { hz: 60 }); no
+    // limits forwards every notification again. Needs
+    // RELAY_FEATURE.SENSOR_STREAM_RATE.
+    async setStreamRate(stream, { keepOneIn = 0, hz = 0 } = {}) {
+        const value = SENSOR_STREAM[String(stream).toUpperCase()];
+        if (value === undefined) {
+            this.log(`Unknown stream ${stream}; streams are ${Object.keys(SENSOR_STREAM).join(', ').toLowerCase()}`, 'warn');
+            return;
+        }
+        const minIntervalUs = hz > 0 ? Math.round(1e6 / hz) : 0;
+        const body = [
+            ...(value ? [0x08, value] : []),
+            ...(keepOneIn ? [0x10, ...this.encodeVarint(keepOneIn)] : []),
+            ...(minIntervalUs ? [0x18, ...this.encodeVarint(minIntervalUs)] : []),
+        ];
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0xE2, 0x01, body.length, ...body]));
+        } catch (error) {
+            this.log(`Failed to set the relay stream rate: ${error.message}`, 'warn');
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, sensor_codec_config_write =
+    // { enabled, keyframe_interval } }; sensor frames then arrive as
+    // SensorFrameDelta and are decoded before processPacket(). Needs
+    // RELAY_FEATURE.SENSOR_CODEC; 0 keeps the relay's keyframe interval.
+    async setSensorCodec(enabled = true, keyframeInterval = 0) {
+        const body = [
+            ...(enabled ? [0x08, 0x01] : []),
+            ...(keyframeInterval ? [0x10, ...this.encodeVarint(keyframeInterval)] : []),
+        ];
+        this.sensorCodec.reset();
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0xDA, 0x01, body.length, ...body]));
+        } catch (error) {
+            this.log(`Failed to set the relay sensor codec: ${error.message}`, 'warn');
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, thread_stats_read = {} }; the
+    // reply covers the time since the previous read and is logged
+    async readThreadStats() {
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0x92, 0x01, 0x00]));
+        } catch (error) {
+            this.log(`Failed to read relay thread stats: ${error.message}`, 'warn');
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, mem_stats_read = { reset } }
+    async readMemStats(reset = false) {
+        const body = reset ? [0x08, 0x01] : [];
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0xA2, 0x01, body.length, ...body]));
+        } catch (error) {
+            this.log(`Failed to read relay memory stats: ${error.message}`, 'warn');
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, trace_read = { offset } }; each
+    // reply is one page and asks for the next until every record is logged
+    async readTrace(offset = 0) {
+        const body = [];
+        if (offset) {
+            body.push(0x08);
+            for (let v = offset; ; v >>>= 7) {
+                if (v < 0x80) { body.push(v); break; }
+                body.push((v & 0x7F) | 0x80);
+            }
+        }
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0x9A, 0x01, body.length, ...body]));
+        } catch (error) {
+            this.log(`Failed to read relay trace: ${error.message}`, 'warn');
+        }
+    }
+
+    // Stream a firmware image (ArrayBuffer or Uint8Array: zephyr.signed.bin on
+    // nRF, the app .bin on ESP) with FwUpdateStart, FwUpdateChunk and
+    // FwUpdateEnd. Chunks go out as FwUpdateStatus grants credit: at most
+    // window of them beyond what the relay has written.
+    async updateFirmware(image, reboot = true) {
+        if (!this.relayCapabilities || !(this.relayCapabilities.features & RELAY_FEATURE.FW_UPDATE)) {
+            this.log('Relay firmware does not take firmware updates over CDC0', 'warn');
+            return;
+        }
+        const bytes = new Uint8Array(image);
+        const sha256 = new Uint8Array(await crypto.subtle.digest('SHA-256', bytes));
+        this.fwUpdate = { bytes, reboot, sent: 0, written: 0, credit: 0, chunkMax: 0,
+                          sending: false, ended: false, startedAt: performance.now() };
+
+        // AppToRelayMessage { destination = RELAY, fw_update_start = { size, sha256 } }
+        const body = [0x08, ...this.encodeVarint(bytes.length), 0x12, sha256.length, ...sha256];
+        this.log(`Firmware update: ${bytes.length} bytes, waiting for the relay to open its slot`, 'info');
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0xAA, 0x01, body.length, ...body]));
+        } catch (error) {
+            this.log(`Failed to start firmware update: ${error.message}`, 'warn');
+            this.fwUpdate = null;
+        }
+    }
+
+    // AppToRelayMessage { destination = RELAY, fw_update_end = { abort: true } }
+    async abortFirmwareUpdate() {
+        this.fwUpdate = null;
+        try {
+            await this.writer.write(this.frameData([0x08, 0x01, 0xBA, 0x01, 0x02, 0x08, 0x01]));
+        } catch (error) {
+            this.log(`Failed to abort firmware update: ${error.message}`, 'warn');
+        }
+    }
+
+    handleFwUpdateStatus(status) {
+        const states = ['idle', 'preparing', 'receiving', 'verifying', 'done', 'error'];
+        const errors = ['none', 'platform', 'too large', 'out of sequence', 'short', 'verify failed'];
+        const update = this.fwUpdate;
+
+        if (status.state === 5) {
+            this.log(`Firmware update failed: ${errors[status.error] || status.error} ` +
+                     `(${status.detail}) at ${status.written}/${status.size} bytes`, 'error');
+            this.fwUpdate = null;
+            return;
+        }
+        if (status.state === 4) {
+            const seconds = update ? (performance.now() - update.startedAt) / 1000 : 0;
+            this.log(`Firmware update verified in ${seconds.toFixed(1)} s; ` +
+                     (update && update.reboot ? 'the relay is restarting into it' : 'it runs after the next reset'),
+                     'info');
+            this.fwUpdate = null;
+            return;
+        }
+        if (!update || status.state !== 2) {
+            if (update) this.log(`Firmware update: ${states[status.state] || status.state}`, 'info');
+            return;
+        }
+
+        // Chunks beyond a drop were dropped too; once the relay has written
+        // everything it accepted, resend from there
+        if (status.offset === status.written && update.sent > status.offset) {
+            update.sent = status.offset;
+        }
+        update.written = status.written;
+        update.credit = status.window * status.chunkMax;
+        update.chunkMax = status.chunkMax;
+        this.pumpFirmwareUpdate();
+    }
+
+    async pumpFirmwareUpdate() {
+        const update = this.fwUpdate;
+        if (!update || update.sending) return;
+        update.sending = true;
+        try {
+            while (this.fwUpdate === update && update.sent < update.bytes.length &&
+                   update.sent < update.written + update.credit) {
+                const offset = update.sent;
+                const data = update.bytes.subarray(offset, Math.min(offset + update.chunkMax, update.bytes.length));
+                update.sent += data.length;
+                // AppToRelayMessage { destination = RELAY, fw_update_chunk = { offset, data } }
+                const body = [0x08, ...this.encodeVarint(offset), 0x12, ...this.encodeVarint(data.length), ...data];
+                await this.writer.write(this.frameData([0x08, 0x01, 0xB2, 0x01, ...this.encodeVarint(body.length), ...body]));
+            }
+            if (this.fwUpdate === update && !update.ended && update.written === update.bytes.length) {
+                // AppToRelayMessage { destination = RELAY, fw_update_end = { reboot } }
+                update.ended = true;
+                await this.writer.write(this.frameData([0x08, 0x01, 0xBA, 0x01, 0x02, 0x10, update.reboot ? 1 : 0]));
             }
-            
-            // Clear any remaining data
-            this.dataBuffer = [];
-            
-            // Reset connection state
-            this.isConnected = false;
-            this.updateConnectionStatus('disconnected');
-            this.log('Disconnected from serial port - port should now be available for other applications', 'success');
-            
         } catch (error) {
-            this.log(`Disconnect error: ${error.message}`, 'error');
-            // Force cleanup even if there's an error
-            this.reader = null;
-            this.writer = null;
-            this.port = null;
-            this.isConnected = false;
-            this.updateConnectionStatus('disconnected');
+            this.log(`Firmware update stopped: ${error.message}`, 'error');
+            this.fwUpdate = null;
+        } finally {
+            update.sending = false;
         }
     }
 
-    async startReading() {
+    // Send data (ArrayBuffer or Uint8Array), e.g. a MouthPad firmware image,
+    // to the MouthPad through the relay's bulk NUS stream: NusStreamWrites go
+    // out as NusStreamStatus grants credit, at most window bytes beyond what
+    // the relay has forwarded to NUS, and the relay packs them into
+    // full-size NUS writes. Resolves once the relay has written everything,
+    // with the number of bytes whose writes failed.
+    streamToMouthpad(data) {
+        if (!this.relayCapabilities || !(this.relayCapabilities.features & RELAY_FEATURE.NUS_STREAM)) {
+            return Promise.reject(new Error('Relay firmware has no bulk NUS stream'));
+        }
+        if (this.nusStream) {
+            return Promise.reject(new Error('A stream to the MouthPad is already running'));
+        }
+        return new Promise((resolve, reject) => {
+            this.nusStream = { bytes: new Uint8Array(data), sent: 0, received: 0, forwarded: 0, window: 0, refused: 0,
+                               open: false, closing: false, sending: false, startedAt: performance.now(),
+                               resolve, reject };
+            this.writeNusStreamControl(true).catch((error) => {
+                this.nusStream = null;
+                reject(error);
+            });
+        });
+    }
+
+    // AppToRelayMessage { destination = RELAY, nus_stream_control = { enabled } }
+    writeNusStreamControl(enabled) {
+        return this.writer.write(this.frameData([0x08, 0x01, 0xC2, 0x01, 0x02, 0x08, enabled ? 1 : 0]));
+    }
+
+    handleNusStreamStatus(status) {
+        const stream = this.nusStream;
+        if (!stream) return;
+
+        if (status.state === 2) {
+            stream.open = true;
+            // Writes after a refused one were refused too; resend from the
+            // next byte the relay expects
+            if (status.refused > stream.refused && stream.sent > status.received) {
+                stream.sent = status.received;
+            }
+            stream.refused = status.refused;
+            stream.received = status.received;
+            stream.forwarded = status.forwarded;
+            stream.window = status.window;
+            this.pumpNusStream();
+        } else if (status.state === 0 && stream.closing) {
+            if (status.sent + status.failed < stream.bytes.length) return;
+            const seconds = (performance.now() - stream.startedAt) / 1000;
+            this.log(`MouthPad stream: ${stream.bytes.length} bytes in ${seconds.toFixed(1)} s ` +
+                     `(${(stream.bytes.length / 1024 / seconds).toFixed(1)} KB/s, ` +
+                     `${status.packetSize}-byte writes), ${status.failed} failed`,
+                     status.failed ? 'warn' : 'info');
+            this.nusStream = null;
+            stream.resolve(status.failed);
+        } else if (status.state === 0 && stream.open) {
+            this.nusStream = null;
+            stream.reject(new Error('Relay closed the stream'));
+        }
+    }
+
+    async pumpNusStream() {
+        const stream = this.nusStream;
+        if (!stream || stream.sending) return;
+        stream.sending = true;
         try {
-            this.reader = this.port.readable.getReader();
-            
-            while (true) {
-                const { value, done } = await this.reader.read();
-                if (done) break;
-                
-                // Process received data
-                this.processReceivedData(value);
+            while (this.nusStream === stream && stream.sent < stream.bytes.length &&
+                   stream.sent < stream.forwarded + stream.window) {
+                const offset = stream.sent;
+                const end = Math.min(offset + 240, stream.bytes.length, stream.forwarded + stream.window);
+                const data = stream.bytes.subarray(offset, end);
+                stream.sent = end;
+                // AppToRelayMessage { destination = RELAY, nus_stream_write = { offset, data } }
+                const body = [0x08, ...this.encodeVarint(offset), 0x12, ...this.encodeVarint(data.length), ...data];
+                await this.writer.write(this.frameData([0x08, 0x01, 0xCA, 0x01, ...this.encodeVarint(body.length), ...body]));
+            }
+            if (this.nusStream === stream && !stream.closing && stream.received === stream.bytes.length) {
+                // Everything was accepted; closing drains it to the MouthPad
+                stream.closing = true;
+                await this.writeNusStreamControl(false);
             }
         } catch (error) {
-            this.log(`Reading error: ${error.message}`, 'error');
+            this.log(`MouthPad stream stopped: ${error.message}`, 'error');
+            this.nusStream = null;
+            stream.reject(error);
+        } finally {
+            stream.sending = false;
         }
     }
 
-    processReceivedData(data) {
-        // Log raw hex data if in raw mode
-        if (this.logViewMode === 'raw') {
-            this.logRaw(data);
-        } else {
-            this.log(`Received ${data.length} bytes of binary data`, 'data');
-        }
-        
-        // Update last packet time
-        this.lastPacketTime = Date.now();
-        
-        // Add received data to buffer (USB CDC fragments data)
-        for (let i = 0; i < data.length; i++) {
-            this.dataBuffer.push(data[i]);
+    handleHidMirrorBatch(sequence, records) {
+        if (!this.hidMirror) return;
+        const mirror = this.hidMirror;
+        // Records lost to the relay's buffer overflowing leave a gap in the numbering
+        if (mirror.nextSequence !== null && sequence !== mirror.nextSequence) {
+            mirror.lost += (sequence - mirror.nextSequence) >>> 0;
         }
-        
-        // this.log(`*** BUFFER SIZE: ${this.dataBuffer.length} bytes ***`, 'debug');
-        
-        // Debug: Show first few bytes of new data
-        if (data.length > 0) {
-            const hexData = data.slice(0, Math.min(16, data.length)).map(b => b.toString(16).padStart(2, '0')).join(' ');
-            // this.log(`*** NEW DATA HEX: ${hexData} ***`, 'debug');
+        mirror.nextSequence = (sequence + records.length) >>> 0;
+        if (mirror.records.length < 100000) {
+            mirror.records.push(...records);
         }
-        
-        // Process complete packets from buffer
-        this.processBuffer();
     }
 
-    processBuffer() {
-        // Look for framed packets - support both old and new formats
-        // Old format: [0xAA][LEN_L][LEN_H][DATA...][0x55]
-        // New format: [0xAA][0x55][LEN_H][LEN_L][DATA...][CRC_H][CRC_L]
-        while (this.dataBuffer.length >= 5) { // Need at least 5 bytes for minimal frame
-            // First try new format: dual start markers (0xAA 0x55)
-            let packetStart = -1;
-            let useNewFormat = false;
-            
-            for (let i = 0; i < this.dataBuffer.length - 4; i++) {
-                if (this.dataBuffer[i] === 0xAA) {
-                    if (i + 1 < this.dataBuffer.length && this.dataBuffer[i + 1] === 0x55) {
-                        // New format detected
-                        packetStart = i;
-                        useNewFormat = true;
-                        break;
-                    } else if (i + 2 < this.dataBuffer.length) {
-                        // Old format detected (0xAA followed by length bytes)
-                        packetStart = i;
-                        useNewFormat = false;
-                        break;
-                    }
-                }
-            }
-            
-            // Debug: If buffer is getting large, show what we're looking for
-            if (this.dataBuffer.length > 1000 && packetStart === -1) {
-                const searchArea = this.dataBuffer.slice(0, Math.min(100, this.dataBuffer.length));
-                const searchHex = searchArea.map(b => b.toString(16).padStart(2, '0')).join(' ');
-                // this.log(`*** LARGE BUFFER SEARCH: Looking for 0xAA in: ${searchHex} ***`, 'debug');
+    logHidMirrorSummary() {
+        const { records, lost } = this.hidMirror;
+        const percentile = (samples, q) => samples.length
+            ? samples[Math.min(samples.length - 1, Math.floor(q * samples.length))] : 0;
+        const submitted = records.filter(r => r.submitted);
+        const delays = submitted.map(r => r.usbSubmitDelayUs).sort((a, b) => a - b);
+
+        this.log(`HID mirror: ${records.length} reports, ${records.length - submitted.length} not submitted, ` +
+                 `${lost} lost to overflow; BLE->USB p50 ${percentile(delays, 0.5)} / p99 ${percentile(delays, 0.99)} us`, 'info');
+
+        // Arrival jitter per report ID, from the BLE receive times
+        const byId = {};
+        records.forEach(r => (byId[r.reportId] = byId[r.reportId] || []).push(r.bleRxUs));
+        Object.entries(byId).forEach(([id, times]) => {
+            const gaps = times.slice(1).map((t, i) => t - times[i]).sort((a, b) => a - b);
+            if (gaps.length) {
+                this.log(`  Report ${id}: interval p50 ${percentile(gaps, 0.5)} / p99 ${percentile(gaps, 0.99)} us`, 'info');
             }
-            
-            if (packetStart === -1) {
-                // No packet start found, remove one byte and continue
-                this.dataBuffer.shift();
-                return;
+        });
+    }
+
+    // Open or close the performance dashboard. Opening it starts a new
+    // session: telemetry at DASHBOARD_POLL_MS, a poll of the relay's HID
+    // latency and path counters and one echo per sample, and a capture of
+    // all relay traffic until it is closed.
+    toggleDashboard() {
+        if (this.dashboardTimer) {
+            clearInterval(this.dashboardTimer);
+            this.dashboardTimer = null;
+            this.dashboardPanel.hidden = true;
+            this.dashboardBtn.textContent = '📈 Dashboard';
+            if (this.isConnected && this.relayHas(RELAY_FEATURE.LINK_TELEMETRY)) {
+                this.sendRelayRequest([0x72, 0x02, 0x08, 0x00], 'stop link telemetry');
             }
-            
-            // Process packet based on detected format
-            if (useNewFormat) {
-                // New format: [0xAA][0x55][LEN_H][LEN_L][DATA...][CRC_H][CRC_L]
-                if (this.dataBuffer.length < packetStart + 6) {
-                    this.log(`*** INCOMPLETE NEW FORMAT LENGTH FIELD ***`, 'debug');
-                    return;
-                }
-                
-                // Parse packet length (2 bytes, big-endian)
-                const packetLength = (this.dataBuffer[packetStart + 2] << 8) | this.dataBuffer[packetStart + 3];
-                
-                // Sanity check: packet length should be reasonable (max 1000 bytes)
-                if (packetLength > 1000 || packetLength < 0) {
-                    this.log(`*** INVALID NEW FORMAT PACKET LENGTH: ${packetLength} bytes, removing start marker ***`, 'warn');
-                    this.dataBuffer = this.dataBuffer.slice(packetStart + 1);
-                    continue;
-                }
-                
-                // this.log(`*** NEW FORMAT FRAMED PACKET: Length=${packetLength} bytes ***`, 'debug');
-                
-                // Check if we have the complete packet (start + len + payload + crc)
-                const totalFramedSize = 4 + packetLength + 2; // start(2) + len(2) + payload + crc(2)
-                if (this.dataBuffer.length < packetStart + totalFramedSize) {
-                    // Not enough data for complete framed packet, wait for more
-                    this.packetFragmentationCount++;
-                    this.lastFragmentationTime = Date.now();
-                    this.log(`*** INCOMPLETE NEW FORMAT PACKET: Need ${totalFramedSize} bytes, have ${this.dataBuffer.length - packetStart} (Fragmentation #${this.packetFragmentationCount}) ***`, 'debug');
-                    
-                    if (this.packetFragmentationCount > 5) {
-                        this.log(`*** HIGH FRAGMENTATION WARNING: ${this.packetFragmentationCount} fragmented packets detected ***`, 'warn');
-                    }
-                    return;
-                }
-                
-                // Extract payload and CRC
-                const payloadStart = packetStart + 4;
-                const payloadEnd = payloadStart + packetLength;
-                const crcStart = payloadEnd;
-                const crcEnd = crcStart + 2;
-                
-                const payload = this.dataBuffer.slice(payloadStart, payloadEnd);
-                const receivedCrc = (this.dataBuffer[crcStart] << 8) | this.dataBuffer[crcStart + 1];
-                
-                // Calculate CRC for payload
-                const calculatedCrc = this.calculateCRC16(payload);
-                
-                if (receivedCrc === calculatedCrc) {
-                    // CRC matches, process the packet
-                    this.dataBuffer = this.dataBuffer.slice(packetStart + totalFramedSize);
-                    
-                    if (this.packetFragmentationCount > 0) {
-                        this.log(`*** PACKET RECOVERY: Successfully processed new format packet after ${this.packetFragmentationCount} fragmentations ***`, 'info');
-                        this.packetFragmentationCount = 0;
-                    }
-                    
-                    // this.log(`*** EXTRACTED NEW FORMAT PACKET: ${payload.length} bytes, CRC=0x${receivedCrc.toString(16).padStart(4, '0')}, Buffer remaining: ${this.dataBuffer.length} ***`, 'debug');
-                    this.processPacket(payload);
-                } else {
-                    // CRC mismatch, remove start marker and continue
-                    this.log(`*** NEW FORMAT CRC MISMATCH: Expected 0x${calculatedCrc.toString(16).padStart(4, '0')}, got 0x${receivedCrc.toString(16).padStart(4, '0')} ***`, 'warn');
-                    this.dataBuffer = this.dataBuffer.slice(packetStart + 1);
-                    continue;
-                }
-            } else {
-                // Old format: [0xAA][LEN_L][LEN_H][DATA...][0x55]
-                if (this.dataBuffer.length < packetStart + 3) {
-                    this.log(`*** INCOMPLETE OLD FORMAT LENGTH FIELD ***`, 'debug');
-                    return;
-                }
-                
-                // Parse packet length (2 bytes, little-endian)
-                const packetLength = this.dataBuffer[packetStart + 1] | (this.dataBuffer[packetStart + 2] << 8);
-                
-                // Sanity check: packet length should be reasonable (max 1000 bytes)
-                if (packetLength > 1000 || packetLength < 0) {
-                    this.log(`*** INVALID OLD FORMAT PACKET LENGTH: ${packetLength} bytes, removing start marker ***`, 'warn');
-                    this.dataBuffer = this.dataBuffer.slice(packetStart + 1);
-                    continue;
-                }
-                
-                // this.log(`*** OLD FORMAT FRAMED PACKET: Length=${packetLength} bytes ***`, 'debug');
-                
-                // Check if we have the complete packet (start + len + data + end)
-                const totalFramedSize = 1 + 2 + packetLength + 1; // start + length + data + end
-                if (this.dataBuffer.length < packetStart + totalFramedSize) {
-                    // Not enough data for complete framed packet, wait for more
-                    this.packetFragmentationCount++;
-                    this.lastFragmentationTime = Date.now();
-                    this.log(`*** INCOMPLETE OLD FORMAT PACKET: Need ${totalFramedSize} bytes, have ${this.dataBuffer.length - packetStart} (Fragmentation #${this.packetFragmentationCount}) ***`, 'debug');
-                    
-                    if (this.packetFragmentationCount > 5) {
-                        this.log(`*** HIGH FRAGMENTATION WARNING: ${this.packetFragmentationCount} fragmented packets detected ***`, 'warn');
-                    }
-                    return;
-                }
-                
-                // Check for end marker
-                const endMarkerPos = packetStart + totalFramedSize - 1;
-                if (this.dataBuffer[endMarkerPos] !== 0x55) {
-                    this.log(`*** INVALID OLD FORMAT END MARKER: Expected 0x55, got 0x${this.dataBuffer[endMarkerPos].toString(16)} ***`, 'warn');
-                    this.dataBuffer = this.dataBuffer.slice(packetStart + 1);
-                    continue;
-                }
-                
-                // Extract the actual packet data (without framing)
-                const payload = this.dataBuffer.slice(packetStart + 3, endMarkerPos);
-                this.dataBuffer = this.dataBuffer.slice(packetStart + totalFramedSize);
-                
-                if (this.packetFragmentationCount > 0) {
-                    this.log(`*** PACKET RECOVERY: Successfully processed old format packet after ${this.packetFragmentationCount} fragmentations ***`, 'info');
-                    this.packetFragmentationCount = 0;
-                }
-                
-                // this.log(`*** EXTRACTED OLD FORMAT PACKET: ${payload.length} bytes, Buffer remaining: ${this.dataBuffer.length} ***`, 'debug');
-                this.processPacket(payload);
+            if (this.capture) {
+                this.log(`Dashboard closed; ${this.dashboard.samples.length} samples and ` +
+                         `${this.capture.bytes} bytes of capture kept for export`, 'info');
             }
+            return;
         }
-        
-        // Prevent buffer from growing too large
-        if (this.dataBuffer.length > 10000) {
-            this.log(`*** BUFFER TOO LARGE (${this.dataBuffer.length} bytes), CLEARING ***`, 'warn');
-            this.dataBuffer = [];
+
+        this.dashboard.reset();
+        this.dashboardSample = {};
+        this.dashboardReports = {};
+        this.lastTelemetry = null;
+        this.capture = new SessionCapture();
+        this.dashboardPanel.hidden = false;
+        this.dashboardBtn.textContent = '📈 Hide Dashboard';
+        this.dashboardTimer = setInterval(() => this.dashboardTick(), DASHBOARD_POLL_MS);
+        if (this.isConnected) {
+            this.requestDashboardSetup();
         }
-        
-        // If we have a partial packet for too long, clear it (increased timeout for high data rate)
-        if (this.dataBuffer.length > 0 && this.lastPacketTime && (Date.now() - this.lastPacketTime) > 10000) {
-            this.log(`*** PARTIAL PACKET TIMEOUT (${this.dataBuffer.length} bytes), CLEARING ***`, 'warn');
-            this.dataBuffer = [];
-            this.lastPacketTime = null;
+    }
+
+    // Firmware that has not answered RelayCapabilitiesRead is asked anyway;
+    // older relays ignore requests they do not know
+    relayHas(feature) {
+        return !this.relayCapabilities || (this.relayCapabilities.features & feature) !== 0;
+    }
+
+    // AppToRelayMessage { destination = RELAY, <body> }. On relays with
+    // RELAY_FEATURE.REQUEST_ID the request carries a request_id and resolves
+    // to its reply, {tag, body}, so several may be in flight; it resolves to
+    // null on a RequestError, after RELAY_REQUEST_TIMEOUT_MS, or at once on
+    // older relays and for requests the relay does not answer.
+    async sendRelayRequest(body, what) {
+        const tracked = this.relayCapabilities && (this.relayCapabilities.features & RELAY_FEATURE.REQUEST_ID);
+        let id = 0;
+        let reply = null;
+
+        if (tracked) {
+            do {
+                this.nextRequestId = (this.nextRequestId + 1) >>> 0;
+            } while (this.nextRequestId === 0 || this.pendingRequests.has(this.nextRequestId));
+            id = this.nextRequestId;
+            reply = new Promise(resolve => {
+                const timer = setTimeout(() => settle(null), RELAY_REQUEST_TIMEOUT_MS);
+                const settle = r => {
+                    clearTimeout(timer);
+                    this.pendingRequests.delete(id);
+                    resolve(r);
+                };
+                this.pendingRequests.set(id, { what, resolve: settle });
+            });
+        }
+
+        try {
+            // request_id = 100: key 0xA0 0x06
+            await this.writer.write(this.frameData([0x08, 0x01, ...body,
+                                                    ...(id ? [0xA0, 0x06, ...this.encodeVarint(id)] : [])]));
+        } catch (error) {
+            this.log(`Failed to ${what}: ${error.message}`, 'warn');
+            if (id) this.pendingRequests.get(id).resolve(null);
         }
+        return reply;
     }
-    
-    calculateCRC16(data) {
-        // Calculate CRC-16 (CCITT) for data integrity checking
-        let crc = 0xFFFF; // Initial value
-        
+
+    // Whether a sendRelayRequest() for what is still waiting for its reply
+    relayRequestPending(what) {
+        return [...this.pendingRequests.values()].some(pending => pending.what === what);
+    }
+
+    requestDashboardSetup() {
+        if (this.relayHas(RELAY_FEATURE.LINK_TELEMETRY)) {
+            // link_telemetry_subscribe = { interval_ms }
+            const interval = this.encodeVarint(DASHBOARD_POLL_MS);
+            this.sendRelayRequest([0x72, interval.length + 1, 0x08, ...interval], 'subscribe to link telemetry');
+        }
+        if (this.relayHas(RELAY_FEATURE.CONNECTION_TIMING)) {
+            this.sendRelayRequest([0x6A, 0x00], 'read connection timing'); // connection_timing_read = {}
+        }
+    }
+
+    dashboardTick() {
+        this.dashboard.push({ time: Date.now(), ...this.dashboardSample });
+        if (!this.isConnected || !this.writer) return;
+
+        // Reads still unanswered from the last sample are not sent again
+        if (this.relayHas(RELAY_FEATURE.HID_LATENCY) && !this.relayRequestPending('read HID latency')) {
+            this.sendRelayRequest([0x42, 0x00], 'read HID latency'); // hid_latency_read = {}
+        }
+        if (this.relayHas(RELAY_FEATURE.RELAY_STATS) && !this.relayRequestPending('read relay stats')) {
+            this.sendRelayRequest([0x62, 0x00], 'read relay stats'); // relay_stats_read = {}
+        }
+        // One echo per sample, unless an echo test is using the waiter
+        if (this.relayCapabilities && (this.relayCapabilities.features & RELAY_FEATURE.ECHO) && !this.echoWaiter) {
+            this.sendEcho(0).then(reply => {
+                this.dashboardSample.usbRttMs = reply ? reply.rttMs : undefined;
+            }, () => {});
+        }
+    }
+
+    handleLinkTelemetry(t) {
+        const last = this.lastTelemetry;
+        const seconds = (t.intervalMs || DASHBOARD_POLL_MS) / 1000;
+
+        // Counters are since boot; the dashboard shows them per second
+        const rate = key => last && t[key] >= last[key] ? (t[key] - last[key]) / seconds : undefined;
+        Object.assign(this.dashboardSample, {
+            rssi: t.connected ? t.rssi : undefined,
+            intervalMs: t.connected ? t.connIntervalUs / 1000 : undefined,
+            hidRate: t.hidReportsPerS,
+            hidDropped: rate('hidDropped'),
+            nusRxDropped: rate('nusRxDropped'),
+            nusLossPct: t.connected ? t.nusLossPermille / 10 : undefined,
+            nusTxDropped: rate('nusTxDropped'),
+            nusTxQueued: t.nusTxQueued,
+            cdcTxQueued: t.cdcTxQueued,
+            stalls: rate('stalls'),
+            // 0 while the relay does not measure it (usb_phase.h)
+            usbWaitMs: t.usbWaitUs ? t.usbWaitUs / 1000 : undefined,
+        });
+        this.lastTelemetry = t;
+
+        const phy = code => ['?', '1M', '2M', 'Coded'][code] || code;
+        this.dashboard.setLine('link', `Link ${t.connected ? 'up' : 'down'}, battery ${t.batteryLevel}%, ` +
+            `PHY ${phy(t.txPhy)}/${phy(t.rxPhy)}, worst stall ${(t.worstStallUs / 1000).toFixed(1)} ms` +
+            (t.usbWaitUs ? `, HID submitted ${t.usbPhaseUs} us into the USB frame` : ''));
+        this.dashboard.setLine('drops', `Since boot: HID dropped ${t.hidDropped}, NUS rx dropped ${t.nusRxDropped}, ` +
+            `NUS tx dropped ${t.nusTxDropped}, ${t.stalls} stalls`);
+        // Sequence gaps by length, as sensor_stream.h bins them
+        const bins = ['1', '2', '3-4', '5-8', '9-16', '17+'];
+        this.dashboard.setLine('sequence', `MouthPad sequence since boot: ${t.nusSeqLost} lost, ` +
+            `${t.nusSeqReordered} late; gaps ` +
+            (t.nusGapLengths.length ? t.nusGapLengths.map((n, i) => `${bins[i] || '?'}: ${n}`).join(', ') : 'none'));
+    }
+
+    // HID latency is measured since boot by the relay, so the dashboard
+    // plots the worst report's cumulative percentiles
+    handleHidLatency(reports) {
+        const measured = reports.filter(r => r.count);
+        if (!measured.length) return;
+        this.dashboardSample.hidP50Ms = Math.max(...measured.map(r => r.p50Us)) / 1000;
+        this.dashboardSample.hidP99Ms = Math.max(...measured.map(r => r.p99Us)) / 1000;
+        this.dashboard.setLine('latency', 'HID latency: ' + measured.map(r =>
+            `report ${r.reportId} p50 ${(r.p50Us / 1000).toFixed(2)} / p99 ${(r.p99Us / 1000).toFixed(2)} / ` +
+            `max ${(r.maxUs / 1000).toFixed(2)} ms (${r.count})`).join(', '));
+        this.dashboardReports.hidLatency = reports;
+    }
+
+    handleRelayStats(stats) {
+        const path = (name, c) => `${name} ${c.bridged}/${c.packets} bridged, ${c.dropped} dropped`;
+        this.dashboard.setLine('paths', `Paths: ${path('NUS rx', stats.nusRx)}; ${path('NUS tx', stats.nusTx)}; ` +
+                               `${path('HID', stats.hid)}`);
+        this.dashboardReports.relayStats = stats;
+    }
+
+    handleConnectionTiming(timing) {
+        const newest = timing.records[0];
+        if (newest) {
+            this.dashboard.setLine('connection', `Connection #${newest.sequence}${newest.bonded ? ' (bonded)' : ''}: ` +
+                `advertising ${newest.firstAdvMs} ms, connected ${newest.connectedMs} ms, ` +
+                `secured ${newest.securityMs} ms, HID ready ${newest.hidReadyMs} ms` +
+                (newest.attBearers ? `, ${newest.attBearers} ATT bearers` : ''));
+        }
+        this.dashboardReports.connectionTiming = timing;
+    }
+
+    exportSession() {
+        const session = {
+            exportedAt: new Date().toISOString(),
+            relay: this.relayCapabilities,
+            samples: this.dashboard.samples,
+            lastTelemetry: this.lastTelemetry,
+            ...this.dashboardReports,
+        };
+        this.download(new Blob([JSON.stringify(session, null, 1)], { type: 'application/json' }), 'json');
+    }
+
+    // MPCAP file for mouthpad_replay or relay_bench
+    exportCapture() {
+        if (!this.capture) {
+            this.log('Open the dashboard to start a capture', 'warn');
+            return;
+        }
+        if (this.capture.full) {
+            this.log(`Capture stopped at ${CAPTURE_MAX_BYTES} bytes`, 'warn');
+        }
+        this.download(this.capture.toBlob(), 'mpcap');
+    }
+
+    download(blob, extension) {
+        const url = URL.createObjectURL(blob);
+        const a = document.createElement('a');
+        a.href = url;
+        a.download = `mouthpad-session-${new Date().toISOString().slice(0, 19).replace(/:/g, '-')}.${extension}`;
+        a.click();
+        URL.revokeObjectURL(url);
+    }
+
+    calculateCRC16(data, crc = 0xFFFF) {
+        // Table-driven CRC-16 (CCITT), same as the firmware's mouthpad_crc16;
+        // pass the previous result as crc to continue over another chunk
         for (let i = 0; i < data.length; i++) {
-            crc ^= data[i] << 8;
-            for (let j = 0; j < 8; j++) {
-                if (crc & 0x8000) {
-                    crc = (crc << 1) ^ 0x1021; // CCITT polynomial
-                } else {
-                    crc = crc << 1;
-                }
-            }
+            crc = ((crc << 8) ^ CRC16_TABLE[((crc >> 8) ^ data[i]) & 0xFF]) & 0xFFFF;
         }
-        
-                return crc & 0xFFFF;
+        return crc;
     }
     
     analyzeCapacitiveData(capTouchData, capacitance) {
@@ -441,7 +2460,7 @@ class MouthPadController {
         if (capTouchData.length > 84) {
             this.log(`*** EXTRA DATA: ${capTouchData.length - 84} bytes beyond 84-byte capacitive data ***`, 'info');
             const extraData = capTouchData.slice(84);
-            const extraHex = extraData.map(b => b.toString(16).padStart(2, '0')).join(' ');
+            const extraHex = this.arrayToHex(extraData);
             this.log(`*** EXTRA DATA HEX: ${extraHex} ***`, 'debug');
         }
         
@@ -542,6 +2561,10 @@ class MouthPadController {
     }
     
     processPacket(packet) {
+        if (this.capture) {
+            this.capture.put(1, false, packet);
+        }
+
         // Log complete packet in raw mode
         if (this.logViewMode === 'raw') {
             this.logRaw(packet);
@@ -565,15 +2588,12 @@ class MouthPadController {
         // Determine packet type and process accordingly
         if (packet.length >= 138) {
             // Large packets (138+ bytes) are always sensor data (JCP, IMU, Click streams)
-            const sensorData = packet.slice(4, 138);
-            // this.log(`*** SENSOR DATA: ${sensorData.length} bytes ***`, 'info');
+            this.sensorView.update(packet);
             
-            // Debug: Show the first few bytes to help identify header structure
-            const firstBytes = sensorData.slice(0, 16).map(b => b.toString(16).padStart(2, '0')).join(' ');
-            // this.log(`*** FIRST 16 BYTES: ${firstBytes} ***`, 'debug');
-            
-            // Process the sensor data for BLE NUS format
-            this.processBLESensorData(sensorData, packetType, flags);
+            // Per-packet analysis in the log, only when asked for
+            if (this.sensorDebug) {
+                this.processBLESensorData(packet.slice(4, 138), packetType, flags);
+            }
             
         } else if (packet.length >= 9 && byte3 < 0x10) {
             // Small packets (9 bytes) with low byte3 are power data
@@ -832,28 +2852,6 @@ class MouthPadController {
         // return row * 8 + (col % 2 === 0 ? col/2 : 4 + col/2);
     }
 
-    createGrid() {
-        this.touchpadGrid.innerHTML = '';
-        
-        // Create 8x6 grid (48 cells)
-        // Try different orientations to match the actual touchpad layout
-        for (let row = 0; row < 6; row++) {
-            for (let col = 0; col < 8; col++) {
-                const cell = document.createElement('div');
-                cell.className = 'grid-cell';
-                cell.textContent = '0';
-                cell.dataset.row = row;
-                cell.dataset.col = col;
-                // Add data attributes for debugging
-                cell.dataset.index = row * 8 + col;
-                this.touchpadGrid.appendChild(cell);
-            }
-        }
-        
-        // Show the grid mapping for debugging
-        // this.logGridMapping();
-    }
-
     logGridMapping() {
         let mapping = [];
         for (let i = 0; i < 24; i++) { // Show first 24 cells
@@ -894,89 +2892,24 @@ class MouthPadController {
         if (this.logViewMode === 'raw') {
             return;
         }
-        
-        const timestamp = new Date().toLocaleTimeString();
-        const logEntry = document.createElement('div');
-        logEntry.className = `log-entry log-${type}`;
-        logEntry.innerHTML = `<span class="timestamp">[${timestamp}]</span> ${message}`;
-        
-        this.terminal.appendChild(logEntry);
-        
-        // Auto-scroll to bottom
-        this.terminal.scrollTop = this.terminal.scrollHeight;
-        
-        // Auto-clear old entries to prevent browser lockup
-        const maxLogEntries = 1000; // Keep last 1000 entries
-        const logEntries = this.terminal.querySelectorAll('.log-entry');
-        if (logEntries.length > maxLogEntries) {
-            // Remove oldest entries (keep the last maxLogEntries)
-            const entriesToRemove = logEntries.length - maxLogEntries;
-            for (let i = 0; i < entriesToRemove; i++) {
-                logEntries[i].remove();
-            }
-        }
-        
-        // Also clear console to prevent memory issues
-        if (this.terminal.children.length > 2000) {
-            this.terminal.innerHTML = '';
-            const clearMessage = document.createElement('div');
-            clearMessage.className = 'log-entry log-info';
-            clearMessage.innerHTML = `<span class="timestamp">[${timestamp}]</span> *** LOGS AUTO-CLEARED TO PREVENT BROWSER LOCKUP ***`;
-            this.terminal.appendChild(clearMessage);
-        }
+        this.logView.push({ time: Date.now(), type, message });
     }
 
     logRaw(data) {
         if (this.logViewMode !== 'raw') {
             return; // Only log raw data in raw mode
         }
-        
-        const timestamp = new Date().toLocaleTimeString();
-        const logEntry = document.createElement('div');
-        logEntry.className = 'log-entry raw';
-        
-        // Convert data to hex string with spaces
-        const hexString = Array.from(data).map(byte => byte.toString(16).padStart(2, '0')).join(' ');
-        
-        // Add packet size indicator
-        const packetSize = data.length;
-        const sizeIndicator = packetSize > 64 ? '📦' : packetSize > 32 ? '📄' : '📝';
-        
-        logEntry.innerHTML = `<span class="timestamp">[${timestamp}]</span> <span class="hex-data">${sizeIndicator} ${hexString}</span>`;
-        
-        this.terminal.appendChild(logEntry);
-        
-        // Auto-scroll to bottom
-        this.terminal.scrollTop = this.terminal.scrollHeight;
-        
-        // Auto-clear old entries to prevent browser lockup
-        const maxLogEntries = 1000;
-        const logEntries = this.terminal.querySelectorAll('.log-entry');
-        if (logEntries.length > maxLogEntries) {
-            const entriesToRemove = logEntries.length - maxLogEntries;
-            for (let i = 0; i < entriesToRemove; i++) {
-                logEntries[i].remove();
-            }
-        }
-        
-        // Also clear console to prevent memory issues
-        if (this.terminal.children.length > 2000) {
-            this.terminal.innerHTML = '';
-            const clearMessage = document.createElement('div');
-            clearMessage.className = 'log-entry log-info';
-            clearMessage.innerHTML = `<span class="timestamp">[${timestamp}]</span> *** LOGS AUTO-CLEARED TO PREVENT BROWSER LOCKUP ***`;
-            this.terminal.appendChild(clearMessage);
-        }
+        // Copied: received chunks are handed on to the deframer worker
+        this.logView.push({ time: Date.now(), type: 'raw', bytes: data.slice() });
     }
 
     clearLog() {
-        this.terminal.innerHTML = '<div class="terminal-line">Log cleared...</div>';
+        this.logView.clear();
+        this.logView.push({ time: Date.now(), type: 'info', message: 'Log cleared...' });
     }
 
     exportLog() {
-        const logText = Array.from(this.terminal.children)
-            .map(line => line.textContent)
-            .join('\n');
+        const logText = this.logView.toText();
         
         const blob = new Blob([logText], { type: 'text/plain' });
         const url = URL.createObjectURL(blob);
@@ -997,16 +2930,22 @@ class MouthPadController {
             case 'connected':
                 if (this.statusText) this.statusText.textContent = 'Connected';
                 if (this.connectBtn) this.connectBtn.disabled = true;
+                if (this.connectUsbBtn) this.connectUsbBtn.disabled = true;
+                if (this.connectGatewayBtn) this.connectGatewayBtn.disabled = true;
                 if (this.disconnectBtn) this.disconnectBtn.disabled = false;
                 break;
             case 'connecting':
                 if (this.statusText) this.statusText.textContent = 'Connecting...';
                 if (this.connectBtn) this.connectBtn.disabled = true;
+                if (this.connectUsbBtn) this.connectUsbBtn.disabled = true;
+                if (this.connectGatewayBtn) this.connectGatewayBtn.disabled = true;
                 if (this.disconnectBtn) this.disconnectBtn.disabled = true;
                 break;
             case 'disconnected':
                 if (this.statusText) this.statusText.textContent = 'Not Connected';
                 if (this.connectBtn) this.connectBtn.disabled = false;
+                if (this.connectUsbBtn) this.connectUsbBtn.disabled = false;
+                if (this.connectGatewayBtn) this.connectGatewayBtn.disabled = false;
                 if (this.disconnectBtn) this.disconnectBtn.disabled = true;
                 break;
         }
@@ -1077,7 +3016,7 @@ class MouthPadController {
     processCapacitiveData(capTouchData) {
         // Parse exactly like Mac app capacitanceData function
         this.log(`*** RECEIVED CAPACITIVE DATA (in processCapacitiveData): ${capTouchData.length} bytes ***`, 'debug');
-        const capDataHex = capTouchData.map(b => b.toString(16).padStart(2, '0')).join(' ');
+        const capDataHex = this.arrayToHex(capTouchData);
         this.log(`*** CAP DATA HEX (in processCapacitiveData): ${capDataHex} ***`, 'debug');
         const capacitance = [];
         
@@ -1165,9 +3104,6 @@ class MouthPadController {
         
         // Analyze the data to find potential alignment issues
         this.analyzeCapacitiveData(capTouchData, capacitance);
-        
-        // Update the grid with complete data
-        this.updateGridFromCompleteCapacitive44(capacitance);
     }
     
     processPressureData(pressureData, packetIndex) {
@@ -1190,7 +3126,7 @@ class MouthPadController {
         if (pressureData.length >= 4) {
             try {
                 const pressureBytes = pressureData.slice(0, 4);
-                const pressureHex = pressureBytes.map(b => b.toString(16).padStart(2, '0')).join(' ');
+                const pressureHex = this.arrayToHex(pressureBytes);
                 this.log(`*** PRESSURE READING BYTES (0-3): ${pressureHex} ***`, 'debug');
                 
                 const bytes = new Uint8Array(pressureBytes);
@@ -1207,7 +3143,7 @@ class MouthPadController {
         if (pressureData.length >= 21) {
             try {
                 const upperBytes = pressureData.slice(17, 21);
-                const upperHex = upperBytes.map(b => b.toString(16).padStart(2, '0')).join(' ');
+                const upperHex = this.arrayToHex(upperBytes);
                 this.log(`*** UPPER THRESHOLD BYTES (17-20): ${upperHex} ***`, 'debug');
                 
                 const bytes = new Uint8Array(upperBytes);
@@ -1224,7 +3160,7 @@ class MouthPadController {
         if (pressureData.length >= 25) {
             try {
                 const lowerBytes = pressureData.slice(21, 25);
-                const lowerHex = lowerBytes.map(b => b.toString(16).padStart(2, '0')).join(' ');
+                const lowerHex = this.arrayToHex(lowerBytes);
                 this.log(`*** LOWER THRESHOLD BYTES (21-24): ${lowerHex} ***`, 'debug');
                 
                 const bytes = new Uint8Array(lowerBytes);
@@ -1256,7 +3192,7 @@ class MouthPadController {
         if (pressureData.length >= 13) {
             try {
                 const meanPressureBytes = pressureData.slice(9, 13);
-                const meanPressureHex = meanPressureBytes.map(b => b.toString(16).padStart(2, '0')).join(' ');
+                const meanPressureHex = this.arrayToHex(meanPressureBytes);
                 // this.log(`*** MEAN PRESSURE BYTES (9-12): ${meanPressureHex} ***`, 'debug');
                 
                 const bytes = new Uint8Array(meanPressureBytes);
@@ -1331,100 +3267,6 @@ class MouthPadController {
         }
     }
     
-    initializePressureChart() {
-        if (!this.pressureChart) return;
-        
-        this.chartCtx = this.pressureChart.getContext('2d');
-        this.chartCtx.fillStyle = '#f8f9fa';
-        this.chartCtx.fillRect(0, 0, this.pressureChart.width, this.pressureChart.height);
-        
-        // Draw initial grid
-        this.drawChartGrid();
-    }
-    
-    drawChartGrid() {
-        if (!this.chartCtx) return;
-        
-        const ctx = this.chartCtx;
-        const width = this.pressureChart.width;
-        const height = this.pressureChart.height;
-        
-        // Clear canvas
-        ctx.fillStyle = '#f8f9fa';
-        ctx.fillRect(0, 0, width, height);
-        
-        // Draw grid lines
-        ctx.strokeStyle = '#e9ecef';
-        ctx.lineWidth = 1;
-        
-        // Vertical lines (time)
-        for (let i = 0; i <= 10; i++) {
-            const x = (width / 10) * i;
-            ctx.beginPath();
-            ctx.moveTo(x, 0);
-            ctx.lineTo(x, height);
-            ctx.stroke();
-        }
-        
-        // Horizontal lines (pressure)
-        for (let i = 0; i <= 5; i++) {
-            const y = (height / 5) * i;
-            ctx.beginPath();
-            ctx.moveTo(0, y);
-            ctx.lineTo(width, y);
-            ctx.stroke();
-        }
-    }
-    
-    updatePressureChart() {
-        if (!this.chartCtx || this.pressureHistory.length === 0) return;
-        
-        const ctx = this.chartCtx;
-        const width = this.pressureChart.width;
-        const height = this.pressureChart.height;
-        
-        // Redraw grid
-        this.drawChartGrid();
-        
-        // Get pressure data for charting
-        const pressures = this.pressureHistory.map(p => p.pressure);
-        const maxPressure = Math.max(...pressures);
-        const minPressure = Math.min(...pressures);
-        const pressureRange = maxPressure - minPressure || 1000; // Default range if all values are same
-        
-        // Draw pressure line
-        ctx.strokeStyle = '#007bff';
-        ctx.lineWidth = 2;
-        ctx.beginPath();
-        
-        this.pressureHistory.forEach((entry, index) => {
-            const x = (index / (this.pressureHistory.length - 1)) * width;
-            const normalizedPressure = (entry.pressure - minPressure) / pressureRange;
-            const y = height - (normalizedPressure * height);
-            
-            if (index === 0) {
-                ctx.moveTo(x, y);
-            } else {
-                ctx.lineTo(x, y);
-            }
-        });
-        
-        ctx.stroke();
-        
-        // Draw current point
-        if (this.pressureHistory.length > 0) {
-            const latest = this.pressureHistory[this.pressureHistory.length - 1];
-            const x = width - 10; // Right side
-            const normalizedPressure = (latest.pressure - minPressure) / pressureRange;
-            const y = height - (normalizedPressure * height);
-            
-            ctx.fillStyle = '#dc3545';
-            ctx.beginPath();
-            ctx.arc(x, y, 4, 0, 2 * Math.PI);
-            ctx.fill();
-        }
-    }
-    
     updatePressureDisplay(pressureReading, upperThreshold, lowerThreshold) {
         // Update pressure display elements if they exist
         if (this.minPressure && this.maxPressure) {
@@ -1450,9 +3292,6 @@ class MouthPadController {
             }
         }
         
-        // Update pressure chart
-        this.updatePressureChart();
-        
         // Log pressure statistics
         if (this.pressureHistory.length > 0) {
             const pressures = this.pressureHistory.map(p => p.pressure);
@@ -1800,7 +3639,7 @@ class MouthPadController {
             const debugStart = Math.max(0, capTouchStartIdx - 4);
             const debugEnd = Math.min(sensorData.length, capTouchEndIdx + 8);
             const debugData = sensorData.slice(debugStart, debugEnd);
-            const debugHex = debugData.map(b => b.toString(16).padStart(2, '0')).join(' ');
+            const debugHex = this.arrayToHex(debugData);
             this.log(`*** DEBUG AREA (${debugStart}-${debugEnd}): ${debugHex} ***`, 'debug');
             
             // Try to find the best alignment for capacitive data
@@ -1827,7 +3666,7 @@ class MouthPadController {
                 this.log(`*** PRESSURE DATA: ${pressureData.length} bytes (indices ${pressureStartIdx}-${pressureEndIdx}) ***`, 'info');
                 
                 // Debug: Show pressure data hex
-                const pressureHex = pressureData.map(b => b.toString(16).padStart(2, '0')).join(' ');
+                const pressureHex = this.arrayToHex(pressureData);
                 this.log(`*** PRESSURE DATA HEX: ${pressureHex} ***`, 'debug');
                 
                 this.processPressureData(pressureData, packetIndex);
@@ -1985,7 +3824,8 @@ class MouthPadController {
             this.logViewToggleBtn.textContent = '🔍 Raw';
             this.logViewToggleBtn.classList.add('raw-mode');
             // Clear terminal for clean raw view
-            this.terminal.innerHTML = '<div class="terminal-line">Raw HEX view - waiting for data...</div>';
+            this.logView.clear();
+            this.logView.push({ time: Date.now(), type: 'info', message: 'Raw HEX view - waiting for data...' });
         } else {
             this.logViewToggleBtn.textContent = '📊 Details';
             this.logViewToggleBtn.classList.remove('raw-mode');
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2025 Robert Dale Smith
+ * Copyright (c) 2025 Augmental Tech
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * WebAssembly entry points for the web client's deframer worker: the
+ * firmware's own deframer, CRC and nanopb RelayToAppMessage decoder, so the
+ * browser accepts exactly the frames the relay sends.
+ *
+ * The module has no imports and allocates nothing. The worker copies each
+ * received chunk into mouthpad_wasm_input(), calls mouthpad_wasm_feed() and
+ * reads the records it wrote to mouthpad_wasm_output(), each a 12-byte
+ * little-endian header followed by its data:
+ *
+ *   u8 kind, u8 flags, u16 len, u32 value, u32 device_index, u8 data[len]
+ *
+ * - MOUTHPAD_WASM_PASS_THROUGH: a PassThroughToApp, or a notification on
+ *   the NUS channel (mouthpad_frame.h); value is the fragment index and
+ *   flags bit 0 more_fragments
+ * - MOUTHPAD_WASM_CHUNK: one PassThroughChunk of a PassThroughToAppBatch;
+ *   value is its sequence
+ * - MOUTHPAD_WASM_MESSAGE: any other RelayToAppMessage, as framed, for the
+ *   page's own handlers
+ * - MOUTHPAD_WASM_RAW: a frame that is not a RelayToAppMessage, passed on
+ *   unchanged as older firmware framed the bare MouthPad packet
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <pb_decode.h>
+
+#include "MouthpadRelay.pb.h"
+#include "mouthpad_frame.h"
+
+/* Host builds of this file, for checking it natively, export nothing */
+#ifdef __wasm__
+#define WASM_EXPORT(name) __attribute__((export_name(#name))) name
+#else
+#define WASM_EXPORT(name) name
+#endif
+
+/* Largest chunk taken per call; the worker splits larger reads */
+#define MOUTHPAD_WASM_INPUT_SIZE 4096
+
+/* A chunk yields at most one record per two input bytes, so this never
+ * fills; a record that would not fit is counted in overflows regardless
+ */
+#define MOUTHPAD_WASM_OUTPUT_SIZE (8 * MOUTHPAD_WASM_INPUT_SIZE)
+
+#define MOUTHPAD_WASM_RECORD_HEADER 12
+
+enum mouthpad_wasm_kind {
+	MOUTHPAD_WASM_PASS_THROUGH,
+	MOUTHPAD_WASM_CHUNK,
+	MOUTHPAD_WASM_MESSAGE,
+	MOUTHPAD_WASM_RAW,
+};
+
+/* Read by the worker as a Uint32Array */
+struct mouthpad_wasm_stats {
+	uint32_t crc_errors;
+	uint32_t length_errors;
+	uint32_t decode_errors; /* Malformed PassThroughToAppBatch frames, unknown channels */
+	uint32_t overflows; /* Records dropped for lack of output space */
+};
+
+static struct mouthpad_deframer deframer;
+static mouthware_message_RelayToAppMessage message;
+static struct mouthpad_wasm_stats stats;
+static uint8_t input[MOUTHPAD_WASM_INPUT_SIZE];
+static uint8_t output[MOUTHPAD_WASM_OUTPUT_SIZE];
+static size_t output_len;
+
+static void put_u32(uint8_t *out, uint32_t value)
+{
+	out[0] = (uint8_t)value;
+	out[1] = (uint8_t)(value >> 8);
+	out[2] = (uint8_t)(value >> 16);
+	out[3] = (uint8_t)(value >> 24);
+}
+
+static void emit(enum mouthpad_wasm_kind kind, uint8_t flags, uint32_t value,
+		 uint32_t device_index, const uint8_t *data, size_t len)
+{
+	uint8_t *out = &output[output_len];
+
+	if (MOUTHPAD_WASM_OUTPUT_SIZE - output_len < MOUTHPAD_WASM_RECORD_HEADER + len) {
+		stats.overflows++;
+		return;
+	}
+
+	out[0] = (uint8_t)kind;
+	out[1] = flags;
+	out[2] = (uint8_t)len;
+	out[3] = (uint8_t)(len >> 8);
+	put_u32(&out[4], value);
+	put_u32(&out[8], device_index);
+	memcpy(&out[MOUTHPAD_WASM_RECORD_HEADER], data, len);
+	output_len += MOUTHPAD_WASM_RECORD_HEADER + len;
+}
+
+/* PassThroughToAppBatch.chunks: each chunk becomes its own record */
+static bool decode_chunk(pb_istream_t *stream, const pb_field_t *field, void **arg)
+{
+	mouthware_message_PassThroughChunk chunk = mouthware_message_PassThroughChunk_init_zero;
+
+	(void)field;
+	(void)arg;
+
+	if (!pb_decode(stream, mouthware_message_PassThroughChunk_fields, &chunk)) {
+		return false;
+	}
+	emit(MOUTHPAD_WASM_CHUNK, 0, chunk.sequence, 0, chunk.data.bytes, chunk.data.size);
+	return true;
+}
+
+/* The batch's chunks are a callback field inside the oneof, which
+ * pb_decode() of the whole message cannot reach, so a batch frame is opened
+ * here and its body decoded on its own. Chunks are emitted as they are
+ * decoded; a batch that fails part way still delivers those before the
+ * error, as the page's decoder did.
+ */
+static bool decode_batch(const uint8_t *payload, size_t len)
+{
+	pb_istream_t stream = pb_istream_from_buffer(payload, len);
+	mouthware_message_PassThroughToAppBatch batch =
+		mouthware_message_PassThroughToAppBatch_init_zero;
+	pb_istream_t body;
+	pb_wire_type_t wire_type;
+	uint32_t tag;
+	bool eof;
+
+	if (!pb_decode_tag(&stream, &wire_type, &tag, &eof) ||
+	    tag != mouthware_message_RelayToAppMessage_pass_through_to_app_batch_tag ||
+	    wire_type != PB_WT_STRING) {
+		return false;
+	}
+
+	if (!pb_make_string_substream(&stream, &body)) {
+		stats.decode_errors++;
+		return true;
+	}
+	batch.chunks.funcs.decode = decode_chunk;
+	if (!pb_decode(&body, mouthware_message_PassThroughToAppBatch_fields, &batch)) {
+		stats.decode_errors++;
+	}
+	pb_close_string_substream(&stream, &body);
+	return true;
+}
+
+static void on_frame(const uint8_t *payload, uint16_t len, void *user_data)
+{
+	struct mouthpad_channel_frame channel;
+
+	(void)user_data;
+
+	if (mouthpad_channel_parse(payload, len, &channel)) {
+		if (channel.channel == MOUTHPAD_CHANNEL_NUS) {
+			emit(MOUTHPAD_WASM_PASS_THROUGH, 0, 0, channel.device_index, channel.data,
+			     channel.len);
+			return;
+		}
+		if (channel.channel != MOUTHPAD_CHANNEL_CONTROL) {
+			stats.decode_errors++;
+			return;
+		}
+		payload = channel.data;
+		len = (uint16_t)channel.len;
+	}
+
+	pb_istream_t stream = pb_istream_from_buffer(payload, len);
+
+	if (decode_batch(payload, len)) {
+		return;
+	}
+
+	memset(&message, 0, sizeof(message));
+	if (len == 0 || !pb_decode(&stream, mouthware_message_RelayToAppMessage_fields, &message) ||
+	    message.which_message_body == 0) {
+		emit(MOUTHPAD_WASM_RAW, 0, 0, 0, payload, len);
+		return;
+	}
+
+	if (message.which_message_body ==
+	    mouthware_message_RelayToAppMessage_pass_through_to_app_tag) {
+		const mouthware_message_PassThroughToApp *p =
+			&message.message_body.pass_through_to_app;
+
+		emit(MOUTHPAD_WASM_PASS_THROUGH, p->more_fragments ? 1 : 0, p->fragment,
+		     p->device_index, p->data.bytes, p->data.size);
+	} else {
+		emit(MOUTHPAD_WASM_MESSAGE, 0, 0, 0, payload, len);
+	}
+}
+
+static void on_error(enum mouthpad_deframer_error err, uint16_t value, void *user_data)
+{
+	(void)value;
+	(void)user_data;
+
+	if (err == MOUTHPAD_DEFRAMER_ERR_CRC) {
+		stats.crc_errors++;
+	} else {
+		stats.length_errors++;
+	}
+}
+
+uint8_t *WASM_EXPORT(mouthpad_wasm_input)(void)
+{
+	return input;
+}
+
+const uint8_t *WASM_EXPORT(mouthpad_wasm_output)(void)
+{
+	return output;
+}
+
+const struct mouthpad_wasm_stats *WASM_EXPORT(mouthpad_wasm_stats)(void)
+{
+	return &stats;
+}
+
+uint32_t WASM_EXPORT(mouthpad_wasm_input_size)(void)
+{
+	return MOUTHPAD_WASM_INPUT_SIZE;
+}
+
+void WASM_EXPORT(mouthpad_wasm_reset)(void)
+{
+	mouthpad_deframer_init(&deframer, on_frame, on_error, NULL);
+	memset(&stats, 0, sizeof(stats));
+}
+
+/* Deframe len bytes from the input buffer; returns the bytes of records
+ * written to the output buffer
+ */
+uint32_t WASM_EXPORT(mouthpad_wasm_feed)(uint32_t len)
+{
+	if (!deframer.on_frame) {
+		mouthpad_wasm_reset();
+	}
+
+	output_len = 0;
+	mouthpad_deframer_feed(&deframer, input,
+			       len < MOUTHPAD_WASM_INPUT_SIZE ? len : MOUTHPAD_WASM_INPUT_SIZE);
+	return (uint32_t)output_len;
+}
+
+uint32_t WASM_EXPORT(mouthpad_wasm_pending)(void)
+{
+	return (uint32_t)mouthpad_deframer_pending(&deframer);
+}